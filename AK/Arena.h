@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// Hands out memory from a few large chunks, and frees all of it at once when cleared or destroyed. This suits
+// data that all dies at the same time, like the nodes and temporary lists of a single parse.
+// Objects created with make() have their destructors run (in reverse order of creation) when the arena is
+// cleared, memory from allocate() is just dropped.
+class Arena {
+    AK_MAKE_NONCOPYABLE(Arena);
+    AK_MAKE_NONMOVABLE(Arena);
+
+public:
+    static constexpr size_t default_alignment = 2 * sizeof(void*);
+
+    explicit Arena(size_t initial_chunk_size = 4 * KiB)
+        : m_next_chunk_size(initial_chunk_size)
+    {
+    }
+
+    ~Arena() { clear(); }
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = default_alignment)
+    {
+        auto aligned = align_up_to(m_current, alignment);
+        if (m_current == 0 || size > m_end - aligned) [[unlikely]]
+            return allocate_in_new_chunk(size, alignment);
+        m_current = aligned + size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Grows the most recent allocation to new_size if there's room for it right behind it.
+    bool try_grow_in_place(void* pointer, size_t old_size, size_t new_size)
+    {
+        auto address = reinterpret_cast<FlatPtr>(pointer);
+        if (address + old_size != m_current || new_size - old_size > m_end - m_current)
+            return false;
+        m_current = address + new_size;
+        return true;
+    }
+
+    template<typename T, typename... Args>
+    T& make(Args&&... args)
+    {
+        if constexpr (IsTriviallyDestructible<T>) {
+            return *new (allocate(sizeof(T), alignof(T))) T { forward<Args>(args)... };
+        } else {
+            auto* destructor = static_cast<Destructor*>(allocate(sizeof(Destructor), alignof(Destructor)));
+            auto* object = new (allocate(sizeof(T), alignof(T))) T { forward<Args>(args)... };
+            *destructor = { m_destructors, object, [](void* object) { static_cast<T*>(object)->~T(); } };
+            m_destructors = destructor;
+            return *object;
+        }
+    }
+
+    StringView copy(StringView string)
+    {
+        if (string.is_empty())
+            return string;
+        auto* characters = static_cast<char*>(allocate(string.length(), 1));
+        __builtin_memcpy(characters, string.characters_without_null_termination(), string.length());
+        return { characters, string.length() };
+    }
+
+    void clear()
+    {
+        for (auto* destructor = m_destructors; destructor; destructor = destructor->previous)
+            destructor->destroy(destructor->object);
+        m_destructors = nullptr;
+
+        while (m_chunk) {
+            auto* previous = m_chunk->previous;
+            kfree_sized(m_chunk, m_chunk->size);
+            m_chunk = previous;
+        }
+        m_current = 0;
+        m_end = 0;
+        m_used_bytes = 0;
+    }
+
+    // The size of all chunks, including the parts that haven't been handed out yet.
+    size_t used_bytes() const { return m_used_bytes; }
+
+private:
+    struct Chunk {
+        Chunk* previous;
+        size_t size;
+    };
+
+    struct Destructor {
+        Destructor* previous;
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    void* allocate_in_new_chunk(size_t size, size_t alignment)
+    {
+        // Chunks double in size so that large parses don't need too many of them, and allocations that don't
+        // fit in one get a chunk of their own.
+        size_t chunk_size = max(m_next_chunk_size, sizeof(Chunk) + size + alignment);
+        m_next_chunk_size = min(m_next_chunk_size * 2, max_chunk_size);
+
+        auto* chunk = static_cast<Chunk*>(kmalloc(chunk_size));
+        VERIFY(chunk);
+        *chunk = { m_chunk, chunk_size };
+        m_chunk = chunk;
+        m_used_bytes += chunk_size;
+
+        m_current = reinterpret_cast<FlatPtr>(chunk) + sizeof(Chunk);
+        m_end = reinterpret_cast<FlatPtr>(chunk) + chunk_size;
+        return allocate(size, alignment);
+    }
+
+    static constexpr size_t max_chunk_size = 1 * MiB;
+
+    Chunk* m_chunk { nullptr };
+    FlatPtr m_current { 0 };
+    FlatPtr m_end { 0 };
+    Destructor* m_destructors { nullptr };
+    size_t m_next_chunk_size { 0 };
+    size_t m_used_bytes { 0 };
+};
+
+// A vector whose storage comes from an Arena. Its elements are destroyed with it, but the memory only goes away
+// with the arena, so it's best suited to short-lived lists or ones that are built up once.
+template<typename T>
+class ArenaVector {
+    AK_MAKE_NONCOPYABLE(ArenaVector);
+
+public:
+    explicit ArenaVector(Arena& arena)
+        : m_arena(&arena)
+    {
+    }
+
+    ArenaVector(ArenaVector&& other)
+        : m_arena(other.m_arena)
+        , m_elements(exchange(other.m_elements, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+    {
+    }
+
+    ArenaVector& operator=(ArenaVector&& other)
+    {
+        if (this != &other) {
+            clear();
+            m_arena = other.m_arena;
+            m_elements = exchange(other.m_elements, nullptr);
+            m_size = exchange(other.m_size, 0);
+            m_capacity = exchange(other.m_capacity, 0);
+        }
+        return *this;
+    }
+
+    ~ArenaVector() { clear(); }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool is_empty() const { return m_size == 0; }
+
+    T* data() { return m_elements; }
+    T const* data() const { return m_elements; }
+
+    T& at(size_t index)
+    {
+        VERIFY(index < m_size);
+        return m_elements[index];
+    }
+    T const& at(size_t index) const
+    {
+        VERIFY(index < m_size);
+        return m_elements[index];
+    }
+    T& operator[](size_t index) { return at(index); }
+    T const& operator[](size_t index) const { return at(index); }
+
+    T& first() { return at(0); }
+    T const& first() const { return at(0); }
+    T& last() { return at(m_size - 1); }
+    T const& last() const { return at(m_size - 1); }
+
+    Span<T> span() { return { m_elements, m_size }; }
+    Span<T const> span() const { return { m_elements, m_size }; }
+
+    T* begin() { return m_elements; }
+    T* end() { return m_elements + m_size; }
+    T const* begin() const { return m_elements; }
+    T const* end() const { return m_elements + m_size; }
+
+    template<typename... Args>
+    T& empend(Args&&... args)
+    {
+        if (m_size == m_capacity)
+            grow(m_size + 1);
+        return *new (&m_elements[m_size++]) T { forward<Args>(args)... };
+    }
+
+    void append(T&& value) { empend(move(value)); }
+    void append(T const& value) { empend(value); }
+
+    T take_last()
+    {
+        VERIFY(!is_empty());
+        T value = move(last());
+        last().~T();
+        --m_size;
+        return value;
+    }
+
+    void ensure_capacity(size_t capacity)
+    {
+        if (capacity > m_capacity)
+            grow(capacity);
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < m_size; ++i)
+            m_elements[i].~T();
+        m_size = 0;
+    }
+
+private:
+    void grow(size_t minimum_capacity)
+    {
+        size_t new_capacity = max(max(minimum_capacity, m_capacity * 2), static_cast<size_t>(4));
+        if (m_elements && m_arena->try_grow_in_place(m_elements, m_capacity * sizeof(T), new_capacity * sizeof(T))) {
+            m_capacity = new_capacity;
+            return;
+        }
+
+        auto* new_elements = static_cast<T*>(m_arena->allocate(new_capacity * sizeof(T), alignof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (&new_elements[i]) T(move(m_elements[i]));
+            m_elements[i].~T();
+        }
+        m_elements = new_elements;
+        m_capacity = new_capacity;
+    }
+
+    Arena* m_arena { nullptr };
+    T* m_elements { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+};
+
+}
+
+using AK::Arena;
+using AK::ArenaVector;
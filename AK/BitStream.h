@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Endian.h>
 #include <AK/Optional.h>
 #include <AK/Stream.h>
 
@@ -174,40 +175,24 @@ public:
         return true;
     }
 
+    // NOTE: Bits are collected and only written out 4 bytes at a time, any remaining ones are written by align_to_byte_boundary().
     void write_bits(u32 bits, size_t count)
     {
         VERIFY(count <= 32);
 
-        if (count == 32 && !m_next_byte.has_value()) { // fast path for aligned 32 bit writes
-            m_stream << bits;
-            return;
-        }
+        if (count < 32)
+            bits &= (1u << count) - 1;
+        m_bit_buffer |= static_cast<u64>(bits) << m_bit_count;
+        m_bit_count += count;
 
-        size_t n_written = 0;
-        while (n_written < count) {
-            if (m_stream.has_any_error()) {
+        if (m_bit_count >= 32) {
+            LittleEndian<u32> completed_bits = static_cast<u32>(m_bit_buffer);
+            if (!m_stream.write_or_error({ &completed_bits, sizeof(completed_bits) })) {
                 set_fatal_error();
                 return;
             }
-
-            if (m_next_byte.has_value()) {
-                m_next_byte.value() |= ((bits >> n_written) & 1) << m_bit_offset;
-                ++n_written;
-
-                if (m_bit_offset++ == 7) {
-                    m_stream << m_next_byte.value();
-                    m_next_byte.clear();
-                }
-            } else if (count - n_written >= 16) { // fast path for aligned 16 bit writes
-                m_stream << (u16)((bits >> n_written) & 0xFFFF);
-                n_written += 16;
-            } else if (count - n_written >= 8) { // fast path for aligned 8 bit writes
-                m_stream << (u8)((bits >> n_written) & 0xFF);
-                n_written += 8;
-            } else {
-                m_bit_offset = 0;
-                m_next_byte = 0;
-            }
+            m_bit_buffer >>= 32;
+            m_bit_count -= 32;
         }
     }
 
@@ -218,22 +203,26 @@ public:
 
     void align_to_byte_boundary()
     {
-        if (m_next_byte.has_value()) {
-            if (!m_stream.write_or_error(ReadonlyBytes { &m_next_byte.value(), 1 })) {
+        while (m_bit_count > 0) {
+            u8 byte = m_bit_buffer & 0xFF;
+            if (!m_stream.write_or_error(ReadonlyBytes { &byte, 1 })) {
                 set_fatal_error();
+                return;
             }
-            m_next_byte.clear();
+            m_bit_buffer >>= 8;
+            m_bit_count = m_bit_count > 8 ? m_bit_count - 8 : 0;
         }
+        m_bit_buffer = 0;
     }
 
     [[nodiscard]] size_t bit_offset() const
     {
-        return m_bit_offset;
+        return m_bit_count % 8;
     }
 
 private:
-    Optional<u8> m_next_byte;
-    size_t m_bit_offset { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     OutputStream& m_stream;
 };
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Assertions.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A Bloom filter that keeps a count per slot, so that hashes can be removed again as well as added.
+// Two slots are derived from each hash, so hashes should be well distributed over their lower 2 * KeyBits bits.
+// NOTE: Counters that reach their maximum stay there, which can only cause more false positives, never false negatives.
+template<size_t KeyBits>
+class CountingBloomFilter {
+    static_assert(KeyBits > 0 && KeyBits <= 16);
+
+public:
+    static constexpr size_t table_size = 1u << KeyBits;
+
+    void add(u32 hash)
+    {
+        increment(first_slot(hash));
+        increment(second_slot(hash));
+    }
+
+    void remove(u32 hash)
+    {
+        decrement(first_slot(hash));
+        decrement(second_slot(hash));
+    }
+
+    [[nodiscard]] bool may_contain(u32 hash) const
+    {
+        return m_counters[first_slot(hash)] != 0 && m_counters[second_slot(hash)] != 0;
+    }
+
+    void clear() { m_counters.fill(0); }
+
+private:
+    static constexpr u32 key_mask = table_size - 1;
+    static constexpr u8 maximum_count = NumericLimits<u8>::max();
+
+    static size_t first_slot(u32 hash) { return hash & key_mask; }
+    static size_t second_slot(u32 hash) { return (hash >> KeyBits) & key_mask; }
+
+    void increment(size_t slot)
+    {
+        if (m_counters[slot] != maximum_count)
+            ++m_counters[slot];
+    }
+
+    void decrement(size_t slot)
+    {
+        VERIFY(m_counters[slot] != 0);
+        if (m_counters[slot] != maximum_count)
+            --m_counters[slot];
+    }
+
+    Array<u8, table_size> m_counters {};
+};
+
+}
+
+using AK::CountingBloomFilter;
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// The decimal number mantissa * 10^exponent.
+struct FloatingPointDecimal {
+    u64 mantissa { 0 };
+    i32 exponent { 0 };
+};
+
+// Returns the decimal with the fewest digits that converts back to the given value, picking the one closest to it
+// if there are several. The value must be finite and greater than zero.
+FloatingPointDecimal convert_double_to_shortest_decimal(double);
+
+// Returns the double closest to mantissa * 10^exponent, rounding ties to even. In the very rare cases where that
+// can't be decided with 128 bits of precision, returns nothing so the caller can fall back to something slower.
+Optional<double> convert_decimal_to_double(u64 mantissa, i64 exponent);
+
+}
+
+using AK::convert_decimal_to_double;
+using AK::convert_double_to_shortest_decimal;
+using AK::FloatingPointDecimal;
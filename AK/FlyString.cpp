@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
 #include <AK/Optional.h>
@@ -11,6 +12,7 @@
 #include <AK/String.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
+#include <sched.h>
 
 namespace AK {
 
@@ -24,16 +26,75 @@ struct FlyStringImplTraits : public Traits<StringImpl*> {
     }
 };
 
-static Singleton<HashTable<StringImpl*, FlyStringImplTraits>> s_table;
+// The table is split into shards with a lock each, so threads interning different strings rarely have to wait
+// for each other. Shards are picked with the top bits of the hash, as the tables themselves use the bottom ones.
+class FlyStringTable {
+public:
+    static constexpr size_t shard_count_bits = 5;
+
+    class Shard {
+    public:
+        HashTable<StringImpl*, FlyStringImplTraits>& impls() { return m_impls; }
+
+        void lock()
+        {
+            for (;;) {
+                if (!m_locked.exchange(true, AK::memory_order_acquire))
+                    return;
+                while (m_locked.load(AK::memory_order_relaxed))
+                    sched_yield();
+            }
+        }
+
+        void unlock() { m_locked.store(false, AK::memory_order_release); }
+
+    private:
+        Atomic<bool> m_locked { false };
+        HashTable<StringImpl*, FlyStringImplTraits> m_impls;
+    };
+
+    class Locker {
+    public:
+        explicit Locker(Shard& shard)
+            : m_shard(shard)
+        {
+            m_shard.lock();
+        }
+        ~Locker() { m_shard.unlock(); }
+
+    private:
+        Shard& m_shard;
+    };
+
+    Shard& shard_for_hash(unsigned hash) { return m_shards[hash >> (32 - shard_count_bits)]; }
+
+private:
+    Array<Shard, 1 << shard_count_bits> m_shards;
+};
+
+static Singleton<FlyStringTable> s_table;
 
-static HashTable<StringImpl*, FlyStringImplTraits>& fly_impls()
+// Returns a new reference to the interned impl with the given contents, if there is one.
+// NOTE: An impl whose last reference is being dropped on another thread stays in the table until its destructor
+//       gets to remove it. try_ref() refuses to bring those back, and interning the same contents again replaces
+//       the dying entry. This is why removal goes by identity rather than by contents.
+template<typename Predicate>
+static RefPtr<StringImpl> find_fly_impl(FlyStringTable::Shard& shard, unsigned hash, Predicate predicate)
 {
-    return *s_table;
+    auto it = shard.impls().find(hash, predicate);
+    if (it == shard.impls().end() || !(*it)->try_ref())
+        return nullptr;
+    VERIFY((*it)->is_fly());
+    return adopt_ref(**it);
 }
 
 void FlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    auto& shard = s_table->shard_for_hash(impl.existing_hash());
+    FlyStringTable::Locker locker(shard);
+    auto it = shard.impls().find(impl.existing_hash(), [&](auto* candidate) { return candidate == &impl; });
+    if (it != shard.impls().end())
+        shard.impls().remove(it);
 }
 
 FlyString::FlyString(String const& string)
@@ -44,33 +105,34 @@ FlyString::FlyString(String const& string)
         m_impl = string.impl();
         return;
     }
-    auto it = fly_impls().find(const_cast<StringImpl*>(string.impl()));
-    if (it == fly_impls().end()) {
-        fly_impls().set(const_cast<StringImpl*>(string.impl()));
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+    auto& impl = const_cast<StringImpl&>(*string.impl());
+    auto hash = impl.hash();
+    auto& shard = s_table->shard_for_hash(hash);
+    FlyStringTable::Locker locker(shard);
+    m_impl = find_fly_impl(shard, hash, [&](auto* candidate) { return *candidate == impl; });
+    if (m_impl)
+        return;
+    shard.impls().set(&impl);
+    impl.set_fly({}, true);
+    m_impl = &impl;
 }
 
 FlyString::FlyString(StringView string)
 {
     if (string.is_null())
         return;
-    auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
-        return string == candidate;
-    });
-    if (it == fly_impls().end()) {
-        auto new_string = string.to_string();
-        fly_impls().set(new_string.impl());
-        new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+    auto hash = string.hash();
+    auto& shard = s_table->shard_for_hash(hash);
+    FlyStringTable::Locker locker(shard);
+    m_impl = find_fly_impl(shard, hash, [&](auto* candidate) { return string == candidate; });
+    if (m_impl)
+        return;
+    auto new_string = string.to_string();
+    auto& impl = const_cast<StringImpl&>(*new_string.impl());
+    impl.set_hash({}, hash);
+    shard.impls().set(&impl);
+    impl.set_fly({}, true);
+    m_impl = &impl;
 }
 
 template<typename T>
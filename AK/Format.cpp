@@ -53,24 +53,52 @@ static constexpr size_t convert_unsigned_to_string(u64 value, Array<u8, 128>& bu
 
     constexpr char const* lowercase_lookup = "0123456789abcdef";
     constexpr char const* uppercase_lookup = "0123456789ABCDEF";
+    // Decimal numbers are by far the most common, and halving the number of (slow) divisions for them pays off.
+    constexpr char const* decimal_pairs_lookup = "00010203040506070809"
+                                                 "10111213141516171819"
+                                                 "20212223242526272829"
+                                                 "30313233343536373839"
+                                                 "40414243444546474849"
+                                                 "50515253545556575859"
+                                                 "60616263646566676869"
+                                                 "70717273747576777879"
+                                                 "80818283848586878889"
+                                                 "90919293949596979899";
 
     if (value == 0) {
         buffer[0] = '0';
         return 1;
     }
 
-    size_t used = 0;
-    while (value > 0) {
-        if (upper_case)
-            buffer[used++] = uppercase_lookup[value % base];
-        else
-            buffer[used++] = lowercase_lookup[value % base];
+    // Write the digits backwards from the end of the buffer, then move them to the front.
+    size_t start = buffer.size();
+    if (base == 10) {
+        while (value >= 100) {
+            auto pair = (value % 100) * 2;
+            value /= 100;
+            buffer[--start] = decimal_pairs_lookup[pair + 1];
+            buffer[--start] = decimal_pairs_lookup[pair];
+        }
+        if (value >= 10) {
+            buffer[--start] = decimal_pairs_lookup[value * 2 + 1];
+            buffer[--start] = decimal_pairs_lookup[value * 2];
+        } else {
+            buffer[--start] = lowercase_lookup[value];
+        }
+    } else {
+        while (value > 0) {
+            if (upper_case)
+                buffer[--start] = uppercase_lookup[value % base];
+            else
+                buffer[--start] = lowercase_lookup[value % base];
 
-        value /= base;
+            value /= base;
+        }
     }
 
-    for (size_t i = 0; i < used / 2; ++i)
-        swap(buffer[i], buffer[used - i - 1]);
+    size_t used = buffer.size() - start;
+    for (size_t i = 0; i < used; ++i)
+        buffer[i] = buffer[start + i];
 
     return used;
 }
@@ -94,11 +94,11 @@ class FixedArray;
 template<size_t precision, typename Underlying = i32>
 class FixedPoint;
 
-template<typename>
+template<typename, size_t inline_capacity = 4 * sizeof(void*)>
 class Function;
 
-template<typename Out, typename... In>
-class Function<Out(In...)>;
+template<typename Out, typename... In, size_t inline_capacity>
+class Function<Out(In...), inline_capacity>;
 
 template<typename T>
 class NonnullRefPtr;
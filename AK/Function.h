@@ -29,15 +29,18 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/BitCast.h>
+#include <AK/Debug.h>
+#include <AK/Forward.h>
 #include <AK/Noncopyable.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 
-namespace AK {
+#if FUNCTION_DEBUG
+#    include <AK/Format.h>
+#endif
 
-template<typename>
-class Function;
+namespace AK {
 
 template<typename F>
 inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePointer<F>>);
@@ -46,8 +49,9 @@ inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePoin
 template<typename F>
 inline constexpr bool IsFunctionObject = (!IsFunctionPointer<F> && IsRvalueReference<F&&>);
 
-template<typename Out, typename... In>
-class Function<Out(In...)> {
+// Callables of up to inline_capacity bytes are stored in the Function itself, bigger ones are allocated on the heap.
+template<typename Out, typename... In, size_t inline_capacity>
+class Function<Out(In...), inline_capacity> {
     AK_MAKE_NONCOPYABLE(Function);
 
 public:
@@ -213,7 +217,10 @@ private:
     {
         VERIFY(m_call_nesting_level == 0);
         using WrapperType = CallableWrapper<Callable>;
-        if constexpr (sizeof(WrapperType) > inline_capacity) {
+        if constexpr (sizeof(WrapperType) > inline_storage_size || alignof(WrapperType) > storage_alignment) {
+#if FUNCTION_DEBUG
+            count_allocation<Callable>();
+#endif
             *bit_cast<CallableWrapperBase**>(&m_storage) = new WrapperType(forward<Callable>(callable));
             m_kind = FunctionKind::Outline;
         } else {
@@ -230,7 +237,7 @@ private:
         case FunctionKind::NullPointer:
             break;
         case FunctionKind::Inline:
-            other_wrapper->init_and_swap(m_storage, inline_capacity);
+            other_wrapper->init_and_swap(m_storage, inline_storage_size);
             m_kind = FunctionKind::Inline;
             break;
         case FunctionKind::Outline:
@@ -243,12 +250,27 @@ private:
         other.m_kind = FunctionKind::NullPointer;
     }
 
+#if FUNCTION_DEBUG
+    // Every lambda expression has a type of its own, so this counts the allocations for each place that
+    // makes a Function out of one. Places that allocate a lot are worth a bigger inline capacity.
+    template<typename Callable>
+    static void count_allocation()
+    {
+        static Atomic<size_t> s_allocation_count { 0 };
+        auto allocation_count = ++s_allocation_count;
+        if (is_power_of_two(allocation_count))
+            dbgln("Function: Allocated {} bytes for a callable {} times in {}", sizeof(CallableWrapper<Callable>), allocation_count, __PRETTY_FUNCTION__);
+    }
+#endif
+
+    // The wrapper around the callable starts with its vtable pointer.
+    static constexpr size_t inline_storage_size = sizeof(CallableWrapperBase) + inline_capacity;
+    static constexpr size_t storage_alignment = max(alignof(CallableWrapperBase), alignof(CallableWrapperBase*));
+
     FunctionKind m_kind { FunctionKind::NullPointer };
     bool m_deferred_clear { false };
     mutable Atomic<u16> m_call_nesting_level { 0 };
-    // Empirically determined to fit most lambdas and functions.
-    static constexpr size_t inline_capacity = 4 * sizeof(void*);
-    alignas(max(alignof(CallableWrapperBase), alignof(CallableWrapperBase*))) u8 m_storage[inline_capacity];
+    alignas(storage_alignment) u8 m_storage[inline_storage_size];
 };
 
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Concepts.h>
 #include <AK/Error.h>
 #include <AK/Forward.h>
@@ -28,28 +29,66 @@ enum class HashSetExistingEntryBehavior {
     Replace
 };
 
-// Upper nibble determines state class:
-// - 0: unused bucket
-// - 1: used bucket
-// - F: end bucket
-// Lower nibble determines state within a class.
-enum class BucketState : u8 {
-    Free = 0x00,
-    Used = 0x10,
-    Deleted = 0x01,
-    Rehashed = 0x12,
-    End = 0xFF,
-};
+namespace Detail {
+
+// Every bucket has a control byte, and those are kept in an array of their own so that lookups can check
+// a group of them at once with plain integer operations, which also works in the kernel:
+// - 0b0xxxxxxx: used bucket, with the lowest 7 bits of its hash
+// - 0x80: free bucket
+// - 0xFE: deleted bucket
+// - 0xFF: end marker, after the last bucket
+constexpr u8 free_bucket_control = 0x80;
+constexpr u8 deleted_bucket_control = 0xFE;
+constexpr u8 end_bucket_control = 0xFF;
 
-// Note that because there's the end state, used and free are not 100% opposites!
-constexpr bool is_used_bucket(BucketState state)
+constexpr bool is_used_bucket(u8 control)
 {
-    return (static_cast<u8>(state) & 0xf0) == 0x10;
+    return !(control & 0x80);
 }
 
-constexpr bool is_free_bucket(BucketState state)
-{
-    return (static_cast<u8>(state) & 0xf0) == 0x00;
+// A group of control bytes, loaded into one word. Bytes in the word are in memory order, as all our targets are little-endian.
+// The matches are returned with the highest bit of each matching byte set.
+class HashTableControlGroup {
+public:
+    static constexpr size_t width = sizeof(u64);
+
+    explicit HashTableControlGroup(u8 const* control)
+    {
+        __builtin_memcpy(&m_word, control, width);
+    }
+
+    // NOTE: This can have false positives right after a byte that actually matches, which the caller will
+    //       sort out when comparing keys anyway.
+    u64 match(u8 hash_fragment) const
+    {
+        auto difference = m_word ^ (lowest_bits * hash_fragment);
+        return (difference - lowest_bits) & ~difference & highest_bits;
+    }
+
+    u64 match_free() const
+    {
+        // Free is the only state with the highest bit set and the second lowest bit clear.
+        return m_word & (~m_word << 6) & highest_bits;
+    }
+
+    u64 match_free_or_deleted() const
+    {
+        // The end marker is the only state with the highest bit set that has the lowest bit set.
+        return m_word & (~m_word << 7) & highest_bits;
+    }
+
+    static size_t index_of_first(u64 matches)
+    {
+        return count_trailing_zeroes(matches) / 8;
+    }
+
+private:
+    static constexpr u64 lowest_bits = 0x0101010101010101;
+    static constexpr u64 highest_bits = 0x8080808080808080;
+
+    u64 m_word;
+};
+
 }
 
 template<typename HashTableType, typename T, typename BucketType>
@@ -70,19 +109,20 @@ private:
             return;
         do {
             ++m_bucket;
-            if (m_bucket->state == BucketState::Used)
-                return;
-        } while (m_bucket->state != BucketState::End);
-        if (m_bucket->state == BucketState::End)
+            ++m_control;
+        } while (!Detail::is_used_bucket(*m_control) && *m_control != Detail::end_bucket_control);
+        if (*m_control == Detail::end_bucket_control)
             m_bucket = nullptr;
     }
 
-    explicit HashTableIterator(BucketType* bucket)
+    HashTableIterator(BucketType* bucket, u8 const* control)
         : m_bucket(bucket)
+        , m_control(control)
     {
     }
 
     BucketType* m_bucket { nullptr };
+    u8 const* m_control { nullptr };
 };
 
 template<typename OrderedHashTableType, typename T, typename BucketType>
@@ -108,10 +148,13 @@ private:
 
 template<typename T, typename TraitsForT, bool IsOrdered>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
+    using ControlGroup = Detail::HashTableControlGroup;
+
+    // The table grows once 7/8 of its buckets are used or deleted.
+    static constexpr size_t max_load_numerator = 7;
+    static constexpr size_t max_load_denominator = 8;
 
     struct Bucket {
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
 
         T* slot() { return reinterpret_cast<T*>(storage); }
@@ -121,7 +164,6 @@ class HashTable {
     struct OrderedBucket {
         OrderedBucket* previous;
         OrderedBucket* next;
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
         T* slot() { return reinterpret_cast<T*>(storage); }
         const T* slot() const { return reinterpret_cast<const T*>(storage); }
@@ -148,9 +190,11 @@ public:
         if (!m_buckets)
             return;
 
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                m_buckets[i].slot()->~T();
+        if constexpr (!Detail::IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Detail::is_used_bucket(m_control[i]))
+                    m_buckets[i].slot()->~T();
+            }
         }
 
         kfree_sized(m_buckets, size_in_bytes(m_capacity));
@@ -158,6 +202,8 @@ public:
 
     HashTable(HashTable const& other)
     {
+        if (other.is_empty())
+            return;
         rehash(other.capacity());
         for (auto& it : other)
             set(it);
@@ -172,6 +218,7 @@ public:
 
     HashTable(HashTable&& other) noexcept
         : m_buckets(other.m_buckets)
+        , m_control(other.m_control)
         , m_collection_data(other.m_collection_data)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
@@ -181,6 +228,7 @@ public:
         other.m_capacity = 0;
         other.m_deleted_count = 0;
         other.m_buckets = nullptr;
+        other.m_control = nullptr;
         if constexpr (IsOrdered)
             other.m_collection_data = { nullptr, nullptr };
     }
@@ -195,6 +243,7 @@ public:
     friend void swap(HashTable& a, HashTable& b) noexcept
     {
         swap(a.m_buckets, b.m_buckets);
+        swap(a.m_control, b.m_control);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
         swap(a.m_deleted_count, b.m_deleted_count);
@@ -222,14 +271,16 @@ public:
 
     void ensure_capacity(size_t capacity)
     {
-        VERIFY(capacity >= size());
-        rehash(capacity * 2);
+        MUST(try_ensure_capacity(capacity));
     }
 
     ErrorOr<void> try_ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        return try_rehash(capacity * 2);
+        auto new_capacity = capacity_for_size(capacity);
+        if (new_capacity <= m_capacity)
+            return {};
+        return try_rehash(new_capacity);
     }
 
     [[nodiscard]] bool contains(T const& value) const
@@ -249,19 +300,23 @@ public:
 
     [[nodiscard]] Iterator begin()
     {
-        if constexpr (IsOrdered)
+        if constexpr (IsOrdered) {
             return Iterator(m_collection_data.head);
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return Iterator(&m_buckets[i]);
+        } else {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Detail::is_used_bucket(m_control[i]))
+                    return Iterator(&m_buckets[i], &m_control[i]);
+            }
+            return end();
         }
-        return end();
     }
 
     [[nodiscard]] Iterator end()
     {
-        return Iterator(nullptr);
+        if constexpr (IsOrdered)
+            return Iterator(nullptr);
+        else
+            return Iterator(nullptr, nullptr);
     }
 
     using ConstIterator = Conditional<IsOrdered,
@@ -270,19 +325,23 @@ public:
 
     [[nodiscard]] ConstIterator begin() const
     {
-        if constexpr (IsOrdered)
+        if constexpr (IsOrdered) {
             return ConstIterator(m_collection_data.head);
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return ConstIterator(&m_buckets[i]);
+        } else {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Detail::is_used_bucket(m_control[i]))
+                    return ConstIterator(&m_buckets[i], &m_control[i]);
+            }
+            return end();
         }
-        return end();
     }
 
     [[nodiscard]] ConstIterator end() const
     {
-        return ConstIterator(nullptr);
+        if constexpr (IsOrdered)
+            return ConstIterator(nullptr);
+        else
+            return ConstIterator(nullptr, nullptr);
     }
 
     void clear()
@@ -291,46 +350,59 @@ public:
     }
     void clear_with_capacity()
     {
+        if (!m_buckets)
+            return;
         if constexpr (!Detail::IsTriviallyDestructible<T>) {
-            for (auto* bucket : *this)
-                bucket->~T();
+            for (auto& value : *this)
+                value.~T();
         }
-        __builtin_memset(m_buckets, 0, size_in_bytes(capacity()));
+        __builtin_memset(m_control, Detail::free_bucket_control, m_capacity);
         m_size = 0;
         m_deleted_count = 0;
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
     }
 
     template<typename U = T>
     ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
     {
-        auto* bucket = TRY(try_lookup_for_writing(value));
-        if (is_used_bucket(bucket->state)) {
-            if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
-                return HashSetResult::KeptExistingEntry;
-            (*bucket->slot()) = forward<U>(value);
-            return HashSetResult::ReplacedExistingEntry;
-        }
-
-        new (bucket->slot()) T(forward<U>(value));
-        if (bucket->state == BucketState::Deleted)
-            --m_deleted_count;
-        bucket->state = BucketState::Used;
+        if (should_grow())
+            TRY(try_grow());
 
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = bucket;
-            } else {
-                bucket->previous = m_collection_data.tail;
-                m_collection_data.tail->next = bucket;
+        auto hash = TraitsForT::hash(value);
+        auto hash_fragment = hash_fragment_for(hash);
+        // Where the value goes if it's not in the table yet.
+        size_t first_unused_index = m_capacity;
+        for (ProbeSequence probe { *this, hash }; true; probe.next()) {
+            ControlGroup group { &m_control[probe.index()] };
+            for (auto matches = group.match(hash_fragment); matches; matches &= matches - 1) {
+                auto& bucket = m_buckets[probe.index() + ControlGroup::index_of_first(matches)];
+                if (!TraitsForT::equals(*bucket.slot(), value))
+                    continue;
+                if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
+                    return HashSetResult::KeptExistingEntry;
+                (*bucket.slot()) = forward<U>(value);
+                return HashSetResult::ReplacedExistingEntry;
+            }
+            if (first_unused_index == m_capacity) {
+                if (auto unused = group.match_free_or_deleted())
+                    first_unused_index = probe.index() + ControlGroup::index_of_first(unused);
             }
-            m_collection_data.tail = bucket;
+            if (group.match_free())
+                break;
         }
 
+        auto index = first_unused_index;
+        VERIFY(index < m_capacity);
+        if (m_control[index] == Detail::deleted_bucket_control)
+            --m_deleted_count;
+        m_control[index] = hash_fragment;
+        auto& bucket = m_buckets[index];
+        new (bucket.slot()) T(forward<U>(value));
+        if constexpr (IsOrdered)
+            link_bucket(bucket);
+
         ++m_size;
         return HashSetResult::InsertedNewEntry;
     }
@@ -343,7 +415,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
     {
-        return Iterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_for(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] Iterator find(T const& value)
@@ -354,7 +426,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_for(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] ConstIterator find(T const& value) const
@@ -411,14 +483,10 @@ public:
     void remove(Iterator iterator)
     {
         VERIFY(iterator.m_bucket);
-        auto& bucket = *iterator.m_bucket;
-        VERIFY(is_used_bucket(bucket.state));
+        auto index = static_cast<size_t>(iterator.m_bucket - m_buckets);
+        VERIFY(Detail::is_used_bucket(m_control[index]));
 
-        delete_bucket(bucket);
-        --m_size;
-        ++m_deleted_count;
-
-        rehash_in_place_if_needed();
+        delete_bucket(index);
     }
 
     template<typename TUnaryPredicate>
@@ -426,81 +494,154 @@ public:
     {
         size_t removed_count = 0;
         for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot())) {
-                delete_bucket(bucket);
+            if (Detail::is_used_bucket(m_control[i]) && predicate(*m_buckets[i].slot())) {
+                delete_bucket(i);
                 ++removed_count;
             }
         }
-        if (removed_count) {
-            m_deleted_count += removed_count;
-            m_size -= removed_count;
-        }
-        rehash_in_place_if_needed();
         return removed_count;
     }
 
 private:
-    void insert_during_rehash(T&& value)
+    // Probes a group of buckets at a time, with the distance to the next group growing by one group
+    // every time. As the number of groups is a power of two, this visits each of them once.
+    class ProbeSequence {
+    public:
+        ProbeSequence(HashTable const& table, unsigned hash)
+            : m_group_mask(table.m_capacity / ControlGroup::width - 1)
+        {
+            // Multiplying by the golden ratio spreads the entropy of the hash over its upper bits, so
+            // that hashes which only differ in their lower bits, or aren't mixed at all, still spread out.
+            auto mixed_hash = static_cast<u32>(hash * 2654435769u);
+            m_group = (static_cast<u64>(mixed_hash) * (m_group_mask + 1)) >> 32;
+        }
+
+        size_t index() const { return m_group * ControlGroup::width; }
+
+        void next()
+        {
+            ++m_distance;
+            m_group = (m_group + m_distance) & m_group_mask;
+        }
+
+    private:
+        size_t m_group_mask;
+        size_t m_group { 0 };
+        size_t m_distance { 0 };
+    };
+
+    static u8 hash_fragment_for(unsigned hash)
     {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.state = BucketState::Used;
+        return hash & 0x7f;
+    }
 
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = &bucket;
-            } else {
-                bucket.previous = m_collection_data.tail;
-                m_collection_data.tail->next = &bucket;
+    Iterator iterator_for(BucketType* bucket)
+    {
+        if constexpr (IsOrdered)
+            return Iterator(bucket);
+        else
+            return bucket ? Iterator(bucket, &m_control[bucket - m_buckets]) : end();
+    }
+
+    ConstIterator iterator_for(BucketType const* bucket) const
+    {
+        if constexpr (IsOrdered)
+            return ConstIterator(bucket);
+        else
+            return bucket ? ConstIterator(bucket, &m_control[bucket - m_buckets]) : end();
+    }
+
+    void link_bucket(BucketType& bucket)
+    {
+        static_assert(IsOrdered);
+        bucket.previous = m_collection_data.tail;
+        bucket.next = nullptr;
+        if (!m_collection_data.head) [[unlikely]]
+            m_collection_data.head = &bucket;
+        else
+            m_collection_data.tail->next = &bucket;
+        m_collection_data.tail = &bucket;
+    }
+
+    void insert_during_rehash(T&& value)
+    {
+        auto hash = TraitsForT::hash(value);
+        for (ProbeSequence probe { *this, hash }; true; probe.next()) {
+            ControlGroup group { &m_control[probe.index()] };
+            if (auto free = group.match_free()) {
+                auto index = probe.index() + ControlGroup::index_of_first(free);
+                m_control[index] = hash_fragment_for(hash);
+                auto& bucket = m_buckets[index];
+                new (bucket.slot()) T(move(value));
+                if constexpr (IsOrdered)
+                    link_bucket(bucket);
+                return;
             }
-            m_collection_data.tail = &bucket;
         }
     }
 
     [[nodiscard]] static constexpr size_t size_in_bytes(size_t capacity)
     {
-        if constexpr (IsOrdered) {
-            return sizeof(BucketType) * capacity;
-        } else {
-            return sizeof(BucketType) * (capacity + 1);
-        }
+        // The control bytes follow the buckets, with the end marker after them.
+        return sizeof(BucketType) * capacity + capacity + 1;
     }
 
-    ErrorOr<void> try_rehash(size_t new_capacity)
+    [[nodiscard]] static constexpr size_t capacity_for_size(size_t size)
     {
-        if (new_capacity == m_capacity && new_capacity >= 4) {
-            rehash_in_place();
-            return {};
-        }
+        size_t capacity = ControlGroup::width;
+        while (capacity * max_load_numerator < size * max_load_denominator)
+            capacity *= 2;
+        return capacity;
+    }
 
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
-        new_capacity = kmalloc_good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        new_capacity = max(capacity_for_size(m_size + 1), new_capacity);
+        // The number of buckets is a power of two and a multiple of the group width.
+        size_t capacity = ControlGroup::width;
+        while (capacity < new_capacity)
+            capacity *= 2;
+        new_capacity = capacity;
 
         auto* old_buckets = m_buckets;
+        auto* old_control = m_control;
         auto old_capacity = m_capacity;
-        Iterator old_iter = begin();
+        auto old_head = [&]() -> BucketType* {
+            if constexpr (IsOrdered)
+                return m_collection_data.head;
+            return nullptr;
+        }();
 
-        auto* new_buckets = kcalloc(1, size_in_bytes(new_capacity));
+        auto* new_buckets = kmalloc(size_in_bytes(new_capacity));
         if (!new_buckets)
             return Error::from_errno(ENOMEM);
 
         m_buckets = (BucketType*)new_buckets;
+        m_control = reinterpret_cast<u8*>(m_buckets + new_capacity);
+        __builtin_memset(m_control, Detail::free_bucket_control, new_capacity);
+        m_control[new_capacity] = Detail::end_bucket_control;
 
         m_capacity = new_capacity;
         m_deleted_count = 0;
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
 
         if (!old_buckets)
             return {};
 
-        for (auto it = move(old_iter); it != end(); ++it) {
-            insert_during_rehash(move(*it));
-            it->~T();
+        if constexpr (IsOrdered) {
+            for (auto* bucket = old_head; bucket; bucket = bucket->next) {
+                insert_during_rehash(move(*bucket->slot()));
+                bucket->slot()->~T();
+            }
+        } else {
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (!Detail::is_used_bucket(old_control[i]))
+                    continue;
+                insert_during_rehash(move(*old_buckets[i].slot()));
+                old_buckets[i].slot()->~T();
+            }
         }
 
         kfree_sized(old_buckets, size_in_bytes(old_capacity));
@@ -511,134 +652,12 @@ private:
         MUST(try_rehash(new_capacity));
     }
 
-    void rehash_in_place()
+    ErrorOr<void> try_grow()
     {
-        // FIXME: This implementation takes two loops over the entire bucket array, but avoids re-allocation.
-        //        Please benchmark your new implementation before you replace this.
-        //        The reason is that because of collisions, we use the special "rehashed" bucket state to mark already-rehashed used buckets.
-        //        Because we of course want to write into old used buckets, but already rehashed data shall not be touched.
-
-        // FIXME: Find a way to reduce the cognitive complexity of this function.
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-
-            // FIXME: Bail out when we have handled every filled bucket.
-
-            if (bucket.state == BucketState::Rehashed || bucket.state == BucketState::End || bucket.state == BucketState::Free)
-                continue;
-            if (bucket.state == BucketState::Deleted) {
-                bucket.state = BucketState::Free;
-                continue;
-            }
-
-            auto const new_hash = TraitsForT::hash(*bucket.slot());
-            if (new_hash % m_capacity == i) {
-                bucket.state = BucketState::Rehashed;
-                continue;
-            }
-
-            auto target_hash = new_hash;
-            auto const to_move_hash = i;
-            BucketType* target_bucket = &m_buckets[target_hash % m_capacity];
-            BucketType* bucket_to_move = &m_buckets[i];
-
-            // Try to move the bucket to move into its correct spot.
-            // During the procedure, we might re-hash or actually change the bucket to move.
-            while (!is_free_bucket(bucket_to_move->state)) {
-
-                // If we're targeting ourselves, there's nothing to do.
-                if (to_move_hash == target_hash % m_capacity) {
-                    bucket_to_move->state = BucketState::Rehashed;
-                    break;
-                }
-
-                if (is_free_bucket(target_bucket->state)) {
-                    // We can just overwrite the target bucket and bail out.
-                    new (target_bucket->slot()) T(move(*bucket_to_move->slot()));
-                    target_bucket->state = BucketState::Rehashed;
-                    bucket_to_move->state = BucketState::Free;
-
-                    if constexpr (IsOrdered) {
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-                } else if (target_bucket->state == BucketState::Rehashed) {
-                    // If the target bucket is already re-hashed, we do normal probing.
-                    target_hash = double_hash(target_hash);
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-                } else {
-                    VERIFY(target_bucket->state != BucketState::End);
-                    // The target bucket is a used bucket that hasn't been re-hashed.
-                    // Swap the data into the target; now the target's data resides in the bucket to move again.
-                    // (That's of course what we want, how neat!)
-                    swap(*bucket_to_move->slot(), *target_bucket->slot());
-                    bucket_to_move->state = target_bucket->state;
-                    target_bucket->state = BucketState::Rehashed;
-
-                    if constexpr (IsOrdered) {
-                        // Update state for the target bucket, we'll do the bucket to move later.
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-
-                    target_hash = TraitsForT::hash(*bucket_to_move->slot());
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-
-                    // The data is already in the correct location: Adjust the pointers
-                    if (target_hash % m_capacity == to_move_hash) {
-                        bucket_to_move->state = BucketState::Rehashed;
-                        if constexpr (IsOrdered) {
-                            // Update state for the bucket to move as it's not actually moved anymore.
-                            if (bucket_to_move->previous)
-                                bucket_to_move->previous->next = bucket_to_move;
-                            else
-                                m_collection_data.head = bucket_to_move;
-                            if (bucket_to_move->next)
-                                bucket_to_move->next->previous = bucket_to_move;
-                            else
-                                m_collection_data.tail = bucket_to_move;
-                        }
-                        break;
-                    }
-                }
-            }
-            // After this, the bucket_to_move either contains data that rehashes to itself, or it contains nothing as we were able to move the last thing.
-            if (bucket_to_move->state == BucketState::Deleted)
-                bucket_to_move->state = BucketState::Free;
-        }
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].state == BucketState::Rehashed)
-                m_buckets[i].state = BucketState::Used;
-        }
-
-        m_deleted_count = 0;
-    }
-
-    void rehash_in_place_if_needed()
-    {
-        // This signals a "thrashed" hash table with many deleted slots.
-        if (m_deleted_count >= m_size && should_grow())
-            rehash_in_place();
+        // A table that is mostly full of deleted buckets only needs them cleaned out.
+        if (m_deleted_count >= m_size)
+            return try_rehash(m_capacity);
+        return try_rehash(m_capacity * 2);
     }
 
     template<typename TUnaryPredicate>
@@ -647,57 +666,37 @@ private:
         if (is_empty())
             return nullptr;
 
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot()))
-                return &bucket;
-
-            if (bucket.state != BucketState::Used && bucket.state != BucketState::Deleted)
-                return nullptr;
-
-            hash = double_hash(hash);
-        }
-    }
-
-    ErrorOr<BucketType*> try_lookup_for_writing(T const& value)
-    {
-        // FIXME: Maybe overrun the "allowed" load factor to avoid OOM
-        //        If we are allowed to do that, separate that logic from
-        //        the normal lookup_for_writing
-        if (should_grow())
-            TRY(try_rehash(capacity() * 2));
-        auto hash = TraitsForT::hash(value);
-        BucketType* first_empty_bucket = nullptr;
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && TraitsForT::equals(*bucket.slot(), value))
-                return &bucket;
-
-            if (!is_used_bucket(bucket.state)) {
-                if (!first_empty_bucket)
-                    first_empty_bucket = &bucket;
-
-                if (bucket.state != BucketState::Deleted)
-                    return const_cast<BucketType*>(first_empty_bucket);
+        auto hash_fragment = hash_fragment_for(hash);
+        for (ProbeSequence probe { *this, hash }; true; probe.next()) {
+            ControlGroup group { &m_control[probe.index()] };
+            for (auto matches = group.match(hash_fragment); matches; matches &= matches - 1) {
+                auto& bucket = m_buckets[probe.index() + ControlGroup::index_of_first(matches)];
+                if (predicate(*bucket.slot()))
+                    return &bucket;
             }
-
-            hash = double_hash(hash);
+            if (group.match_free())
+                return nullptr;
         }
     }
-    [[nodiscard]] BucketType& lookup_for_writing(T const& value)
-    {
-        return *MUST(try_lookup_for_writing(value));
-    }
 
     [[nodiscard]] size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    [[nodiscard]] bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
+    [[nodiscard]] bool should_grow() const { return (used_bucket_count() + 1) * max_load_denominator > m_capacity * max_load_numerator; }
 
-    void delete_bucket(auto& bucket)
+    void delete_bucket(size_t index)
     {
+        auto& bucket = m_buckets[index];
         bucket.slot()->~T();
-        bucket.state = BucketState::Deleted;
+
+        // Lookups stop at the first group that has a free bucket, so a bucket in such a group can be freed
+        // right away. Groups only get free buckets back by rehashing, so no lookup ever went past this one.
+        auto group_index = index - index % ControlGroup::width;
+        if (ControlGroup { &m_control[group_index] }.match_free()) {
+            m_control[index] = Detail::free_bucket_control;
+        } else {
+            m_control[index] = Detail::deleted_bucket_control;
+            ++m_deleted_count;
+        }
+        --m_size;
 
         if constexpr (IsOrdered) {
             if (bucket.previous)
@@ -714,6 +713,7 @@ private:
     }
 
     BucketType* m_buckets { nullptr };
+    u8* m_control { nullptr };
 
     [[no_unique_address]] CollectionDataType m_collection_data;
     size_t m_size { 0 };
@@ -8,6 +8,8 @@
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonParser.h>
+#include <AK/UnicodeUtils.h>
+#include <AK/Variant.h>
 #include <math.h>
 
 namespace AK {
@@ -17,99 +19,95 @@ constexpr bool is_space(int ch)
     return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
 }
 
-ErrorOr<String> JsonParser::consume_and_unescape_string()
+// Returns how many of the leading bytes can be copied into a string as they are. That's everything up to the
+// closing quote, an escape or a control character, which is found a word at a time.
+static size_t plain_string_prefix_length(StringView input)
+{
+    constexpr u64 ones = 0x0101010101010101ull;
+    constexpr u64 high_bits = 0x8080808080808080ull;
+    auto has_zero_byte = [&](u64 word) { return (word - ones) & ~word & high_bits; };
+    auto has_byte_below_space = [&](u64 word) { return (word - ones * ' ') & ~word & high_bits; };
+
+    auto const* characters = input.characters_without_null_termination();
+    size_t offset = 0;
+    for (; offset + sizeof(u64) <= input.length(); offset += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, characters + offset, sizeof(word));
+        if (has_zero_byte(word ^ (ones * '"')) || has_zero_byte(word ^ (ones * '\\')) || has_byte_below_space(word))
+            break;
+    }
+    for (; offset < input.length(); ++offset) {
+        char ch = characters[offset];
+        if (ch == '"' || ch == '\\' || is_ascii_c0_control(ch))
+            break;
+    }
+    return offset;
+}
+
+ErrorOr<StringView> JsonParser::consume_and_unescape_string()
 {
     if (!consume_specific('"'))
         return Error::from_string_literal("JsonParser: Expected '\"'");
-    StringBuilder final_sb;
 
-    for (;;) {
-        size_t peek_index = m_index;
-        char ch = 0;
-        for (;;) {
-            if (peek_index == m_input.length())
-                break;
-            ch = m_input[peek_index];
-            if (ch == '"' || ch == '\\')
-                break;
-            if (is_ascii_c0_control(ch))
-                return Error::from_string_literal("JsonParser: Error while parsing string");
-            ++peek_index;
-        }
+    // Most strings don't contain any escapes, and can be handed out straight from the input.
+    auto plain_length = plain_string_prefix_length(remaining());
+    if (m_index + plain_length < m_input.length() && m_input[m_index + plain_length] == '"') {
+        auto string = m_input.substring_view(m_index, plain_length);
+        m_index += plain_length + 1;
+        return string;
+    }
 
-        while (peek_index != m_index) {
-            final_sb.append(m_input[m_index]);
-            m_index++;
-        }
+    m_string_buffer.clear_with_capacity();
+    auto append = [&](char ch) { m_string_buffer.append(ch); };
 
-        if (m_index == m_input.length())
-            break;
-        if (ch == '"')
+    for (;;) {
+        auto plain_length = plain_string_prefix_length(remaining());
+        m_string_buffer.append(m_input.characters_without_null_termination() + m_index, plain_length);
+        m_index += plain_length;
+
+        if (is_eof() || peek() == '"')
             break;
-        if (ch != '\\') {
-            final_sb.append(consume());
-            continue;
-        }
+        if (peek() != '\\')
+            return Error::from_string_literal("JsonParser: Error while parsing string");
         ignore();
-        if (next_is('"')) {
-            ignore();
-            final_sb.append('"');
-            continue;
-        }
-
-        if (next_is('\\')) {
-            ignore();
-            final_sb.append('\\');
-            continue;
-        }
 
-        if (next_is('/')) {
-            ignore();
-            final_sb.append('/');
+        switch (peek()) {
+        case '"':
+        case '\\':
+        case '/':
+            append(consume());
             continue;
-        }
-
-        if (next_is('n')) {
+        case 'n':
             ignore();
-            final_sb.append('\n');
+            append('\n');
             continue;
-        }
-
-        if (next_is('r')) {
+        case 'r':
             ignore();
-            final_sb.append('\r');
+            append('\r');
             continue;
-        }
-
-        if (next_is('t')) {
+        case 't':
             ignore();
-            final_sb.append('\t');
+            append('\t');
             continue;
-        }
-
-        if (next_is('b')) {
+        case 'b':
             ignore();
-            final_sb.append('\b');
+            append('\b');
             continue;
-        }
-
-        if (next_is('f')) {
+        case 'f':
             ignore();
-            final_sb.append('\f');
+            append('\f');
             continue;
-        }
-
-        if (next_is('u')) {
+        case 'u': {
             ignore();
             if (tell_remaining() < 4)
                 return Error::from_string_literal("JsonParser: EOF while parsing Unicode escape");
 
             auto code_point = AK::StringUtils::convert_to_uint_from_hex(consume(4));
-            if (code_point.has_value()) {
-                final_sb.append_code_point(code_point.value());
-                continue;
-            }
-            return Error::from_string_literal("JsonParser: Error while parsing Unicode escape");
+            if (!code_point.has_value())
+                return Error::from_string_literal("JsonParser: Error while parsing Unicode escape");
+            (void)AK::UnicodeUtils::code_point_to_utf8(code_point.value(), append);
+            continue;
+        }
         }
 
         return Error::from_string_literal("JsonParser: Error while parsing string");
@@ -117,28 +115,26 @@ ErrorOr<String> JsonParser::consume_and_unescape_string()
     if (!consume_specific('"'))
         return Error::from_string_literal("JsonParser: Expected '\"'");
 
-    return final_sb.to_string();
+    return StringView { m_string_buffer.data(), m_string_buffer.size() };
 }
 
-ErrorOr<JsonValue> JsonParser::parse_object()
+ErrorOr<void> JsonParser::parse_object(Handler& handler)
 {
-    JsonObject object;
     if (!consume_specific('{'))
         return Error::from_string_literal("JsonParser: Expected '{'");
+    TRY(handler.on_object_start());
     for (;;) {
         ignore_while(is_space);
         if (peek() == '}')
             break;
         ignore_while(is_space);
         auto name = TRY(consume_and_unescape_string());
-        if (name.is_null())
-            return Error::from_string_literal("JsonParser: Expected object property name");
+        TRY(handler.on_object_key(name));
         ignore_while(is_space);
         if (!consume_specific(':'))
             return Error::from_string_literal("JsonParser: Expected ':'");
         ignore_while(is_space);
-        auto value = TRY(parse_helper());
-        object.set(name, move(value));
+        TRY(parse_helper(handler));
         ignore_while(is_space);
         if (peek() == '}')
             break;
@@ -150,20 +146,19 @@ ErrorOr<JsonValue> JsonParser::parse_object()
     }
     if (!consume_specific('}'))
         return Error::from_string_literal("JsonParser: Expected '}'");
-    return JsonValue { move(object) };
+    return handler.on_object_end();
 }
 
-ErrorOr<JsonValue> JsonParser::parse_array()
+ErrorOr<void> JsonParser::parse_array(Handler& handler)
 {
-    JsonArray array;
     if (!consume_specific('['))
         return Error::from_string_literal("JsonParser: Expected '['");
+    TRY(handler.on_array_start());
     for (;;) {
         ignore_while(is_space);
         if (peek() == ']')
             break;
-        auto element = TRY(parse_helper());
-        array.append(move(element));
+        TRY(parse_helper(handler));
         ignore_while(is_space);
         if (peek() == ']')
             break;
@@ -176,13 +171,7 @@ ErrorOr<JsonValue> JsonParser::parse_array()
     ignore_while(is_space);
     if (!consume_specific(']'))
         return Error::from_string_literal("JsonParser: Expected ']'");
-    return JsonValue { move(array) };
-}
-
-ErrorOr<JsonValue> JsonParser::parse_string()
-{
-    auto string = TRY(consume_and_unescape_string());
-    return JsonValue(move(string));
+    return handler.on_array_end();
 }
 
 ErrorOr<JsonValue> JsonParser::parse_number()
@@ -307,17 +296,17 @@ ErrorOr<JsonValue> JsonParser::parse_null()
     return JsonValue(JsonValue::Type::Null);
 }
 
-ErrorOr<JsonValue> JsonParser::parse_helper()
+ErrorOr<void> JsonParser::parse_helper(Handler& handler)
 {
     ignore_while(is_space);
     auto type_hint = peek();
     switch (type_hint) {
     case '{':
-        return parse_object();
+        return parse_object(handler);
     case '[':
-        return parse_array();
+        return parse_array(handler);
     case '"':
-        return parse_string();
+        return handler.on_string(TRY(consume_and_unescape_string()));
     case '-':
     case '0':
     case '1':
@@ -329,25 +318,93 @@ ErrorOr<JsonValue> JsonParser::parse_helper()
     case '7':
     case '8':
     case '9':
-        return parse_number();
+        return handler.on_value(TRY(parse_number()));
     case 'f':
-        return parse_false();
+        return handler.on_value(TRY(parse_false()));
     case 't':
-        return parse_true();
+        return handler.on_value(TRY(parse_true()));
     case 'n':
-        return parse_null();
+        return handler.on_value(TRY(parse_null()));
     }
 
     return Error::from_string_literal("JsonParser: Unexpected character");
 }
 
-ErrorOr<JsonValue> JsonParser::parse()
+ErrorOr<void> JsonParser::parse(Handler& handler)
 {
-    auto result = TRY(parse_helper());
+    TRY(parse_helper(handler));
     ignore_while(is_space);
     if (!is_eof())
         return Error::from_string_literal("JsonParser: Didn't consume all input");
-    return result;
+    return {};
+}
+
+// Puts the parts of a document back together into a JsonValue.
+class JsonValueBuilder final : public JsonParser::Handler {
+public:
+    JsonValue take_value() { return move(m_value); }
+
+    virtual ErrorOr<void> on_object_start() override
+    {
+        m_containers.append({ JsonObject {}, {} });
+        return {};
+    }
+
+    virtual ErrorOr<void> on_object_key(StringView key) override
+    {
+        m_containers.last().key = key;
+        return {};
+    }
+
+    virtual ErrorOr<void> on_object_end() override
+    {
+        auto container = m_containers.take_last();
+        return add(JsonValue { move(container.value.get<JsonObject>()) });
+    }
+
+    virtual ErrorOr<void> on_array_start() override
+    {
+        m_containers.append({ JsonArray {}, {} });
+        return {};
+    }
+
+    virtual ErrorOr<void> on_array_end() override
+    {
+        auto container = m_containers.take_last();
+        return add(JsonValue { move(container.value.get<JsonArray>()) });
+    }
+
+    virtual ErrorOr<void> on_string(StringView string) override { return add(JsonValue { string }); }
+    virtual ErrorOr<void> on_value(JsonValue value) override { return add(move(value)); }
+
+private:
+    ErrorOr<void> add(JsonValue value)
+    {
+        if (m_containers.is_empty()) {
+            m_value = move(value);
+            return {};
+        }
+        auto& container = m_containers.last();
+        container.value.visit(
+            [&](JsonObject& object) { object.set(container.key, move(value)); },
+            [&](JsonArray& array) { array.append(move(value)); });
+        return {};
+    }
+
+    struct Container {
+        Variant<JsonObject, JsonArray> value;
+        String key;
+    };
+
+    Vector<Container> m_containers;
+    JsonValue m_value;
+};
+
+ErrorOr<JsonValue> JsonParser::parse()
+{
+    JsonValueBuilder builder;
+    TRY(parse(builder));
+    return builder.take_value();
 }
 
 }
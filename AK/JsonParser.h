@@ -8,29 +8,51 @@
 
 #include <AK/GenericLexer.h>
 #include <AK/JsonValue.h>
+#include <AK/Vector.h>
 
 namespace AK {
 
 class JsonParser : private GenericLexer {
 public:
+    // Receives the parts of a document as they are parsed, so that whatever the JSON is turned into can be
+    // built directly, without going through a JsonValue tree first. Returning an error stops the parse.
+    // NOTE: The views passed to on_object_key() and on_string() point into the input where possible, and into
+    //       a buffer that's reused for the next string otherwise. They are only valid until the call returns.
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+
+        virtual ErrorOr<void> on_object_start() = 0;
+        virtual ErrorOr<void> on_object_key(StringView) = 0;
+        virtual ErrorOr<void> on_object_end() = 0;
+        virtual ErrorOr<void> on_array_start() = 0;
+        virtual ErrorOr<void> on_array_end() = 0;
+        virtual ErrorOr<void> on_string(StringView) = 0;
+        // Called with everything else: null, booleans and numbers.
+        virtual ErrorOr<void> on_value(JsonValue) = 0;
+    };
+
     explicit JsonParser(StringView input)
         : GenericLexer(input)
     {
     }
 
     ErrorOr<JsonValue> parse();
+    ErrorOr<void> parse(Handler&);
 
 private:
-    ErrorOr<JsonValue> parse_helper();
+    ErrorOr<void> parse_helper(Handler&);
 
-    ErrorOr<String> consume_and_unescape_string();
-    ErrorOr<JsonValue> parse_array();
-    ErrorOr<JsonValue> parse_object();
+    ErrorOr<StringView> consume_and_unescape_string();
+    ErrorOr<void> parse_array(Handler&);
+    ErrorOr<void> parse_object(Handler&);
     ErrorOr<JsonValue> parse_number();
-    ErrorOr<JsonValue> parse_string();
     ErrorOr<JsonValue> parse_false();
     ErrorOr<JsonValue> parse_true();
     ErrorOr<JsonValue> parse_null();
+
+    // Unescaped strings that can't be referred to in the input go here.
+    Vector<char, 128> m_string_buffer;
 };
 
 }
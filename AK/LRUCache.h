@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Concepts.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+
+namespace AK {
+
+// A map that evicts its least recently used entries once the total cost of its entries exceeds its capacity.
+// Unless a cost function is given, every entry costs 1, which makes the capacity a limit on the number of entries.
+template<typename K, typename V, typename KeyTraits = Traits<K>>
+class LRUCache {
+public:
+    using CostFunction = Function<size_t(K const&, V const&)>;
+
+    explicit LRUCache(size_t capacity, CostFunction cost_function = {})
+        : m_capacity(capacity)
+        , m_cost_function(move(cost_function))
+    {
+    }
+
+    [[nodiscard]] size_t size() const { return m_entries.size(); }
+    [[nodiscard]] bool is_empty() const { return m_entries.is_empty(); }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+    [[nodiscard]] size_t total_cost() const { return m_total_cost; }
+
+    [[nodiscard]] bool contains(K const& key) const { return m_entries.contains(key); }
+
+    // Returns the value for the key and makes it the most recently used entry.
+    // NOTE: The pointer is only valid until the cache is modified again.
+    V* get(K const& key) { return touch(m_entries.find(key)); }
+
+    template<Concepts::HashCompatible<K> Key>
+    requires(IsSame<KeyTraits, Traits<K>>) V* get(Key const& key)
+    {
+        return touch(m_entries.find(key));
+    }
+
+    // Inserts or replaces the entry for the key as the most recently used one, then evicts the least recently used
+    // entries until the cache is within its capacity again. Entries that cost more than the capacity aren't kept.
+    void set(K key, V value)
+    {
+        remove(key);
+        auto cost = m_cost_function ? m_cost_function(key, value) : 1;
+        if (cost > m_capacity)
+            return;
+        m_total_cost += cost;
+        m_entries.set(move(key), Entry { move(value), cost });
+        evict_until_within(m_capacity);
+    }
+
+    Optional<V> take(K const& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return {};
+        auto value = move(it->value.value);
+        m_total_cost -= it->value.cost;
+        m_entries.remove(it);
+        return value;
+    }
+
+    bool remove(K const& key) { return take(key).has_value(); }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_total_cost = 0;
+    }
+
+    void set_capacity(size_t capacity)
+    {
+        m_capacity = capacity;
+        evict_until_within(m_capacity);
+    }
+
+    // Evicts the least recently used entries until the total cost is at most the given one, without changing the capacity.
+    void evict_until_within(size_t cost)
+    {
+        while (m_total_cost > cost && !m_entries.is_empty()) {
+            auto least_recently_used = m_entries.begin();
+            m_total_cost -= least_recently_used->value.cost;
+            m_entries.remove(least_recently_used);
+        }
+    }
+
+private:
+    struct Entry {
+        V value;
+        size_t cost { 0 };
+    };
+
+    using MapType = OrderedHashMap<K, Entry, KeyTraits>;
+
+    // The map is kept in order of use, so a hit moves its entry to the back, and the front is evicted first.
+    V* touch(typename MapType::IteratorType it)
+    {
+        if (it == m_entries.end())
+            return nullptr;
+        auto key = it->key;
+        auto entry = move(it->value);
+        m_entries.remove(it);
+        m_entries.set(key, move(entry));
+        return &m_entries.find(key)->value.value;
+    }
+
+    MapType m_entries;
+    size_t m_capacity { 0 };
+    size_t m_total_cost { 0 };
+    CostFunction m_cost_function;
+};
+
+}
+
+using AK::LRUCache;
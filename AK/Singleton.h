@@ -12,6 +12,7 @@
 #ifdef KERNEL
 #    include <Kernel/Arch/Processor.h>
 #    include <Kernel/Arch/ScopedCritical.h>
+#    include <Kernel/Locking/RWSpinlockProtected.h>
 #    include <Kernel/Locking/SpinlockProtected.h>
 #else
 #    include <sched.h>
@@ -41,6 +42,14 @@ struct SingletonInstanceCreator<Kernel::SpinlockProtected<T>> {
         return new Kernel::SpinlockProtected<T> { Kernel::LockRank::None };
     }
 };
+
+template<typename T>
+struct SingletonInstanceCreator<Kernel::RWSpinlockProtected<T>> {
+    static Kernel::RWSpinlockProtected<T>* create()
+    {
+        return new Kernel::RWSpinlockProtected<T> { Kernel::LockRank::None };
+    }
+};
 #endif
 
 template<typename T, T* (*InitFunction)() = SingletonInstanceCreator<T>::create>
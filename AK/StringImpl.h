@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -41,6 +42,40 @@ public:
 
     static StringImpl& the_empty_stringimpl();
 
+    // Fly impls are shared by every thread that interns the same text, so their reference count is updated atomically.
+    // Every other impl keeps the cheaper plain count, which is only ever touched by threads that share it knowingly.
+    ALWAYS_INLINE void ref() const
+    {
+        if (!m_fly)
+            return RefCounted::ref();
+        auto old_ref_count = AK::atomic_fetch_add(&m_ref_count, 1u, AK::memory_order_relaxed);
+        VERIFY(old_ref_count > 0);
+    }
+
+    [[nodiscard]] bool try_ref() const
+    {
+        if (!m_fly)
+            return RefCounted::try_ref();
+        auto ref_count = AK::atomic_load(&m_ref_count, AK::memory_order_relaxed);
+        do {
+            if (ref_count == 0)
+                return false;
+        } while (!AK::atomic_compare_exchange_strong(&m_ref_count, ref_count, ref_count + 1, AK::memory_order_acquire));
+        return true;
+    }
+
+    ALWAYS_INLINE bool unref() const
+    {
+        if (!m_fly)
+            return RefCounted::unref();
+        auto old_ref_count = AK::atomic_fetch_sub(&m_ref_count, 1u, AK::memory_order_acq_rel);
+        VERIFY(old_ref_count > 0);
+        if (old_ref_count != 1)
+            return false;
+        delete this;
+        return true;
+    }
+
     ~StringImpl();
 
     size_t length() const { return m_length; }
@@ -79,6 +114,11 @@ public:
 
     bool is_fly() const { return m_fly; }
     void set_fly(Badge<FlyString>, bool fly) const { m_fly = fly; }
+    void set_hash(Badge<FlyString>, unsigned hash) const
+    {
+        m_hash = hash;
+        m_has_hash = true;
+    }
 
 private:
     enum ConstructTheEmptyStringImplTag {
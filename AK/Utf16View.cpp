@@ -20,31 +20,49 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<typename UtfViewType>
-static Vector<u16, 1> to_utf16_impl(UtfViewType const& view) requires(IsSame<UtfViewType, Utf8View> || IsSame<UtfViewType, Utf32View>)
-{
-    Vector<u16, 1> utf16_data;
-    utf16_data.ensure_capacity(view.length());
-
-    for (auto code_point : view)
-        code_point_to_utf16(utf16_data, code_point);
-
-    return utf16_data;
-}
-
 Vector<u16, 1> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 Vector<u16, 1> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    auto const* bytes = reinterpret_cast<u8 const*>(utf8_view.as_string().characters_without_null_termination());
+    size_t remaining = utf8_view.byte_length();
+
+    Vector<u16, 1> utf16_data;
+    utf16_data.ensure_capacity(utf8_view.length());
+
+    while (remaining > 0) {
+        auto ascii_length = Detail::ascii_prefix_length(bytes, remaining);
+        utf16_data.ensure_capacity(utf16_data.size() + ascii_length);
+        for (size_t i = 0; i < ascii_length; ++i)
+            utf16_data.unchecked_append(bytes[i]);
+        bytes += ascii_length;
+        remaining -= ascii_length;
+        if (remaining == 0)
+            break;
+
+        // Stepping over the code point's underlying bytes matches what iterating the view would do, invalid sequences included.
+        auto iterator = Utf8View { StringView { bytes, remaining } }.begin();
+        code_point_to_utf16(utf16_data, *iterator);
+        auto code_point_length_in_bytes = iterator.underlying_code_point_length_in_bytes();
+        bytes += code_point_length_in_bytes;
+        remaining -= code_point_length_in_bytes;
+    }
+
+    return utf16_data;
 }
 
 Vector<u16, 1> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Vector<u16, 1> utf16_data;
+    utf16_data.ensure_capacity(utf32_view.length());
+
+    for (auto code_point : utf32_view)
+        code_point_to_utf16(utf16_data, code_point);
+
+    return utf16_data;
 }
 
 void code_point_to_utf16(Vector<u16, 1>& string, u32 code_point)
@@ -102,6 +102,12 @@ bool Utf8View::validate(size_t& valid_bytes) const
 {
     valid_bytes = 0;
     for (auto ptr = begin_ptr(); ptr < end_ptr(); ptr++) {
+        auto ascii_length = Detail::ascii_prefix_length(ptr, end_ptr() - ptr);
+        valid_bytes += ascii_length;
+        ptr += ascii_length;
+        if (ptr == end_ptr())
+            break;
+
         size_t code_point_length_in_bytes = 0;
         u32 code_point = 0;
         bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, code_point);
@@ -131,8 +137,15 @@ bool Utf8View::validate(size_t& valid_bytes) const
 size_t Utf8View::calculate_length() const
 {
     size_t length = 0;
-    for ([[maybe_unused]] auto code_point : *this) {
-        ++length;
+    for (auto iterator = begin(); !iterator.done(); ++length) {
+        // Every ASCII byte is a code point of its own, so runs of them can be counted without decoding anything.
+        if (auto ascii_length = Detail::ascii_prefix_length(iterator.m_ptr, iterator.m_length); ascii_length > 0) {
+            iterator.m_ptr += ascii_length;
+            iterator.m_length -= ascii_length;
+            length += ascii_length - 1;
+            continue;
+        }
+        ++iterator;
     }
     return length;
 }
@@ -13,6 +13,28 @@
 
 namespace AK {
 
+namespace Detail {
+
+// Returns how many of the leading bytes are ASCII. Runs of ASCII are checked a word at a time, as that's what
+// most text mostly consists of.
+inline size_t ascii_prefix_length(u8 const* bytes, size_t length)
+{
+    constexpr u64 high_bits = 0x8080808080808080ull;
+
+    size_t offset = 0;
+    for (; offset + sizeof(u64) <= length; offset += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, bytes + offset, sizeof(word));
+        if (word & high_bits)
+            break;
+    }
+    while (offset < length && bytes[offset] < 0x80)
+        ++offset;
+    return offset;
+}
+
+}
+
 class Utf8View;
 
 class Utf8CodePointIterator {
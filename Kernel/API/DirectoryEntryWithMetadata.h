@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+#ifdef KERNEL
+#    include <Kernel/API/POSIX/sys/stat.h>
+#else
+#    include <sys/stat.h>
+#endif
+
+// This is what get_dir_entries_with_metadata() writes for every entry of a directory, back to back.
+struct [[gnu::packed]] DirectoryEntryWithMetadata {
+    u64 inode_index { 0 };
+    u8 file_type { 0 };
+    // The kernel leaves out the metadata when it can't hand it out without a lookup of its own (for example across mount
+    // points, or in processes that have unveiled paths), in which case stat() has to be asked instead.
+    bool has_metadata { false };
+    struct stat metadata {
+    };
+    u32 name_length { 0 };
+    // This is a VLA which is written by get_dir_entries_with_metadata().
+    char name[];
+
+    size_t total_size() const { return sizeof(DirectoryEntryWithMetadata) + name_length; }
+};
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is a shared memory mapping with a submission queue and a completion queue.
+// Userspace produces submissions and consumes completions, the kernel does the opposite
+// whenever io_ring_enter() is called. The mapping starts with an IORingHeader, followed by
+// the submission entries and then the completion entries.
+
+enum class IORingOpcode : u8 {
+    Nop = 0,
+    Read,   // read() at the current offset
+    Write,  // write() at the current offset
+    PRead,  // pread() at the given offset
+    PWrite, // pwrite() at the given offset
+};
+
+struct IORingSubmission {
+    IORingOpcode opcode;
+    u8 reserved0;
+    u16 reserved1;
+    i32 fd;
+    u64 offset;
+    u64 buffer;
+    u32 length;
+    u32 reserved2;
+    u64 user_data;
+};
+
+struct IORingCompletion {
+    u64 user_data;
+    // The number of bytes transferred, or a negated errno.
+    i64 result;
+};
+
+struct IORingHeader {
+    // Head indices are advanced by the consumer, tail indices by the producer.
+    // Indices wrap around freely, the entry for an index is at (index & (entries - 1)).
+    u32 submission_head;
+    u32 submission_tail;
+    u32 completion_head;
+    u32 completion_tail;
+    u32 submission_entries;
+    u32 completion_entries;
+    u32 submissions_offset;
+    u32 completions_offset;
+};
+
+static constexpr u32 io_ring_max_entries = 4096;
+
+// There is room for twice as many completions as submissions, so completions can pile up
+// while userspace keeps submitting.
+constexpr u32 io_ring_completion_entries(u32 submission_entries)
+{
+    return submission_entries * 2;
+}
+
+constexpr size_t io_ring_submissions_offset()
+{
+    return (sizeof(IORingHeader) + 63) & ~static_cast<size_t>(63);
+}
+
+constexpr size_t io_ring_completions_offset(u32 submission_entries)
+{
+    return io_ring_submissions_offset() + submission_entries * sizeof(IORingSubmission);
+}
+
+constexpr size_t io_ring_mapping_size(u32 submission_entries)
+{
+    return io_ring_completions_offset(submission_entries) + io_ring_completion_entries(submission_entries) * sizeof(IORingCompletion);
+}
@@ -49,6 +49,9 @@ extern "C" {
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -58,6 +61,10 @@ extern "C" {
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// The layout of a priority inheritance futex: the owner's thread ID, and a flag telling it to unlock through the kernel.
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 #ifdef __cplusplus
 }
 #endif
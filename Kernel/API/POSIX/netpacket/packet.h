@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The protocol of a packet socket is an ethertype in network byte order, or this for all of them.
+#define ETH_P_ALL 0x0003
+
+// Note: There are no interface indices, so sll_ifindex has to be 0. Use SO_BINDTODEVICE to pick an interface.
+struct sockaddr_ll {
+    sa_family_t sll_family;
+    uint16_t sll_protocol;
+    int sll_ifindex;
+    uint16_t sll_hatype;
+    uint8_t sll_pkttype;
+    uint8_t sll_halen;
+    uint8_t sll_addr[8];
+};
+
+enum {
+    PACKET_RX_RING = 1,
+    PACKET_TX_RING,
+    PACKET_STATISTICS,
+};
+#define PACKET_RX_RING PACKET_RX_RING
+#define PACKET_TX_RING PACKET_TX_RING
+#define PACKET_STATISTICS PACKET_STATISTICS
+
+// A ring is set up with setsockopt(SOL_PACKET, PACKET_RX_RING or PACKET_TX_RING), and then mapped with a shared
+// mmap() of the socket at offset 0. If both rings are set up, the TX ring follows the RX ring in the same mapping.
+// The block size has to be a multiple of the page size and of the frame size, and the frame count has to fill
+// all blocks, so frame n simply starts at n * tp_frame_size.
+struct tpacket_req {
+    unsigned int tp_block_size;
+    unsigned int tp_block_nr;
+    unsigned int tp_frame_size;
+    unsigned int tp_frame_nr;
+};
+
+// Every frame starts with this header, the packet itself starts at tp_mac bytes into the frame.
+// Whoever owns a frame according to tp_status may touch the rest of it.
+struct tpacket_hdr {
+    unsigned long tp_status;
+    unsigned int tp_len;
+    unsigned int tp_snaplen;
+    unsigned short tp_mac;
+    unsigned short tp_net;
+    unsigned int tp_sec;
+    unsigned int tp_usec;
+};
+
+// RX frames are handed to userspace by the kernel, which sets them to TP_STATUS_USER. Userspace gives them back
+// by setting them to TP_STATUS_KERNEL.
+#define TP_STATUS_KERNEL 0
+#define TP_STATUS_USER (1 << 0)
+// Packets were dropped before this one because the ring was full.
+#define TP_STATUS_LOSING (1 << 2)
+
+// TX frames are handed to the kernel by setting them to TP_STATUS_SEND_REQUEST, and get sent by the next send()
+// on the socket, which may have an empty buffer. The kernel gives them back as TP_STATUS_AVAILABLE, or as
+// TP_STATUS_WRONG_FORMAT if the packet couldn't be sent.
+#define TP_STATUS_AVAILABLE 0
+#define TP_STATUS_SEND_REQUEST (1 << 0)
+#define TP_STATUS_WRONG_FORMAT (1 << 2)
+
+#define TPACKET_ALIGNMENT 16
+#define TPACKET_ALIGN(x) (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
+struct tpacket_stats {
+    unsigned int tp_packets;
+    unsigned int tp_drops;
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -33,10 +33,29 @@ enum {
     PERF_EVENT_SYSCALL = 16384,
     PERF_EVENT_SIGNPOST = 32768,
     PERF_EVENT_READ = 65536,
+    PERF_EVENT_LOCK_CONTENTION = 131072,
+    PERF_EVENT_CPU_CYCLES = 262144,
+    PERF_EVENT_CACHE_MISSES = 524288,
+    PERF_EVENT_BRANCH_MISSES = 1048576,
+    PERF_EVENT_TLB_MISSES = 2097152,
 };
 
+#define PERF_EVENT_HARDWARE_COUNTERS (PERF_EVENT_CPU_CYCLES | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES | PERF_EVENT_TLB_MISSES)
+
 #define PERF_EVENT_MASK_ALL (~0ull)
 
+// A signpost recorded by a userspace tracepoint, which are handed to the kernel in batches with perf_signposts().
+struct perf_signpost {
+    // Milliseconds since boot, like the timestamps of all other performance events.
+    uint64_t timestamp;
+    uintptr_t string_id;
+    uintptr_t arg;
+    // The address of the tracepoint, and the return address of the function it is in.
+    uintptr_t stack[2];
+};
+
+#define PERF_SIGNPOSTS_MAX_BATCH 32
+
 #define THREAD_PRIORITY_MIN 1
 #define THREAD_PRIORITY_LOW 10
 #define THREAD_PRIORITY_NORMAL 30
@@ -20,11 +20,13 @@ extern "C" {
 #define AF_UNIX AF_LOCAL
 #define AF_INET 2
 #define AF_INET6 3
-#define AF_MAX 4
+#define AF_PACKET 4
+#define AF_MAX 5
 #define PF_LOCAL AF_LOCAL
 #define PF_UNIX PF_LOCAL
 #define PF_INET AF_INET
 #define PF_INET6 AF_INET6
+#define PF_PACKET AF_PACKET
 #define PF_UNSPEC AF_UNSPEC
 #define PF_MAX AF_MAX
 
@@ -96,6 +98,7 @@ struct linger {
 };
 
 #define SOL_SOCKET 1
+#define SOL_PACKET 263
 #define SOMAXCONN 128
 
 enum {
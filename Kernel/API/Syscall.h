@@ -12,6 +12,7 @@
 constexpr int syscall_vector = 0x82;
 
 extern "C" {
+struct epoll_event;
 struct pollfd;
 struct timeval;
 struct timespec;
@@ -38,160 +39,168 @@ enum class NeedsBigProcessLock {
 //   - VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
 //   - VERIFY_NO_PROCESS_BIG_LOCK(this)
 //
-#define ENUMERATE_SYSCALLS(S)                               \
-    S(accept4, NeedsBigProcessLock::No)                     \
-    S(access, NeedsBigProcessLock::Yes)                     \
-    S(adjtime, NeedsBigProcessLock::No)                     \
-    S(alarm, NeedsBigProcessLock::Yes)                      \
-    S(allocate_tls, NeedsBigProcessLock::Yes)               \
-    S(anon_create, NeedsBigProcessLock::No)                 \
-    S(beep, NeedsBigProcessLock::No)                        \
-    S(bind, NeedsBigProcessLock::No)                        \
-    S(chdir, NeedsBigProcessLock::No)                       \
-    S(chmod, NeedsBigProcessLock::No)                       \
-    S(chown, NeedsBigProcessLock::No)                       \
-    S(clock_gettime, NeedsBigProcessLock::No)               \
-    S(clock_nanosleep, NeedsBigProcessLock::No)             \
-    S(clock_getres, NeedsBigProcessLock::No)                \
-    S(clock_settime, NeedsBigProcessLock::No)               \
-    S(close, NeedsBigProcessLock::No)                       \
-    S(connect, NeedsBigProcessLock::No)                     \
-    S(create_inode_watcher, NeedsBigProcessLock::Yes)       \
-    S(create_thread, NeedsBigProcessLock::Yes)              \
-    S(dbgputstr, NeedsBigProcessLock::No)                   \
-    S(detach_thread, NeedsBigProcessLock::Yes)              \
-    S(disown, NeedsBigProcessLock::Yes)                     \
-    S(dump_backtrace, NeedsBigProcessLock::No)              \
-    S(dup2, NeedsBigProcessLock::No)                        \
-    S(emuctl, NeedsBigProcessLock::No)                      \
-    S(execve, NeedsBigProcessLock::Yes)                     \
-    S(exit, NeedsBigProcessLock::Yes)                       \
-    S(exit_thread, NeedsBigProcessLock::Yes)                \
-    S(fchdir, NeedsBigProcessLock::No)                      \
-    S(fchmod, NeedsBigProcessLock::No)                      \
-    S(fchown, NeedsBigProcessLock::No)                      \
-    S(fcntl, NeedsBigProcessLock::Yes)                      \
-    S(fork, NeedsBigProcessLock::Yes)                       \
-    S(fstat, NeedsBigProcessLock::No)                       \
-    S(fstatvfs, NeedsBigProcessLock::No)                    \
-    S(fsync, NeedsBigProcessLock::No)                       \
-    S(ftruncate, NeedsBigProcessLock::No)                   \
-    S(futex, NeedsBigProcessLock::Yes)                      \
-    S(get_dir_entries, NeedsBigProcessLock::Yes)            \
-    S(get_process_name, NeedsBigProcessLock::Yes)           \
-    S(get_stack_bounds, NeedsBigProcessLock::No)            \
-    S(get_thread_name, NeedsBigProcessLock::Yes)            \
-    S(getcwd, NeedsBigProcessLock::No)                      \
-    S(getegid, NeedsBigProcessLock::No)                     \
-    S(geteuid, NeedsBigProcessLock::No)                     \
-    S(getgid, NeedsBigProcessLock::No)                      \
-    S(getgroups, NeedsBigProcessLock::No)                   \
-    S(gethostname, NeedsBigProcessLock::No)                 \
-    S(getkeymap, NeedsBigProcessLock::No)                   \
-    S(getpeername, NeedsBigProcessLock::Yes)                \
-    S(getpgid, NeedsBigProcessLock::Yes)                    \
-    S(getpgrp, NeedsBigProcessLock::Yes)                    \
-    S(getpid, NeedsBigProcessLock::No)                      \
-    S(getppid, NeedsBigProcessLock::No)                     \
-    S(getrandom, NeedsBigProcessLock::No)                   \
-    S(getresgid, NeedsBigProcessLock::No)                   \
-    S(getresuid, NeedsBigProcessLock::No)                   \
-    S(getrusage, NeedsBigProcessLock::Yes)                  \
-    S(getsid, NeedsBigProcessLock::Yes)                     \
-    S(getsockname, NeedsBigProcessLock::Yes)                \
-    S(getsockopt, NeedsBigProcessLock::No)                  \
-    S(gettid, NeedsBigProcessLock::No)                      \
-    S(getuid, NeedsBigProcessLock::No)                      \
-    S(inode_watcher_add_watch, NeedsBigProcessLock::Yes)    \
-    S(inode_watcher_remove_watch, NeedsBigProcessLock::Yes) \
-    S(ioctl, NeedsBigProcessLock::Yes)                      \
-    S(join_thread, NeedsBigProcessLock::Yes)                \
-    S(kill, NeedsBigProcessLock::Yes)                       \
-    S(kill_thread, NeedsBigProcessLock::Yes)                \
-    S(killpg, NeedsBigProcessLock::Yes)                     \
-    S(link, NeedsBigProcessLock::No)                        \
-    S(listen, NeedsBigProcessLock::No)                      \
-    S(lseek, NeedsBigProcessLock::No)                       \
-    S(madvise, NeedsBigProcessLock::Yes)                    \
-    S(map_time_page, NeedsBigProcessLock::Yes)              \
-    S(mkdir, NeedsBigProcessLock::No)                       \
-    S(mknod, NeedsBigProcessLock::No)                       \
-    S(mmap, NeedsBigProcessLock::Yes)                       \
-    S(mount, NeedsBigProcessLock::Yes)                      \
-    S(mprotect, NeedsBigProcessLock::Yes)                   \
-    S(mremap, NeedsBigProcessLock::Yes)                     \
-    S(msync, NeedsBigProcessLock::Yes)                      \
-    S(msyscall, NeedsBigProcessLock::Yes)                   \
-    S(munmap, NeedsBigProcessLock::Yes)                     \
-    S(open, NeedsBigProcessLock::Yes)                       \
-    S(perf_event, NeedsBigProcessLock::Yes)                 \
-    S(perf_register_string, NeedsBigProcessLock::Yes)       \
-    S(pipe, NeedsBigProcessLock::No)                        \
-    S(pledge, NeedsBigProcessLock::Yes)                     \
-    S(poll, NeedsBigProcessLock::Yes)                       \
-    S(posix_fallocate, NeedsBigProcessLock::No)             \
-    S(prctl, NeedsBigProcessLock::Yes)                      \
-    S(profiling_disable, NeedsBigProcessLock::Yes)          \
-    S(profiling_enable, NeedsBigProcessLock::Yes)           \
-    S(profiling_free_buffer, NeedsBigProcessLock::Yes)      \
-    S(ptrace, NeedsBigProcessLock::Yes)                     \
-    S(purge, NeedsBigProcessLock::Yes)                      \
-    S(read, NeedsBigProcessLock::Yes)                       \
-    S(pread, NeedsBigProcessLock::Yes)                      \
-    S(readlink, NeedsBigProcessLock::No)                    \
-    S(readv, NeedsBigProcessLock::Yes)                      \
-    S(realpath, NeedsBigProcessLock::No)                    \
-    S(recvfd, NeedsBigProcessLock::No)                      \
-    S(recvmsg, NeedsBigProcessLock::Yes)                    \
-    S(rename, NeedsBigProcessLock::No)                      \
-    S(rmdir, NeedsBigProcessLock::No)                       \
-    S(sched_getparam, NeedsBigProcessLock::No)              \
-    S(sched_setparam, NeedsBigProcessLock::No)              \
-    S(sendfd, NeedsBigProcessLock::No)                      \
-    S(sendmsg, NeedsBigProcessLock::Yes)                    \
-    S(set_coredump_metadata, NeedsBigProcessLock::No)       \
-    S(set_mmap_name, NeedsBigProcessLock::Yes)              \
-    S(set_process_name, NeedsBigProcessLock::Yes)           \
-    S(set_thread_name, NeedsBigProcessLock::Yes)            \
-    S(setegid, NeedsBigProcessLock::No)                     \
-    S(seteuid, NeedsBigProcessLock::No)                     \
-    S(setgid, NeedsBigProcessLock::No)                      \
-    S(setgroups, NeedsBigProcessLock::No)                   \
-    S(sethostname, NeedsBigProcessLock::No)                 \
-    S(setkeymap, NeedsBigProcessLock::No)                   \
-    S(setpgid, NeedsBigProcessLock::Yes)                    \
-    S(setresgid, NeedsBigProcessLock::No)                   \
-    S(setresuid, NeedsBigProcessLock::No)                   \
-    S(setreuid, NeedsBigProcessLock::No)                    \
-    S(setsid, NeedsBigProcessLock::Yes)                     \
-    S(setsockopt, NeedsBigProcessLock::No)                  \
-    S(setuid, NeedsBigProcessLock::No)                      \
-    S(shutdown, NeedsBigProcessLock::No)                    \
-    S(sigaction, NeedsBigProcessLock::Yes)                  \
-    S(sigaltstack, NeedsBigProcessLock::Yes)                \
-    S(sigpending, NeedsBigProcessLock::Yes)                 \
-    S(sigprocmask, NeedsBigProcessLock::Yes)                \
-    S(sigreturn, NeedsBigProcessLock::Yes)                  \
-    S(sigsuspend, NeedsBigProcessLock::Yes)                 \
-    S(sigtimedwait, NeedsBigProcessLock::Yes)               \
-    S(socket, NeedsBigProcessLock::No)                      \
-    S(socketpair, NeedsBigProcessLock::No)                  \
-    S(stat, NeedsBigProcessLock::No)                        \
-    S(statvfs, NeedsBigProcessLock::No)                     \
-    S(symlink, NeedsBigProcessLock::No)                     \
-    S(sync, NeedsBigProcessLock::No)                        \
-    S(sysconf, NeedsBigProcessLock::No)                     \
-    S(times, NeedsBigProcessLock::Yes)                      \
-    S(umask, NeedsBigProcessLock::Yes)                      \
-    S(umount, NeedsBigProcessLock::Yes)                     \
-    S(uname, NeedsBigProcessLock::No)                       \
-    S(unlink, NeedsBigProcessLock::No)                      \
-    S(unveil, NeedsBigProcessLock::No)                      \
-    S(utime, NeedsBigProcessLock::No)                       \
-    S(utimensat, NeedsBigProcessLock::No)                   \
-    S(waitid, NeedsBigProcessLock::Yes)                     \
-    S(write, NeedsBigProcessLock::Yes)                      \
-    S(writev, NeedsBigProcessLock::Yes)                     \
+#define ENUMERATE_SYSCALLS(S)                                  \
+    S(accept4, NeedsBigProcessLock::No)                        \
+    S(access, NeedsBigProcessLock::Yes)                        \
+    S(adjtime, NeedsBigProcessLock::No)                        \
+    S(alarm, NeedsBigProcessLock::Yes)                         \
+    S(allocate_tls, NeedsBigProcessLock::Yes)                  \
+    S(anon_create, NeedsBigProcessLock::No)                    \
+    S(beep, NeedsBigProcessLock::No)                           \
+    S(bind, NeedsBigProcessLock::No)                           \
+    S(chdir, NeedsBigProcessLock::No)                          \
+    S(chmod, NeedsBigProcessLock::No)                          \
+    S(chown, NeedsBigProcessLock::No)                          \
+    S(clock_gettime, NeedsBigProcessLock::No)                  \
+    S(clock_nanosleep, NeedsBigProcessLock::No)                \
+    S(clock_getres, NeedsBigProcessLock::No)                   \
+    S(clock_settime, NeedsBigProcessLock::No)                  \
+    S(close, NeedsBigProcessLock::No)                          \
+    S(connect, NeedsBigProcessLock::No)                        \
+    S(create_inode_watcher, NeedsBigProcessLock::Yes)          \
+    S(create_thread, NeedsBigProcessLock::Yes)                 \
+    S(dbgputstr, NeedsBigProcessLock::No)                      \
+    S(detach_thread, NeedsBigProcessLock::Yes)                 \
+    S(disown, NeedsBigProcessLock::Yes)                        \
+    S(dump_backtrace, NeedsBigProcessLock::No)                 \
+    S(dup2, NeedsBigProcessLock::No)                           \
+    S(emuctl, NeedsBigProcessLock::No)                         \
+    S(epoll_create, NeedsBigProcessLock::No)                   \
+    S(epoll_ctl, NeedsBigProcessLock::No)                      \
+    S(epoll_wait, NeedsBigProcessLock::No)                     \
+    S(execve, NeedsBigProcessLock::Yes)                        \
+    S(exit, NeedsBigProcessLock::Yes)                          \
+    S(exit_thread, NeedsBigProcessLock::Yes)                   \
+    S(fchdir, NeedsBigProcessLock::No)                         \
+    S(fchmod, NeedsBigProcessLock::No)                         \
+    S(fchown, NeedsBigProcessLock::No)                         \
+    S(fcntl, NeedsBigProcessLock::Yes)                         \
+    S(fork, NeedsBigProcessLock::Yes)                          \
+    S(fstat, NeedsBigProcessLock::No)                          \
+    S(fstatvfs, NeedsBigProcessLock::No)                       \
+    S(fsync, NeedsBigProcessLock::No)                          \
+    S(ftruncate, NeedsBigProcessLock::No)                      \
+    S(futex, NeedsBigProcessLock::Yes)                         \
+    S(get_dir_entries, NeedsBigProcessLock::Yes)               \
+    S(get_dir_entries_with_metadata, NeedsBigProcessLock::Yes) \
+    S(get_process_name, NeedsBigProcessLock::Yes)              \
+    S(get_stack_bounds, NeedsBigProcessLock::No)               \
+    S(get_thread_name, NeedsBigProcessLock::Yes)               \
+    S(getcwd, NeedsBigProcessLock::No)                         \
+    S(getegid, NeedsBigProcessLock::No)                        \
+    S(geteuid, NeedsBigProcessLock::No)                        \
+    S(getgid, NeedsBigProcessLock::No)                         \
+    S(getgroups, NeedsBigProcessLock::No)                      \
+    S(gethostname, NeedsBigProcessLock::No)                    \
+    S(getkeymap, NeedsBigProcessLock::No)                      \
+    S(getpeername, NeedsBigProcessLock::Yes)                   \
+    S(getpgid, NeedsBigProcessLock::Yes)                       \
+    S(getpgrp, NeedsBigProcessLock::Yes)                       \
+    S(getpid, NeedsBigProcessLock::No)                         \
+    S(getppid, NeedsBigProcessLock::No)                        \
+    S(getrandom, NeedsBigProcessLock::No)                      \
+    S(getresgid, NeedsBigProcessLock::No)                      \
+    S(getresuid, NeedsBigProcessLock::No)                      \
+    S(getrusage, NeedsBigProcessLock::Yes)                     \
+    S(getsid, NeedsBigProcessLock::Yes)                        \
+    S(getsockname, NeedsBigProcessLock::Yes)                   \
+    S(getsockopt, NeedsBigProcessLock::No)                     \
+    S(gettid, NeedsBigProcessLock::No)                         \
+    S(getuid, NeedsBigProcessLock::No)                         \
+    S(inode_watcher_add_watch, NeedsBigProcessLock::Yes)       \
+    S(inode_watcher_remove_watch, NeedsBigProcessLock::Yes)    \
+    S(io_ring_create, NeedsBigProcessLock::No)                 \
+    S(io_ring_enter, NeedsBigProcessLock::Yes)                 \
+    S(ioctl, NeedsBigProcessLock::Yes)                         \
+    S(join_thread, NeedsBigProcessLock::Yes)                   \
+    S(kill, NeedsBigProcessLock::Yes)                          \
+    S(kill_thread, NeedsBigProcessLock::Yes)                   \
+    S(killpg, NeedsBigProcessLock::Yes)                        \
+    S(link, NeedsBigProcessLock::No)                           \
+    S(listen, NeedsBigProcessLock::No)                         \
+    S(lseek, NeedsBigProcessLock::No)                          \
+    S(madvise, NeedsBigProcessLock::Yes)                       \
+    S(map_time_page, NeedsBigProcessLock::Yes)                 \
+    S(mkdir, NeedsBigProcessLock::No)                          \
+    S(mknod, NeedsBigProcessLock::No)                          \
+    S(mmap, NeedsBigProcessLock::Yes)                          \
+    S(mount, NeedsBigProcessLock::Yes)                         \
+    S(mprotect, NeedsBigProcessLock::Yes)                      \
+    S(mremap, NeedsBigProcessLock::Yes)                        \
+    S(msync, NeedsBigProcessLock::Yes)                         \
+    S(msyscall, NeedsBigProcessLock::Yes)                      \
+    S(munmap, NeedsBigProcessLock::Yes)                        \
+    S(open, NeedsBigProcessLock::Yes)                          \
+    S(perf_event, NeedsBigProcessLock::Yes)                    \
+    S(perf_register_string, NeedsBigProcessLock::Yes)          \
+    S(perf_signposts, NeedsBigProcessLock::Yes)                \
+    S(pipe, NeedsBigProcessLock::No)                           \
+    S(pledge, NeedsBigProcessLock::Yes)                        \
+    S(poll, NeedsBigProcessLock::Yes)                          \
+    S(posix_fallocate, NeedsBigProcessLock::No)                \
+    S(prctl, NeedsBigProcessLock::Yes)                         \
+    S(profiling_disable, NeedsBigProcessLock::Yes)             \
+    S(profiling_enable, NeedsBigProcessLock::Yes)              \
+    S(profiling_free_buffer, NeedsBigProcessLock::Yes)         \
+    S(ptrace, NeedsBigProcessLock::Yes)                        \
+    S(purge, NeedsBigProcessLock::Yes)                         \
+    S(read, NeedsBigProcessLock::Yes)                          \
+    S(pread, NeedsBigProcessLock::Yes)                         \
+    S(readlink, NeedsBigProcessLock::No)                       \
+    S(readv, NeedsBigProcessLock::Yes)                         \
+    S(realpath, NeedsBigProcessLock::No)                       \
+    S(recvfd, NeedsBigProcessLock::No)                         \
+    S(recvmsg, NeedsBigProcessLock::Yes)                       \
+    S(rename, NeedsBigProcessLock::No)                         \
+    S(rmdir, NeedsBigProcessLock::No)                          \
+    S(sched_getparam, NeedsBigProcessLock::No)                 \
+    S(sched_setparam, NeedsBigProcessLock::No)                 \
+    S(sendfd, NeedsBigProcessLock::No)                         \
+    S(sendfile, NeedsBigProcessLock::Yes)                      \
+    S(sendmsg, NeedsBigProcessLock::Yes)                       \
+    S(set_coredump_metadata, NeedsBigProcessLock::No)          \
+    S(set_mmap_name, NeedsBigProcessLock::Yes)                 \
+    S(set_process_name, NeedsBigProcessLock::Yes)              \
+    S(set_thread_name, NeedsBigProcessLock::Yes)               \
+    S(setegid, NeedsBigProcessLock::No)                        \
+    S(seteuid, NeedsBigProcessLock::No)                        \
+    S(setgid, NeedsBigProcessLock::No)                         \
+    S(setgroups, NeedsBigProcessLock::No)                      \
+    S(sethostname, NeedsBigProcessLock::No)                    \
+    S(setkeymap, NeedsBigProcessLock::No)                      \
+    S(setpgid, NeedsBigProcessLock::Yes)                       \
+    S(setresgid, NeedsBigProcessLock::No)                      \
+    S(setresuid, NeedsBigProcessLock::No)                      \
+    S(setreuid, NeedsBigProcessLock::No)                       \
+    S(setsid, NeedsBigProcessLock::Yes)                        \
+    S(setsockopt, NeedsBigProcessLock::No)                     \
+    S(setuid, NeedsBigProcessLock::No)                         \
+    S(shutdown, NeedsBigProcessLock::No)                       \
+    S(sigaction, NeedsBigProcessLock::Yes)                     \
+    S(sigaltstack, NeedsBigProcessLock::Yes)                   \
+    S(sigpending, NeedsBigProcessLock::Yes)                    \
+    S(sigprocmask, NeedsBigProcessLock::Yes)                   \
+    S(sigreturn, NeedsBigProcessLock::Yes)                     \
+    S(sigsuspend, NeedsBigProcessLock::Yes)                    \
+    S(sigtimedwait, NeedsBigProcessLock::Yes)                  \
+    S(socket, NeedsBigProcessLock::No)                         \
+    S(socketpair, NeedsBigProcessLock::No)                     \
+    S(stat, NeedsBigProcessLock::No)                           \
+    S(statvfs, NeedsBigProcessLock::No)                        \
+    S(symlink, NeedsBigProcessLock::No)                        \
+    S(sync, NeedsBigProcessLock::No)                           \
+    S(sysconf, NeedsBigProcessLock::No)                        \
+    S(times, NeedsBigProcessLock::Yes)                         \
+    S(umask, NeedsBigProcessLock::Yes)                         \
+    S(umount, NeedsBigProcessLock::Yes)                        \
+    S(uname, NeedsBigProcessLock::No)                          \
+    S(unlink, NeedsBigProcessLock::No)                         \
+    S(unveil, NeedsBigProcessLock::No)                         \
+    S(utime, NeedsBigProcessLock::No)                          \
+    S(utimensat, NeedsBigProcessLock::No)                      \
+    S(waitid, NeedsBigProcessLock::Yes)                        \
+    S(write, NeedsBigProcessLock::Yes)                         \
+    S(writev, NeedsBigProcessLock::Yes)                        \
     S(yield, NeedsBigProcessLock::No)
 
 namespace Syscall {
@@ -253,6 +262,28 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_sendfile_params {
+    int out_fd;
+    int in_fd;
+    off_t* offset;
+    size_t count;
+};
+
+struct SC_epoll_ctl_params {
+    int epfd;
+    int op;
+    int fd;
+    struct epoll_event const* event;
+};
+
+struct SC_epoll_wait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+    u32 const* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -21,10 +21,31 @@ inline bool time_page_supports(clockid_t clock_id)
     return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE;
 }
 
+// The precise clocks can be served from the time page by interpolating from their
+// coarse counterpart with the TSC, as long as the kernel has published a usable rate.
+inline bool time_page_supports_interpolation(clockid_t clock_id)
+{
+    return clock_id == CLOCK_REALTIME || clock_id == CLOCK_MONOTONIC;
+}
+
+inline clockid_t time_page_interpolation_base(clockid_t clock_id)
+{
+    return clock_id == CLOCK_REALTIME ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+}
+
 struct TimePage {
     volatile u32 update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // TSC value at the time the coarse clocks were last updated.
+    u64 tsc_at_update;
+    // Nanoseconds per TSC tick as a 32.32 fixed-point value, or 0 if the TSC must not be used.
+    u64 tsc_to_ns_multiplier;
+    // Interpolation is clamped to this many TSC ticks, the length of one timer tick, so it does not run past the next update.
+    u64 max_tsc_delta;
     volatile u32 update2;
+    // Nonzero while signposts are being recorded, and different every time recording starts. Userspace tracepoints
+    // check this to skip the syscall when nobody is listening, and to know when to register their names again.
+    volatile u32 signpost_generation;
 };
 
 }
@@ -24,6 +24,13 @@ public:
         m_raw |= PhysicalAddress::physical_page_base(value);
     }
 
+    // NOTE: Only valid if is_huge() is true, in which case the entry maps a 2 MiB page instead of a page table.
+    void set_large_page_base(PhysicalPtr value)
+    {
+        m_raw &= 0x8000000000000fffULL;
+        m_raw |= value & ~(PhysicalPtr)0x1fffff;
+    }
+
     bool is_null() const { return m_raw == 0; }
     void clear() { m_raw = 0; }
 
@@ -95,6 +102,7 @@ public:
         UserSupervisor = 1 << 2,
         WriteThrough = 1 << 3,
         CacheDisabled = 1 << 4,
+        Accessed = 1 << 5,
         PAT = 1 << 7,
         Global = 1 << 8,
         NoExecute = 0x8000000000000000ULL,
@@ -124,6 +132,11 @@ public:
     bool is_pat() const { return (raw() & PAT) == PAT; }
     void set_pat(bool b) { set_bit(PAT, b); }
 
+    // NOTE: The CPU sets this whenever it loads the entry into the TLB, so clearing it only tells us about
+    //       accesses after the next TLB flush.
+    bool is_accessed() const { return (raw() & Accessed) == Accessed; }
+    void set_accessed(bool b) { set_bit(Accessed, b); }
+
     bool is_null() const { return m_raw == 0; }
     void clear() { m_raw = 0; }
 
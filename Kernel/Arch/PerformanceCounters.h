@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+struct RegisterState;
+
+// Sampling on the processors' hardware performance counters, as opposed to the profile timer.
+// Every time one of the counters has counted its sample period worth of events, the thread that is running
+// gets a sample of the matching PERF_EVENT_* type, with the given registers' backtrace.
+namespace PerformanceCounters {
+
+// Whether the hardware can count all of the PERF_EVENT_HARDWARE_COUNTERS events in the given mask at once.
+bool can_count(u64 event_mask);
+
+// Starts counting the hardware events in the event mask on all processors. Like the profile timer, the counters
+// stay enabled until every enable() has been matched by a disable().
+ErrorOr<void> enable(u64 event_mask);
+void disable();
+
+void handle_overflow_interrupt(RegisterState const&);
+
+}
+
+}
@@ -16,6 +16,7 @@
 #include <Kernel/Random.h>
 #include <Kernel/Sections.h>
 #include <Kernel/UserOrKernelBuffer.h>
+#include <Kernel/WorkQueue.h>
 
 // Scheduler
 namespace Kernel {
@@ -24,6 +25,18 @@ READONLY_AFTER_INIT Thread* g_finalizer;
 
 }
 
+// WorkQueue
+namespace Kernel {
+
+WorkQueue* g_readahead_work;
+
+void WorkQueue::do_queue(WorkItem&)
+{
+    VERIFY_NOT_REACHED();
+}
+
+}
+
 // Random
 namespace Kernel {
 
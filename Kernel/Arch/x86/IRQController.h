@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/AtomicRefCounted.h>
+#include <AK/Error.h>
 #include <AK/Types.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 
@@ -31,6 +32,9 @@ public:
     bool is_hard_disabled() const { return m_hard_disabled; }
     virtual void eoi(GenericInterruptHandler const&) const = 0;
     virtual void spurious_eoi(GenericInterruptHandler const&) const = 0;
+    // Note: Unless a controller can send them elsewhere, all interrupts go to the bootstrap processor.
+    virtual ErrorOr<void> set_destination_processor(GenericInterruptHandler const&, u32) { return ENOTSUP; }
+    virtual u32 destination_processor(GenericInterruptHandler const&) const { return 0; }
     virtual size_t interrupt_vectors_count() const = 0;
     virtual u32 gsi_base() const = 0;
     virtual u16 get_isr() const = 0;
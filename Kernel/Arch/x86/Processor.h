@@ -101,6 +101,12 @@ class Processor {
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The CR3 value this processor is currently running with, or 0 if we don't know yet.
+    // This lets TLB shootdowns for user addresses skip processors that can't have stale entries.
+    Atomic<FlatPtr> m_active_cr3;
+    Atomic<size_t> m_tlb_shootdowns_sent;
+    Atomic<size_t> m_tlb_shootdowns_skipped;
+
     bool m_invoke_scheduler_async;
     bool m_scheduler_initialized;
     bool m_in_scheduler;
@@ -123,6 +129,7 @@ class Processor {
     bool smp_enqueue_message(ProcessorMessage&);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static void smp_multicast_message(ProcessorMessage& msg, u64 target_cpu_mask);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -190,6 +197,12 @@ public:
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
 
+    // NOTE: This has to be called right before loading a new CR3 value.
+    ALWAYS_INLINE void set_active_cr3(FlatPtr cr3) { m_active_cr3.store(cr3, AK::MemoryOrder::memory_order_seq_cst); }
+
+    size_t tlb_shootdowns_sent() const { return m_tlb_shootdowns_sent.load(AK::MemoryOrder::memory_order_relaxed); }
+    size_t tlb_shootdowns_skipped() const { return m_tlb_shootdowns_skipped.load(AK::MemoryOrder::memory_order_relaxed); }
+
     Descriptor& get_gdt_entry(u16 selector);
     void flush_gdt();
     DescriptorTablePointer const& get_gdtr();
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/API/POSIX/serenity.h>
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/x86/CPUID.h>
+#include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Interrupts/APIC.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceManager.h>
+
+// This uses Intel's architectural performance monitoring (Intel SDM Vol. 3B, Chapter 20), which gives us a number of
+// general purpose counters that raise an interrupt through the local APIC whenever they overflow. Starting them at
+// minus the sample period makes them overflow once per period.
+
+namespace Kernel::PerformanceCounters {
+
+static constexpr u32 IA32_PMC0 = 0xc1;
+static constexpr u32 IA32_PERFEVTSEL0 = 0x186;
+static constexpr u32 IA32_PERF_GLOBAL_STATUS = 0x38e;
+static constexpr u32 IA32_PERF_GLOBAL_CTRL = 0x38f;
+static constexpr u32 IA32_PERF_GLOBAL_OVF_CTRL = 0x390;
+
+static constexpr u64 PERFEVTSEL_USR = 1 << 16;
+static constexpr u64 PERFEVTSEL_OS = 1 << 17;
+static constexpr u64 PERFEVTSEL_INT = 1 << 20;
+static constexpr u64 PERFEVTSEL_EN = 1 << 22;
+
+static constexpr u8 not_architectural = 0xff;
+
+struct HardwareEvent {
+    int type;
+    u8 event_select;
+    u8 unit_mask;
+    // The bit in CPUID.0AH:EBX that is set if the event is *not* available, for architectural events.
+    u8 unavailable_bit;
+    u32 sample_period;
+};
+
+static constexpr Array<HardwareEvent, 4> s_hardware_events { {
+    // UnHalted Core Cycles
+    { PERF_EVENT_CPU_CYCLES, 0x3c, 0x00, 0, 1'000'000 },
+    // LLC Misses
+    { PERF_EVENT_CACHE_MISSES, 0x2e, 0x41, 4, 10'000 },
+    // Branch Mispredicts Retired
+    { PERF_EVENT_BRANCH_MISSES, 0xc5, 0x00, 6, 10'000 },
+    // DTLB_LOAD_MISSES.MISS_CAUSES_A_WALK. This one isn't architectural, but has the same encoding on the Intel Core
+    // microarchitectures since Nehalem, so we only offer it on those (family 6).
+    { PERF_EVENT_TLB_MISSES, 0x08, 0x01, not_architectural, 10'000 },
+} };
+
+static constexpr size_t max_counter_count = s_hardware_events.size();
+
+struct Capabilities {
+    u8 version { 0 };
+    u8 counter_count { 0 };
+    u8 counter_width { 0 };
+    u32 unavailable_events { 0 };
+    bool is_family_6 { false };
+};
+
+static Capabilities const& capabilities()
+{
+    static Capabilities capabilities = [] {
+        Capabilities capabilities;
+        if (CPUID(0).eax() < 0xa || !MSR::have())
+            return capabilities;
+        CPUID leaf(0xa);
+        capabilities.version = leaf.eax() & 0xff;
+        capabilities.counter_count = min(static_cast<size_t>((leaf.eax() >> 8) & 0xff), max_counter_count);
+        capabilities.counter_width = (leaf.eax() >> 16) & 0xff;
+        auto event_vector_length = (leaf.eax() >> 24) & 0xff;
+        // Events past the end of the bit vector aren't available either.
+        capabilities.unavailable_events = leaf.ebx() | (event_vector_length < 32 ? ~0u << event_vector_length : 0);
+        capabilities.is_family_6 = ((CPUID(1).eax() >> 8) & 0xf) == 6;
+        return capabilities;
+    }();
+    return capabilities;
+}
+
+static bool is_available(HardwareEvent const& event)
+{
+    auto const& capabilities = PerformanceCounters::capabilities();
+    if (capabilities.version == 0)
+        return false;
+    if (event.unavailable_bit == not_architectural)
+        return capabilities.is_family_6;
+    return (capabilities.unavailable_events & (1u << event.unavailable_bit)) == 0;
+}
+
+static Spinlock s_lock { LockRank::None };
+static u32 s_enable_count { 0 };
+static u64 s_counted_events { 0 };
+// The events that the counters are programmed for, in order. Only read on the processors while the counters are running.
+static Array<HardwareEvent const*, max_counter_count> s_counter_events {};
+static size_t s_counter_count { 0 };
+
+bool can_count(u64 event_mask)
+{
+    size_t count = 0;
+    for (auto const& event : s_hardware_events) {
+        if ((event_mask & event.type) == 0)
+            continue;
+        if (!is_available(event))
+            return false;
+        ++count;
+    }
+    return count <= capabilities().counter_count;
+}
+
+static void reload_counter(size_t index)
+{
+    // Writes to IA32_PMCx are sign-extended from 32 bits, which is plenty for our sample periods.
+    MSR counter(IA32_PMC0 + index);
+    counter.set(static_cast<u64>(-static_cast<i64>(s_counter_events[index]->sample_period)));
+}
+
+static void stop_counters_on_current_processor()
+{
+    if (capabilities().version >= 2) {
+        MSR global_control(IA32_PERF_GLOBAL_CTRL);
+        global_control.set(0);
+    }
+    for (size_t i = 0; i < capabilities().counter_count; ++i) {
+        MSR event_select(IA32_PERFEVTSEL0 + i);
+        event_select.set(0);
+    }
+    APIC::the().set_performance_counter_interrupt_enabled(false);
+}
+
+static void start_counters_on_current_processor()
+{
+    APIC::the().set_performance_counter_interrupt_enabled(true);
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        auto const& event = *s_counter_events[i];
+        reload_counter(i);
+        MSR event_select(IA32_PERFEVTSEL0 + i);
+        event_select.set(event.event_select | (static_cast<u64>(event.unit_mask) << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN);
+    }
+    if (capabilities().version >= 2) {
+        MSR global_control(IA32_PERF_GLOBAL_CTRL);
+        global_control.set((1ull << s_counter_count) - 1);
+    }
+}
+
+static void on_each_processor(void (*callback)())
+{
+    ScopedCritical critical;
+    auto current_id = Processor::current_id();
+    Processor::for_each([&](Processor& processor) {
+        if (processor.id() != current_id)
+            Processor::smp_unicast(processor.id(), [callback] { callback(); }, false);
+    });
+    callback();
+}
+
+ErrorOr<void> enable(u64 event_mask)
+{
+    event_mask &= PERF_EVENT_HARDWARE_COUNTERS;
+    if (!can_count(event_mask))
+        return ENOTSUP;
+
+    SpinlockLocker locker(s_lock);
+    if (s_enable_count++ > 0 && event_mask == s_counted_events)
+        return {};
+
+    if (s_counter_count > 0)
+        on_each_processor(stop_counters_on_current_processor);
+
+    s_counted_events = event_mask;
+    s_counter_count = 0;
+    for (auto const& event : s_hardware_events) {
+        if ((event_mask & event.type) != 0)
+            s_counter_events[s_counter_count++] = &event;
+    }
+
+    if (s_counter_count > 0)
+        on_each_processor(start_counters_on_current_processor);
+    return {};
+}
+
+void disable()
+{
+    SpinlockLocker locker(s_lock);
+    if (s_enable_count == 0 || --s_enable_count > 0)
+        return;
+    if (s_counter_count > 0)
+        on_each_processor(stop_counters_on_current_processor);
+    s_counted_events = 0;
+    s_counter_count = 0;
+}
+
+void handle_overflow_interrupt(RegisterState const& regs)
+{
+    auto const& capabilities = PerformanceCounters::capabilities();
+
+    u64 overflowed_counters = 0;
+    if (capabilities.version >= 2) {
+        MSR global_status(IA32_PERF_GLOBAL_STATUS);
+        overflowed_counters = global_status.get();
+    } else {
+        // Without a status register, we recognize the counters that overflowed by their no longer being negative.
+        for (size_t i = 0; i < s_counter_count; ++i) {
+            MSR counter(IA32_PMC0 + i);
+            if ((counter.get() & (1ull << (capabilities.counter_width - 1))) == 0)
+                overflowed_counters |= 1ull << i;
+        }
+    }
+
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        if ((overflowed_counters & (1ull << i)) == 0)
+            continue;
+        // Same as for timer samples, we don't collect samples while idle.
+        if (current_thread && current_thread != Processor::idle_thread())
+            PerformanceManager::add_hardware_counter_sample_event(*current_thread, regs, s_counter_events[i]->type);
+        reload_counter(i);
+    }
+
+    if (capabilities.version >= 2) {
+        MSR overflow_control(IA32_PERF_GLOBAL_OVF_CTRL);
+        overflow_control.set(overflowed_counters);
+    }
+
+    // The local APIC masks the interrupt when it delivers it, so we have to unmask it for the next one.
+    if (s_counter_count > 0)
+        APIC::the().set_performance_counter_interrupt_enabled(true);
+}
+
+}
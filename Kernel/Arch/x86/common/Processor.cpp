@@ -619,6 +619,9 @@ UNMAP_AFTER_INIT void Processor::early_initialize(u32 cpu)
     m_in_scheduler = true;
 
     m_message_queue = nullptr;
+    m_active_cr3 = 0;
+    m_tlb_shootdowns_sent = 0;
+    m_tlb_shootdowns_skipped = 0;
     m_idle_thread = nullptr;
     m_current_thread = nullptr;
     m_info = nullptr;
@@ -1002,6 +1005,14 @@ void Processor::check_invoke_scheduler()
 
 void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    // Past a certain size, reloading CR3 is cheaper than invalidating every single page.
+    // We can't do this for kernel addresses, as those are mapped global and survive a CR3 reload.
+    static constexpr size_t full_flush_threshold = 64;
+    if (page_count > full_flush_threshold && Memory::is_user_address(vaddr)) {
+        flush_entire_tlb_local();
+        return;
+    }
+
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -1259,6 +1270,25 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+void Processor::smp_multicast_message(ProcessorMessage& msg, u64 target_cpu_mask)
+{
+    auto& current_processor = Processor::current();
+    VERIFY(!(target_cpu_mask & (1ull << current_processor.id())));
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpu mask: {:#x}", current_processor.id(), VirtualAddress(&msg), target_cpu_mask);
+
+    msg.refs.store(popcount(target_cpu_mask), AK::MemoryOrder::memory_order_release);
+    VERIFY(msg.refs > 0);
+    for_each(
+        [&](Processor& proc) {
+            if (!(target_cpu_mask & (1ull << proc.id())))
+                return;
+            // Only interrupt processors that didn't already have messages queued up, the others will see ours too.
+            if (proc.smp_enqueue_message(msg))
+                APIC::the().send_ipi(proc.id());
+        });
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -1319,13 +1349,53 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
 
 void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
+    auto& current_processor = Processor::current();
+
+    // Kernel mappings are shared by all page directories, so they have to be flushed everywhere.
+    // User mappings can only be cached by processors that currently have this page directory loaded,
+    // anyone switching to it later gets a clean TLB by loading CR3.
+    u64 target_cpu_mask = 0;
+    size_t skipped_count = 0;
+    if (Memory::is_user_address(vaddr)) {
+        // Make sure our page table updates are visible before looking at what everyone else is running with.
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+        auto cr3 = page_directory->cr3();
+        for_each(
+            [&](Processor& proc) {
+                if (&proc == &current_processor)
+                    return;
+                auto active_cr3 = proc.m_active_cr3.load(AK::MemoryOrder::memory_order_seq_cst);
+                if (active_cr3 == 0 || active_cr3 == cr3)
+                    target_cpu_mask |= 1ull << proc.id();
+                else
+                    ++skipped_count;
+            });
+    } else {
+        for_each(
+            [&](Processor& proc) {
+                if (&proc != &current_processor)
+                    target_cpu_mask |= 1ull << proc.id();
+            });
+    }
+
+    current_processor.m_tlb_shootdowns_sent.fetch_add(popcount(target_cpu_mask), AK::MemoryOrder::memory_order_relaxed);
+    current_processor.m_tlb_shootdowns_skipped.fetch_add(skipped_count, AK::MemoryOrder::memory_order_relaxed);
+
+    if (!target_cpu_mask) {
+        flush_tlb_local(vaddr, page_count);
+        return;
+    }
+
     auto& msg = smp_get_from_pool();
     msg.async = false;
     msg.type = ProcessorMessage::FlushTlb;
     msg.flush_tlb.page_directory = page_directory;
     msg.flush_tlb.ptr = vaddr.as_ptr();
     msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+    if (skipped_count == 0)
+        smp_broadcast_message(msg);
+    else
+        smp_multicast_message(msg, target_cpu_mask);
     // While the other processors handle this request, we'll flush ours
     flush_tlb_local(vaddr, page_count);
     // Now wait until everybody is done as well
@@ -1621,8 +1691,10 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     fs_base_msr.set(to_thread->thread_specific_data().get());
 #endif
 
-    if (from_regs.cr3 != to_regs.cr3)
+    if (from_regs.cr3 != to_regs.cr3) {
+        processor.set_active_cr3(to_regs.cr3);
         write_cr3(to_regs.cr3);
+    }
 
     to_thread->set_cpu(processor.id());
 
@@ -176,6 +176,16 @@ bool CommandLine::is_pc_speaker_enabled() const
     PANIC("Unknown pcspeaker setting: {}", value);
 }
 
+bool CommandLine::is_page_compression_enabled() const
+{
+    auto value = lookup("page_compression"sv).value_or("on"sv);
+    if (value == "on"sv)
+        return true;
+    if (value == "off"sv)
+        return false;
+    PANIC("Unknown page_compression setting: {}", value);
+}
+
 UNMAP_AFTER_INIT bool CommandLine::is_force_pio() const
 {
     return contains("force_pio"sv);
@@ -255,6 +265,32 @@ UNMAP_AFTER_INIT AHCIResetMode CommandLine::ahci_reset_mode() const
     PANIC("Unknown AHCIResetMode: {}", ahci_reset_mode);
 }
 
+bool CommandLine::is_ahci_coalescing_enabled() const
+{
+    return contains("ahci_coalescing"sv);
+}
+
+IOSchedulerPolicy CommandLine::io_scheduler_policy() const
+{
+    auto const io_scheduler = lookup("io_scheduler"sv).value_or("fair"sv);
+    if (io_scheduler == "fcfs"sv)
+        return IOSchedulerPolicy::FirstComeFirstServed;
+    if (io_scheduler == "deadline"sv)
+        return IOSchedulerPolicy::Deadline;
+    if (io_scheduler == "fair"sv)
+        return IOSchedulerPolicy::Fair;
+    PANIC("Unknown IOSchedulerPolicy: {}", io_scheduler);
+}
+
+Time CommandLine::plan9fs_attribute_cache_timeout() const
+{
+    auto const value = lookup("plan9fs_attribute_cache_timeout"sv).value_or("1000"sv);
+    auto milliseconds = value.to_uint();
+    if (milliseconds.has_value())
+        return Time::from_milliseconds(milliseconds.value());
+    PANIC("Invalid Plan9FS attribute cache timeout: {}", value);
+}
+
 StringView CommandLine::system_mode() const
 {
     return lookup("system_mode"sv).value_or("graphical"sv);
@@ -314,4 +350,13 @@ UNMAP_AFTER_INIT size_t CommandLine::switch_to_tty() const
     }
     PANIC("Invalid default tty value: {}", default_tty);
 }
+
+size_t CommandLine::disk_cache_dirty_ratio() const
+{
+    auto const value = lookup("disk_cache_dirty_ratio"sv).value_or("40"sv);
+    auto dirty_ratio = value.to_uint();
+    if (dirty_ratio.has_value() && dirty_ratio.value() >= 1 && dirty_ratio.value() <= 100)
+        return dirty_ratio.value();
+    PANIC("Invalid disk cache dirty ratio: {}", value);
+}
 }
@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <Kernel/KString.h>
 
@@ -41,6 +42,12 @@ enum class AHCIResetMode {
     Aggressive,
 };
 
+enum class IOSchedulerPolicy {
+    FirstComeFirstServed,
+    Deadline,
+    Fair,
+};
+
 class CommandLine {
 
 public:
@@ -74,6 +81,7 @@ public:
     [[nodiscard]] bool is_pci_disabled() const;
     [[nodiscard]] bool is_legacy_time_enabled() const;
     [[nodiscard]] bool is_pc_speaker_enabled() const;
+    [[nodiscard]] bool is_page_compression_enabled() const;
     [[nodiscard]] GraphicsSubsystemMode graphics_subsystem_mode() const;
     [[nodiscard]] bool is_force_pio() const;
     [[nodiscard]] AcpiFeatureLevel acpi_feature_level() const;
@@ -87,11 +95,15 @@ public:
     [[nodiscard]] bool disable_virtio() const;
     [[nodiscard]] bool is_early_boot_console_disabled() const;
     [[nodiscard]] AHCIResetMode ahci_reset_mode() const;
+    [[nodiscard]] bool is_ahci_coalescing_enabled() const;
+    [[nodiscard]] IOSchedulerPolicy io_scheduler_policy() const;
+    [[nodiscard]] Time plan9fs_attribute_cache_timeout() const;
     [[nodiscard]] StringView userspace_init() const;
     [[nodiscard]] NonnullOwnPtrVector<KString> userspace_init_args() const;
     [[nodiscard]] StringView root_device() const;
     [[nodiscard]] bool is_nvme_polling_enabled() const;
     [[nodiscard]] size_t switch_to_tty() const;
+    [[nodiscard]] size_t disk_cache_dirty_ratio() const;
 
 private:
     CommandLine(StringView);
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <AK/NumericLimits.h>
+#include <AK/OwnPtr.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/Arch/RegisterState.h>
+#include <Kernel/ContinuousProfiler.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+Atomic<bool> ContinuousProfiler::s_enabled { false };
+
+// At 25 samples per second, the ring buffer holds the last 40 seconds or so of every processor.
+static constexpr size_t sample_capacity = 1024;
+static constexpr size_t stack_capacity = 512;
+static constexpr size_t max_stack_frame_count = 32;
+static constexpr size_t stack_index_size = stack_capacity * 2;
+static constexpr u16 no_stack = NumericLimits<u16>::max();
+
+struct ProfileSample {
+    u64 timestamp { 0 };
+    pid_t pid { 0 };
+    pid_t tid { 0 };
+    u16 stack_id { no_stack };
+};
+
+struct ProfileStack {
+    unsigned hash { 0 };
+    size_t frame_count { 0 };
+    FlatPtr frames[max_stack_frame_count];
+};
+
+class SampleBuffer {
+public:
+    void add_sample(u64 timestamp, pid_t pid, pid_t tid, Span<FlatPtr const> frames)
+    {
+        // Once the ring buffer is full, the oldest samples are the ones that make room.
+        if (m_sample_count == sample_capacity) {
+            m_first_sample = (m_first_sample + 1) % sample_capacity;
+            --m_sample_count;
+            ++m_lost_samples;
+        }
+        auto& sample = m_samples[(m_first_sample + m_sample_count++) % sample_capacity];
+        sample.timestamp = timestamp;
+        sample.pid = pid;
+        sample.tid = tid;
+        sample.stack_id = find_or_add_stack(frames.trim(max_stack_frame_count));
+    }
+
+    void clear()
+    {
+        m_first_sample = 0;
+        m_sample_count = 0;
+        m_lost_samples = 0;
+        m_stack_count = 0;
+        m_dropped_stacks = 0;
+        memset(m_stack_index, 0, sizeof(m_stack_index));
+    }
+
+    ErrorOr<void> to_json(JsonObjectSerializer<KBufferBuilder>& object) const
+    {
+        TRY(object.add("lost_samples"sv, m_lost_samples));
+        TRY(object.add("dropped_stacks"sv, m_dropped_stacks));
+        {
+            // Samples refer to these by their index.
+            auto stacks_array = TRY(object.add_array("stacks"sv));
+            for (size_t i = 0; i < m_stack_count; ++i) {
+                auto stack_array = TRY(stacks_array.add_array());
+                auto const& stack = m_stacks[i];
+                for (size_t frame = 0; frame < stack.frame_count; ++frame)
+                    TRY(stack_array.add(stack.frames[frame]));
+                TRY(stack_array.finish());
+            }
+            TRY(stacks_array.finish());
+        }
+        auto samples_array = TRY(object.add_array("samples"sv));
+        for (size_t i = 0; i < m_sample_count; ++i) {
+            auto const& sample = m_samples[(m_first_sample + i) % sample_capacity];
+            auto sample_object = TRY(samples_array.add_object());
+            TRY(sample_object.add("timestamp"sv, sample.timestamp));
+            TRY(sample_object.add("pid"sv, sample.pid));
+            TRY(sample_object.add("tid"sv, sample.tid));
+            if (sample.stack_id != no_stack)
+                TRY(sample_object.add("stack"sv, sample.stack_id));
+            TRY(sample_object.finish());
+        }
+        TRY(samples_array.finish());
+        return {};
+    }
+
+private:
+    u16 find_or_add_stack(Span<FlatPtr const> frames)
+    {
+        unsigned hash = 0;
+        for (auto frame : frames)
+            hash = pair_int_hash(hash, ptr_hash(frame));
+
+        // The index is an open addressing hash table of stack ids plus one, so that zero means unused.
+        for (size_t probe = 0, slot = hash % stack_index_size; probe < stack_index_size; ++probe, slot = (slot + 1) % stack_index_size) {
+            auto entry = m_stack_index[slot];
+            if (entry == 0) {
+                if (m_stack_count == stack_capacity)
+                    break;
+                auto& stack = m_stacks[m_stack_count];
+                stack.hash = hash;
+                stack.frame_count = frames.size();
+                memcpy(stack.frames, frames.data(), frames.size() * sizeof(FlatPtr));
+                m_stack_index[slot] = ++m_stack_count;
+                return m_stack_count - 1;
+            }
+            auto const& stack = m_stacks[entry - 1];
+            if (stack.hash == hash && stack.frame_count == frames.size() && memcmp(stack.frames, frames.data(), frames.size() * sizeof(FlatPtr)) == 0)
+                return entry - 1;
+        }
+        ++m_dropped_stacks;
+        return no_stack;
+    }
+
+    ProfileSample m_samples[sample_capacity];
+    size_t m_first_sample { 0 };
+    size_t m_sample_count { 0 };
+    u64 m_lost_samples { 0 };
+
+    ProfileStack m_stacks[stack_capacity];
+    size_t m_stack_count { 0 };
+    u16 m_stack_index[stack_index_size] {};
+    u64 m_dropped_stacks { 0 };
+};
+
+// Every processor records into its active buffer, and the reader swaps it with the inactive one so that it can take
+// its time with the samples without holding up the processor.
+struct ProcessorSampleBuffers {
+    Spinlock lock { LockRank::None };
+    NonnullOwnPtr<SampleBuffer> active;
+    NonnullOwnPtr<SampleBuffer> inactive;
+    u32 ticks_until_next_sample { 0 };
+};
+
+// NOTE: These are allocated the first time the profiler is enabled, and never freed.
+static Vector<NonnullOwnPtr<ProcessorSampleBuffers>> s_processor_buffers;
+static Mutex s_reader_lock { "ContinuousProfiler"sv };
+
+static ErrorOr<void> allocate_processor_buffers()
+{
+    Vector<NonnullOwnPtr<ProcessorSampleBuffers>> processor_buffers;
+    TRY(processor_buffers.try_ensure_capacity(Processor::count()));
+    for (size_t i = 0; i < Processor::count(); ++i) {
+        auto active = TRY(adopt_nonnull_own_or_enomem(new (nothrow) SampleBuffer));
+        auto inactive = TRY(adopt_nonnull_own_or_enomem(new (nothrow) SampleBuffer));
+        processor_buffers.unchecked_append(TRY(adopt_nonnull_own_or_enomem(new (nothrow) ProcessorSampleBuffers { .active = move(active), .inactive = move(inactive) })));
+    }
+    s_processor_buffers = move(processor_buffers);
+    return {};
+}
+
+void ContinuousProfiler::set_enabled(bool enabled)
+{
+    MutexLocker locker(s_reader_lock);
+    if (!enabled) {
+        s_enabled.store(false, AK::memory_order_release);
+        return;
+    }
+    if (is_enabled())
+        return;
+
+    if (s_processor_buffers.is_empty()) {
+        if (auto result = allocate_processor_buffers(); result.is_error()) {
+            dmesgln("ContinuousProfiler: Could not allocate sample buffers: {}", result.error());
+            return;
+        }
+    }
+
+    // Every time profiling is switched on it starts over with a clean slate.
+    for (auto& buffers : s_processor_buffers) {
+        SpinlockLocker lock(buffers->lock);
+        buffers->active->clear();
+        buffers->inactive->clear();
+    }
+    s_enabled.store(true, AK::memory_order_release);
+}
+
+void ContinuousProfiler::timer_tick(RegisterState const& regs)
+{
+    if (!is_enabled())
+        return;
+
+    auto& buffers = *s_processor_buffers[Processor::current_id()];
+    if (buffers.ticks_until_next_sample > 0) {
+        --buffers.ticks_until_next_sample;
+        return;
+    }
+    buffers.ticks_until_next_sample = OPTIMAL_TICKS_PER_SECOND_RATE / samples_per_second - 1;
+
+    // Same as the profile timer, we don't collect samples while idle.
+    auto* current_thread = Thread::current();
+    if (!current_thread || current_thread == Processor::idle_thread())
+        return;
+
+    auto backtrace = raw_backtrace(regs.bp(), regs.ip());
+    auto timestamp = TimeManagement::the().uptime_ms();
+
+    SpinlockLocker lock(buffers.lock);
+    buffers.active->add_sample(timestamp, current_thread->pid().value(), current_thread->tid().value(), backtrace.span());
+}
+
+ErrorOr<void> ContinuousProfiler::drain_to_json(KBufferBuilder& builder)
+{
+    MutexLocker locker(s_reader_lock);
+
+    auto object = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(object.add("enabled"sv, is_enabled()));
+    TRY(object.add("samples_per_second"sv, samples_per_second));
+    auto processors_array = TRY(object.add_array("processors"sv));
+    for (size_t i = 0; i < s_processor_buffers.size(); ++i) {
+        auto& buffers = *s_processor_buffers[i];
+        {
+            SpinlockLocker lock(buffers.lock);
+            swap(buffers.active, buffers.inactive);
+        }
+        // NOTE: Whatever happens while writing them out, these samples are gone once they have been handed out.
+        ScopeGuard clear_buffer([&] { buffers.inactive->clear(); });
+        auto processor_object = TRY(processors_array.add_object());
+        TRY(processor_object.add("processor"sv, i));
+        TRY(buffers.inactive->to_json(processor_object));
+        TRY(processor_object.finish());
+    }
+    TRY(processors_array.finish());
+    TRY(object.finish());
+    return {};
+}
+
+}
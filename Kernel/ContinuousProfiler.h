@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+class KBufferBuilder;
+struct RegisterState;
+
+// A profiler cheap enough to leave running for hours, as opposed to the per-process event buffers of profile(1).
+// Every processor samples whatever it is running at a low rate from its scheduler tick, into a fixed-size ring
+// buffer of its own that only keeps one copy of every distinct stack. Nothing is allocated while sampling.
+// It is switched on through /proc/sys/continuous_profiling, and every time /proc/continuous_profile is opened
+// (or rewound) it hands out the samples taken since the previous time, so a reader can stream them.
+class ContinuousProfiler {
+public:
+    static constexpr u32 samples_per_second = 25;
+
+    static bool is_enabled() { return s_enabled.load(AK::memory_order_acquire); }
+    static void set_enabled(bool);
+
+    static void timer_tick(RegisterState const&);
+
+    // Writes out the samples taken since the last time, and forgets about them.
+    static ErrorOr<void> drain_to_json(KBufferBuilder&);
+
+private:
+    static Atomic<bool> s_enabled;
+};
+
+}
@@ -30,6 +30,40 @@ namespace Kernel {
     return region.name().starts_with("LibJS:"sv) || region.name().starts_with("malloc:"sv);
 }
 
+static bool page_has_contents(Memory::Region const& region, size_t page_index)
+{
+    auto page = region.physical_page(page_index);
+    // Note: Anonymous memory only has no physical page while it's swapped out.
+    if (!page)
+        return region.vmobject().is_anonymous();
+    return !page->is_shared_zero_page() && !page->is_lazy_committed_page();
+}
+
+// The pages of a region whose contents go into the coredump. Everything outside of them reads as zero, or is
+// identical to the file the region was mapped from.
+struct DumpedPages {
+    size_t first_page { 0 };
+    size_t page_count { 0 };
+};
+
+static DumpedPages dumped_pages_of(Memory::Region const& region)
+{
+    // File-backed memory that was never writable (like the text of the executable and its libraries) can be read
+    // back from the file, and makes up a good chunk of any big process.
+    if (region.vmobject().is_inode() && !region.has_been_writable())
+        return {};
+
+    // Large mappings, stacks in particular, are often only touched at one end. We leave out the untouched pages at
+    // either end, which are all zeroes.
+    size_t first_page = 0;
+    size_t end_page = region.page_count();
+    while (first_page < end_page && !page_has_contents(region, first_page))
+        ++first_page;
+    while (end_page > first_page && !page_has_contents(region, end_page - 1))
+        --end_page;
+    return { first_page, end_page - first_page };
+}
+
 ErrorOr<NonnullOwnPtr<Coredump>> Coredump::try_create(NonnullLockRefPtr<Process> process, StringView output_path)
 {
     if (!process->is_dumpable()) {
@@ -148,13 +182,16 @@ ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
 
             ElfW(Phdr) phdr {};
 
+            // NOTE: This has to agree with write_regions(), which doesn't write anything for unmapped regions.
+            auto dumped_pages = region.is_mapped() ? dumped_pages_of(region) : DumpedPages {};
+
             phdr.p_type = PT_LOAD;
             phdr.p_offset = offset;
-            phdr.p_vaddr = region.vaddr().get();
+            phdr.p_vaddr = region.vaddr().offset(dumped_pages.first_page * PAGE_SIZE).get();
             phdr.p_paddr = 0;
 
-            phdr.p_filesz = region.page_count() * PAGE_SIZE;
-            phdr.p_memsz = region.page_count() * PAGE_SIZE;
+            phdr.p_filesz = dumped_pages.page_count * PAGE_SIZE;
+            phdr.p_memsz = dumped_pages.page_count * PAGE_SIZE;
             phdr.p_align = 0;
 
             phdr.p_flags = region.is_readable() ? PF_R : 0;
@@ -204,13 +241,17 @@ ErrorOr<void> Coredump::write_regions()
             if (!region.is_mapped())
                 continue;
 
+            auto dumped_pages = dumped_pages_of(region);
+            if (dumped_pages.page_count == 0)
+                continue;
+
             region.set_readable(true);
             region.remap();
 
-            for (size_t i = 0; i < region.page_count(); i++) {
+            for (size_t i = dumped_pages.first_page; i < dumped_pages.first_page + dumped_pages.page_count; i++) {
                 auto page = region.physical_page(i);
                 auto src_buffer = [&]() -> ErrorOr<UserOrKernelBuffer> {
-                    if (page)
+                    if (page || region.vmobject().is_anonymous())
                         return UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
                     // If the current page is not backed by a physical page, we zero it in the coredump file.
                     return UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
@@ -81,6 +81,12 @@ public:
     }
     void* get_private() const { return m_private; }
 
+    // Note: These describe who queued the request and when, for I/O schedulers to go by.
+    // A request takes on the scheduling priority of the thread that made it.
+    Process const& process() const { return *m_process; }
+    u32 priority() const { return m_priority; }
+    Time queued_time() const { return m_queued_time; }
+
     template<typename... Args>
     ErrorOr<void> write_to_buffer(UserOrKernelBuffer& buffer, Args... args)
     {
@@ -150,6 +156,8 @@ private:
     AsyncDeviceSubRequestList m_sub_requests_complete;
     WaitQueue m_queue;
     NonnullLockRefPtr<Process> m_process;
+    u32 const m_priority;
+    Time const m_queued_time;
     void* m_private { nullptr };
     mutable Spinlock m_lock { LockRank::None };
 };
@@ -58,16 +58,33 @@ ErrorOr<NonnullOwnPtr<KString>> Device::pseudo_path(OpenFileDescription const&)
     return KString::formatted("device:{},{}", major(), minor());
 }
 
+void Device::start_next_request(SpinlockLocker<Spinlock>&& lock)
+{
+    VERIFY(!m_queued_requests.is_empty());
+    auto next_request_it = select_next_request(m_queued_requests);
+    VERIFY(next_request_it != m_queued_requests.end());
+    auto next_request = *next_request_it;
+    m_queued_requests.remove(next_request_it);
+    m_started_requests.append(next_request);
+    m_requests_in_flight++;
+    next_request->do_start(move(lock));
+}
+
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
     SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
-    }
+    VERIFY(m_requests_in_flight > 0);
+    // Note: With more than one request in flight, they don't necessarily complete in order.
+    auto completed_request_it = m_started_requests.begin();
+    while (completed_request_it != m_started_requests.end() && completed_request_it->ptr() != &completed_request)
+        ++completed_request_it;
+    VERIFY(completed_request_it != m_started_requests.end());
+    did_complete_request(completed_request);
+    m_started_requests.remove(completed_request_it);
+    m_requests_in_flight--;
+
+    if (!m_queued_requests.is_empty())
+        start_next_request(move(lock));
 
     evaluate_block_conditions();
 }
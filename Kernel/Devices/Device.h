@@ -52,20 +52,30 @@ public:
     virtual void after_inserting();
     void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
+    // Devices that can work on several requests at the same time (e.g. by queueing them in hardware) can
+    // override this, and will then have up to that many requests started before the first one completes.
+    virtual size_t max_requests_in_flight() const { return 1; }
+
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
         SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        m_requests.append(request);
-        if (was_empty)
-            request->do_start(move(lock));
+        m_queued_requests.append(request);
+        if (m_requests_in_flight < max_requests_in_flight())
+            start_next_request(move(lock));
         return request;
     }
 
 protected:
+    using RequestQueue = DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>>;
+
     Device(MajorNumber major, MinorNumber minor);
+
+    // Note: These are called with the request queue locked.
+    // The queued requests are started in the order they were queued, unless a device picks another order.
+    virtual RequestQueue::Iterator select_next_request(RequestQueue& queued_requests) { return queued_requests.begin(); }
+    virtual void did_complete_request(AsyncDeviceRequest const&) { }
     void set_uid(UserID uid) { m_uid = uid; }
     void set_gid(GroupID gid) { m_gid = gid; }
 
@@ -81,6 +91,8 @@ protected:
     virtual void before_will_be_destroyed_remove_from_device_identifier_directory() = 0;
 
 private:
+    void start_next_request(SpinlockLocker<Spinlock>&&);
+
     MajorNumber const m_major { 0 };
     MinorNumber const m_minor { 0 };
     UserID m_uid { 0 };
@@ -89,7 +101,9 @@ private:
     State m_state { State::Normal };
 
     Spinlock m_requests_lock { LockRank::None };
-    DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>> m_requests;
+    RequestQueue m_queued_requests;
+    RequestQueue m_started_requests;
+    size_t m_requests_in_flight { 0 };
 
 protected:
     // FIXME: This pointer will be eventually removed after all nodes in /sys/dev/block/ and
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/MemoryPressureDevice.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+static MemoryPressureDevice* s_the;
+
+struct MemoryPressureDeviceData final : public OpenFileDescriptionData {
+    // The level this file description was last told about, if any.
+    Atomic<i8> last_read_level { -1 };
+};
+
+static StringView memory_pressure_level_name(Memory::MemoryPressureLevel level)
+{
+    switch (level) {
+    case Memory::MemoryPressureLevel::Normal:
+        return "normal\n"sv;
+    case Memory::MemoryPressureLevel::Low:
+        return "low\n"sv;
+    case Memory::MemoryPressureLevel::Critical:
+        return "critical\n"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<MemoryPressureDevice> MemoryPressureDevice::must_create()
+{
+    auto device_or_error = DeviceManagement::try_create_device<MemoryPressureDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!device_or_error.is_error());
+    s_the = device_or_error.value().ptr();
+    return device_or_error.release_value();
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::MemoryPressureDevice()
+    : CharacterDevice(1, 9)
+{
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::~MemoryPressureDevice() = default;
+
+void MemoryPressureDevice::did_change_memory_pressure_level()
+{
+    if (s_the)
+        s_the->evaluate_block_conditions();
+}
+
+ErrorOr<NonnullLockRefPtr<OpenFileDescription>> MemoryPressureDevice::open(int options)
+{
+    auto description = TRY(CharacterDevice::open(options));
+    description->data() = TRY(adopt_nonnull_own_or_enomem(new (nothrow) MemoryPressureDeviceData));
+    return description;
+}
+
+bool MemoryPressureDevice::can_read(OpenFileDescription const& description, u64) const
+{
+    auto const* data = static_cast<MemoryPressureDeviceData const*>(description.data());
+    return data->last_read_level != static_cast<i8>(MM.memory_pressure_level());
+}
+
+ErrorOr<size_t> MemoryPressureDevice::read(OpenFileDescription& description, u64, UserOrKernelBuffer& buffer, size_t size)
+{
+    auto& data = static_cast<MemoryPressureDeviceData&>(*description.data());
+    auto level = MM.memory_pressure_level();
+    auto name = memory_pressure_level_name(level);
+    if (size < name.length())
+        return EINVAL;
+    TRY(buffer.write(name.characters_without_null_termination(), name.length()));
+    data.last_read_level = static_cast<i8>(level);
+    return name.length();
+}
+
+ErrorOr<size_t> MemoryPressureDevice::write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t)
+{
+    return EINVAL;
+}
+
+}
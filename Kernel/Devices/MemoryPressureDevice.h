@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Devices/CharacterDevice.h>
+
+namespace Kernel {
+
+// Reading from /dev/memorypressure returns the current memory pressure level as a line of text ("normal", "low" or "critical").
+// After that, the file description only becomes readable again once the level changes, so that processes can poll it
+// and shed memory they can do without before allocations start to fail.
+class MemoryPressureDevice final : public CharacterDevice {
+    friend class DeviceManagement;
+
+public:
+    static NonnullLockRefPtr<MemoryPressureDevice> must_create();
+    virtual ~MemoryPressureDevice() override;
+
+    static void did_change_memory_pressure_level();
+
+private:
+    MemoryPressureDevice();
+
+    // ^File
+    virtual ErrorOr<NonnullLockRefPtr<OpenFileDescription>> open(int options) override;
+
+    // ^CharacterDevice
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual StringView class_name() const override { return "MemoryPressureDevice"sv; }
+};
+
+}
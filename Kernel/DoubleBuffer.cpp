@@ -17,17 +17,20 @@ inline void DoubleBuffer::compute_lockfree_metadata()
     m_space_for_writing = m_capacity - m_write_buffer->size;
 }
 
-ErrorOr<NonnullOwnPtr<DoubleBuffer>> DoubleBuffer::try_create(StringView name, size_t capacity)
+ErrorOr<NonnullOwnPtr<DoubleBuffer>> DoubleBuffer::try_create(StringView name, size_t capacity, size_t max_capacity)
 {
+    max_capacity = max(capacity, max_capacity);
     auto storage = TRY(KBuffer::try_create_with_size(name, capacity * 2, Memory::Region::Access::ReadWrite));
-    return adopt_nonnull_own_or_enomem(new (nothrow) DoubleBuffer(capacity, move(storage)));
+    return adopt_nonnull_own_or_enomem(new (nothrow) DoubleBuffer(name, capacity, max_capacity, move(storage)));
 }
 
-DoubleBuffer::DoubleBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage)
+DoubleBuffer::DoubleBuffer(StringView name, size_t capacity, size_t max_capacity, NonnullOwnPtr<KBuffer> storage)
     : m_write_buffer(&m_buffer1)
     , m_read_buffer(&m_buffer2)
+    , m_name(name)
     , m_storage(move(storage))
     , m_capacity(capacity)
+    , m_max_capacity(max_capacity)
 {
     m_buffer1.data = m_storage->data();
     m_buffer1.size = 0;
@@ -45,11 +48,47 @@ void DoubleBuffer::flip()
     compute_lockfree_metadata();
 }
 
+ErrorOr<void> DoubleBuffer::try_grow(size_t space_needed)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+
+    size_t pending_size = (m_read_buffer->size - m_read_buffer_index) + m_write_buffer->size;
+    size_t new_capacity = m_capacity;
+    while (new_capacity < m_max_capacity && new_capacity < pending_size + space_needed)
+        new_capacity = min(new_capacity * 2, m_max_capacity);
+    if (new_capacity == m_capacity || new_capacity < pending_size)
+        return {};
+
+    auto new_storage = TRY(KBuffer::try_create_with_size(m_name, new_capacity * 2, Memory::Region::Access::ReadWrite));
+
+    // Everything that hasn't been read yet moves into the new write buffer, in order.
+    u8* new_data = new_storage->data();
+    size_t unread_size = m_read_buffer->size - m_read_buffer_index;
+    memcpy(new_data, m_read_buffer->data + m_read_buffer_index, unread_size);
+    memcpy(new_data + unread_size, m_write_buffer->data, m_write_buffer->size);
+
+    m_storage = move(new_storage);
+    m_capacity = new_capacity;
+    m_write_buffer = &m_buffer1;
+    m_read_buffer = &m_buffer2;
+    m_buffer1.data = new_data;
+    m_buffer1.size = pending_size;
+    m_buffer2.data = new_data + new_capacity;
+    m_buffer2.size = 0;
+    m_read_buffer_index = 0;
+    compute_lockfree_metadata();
+    return {};
+}
+
 ErrorOr<size_t> DoubleBuffer::write(UserOrKernelBuffer const& data, size_t size)
 {
     if (!size)
         return 0;
     MutexLocker locker(m_lock);
+    if (size > m_space_for_writing && m_capacity < m_max_capacity) {
+        // NOTE: If we can't grow, we simply write as much as fits right now.
+        (void)try_grow(size);
+    }
     size_t bytes_to_write = min(size, m_space_for_writing);
     u8* write_ptr = m_write_buffer->data + m_write_buffer->size;
     TRY(data.read(write_ptr, bytes_to_write));
@@ -70,8 +109,20 @@ ErrorOr<size_t> DoubleBuffer::read_impl(UserOrKernelBuffer& data, size_t size, M
         return 0;
     size_t nread = min(m_read_buffer->size - m_read_buffer_index, size);
     TRY(data.write(m_read_buffer->data + m_read_buffer_index, nread));
-    if (advance_buffer_index)
+
+    // Hand out whatever is waiting in the write buffer as well, so a large message doesn't take two reads.
+    size_t nread_from_write_buffer = min(m_write_buffer->size, size - nread);
+    if (nread_from_write_buffer > 0)
+        TRY(data.write(m_write_buffer->data, nread, nread_from_write_buffer));
+
+    if (advance_buffer_index) {
         m_read_buffer_index += nread;
+        if (nread_from_write_buffer > 0) {
+            flip();
+            m_read_buffer_index = nread_from_write_buffer;
+        }
+    }
+    nread += nread_from_write_buffer;
     compute_lockfree_metadata();
     if (m_unblock_callback && m_space_for_writing > 0)
         m_unblock_callback();
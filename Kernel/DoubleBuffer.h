@@ -16,7 +16,9 @@ namespace Kernel {
 
 class DoubleBuffer {
 public:
-    static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create(StringView name, size_t capacity = 65536);
+    // The buffer starts out with room for `capacity` bytes, and grows on demand up to `max_capacity` bytes.
+    // NOTE: The name must outlive the buffer, as it is reused when growing.
+    static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create(StringView name, size_t capacity = 65536, size_t max_capacity = 0);
     ErrorOr<size_t> write(UserOrKernelBuffer const&, size_t);
     ErrorOr<size_t> write(u8 const* data, size_t size)
     {
@@ -38,6 +40,7 @@ public:
     bool is_empty() const { return m_empty; }
 
     size_t space_for_writing() const { return m_space_for_writing; }
+    size_t capacity() const { return m_capacity; }
     size_t immediately_readable() const
     {
         return (m_read_buffer->size - m_read_buffer_index) + m_write_buffer->size;
@@ -50,9 +53,10 @@ public:
     }
 
 private:
-    explicit DoubleBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage);
+    DoubleBuffer(StringView name, size_t capacity, size_t max_capacity, NonnullOwnPtr<KBuffer> storage);
     void flip();
     void compute_lockfree_metadata();
+    ErrorOr<void> try_grow(size_t space_needed);
 
     ErrorOr<size_t> read_impl(UserOrKernelBuffer&, size_t, MutexLocker&, bool advance_buffer_index);
 
@@ -66,9 +70,11 @@ private:
     InnerBuffer m_buffer1;
     InnerBuffer m_buffer2;
 
+    StringView m_name;
     NonnullOwnPtr<KBuffer> m_storage;
     Function<void()> m_unblock_callback;
     size_t m_capacity { 0 };
+    size_t m_max_capacity { 0 };
     size_t m_read_buffer_index { 0 };
     size_t m_space_for_writing { 0 };
     bool m_empty { true };
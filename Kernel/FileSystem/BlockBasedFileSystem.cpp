@@ -5,9 +5,13 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -16,20 +20,33 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_mapped { false };
+    bool is_hot { false };
+    // Read ahead of time, and not referenced since.
+    bool was_prefetched { false };
+    u64 dirtied_at_ms { 0 };
 };
 
+// The cache is a simplified 2Q: blocks enter on the cold list and are only
+// promoted to the hot list once they are referenced again. Eviction always
+// takes from the cold list first, so a single pass over a large number of
+// blocks (e.g. `find /`) can't flush out the working set.
+//
+// Entries are allocated in chunks. The cache grows a chunk at a time when it
+// would otherwise have to evict and there's plenty of free physical memory,
+// and gives chunks back when physical memory runs low.
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    static constexpr size_t EntriesPerChunk = 1024;
+    static constexpr size_t MinimumChunkCount = 10;
+    static constexpr size_t MaximumChunkCount = 1024;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(BlockBasedFileSystem& fs)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(fs)));
+        for (size_t i = 0; i < MinimumChunkCount; ++i)
+            TRY(cache->try_add_chunk());
+        return cache;
     }
 
     ~DiskCache() = default;
@@ -40,17 +57,28 @@ public:
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+            mark_clean(*entry);
     }
 
+    // The dirty list is kept in the order blocks were first dirtied, so that
+    // its tail always holds the oldest dirty block.
     void mark_dirty(CacheEntry& entry)
     {
+        if (entry_is_dirty(entry))
+            return;
+        entry.dirtied_at_ms = TimeManagement::the().uptime_ms();
         m_dirty_list.prepend(entry);
+        ++m_dirty_count;
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (entry_is_dirty(entry))
+            --m_dirty_count;
+        if (entry.is_hot)
+            m_hot_list.prepend(entry);
+        else
+            m_cold_list.prepend(entry);
     }
 
     CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
@@ -64,54 +92,224 @@ public:
     }
 
     ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        if (auto* entry = get(block_index)) {
+            ++m_statistics.hits;
+            touch(*entry);
+            return entry;
+        }
+
+        ++m_statistics.misses;
+        return insert(block_index);
+    }
+
+    // Like ensure(), but for blocks that are read ahead of time. A new entry goes on the cold list
+    // without counting as a miss, and the first real access to it doesn't promote it to the hot list.
+    ErrorOr<CacheEntry*> ensure_for_prefetch(BlockBasedFileSystem::BlockIndex block_index) const
     {
         if (auto* entry = get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
+        auto* entry = TRY(insert(block_index));
+        entry->was_prefetched = true;
+        return entry;
+    }
+
+    // Gives chunks back to the system while physical memory is scarce.
+    // Only chunks without any dirty entries can be released, so this is best
+    // called right after flushing.
+    void shrink_if_under_memory_pressure()
+    {
+        while (m_chunks.size() > MinimumChunkCount && is_under_memory_pressure()) {
+            if (!try_remove_last_chunk())
+                return;
+        }
+    }
+
+    DiskCacheStatistics statistics() const
+    {
+        auto statistics = m_statistics;
+        statistics.entry_count = m_chunks.size() * EntriesPerChunk;
+        return statistics;
+    }
+
+    size_t dirty_count() const { return m_dirty_count; }
+    size_t entry_count() const { return m_chunks.size() * EntriesPerChunk; }
+
+    // Collects the oldest dirty entries that were dirtied before the given time, oldest first.
+    template<size_t inline_capacity>
+    void collect_dirty_entries(Vector<CacheEntry*, inline_capacity>& entries, u64 dirtied_before_ms)
+    {
+        for (auto it = m_dirty_list.rbegin(); it != m_dirty_list.rend() && entries.size() < inline_capacity; ++it) {
+            if (it->dirtied_at_ms >= dirtied_before_ms)
+                break;
+            entries.unchecked_append(&*it);
+        }
+    }
+
+private:
+    struct Chunk {
+        NonnullOwnPtr<KBuffer> block_data;
+        NonnullOwnPtr<KBuffer> entries_buffer;
+
+        CacheEntry* entries() { return (CacheEntry*)entries_buffer->data(); }
+    };
+
+    explicit DiskCache(BlockBasedFileSystem& fs)
+        : m_fs(fs)
+    {
+    }
+
+    // At most three quarters of the cache can be hot, the rest is left for
+    // blocks that haven't proven themselves yet.
+    size_t maximum_hot_count() const { return entry_count() / 4 * 3; }
+
+    ErrorOr<CacheEntry*> insert(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        if (m_cold_list.is_empty() && m_hot_list.is_empty()) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
             //       not some FileBackedFileSystem subclass flush!
             m_fs.flush_writes_impl();
-            return ensure(block_index);
+            return insert(block_index);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        auto* victim = eviction_candidate();
+        if (victim->is_mapped && should_grow() && !try_add_chunk().is_error())
+            victim = eviction_candidate();
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        auto& new_entry = *victim;
+        if (new_entry.is_mapped) {
+            m_hash.remove(new_entry.block_index);
+            ++m_statistics.evictions;
+        }
+        if (new_entry.is_hot) {
+            new_entry.is_hot = false;
+            --m_hot_count;
+        }
+        m_cold_list.prepend(new_entry);
 
+        new_entry.is_mapped = false;
+        TRY(m_hash.try_set(block_index, &new_entry));
+        new_entry.is_mapped = true;
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.was_prefetched = false;
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    void touch(CacheEntry& entry) const
+    {
+        bool is_dirty = entry_is_dirty(entry);
+        if (entry.was_prefetched) {
+            // This is the first reference to the block, so it stays cold.
+            entry.was_prefetched = false;
+            if (!is_dirty)
+                m_cold_list.prepend(entry);
+            return;
+        }
+        if (!entry.is_hot) {
+            entry.is_hot = true;
+            ++m_hot_count;
+            demote_hot_entries_if_needed();
+        }
+        if (!is_dirty)
+            m_hot_list.prepend(entry);
+    }
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void demote_hot_entries_if_needed() const
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        while (m_hot_count > maximum_hot_count()) {
+            auto* entry = m_hot_list.last();
+            if (!entry)
+                return;
+            entry->is_hot = false;
+            --m_hot_count;
+            m_cold_list.prepend(*entry);
+        }
+    }
+
+    CacheEntry* eviction_candidate() const
+    {
+        if (auto* entry = m_cold_list.last())
+            return entry;
+        VERIFY(m_hot_list.last());
+        return m_hot_list.last();
+    }
+
+    static bool is_under_memory_pressure()
+    {
+        auto info = MM.get_system_memory_info();
+        auto available = info.physical_pages - info.physical_pages_used;
+        return available < info.physical_pages / 8;
+    }
+
+    bool should_grow() const
+    {
+        if (m_chunks.size() >= MaximumChunkCount)
+            return false;
+        auto info = MM.get_system_memory_info();
+        auto available = info.physical_pages - info.physical_pages_used;
+        auto chunk_pages = (EntriesPerChunk * (m_fs.block_size() + sizeof(CacheEntry))) / PAGE_SIZE;
+        return available > chunk_pages && available - chunk_pages > info.physical_pages / 4;
+    }
+
+    ErrorOr<void> try_add_chunk() const
+    {
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, EntriesPerChunk * m_fs.block_size()));
+        auto entries_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, EntriesPerChunk * sizeof(CacheEntry)));
+        TRY(m_chunks.try_append(Chunk { move(block_data), move(entries_buffer) }));
+
+        auto& chunk = m_chunks.last();
+        for (size_t i = 0; i < EntriesPerChunk; ++i) {
+            auto* entry = new (&chunk.entries()[i]) CacheEntry;
+            entry->data = chunk.block_data->data() + i * m_fs.block_size();
+            // Fresh entries go to the back of the cold list so they're used before anything gets evicted.
+            m_cold_list.append(*entry);
+        }
+        return {};
+    }
+
+    bool try_remove_last_chunk()
+    {
+        auto& chunk = m_chunks.last();
+        for (size_t i = 0; i < EntriesPerChunk; ++i) {
+            if (entry_is_dirty(chunk.entries()[i]))
+                return false;
+        }
+        for (size_t i = 0; i < EntriesPerChunk; ++i) {
+            auto& entry = chunk.entries()[i];
+            if (entry.is_mapped)
+                m_hash.remove(entry.block_index);
+            if (entry.is_hot)
+                --m_hot_count;
+            entry.list_node.remove();
+            entry.~CacheEntry();
+        }
+        m_chunks.take_last();
+        return true;
     }
 
-private:
     BlockBasedFileSystem& m_fs;
     mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
+    mutable IntrusiveList<&CacheEntry::list_node> m_cold_list;
+    mutable IntrusiveList<&CacheEntry::list_node> m_hot_list;
     mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-    NonnullOwnPtr<KBuffer> m_entries;
+    mutable size_t m_hot_count { 0 };
+    size_t m_dirty_count { 0 };
+    mutable Vector<Chunk> m_chunks;
+    mutable DiskCacheStatistics m_statistics;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
 {
     VERIFY(file_description.file().is_seekable());
+
+    auto dirty_ratio = kernel_command_line().disk_cache_dirty_ratio();
+    VERIFY(dirty_ratio > 0 && dirty_ratio <= 100);
+    m_dirty_ratio = dirty_ratio;
 }
 
 BlockBasedFileSystem::~BlockBasedFileSystem() = default;
@@ -119,9 +317,9 @@ BlockBasedFileSystem::~BlockBasedFileSystem() = default;
 ErrorOr<void> BlockBasedFileSystem::initialize()
 {
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(*this));
+    m_writeback_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Writeback buffer"sv, MaxBlocksPerWritebackBatch * block_size()));
+    m_readahead_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Readahead buffer"sv, MaxReadaheadBlocks * block_size()));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -142,7 +340,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    TRY(m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
@@ -161,7 +359,11 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
         cache->mark_dirty(*entry);
         entry->has_data = true;
         return {};
-    });
+    }));
+
+    if (allow_cache)
+        throttle_dirty_writes_if_needed();
+    return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
@@ -255,6 +457,70 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
+// NOTE: Storage devices may transfer less than asked for in one go, so these keep
+//       going until the whole range has been transferred.
+ErrorOr<void> BlockBasedFileSystem::read_exactly(u64 offset, UserOrKernelBuffer& buffer, size_t count) const
+{
+    size_t nread = 0;
+    while (nread < count) {
+        auto chunk_buffer = buffer.offset(nread);
+        auto chunk_size = TRY(file_description().read(chunk_buffer, offset + nread, count - nread));
+        if (chunk_size == 0)
+            return EIO;
+        nread += chunk_size;
+    }
+    return {};
+}
+
+ErrorOr<void> BlockBasedFileSystem::write_exactly(u64 offset, UserOrKernelBuffer const& buffer, size_t count)
+{
+    size_t nwritten = 0;
+    while (nwritten < count) {
+        auto chunk_size = TRY(file_description().write(offset + nwritten, buffer.offset(nwritten), count - nwritten));
+        if (chunk_size == 0)
+            return EIO;
+        nwritten += chunk_size;
+    }
+    return {};
+}
+
+ErrorOr<void> BlockBasedFileSystem::prefetch_blocks(BlockIndex index, size_t count) const
+{
+    VERIFY(m_logical_block_size);
+    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+        auto is_cached = [&](u64 block) {
+            auto* entry = cache->get(BlockIndex { block });
+            return entry && entry->has_data;
+        };
+
+        auto block = index.value();
+        auto end = index.value() + count;
+        while (block < end) {
+            // Skip over whatever is already in the cache, and read the next uncached run in one go.
+            while (block < end && is_cached(block))
+                ++block;
+            auto run_start = block;
+            while (block < end && block - run_start < MaxReadaheadBlocks && !is_cached(block))
+                ++block;
+            auto run_length = block - run_start;
+            if (!run_length)
+                break;
+
+            auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(m_readahead_buffer->data());
+            TRY(read_exactly(run_start * block_size(), run_buffer, run_length * block_size()));
+
+            for (size_t i = 0; i < run_length; ++i) {
+                auto* entry = TRY(cache->ensure_for_prefetch(BlockIndex { run_start + i }));
+                if (entry->has_data)
+                    continue;
+                memcpy(entry->data, m_readahead_buffer->data() + i * block_size(), block_size());
+                entry->has_data = true;
+            }
+        }
+        return {};
+    });
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
     m_cache.with_exclusive([&](auto& cache) {
@@ -271,26 +537,104 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
     });
 }
 
+size_t BlockBasedFileSystem::flush_dirty_batch(u64 dirtied_before_ms)
+{
+    return m_cache.with_exclusive([&](auto& cache) -> size_t {
+        if (!cache->is_dirty())
+            return 0;
+
+        Vector<CacheEntry*, MaxBlocksPerWritebackBatch> batch;
+        cache->collect_dirty_entries(batch, dirtied_before_ms);
+        if (batch.is_empty())
+            return 0;
+
+        // Submit the batch in block order, merging runs of adjacent blocks into a single write.
+        quick_sort(batch, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+        Vector<WritebackBlock, MaxBlocksPerWritebackBatch> blocks;
+        for (auto* entry : batch)
+            blocks.unchecked_append({ entry->block_index, entry->data });
+        will_write_back_blocks(blocks);
+
+        for (size_t i = 0; i < batch.size();) {
+            size_t run_length = 1;
+            while (i + run_length < batch.size() && batch[i + run_length]->block_index.value() == batch[i]->block_index.value() + run_length)
+                ++run_length;
+
+            auto base_offset = batch[i]->block_index.value() * block_size();
+            if (run_length == 1) {
+                auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(batch[i]->data);
+                [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
+            } else {
+                for (size_t j = 0; j < run_length; ++j)
+                    memcpy(m_writeback_buffer->data() + j * block_size(), batch[i + j]->data, block_size());
+                auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(m_writeback_buffer->data());
+                [[maybe_unused]] auto rc = write_exactly(base_offset, run_buffer, run_length * block_size());
+            }
+            i += run_length;
+        }
+        did_write_back_blocks(blocks);
+
+        for (auto* entry : batch)
+            cache->mark_clean(*entry);
+        return batch.size();
+    });
+}
+
 void BlockBasedFileSystem::flush_writes_impl()
 {
+    // NOTE: The cache lock is dropped between batches, so that other readers and
+    //       writers don't stall behind one long flush of the entire cache.
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
+    while (auto flushed = flush_dirty_batch(NumericLimits<u64>::max()))
+        count += flushed;
+    if (count)
         dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+}
+
+void BlockBasedFileSystem::flush_expired_writes()
+{
+    auto now = TimeManagement::the().uptime_ms();
+    if (now < DirtyExpireMs)
+        return;
+    for (size_t i = 0; i < MaxWritebackBatchesPerPass; ++i) {
+        if (!flush_dirty_batch(now - DirtyExpireMs))
+            break;
+    }
+    m_cache.with_exclusive([&](auto& cache) {
+        cache->shrink_if_under_memory_pressure();
     });
 }
 
+void BlockBasedFileSystem::throttle_dirty_writes_if_needed()
+{
+    auto is_over_dirty_limit = [&] {
+        return m_cache.with_exclusive([&](auto& cache) {
+            return cache->dirty_count() * 100 > cache->entry_count() * m_dirty_ratio;
+        });
+    };
+
+    // The writer that pushed the cache over its dirty limit pays for writing
+    // back the oldest blocks until we're below the limit again.
+    while (is_over_dirty_limit()) {
+        if (!flush_dirty_batch(NumericLimits<u64>::max()))
+            break;
+    }
+}
+
 void BlockBasedFileSystem::flush_writes()
 {
     flush_writes_impl();
+    m_cache.with_exclusive([&](auto& cache) {
+        cache->shrink_if_under_memory_pressure();
+    });
+}
+
+DiskCacheStatistics BlockBasedFileSystem::cache_statistics() const
+{
+    return m_cache.with_exclusive([&](auto& cache) {
+        return cache->statistics();
+    });
 }
 
 }
@@ -11,6 +11,13 @@
 
 namespace Kernel {
 
+struct DiskCacheStatistics {
+    u64 hits { 0 };
+    u64 misses { 0 };
+    u64 evictions { 0 };
+    size_t entry_count { 0 };
+};
+
 class BlockBasedFileSystem : public FileBackedFileSystem {
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
@@ -21,14 +28,33 @@ public:
     u64 logical_block_size() const { return m_logical_block_size; };
 
     virtual void flush_writes() override;
+    virtual void flush_expired_writes() override;
     void flush_writes_impl();
 
+    DiskCacheStatistics cache_statistics() const;
+
+    struct WritebackBlock {
+        BlockIndex block_index;
+        u8 const* data { nullptr };
+    };
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
+    static constexpr size_t MaxBlocksPerWritebackBatch = 128;
+
+    // These are called with the cache locked, right before and after a batch of dirty blocks is written back
+    // to its place on disk. They must not go through the cache themselves.
+    virtual void will_write_back_blocks(Span<WritebackBlock const>) { }
+    virtual void did_write_back_blocks(Span<WritebackBlock const>) { }
+
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
 
+    // Reads a run of physically contiguous blocks into the cache with as few device reads as possible.
+    ErrorOr<void> prefetch_blocks(BlockIndex, size_t count) const;
+    static constexpr size_t MaxReadaheadBlocks = 64;
+
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
 
@@ -38,13 +64,27 @@ protected:
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
+    ErrorOr<void> read_exactly(u64 offset, UserOrKernelBuffer&, size_t count) const;
+    ErrorOr<void> write_exactly(u64 offset, UserOrKernelBuffer const&, size_t count);
+
     u64 m_logical_block_size { 512 };
 
 private:
+    // Blocks that have been dirty for longer than this are written back by the periodic writeback.
+    static constexpr u64 DirtyExpireMs = 5000;
+    static constexpr size_t MaxWritebackBatchesPerPass = 8;
+
+    virtual bool is_block_based() const override { return true; }
+
     DiskCache& cache() const;
     void flush_specific_block_if_needed(BlockIndex index);
+    size_t flush_dirty_batch(u64 dirtied_before_ms);
+    void throttle_dirty_writes_if_needed();
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    OwnPtr<KBuffer> m_writeback_buffer;
+    mutable OwnPtr<KBuffer> m_readahead_buffer;
+    size_t m_dirty_ratio { 0 };
 };
 
 }
@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashFunctions.h>
 #include <AK/RefPtr.h>
 #include <AK/Singleton.h>
 #include <AK/StringBuilder.h>
+#include <AK/StringHash.h>
 #include <AK/StringView.h>
 #include <AK/Vector.h>
 #include <Kernel/FileSystem/Custody.h>
@@ -14,17 +16,23 @@
 
 namespace Kernel {
 
-static Singleton<SpinlockProtected<Custody::AllCustodiesList>> s_all_instances;
+static Singleton<SpinlockProtected<Custody::AllCustodiesTable>> s_all_instances;
 
-SpinlockProtected<Custody::AllCustodiesList>& Custody::all_instances()
+SpinlockProtected<Custody::AllCustodiesTable>& Custody::all_instances()
 {
     return s_all_instances;
 }
 
+size_t Custody::AllCustodiesTable::bucket_index_for(Custody const* parent, StringView name)
+{
+    return pair_int_hash(ptr_hash(parent), string_hash(name.characters_without_null_termination(), name.length())) % bucket_count;
+}
+
 ErrorOr<NonnullRefPtr<Custody>> Custody::try_create(Custody* parent, StringView name, Inode& inode, int mount_flags)
 {
     return all_instances().with([&](auto& all_custodies) -> ErrorOr<NonnullRefPtr<Custody>> {
-        for (Custody& custody : all_custodies) {
+        auto& bucket = all_custodies.bucket_for(parent, name);
+        for (Custody& custody : bucket) {
             if (custody.parent() == parent
                 && custody.name() == name
                 && &custody.inode() == &inode
@@ -35,7 +43,7 @@ ErrorOr<NonnullRefPtr<Custody>> Custody::try_create(Custody* parent, StringView
 
         auto name_kstring = TRY(KString::try_create(name));
         auto custody = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Custody(parent, move(name_kstring), inode, mount_flags)));
-        all_custodies.prepend(*custody);
+        bucket.prepend(*custody);
         return custody;
     });
 }
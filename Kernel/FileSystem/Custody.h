@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Error.h>
 #include <AK/IntrusiveList.h>
 #include <AK/RefPtr.h>
@@ -44,7 +45,21 @@ private:
 
 public:
     using AllCustodiesList = IntrusiveList<&Custody::m_all_custodies_list_node>;
-    static SpinlockProtected<Custody::AllCustodiesList>& all_instances();
+
+    // All custodies, hashed by parent and name so that try_create() doesn't have to walk every one of them.
+    class AllCustodiesTable {
+    public:
+        AllCustodiesList& bucket_for(Custody const* parent, StringView name) { return m_buckets[bucket_index_for(parent, name)]; }
+        void remove(Custody& custody) { bucket_for(custody.m_parent.ptr(), custody.name()).remove(custody); }
+
+    private:
+        static constexpr size_t bucket_count = 1024;
+        static size_t bucket_index_for(Custody const* parent, StringView name);
+
+        Array<AllCustodiesList, bucket_count> m_buckets;
+    };
+
+    static SpinlockProtected<Custody::AllCustodiesTable>& all_instances();
 };
 
 }
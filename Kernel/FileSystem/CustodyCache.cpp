@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/Singleton.h>
+#include <AK/StringHash.h>
+#include <Kernel/FileSystem/CustodyCache.h>
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/FileSystem/Inode.h>
+
+namespace Kernel {
+
+static Singleton<CustodyCache> s_the;
+
+CustodyCache& CustodyCache::the()
+{
+    return *s_the;
+}
+
+CustodyCache::CustodyCache() = default;
+
+// NOTE: Entries are bucketed by the directory inode rather than the parent custody,
+//       so that invalidating a name reaches every custody through which the directory was looked up.
+size_t CustodyCache::bucket_index_for(Inode const& directory, StringView name)
+{
+    return pair_int_hash(ptr_hash(&directory), string_hash(name.characters_without_null_termination(), name.length())) % bucket_count;
+}
+
+CustodyCache::LookupResult CustodyCache::lookup(Custody& parent, StringView name)
+{
+    auto index = bucket_index_for(parent.inode(), name);
+    return m_state.with([&](State& state) -> LookupResult {
+        auto& bucket = state.buckets[index];
+        for (auto& entry : bucket.entries) {
+            if (entry.parent.ptr() != &parent || entry.name->view() != name)
+                continue;
+            state.lru.remove(entry);
+            state.lru.prepend(entry);
+            return { true, entry.child, bucket.generation };
+        }
+        return { false, nullptr, bucket.generation };
+    });
+}
+
+void CustodyCache::add(Custody& parent, StringView name, RefPtr<Custody> child, u64 generation)
+{
+    if (!parent.inode().fs().supports_path_lookup_cache())
+        return;
+
+    auto name_or_error = KString::try_create(name);
+    if (name_or_error.is_error())
+        return;
+    auto index = bucket_index_for(parent.inode(), name);
+    auto* new_entry = new (nothrow) Entry { parent, name_or_error.release_value(), move(child), index, {}, {} };
+    if (!new_entry)
+        return;
+
+    LRUList dead_entries;
+    m_state.with([&](State& state) {
+        auto& bucket = state.buckets[index];
+        if (bucket.generation != generation) {
+            dead_entries.append(*new_entry);
+            return;
+        }
+        for (auto& entry : bucket.entries) {
+            if (entry.parent.ptr() == &parent && entry.name->view() == name) {
+                remove_entry(state, entry, dead_entries);
+                break;
+            }
+        }
+        while (state.entry_count >= max_entries)
+            remove_entry(state, *state.lru.last(), dead_entries);
+
+        bucket.entries.append(*new_entry);
+        state.lru.prepend(*new_entry);
+        ++state.entry_count;
+    });
+    destroy(dead_entries);
+}
+
+void CustodyCache::invalidate(Inode& directory, StringView name)
+{
+    auto index = bucket_index_for(directory, name);
+    LRUList dead_entries;
+    m_state.with([&](State& state) {
+        auto& bucket = state.buckets[index];
+        ++bucket.generation;
+        for (auto it = bucket.entries.begin(); it != bucket.entries.end();) {
+            auto& entry = *it;
+            ++it;
+            if (&entry.parent->inode() == &directory && entry.name->view() == name)
+                remove_entry(state, entry, dead_entries);
+        }
+    });
+    destroy(dead_entries);
+}
+
+void CustodyCache::invalidate_all()
+{
+    LRUList dead_entries;
+    m_state.with([&](State& state) {
+        for (auto& bucket : state.buckets)
+            ++bucket.generation;
+        while (!state.lru.is_empty())
+            remove_entry(state, *state.lru.first(), dead_entries);
+    });
+    destroy(dead_entries);
+}
+
+void CustodyCache::remove_entry(State& state, Entry& entry, LRUList& dead_entries)
+{
+    state.buckets[entry.bucket_index].entries.remove(entry);
+    state.lru.remove(entry);
+    --state.entry_count;
+    dead_entries.append(entry);
+}
+
+// NOTE: Dropping the last reference to a custody may drop the last reference to its inode as well,
+//       which can do I/O, so entries are only destroyed once the cache is unlocked.
+void CustodyCache::destroy(LRUList& dead_entries)
+{
+    while (auto* entry = dead_entries.take_first())
+        delete entry;
+}
+
+}
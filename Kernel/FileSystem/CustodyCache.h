@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/IntrusiveList.h>
+#include <AK/RefPtr.h>
+#include <AK/StringView.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/Forward.h>
+#include <Kernel/KString.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// Remembers the outcome of looking up a name in a directory during path resolution, so that resolving
+// the same path again doesn't have to go through Inode::lookup(). Failed lookups are remembered as well
+// (negative entries), as build systems probe lots of paths that don't exist.
+// Only directories on file systems whose contents change exclusively through the VirtualFileSystem are
+// cached, see FileSystem::supports_path_lookup_cache(). The VirtualFileSystem invalidates a name
+// whenever it changes a directory, and drops everything whenever the mount table changes.
+class CustodyCache {
+    AK_MAKE_NONCOPYABLE(CustodyCache);
+    AK_MAKE_NONMOVABLE(CustodyCache);
+
+public:
+    static CustodyCache& the();
+
+    CustodyCache();
+
+    struct LookupResult {
+        bool is_cached { false };
+        // The child custody (with any mount already resolved), or null if the name is known not to exist.
+        RefPtr<Custody> custody;
+        // On a miss, this has to be passed to add() for the result of the lookup to be remembered.
+        u64 generation { 0 };
+    };
+
+    LookupResult lookup(Custody& parent, StringView name);
+
+    // Remembers that `name` in `parent` resolves to `child`, or doesn't exist at all if `child` is null.
+    // This is silently dropped if the directory was changed since the lookup that handed out `generation`.
+    void add(Custody& parent, StringView name, RefPtr<Custody> child, u64 generation);
+
+    void invalidate(Inode& directory, StringView name);
+    void invalidate_all();
+
+private:
+    struct Entry {
+        NonnullRefPtr<Custody> parent;
+        NonnullOwnPtr<KString> name;
+        RefPtr<Custody> child;
+        size_t bucket_index { 0 };
+
+        IntrusiveListNode<Entry> bucket_list_node;
+        IntrusiveListNode<Entry> lru_list_node;
+    };
+
+    using BucketList = IntrusiveList<&Entry::bucket_list_node>;
+    using LRUList = IntrusiveList<&Entry::lru_list_node>;
+
+    static constexpr size_t bucket_count = 1024;
+    static constexpr size_t max_entries = 8192;
+
+    struct Bucket {
+        BucketList entries;
+        // Bumped whenever a name hashing to this bucket is invalidated.
+        u64 generation { 0 };
+    };
+
+    struct State {
+        Array<Bucket, bucket_count> buckets;
+        // Most recently used first.
+        LRUList lru;
+        size_t entry_count { 0 };
+    };
+
+    static size_t bucket_index_for(Inode const& directory, StringView name);
+    static void remove_entry(State&, Entry&, LRUList& dead_entries);
+    static void destroy(LRUList& dead_entries);
+
+    SpinlockProtected<State> m_state { LockRank::None };
+};
+
+}
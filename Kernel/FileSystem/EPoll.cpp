@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Protects the links between interests and their descriptions, so interests can't be destroyed
+// by their EPoll and their description at the same time.
+// NOTE: This is always taken before the blocker set locks, which are taken before EPoll::m_lock.
+static Spinlock s_interest_links_lock { LockRank::None };
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // always report EPOLLERR and EPOLLHUP
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 events_for_unblock_flags(BlockFlags unblock_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblock_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblock_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(unblock_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (!has_flag(unblock_flags, BlockFlags::WriteHangUp) && has_flag(unblock_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblock_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    return events;
+}
+
+void EPollInterest::file_readiness_may_have_changed()
+{
+    // NOTE: We are called with the blocker set of our description locked,
+    //       which keeps the description from going away underneath us.
+    m_epoll.update_readiness(*this);
+}
+
+ErrorOr<NonnullLockRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll()
+{
+    SpinlockLocker links_lock(s_interest_links_lock);
+    for (;;) {
+        EPollInterest* interest = nullptr;
+        {
+            SpinlockLocker lock(m_lock);
+            if (m_interests.is_empty())
+                break;
+            interest = m_interests.begin()->value.ptr();
+        }
+        destroy_interest(*interest);
+    }
+}
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    SpinlockLocker lock(m_lock);
+    return m_ready_count > 0;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    SpinlockLocker lock(m_lock);
+    return KString::formatted("EPoll:({})", m_interests.size());
+}
+
+void EPoll::update_readiness(EPollInterest& interest)
+{
+    {
+        SpinlockLocker lock(m_lock);
+        if (interest.m_is_queued || interest.m_is_disarmed)
+            return;
+        auto unblock_flags = interest.m_description.should_unblock(block_flags_for_events(interest.m_events));
+        if (unblock_flags == BlockFlags::None)
+            return;
+        m_ready_list.append(interest);
+        ++m_ready_count;
+        interest.m_is_queued = true;
+    }
+    evaluate_block_conditions();
+}
+
+void EPoll::destroy_interest(EPollInterest& interest)
+{
+    VERIFY(s_interest_links_lock.is_locked());
+
+    interest.m_description.blocker_set().remove_readiness_observer(interest);
+    interest.m_description.epoll_interests({}).remove(interest);
+
+    OwnPtr<EPollInterest> doomed_interest;
+    {
+        SpinlockLocker lock(m_lock);
+        if (interest.m_is_queued) {
+            m_ready_list.remove(interest);
+            --m_ready_count;
+        }
+        auto it = m_interests.find(interest.m_fd);
+        VERIFY(it != m_interests.end() && it->value.ptr() == &interest);
+        doomed_interest = move(it->value);
+        m_interests.remove(it);
+    }
+}
+
+ErrorOr<void> EPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // FIXME: Support nesting epolls, this needs loop detection.
+    if (description.is_epoll())
+        return EINVAL;
+
+    auto new_interest = TRY(adopt_nonnull_own_or_enomem(new (nothrow) EPollInterest(*this, description, fd, event)));
+    auto& interest = *new_interest;
+
+    SpinlockLocker links_lock(s_interest_links_lock);
+    EPollInterest* existing_interest = nullptr;
+    {
+        SpinlockLocker lock(m_lock);
+        if (auto it = m_interests.find(fd); it != m_interests.end())
+            existing_interest = it->value.ptr();
+    }
+    if (existing_interest) {
+        if (&existing_interest->m_description == &description)
+            return EEXIST;
+        // The fd was closed and has since been reused, while the old description is kept alive
+        // by another fd (e.g. after dup()). Nobody can refer to the old interest anymore.
+        destroy_interest(*existing_interest);
+    }
+
+    {
+        SpinlockLocker lock(m_lock);
+        TRY(m_interests.try_set(fd, move(new_interest)));
+    }
+    description.epoll_interests({}).append(interest);
+    description.blocker_set().add_readiness_observer(interest);
+    return {};
+}
+
+ErrorOr<void> EPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    SpinlockLocker links_lock(s_interest_links_lock);
+    EPollInterest* interest = nullptr;
+    {
+        SpinlockLocker lock(m_lock);
+        auto it = m_interests.find(fd);
+        if (it == m_interests.end() || &it->value->m_description != &description)
+            return ENOENT;
+        interest = it->value.ptr();
+        interest->m_events = event.events;
+        interest->m_data = event.data;
+        interest->m_is_disarmed = false;
+        if (interest->m_is_queued) {
+            // Let collect_ready_events() figure out whether it's still ready for the new events.
+            return {};
+        }
+    }
+    update_readiness(*interest);
+    return {};
+}
+
+ErrorOr<void> EPoll::remove_interest(int fd, OpenFileDescription& description)
+{
+    SpinlockLocker links_lock(s_interest_links_lock);
+    EPollInterest* interest = nullptr;
+    {
+        SpinlockLocker lock(m_lock);
+        auto it = m_interests.find(fd);
+        if (it == m_interests.end() || &it->value->m_description != &description)
+            return ENOENT;
+        interest = it->value.ptr();
+    }
+    destroy_interest(*interest);
+    return {};
+}
+
+size_t EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    SpinlockLocker lock(m_lock);
+    size_t count = 0;
+    // Visit each queued interest at most once, level-triggered ones go back to the end of the queue
+    // so that a busy file can't starve the others.
+    for (size_t remaining = m_ready_count; remaining > 0 && count < events.size(); --remaining) {
+        auto* interest = m_ready_list.take_first();
+        --m_ready_count;
+        interest->m_is_queued = false;
+
+        auto unblock_flags = interest->m_description.should_unblock(block_flags_for_events(interest->m_events));
+        auto ready_events = events_for_unblock_flags(unblock_flags);
+        if (ready_events == 0) {
+            // No longer ready, it will be queued again once its file changes.
+            continue;
+        }
+
+        events[count++] = { ready_events, interest->m_data };
+
+        if (interest->m_events & EPOLLONESHOT) {
+            interest->m_is_disarmed = true;
+            continue;
+        }
+        if (interest->m_events & EPOLLET)
+            continue;
+
+        m_ready_list.append(*interest);
+        ++m_ready_count;
+        interest->m_is_queued = true;
+    }
+    return count;
+}
+
+void EPoll::remove_interests_for_description(Badge<OpenFileDescription>, OpenFileDescription& description)
+{
+    SpinlockLocker links_lock(s_interest_links_lock);
+    auto& interests = description.epoll_interests({});
+    while (!interests.is_empty()) {
+        auto& interest = *interests.first();
+        interest.m_epoll.destroy_interest(interest);
+    }
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+// One file description registered with an EPoll.
+class EPollInterest final : public FileReadinessObserver {
+public:
+    EPollInterest(EPoll& epoll, OpenFileDescription& description, int fd, epoll_event const& event)
+        : m_epoll(epoll)
+        , m_description(description)
+        , m_fd(fd)
+        , m_events(event.events)
+        , m_data(event.data)
+    {
+    }
+
+    virtual void file_readiness_may_have_changed() override;
+
+private:
+    friend class EPoll;
+
+    EPoll& m_epoll;
+    OpenFileDescription& m_description;
+    int m_fd { -1 };
+
+    // NOTE: Everything below is protected by the EPoll's lock.
+    u32 m_events { 0 };
+    epoll_data_t m_data {};
+    bool m_is_queued { false };
+    bool m_is_disarmed { false };
+
+    IntrusiveListNode<EPollInterest> m_ready_list_node;
+    IntrusiveListNode<EPollInterest> m_description_list_node;
+
+public:
+    using ReadyList = IntrusiveList<&EPollInterest::m_ready_list_node>;
+    using ListInDescription = IntrusiveList<&EPollInterest::m_description_list_node>;
+};
+
+// A persistent set of file descriptions to wait on. Unlike select() and poll(), the files tell
+// the EPoll when they may have become ready, so waiting costs O(ready files) instead of O(all files).
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    // Can't write to an epoll.
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd, OpenFileDescription&);
+
+    size_t collect_ready_events(Span<epoll_event>);
+
+    static void remove_interests_for_description(Badge<OpenFileDescription>, OpenFileDescription&);
+
+private:
+    friend class EPollInterest;
+
+    EPoll() = default;
+
+    void update_readiness(EPollInterest&);
+    void destroy_interest(EPollInterest&);
+
+    mutable Spinlock m_lock { LockRank::None };
+    HashMap<int, NonnullOwnPtr<EPollInterest>> m_interests;
+    EPollInterest::ReadyList m_ready_list;
+    size_t m_ready_count { 0 };
+};
+
+}
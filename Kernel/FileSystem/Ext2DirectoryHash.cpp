@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/Ext2DirectoryHash.h>
+#include <Kernel/FileSystem/ext2_fs.h>
+
+namespace Kernel {
+
+// NOTE: These have to match the Linux implementation bit for bit, including its treatment of
+//       names as signed or unsigned chars, as the hashes are stored on disk.
+
+static u32 rotate_left(u32 value, u32 bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+static int character_at(StringView name, size_t index, bool is_signed)
+{
+    auto c = static_cast<u8>(name[index]);
+    if (is_signed)
+        return static_cast<i8>(c);
+    return c;
+}
+
+static u32 legacy_hash(StringView name, bool is_signed)
+{
+    u32 hash = 0;
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (size_t i = 0; i < name.length(); ++i) {
+        hash = hash1 + (hash0 ^ static_cast<u32>(character_at(name, i, is_signed) * 7152373));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+// Packs (up to) the first `words * 4` bytes of the name into `buffer`, padding with a value derived from its length.
+static void pack_name(StringView name, u32* buffer, int words, bool is_signed)
+{
+    u32 padding = static_cast<u32>(name.length()) | (static_cast<u32>(name.length()) << 8);
+    padding |= padding << 16;
+
+    u32 value = padding;
+    size_t length = min(name.length(), static_cast<size_t>(words) * 4);
+    for (size_t i = 0; i < length; ++i) {
+        value = static_cast<u32>(character_at(name, i, is_signed)) + (value << 8);
+        if ((i % 4) == 3) {
+            *buffer++ = value;
+            value = padding;
+            --words;
+        }
+    }
+    if (--words >= 0)
+        *buffer++ = value;
+    while (--words >= 0)
+        *buffer++ = padding;
+}
+
+static void half_md4_transform(u32 (&buffer)[4], u32 const (&input)[8])
+{
+    constexpr u32 k1 = 0;
+    constexpr u32 k2 = 013240474631u;
+    constexpr u32 k3 = 015666365641u;
+
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+    auto round = [](auto function, u32& a, u32 b, u32 c, u32 d, u32 x, u32 s) {
+        a += function(b, c, d) + x;
+        a = rotate_left(a, s);
+    };
+
+    u32 a = buffer[0];
+    u32 b = buffer[1];
+    u32 c = buffer[2];
+    u32 d = buffer[3];
+
+    round(f, a, b, c, d, input[0] + k1, 3);
+    round(f, d, a, b, c, input[1] + k1, 7);
+    round(f, c, d, a, b, input[2] + k1, 11);
+    round(f, b, c, d, a, input[3] + k1, 19);
+    round(f, a, b, c, d, input[4] + k1, 3);
+    round(f, d, a, b, c, input[5] + k1, 7);
+    round(f, c, d, a, b, input[6] + k1, 11);
+    round(f, b, c, d, a, input[7] + k1, 19);
+
+    round(g, a, b, c, d, input[1] + k2, 3);
+    round(g, d, a, b, c, input[3] + k2, 5);
+    round(g, c, d, a, b, input[5] + k2, 9);
+    round(g, b, c, d, a, input[7] + k2, 13);
+    round(g, a, b, c, d, input[0] + k2, 3);
+    round(g, d, a, b, c, input[2] + k2, 5);
+    round(g, c, d, a, b, input[4] + k2, 9);
+    round(g, b, c, d, a, input[6] + k2, 13);
+
+    round(h, a, b, c, d, input[3] + k3, 3);
+    round(h, d, a, b, c, input[7] + k3, 9);
+    round(h, c, d, a, b, input[2] + k3, 11);
+    round(h, b, c, d, a, input[6] + k3, 15);
+    round(h, a, b, c, d, input[1] + k3, 3);
+    round(h, d, a, b, c, input[5] + k3, 9);
+    round(h, c, d, a, b, input[0] + k3, 11);
+    round(h, b, c, d, a, input[4] + k3, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+static void tea_transform(u32 (&buffer)[4], u32 const (&input)[4])
+{
+    constexpr u32 delta = 0x9E3779B9;
+
+    u32 sum = 0;
+    u32 b0 = buffer[0];
+    u32 b1 = buffer[1];
+    for (int i = 0; i < 16; ++i) {
+        sum += delta;
+        b0 += ((b1 << 4) + input[0]) ^ (b1 + sum) ^ ((b1 >> 5) + input[1]);
+        b1 += ((b0 << 4) + input[2]) ^ (b0 + sum) ^ ((b0 >> 5) + input[3]);
+    }
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const (&seed)[4])
+{
+    u32 buffer[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    if (seed[0] || seed[1] || seed[2] || seed[3]) {
+        for (size_t i = 0; i < 4; ++i)
+            buffer[i] = seed[i];
+    }
+
+    u32 hash = 0;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY_UNSIGNED:
+    case EXT2_HASH_LEGACY:
+        hash = legacy_hash(name, hash_version == EXT2_HASH_LEGACY);
+        break;
+    case EXT2_HASH_HALF_MD4_UNSIGNED:
+    case EXT2_HASH_HALF_MD4: {
+        bool is_signed = hash_version == EXT2_HASH_HALF_MD4;
+        for (auto remaining = name; !remaining.is_empty(); remaining = remaining.substring_view(min<size_t>(remaining.length(), 32))) {
+            u32 input[8];
+            pack_name(remaining, input, 8, is_signed);
+            half_md4_transform(buffer, input);
+        }
+        hash = buffer[1];
+        break;
+    }
+    case EXT2_HASH_TEA_UNSIGNED:
+    case EXT2_HASH_TEA: {
+        bool is_signed = hash_version == EXT2_HASH_TEA;
+        for (auto remaining = name; !remaining.is_empty(); remaining = remaining.substring_view(min<size_t>(remaining.length(), 16))) {
+            u32 input[4];
+            pack_name(remaining, input, 4, is_signed);
+            tea_transform(buffer, input);
+        }
+        hash = buffer[0];
+        break;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    hash &= ~1u;
+    // NOTE: The largest hash value is reserved to mark the end of the index when reading directories by hash.
+    if (hash == (0x7fffffffu << 1))
+        hash = (0x7fffffffu - 1) << 1;
+    return hash;
+}
+
+}
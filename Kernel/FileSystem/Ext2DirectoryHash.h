@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The hash used to order entries in ext2/3 hash-indexed (dir_index) directories.
+// `hash_version` is one of the EXT2_HASH_* values, already adjusted for the signedness the file system uses.
+// The lowest bit of the result is always clear, as the index uses it to mark hash collisions
+// that continue into the next leaf block.
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const (&seed)[4]);
+
+}
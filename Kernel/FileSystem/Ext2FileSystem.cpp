@@ -7,12 +7,15 @@
 
 #include <AK/HashMap.h>
 #include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringView.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/FileSystem/Ext2DirectoryHash.h>
 #include <Kernel/FileSystem/Ext2FileSystem.h>
+#include <Kernel/FileSystem/Ext2Journal.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/ext2_fs.h>
 #include <Kernel/Process.h>
@@ -28,6 +31,8 @@ struct Ext2FSDirectoryEntry {
     InodeIndex inode_index { 0 };
     u8 file_type { 0 };
     u16 record_length { 0 };
+    // Only used while laying out indexed directories.
+    u32 hash { 0 };
 };
 
 static u8 to_ext2_file_type(mode_t mode)
@@ -121,10 +126,12 @@ ErrorOr<void> Ext2FS::initialize()
     }
 
     auto blocks_to_read = ceil_div(m_block_group_count * sizeof(ext2_group_desc), block_size());
-    BlockIndex first_block_of_bgdt = block_size() == 1024 ? 2 : 1;
     m_cached_group_descriptor_table = TRY(KBuffer::try_create_with_size("Ext2FS: Block group descriptors"sv, block_size() * blocks_to_read, Memory::Region::Access::ReadWrite));
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(m_cached_group_descriptor_table->data());
-    TRY(read_blocks(first_block_of_bgdt, blocks_to_read, buffer));
+    TRY(read_block_group_descriptor_table());
+    TRY(m_block_group_summaries.try_resize(m_block_group_count));
+
+    if (super_block.s_feature_compat & EXT3_FEATURE_COMPAT_HAS_JOURNAL)
+        TRY(initialize_journal());
 
     if constexpr (EXT2_DEBUG) {
         for (unsigned i = 1; i <= m_block_group_count; ++i) {
@@ -137,6 +144,76 @@ ErrorOr<void> Ext2FS::initialize()
     return {};
 }
 
+ErrorOr<void> Ext2FS::read_block_group_descriptor_table()
+{
+    auto blocks_to_read = ceil_div(m_block_group_count * sizeof(ext2_group_desc), block_size());
+    BlockIndex first_block_of_bgdt = block_size() == 1024 ? 2 : 1;
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(m_cached_group_descriptor_table->data());
+    return read_blocks(first_block_of_bgdt, blocks_to_read, buffer);
+}
+
+// NOTE: This has to happen before anything else looks at the file system, as the journal may hold newer copies of any block.
+ErrorOr<void> Ext2FS::initialize_journal()
+{
+    VERIFY(m_lock.is_locked());
+    if ((m_super_block.s_feature_incompat & EXT3_FEATURE_INCOMPAT_JOURNAL_DEV) || !m_super_block.s_journal_inum) {
+        if (m_super_block.s_feature_incompat & EXT3_FEATURE_INCOMPAT_RECOVER) {
+            dmesgln("Ext2FS: File system needs to be recovered from an external journal, which is not supported");
+            return ENOTSUP;
+        }
+        return {};
+    }
+
+    Vector<BlockIndex> journal_blocks;
+    {
+        auto journal_inode = TRY(get_inode({ fsid(), m_super_block.s_journal_inum }));
+        journal_blocks = TRY(static_cast<Ext2FSInode&>(*journal_inode).compute_block_list());
+    }
+    auto journal = TRY(Ext2Journal::try_create(*this, move(journal_blocks)));
+    if (is_readonly()) {
+        if (journal->needs_recovery())
+            dmesgln("Ext2FS: Journal needs to be recovered, but the file system is read-only");
+        return {};
+    }
+
+    if (journal->needs_recovery()) {
+        TRY(journal->recover());
+        // The replayed blocks went through the disk cache, but everything we keep outside of it may be stale now.
+        m_inode_cache.clear();
+        m_cached_bitmaps.clear();
+        auto super_block_buffer = UserOrKernelBuffer::for_kernel_buffer((u8*)&m_super_block);
+        TRY(raw_read_blocks(2, (sizeof(ext2_super_block) / logical_block_size()), super_block_buffer));
+        TRY(read_block_group_descriptor_table());
+    }
+
+    // NOTE: The recovery flag stays set for as long as we may leave transactions behind in the journal.
+    if (journal->is_writable()) {
+        TRY(journal->prepare_for_writing());
+        m_journal = move(journal);
+        m_super_block.s_feature_incompat |= EXT3_FEATURE_INCOMPAT_RECOVER;
+    } else {
+        dmesgln("Ext2FS: Journal uses features that we can't write, continuing without it");
+        m_super_block.s_feature_incompat &= ~EXT3_FEATURE_INCOMPAT_RECOVER;
+    }
+    return flush_super_block();
+}
+
+void Ext2FS::will_write_back_blocks(Span<WritebackBlock const> blocks)
+{
+    if (!m_journal)
+        return;
+    if (auto result = m_journal->commit(blocks); result.is_error())
+        dbgln("Ext2FS[{}]: Failed to commit {} blocks to the journal: {}", fsid(), blocks.size(), result.error());
+}
+
+void Ext2FS::did_write_back_blocks(Span<WritebackBlock const>)
+{
+    if (!m_journal)
+        return;
+    if (auto result = m_journal->checkpoint(); result.is_error())
+        dbgln("Ext2FS[{}]: Failed to checkpoint the journal: {}", fsid(), result.error());
+}
+
 Ext2FSInode& Ext2FS::root_inode()
 {
     return *m_root_inode;
@@ -380,7 +457,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
 
     Vector<Ext2FS::BlockIndex> new_meta_blocks;
     if (new_shape.meta_blocks > old_shape.meta_blocks) {
-        new_meta_blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), new_shape.meta_blocks - old_shape.meta_blocks));
+        new_meta_blocks = TRY(fs().allocate_blocks_for_inode(*this, new_shape.meta_blocks - old_shape.meta_blocks, next_block_goal()));
     }
 
     m_raw_inode.i_blocks = (m_block_list.size() + new_shape.meta_blocks) * (fs().block_size() / 512);
@@ -614,12 +691,9 @@ ErrorOr<void> Ext2FS::free_inode(Ext2FSInode& inode)
 
     // Mark all blocks used by this inode as free.
     {
+        discard_block_reservation(inode.index());
         auto blocks = TRY(inode.compute_block_list_with_meta_blocks());
-        for (auto block_index : blocks) {
-            VERIFY(block_index <= super_block().s_blocks_count);
-            if (block_index.value())
-                TRY(set_block_allocation_state(block_index, false));
-        }
+        TRY(free_blocks(blocks));
     }
 
     // If the inode being freed is a directory, update block group directory counter.
@@ -651,7 +725,7 @@ void Ext2FS::flush_block_group_descriptor_table()
         dbgln("Ext2FS[{}]::flush_block_group_descriptor_table(): Failed to write blocks: {}", fsid(), result.error());
 }
 
-void Ext2FS::flush_writes()
+void Ext2FS::flush_metadata()
 {
     {
         MutexLocker locker(m_lock);
@@ -668,7 +742,8 @@ void Ext2FS::flush_writes()
             flush_block_group_descriptor_table();
             m_block_group_descriptors_dirty = false;
         }
-        for (auto& cached_bitmap : m_cached_bitmaps) {
+        for (auto& it : m_cached_bitmaps) {
+            auto& cached_bitmap = it.value;
             if (cached_bitmap->dirty) {
                 auto buffer = UserOrKernelBuffer::for_kernel_buffer(cached_bitmap->buffer->data());
                 if (auto result = write_block(cached_bitmap->bitmap_block_index, buffer, block_size()); result.is_error()) {
@@ -696,10 +771,20 @@ void Ext2FS::flush_writes()
             return cached_inode->ref_count() == 1 && !cached_inode->has_watchers();
         });
     }
+}
 
+void Ext2FS::flush_writes()
+{
+    flush_metadata();
     BlockBasedFileSystem::flush_writes();
 }
 
+void Ext2FS::flush_expired_writes()
+{
+    flush_metadata();
+    BlockBasedFileSystem::flush_expired_writes();
+}
+
 Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
     : Inode(fs, index)
 {
@@ -710,9 +795,27 @@ Ext2FSInode::~Ext2FSInode()
     if (m_raw_inode.i_links_count == 0) {
         // Alas, we have nowhere to propagate any errors that occur here.
         (void)fs().free_inode(*this);
+    } else {
+        fs().discard_block_reservation(index());
     }
 }
 
+void Ext2FSInode::detach(OpenFileDescription&)
+{
+    // NOTE: Once the file is closed, nobody is likely to keep appending to it, so let others have the blocks after it.
+    fs().discard_block_reservation(index());
+}
+
+// New blocks are best placed right after the last one the inode already has.
+Ext2FS::BlockIndex Ext2FSInode::next_block_goal() const
+{
+    for (size_t i = m_block_list.size(); i > 0; --i) {
+        if (m_block_list[i - 1].value())
+            return m_block_list[i - 1].value() + 1;
+    }
+    return 0;
+}
+
 u64 Ext2FSInode::size() const
 {
     if (Kernel::is_regular_file(m_raw_inode.i_mode) && ((u32)fs().get_features_readonly() & (u32)Ext2FS::FeaturesReadOnly::FileSize64bits))
@@ -798,6 +901,53 @@ ErrorOr<NonnullLockRefPtr<Inode>> Ext2FS::get_inode(InodeIdentifier inode) const
     return new_inode;
 }
 
+void Ext2FSInode::do_readahead(OpenFileDescription& description, off_t offset, size_t count, u64 first_block, u64 last_block) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    static constexpr size_t initial_window_in_blocks = 4;
+
+    auto state = description.readahead_state();
+    bool is_sequential = static_cast<u64>(offset) == state.next_sequential_offset;
+    state.next_sequential_offset = offset + count;
+    if (!is_sequential) {
+        // Random access; forget about any readahead we did and start over small.
+        state.window_in_blocks = 0;
+        state.readahead_end_block = 0;
+        description.set_readahead_state(state);
+        return;
+    }
+
+    // Only read ahead again once the reader has caught up with the previous readahead,
+    // growing the window every time the access pattern stays sequential.
+    if (last_block < state.readahead_end_block) {
+        description.set_readahead_state(state);
+        return;
+    }
+    state.window_in_blocks = state.window_in_blocks ? min(state.window_in_blocks * 2, BlockBasedFileSystem::MaxReadaheadBlocks) : initial_window_in_blocks;
+
+    auto start = max(first_block, state.readahead_end_block);
+    auto end = min<u64>(last_block + 1 + state.window_in_blocks, m_block_list.size());
+    state.readahead_end_block = end;
+    description.set_readahead_state(state);
+
+    // Prefetch the range in runs of physically contiguous blocks, skipping holes.
+    for (auto block = start; block < end;) {
+        auto run_start = m_block_list[block].value();
+        if (run_start == 0) {
+            ++block;
+            continue;
+        }
+        size_t run_length = 1;
+        while (block + run_length < end && m_block_list[block + run_length].value() == run_start + run_length)
+            ++run_length;
+        if (auto result = fs().prefetch_blocks(m_block_list[block], run_length); result.is_error()) {
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::do_readahead(): Failed to prefetch {} blocks at {}: {}", identifier(), run_length, run_start, result.error());
+            return;
+        }
+        block += run_length;
+    }
+}
+
 ErrorOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
 {
     MutexLocker inode_locker(m_inode_lock);
@@ -841,6 +991,9 @@ ErrorOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKernel
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
+    if (description && allow_cache)
+        do_readahead(*description, offset, remaining_count, first_block_logical_index.value(), last_block_logical_index.value());
+
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         auto block_index = m_block_list[bi.value()];
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
@@ -890,7 +1043,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         m_block_list = TRY(compute_block_list());
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
+        auto blocks = TRY(fs().allocate_blocks_for_inode(*this, blocks_needed_after - blocks_needed_before, next_block_goal()));
         TRY(m_block_list.try_extend(move(blocks)));
     } else if (blocks_needed_after < blocks_needed_before) {
         if constexpr (EXT2_VERY_DEBUG) {
@@ -899,15 +1052,12 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
                 dbgln("    # {}", block_index);
             }
         }
-        while (m_block_list.size() != blocks_needed_after) {
-            auto block_index = m_block_list.take_last();
-            if (block_index.value()) {
-                if (auto result = fs().set_block_allocation_state(block_index, false); result.is_error()) {
-                    dbgln("Ext2FSInode[{}]::resize(): Failed to free block {}: {}", identifier(), block_index, result.error());
-                    return result;
-                }
-            }
+        fs().discard_block_reservation(index());
+        if (auto result = fs().free_blocks(m_block_list.span().slice(blocks_needed_after)); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::resize(): Failed to free blocks: {}", identifier(), result.error());
+            return result;
         }
+        m_block_list.shrink(blocks_needed_after);
     }
 
     TRY(flush_block_list());
@@ -1029,6 +1179,19 @@ Ext2FS::FeaturesReadOnly Ext2FS::get_features_readonly() const
     return Ext2FS::FeaturesReadOnly::None;
 }
 
+bool Ext2FS::supports_directory_index() const
+{
+    return m_super_block.s_rev_level > 0 && (m_super_block.s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX);
+}
+
+u8 Ext2FS::directory_hash_version(u8 stored_hash_version) const
+{
+    // NOTE: File systems created where char is unsigned hash names as unsigned bytes, everything else as signed ones.
+    if (stored_hash_version <= EXT2_HASH_TEA && (m_super_block.s_flags & EXT2_FLAGS_UNSIGNED_HASH))
+        return stored_hash_version + EXT2_HASH_LEGACY_UNSIGNED;
+    return stored_hash_version;
+}
+
 ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)> callback) const
 {
     VERIFY(is_directory());
@@ -1107,6 +1270,8 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
     VERIFY(stream.is_end());
 
     TRY(resize(stream.size()));
+    // NOTE: A linear layout leaves no room for the index, so this directory no longer has one.
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
 
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(stream.data());
     auto nwritten = TRY(write_bytes(0, stream.size(), buffer, nullptr));
@@ -1116,6 +1281,545 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
     return {};
 }
 
+// The root block of a directory index starts with the "." and ".." entries. The record of ".." covers the
+// rest of the block, which holds the root info followed by the index entries.
+static constexpr size_t directory_index_root_info_offset = 24;
+static constexpr size_t directory_index_root_entries_offset = directory_index_root_info_offset + sizeof(ext2_dx_root_info);
+// Interior nodes start with an unused entry covering the whole block, followed by the index entries.
+static constexpr size_t directory_index_node_entries_offset = 8;
+
+static size_t directory_index_root_limit(size_t block_size)
+{
+    return (block_size - directory_index_root_entries_offset) / sizeof(ext2_dx_entry);
+}
+
+static size_t directory_index_node_limit(size_t block_size)
+{
+    return (block_size - directory_index_node_entries_offset) / sizeof(ext2_dx_entry);
+}
+
+template<typename Callback>
+static ErrorOr<void> for_each_entry_in_directory_block(ReadonlyBytes block, Callback callback)
+{
+    size_t offset = 0;
+    while (offset < block.size()) {
+        auto const& entry = *reinterpret_cast<ext2_dir_entry_2 const*>(block.data() + offset);
+        if (entry.rec_len < 8 || entry.rec_len % 4 != 0 || offset + entry.rec_len > block.size() || entry.name_len + 8u > entry.rec_len)
+            return EIO;
+        if (TRY(callback(offset, entry)) == IterationDecision::Break)
+            break;
+        offset += entry.rec_len;
+    }
+    return {};
+}
+
+static ErrorOr<Optional<size_t>> find_entry_in_directory_block(ReadonlyBytes block, StringView name)
+{
+    Optional<size_t> found_offset;
+    TRY(for_each_entry_in_directory_block(block, [&](size_t offset, auto const& entry) -> ErrorOr<IterationDecision> {
+        if (entry.inode == 0 || StringView { entry.name, entry.name_len } != name)
+            return IterationDecision::Continue;
+        found_offset = offset;
+        return IterationDecision::Break;
+    }));
+    return found_offset;
+}
+
+// Puts a new entry into the first gap in the block that is large enough for it, if there is one.
+static ErrorOr<bool> insert_entry_into_directory_block(Bytes block, InodeIndex inode_index, StringView name, u8 file_type)
+{
+    size_t needed_length = EXT2_DIR_REC_LEN(name.length());
+    Optional<size_t> gap_offset;
+    TRY(for_each_entry_in_directory_block(block, [&](size_t offset, auto const& entry) -> ErrorOr<IterationDecision> {
+        size_t used_length = entry.inode != 0 ? EXT2_DIR_REC_LEN(entry.name_len) : 0;
+        if (entry.rec_len - used_length < needed_length)
+            return IterationDecision::Continue;
+        gap_offset = offset;
+        return IterationDecision::Break;
+    }));
+    if (!gap_offset.has_value())
+        return false;
+
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + gap_offset.value());
+    if (entry->inode != 0) {
+        u16 used_length = EXT2_DIR_REC_LEN(entry->name_len);
+        auto* new_entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + gap_offset.value() + used_length);
+        new_entry->rec_len = entry->rec_len - used_length;
+        entry->rec_len = used_length;
+        entry = new_entry;
+    }
+    entry->inode = inode_index.value();
+    entry->name_len = name.length();
+    entry->file_type = file_type;
+    memcpy(entry->name, name.characters_without_null_termination(), name.length());
+    return true;
+}
+
+static ErrorOr<void> remove_entry_from_directory_block(Bytes block, size_t entry_offset)
+{
+    Optional<size_t> previous_offset;
+    TRY(for_each_entry_in_directory_block(block, [&](size_t offset, auto const&) -> ErrorOr<IterationDecision> {
+        if (offset == entry_offset)
+            return IterationDecision::Break;
+        previous_offset = offset;
+        return IterationDecision::Continue;
+    }));
+
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + entry_offset);
+    if (previous_offset.has_value()) {
+        auto* previous_entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + previous_offset.value());
+        previous_entry->rec_len += entry->rec_len;
+    } else {
+        entry->inode = 0;
+    }
+    return {};
+}
+
+// Lays out the entries (which have to fit) from the start of the block, with the last one covering the rest of it.
+static void write_entries_to_directory_block(Bytes block, Span<Ext2FSDirectoryEntry const> entries)
+{
+    block.fill(0);
+    if (entries.is_empty()) {
+        reinterpret_cast<ext2_dir_entry_2*>(block.data())->rec_len = block.size();
+        return;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto& entry = entries[i];
+        auto* raw_entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + offset);
+        size_t record_length = i + 1 < entries.size() ? EXT2_DIR_REC_LEN(entry.name->length()) : block.size() - offset;
+        raw_entry->inode = entry.inode_index.value();
+        raw_entry->rec_len = record_length;
+        raw_entry->name_len = entry.name->length();
+        raw_entry->file_type = entry.file_type;
+        memcpy(raw_entry->name, entry.name->characters(), entry.name->length());
+        offset += record_length;
+    }
+}
+
+template<typename EntryForIndex>
+static void write_index_entries(Bytes block, size_t entries_offset, size_t limit, size_t count, EntryForIndex entry_for_index)
+{
+    auto* entries = reinterpret_cast<ext2_dx_entry*>(block.data() + entries_offset);
+    for (size_t i = 0; i < count; ++i)
+        entries[i] = entry_for_index(i);
+    // NOTE: This overlaps the hash of the first entry, which is implied to be 0.
+    auto& countlimit = *reinterpret_cast<ext2_dx_countlimit*>(entries);
+    countlimit.limit = limit;
+    countlimit.count = count;
+}
+
+void Ext2FSInode::DirectoryIndexFrame::insert_after_position(u32 hash, u32 child)
+{
+    auto& countlimit = this->countlimit();
+    VERIFY(countlimit.count < countlimit.limit);
+    auto* entries = this->entries();
+    auto new_position = position + 1;
+    memmove(&entries[new_position + 1], &entries[new_position], (countlimit.count - new_position) * sizeof(ext2_dx_entry));
+    entries[new_position] = { hash, child };
+    ++countlimit.count;
+}
+
+bool Ext2FSInode::has_directory_index() const
+{
+    return (m_raw_inode.i_flags & EXT2_INDEX_FL) && fs().supports_directory_index();
+}
+
+void Ext2FSInode::drop_directory_index()
+{
+    MutexLocker locker(m_inode_lock);
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+}
+
+ErrorOr<ByteBuffer> Ext2FSInode::read_directory_block(u32 block_index) const
+{
+    auto block_size = fs().block_size();
+    auto block = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(block.data());
+    auto nread = TRY(read_bytes(static_cast<off_t>(block_index) * block_size, block_size, buffer, nullptr));
+    if (nread != block_size)
+        return EIO;
+    return block;
+}
+
+ErrorOr<void> Ext2FSInode::write_directory_block(u32 block_index, ReadonlyBytes block)
+{
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(block.data()));
+    auto nwritten = TRY(write_bytes(static_cast<off_t>(block_index) * fs().block_size(), block.size(), buffer, nullptr));
+    if (nwritten != block.size())
+        return EIO;
+    return {};
+}
+
+ErrorOr<u32> Ext2FSInode::append_directory_block(ReadonlyBytes block)
+{
+    auto block_index = static_cast<u32>(size() / fs().block_size());
+    TRY(resize(size() + fs().block_size()));
+    TRY(write_directory_block(block_index, block));
+    return block_index;
+}
+
+// Walks the index down to the leaf that `name` hashes to, and searches it along with any following leaves
+// that the same hash continues into. Returns nothing if the index is unusable, in which case the directory
+// has to be treated as a linear one.
+ErrorOr<Optional<Ext2FSInode::DirectoryIndexSearch>> Ext2FSInode::search_directory_index(StringView name) const
+{
+    MutexLocker locker(m_inode_lock);
+    auto block_size = fs().block_size();
+    auto block_count = size() / block_size;
+
+    DirectoryIndexSearch search;
+    auto root = TRY(read_directory_block(0));
+
+    // NOTE: "." and ".." are never indexed, they are only ever found at the start of the root block.
+    if (name == "."sv || name == ".."sv) {
+        search.entry_offset = TRY(find_entry_in_directory_block(root, name));
+        search.leaf = move(root);
+        return Optional<DirectoryIndexSearch> { move(search) };
+    }
+
+    auto const& info = *reinterpret_cast<ext2_dx_root_info const*>(root.data() + directory_index_root_info_offset);
+    if (info.reserved_zero != 0 || info.hash_version > EXT2_HASH_TEA || info.info_length != sizeof(ext2_dx_root_info) || info.indirect_levels > 1) {
+        dbgln("Ext2FSInode[{}]::search_directory_index(): Unsupported or corrupt index root", identifier());
+        return Optional<DirectoryIndexSearch> {};
+    }
+    search.hash_version = fs().directory_hash_version(info.hash_version);
+    search.hash = ext2_directory_hash(name, search.hash_version, fs().super_block().s_hash_seed);
+    size_t levels_below = info.indirect_levels;
+
+    DirectoryIndexFrame frame { move(root), 0, directory_index_root_entries_offset, 0 };
+    auto limit = directory_index_root_limit(block_size);
+    for (;;) {
+        auto& countlimit = frame.countlimit();
+        if (countlimit.limit != limit || countlimit.count == 0 || countlimit.count > countlimit.limit) {
+            dbgln("Ext2FSInode[{}]::search_directory_index(): Corrupt index block {}", identifier(), frame.block_index);
+            return Optional<DirectoryIndexSearch> {};
+        }
+
+        // Find the last entry whose hash isn't above ours.
+        size_t first = 1;
+        size_t last = countlimit.count;
+        while (first < last) {
+            auto middle = first + (last - first) / 2;
+            if (frame.hash_at(middle) > search.hash)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+        frame.position = first - 1;
+
+        auto child = frame.child_at(frame.position);
+        if (child == 0 || child >= block_count) {
+            dbgln("Ext2FSInode[{}]::search_directory_index(): Index block {} points outside of the directory", identifier(), frame.block_index);
+            return Optional<DirectoryIndexSearch> {};
+        }
+        TRY(search.path.try_append(move(frame)));
+
+        if (levels_below-- == 0) {
+            search.leaf_index = child;
+            break;
+        }
+
+        auto node = TRY(read_directory_block(child));
+        auto const& unused_entry = *reinterpret_cast<ext2_dir_entry_2 const*>(node.data());
+        if (unused_entry.inode != 0 || unused_entry.rec_len != block_size) {
+            dbgln("Ext2FSInode[{}]::search_directory_index(): Corrupt index node {}", identifier(), child);
+            return Optional<DirectoryIndexSearch> {};
+        }
+        frame = DirectoryIndexFrame { move(node), child, directory_index_node_entries_offset, 0 };
+        limit = directory_index_node_limit(block_size);
+    }
+
+    for (;;) {
+        search.leaf = TRY(read_directory_block(search.leaf_index));
+        search.entry_offset = TRY(find_entry_in_directory_block(search.leaf, name));
+        if (search.entry_offset.has_value() || !TRY(advance_directory_index_path(search.path, search.hash)))
+            break;
+        auto& bottom = search.path.last();
+        search.leaf_index = bottom.child_at(bottom.position);
+        if (search.leaf_index == 0 || search.leaf_index >= block_count)
+            return EIO;
+    }
+    return Optional<DirectoryIndexSearch> { move(search) };
+}
+
+// Moves the path over to the next leaf if entries with the given hash may continue into it.
+ErrorOr<bool> Ext2FSInode::advance_directory_index_path(DirectoryIndexPath& path, u32 hash) const
+{
+    size_t level = path.size() - 1;
+    while (path[level].position + 1 >= path[level].countlimit().count) {
+        if (level == 0)
+            return false;
+        --level;
+    }
+
+    // NOTE: The next leaf can only hold entries with our hash if its range starts at it.
+    //       Its lowest bit is set if the entries were split up due to a hash collision.
+    if ((path[level].hash_at(path[level].position + 1) & ~1u) != hash)
+        return false;
+
+    ++path[level].position;
+    for (++level; level < path.size(); ++level) {
+        auto& parent = path[level - 1];
+        auto& frame = path[level];
+        frame.block_index = parent.child_at(parent.position);
+        frame.block = TRY(read_directory_block(frame.block_index));
+        frame.position = 0;
+    }
+    return true;
+}
+
+// Makes room for another entry at the bottom level of the index, either by moving the entries of the root
+// into a new interior node, or by splitting the interior node in two.
+ErrorOr<void> Ext2FSInode::make_room_in_directory_index(DirectoryIndexPath& path)
+{
+    auto block_size = fs().block_size();
+    auto node_limit = directory_index_node_limit(block_size);
+
+    auto create_node = [&](ext2_dx_entry const* entries, size_t count) -> ErrorOr<ByteBuffer> {
+        auto node = TRY(ByteBuffer::create_zeroed(block_size));
+        reinterpret_cast<ext2_dir_entry_2*>(node.data())->rec_len = block_size;
+        write_index_entries(node, directory_index_node_entries_offset, node_limit, count, [&](size_t i) { return entries[i]; });
+        return node;
+    };
+
+    auto& root = path[0];
+    if (path.size() == 1) {
+        auto node = TRY(create_node(root.entries(), root.countlimit().count));
+        auto node_index = TRY(append_directory_block(node));
+
+        root.countlimit().count = 1;
+        root.entries()[0].block = node_index;
+        reinterpret_cast<ext2_dx_root_info*>(root.block.data() + directory_index_root_info_offset)->indirect_levels = 1;
+        TRY(write_directory_block(0, root.block));
+
+        auto position_in_node = root.position;
+        root.position = 0;
+        TRY(path.try_append({ move(node), node_index, directory_index_node_entries_offset, position_in_node }));
+        return {};
+    }
+
+    if (root.countlimit().count >= root.countlimit().limit) {
+        dbgln("Ext2FSInode[{}]::make_room_in_directory_index(): Directory index is full", identifier());
+        return ENOSPC;
+    }
+
+    auto& node = path[1];
+    size_t count = node.countlimit().count;
+    size_t split = count / 2;
+    auto split_hash = node.hash_at(split);
+
+    auto sibling = TRY(create_node(node.entries() + split, count - split));
+    auto sibling_index = TRY(append_directory_block(sibling));
+    node.countlimit().count = split;
+    TRY(write_directory_block(node.block_index, node.block));
+    root.insert_after_position(split_hash, sibling_index);
+    TRY(write_directory_block(0, root.block));
+
+    if (node.position >= split) {
+        node.block = move(sibling);
+        node.block_index = sibling_index;
+        node.position -= split;
+        ++root.position;
+    }
+    return {};
+}
+
+// Returns false if the index is unusable, in which case the directory has to be treated as a linear one.
+ErrorOr<bool> Ext2FSInode::add_child_to_directory_index(InodeIndex child_index, StringView name, u8 file_type)
+{
+    auto maybe_search = TRY(search_directory_index(name));
+    if (!maybe_search.has_value())
+        return false;
+    auto& search = maybe_search.value();
+    if (search.entry_offset.has_value())
+        return EEXIST;
+    if (search.path.is_empty())
+        return false;
+
+    if (TRY(insert_entry_into_directory_block(search.leaf, child_index, name, file_type))) {
+        TRY(write_directory_block(search.leaf_index, search.leaf));
+        return true;
+    }
+
+    // The leaf is full, so split its entries in two by hash, and point a new index entry at the upper half.
+    if (search.path.last().countlimit().count >= search.path.last().countlimit().limit)
+        TRY(make_room_in_directory_index(search.path));
+
+    Vector<Ext2FSDirectoryEntry> entries;
+    TRY(for_each_entry_in_directory_block(search.leaf, [&](size_t, auto const& entry) -> ErrorOr<IterationDecision> {
+        if (entry.inode == 0)
+            return IterationDecision::Continue;
+        StringView entry_name { entry.name, entry.name_len };
+        auto hash = ext2_directory_hash(entry_name, search.hash_version, fs().super_block().s_hash_seed);
+        TRY(entries.try_append({ TRY(KString::try_create(entry_name)), entry.inode, entry.file_type, 0, hash }));
+        return IterationDecision::Continue;
+    }));
+    if (entries.size() < 2)
+        return ENOSPC;
+    quick_sort(entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    size_t split = entries.size() / 2;
+    auto split_hash = entries[split].hash;
+    // NOTE: If entries with the same hash end up on both sides, mark the new range as a continuation,
+    //       so that lookups know to search on into it.
+    if (split_hash == entries[split - 1].hash)
+        split_hash |= 1;
+
+    auto upper_leaf = TRY(ByteBuffer::create_uninitialized(fs().block_size()));
+    write_entries_to_directory_block(upper_leaf, entries.span().slice(split));
+    write_entries_to_directory_block(search.leaf, entries.span().trim(split));
+    auto upper_leaf_index = TRY(append_directory_block(upper_leaf));
+    TRY(write_directory_block(search.leaf_index, search.leaf));
+
+    auto& bottom = search.path.last();
+    bottom.insert_after_position(split_hash, upper_leaf_index);
+    TRY(write_directory_block(bottom.block_index, bottom.block));
+
+    bool goes_into_upper_leaf = search.hash >= (split_hash & ~1u);
+    auto& leaf = goes_into_upper_leaf ? upper_leaf : search.leaf;
+    if (!TRY(insert_entry_into_directory_block(leaf, child_index, name, file_type)))
+        return ENOSPC;
+    TRY(write_directory_block(goes_into_upper_leaf ? upper_leaf_index : search.leaf_index, leaf));
+    return true;
+}
+
+// Returns nothing if the index is unusable, in which case the directory has to be treated as a linear one.
+ErrorOr<Optional<InodeIndex>> Ext2FSInode::remove_child_from_directory_index(StringView name)
+{
+    auto maybe_search = TRY(search_directory_index(name));
+    if (!maybe_search.has_value())
+        return Optional<InodeIndex> {};
+    auto& search = maybe_search.value();
+    if (!search.entry_offset.has_value())
+        return ENOENT;
+
+    InodeIndex child_index = reinterpret_cast<ext2_dir_entry_2 const*>(search.leaf.data() + search.entry_offset.value())->inode;
+    TRY(remove_entry_from_directory_block(search.leaf, search.entry_offset.value()));
+    TRY(write_directory_block(search.leaf_index, search.leaf));
+
+    // NOTE: The root info lives in the record of "..", so the index is gone once "." or ".." are (which only rmdir does).
+    if (search.leaf_index == 0)
+        drop_directory_index();
+    return child_index;
+}
+
+// Lays the directory out as a hash index over leaf blocks that are filled up to 3/4, so that entries can
+// be added for a while before leaves have to be split. Returns false if there are too many entries to index.
+ErrorOr<bool> Ext2FSInode::write_indexed_directory(Vector<Ext2FSDirectoryEntry>& entries)
+{
+    MutexLocker locker(m_inode_lock);
+    auto block_size = fs().block_size();
+    auto root_limit = directory_index_root_limit(block_size);
+    auto node_limit = directory_index_node_limit(block_size);
+
+    u8 hash_version = fs().super_block().s_def_hash_version;
+    if (hash_version > EXT2_HASH_TEA)
+        hash_version = EXT2_HASH_HALF_MD4;
+    auto adjusted_hash_version = fs().directory_hash_version(hash_version);
+
+    Optional<InodeIndex> self_index;
+    Optional<InodeIndex> parent_index;
+    for (auto& entry : entries) {
+        if (entry.name->view() == "."sv)
+            self_index = entry.inode_index;
+        else if (entry.name->view() == ".."sv)
+            parent_index = entry.inode_index;
+        else
+            entry.hash = ext2_directory_hash(entry.name->view(), adjusted_hash_version, fs().super_block().s_hash_seed);
+    }
+    if (!self_index.has_value() || !parent_index.has_value())
+        return false;
+    entries.remove_all_matching([](auto& entry) { return entry.name->view() == "."sv || entry.name->view() == ".."sv; });
+    quick_sort(entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    struct Leaf {
+        size_t first_entry { 0 };
+        size_t entry_count { 0 };
+        u32 hash { 0 };
+    };
+    Vector<Leaf> leaves;
+    size_t fill_limit = block_size * 3 / 4;
+    size_t used_in_leaf = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t record_length = EXT2_DIR_REC_LEN(entries[i].name->length());
+        if (leaves.is_empty() || used_in_leaf + record_length > fill_limit) {
+            u32 hash = 0;
+            if (!leaves.is_empty())
+                hash = entries[i].hash | (entries[i].hash == entries[i - 1].hash ? 1 : 0);
+            TRY(leaves.try_append({ i, 0, hash }));
+            used_in_leaf = 0;
+        }
+        ++leaves.last().entry_count;
+        used_in_leaf += record_length;
+    }
+    if (leaves.is_empty())
+        TRY(leaves.try_append({}));
+
+    size_t node_count = 0;
+    if (leaves.size() > root_limit) {
+        node_count = ceil_div(leaves.size(), node_limit);
+        if (node_count > root_limit)
+            return false;
+    }
+    size_t first_leaf_block = 1 + node_count;
+
+    auto directory_data = TRY(ByteBuffer::create_zeroed((first_leaf_block + leaves.size()) * block_size));
+    auto block_at = [&](size_t block_index) { return directory_data.bytes().slice(block_index * block_size, block_size); };
+    auto entry_for_leaf = [&](size_t leaf) -> ext2_dx_entry { return { leaves[leaf].hash, static_cast<u32>(first_leaf_block + leaf) }; };
+
+    auto root = block_at(0);
+    auto* dot = reinterpret_cast<ext2_dir_entry_2*>(root.data());
+    dot->inode = self_index->value();
+    dot->rec_len = EXT2_DIR_REC_LEN(1);
+    dot->name_len = 1;
+    dot->file_type = EXT2_FT_DIR;
+    dot->name[0] = '.';
+    auto* dot_dot = reinterpret_cast<ext2_dir_entry_2*>(root.data() + dot->rec_len);
+    dot_dot->inode = parent_index->value();
+    dot_dot->rec_len = block_size - dot->rec_len;
+    dot_dot->name_len = 2;
+    dot_dot->file_type = EXT2_FT_DIR;
+    dot_dot->name[0] = '.';
+    dot_dot->name[1] = '.';
+    auto& info = *reinterpret_cast<ext2_dx_root_info*>(root.data() + directory_index_root_info_offset);
+    info.hash_version = hash_version;
+    info.info_length = sizeof(ext2_dx_root_info);
+    info.indirect_levels = node_count ? 1 : 0;
+
+    if (node_count == 0) {
+        write_index_entries(root, directory_index_root_entries_offset, root_limit, leaves.size(), entry_for_leaf);
+    } else {
+        write_index_entries(root, directory_index_root_entries_offset, root_limit, node_count, [&](size_t node) -> ext2_dx_entry {
+            return { leaves[node * node_limit].hash, static_cast<u32>(1 + node) };
+        });
+        for (size_t node = 0; node < node_count; ++node) {
+            auto node_block = block_at(1 + node);
+            reinterpret_cast<ext2_dir_entry_2*>(node_block.data())->rec_len = block_size;
+            auto first_leaf = node * node_limit;
+            write_index_entries(node_block, directory_index_node_entries_offset, node_limit, min(node_limit, leaves.size() - first_leaf), [&](size_t i) {
+                return entry_for_leaf(first_leaf + i);
+            });
+        }
+    }
+
+    for (size_t leaf = 0; leaf < leaves.size(); ++leaf)
+        write_entries_to_directory_block(block_at(first_leaf_block + leaf), entries.span().slice(leaves[leaf].first_entry, leaves[leaf].entry_count));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_indexed_directory(): Writing {} entries into {} leaves", identifier(), entries.size(), leaves.size());
+
+    TRY(resize(directory_data.size()));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(write_bytes(0, directory_data.size(), buffer, nullptr));
+    if (nwritten != directory_data.size())
+        return EIO;
+    m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+    return true;
+}
+
 ErrorOr<NonnullLockRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (::is_directory(mode))
@@ -1133,6 +1837,15 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
+    if (has_directory_index()) {
+        if (TRY(add_child_to_directory_index(child.index(), name, to_ext2_file_type(mode)))) {
+            TRY(child.increment_link_count());
+            did_add_child(child.identifier(), name);
+            return {};
+        }
+        drop_directory_index();
+    }
+
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         if (name == entry.name)
@@ -1147,6 +1860,18 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
     auto entry_name = TRY(KString::try_create(name));
     TRY(entries.try_empend(move(entry_name), child.index(), to_ext2_file_type(mode)));
 
+    // Directories that outgrow a single block are turned into indexed ones, if the file system supports that.
+    if (fs().supports_directory_index()) {
+        size_t directory_size = 0;
+        for (auto& entry : entries)
+            directory_size += EXT2_DIR_REC_LEN(entry.name->length());
+        if (directory_size > fs().block_size() && TRY(write_indexed_directory(entries))) {
+            m_lookup_cache.clear();
+            did_add_child(child.identifier(), name);
+            return {};
+        }
+    }
+
     TRY(write_directory(entries));
     TRY(populate_lookup_cache());
 
@@ -1162,6 +1887,17 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::remove_child(): Removing '{}'", identifier(), name);
     VERIFY(is_directory());
 
+    if (has_directory_index()) {
+        if (auto child_inode_index = TRY(remove_child_from_directory_index(name)); child_inode_index.has_value()) {
+            InodeIdentifier child_id { fsid(), child_inode_index.value() };
+            auto child_inode = TRY(fs().get_inode(child_id));
+            TRY(child_inode->decrement_link_count());
+            did_remove_child(child_id, name);
+            return {};
+        }
+        drop_directory_index();
+    }
+
     TRY(populate_lookup_cache());
 
     auto it = m_lookup_cache.find(name);
@@ -1220,62 +1956,254 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+Ext2FS::BlockIndex Ext2FS::first_block_of_group(GroupIndex group_index) const
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
-    if (count == 0)
-        return Vector<BlockIndex> {};
+    return (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+}
 
-    Vector<BlockIndex> blocks;
-    TRY(blocks.try_ensure_capacity(count));
+size_t Ext2FS::blocks_in_group(GroupIndex group_index) const
+{
+    return min(blocks_per_group(), super_block().s_blocks_count - first_block_of_group(group_index).value());
+}
+
+// Finds the first run of free blocks in the group at or after `first_bit`, of at most `max_length` blocks.
+// Blocks reserved by inodes other than `owner` are skipped over, unless `respect_reservations` is false.
+auto Ext2FS::find_free_blocks(GroupIndex group_index, size_t first_bit, size_t max_length, bool respect_reservations, InodeIndex owner) -> ErrorOr<Optional<BlockRange>>
+{
+    VERIFY(m_lock.is_locked());
+    auto const& bgd = group_descriptor(group_index);
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group(group_index));
+    auto first_block_in_group = first_block_of_group(group_index);
+
+    auto& summary = block_group_summary(group_index);
+    size_t search_from = max(first_bit, summary.first_free_block_bit);
+    while (search_from < block_bitmap.size()) {
+        size_t found_bit = search_from;
+        auto length = block_bitmap.find_next_range_of_unset_bits(found_bit, 1, max_length);
+        // NOTE: The search doesn't honor its starting point in the last few bits of the bitmap.
+        if (!length.has_value() || found_bit < search_from)
+            return Optional<BlockRange> {};
+        if (search_from == summary.first_free_block_bit)
+            summary.first_free_block_bit = found_bit;
+
+        BlockRange range { first_block_in_group.value() + found_bit, length.value() };
+        bool is_reserved = false;
+        if (respect_reservations) {
+            for (auto& it : m_block_reservations) {
+                auto& reservation = it.value;
+                if (it.key == owner || reservation.block_count == 0)
+                    continue;
+                auto reservation_end = reservation.first_block.value() + reservation.block_count;
+                if (reservation.first_block <= range.first_block && range.first_block.value() < reservation_end) {
+                    search_from = reservation_end - first_block_in_group.value();
+                    is_reserved = true;
+                    break;
+                }
+                if (range.first_block < reservation.first_block && reservation.first_block.value() < range.first_block.value() + range.block_count)
+                    range.block_count = reservation.first_block.value() - range.first_block.value();
+            }
+        }
+        if (!is_reserved)
+            return range;
+    }
+    return Optional<BlockRange> {};
+}
 
+ErrorOr<void> Ext2FS::mark_blocks_as_allocated(BlockRange range)
+{
+    VERIFY(m_lock.is_locked());
+    auto group_index = group_index_from_block_index(range.first_block);
+    auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group(group_index));
+    auto first_bit = range.first_block.value() - first_block_of_group(group_index).value();
+    VERIFY(first_bit + range.block_count <= block_bitmap.size());
+
+    dbgln_if(EXT2_DEBUG, "Ext2FS: Allocating {} block(s) starting at {} (in bitmap block {})", range.block_count, range.first_block, bgd.bg_block_bitmap);
+    block_bitmap.set_range(first_bit, range.block_count, true);
+    cached_bitmap->dirty = true;
+    note_blocks_allocated(group_index, first_bit, range.block_count);
+
+    m_super_block.s_free_blocks_count -= range.block_count;
+    bgd.bg_free_blocks_count -= range.block_count;
+    m_super_block_dirty = true;
+    m_block_group_descriptors_dirty = true;
+    return {};
+}
+
+// Frees the given blocks, a run of consecutive ones at a time. Zero entries are skipped.
+ErrorOr<void> Ext2FS::free_blocks(Span<BlockIndex const> blocks)
+{
     MutexLocker locker(m_lock);
-    auto group_index = preferred_group_index;
 
-    if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
-        group_index = 1;
+    auto free_range = [&](BlockRange range) -> ErrorOr<void> {
+        auto group_index = group_index_from_block_index(range.first_block);
+        auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group(group_index));
+        auto first_bit = range.first_block.value() - first_block_of_group(group_index).value();
+        VERIFY(first_bit + range.block_count <= block_bitmap.size());
+        for (size_t i = 0; i < range.block_count; ++i) {
+            if (!block_bitmap.get(first_bit + i)) {
+                dbgln("Ext2FS: Block {} was freed but isn't in use", range.first_block.value() + i);
+                return EIO;
+            }
+        }
+
+        dbgln_if(EXT2_DEBUG, "Ext2FS: Freeing {} block(s) starting at {} (in bitmap block {})", range.block_count, range.first_block, bgd.bg_block_bitmap);
+        block_bitmap.set_range(first_bit, range.block_count, false);
+        cached_bitmap->dirty = true;
+        note_blocks_freed(group_index, first_bit);
+
+        m_super_block.s_free_blocks_count += range.block_count;
+        bgd.bg_free_blocks_count += range.block_count;
+        m_super_block_dirty = true;
+        m_block_group_descriptors_dirty = true;
+        return {};
+    };
+
+    Optional<BlockRange> run;
+    for (auto block_index : blocks) {
+        if (!block_index.value())
+            continue;
+        VERIFY(block_index <= super_block().s_blocks_count);
+        if (run.has_value()) {
+            auto next_block = run->first_block.value() + run->block_count;
+            if (block_index.value() == next_block && group_index_from_block_index(block_index) == group_index_from_block_index(run->first_block)) {
+                ++run->block_count;
+                continue;
+            }
+            TRY(free_range(run.release_value()));
+        }
+        run = BlockRange { block_index, 1 };
     }
+    if (run.has_value())
+        TRY(free_range(run.release_value()));
+    return {};
+}
 
-    while (blocks.size() < count) {
-        bool found_a_group = false;
-        if (group_descriptor(group_index).bg_free_blocks_count) {
-            found_a_group = true;
-        } else {
-            if (group_index == preferred_group_index)
-                group_index = 1;
-            for (; group_index <= m_block_group_count; group_index = GroupIndex { group_index.value() + 1 }) {
-                if (group_descriptor(group_index).bg_free_blocks_count) {
-                    found_a_group = true;
-                    break;
+// Allocates blocks as contiguously as possible, in first-fit order starting at `goal` (or at the start of the
+// preferred group if there is none). Blocks reserved by inodes other than `owner` are only handed out if
+// there is nothing else left.
+auto Ext2FS::allocate_blocks_impl(GroupIndex preferred_group_index, size_t count, BlockIndex goal, InodeIndex owner) -> ErrorOr<Vector<BlockIndex>>
+{
+    VERIFY(m_lock.is_locked());
+    if (count > super_block().s_free_blocks_count)
+        return ENOSPC;
+
+    Vector<BlockIndex> blocks;
+    TRY(blocks.try_ensure_capacity(count));
+
+    auto first_group_index = goal.value() ? group_index_from_block_index(goal) : preferred_group_index;
+    if (first_group_index.value() == 0 || first_group_index.value() > m_block_group_count) {
+        first_group_index = 1;
+        goal = 0;
+    }
+
+    for (auto respect_reservations : { true, false }) {
+        for (size_t i = 0; i < m_block_group_count && blocks.size() < count; ++i) {
+            GroupIndex group_index = (first_group_index.value() - 1 + i) % m_block_group_count + 1;
+            if (!group_descriptor(group_index).bg_free_blocks_count)
+                continue;
+
+            size_t first_bit = 0;
+            if (i == 0 && goal.value())
+                first_bit = goal.value() - first_block_of_group(group_index).value();
+            bool wrapped_around = first_bit == 0;
+            while (blocks.size() < count) {
+                auto range = TRY(find_free_blocks(group_index, first_bit, count - blocks.size(), respect_reservations, owner));
+                if (!range.has_value()) {
+                    if (wrapped_around)
+                        break;
+                    wrapped_around = true;
+                    first_bit = 0;
+                    continue;
                 }
+                dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", range->block_count, group_index);
+                TRY(mark_blocks_as_allocated(range.value()));
+                for (size_t j = 0; j < range->block_count; ++j)
+                    blocks.unchecked_append(range->first_block.value() + j);
+                first_bit = range->first_block.value() - first_block_of_group(group_index).value() + range->block_count;
             }
         }
+        if (blocks.size() == count)
+            return blocks;
+    }
 
-        VERIFY(found_a_group);
-        auto const& bgd = group_descriptor(group_index);
+    dmesgln("Ext2FS: allocate_blocks found only {} of {} blocks, despite the superblock claiming there are enough", blocks.size(), count);
+    TRY(free_blocks(blocks));
+    return EIO;
+}
 
-        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
+    if (count == 0)
+        return Vector<BlockIndex> {};
+
+    MutexLocker locker(m_lock);
+    return allocate_blocks_impl(preferred_group_index, count, goal, 0);
+}
+
+// Allocates blocks for an inode, continuing at `goal` (usually right after its last block).
+// Each inode that is growing keeps a window of free blocks after its last allocation reserved, so that
+// files which are written to at the same time don't end up interleaved on disk. The window grows
+// each time a writer has used it all up, and starts over when the inode is written to elsewhere.
+auto Ext2FS::allocate_blocks_for_inode(Ext2FSInode& inode, size_t count, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks_for_inode(inode: {}, count {}, goal {})", inode.index(), count, goal);
+    if (count == 0)
+        return Vector<BlockIndex> {};
+
+    MutexLocker locker(m_lock);
+    auto preferred_group_index = group_index_from_inode(inode.index());
+    if (!goal.value())
+        goal = first_block_of_group(preferred_group_index);
+
+    auto it = m_block_reservations.find(inode.index());
+    if (it == m_block_reservations.end()) {
+        TRY(m_block_reservations.try_set(inode.index(), {}));
+        it = m_block_reservations.find(inode.index());
+    }
+    auto& reservation = it->value;
 
-        int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
-        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
-
-        BlockIndex first_block_in_group = (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
-        size_t free_region_size = 0;
-        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(count - blocks.size(), free_region_size);
-        VERIFY(first_unset_bit_index.has_value());
-        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", free_region_size, group_index);
-        for (size_t i = 0; i < free_region_size; ++i) {
-            BlockIndex block_index = (first_unset_bit_index.value() + i) + first_block_in_group.value();
-            TRY(set_block_allocation_state(block_index, true));
-            blocks.unchecked_append(block_index);
-            dbgln_if(EXT2_DEBUG, "  allocated > {}", block_index);
+    if (reservation.block_count && reservation.first_block != goal) {
+        reservation.block_count = 0;
+        reservation.window_size = 0;
+    }
+    if (!reservation.block_count) {
+        reservation.window_size = reservation.window_size ? min(reservation.window_size * 2, max_block_reservation_window) : default_block_reservation_window;
+        auto goal_group_index = group_index_from_block_index(goal);
+        if (goal_group_index.value() && goal_group_index.value() <= m_block_group_count) {
+            auto first_bit = goal.value() - first_block_of_group(goal_group_index).value();
+            if (auto window = TRY(find_free_blocks(goal_group_index, first_bit, max(count, reservation.window_size), true, inode.index())); window.has_value()) {
+                reservation.first_block = window->first_block;
+                reservation.block_count = window->block_count;
+            }
         }
     }
 
-    VERIFY(blocks.size() == count);
+    auto blocks = TRY(allocate_blocks_impl(preferred_group_index, count, goal, inode.index()));
+
+    // Whatever is left of the window after the blocks we just handed out stays reserved.
+    auto window_end = reservation.first_block.value() + reservation.block_count;
+    auto next_block = blocks.last().value() + 1;
+    if (reservation.first_block.value() < next_block && next_block <= window_end) {
+        reservation.first_block = next_block;
+        reservation.block_count = window_end - next_block;
+    } else {
+        reservation.block_count = 0;
+    }
     return blocks;
 }
 
+void Ext2FS::discard_block_reservation(InodeIndex inode_index)
+{
+    MutexLocker locker(m_lock);
+    m_block_reservations.remove(inode_index);
+}
+
 ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
 {
     dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_inode(preferred_group: {})", preferred_group);
@@ -1313,10 +2241,20 @@ ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
 
     auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_inode_bitmap));
     auto inode_bitmap = cached_bitmap->bitmap(inodes_in_group);
-    for (size_t i = 0; i < inode_bitmap.size(); ++i) {
-        if (inode_bitmap.get(i))
-            continue;
+    auto& summary = block_group_summary(group_index);
+    Optional<size_t> free_bit;
+    if (summary.first_free_inode_bit < inode_bitmap.size())
+        free_bit = inode_bitmap.find_one_anywhere_unset(summary.first_free_inode_bit);
+    // NOTE: The word-wise search above doesn't look at the bits in a trailing partial byte.
+    for (size_t i = inode_bitmap.size() & ~7; !free_bit.has_value() && i < inode_bitmap.size(); ++i) {
+        if (!inode_bitmap.get(i))
+            free_bit = i;
+    }
+
+    if (free_bit.has_value()) {
+        auto i = free_bit.value();
         inode_bitmap.set(i, true);
+        summary.first_free_inode_bit = i + 1;
 
         auto inode_index = InodeIndex(first_inode_in_group.value() + i);
 
@@ -1340,7 +2278,7 @@ Ext2FS::GroupIndex Ext2FS::group_index_from_block_index(BlockIndex block_index)
 {
     if (!block_index)
         return 0;
-    return (block_index.value() - 1) / blocks_per_group() + 1;
+    return (block_index.value() - first_block_index().value()) / blocks_per_group() + 1;
 }
 
 auto Ext2FS::group_index_from_inode(InodeIndex inode) const -> GroupIndex
@@ -1397,7 +2335,13 @@ ErrorOr<void> Ext2FS::set_inode_allocation_state(InodeIndex inode_index, bool ne
 
     dbgln_if(EXT2_DEBUG, "Ext2FS: set_inode_allocation_state: Inode {} -> {}", inode_index, new_state);
     auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
-    return update_bitmap_block(bgd.bg_inode_bitmap, bit_index, new_state, m_super_block.s_free_inodes_count, bgd.bg_free_inodes_count);
+    TRY(update_bitmap_block(bgd.bg_inode_bitmap, bit_index, new_state, m_super_block.s_free_inodes_count, bgd.bg_free_inodes_count));
+    auto& summary = block_group_summary(group_index);
+    if (new_state && bit_index == summary.first_free_inode_bit)
+        ++summary.first_free_inode_bit;
+    else if (!new_state)
+        summary.first_free_inode_bit = min(summary.first_free_inode_bit, bit_index);
+    return {};
 }
 
 Ext2FS::BlockIndex Ext2FS::first_block_index() const
@@ -1407,17 +2351,35 @@ Ext2FS::BlockIndex Ext2FS::first_block_index() const
 
 ErrorOr<Ext2FS::CachedBitmap*> Ext2FS::get_bitmap_block(BlockIndex bitmap_block_index)
 {
-    for (auto& cached_bitmap : m_cached_bitmaps) {
-        if (cached_bitmap->bitmap_block_index == bitmap_block_index)
-            return cached_bitmap.ptr();
-    }
+    if (auto it = m_cached_bitmaps.find(bitmap_block_index); it != m_cached_bitmaps.end())
+        return it->value.ptr();
 
     auto block = TRY(KBuffer::try_create_with_size("Ext2FS: Cached bitmap block"sv, block_size(), Memory::Region::Access::ReadWrite));
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(block->data());
     TRY(read_block(bitmap_block_index, &buffer, block_size()));
     auto new_bitmap = TRY(adopt_nonnull_own_or_enomem(new (nothrow) CachedBitmap(bitmap_block_index, move(block))));
-    TRY(m_cached_bitmaps.try_append(move(new_bitmap)));
-    return m_cached_bitmaps.last().ptr();
+    auto* new_bitmap_ptr = new_bitmap.ptr();
+    TRY(m_cached_bitmaps.try_set(bitmap_block_index, move(new_bitmap)));
+    return new_bitmap_ptr;
+}
+
+Ext2FS::BlockGroupSummary& Ext2FS::block_group_summary(GroupIndex group_index)
+{
+    VERIFY(group_index.value() && group_index.value() <= m_block_group_count);
+    return m_block_group_summaries[group_index.value() - 1];
+}
+
+void Ext2FS::note_blocks_allocated(GroupIndex group_index, size_t first_bit, size_t count)
+{
+    auto& summary = block_group_summary(group_index);
+    if (first_bit <= summary.first_free_block_bit && summary.first_free_block_bit < first_bit + count)
+        summary.first_free_block_bit = first_bit + count;
+}
+
+void Ext2FS::note_blocks_freed(GroupIndex group_index, size_t first_bit)
+{
+    auto& summary = block_group_summary(group_index);
+    summary.first_free_block_bit = min(summary.first_free_block_bit, first_bit);
 }
 
 ErrorOr<void> Ext2FS::set_block_allocation_state(BlockIndex block_index, bool new_state)
@@ -1431,7 +2393,12 @@ ErrorOr<void> Ext2FS::set_block_allocation_state(BlockIndex block_index, bool ne
     auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
 
     dbgln_if(EXT2_DEBUG, "Ext2FS: Block {} state -> {} (in bitmap block {})", block_index, new_state, bgd.bg_block_bitmap);
-    return update_bitmap_block(bgd.bg_block_bitmap, bit_index, new_state, m_super_block.s_free_blocks_count, bgd.bg_free_blocks_count);
+    TRY(update_bitmap_block(bgd.bg_block_bitmap, bit_index, new_state, m_super_block.s_free_blocks_count, bgd.bg_free_blocks_count));
+    if (new_state)
+        note_blocks_allocated(group_index, bit_index, 1);
+    else
+        note_blocks_freed(group_index, bit_index);
+    return {};
 }
 
 ErrorOr<NonnullLockRefPtr<Inode>> Ext2FS::create_directory(Ext2FSInode& parent_inode, StringView name, mode_t mode, UserID uid, GroupID gid)
@@ -1521,6 +2488,21 @@ ErrorOr<NonnullLockRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
 {
     VERIFY(is_directory());
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): Looking up '{}'", identifier(), name);
+
+    // NOTE: Indexed directories can be huge, so rather than caching all of their entries, we look up just the one block.
+    if (has_directory_index()) {
+        auto search = TRY(search_directory_index(name));
+        if (search.has_value()) {
+            if (!search->entry_offset.has_value()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            InodeIndex inode_index = reinterpret_cast<ext2_dir_entry_2 const*>(search->leaf.data() + search->entry_offset.value())->inode;
+            return fs().get_inode({ fsid(), inode_index });
+        }
+        drop_directory_index();
+    }
+
     TRY(populate_lookup_cache());
 
     InodeIndex inode_index;
@@ -1674,6 +2656,13 @@ ErrorOr<void> Ext2FS::prepare_to_unmount()
 
     m_inode_cache.clear();
     m_root_inode = nullptr;
+
+    if (m_journal) {
+        // Everything has been checkpointed once the cache is clean, so the journal doesn't need to be recovered anymore.
+        flush_writes();
+        m_super_block.s_feature_incompat &= ~EXT3_FEATURE_INCOMPAT_RECOVER;
+        TRY(flush_super_block());
+    }
     return {};
 }
 }
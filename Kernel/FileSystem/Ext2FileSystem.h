@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Bitmap.h>
+#include <AK/ByteBuffer.h>
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
@@ -21,6 +22,7 @@ struct ext2_super_block;
 namespace Kernel {
 
 class Ext2FS;
+class Ext2Journal;
 struct Ext2FSDirectoryEntry;
 
 class Ext2FSInode final : public Inode {
@@ -40,6 +42,7 @@ private:
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullLockRefPtr<Inode>> lookup(StringView name) override;
     virtual ErrorOr<void> flush_metadata() override;
+    virtual void detach(OpenFileDescription&) override;
     virtual ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) override;
     virtual ErrorOr<NonnullLockRefPtr<Inode>> create_child(StringView name, mode_t, dev_t, UserID, GroupID) override;
     virtual ErrorOr<void> add_child(Inode& child, StringView name, mode_t) override;
@@ -54,13 +57,54 @@ private:
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache() const;
+
+    // One level of an ext2 directory index (htree), i.e. the root block or an interior node,
+    // along with the position of the index entry that was followed from it.
+    struct DirectoryIndexFrame {
+        ByteBuffer block;
+        u32 block_index { 0 };
+        size_t entries_offset { 0 };
+        size_t position { 0 };
+
+        ext2_dx_countlimit& countlimit() { return *reinterpret_cast<ext2_dx_countlimit*>(block.data() + entries_offset); }
+        ext2_dx_entry* entries() { return reinterpret_cast<ext2_dx_entry*>(block.data() + entries_offset); }
+        // The first entry covers all hashes below the second one, so its hash is implied to be 0.
+        u32 hash_at(size_t index) { return index == 0 ? 0 : entries()[index].hash; }
+        u32 child_at(size_t index) { return entries()[index].block & 0x00ffffff; }
+        void insert_after_position(u32 hash, u32 child);
+    };
+    using DirectoryIndexPath = Vector<DirectoryIndexFrame, 2>;
+
+    struct DirectoryIndexSearch {
+        DirectoryIndexPath path;
+        u8 hash_version { 0 };
+        u32 hash { 0 };
+        // The last leaf block that was searched, and the offset of the entry within it if it was found.
+        ByteBuffer leaf;
+        u32 leaf_index { 0 };
+        Optional<size_t> entry_offset;
+    };
+
+    bool has_directory_index() const;
+    void drop_directory_index();
+    ErrorOr<ByteBuffer> read_directory_block(u32 block_index) const;
+    ErrorOr<void> write_directory_block(u32 block_index, ReadonlyBytes);
+    ErrorOr<u32> append_directory_block(ReadonlyBytes);
+    ErrorOr<Optional<DirectoryIndexSearch>> search_directory_index(StringView name) const;
+    ErrorOr<bool> advance_directory_index_path(DirectoryIndexPath&, u32 hash) const;
+    ErrorOr<void> make_room_in_directory_index(DirectoryIndexPath&);
+    ErrorOr<bool> add_child_to_directory_index(InodeIndex, StringView name, u8 file_type);
+    ErrorOr<Optional<InodeIndex>> remove_child_from_directory_index(StringView name);
+    ErrorOr<bool> write_indexed_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> resize(u64);
+    void do_readahead(OpenFileDescription&, off_t offset, size_t count, u64 first_block, u64 last_block) const;
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
+    BlockBasedFileSystem::BlockIndex next_block_goal() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl(bool include_block_list_blocks) const;
@@ -77,6 +121,7 @@ private:
 
 class Ext2FS final : public BlockBasedFileSystem {
     friend class Ext2FSInode;
+    friend class Ext2Journal;
 
 public:
     enum class FeaturesReadOnly : u32 {
@@ -97,10 +142,12 @@ public:
     virtual ErrorOr<void> prepare_to_unmount() override;
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_path_lookup_cache() const override { return true; }
 
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const override;
 
     FeaturesReadOnly get_features_readonly() const;
+    bool supports_directory_index() const;
 
 private:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(unsigned, GroupIndex);
@@ -116,6 +163,7 @@ private:
     u64 inodes_per_group() const;
     u64 blocks_per_group() const;
     u64 inode_size() const;
+    u8 directory_hash_version(u8 stored_hash_version) const;
 
     ErrorOr<void> write_ext2_inode(InodeIndex, ext2_inode const&);
     bool find_block_containing_inode(InodeIndex, BlockIndex& block_index, unsigned& offset) const;
@@ -128,12 +176,33 @@ private:
     ErrorOr<NonnullLockRefPtr<Inode>> create_inode(Ext2FSInode& parent_inode, StringView name, mode_t, dev_t, UserID, GroupID);
     ErrorOr<NonnullLockRefPtr<Inode>> create_directory(Ext2FSInode& parent_inode, StringView name, mode_t, UserID, GroupID);
     virtual void flush_writes() override;
+    virtual void flush_expired_writes() override;
+    void flush_metadata();
+
+    ErrorOr<void> read_block_group_descriptor_table();
+    ErrorOr<void> initialize_journal();
+    virtual void will_write_back_blocks(Span<WritebackBlock const>) override;
+    virtual void did_write_back_blocks(Span<WritebackBlock const>) override;
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks_for_inode(Ext2FSInode&, size_t count, BlockIndex goal);
+    ErrorOr<void> free_blocks(Span<BlockIndex const>);
+    void discard_block_reservation(InodeIndex);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
+    BlockIndex first_block_of_group(GroupIndex) const;
+    size_t blocks_in_group(GroupIndex) const;
+
+    struct BlockRange {
+        BlockIndex first_block { 0 };
+        size_t block_count { 0 };
+    };
+
+    ErrorOr<Vector<BlockIndex>> allocate_blocks_impl(GroupIndex preferred_group_index, size_t count, BlockIndex goal, InodeIndex owner);
+    ErrorOr<Optional<BlockRange>> find_free_blocks(GroupIndex, size_t first_bit, size_t max_length, bool respect_reservations, InodeIndex owner);
+    ErrorOr<void> mark_blocks_as_allocated(BlockRange);
 
     ErrorOr<bool> get_inode_allocation_state(InodeIndex) const;
     ErrorOr<void> set_inode_allocation_state(InodeIndex, bool);
@@ -157,6 +226,9 @@ private:
     mutable ext2_super_block m_super_block {};
     mutable OwnPtr<KBuffer> m_cached_group_descriptor_table;
 
+    // Only set if the journal is being written to.
+    OwnPtr<Ext2Journal> m_journal;
+
     mutable HashMap<InodeIndex, LockRefPtr<Ext2FSInode>> m_inode_cache;
 
     bool m_super_block_dirty { false };
@@ -177,7 +249,31 @@ private:
     ErrorOr<CachedBitmap*> get_bitmap_block(BlockIndex);
     ErrorOr<void> update_bitmap_block(BlockIndex bitmap_block, size_t bit_index, bool new_state, u32& super_block_counter, u16& group_descriptor_counter);
 
-    Vector<OwnPtr<CachedBitmap>> m_cached_bitmaps;
+    HashMap<BlockIndex, NonnullOwnPtr<CachedBitmap>> m_cached_bitmaps;
+
+    // What we know about the free space of a block group without scanning its bitmaps.
+    struct BlockGroupSummary {
+        // There are no free blocks (or inodes) before these bits in the group's bitmaps.
+        size_t first_free_block_bit { 0 };
+        size_t first_free_inode_bit { 0 };
+    };
+
+    BlockGroupSummary& block_group_summary(GroupIndex);
+    void note_blocks_allocated(GroupIndex, size_t first_bit, size_t count);
+    void note_blocks_freed(GroupIndex, size_t first_bit);
+
+    Vector<BlockGroupSummary> m_block_group_summaries;
+
+    static constexpr size_t default_block_reservation_window = 8;
+    static constexpr size_t max_block_reservation_window = 1024;
+
+    // The blocks right after the last allocation of an inode that is being written to, which other inodes keep clear of.
+    struct BlockReservation {
+        BlockIndex first_block { 0 };
+        size_t block_count { 0 };
+        size_t window_size { 0 };
+    };
+    HashMap<InodeIndex, BlockReservation> m_block_reservations;
     LockRefPtr<Ext2FSInode> m_root_inode;
 };
 
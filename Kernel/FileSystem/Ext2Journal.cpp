@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <AK/HashMap.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Ext2FileSystem.h>
+#include <Kernel/FileSystem/Ext2Journal.h>
+
+namespace Kernel {
+
+static constexpr u32 journal_magic = 0xc03b3998;
+
+enum class JournalBlockType : u32 {
+    Descriptor = 1,
+    Commit = 2,
+    SuperblockV1 = 3,
+    SuperblockV2 = 4,
+    Revoke = 5,
+};
+
+static constexpr u32 journal_incompat_revoke = 0x1;
+static constexpr u32 journal_incompat_64bit = 0x2;
+static constexpr u32 journal_known_incompat_features = journal_incompat_revoke | journal_incompat_64bit;
+
+static constexpr u16 journal_tag_flag_escape = 0x1;
+static constexpr u16 journal_tag_flag_same_uuid = 0x2;
+static constexpr u16 journal_tag_flag_last_tag = 0x8;
+
+static constexpr size_t journal_uuid_size = 16;
+
+struct [[gnu::packed]] JournalHeader {
+    BigEndian<u32> magic;
+    BigEndian<u32> block_type;
+    BigEndian<u32> sequence;
+};
+
+struct [[gnu::packed]] JournalSuperblock {
+    JournalHeader header;
+    BigEndian<u32> block_size;
+    BigEndian<u32> max_length;
+    BigEndian<u32> first;
+    BigEndian<u32> sequence;
+    BigEndian<u32> start;
+    BigEndian<u32> error;
+    // The rest is only valid in version 2 superblocks.
+    BigEndian<u32> feature_compat;
+    BigEndian<u32> feature_incompat;
+    BigEndian<u32> feature_ro_compat;
+    u8 uuid[journal_uuid_size];
+};
+
+// NOTE: `block_number_high` is only there if the journal has the 64-bit feature.
+struct [[gnu::packed]] JournalBlockTag {
+    BigEndian<u32> block_number;
+    BigEndian<u16> checksum;
+    BigEndian<u16> flags;
+    BigEndian<u32> block_number_high;
+};
+
+struct [[gnu::packed]] JournalRevokeHeader {
+    JournalHeader header;
+    BigEndian<u32> byte_count;
+};
+
+ErrorOr<NonnullOwnPtr<Ext2Journal>> Ext2Journal::try_create(Ext2FS& fs, Vector<BlockIndex> blocks)
+{
+    if (blocks.is_empty())
+        return EINVAL;
+    auto superblock = TRY(KBuffer::try_create_with_size("Ext2FS: Journal superblock"sv, fs.block_size()));
+    auto journal = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Ext2Journal(fs, move(blocks), move(superblock))));
+    TRY(journal->read_superblock());
+    return journal;
+}
+
+Ext2Journal::Ext2Journal(Ext2FS& fs, Vector<BlockIndex> blocks, NonnullOwnPtr<KBuffer> superblock)
+    : m_fs(fs)
+    , m_blocks(move(blocks))
+    , m_superblock(move(superblock))
+{
+}
+
+ErrorOr<void> Ext2Journal::read_superblock()
+{
+    TRY(read_log_block(0, m_superblock->data()));
+    auto const& superblock = *reinterpret_cast<JournalSuperblock const*>(m_superblock->data());
+    if (superblock.header.magic != journal_magic) {
+        dmesgln("Ext2FS: Bad journal superblock magic");
+        return EINVAL;
+    }
+
+    auto block_type = static_cast<JournalBlockType>(static_cast<u32>(superblock.header.block_type));
+    if (block_type != JournalBlockType::SuperblockV1 && block_type != JournalBlockType::SuperblockV2) {
+        dmesgln("Ext2FS: Unknown journal superblock type {}", static_cast<u32>(block_type));
+        return EINVAL;
+    }
+    if (superblock.block_size != m_fs.block_size()) {
+        dmesgln("Ext2FS: Journal block size {} doesn't match the file system's", static_cast<u32>(superblock.block_size));
+        return EINVAL;
+    }
+
+    m_first = superblock.first;
+    m_max_length = superblock.max_length;
+    m_sequence = superblock.sequence;
+    m_start = superblock.start;
+    if (block_type == JournalBlockType::SuperblockV2) {
+        m_feature_compat = superblock.feature_compat;
+        m_feature_incompat = superblock.feature_incompat;
+    }
+
+    if (m_max_length > m_blocks.size() || m_first == 0 || m_first >= m_max_length || (m_start && (m_start < m_first || m_start >= m_max_length))) {
+        dmesgln("Ext2FS: Journal superblock is corrupt (first: {}, length: {}, start: {}, journal has {} blocks)", m_first, m_max_length, m_start, m_blocks.size());
+        return EINVAL;
+    }
+    if (m_feature_incompat & ~journal_known_incompat_features) {
+        dmesgln("Ext2FS: Journal has unsupported features: {:#x}", m_feature_incompat);
+        return ENOTSUP;
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2Journal::write_superblock()
+{
+    auto& superblock = *reinterpret_cast<JournalSuperblock*>(m_superblock->data());
+    superblock.sequence = m_sequence;
+    superblock.start = m_start;
+    return write_log_blocks(0, 1, m_superblock->data());
+}
+
+ErrorOr<void> Ext2Journal::read_log_block(u32 log_block, u8* data)
+{
+    if (log_block >= m_blocks.size())
+        return EIO;
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+    return m_fs.read_exactly(m_blocks[log_block].value() * m_fs.block_size(), buffer, m_fs.block_size());
+}
+
+// The journal inode is usually laid out contiguously, so this ends up as few large writes.
+ErrorOr<void> Ext2Journal::write_log_blocks(u32 first_log_block, size_t count, u8 const* data)
+{
+    if (first_log_block + count > m_blocks.size())
+        return EIO;
+    auto block_size = m_fs.block_size();
+    for (size_t i = 0; i < count;) {
+        size_t run_length = 1;
+        while (i + run_length < count && m_blocks[first_log_block + i + run_length].value() == m_blocks[first_log_block + i].value() + run_length)
+            ++run_length;
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data + i * block_size));
+        TRY(m_fs.write_exactly(m_blocks[first_log_block + i].value() * block_size, buffer, run_length * block_size));
+        i += run_length;
+    }
+    return {};
+}
+
+u32 Ext2Journal::next_log_block(u32 log_block) const
+{
+    ++log_block;
+    return log_block >= m_max_length ? m_first : log_block;
+}
+
+size_t Ext2Journal::tag_size() const
+{
+    return (m_feature_incompat & journal_incompat_64bit) ? sizeof(JournalBlockTag) : sizeof(JournalBlockTag) - sizeof(u32);
+}
+
+// NOTE: Only the first tag in a descriptor block is followed by a UUID.
+size_t Ext2Journal::tags_per_descriptor() const
+{
+    return (m_fs.block_size() - sizeof(JournalHeader) - journal_uuid_size) / tag_size();
+}
+
+size_t Ext2Journal::max_transaction_length() const
+{
+    return Ext2FS::MaxBlocksPerWritebackBatch + ceil_div(Ext2FS::MaxBlocksPerWritebackBatch, tags_per_descriptor()) + 1;
+}
+
+// Replays every transaction that was committed to the journal but may not have reached its place on disk.
+ErrorOr<void> Ext2Journal::recover()
+{
+    if (!needs_recovery())
+        return {};
+
+    struct ReplayBlock {
+        u64 block_index { 0 };
+        u32 log_block { 0 };
+        u32 sequence { 0 };
+        bool is_escaped { false };
+    };
+    Vector<ReplayBlock> committed_blocks;
+    Vector<ReplayBlock> pending_blocks;
+    // The last transaction in which a block was revoked. Its copies in that transaction and earlier ones must not be replayed.
+    HashMap<u64, u32> revoked_blocks;
+    Vector<u64> pending_revoked_blocks;
+
+    auto block_size = m_fs.block_size();
+    auto buffer = TRY(KBuffer::try_create_with_size("Ext2FS: Journal replay"sv, block_size));
+    auto* data = buffer->data();
+
+    u32 sequence = m_sequence;
+    u32 log_block = m_start;
+    size_t transaction_count = 0;
+    for (size_t blocks_scanned = 0; blocks_scanned < m_max_length; ++blocks_scanned) {
+        TRY(read_log_block(log_block, data));
+        auto const& header = *reinterpret_cast<JournalHeader const*>(data);
+        if (header.magic != journal_magic || header.sequence != sequence)
+            break;
+        log_block = next_log_block(log_block);
+
+        auto block_type = static_cast<JournalBlockType>(static_cast<u32>(header.block_type));
+        if (block_type == JournalBlockType::Descriptor) {
+            size_t offset = sizeof(JournalHeader);
+            while (offset + tag_size() <= block_size) {
+                auto const& tag = *reinterpret_cast<JournalBlockTag const*>(data + offset);
+                u64 block_index = tag.block_number;
+                if (m_feature_incompat & journal_incompat_64bit)
+                    block_index |= static_cast<u64>(tag.block_number_high) << 32;
+                u16 flags = tag.flags;
+                TRY(pending_blocks.try_append({ block_index, log_block, sequence, (flags & journal_tag_flag_escape) != 0 }));
+                log_block = next_log_block(log_block);
+                ++blocks_scanned;
+
+                offset += tag_size();
+                if (!(flags & journal_tag_flag_same_uuid))
+                    offset += journal_uuid_size;
+                if (flags & journal_tag_flag_last_tag)
+                    break;
+            }
+        } else if (block_type == JournalBlockType::Revoke) {
+            auto const& revoke_header = *reinterpret_cast<JournalRevokeHeader const*>(data);
+            size_t record_size = (m_feature_incompat & journal_incompat_64bit) ? sizeof(u64) : sizeof(u32);
+            size_t byte_count = min<size_t>(revoke_header.byte_count, block_size);
+            for (size_t offset = sizeof(JournalRevokeHeader); offset + record_size <= byte_count; offset += record_size) {
+                u64 block_index = record_size == sizeof(u64)
+                    ? static_cast<u64>(*reinterpret_cast<BigEndian<u64> const*>(data + offset))
+                    : static_cast<u64>(*reinterpret_cast<BigEndian<u32> const*>(data + offset));
+                TRY(pending_revoked_blocks.try_append(block_index));
+            }
+        } else if (block_type == JournalBlockType::Commit) {
+            TRY(committed_blocks.try_extend(move(pending_blocks)));
+            for (auto block_index : pending_revoked_blocks)
+                TRY(revoked_blocks.try_set(block_index, sequence));
+            pending_blocks.clear();
+            pending_revoked_blocks.clear();
+            ++sequence;
+            ++transaction_count;
+        } else {
+            break;
+        }
+    }
+
+    size_t replayed_block_count = 0;
+    for (auto const& block : committed_blocks) {
+        if (auto it = revoked_blocks.find(block.block_index); it != revoked_blocks.end() && it->value >= block.sequence)
+            continue;
+        if (block.block_index >= m_fs.super_block().s_blocks_count) {
+            dmesgln("Ext2FS: Journal contains out-of-range block {}", block.block_index);
+            return EIO;
+        }
+        TRY(read_log_block(block.log_block, data));
+        if (block.is_escaped)
+            *reinterpret_cast<BigEndian<u32>*>(data) = journal_magic;
+        auto block_buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        TRY(m_fs.write_block(block.block_index, block_buffer, block_size));
+        ++replayed_block_count;
+    }
+    m_fs.flush_writes_impl();
+
+    dmesgln("Ext2FS: Replayed {} block(s) from {} journal transaction(s)", replayed_block_count, transaction_count);
+    m_start = 0;
+    m_sequence = sequence;
+    return write_superblock();
+}
+
+bool Ext2Journal::is_writable() const
+{
+    return m_feature_compat == 0
+        && (m_feature_incompat & ~journal_incompat_revoke) == 0
+        && m_max_length - m_first >= max_transaction_length();
+}
+
+ErrorOr<void> Ext2Journal::prepare_for_writing()
+{
+    VERIFY(is_writable() && !needs_recovery());
+    m_transaction_buffer = TRY(KBuffer::try_create_with_size("Ext2FS: Journal transaction"sv, max_transaction_length() * m_fs.block_size()));
+    return {};
+}
+
+// As every transaction is checkpointed before the next one is committed, they all start at the beginning of the log.
+ErrorOr<void> Ext2Journal::commit(Span<BlockBasedFileSystem::WritebackBlock const> blocks)
+{
+    VERIFY(m_transaction_buffer);
+    // NOTE: The previous transaction has reached the disk by now, even if marking it as such failed.
+    TRY(checkpoint());
+    VERIFY(blocks.size() <= Ext2FS::MaxBlocksPerWritebackBatch);
+    if (blocks.is_empty())
+        return {};
+
+    auto block_size = m_fs.block_size();
+    auto const& superblock = *reinterpret_cast<JournalSuperblock const*>(m_superblock->data());
+    auto* transaction = m_transaction_buffer->data();
+    size_t length = 0;
+
+    auto append_header = [&](JournalBlockType block_type) {
+        auto* block = transaction + length++ * block_size;
+        memset(block, 0, block_size);
+        auto& header = *reinterpret_cast<JournalHeader*>(block);
+        header.magic = journal_magic;
+        header.block_type = to_underlying(block_type);
+        header.sequence = m_sequence;
+        return block;
+    };
+
+    for (size_t i = 0; i < blocks.size(); i += tags_per_descriptor()) {
+        auto* descriptor = append_header(JournalBlockType::Descriptor);
+        auto tag_count = min(tags_per_descriptor(), blocks.size() - i);
+        size_t offset = sizeof(JournalHeader);
+        for (size_t j = 0; j < tag_count; ++j) {
+            auto const& block = blocks[i + j];
+            VERIFY(block.block_index.value() <= NumericLimits<u32>::max());
+            auto* data = transaction + length++ * block_size;
+            memcpy(data, block.data, block_size);
+
+            u16 flags = 0;
+            // A block that looks like journal metadata has its magic cleared, and restored when replaying.
+            if (*reinterpret_cast<BigEndian<u32> const*>(data) == journal_magic) {
+                *reinterpret_cast<u32*>(data) = 0;
+                flags |= journal_tag_flag_escape;
+            }
+            if (j != 0)
+                flags |= journal_tag_flag_same_uuid;
+            if (j == tag_count - 1)
+                flags |= journal_tag_flag_last_tag;
+
+            auto& tag = *reinterpret_cast<JournalBlockTag*>(descriptor + offset);
+            tag.block_number = static_cast<u32>(block.block_index.value());
+            tag.flags = flags;
+            offset += tag_size();
+            if (j == 0) {
+                memcpy(descriptor + offset, superblock.uuid, journal_uuid_size);
+                offset += journal_uuid_size;
+            }
+        }
+    }
+    append_header(JournalBlockType::Commit);
+    VERIFY(length <= max_transaction_length());
+
+    dbgln_if(EXT2_DEBUG, "Ext2FS: Committing journal transaction {} ({} blocks)", m_sequence, blocks.size());
+    TRY(write_log_blocks(m_first, length, transaction));
+    // The transaction only counts once the superblock points at it.
+    m_start = m_first;
+    TRY(write_superblock());
+    m_has_uncheckpointed_transaction = true;
+    return {};
+}
+
+ErrorOr<void> Ext2Journal::checkpoint()
+{
+    if (!m_has_uncheckpointed_transaction)
+        return {};
+    m_start = 0;
+    ++m_sequence;
+    TRY(write_superblock());
+    m_has_uncheckpointed_transaction = false;
+    return {};
+}
+
+}
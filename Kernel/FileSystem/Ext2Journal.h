@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/KBuffer.h>
+
+namespace Kernel {
+
+class Ext2FS;
+
+// An ext3-compatible (JBD) journal kept in an inode of the file system.
+// Each batch of blocks that the disk cache writes back is first committed to the journal as a single
+// transaction, and the journal is marked empty again once the batch has reached its place on disk.
+// After a crash, committed transactions are replayed when mounting, so a batch either makes it to disk
+// completely or not at all. Journals left behind by other implementations are replayed the same way.
+// NOTE: Apart from recover(), which runs while mounting, this is only used with the disk cache locked.
+class Ext2Journal {
+    AK_MAKE_NONCOPYABLE(Ext2Journal);
+    AK_MAKE_NONMOVABLE(Ext2Journal);
+
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    // `blocks` are the blocks of the journal inode, in order.
+    static ErrorOr<NonnullOwnPtr<Ext2Journal>> try_create(Ext2FS&, Vector<BlockIndex> blocks);
+
+    bool needs_recovery() const { return m_start != 0; }
+    ErrorOr<void> recover();
+
+    // Whether we know how to write to this journal. We don't write checksummed journals.
+    bool is_writable() const;
+    ErrorOr<void> prepare_for_writing();
+
+    ErrorOr<void> commit(Span<BlockBasedFileSystem::WritebackBlock const>);
+    ErrorOr<void> checkpoint();
+
+private:
+    Ext2Journal(Ext2FS&, Vector<BlockIndex> blocks, NonnullOwnPtr<KBuffer> superblock);
+
+    ErrorOr<void> read_superblock();
+    ErrorOr<void> write_superblock();
+    ErrorOr<void> read_log_block(u32 log_block, u8* data);
+    ErrorOr<void> write_log_blocks(u32 first_log_block, size_t count, u8 const* data);
+    u32 next_log_block(u32 log_block) const;
+
+    size_t tag_size() const;
+    size_t tags_per_descriptor() const;
+    size_t max_transaction_length() const;
+
+    Ext2FS& m_fs;
+    Vector<BlockIndex> m_blocks;
+    NonnullOwnPtr<KBuffer> m_superblock;
+    OwnPtr<KBuffer> m_transaction_buffer;
+
+    u32 m_first { 0 };
+    u32 m_max_length { 0 };
+    u32 m_sequence { 0 };
+    u32 m_start { 0 };
+    u32 m_feature_compat { 0 };
+    u32 m_feature_incompat { 0 };
+    bool m_has_uncheckpointed_transaction { false };
+};
+
+}
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,38 @@ namespace Kernel {
 
 class File;
 
+// Gets told whenever a File's blocker set is evaluated, without a thread having to block on it.
+// This is what lets an EPoll keep track of many files at once.
+class FileReadinessObserver {
+public:
+    virtual ~FileReadinessObserver() = default;
+    virtual void file_readiness_may_have_changed() = 0;
+
+private:
+    IntrusiveListNode<FileReadinessObserver> m_observer_list_node;
+
+public:
+    using List = IntrusiveList<&FileReadinessObserver::m_observer_list_node>;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    void add_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.append(observer);
+        // Let the observer pick up the current state, it may not change again for a while.
+        observer.file_readiness_may_have_changed();
+    }
+
+    void remove_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.remove(observer);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +69,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_readiness_observers)
+            observer.file_readiness_may_have_changed();
     }
+
+private:
+    FileReadinessObserver::List m_readiness_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +148,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
 
     virtual FileBlockerSet& blocker_set() { return m_blocker_set; }
 
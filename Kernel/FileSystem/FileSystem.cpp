@@ -64,6 +64,21 @@ void FileSystem::sync()
         fs.flush_writes();
 }
 
+void FileSystem::writeback()
+{
+    Inode::sync_all();
+
+    NonnullLockRefPtrVector<FileSystem, 32> file_systems;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_file_systems())
+            file_systems.append(*it.value);
+    }
+
+    for (auto& fs : file_systems)
+        fs.flush_expired_writes();
+}
+
 void FileSystem::lock_all()
 {
     for (auto& it : all_file_systems()) {
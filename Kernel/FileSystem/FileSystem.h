@@ -27,12 +27,15 @@ public:
     FileSystemID fsid() const { return m_fsid; }
     static FileSystem* from_fsid(FileSystemID);
     static void sync();
+    static void writeback();
     static void lock_all();
 
     virtual ErrorOr<void> initialize() = 0;
     virtual StringView class_name() const = 0;
     virtual Inode& root_inode() = 0;
     virtual bool supports_watchers() const { return false; }
+    // Whether directories only ever change through the VirtualFileSystem, so lookups in them can be cached.
+    virtual bool supports_path_lookup_cache() const { return false; }
 
     bool is_readonly() const { return m_readonly; }
 
@@ -52,11 +55,15 @@ public:
     };
 
     virtual void flush_writes() { }
+    // Writes back data that has been dirty for a while. This is what the periodic
+    // writeback does, as opposed to flush_writes() which writes back everything.
+    virtual void flush_expired_writes() { flush_writes(); }
 
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
     virtual bool is_file_backed() const { return false; }
+    virtual bool is_block_based() const { return false; }
 
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const { return entry.file_type; }
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KString.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<NonnullLockRefPtr<IORing>> IORing::try_create(u32 entries)
+{
+    if (entries == 0 || entries > io_ring_max_entries)
+        return EINVAL;
+
+    // The ring indices are masked, so the entry count has to be a power of two.
+    u32 rounded_entries = 1;
+    while (rounded_entries < entries)
+        rounded_entries <<= 1;
+    entries = rounded_entries;
+
+    auto size = TRY(Memory::page_round_up(io_ring_mapping_size(entries)));
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) IORing(entries, move(vmobject), move(region)));
+}
+
+IORing::IORing(u32 entries, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_submission_entries(entries)
+    , m_completion_entries(io_ring_completion_entries(entries))
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+    auto& ring_header = header();
+    ring_header.submission_entries = m_submission_entries;
+    ring_header.completion_entries = m_completion_entries;
+    ring_header.submissions_offset = io_ring_submissions_offset();
+    ring_header.completions_offset = io_ring_completions_offset(m_submission_entries);
+}
+
+IORing::~IORing() = default;
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // NOTE: A private mapping would get copy-on-write pages, which would silently detach it from the kernel's view.
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":io-ring:"sv);
+}
+
+size_t IORing::available_completions() const
+{
+    auto head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+    return min(static_cast<u32>(m_completion_tail - head), m_completion_entries);
+}
+
+bool IORing::has_room_for_completion() const
+{
+    auto head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+    return static_cast<u32>(m_completion_tail - head) < m_completion_entries;
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    return available_completions() > 0;
+}
+
+void IORing::post_completion(u64 user_data, i64 result)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(has_room_for_completion());
+
+    auto* completions = reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(io_ring_completions_offset(m_submission_entries)).as_ptr());
+    completions[m_completion_tail & (m_completion_entries - 1)] = { user_data, result };
+    ++m_completion_tail;
+    AK::atomic_store(&header().completion_tail, m_completion_tail, AK::memory_order_release);
+}
+
+static ErrorOr<size_t> perform_operation(OpenFileDescription& description, IORingSubmission const& submission)
+{
+    auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.buffer), submission.length));
+    switch (submission.opcode) {
+    case IORingOpcode::Read:
+        return description.read(buffer, submission.length);
+    case IORingOpcode::PRead:
+        return description.read(buffer, submission.offset, submission.length);
+    case IORingOpcode::Write:
+        if (description.should_append() && description.file().is_seekable())
+            TRY(description.seek(0, SEEK_END));
+        return description.write(buffer, submission.length);
+    case IORingOpcode::PWrite:
+        return description.write(submission.offset, buffer, submission.length);
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static bool is_read_operation(IORingOpcode opcode)
+{
+    return opcode == IORingOpcode::Read || opcode == IORingOpcode::PRead;
+}
+
+static bool is_ready(OpenFileDescription const& description, IORingOpcode opcode)
+{
+    return is_read_operation(opcode) ? description.can_read() : description.can_write();
+}
+
+static ErrorOr<NonnullLockRefPtr<OpenFileDescription>> description_for_submission(Process& process, IORingSubmission const& submission)
+{
+    auto description = TRY(process.open_file_description(submission.fd));
+    if (description->is_io_ring())
+        return EINVAL;
+    if (is_read_operation(submission.opcode)) {
+        if (!description->is_readable())
+            return EBADF;
+        if (description->is_directory())
+            return EISDIR;
+    } else if (!description->is_writable()) {
+        return EBADF;
+    }
+    if (submission.opcode == IORingOpcode::PRead || submission.opcode == IORingOpcode::PWrite) {
+        if (!description->file().is_seekable())
+            return EINVAL;
+        if (submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+    }
+    return description;
+}
+
+void IORing::handle_submission(Process& process, IORingSubmission const& submission, Vector<PendingOperation>& ready_operations)
+{
+    switch (submission.opcode) {
+    case IORingOpcode::Nop:
+        post_completion(submission.user_data, 0);
+        return;
+    case IORingOpcode::Read:
+    case IORingOpcode::Write:
+    case IORingOpcode::PRead:
+    case IORingOpcode::PWrite:
+        break;
+    default:
+        post_completion(submission.user_data, -EINVAL);
+        return;
+    }
+
+    if (submission.length > NumericLimits<ssize_t>::max()) {
+        post_completion(submission.user_data, -EINVAL);
+        return;
+    }
+
+    auto description_or_error = description_for_submission(process, submission);
+    if (description_or_error.is_error()) {
+        post_completion(submission.user_data, -static_cast<i64>(description_or_error.error().code()));
+        return;
+    }
+    auto description = description_or_error.release_value();
+
+    // NOTE: Operations on files that aren't ready yet are parked instead of blocking the whole batch.
+    //       Like O_NONBLOCK I/O, a parked operation is performed (once) as soon as its file becomes ready.
+    if (!is_ready(*description, submission.opcode)) {
+        auto result = m_pending_operations.try_append({ submission, move(description), process.pid() });
+        if (result.is_error())
+            post_completion(submission.user_data, -ENOMEM);
+        return;
+    }
+
+    if (ready_operations.try_append({ submission, move(description), process.pid() }).is_error()) {
+        post_completion(submission.user_data, -ENOMEM);
+        return;
+    }
+    ++m_operations_in_flight;
+}
+
+ErrorOr<size_t> IORing::consume_submissions(Process& process, Vector<PendingOperation>& ready_operations)
+{
+    VERIFY(m_lock.is_locked());
+
+    auto tail = AK::atomic_load(&header().submission_tail, AK::memory_order_acquire);
+    auto available = static_cast<u32>(tail - m_submission_head);
+    if (available > m_submission_entries)
+        return EINVAL;
+
+    auto const* submissions = reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(io_ring_submissions_offset()).as_ptr());
+    size_t consumed = 0;
+    while (m_submission_head != tail) {
+        // Every submission we take (and every parked or running one) must be able to post its completion later on.
+        auto head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+        auto free_completions = m_completion_entries - min(static_cast<u32>(m_completion_tail - head), m_completion_entries);
+        if (free_completions <= m_pending_operations.size() + m_operations_in_flight)
+            break;
+
+        // NOTE: Copy the entry out of the shared mapping, so userspace can't change it while we work on it.
+        auto submission = submissions[m_submission_head & (m_submission_entries - 1)];
+        ++m_submission_head;
+        AK::atomic_store(&header().submission_head, m_submission_head, AK::memory_order_release);
+        ++consumed;
+
+        handle_submission(process, submission, ready_operations);
+    }
+    return consumed;
+}
+
+void IORing::take_ready_operations(Process& process, Vector<PendingOperation>& ready_operations)
+{
+    VERIFY(m_lock.is_locked());
+
+    m_pending_operations.remove_all_matching([&](auto& operation) {
+        // NOTE: The buffers of an operation live in the address space of the process that submitted it.
+        if (operation.pid != process.pid())
+            return false;
+        if (!is_ready(*operation.description, operation.submission.opcode))
+            return false;
+        if (ready_operations.try_append(operation).is_error())
+            return false;
+        ++m_operations_in_flight;
+        return true;
+    });
+}
+
+void IORing::perform_ready_operations(Vector<PendingOperation>& ready_operations)
+{
+    VERIFY(!m_lock.is_exclusively_locked_by_current_thread());
+
+    for (auto& operation : ready_operations) {
+        auto result = perform_operation(*operation.description, operation.submission);
+        MutexLocker locker(m_lock);
+        --m_operations_in_flight;
+        post_completion(operation.submission.user_data, result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value()));
+    }
+    // Let anyone polling the ring know about the new completions.
+    evaluate_block_conditions();
+}
+
+ErrorOr<size_t> IORing::enter(Process& process, u32 min_complete)
+{
+    min_complete = min(min_complete, m_completion_entries);
+
+    size_t consumed = 0;
+    bool is_first_pass = true;
+    for (;;) {
+        Vector<PendingOperation> ready_operations;
+        Thread::SelectBlocker::FDVector fds_info;
+        {
+            MutexLocker locker(m_lock);
+            auto previous_completion_tail = m_completion_tail;
+            if (is_first_pass) {
+                consumed = TRY(consume_submissions(process, ready_operations));
+                is_first_pass = false;
+            }
+            take_ready_operations(process, ready_operations);
+            // Let anyone polling the ring know about the new completions.
+            if (m_completion_tail != previous_completion_tail)
+                evaluate_block_conditions();
+
+            if (ready_operations.is_empty()) {
+                if (available_completions() >= min_complete)
+                    return consumed;
+
+                for (auto& operation : m_pending_operations) {
+                    if (operation.pid != process.pid())
+                        continue;
+                    auto block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+                    block_flags |= is_read_operation(operation.submission.opcode) ? BlockFlags::Read : BlockFlags::Write;
+                    TRY(fds_info.try_append({ operation.description, block_flags }));
+                }
+            }
+        }
+
+        // NOTE: Operations can block (e.g. on disk I/O), so they run without holding the ring lock.
+        //       That way other threads can keep submitting to and reaping from the same ring meanwhile.
+        if (!ready_operations.is_empty()) {
+            perform_ready_operations(ready_operations);
+            continue;
+        }
+
+        // Nothing we could wait for would ever produce the requested completions.
+        if (fds_info.is_empty())
+            return consumed;
+
+        dbgln_if(IO_DEBUG, "IORing: Waiting on {} pending operations", fds_info.size());
+        if (Thread::current()->block<Thread::SelectBlocker>({}, fds_info).was_interrupted()) {
+            if (consumed == 0)
+                return EINTR;
+            return consumed;
+        }
+    }
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+
+namespace Kernel {
+
+// The kernel side of an I/O ring, see Kernel/API/IORing.h for the shared memory layout.
+// Submissions are consumed in io_ring_enter(). Operations are performed right away when their file
+// is ready, otherwise they are parked until it is, and completed by a later io_ring_enter() from
+// the same process. This lets one kernel entry start and finish a whole batch of I/O.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<IORing>> try_create(u32 entries);
+    virtual ~IORing() override;
+
+    // The ring is readable when there are completions waiting to be consumed.
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+    // Consumes all available submissions, then waits until at least `min_complete` completions are available.
+    // Returns the number of consumed submissions.
+    ErrorOr<size_t> enter(Process&, u32 min_complete);
+
+private:
+    struct PendingOperation {
+        IORingSubmission submission;
+        NonnullLockRefPtr<OpenFileDescription> description;
+        ProcessID pid;
+    };
+
+    IORing(u32 entries, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    IORingHeader const& header() const { return *reinterpret_cast<IORingHeader const*>(m_region->vaddr().as_ptr()); }
+
+    bool has_room_for_completion() const;
+    size_t available_completions() const;
+    void post_completion(u64 user_data, i64 result);
+
+    // Operations that can be performed right away are collected in `ready_operations`, so that the caller
+    // can perform them with perform_ready_operations() once it has dropped the lock.
+    ErrorOr<size_t> consume_submissions(Process&, Vector<PendingOperation>& ready_operations);
+    void handle_submission(Process&, IORingSubmission const&, Vector<PendingOperation>& ready_operations);
+    void take_ready_operations(Process&, Vector<PendingOperation>& ready_operations);
+    void perform_ready_operations(Vector<PendingOperation>&);
+
+    u32 const m_submission_entries { 0 };
+    u32 const m_completion_entries { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+
+    // NOTE: Userspace can scribble over the shared header at any time, so the kernel keeps its own indices.
+    Mutex m_lock { "IORing"sv };
+    u32 m_submission_head { 0 };
+    u32 m_completion_tail { 0 };
+    Vector<PendingOperation> m_pending_operations;
+    // Operations that were taken off the ring or the pending list and are being performed without the lock held.
+    // They still count towards the completions that have to fit into the ring.
+    u32 m_operations_in_flight { 0 };
+};
+
+}
@@ -311,6 +311,7 @@ public:
     virtual ErrorOr<void> initialize() override;
     virtual StringView class_name() const override { return "ISO9660FS"sv; }
     virtual Inode& root_inode() override;
+    virtual bool supports_path_lookup_cache() const override { return true; }
 
     virtual unsigned total_block_count() const override;
     virtual unsigned total_inode_count() const override;
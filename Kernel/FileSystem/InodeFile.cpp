@@ -29,7 +29,18 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (Checked<off_t>::addition_would_overflow(offset, count))
         return EOVERFLOW;
 
-    auto nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
+    size_t nread = 0;
+    // If the file is mmap'd, serve whatever is already resident in its shared VMObject
+    // directly instead of going through the filesystem (and caching it a second time).
+    if (auto vmobject = m_inode->shared_vmobject()) {
+        auto size = static_cast<u64>(m_inode->size());
+        if (offset < size)
+            nread = TRY(vmobject->read_resident_bytes(offset, min<u64>(count, size - offset), buffer));
+    }
+    if (nread < count) {
+        auto remaining_buffer = buffer.offset(nread);
+        nread += TRY(m_inode->read_bytes(offset + nread, count - nread, remaining_buffer, &description));
+    }
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
@@ -47,6 +58,11 @@ ErrorOr<size_t> InodeFile::write(OpenFileDescription& description, u64 offset, U
         MutexLocker locker(m_inode->m_inode_lock);
         TRY(m_inode->prepare_to_write_data());
         nwritten = TRY(m_inode->write_bytes(offset, count, data, &description));
+        // Keep the pages of any shared mapping coherent with what was just written.
+        // NOTE: This has to happen under the inode lock, so that the pages end up with the same bytes as the file
+        //       when writes to the same range race.
+        if (auto vmobject = m_inode->shared_vmobject(); vmobject && nwritten > 0)
+            TRY(vmobject->update_resident_bytes(offset, nwritten, data));
     }
     if (nwritten > 0) {
         auto mtime_result = m_inode->update_timestamps({}, {}, kgettimeofday().to_truncated_seconds());
@@ -6,12 +6,14 @@
  */
 
 #include <AK/MemoryStream.h>
+#include <Kernel/API/DirectoryEntryWithMetadata.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Net/Socket.h>
@@ -22,6 +24,8 @@
 
 namespace Kernel {
 
+DEFINE_SLAB_CACHE(OpenFileDescription);
+
 ErrorOr<NonnullLockRefPtr<OpenFileDescription>> OpenFileDescription::try_create(Custody& custody)
 {
     auto inode_file = TRY(InodeFile::create(custody.inode()));
@@ -51,6 +55,10 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    // NOTE: Nobody can register new interests anymore, so only a concurrently destroyed EPoll could make this list shrink.
+    if (!m_epoll_interests.is_empty())
+        EPoll::remove_interests_for_description({}, *this);
+
     m_file->detach(*this);
     if (is_fifo())
         static_cast<FIFO*>(m_file.ptr())->detach(fifo_direction());
@@ -270,6 +278,98 @@ ErrorOr<size_t> OpenFileDescription::get_dir_entries(UserOrKernelBuffer& output_
     return size - remaining;
 }
 
+ErrorOr<size_t> OpenFileDescription::get_dir_entries_with_metadata(Credentials const& credentials, bool may_look_up_metadata, UserOrKernelBuffer& output_buffer, size_t size)
+{
+    if (!is_directory())
+        return ENOTDIR;
+
+    auto metadata = this->metadata();
+    if (!metadata.is_valid())
+        return EIO;
+
+    // Looking up the children while the directory is being traversed would mean taking their locks under the directory's
+    // lock, so we gather the entries first.
+    struct Entry {
+        NonnullOwnPtr<KString> name;
+        InodeIdentifier inode;
+        u8 file_type { 0 };
+    };
+    Vector<Entry> entries;
+    TRY(VirtualFileSystem::the().traverse_directory_inode(*m_inode, [&entries, this](auto& entry) -> ErrorOr<void> {
+        TRY(entries.try_append({ TRY(KString::try_create(entry.name)), entry.inode, m_inode->fs().internal_file_type_to_directory_entry_type(entry) }));
+        return {};
+    }));
+
+    // Same as stat() on the entries, we need to be able to search the directory to see its children's metadata.
+    may_look_up_metadata = may_look_up_metadata && metadata.may_execute(credentials);
+
+    auto lookup_metadata = [&](Entry const& entry) -> Optional<struct stat> {
+        if (!may_look_up_metadata)
+            return {};
+        LockRefPtr<Inode> inode;
+        if (entry.name->view() == "."sv) {
+            inode = m_inode;
+        } else if (entry.inode.fsid() != m_inode->fsid()) {
+            // Entries on other file systems are either mount points, in which case they are the root of the mounted
+            // file system, or the parent of this file system's root, which we leave to stat().
+            if (entry.name->view() == ".."sv)
+                return {};
+            auto* fs = FileSystem::from_fsid(entry.inode.fsid());
+            if (!fs)
+                return {};
+            inode = fs->root_inode();
+        } else {
+            auto inode_or_error = m_inode->lookup(entry.name->view());
+            if (inode_or_error.is_error())
+                return {};
+            inode = inode_or_error.release_value();
+        }
+        // The directory may have changed since we traversed it.
+        if (inode->identifier() != entry.inode)
+            return {};
+        auto stat_or_error = inode->metadata().stat();
+        if (stat_or_error.is_error())
+            return {};
+        return stat_or_error.release_value();
+    };
+
+    size_t remaining = size;
+    u8 stack_buffer[PAGE_SIZE];
+    Bytes temp_buffer(stack_buffer, sizeof(stack_buffer));
+    OutputMemoryStream stream { temp_buffer };
+
+    auto flush_stream_to_output_buffer = [&stream, &remaining, &output_buffer]() -> ErrorOr<void> {
+        if (stream.size() == 0)
+            return {};
+        if (remaining < stream.size())
+            return EINVAL;
+        TRY(output_buffer.write(stream.bytes()));
+        output_buffer = output_buffer.offset(stream.size());
+        remaining -= stream.size();
+        stream.reset();
+        return {};
+    };
+
+    for (auto& entry : entries) {
+        DirectoryEntryWithMetadata serialized_entry;
+        serialized_entry.inode_index = entry.inode.index().value();
+        serialized_entry.file_type = entry.file_type;
+        if (auto stat = lookup_metadata(entry); stat.has_value()) {
+            serialized_entry.has_metadata = true;
+            serialized_entry.metadata = stat.release_value();
+        }
+        serialized_entry.name_length = entry.name->length();
+
+        if (serialized_entry.total_size() > stream.remaining())
+            TRY(flush_stream_to_output_buffer());
+        stream << ReadonlyBytes { reinterpret_cast<u8 const*>(&serialized_entry), sizeof(serialized_entry) };
+        stream << entry.name->bytes();
+    }
+    TRY(flush_stream_to_output_buffer());
+
+    return size - remaining;
+}
+
 bool OpenFileDescription::is_device() const
 {
     return m_file->is_device();
@@ -327,6 +427,30 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_epoll() const
+{
+    return m_file->is_epoll();
+}
+
+EPoll* OpenFileDescription::epoll()
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll*>(m_file.ptr());
+}
+
+bool OpenFileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+IORing* OpenFileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_master_pty() const
 {
     return m_file->is_master_pty();
@@ -493,6 +617,16 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+OpenFileDescription::ReadaheadState OpenFileDescription::readahead_state() const
+{
+    return m_state.with([](auto& state) { return state.readahead; });
+}
+
+void OpenFileDescription::set_readahead_state(ReadaheadState const& readahead)
+{
+    m_state.with([&](auto& state) { state.readahead = readahead; });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
@@ -533,6 +667,11 @@ OwnPtr<OpenFileDescriptionData>& OpenFileDescription::data()
     return m_state.with([](auto& state) -> OwnPtr<OpenFileDescriptionData>& { return state.data; });
 }
 
+OpenFileDescriptionData const* OpenFileDescription::data() const
+{
+    return m_state.with([](auto const& state) -> OpenFileDescriptionData const* { return state.data.ptr(); });
+}
+
 off_t OpenFileDescription::offset() const
 {
     return m_state.with([](auto& state) { return state.current_offset; });
@@ -9,10 +9,12 @@
 #include <AK/AtomicRefCounted.h>
 #include <AK/Badge.h>
 #include <AK/RefPtr.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Heap/SlabCache.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/VirtualAddress.h>
 
@@ -24,6 +26,8 @@ public:
 };
 
 class OpenFileDescription final : public AtomicRefCounted<OpenFileDescription> {
+    MAKE_SLAB_ALLOCATED(OpenFileDescription);
+
 public:
     static ErrorOr<NonnullLockRefPtr<OpenFileDescription>> try_create(Custody&);
     static ErrorOr<NonnullLockRefPtr<OpenFileDescription>> try_create(File&);
@@ -56,6 +60,7 @@ public:
     bool can_write() const;
 
     ErrorOr<size_t> get_dir_entries(UserOrKernelBuffer& buffer, size_t);
+    ErrorOr<size_t> get_dir_entries_with_metadata(Credentials const&, bool may_look_up_metadata, UserOrKernelBuffer& buffer, size_t);
 
     ErrorOr<NonnullOwnPtr<KBuffer>> read_entire_file();
 
@@ -64,6 +69,15 @@ public:
 
     bool is_direct() const;
 
+    // Filesystems use this to detect sequential reads and size their readahead.
+    struct ReadaheadState {
+        u64 next_sequential_offset { 0 };
+        u64 readahead_end_block { 0 };
+        size_t window_in_blocks { 0 };
+    };
+    ReadaheadState readahead_state() const;
+    void set_readahead_state(ReadaheadState const&);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -81,6 +95,12 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_epoll() const;
+    EPoll* epoll();
+
+    bool is_io_ring() const;
+    IORing* io_ring();
+
     bool is_master_pty() const;
     MasterPTY const* master_pty() const;
     MasterPTY* master_pty();
@@ -112,6 +132,7 @@ public:
     void set_fifo_direction(Badge<FIFO>, FIFO::Direction direction);
 
     OwnPtr<OpenFileDescriptionData>& data();
+    OpenFileDescriptionData const* data() const;
 
     void set_original_inode(Badge<VirtualFileSystem>, NonnullLockRefPtr<Inode>&& inode) { m_inode = move(inode); }
     void set_original_custody(Badge<VirtualFileSystem>, Custody& custody);
@@ -125,6 +146,8 @@ public:
 
     FileBlockerSet& blocker_set();
 
+    EPollInterest::ListInDescription& epoll_interests(Badge<EPoll>) { return m_epoll_interests; }
+
     ErrorOr<void> apply_flock(Process const&, Userspace<flock const*>, ShouldBlock);
     ErrorOr<void> get_flock(Userspace<flock*>) const;
 
@@ -154,8 +177,12 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+        ReadaheadState readahead;
     };
 
     SpinlockProtected<State> m_state { LockRank::None };
+
+    // NOTE: This is protected by the EPoll interest links lock.
+    EPollInterest::ListInDescription m_epoll_interests;
 };
 }
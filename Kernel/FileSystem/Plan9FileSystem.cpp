@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/CommandLine.h>
 #include <Kernel/FileSystem/Plan9FileSystem.h>
 #include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -16,6 +18,7 @@ ErrorOr<NonnullLockRefPtr<FileSystem>> Plan9FS::try_create(OpenFileDescription&
 
 Plan9FS::Plan9FS(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
+    , m_attribute_cache_timeout(kernel_command_line().plan9fs_attribute_cache_timeout())
     , m_completion_blocker(*this)
 {
 }
@@ -324,7 +327,7 @@ StringView Plan9FS::Message::Decoder::read_data()
 
 Plan9FS::Message::Message(Plan9FS& fs, Type type)
     : m_builder(KBufferBuilder::try_create().release_value()) // FIXME: Don't assume KBufferBuilder allocation success.
-    , m_tag(fs.allocate_tag())
+    , m_tag(type == Type::Tversion ? no_tag : fs.allocate_tag())
     , m_type(type)
     , m_have_been_built(false)
 {
@@ -487,6 +490,17 @@ bool Plan9FS::is_complete(ReceiveCompletion const& completion)
     return true;
 }
 
+u16 Plan9FS::allocate_tag()
+{
+    MutexLocker locker(m_lock);
+    // Note: A tag can't be used again while we may still get a reply to it.
+    for (;;) {
+        auto tag = m_next_tag++;
+        if (tag != no_tag && !m_completions.contains(tag))
+            return tag;
+    }
+}
+
 ErrorOr<void> Plan9FS::post_message(Message& message, LockRefPtr<ReceiveCompletion> completion)
 {
     auto const& buffer = message.build();
@@ -582,10 +596,20 @@ ErrorOr<void> Plan9FS::post_message_and_explicitly_ignore_reply(Message& message
 
 ErrorOr<void> Plan9FS::post_message_and_wait_for_a_reply(Message& message)
 {
-    auto request_type = message.type();
-    auto tag = message.tag();
-    auto completion = adopt_lock_ref(*new ReceiveCompletion(tag));
+    auto completion = TRY(post_message_expecting_reply(message));
+    return wait_for_reply(message, move(completion));
+}
+
+ErrorOr<NonnullLockRefPtr<Plan9FS::ReceiveCompletion>> Plan9FS::post_message_expecting_reply(Message& message)
+{
+    auto completion = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) ReceiveCompletion(message.tag())));
     TRY(post_message(message, completion));
+    return completion;
+}
+
+ErrorOr<void> Plan9FS::wait_for_reply(Message& message, NonnullLockRefPtr<ReceiveCompletion> completion)
+{
+    auto request_type = message.type();
     if (Thread::current()->block<Plan9FS::Blocker>({}, *this, message, completion).was_interrupted())
         return EINTR;
 
@@ -722,53 +746,195 @@ ErrorOr<size_t> Plan9FSInode::read_bytes(off_t offset, size_t size, UserOrKernel
 {
     TRY(const_cast<Plan9FSInode&>(*this).ensure_open_for_mode(O_RDONLY));
 
-    size = fs().adjust_buffer_size(size);
-
-    Plan9FS::Message message { fs(), Plan9FS::Message::Type::Treadlink };
-    StringView data;
-
-    // Try readlink first.
-    bool readlink_succeeded = false;
-    if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L && offset == 0) {
+    // Try readlink first, unless we already know this isn't a symlink.
+    auto metadata = cached_metadata();
+    if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L && offset == 0 && (!metadata.has_value() || metadata->is_symlink())) {
+        Plan9FS::Message message { fs(), Plan9FS::Message::Type::Treadlink };
         message << fid();
         if (auto result = fs().post_message_and_wait_for_a_reply(message); !result.is_error()) {
-            readlink_succeeded = true;
+            StringView data;
             message >> data;
+            // Guard against the server returning more data than requested.
+            size_t nread = min(data.length(), fs().adjust_buffer_size(size));
+            TRY(buffer.write(data.characters_without_null_termination(), nread));
+            return nread;
+        }
+    }
+
+    MutexLocker locker(m_read_lock);
+    bool is_sequential = (u64)offset == m_next_sequential_offset;
+    if (m_readahead.has_value() && m_readahead->offset != (u64)offset)
+        m_readahead.clear();
+
+    size_t nread = 0;
+    bool reached_end_of_file = false;
+    if (m_readahead.has_value()) {
+        auto& readahead = m_readahead.value();
+        auto result = ErrorOr<void> {};
+        if (readahead.completion) {
+            result = fs().wait_for_reply(*readahead.message, readahead.completion.release_nonnull());
+            if (!result.is_error()) {
+                auto data = readahead.message->read_data();
+                // Guard against the server returning more data than requested.
+                readahead.data = data.substring_view(0, min(data.length(), readahead.requested_size));
+                readahead.reaches_end_of_file = readahead.data.length() < readahead.requested_size;
+            }
+        }
+        if (result.is_error()) {
+            // Note: Reading it again below will tell whether this was more than a fluke.
+            m_readahead.clear();
+        } else {
+            nread = min(size, readahead.data.length());
+            TRY(buffer.write(readahead.data.characters_without_null_termination(), nread));
+            readahead.data = readahead.data.substring_view(nread);
+            readahead.offset += nread;
+            if (readahead.data.is_empty()) {
+                reached_end_of_file = readahead.reaches_end_of_file;
+                m_readahead.clear();
+            }
+        }
+    }
+
+    if (nread < size && !reached_end_of_file) {
+        auto buffer_remaining = buffer.offset(nread);
+        auto nread_now = TRY(read_pipelined(offset + nread, size - nread, buffer_remaining));
+        reached_end_of_file = nread_now < size - nread;
+        nread += nread_now;
+    }
+
+    m_next_sequential_offset = offset + nread;
+    if (is_sequential && !reached_end_of_file && !m_readahead.has_value()) {
+        // Note: If we can't read ahead, the next read just won't be any faster.
+        auto readahead_size = fs().adjust_buffer_size(NumericLimits<u32>::max());
+        auto message = adopt_own_if_nonnull(new (nothrow) Plan9FS::Message { fs(), Plan9FS::Message::Type::Tread });
+        if (message) {
+            *message << fid() << (u64)(offset + nread) << (u32)readahead_size;
+            auto completion = fs().post_message_expecting_reply(*message);
+            if (!completion.is_error())
+                m_readahead = Readahead { offset + nread, readahead_size, move(message), completion.release_value(), {}, false };
         }
     }
+    return nread;
+}
 
-    if (!readlink_succeeded) {
-        message = Plan9FS::Message { fs(), Plan9FS::Message::Type::Tread };
-        message << fid() << (u64)offset << (u32)size;
-        TRY(fs().post_message_and_wait_for_a_reply(message));
-        data = message.read_data();
+ErrorOr<size_t> Plan9FSInode::read_pipelined(u64 offset, size_t size, UserOrKernelBuffer& buffer) const
+{
+    auto max_chunk_size = fs().adjust_buffer_size(size);
+    struct PendingRead {
+        size_t size;
+        NonnullOwnPtr<Plan9FS::Message> message;
+        NonnullLockRefPtr<Plan9FS::ReceiveCompletion> completion;
+    };
+    Vector<PendingRead, Plan9FS::max_pipelined_messages> pending_reads;
+    for (size_t position = 0; position < size && pending_reads.size() < Plan9FS::max_pipelined_messages; position += max_chunk_size) {
+        auto chunk_size = min(max_chunk_size, size - position);
+        auto message = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Plan9FS::Message { fs(), Plan9FS::Message::Type::Tread }));
+        *message << fid() << (u64)(offset + position) << (u32)chunk_size;
+        auto completion = fs().post_message_expecting_reply(*message);
+        if (completion.is_error()) {
+            if (pending_reads.is_empty())
+                return completion.release_error();
+            break;
+        }
+        pending_reads.append({ chunk_size, move(message), completion.release_value() });
     }
 
-    // Guard against the server returning more data than requested.
-    size_t nread = min(data.length(), size);
-    TRY(buffer.write(data.characters_without_null_termination(), nread));
+    size_t nread = 0;
+    for (size_t i = 0; i < pending_reads.size(); ++i) {
+        auto& pending_read = pending_reads[i];
+        auto result = fs().wait_for_reply(*pending_read.message, move(pending_read.completion));
+        if (result.is_error()) {
+            if (i == 0)
+                return result.release_error();
+            break;
+        }
+        auto data = pending_read.message->read_data();
+        // Guard against the server returning more data than requested.
+        auto chunk_nread = min(data.length(), pending_read.size);
+        TRY(buffer.write(data.characters_without_null_termination(), nread, chunk_nread));
+        nread += chunk_nread;
+        // Note: A short read means we are at the end of the file, so whatever comes after it is of no use.
+        if (chunk_nread < pending_read.size)
+            break;
+    }
     return nread;
 }
 
 ErrorOr<size_t> Plan9FSInode::write_bytes(off_t offset, size_t size, UserOrKernelBuffer const& data, OpenFileDescription*)
 {
     TRY(ensure_open_for_mode(O_WRONLY));
-    size = fs().adjust_buffer_size(size);
-
-    auto data_copy = TRY(data.try_copy_into_kstring(size)); // FIXME: this seems ugly
+    invalidate_cached_data();
+    return write_pipelined(offset, size, data);
+}
 
-    Plan9FS::Message message { fs(), Plan9FS::Message::Type::Twrite };
-    message << fid() << (u64)offset;
-    message.append_data(data_copy->view());
-    TRY(fs().post_message_and_wait_for_a_reply(message));
+ErrorOr<size_t> Plan9FSInode::write_pipelined(u64 offset, size_t size, UserOrKernelBuffer const& data)
+{
+    auto max_chunk_size = fs().adjust_buffer_size(size);
+    struct PendingWrite {
+        size_t size;
+        NonnullOwnPtr<Plan9FS::Message> message;
+        NonnullLockRefPtr<Plan9FS::ReceiveCompletion> completion;
+    };
+    Vector<PendingWrite, Plan9FS::max_pipelined_messages> pending_writes;
+    for (size_t position = 0; position < size && pending_writes.size() < Plan9FS::max_pipelined_messages; position += max_chunk_size) {
+        auto chunk_size = min(max_chunk_size, size - position);
+        auto data_copy = TRY(data.offset(position).try_copy_into_kstring(chunk_size)); // FIXME: this seems ugly
+        auto message = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Plan9FS::Message { fs(), Plan9FS::Message::Type::Twrite }));
+        *message << fid() << (u64)(offset + position);
+        message->append_data(data_copy->view());
+        auto completion = fs().post_message_expecting_reply(*message);
+        if (completion.is_error()) {
+            if (pending_writes.is_empty())
+                return completion.release_error();
+            break;
+        }
+        pending_writes.append({ chunk_size, move(message), completion.release_value() });
+    }
 
-    u32 nwritten;
-    message >> nwritten;
+    size_t nwritten = 0;
+    for (size_t i = 0; i < pending_writes.size(); ++i) {
+        auto& pending_write = pending_writes[i];
+        auto result = fs().wait_for_reply(*pending_write.message, move(pending_write.completion));
+        if (result.is_error()) {
+            if (i == 0)
+                return result.release_error();
+            break;
+        }
+        u32 chunk_nwritten;
+        *pending_write.message >> chunk_nwritten;
+        nwritten += min<size_t>(chunk_nwritten, pending_write.size);
+        // Note: Whatever was written after a short write leaves a hole, but we can't take it back anymore.
+        if (chunk_nwritten < pending_write.size)
+            break;
+    }
     return nwritten;
 }
 
+Optional<InodeMetadata> Plan9FSInode::cached_metadata() const
+{
+    SpinlockLocker locker(m_metadata_lock);
+    if (!m_cached_metadata.has_value())
+        return {};
+    if (TimeManagement::the().monotonic_time(TimePrecision::Coarse) - m_cached_metadata_time >= fs().attribute_cache_timeout())
+        return {};
+    return m_cached_metadata;
+}
+
+void Plan9FSInode::invalidate_cached_data()
+{
+    {
+        SpinlockLocker locker(m_metadata_lock);
+        m_cached_metadata.clear();
+    }
+    MutexLocker locker(m_read_lock);
+    m_readahead.clear();
+}
+
 InodeMetadata Plan9FSInode::metadata() const
 {
+    if (auto metadata = cached_metadata(); metadata.has_value())
+        return metadata.release_value();
+
     InodeMetadata metadata;
     metadata.inode = identifier();
 
@@ -819,6 +985,9 @@ InodeMetadata Plan9FSInode::metadata() const
         metadata.block_count = blocks;
     }
 
+    SpinlockLocker locker(m_metadata_lock);
+    m_cached_metadata = metadata;
+    m_cached_metadata_time = TimeManagement::the().monotonic_time(TimePrecision::Coarse);
     return metadata;
 }
 
@@ -934,6 +1103,7 @@ ErrorOr<void> Plan9FSInode::chown(UserID, GroupID)
 
 ErrorOr<void> Plan9FSInode::truncate(u64 new_size)
 {
+    invalidate_cached_data();
     if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L) {
         Plan9FS::Message message { fs(), Plan9FS::Message::Type::Tsetattr };
         SetAttrMask valid = SetAttrMask::Size;
@@ -28,9 +28,15 @@ public:
 
     virtual Inode& root_inode() override;
 
-    u16 allocate_tag() { return m_next_tag++; }
+    u16 allocate_tag();
     u32 allocate_fid() { return m_next_fid++; }
 
+    // Note: This tag is reserved for Tversion, which is sent before anything else.
+    static constexpr u16 no_tag = 0xffff;
+
+    // Large reads and writes are split into this many messages at most, which are all in flight at the same time.
+    static constexpr size_t max_pipelined_messages = 8;
+
     enum class ProtocolVersion {
         v9P2000,
         v9P2000u,
@@ -121,19 +127,25 @@ private:
     ErrorOr<void> read_and_dispatch_one_message();
     ErrorOr<void> post_message_and_wait_for_a_reply(Message&);
     ErrorOr<void> post_message_and_explicitly_ignore_reply(Message&);
+    // Note: These let callers have several messages in flight, and wait for the replies afterwards.
+    ErrorOr<NonnullLockRefPtr<ReceiveCompletion>> post_message_expecting_reply(Message&);
+    ErrorOr<void> wait_for_reply(Message&, NonnullLockRefPtr<ReceiveCompletion>);
 
     ProtocolVersion parse_protocol_version(StringView) const;
     size_t adjust_buffer_size(size_t size) const;
+    Time attribute_cache_timeout() const { return m_attribute_cache_timeout; }
 
     void thread_main();
     void ensure_thread();
 
     LockRefPtr<Plan9FSInode> m_root_inode;
-    Atomic<u16> m_next_tag { (u16)-1 };
+    u16 m_next_tag { 0 };
     Atomic<u32> m_next_fid { 1 };
 
     ProtocolVersion m_remote_protocol_version { ProtocolVersion::v9P2000 };
-    size_t m_max_message_size { 4 * KiB };
+    // Note: This is what we ask for, the server may settle on less.
+    size_t m_max_message_size { 512 * KiB };
+    Time const m_attribute_cache_timeout;
 
     Mutex m_send_lock { "Plan9FS send"sv };
     Plan9FSBlockerSet m_completion_blocker;
@@ -208,6 +220,31 @@ private:
     int m_open_mode { 0 };
     ErrorOr<void> ensure_open_for_mode(int mode);
 
+    ErrorOr<size_t> read_pipelined(u64 offset, size_t size, UserOrKernelBuffer&) const;
+    ErrorOr<size_t> write_pipelined(u64 offset, size_t size, UserOrKernelBuffer const&);
+
+    Optional<InodeMetadata> cached_metadata() const;
+    void invalidate_cached_data();
+
+    // Note: When a read continues where the previous one left off, the next chunk of the file is requested right away,
+    // and the reads after it are served from that chunk for as long as it lasts.
+    struct Readahead {
+        u64 offset { 0 };
+        size_t requested_size { 0 };
+        OwnPtr<Plan9FS::Message> message;
+        // Note: This is null once the reply came in, and the data is what is left of it.
+        LockRefPtr<Plan9FS::ReceiveCompletion> completion;
+        StringView data;
+        bool reaches_end_of_file { false };
+    };
+    mutable Mutex m_read_lock { "Plan9FSInode read"sv };
+    mutable Optional<Readahead> m_readahead;
+    mutable u64 m_next_sequential_offset { 0 };
+
+    mutable Spinlock m_metadata_lock { LockRank::None };
+    mutable Optional<InodeMetadata> m_cached_metadata;
+    mutable Time m_cached_metadata_time;
+
     Plan9FS& fs() { return reinterpret_cast<Plan9FS&>(Inode::fs()); }
     Plan9FS& fs() const
     {
@@ -8,6 +8,7 @@
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Storage/DeviceAttribute.h>
+#include <Kernel/KBufferBuilder.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -21,6 +22,10 @@ StringView StorageDeviceAttributeSysFSComponent::name() const
         return "sector_size"sv;
     case Type::CommandSet:
         return "command_set"sv;
+    case Type::IOScheduler:
+        return "io_scheduler"sv;
+    case Type::LatencyHistogram:
+        return "latency_histogram"sv;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -63,6 +68,17 @@ ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_gen
     case Type::CommandSet:
         value = TRY(KString::formatted("{}", m_device->command_set_to_string_view()));
         break;
+    case Type::IOScheduler:
+        value = TRY(KString::formatted("{}", m_device->io_scheduler().policy_name()));
+        break;
+    case Type::LatencyHistogram: {
+        auto builder = TRY(KBufferBuilder::try_create());
+        TRY(m_device->io_scheduler().try_generate_latency_histogram(builder));
+        auto buffer = builder.build();
+        if (!buffer)
+            return ENOMEM;
+        return buffer.release_nonnull();
+    }
     default:
         VERIFY_NOT_REACHED();
     }
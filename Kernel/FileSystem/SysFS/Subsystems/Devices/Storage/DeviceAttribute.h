@@ -18,6 +18,8 @@ public:
         EndLBA,
         SectorSize,
         CommandSet,
+        IOScheduler,
+        LatencyHistogram,
     };
 
 public:
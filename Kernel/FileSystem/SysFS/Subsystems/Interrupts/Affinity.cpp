@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <Kernel/Arch/CPU.h>
+#include <Kernel/Arch/InterruptManagement.h>
+#include <Kernel/Arch/Interrupts.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Interrupts/Affinity.h>
+#include <Kernel/Interrupts/GenericInterruptHandler.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+mode_t InterruptAffinityNode::permissions() const
+{
+    return S_IRUSR | S_IRGRP | S_IROTH | S_IWUSR;
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<InterruptAffinityNode> InterruptAffinityNode::must_create(InterruptsSysFSDirectory& interrupts_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) InterruptAffinityNode(interrupts_directory)).release_nonnull();
+}
+
+UNMAP_AFTER_INIT InterruptAffinityNode::InterruptAffinityNode(InterruptsSysFSDirectory&)
+    : SysFSComponent()
+{
+}
+
+ErrorOr<void> InterruptAffinityNode::truncate(u64 size)
+{
+    // Note: This node doesn't store anything, so truncating it to zero is simply ignored.
+    if (size != 0)
+        return EPERM;
+    return {};
+}
+
+ErrorOr<size_t> InterruptAffinityNode::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription*) const
+{
+    auto blob = TRY(try_to_generate_buffer());
+
+    if ((size_t)offset >= blob->size())
+        return 0;
+
+    ssize_t nread = min(static_cast<off_t>(blob->size() - offset), static_cast<off_t>(count));
+    TRY(buffer.write(blob->data() + offset, nread));
+    return nread;
+}
+
+ErrorOr<NonnullOwnPtr<KBuffer>> InterruptAffinityNode::try_to_generate_buffer() const
+{
+    auto builder = TRY(KBufferBuilder::try_create());
+    for (size_t interrupt_number = 0; interrupt_number < GENERIC_INTERRUPT_HANDLERS_COUNT; ++interrupt_number) {
+        auto& handler = GenericInterruptHandler::from(interrupt_number);
+        if (handler.type() == HandlerType::UnhandledInterruptHandler)
+            continue;
+        auto controller = InterruptManagement::the().get_responsible_irq_controller(interrupt_number);
+        TRY(builder.appendff("{} {}\n", interrupt_number, controller->destination_processor(handler)));
+    }
+    auto buffer = builder.build();
+    if (!buffer)
+        return ENOMEM;
+    return buffer.release_nonnull();
+}
+
+ErrorOr<size_t> InterruptAffinityNode::write_bytes(off_t offset, size_t count, UserOrKernelBuffer const& data, OpenFileDescription*)
+{
+    if (offset > 0)
+        return EINVAL;
+
+    char buffer[32];
+    if (count > sizeof(buffer))
+        return EINVAL;
+    TRY(data.read(buffer, count));
+
+    auto parts = StringView { buffer, count }.trim_whitespace().split_view(' ');
+    if (parts.size() != 2)
+        return EINVAL;
+    auto interrupt_number = parts[0].to_uint();
+    auto processor = parts[1].to_uint();
+    if (!interrupt_number.has_value() || !processor.has_value() || interrupt_number.value() >= GENERIC_INTERRUPT_HANDLERS_COUNT)
+        return EINVAL;
+
+    auto& handler = GenericInterruptHandler::from(interrupt_number.value());
+    if (handler.type() == HandlerType::UnhandledInterruptHandler)
+        return ENOENT;
+    auto controller = InterruptManagement::the().get_responsible_irq_controller(interrupt_number.value());
+    TRY(controller->set_destination_processor(handler, processor.value()));
+    return count;
+}
+
+}
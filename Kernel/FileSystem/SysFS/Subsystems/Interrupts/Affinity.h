@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/FileSystem/SysFS.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Interrupts/Directory.h>
+#include <Kernel/KBuffer.h>
+
+namespace Kernel {
+
+// Lists which processor handles every interrupt line, one "<interrupt line> <processor>" pair per line.
+// Writing such a pair sends that interrupt line to another processor.
+class InterruptAffinityNode final : public SysFSComponent {
+public:
+    virtual StringView name() const override { return "affinity"sv; }
+    static NonnullLockRefPtr<InterruptAffinityNode> must_create(InterruptsSysFSDirectory&);
+    virtual mode_t permissions() const override;
+    virtual ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer&, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const&, OpenFileDescription*) override;
+    virtual ErrorOr<void> truncate(u64) override;
+
+private:
+    explicit InterruptAffinityNode(InterruptsSysFSDirectory&);
+
+    ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_buffer() const;
+};
+
+}
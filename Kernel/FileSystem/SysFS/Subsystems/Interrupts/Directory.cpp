@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Registry.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Interrupts/Affinity.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Interrupts/Directory.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void InterruptsSysFSDirectory::initialize()
+{
+    auto interrupts_directory = adopt_lock_ref_if_nonnull(new (nothrow) InterruptsSysFSDirectory()).release_nonnull();
+    SysFSComponentRegistry::the().register_new_component(interrupts_directory);
+    interrupts_directory->create_components();
+}
+
+UNMAP_AFTER_INIT void InterruptsSysFSDirectory::create_components()
+{
+    MUST(m_child_components.with([&](auto& list) -> ErrorOr<void> {
+        list.append(InterruptAffinityNode::must_create(*this));
+        return {};
+    }));
+}
+
+UNMAP_AFTER_INIT InterruptsSysFSDirectory::InterruptsSysFSDirectory()
+    : SysFSDirectory(SysFSComponentRegistry::the().root_directory())
+{
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS.h>
+
+namespace Kernel {
+
+class InterruptsSysFSDirectory : public SysFSDirectory {
+public:
+    virtual StringView name() const override { return "interrupts"sv; }
+    static void initialize();
+
+    void create_components();
+
+private:
+    InterruptsSysFSDirectory();
+};
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/FileSystem/TmpFS.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
 #include <LibC/limits.h>
 
@@ -87,22 +88,109 @@ ErrorOr<void> TmpFSInode::traverse_as_directory(Function<ErrorOr<void>(FileSyste
     return {};
 }
 
+ErrorOr<NonnullOwnPtr<TmpFSInode::DataBlock>> TmpFSInode::DataBlock::try_create()
+{
+    // NOTE: Nothing is committed up front, the pages of the block are allocated by allocate_pages() as they are written to.
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(block_size, AllocationStrategy::None));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, block_size, "TmpFSInode: Content"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_own_or_enomem(new (nothrow) DataBlock(move(vmobject), move(region)));
+}
+
+TmpFSInode::DataBlock::DataBlock(NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+}
+
+ErrorOr<void> TmpFSInode::DataBlock::allocate_pages(size_t offset, size_t size)
+{
+    auto first_page_index = offset / PAGE_SIZE;
+    auto last_page_index = (offset + size - 1) / PAGE_SIZE;
+    return m_vmobject->allocate_pages(first_page_index, last_page_index - first_page_index + 1);
+}
+
+void TmpFSInode::DataBlock::release_pages(size_t offset)
+{
+    VERIFY(offset % PAGE_SIZE == 0);
+    m_vmobject->release_pages(offset / PAGE_SIZE, (block_size - offset) / PAGE_SIZE);
+}
+
+// Calls `callback(block_index, offset_in_block, offset_in_range, size)` for each part of the range that falls into a different block.
+template<typename Callback>
+ErrorOr<void> TmpFSInode::for_each_block_in_range(size_t offset, size_t size, Callback callback) const
+{
+    size_t done = 0;
+    while (done < size) {
+        auto block_index = (offset + done) / DataBlock::block_size;
+        auto offset_in_block = (offset + done) % DataBlock::block_size;
+        auto size_in_block = min(size - done, DataBlock::block_size - offset_in_block);
+        TRY(callback(block_index, offset_in_block, done, size_in_block));
+        done += size_in_block;
+    }
+    return {};
+}
+
+ErrorOr<void> TmpFSInode::read_from_content(size_t offset, size_t size, UserOrKernelBuffer& buffer) const
+{
+    return for_each_block_in_range(offset, size, [&](size_t block_index, size_t offset_in_block, size_t offset_in_range, size_t size_in_block) -> ErrorOr<void> {
+        auto const* block = block_index < m_blocks.size() ? m_blocks[block_index].ptr() : nullptr;
+        if (!block)
+            return buffer.memset(0, offset_in_range, size_in_block);
+        return buffer.write(block->data() + offset_in_block, offset_in_range, size_in_block);
+    });
+}
+
+ErrorOr<void> TmpFSInode::write_to_content(size_t offset, size_t size, UserOrKernelBuffer const& buffer)
+{
+    if (size == 0)
+        return {};
+    auto last_block_index = (offset + size - 1) / DataBlock::block_size;
+    if (last_block_index >= m_blocks.size())
+        TRY(m_blocks.try_resize(last_block_index + 1));
+
+    return for_each_block_in_range(offset, size, [&](size_t block_index, size_t offset_in_block, size_t offset_in_range, size_t size_in_block) -> ErrorOr<void> {
+        auto& block = m_blocks[block_index];
+        if (!block)
+            block = TRY(DataBlock::try_create());
+        TRY(block->allocate_pages(offset_in_block, size_in_block));
+        return buffer.read(block->data() + offset_in_block, offset_in_range, size_in_block);
+    });
+}
+
+// Drops the blocks past the new end of the file, and zeroes the tail of the last one,
+// so that whatever is beyond the end of the file always reads back as zeroes.
+ErrorOr<void> TmpFSInode::truncate_content(size_t size)
+{
+    auto block_count = ceil_div(size, DataBlock::block_size);
+    if (block_count < m_blocks.size())
+        m_blocks.shrink(block_count);
+
+    auto offset_in_block = size % DataBlock::block_size;
+    if (offset_in_block == 0 || block_count > m_blocks.size() || !m_blocks[block_count - 1])
+        return {};
+    auto& block = *m_blocks[block_count - 1];
+    auto end_of_page = round_up_to_power_of_two(offset_in_block, PAGE_SIZE);
+    block.release_pages(end_of_page);
+    if (end_of_page == offset_in_block)
+        return {};
+    TRY(block.allocate_pages(offset_in_block, end_of_page - offset_in_block));
+    memset(block.data() + offset_in_block, 0, end_of_page - offset_in_block);
+    return {};
+}
+
 ErrorOr<size_t> TmpFSInode::read_bytes(off_t offset, size_t size, UserOrKernelBuffer& buffer, OpenFileDescription*) const
 {
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
     VERIFY(!is_directory());
     VERIFY(offset >= 0);
 
-    if (!m_content)
-        return 0;
-
     if (offset >= m_metadata.size)
         return 0;
 
     if (static_cast<off_t>(size) > m_metadata.size - offset)
         size = m_metadata.size - offset;
 
-    TRY(buffer.write(m_content->data() + offset, size));
+    TRY(read_from_content(offset, size, buffer));
     return size;
 }
 
@@ -117,32 +205,16 @@ ErrorOr<size_t> TmpFSInode::write_bytes(off_t offset, size_t size, UserOrKernelB
     if (static_cast<off_t>(offset + size) > new_size)
         new_size = offset + size;
 
-    if (static_cast<u64>(new_size) > (NumericLimits<size_t>::max() / 2)) // on 32-bit, size_t might be 32 bits while off_t is 64 bits
-        return ENOMEM;                                                   // we won't be able to resize to this capacity
+    if (static_cast<u64>(new_size) > NumericLimits<size_t>::max()) // on 32-bit, size_t might be 32 bits while off_t is 64 bits
+        return ENOMEM;
+
+    TRY(write_to_content(offset, size, buffer)); // TODO: partial reads?
 
     if (new_size > old_size) {
-        if (m_content && static_cast<off_t>(m_content->capacity()) >= new_size) {
-            m_content->set_size(new_size);
-        } else {
-            // Grow the content buffer 2x the new size to accommodate repeating write() calls.
-            // Note that we're not actually committing physical memory to the buffer
-            // until it's needed. We only grow VM here.
-
-            // FIXME: Fix this so that no memcpy() is necessary, and we can just grow the
-            //        KBuffer and it will add physical pages as needed while keeping the
-            //        existing ones.
-            auto tmp = TRY(KBuffer::try_create_with_size("TmpFSInode: Content"sv, new_size * 2));
-            tmp->set_size(new_size);
-            if (m_content)
-                memcpy(tmp->data(), m_content->data(), old_size);
-            m_content = move(tmp);
-        }
         m_metadata.size = new_size;
         set_metadata_dirty(true);
     }
 
-    TRY(buffer.read(m_content->data() + offset, size)); // TODO: partial reads?
-
     did_modify_contents();
     return size;
 }
@@ -280,21 +352,10 @@ ErrorOr<void> TmpFSInode::truncate(u64 size)
     MutexLocker locker(m_inode_lock);
     VERIFY(!is_directory());
 
-    if (size == 0)
-        m_content.clear();
-    else if (!m_content) {
-        m_content = TRY(KBuffer::try_create_with_size("TmpFSInode: Content"sv, size));
-    } else if (static_cast<size_t>(size) < m_content->capacity()) {
-        size_t prev_size = m_metadata.size;
-        m_content->set_size(size);
-        if (prev_size < static_cast<size_t>(size))
-            memset(m_content->data() + prev_size, 0, size - prev_size);
-    } else {
-        size_t prev_size = m_metadata.size;
-        auto tmp = TRY(KBuffer::try_create_with_size("TmpFSInode: Content"sv, size));
-        memcpy(tmp->data(), m_content->data(), prev_size);
-        m_content = move(tmp);
-    }
+    if (size > NumericLimits<size_t>::max())
+        return ENOMEM;
+    if (size < static_cast<u64>(m_metadata.size))
+        TRY(truncate_content(size));
 
     m_metadata.size = size;
     set_metadata_dirty(true);
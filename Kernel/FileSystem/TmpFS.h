@@ -8,7 +8,7 @@
 
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
-#include <Kernel/KBuffer.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
 
 namespace Kernel {
 
@@ -25,6 +25,7 @@ public:
     virtual StringView class_name() const override { return "TmpFS"sv; }
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_path_lookup_cache() const override { return true; }
 
     virtual Inode& root_inode() override;
 
@@ -75,10 +76,39 @@ private:
 
     Child* find_child_by_name(StringView);
 
+    // File contents are kept in fixed-size blocks of anonymous memory, which only get physical pages once they're written to.
+    class DataBlock {
+    public:
+        static constexpr size_t block_size = 128 * KiB;
+
+        static ErrorOr<NonnullOwnPtr<DataBlock>> try_create();
+
+        // Backs the given range with physical pages, which has to happen before it's written to.
+        ErrorOr<void> allocate_pages(size_t offset, size_t size);
+        // Gives back the pages from the given page-aligned offset to the end of the block, which then read back as zeroes.
+        void release_pages(size_t offset);
+
+        u8* data() { return m_region->vaddr().as_ptr(); }
+        u8 const* data() const { return m_region->vaddr().as_ptr(); }
+
+    private:
+        DataBlock(NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+        NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+        NonnullOwnPtr<Memory::Region> m_region;
+    };
+
+    template<typename Callback>
+    ErrorOr<void> for_each_block_in_range(size_t offset, size_t size, Callback) const;
+    ErrorOr<void> read_from_content(size_t offset, size_t size, UserOrKernelBuffer&) const;
+    ErrorOr<void> write_to_content(size_t offset, size_t size, UserOrKernelBuffer const&);
+    ErrorOr<void> truncate_content(size_t size);
+
     InodeMetadata m_metadata;
     LockWeakPtr<TmpFSInode> m_parent;
 
-    OwnPtr<KBuffer> m_content;
+    // Blocks that were never written to are null, and read back as zeroes.
+    Vector<OwnPtr<DataBlock>> m_blocks;
 
     Child::List m_children;
 };
@@ -7,6 +7,7 @@
 #include <AK/AnyOf.h>
 #include <AK/GenericLexer.h>
 #include <AK/RefPtr.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/StringBuilder.h>
 #include <Kernel/API/POSIX/errno.h>
@@ -14,6 +15,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/CustodyCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -51,47 +53,49 @@ InodeIdentifier VirtualFileSystem::root_inode_id() const
     return m_root_inode->identifier();
 }
 
-bool VirtualFileSystem::mount_point_exists_at_inode(InodeIdentifier inode_identifier)
+static bool mount_point_exists_at_inode(Vector<NonnullOwnPtr<Mount>, 16> const& mounts, InodeIdentifier inode_identifier)
 {
-    return m_mounts.with([&](auto& mounts) -> bool {
-        return any_of(mounts, [&inode_identifier](auto const& existing_mount) {
-            return existing_mount->host() && existing_mount->host()->identifier() == inode_identifier;
-        });
+    return any_of(mounts, [&inode_identifier](auto const& existing_mount) {
+        return existing_mount->host() && existing_mount->host()->identifier() == inode_identifier;
     });
 }
 
 ErrorOr<void> VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(fs, &mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with_exclusive([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: Mounting {} at inode {} with flags {}",
             fs.class_name(),
             inode.identifier(),
             flags);
-        if (mount_point_exists_at_inode(inode.identifier())) {
+        if (mount_point_exists_at_inode(mounts, inode.identifier())) {
             dbgln("VirtualFileSystem: Mounting unsuccessful - inode {} is already a mount-point.", inode.identifier());
             return EBUSY;
         }
         mounts.append(move(new_mount));
         return {};
-    });
+    }));
+    CustodyCache::the().invalidate_all();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::bind_mount(Custody& source, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(source.inode(), mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with_exclusive([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: Bind-mounting inode {} at inode {}", source.inode().identifier(), inode.identifier());
-        if (mount_point_exists_at_inode(inode.identifier())) {
+        if (mount_point_exists_at_inode(mounts, inode.identifier())) {
             dbgln("VirtualFileSystem: Bind-mounting unsuccessful - inode {} is already a mount-point.",
                 mount_point.inode().identifier());
             return EBUSY;
         }
         mounts.append(move(new_mount));
         return {};
-    });
+    }));
+    CustodyCache::the().invalidate_all();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
@@ -103,6 +107,7 @@ ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
         return ENODEV;
 
     mount->set_flags(new_flags);
+    CustodyCache::the().invalidate_all();
     return {};
 }
 
@@ -110,7 +115,10 @@ ErrorOr<void> VirtualFileSystem::unmount(Inode& guest_inode)
 {
     dbgln("VirtualFileSystem: unmount called with inode {}", guest_inode.identifier());
 
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    // NOTE: The cache holds on to inodes, which would keep the file system busy.
+    CustodyCache::the().invalidate_all();
+
+    return m_mounts.with_exclusive([&](auto& mounts) -> ErrorOr<void> {
         for (size_t i = 0; i < mounts.size(); ++i) {
             auto& mount = mounts[i];
             if (&mount->guest() != &guest_inode)
@@ -144,7 +152,7 @@ ErrorOr<void> VirtualFileSystem::mount_root(FileSystem& fs)
     auto pseudo_path = TRY(static_cast<FileBackedFileSystem&>(fs).file_description().pseudo_path());
     dmesgln("VirtualFileSystem: mounted root from {} ({})", fs.class_name(), pseudo_path);
 
-    m_mounts.with([&](auto& mounts) {
+    m_mounts.with_exclusive([&](auto& mounts) {
         mounts.append(move(new_mount));
     });
 
@@ -157,10 +165,11 @@ ErrorOr<void> VirtualFileSystem::mount_root(FileSystem& fs)
 
 auto VirtualFileSystem::find_mount_for_host(InodeIdentifier id) -> Mount*
 {
-    return m_mounts.with([&](auto& mounts) -> Mount* {
+    return m_mounts.with_shared([&](auto const& mounts) -> Mount* {
         for (auto& mount : mounts) {
+            // NOTE: m_mounts only protects the list, not the Mounts in it.
             if (mount->host() && mount->host()->identifier() == id)
-                return mount.ptr();
+                return const_cast<Mount*>(mount.ptr());
         }
         return nullptr;
     });
@@ -168,10 +177,10 @@ auto VirtualFileSystem::find_mount_for_host(InodeIdentifier id) -> Mount*
 
 auto VirtualFileSystem::find_mount_for_guest(InodeIdentifier id) -> Mount*
 {
-    return m_mounts.with([&](auto& mounts) -> Mount* {
+    return m_mounts.with_shared([&](auto const& mounts) -> Mount* {
         for (auto& mount : mounts) {
             if (mount->guest().identifier() == id)
-                return mount.ptr();
+                return const_cast<Mount*>(mount.ptr());
         }
         return nullptr;
     });
@@ -349,6 +358,7 @@ ErrorOr<void> VirtualFileSystem::mknod(Credentials const& credentials, StringVie
 
     auto basename = KLexicalPath::basename(path);
     dbgln_if(VFS_DEBUG, "VirtualFileSystem::mknod: '{}' mode={} dev={} in {}", basename, mode, dev, parent_inode.identifier());
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
     (void)TRY(parent_inode.create_child(basename, mode, dev, credentials.euid(), credentials.egid()));
     return {};
 }
@@ -375,6 +385,7 @@ ErrorOr<NonnullLockRefPtr<OpenFileDescription>> VirtualFileSystem::create(Creden
     auto uid = owner.has_value() ? owner.value().uid : credentials.euid();
     auto gid = owner.has_value() ? owner.value().gid : credentials.egid();
 
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
     auto inode = TRY(parent_inode.create_child(basename, mode, 0, uid, gid));
     auto custody = TRY(Custody::try_create(&parent_custody, basename, inode, parent_custody.mount_flags()));
 
@@ -416,6 +427,7 @@ ErrorOr<void> VirtualFileSystem::mkdir(Credentials const& credentials, StringVie
 
     auto basename = KLexicalPath::basename(path);
     dbgln_if(VFS_DEBUG, "VirtualFileSystem::mkdir: '{}' in {}", basename, parent_inode.identifier());
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
     (void)TRY(parent_inode.create_child(basename, S_IFDIR | mode, 0, credentials.euid(), credentials.egid()));
     return {};
 }
@@ -541,6 +553,11 @@ ErrorOr<void> VirtualFileSystem::rename(Credentials const& credentials, StringVi
     if (old_basename == new_basename && old_parent_inode.index() == new_parent_inode.index())
         return {};
 
+    ScopeGuard invalidate_cached_lookups = [&] {
+        CustodyCache::the().invalidate(old_parent_inode, old_basename);
+        CustodyCache::the().invalidate(new_parent_inode, new_basename);
+    };
+
     if (!new_custody_or_error.is_error()) {
         auto& new_custody = *new_custody_or_error.value();
         auto& new_inode = new_custody.inode();
@@ -649,7 +666,9 @@ ErrorOr<void> VirtualFileSystem::link(Credentials const& credentials, StringView
     if (!hard_link_allowed(credentials, old_inode))
         return EPERM;
 
-    return parent_inode.add_child(old_inode, KLexicalPath::basename(new_path), old_inode.mode());
+    auto new_basename = KLexicalPath::basename(new_path);
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, new_basename); };
+    return parent_inode.add_child(old_inode, new_basename, old_inode.mode());
 }
 
 ErrorOr<void> VirtualFileSystem::unlink(Credentials const& credentials, StringView path, Custody& base)
@@ -678,7 +697,9 @@ ErrorOr<void> VirtualFileSystem::unlink(Credentials const& credentials, StringVi
     if (parent_custody->is_readonly())
         return EROFS;
 
-    return parent_inode.remove_child(KLexicalPath::basename(path));
+    auto basename = KLexicalPath::basename(path);
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
+    return parent_inode.remove_child(basename);
 }
 
 ErrorOr<void> VirtualFileSystem::symlink(Credentials const& credentials, StringView target, StringView linkpath, Custody& base)
@@ -700,6 +721,7 @@ ErrorOr<void> VirtualFileSystem::symlink(Credentials const& credentials, StringV
     auto basename = KLexicalPath::basename(linkpath);
     dbgln_if(VFS_DEBUG, "VirtualFileSystem::symlink: '{}' (-> '{}') in {}", basename, target, parent_inode.identifier());
 
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
     auto inode = TRY(parent_inode.create_child(basename, S_IFLNK | 0644, 0, credentials.euid(), credentials.egid()));
 
     auto target_buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>((u8 const*)target.characters_without_null_termination()));
@@ -747,15 +769,18 @@ ErrorOr<void> VirtualFileSystem::rmdir(Credentials const& credentials, StringVie
     if (custody->is_readonly())
         return EROFS;
 
+    auto basename = KLexicalPath::basename(path);
+    ScopeGuard invalidate_cached_lookup = [&] { CustodyCache::the().invalidate(parent_inode, basename); };
+
     TRY(inode.remove_child("."sv));
     TRY(inode.remove_child(".."sv));
 
-    return parent_inode.remove_child(KLexicalPath::basename(path));
+    return parent_inode.remove_child(basename);
 }
 
 ErrorOr<void> VirtualFileSystem::for_each_mount(Function<ErrorOr<void>(Mount const&)> callback) const
 {
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    return m_mounts.with_shared([&](auto const& mounts) -> ErrorOr<void> {
         for (auto& mount : mounts)
             TRY(callback(*mount));
         return {};
@@ -767,6 +792,11 @@ void VirtualFileSystem::sync()
     FileSystem::sync();
 }
 
+void VirtualFileSystem::writeback()
+{
+    FileSystem::writeback();
+}
+
 NonnullRefPtr<Custody> VirtualFileSystem::root_custody()
 {
     return m_root_custody.with([](auto& root_custody) -> NonnullRefPtr<Custody> { return *root_custody; });
@@ -928,31 +958,48 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
             continue;
         }
 
-        // Okay, let's look up this part.
-        auto child_or_error = parent.inode().lookup(part);
-        if (child_or_error.is_error()) {
+        auto signal_missing_child = [&] {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
                 // we found the immediate parent of the file, but the file itself
                 // does not exist yet.
                 *out_parent = have_more_parts ? nullptr : &parent;
             }
-            return child_or_error.release_error();
-        }
-        auto child_inode = child_or_error.release_value();
+        };
 
-        int mount_flags_for_child = parent.mount_flags();
+        auto cached = CustodyCache::the().lookup(parent, part);
+        if (cached.is_cached) {
+            if (!cached.custody) {
+                signal_missing_child();
+                return ENOENT;
+            }
+            custody = cached.custody.release_nonnull();
+        } else {
+            // Okay, let's look up this part.
+            auto child_or_error = parent.inode().lookup(part);
+            if (child_or_error.is_error()) {
+                if (child_or_error.error().code() == ENOENT)
+                    CustodyCache::the().add(parent, part, nullptr, cached.generation);
+                signal_missing_child();
+                return child_or_error.release_error();
+            }
+            auto child_inode = child_or_error.release_value();
 
-        // See if there's something mounted on the child; in that case
-        // we would need to return the guest inode, not the host inode.
-        if (auto mount = find_mount_for_host(child_inode->identifier())) {
-            child_inode = mount->guest();
-            mount_flags_for_child = mount->flags();
-        }
+            int mount_flags_for_child = parent.mount_flags();
 
-        custody = TRY(Custody::try_create(&parent, part, *child_inode, mount_flags_for_child));
+            // See if there's something mounted on the child; in that case
+            // we would need to return the guest inode, not the host inode.
+            if (auto mount = find_mount_for_host(child_inode->identifier())) {
+                child_inode = mount->guest();
+                mount_flags_for_child = mount->flags();
+            }
+
+            custody = TRY(Custody::try_create(&parent, part, *child_inode, mount_flags_for_child));
+            CustodyCache::the().add(parent, part, custody, cached.generation);
+        }
 
-        if (child_inode->metadata().is_symlink()) {
+        auto& child_inode = custody->inode();
+        if (child_inode.metadata().is_symlink()) {
             if (!have_more_parts) {
                 if (options & O_NOFOLLOW)
                     return ELOOP;
@@ -960,12 +1007,12 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
                     break;
             }
 
-            if (!safe_to_follow_symlink(credentials, *child_inode, parent_metadata))
+            if (!safe_to_follow_symlink(credentials, child_inode, parent_metadata))
                 return EACCES;
 
             TRY(validate_path_against_process_veil(*custody, options));
 
-            auto symlink_target = TRY(child_inode->resolve_as_link(credentials, parent, out_parent, options, symlink_recursion_level + 1));
+            auto symlink_target = TRY(child_inode.resolve_as_link(credentials, parent, out_parent, options, symlink_recursion_level + 1));
             if (!have_more_parts)
                 return symlink_target;
 
@@ -19,6 +19,7 @@
 #include <Kernel/FileSystem/UnveilNode.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/LockRefPtr.h>
+#include <Kernel/Locking/RWSpinlockProtected.h>
 #include <Kernel/Locking/SpinlockProtected.h>
 
 namespace Kernel {
@@ -74,6 +75,7 @@ public:
     InodeIdentifier root_inode_id() const;
 
     static void sync();
+    static void writeback();
 
     NonnullRefPtr<Custody> root_custody();
     ErrorOr<NonnullRefPtr<Custody>> resolve_path(Credentials const&, StringView path, NonnullRefPtr<Custody> base, RefPtr<Custody>* out_parent = nullptr, int options = 0, int symlink_recursion_level = 0);
@@ -90,8 +92,6 @@ private:
 
     ErrorOr<void> traverse_directory_inode(Inode&, Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>);
 
-    bool mount_point_exists_at_inode(InodeIdentifier inode);
-
     // FIXME: These functions are totally unsafe as someone could unmount the returned Mount underneath us.
     Mount* find_mount_for_host(InodeIdentifier);
     Mount* find_mount_for_guest(InodeIdentifier);
@@ -100,7 +100,7 @@ private:
 
     SpinlockProtected<RefPtr<Custody>> m_root_custody;
 
-    SpinlockProtected<Vector<NonnullOwnPtr<Mount>, 16>> m_mounts { LockRank::None };
+    RWSpinlockProtected<Vector<NonnullOwnPtr<Mount>, 16>> m_mounts { LockRank::None };
 };
 
 }
@@ -24,11 +24,13 @@ class DevTmpFSRootDirectoryInode;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class OpenFileDescription;
 class DisplayConnector;
 class FileSystem;
 class FutexQueue;
+class IORing;
 class IPv4Socket;
 class Inode;
 class InodeIdentifier;
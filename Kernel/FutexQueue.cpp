@@ -11,7 +11,13 @@
 namespace Kernel {
 
 FutexQueue::FutexQueue() = default;
-FutexQueue::~FutexQueue() = default;
+FutexQueue::~FutexQueue()
+{
+    if (m_pi_owner) {
+        m_pi_owner->remove_owned_pi_futex_queue({}, *this);
+        m_pi_owner->update_inherited_priority();
+    }
+}
 
 bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
 {
@@ -25,6 +31,12 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was removed", this, b.thread());
         return false;
     }
+    // The owner unlocked the PI futex after the waiter last looked at it, so it would miss the wake-up.
+    auto const* pi_owner = static_cast<Thread::FutexBlocker&>(b).pi_owner();
+    if (pi_owner && pi_owner != m_pi_owner.ptr()) {
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: PI owner changed", this, b.thread());
+        return false;
+    }
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, b.thread());
 
     return true;
@@ -146,6 +158,56 @@ bool FutexQueue::queue_imminent_wait()
     return true;
 }
 
+void FutexQueue::cancel_imminent_wait()
+{
+    SpinlockLocker lock(m_lock);
+    VERIFY(m_imminent_waits > 0);
+    m_imminent_waits--;
+}
+
+u32 FutexQueue::highest_waiter_priority_locked() const
+{
+    u32 priority = 0;
+    for_each_blocker_locked([&](Thread::Blocker& blocker) {
+        priority = max(priority, blocker.thread().priority());
+    });
+    return priority;
+}
+
+void FutexQueue::set_pi_owner(Thread& owner, u32 waiter_priority)
+{
+    SpinlockLocker lock(m_lock);
+    if (m_pi_owner != &owner) {
+        if (m_pi_owner) {
+            m_pi_owner->remove_owned_pi_futex_queue({}, *this);
+            m_pi_owner->update_inherited_priority();
+        }
+        owner.add_owned_pi_futex_queue({}, *this);
+        m_pi_owner = owner;
+    }
+    m_pi_waiter_priority.store(max(highest_waiter_priority_locked(), waiter_priority), AK::MemoryOrder::memory_order_relaxed);
+    owner.update_inherited_priority();
+}
+
+void FutexQueue::clear_pi_owner()
+{
+    SpinlockLocker lock(m_lock);
+    if (!m_pi_owner)
+        return;
+    m_pi_owner->remove_owned_pi_futex_queue({}, *this);
+    m_pi_owner->update_inherited_priority();
+    m_pi_owner = nullptr;
+}
+
+void FutexQueue::update_pi_waiter_priority()
+{
+    SpinlockLocker lock(m_lock);
+    if (!m_pi_owner)
+        return;
+    m_pi_waiter_priority.store(highest_waiter_priority_locked(), AK::MemoryOrder::memory_order_relaxed);
+    m_pi_owner->update_inherited_priority();
+}
+
 bool FutexQueue::try_remove()
 {
     SpinlockLocker lock(m_lock);
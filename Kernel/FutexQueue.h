@@ -39,12 +39,27 @@ public:
     }
     bool is_empty_and_no_imminent_waits_locked();
 
+    // Gives up on a wait that was announced with queue_imminent_wait().
+    void cancel_imminent_wait();
+
+    // Priority inheritance, for FUTEX_LOCK_PI: The owner runs at least at the priority of its highest priority waiter.
+    // A waiter that is about to block passes its own priority, since it isn't one of our blockers yet.
+    void set_pi_owner(Thread& owner, u32 waiter_priority);
+    void clear_pi_owner();
+    // Recomputes the priority the owner inherits, after waiters went away.
+    void update_pi_waiter_priority();
+    u32 pi_waiter_priority() const { return m_pi_waiter_priority.load(AK::MemoryOrder::memory_order_relaxed); }
+
 protected:
     virtual bool should_add_blocker(Thread::Blocker& b, void*) override;
 
 private:
+    u32 highest_waiter_priority_locked() const;
+
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
     bool m_was_removed { false };
+    LockRefPtr<Thread> m_pi_owner;
+    Atomic<u32> m_pi_waiter_priority { 0 };
 };
 
 }
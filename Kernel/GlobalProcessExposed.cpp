@@ -14,14 +14,19 @@
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/CommandLine.h>
+#include <Kernel/ContinuousProfiler.h>
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/Devices/HID/HIDManagement.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Heap/SlabCache.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 #include <Kernel/KBufferBuilder.h>
+#include <Kernel/Locking/LockContention.h>
+#include <Kernel/Memory/CompressedPage.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Routing.h>
@@ -81,7 +86,7 @@ private:
     virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
     {
         auto array = TRY(JsonArraySerializer<>::try_create(builder));
-        TRY(arp_table().with([&](auto const& table) -> ErrorOr<void> {
+        TRY(arp_table().with_shared([&](auto const& table) -> ErrorOr<void> {
             for (auto& it : table) {
                 auto obj = TRY(array.add_object());
                 auto mac_address = TRY(it.value.to_string());
@@ -106,7 +111,7 @@ private:
     virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
     {
         auto array = TRY(JsonArraySerializer<>::try_create(builder));
-        TRY(routing_table().with([&](auto const& table) -> ErrorOr<void> {
+        TRY(routing_table().with_shared([&](auto const& table) -> ErrorOr<void> {
             for (auto& it : table) {
                 auto obj = TRY(array.add_object());
                 auto destination = TRY(it.destination.to_string());
@@ -150,6 +155,17 @@ private:
             TRY(obj.add("bytes_in"sv, socket.bytes_in()));
             TRY(obj.add("packets_out"sv, socket.packets_out()));
             TRY(obj.add("bytes_out"sv, socket.bytes_out()));
+            TRY(obj.add("retransmits"sv, socket.retransmits()));
+            auto& congestion_control = socket.congestion_control();
+            TRY(obj.add("congestion_control"sv, TCPCongestionControl::to_string(congestion_control.algorithm())));
+            TRY(obj.add("congestion_window"sv, congestion_control.congestion_window()));
+            if (congestion_control.slow_start_threshold() != NumericLimits<size_t>::max())
+                TRY(obj.add("slow_start_threshold"sv, congestion_control.slow_start_threshold()));
+            TRY(obj.add("send_window"sv, socket.send_window_size()));
+            TRY(obj.add("srtt_ms"sv, socket.smoothed_rtt().to_milliseconds()));
+            TRY(obj.add("rto_ms"sv, socket.retransmission_timeout().to_milliseconds()));
+            TRY(obj.add("sack_permitted"sv, socket.is_sack_permitted()));
+            TRY(obj.add("window_scaling"sv, socket.is_window_scaling_enabled()));
             auto current_process_credentials = Process::current().credentials();
             if (current_process_credentials->is_superuser() || current_process_credentials->uid() == socket.origin_uid()) {
                 TRY(obj.add("origin_pid"sv, socket.origin_pid().value()));
@@ -322,6 +338,28 @@ private:
     mutable Mutex m_lock;
 };
 
+class ProcFSLockContentionProfiling : public ProcFSSystemBoolean {
+public:
+    static NonnullLockRefPtr<ProcFSLockContentionProfiling> must_create(ProcFSSystemDirectory const&);
+
+    virtual bool value() const override { return LockContention::is_enabled(); }
+    virtual void set_value(bool new_value) override { LockContention::set_enabled(new_value); }
+
+private:
+    ProcFSLockContentionProfiling();
+};
+
+class ProcFSContinuousProfiling : public ProcFSSystemBoolean {
+public:
+    static NonnullLockRefPtr<ProcFSContinuousProfiling> must_create(ProcFSSystemDirectory const&);
+
+    virtual bool value() const override { return ContinuousProfiler::is_enabled(); }
+    virtual void set_value(bool new_value) override { ContinuousProfiler::set_enabled(new_value); }
+
+private:
+    ProcFSContinuousProfiling();
+};
+
 class ProcFSUBSanDeadly : public ProcFSSystemBoolean {
 public:
     static NonnullLockRefPtr<ProcFSUBSanDeadly> must_create(ProcFSSystemDirectory const&);
@@ -356,6 +394,14 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSDumpKmallocStacks> ProcFSDumpKmallocSta
 {
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSDumpKmallocStacks).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSLockContentionProfiling> ProcFSLockContentionProfiling::must_create(ProcFSSystemDirectory const&)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSLockContentionProfiling).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSContinuousProfiling> ProcFSContinuousProfiling::must_create(ProcFSSystemDirectory const&)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSContinuousProfiling).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSUBSanDeadly> ProcFSUBSanDeadly::must_create(ProcFSSystemDirectory const&)
 {
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSUBSanDeadly).release_nonnull();
@@ -370,6 +416,16 @@ UNMAP_AFTER_INIT ProcFSDumpKmallocStacks::ProcFSDumpKmallocStacks()
 {
 }
 
+UNMAP_AFTER_INIT ProcFSLockContentionProfiling::ProcFSLockContentionProfiling()
+    : ProcFSSystemBoolean("lock_contention_profiling"sv)
+{
+}
+
+UNMAP_AFTER_INIT ProcFSContinuousProfiling::ProcFSContinuousProfiling()
+    : ProcFSSystemBoolean("continuous_profiling"sv)
+{
+}
+
 UNMAP_AFTER_INIT ProcFSUBSanDeadly::ProcFSUBSanDeadly()
     : ProcFSSystemBoolean("ubsan_is_deadly"sv)
 {
@@ -422,6 +478,14 @@ private:
                 TRY(fs_object.add("source"sv, "none"));
             }
 
+            if (fs.is_block_based()) {
+                auto cache_statistics = static_cast<BlockBasedFileSystem const&>(fs).cache_statistics();
+                TRY(fs_object.add("cache_hits"sv, cache_statistics.hits));
+                TRY(fs_object.add("cache_misses"sv, cache_statistics.misses));
+                TRY(fs_object.add("cache_evictions"sv, cache_statistics.evictions));
+                TRY(fs_object.add("cache_entries"sv, cache_statistics.entry_count));
+            }
+
             TRY(fs_object.finish());
             return {};
         }));
@@ -452,8 +516,62 @@ private:
         TRY(json.add("physical_available"sv, system_memory.physical_pages - system_memory.physical_pages_used));
         TRY(json.add("physical_committed"sv, system_memory.physical_pages_committed));
         TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
+        TRY(json.add("compressed_pages"sv, Memory::CompressedPage::count()));
+        TRY(json.add("compressed_bytes"sv, Memory::CompressedPage::total_size()));
         TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
         TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+        {
+            auto array = TRY(json.add_array("slab_caches"sv));
+            TRY(SlabCache::try_for_each([&](SlabCache const& cache) -> ErrorOr<void> {
+                auto cache_statistics = cache.statistics();
+                auto cache_object = TRY(array.add_object());
+                TRY(cache_object.add("name"sv, cache_statistics.name));
+                TRY(cache_object.add("object_size"sv, cache_statistics.object_size));
+                TRY(cache_object.add("allocation_count"sv, cache_statistics.allocation_count));
+                TRY(cache_object.add("free_count"sv, cache_statistics.free_count));
+                TRY(cache_object.add("fast_path_count"sv, cache_statistics.fast_path_count));
+                TRY(cache_object.add("backend_allocation_count"sv, cache_statistics.backend_allocation_count));
+                TRY(cache_object.add("cached_objects"sv, cache_statistics.cached_objects));
+                TRY(cache_object.finish());
+                return {};
+            }));
+            TRY(array.finish());
+        }
+        TRY(json.finish());
+        return {};
+    }
+};
+
+class ProcFSLockContention final : public ProcFSGlobalInformation {
+public:
+    static NonnullLockRefPtr<ProcFSLockContention> must_create();
+
+private:
+    ProcFSLockContention();
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+        TRY(json.add("enabled"sv, LockContention::is_enabled()));
+        TRY(json.add("dropped_sites"sv, LockContention::dropped_sites()));
+        {
+            auto array = TRY(json.add_array("locks"sv));
+            TRY(LockContention::try_for_each([&](LockContentionStatistics const& statistics) -> ErrorOr<void> {
+                if (statistics.acquisitions == 0)
+                    return {};
+                auto lock_object = TRY(array.add_object());
+                TRY(lock_object.add("name"sv, statistics.name));
+                TRY(lock_object.add("acquisitions"sv, statistics.acquisitions));
+                TRY(lock_object.add("contended_acquisitions"sv, statistics.contended_acquisitions));
+                TRY(lock_object.add("total_wait_ns"sv, statistics.total_wait_ns));
+                TRY(lock_object.add("max_wait_ns"sv, statistics.max_wait_ns));
+                TRY(lock_object.add("exclusive_holds"sv, statistics.exclusive_holds));
+                TRY(lock_object.add("total_hold_ns"sv, statistics.total_hold_ns));
+                TRY(lock_object.add("max_hold_ns"sv, statistics.max_hold_ns));
+                TRY(lock_object.finish());
+                return {};
+            }));
+            TRY(array.finish());
+        }
         TRY(json.finish());
         return {};
     }
@@ -541,32 +659,23 @@ private:
             TRY(process_object.add("name"sv, process.name()));
             TRY(process_object.add("executable"sv, process.executable() ? TRY(process.executable()->try_serialize_absolute_path())->view() : ""sv));
 
-            size_t amount_virtual = 0;
-            size_t amount_resident = 0;
-            size_t amount_dirty_private = 0;
+            Memory::AddressSpace::MemoryUsage memory_usage;
             size_t amount_clean_inode = 0;
-            size_t amount_shared = 0;
-            size_t amount_purgeable_volatile = 0;
-            size_t amount_purgeable_nonvolatile = 0;
-
             TRY(process.address_space().with([&](auto& space) -> ErrorOr<void> {
-                amount_virtual = space->amount_virtual();
-                amount_resident = space->amount_resident();
-                amount_dirty_private = space->amount_dirty_private();
+                memory_usage = space->memory_usage();
                 amount_clean_inode = TRY(space->amount_clean_inode());
-                amount_shared = space->amount_shared();
-                amount_purgeable_volatile = space->amount_purgeable_volatile();
-                amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile();
                 return {};
             }));
 
-            TRY(process_object.add("amount_virtual"sv, amount_virtual));
-            TRY(process_object.add("amount_resident"sv, amount_resident));
-            TRY(process_object.add("amount_dirty_private"sv, amount_dirty_private));
+            TRY(process_object.add("amount_virtual"sv, memory_usage.virtual_size));
+            TRY(process_object.add("amount_resident"sv, memory_usage.resident));
+            TRY(process_object.add("amount_dirty_private"sv, memory_usage.dirty_private));
             TRY(process_object.add("amount_clean_inode"sv, amount_clean_inode));
-            TRY(process_object.add("amount_shared"sv, amount_shared));
-            TRY(process_object.add("amount_purgeable_volatile"sv, amount_purgeable_volatile));
-            TRY(process_object.add("amount_purgeable_nonvolatile"sv, amount_purgeable_nonvolatile));
+            TRY(process_object.add("amount_shared"sv, memory_usage.shared));
+            TRY(process_object.add("amount_unique"sv, memory_usage.unique));
+            TRY(process_object.add("amount_proportional"sv, memory_usage.proportional));
+            TRY(process_object.add("amount_purgeable_volatile"sv, memory_usage.purgeable_volatile));
+            TRY(process_object.add("amount_purgeable_nonvolatile"sv, memory_usage.purgeable_nonvolatile));
             TRY(process_object.add("dumpable"sv, process.is_dumpable()));
             TRY(process_object.add("kernel"sv, process.is_kernel_process()));
             auto thread_array = TRY(process_object.add_array("threads"sv));
@@ -606,11 +715,15 @@ private:
         {
             auto array = TRY(json.add_array("processes"sv));
             TRY(build_process(array, *Scheduler::colonel()));
-            TRY(Process::all_instances().with([&](auto& processes) -> ErrorOr<void> {
-                for (auto& process : processes)
-                    TRY(build_process(array, process));
+            // Note: Describing a process takes a while, so we only hold the lock of the process list long enough to copy it.
+            NonnullLockRefPtrVector<Process> processes;
+            TRY(Process::all_instances().with([&](auto& list) -> ErrorOr<void> {
+                for (auto& process : list)
+                    TRY(processes.try_append(process));
                 return {};
             }));
+            for (auto& process : processes)
+                TRY(build_process(array, process));
             TRY(array.finish());
         }
 
@@ -657,6 +770,8 @@ private:
                 TRY(obj.add("stepping"sv, info.stepping()));
                 TRY(obj.add("type"sv, info.type()));
                 TRY(obj.add("brand"sv, info.brand_string()));
+                TRY(obj.add("tlb_shootdowns_sent"sv, proc.tlb_shootdowns_sent()));
+                TRY(obj.add("tlb_shootdowns_skipped"sv, proc.tlb_shootdowns_skipped()));
 
                 auto caches = TRY(obj.add_object("caches"sv));
 
@@ -722,9 +837,14 @@ private:
                 TRY(obj.add("purpose"sv, handler.purpose()));
                 TRY(obj.add("interrupt_line"sv, handler.interrupt_number()));
                 TRY(obj.add("controller"sv, handler.controller()));
-                TRY(obj.add("cpu_handler"sv, 0)); // FIXME: Determine the responsible CPU for each interrupt handler.
+                auto controller = InterruptManagement::the().get_responsible_irq_controller(handler.interrupt_number());
+                TRY(obj.add("cpu_handler"sv, controller ? controller->destination_processor(handler) : 0));
                 TRY(obj.add("device_sharing"sv, (unsigned)handler.sharing_devices_count()));
                 TRY(obj.add("call_count"sv, (unsigned)handler.get_invoking_count()));
+                auto per_cpu_call_counts = TRY(obj.add_array("per_cpu_call_counts"sv));
+                for (u32 processor = 0; processor < min<u32>(Processor::count(), GenericInterruptHandler::max_counted_processors); ++processor)
+                    TRY(per_cpu_call_counts.add((unsigned)handler.get_invoking_count(processor)));
+                TRY(per_cpu_call_counts.finish());
                 TRY(obj.finish());
                 return {};
             })();
@@ -834,6 +954,20 @@ private:
     }
 };
 
+class ProcFSContinuousProfile final : public ProcFSGlobalInformation {
+public:
+    static NonnullLockRefPtr<ProcFSContinuousProfile> must_create();
+
+    virtual mode_t required_mode() const override { return 0400; }
+
+private:
+    ProcFSContinuousProfile();
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        return ContinuousProfiler::drain_to_json(builder);
+    }
+};
+
 class ProcFSKernelBase final : public ProcFSGlobalInformation {
 public:
     static NonnullLockRefPtr<ProcFSKernelBase> must_create();
@@ -864,6 +998,10 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSMemoryStatus> ProcFSMemoryStatus::must_
 {
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSMemoryStatus).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSLockContention> ProcFSLockContention::must_create()
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSLockContention).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSSystemStatistics> ProcFSSystemStatistics::must_create()
 {
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSSystemStatistics).release_nonnull();
@@ -909,6 +1047,10 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSProfile> ProcFSProfile::must_create()
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSProfile).release_nonnull();
 }
 
+UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSContinuousProfile> ProcFSContinuousProfile::must_create()
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSContinuousProfile).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSKernelBase> ProcFSKernelBase::must_create()
 {
     return adopt_lock_ref_if_nonnull(new (nothrow) ProcFSKernelBase).release_nonnull();
@@ -926,6 +1068,10 @@ UNMAP_AFTER_INIT ProcFSMemoryStatus::ProcFSMemoryStatus()
     : ProcFSGlobalInformation("memstat"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSLockContention::ProcFSLockContention()
+    : ProcFSGlobalInformation("lock_contention"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSSystemStatistics::ProcFSSystemStatistics()
     : ProcFSGlobalInformation("stat"sv)
 {
@@ -971,6 +1117,11 @@ UNMAP_AFTER_INIT ProcFSProfile::ProcFSProfile()
 {
 }
 
+UNMAP_AFTER_INIT ProcFSContinuousProfile::ProcFSContinuousProfile()
+    : ProcFSGlobalInformation("continuous_profile"sv)
+{
+}
+
 UNMAP_AFTER_INIT ProcFSKernelBase::ProcFSKernelBase()
     : ProcFSGlobalInformation("kernel_base"sv)
 {
@@ -981,6 +1132,8 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSSystemDirectory> ProcFSSystemDirectory:
     auto directory = adopt_lock_ref(*new (nothrow) ProcFSSystemDirectory(parent_directory));
     directory->m_components.append(ProcFSDumpKmallocStacks::must_create(directory));
     directory->m_components.append(ProcFSUBSanDeadly::must_create(directory));
+    directory->m_components.append(ProcFSLockContentionProfiling::must_create(directory));
+    directory->m_components.append(ProcFSContinuousProfiling::must_create(directory));
     directory->m_components.append(ProcFSCapsLockRemap::must_create(directory));
     return directory;
 }
@@ -996,6 +1149,7 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSRootDirectory> ProcFSRootDirectory::mus
     directory->m_components.append(ProcFSSelfProcessDirectory::must_create());
     directory->m_components.append(ProcFSDiskUsage::must_create());
     directory->m_components.append(ProcFSMemoryStatus::must_create());
+    directory->m_components.append(ProcFSLockContention::must_create());
     directory->m_components.append(ProcFSSystemStatistics::must_create());
     directory->m_components.append(ProcFSOverallProcesses::must_create());
     directory->m_components.append(ProcFSCPUInformation::must_create());
@@ -1007,6 +1161,7 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<ProcFSRootDirectory> ProcFSRootDirectory::mus
     directory->m_components.append(ProcFSCommandLine::must_create());
     directory->m_components.append(ProcFSSystemMode::must_create());
     directory->m_components.append(ProcFSProfile::must_create());
+    directory->m_components.append(ProcFSContinuousProfile::must_create());
     directory->m_components.append(ProcFSKernelBase::must_create());
 
     directory->m_components.append(ProcFSNetworkDirectory::must_create(*directory));
@@ -73,6 +73,8 @@ ErrorOr<void> VirtIODisplayConnector::set_mode_setting(ModeSetting const& mode_s
         .vertical_offset = 0,
     };
     m_current_mode_setting = mode_set;
+    m_last_set_buffer_index.store(0);
+    m_vertical_offsetted = false;
 
     m_display_info.enabled = 1;
     return {};
@@ -99,12 +101,20 @@ ErrorOr<void> VirtIODisplayConnector::set_safe_mode_setting()
 ErrorOr<void> VirtIODisplayConnector::set_y_offset(size_t y)
 {
     VERIFY(m_control_lock.is_locked());
+    size_t buffer_index;
     if (y == 0)
-        m_last_set_buffer_index.store(0);
+        buffer_index = 0;
     else if (y == m_display_info.rect.height)
-        m_last_set_buffer_index.store(1);
+        buffer_index = 1;
     else
         return Error::from_errno(EINVAL);
+    if (m_last_set_buffer_index.load() == buffer_index)
+        return {};
+
+    // Point the scanout at the other buffer's resource, so flipping doesn't cost a transfer of the whole screen.
+    SpinlockLocker locker(m_graphics_adapter->operation_lock());
+    m_graphics_adapter->set_scanout_buffer({}, *this, buffer_index == 0);
+    m_last_set_buffer_index.store(buffer_index);
     return {};
 }
 ErrorOr<void> VirtIODisplayConnector::unblank()
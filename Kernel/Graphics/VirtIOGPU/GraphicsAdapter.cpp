@@ -53,11 +53,25 @@ ErrorOr<void> VirtIOGraphicsAdapter::mode_set_resolution(Badge<VirtIODisplayConn
     SpinlockLocker locker(m_operation_lock);
     VERIFY(connector.scanout_id() < VIRTIO_GPU_MAX_SCANOUTS);
     auto rounded_buffer_size = TRY(calculate_framebuffer_size(width, height));
-    TRY(attach_physical_range_to_framebuffer(connector, true, 0, rounded_buffer_size));
+    // Note: Attaching a buffer also makes the scanout show it, and we always start out showing the main buffer.
     TRY(attach_physical_range_to_framebuffer(connector, false, rounded_buffer_size, rounded_buffer_size));
+    TRY(attach_physical_range_to_framebuffer(connector, true, 0, rounded_buffer_size));
     return {};
 }
 
+void VirtIOGraphicsAdapter::set_scanout_buffer(Badge<VirtIODisplayConnector>, VirtIODisplayConnector& connector, bool main_buffer)
+{
+    VERIFY(m_operation_lock.is_locked());
+    VERIFY(connector.scanout_id() < VIRTIO_GPU_MAX_SCANOUTS);
+    Scanout::PhysicalBuffer& buffer = main_buffer ? m_scanouts[connector.scanout_id().value()].main_buffer : m_scanouts[connector.scanout_id().value()].back_buffer;
+    auto display_rect = connector.display_information({}).rect;
+    // Note: This is a real page flip, nothing is copied. The host simply starts presenting the other resource,
+    // whose contents were already transferred to it while it was the back buffer.
+    set_scanout_resource(connector.scanout_id(), buffer.resource_id, display_rect);
+    flush_displayed_image(buffer.resource_id, display_rect);
+    buffer.dirty_rect = {};
+}
+
 void VirtIOGraphicsAdapter::set_dirty_displayed_rect(Badge<VirtIODisplayConnector>, VirtIODisplayConnector& connector, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect, bool main_buffer)
 {
     VERIFY(m_operation_lock.is_locked());
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/InterruptDisabler.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Heap/SlabCache.h>
+#include <Kernel/StdLib.h>
+
+namespace Kernel {
+
+Atomic<SlabCache*> SlabCache::s_first_cache { nullptr };
+
+void SlabCache::register_cache()
+{
+    if (m_registered.exchange(true, AK::memory_order_relaxed))
+        return;
+    auto* head = s_first_cache.load(AK::memory_order_relaxed);
+    do {
+        m_next_cache = head;
+    } while (!s_first_cache.compare_exchange_strong(head, this, AK::memory_order_acq_rel));
+}
+
+void SlabCache::refill_magazine(Magazine& magazine)
+{
+    SpinlockLocker lock(m_depot_lock);
+    while (m_depot && magazine.count < magazine_capacity / 2) {
+        auto* entry = m_depot;
+        m_depot = entry->next;
+        --m_depot_count;
+        magazine.objects[magazine.count++] = entry;
+    }
+}
+
+SlabCache::FreelistEntry* SlabCache::drain_magazine(Magazine& magazine)
+{
+    // Keep half of the magazine around, so alternating allocations and frees don't bounce on the depot.
+    FreelistEntry* overflow = nullptr;
+    SpinlockLocker lock(m_depot_lock);
+    while (magazine.count > magazine_capacity / 2) {
+        auto* entry = static_cast<FreelistEntry*>(magazine.objects[--magazine.count]);
+        if (m_depot_count < max_depot_objects) {
+            entry->next = m_depot;
+            m_depot = entry;
+            ++m_depot_count;
+        } else {
+            entry->next = overflow;
+            overflow = entry;
+        }
+    }
+    return overflow;
+}
+
+void* SlabCache::allocate_from_backend()
+{
+    if (m_alignment > kmalloc_alignment)
+        return kmalloc_aligned(m_object_size, m_alignment);
+    return kmalloc(m_object_size);
+}
+
+void SlabCache::deallocate_to_backend(void* ptr)
+{
+    if (m_alignment > kmalloc_alignment)
+        kfree_aligned(ptr);
+    else
+        kfree_sized(ptr, m_object_size);
+}
+
+void* SlabCache::allocate()
+{
+    {
+        InterruptDisabler disabler;
+        auto& magazine = m_magazines[Processor::current_id()];
+        ++magazine.allocation_count;
+        if (magazine.count > 0)
+            ++magazine.fast_path_count;
+        else
+            refill_magazine(magazine);
+
+        if (magazine.count > 0) {
+            void* ptr = magazine.objects[--magazine.count];
+            memset(ptr, KMALLOC_SCRUB_BYTE, m_object_size);
+            return ptr;
+        }
+    }
+
+    register_cache();
+    m_backend_allocation_count.fetch_add(1, AK::memory_order_relaxed);
+    return allocate_from_backend();
+}
+
+void SlabCache::deallocate(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    memset(ptr, KFREE_SCRUB_BYTE, m_object_size);
+
+    FreelistEntry* overflow = nullptr;
+    {
+        InterruptDisabler disabler;
+        auto& magazine = m_magazines[Processor::current_id()];
+        ++magazine.free_count;
+        if (magazine.count == magazine_capacity)
+            overflow = drain_magazine(magazine);
+        magazine.objects[magazine.count++] = ptr;
+    }
+
+    // NOTE: The depot was full, so hand the excess back to kmalloc outside of any lock.
+    while (overflow) {
+        auto* next = overflow->next;
+        deallocate_to_backend(overflow);
+        overflow = next;
+    }
+}
+
+SlabCacheStatistics SlabCache::statistics() const
+{
+    SlabCacheStatistics statistics;
+    statistics.name = name();
+    statistics.object_size = m_object_size;
+    statistics.backend_allocation_count = m_backend_allocation_count.load(AK::memory_order_relaxed);
+    for (size_t i = 0; i < Processor::count(); ++i) {
+        auto const& magazine = m_magazines[i];
+        statistics.allocation_count += magazine.allocation_count;
+        statistics.free_count += magazine.free_count;
+        statistics.fast_path_count += magazine.fast_path_count;
+        statistics.cached_objects += magazine.count;
+    }
+    SpinlockLocker lock(m_depot_lock);
+    statistics.cached_objects += m_depot_count;
+    return statistics;
+}
+
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+struct SlabCacheStatistics {
+    StringView name;
+    size_t object_size { 0 };
+    size_t allocation_count { 0 };
+    size_t free_count { 0 };
+    size_t fast_path_count { 0 };
+    size_t backend_allocation_count { 0 };
+    size_t cached_objects { 0 };
+};
+
+// A cache of equally sized objects of one type, layered on top of kmalloc.
+// Each processor keeps a small magazine of free objects that is accessed with only interrupts disabled,
+// and a shared depot behind a spinlock absorbs overflow between processors. kmalloc (and its global lock)
+// is only hit when both are empty, or when the depot is full on free.
+class SlabCache {
+    AK_MAKE_NONCOPYABLE(SlabCache);
+    AK_MAKE_NONMOVABLE(SlabCache);
+
+public:
+    // NOTE: This is constexpr so that static caches are constant-initialized,
+    //       as some objects (e.g Region) are allocated before global constructors run.
+    constexpr SlabCache(char const* name, size_t object_size, size_t alignment)
+        : m_name(name)
+        , m_object_size(max(object_size, sizeof(FreelistEntry)))
+        , m_alignment(alignment_for(alignment))
+    {
+    }
+
+    // NOTE: kmalloc() only guarantees this much, objects that need more are carved out with kmalloc_aligned().
+    static constexpr size_t kmalloc_alignment = 16;
+    static constexpr size_t alignment_for(size_t object_alignment) { return max(object_alignment, kmalloc_alignment); }
+
+    [[nodiscard]] void* allocate();
+    void deallocate(void*);
+
+    StringView name() const { return { m_name, __builtin_strlen(m_name) }; }
+    size_t object_size() const { return m_object_size; }
+    size_t alignment() const { return m_alignment; }
+    SlabCacheStatistics statistics() const;
+
+    template<typename Callback>
+    static ErrorOr<void> try_for_each(Callback callback)
+    {
+        // NOTE: Caches are never destroyed, so the list can be walked without a lock.
+        for (auto* cache = s_first_cache.load(AK::memory_order_acquire); cache; cache = cache->m_next_cache)
+            TRY(callback(*cache));
+        return {};
+    }
+
+private:
+    struct FreelistEntry {
+        FreelistEntry* next;
+    };
+
+    static constexpr size_t magazine_capacity = 16;
+    static constexpr size_t max_depot_objects = 16 * magazine_capacity;
+
+    struct Magazine {
+        size_t count { 0 };
+        void* objects[magazine_capacity] {};
+
+        size_t allocation_count { 0 };
+        size_t free_count { 0 };
+        size_t fast_path_count { 0 };
+    };
+
+    void register_cache();
+    void refill_magazine(Magazine&);
+    FreelistEntry* drain_magazine(Magazine&);
+    void* allocate_from_backend();
+    void deallocate_to_backend(void*);
+
+    char const* m_name { nullptr };
+    size_t m_object_size { 0 };
+    size_t m_alignment { 0 };
+    Array<Magazine, KERNEL_MAX_CPU_COUNT> m_magazines {};
+
+    mutable Spinlock m_depot_lock { LockRank::None };
+    FreelistEntry* m_depot { nullptr };
+    size_t m_depot_count { 0 };
+    Atomic<size_t> m_backend_allocation_count { 0 };
+
+    Atomic<bool> m_registered { false };
+    SlabCache* m_next_cache { nullptr };
+    static Atomic<SlabCache*> s_first_cache;
+};
+
+}
+
+// Routes all allocations of `type` through a dedicated SlabCache, which must be defined
+// in exactly one translation unit with DEFINE_SLAB_CACHE(type).
+#define MAKE_SLAB_ALLOCATED(type)                                                                             \
+public:                                                                                                       \
+    [[nodiscard]] void* operator new(size_t size)                                                             \
+    {                                                                                                         \
+        VERIFY(size == sizeof(type));                                                                         \
+        void* ptr = s_slab_cache.allocate();                                                                  \
+        VERIFY(ptr);                                                                                          \
+        return ptr;                                                                                           \
+    }                                                                                                         \
+    [[nodiscard]] void* operator new(size_t size, std::nothrow_t const&) noexcept                             \
+    {                                                                                                         \
+        VERIFY(size == sizeof(type));                                                                         \
+        return s_slab_cache.allocate();                                                                       \
+    }                                                                                                         \
+    [[nodiscard]] void* operator new(size_t size, std::align_val_t alignment)                                 \
+    {                                                                                                         \
+        VERIFY(static_cast<size_t>(alignment) <= s_slab_cache.alignment());                                   \
+        return operator new(size);                                                                            \
+    }                                                                                                         \
+    [[nodiscard]] void* operator new(size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept \
+    {                                                                                                         \
+        VERIFY(static_cast<size_t>(alignment) <= s_slab_cache.alignment());                                   \
+        return operator new(size, std::nothrow);                                                              \
+    }                                                                                                         \
+    void operator delete(void* ptr) noexcept { s_slab_cache.deallocate(ptr); }                                \
+    void operator delete(void* ptr, std::align_val_t) noexcept { s_slab_cache.deallocate(ptr); }              \
+                                                                                                              \
+private:                                                                                                      \
+    static Kernel::SlabCache s_slab_cache
+
+#define DEFINE_SLAB_CACHE(type)                                                      \
+    static_assert(Kernel::SlabCache::alignment_for(alignof(type)) >= alignof(type)); \
+    constinit Kernel::SlabCache type::s_slab_cache { #type, sizeof(type), alignof(type) }
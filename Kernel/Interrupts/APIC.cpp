@@ -8,6 +8,7 @@
 #include <AK/Memory.h>
 #include <AK/Singleton.h>
 #include <AK/Types.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/x86/IO.h>
 #include <Kernel/Arch/x86/MSR.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
@@ -25,6 +26,7 @@
 #include <Kernel/Thread.h>
 #include <Kernel/Time/APICTimer.h>
 
+#define IRQ_APIC_PERFORMANCE_COUNTER (0xfb - IRQ_VECTOR_BASE)
 #define IRQ_APIC_TIMER (0xfc - IRQ_VECTOR_BASE)
 #define IRQ_APIC_IPI (0xfd - IRQ_VECTOR_BASE)
 #define IRQ_APIC_ERR (0xfe - IRQ_VECTOR_BASE)
@@ -121,6 +123,37 @@ public:
 private:
 };
 
+class APICPerformanceCounterInterruptHandler final : public GenericInterruptHandler {
+public:
+    explicit APICPerformanceCounterInterruptHandler(u8 interrupt_vector)
+        : GenericInterruptHandler(interrupt_vector, true)
+    {
+    }
+    virtual ~APICPerformanceCounterInterruptHandler()
+    {
+    }
+
+    static void initialize(u8 interrupt_number)
+    {
+        auto* handler = new APICPerformanceCounterInterruptHandler(interrupt_number);
+        handler->register_interrupt_handler();
+    }
+
+    virtual bool handle_interrupt(RegisterState const&) override;
+
+    virtual bool eoi() override;
+
+    virtual HandlerType type() const override { return HandlerType::IRQHandler; }
+    virtual StringView purpose() const override { return "Performance Counter Handler"sv; }
+    virtual StringView controller() const override { return {}; }
+
+    virtual size_t sharing_devices_count() const override { return 0; }
+    virtual bool is_shared_handler() const override { return false; }
+    virtual bool is_sharing_with_others() const override { return false; }
+
+private:
+};
+
 bool APIC::initialized()
 {
     return s_apic.is_initialized();
@@ -482,6 +515,7 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
     dbgln_if(APIC_DEBUG, "CPU #{} apic id: {}", cpu, apic_id);
     Processor::current().info().set_apic_id(apic_id);
+    m_physical_apic_ids[cpu] = m_is_x2 ? apic_id : read_register(APIC_REG_ID) >> 24;
 
     dbgln_if(APIC_DEBUG, "Enabling local APIC for CPU #{}, logical APIC ID: {}", cpu, apic_id);
 
@@ -492,6 +526,8 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
         // register IPI interrupt vector
         APICIPIInterruptHandler::initialize(IRQ_APIC_IPI);
+
+        APICPerformanceCounterInterruptHandler::initialize(IRQ_APIC_PERFORMANCE_COUNTER);
     }
 
     if (!m_is_x2) {
@@ -514,6 +550,14 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
     write_register(APIC_REG_TPR, 0);
 }
 
+void APIC::set_performance_counter_interrupt_enabled(bool enabled)
+{
+    if (enabled)
+        write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(IRQ_APIC_PERFORMANCE_COUNTER + IRQ_VECTOR_BASE, 0));
+    else
+        write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(0, 0) | APIC_LVT_MASKED);
+}
+
 Thread* APIC::get_idle_thread(u32 cpu) const
 {
     VERIFY(cpu > 0);
@@ -666,6 +710,18 @@ bool APICErrInterruptHandler::eoi()
     return true;
 }
 
+bool APICPerformanceCounterInterruptHandler::handle_interrupt(RegisterState const& regs)
+{
+    PerformanceCounters::handle_overflow_interrupt(regs);
+    return true;
+}
+
+bool APICPerformanceCounterInterruptHandler::eoi()
+{
+    APIC::the().eoi();
+    return true;
+}
+
 bool HardwareTimer<GenericInterruptHandler>::eoi()
 {
     APIC::the().eoi();
@@ -33,8 +33,12 @@ public:
     void broadcast_ipi();
     void send_ipi(u32 cpu);
     static u8 spurious_interrupt_vector();
+    // Enables or masks the overflow interrupt of the current processor's performance counters.
+    void set_performance_counter_interrupt_enabled(bool);
     Thread* get_idle_thread(u32 cpu) const;
     u32 enabled_processor_count() const { return m_processor_enabled_cnt; }
+    // Note: This is the ID to address a processor by in physical destination mode, e.g. from an IOAPIC.
+    u32 physical_apic_id(u32 cpu) const { return m_physical_apic_ids[cpu]; }
 
     APICTimer* initialize_timers(HardwareTimerBase&);
     APICTimer* get_timer() const { return m_apic_timer; }
@@ -100,6 +104,7 @@ private:
     u32 m_processor_enabled_cnt { 0 };
     APICTimer* m_apic_timer { nullptr };
     bool m_is_x2 { false };
+    Array<u32, 32> m_physical_apic_ids {};
 
     static PhysicalAddress get_base();
     void set_base(PhysicalAddress const& base);
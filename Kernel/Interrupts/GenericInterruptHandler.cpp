@@ -6,6 +6,7 @@
 
 #include <Kernel/Arch/InterruptManagement.h>
 #include <Kernel/Arch/Interrupts.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Assertions.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 
@@ -23,6 +24,19 @@ GenericInterruptHandler::GenericInterruptHandler(u8 interrupt_number, bool disab
     // is being constructed or deconstructed!
 }
 
+size_t GenericInterruptHandler::get_invoking_count() const
+{
+    size_t count = 0;
+    for (auto& processor_count : m_invoking_counts)
+        count += processor_count.load();
+    return count;
+}
+
+void GenericInterruptHandler::increment_invoking_counter()
+{
+    m_invoking_counts[Processor::current_id()]++;
+}
+
 void GenericInterruptHandler::will_be_destroyed()
 {
     // This will be called for RefCounted interrupt handlers before the
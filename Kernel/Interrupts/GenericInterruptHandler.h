@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/RegisterState.h>
@@ -37,7 +39,10 @@ public:
 
     u8 interrupt_number() const { return m_interrupt_number; }
 
-    size_t get_invoking_count() const { return m_invoking_count; }
+    // Note: Interrupts are counted for every processor that handled them.
+    static constexpr size_t max_counted_processors = 32;
+    size_t get_invoking_count() const;
+    size_t get_invoking_count(u32 processor) const { return m_invoking_counts[processor]; }
 
     virtual size_t sharing_devices_count() const = 0;
     virtual bool is_shared_handler() const = 0;
@@ -48,10 +53,7 @@ public:
     virtual StringView controller() const = 0;
 
     virtual bool eoi() = 0;
-    ALWAYS_INLINE void increment_invoking_counter()
-    {
-        m_invoking_count++;
-    }
+    void increment_invoking_counter();
 
 protected:
     void change_interrupt_number(u8 number);
@@ -60,7 +62,7 @@ protected:
     void disable_remap() { m_disable_remap = true; }
 
 private:
-    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_invoking_count { 0 };
+    Array<Atomic<u32, AK::MemoryOrder::memory_order_relaxed>, max_counted_processors> m_invoking_counts {};
     u8 m_interrupt_number { 0 };
     bool m_disable_remap { false };
     bool m_registered { false };
@@ -6,6 +6,7 @@
 
 #include <AK/Optional.h>
 #include <Kernel/Arch/InterruptDisabler.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/x86/InterruptManagement.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Interrupts/APIC.h>
@@ -210,6 +211,19 @@ bool IOAPIC::is_redirection_entry_masked(u8 index) const
     return (read_register((index << 1) + IOAPIC_REDIRECTION_ENTRY_OFFSET) & (1 << 16)) != 0;
 }
 
+bool IOAPIC::is_redirection_entry_level_triggered(u8 index) const
+{
+    VERIFY((u32)index < m_redirection_entries_count);
+    return (read_register((index << 1) + IOAPIC_REDIRECTION_ENTRY_OFFSET) & (1 << 15)) != 0;
+}
+
+void IOAPIC::set_redirection_entry_destination(u8 index, u32 processor) const
+{
+    VERIFY((u32)index < m_redirection_entries_count);
+    // Note: All entries are in physical destination mode, so this just points the entry at the APIC of another processor.
+    write_register((index << 1) + IOAPIC_REDIRECTION_ENTRY_OFFSET + 1, APIC::the().physical_apic_id(processor) << 24);
+}
+
 void IOAPIC::unmask_redirection_entry(u8 index) const
 {
     VERIFY((u32)index < m_redirection_entries_count);
@@ -268,9 +282,52 @@ void IOAPIC::enable(GenericInterruptHandler const& handler)
         found_index = find_redirection_entry_by_vector(interrupt_vector);
     }
     VERIFY(found_index.has_value());
+
+    // PCI interrupts are level triggered, and spread across all processors when they are first enabled.
+    // Everything else, including the timers, stays with the bootstrap processor.
+    if (is_redirection_entry_masked(found_index.value()) && is_redirection_entry_level_triggered(found_index.value()) && Processor::count() > 1) {
+        static u32 s_next_processor = 0;
+        auto processor = s_next_processor++ % Processor::count();
+        if (APIC::the().physical_apic_id(processor) <= 0xff)
+            set_redirection_entry_destination(found_index.value(), processor);
+    }
     unmask_redirection_entry(found_index.value());
 }
 
+ErrorOr<void> IOAPIC::set_destination_processor(GenericInterruptHandler const& handler, u32 processor)
+{
+    if (handler.interrupt_number() >= interrupt_vectors_count() || processor >= Processor::count())
+        return EINVAL;
+    // Note: Without interrupt remapping, there is only room for 8-bit APIC IDs in a redirection entry.
+    if (APIC::the().physical_apic_id(processor) > 0xff)
+        return ENOTSUP;
+
+    InterruptDisabler disabler;
+    VERIFY(!is_hard_disabled());
+    auto found_index = find_redirection_entry_by_vector(handler.interrupt_number());
+    if (!found_index.has_value())
+        return ENOENT;
+    set_redirection_entry_destination(found_index.value(), processor);
+    return {};
+}
+
+u32 IOAPIC::destination_processor(GenericInterruptHandler const& handler) const
+{
+    // Note: Interrupts that don't come in through an IOAPIC, like IPIs, are handled wherever they are sent.
+    if (handler.interrupt_number() >= interrupt_vectors_count())
+        return 0;
+    InterruptDisabler disabler;
+    auto found_index = find_redirection_entry_by_vector(handler.interrupt_number());
+    if (!found_index.has_value())
+        return 0;
+    u32 apic_id = read_register((found_index.value() << 1) + IOAPIC_REDIRECTION_ENTRY_OFFSET + 1) >> 24;
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        if (APIC::the().physical_apic_id(processor) == apic_id)
+            return processor;
+    }
+    return 0;
+}
+
 void IOAPIC::eoi(GenericInterruptHandler const& handler) const
 {
     InterruptDisabler disabler;
@@ -45,6 +45,8 @@ public:
     virtual void hard_disable() override;
     virtual void eoi(GenericInterruptHandler const&) const override;
     virtual void spurious_eoi(GenericInterruptHandler const&) const override;
+    virtual ErrorOr<void> set_destination_processor(GenericInterruptHandler const&, u32 processor) override;
+    virtual u32 destination_processor(GenericInterruptHandler const&) const override;
     virtual bool is_vector_enabled(u8 number) const override;
     virtual bool is_enabled() const override;
     virtual u16 get_isr() const override;
@@ -64,6 +66,8 @@ private:
     void mask_redirection_entry(u8 index) const;
     void unmask_redirection_entry(u8 index) const;
     bool is_redirection_entry_masked(u8 index) const;
+    bool is_redirection_entry_level_triggered(u8 index) const;
+    void set_redirection_entry_destination(u8 index, u32 processor) const;
 
     u8 read_redirection_entry_vector(u8 index) const;
     Optional<int> find_redirection_entry_by_vector(u8 vector) const;
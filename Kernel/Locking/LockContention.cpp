@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringHash.h>
+#include <Kernel/Locking/LockContention.h>
+#include <Kernel/PerformanceManager.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+Atomic<bool> LockContention::s_enabled { false };
+Atomic<size_t> LockContention::s_dropped_sites { 0 };
+LockContention::Site LockContention::s_sites[max_sites];
+
+void LockContention::set_enabled(bool enabled)
+{
+    // Every time profiling is switched on it starts over with a clean slate.
+    if (enabled && !s_enabled.exchange(true, AK::memory_order_relaxed)) {
+        reset();
+        return;
+    }
+    if (!enabled)
+        s_enabled.store(false, AK::memory_order_relaxed);
+}
+
+Optional<Time> LockContention::timestamp_if_enabled(Thread& thread)
+{
+    if (!TimeManagement::is_initialized())
+        return {};
+    if (!is_enabled() && !PerformanceManager::is_recording_lock_contention(thread))
+        return {};
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise);
+}
+
+LockContention::Site* LockContention::site_for(StringView name)
+{
+    if (name.is_empty())
+        name = "(unnamed)"sv;
+    name = name.substring_view(0, min(name.length(), Site::max_name_length));
+
+    auto index = string_hash(name.characters_without_null_termination(), name.length()) % max_sites;
+    for (size_t probe = 0; probe < max_sites; ++probe, index = (index + 1) % max_sites) {
+        auto& site = s_sites[index];
+        u8 state = site.state.load(AK::memory_order_acquire);
+        if (state == Site::State::Empty) {
+            if (site.state.compare_exchange_strong(state, Site::State::Claiming, AK::memory_order_acquire)) {
+                memcpy(site.name, name.characters_without_null_termination(), name.length());
+                site.name_length = name.length();
+                site.state.store(Site::State::Ready, AK::memory_order_release);
+                return &site;
+            }
+        }
+        // Another processor may have claimed the site but not copied its name yet.
+        while (state != Site::State::Ready) {
+            Processor::pause();
+            state = site.state.load(AK::memory_order_acquire);
+        }
+        if (StringView { site.name, site.name_length } == name)
+            return &site;
+    }
+    s_dropped_sites.fetch_add(1, AK::memory_order_relaxed);
+    return nullptr;
+}
+
+static void update_maximum(Atomic<u64>& maximum, u64 value)
+{
+    auto current = maximum.load(AK::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_strong(current, value, AK::memory_order_relaxed))
+        ;
+}
+
+void LockContention::record_acquisition(StringView name)
+{
+    if (auto* site = site_for(name))
+        site->acquisitions.fetch_add(1, AK::memory_order_relaxed);
+}
+
+void LockContention::record_contended_acquisition(StringView name, Time wait_time)
+{
+    auto* site = site_for(name);
+    if (!site)
+        return;
+    u64 wait_ns = max<i64>(wait_time.to_nanoseconds(), 0);
+    site->acquisitions.fetch_add(1, AK::memory_order_relaxed);
+    site->contended_acquisitions.fetch_add(1, AK::memory_order_relaxed);
+    site->total_wait_ns.fetch_add(wait_ns, AK::memory_order_relaxed);
+    update_maximum(site->max_wait_ns, wait_ns);
+}
+
+void LockContention::record_exclusive_hold(StringView name, Time hold_time)
+{
+    auto* site = site_for(name);
+    if (!site)
+        return;
+    u64 hold_ns = max<i64>(hold_time.to_nanoseconds(), 0);
+    site->exclusive_holds.fetch_add(1, AK::memory_order_relaxed);
+    site->total_hold_ns.fetch_add(hold_ns, AK::memory_order_relaxed);
+    update_maximum(site->max_hold_ns, hold_ns);
+}
+
+void LockContention::reset()
+{
+    // NOTE: Sites stay claimed, only their counters are cleared.
+    for (auto& site : s_sites) {
+        site.acquisitions.store(0, AK::memory_order_relaxed);
+        site.contended_acquisitions.store(0, AK::memory_order_relaxed);
+        site.total_wait_ns.store(0, AK::memory_order_relaxed);
+        site.max_wait_ns.store(0, AK::memory_order_relaxed);
+        site.exclusive_holds.store(0, AK::memory_order_relaxed);
+        site.total_hold_ns.store(0, AK::memory_order_relaxed);
+        site.max_hold_ns.store(0, AK::memory_order_relaxed);
+    }
+    s_dropped_sites.store(0, AK::memory_order_relaxed);
+}
+
+LockContentionStatistics LockContention::Site::statistics() const
+{
+    return {
+        .name = { name, name_length },
+        .acquisitions = acquisitions.load(AK::memory_order_relaxed),
+        .contended_acquisitions = contended_acquisitions.load(AK::memory_order_relaxed),
+        .total_wait_ns = total_wait_ns.load(AK::memory_order_relaxed),
+        .max_wait_ns = max_wait_ns.load(AK::memory_order_relaxed),
+        .exclusive_holds = exclusive_holds.load(AK::memory_order_relaxed),
+        .total_hold_ns = total_hold_ns.load(AK::memory_order_relaxed),
+        .max_hold_ns = max_hold_ns.load(AK::memory_order_relaxed),
+    };
+}
+
+}
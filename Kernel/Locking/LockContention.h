@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+#include <Kernel/Forward.h>
+
+namespace Kernel {
+
+struct LockContentionStatistics {
+    StringView name;
+    u64 acquisitions { 0 };
+    u64 contended_acquisitions { 0 };
+    u64 total_wait_ns { 0 };
+    u64 max_wait_ns { 0 };
+    u64 exclusive_holds { 0 };
+    u64 total_hold_ns { 0 };
+    u64 max_hold_ns { 0 };
+};
+
+// Opt-in bookkeeping of how Mutexes are acquired, aggregated per lock site (the name a Mutex was created with).
+// It is switched on at runtime through /proc/sys/lock_contention_profiling and exported as /proc/lock_contention.
+// Recording never allocates or takes a lock: sites live in a fixed-size table that is claimed with atomics.
+class LockContention {
+public:
+    static bool is_enabled() { return s_enabled.load(AK::memory_order_relaxed); }
+    static void set_enabled(bool);
+
+    // Returns the current time if lock timing is enabled, either for the statistics or for the profiler.
+    static Optional<Time> timestamp_if_enabled(Thread&);
+
+    static void record_acquisition(StringView name);
+    static void record_contended_acquisition(StringView name, Time wait_time);
+    static void record_exclusive_hold(StringView name, Time hold_time);
+
+    static void reset();
+
+    static size_t dropped_sites() { return s_dropped_sites.load(AK::memory_order_relaxed); }
+
+    template<typename Callback>
+    static ErrorOr<void> try_for_each(Callback callback)
+    {
+        for (auto& site : s_sites) {
+            if (site.state.load(AK::memory_order_acquire) != Site::State::Ready)
+                continue;
+            TRY(callback(site.statistics()));
+        }
+        return {};
+    }
+
+private:
+    struct Site {
+        enum State : u8 {
+            Empty,
+            Claiming,
+            Ready,
+        };
+
+        // NOTE: The name is copied, as a Mutex's name only has to outlive the Mutex itself.
+        static constexpr size_t max_name_length = 48;
+
+        Atomic<u8> state { State::Empty };
+        char name[max_name_length] {};
+        size_t name_length { 0 };
+        Atomic<u64> acquisitions { 0 };
+        Atomic<u64> contended_acquisitions { 0 };
+        Atomic<u64> total_wait_ns { 0 };
+        Atomic<u64> max_wait_ns { 0 };
+        Atomic<u64> exclusive_holds { 0 };
+        Atomic<u64> total_hold_ns { 0 };
+        Atomic<u64> max_hold_ns { 0 };
+
+        LockContentionStatistics statistics() const;
+    };
+
+    static constexpr size_t max_sites = 512;
+
+    static Site* site_for(StringView name);
+
+    static Atomic<bool> s_enabled;
+    static Atomic<size_t> s_dropped_sites;
+    static Site s_sites[max_sites];
+};
+
+}
@@ -7,10 +7,13 @@
 
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
+#include <Kernel/Locking/LockContention.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceManager.h>
 #include <Kernel/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
 
 extern bool g_in_early_boot;
 
@@ -49,6 +52,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
         }
         VERIFY(m_times_locked == 0);
         m_times_locked++;
+        record_uncontended_acquisition(mode);
 
 #if LOCK_DEBUG
         if (current_thread) {
@@ -87,6 +91,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
             // if we didn't block we must still be an exclusive lock
             VERIFY(m_mode == Mode::Exclusive);
             m_times_locked++;
+            record_uncontended_acquisition(mode);
         }
 
 #if LOCK_DEBUG
@@ -129,6 +134,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
             m_times_locked++;
             VERIFY(m_shared_holders > 0);
             ++m_shared_holders;
+            record_uncontended_acquisition(mode);
 #if LOCK_SHARED_UPGRADE_DEBUG
             auto it = m_shared_holders_map.find(current_thread);
             if (it != m_shared_holders_map.end())
@@ -205,6 +211,8 @@ void Mutex::unlock()
 
     if (m_times_locked == 0) {
         VERIFY(current_mode == Mode::Exclusive ? !m_holder : m_shared_holders == 0);
+        if (current_mode == Mode::Exclusive)
+            end_exclusive_hold();
 
         m_mode = Mode::Unlocked;
         unblock_waiters(current_mode);
@@ -230,10 +238,22 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& l
             append_to_list(lists.list_for_mode(mode));
     });
 
+    auto blocked_at = LockContention::timestamp_if_enabled(current_thread);
+
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waiting...", this, m_name);
     current_thread.block(*this, lock, requested_locks);
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waited", this, m_name);
 
+    if (blocked_at.has_value()) {
+        auto wait_time = TimeManagement::the().monotonic_time(TimePrecision::Precise) - blocked_at.value();
+        if (LockContention::is_enabled()) {
+            LockContention::record_contended_acquisition(m_name, wait_time);
+            if (mode == Mode::Exclusive)
+                start_exclusive_hold();
+        }
+        PerformanceManager::add_lock_contention_event(current_thread, *this, wait_time);
+    }
+
     m_blocked_thread_lists.with([&](auto& lists) {
         auto remove_from_list = [&]<typename L>(L& list) {
             VERIFY(list.contains(current_thread));
@@ -316,6 +336,7 @@ auto Mutex::force_unlock_exclusive_if_locked(u32& lock_count_to_restore) -> Mode
         VERIFY(m_times_locked > 0);
         lock_count_to_restore = m_times_locked;
         m_times_locked = 0;
+        end_exclusive_hold();
         m_mode = Mode::Unlocked;
         unblock_waiters(Mode::Exclusive);
         break;
@@ -361,6 +382,7 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
             m_times_locked = lock_count;
             VERIFY(!m_holder);
             m_holder = current_thread;
+            record_uncontended_acquisition(Mode::Exclusive);
         } else {
             VERIFY(m_mode == Mode::Exclusive);
             VERIFY(m_holder == current_thread);
@@ -374,4 +396,28 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
 #endif
 }
 
+void Mutex::record_uncontended_acquisition(Mode mode)
+{
+    VERIFY(m_lock.is_locked());
+    if (!LockContention::is_enabled())
+        return;
+    LockContention::record_acquisition(m_name);
+    if (mode == Mode::Exclusive && m_holder && m_exclusive_locked_at.is_zero())
+        start_exclusive_hold();
+}
+
+void Mutex::start_exclusive_hold()
+{
+    if (TimeManagement::is_initialized())
+        m_exclusive_locked_at = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+}
+
+void Mutex::end_exclusive_hold()
+{
+    auto locked_at = exchange(m_exclusive_locked_at, {});
+    if (locked_at.is_zero() || !LockContention::is_enabled())
+        return;
+    LockContention::record_exclusive_hold(m_name, TimeManagement::the().monotonic_time(TimePrecision::Precise) - locked_at);
+}
+
 }
@@ -10,6 +10,7 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/HashMap.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/LockLocation.h>
@@ -85,6 +86,11 @@ private:
     void block(Thread&, Mode, SpinlockLocker<Spinlock>&, u32);
     void unblock_waiters(Mode);
 
+    // Lock contention profiling, see LockContention.
+    void record_uncontended_acquisition(Mode);
+    void start_exclusive_hold();
+    void end_exclusive_hold();
+
     StringView m_name;
     Mode m_mode { Mode::Unlocked };
 
@@ -103,6 +109,9 @@ private:
     LockRefPtr<Thread> m_holder;
     size_t m_shared_holders { 0 };
 
+    // When the current exclusive holder took the lock, only tracked while lock contention profiling is enabled.
+    Time m_exclusive_locked_at {};
+
     struct BlockedThreadLists {
         BlockedThreadList exclusive;
         BlockedThreadList shared;
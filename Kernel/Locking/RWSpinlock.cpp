@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Locking/RWSpinlock.h>
+
+namespace Kernel {
+
+// NOTE: The lock hands back whether interrupts were enabled, so they can be restored on unlock.
+static u32 disable_interrupts_for_lock()
+{
+    u32 prev_flags = Processor::are_interrupts_enabled() ? 1 : 0;
+    Processor::enter_critical();
+    Processor::disable_interrupts();
+    return prev_flags;
+}
+
+static void restore_interrupts_after_unlock(u32 prev_flags)
+{
+    Processor::leave_critical();
+    if (prev_flags)
+        Processor::enable_interrupts();
+    else
+        Processor::disable_interrupts();
+}
+
+u32 RWSpinlock::lock()
+{
+    auto prev_flags = disable_interrupts_for_lock();
+    for (;;) {
+        auto state = m_state.load(AK::memory_order_relaxed);
+        if ((state & ~writer_waiting) == 0) {
+            if (m_state.compare_exchange_strong(state, writer, AK::memory_order_acquire))
+                break;
+            continue;
+        }
+        // Keep new readers out until the current ones are done.
+        if ((state & writer_waiting) == 0)
+            m_state.fetch_or(writer_waiting, AK::memory_order_relaxed);
+        Processor::wait_check();
+    }
+    track_lock_acquire(m_rank);
+    return prev_flags;
+}
+
+void RWSpinlock::unlock(u32 prev_flags)
+{
+    VERIFY(is_locked_exclusive());
+    track_lock_release(m_rank);
+    // NOTE: Another writer may have started waiting in the meantime, so only drop our own bit.
+    m_state.fetch_and(~writer, AK::memory_order_release);
+    restore_interrupts_after_unlock(prev_flags);
+}
+
+u32 RWSpinlock::lock_shared()
+{
+    auto prev_flags = disable_interrupts_for_lock();
+    for (;;) {
+        auto state = m_state.load(AK::memory_order_relaxed);
+        if ((state & (writer | writer_waiting)) == 0) {
+            VERIFY((state & reader_mask) != reader_mask);
+            if (m_state.compare_exchange_strong(state, state + 1, AK::memory_order_acquire))
+                break;
+            continue;
+        }
+        Processor::wait_check();
+    }
+    track_lock_acquire(m_rank);
+    return prev_flags;
+}
+
+void RWSpinlock::unlock_shared(u32 prev_flags)
+{
+    VERIFY((m_state.load(AK::memory_order_relaxed) & reader_mask) != 0);
+    track_lock_release(m_rank);
+    m_state.fetch_sub(1, AK::memory_order_release);
+    restore_interrupts_after_unlock(prev_flags);
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <Kernel/Locking/LockRank.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// A spinlock that can be held by any number of readers at once, or by a single writer.
+// A waiting writer keeps new readers out, so a steady stream of readers can't starve it.
+// NOTE: Unlike RecursiveSpinlock, neither mode may be taken recursively: a processor that already holds
+//       the lock shared deadlocks when trying to take it shared again while a writer is waiting.
+class RWSpinlock {
+    AK_MAKE_NONCOPYABLE(RWSpinlock);
+    AK_MAKE_NONMOVABLE(RWSpinlock);
+
+public:
+    constexpr RWSpinlock(LockRank rank)
+        : m_rank(rank)
+    {
+    }
+
+    // The exclusive mode uses the same interface as Spinlock, so it works with SpinlockLocker.
+    u32 lock();
+    void unlock(u32 prev_flags);
+
+    u32 lock_shared();
+    void unlock_shared(u32 prev_flags);
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked() const
+    {
+        return (m_state.load(AK::memory_order_relaxed) & ~writer_waiting) != 0;
+    }
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked_exclusive() const
+    {
+        return (m_state.load(AK::memory_order_relaxed) & writer) != 0;
+    }
+
+private:
+    static constexpr u32 writer = 1u << 31;
+    static constexpr u32 writer_waiting = 1u << 30;
+    static constexpr u32 reader_mask = writer_waiting - 1;
+
+    Atomic<u32> m_state { 0 };
+    const LockRank m_rank;
+};
+
+class [[nodiscard]] RWSpinlockSharedLocker {
+    AK_MAKE_NONCOPYABLE(RWSpinlockSharedLocker);
+    AK_MAKE_NONMOVABLE(RWSpinlockSharedLocker);
+
+public:
+    explicit RWSpinlockSharedLocker(RWSpinlock& lock)
+        : m_lock(lock)
+        , m_prev_flags(lock.lock_shared())
+    {
+    }
+
+    ~RWSpinlockSharedLocker()
+    {
+        m_lock.unlock_shared(m_prev_flags);
+    }
+
+private:
+    RWSpinlock& m_lock;
+    u32 m_prev_flags { 0 };
+};
+
+}
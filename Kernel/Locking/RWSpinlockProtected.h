@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Locking/RWSpinlock.h>
+
+namespace Kernel {
+
+template<typename T>
+class RWSpinlockProtected {
+    AK_MAKE_NONCOPYABLE(RWSpinlockProtected);
+    AK_MAKE_NONMOVABLE(RWSpinlockProtected);
+
+public:
+    template<typename... Args>
+    RWSpinlockProtected(LockRank rank, Args&&... args)
+        : m_value(forward<Args>(args)...)
+        , m_spinlock(rank)
+    {
+    }
+
+    template<typename Callback>
+    decltype(auto) with_shared(Callback callback) const
+    {
+        RWSpinlockSharedLocker locker(m_spinlock);
+        return callback(m_value);
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(Callback callback)
+    {
+        SpinlockLocker locker(m_spinlock);
+        return callback(m_value);
+    }
+
+    template<typename Callback>
+    void for_each_shared(Callback callback) const
+    {
+        with_shared([&](auto const& value) {
+            for (auto& item : value)
+                callback(item);
+        });
+    }
+
+    template<typename Callback>
+    void for_each_exclusive(Callback callback)
+    {
+        with_exclusive([&](auto& value) {
+            for (auto& item : value)
+                callback(item);
+        });
+    }
+
+private:
+    T m_value;
+    RWSpinlock mutable m_spinlock;
+};
+
+}
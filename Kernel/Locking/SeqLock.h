@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// A sequence lock lets readers proceed without writing to shared memory at all: they read optimistically
+// and retry if a writer got in the way. Writers serialize on a Spinlock and bump the sequence number
+// before and after updating, so it is odd while an update is in progress.
+// NOTE: Readers may observe torn data before retrying, so the protected data must be safe to copy
+//       in any state (i.e. no pointers that are followed while reading).
+class SeqLock {
+    AK_MAKE_NONCOPYABLE(SeqLock);
+    AK_MAKE_NONMOVABLE(SeqLock);
+
+public:
+    constexpr SeqLock(LockRank rank)
+        : m_write_lock(rank)
+    {
+    }
+
+    [[nodiscard]] ALWAYS_INLINE u32 read_begin() const
+    {
+        for (;;) {
+            auto sequence = m_sequence.load(AK::memory_order_acquire);
+            if ((sequence & 1) == 0)
+                return sequence;
+            Processor::wait_check();
+        }
+    }
+
+    [[nodiscard]] ALWAYS_INLINE bool read_retry(u32 sequence) const
+    {
+        AK::atomic_thread_fence(AK::memory_order_acquire);
+        return m_sequence.load(AK::memory_order_relaxed) != sequence;
+    }
+
+    // The write side uses the same interface as Spinlock, so it works with SpinlockLocker.
+    ALWAYS_INLINE u32 lock()
+    {
+        auto prev_flags = m_write_lock.lock();
+        m_sequence.fetch_add(1, AK::memory_order_relaxed);
+        AK::atomic_thread_fence(AK::memory_order_release);
+        return prev_flags;
+    }
+
+    ALWAYS_INLINE void unlock(u32 prev_flags)
+    {
+        m_sequence.fetch_add(1, AK::memory_order_release);
+        m_write_lock.unlock(prev_flags);
+    }
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked() const { return m_write_lock.is_locked(); }
+
+private:
+    Atomic<u32> m_sequence { 0 };
+    Spinlock m_write_lock;
+};
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/StdLibExtras.h>
+#include <Kernel/Locking/SeqLock.h>
+
+namespace Kernel {
+
+// Protects a small, trivially copyable value that is read far more often than it is written.
+template<typename T>
+requires(IsTriviallyCopyable<T>) class SeqLockProtected {
+    AK_MAKE_NONCOPYABLE(SeqLockProtected);
+    AK_MAKE_NONMOVABLE(SeqLockProtected);
+
+public:
+    template<typename... Args>
+    SeqLockProtected(LockRank rank, Args&&... args)
+        : m_value(forward<Args>(args)...)
+        , m_seqlock(rank)
+    {
+    }
+
+    // Returns a consistent copy of the value, retrying for as long as a writer gets in the way.
+    T read() const
+    {
+        alignas(T) u8 buffer[sizeof(T)];
+        u32 sequence;
+        do {
+            sequence = m_seqlock.read_begin();
+            __builtin_memcpy(buffer, &m_value, sizeof(T));
+        } while (m_seqlock.read_retry(sequence));
+        return bit_cast<T>(buffer);
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(Callback callback)
+    {
+        SpinlockLocker locker(m_seqlock);
+        return callback(m_value);
+    }
+
+    void write(T const& value)
+    {
+        with_exclusive([&](T& protected_value) { protected_value = value; });
+    }
+
+private:
+    T m_value;
+    SeqLock mutable m_seqlock;
+};
+
+}
@@ -381,9 +381,6 @@ size_t AddressSpace::amount_resident() const
 size_t AddressSpace::amount_shared() const
 {
     // FIXME: This will double count if multiple regions use the same physical page.
-    // FIXME: It doesn't work at the moment, since it relies on PhysicalPage ref counts,
-    //        and each PhysicalPage is only reffed by its VMObject. This needs to be refactored
-    //        so that every Region contributes +1 ref to each of its PhysicalPages.
     size_t amount = 0;
     for (auto const& region : m_region_tree.regions()) {
         amount += region.amount_shared();
@@ -391,6 +388,22 @@ size_t AddressSpace::amount_shared() const
     return amount;
 }
 
+size_t AddressSpace::amount_unique() const
+{
+    size_t amount = 0;
+    for (auto const& region : m_region_tree.regions())
+        amount += region.amount_unique();
+    return amount;
+}
+
+size_t AddressSpace::amount_proportional() const
+{
+    size_t amount = 0;
+    for (auto const& region : m_region_tree.regions())
+        amount += region.amount_proportional();
+    return amount;
+}
+
 size_t AddressSpace::amount_purgeable_volatile() const
 {
     size_t amount = 0;
@@ -417,4 +430,27 @@ size_t AddressSpace::amount_purgeable_nonvolatile() const
     return amount;
 }
 
+AddressSpace::MemoryUsage AddressSpace::memory_usage() const
+{
+    MemoryUsage usage;
+    for (auto const& region : m_region_tree.regions()) {
+        auto page_usage = region.page_usage();
+        usage.virtual_size += region.size();
+        usage.resident += page_usage.resident;
+        usage.shared += page_usage.shared;
+        usage.unique += page_usage.unique;
+        usage.proportional += page_usage.proportional;
+        if (!region.is_shared())
+            usage.dirty_private += region.vmobject().is_inode() ? region.amount_dirty() : page_usage.resident;
+        if (!region.vmobject().is_anonymous())
+            continue;
+        auto const& vmobject = static_cast<AnonymousVMObject const&>(region.vmobject());
+        if (vmobject.is_purgeable() && vmobject.is_volatile())
+            usage.purgeable_volatile += page_usage.resident;
+        else if (vmobject.is_purgeable())
+            usage.purgeable_nonvolatile += page_usage.resident;
+    }
+    return usage;
+}
+
 }
@@ -58,9 +58,24 @@ public:
     size_t amount_virtual() const;
     size_t amount_resident() const;
     size_t amount_shared() const;
+    size_t amount_unique() const;
+    size_t amount_proportional() const;
     size_t amount_purgeable_volatile() const;
     size_t amount_purgeable_nonvolatile() const;
 
+    struct MemoryUsage {
+        size_t virtual_size { 0 };
+        size_t resident { 0 };
+        size_t dirty_private { 0 };
+        size_t shared { 0 };
+        size_t unique { 0 };
+        size_t proportional { 0 };
+        size_t purgeable_volatile { 0 };
+        size_t purgeable_nonvolatile { 0 };
+    };
+    // All of the above but amount_clean_inode(), in a single pass over the pages of every region.
+    MemoryUsage memory_usage() const;
+
 private:
     AddressSpace(NonnullLockRefPtr<PageDirectory>, VirtualRange total_range);
 
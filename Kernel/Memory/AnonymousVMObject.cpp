@@ -34,7 +34,8 @@ ErrorOr<NonnullLockRefPtr<VMObject>> AnonymousVMObject::try_clone()
     // non-volatile memory available.
     size_t new_cow_pages_needed = 0;
     for (auto const& page : m_physical_pages) {
-        if (!page->is_shared_zero_page())
+        // Note: Swapped out pages don't have a physical page, but the clone shares their contents all the same.
+        if (!page || !page->is_shared_zero_page())
             ++new_cow_pages_needed;
     }
 
@@ -54,6 +55,8 @@ ErrorOr<NonnullLockRefPtr<VMObject>> AnonymousVMObject::try_clone()
     auto new_shared_committed_cow_pages = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) SharedCommittedCowPages(move(committed_pages))));
     auto new_physical_pages = TRY(this->try_clone_physical_pages());
     auto clone = TRY(try_create_with_shared_cow(*this, *new_shared_committed_cow_pages, move(new_physical_pages)));
+    for (auto const& it : m_swapped_out_pages)
+        TRY(clone->m_swapped_out_pages.try_set(it.key, it.value));
 
     // Both original and clone become COW. So create a COW map for ourselves
     // or reset all pages to be copied again if we were previously cloned
@@ -143,6 +146,7 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with
 AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, AllocationStrategy strategy, Optional<CommittedPhysicalPageSet> committed_pages)
     : VMObject(move(new_physical_pages))
     , m_unused_committed_pages(move(committed_pages))
+    , m_swappable(true)
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
@@ -172,6 +176,7 @@ AnonymousVMObject::AnonymousVMObject(LockWeakPtr<AnonymousVMObject> other, Nonnu
     : VMObject(move(new_physical_pages))
     , m_cow_parent(move(other))
     , m_shared_committed_cow_pages(move(shared_committed_cow_pages))
+    , m_swappable(m_cow_parent.strong_ref()->m_swappable)
     , m_purgeable(m_cow_parent.strong_ref()->m_purgeable)
 {
 }
@@ -276,6 +281,73 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+ErrorOr<void> AnonymousVMObject::allocate_pages(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+    bool did_allocate_any = false;
+    for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
+        {
+            SpinlockLocker locker(m_lock);
+            if (!m_physical_pages[i]->is_shared_zero_page())
+                continue;
+        }
+        auto page = TRY(MM.allocate_physical_page(MemoryManager::ShouldZeroFill::Yes));
+        SpinlockLocker locker(m_lock);
+        // Someone may have faulted the page in while we were allocating one.
+        if (!m_physical_pages[i]->is_shared_zero_page())
+            continue;
+        m_physical_pages[i] = move(page);
+        did_allocate_any = true;
+    }
+    if (did_allocate_any)
+        for_each_region([](auto& region) { region.remap(); });
+    return {};
+}
+
+void AnonymousVMObject::release_pages(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+    bool did_release_any = false;
+    {
+        SpinlockLocker locker(m_lock);
+        for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
+            auto& page = m_physical_pages[i];
+            if (page->is_shared_zero_page() || page->is_lazy_committed_page())
+                continue;
+            page = MM.shared_zero_page();
+            did_release_any = true;
+        }
+    }
+    if (did_release_any)
+        for_each_region([](auto& region) { region.remap(); });
+}
+
+bool AnonymousVMObject::try_install_large_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const& pages)
+{
+    SpinlockLocker lock(m_lock);
+    if (first_page_index + pages.size() > page_count())
+        return false;
+
+    size_t lazy_committed_page_count = 0;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto const& page_slot = physical_pages()[first_page_index + i];
+        if (page_slot.is_null())
+            return false;
+        if (page_slot->is_lazy_committed_page())
+            ++lazy_committed_page_count;
+        else if (!page_slot->is_shared_zero_page())
+            return false;
+    }
+
+    for (size_t i = 0; i < pages.size(); ++i)
+        physical_pages()[first_page_index + i] = pages[i];
+
+    // The new pages were allocated from the uncommitted pool, so give back what was committed for the replaced slots.
+    for (size_t i = 0; i < lazy_committed_page_count; ++i)
+        m_unused_committed_pages->uncommit_one();
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
@@ -328,6 +400,10 @@ PageFaultResponse AnonymousVMObject::handle_cow_fault(size_t page_index, Virtual
 
     auto& page_slot = physical_pages()[page_index];
 
+    // The page was swapped out after the fault happened. Accessing it again will swap it back in.
+    if (!page_slot)
+        return PageFaultResponse::Continue;
+
     // If we were sharing committed COW pages with another process, and the other process
     // has exhausted the supply, we can stop counting the shared pages.
     if (m_shared_committed_cow_pages && m_shared_committed_cow_pages->is_empty())
@@ -381,6 +457,129 @@ PageFaultResponse AnonymousVMObject::handle_cow_fault(size_t page_index, Virtual
     return PageFaultResponse::Continue;
 }
 
+bool AnonymousVMObject::can_swap_out()
+{
+    // Purgeable memory may as well be purged instead. Memory that the kernel maps has to stay put, since the kernel
+    // may touch it at a time where it can't handle a page fault, so we only swap out what only userspace maps.
+    if (!m_swappable || is_purgeable())
+        return false;
+    bool is_mapped = false;
+    bool is_only_mapped_by_userspace = true;
+    for_each_region([&](Region& region) {
+        is_mapped = true;
+        // Note: Looking at the page tables of a large page would break it up into small ones.
+        if (region.is_kernel() || region.are_large_pages_enabled())
+            is_only_mapped_by_userspace = false;
+    });
+    return is_mapped && is_only_mapped_by_userspace;
+}
+
+static bool is_zero_filled(ReadonlyBytes page)
+{
+    auto const* words = reinterpret_cast<u64 const*>(page.data());
+    for (size_t i = 0; i < page.size() / sizeof(u64); ++i) {
+        if (words[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+bool AnonymousVMObject::swap_out_page(size_t page_index, Bytes compression_buffer)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    auto& page_slot = m_physical_pages[page_index];
+
+    // Nobody may write to the page while we compress it, so take it away from everyone first.
+    // If we end up keeping it, the next access just maps it again.
+    for_each_region([&](Region& region) {
+        region.unmap_vmobject_page({}, page_index);
+    });
+
+    bool zero_filled = false;
+    Optional<size_t> compressed_size;
+    {
+        ReadonlyBytes page { MM.quickmap_page(*page_slot), PAGE_SIZE };
+        zero_filled = is_zero_filled(page);
+        if (!zero_filled)
+            compressed_size = CompressedPage::compress(page, compression_buffer);
+        MM.unquickmap_page();
+    }
+
+    if (zero_filled) {
+        page_slot = MM.shared_zero_page();
+        return true;
+    }
+    if (!compressed_size.has_value())
+        return false;
+
+    auto compressed_page_or_error = CompressedPage::try_create(compression_buffer.trim(compressed_size.value()));
+    if (compressed_page_or_error.is_error())
+        return false;
+    if (m_swapped_out_pages.try_set(page_index, compressed_page_or_error.release_value()).is_error())
+        return false;
+    page_slot = nullptr;
+    return true;
+}
+
+size_t AnonymousVMObject::swap_out_cold_pages(size_t max_page_count)
+{
+    SpinlockLocker lock(m_lock);
+    if (!can_swap_out())
+        return 0;
+
+    auto accessed_pages_or_error = Bitmap::try_create(page_count(), false);
+    if (accessed_pages_or_error.is_error())
+        return 0;
+    auto accessed_pages = accessed_pages_or_error.release_value();
+    for_each_region([&](Region& region) {
+        region.collect_accessed_pages({}, accessed_pages);
+    });
+
+    // Note: A page is only worth keeping compressed if that at least halves its size.
+    u8 compression_buffer[PAGE_SIZE / 2];
+    size_t swapped_out_page_count = 0;
+    for (size_t page_index = 0; page_index < page_count() && swapped_out_page_count < max_page_count; ++page_index) {
+        if (accessed_pages.get(page_index))
+            continue;
+        // A page that another VMObject still shares since a fork wouldn't go away, and anyone else who holds
+        // a reference to it (like a page fault that is being handled) may be about to map it.
+        auto const& page = m_physical_pages[page_index];
+        if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page() || page->ref_count() != 1)
+            continue;
+        if (swap_out_page(page_index, { compression_buffer, sizeof(compression_buffer) }))
+            ++swapped_out_page_count;
+    }
+    return swapped_out_page_count;
+}
+
+NonnullRefPtr<PhysicalPage> AnonymousVMObject::swap_in_page(Badge<Region>, size_t page_index, NonnullRefPtr<PhysicalPage> page)
+{
+    SpinlockLocker lock(m_lock);
+    auto& page_slot = m_physical_pages[page_index];
+    if (page_slot)
+        return *page_slot;
+
+    auto it = m_swapped_out_pages.find(page_index);
+    VERIFY(it != m_swapped_out_pages.end());
+    {
+        Bytes page_data { MM.quickmap_page(*page), PAGE_SIZE };
+        it->value->decompress_into(page_data);
+        MM.unquickmap_page();
+    }
+    m_swapped_out_pages.remove(it);
+
+    // Note: If the page was shared with a clone, its COW bit is still set, and the first write takes the page
+    //       fault that gives back the page we had committed for copying it.
+    page_slot = move(page);
+    return *page_slot;
+}
+
+void AnonymousVMObject::discard_swapped_out_page(Badge<Region>, size_t page_index)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    m_swapped_out_pages.remove(page_index);
+}
+
 AnonymousVMObject::SharedCommittedCowPages::SharedCommittedCowPages(CommittedPhysicalPageSet&& committed_pages)
     : m_committed_pages(move(committed_pages))
 {
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <Kernel/Memory/AllocationStrategy.h>
+#include <Kernel/Memory/CompressedPage.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PageFaultResponse.h>
 #include <Kernel/Memory/VMObject.h>
@@ -26,6 +28,12 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    // Replaces the shared zero pages in the given range with freshly allocated ones, so that writing to them can't fault.
+    ErrorOr<void> allocate_pages(size_t first_page_index, size_t page_count);
+    // Puts the shared zero page back into the given range.
+    void release_pages(size_t first_page_index, size_t page_count);
+    // Installs a run of freshly allocated pages, if none of the slots they would replace have been faulted in yet.
+    bool try_install_large_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const&);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -38,6 +46,14 @@ public:
 
     size_t purge();
 
+    // Compresses pages that nobody accessed since the last time this was called, up to `max_page_count` of them,
+    // and returns how many physical pages that gave back. Accessing those pages again decompresses them.
+    size_t swap_out_cold_pages(size_t max_page_count);
+    // Puts the contents of a swapped out page into the given page, which then takes its place.
+    // If someone else swapped it in first, the page they used is returned instead.
+    NonnullRefPtr<PhysicalPage> swap_in_page(Badge<Region>, size_t page_index, NonnullRefPtr<PhysicalPage>);
+    void discard_swapped_out_page(Badge<Region>, size_t page_index);
+
 private:
     class SharedCommittedCowPages;
 
@@ -59,6 +75,9 @@ private:
     ErrorOr<void> ensure_cow_map();
     ErrorOr<void> ensure_or_reset_cow_map();
 
+    bool can_swap_out();
+    bool swap_out_page(size_t page_index, Bytes compression_buffer);
+
     Optional<CommittedPhysicalPageSet> m_unused_committed_pages;
     Bitmap m_cow_map;
 
@@ -85,6 +104,11 @@ private:
     LockWeakPtr<AnonymousVMObject> m_cow_parent;
     LockRefPtr<SharedCommittedCowPages> m_shared_committed_cow_pages;
 
+    // The slots of swapped out pages are empty, and their contents live here instead.
+    HashMap<size_t, NonnullRefPtr<CompressedPage>> m_swapped_out_pages;
+
+    // Only memory we allocated ourselves may be swapped out; pages we were handed by physical address may be used for DMA.
+    bool m_swappable { false };
     bool m_purgeable { false };
     bool m_volatile { false };
     bool m_was_purged { false };
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <Kernel/Memory/CompressedPage.h>
+
+namespace Kernel::Memory {
+
+// The compressed data is a series of groups of up to eight items, each preceded by a byte that has a bit set for every
+// item in the group that is a back-reference rather than a literal byte. A back-reference takes two bytes, with how far
+// back the match starts (1 to 4096 bytes) in the upper 12 bits and its length (3 to 18 bytes) in the lower 4.
+static constexpr size_t min_match_length = 3;
+static constexpr size_t max_match_length = min_match_length + 15;
+static constexpr size_t hash_table_bits = 10;
+
+static Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> s_count;
+static Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> s_total_size;
+
+static size_t hash_at(ReadonlyBytes page, size_t offset)
+{
+    u32 value = page[offset] | (page[offset + 1] << 8) | (page[offset + 2] << 16);
+    return (value * 2654435761u) >> (32 - hash_table_bits);
+}
+
+Optional<size_t> CompressedPage::compress(ReadonlyBytes page, Bytes output)
+{
+    VERIFY(page.size() <= NumericLimits<u16>::max());
+
+    // The most recent offset (plus one, so that zero can mean none) at which each hash of three bytes was seen.
+    Array<u16, 1 << hash_table_bits> recent_offsets {};
+    auto remember_offset = [&](size_t offset) {
+        if (offset + min_match_length <= page.size())
+            recent_offsets[hash_at(page, offset)] = offset + 1;
+    };
+
+    size_t in = 0;
+    size_t out = 0;
+    size_t flags_offset = 0;
+    size_t items_in_group = 8;
+    while (in < page.size()) {
+        if (items_in_group == 8) {
+            if (out == output.size())
+                return {};
+            flags_offset = out;
+            output[out++] = 0;
+            items_in_group = 0;
+        }
+
+        size_t match_length = 0;
+        size_t match_distance = 0;
+        if (in + min_match_length <= page.size()) {
+            auto candidate = recent_offsets[hash_at(page, in)];
+            if (candidate != 0) {
+                size_t match_offset = candidate - 1;
+                auto longest_length = min(max_match_length, page.size() - in);
+                while (match_length < longest_length && page[match_offset + match_length] == page[in + match_length])
+                    ++match_length;
+                match_distance = in - match_offset;
+            }
+        }
+
+        if (match_length >= min_match_length) {
+            if (out + 2 > output.size())
+                return {};
+            u16 token = ((match_distance - 1) << 4) | (match_length - min_match_length);
+            output[out++] = token >> 8;
+            output[out++] = token & 0xff;
+            output[flags_offset] |= 1 << items_in_group;
+            for (size_t i = 0; i < match_length; ++i)
+                remember_offset(in + i);
+            in += match_length;
+        } else {
+            if (out == output.size())
+                return {};
+            remember_offset(in);
+            output[out++] = page[in++];
+        }
+        ++items_in_group;
+    }
+    return out;
+}
+
+ErrorOr<NonnullRefPtr<CompressedPage>> CompressedPage::try_create(ReadonlyBytes compressed_data)
+{
+    auto data = TRY(FixedArray<u8>::try_create(compressed_data));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) CompressedPage(move(data)));
+}
+
+CompressedPage::CompressedPage(FixedArray<u8>&& data)
+    : m_data(move(data))
+{
+    ++s_count;
+    s_total_size += m_data.size();
+}
+
+CompressedPage::~CompressedPage()
+{
+    --s_count;
+    s_total_size -= m_data.size();
+}
+
+void CompressedPage::decompress_into(Bytes page) const
+{
+    size_t in = 0;
+    size_t out = 0;
+    while (out < page.size()) {
+        VERIFY(in < m_data.size());
+        u8 flags = m_data[in++];
+        for (size_t item = 0; item < 8 && out < page.size(); ++item) {
+            if (!(flags & (1 << item))) {
+                VERIFY(in < m_data.size());
+                page[out++] = m_data[in++];
+                continue;
+            }
+            VERIFY(in + 2 <= m_data.size());
+            u16 token = (m_data[in] << 8) | m_data[in + 1];
+            in += 2;
+            size_t distance = (token >> 4) + 1;
+            size_t length = (token & 0xf) + min_match_length;
+            VERIFY(distance <= out && out + length <= page.size());
+            // Note: The match may overlap the bytes it produces, so this has to go one byte at a time.
+            for (size_t i = 0; i < length; ++i, ++out)
+                page[out] = page[out - distance];
+        }
+    }
+}
+
+size_t CompressedPage::count()
+{
+    return s_count;
+}
+
+size_t CompressedPage::total_size()
+{
+    return s_total_size;
+}
+
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/FixedArray.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/Span.h>
+
+namespace Kernel::Memory {
+
+// The contents of a page of anonymous memory that nobody touched in a while, compressed so that the physical page
+// can be used for something else. Since it's immutable, a VMObject and its clones can all share it after a fork.
+class CompressedPage final : public AtomicRefCounted<CompressedPage> {
+public:
+    // Compresses a page into `output`, and returns how many bytes of it were used.
+    // Gives up once it would take more than `output.size()` bytes.
+    static Optional<size_t> compress(ReadonlyBytes page, Bytes output);
+
+    static ErrorOr<NonnullRefPtr<CompressedPage>> try_create(ReadonlyBytes compressed_data);
+    ~CompressedPage();
+
+    void decompress_into(Bytes page) const;
+
+    size_t size() const { return m_data.size(); }
+
+    // How many compressed pages there are, and how many bytes they take up together.
+    static size_t count();
+    static size_t total_size();
+
+private:
+    explicit CompressedPage(FixedArray<u8>&&);
+
+    FixedArray<u8> m_data;
+};
+
+}
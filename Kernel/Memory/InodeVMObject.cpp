@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/InterruptDisabler.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/KBuffer.h>
 #include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
 
 namespace Kernel::Memory {
 
@@ -96,4 +99,124 @@ u32 InodeVMObject::writable_mappings() const
     return count;
 }
 
+// Resident bytes are copied to and from the caller's buffer in pieces of this size.
+static constexpr size_t resident_bytes_bounce_size = 256;
+
+ErrorOr<size_t> InodeVMObject::read_resident_bytes(u64 offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    size_t nread = 0;
+    while (nread < count) {
+        auto page_index = (offset + nread) / PAGE_SIZE;
+        if (page_index >= page_count())
+            break;
+
+        RefPtr<PhysicalPage> physical_page;
+        {
+            SpinlockLocker locker(m_lock);
+            physical_page = m_physical_pages[page_index];
+        }
+        if (!physical_page)
+            break;
+
+        auto offset_in_page = (offset + nread) % PAGE_SIZE;
+        auto chunk_size = min(count - nread, PAGE_SIZE - offset_in_page);
+
+        // NOTE: We can't touch the (possibly userspace) buffer while a page is quickmapped,
+        //       so the data takes a detour through a small buffer on the stack.
+        for (size_t copied = 0; copied < chunk_size;) {
+            u8 bounce_buffer[resident_bytes_bounce_size];
+            auto bounce_size = min(chunk_size - copied, resident_bytes_bounce_size);
+            {
+                InterruptDisabler disabler;
+                MM.read_from_physical_page(*physical_page, offset_in_page + copied, { bounce_buffer, bounce_size });
+            }
+            TRY(buffer.write(bounce_buffer, nread + copied, bounce_size));
+            copied += bounce_size;
+        }
+        nread += chunk_size;
+    }
+    return nread;
+}
+
+ErrorOr<void> InodeVMObject::update_resident_bytes(u64 offset, size_t count, UserOrKernelBuffer const& data)
+{
+    size_t nwritten = 0;
+    while (nwritten < count) {
+        auto page_index = (offset + nwritten) / PAGE_SIZE;
+        if (page_index >= page_count())
+            break;
+
+        auto offset_in_page = (offset + nwritten) % PAGE_SIZE;
+        auto chunk_size = min(count - nwritten, PAGE_SIZE - offset_in_page);
+
+        RefPtr<PhysicalPage> physical_page;
+        {
+            SpinlockLocker locker(m_lock);
+            physical_page = m_physical_pages[page_index];
+        }
+        for (size_t copied = 0; physical_page && copied < chunk_size;) {
+            u8 bounce_buffer[resident_bytes_bounce_size];
+            auto bounce_size = min(chunk_size - copied, resident_bytes_bounce_size);
+            TRY(data.read(bounce_buffer, nwritten + copied, bounce_size));
+
+            InterruptDisabler disabler;
+            MM.write_to_physical_page(*physical_page, offset_in_page + copied, { bounce_buffer, bounce_size });
+            copied += bounce_size;
+        }
+        nwritten += chunk_size;
+    }
+    return {};
+}
+
+ErrorOr<void> InodeVMObject::populate_pages(size_t first_page_index, size_t count)
+{
+    auto end_page_index = min(first_page_index + count, page_count());
+    OwnPtr<KBuffer> read_buffer;
+
+    for (auto page_index = first_page_index; page_index < end_page_index;) {
+        // Find the next run of pages that aren't resident, and read it from the inode in one go.
+        size_t run_start;
+        size_t run_end;
+        {
+            SpinlockLocker locker(m_lock);
+            while (page_index < end_page_index && m_physical_pages[page_index])
+                ++page_index;
+            run_start = page_index;
+            while (page_index < end_page_index && !m_physical_pages[page_index])
+                ++page_index;
+            run_end = page_index;
+        }
+        if (run_start == run_end)
+            break;
+
+        if (!read_buffer)
+            read_buffer = TRY(KBuffer::try_create_with_size("InodeVMObject: Readahead buffer"sv, (end_page_index - first_page_index) * PAGE_SIZE));
+
+        auto run_size = (run_end - run_start) * PAGE_SIZE;
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(read_buffer->data());
+        auto nread = TRY(m_inode->read_bytes(run_start * PAGE_SIZE, run_size, buffer, nullptr));
+        if (nread == 0)
+            break;
+        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+        memset(read_buffer->data() + nread, 0, run_size - nread);
+
+        auto pages_read = ceil_div(nread, static_cast<size_t>(PAGE_SIZE));
+        for (auto index = run_start; index < run_start + pages_read; ++index) {
+            auto physical_page = TRY(MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No));
+            {
+                InterruptDisabler disabler;
+                MM.write_to_physical_page(*physical_page, 0, { read_buffer->data() + (index - run_start) * PAGE_SIZE, PAGE_SIZE });
+            }
+
+            SpinlockLocker locker(m_lock);
+            // NOTE: Someone may have faulted this page in while we were reading, in which case we keep theirs.
+            if (!m_physical_pages[index])
+                m_physical_pages[index] = move(physical_page);
+        }
+        if (nread < run_size)
+            break;
+    }
+    return {};
+}
+
 }
@@ -27,6 +27,16 @@ public:
 
     u32 writable_mappings() const;
 
+    // These let read() and write() share the pages that are already resident in
+    // this VMObject, so that a file that is both mmap'd and read through a file
+    // description is only cached once, and both views stay coherent.
+    ErrorOr<size_t> read_resident_bytes(u64 offset, size_t count, UserOrKernelBuffer&) const;
+    ErrorOr<void> update_resident_bytes(u64 offset, size_t count, UserOrKernelBuffer const&);
+
+    // Reads the pages in the given range that aren't resident yet from the inode,
+    // so that later faults on them only have to map them.
+    ErrorOr<void> populate_pages(size_t first_page_index, size_t count);
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
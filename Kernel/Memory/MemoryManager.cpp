@@ -15,10 +15,12 @@
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/BootInfo.h>
 #include <Kernel/CMOS.h>
+#include <Kernel/Devices/MemoryPressureDevice.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/CompressedPage.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PageDirectory.h>
 #include <Kernel/Memory/PhysicalRegion.h>
@@ -546,9 +548,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(const_cast<PageDirectory&>(page_directory), page_directory_table_index);
-    PageDirectoryEntry const& pde = pd[page_directory_index];
+    PageDirectoryEntry& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+    if (pde.is_huge())
+        demote_large_page(page_directory, pde, vaddr);
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -563,6 +567,8 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
+    if (pde.is_present() && pde.is_huge())
+        demote_large_page(page_directory, pde, vaddr);
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
@@ -604,6 +610,8 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_present() && pde.is_huge())
+        demote_large_page(page_directory, pde, vaddr);
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -627,6 +635,77 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::try_promote_to_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % large_page_size == 0);
+
+    // NOTE: Kernel mappings are set up once and never touched by the page fault handler, so we only promote user mappings.
+    if (&page_directory == m_kernel_page_directory.ptr())
+        return false;
+
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || pde.is_huge())
+        return false;
+
+    auto page_table_base = pde.page_table_base();
+    auto* page_table = quickmap_pt(PhysicalAddress(page_table_base));
+
+    // All 512 entries have to map one physically contiguous and aligned 2 MiB range with identical permissions.
+    constexpr u64 relevant_flags = PageTableEntry::Present | PageTableEntry::ReadWrite | PageTableEntry::UserSupervisor
+        | PageTableEntry::WriteThrough | PageTableEntry::CacheDisabled | PageTableEntry::PAT | PageTableEntry::Global | PageTableEntry::NoExecute;
+    auto const& first_pte = page_table[0];
+    if (!first_pte.is_present() || first_pte.is_pat())
+        return false;
+    auto large_page_base = first_pte.physical_page_base();
+    if (large_page_base % large_page_size != 0)
+        return false;
+    auto flags = first_pte.raw() & relevant_flags;
+    for (size_t i = 1; i < pages_per_large_page; ++i) {
+        auto const& pte = page_table[i];
+        if ((pte.raw() & relevant_flags) != flags || pte.physical_page_base() != large_page_base + i * PAGE_SIZE)
+            return false;
+    }
+
+    // NOTE: The page table is kept around as-is, so that we can go back to it without allocating anything.
+    if (page_directory.m_large_page_tables.try_set(vaddr.get(), page_table_base).is_error())
+        return false;
+
+    pde.set_large_page_base(large_page_base);
+    pde.set_writable(first_pte.is_writable());
+    pde.set_user_allowed(first_pte.is_user_allowed());
+    pde.set_write_through(first_pte.is_write_through());
+    pde.set_cache_disabled(first_pte.is_cache_disabled());
+    pde.set_execute_disabled(first_pte.is_execute_disabled());
+    pde.set_huge(true);
+
+    flush_tlb(&page_directory, vaddr, pages_per_large_page);
+    return true;
+}
+
+void MemoryManager::demote_large_page(PageDirectory& page_directory, PageDirectoryEntry& pde, VirtualAddress vaddr)
+{
+    VERIFY(pde.is_huge());
+    auto large_page_vaddr = VirtualAddress { vaddr.get() & ~(large_page_size - 1) };
+    auto page_table_base = page_directory.m_large_page_tables.get(large_page_vaddr.get());
+    VERIFY(page_table_base.has_value());
+    page_directory.m_large_page_tables.remove(large_page_vaddr.get());
+
+    // The shadowed page table still holds the individual mappings, so we just have to point the PDE back at it.
+    pde.clear();
+    pde.set_page_table_base(page_table_base.value());
+    pde.set_user_allowed(true);
+    pde.set_present(true);
+    pde.set_writable(true);
+
+    flush_tlb(&page_directory, large_page_vaddr, pages_per_large_page);
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
@@ -821,6 +900,19 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 {
     VERIFY(page_count > 0);
     SpinlockLocker lock(s_mm_lock);
+    if (m_system_memory_info.physical_pages_uncommitted < page_count) {
+        // Volatile memory may be purged at any time anyway, so do that before we fail the commit.
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_anonymous())
+                return IterationDecision::Continue;
+            auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+            if (anonymous_vmobject.is_purgeable() && anonymous_vmobject.is_volatile())
+                anonymous_vmobject.purge();
+            if (m_system_memory_info.physical_pages_uncommitted >= page_count)
+                return IterationDecision::Break;
+            return IterationDecision::Continue;
+        });
+    }
     if (m_system_memory_info.physical_pages_uncommitted < page_count) {
         dbgln("MM: Unable to commit {} pages, have only {}", page_count, m_system_memory_info.physical_pages_uncommitted);
 
@@ -847,6 +939,7 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 
     m_system_memory_info.physical_pages_uncommitted -= page_count;
     m_system_memory_info.physical_pages_committed += page_count;
+    update_memory_pressure_level();
     return CommittedPhysicalPageSet { {}, page_count };
 }
 
@@ -859,6 +952,76 @@ void MemoryManager::uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, siz
 
     m_system_memory_info.physical_pages_uncommitted += page_count;
     m_system_memory_info.physical_pages_committed -= page_count;
+    update_memory_pressure_level();
+}
+
+void MemoryManager::update_memory_pressure_level()
+{
+    VERIFY(s_mm_lock.is_locked_by_current_processor());
+    auto total = m_system_memory_info.physical_pages;
+    auto available = m_system_memory_info.physical_pages_uncommitted;
+    auto level_with_margin = [&](PhysicalSize margin) {
+        if (available < total / 32 + margin)
+            return MemoryPressureLevel::Critical;
+        if (available < total / 8 + margin)
+            return MemoryPressureLevel::Low;
+        return MemoryPressureLevel::Normal;
+    };
+
+    auto current_level = memory_pressure_level();
+    auto level = level_with_margin(0);
+    // Note: Getting out of a level takes a bit more memory than getting into it did, so that a single page
+    //       coming and going doesn't wake up everyone who is listening.
+    if (level < current_level)
+        level = level_with_margin(total / 64);
+    if (level == current_level)
+        return;
+
+    m_memory_pressure_level = level;
+    // We are holding the MM lock here, so let the listeners know once we've let go of it.
+    Processor::deferred_call_queue([] {
+        MemoryPressureDevice::did_change_memory_pressure_level();
+    });
+}
+
+size_t MemoryManager::swap_out_cold_pages()
+{
+    size_t wanted_page_count = 0;
+    {
+        SpinlockLocker lock(s_mm_lock);
+        auto const& info = m_system_memory_info;
+        // Compressed pages live on the kernel heap, so don't let them crowd out everything else.
+        if (CompressedPage::total_size() >= info.physical_pages * PAGE_SIZE / 4)
+            return 0;
+        // Aim for the amount that gets us out of the Low memory pressure level.
+        auto target_page_count = info.physical_pages / 8 + info.physical_pages / 64;
+        if (info.physical_pages_uncommitted < target_page_count)
+            wanted_page_count = target_page_count - info.physical_pages_uncommitted;
+    }
+
+    // Note: We can't hold the lock of the VMObject list while swapping out pages, since that allocates memory,
+    //       which may have to purge volatile VMObjects.
+    size_t anonymous_vmobject_count = 0;
+    for_each_vmobject([&](VMObject& vmobject) {
+        if (vmobject.is_anonymous())
+            ++anonymous_vmobject_count;
+    });
+    Vector<NonnullLockRefPtr<AnonymousVMObject>> anonymous_vmobjects;
+    if (anonymous_vmobjects.try_ensure_capacity(anonymous_vmobject_count).is_error())
+        return 0;
+    for_each_vmobject([&](VMObject& vmobject) {
+        if (anonymous_vmobjects.size() == anonymous_vmobjects.capacity())
+            return IterationDecision::Break;
+        if (vmobject.is_anonymous())
+            anonymous_vmobjects.unchecked_append(static_cast<AnonymousVMObject&>(vmobject));
+        return IterationDecision::Continue;
+    });
+
+    // Every VMObject gets looked at even once we have enough, so that all pages age at the same rate.
+    size_t swapped_out_page_count = 0;
+    for (auto& anonymous_vmobject : anonymous_vmobjects)
+        swapped_out_page_count += anonymous_vmobject->swap_out_cold_pages(wanted_page_count - min(swapped_out_page_count, wanted_page_count));
+    return swapped_out_page_count;
 }
 
 void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
@@ -877,6 +1040,7 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
         // committed and allocated are only freed upon request. Once
         // returned there is no guarantee being able to get them back.
         ++m_system_memory_info.physical_pages_uncommitted;
+        update_memory_pressure_level();
         return;
     }
     PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
@@ -895,6 +1059,7 @@ RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
         if (m_system_memory_info.physical_pages_uncommitted == 0)
             return {};
         m_system_memory_info.physical_pages_uncommitted--;
+        update_memory_pressure_level();
     }
     for (auto& region : m_physical_regions) {
         page = region.take_free_page();
@@ -1000,6 +1165,7 @@ ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_ph
             }
             m_system_memory_info.physical_pages_uncommitted -= page_count;
             m_system_memory_info.physical_pages_used += page_count;
+            update_memory_pressure_level();
             return physical_pages;
         }
     }
@@ -1008,6 +1174,38 @@ ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_ph
     return ENOMEM;
 }
 
+ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_physical_large_page()
+{
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    {
+        SpinlockLocker mm_lock(s_mm_lock);
+
+        // We need to make sure we don't touch pages that we have committed to
+        if (m_system_memory_info.physical_pages_uncommitted < pages_per_large_page)
+            return ENOMEM;
+
+        for (auto& physical_region : m_physical_regions) {
+            physical_pages = physical_region.take_free_large_page();
+            if (!physical_pages.is_empty())
+                break;
+        }
+        if (physical_pages.is_empty())
+            return ENOMEM;
+
+        m_system_memory_info.physical_pages_uncommitted -= pages_per_large_page;
+        m_system_memory_info.physical_pages_used += pages_per_large_page;
+        update_memory_pressure_level();
+    }
+
+    for (auto& physical_page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(physical_page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1182,6 +1380,22 @@ void MemoryManager::copy_physical_page(PhysicalPage& physical_page, u8 page_buff
     unquickmap_page();
 }
 
+void MemoryManager::read_from_physical_page(PhysicalPage& physical_page, size_t offset_in_page, Bytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(bytes.data(), quickmapped_page + offset_in_page, bytes.size());
+    unquickmap_page();
+}
+
+void MemoryManager::write_to_physical_page(PhysicalPage& physical_page, size_t offset_in_page, ReadonlyBytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(quickmapped_page + offset_in_page, bytes.data(), bytes.size());
+    unquickmap_page();
+}
+
 ErrorOr<NonnullOwnPtr<Memory::Region>> MemoryManager::create_identity_mapped_region(PhysicalAddress address, size_t size)
 {
     auto vmobject = TRY(Memory::AnonymousVMObject::try_create_for_physical_range(address, size));
@@ -32,11 +32,22 @@ namespace Kernel::Memory {
 
 ErrorOr<FlatPtr> page_round_up(FlatPtr x);
 
+// How close we are to running out of physical memory that can still be committed.
+enum class MemoryPressureLevel : u8 {
+    Normal,
+    Low,
+    Critical,
+};
+
 constexpr FlatPtr page_round_down(FlatPtr x)
 {
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// A large page is mapped by a single page directory entry instead of a full page table.
+static constexpr size_t large_page_size = 2 * MiB;
+static constexpr size_t pages_per_large_page = large_page_size / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -172,6 +183,8 @@ public:
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_physical_pages(size_t size);
+    // Allocates a zero-filled, physically contiguous and 2 MiB aligned run of pages_per_large_page pages.
+    ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_physical_large_page();
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -199,6 +212,12 @@ public:
         return m_system_memory_info;
     }
 
+    MemoryPressureLevel memory_pressure_level() const { return m_memory_pressure_level; }
+
+    // Compresses anonymous pages that weren't accessed since the last call, until there is enough memory again.
+    // Returns how many physical pages that gave back.
+    size_t swap_out_cold_pages();
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -237,6 +256,8 @@ public:
     PhysicalAddress get_physical_address(PhysicalPage const&);
 
     void copy_physical_page(PhysicalPage&, u8 page_buffer[PAGE_SIZE]);
+    void read_from_physical_page(PhysicalPage&, size_t offset_in_page, Bytes);
+    void write_to_physical_page(PhysicalPage&, size_t offset_in_page, ReadonlyBytes);
 
     IterationDecision for_each_physical_memory_range(Function<IterationDecision(PhysicalMemoryRange const&)>);
 
@@ -278,6 +299,12 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    // Replaces the page table mapping the 2 MiB range at `vaddr` with a single large page, if all of its entries allow it.
+    bool try_promote_to_large_page(PageDirectory&, VirtualAddress);
+    void demote_large_page(PageDirectory&, PageDirectoryEntry&, VirtualAddress);
+
+    void update_memory_pressure_level();
+
     ALWAYS_INLINE void verify_system_memory_info_consistency() const
     {
         auto physical_pages_unused = m_system_memory_info.physical_pages_committed + m_system_memory_info.physical_pages_uncommitted;
@@ -290,6 +317,7 @@ private:
     RefPtr<PhysicalPage> m_lazy_committed_page;
 
     SystemMemoryInfo m_system_memory_info;
+    Atomic<MemoryPressureLevel, AK::MemoryOrder::memory_order_relaxed> m_memory_pressure_level { MemoryPressureLevel::Normal };
 
     NonnullOwnPtrVector<PhysicalRegion> m_physical_regions;
     OwnPtr<PhysicalRegion> m_physical_pages_region;
@@ -73,6 +73,10 @@ private:
     RefPtr<PhysicalPage> m_directory_pages[4];
 #endif
     RecursiveSpinlock m_lock { LockRank::None };
+
+    // Maps the base address of each 2 MiB range that is currently mapped as a large page
+    // to the page table that mapped it before promotion.
+    HashMap<FlatPtr, PhysicalPtr> m_large_page_tables;
 };
 
 void activate_kernel_page_directory(PageDirectory const& pgd);
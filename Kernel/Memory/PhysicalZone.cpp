@@ -64,6 +64,26 @@ Optional<PhysicalAddress> PhysicalZone::allocate_block(size_t order)
     return m_base_address.offset(result.value() * ZONE_CHUNK_SIZE);
 }
 
+Optional<PhysicalAddress> PhysicalZone::allocate_aligned_block(size_t order)
+{
+    FlatPtr block_size_in_bytes = PAGE_SIZE << order;
+    if (m_base_address.get() % block_size_in_bytes == 0)
+        return allocate_block(order);
+
+    // Buddy blocks are only aligned relative to the zone base, so allocate a block twice the size
+    // and give back the pages around the aligned block inside of it.
+    auto base = allocate_block(order + 1);
+    if (!base.has_value())
+        return {};
+    auto aligned_base = PhysicalAddress { round_up_to_power_of_two(base->get(), block_size_in_bytes) };
+    for (auto address = *base; address < aligned_base; address = address.offset(PAGE_SIZE))
+        deallocate_block(address, 0);
+    auto end = base->offset(2 * block_size_in_bytes);
+    for (auto address = aligned_base.offset(block_size_in_bytes); address < end; address = address.offset(PAGE_SIZE))
+        deallocate_block(address, 0);
+    return aligned_base;
+}
+
 Optional<PhysicalZone::ChunkIndex> PhysicalZone::allocate_block_impl(size_t order)
 {
     if (order > max_order)
@@ -27,6 +27,9 @@ public:
     PhysicalZone(PhysicalAddress base, size_t page_count);
 
     Optional<PhysicalAddress> allocate_block(size_t order);
+    // Like allocate_block(), but the returned address is aligned to the block size in physical memory,
+    // not just relative to the zone base.
+    Optional<PhysicalAddress> allocate_aligned_block(size_t order);
     void deallocate_block(PhysicalAddress, size_t order);
 
     void dump() const;
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Memory.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/InterruptDisabler.h>
 #include <Kernel/Arch/PageDirectory.h>
@@ -20,9 +21,12 @@
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
 #include <Kernel/Thread.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel::Memory {
 
+DEFINE_SLAB_CACHE(Region);
+
 Region::Region()
     : m_range(VirtualRange({}, 0))
 {
@@ -109,6 +113,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_large_pages_enabled(are_large_pages_enabled());
         return region;
     }
 
@@ -119,7 +124,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
 
     // Set up a COW region. The parent (this) region becomes COW as well!
     if (is_writable())
-        remap();
+        remap_mapped_pages();
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -133,6 +138,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         clone_region->set_stack(true);
     }
     clone_region->set_syscall_region(is_syscall_region());
+    clone_region->set_large_pages_enabled(are_large_pages_enabled());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
     return clone_region;
 }
@@ -171,15 +177,46 @@ size_t Region::amount_resident() const
     return bytes;
 }
 
+// How many regions map the page, both through this VMObject and through the ones it shares the page with since a fork.
+static size_t sharer_count(VMObject const& vmobject, size_t page_index_in_vmobject, PhysicalPage const& page)
+{
+    // Note: Every VMObject holding the page has a reference to it, and so does the caller.
+    auto vmobject_count = max(page.ref_count(), 2u) - 1;
+    return vmobject_count * max<size_t>(vmobject.mapping_count(page_index_in_vmobject), 1);
+}
+
 size_t Region::amount_shared() const
 {
-    size_t bytes = 0;
+    return page_usage().shared;
+}
+
+size_t Region::amount_unique() const
+{
+    return page_usage().unique;
+}
+
+size_t Region::amount_proportional() const
+{
+    return page_usage().proportional;
+}
+
+Region::PageUsage Region::page_usage() const
+{
+    PageUsage usage;
+    SpinlockLocker vmobject_locker(vmobject().m_lock);
     for (size_t i = 0; i < page_count(); ++i) {
-        auto page = physical_page(i);
-        if (page && page->ref_count() > 1 && !page->is_shared_zero_page() && !page->is_lazy_committed_page())
-            bytes += PAGE_SIZE;
+        RefPtr<PhysicalPage> page = vmobject().physical_pages()[first_page_index() + i];
+        if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page())
+            continue;
+        auto sharers = sharer_count(vmobject(), first_page_index() + i, *page);
+        usage.resident += PAGE_SIZE;
+        if (sharers > 1)
+            usage.shared += PAGE_SIZE;
+        else
+            usage.unique += PAGE_SIZE;
+        usage.proportional += PAGE_SIZE / sharers;
     }
-    return bytes;
+    return usage;
 }
 
 ErrorOr<NonnullOwnPtr<Region>> Region::try_create_user_accessible(VirtualRange const& range, NonnullLockRefPtr<VMObject> vmobject, size_t offset_in_vmobject, OwnPtr<KString> name, Region::Access access, Cacheable cacheable, bool shared)
@@ -323,6 +360,26 @@ void Region::remap()
         TODO();
 }
 
+void Region::remap_mapped_pages()
+{
+    VERIFY(m_page_directory);
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    for (size_t page_index = 0; page_index < page_count(); ++page_index) {
+        auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+        if (!pte || !pte->is_present())
+            continue;
+        // NOTE: This can't fail, as the page table for this page already exists.
+        VERIFY(map_individual_page_impl(page_index));
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
+}
+
+bool Region::can_be_mapped_lazily() const
+{
+    // These are the only VMObjects we know how to fault in on a not-present fault.
+    return vmobject().is_anonymous() || vmobject().is_inode();
+}
+
 ErrorOr<void> Region::set_write_combine(bool enable)
 {
     if (enable && !Processor::current().has_pat()) {
@@ -341,13 +398,46 @@ void Region::clear_to_zero()
     SpinlockLocker locker(vmobject().m_lock);
     for (auto i = 0u; i < page_count(); ++i) {
         auto& page = physical_page_slot(i);
-        VERIFY(page);
-        if (page->is_shared_zero_page())
+        if (!page)
+            static_cast<AnonymousVMObject&>(vmobject()).discard_swapped_out_page({}, translate_to_vmobject_page(i));
+        else if (page->is_shared_zero_page())
             continue;
         page = MM.shared_zero_page();
     }
 }
 
+void Region::collect_accessed_pages(Badge<AnonymousVMObject>, Bitmap& accessed_pages)
+{
+    if (!m_page_directory)
+        return;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    bool cleared_any = false;
+    for (size_t page_index = 0; page_index < page_count(); ++page_index) {
+        auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+        if (!pte || !pte->is_present() || !pte->is_accessed())
+            continue;
+        accessed_pages.set(translate_to_vmobject_page(page_index), true);
+        pte->set_accessed(false);
+        cleared_any = true;
+    }
+    // Pages that stay in the TLB would never look accessed again otherwise.
+    if (cleared_any)
+        MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
+}
+
+void Region::unmap_vmobject_page(Badge<AnonymousVMObject>, size_t page_index)
+{
+    if (!m_page_directory || !translate_vmobject_page(page_index))
+        return;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    auto* pte = MM.pte(*m_page_directory, page_vaddr);
+    if (!pte || !pte->is_present())
+        return;
+    pte->clear();
+    MemoryManager::flush_tlb(m_page_directory, page_vaddr);
+}
+
 PageFaultResponse Region::handle_fault(PageFault const& fault)
 {
     auto page_index_in_region = page_index_from_address(fault.vaddr());
@@ -365,22 +455,45 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
             return handle_inode_fault(page_index_in_region);
         }
 
-        SpinlockLocker vmobject_locker(vmobject().m_lock);
-        auto& page_slot = physical_page_slot(page_index_in_region);
-        if (page_slot->is_lazy_committed_page()) {
-            auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
-            VERIFY(m_vmobject->is_anonymous());
-            page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
-            if (!remap_vmobject_page(page_index_in_vmobject, *page_slot))
+        auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
+        RefPtr<PhysicalPage> page;
+        {
+            SpinlockLocker vmobject_locker(vmobject().m_lock);
+            auto& page_slot = physical_page_slot(page_index_in_region);
+            if (page_slot && page_slot->is_lazy_committed_page()) {
+                VERIFY(m_vmobject->is_anonymous());
+                page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
+                if (!remap_vmobject_page(page_index_in_vmobject, *page_slot))
+                    return PageFaultResponse::OutOfMemory;
+                return PageFaultResponse::Continue;
+            }
+            page = page_slot;
+        }
+
+        if (!page && vmobject().is_anonymous()) {
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(swapped out) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            return handle_swap_in_fault(page_index_in_region);
+        }
+
+        if (page && vmobject().is_anonymous()) {
+            // The page tables of a forked child are populated on demand, so this page simply hasn't been mapped here yet.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(lazy) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            if (fault.is_write() && is_writable() && should_cow(page_index_in_region)) {
+                if (page->is_shared_zero_page())
+                    return handle_zero_fault(page_index_in_region, *page);
+                return handle_cow_fault(page_index_in_region);
+            }
+            if (!remap_vmobject_page(page_index_in_vmobject, *page))
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
-        dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
-        if (page_slot) {
-            dbgln("     - Physical page: {}", page_slot->paddr());
-            dbgln("     - Lazy committed: {}", page_slot->is_lazy_committed_page());
-            dbgln("     - Shared zero: {}", page_slot->is_shared_zero_page());
+        dbgln("     - Physical page slot pointer: {:p}", page.ptr());
+        if (page) {
+            dbgln("     - Physical page: {}", page->paddr());
+            dbgln("     - Lazy committed: {}", page->is_lazy_committed_page());
+            dbgln("     - Shared zero: {}", page->is_shared_zero_page());
         }
         return PageFaultResponse::ShouldCrash;
     }
@@ -388,7 +501,7 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
     if (fault.access() == PageFault::Access::Write && is_writable() && should_cow(page_index_in_region)) {
         dbgln_if(PAGE_FAULT_DEBUG, "PV(cow) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
         auto phys_page = physical_page(page_index_in_region);
-        if (phys_page->is_shared_zero_page() || phys_page->is_lazy_committed_page()) {
+        if (phys_page && (phys_page->is_shared_zero_page() || phys_page->is_lazy_committed_page())) {
             dbgln_if(PAGE_FAULT_DEBUG, "NP(zero) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
             return handle_zero_fault(page_index_in_region, *phys_page);
         }
@@ -408,6 +521,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (m_large_pages_enabled && try_handle_large_zero_fault(page_index_in_region))
+        return PageFaultResponse::Continue;
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -446,6 +562,35 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+bool Region::try_handle_large_zero_fault(size_t page_index_in_region)
+{
+    // We can only use a large page if the whole 2 MiB aligned range around the faulting address is part of this region.
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(large_page_size - 1) };
+    if (large_page_vaddr < vaddr() || large_page_vaddr.offset(large_page_size) > range().end())
+        return false;
+    size_t first_page_index_in_region = (large_page_vaddr.get() - vaddr().get()) / PAGE_SIZE;
+
+    auto physical_pages_or_error = MM.allocate_physical_large_page();
+    if (physical_pages_or_error.is_error())
+        return false;
+    auto physical_pages = physical_pages_or_error.release_value();
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_install_large_page({}, translate_to_vmobject_page(first_page_index_in_region), physical_pages))
+        return false;
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED LARGE PAGE {}", physical_pages[0].paddr());
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        // NOTE: If this fails, the regular zero fault path will find the installed page and retry mapping it.
+        if (!map_individual_page_impl(first_page_index_in_region + i))
+            return false;
+    }
+    if (!MM.try_promote_to_large_page(*m_page_directory, large_page_vaddr))
+        MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, pages_per_large_page);
+    return true;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -457,11 +602,31 @@ PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto response = reinterpret_cast<AnonymousVMObject&>(vmobject()).handle_cow_fault(page_index_in_vmobject, vaddr().offset(page_index_in_region * PAGE_SIZE));
-    if (!remap_vmobject_page(page_index_in_vmobject, *vmobject().physical_pages()[page_index_in_vmobject]))
+    auto page = physical_page(page_index_in_region);
+    if (page && !remap_vmobject_page(page_index_in_vmobject, *page))
         return PageFaultResponse::OutOfMemory;
     return response;
 }
 
+PageFaultResponse Region::handle_swap_in_fault(size_t page_index_in_region)
+{
+    VERIFY(vmobject().is_anonymous());
+
+    auto page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+    if (page_or_error.is_error()) {
+        dmesgln("MM: handle_swap_in_fault was unable to allocate a physical page");
+        return PageFaultResponse::OutOfMemory;
+    }
+
+    auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
+    auto page = static_cast<AnonymousVMObject&>(vmobject()).swap_in_page({}, page_index_in_vmobject, page_or_error.release_value());
+    if (!remap_vmobject_page(page_index_in_vmobject, move(page))) {
+        dmesgln("MM: handle_swap_in_fault was unable to allocate a page table to map {}", vaddr_from_page_index(page_index_in_region));
+        return PageFaultResponse::OutOfMemory;
+    }
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
 {
     VERIFY(vmobject().is_inode());
@@ -473,6 +638,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& vmobject_physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
 
+    bool is_resident = false;
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
@@ -480,9 +646,13 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
             dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else before reading, remapping.");
             if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
                 return PageFaultResponse::OutOfMemory;
-            return PageFaultResponse::Continue;
+            is_resident = true;
         }
     }
+    if (is_resident) {
+        fault_around_inode_page(page_index_in_region, ShouldReadAhead::No);
+        return PageFaultResponse::Continue;
+    }
 
     dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
 
@@ -540,9 +710,51 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
         return PageFaultResponse::OutOfMemory;
 
+    fault_around_inode_page(page_index_in_region, ShouldReadAhead::Yes);
     return PageFaultResponse::Continue;
 }
 
+void Region::fault_around_inode_page(size_t page_index_in_region, ShouldReadAhead should_read_ahead)
+{
+    // Map the already resident neighbours of a faulting page right away, so that code and data which is
+    // touched in order doesn't take a separate fault for every single page.
+    static constexpr size_t fault_around_page_count = 16;
+
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    auto window_start = page_index_in_region & ~(fault_around_page_count - 1);
+    auto window_end = min(window_start + fault_around_page_count, page_count());
+
+    bool has_missing_pages = false;
+    {
+        SpinlockLocker page_lock(m_page_directory->get_lock());
+        for (auto page_index = window_start; page_index < window_end; ++page_index) {
+            if (page_index == page_index_in_region)
+                continue;
+            auto page = physical_page(page_index);
+            if (!page) {
+                has_missing_pages = true;
+                continue;
+            }
+            if (!map_individual_page_impl(page_index, move(page)))
+                break;
+        }
+        MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(window_start), window_end - window_start);
+    }
+
+    if (!has_missing_pages || should_read_ahead == ShouldReadAhead::No)
+        return;
+
+    // Read the rest of the window in the background. The pages are mapped by the fault that eventually touches them.
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(window_start);
+    auto count = window_end - window_start;
+    auto result = g_readahead_work->try_queue([vmobject = NonnullLockRefPtr<InodeVMObject> { inode_vmobject }, first_page_index_in_vmobject, count]() mutable {
+        if (auto populate_result = vmobject->populate_pages(first_page_index_in_vmobject, count); populate_result.is_error())
+            dbgln_if(PAGE_FAULT_DEBUG, "fault_around_inode_page: Error ({}) while reading ahead", populate_result.error());
+    });
+    if (result.is_error())
+        dbgln_if(PAGE_FAULT_DEBUG, "fault_around_inode_page: Unable to queue readahead");
+}
+
 RefPtr<PhysicalPage> Region::physical_page(size_t index) const
 {
     SpinlockLocker vmobject_locker(vmobject().m_lock);
@@ -11,6 +11,7 @@
 #include <AK/IntrusiveList.h>
 #include <AK/IntrusiveRedBlackTree.h>
 #include <Kernel/Forward.h>
+#include <Kernel/Heap/SlabCache.h>
 #include <Kernel/KString.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Memory/PageFaultResponse.h>
@@ -35,6 +36,8 @@ class Region final
     friend class MemoryManager;
     friend class RegionTree;
 
+    MAKE_SLAB_ALLOCATED(Region);
+
 public:
     enum Access : u8 {
         None = 0,
@@ -174,6 +177,19 @@ public:
     [[nodiscard]] size_t amount_resident() const;
     [[nodiscard]] size_t amount_shared() const;
     [[nodiscard]] size_t amount_dirty() const;
+    // Resident memory that no other region maps (USS).
+    [[nodiscard]] size_t amount_unique() const;
+    // Resident memory, with every page divided evenly between the regions that map it (PSS).
+    [[nodiscard]] size_t amount_proportional() const;
+
+    struct PageUsage {
+        size_t resident { 0 };
+        size_t shared { 0 };
+        size_t unique { 0 };
+        size_t proportional { 0 };
+    };
+    // All of the above but amount_dirty(), in a single pass over the pages.
+    [[nodiscard]] PageUsage page_usage() const;
 
     [[nodiscard]] bool should_cow(size_t page_index) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
@@ -192,14 +208,27 @@ public:
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock>& pd_locker);
 
     void remap();
+    // Like remap(), but only touches pages that are currently present in the page tables.
+    void remap_mapped_pages();
+
+    // Whether page faults can fill in this region's mappings, so that it doesn't have to be mapped up front.
+    [[nodiscard]] bool can_be_mapped_lazily() const;
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
     void clear_to_zero();
 
+    // Marks the pages of the VMObject that were accessed through this region since the last call.
+    void collect_accessed_pages(Badge<AnonymousVMObject>, Bitmap& accessed_pages);
+    // Takes a page of the VMObject out of this region's page tables, so that the next access to it faults.
+    void unmap_vmobject_page(Badge<AnonymousVMObject>, size_t page_index);
+
     [[nodiscard]] bool is_syscall_region() const { return m_syscall_region; }
     void set_syscall_region(bool b) { m_syscall_region = b; }
 
+    [[nodiscard]] bool are_large_pages_enabled() const { return m_large_pages_enabled; }
+    void set_large_pages_enabled(bool b) { m_large_pages_enabled = b; }
+
     [[nodiscard]] bool mmapped_from_readable() const { return m_mmapped_from_readable; }
     [[nodiscard]] bool mmapped_from_writable() const { return m_mmapped_from_writable; }
 
@@ -220,7 +249,14 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
+    enum class ShouldReadAhead {
+        No,
+        Yes,
+    };
+    void fault_around_inode_page(size_t page_index, ShouldReadAhead);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalPage& page_in_slot_at_time_of_fault);
+    [[nodiscard]] PageFaultResponse handle_swap_in_fault(size_t page_index);
+    [[nodiscard]] bool try_handle_large_zero_fault(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
@@ -237,6 +273,7 @@ private:
     bool m_mmap : 1 { false };
     bool m_syscall_region : 1 { false };
     bool m_write_combine : 1 { false };
+    bool m_large_pages_enabled : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
 
@@ -21,6 +21,7 @@ ScopedAddressSpaceSwitcher::~ScopedAddressSpaceSwitcher()
 {
     InterruptDisabler disabler;
     Thread::current()->regs().cr3 = m_previous_cr3;
+    Processor::current().set_active_cr3(m_previous_cr3);
     write_cr3(m_previous_cr3);
 }
 
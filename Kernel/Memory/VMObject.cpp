@@ -38,4 +38,15 @@ VMObject::~VMObject()
     VERIFY(m_regions.is_empty());
 }
 
+size_t VMObject::mapping_count(size_t page_index) const
+{
+    SpinlockLocker locker(m_lock);
+    size_t count = 0;
+    for (auto const& region : m_regions) {
+        if (page_index >= region.first_page_index() && page_index < region.first_page_index() + region.page_count())
+            ++count;
+    }
+    return count;
+}
+
 }
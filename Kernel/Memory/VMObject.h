@@ -54,6 +54,9 @@ public:
         m_regions.remove(region);
     }
 
+    // How many regions map the page at this index into any address space.
+    size_t mapping_count(size_t page_index) const;
+
 protected:
     static ErrorOr<FixedArray<RefPtr<PhysicalPage>>> try_create_physical_pages(size_t);
     ErrorOr<FixedArray<RefPtr<PhysicalPage>>> try_clone_physical_pages() const;
@@ -95,12 +95,28 @@ void* memset(void* dest_ptr, int c, size_t n)
     return dest_ptr;
 }
 
-size_t strlen(char const* str)
+// NOTE: The word sized loads may read past the terminator, but they're aligned, so they never cross into another page.
+NO_SANITIZE_ADDRESS size_t strlen(char const* str)
 {
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
+    char const* characters = str;
+    for (; (FlatPtr)characters % sizeof(FlatPtr); ++characters) {
+        if (!*characters)
+            return characters - str;
+    }
+
+    // A word contains a zero byte iff subtracting one from each byte borrows into a high bit that wasn't set before.
+    constexpr FlatPtr low_bits = explode_byte(0x01);
+    constexpr FlatPtr high_bits = explode_byte(0x80);
+    for (;; characters += sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, characters, sizeof(FlatPtr));
+        if ((word - low_bits) & ~word & high_bits)
+            break;
+    }
+
+    while (*characters)
+        ++characters;
+    return characters - str;
 }
 
 size_t strnlen(char const* str, size_t maxlen)
@@ -124,6 +140,17 @@ int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto const* s1 = (u8 const*)v1;
     auto const* s2 = (u8 const*)v2;
+
+    // Skip over the equal prefix a word at a time, the first difference is then found byte by byte.
+    for (; n >= sizeof(FlatPtr); n -= sizeof(FlatPtr), s1 += sizeof(FlatPtr), s2 += sizeof(FlatPtr)) {
+        FlatPtr word1;
+        FlatPtr word2;
+        __builtin_memcpy(&word1, s1, sizeof(FlatPtr));
+        __builtin_memcpy(&word2, s2, sizeof(FlatPtr));
+        if (word1 != word2)
+            break;
+    }
+
     while (n-- > 0) {
         if (*s1++ != *s2++)
             return s1[-1] < s2[-1] ? -1 : 1;
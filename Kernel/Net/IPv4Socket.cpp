@@ -838,4 +838,11 @@ void IPv4Socket::drop_receive_buffer()
     m_receive_buffer = nullptr;
 }
 
+size_t IPv4Socket::receive_buffer_space() const
+{
+    if (!m_receive_buffer)
+        return 0;
+    return m_receive_buffer->space_for_writing();
+}
+
 }
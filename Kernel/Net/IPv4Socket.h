@@ -94,6 +94,7 @@ protected:
 
     static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create_receive_buffer();
     void drop_receive_buffer();
+    size_t receive_buffer_space() const;
 
 private:
     virtual bool is_ipv4() const override { return true; }
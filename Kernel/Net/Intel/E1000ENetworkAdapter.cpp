@@ -227,6 +227,7 @@ UNMAP_AFTER_INIT bool E1000ENetworkAdapter::initialize()
 
     initialize_rx_descriptors();
     initialize_tx_descriptors();
+    setup_offloads();
 
     setup_link();
     setup_interrupts();
@@ -8,8 +8,11 @@
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
+#include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -39,6 +42,7 @@ namespace Kernel {
 #define REG_RADV 0x282C             // RX Int. Absolute Delay Timer
 #define REG_RSRPD 0x2C00            // RX Small Packet Detect Interrupt
 #define REG_TIPG 0x0410             // Transmit Inter Packet Gap
+#define REG_RXCSUM 0x5000           // RX Checksum Control
 #define ECTRL_SLU 0x40              // set link up
 #define RCTL_EN (1 << 1)            // Receiver Enable
 #define RCTL_SBP (1 << 2)           // Store Bad Packets
@@ -81,6 +85,36 @@ namespace Kernel {
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
+// Extended Transmit Descriptors
+
+#define DTYP_CONTEXT (0 << 20)
+#define DTYP_DATA (1 << 20)
+#define TUCMD_TCP (1 << 24)  // Packet type is TCP
+#define TUCMD_IP (1 << 25)   // Packet type is IPv4
+#define TUCMD_TSE (1 << 26)  // TCP Segmentation Enable
+#define TUCMD_DEXT (1 << 29) // Descriptor Extension
+#define DCMD_EOP (1 << 24)   // End of Packet
+#define DCMD_IFCS (1 << 25)  // Insert FCS
+#define DCMD_TSE (1 << 26)   // TCP Segmentation Enable
+#define DCMD_RS (1 << 27)    // Report Status
+#define DCMD_DEXT (1 << 29)  // Descriptor Extension
+#define POPTS_IXSM (1 << 0)  // Insert IP Checksum
+#define POPTS_TXSM (1 << 1)  // Insert TCP/UDP Checksum
+
+// RXCSUM Register
+
+#define RXCSUM_IPOFL (1 << 8) // IP Checksum Offload Enable
+#define RXCSUM_TUOFL (1 << 9) // TCP/UDP Checksum Offload Enable
+
+// Receive Descriptor Status and Errors
+
+#define RSTA_DD (1 << 0)    // Descriptor Done
+#define RSTA_IXSM (1 << 2)  // Ignore Checksum Indication
+#define RSTA_TCPCS (1 << 5) // TCP/UDP Checksum Calculated
+#define RSTA_IPCS (1 << 6)  // IP Checksum Calculated
+#define RERR_TCPE (1 << 5)  // TCP/UDP Checksum Error
+#define RERR_IPE (1 << 6)   // IP Checksum Error
+
 // TCTL Register
 
 #define TCTL_EN (1 << 1)      // Transmit Enable
@@ -121,6 +155,8 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+#define RECEIVE_INTERRUPTS (INTERRUPT_RXT0 | INTERRUPT_RXO)
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 UNMAP_AFTER_INIT static bool is_valid_device_id(u16 device_id)
 {
@@ -187,7 +223,8 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
     out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    // NOTE: Transmissions wait for TXDW, as there is no guarantee that receive interrupts aren't masked for polling.
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_TXDW | RECEIVE_INTERRUPTS);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
 }
@@ -218,6 +255,7 @@ UNMAP_AFTER_INIT bool E1000NetworkAdapter::initialize()
 
     initialize_rx_descriptors();
     initialize_tx_descriptors();
+    setup_offloads();
 
     setup_link();
     setup_interrupts();
@@ -259,8 +297,10 @@ bool E1000NetworkAdapter::handle_irq(RegisterState const&)
     if (status & INTERRUPT_RXO) {
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
-    if (status & INTERRUPT_RXT0) {
-        receive();
+    if (status & RECEIVE_INTERRUPTS) {
+        // Leave the receive ring to NetworkTask until it has been drained.
+        out32(REG_INTERRUPT_MASK_CLEAR, RECEIVE_INTERRUPTS);
+        schedule_poll();
     }
 
     m_wait_queue.wake_all();
@@ -345,14 +385,12 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
 {
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
 
-    constexpr auto tx_buffer_size = 8192;
-    constexpr auto tx_buffer_page_count = tx_buffer_size / PAGE_SIZE;
     m_tx_buffer_region = MM.allocate_contiguous_kernel_region(tx_buffer_size * number_of_tx_descriptors, "E1000 TX buffers"sv, Memory::Region::Access::ReadWrite).release_value();
 
     for (size_t i = 0; i < number_of_tx_descriptors; ++i) {
         auto& descriptor = tx_descriptors[i];
         m_tx_buffers[i] = m_tx_buffer_region->vaddr().as_ptr() + tx_buffer_size * i;
-        descriptor.addr = m_tx_buffer_region->physical_page(tx_buffer_page_count * i)->paddr().get();
+        descriptor.addr = tx_buffer_physical_address(i).get();
         descriptor.cmd = 0;
     }
 
@@ -366,6 +404,20 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
     out32(REG_TIPG, 0x0060200A);
 }
 
+UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_offloads()
+{
+    // All supported controllers can checksum and segment TCP over IPv4. A segmented frame has to fit
+    // into the descriptor ring (next to a context descriptor), which is far more than an IPv4 packet can hold.
+    out32(REG_RXCSUM, in32(REG_RXCSUM) | RXCSUM_IPOFL | RXCSUM_TUOFL);
+    set_offloads(NetworkOffload::TCPChecksum | NetworkOffload::TCPSegmentation | NetworkOffload::ReceiveChecksum, tx_buffer_size * (number_of_tx_descriptors - 1));
+}
+
+PhysicalAddress E1000NetworkAdapter::tx_buffer_physical_address(size_t index) const
+{
+    constexpr auto tx_buffer_page_count = tx_buffer_size / PAGE_SIZE;
+    return m_tx_buffer_region->physical_page(tx_buffer_page_count * index)->paddr();
+}
+
 void E1000NetworkAdapter::out8(u16 address, u8 data)
 {
     dbgln_if(E1000_DEBUG, "E1000: OUT8 {:#02x} @ {:#04x}", data, address);
@@ -430,10 +482,15 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
     auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
+    VERIFY(payload.size() <= tx_buffer_size);
     auto* vptr = (void*)m_tx_buffers[tx_current];
     memcpy(vptr, payload.data(), payload.size());
+    // NOTE: The descriptor may have been used as an extended one before, so rewrite all of it.
+    descriptor.addr = tx_buffer_physical_address(tx_current).get();
     descriptor.length = payload.size();
+    descriptor.cso = 0;
+    descriptor.css = 0;
+    descriptor.special = 0;
     descriptor.status = 0;
     descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
@@ -441,21 +498,129 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     cli();
     enable_irq();
     out32(REG_TXDESCTAIL, tx_current);
+    wait_for_tx_descriptor(descriptor.status);
+    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
+}
+
+void E1000NetworkAdapter::wait_for_tx_descriptor(u8 volatile& status)
+{
     for (;;) {
-        if (descriptor.status) {
+        if (status) {
             sti();
             break;
         }
         m_wait_queue.wait_forever("E1000NetworkAdapter"sv);
     }
-    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
 }
 
-void E1000NetworkAdapter::receive()
+static u16 fold_checksum(u32 checksum)
+{
+    while (checksum > 0xffff)
+        checksum = (checksum >> 16) + (checksum & 0xffff);
+    return checksum;
+}
+
+// The hardware expects the TCP checksum field to hold the (uncomplemented) sum of the pseudo header.
+// When segmenting, the TCP length is left out of it, as the hardware adds it to every segment.
+static u16 tcp_pseudo_header_checksum(IPv4Packet const& ipv4, u16 tcp_length)
+{
+    u32 checksum = 0;
+    auto add_address = [&](IPv4Address const& address) {
+        auto value = address.to_u32();
+        auto const* bytes = reinterpret_cast<u8 const*>(&value);
+        checksum += (bytes[0] << 8) | bytes[1];
+        checksum += (bytes[2] << 8) | bytes[3];
+    };
+    add_address(ipv4.source());
+    add_address(ipv4.destination());
+    checksum += (u8)IPv4Protocol::TCP;
+    checksum += tcp_length;
+    return fold_checksum(checksum);
+}
+
+void E1000NetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    constexpr size_t ipv4_header_offset = sizeof(EthernetFrameHeader);
+    constexpr size_t tcp_header_offset = ipv4_header_offset + sizeof(IPv4Packet);
+    constexpr size_t tcp_checksum_offset = tcp_header_offset + 16;
+
+    bool segment = has_flag(offload.offloads, NetworkOffload::TCPSegmentation);
+    VERIFY(payload.size() >= tcp_header_offset + sizeof(TCPPacket));
+    VERIFY(payload.size() <= tx_buffer_size * (number_of_tx_descriptors - 1));
+
+    disable_irq();
+    size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
+    dbgln_if(E1000_DEBUG, "E1000: Sending packet with offloads ({} bytes)", payload.size());
+
+    auto const& tcp = *reinterpret_cast<TCPPacket const*>(payload.offset(tcp_header_offset));
+    size_t headers_size = tcp_header_offset + tcp.header_size();
+
+    auto& context = reinterpret_cast<e1000_tx_context_desc*>(m_tx_descriptors_region->vaddr().as_ptr())[tx_current];
+    context = {};
+    context.tucss = tcp_header_offset;
+    context.tucso = tcp_checksum_offset;
+    context.tucse = 0; // checksum until the end of the packet
+    if (segment) {
+        context.ipcss = ipv4_header_offset;
+        context.ipcso = ipv4_header_offset + 10;
+        context.ipcse = tcp_header_offset - 1;
+        context.paylen_dtyp_tucmd = TUCMD_DEXT | TUCMD_TSE | TUCMD_IP | TUCMD_TCP | DTYP_CONTEXT | (payload.size() - headers_size);
+        context.hdrlen = headers_size;
+        context.mss = offload.maximum_segment_size;
+    } else {
+        context.paylen_dtyp_tucmd = TUCMD_DEXT | TUCMD_TCP | DTYP_CONTEXT;
+    }
+    tx_current = (tx_current + 1) % number_of_tx_descriptors;
+
+    e1000_tx_data_desc* last_descriptor = nullptr;
+    for (size_t offset = 0; offset < payload.size(); offset += tx_buffer_size) {
+        auto chunk_size = min(tx_buffer_size, payload.size() - offset);
+        auto* buffer = static_cast<u8*>(m_tx_buffers[tx_current]);
+        memcpy(buffer, payload.offset(offset), chunk_size);
+
+        if (offset == 0) {
+            // Prepare the headers the way the hardware wants them, it fills in the rest per segment.
+            auto& ipv4 = *reinterpret_cast<IPv4Packet*>(buffer + ipv4_header_offset);
+            u16 tcp_length = segment ? 0 : payload.size() - tcp_header_offset;
+            auto tcp_checksum = tcp_pseudo_header_checksum(ipv4, tcp_length);
+            buffer[tcp_checksum_offset] = tcp_checksum >> 8;
+            buffer[tcp_checksum_offset + 1] = tcp_checksum & 0xff;
+            if (segment) {
+                ipv4.set_length(0);
+                ipv4.set_checksum(0);
+            }
+        }
+
+        auto& descriptor = reinterpret_cast<e1000_tx_data_desc*>(m_tx_descriptors_region->vaddr().as_ptr())[tx_current];
+        descriptor.addr = tx_buffer_physical_address(tx_current).get();
+        descriptor.dtalen_dtyp_dcmd = DCMD_DEXT | DCMD_IFCS | DTYP_DATA | (segment ? DCMD_TSE : 0) | chunk_size;
+        descriptor.status = 0;
+        descriptor.popts = POPTS_TXSM | (segment ? POPTS_IXSM : 0);
+        descriptor.special = 0;
+        last_descriptor = &descriptor;
+        tx_current = (tx_current + 1) % number_of_tx_descriptors;
+    }
+    VERIFY(last_descriptor);
+    last_descriptor->dtalen_dtyp_dcmd = last_descriptor->dtalen_dtyp_dcmd | DCMD_EOP | DCMD_RS;
+
+    cli();
+    enable_irq();
+    out32(REG_TXDESCTAIL, tx_current);
+    wait_for_tx_descriptor(last_descriptor->status);
+    dbgln_if(E1000_DEBUG, "E1000: Sent packet with offloads, status is now {:#02x}!", (u8)last_descriptor->status);
+}
+
+void E1000NetworkAdapter::enable_receive_interrupts()
+{
+    out32(REG_INTERRUPT_MASK_SET, RECEIVE_INTERRUPTS);
+}
+
+size_t E1000NetworkAdapter::receive_batch(size_t budget)
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     u32 rx_current;
-    for (;;) {
+    size_t received = 0;
+    while (received < budget) {
         rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
         rx_current = (rx_current + 1) % number_of_rx_descriptors;
         if (!(rx_descriptors[rx_current].status & 1))
@@ -464,10 +629,18 @@ void E1000NetworkAdapter::receive()
         u16 length = rx_descriptors[rx_current].length;
         VERIFY(length <= 8192);
         dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
-        did_receive({ buffer, length });
+        auto const& rx_descriptor = *reinterpret_cast<e1000_rx_desc const*>(&rx_descriptors[rx_current]);
+        bool bad_ip_checksum = (rx_descriptor.status & RSTA_IPCS) && (rx_descriptor.errors & RERR_IPE);
+        bool bad_tcp_checksum = (rx_descriptor.status & RSTA_TCPCS) && (rx_descriptor.errors & RERR_TCPE);
+        if (!(rx_descriptor.status & RSTA_IXSM) && (bad_ip_checksum || bad_tcp_checksum))
+            dbgln_if(E1000_DEBUG, "E1000: Dropping packet with bad checksum");
+        else
+            did_receive({ buffer, length });
         rx_descriptors[rx_current].status = 0;
         out32(REG_RXDESCTAIL, rx_current);
+        ++received;
     }
+    return received;
 }
 
 i32 E1000NetworkAdapter::link_speed()
@@ -27,6 +27,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) override;
     virtual bool link_up() override { return m_link_up; };
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -36,6 +37,7 @@ public:
 protected:
     void setup_interrupts();
     void setup_link();
+    void setup_offloads();
 
     E1000NetworkAdapter(PCI::Address, u8 irq, NonnullOwnPtr<KString>);
     virtual bool handle_irq(RegisterState const&) override;
@@ -60,6 +62,32 @@ protected:
         volatile uint16_t special { 0 };
     };
 
+    // Sets up the checksum and segmentation offloads for the data descriptors that follow it.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        volatile uint8_t ipcss { 0 };
+        volatile uint8_t ipcso { 0 };
+        volatile uint16_t ipcse { 0 };
+        volatile uint8_t tucss { 0 };
+        volatile uint8_t tucso { 0 };
+        volatile uint16_t tucse { 0 };
+        volatile uint32_t paylen_dtyp_tucmd { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t hdrlen { 0 };
+        volatile uint16_t mss { 0 };
+    };
+
+    struct [[gnu::packed]] e1000_tx_data_desc {
+        volatile uint64_t addr { 0 };
+        volatile uint32_t dtalen_dtyp_dcmd { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t popts { 0 };
+        volatile uint16_t special { 0 };
+    };
+
+    static_assert(AssertSize<e1000_tx_desc, 16>());
+    static_assert(AssertSize<e1000_tx_context_desc, 16>());
+    static_assert(AssertSize<e1000_tx_data_desc, 16>());
+
     virtual void detect_eeprom();
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -77,10 +105,14 @@ protected:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
+    virtual size_t receive_batch(size_t budget) override;
+    virtual void enable_receive_interrupts() override;
+    PhysicalAddress tx_buffer_physical_address(size_t index) const;
+    void wait_for_tx_descriptor(u8 volatile& status);
 
     static constexpr size_t number_of_rx_descriptors = 256;
     static constexpr size_t number_of_tx_descriptors = 256;
+    static constexpr size_t tx_buffer_size = 8192;
 
     IOAddress m_io_base;
     VirtualAddress m_mmio_base;
@@ -45,8 +45,8 @@ ErrorOr<void> LocalSocket::try_for_each(Function<ErrorOr<void>(LocalSocket const
 
 ErrorOr<NonnullLockRefPtr<LocalSocket>> LocalSocket::try_create(int type)
 {
-    auto client_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Client buffer"sv));
-    auto server_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Server buffer"sv));
+    auto client_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Client buffer"sv, initial_buffer_capacity, max_buffer_capacity));
+    auto server_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Server buffer"sv, initial_buffer_capacity, max_buffer_capacity));
     return adopt_nonnull_lock_ref_or_enomem(new (nothrow) LocalSocket(type, move(client_buffer), move(server_buffer)));
 }
 
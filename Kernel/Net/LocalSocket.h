@@ -53,6 +53,10 @@ public:
     virtual ErrorOr<void> chmod(Credentials const&, OpenFileDescription&, mode_t) override;
 
 private:
+    // Most IPC messages are small, but the buffers grow so bulk transfers don't need a syscall per 64 KiB.
+    static constexpr size_t initial_buffer_capacity = 64 * KiB;
+    static constexpr size_t max_buffer_capacity = 1 * MiB;
+
     explicit LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer);
     virtual StringView class_name() const override { return "LocalSocket"sv; }
     virtual bool is_local() const override { return true; }
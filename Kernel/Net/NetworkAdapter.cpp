@@ -9,6 +9,9 @@
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
 
@@ -17,10 +20,24 @@ namespace Kernel {
 NetworkAdapter::NetworkAdapter(NonnullOwnPtr<KString> interface_name)
     : m_name(move(interface_name))
 {
+    // NOTE: Received packets are usually queued from IRQ handlers, so have buffers ready for them up front.
+    for (size_t i = 0; i < preallocated_packet_buffers; ++i) {
+        auto packet = allocate_packet_buffer(pooled_packet_buffer_size);
+        if (!packet)
+            break;
+        release_packet_buffer(*packet);
+    }
 }
 
 NetworkAdapter::~NetworkAdapter() = default;
 
+void NetworkAdapter::set_offloads(NetworkOffload offloads, size_t max_segmentation_frame_size)
+{
+    VERIFY(!has_flag(offloads, NetworkOffload::TCPSegmentation) || max_segmentation_frame_size > layer3_payload_offset() + mtu());
+    m_offloads = offloads;
+    m_max_segmentation_frame_size = min(max_segmentation_frame_size, layer3_payload_offset() + max_ipv4_packet_size);
+}
+
 void NetworkAdapter::send_packet(ReadonlyBytes packet)
 {
     m_packets_out++;
@@ -28,6 +45,67 @@ void NetworkAdapter::send_packet(ReadonlyBytes packet)
     send_raw(packet);
 }
 
+void NetworkAdapter::send_packet(ReadonlyBytes packet, TransmitOffload const& offload)
+{
+    if (offload.offloads == NetworkOffload::None)
+        return send_packet(packet);
+
+    // This can happen when a packet is retransmitted through a different adapter.
+    bool fits_adapter = !has_flag(offload.offloads, NetworkOffload::TCPSegmentation) || packet.size() <= m_max_segmentation_frame_size;
+    if (!supports_offload(offload.offloads) || !fits_adapter)
+        return send_with_software_offload(packet, offload);
+
+    m_packets_out++;
+    m_bytes_out += packet.size();
+    send_raw_with_offload(packet, offload);
+}
+
+void NetworkAdapter::send_with_software_offload(ReadonlyBytes packet, TransmitOffload const& offload)
+{
+    auto const& ipv4 = *reinterpret_cast<IPv4Packet const*>(packet.offset(layer3_payload_offset()));
+    auto const& tcp = *reinterpret_cast<TCPPacket const*>(ipv4.payload());
+    size_t headers_size = ipv4_payload_offset() + tcp.header_size();
+    VERIFY(packet.size() >= headers_size);
+
+    size_t payload_size = packet.size() - headers_size;
+    size_t segment_size = payload_size;
+    if (has_flag(offload.offloads, NetworkOffload::TCPSegmentation) && offload.maximum_segment_size > 0)
+        segment_size = min<size_t>(payload_size, offload.maximum_segment_size);
+
+    auto segment = acquire_packet_buffer(headers_size + segment_size);
+    if (!segment) {
+        // NOTE: TCP will retransmit this later on.
+        dbgln("NetworkAdapter: Dropping outgoing TCP packet as there is not enough memory to segment it");
+        return;
+    }
+
+    size_t offset = 0;
+    do {
+        auto chunk_size = min(segment_size, payload_size - offset);
+        segment->buffer->set_size(headers_size + chunk_size);
+        memcpy(segment->buffer->data(), packet.data(), headers_size);
+        memcpy(segment->buffer->data() + headers_size, packet.offset(headers_size + offset), chunk_size);
+
+        auto& segment_ipv4 = *reinterpret_cast<IPv4Packet*>(segment->buffer->data() + layer3_payload_offset());
+        segment_ipv4.set_length(sizeof(IPv4Packet) + tcp.header_size() + chunk_size);
+        segment_ipv4.set_checksum(0);
+        segment_ipv4.set_checksum(segment_ipv4.compute_checksum());
+
+        auto& segment_tcp = *reinterpret_cast<TCPPacket*>(segment_ipv4.payload());
+        segment_tcp.set_sequence_number(tcp.sequence_number() + offset);
+        // Only the last segment may finish the stream or push it to the application.
+        if (offset + chunk_size < payload_size)
+            segment_tcp.set_flags(tcp.flags() & ~(TCPFlags::FIN | TCPFlags::PSH));
+        segment_tcp.set_checksum(0);
+        segment_tcp.set_checksum(TCPSocket::compute_tcp_checksum(segment_ipv4.source(), segment_ipv4.destination(), segment_tcp, chunk_size));
+
+        send_packet(segment->bytes());
+        offset += chunk_size;
+    } while (offset < payload_size);
+
+    release_packet_buffer(*segment);
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -47,7 +125,8 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    // NOTE: Larger TCP packets are segmented before they hit the wire.
+    VERIFY(ipv4_packet_size <= mtu() || (protocol == IPv4Protocol::TCP && ipv4_packet_size <= max_ipv4_packet_size));
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -91,10 +170,33 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
     m_packet_queue.append(*packet);
     m_packet_queue_size++;
 
+    // NOTE: NetworkTask is already running when packets are received from a poll.
+    if (on_receive && !m_poll_scheduled.load(AK::memory_order_relaxed))
+        on_receive();
+}
+
+void NetworkAdapter::schedule_poll()
+{
+    if (m_poll_scheduled.exchange(true, AK::memory_order_acq_rel))
+        return;
     if (on_receive)
         on_receive();
 }
 
+size_t NetworkAdapter::poll(size_t budget)
+{
+    if (!m_poll_scheduled.load(AK::memory_order_acquire))
+        return 0;
+    auto received = receive_batch(budget);
+    if (received < budget) {
+        // The receive ring has been drained. Anything that arrives from here on raises an interrupt again,
+        // since the hardware latches the interrupt cause while it is masked.
+        m_poll_scheduled.store(false, AK::memory_order_release);
+        enable_receive_interrupts();
+    }
+    return received;
+}
+
 size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
 {
     InterruptDisabler disabler;
@@ -113,29 +215,29 @@ size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& pack
 
 LockRefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
 {
-    auto packet = m_unused_packets.with([size](auto& unused_packets) -> LockRefPtr<PacketWithTimestamp> {
-        if (unused_packets.is_empty())
-            return nullptr;
-
-        auto unused_packet = unused_packets.take_first();
-
-        if (unused_packet->buffer->capacity() >= size)
-            return unused_packet;
-
-        unused_packets.append(*unused_packet);
-        return nullptr;
-    });
-
-    if (packet) {
-        packet->timestamp = kgettimeofday();
-        packet->buffer->set_size(size);
-        return packet;
+    if (size <= pooled_packet_buffer_size) {
+        auto packet = m_unused_packets.with([](auto& pool) -> LockRefPtr<PacketWithTimestamp> {
+            if (pool.packets.is_empty())
+                return nullptr;
+            --pool.size;
+            return pool.packets.take_first();
+        });
+        if (packet) {
+            packet->timestamp = kgettimeofday();
+            packet->buffer->set_size(size);
+            return packet;
+        }
     }
+    return allocate_packet_buffer(size);
+}
 
-    auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+LockRefPtr<PacketWithTimestamp> NetworkAdapter::allocate_packet_buffer(size_t size)
+{
+    // NOTE: Small buffers are allocated at the pooled size, so they can be recycled for any packet later on.
+    auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, max(size, pooled_packet_buffer_size), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    packet = adopt_lock_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
+    auto packet = adopt_lock_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
     if (!packet)
         return {};
     packet->buffer->set_size(size);
@@ -144,8 +246,13 @@ LockRefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t siz
 
 void NetworkAdapter::release_packet_buffer(PacketWithTimestamp& packet)
 {
-    m_unused_packets.with([&packet](auto& unused_packets) {
-        unused_packets.append(packet);
+    if (packet.buffer->capacity() != pooled_packet_buffer_size)
+        return;
+    m_unused_packets.with([&packet](auto& pool) {
+        if (pool.size == max_packet_buffers)
+            return;
+        pool.packets.append(packet);
+        ++pool.size;
     });
 }
 
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
@@ -28,6 +30,26 @@ class NetworkAdapter;
 
 using NetworkByteBuffer = AK::Detail::ByteBuffer<1500>;
 
+enum class NetworkOffload : u8 {
+    None = 0,
+    // The adapter fills in TCP checksums of outgoing frames.
+    TCPChecksum = 1 << 0,
+    // The adapter splits outgoing TCP frames that are larger than the MTU into MSS-sized segments,
+    // and fills in all of their IPv4 and TCP checksums.
+    TCPSegmentation = 1 << 1,
+    // The adapter validates IPv4, TCP and UDP checksums of incoming frames, and drops bad ones.
+    ReceiveChecksum = 1 << 2,
+};
+
+AK_ENUM_BITWISE_OPERATORS(NetworkOffload);
+
+// The work that is left to do on an outgoing IPv4 frame, which is either done by the adapter
+// or in software by NetworkAdapter::send_packet(). The TCP checksum field of such a frame is zero.
+struct TransmitOffload {
+    NetworkOffload offloads { NetworkOffload::None };
+    u16 maximum_segment_size { 0 };
+};
+
 struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp> {
     PacketWithTimestamp(NonnullOwnPtr<KBuffer> buffer, Time timestamp)
         : buffer(move(buffer))
@@ -75,9 +97,18 @@ public:
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
+    // Receives at most `budget` packets if the driver has scheduled a poll, and returns how many were received.
+    // Once fewer than `budget` packets were received, the driver is switched back to receive interrupts.
+    size_t poll(size_t budget);
+
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
+    NetworkOffload offloads() const { return m_offloads; }
+    bool supports_offload(NetworkOffload offload) const { return has_flag(m_offloads, offload); }
+    // The largest frame (including the link layer header) that can be handed to the adapter for TCP segmentation.
+    size_t max_segmentation_frame_size() const { return m_max_segmentation_frame_size; }
+
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
@@ -92,32 +123,59 @@ public:
     Function<void()> on_receive;
 
     void send_packet(ReadonlyBytes);
+    void send_packet(ReadonlyBytes, TransmitOffload const&);
+
+    // NOTE: IPv4 packets can't be larger than this, no matter whether they're segmented later on.
+    static constexpr size_t max_ipv4_packet_size = NumericLimits<u16>::max();
 
 protected:
     NetworkAdapter(NonnullOwnPtr<KString>);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
+    void set_offloads(NetworkOffload, size_t max_segmentation_frame_size = 0);
     void did_receive(ReadonlyBytes);
+    // Called from the IRQ handler of drivers that implement receive_batch(), with their receive interrupts masked.
+    void schedule_poll();
+    // Hands at most `budget` packets to did_receive(), and returns how many there were.
+    virtual size_t receive_batch(size_t) { VERIFY_NOT_REACHED(); }
+    virtual void enable_receive_interrupts() { VERIFY_NOT_REACHED(); }
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called with offloads the adapter advertised with set_offloads().
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) { VERIFY_NOT_REACHED(); }
 
 private:
+    void send_with_software_offload(ReadonlyBytes, TransmitOffload const&);
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
 
     // FIXME: Make this configurable
     static constexpr size_t max_packet_buffers = 1024;
+    static constexpr size_t preallocated_packet_buffers = 128;
+    // Enough for any frame that fits into the MTU, larger buffers (e.g for TCP segmentation) aren't pooled.
+    static constexpr size_t pooled_packet_buffer_size = PAGE_SIZE;
 
     using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
 
+    struct PacketPool {
+        PacketList packets;
+        size_t size { 0 };
+    };
+
+    LockRefPtr<PacketWithTimestamp> allocate_packet_buffer(size_t);
+
     PacketList m_packet_queue;
     size_t m_packet_queue_size { 0 };
-    SpinlockProtected<PacketList> m_unused_packets { LockRank::None };
+    SpinlockProtected<PacketPool> m_unused_packets { LockRank::None };
+    Atomic<bool> m_poll_scheduled { false };
     NonnullOwnPtr<KString> m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    NetworkOffload m_offloads { NetworkOffload::None };
+    size_t m_max_segmentation_frame_size { 0 };
 };
 
 }
@@ -16,6 +16,7 @@
 #include <Kernel/Net/LoopbackAdapter.h>
 #include <Kernel/Net/NetworkTask.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/PacketSocket.h>
 #include <Kernel/Net/Routing.h>
 #include <Kernel/Net/TCP.h>
 #include <Kernel/Net/TCPSocket.h>
@@ -60,8 +61,11 @@ void NetworkTask_main(void*)
     delayed_ack_sockets = new HashTable<LockRefPtr<TCPSocket>>;
 
     WaitQueue packet_wait_queue;
-    int pending_packets = 0;
+    // NOTE: Adapters are only registered during boot, so we can keep our own list and process packets
+    //       without holding the adapter list lock.
+    NonnullLockRefPtrVector<NetworkAdapter> adapters;
     NetworkingManagement::the().for_each([&](auto& adapter) {
+        adapters.append(adapter);
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
         if (adapter.class_name() == "LoopbackAdapter"sv) {
@@ -70,25 +74,10 @@ void NetworkTask_main(void*)
         }
 
         adapter.on_receive = [&]() {
-            pending_packets++;
             packet_wait_queue.wake_all();
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
-
     size_t buffer_size = 64 * KiB;
     auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
     if (region_or_error.is_error())
@@ -97,20 +86,13 @@ void NetworkTask_main(void*)
     auto buffer = (u8*)buffer_region->vaddr().get();
     Time packet_timestamp;
 
-    for (;;) {
-        flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
-            auto timeout_time = Time::from_milliseconds(500);
-            auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
-        }
+    auto handle_packet = [&](NetworkAdapter& adapter, size_t packet_size) {
         if (packet_size < sizeof(EthernetFrameHeader)) {
             dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
+            return;
         }
+        PacketSocket::deliver(adapter, { buffer, packet_size }, packet_timestamp);
+
         auto& eth = *(EthernetFrameHeader const*)buffer;
         dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
 
@@ -127,6 +109,40 @@ void NetworkTask_main(void*)
         default:
             dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
         }
+    };
+
+    // The number of packets taken from each adapter per round, so that a busy adapter can't starve the others
+    // (or the delayed ACKs and retransmissions below).
+    constexpr size_t poll_budget = 64;
+
+    for (;;) {
+        flush_delayed_tcp_acks();
+        retransmit_tcp_packets();
+
+        size_t handled_packets = 0;
+        for (auto& adapter : adapters) {
+            auto polled_packets = adapter.poll(poll_budget);
+            if (polled_packets)
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Polled {} packets from {}", polled_packets, adapter.name());
+
+            for (size_t i = 0; i < poll_budget && adapter.has_queued_packets(); ++i) {
+                size_t packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
+                if (!packet_size)
+                    break;
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+                handle_packet(adapter, packet_size);
+                ++handled_packets;
+            }
+            // NOTE: An adapter that used up its budget still has packets waiting, so keep going without sleeping.
+            if (polled_packets == poll_budget)
+                ++handled_packets;
+        }
+
+        if (!handled_packets) {
+            auto timeout_time = Time::from_milliseconds(500);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
+        }
     }
 }
 
@@ -381,6 +397,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
     size_t maximum_tcp_header_size = 15 * sizeof(u32);
     if (tcp_packet.header_size() < minimum_tcp_header_size || tcp_packet.header_size() > maximum_tcp_header_size) {
         dbgln("handle_tcp: TCP packet header has invalid size {}", tcp_packet.header_size());
+        return;
     }
 
     if (ipv4_packet.payload_size() < tcp_packet.header_size()) {
@@ -459,6 +476,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->process_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Checked.h>
+#include <AK/Singleton.h>
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/API/POSIX/net/if_arp.h>
+#include <Kernel/Debug.h>
+#include <Kernel/KString.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
+#include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/Net/PacketSocket.h>
+#include <Kernel/Process.h>
+#include <Kernel/StdLib.h>
+
+namespace Kernel {
+
+static Singleton<MutexProtected<PacketSocket::List>> s_all_sockets;
+// Lets deliver() skip the list lock on the common path, where no packet sockets are open.
+static Atomic<size_t> s_socket_count { 0 };
+
+// Both rings together may not take up more memory than this.
+static constexpr size_t max_ring_size = 64 * MiB;
+
+MutexProtected<PacketSocket::List>& PacketSocket::all_sockets()
+{
+    return *s_all_sockets;
+}
+
+ErrorOr<NonnullLockRefPtr<Socket>> PacketSocket::try_create(int type, int protocol)
+{
+    if (type != SOCK_RAW)
+        return EPROTONOSUPPORT;
+    return TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) PacketSocket(type, protocol)));
+}
+
+PacketSocket::PacketSocket(int type, int protocol)
+    : Socket(AF_PACKET, type, protocol)
+    , m_ethertype(static_cast<u16>(protocol))
+{
+    all_sockets().with_exclusive([&](auto& sockets) {
+        sockets.append(*this);
+        ++s_socket_count;
+    });
+}
+
+PacketSocket::~PacketSocket()
+{
+    all_sockets().with_exclusive([&](auto& sockets) {
+        sockets.remove(*this);
+        --s_socket_count;
+    });
+}
+
+ErrorOr<void> PacketSocket::bind(Credentials const&, Userspace<sockaddr const*> user_address, socklen_t address_size)
+{
+    if (address_size != sizeof(sockaddr_ll))
+        return set_so_error(EINVAL);
+
+    sockaddr_ll address {};
+    SOCKET_TRY(copy_from_user(&address, user_address, sizeof(sockaddr_ll)));
+    if (address.sll_family != AF_PACKET)
+        return set_so_error(EINVAL);
+    if (address.sll_ifindex != 0)
+        return set_so_error(ENODEV);
+
+    MutexLocker locker(mutex());
+    if (address.sll_protocol != 0)
+        m_ethertype = address.sll_protocol;
+    return {};
+}
+
+void PacketSocket::get_local_address(sockaddr* address, socklen_t* address_size)
+{
+    sockaddr_ll local_address {};
+    local_address.sll_family = AF_PACKET;
+    local_address.sll_protocol = m_ethertype;
+    local_address.sll_hatype = ARPHRD_ETHER;
+    if (auto adapter = bound_interface()) {
+        auto mac_address = adapter->mac_address();
+        local_address.sll_halen = sizeof(mac_address);
+        memcpy(local_address.sll_addr, &mac_address, sizeof(mac_address));
+    }
+    memcpy(address, &local_address, min(static_cast<size_t>(*address_size), sizeof(sockaddr_ll)));
+    *address_size = sizeof(sockaddr_ll);
+}
+
+void PacketSocket::get_peer_address(sockaddr*, socklen_t* address_size)
+{
+    *address_size = 0;
+}
+
+tpacket_hdr& PacketSocket::frame_header(Ring const& ring, u32 index) const
+{
+    VERIFY(index < ring.frame_count);
+    return *reinterpret_cast<tpacket_hdr*>(m_ring_region->vaddr().offset(ring.offset + static_cast<size_t>(index) * ring.frame_size).as_ptr());
+}
+
+bool PacketSocket::can_read(OpenFileDescription const&, u64) const
+{
+    if (!m_rings_are_mapped.load(AK::memory_order_acquire) || !m_rx_ring.is_set_up())
+        return false;
+    // Userspace consumes frames in order, so as long as it hasn't given back the frame that was filled last,
+    // there is something left for it to read.
+    auto last_index = (m_rx_head.load(AK::memory_order_relaxed) + m_rx_ring.frame_count - 1) % m_rx_ring.frame_count;
+    return AK::atomic_load(&frame_header(m_rx_ring, last_index).tp_status, AK::memory_order_acquire) & TP_STATUS_USER;
+}
+
+bool PacketSocket::wants(NetworkAdapter const& adapter, ReadonlyBytes frame) const
+{
+    if (m_ethertype == 0)
+        return false;
+    if (auto bound_adapter = bound_interface(); bound_adapter && bound_adapter.ptr() != &adapter)
+        return false;
+    if (m_ethertype == htons(ETH_P_ALL))
+        return true;
+    auto const& ethernet_header = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    return ethernet_header.ether_type() == ntohs(m_ethertype);
+}
+
+void PacketSocket::deliver(NetworkAdapter& adapter, ReadonlyBytes frame, Time const& timestamp)
+{
+    VERIFY(frame.size() >= sizeof(EthernetFrameHeader));
+    if (s_socket_count.load(AK::memory_order_relaxed) == 0)
+        return;
+    all_sockets().with_shared([&](auto const& sockets) {
+        // NOTE: The list lock only guards membership; each socket serializes access to its RX ring with its own mutex.
+        for (auto& socket : sockets)
+            const_cast<PacketSocket&>(socket).did_receive(adapter, frame, timestamp);
+    });
+}
+
+void PacketSocket::did_receive(NetworkAdapter& adapter, ReadonlyBytes frame, Time const& timestamp)
+{
+    if (!m_rings_are_mapped.load(AK::memory_order_acquire) || !m_rx_ring.is_set_up())
+        return;
+
+    MutexLocker locker(mutex());
+    if (!wants(adapter, frame))
+        return;
+
+    ++m_received_packets;
+    auto head = m_rx_head.load(AK::memory_order_relaxed);
+    auto& header = frame_header(m_rx_ring, head);
+    if (AK::atomic_load(&header.tp_status, AK::memory_order_acquire) != TP_STATUS_KERNEL) {
+        dbgln_if(PACKET_SOCKET_DEBUG, "PacketSocket({}): RX ring is full, dropping a {} byte frame", this, frame.size());
+        ++m_dropped_packets;
+        m_rx_is_losing = true;
+        return;
+    }
+
+    auto snap_length = min(frame.size(), static_cast<size_t>(m_rx_ring.frame_size - TPACKET_HDRLEN));
+    memcpy(reinterpret_cast<u8*>(&header) + TPACKET_HDRLEN, frame.data(), snap_length);
+    auto timeval = timestamp.to_timeval();
+    header.tp_len = frame.size();
+    header.tp_snaplen = snap_length;
+    header.tp_mac = TPACKET_HDRLEN;
+    header.tp_net = TPACKET_HDRLEN + sizeof(EthernetFrameHeader);
+    header.tp_sec = timeval.tv_sec;
+    header.tp_usec = timeval.tv_usec;
+
+    unsigned long status = TP_STATUS_USER;
+    if (m_rx_is_losing)
+        status |= TP_STATUS_LOSING;
+    m_rx_is_losing = false;
+
+    AK::atomic_store(&header.tp_status, status, AK::memory_order_seq_cst);
+    m_rx_head.store((head + 1) % m_rx_ring.frame_count, AK::memory_order_seq_cst);
+
+    // If userspace hasn't given back the previous frame yet, it will look at this one next, so it can't be waiting.
+    // Note: This has to be checked after publishing the frame, or userspace could give back the previous one and
+    //       start waiting in between.
+    auto previous_index = (head + m_rx_ring.frame_count - 1) % m_rx_ring.frame_count;
+    if (AK::atomic_load(&frame_header(m_rx_ring, previous_index).tp_status, AK::memory_order_seq_cst) == TP_STATUS_KERNEL)
+        evaluate_block_conditions();
+}
+
+ErrorOr<size_t> PacketSocket::send_frame(ReadonlyBytes frame)
+{
+    auto adapter = bound_interface();
+    if (!adapter)
+        return ENXIO;
+    if (frame.size() < sizeof(EthernetFrameHeader) || frame.size() > sizeof(EthernetFrameHeader) + adapter->mtu())
+        return EMSGSIZE;
+    adapter->send_packet(frame);
+    return frame.size();
+}
+
+ErrorOr<size_t> PacketSocket::send_pending_frames()
+{
+    if (!bound_interface())
+        return ENXIO;
+
+    size_t total_size = 0;
+    for (u32 i = 0; i < m_tx_ring.frame_count; ++i) {
+        auto& header = frame_header(m_tx_ring, m_tx_head);
+        if (AK::atomic_load(&header.tp_status, AK::memory_order_acquire) != TP_STATUS_SEND_REQUEST)
+            break;
+
+        // NOTE: Userspace can scribble over the frame at any time, so the length is only read once.
+        auto length = AK::atomic_load(&header.tp_len, AK::memory_order_relaxed);
+        unsigned long status = TP_STATUS_AVAILABLE;
+        if (length > m_tx_ring.frame_size - TPACKET_HDRLEN) {
+            status = TP_STATUS_WRONG_FORMAT;
+        } else {
+            auto result = send_frame({ reinterpret_cast<u8 const*>(&header) + TPACKET_HDRLEN, length });
+            if (result.is_error())
+                status = TP_STATUS_WRONG_FORMAT;
+            else
+                total_size += result.value();
+        }
+        AK::atomic_store(&header.tp_status, status, AK::memory_order_release);
+        m_tx_head = (m_tx_head + 1) % m_tx_ring.frame_count;
+    }
+    return total_size;
+}
+
+ErrorOr<size_t> PacketSocket::sendto(OpenFileDescription&, UserOrKernelBuffer const& data, size_t data_length, int, Userspace<sockaddr const*>, socklen_t)
+{
+    MutexLocker locker(mutex());
+    if (m_rings_are_mapped.load(AK::memory_order_acquire) && m_tx_ring.is_set_up())
+        return SOCKET_TRY(send_pending_frames());
+
+    auto adapter = bound_interface();
+    if (!adapter)
+        return set_so_error(ENXIO);
+    if (data_length < sizeof(EthernetFrameHeader) || data_length > sizeof(EthernetFrameHeader) + adapter->mtu())
+        return set_so_error(EMSGSIZE);
+    auto packet = adapter->acquire_packet_buffer(data_length);
+    if (!packet)
+        return set_so_error(ENOMEM);
+    SOCKET_TRY(data.read(packet->buffer->data(), data_length));
+    return SOCKET_TRY(send_frame(packet->bytes()));
+}
+
+ErrorOr<size_t> PacketSocket::recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&, bool)
+{
+    // Frames are only ever received through the RX ring.
+    return EOPNOTSUPP;
+}
+
+ErrorOr<void> PacketSocket::set_up_ring(Ring& ring, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    VERIFY(mutex().is_exclusively_locked_by_current_thread());
+    if (user_value_size != sizeof(tpacket_req))
+        return EINVAL;
+    auto request = TRY(copy_typed_from_user(static_ptr_cast<tpacket_req const*>(user_value)));
+    if (m_rings_are_mapped.load(AK::memory_order_acquire))
+        return EBUSY;
+
+    if (request.tp_block_nr == 0) {
+        ring = {};
+    } else {
+        if (request.tp_frame_size < TPACKET_HDRLEN + sizeof(EthernetFrameHeader) || request.tp_frame_size % TPACKET_ALIGNMENT != 0)
+            return EINVAL;
+        if (request.tp_block_size == 0 || request.tp_block_size % PAGE_SIZE != 0 || request.tp_block_size % request.tp_frame_size != 0)
+            return EINVAL;
+        Checked<size_t> size = request.tp_block_size;
+        size *= request.tp_block_nr;
+        if (size.has_overflow() || size.value() > max_ring_size)
+            return ENOMEM;
+        if (request.tp_frame_nr != size.value() / request.tp_frame_size)
+            return EINVAL;
+        ring.frame_size = request.tp_frame_size;
+        ring.frame_count = request.tp_frame_nr;
+    }
+
+    if (m_rx_ring.size() + m_tx_ring.size() > max_ring_size) {
+        ring = {};
+        return ENOMEM;
+    }
+    m_tx_ring.offset = m_rx_ring.size();
+    return {};
+}
+
+ErrorOr<void> PacketSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_PACKET)
+        return Socket::setsockopt(level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+    switch (option) {
+    case PACKET_RX_RING:
+        return set_up_ring(m_rx_ring, user_value, user_value_size);
+    case PACKET_TX_RING:
+        return set_up_ring(m_tx_ring, user_value, user_value_size);
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+ErrorOr<void> PacketSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != SOL_PACKET)
+        return Socket::getsockopt(description, level, option, value, value_size);
+
+    MutexLocker locker(mutex());
+    socklen_t size;
+    TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
+
+    switch (option) {
+    case PACKET_STATISTICS: {
+        if (size < sizeof(tpacket_stats))
+            return EINVAL;
+        // Reading the statistics resets them, so that they can be polled for the numbers since the last time.
+        tpacket_stats stats { m_received_packets, m_dropped_packets };
+        TRY(copy_to_user(static_ptr_cast<tpacket_stats*>(value), &stats));
+        size = sizeof(tpacket_stats);
+        TRY(copy_to_user(value_size, &size));
+        m_received_packets = 0;
+        m_dropped_packets = 0;
+        return {};
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> PacketSocket::vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // The kernel keeps writing received frames into the rings after they are mapped, so only shared mappings of the whole thing make sense.
+    if (offset != 0 || !shared)
+        return EINVAL;
+
+    MutexLocker locker(mutex());
+    if (m_rings_are_mapped.load(AK::memory_order_acquire))
+        return *m_ring_vmobject;
+
+    auto size = m_rx_ring.size() + m_tx_ring.size();
+    if (size == 0)
+        return EINVAL;
+    // Note: Fresh anonymous pages are zeroed, so every frame starts out as owned by the kernel (RX) or available (TX).
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    m_ring_region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "PacketSocket ring"sv, Memory::Region::Access::ReadWrite));
+    m_ring_vmobject = vmobject;
+    m_rings_are_mapped.store(true, AK::memory_order_release);
+    return vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> PacketSocket::pseudo_path(OpenFileDescription const&) const
+{
+    if (auto adapter = bound_interface())
+        return KString::formatted("packet:{}", adapter->name());
+    return KString::try_create("packet"sv);
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/POSIX/netpacket/packet.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Net/Socket.h>
+
+namespace Kernel {
+
+// An AF_PACKET socket sees whole Ethernet frames. Received frames are written straight into an RX ring that
+// userspace maps, and frames that userspace puts into a TX ring are sent in batches by a single send(), so a
+// capture tool or a userspace protocol stack needs no syscall per packet. See Kernel/API/POSIX/netpacket/packet.h
+// for the layout of the rings. Without a TX ring, send() sends a single frame the usual way.
+class PacketSocket final : public Socket {
+public:
+    static ErrorOr<NonnullLockRefPtr<Socket>> try_create(int type, int protocol);
+    virtual ~PacketSocket() override;
+
+    // Hands a frame that was received on `adapter` to every packet socket that is interested in it.
+    static void deliver(NetworkAdapter& adapter, ReadonlyBytes frame, Time const& timestamp);
+
+    virtual ErrorOr<void> bind(Credentials const&, Userspace<sockaddr const*>, socklen_t) override;
+    virtual ErrorOr<void> connect(Credentials const&, OpenFileDescription&, Userspace<sockaddr const*>, socklen_t) override { return EOPNOTSUPP; }
+    virtual ErrorOr<void> listen(size_t) override { return EOPNOTSUPP; }
+    virtual void get_local_address(sockaddr*, socklen_t*) override;
+    virtual void get_peer_address(sockaddr*, socklen_t*) override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> sendto(OpenFileDescription&, UserOrKernelBuffer const&, size_t, int, Userspace<sockaddr const*>, socklen_t) override;
+    virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&, bool blocking) override;
+    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+
+private:
+    struct Ring {
+        u32 frame_size { 0 };
+        u32 frame_count { 0 };
+        size_t offset { 0 };
+
+        bool is_set_up() const { return frame_count != 0; }
+        size_t size() const { return static_cast<size_t>(frame_size) * frame_count; }
+    };
+
+    PacketSocket(int type, int protocol);
+    virtual StringView class_name() const override { return "PacketSocket"sv; }
+
+    bool wants(NetworkAdapter const&, ReadonlyBytes frame) const;
+    void did_receive(NetworkAdapter&, ReadonlyBytes frame, Time const& timestamp);
+
+    ErrorOr<void> set_up_ring(Ring&, Userspace<void const*>, socklen_t);
+    tpacket_hdr& frame_header(Ring const&, u32 index) const;
+    ErrorOr<size_t> send_frame(ReadonlyBytes);
+    ErrorOr<size_t> send_pending_frames();
+
+    // The ethertype to receive in network byte order, ETH_P_ALL, or 0 for nothing at all.
+    u16 m_ethertype { 0 };
+
+    // NOTE: The rings are only allocated once userspace maps them, and don't change after that. This lets
+    //       can_read() look at them without taking the socket mutex.
+    Ring m_rx_ring;
+    Ring m_tx_ring;
+    LockRefPtr<Memory::AnonymousVMObject> m_ring_vmobject;
+    OwnPtr<Memory::Region> m_ring_region;
+    Atomic<bool> m_rings_are_mapped { false };
+
+    Atomic<u32> m_rx_head { 0 };
+    u32 m_tx_head { 0 };
+    bool m_rx_is_losing { false };
+    u32 m_received_packets { 0 };
+    u32 m_dropped_packets { 0 };
+
+    IntrusiveListNode<PacketSocket> m_list_node;
+
+public:
+    using List = IntrusiveList<&PacketSocket::m_list_node>;
+    static MutexProtected<PacketSocket::List>& all_sockets();
+};
+
+}
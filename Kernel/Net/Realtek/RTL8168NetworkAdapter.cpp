@@ -8,6 +8,8 @@
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
+#include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Realtek/RTL8168NetworkAdapter.h>
 #include <Kernel/Sections.h>
@@ -261,6 +263,7 @@ UNMAP_AFTER_INIT RTL8168NetworkAdapter::RTL8168NetworkAdapter(PCI::Address addre
     }
 
     initialize();
+    setup_offloads();
     startup();
 }
 
@@ -1190,9 +1193,51 @@ UNMAP_AFTER_INIT void RTL8168NetworkAdapter::read_mac_address()
     set_mac_address(mac);
 }
 
+UNMAP_AFTER_INIT void RTL8168NetworkAdapter::setup_offloads()
+{
+    // NOTE: Segmented frames have to fit into a single TX buffer, as we only ever use one descriptor per frame.
+    auto offloads = NetworkOffload::TCPChecksum | NetworkOffload::ReceiveChecksum;
+    // The RTL8168E-VL is known to corrupt large sends.
+    if (m_version != ChipVersion::Version15)
+        offloads |= NetworkOffload::TCPSegmentation;
+    set_offloads(offloads, TX_BUFFER_SIZE);
+}
+
 void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     dbgln_if(RTL8168_DEBUG, "RTL8168: send_raw length={}", payload.size());
+    transmit(payload, 0, 0);
+}
+
+void RTL8168NetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    dbgln_if(RTL8168_DEBUG, "RTL8168: send_raw_with_offload length={}, mss={}", payload.size(), offload.maximum_segment_size);
+
+    // The offset of the TCP header, as the hardware does not parse the headers itself.
+    constexpr u16 transport_offset = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+
+    u16 flags = 0;
+    u16 vlan_flags = 0;
+    bool segment = has_flag(offload.offloads, NetworkOffload::TCPSegmentation);
+    if (m_version <= ChipVersion::Version3) {
+        // RTL8168B uses the first generation of the descriptor format.
+        if (segment)
+            flags = TXDescriptor::LargeSend | (offload.maximum_segment_size & 0x7FF);
+        else
+            flags = TXDescriptor::IPChecksumV1 | TXDescriptor::TCPChecksumV1;
+    } else {
+        if (segment) {
+            flags = TXDescriptor::GiantSendIPv4 | (transport_offset << 2);
+            vlan_flags = offload.maximum_segment_size << 2;
+        } else {
+            vlan_flags = TXDescriptor::IPChecksumV2 | TXDescriptor::TCPChecksumV2 | (transport_offset << 2);
+        }
+    }
+    transmit(payload, flags, vlan_flags);
+}
+
+void RTL8168NetworkAdapter::transmit(ReadonlyBytes payload, u16 offload_flags, u16 offload_vlan_flags)
+{
 
     if (payload.size() > TX_BUFFER_SIZE) {
         dmesgln("RTL8168: Packet was too big; discarding");
@@ -1205,7 +1250,7 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     if ((free_descriptor.flags & TXDescriptor::Ownership) != 0) {
         dbgln_if(RTL8168_DEBUG, "RTL8168: No free TX buffers, sleeping until one is available");
         m_wait_queue.wait_forever("RTL8168NetworkAdapter"sv);
-        return send_raw(payload);
+        return transmit(payload, offload_flags, offload_vlan_flags);
         // if we woke up a TX descriptor is guaranteed to be available, so this should never recurse more than once
         // but this can probably be done more cleanly
     }
@@ -1216,11 +1261,31 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     m_tx_free_index = (m_tx_free_index + 1) % number_of_tx_descriptors;
 
     free_descriptor.frame_length = payload.size() & 0x3FFF;
-    free_descriptor.flags = free_descriptor.flags | TXDescriptor::Ownership;
+    free_descriptor.vlan_tag = 0;
+    free_descriptor.vlan_flags = offload_vlan_flags;
+    auto ring_flags = free_descriptor.flags & (TXDescriptor::EndOfRing | TXDescriptor::FirstSegment | TXDescriptor::LastSegment);
+    free_descriptor.flags = ring_flags | offload_flags | TXDescriptor::Ownership;
 
     out8(REG_TXSTART, TXSTART_START); // FIXME: this shouldn't be done so often, we should look into doing this using the watchdog timer
 }
 
+bool RTL8168NetworkAdapter::has_bad_checksum(u16 flags, u16 buffer_size)
+{
+    // NOTE: The protocol bits are only set when the frame was parsed as IPv4, in which case the IP checksum was verified as well.
+    constexpr u16 protocol_udp = 1;
+    constexpr u16 protocol_tcp = 2;
+    auto protocol = (flags >> 1) & 0x3;
+    if (protocol == 0)
+        return false;
+    if ((flags & RXDescriptor::IPChecksumFailure) != 0)
+        return true;
+    if (protocol == protocol_tcp)
+        return (buffer_size & RXDescriptor::TCPChecksumFailure) != 0;
+    if (protocol == protocol_udp)
+        return (buffer_size & RXDescriptor::UDPChecksumFailure) != 0;
+    return false;
+}
+
 void RTL8168NetworkAdapter::receive()
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
@@ -1234,7 +1299,8 @@ void RTL8168NetworkAdapter::receive()
         }
 
         u16 flags = descriptor.flags;
-        u16 length = descriptor.buffer_size & 0x3FFF;
+        u16 buffer_size = descriptor.buffer_size;
+        u16 length = buffer_size & 0x3FFF;
 
         dbgln_if(RTL8168_DEBUG, "RTL8168: receive, flags={:#04x}, length={}, descriptor={}", flags, length, descriptor_index);
 
@@ -1244,6 +1310,8 @@ void RTL8168NetworkAdapter::receive()
             VERIFY_NOT_REACHED();
             // Our maximum received packet size is smaller than the descriptor buffer size, so packets should never be segmented
             // if this happens on a real NIC it might not respect that, and we will have to support packet segmentation
+        } else if (has_bad_checksum(flags, buffer_size)) {
+            dbgln_if(RTL8168_DEBUG, "RTL8168: receive dropped packet with bad checksum, flags={:#04x}", flags);
         } else {
             did_receive({ m_rx_buffers_regions[descriptor_index].vaddr().as_ptr(), length });
         }
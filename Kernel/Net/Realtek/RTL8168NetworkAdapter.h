@@ -27,6 +27,7 @@ public:
     virtual ~RTL8168NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) override;
     virtual bool link_up() override { return m_link_up; }
     virtual bool link_full_duplex() override;
     virtual i32 link_speed() override;
@@ -59,6 +60,17 @@ private:
         static constexpr u16 FirstSegment = 0x2000u;
         static constexpr u16 LastSegment = 0x1000u;
         static constexpr u16 LargeSend = 0x800u;
+
+        // flags bit field (RTL8168C and later)
+        static constexpr u16 GiantSendIPv4 = 0x400u;
+
+        // flags bit field (RTL8168B)
+        static constexpr u16 IPChecksumV1 = 0x4u;
+        static constexpr u16 TCPChecksumV1 = 0x1u;
+
+        // vlan_flags bit field (RTL8168C and later)
+        static constexpr u16 TCPChecksumV2 = 0x4000u;
+        static constexpr u16 IPChecksumV2 = 0x2000u;
     };
 
     static_assert(AssertSize<TXDescriptor, 16u>());
@@ -83,6 +95,11 @@ private:
         static constexpr u16 ErrorSummary = 0x20;
         static constexpr u16 RuntPacket = 0x10;
         static constexpr u16 CRCError = 0x8;
+        static constexpr u16 IPChecksumFailure = 0x1;
+
+        // buffer_size bit field
+        static constexpr u16 UDPChecksumFailure = 0x8000u;
+        static constexpr u16 TCPChecksumFailure = 0x4000u;
     };
 
     static_assert(AssertSize<RXDescriptor, 16u>());
@@ -130,6 +147,8 @@ private:
     void start_hardware();
     void initialize();
     void startup();
+    void setup_offloads();
+    void transmit(ReadonlyBytes, u16 offload_flags, u16 offload_vlan_flags);
 
     void configure_phy();
     void configure_phy_b_1();
@@ -150,6 +169,7 @@ private:
     void initialize_tx_descriptors();
 
     void receive();
+    static bool has_bad_checksum(u16 flags, u16 buffer_size);
 
     void out8(u16 address, u8 data);
     void out16(u16 address, u16 data);
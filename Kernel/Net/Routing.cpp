@@ -16,8 +16,8 @@
 
 namespace Kernel {
 
-static Singleton<SpinlockProtected<HashMap<IPv4Address, MACAddress>>> s_arp_table;
-static Singleton<SpinlockProtected<Route::RouteList>> s_routing_table;
+static Singleton<RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>> s_arp_table;
+static Singleton<RWSpinlockProtected<Route::RouteList>> s_routing_table;
 
 class ARPTableBlocker final : public Thread::Blocker {
 public:
@@ -71,7 +71,7 @@ protected:
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::Routing);
         auto& blocker = static_cast<ARPTableBlocker&>(b);
-        auto maybe_mac_address = arp_table().with([&](auto const& table) -> auto{
+        auto maybe_mac_address = arp_table().with_shared([&](auto const& table) -> auto{
             return table.get(blocker.ip_address());
         });
         if (!maybe_mac_address.has_value())
@@ -95,7 +95,7 @@ bool ARPTableBlocker::setup_blocker()
 
 void ARPTableBlocker::will_unblock_immediately_without_blocking(UnblockImmediatelyReason)
 {
-    auto addr = arp_table().with([&](auto const& table) -> auto{
+    auto addr = arp_table().with_shared([&](auto const& table) -> auto{
         return table.get(ip_address());
     });
 
@@ -106,14 +106,14 @@ void ARPTableBlocker::will_unblock_immediately_without_blocking(UnblockImmediate
     }
 }
 
-SpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table()
+RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table()
 {
     return *s_arp_table;
 }
 
 void update_arp_table(IPv4Address const& ip_addr, MACAddress const& addr, UpdateTable update)
 {
-    arp_table().with([&](auto& table) {
+    arp_table().with_exclusive([&](auto& table) {
         if (update == UpdateTable::Set)
             table.set(ip_addr, addr);
         if (update == UpdateTable::Delete)
@@ -122,7 +122,7 @@ void update_arp_table(IPv4Address const& ip_addr, MACAddress const& addr, Update
     s_arp_table_blocker_set->unblock_blockers_waiting_for_ipv4_address(ip_addr, addr);
 
     if constexpr (ARP_DEBUG) {
-        arp_table().with([&](auto const& table) {
+        arp_table().with_shared([&](auto const& table) {
             dmesgln("ARP table ({} entries):", table.size());
             for (auto& it : table)
                 dmesgln("{} :: {}", it.value.to_string(), it.key.to_string());
@@ -130,7 +130,7 @@ void update_arp_table(IPv4Address const& ip_addr, MACAddress const& addr, Update
     }
 }
 
-SpinlockProtected<Route::RouteList>& routing_table()
+RWSpinlockProtected<Route::RouteList>& routing_table()
 {
     return *s_routing_table;
 }
@@ -143,7 +143,7 @@ ErrorOr<void> update_routing_table(IPv4Address const& destination, IPv4Address c
     if (!route_entry)
         return ENOMEM;
 
-    TRY(routing_table().with([&](auto& table) -> ErrorOr<void> {
+    TRY(routing_table().with_exclusive([&](auto& table) -> ErrorOr<void> {
         if (update == UpdateTable::Set) {
             for (auto const& route : table) {
                 if (route == *route_entry)
@@ -223,7 +223,7 @@ RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, L
     });
 
     u32 longest_prefix_match = 0;
-    routing_table().for_each([&target_addr, &matches, &longest_prefix_match, &chosen_route](auto& route) {
+    routing_table().for_each_shared([&target_addr, &matches, &longest_prefix_match, &chosen_route](auto& route) {
         auto route_addr = route.destination.to_u32();
         auto route_mask = route.netmask.to_u32();
 
@@ -301,7 +301,7 @@ RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, L
         return { adapter, multicast_ethernet_address(target) };
 
     {
-        auto addr = arp_table().with([&](auto const& table) -> auto{
+        auto addr = arp_table().with_shared([&](auto const& table) -> auto{
             return table.get(next_hop_ip);
         });
         if (addr.has_value()) {
@@ -9,6 +9,7 @@
 #include <AK/IPv4Address.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/RWSpinlockProtected.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Thread.h>
 
@@ -66,7 +67,7 @@ enum class AllowUsingGateway {
 
 RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, LockRefPtr<NetworkAdapter> const through = nullptr, AllowUsingGateway = AllowUsingGateway::Yes);
 
-SpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table();
-SpinlockProtected<Route::RouteList>& routing_table();
+RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table();
+RWSpinlockProtected<Route::RouteList>& routing_table();
 
 }
@@ -11,6 +11,7 @@
 #include <Kernel/Net/IPv4Socket.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/PacketSocket.h>
 #include <Kernel/Net/Socket.h>
 #include <Kernel/Process.h>
 #include <Kernel/UnixTypes.h>
@@ -24,6 +25,8 @@ ErrorOr<NonnullLockRefPtr<Socket>> Socket::create(int domain, int type, int prot
         return TRY(LocalSocket::try_create(type & SOCK_TYPE_MASK));
     case AF_INET:
         return IPv4Socket::create(type & SOCK_TYPE_MASK, protocol);
+    case AF_PACKET:
+        return PacketSocket::try_create(type & SOCK_TYPE_MASK, protocol);
     default:
         return EAFNOSUPPORT;
     }
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/Traits.h>
+#include <Kernel/Locking/MutexProtected.h>
+
+namespace Kernel {
+
+// A hash table of sockets that is split into independently locked shards.
+// Demultiplexing an incoming packet only takes the (shared) lock of the shard its key hashes to,
+// so lookups for different connections don't contend with each other or with connection setup.
+template<typename Key, typename Value, size_t ShardCount>
+class SocketTable {
+    AK_MAKE_NONCOPYABLE(SocketTable);
+    AK_MAKE_NONMOVABLE(SocketTable);
+
+public:
+    using Shard = HashMap<Key, Value>;
+
+    SocketTable() = default;
+
+    template<typename Callback>
+    decltype(auto) with_shared(Key const& key, Callback callback) const
+    {
+        return shard_for(key).with_shared(move(callback));
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(Key const& key, Callback callback)
+    {
+        return shard_for(key).with_exclusive(move(callback));
+    }
+
+    Optional<Value> get(Key const& key) const
+    {
+        return with_shared(key, [&](auto const& shard) { return shard.get(key); });
+    }
+
+    // NOTE: Only one shard is locked at a time, so this doesn't see a consistent snapshot of the whole table.
+    template<typename Callback>
+    void for_each_shared(Callback callback) const
+    {
+        for (auto& shard : m_shards)
+            shard.for_each_shared(callback);
+    }
+
+    template<typename Callback>
+    ErrorOr<void> try_for_each_shared(Callback callback) const
+    {
+        for (auto& shard : m_shards) {
+            TRY(shard.with_shared([&](auto const& entries) -> ErrorOr<void> {
+                for (auto& entry : entries)
+                    TRY(callback(entry));
+                return {};
+            }));
+        }
+        return {};
+    }
+
+private:
+    MutexProtected<Shard>& shard_for(Key const& key) { return m_shards[Traits<Key>::hash(key) % ShardCount]; }
+    MutexProtected<Shard> const& shard_for(Key const& key) const { return m_shards[Traits<Key>::hash(key) % ShardCount]; }
+
+    Array<MutexProtected<Shard>, ShardCount> m_shards;
+};
+
+}
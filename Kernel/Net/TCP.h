@@ -22,6 +22,15 @@ struct TCPFlags {
     };
 };
 
+enum class TCPOptionKind : u8 {
+    End = 0,
+    NoOperation = 1,
+    MSS = 2,
+    WindowScale = 3,
+    SACKPermitted = 4,
+    SACK = 5,
+};
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -32,13 +41,51 @@ public:
     u16 value() const { return m_value; }
 
 private:
-    u8 m_option_kind { 0x02 };
+    u8 m_option_kind { (u8)TCPOptionKind::MSS };
     u8 m_option_length { sizeof(TCPOptionMSS) };
     NetworkOrdered<u16> m_value;
 };
 
 static_assert(AssertSize<TCPOptionMSS, 4>());
 
+// RFC 7323
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 shift_count)
+        : m_shift_count(shift_count)
+    {
+    }
+
+    u8 shift_count() const { return m_shift_count; }
+
+private:
+    u8 m_option_kind { (u8)TCPOptionKind::WindowScale };
+    u8 m_option_length { sizeof(TCPOptionWindowScale) };
+    u8 m_shift_count { 0 };
+};
+
+static_assert(AssertSize<TCPOptionWindowScale, 3>());
+
+// RFC 2018
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_option_kind { (u8)TCPOptionKind::SACKPermitted };
+    u8 m_option_length { sizeof(TCPOptionSACKPermitted) };
+};
+
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+static_assert(AssertSize<TCPSACKBlock, 8>());
+
+// Sequence numbers wrap around, so they can only be compared relative to each other (RFC 793, 3.3).
+constexpr bool tcp_sequence_number_before(u32 a, u32 b) { return static_cast<i32>(a - b) < 0; }
+constexpr bool tcp_sequence_number_before_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) <= 0; }
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
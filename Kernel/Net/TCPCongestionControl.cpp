@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/OwnPtr.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(Algorithm algorithm, size_t maximum_segment_size)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewReno(maximum_segment_size)));
+    case Algorithm::CUBIC:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPCUBIC(maximum_segment_size)));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::CUBIC;
+    return {};
+}
+
+StringView TCPCongestionControl::to_string(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return "newreno"sv;
+    case Algorithm::CUBIC:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// RFC 6928
+static size_t initial_window(size_t maximum_segment_size)
+{
+    return min(10 * maximum_segment_size, max<size_t>(2 * maximum_segment_size, 14600));
+}
+
+TCPCongestionControl::TCPCongestionControl(size_t maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+    , m_congestion_window(initial_window(maximum_segment_size))
+{
+}
+
+void TCPCongestionControl::set_maximum_segment_size(size_t maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    m_maximum_segment_size = maximum_segment_size;
+    m_congestion_window = initial_window(maximum_segment_size);
+}
+
+void TCPCongestionControl::on_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt)
+{
+    if (m_in_recovery)
+        return;
+    if (m_congestion_window < m_slow_start_threshold) {
+        m_congestion_window += min(acknowledged_bytes, m_maximum_segment_size);
+        return;
+    }
+    on_congestion_avoidance_ack(acknowledged_bytes, now, smoothed_rtt);
+}
+
+void TCPCongestionControl::enter_recovery(size_t bytes_in_flight)
+{
+    if (m_in_recovery)
+        return;
+    m_slow_start_threshold = on_congestion_event(bytes_in_flight);
+    // Account for the three segments that have left the network to cause the duplicate ACKs.
+    m_congestion_window = m_slow_start_threshold + 3 * m_maximum_segment_size;
+    m_in_recovery = true;
+}
+
+void TCPCongestionControl::on_duplicate_ack()
+{
+    if (m_in_recovery)
+        m_congestion_window += m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_partial_ack(size_t acknowledged_bytes)
+{
+    VERIFY(m_in_recovery);
+    // Deflate the window by the amount of new data acknowledged, and add back one segment for the retransmission.
+    m_congestion_window -= min(acknowledged_bytes, m_congestion_window);
+    m_congestion_window = max(m_congestion_window + m_maximum_segment_size, m_maximum_segment_size);
+}
+
+void TCPCongestionControl::exit_recovery()
+{
+    if (!m_in_recovery)
+        return;
+    m_congestion_window = m_slow_start_threshold;
+    m_in_recovery = false;
+}
+
+void TCPCongestionControl::on_retransmit_timeout(size_t bytes_in_flight)
+{
+    m_slow_start_threshold = on_congestion_event(bytes_in_flight);
+    m_congestion_window = m_maximum_segment_size;
+    m_in_recovery = false;
+}
+
+size_t TCPNewReno::on_congestion_event(size_t bytes_in_flight)
+{
+    m_bytes_acknowledged = 0;
+    return max(bytes_in_flight / 2, minimum_congestion_window());
+}
+
+void TCPNewReno::on_congestion_avoidance_ack(size_t acknowledged_bytes, Time, Time)
+{
+    // Appropriate Byte Counting (RFC 3465): one segment per window of acknowledged data.
+    m_bytes_acknowledged += acknowledged_bytes;
+    if (m_bytes_acknowledged >= m_congestion_window) {
+        m_bytes_acknowledged -= m_congestion_window;
+        m_congestion_window += m_maximum_segment_size;
+    }
+}
+
+// NOTE: The constants are C = 0.4 and beta = 0.7, all of the math below is written out in integers.
+static u64 integer_cube_root(u64 value)
+{
+    u64 low = 0;
+    u64 high = 2642246; // cbrt(2^64)
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+size_t TCPCUBIC::on_congestion_event(size_t)
+{
+    m_epoch_start.clear();
+    // Fast convergence: Release some bandwidth to new flows if we didn't get back to the previous maximum.
+    if (m_congestion_window < m_last_window_max)
+        m_window_max = m_congestion_window * 17 / 20;
+    else
+        m_window_max = m_congestion_window;
+    m_last_window_max = m_congestion_window;
+    return max(m_congestion_window * 7 / 10, minimum_congestion_window());
+}
+
+size_t TCPCUBIC::window_at(i64 milliseconds_since_epoch_start) const
+{
+    // W_cubic(t) = C * (t - K)^3 + W_max, with t in seconds and the windows in segments.
+    // The distance is clamped to 100 seconds to keep the cube within 64 bits.
+    auto distance = clamp<i64>(milliseconds_since_epoch_start - m_time_to_window_max, -100'000, 100'000);
+    auto milli_segments = 2 * distance * distance * distance / 5'000'000;
+    auto window = static_cast<i64>(m_window_max) + milli_segments * static_cast<i64>(m_maximum_segment_size) / 1000;
+    return max<i64>(window, minimum_congestion_window());
+}
+
+void TCPCUBIC::on_congestion_avoidance_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt)
+{
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        if (m_congestion_window < m_window_max) {
+            // K = cbrt((W_max - cwnd) / C), in milliseconds.
+            u64 bytes_to_window_max = m_window_max - m_congestion_window;
+            m_time_to_window_max = integer_cube_root(bytes_to_window_max * 2'500'000'000ull / m_maximum_segment_size);
+        } else {
+            m_time_to_window_max = 0;
+            m_window_max = m_congestion_window;
+        }
+    }
+
+    auto elapsed = (now - m_epoch_start.value()).to_milliseconds();
+    auto rtt = max<i64>(smoothed_rtt.to_milliseconds(), 1);
+
+    // The window standard TCP would have reached, CUBIC shouldn't be slower than that on short RTTs.
+    // W_est(t) = W_max * beta + (3 * (1 - beta) / (1 + beta)) * t / RTT
+    size_t reno_window = m_window_max * 7 / 10 + static_cast<i64>(m_maximum_segment_size) * 9 * elapsed / (17 * rtt);
+    if (reno_window > m_congestion_window && reno_window > window_at(elapsed)) {
+        m_congestion_window = reno_window;
+        return;
+    }
+
+    // Grow towards the window we should have one RTT from now, but by no more than half a window per RTT.
+    auto target = min(window_at(elapsed + rtt), m_congestion_window * 3 / 2);
+    if (target <= m_congestion_window)
+        return;
+    m_congestion_window += max<size_t>((target - m_congestion_window) * acknowledged_bytes / m_congestion_window, 1);
+}
+
+}
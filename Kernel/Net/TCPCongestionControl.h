@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Decides how much unacknowledged data a TCPSocket may have in flight.
+// Slow start and fast recovery (RFC 5681, RFC 6582) are shared, algorithms only decide
+// how the window grows during congestion avoidance and how far it shrinks after a loss.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        NewReno,
+        CUBIC,
+    };
+
+    static constexpr Algorithm default_algorithm = Algorithm::CUBIC;
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(Algorithm, size_t maximum_segment_size);
+    static Optional<Algorithm> algorithm_from_name(StringView);
+    static StringView to_string(Algorithm);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual Algorithm algorithm() const = 0;
+
+    size_t congestion_window() const { return m_congestion_window; }
+    size_t slow_start_threshold() const { return m_slow_start_threshold; }
+    size_t maximum_segment_size() const { return m_maximum_segment_size; }
+    bool is_in_recovery() const { return m_in_recovery; }
+
+    // Once the peer told us its MSS, before any data was sent.
+    void set_maximum_segment_size(size_t);
+
+    // An ACK acknowledged new data outside of recovery.
+    void on_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt);
+
+    // Three duplicate ACKs arrived, so a segment was (most likely) lost.
+    void enter_recovery(size_t bytes_in_flight);
+    void on_duplicate_ack();
+    void on_partial_ack(size_t acknowledged_bytes);
+    void exit_recovery();
+
+    void on_retransmit_timeout(size_t bytes_in_flight);
+
+protected:
+    explicit TCPCongestionControl(size_t maximum_segment_size);
+
+    // Returns the new slow start threshold.
+    virtual size_t on_congestion_event(size_t bytes_in_flight) = 0;
+    virtual void on_congestion_avoidance_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt) = 0;
+
+    size_t minimum_congestion_window() const { return 2 * m_maximum_segment_size; }
+
+    size_t m_maximum_segment_size { 0 };
+    size_t m_congestion_window { 0 };
+    size_t m_slow_start_threshold { NumericLimits<size_t>::max() };
+
+private:
+    bool m_in_recovery { false };
+};
+
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    explicit TCPNewReno(size_t maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+private:
+    virtual size_t on_congestion_event(size_t bytes_in_flight) override;
+    virtual void on_congestion_avoidance_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt) override;
+
+    size_t m_bytes_acknowledged { 0 };
+};
+
+// RFC 8312
+class TCPCUBIC final : public TCPCongestionControl {
+public:
+    explicit TCPCUBIC(size_t maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::CUBIC; }
+
+private:
+    virtual size_t on_congestion_event(size_t bytes_in_flight) override;
+    virtual void on_congestion_avoidance_ack(size_t acknowledged_bytes, Time now, Time smoothed_rtt) override;
+
+    size_t window_at(i64 milliseconds_since_epoch_start) const;
+
+    size_t m_window_max { 0 };
+    size_t m_last_window_max { 0 };
+    i64 m_time_to_window_max { 0 }; // K, in milliseconds
+    Optional<Time> m_epoch_start;
+};
+
+}
@@ -22,25 +22,33 @@
 
 namespace Kernel {
 
+DEFINE_SLAB_CACHE(TCPSocket);
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
-    sockets_by_tuple().for_each_shared([&](auto const& it) {
-        callback(*it.value);
-    });
+    auto for_each_in_table = [&](SocketTable const& table) {
+        table.for_each_shared([&](auto const& it) {
+            callback(*it.value);
+        });
+    };
+    for_each_in_table(listening_sockets());
+    for_each_in_table(connected_sockets());
 }
 
 ErrorOr<void> TCPSocket::try_for_each(Function<ErrorOr<void>(TCPSocket const&)> callback)
 {
-    return sockets_by_tuple().with_shared([&](auto const& sockets) -> ErrorOr<void> {
-        for (auto& it : sockets)
-            TRY(callback(*it.value));
-        return {};
-    });
+    auto try_for_each_in_table = [&](SocketTable const& table) {
+        return table.try_for_each_shared([&](auto const& it) {
+            return callback(*it.value);
+        });
+    };
+    TRY(try_for_each_in_table(listening_sockets()));
+    return try_for_each_in_table(connected_sockets());
 }
 
 bool TCPSocket::unref() const
 {
-    bool did_hit_zero = sockets_by_tuple().with_exclusive([&](auto& table) {
+    bool did_hit_zero = sockets_by_tuple(tuple()).with_exclusive(tuple(), [&](auto& table) {
         if (deref_base())
             return false;
         table.remove(tuple());
@@ -95,42 +103,55 @@ MutexProtected<HashMap<IPv4SocketTuple, LockRefPtr<TCPSocket>>>& TCPSocket::clos
     return *s_socket_closing;
 }
 
-static Singleton<MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
+static Singleton<TCPSocket::SocketTable> s_listening_sockets;
+static Singleton<TCPSocket::SocketTable> s_connected_sockets;
 
-MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
+TCPSocket::SocketTable& TCPSocket::listening_sockets()
 {
-    return *s_socket_tuples;
+    return *s_listening_sockets;
+}
+
+TCPSocket::SocketTable& TCPSocket::connected_sockets()
+{
+    return *s_connected_sockets;
+}
+
+TCPSocket::SocketTable& TCPSocket::sockets_by_tuple(IPv4SocketTuple const& tuple)
+{
+    if (tuple.peer_address().is_zero() && tuple.peer_port() == 0)
+        return listening_sockets();
+    return connected_sockets();
 }
 
 LockRefPtr<TCPSocket> TCPSocket::from_tuple(IPv4SocketTuple const& tuple)
 {
-    return sockets_by_tuple().with_shared([&](auto const& table) -> LockRefPtr<TCPSocket> {
-        auto exact_match = table.get(tuple);
-        if (exact_match.has_value())
-            return { *exact_match.value() };
+    auto lookup = [](SocketTable const& table, IPv4SocketTuple const& tuple) -> LockRefPtr<TCPSocket> {
+        // NOTE: The reference has to be taken while the shard is locked, since unref() removes the socket under the same lock.
+        return table.with_shared(tuple, [&](auto const& shard) -> LockRefPtr<TCPSocket> {
+            auto match = shard.get(tuple);
+            if (!match.has_value())
+                return {};
+            return { *match.value() };
+        });
+    };
 
-        auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
-        auto address_match = table.get(address_tuple);
-        if (address_match.has_value())
-            return { *address_match.value() };
+    if (auto exact_match = lookup(connected_sockets(), tuple))
+        return exact_match;
 
-        auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
-        auto wildcard_match = table.get(wildcard_tuple);
-        if (wildcard_match.has_value())
-            return { *wildcard_match.value() };
+    if (auto address_match = lookup(listening_sockets(), IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0)))
+        return address_match;
 
-        return {};
-    });
+    return lookup(listening_sockets(), IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0));
 }
 ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const& new_local_address, u16 new_local_port, IPv4Address const& new_peer_address, u16 new_peer_port)
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<NonnullLockRefPtr<TCPSocket>> {
+    return sockets_by_tuple(tuple).with_exclusive(tuple, [&](auto& table) -> ErrorOr<NonnullLockRefPtr<TCPSocket>> {
         if (table.contains(tuple))
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
-        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer), m_congestion_control->algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -162,8 +183,9 @@ void TCPSocket::release_for_accept(NonnullLockRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+    , m_congestion_control(move(congestion_control))
 {
     m_last_retransmit_time = kgettimeofday();
 }
@@ -175,11 +197,13 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm congestion_control_algorithm)
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    // NOTE: The segment size is updated once we know where we're sending to.
+    auto congestion_control = TRY(TCPCongestionControl::try_create(congestion_control_algorithm, default_maximum_segment_size));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -205,8 +229,28 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
+    size_t mss = maximum_segment_size(*routing_decision.adapter);
+    size_t max_payload_size = mss;
+    // Hand the adapter as many full segments as it can split up by itself.
+    if (routing_decision.adapter->supports_offload(NetworkOffload::TCPSegmentation)) {
+        auto max_segmentation_payload_size = routing_decision.adapter->max_segmentation_frame_size() - routing_decision.adapter->ipv4_payload_offset() - sizeof(TCPPacket);
+        max_payload_size = max(mss, max_segmentation_payload_size - max_segmentation_payload_size % mss);
+    }
+
+    auto window_space = m_unacked_packets.with_shared([&](auto const& unacked_packets) -> size_t {
+        auto bytes_in_flight = unacked_packets.bytes_in_flight();
+        if (bytes_in_flight < send_window())
+            return send_window() - bytes_in_flight;
+        // NOTE: Nothing is in flight, so the peer must have closed its window. Probe it with a single segment,
+        //       which is retransmitted until the window opens again.
+        if (unacked_packets.packets.is_empty())
+            return mss;
+        return 0;
+    });
+    if (window_space == 0)
+        return set_so_error(EAGAIN);
+
+    data_length = min(data_length, min(max_payload_size, window_space));
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -226,8 +270,19 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    // Window scaling and SACK are offered in our SYN, and only confirmed in a SYN-ACK if the peer offered them too.
+    bool const is_syn = flags & TCPFlags::SYN;
+    bool const is_syn_ack = is_syn && (flags & TCPFlags::ACK);
+    bool const has_mss_option = is_syn;
+    bool const has_window_scale_option = is_syn && (!is_syn_ack || m_window_scaling_enabled);
+    bool const has_sack_permitted_option = is_syn && (!is_syn_ack || m_sack_permitted);
+    size_t options_size = 0;
+    if (has_mss_option)
+        options_size += sizeof(TCPOptionMSS);
+    if (has_window_scale_option)
+        options_size += 1 + sizeof(TCPOptionWindowScale);
+    if (has_sack_permitted_option)
+        options_size += 2 + sizeof(TCPOptionSACKPermitted);
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -241,7 +296,15 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    if (has_window_scale_option) {
+        // Pick the smallest scale that lets us advertise all of our receive buffer.
+        m_receive_window_scale = 0;
+        while (m_receive_window_scale < maximum_window_scale && (receive_buffer_space() >> m_receive_window_scale) > NumericLimits<u16>::max())
+            ++m_receive_window_scale;
+    }
+    // NOTE: The window in a SYN is never scaled.
+    auto receive_window = is_syn ? receive_buffer_space() : receive_buffer_space() >> m_receive_window_scale;
+    tcp_packet.set_window_size(min<size_t>(receive_window, NumericLimits<u16>::max()));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -265,22 +328,54 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
-        u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-        TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+    if (options_size > 0) {
+        auto* options = packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket);
+        auto append_option = [&](void const* option, size_t size) {
+            memcpy(options, option, size);
+            options += size;
+        };
+        u8 const no_operation = (u8)TCPOptionKind::NoOperation;
+        if (has_mss_option) {
+            TCPOptionMSS mss_option { static_cast<u16>(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket)) };
+            append_option(&mss_option, sizeof(mss_option));
+        }
+        if (has_window_scale_option) {
+            TCPOptionWindowScale window_scale_option { m_receive_window_scale };
+            append_option(&no_operation, 1);
+            append_option(&window_scale_option, sizeof(window_scale_option));
+        }
+        if (has_sack_permitted_option) {
+            TCPOptionSACKPermitted sack_permitted_option;
+            append_option(&no_operation, 1);
+            append_option(&no_operation, 1);
+            append_option(&sack_permitted_option, sizeof(sack_permitted_option));
+        }
+        VERIFY(options == packet->buffer->data() + ipv4_payload_offset + tcp_header_size);
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    TransmitOffload offload;
+    size_t mss = maximum_segment_size(*routing_decision.adapter);
+    if (payload_size > mss) {
+        offload.offloads = NetworkOffload::TCPSegmentation;
+        offload.maximum_segment_size = mss;
+    } else if (routing_decision.adapter->supports_offload(NetworkOffload::TCPChecksum)) {
+        offload.offloads = NetworkOffload::TCPChecksum;
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), offload);
 
     m_packets_out++;
     m_bytes_out += buffer_size;
     if (tcp_packet.has_syn() || payload_size > 0) {
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            unacked_packets.packets.append({ m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter });
+            // Start the retransmission timer if nothing was in flight yet (RFC 6298, 5.1).
+            if (unacked_packets.packets.is_empty()) {
+                m_last_retransmit_time = kgettimeofday();
+                m_send_unacknowledged = tcp_packet.sequence_number();
+            }
+            unacked_packets.packets.append({ m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter, offload });
             unacked_packets.size += payload_size;
             enqueue_for_retransmit();
         });
@@ -291,46 +386,313 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     return {};
 }
 
+template<typename Callback>
+static void for_each_option(TCPPacket const& packet, Callback callback)
+{
+    if (packet.header_size() <= sizeof(TCPPacket))
+        return;
+    auto const* options = reinterpret_cast<u8 const*>(&packet) + sizeof(TCPPacket);
+    size_t options_size = packet.header_size() - sizeof(TCPPacket);
+    for (size_t offset = 0; offset < options_size;) {
+        auto kind = static_cast<TCPOptionKind>(options[offset]);
+        if (kind == TCPOptionKind::End)
+            return;
+        if (kind == TCPOptionKind::NoOperation) {
+            ++offset;
+            continue;
+        }
+        if (offset + 1 >= options_size)
+            return;
+        u8 length = options[offset + 1];
+        if (length < 2 || offset + length > options_size)
+            return;
+        callback(kind, ReadonlyBytes { options + offset + 2, length - 2u });
+        offset += length;
+    }
+}
+
+void TCPSocket::process_syn_options(TCPPacket const& packet)
+{
+    VERIFY(packet.has_syn());
+
+    Optional<u16> maximum_segment_size;
+    Optional<u8> window_scale;
+    bool sack_permitted = false;
+    for_each_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == sizeof(u16))
+                maximum_segment_size = (data[0] << 8) | data[1];
+            break;
+        case TCPOptionKind::WindowScale:
+            if (data.size() == sizeof(u8))
+                window_scale = min(data[0], maximum_window_scale);
+            break;
+        case TCPOptionKind::SACKPermitted:
+            sack_permitted = data.is_empty();
+            break;
+        default:
+            break;
+        }
+    });
+
+    if (maximum_segment_size.has_value() && maximum_segment_size.value() > 0)
+        m_peer_maximum_segment_size = maximum_segment_size;
+    m_window_scaling_enabled = window_scale.has_value();
+    m_send_window_scale = window_scale.value_or(0);
+    if (!m_window_scaling_enabled)
+        m_receive_window_scale = 0;
+    m_sack_permitted = sack_permitted;
+
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (!routing_decision.is_zero())
+        m_congestion_control->set_maximum_segment_size(this->maximum_segment_size(*routing_decision.adapter));
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) peer options: mss={}, window_scale={}, sack_permitted={}", this, m_peer_maximum_segment_size, window_scale, m_sack_permitted);
+}
+
+size_t TCPSocket::maximum_segment_size(NetworkAdapter const& adapter) const
+{
+    size_t mss = adapter.mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    return min(mss, static_cast<size_t>(m_peer_maximum_segment_size.value_or(default_maximum_segment_size)));
+}
+
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
+    if (packet.has_syn() && m_state != State::Listen)
+        process_syn_options(packet);
+
     if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+        // NOTE: The window in a SYN is never scaled.
+        auto send_window_size = packet.has_syn() ? packet.window_size() : static_cast<size_t>(packet.window_size()) << m_send_window_scale;
+        bool did_window_change = send_window_size != m_send_window_size;
+        m_send_window_size = send_window_size;
+        receive_ack(packet, size - min<size_t>(size, packet.header_size()), did_window_change);
+    }
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+    m_packets_in++;
+    m_bytes_in += packet.header_size() + size;
+}
+
+static size_t payload_size_of(PacketWithTimestamp& packet, size_t ipv4_payload_offset)
+{
+    auto& tcp_packet = *reinterpret_cast<TCPPacket const*>(packet.buffer->data() + ipv4_payload_offset);
+    return packet.buffer->data() + packet.buffer->size() - static_cast<u8 const*>(tcp_packet.payload());
+}
+
+void TCPSocket::receive_ack(TCPPacket const& packet, size_t payload_size, bool did_window_change)
+{
+    u32 ack_number = packet.ack_number();
+    auto now = kgettimeofday();
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (m_sack_permitted)
+            process_sack_blocks(packet, unacked_packets);
 
         int removed = 0;
-        m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            while (!unacked_packets.packets.is_empty()) {
-                auto& packet = unacked_packets.packets.first();
-
-                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
-
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
+        size_t acknowledged_bytes = 0;
+        Optional<Time> rtt_sample;
+        while (!unacked_packets.packets.is_empty()) {
+            auto& packet = unacked_packets.packets.first();
+
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+
+            if (!tcp_sequence_number_before_or_equal(packet.ack_number, ack_number))
+                break;
+
+            // Karn's algorithm: Only packets that weren't retransmitted tell us anything about the round-trip time.
+            if (packet.tx_counter == 0)
+                rtt_sample = now - packet.buffer->timestamp;
+
+            auto packet_payload_size = payload_size_of(*packet.buffer, packet.ipv4_payload_offset);
+            unacked_packets.size -= packet_payload_size;
+            if (packet.sacked)
+                unacked_packets.sacked_size -= packet_payload_size;
+            acknowledged_bytes += packet_payload_size;
+
+            auto old_adapter = packet.adapter.strong_ref();
+            if (old_adapter)
+                old_adapter->release_packet_buffer(*packet.buffer);
+            unacked_packets.packets.take_first();
+            removed++;
+        }
+
+        if (removed > 0) {
+            m_send_unacknowledged = ack_number;
+            m_duplicate_acks_received = 0;
+            if (rtt_sample.has_value())
+                update_round_trip_time(rtt_sample.value());
+
+            // New data was acknowledged, so restart the retransmission timer (RFC 6298, 5.3).
+            m_retransmit_attempts = 0;
+            m_last_retransmit_time = now;
+
+            if (m_in_loss_recovery && tcp_sequence_number_before(ack_number, m_recovery_point)) {
+                if (m_congestion_control->is_in_recovery()) {
+                    // NewReno: A partial ACK means that the next segment was lost as well.
+                    m_congestion_control->on_partial_ack(acknowledged_bytes);
+                    mark_first_packet_lost(unacked_packets);
+                    retransmit_lost_packets(unacked_packets, 1);
+                } else {
+                    // Recovering from a retransmission timeout, the window grows in slow start.
+                    m_congestion_control->on_ack(acknowledged_bytes, now, m_smoothed_rtt);
+                    retransmit_lost_packets(unacked_packets, 2);
+                }
+            } else {
+                if (m_in_loss_recovery) {
+                    m_in_loss_recovery = false;
+                    m_congestion_control->exit_recovery();
                 } else {
-                    break;
+                    m_congestion_control->on_ack(acknowledged_bytes, now, m_smoothed_rtt);
                 }
             }
+        } else if (payload_size == 0 && !packet.has_syn() && !packet.has_fin() && !did_window_change
+            && ack_number == m_send_unacknowledged && !unacked_packets.packets.is_empty()) {
+            ++m_duplicate_acks_received;
+            if (m_duplicate_acks_received == 3 && !m_in_loss_recovery) {
+                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) three duplicate ACKs, entering fast recovery", this);
+                m_in_loss_recovery = true;
+                m_recovery_point = m_sequence_number;
+                m_congestion_control->enter_recovery(unacked_packets.bytes_in_flight());
+                mark_first_packet_lost(unacked_packets);
+                retransmit_lost_packets(unacked_packets, 1);
+            } else if (m_duplicate_acks_received > 3) {
+                // Another segment has left the network, which lets us fill one more hole the peer told us about.
+                m_congestion_control->on_duplicate_ack();
+                retransmit_lost_packets(unacked_packets, 1);
+            }
+        }
 
-            if (unacked_packets.packets.is_empty()) {
-                m_retransmit_attempts = 0;
-                dequeue_for_retransmit();
+        if (unacked_packets.packets.is_empty()) {
+            m_retransmit_attempts = 0;
+            dequeue_for_retransmit();
+        }
+
+        if (removed > 0 || did_window_change)
+            evaluate_block_conditions();
+
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+    });
+}
+
+void TCPSocket::process_sack_blocks(TCPPacket const& packet, UnackedPackets& unacked_packets)
+{
+    Optional<u32> highest_sacked_sequence_number;
+    for_each_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK || data.size() % sizeof(TCPSACKBlock) != 0)
+            return;
+        auto const* blocks = reinterpret_cast<TCPSACKBlock const*>(data.data());
+        for (size_t i = 0; i < data.size() / sizeof(TCPSACKBlock); ++i) {
+            u32 left_edge = blocks[i].left_edge;
+            u32 right_edge = blocks[i].right_edge;
+            if (!highest_sacked_sequence_number.has_value() || tcp_sequence_number_before(highest_sacked_sequence_number.value(), right_edge))
+                highest_sacked_sequence_number = right_edge;
+
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.sacked)
+                    continue;
+                auto& tcp_packet = *reinterpret_cast<TCPPacket const*>(outgoing_packet.buffer->buffer->data() + outgoing_packet.ipv4_payload_offset);
+                if (tcp_sequence_number_before_or_equal(left_edge, tcp_packet.sequence_number()) && tcp_sequence_number_before_or_equal(outgoing_packet.ack_number, right_edge)) {
+                    outgoing_packet.sacked = true;
+                    outgoing_packet.lost = false;
+                    unacked_packets.sacked_size += payload_size_of(*outgoing_packet.buffer, outgoing_packet.ipv4_payload_offset);
+                }
             }
+        }
+    });
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
-        });
+    if (!highest_sacked_sequence_number.has_value() || !m_in_loss_recovery)
+        return;
+
+    // Anything below the highest selectively acknowledged segment that is still missing has been lost (RFC 6675).
+    for (auto& outgoing_packet : unacked_packets.packets) {
+        if (!tcp_sequence_number_before(outgoing_packet.ack_number, highest_sacked_sequence_number.value()))
+            break;
+        if (!outgoing_packet.sacked && outgoing_packet.tx_counter == 0)
+            outgoing_packet.lost = true;
     }
+}
 
-    m_packets_in++;
-    m_bytes_in += packet.header_size() + size;
+void TCPSocket::update_round_trip_time(Time sample)
+{
+    // RFC 6298, 2.2 and 2.3
+    auto sample_us = sample.to_microseconds();
+    if (!m_has_rtt_sample) {
+        m_smoothed_rtt = sample;
+        m_rtt_variance = Time::from_microseconds(sample_us / 2);
+        m_has_rtt_sample = true;
+    } else {
+        auto smoothed_rtt_us = m_smoothed_rtt.to_microseconds();
+        auto deviation_us = smoothed_rtt_us > sample_us ? smoothed_rtt_us - sample_us : sample_us - smoothed_rtt_us;
+        m_rtt_variance = Time::from_microseconds((3 * m_rtt_variance.to_microseconds() + deviation_us) / 4);
+        m_smoothed_rtt = Time::from_microseconds((7 * smoothed_rtt_us + sample_us) / 8);
+    }
+
+    // RFC 6298, 2.4 and 2.5: At least one second, and we may cap it at 60 seconds.
+    auto timeout_us = m_smoothed_rtt.to_microseconds() + max<i64>(4 * m_rtt_variance.to_microseconds(), 1000);
+    m_retransmission_timeout = Time::from_microseconds(clamp<i64>(timeout_us, 1'000'000, 60'000'000));
+}
+
+void TCPSocket::mark_first_packet_lost(UnackedPackets& unacked_packets)
+{
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.sacked) {
+            packet.lost = true;
+            return;
+        }
+    }
+}
+
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets, size_t max_packets)
+{
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return;
+
+    size_t retransmitted_packets = 0;
+    for (auto& packet : unacked_packets.packets) {
+        if (retransmitted_packets == max_packets)
+            break;
+        if (!packet.lost)
+            continue;
+        packet.lost = false;
+        packet.tx_counter++;
+
+        if constexpr (TCP_SOCKET_DEBUG) {
+            auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+            dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+                local_address(), local_port(),
+                peer_address(), peer_port(),
+                (tcp_packet.has_syn() ? "SYN " : ""),
+                (tcp_packet.has_ack() ? "ACK " : ""),
+                (tcp_packet.has_fin() ? "FIN " : ""),
+                (tcp_packet.has_rst() ? "RST " : ""),
+                tcp_packet.sequence_number(),
+                tcp_packet.ack_number(),
+                packet.tx_counter);
+        }
+
+        size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+        if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+            // FIXME: Add support for this. This can happen if after a route change
+            // we ended up on another adapter which doesn't have the same layer 2 type
+            // like the previous adapter.
+            VERIFY_NOT_REACHED();
+        }
+
+        auto packet_buffer = packet.buffer->bytes();
+
+        routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+            local_address(), routing_decision.next_hop, peer_address(),
+            IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+        routing_decision.adapter->send_packet(packet_buffer, packet.offload);
+        m_packets_out++;
+        m_bytes_out += packet_buffer.size();
+        m_retransmits++;
+        retransmitted_packets++;
+    }
 }
 
 bool TCPSocket::should_delay_next_ack() const
@@ -404,7 +766,7 @@ ErrorOr<void> TCPSocket::protocol_bind()
 ErrorOr<void> TCPSocket::protocol_listen(bool did_allocate_port)
 {
     if (!did_allocate_port) {
-        bool ok = sockets_by_tuple().with_exclusive([&](auto& table) -> bool {
+        bool ok = sockets_by_tuple(tuple()).with_exclusive(tuple(), [&](auto& table) -> bool {
             if (table.contains(tuple()))
                 return false;
             table.set(tuple(), this);
@@ -471,24 +833,26 @@ ErrorOr<u16> TCPSocket::protocol_allocate_local_port()
     constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<u16> {
-        for (u16 port = first_scan_port;;) {
-            IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
+    for (u16 port = first_scan_port;;) {
+        IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
 
-            auto it = table.find(proposed_tuple);
-            if (it == table.end()) {
-                set_local_port(port);
-                table.set(proposed_tuple, this);
-                return port;
-            }
-            ++port;
-            if (port > last_ephemeral_port)
-                port = first_ephemeral_port;
-            if (port == first_scan_port)
-                break;
-        }
-        return set_so_error(EADDRINUSE);
-    });
+        bool did_claim_port = sockets_by_tuple(proposed_tuple).with_exclusive(proposed_tuple, [&](auto& table) {
+            if (table.contains(proposed_tuple))
+                return false;
+            set_local_port(port);
+            table.set(proposed_tuple, this);
+            return true;
+        });
+        if (did_claim_port)
+            return port;
+
+        ++port;
+        if (port > last_ephemeral_port)
+            port = first_ephemeral_port;
+        if (port == first_scan_port)
+            break;
+    }
+    return set_so_error(EADDRINUSE);
 }
 
 bool TCPSocket::protocol_is_disconnected() const
@@ -562,11 +926,11 @@ void TCPSocket::retransmit_packets()
 
     // RFC6298 says we should have at least one second between retransmits. According to
     // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
+    auto retransmit_interval = m_retransmission_timeout;
     for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+        retransmit_interval += retransmit_interval;
 
-    if (m_last_retransmit_time > now - Time::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmit_interval)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -581,45 +945,20 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
-    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    if (routing_decision.is_zero())
-        return;
-
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return;
+
+        // Everything that is still in flight is presumed lost, and sent again as the window opens up (RFC 5681, 3.1).
+        m_congestion_control->on_retransmit_timeout(unacked_packets.bytes_in_flight());
+        m_in_loss_recovery = true;
+        m_recovery_point = m_sequence_number;
+        m_duplicate_acks_received = 0;
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
-
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
-
-            auto packet_buffer = packet.buffer->bytes();
-
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+            if (!packet.sacked)
+                packet.lost = true;
         }
+        retransmit_lost_packets(unacked_packets, 1);
     });
 }
 
@@ -631,11 +970,63 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        // NOTE: A closed window is probed with a single segment once everything has been acknowledged.
+        return unacked_packets.bytes_in_flight() < send_window() || unacked_packets.packets.is_empty();
     });
 }
+
+ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::setsockopt(level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        if (user_value_size == 0 || user_value_size > TCP_CA_NAME_MAX)
+            return EINVAL;
+        char name[TCP_CA_NAME_MAX];
+        TRY(copy_from_user(name, static_ptr_cast<char const*>(user_value), user_value_size));
+        auto algorithm = TCPCongestionControl::algorithm_from_name(StringView { name, strnlen(name, user_value_size) });
+        if (!algorithm.has_value())
+            return ENOENT;
+        // NOTE: Switching algorithms mid-connection would throw away everything we learned about the path.
+        if (m_state != State::Closed && m_state != State::Listen)
+            return EISCONN;
+        m_congestion_control = TRY(TCPCongestionControl::try_create(algorithm.value(), m_congestion_control->maximum_segment_size()));
+        return {};
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::getsockopt(description, level, option, value, value_size);
+
+    MutexLocker locker(mutex());
+
+    socklen_t size;
+    TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        auto name = TCPCongestionControl::to_string(m_congestion_control->algorithm());
+        if (size < name.length() + 1)
+            return EINVAL;
+        char buffer[TCP_CA_NAME_MAX] {};
+        VERIFY(name.length() < TCP_CA_NAME_MAX);
+        memcpy(buffer, name.characters_without_null_termination(), name.length());
+        TRY(copy_to_user(static_ptr_cast<char*>(value), buffer, name.length() + 1));
+        size = name.length() + 1;
+        return copy_to_user(value_size, &size);
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
 }
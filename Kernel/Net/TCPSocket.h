@@ -10,17 +10,22 @@
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/SinglyLinkedList.h>
+#include <Kernel/Heap/SlabCache.h>
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
 class TCPSocket final : public IPv4Socket {
+    MAKE_SLAB_ALLOCATED(TCPSocket);
+
 public:
     static void for_each(Function<void(TCPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(TCPSocket const&)>);
-    static ErrorOr<NonnullLockRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullLockRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm = TCPCongestionControl::default_algorithm);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -133,6 +138,15 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmits() const { return m_retransmits; }
+
+    TCPCongestionControl const& congestion_control() const { return *m_congestion_control; }
+    // The peer's receive window, in bytes.
+    size_t send_window_size() const { return m_send_window_size; }
+    Time smoothed_rtt() const { return m_smoothed_rtt; }
+    Time retransmission_timeout() const { return m_retransmission_timeout; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+    bool is_window_scaling_enabled() const { return m_window_scaling_enabled; }
 
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
@@ -142,10 +156,16 @@ public:
     ErrorOr<void> send_ack(bool allow_duplicate = false);
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
+    // Takes note of the options the peer sent in its SYN.
+    void process_syn_options(TCPPacket const&);
 
     bool should_delay_next_ack() const;
 
-    static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
+    // Listening sockets are keyed by their local address and port only, everything else by the full tuple.
+    using SocketTable = Kernel::SocketTable<IPv4SocketTuple, TCPSocket*, 256>;
+    static SocketTable& listening_sockets();
+    static SocketTable& connected_sockets();
+    static SocketTable& sockets_by_tuple(IPv4SocketTuple const&);
     static LockRefPtr<TCPSocket> from_tuple(IPv4SocketTuple const& tuple);
 
     static MutexProtected<HashMap<IPv4SocketTuple, LockRefPtr<TCPSocket>>>& closing_sockets();
@@ -162,13 +182,16 @@ public:
 
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
+    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
+
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -185,6 +208,21 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct UnackedPackets;
+
+    // RFC 9293, 3.7.1: Assumed when the peer didn't send an MSS option.
+    static constexpr size_t default_maximum_segment_size = 536;
+    static constexpr u8 maximum_window_scale = 14;
+
+    size_t maximum_segment_size(NetworkAdapter const&) const;
+    // The amount of data we may have in flight, limited by both the peer and the network.
+    size_t send_window() const { return min(m_send_window_size, m_congestion_control->congestion_window()); }
+    void receive_ack(TCPPacket const&, size_t payload_size, bool did_window_change);
+    void process_sack_blocks(TCPPacket const&, UnackedPackets&);
+    void update_round_trip_time(Time sample);
+    void mark_first_packet_lost(UnackedPackets&);
+    void retransmit_lost_packets(UnackedPackets&, size_t max_packets);
+
     LockWeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullLockRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -203,18 +241,45 @@ private:
         LockRefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
+        TransmitOffload offload;
         int tx_counter { 0 };
+        bool sacked { false };
+        bool lost { false };
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        // Bytes that the peer has selectively acknowledged, and which are no longer in flight.
+        size_t sacked_size { 0 };
+
+        size_t bytes_in_flight() const { return size - sacked_size; }
     };
 
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
 
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    // The oldest unacknowledged sequence number (SND.UNA).
+    u32 m_send_unacknowledged { 0 };
+    u32 m_duplicate_acks_received { 0 };
+    // Set after a loss until everything that was in flight at that point has been acknowledged.
+    bool m_in_loss_recovery { false };
+    u32 m_recovery_point { 0 };
+    u32 m_retransmits { 0 };
+
+    Optional<u16> m_peer_maximum_segment_size;
+    bool m_window_scaling_enabled { false };
+    u8 m_send_window_scale { 0 };
+    u8 m_receive_window_scale { 0 };
+    bool m_sack_permitted { false };
+
+    bool m_has_rtt_sample { false };
+    Time m_smoothed_rtt;
+    Time m_rtt_variance;
+    Time m_retransmission_timeout { Time::from_seconds(1) };
+
     u32 m_last_ack_number_sent { 0 };
     Time m_last_ack_sent_time;
 
@@ -223,8 +288,7 @@ private:
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
-    // FIXME: Parse window size TCP option from the peer
-    u32 m_send_window_size { 64 * KiB };
+    size_t m_send_window_size { 64 * KiB };
 
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
 
@@ -9,6 +9,7 @@
 #include <AK/Error.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
 
 namespace Kernel {
 
@@ -17,6 +18,7 @@ public:
     static ErrorOr<NonnullLockRefPtr<UDPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
     virtual ~UDPSocket() override;
 
+    using SocketTable = Kernel::SocketTable<u16, UDPSocket*, 64>;
     static LockRefPtr<UDPSocket> from_port(u16);
     static void for_each(Function<void(UDPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(UDPSocket const&)>);
@@ -24,7 +26,7 @@ public:
 private:
     explicit UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
     virtual StringView class_name() const override { return "UDPSocket"sv; }
-    static MutexProtected<HashMap<u16, UDPSocket*>>& sockets_by_port();
+    static SocketTable& sockets_by_port();
 
     virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
@@ -28,7 +28,7 @@ NEVER_INLINE ErrorOr<void> PerformanceEventBuffer::append(int type, FlatPtr arg1
     return append_with_ip_and_bp(current_thread->pid(), current_thread->tid(), 0, base_pointer, type, 0, arg1, arg2, arg3, arg4, arg5, arg6);
 }
 
-static Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(FlatPtr bp, FlatPtr ip)
+Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(FlatPtr bp, FlatPtr ip)
 {
     Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> backtrace;
     if (ip != 0)
@@ -97,6 +97,10 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
 
     switch (type) {
     case PERF_EVENT_SAMPLE:
+    case PERF_EVENT_CPU_CYCLES:
+    case PERF_EVENT_CACHE_MISSES:
+    case PERF_EVENT_BRANCH_MISSES:
+    case PERF_EVENT_TLB_MISSES:
         break;
     case PERF_EVENT_MALLOC:
         event.data.malloc.size = arg1;
@@ -165,6 +169,13 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
         event.data.read.start_timestamp = arg5;
         event.data.read.success = !arg6.is_error();
         break;
+    case PERF_EVENT_LOCK_CONTENTION:
+        event.data.lock_contention.lock = arg1;
+        event.data.lock_contention.wait_ns = arg5;
+        memset(event.data.lock_contention.name, 0, sizeof(event.data.lock_contention.name));
+        if (!arg3.is_empty())
+            memcpy(event.data.lock_contention.name, arg3.characters_without_null_termination(), min(arg3.length(), sizeof(event.data.lock_contention.name) - 1));
+        break;
     default:
         return EINVAL;
     }
@@ -180,6 +191,35 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     return {};
 }
 
+ErrorOr<void> PerformanceEventBuffer::append_signpost(ProcessID pid, ThreadID tid, u64 timestamp, FlatPtr string_id, FlatPtr arg, Span<FlatPtr const> stack)
+{
+    if (count() >= capacity())
+        return ENOBUFS;
+
+    if ((g_profiling_event_mask & PERF_EVENT_SIGNPOST) == 0)
+        return EINVAL;
+
+    PerformanceEvent event;
+    event.type = PERF_EVENT_SIGNPOST;
+    event.lost_samples = 0;
+    event.data.signpost.arg1 = string_id;
+    event.data.signpost.arg2 = arg;
+
+    // Frames that userspace couldn't fill in are left as zeroes.
+    event.stack_size = 0;
+    for (auto frame : stack.trim(PerformanceEvent::max_stack_frame_count)) {
+        if (frame == 0)
+            break;
+        event.stack[event.stack_size++] = frame;
+    }
+
+    event.pid = pid.value();
+    event.tid = tid.value();
+    event.timestamp = timestamp;
+    at(m_count++) = event;
+    return {};
+}
+
 PerformanceEvent& PerformanceEventBuffer::at(size_t index)
 {
     VERIFY(index < capacity());
@@ -223,6 +263,23 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
         case PERF_EVENT_SAMPLE:
             TRY(event_object.add("type"sv, "sample"));
             break;
+        // Samples taken by the hardware performance counters, which tell what they were counting.
+        case PERF_EVENT_CPU_CYCLES:
+            TRY(event_object.add("type"sv, "sample"));
+            TRY(event_object.add("counter"sv, "cpu_cycles"));
+            break;
+        case PERF_EVENT_CACHE_MISSES:
+            TRY(event_object.add("type"sv, "sample"));
+            TRY(event_object.add("counter"sv, "cache_misses"));
+            break;
+        case PERF_EVENT_BRANCH_MISSES:
+            TRY(event_object.add("type"sv, "sample"));
+            TRY(event_object.add("counter"sv, "branch_misses"));
+            break;
+        case PERF_EVENT_TLB_MISSES:
+            TRY(event_object.add("type"sv, "sample"));
+            TRY(event_object.add("counter"sv, "tlb_misses"));
+            break;
         case PERF_EVENT_MALLOC:
             TRY(event_object.add("type"sv, "malloc"));
             TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.malloc.ptr)));
@@ -296,6 +353,12 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             TRY(event_object.add("start_timestamp"sv, event.data.read.start_timestamp));
             TRY(event_object.add("success"sv, event.data.read.success));
             break;
+        case PERF_EVENT_LOCK_CONTENTION:
+            TRY(event_object.add("type"sv, "lock_contention"));
+            TRY(event_object.add("lock"sv, static_cast<u64>(event.data.lock_contention.lock)));
+            TRY(event_object.add("wait_ns"sv, event.data.lock_contention.wait_ns));
+            TRY(event_object.add("name"sv, event.data.lock_contention.name));
+            break;
         }
         TRY(event_object.add("pid"sv, event.pid));
         TRY(event_object.add("tid"sv, event.tid));
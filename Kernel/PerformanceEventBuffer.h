@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Error.h>
+#include <AK/Vector.h>
 #include <Kernel/KBuffer.h>
 
 namespace Kernel {
@@ -76,6 +77,12 @@ struct [[gnu::packed]] ReadPerformanceEvent {
     bool success;
 };
 
+struct [[gnu::packed]] LockContentionPerformanceEvent {
+    FlatPtr lock;
+    u64 wait_ns;
+    char name[48];
+};
+
 struct [[gnu::packed]] PerformanceEvent {
     u32 type { 0 };
     u8 stack_size { 0 };
@@ -96,11 +103,15 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         ReadPerformanceEvent read;
+        LockContentionPerformanceEvent lock_contention;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
 };
 
+// Walks the stack from the given frame, kernel frames first, followed by the userspace ones.
+Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(FlatPtr bp, FlatPtr ip);
+
 enum class ProcessEventType {
     Create,
     Exec
@@ -115,6 +126,8 @@ public:
         int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FlatPtr arg4 = 0, u64 arg5 = {}, ErrorOr<FlatPtr> arg6 = 0);
     ErrorOr<void> append_with_ip_and_bp(ProcessID pid, ThreadID tid, RegisterState const& regs,
         int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FlatPtr arg4 = 0, u64 arg5 = {}, ErrorOr<FlatPtr> arg6 = 0);
+    // Appends a signpost that userspace recorded itself, with its own timestamp and stack.
+    ErrorOr<void> append_signpost(ProcessID pid, ThreadID tid, u64 timestamp, FlatPtr string_id, FlatPtr arg, Span<FlatPtr const> stack);
 
     void clear()
     {
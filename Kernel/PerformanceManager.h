@@ -66,6 +66,16 @@ public:
         }
     }
 
+    inline static void add_hardware_counter_sample_event(Thread& current_thread, RegisterState const& regs, int type)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append_with_ip_and_bp(
+                current_thread.pid(), current_thread.tid(), regs, type, 0, 0, 0, {});
+        }
+    }
+
     inline static void add_mmap_perf_event(Process& current_process, Memory::Region const& region)
     {
         if (auto* event_buffer = current_process.current_perf_events_buffer()) {
@@ -161,6 +171,20 @@ public:
         [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_READ, fd, size, {}, &thread, filepath_string_index, start_timestamp, result); // wrong arguments
     }
 
+    inline static bool is_recording_lock_contention(Thread& thread)
+    {
+        return (g_profiling_event_mask & PERF_EVENT_LOCK_CONTENTION) != 0 && thread.process().current_perf_events_buffer();
+    }
+
+    inline static void add_lock_contention_event(Thread& thread, Mutex const& lock, Time wait_time)
+    {
+        if (thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_LOCK_CONTENTION, FlatPtr(&lock), 0, lock.name(), &thread, 0, max<i64>(wait_time.to_nanoseconds(), 0));
+        }
+    }
+
     inline static void timer_tick(RegisterState const& regs)
     {
         static Time last_wakeup;
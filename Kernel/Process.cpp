@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/InterruptDisabler.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/Credentials.h>
 #include <Kernel/Debug.h>
@@ -642,6 +643,10 @@ void Process::finalize()
             if (result.is_error())
                 dmesgln("Failed to write perfcore for pid {}: {}", pid(), result.error());
             TimeManagement::the().disable_profile_timer();
+            if (m_profiling_hardware_counters) {
+                PerformanceCounters::disable();
+                m_profiling_hardware_counters = false;
+            }
         }
     }
 
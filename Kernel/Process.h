@@ -200,6 +200,8 @@ public:
 
     bool is_profiling() const { return m_profiling; }
     void set_profiling(bool profiling) { m_profiling = profiling; }
+    bool is_profiling_hardware_counters() const { return m_profiling_hardware_counters; }
+    void set_profiling_hardware_counters(bool profiling_hardware_counters) { m_profiling_hardware_counters = profiling_hardware_counters; }
 
     bool should_generate_coredump() const { return m_should_generate_coredump; }
     void set_should_generate_coredump(bool b) { m_should_generate_coredump = b; }
@@ -335,7 +337,14 @@ public:
     ErrorOr<FlatPtr> sys$msync(Userspace<void*>, size_t, int flags);
     ErrorOr<FlatPtr> sys$purge(int mode);
     ErrorOr<FlatPtr> sys$poll(Userspace<Syscall::SC_poll_params const*>);
+    ErrorOr<FlatPtr> sys$epoll_create(int flags);
+    ErrorOr<FlatPtr> sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*>);
+    ErrorOr<FlatPtr> sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*>);
+    ErrorOr<FlatPtr> sys$io_ring_create(u32 entries, int flags);
+    ErrorOr<FlatPtr> sys$io_ring_enter(int fd, u32 min_complete);
+    ErrorOr<FlatPtr> sys$sendfile(Userspace<Syscall::SC_sendfile_params const*>);
     ErrorOr<FlatPtr> sys$get_dir_entries(int fd, Userspace<void*>, size_t);
+    ErrorOr<FlatPtr> sys$get_dir_entries_with_metadata(int fd, Userspace<void*>, size_t);
     ErrorOr<FlatPtr> sys$getcwd(Userspace<char*>, size_t);
     ErrorOr<FlatPtr> sys$chdir(Userspace<char const*>, size_t);
     ErrorOr<FlatPtr> sys$fchdir(int fd);
@@ -424,6 +433,7 @@ public:
     ErrorOr<FlatPtr> sys$unveil(Userspace<Syscall::SC_unveil_params const*>);
     ErrorOr<FlatPtr> sys$perf_event(int type, FlatPtr arg1, FlatPtr arg2);
     ErrorOr<FlatPtr> sys$perf_register_string(Userspace<char const*>, size_t);
+    ErrorOr<FlatPtr> sys$perf_signposts(Userspace<perf_signpost const*>, size_t);
     ErrorOr<FlatPtr> sys$get_stack_bounds(Userspace<FlatPtr*> stack_base, Userspace<size_t*> stack_size);
     ErrorOr<FlatPtr> sys$ptrace(Userspace<Syscall::SC_ptrace_params const*>);
     ErrorOr<FlatPtr> sys$sendfd(int sockfd, int fd);
@@ -847,6 +857,7 @@ private:
     bool const m_is_kernel_process;
     Atomic<State> m_state { State::Running };
     bool m_profiling { false };
+    bool m_profiling_hardware_counters { false };
     Atomic<bool, AK::MemoryOrder::memory_order_relaxed> m_is_stopped { false };
     bool m_should_generate_coredump { false };
 
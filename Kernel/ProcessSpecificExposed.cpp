@@ -286,8 +286,11 @@ ErrorOr<void> Process::procfs_get_virtual_memory_stats(KBufferBuilder& builder)
             TRY(region_object.add("cacheable"sv, region.is_cacheable()));
             TRY(region_object.add("address"sv, region.vaddr().get()));
             TRY(region_object.add("size"sv, region.size()));
-            TRY(region_object.add("amount_resident"sv, region.amount_resident()));
+            auto page_usage = region.page_usage();
+            TRY(region_object.add("amount_resident"sv, page_usage.resident));
             TRY(region_object.add("amount_dirty"sv, region.amount_dirty()));
+            TRY(region_object.add("amount_unique"sv, page_usage.unique));
+            TRY(region_object.add("amount_proportional"sv, page_usage.proportional));
             TRY(region_object.add("cow_pages"sv, region.cow_pages()));
             TRY(region_object.add("name"sv, region.name()));
             TRY(region_object.add("vmobject"sv, region.vmobject().class_name()));
@@ -10,6 +10,7 @@
 #include <AK/Time.h>
 #include <Kernel/Arch/InterruptDisabler.h>
 #include <Kernel/Arch/x86/TrapFrame.h>
+#include <Kernel/ContinuousProfiler.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceManager.h>
@@ -47,9 +48,36 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues>> g_ready_queues;
+// Every processor owns a set of ready queues with the same priority bucket layout.
+// Threads are placed on the queues of a processor they have affinity for, and
+// processors that run out of work steal from their peers. The runnable count is
+// kept outside of the lock so that other processors can skip empty queues without
+// touching the spinlock.
+struct ProcessorReadyQueues {
+    SpinlockProtected<ThreadReadyQueues> queues { LockRank::None };
+    Atomic<u32> runnable_count { 0 };
+
+    Thread* take_runnable_thread(u32 affinity_mask);
+    Thread* peek_runnable_thread(u32 affinity_mask);
+    void enqueue(Thread&, u32 priority, u32 cpu);
+    bool dequeue(Thread&);
+
+private:
+    static Thread* find_runnable_thread(ThreadReadyQueues&, u32 affinity_mask);
+    void remove(ThreadReadyQueues&, Thread&);
+};
+
+// Thread affinity is a u32 bitmask, so there can't be more processors than that.
+static constexpr size_t max_processor_count = sizeof(u32) * 8;
 
-static SpinlockProtected<TotalTimeScheduled> g_total_time_scheduled { LockRank::None };
+static Singleton<Array<ProcessorReadyQueues, max_processor_count>> s_ready_queues;
+
+// Every processor only adds to its own totals, so that accounting for a context switch doesn't contend with the others.
+struct alignas(64) ProcessorTimeScheduled {
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> total { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> total_kernel { 0 };
+};
+static Array<ProcessorTimeScheduled, max_processor_count> s_time_scheduled;
 
 // The Scheduler::current_time function provides a current time for scheduling purposes,
 // which may not necessarily relate to wall time
@@ -60,7 +88,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -69,117 +97,187 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+Thread* ProcessorReadyQueues::find_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            return &thread;
         }
-        return *Processor::idle_thread();
-    });
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+void ProcessorReadyQueues::remove(ThreadReadyQueues& ready_queues, Thread& thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+    auto priority = thread.m_runnable_priority;
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    runnable_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
+Thread* ProcessorReadyQueues::take_runnable_thread(u32 affinity_mask)
+{
+    if (runnable_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
         return nullptr;
+
+    return queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+        if (!thread)
+            return nullptr;
+        remove(ready_queues, *thread);
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return thread;
     });
 }
 
-bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+Thread* ProcessorReadyQueues::peek_runnable_thread(u32 affinity_mask)
 {
-    if (thread.is_idle_thread())
-        return true;
-
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
-            return false;
-        }
-
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+    if (runnable_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+        return nullptr;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
+    return queues.with([&](auto& ready_queues) {
+        return find_runnable_thread(ready_queues, affinity_mask);
     });
 }
 
-void Scheduler::enqueue_runnable_thread(Thread& thread)
+void ProcessorReadyQueues::enqueue(Thread& thread, u32 priority, u32 cpu)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
-    if (thread.is_idle_thread())
-        return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
-
-    g_ready_queues->with([&](auto& ready_queues) {
+    queues.with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_ready_queue_cpu = cpu;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        runnable_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     });
 }
 
+bool ProcessorReadyQueues::dequeue(Thread& thread)
+{
+    return queues.with([&](auto& ready_queues) {
+        if (thread.m_runnable_priority < 0)
+            return false;
+        remove(ready_queues, thread);
+        return true;
+    });
+}
+
+static u32 processor_for_runnable_thread(Thread const& thread)
+{
+    auto affinity = thread.affinity();
+    // Prefer the processor the thread last ran on, as its caches are most likely still warm.
+    auto last_cpu = thread.cpu();
+    if (affinity & (1u << last_cpu))
+        return last_cpu;
+    auto current_cpu = Processor::current_id();
+    if (affinity & (1u << current_cpu))
+        return current_cpu;
+    auto processor_count = Processor::count();
+    for (u32 cpu = 0; cpu < processor_count; cpu++) {
+        if (affinity & (1u << cpu))
+            return cpu;
+    }
+    // The affinity doesn't include any processor that is online, just keep it on ours
+    // so that it isn't lost. It will never be picked, just like before.
+    return current_cpu;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+    auto& ready_queues = *s_ready_queues;
+
+    if (auto* thread = ready_queues[current_id].take_runnable_thread(affinity_mask))
+        return *thread;
+
+    // Our own queues are empty, try to steal a thread from one of the other processors.
+    auto processor_count = Processor::count();
+    for (u32 i = 1; i < processor_count; i++) {
+        auto victim_id = (current_id + i) % processor_count;
+        if (auto* thread = ready_queues[victim_id].take_runnable_thread(affinity_mask)) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_id, *thread, victim_id);
+            return *thread;
+        }
+    }
+
+    return *Processor::idle_thread();
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+    auto& ready_queues = *s_ready_queues;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled, either on our own queues or on ones we could steal from.
+    auto processor_count = Processor::count();
+    for (u32 i = 0; i < processor_count; i++) {
+        if (auto* thread = ready_queues[(current_id + i) % processor_count].peek_runnable_thread(affinity_mask))
+            return thread;
+    }
+    return nullptr;
+}
+
+bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+{
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    if (thread.is_idle_thread())
+        return true;
+
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
+
+    // A thread can only move between ready queues while the scheduler lock is held,
+    // so m_ready_queue_cpu is stable here.
+    return (*s_ready_queues)[thread.m_ready_queue_cpu].dequeue(thread);
+}
+
+void Scheduler::enqueue_runnable_thread(Thread& thread)
+{
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    if (thread.is_idle_thread())
+        return;
+    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = processor_for_runnable_thread(thread);
+    (*s_ready_queues)[cpu].enqueue(thread, priority, cpu);
+}
+
 UNMAP_AFTER_INIT void Scheduler::start()
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -219,6 +317,12 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
+    // An idle processor checks for work every time it wakes up. If there is nothing it could
+    // run, it stays on its idle thread, and that doesn't need the global lock: nobody else
+    // changes the state of an idle thread, and the ready queue counts can be read locklessly.
+    if (Thread::current()->is_idle_thread() && !peek_next_runnable_thread())
+        return;
+
     SpinlockLocker lock(g_scheduler_lock);
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
@@ -428,11 +532,10 @@ UNMAP_AFTER_INIT Thread* Scheduler::create_ap_idle_thread(u32 cpu)
 
 void Scheduler::add_time_scheduled(u64 time_to_add, bool is_kernel)
 {
-    g_total_time_scheduled.with([&](auto& total_time_scheduled) {
-        total_time_scheduled.total += time_to_add;
-        if (is_kernel)
-            total_time_scheduled.total_kernel += time_to_add;
-    });
+    auto& time_scheduled = s_time_scheduled[Processor::current_id()];
+    time_scheduled.total += time_to_add;
+    if (is_kernel)
+        time_scheduled.total_kernel += time_to_add;
 }
 
 void Scheduler::timer_tick(RegisterState const& regs)
@@ -463,6 +566,8 @@ void Scheduler::timer_tick(RegisterState const& regs)
         return;
     }
 
+    ContinuousProfiler::timer_tick(regs);
+
     if (current_thread->tick())
         return;
 
@@ -528,7 +633,14 @@ bool Scheduler::is_initialized()
 
 TotalTimeScheduled Scheduler::get_total_time_scheduled()
 {
-    return g_total_time_scheduled.with([&](auto& total_time_scheduled) { return total_time_scheduled; });
+    TotalTimeScheduled total_time_scheduled;
+    for (auto& time_scheduled : s_time_scheduled) {
+        // Note: The kernel time is added last, so reading it first keeps it from exceeding the total.
+        auto total_kernel = time_scheduled.total_kernel.load();
+        total_time_scheduled.total += time_scheduled.total.load();
+        total_time_scheduled.total_kernel += total_kernel;
+    }
+    return total_time_scheduled;
 }
 
 void dump_thread_list(bool with_stack_traces)
@@ -66,9 +66,49 @@ bool AHCIController::reset()
         m_ports[index] = port;
         port->reset();
     }
+
+    if (kernel_command_line().is_ahci_coalescing_enabled()) {
+        if (m_hba_capabilities.command_completion_coalescing_supported)
+            enable_command_completion_coalescing();
+        else
+            dmesgln("{}: AHCI controller doesn't support command completion coalescing", pci_address());
+    }
     return true;
 }
 
+void AHCIController::enable_command_completion_coalescing()
+{
+    // Note: Coalescing only pays off on ports that can have more than one command in flight.
+    u32 coalesced_ports = 0;
+    for (auto const& port : m_ports) {
+        if (port && port->connected_device() && port->queue_depth() > 1)
+            coalesced_ports |= 1u << port->port_index();
+    }
+    if (coalesced_ports == 0)
+        return;
+
+    SpinlockLocker locker(m_hba_control_lock);
+    // Note: The HBA only takes a new configuration while coalescing is disabled.
+    hba().control_regs.ccc_ctl = 0;
+    full_memory_barrier();
+    hba().control_regs.ccc_ports = coalesced_ports;
+    // Raise an interrupt once 8 commands completed, or 1 millisecond after the first one completed.
+    hba().control_regs.ccc_ctl = (1 << 16) | (8 << 8);
+    full_memory_barrier();
+    m_command_completion_coalescing_interrupt = (hba().control_regs.ccc_ctl >> 3) & 0b11111;
+    m_coalesced_ports = coalesced_ports;
+
+    // Note: Completions on the coalesced ports are picked up when the coalescing interrupt fires,
+    // so they shouldn't raise interrupts of their own.
+    for (auto& port : m_ports) {
+        if (port && (coalesced_ports & (1u << port->port_index())))
+            port->disable_command_completion_interrupts();
+    }
+
+    hba().control_regs.ccc_ctl = hba().control_regs.ccc_ctl | 1;
+    dmesgln("{}: AHCI command completion coalescing enabled for ports {:#08x}", pci_address(), coalesced_ports);
+}
+
 bool AHCIController::shutdown()
 {
     TODO();
@@ -92,6 +132,20 @@ void AHCIController::start_request(ATADevice const& device, AsyncBlockDeviceRequ
     port->start_request(request);
 }
 
+size_t AHCIController::max_transfer_size(ATADevice const& device) const
+{
+    auto port = m_ports[device.ata_address().port];
+    VERIFY(port);
+    return port->max_transfer_size();
+}
+
+size_t AHCIController::max_requests_in_flight(ATADevice const& device) const
+{
+    auto port = m_ports[device.ata_address().port];
+    VERIFY(port);
+    return port->queue_depth();
+}
+
 void AHCIController::complete_current_request(AsyncDeviceRequest::RequestResult)
 {
     VERIFY_NOT_REACHED();
@@ -178,6 +232,13 @@ UNMAP_AFTER_INIT void AHCIController::initialize_hba(PCI::DeviceIdentifier const
 
 void AHCIController::handle_interrupt_for_port(Badge<AHCIInterruptHandler>, u32 port_index) const
 {
+    if (m_coalesced_ports != 0 && port_index == m_command_completion_coalescing_interrupt) {
+        for (auto port : m_ports) {
+            if (port && (m_coalesced_ports & (1u << port->port_index())))
+                port->complete_finished_commands();
+        }
+        return;
+    }
     auto port = m_ports[port_index];
     VERIFY(port);
     port->handle_interrupt();
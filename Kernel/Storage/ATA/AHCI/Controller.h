@@ -32,6 +32,8 @@ public:
     virtual bool shutdown() override;
     virtual size_t devices_count() const override;
     virtual void start_request(ATADevice const&, AsyncBlockDeviceRequest&) override;
+    virtual size_t max_transfer_size(ATADevice const&) const override;
+    virtual size_t max_requests_in_flight(ATADevice const&) const override;
     virtual void complete_current_request(AsyncDeviceRequest::RequestResult) override;
 
     void handle_interrupt_for_port(Badge<AHCIInterruptHandler>, u32 port_index) const;
@@ -44,6 +46,7 @@ private:
     void initialize_hba(PCI::DeviceIdentifier const&);
 
     AHCI::HBADefinedCapabilities capabilities() const;
+    void enable_command_completion_coalescing();
     LockRefPtr<StorageDevice> device_by_port(u32 index) const;
 
     volatile AHCI::PortRegisters& port(size_t port_number) const;
@@ -54,6 +57,11 @@ private:
     NonnullOwnPtr<Memory::Region> m_hba_region;
     AHCI::HBADefinedCapabilities m_hba_capabilities;
 
+    // Note: When command completion coalescing is enabled, the HBA signals the completions on
+    // these ports by setting this bit in the interrupt status register, which no port uses.
+    u32 m_coalesced_ports { 0 };
+    u8 m_command_completion_coalescing_interrupt { 0 };
+
     // FIXME: There could be multiple IRQ (MSI) handlers for AHCI. Find a way to use all of them.
     OwnPtr<AHCIInterruptHandler> m_irq_handler;
 
@@ -321,6 +321,7 @@ public:
     u32 raw_value() const { return m_bitfield; }
     bool is_set(PortInterruptFlag flag) const { return m_bitfield & (u32)flag; }
     void clear() { m_bitfield = 0xffffffff; }
+    void clear(u32 flags) { m_bitfield = flags; }
 
     // Disable default implementations that would use surprising integer promotion.
     bool operator==(MaskedBitField const&) const = delete;
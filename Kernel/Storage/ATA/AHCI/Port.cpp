@@ -8,6 +8,7 @@
 // please look at Documentation/Kernel/AHCILocking.md
 
 #include <AK/Atomic.h>
+#include <AK/ScopeGuard.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/ScatterGatherList.h>
@@ -37,14 +38,9 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
 
     m_fis_receive_page = TRY(MM.allocate_physical_page());
 
-    for (size_t index = 0; index < 1; index++) {
-        auto dma_page = TRY(MM.allocate_physical_page());
-        m_dma_buffers.append(move(dma_page));
-    }
-    for (size_t index = 0; index < 1; index++) {
-        auto command_table_page = TRY(MM.allocate_physical_page());
-        m_command_table_pages.append(move(command_table_page));
-    }
+    // Note: The DMA buffers are only allocated once we know how many commands the device can queue.
+    auto command_tables_size = TRY(Memory::page_round_up(m_hba_capabilities.max_command_list_entries_count * command_table_size));
+    m_command_tables_region = TRY(MM.allocate_dma_buffer_pages(command_tables_size, "AHCI Port Command Tables"sv, Memory::Region::Access::ReadWrite, m_command_table_pages));
 
     m_command_list_region = TRY(MM.allocate_dma_buffer_page("AHCI Port Command List"sv, Memory::Region::Access::ReadWrite, m_command_list_page));
 
@@ -54,6 +50,25 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
     return {};
 }
 
+ErrorOr<void> AHCIPort::allocate_dma_buffers(size_t command_slots_count)
+{
+    auto pages_count = command_slots_count * dma_pages_per_command;
+    TRY(m_dma_buffers.try_ensure_capacity(pages_count));
+    while (m_dma_buffers.size() < pages_count)
+        m_dma_buffers.unchecked_append(TRY(MM.allocate_physical_page()));
+    return {};
+}
+
+volatile AHCI::CommandTable& AHCIPort::command_table(u8 command_slot) const
+{
+    return *(volatile AHCI::CommandTable*)m_command_tables_region->vaddr().offset(command_slot * command_table_size).as_ptr();
+}
+
+PhysicalAddress AHCIPort::command_table_address(u8 command_slot) const
+{
+    return m_command_table_pages.first().paddr().offset(command_slot * command_table_size);
+}
+
 UNMAP_AFTER_INIT AHCIPort::AHCIPort(AHCIController const& controller, NonnullRefPtr<Memory::PhysicalPage> identify_buffer_page, AHCI::HBADefinedCapabilities hba_capabilities, volatile AHCI::PortRegisters& registers, u32 port_index)
     : m_port_index(port_index)
     , m_hba_capabilities(hba_capabilities)
@@ -73,8 +88,9 @@ void AHCIPort::clear_sata_error_register() const
 
 void AHCIPort::handle_interrupt()
 {
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Interrupt handled, PxIS {}", representative_port_index(), m_interrupt_status.raw_value());
-    if (m_interrupt_status.raw_value() == 0) {
+    auto interrupt_status = m_interrupt_status.raw_value();
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Interrupt handled, PxIS {}", representative_port_index(), interrupt_status);
+    if (interrupt_status == 0) {
         return;
     }
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::PRC) && m_interrupt_status.is_set(AHCI::PortInterruptFlag::PC)) {
@@ -85,20 +101,14 @@ void AHCIPort::handle_interrupt()
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 m_connected_device.clear();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                fail_requests_in_slots(NumericLimits<u32>::max());
         } else {
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 reset();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                fail_requests_in_slots(NumericLimits<u32>::max());
         }
         return;
     }
@@ -111,64 +121,69 @@ void AHCIPort::handle_interrupt()
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             reset();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            fail_requests_in_slots(NumericLimits<u32>::max());
         return;
     }
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::IF) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::TFE) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBD) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBF)) {
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             recover_from_fatal_error();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            fail_requests_in_slots(NumericLimits<u32>::max());
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
-        m_wait_for_completion = false;
 
-        // Now schedule reading/writing the buffer as soon as we leave the irq handler.
-        // This is important so that we can safely access the buffers, which could
-        // trigger page faults
-        if (!m_current_request) {
-            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
-        } else {
-            auto work_item_creation_result = g_io_work->try_queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                MutexLocker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (!m_connected_device) {
-                    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                    complete_current_request(AsyncDeviceRequest::Failure);
-                    return;
-                }
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (auto result = m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count()); result.is_error()) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
-            });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+    // Note: Only clear the bits we have seen, so that a command completing right now still raises another interrupt.
+    m_interrupt_status.clear(interrupt_status);
+
+    // Note: Queued commands complete with a Set Device Bits FIS, everything else with a Device to Host Register FIS.
+    if (interrupt_status & (AHCI::PortInterruptFlag::DHR | AHCI::PortInterruptFlag::PS | AHCI::PortInterruptFlag::SDB))
+        complete_finished_commands();
+}
+
+void AHCIPort::complete_finished_commands()
+{
+    {
+        SpinlockLocker lock(m_hard_lock);
+        u32 finished_command_slots = m_issued_command_slots & ~(m_port_registers.sact | m_port_registers.ci);
+        if (finished_command_slots == 0) {
+            dbgln_if(AHCI_DEBUG, "AHCI Port {}: No request finished, probably identify request", representative_port_index());
+            return;
         }
+        m_issued_command_slots &= ~finished_command_slots;
+        m_finished_command_slots |= finished_command_slots;
     }
 
-    m_interrupt_status.clear();
+    // Now schedule reading/writing the buffer as soon as we leave the irq handler.
+    // This is important so that we can safely access the buffers, which could
+    // trigger page faults
+    auto work_item_creation_result = g_io_work->try_queue([this]() {
+        MutexLocker locker(m_lock);
+        u32 finished_command_slots = 0;
+        {
+            SpinlockLocker lock(m_hard_lock);
+            swap(finished_command_slots, m_finished_command_slots);
+        }
+        for (u8 command_slot = 0; command_slot < AHCI::Limits::MaxCommands; command_slot++) {
+            if (finished_command_slots & (1u << command_slot))
+                finish_request_in_slot(command_slot);
+        }
+    });
+    if (work_item_creation_result.is_error()) {
+        u32 finished_command_slots = 0;
+        {
+            SpinlockLocker lock(m_hard_lock);
+            swap(finished_command_slots, m_finished_command_slots);
+        }
+        fail_requests_in_slots(finished_command_slots);
+    }
+}
+
+void AHCIPort::disable_command_completion_interrupts()
+{
+    SpinlockLocker lock(m_hard_lock);
+    m_port_registers.ie = m_port_registers.ie & ~(u32)(AHCI::PortInterruptFlag::DHR | AHCI::PortInterruptFlag::PS | AHCI::PortInterruptFlag::DS | AHCI::PortInterruptFlag::SDB);
 }
 
 bool AHCIPort::is_interrupts_enabled() const
@@ -178,8 +193,14 @@ bool AHCIPort::is_interrupts_enabled() const
 
 void AHCIPort::recover_from_fatal_error()
 {
+    // Note: Nothing that was in flight is going to complete anymore, so fail it once we let go of the locks,
+    // since completing a request might start the next one.
+    u32 lost_command_slots = 0;
+    ScopeGuard fail_lost_requests = [&] { fail_requests_in_slots(lost_command_slots); };
+
     MutexLocker locker(m_lock);
     SpinlockLocker lock(m_hard_lock);
+    lost_command_slots = m_busy_command_slots;
     LockRefPtr<AHCIController> controller = m_parent_controller.strong_ref();
     if (!controller) {
         dmesgln("AHCI Port {}: fatal error, controller not available", representative_port_index());
@@ -209,7 +230,7 @@ void AHCIPort::eject()
     auto unused_command_header = try_to_find_unused_command_header();
     VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
+    command_list_entries[unused_command_header.value()].ctba = command_table_address(unused_command_header.value()).get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
     command_list_entries[unused_command_header.value()].prdbc = 0;
     command_list_entries[unused_command_header.value()].prdtl = 0;
@@ -220,8 +241,7 @@ void AHCIPort::eject()
     // handshake error bit in PxSERR register if CFL is incorrect.
     command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | AHCI::CommandHeaderAttributes::C | AHCI::CommandHeaderAttributes::A;
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::Region::Cacheable::No).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = this->command_table(unused_command_header.value());
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
     auto& fis = *(volatile FIS::HostToDevice::Register*)command_table.command_fis;
     fis.header.fis_type = (u8)FIS::Type::RegisterHostToDevice;
@@ -268,8 +288,13 @@ void AHCIPort::eject()
 
 bool AHCIPort::reset()
 {
+    // Note: Whatever the port was working on is lost when it resets.
+    u32 lost_command_slots = 0;
+    ScopeGuard fail_lost_requests = [&] { fail_requests_in_slots(lost_command_slots); };
+
     MutexLocker locker(m_lock);
     SpinlockLocker lock(m_hard_lock);
+    lost_command_slots = m_busy_command_slots;
 
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Resetting", representative_port_index());
 
@@ -351,7 +376,21 @@ bool AHCIPort::initialize()
             m_port_registers.cmd = m_port_registers.cmd | (1 << 24);
         }
 
-        dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
+        // Note: Word 76 reads as all ones on devices that aren't Serial ATA devices.
+        m_native_command_queuing_enabled = m_hba_capabilities.native_command_queuing_supported
+            && !is_atapi_attached()
+            && identify_block->serial_ata_capabilities != 0xffff
+            && (identify_block->serial_ata_capabilities & (1 << 8));
+        m_queue_depth = 1;
+        if (m_native_command_queuing_enabled)
+            m_queue_depth = min<size_t>((identify_block->queue_depth & 0b11111) + 1, m_hba_capabilities.max_command_list_entries_count);
+
+        dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}, Queue depth={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size, m_queue_depth);
+
+        if (auto result = allocate_dma_buffers(m_queue_depth); result.is_error()) {
+            dmesgln("AHCI Port {}: Could not allocate DMA buffers: {}", representative_port_index(), result.error());
+            return false;
+        }
 
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
         if (!is_atapi_attached()) {
@@ -487,28 +526,29 @@ size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
     size_t needed_dma_regions_count = Memory::page_round_up((block_count * m_connected_device->block_size())).value() / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    VERIFY(needed_dma_regions_count <= dma_pages_per_command);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(u8 command_slot, AsyncBlockDeviceRequest& request)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(request.block_count() > 0);
 
-    NonnullRefPtrVector<Memory::PhysicalPage> allocated_dma_regions;
-    for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
-    }
-
-    m_current_scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
-    if (!m_current_scatter_list)
+    auto dma_pages = m_dma_buffers.span().slice(command_slot * dma_pages_per_command, calculate_descriptors_count(request.block_count()));
+    auto scatter_list = Memory::ScatterGatherList::try_create(request, dma_pages, m_connected_device->block_size());
+    if (!scatter_list)
         return AsyncDeviceRequest::Failure;
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (auto result = request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
+        if (auto result = request.read_from_buffer(request.buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
+
+    // Note: The slot might still hold the scatter list of a request that failed before it was finished,
+    // which then gets freed when we return, outside the spinlock.
+    SpinlockLocker lock(m_hard_lock);
+    swap(m_command_slots[command_slot].scatter_list, scatter_list);
     return {};
 }
 
@@ -516,34 +556,108 @@ void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     MutexLocker locker(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    Optional<u8> command_slot;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        command_slot = try_to_find_unused_command_header();
+        if (command_slot.has_value()) {
+            m_busy_command_slots |= 1u << command_slot.value();
+            m_command_slots[command_slot.value()].request = request;
+        }
+    }
+    if (!command_slot.has_value() || !m_connected_device) {
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, no command slot or device available.", representative_port_index());
+        locker.unlock();
+        if (command_slot.has_value())
+            complete_request_in_slot(command_slot.value(), request, AsyncDeviceRequest::Failure);
+        else
+            request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
 
-    auto result = prepare_and_set_scatter_list(request);
+    auto result = prepare_and_set_scatter_list(command_slot.value(), request);
     if (result.has_value()) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(result.value());
+        complete_request_in_slot(command_slot.value(), request, result.value());
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto success = access_device(command_slot.value(), request.request_type(), request.block_index(), request.block_count());
     if (!success) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        complete_request_in_slot(command_slot.value(), request, AsyncDeviceRequest::Failure);
+        return;
+    }
+}
+
+void AHCIPort::finish_request_in_slot(u8 command_slot)
+{
+    VERIFY(m_lock.is_locked());
+    LockRefPtr<AsyncBlockDeviceRequest> request;
+    LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        request = m_command_slots[command_slot].request;
+        scatter_list = m_command_slots[command_slot].scatter_list;
+    }
+    // Note: The request may have failed in the meantime, e.g. because the port was reset.
+    if (!request)
+        return;
+    VERIFY(scatter_list);
+
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
+    if (!m_connected_device) {
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, device is gone.", representative_port_index());
+        complete_request_in_slot(command_slot, *request, AsyncDeviceRequest::Failure);
         return;
     }
+    if (request->request_type() == AsyncBlockDeviceRequest::Read) {
+        if (auto result = request->write_to_buffer(request->buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request->block_count()); result.is_error()) {
+            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+            complete_request_in_slot(command_slot, *request, AsyncDeviceRequest::MemoryFault);
+            return;
+        }
+    }
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
+    complete_request_in_slot(command_slot, *request, AsyncDeviceRequest::Success);
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_request_in_slot(u8 command_slot, AsyncBlockDeviceRequest& request, AsyncDeviceRequest::RequestResult result)
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        // Note: If the request failed in the meantime, the slot might already belong to the next one.
+        if (m_command_slots[command_slot].request.ptr() != &request)
+            return;
+        m_command_slots[command_slot].request.clear();
+        swap(scatter_list, m_command_slots[command_slot].scatter_list);
+        m_busy_command_slots &= ~(1u << command_slot);
+    }
+    request.complete(result);
+}
+
+void AHCIPort::fail_requests_in_slots(u32 command_slots)
+{
+    Array<LockRefPtr<AsyncBlockDeviceRequest>, AHCI::Limits::MaxCommands> failed_requests;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        command_slots &= m_busy_command_slots;
+        for (u8 command_slot = 0; command_slot < AHCI::Limits::MaxCommands; command_slot++) {
+            if (command_slots & (1u << command_slot))
+                swap(failed_requests[command_slot], m_command_slots[command_slot].request);
+        }
+        m_busy_command_slots &= ~command_slots;
+        m_issued_command_slots &= ~command_slots;
+        m_finished_command_slots &= ~command_slots;
+    }
+    for (auto& request : failed_requests) {
+        if (request)
+            request->complete(AsyncDeviceRequest::Failure);
+    }
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -562,44 +676,43 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 command_slot, AsyncBlockDeviceRequest::RequestType direction, u64 lba, u16 block_count)
 {
     VERIFY(m_connected_device);
-    VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
     SpinlockLocker lock(m_hard_lock);
+    auto& scatter_list = m_command_slots[command_slot].scatter_list;
+    VERIFY(scatter_list);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, command slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, command_slot);
+    // Note: The port stops processing commands after a fatal error.
+    if (!is_operable())
+        return false;
     if (!spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    auto& command_header = command_list_entries[command_slot];
+    command_header.ctba = command_table_address(command_slot).get();
+    command_header.ctbau = 0;
+    command_header.prdbc = 0;
+    command_header.prdtl = scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
-
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
-
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::Region::Cacheable::No).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    // The HBA isn't allowed to prefetch the PRDs of queued commands though.
+    command_header.attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | (m_native_command_queuing_enabled ? 0 : AHCI::CommandHeaderAttributes::P) | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_header.ctba, (u32)command_header.ctbau, (u32)command_header.prdbc, (u16)command_header.prdtl, (u16)command_header.attributes);
 
+    auto& command_table = this->command_table(command_slot);
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -614,7 +727,6 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
         }
         scatter_entry_index++;
     }
-    command_table.descriptors[scatter_entry_index].byte_count = (PAGE_SIZE - 1) | (1 << 31);
 
     memset(const_cast<u8*>(command_table.atapi_command), 0, 32);
 
@@ -623,6 +735,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -641,17 +758,28 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing_enabled) {
+        // Note: Queued commands take the block count in the features register,
+        // and the tag of the command (which is its command slot) in the count register.
+        fis.features_low = block_count & 0xff;
+        fis.features_high = (block_count >> 8) & 0xff;
+        fis.count = command_slot << 3;
+    } else {
+        fis.count = block_count;
+    }
 
     // The below loop waits until the port is no longer busy before issuing a new command
     if (!spin_until_ready())
         return false;
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    m_issued_command_slots |= 1u << command_slot;
+    if (m_native_command_queuing_enabled)
+        m_port_registers.sact = 1u << command_slot;
+    mark_command_header_ready_to_process(command_slot);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, command slot {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, command_slot);
     return true;
 }
 
@@ -669,7 +797,7 @@ bool AHCIPort::identify_device()
     auto unused_command_header = try_to_find_unused_command_header();
     VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
+    command_list_entries[unused_command_header.value()].ctba = command_table_address(unused_command_header.value()).get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
     command_list_entries[unused_command_header.value()].prdbc = 512;
     command_list_entries[unused_command_header.value()].prdtl = 1;
@@ -678,8 +806,7 @@ bool AHCIPort::identify_device()
     // QEMU doesn't care if we don't set the correct CFL field in this register, real hardware will set an handshake error bit in PxSERR register.
     command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P;
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table"sv, Memory::Region::Access::ReadWrite).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = this->command_table(unused_command_header.value());
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
     command_table.descriptors[0].base_high = 0;
     command_table.descriptors[0].base_low = m_identify_buffer_page->paddr().get();
@@ -756,13 +883,13 @@ bool AHCIPort::shutdown()
 Optional<u8> AHCIPort::try_to_find_unused_command_header()
 {
     VERIFY(m_lock.is_locked());
-    u32 commands_issued = m_port_registers.ci;
-    for (size_t index = 0; index < 32; index++) {
-        if (!(commands_issued & 1)) {
+    u32 used_command_slots = m_busy_command_slots | m_port_registers.ci | m_port_registers.sact;
+    // Note: Queued commands use their slot as their tag, which has to stay below the queue depth of the device.
+    for (size_t index = 0; index < m_queue_depth; index++) {
+        if (!(used_command_slots & (1u << index))) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: unused command header at index {}", representative_port_index(), index);
             return index;
         }
-        commands_issued >>= 1;
     }
     return {};
 }
@@ -781,8 +908,6 @@ void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) con
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
     m_port_registers.ci = 1 << command_header_index;
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
@@ -47,12 +48,29 @@ public:
 
     LockRefPtr<StorageDevice> connected_device() const { return m_connected_device; }
 
+    // How many commands the port keeps in flight at once, more than one only with native command queuing.
+    size_t queue_depth() const { return m_queue_depth; }
+    size_t max_transfer_size() const { return dma_pages_per_command * PAGE_SIZE; }
+
     bool reset();
     bool initialize_without_reset();
     void handle_interrupt();
+    void complete_finished_commands();
+    void disable_command_completion_interrupts();
 
 private:
+    // Every command slot gets its own DMA buffers, which the command's PRDT scatters the transfer over.
+    static constexpr size_t dma_pages_per_command = 16;
+    // Note: Command tables have to be aligned on 128 bytes.
+    static constexpr size_t command_table_size = align_up_to(sizeof(AHCI::CommandTable) + dma_pages_per_command * sizeof(AHCI::PhysicalRegionDescriptor), 128);
+
+    struct CommandSlot {
+        LockRefPtr<AsyncBlockDeviceRequest> request;
+        LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    };
+
     ErrorOr<void> allocate_resources_and_initialize_ports();
+    ErrorOr<void> allocate_dma_buffers(size_t command_slots_count);
 
     bool is_phy_enabled() const { return (m_port_registers.ssts & 0xf) == 3; }
     bool initialize();
@@ -74,10 +92,14 @@ private:
     ALWAYS_INLINE void power_on() const;
 
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    void finish_request_in_slot(u8 command_slot);
+    void complete_request_in_slot(u8 command_slot, AsyncBlockDeviceRequest&, AsyncDeviceRequest::RequestResult);
+    void fail_requests_in_slots(u32 command_slots);
+    bool access_device(u8 command_slot, AsyncBlockDeviceRequest::RequestType, u64 lba, u16 block_count);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(u8 command_slot, AsyncBlockDeviceRequest& request);
+    volatile AHCI::CommandTable& command_table(u8 command_slot) const;
+    PhysicalAddress command_table_address(u8 command_slot) const;
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -106,14 +128,23 @@ private:
     // Data members
 
     EntropySource m_entropy_source;
-    LockRefPtr<AsyncBlockDeviceRequest> m_current_request;
     Spinlock m_hard_lock { LockRank::None };
     Mutex m_lock { "AHCIPort"sv };
 
-    mutable bool m_wait_for_completion { false };
+    // Note: The command slots and the bitmaps below are guarded by m_hard_lock.
+    // A slot is busy from the moment a request is assigned to it until that request is completed,
+    // issued while the HBA (or the device, for queued commands) still works on its command, and finished
+    // from the moment the command is done until the request is completed on the I/O work queue.
+    Array<CommandSlot, AHCI::Limits::MaxCommands> m_command_slots;
+    u32 m_busy_command_slots { 0 };
+    u32 m_issued_command_slots { 0 };
+    u32 m_finished_command_slots { 0 };
+    size_t m_queue_depth { 1 };
+    bool m_native_command_queuing_enabled { false };
 
     NonnullRefPtrVector<Memory::PhysicalPage> m_dma_buffers;
     NonnullRefPtrVector<Memory::PhysicalPage> m_command_table_pages;
+    OwnPtr<Memory::Region> m_command_tables_region;
     RefPtr<Memory::PhysicalPage> m_command_list_page;
     OwnPtr<Memory::Region> m_command_list_region;
     RefPtr<Memory::PhysicalPage> m_fis_receive_page;
@@ -133,7 +164,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    LockRefPtr<Memory::ScatterGatherList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
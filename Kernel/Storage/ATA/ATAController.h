@@ -22,6 +22,8 @@ class ATAController
     , public LockWeakable<ATAController> {
 public:
     virtual void start_request(ATADevice const&, AsyncBlockDeviceRequest&) = 0;
+    virtual size_t max_transfer_size(ATADevice const&) const { return PAGE_SIZE; }
+    virtual size_t max_requests_in_flight(ATADevice const&) const { return 1; }
 
 protected:
     ATAController() = default;
@@ -33,4 +33,18 @@ void ATADevice::start_request(AsyncBlockDeviceRequest& request)
     controller->start_request(*this, request);
 }
 
+size_t ATADevice::max_blocks_per_request() const
+{
+    auto controller = m_controller.strong_ref();
+    VERIFY(controller);
+    return controller->max_transfer_size(*this) / block_size();
+}
+
+size_t ATADevice::max_requests_in_flight() const
+{
+    auto controller = m_controller.strong_ref();
+    VERIFY(controller);
+    return controller->max_requests_in_flight(*this);
+}
+
 }
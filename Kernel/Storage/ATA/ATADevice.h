@@ -32,6 +32,12 @@ public:
     // ^BlockDevice
     virtual void start_request(AsyncBlockDeviceRequest&) override;
 
+    // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override;
+
+    // ^Device
+    virtual size_t max_requests_in_flight() const override;
+
     u16 ata_capabilites() const { return m_capabilities; }
     Address const& ata_address() const { return m_ata_address; }
 
@@ -48,6 +48,8 @@ enum DeviceSignature : u32 {
 #define ATA_CMD_PACKET 0xA0
 #define ATA_CMD_IDENTIFY_PACKET 0xA1
 #define ATA_CMD_IDENTIFY 0xEC
+#define ATA_CMD_READ_FPDMA_QUEUED 0x60
+#define ATA_CMD_WRITE_FPDMA_QUEUED 0x61
 
 #define ATAPI_CMD_READ 0xA8
 #define ATAPI_CMD_EJECT 0x1B
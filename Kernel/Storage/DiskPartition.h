@@ -22,6 +22,10 @@ public:
 
     virtual void start_request(AsyncBlockDeviceRequest&) override;
 
+    // ^Device
+    // Note: Requests are passed on to the disk right away, so that its I/O scheduler gets to see all of them.
+    virtual size_t max_requests_in_flight() const override { return NumericLimits<size_t>::max(); }
+
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual bool can_read(OpenFileDescription const&, u64) const override;
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Storage/IOScheduler.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// Deadline: Requests that waited this long get started before anything else.
+static constexpr Time read_deadline = Time::from_milliseconds(500);
+static constexpr Time write_deadline = Time::from_milliseconds(5000);
+
+// Fair: Processes are charged this much for every block they get served, divided by their priority.
+static constexpr u64 service_per_block = 1024;
+
+IOScheduler::IOScheduler(IOSchedulerPolicy policy)
+    : m_policy(policy)
+{
+}
+
+StringView IOScheduler::policy_name() const
+{
+    switch (m_policy) {
+    case IOSchedulerPolicy::FirstComeFirstServed:
+        return "fcfs"sv;
+    case IOSchedulerPolicy::Deadline:
+        return "deadline"sv;
+    case IOSchedulerPolicy::Fair:
+        return "fair"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+IOScheduler::RequestQueue::Iterator IOScheduler::select_next_request(RequestQueue& queued_requests)
+{
+    switch (m_policy) {
+    case IOSchedulerPolicy::FirstComeFirstServed:
+        return queued_requests.begin();
+    case IOSchedulerPolicy::Deadline:
+        return select_deadline(queued_requests);
+    case IOSchedulerPolicy::Fair:
+        return select_fair(queued_requests);
+    }
+    VERIFY_NOT_REACHED();
+}
+
+IOScheduler::RequestQueue::Iterator IOScheduler::select_deadline(RequestQueue& queued_requests)
+{
+    auto now = TimeManagement::the().monotonic_time();
+
+    // Requests that have waited past their deadline go first, the one that is the furthest past it first of all.
+    auto expired_request = queued_requests.end();
+    Time earliest_deadline;
+    for (auto it = queued_requests.begin(); it != queued_requests.end(); ++it) {
+        auto& request = static_cast<AsyncBlockDeviceRequest const&>(**it);
+        auto deadline = request.queued_time() + (request.request_type() == AsyncBlockDeviceRequest::Read ? read_deadline : write_deadline);
+        if (deadline > now)
+            continue;
+        if (expired_request == queued_requests.end() || deadline < earliest_deadline) {
+            expired_request = it;
+            earliest_deadline = deadline;
+        }
+    }
+
+    // Otherwise, sweep across the disk towards the end, and start over at the beginning once we get there.
+    auto selected_request = expired_request;
+    if (selected_request == queued_requests.end()) {
+        auto first_request = queued_requests.end();
+        for (auto it = queued_requests.begin(); it != queued_requests.end(); ++it) {
+            auto block_index = static_cast<AsyncBlockDeviceRequest const&>(**it).block_index();
+            if (first_request == queued_requests.end() || block_index < static_cast<AsyncBlockDeviceRequest const&>(**first_request).block_index())
+                first_request = it;
+            if (block_index < m_next_block)
+                continue;
+            if (selected_request == queued_requests.end() || block_index < static_cast<AsyncBlockDeviceRequest const&>(**selected_request).block_index())
+                selected_request = it;
+        }
+        if (selected_request == queued_requests.end())
+            selected_request = first_request;
+    }
+
+    auto& request = static_cast<AsyncBlockDeviceRequest const&>(**selected_request);
+    m_next_block = request.block_index() + request.block_count();
+    return selected_request;
+}
+
+u64 IOScheduler::service_of(ProcessID pid) const
+{
+    for (size_t i = 0; i < m_service_count; ++i) {
+        if (m_service[i].pid == pid)
+            return max(m_service[i].service, m_virtual_time);
+    }
+    return m_virtual_time;
+}
+
+void IOScheduler::charge_service(ProcessID pid, u64 service)
+{
+    ProcessService* least_served = nullptr;
+    for (size_t i = 0; i < m_service_count; ++i) {
+        auto& entry = m_service[i];
+        if (entry.pid == pid) {
+            entry.service = service;
+            return;
+        }
+        if (!least_served || entry.service < least_served->service)
+            least_served = &entry;
+    }
+    if (m_service_count < m_service.size()) {
+        m_service[m_service_count++] = { pid, service };
+        return;
+    }
+    // Note: Forgetting the process that got the least service only makes it start over at the virtual time,
+    // which is where it would be anyway if the virtual time already passed it.
+    *least_served = { pid, service };
+}
+
+IOScheduler::RequestQueue::Iterator IOScheduler::select_fair(RequestQueue& queued_requests)
+{
+    // The process that got the least service goes next. Since that favors processes in the order
+    // they queued their requests on a tie, this is first come, first served for a single process.
+    auto selected_request = queued_requests.end();
+    u64 selected_service = 0;
+    for (auto it = queued_requests.begin(); it != queued_requests.end(); ++it) {
+        auto service = service_of((*it)->process().pid());
+        if (selected_request == queued_requests.end() || service < selected_service) {
+            selected_request = it;
+            selected_service = service;
+        }
+    }
+    VERIFY(selected_request != queued_requests.end());
+
+    auto& request = static_cast<AsyncBlockDeviceRequest const&>(**selected_request);
+    m_virtual_time = selected_service;
+    auto weight = max(request.priority(), 1u);
+    charge_service(request.process().pid(), selected_service + request.block_count() * service_per_block / weight);
+    return selected_request;
+}
+
+void IOScheduler::did_complete_request(AsyncDeviceRequest const& request)
+{
+    auto latency = TimeManagement::the().monotonic_time(TimePrecision::Precise) - request.queued_time();
+    auto microseconds = static_cast<u64>(max<i64>(latency.to_microseconds(), 1));
+    // Note: Bucket 0 takes everything up to 16us, and every bucket after it twice as much as the one before.
+    size_t bucket = 0;
+    if (microseconds > 16)
+        bucket = min<size_t>(64 - count_leading_zeroes(microseconds - 1) - 4, latency_histogram_buckets_count - 1);
+    m_latency_histogram[bucket]++;
+}
+
+ErrorOr<void> IOScheduler::try_generate_latency_histogram(KBufferBuilder& builder) const
+{
+    for (size_t bucket = 0; bucket < latency_histogram_buckets_count - 1; ++bucket)
+        TRY(builder.appendff("{}us {}\n", 1ull << (bucket + 4), m_latency_histogram[bucket].load()));
+    TRY(builder.appendff("inf {}\n", m_latency_histogram[latency_histogram_buckets_count - 1].load()));
+    return {};
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/DoublyLinkedList.h>
+#include <AK/Time.h>
+#include <Kernel/CommandLine.h>
+#include <Kernel/Devices/AsyncDeviceRequest.h>
+#include <Kernel/Library/LockRefPtr.h>
+
+namespace Kernel {
+
+class KBufferBuilder;
+
+// Decides in which order the queued requests of a storage device get started, and keeps track of how long they take.
+// All requests that go through it are expected to be AsyncBlockDeviceRequests.
+class IOScheduler {
+public:
+    using RequestQueue = DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>>;
+
+    // Note: The buckets count completions that took up to 16us, 32us, ..., 2^(4 + index)us,
+    // and the last one everything that took longer than that.
+    static constexpr size_t latency_histogram_buckets_count = 21;
+
+    explicit IOScheduler(IOSchedulerPolicy);
+
+    IOSchedulerPolicy policy() const { return m_policy; }
+    StringView policy_name() const;
+
+    // Note: Both of these are called with the request queue of the device locked.
+    RequestQueue::Iterator select_next_request(RequestQueue& queued_requests);
+    void did_complete_request(AsyncDeviceRequest const&);
+
+    ErrorOr<void> try_generate_latency_histogram(KBufferBuilder&) const;
+
+private:
+    RequestQueue::Iterator select_deadline(RequestQueue& queued_requests);
+    RequestQueue::Iterator select_fair(RequestQueue& queued_requests);
+    u64 service_of(ProcessID) const;
+    void charge_service(ProcessID, u64 service);
+
+    IOSchedulerPolicy const m_policy;
+
+    // Deadline: The block right after the last request that was started, where the sweep across the disk continues.
+    u64 m_next_block { 0 };
+
+    // Fair: How much service the most recently served processes got so far, weighted by their priority.
+    // Processes that didn't get any since the virtual time passed them start over at the virtual time.
+    // Note: This is a fixed array since requests may be selected from an interrupt handler, where we can't allocate.
+    struct ProcessService {
+        ProcessID pid { 0 };
+        u64 service { 0 };
+    };
+    Array<ProcessService, 32> m_service {};
+    size_t m_service_count { 0 };
+    u64 m_virtual_time { 0 };
+
+    Array<Atomic<u64, AK::MemoryOrder::memory_order_relaxed>, latency_histogram_buckets_count> m_latency_histogram {};
+};
+
+}
@@ -57,6 +57,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     calculate_doorbell_stride();
     TRY(create_admin_queue(irq));
     VERIFY(m_admin_queue_ready == true);
+    TRY(identify_controller());
 
     VERIFY(IO_QUEUE_SIZE < MQES(caps));
     dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", IO_QUEUE_SIZE);
@@ -149,6 +150,30 @@ UNMAP_AFTER_INIT u32 NVMeController::get_admin_q_dept()
     return q_depth;
 }
 
+UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_controller()
+{
+    RefPtr<Memory::PhysicalPage> prp_dma_buffer;
+    auto prp_dma_region = TRY(MM.allocate_dma_buffer_page("Identify PRP"sv, Memory::Region::Access::ReadWrite, prp_dma_buffer));
+
+    NVMeSubmission sub {};
+    sub.op = OP_ADMIN_IDENTIFY;
+    sub.identify.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(prp_dma_buffer->paddr().as_ptr()));
+    sub.identify.cns = NVMe_CNS_ID_CTRL & 0xff;
+    if (submit_admin_command(sub, true)) {
+        dmesgln("Failed to identify controller command");
+        return EFAULT;
+    }
+
+    // MDTS is a power of two in units of the minimum memory page size, and zero means there is no limit.
+    // We always run the controller with 4KiB pages (CC.MPS = 0).
+    u8 mdts = prp_dma_region->vaddr().offset(CTRL_MDTS_INDEX).as_ptr()[0];
+    m_max_transfer_pages = IO_MAX_TRANSFER_PAGES;
+    if (mdts != 0 && mdts < 32)
+        m_max_transfer_pages = min(m_max_transfer_pages, 1u << mdts);
+    dbgln_if(NVME_DEBUG, "NVMe: MDTS is {}, using at most {} pages per IO command", mdts, m_max_transfer_pages);
+    return {};
+}
+
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 {
 
@@ -351,7 +376,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<
     auto queue_doorbell_offset = REG_SQ0TDBL_START + ((2 * qid) * (4 << m_dbl_stride));
     auto doorbell_regs = TRY(Memory::map_typed_writable<DoorbellRegister volatile>(PhysicalAddress(m_bar + queue_doorbell_offset)));
 
-    m_queues.append(TRY(NVMeQueue::try_create(qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), cq_dma_pages, move(sq_dma_region), sq_dma_pages, move(doorbell_regs))));
+    m_queues.append(TRY(NVMeQueue::try_create(qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), cq_dma_pages, move(sq_dma_region), sq_dma_pages, move(doorbell_regs), m_max_transfer_pages)));
     dbgln_if(NVME_DEBUG, "NVMe: Created IO Queue with QID{}", m_queues.size());
     return {};
 }
@@ -98,11 +98,15 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 }
 
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// Upper bound for the data transferred by a single IO command, the controller's MDTS may lower it further
+static constexpr u32 IO_MAX_TRANSFER_PAGES = 32;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
 static constexpr u8 NVMe_CNS_ID_ACTIVE_NS = 0x2;
 static constexpr u8 NVMe_CNS_ID_NS = 0x0;
+static constexpr u8 NVMe_CNS_ID_CTRL = 0x1;
+static constexpr u8 CTRL_MDTS_INDEX = 77;
 static constexpr u8 FLBA_SIZE_INDEX = 26;
 static constexpr u8 FLBA_SIZE_MASK = 0xf;
 static constexpr u8 LBA_FORMAT_SUPPORT_INDEX = 128;
@@ -13,20 +13,32 @@
 #include <Kernel/Storage/NVMe/NVMePollQueue.h>
 
 namespace Kernel {
-ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
+ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs, u32 max_transfer_pages)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
+    VERIFY(max_transfer_pages > 0);
+    // Note: Allocate DMA region for RW operation. Requests never exceed max_transfer_pages (Storage device takes care of it)
+    NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages;
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(max_transfer_pages * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages));
+
+    // Transfers spanning more than two pages describe everything after the first page with a PRP list.
+    // The DMA buffer never changes, so the list is built once here and shared by every command.
+    OwnPtr<Memory::Region> prp_list_region;
+    if (max_transfer_pages > 2) {
+        VERIFY(max_transfer_pages - 1 <= PAGE_SIZE / sizeof(u64));
+        prp_list_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue PRP list"sv, Memory::Region::Access::ReadWrite));
+        auto* prp_list = reinterpret_cast<LittleEndian<u64>*>(prp_list_region->vaddr().as_ptr());
+        for (size_t i = 1; i < max_transfer_pages; ++i)
+            prp_list[i - 1] = rw_dma_pages[i].paddr().get();
+    }
     if (!irq.has_value()) {
-        auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), *rw_dma_page, qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+        auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), move(rw_dma_pages), move(prp_list_region), qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
         return queue;
     }
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(rw_dma_region), *rw_dma_page, qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(rw_dma_region), move(rw_dma_pages), move(prp_list_region), qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages, OwnPtr<Memory::Region> prp_list_region, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
     : m_current_request(nullptr)
     , m_rw_dma_region(move(rw_dma_region))
     , m_qid(qid)
@@ -37,7 +49,8 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_sq_dma_region(move(sq_dma_region))
     , m_sq_dma_page(sq_dma_page)
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
+    , m_rw_dma_pages(move(rw_dma_pages))
+    , m_prp_list_region(move(prp_list_region))
 
 {
     m_sqe_array = { reinterpret_cast<NVMeSubmission*>(m_sq_dma_region->vaddr().as_ptr()), m_qdepth };
@@ -134,6 +147,18 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return status;
 }
 
+void NVMeQueue::set_data_pointer(NVMeSubmission& sub, size_t size)
+{
+    auto page_count = ceil_div(size, static_cast<size_t>(PAGE_SIZE));
+    VERIFY(page_count > 0 && page_count <= m_rw_dma_pages.size());
+
+    sub.rw.data_ptr.prp1 = m_rw_dma_pages[0].paddr().get();
+    if (page_count == 2)
+        sub.rw.data_ptr.prp2 = m_rw_dma_pages[1].paddr().get();
+    else if (page_count > 2)
+        sub.rw.data_ptr.prp2 = m_prp_list_region->physical_page(0)->paddr().get();
+}
+
 void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
 {
     NVMeSubmission sub {};
@@ -145,7 +170,7 @@ void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    set_data_pointer(sub, m_current_request->buffer_size());
 
     full_memory_barrier();
     submit_sqe(sub);
@@ -166,7 +191,7 @@ void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    set_data_pointer(sub, m_current_request->buffer_size());
 
     full_memory_barrier();
     submit_sqe(sub);
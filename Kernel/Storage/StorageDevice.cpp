@@ -25,6 +25,7 @@ StorageDevice::StorageDevice(LUNAddress logical_unit_number_address, MajorNumber
     , m_logical_unit_number_address(logical_unit_number_address)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_io_scheduler(kernel_command_line().io_scheduler_policy())
 {
 }
 
@@ -78,10 +79,10 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    // Most controllers (e.g. PATAChannel) use a single page for their DMA buffer,
+    // so we can't read more than the device allows in a single request.
+    if (auto max_blocks = max_blocks_per_request(); whole_blocks >= max_blocks) {
+        whole_blocks = max_blocks;
         remaining = 0;
     }
 
@@ -144,10 +145,10 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    // Most controllers (e.g. PATAChannel) use a single page for their DMA buffer,
+    // so we can't write more than the device allows in a single request.
+    if (auto max_blocks = max_blocks_per_request(); whole_blocks >= max_blocks) {
+        whole_blocks = max_blocks;
         remaining = 0;
     }
 
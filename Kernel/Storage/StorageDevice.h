@@ -11,6 +11,7 @@
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Storage/DiskPartition.h>
+#include <Kernel/Storage/IOScheduler.h>
 #include <Kernel/Storage/StorageController.h>
 
 namespace Kernel {
@@ -56,6 +57,9 @@ public:
 public:
     virtual u64 max_addressable_block() const { return m_max_addressable_block; }
 
+    // The largest number of blocks a single AsyncBlockDeviceRequest may transfer
+    virtual size_t max_blocks_per_request() const { return m_blocks_per_page; }
+
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual bool can_read(OpenFileDescription const&, u64) const override;
@@ -76,6 +80,8 @@ public:
 
     StringView command_set_to_string_view() const;
 
+    IOScheduler const& io_scheduler() const { return m_io_scheduler; }
+
     // ^File
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) final;
 
@@ -84,6 +90,10 @@ protected:
     // ^DiskDevice
     virtual StringView class_name() const override;
 
+    // ^Device
+    virtual RequestQueue::Iterator select_next_request(RequestQueue& queued_requests) override { return m_io_scheduler.select_next_request(queued_requests); }
+    virtual void did_complete_request(AsyncDeviceRequest const& request) override { m_io_scheduler.did_complete_request(request); }
+
 private:
     virtual void after_inserting() override;
     virtual void will_be_destroyed() override;
@@ -96,6 +106,7 @@ private:
     LUNAddress const m_logical_unit_number_address;
     u64 m_max_addressable_block { 0 };
     size_t m_blocks_per_page { 0 };
+    IOScheduler m_io_scheduler;
 };
 
 }
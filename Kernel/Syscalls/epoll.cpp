@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// NOTE: This bounds the kernel buffer used by one epoll_wait() call, more events are simply reported by the next call.
+static constexpr int max_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto epoll = TRY(EPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(epoll)));
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (flags & EPOLL_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+    auto epoll_description = TRY(open_file_description(params.epfd));
+    auto* epoll = epoll_description->epoll();
+    if (!epoll)
+        return EINVAL;
+    auto description = TRY(open_file_description(params.fd));
+
+    epoll_event event {};
+    if (params.op == EPOLL_CTL_ADD || params.op == EPOLL_CTL_MOD)
+        TRY(copy_from_user(&event, params.event));
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        TRY(epoll->add_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(epoll->modify_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_DEL:
+        TRY(epoll->remove_interest(params.fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto epoll_description = TRY(open_file_description(params.epfd));
+    auto* epoll = epoll_description->epoll();
+    if (!epoll)
+        return EINVAL;
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event> events;
+    TRY(events.try_resize(min(params.maxevents, max_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = epoll->collect_ready_events(events.span());
+        if (event_count > 0)
+            break;
+
+        // NOTE: Interests that stopped being ready can keep the epoll readable until we collect again, so loop.
+        //       The timeout is absolute by now, so this doesn't extend it.
+        auto unblocked_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = current_thread->block<Thread::ReadBlocker>(timeout, *epoll_description, unblocked_flags);
+        if (result.was_interrupted())
+            return EINTR;
+        if (result == Thread::BlockResult::InterruptedByTimeout) {
+            event_count = epoll->collect_ready_events(events.span());
+            break;
+        }
+    }
+
+    dbgln_if(POLL_SELECT_DEBUG, "epoll_wait on {} returned {} events", params.epfd, event_count);
+
+    if (event_count > 0)
+        TRY(copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)));
+    return event_count;
+}
+
+}
@@ -128,7 +128,13 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
                 auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                if (region_clone->can_be_mapped_lazily()) {
+                    // NOTE: The child's page tables are populated by page faults as it touches its memory,
+                    //       so we don't have to walk (and allocate page tables for) every page up front.
+                    region_clone->set_page_directory(child_space->page_directory());
+                } else {
+                    TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                }
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 auto* child_region = region_clone.leak_ptr();
 
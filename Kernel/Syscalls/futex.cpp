@@ -107,11 +107,13 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
     case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_CMP_REQUEUE:
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
-            clockid_t clock_id = use_realtime_clock ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+            // NOTE: Like on Linux, the timeout of FUTEX_LOCK_PI is always measured against the realtime clock.
+            clockid_t clock_id = use_realtime_clock || cmd == FUTEX_LOCK_PI ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time, nullptr, clock_id);
         }
         if (cmd == FUTEX_WAIT_BITSET && params.val3 == FUTEX_BITSET_MATCH_ANY)
@@ -227,7 +229,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
                 // NOTE: futex_queue's lock is being held while this callback is called
                 // The reason we're doing this in a callback is that we don't want to always
                 // create a target queue, only if we actually have anything to move to it!
-                target_futex_queue = TRY(find_futex_queue(futex_key2, true));
+                bool did_create_target;
+                target_futex_queue = TRY(find_futex_queue(futex_key2, true, &did_create_target));
                 return target_futex_queue.ptr();
             },
             params.val2, is_empty, is_target_empty));
@@ -238,6 +241,115 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return woken_or_requeued;
     };
 
+    auto do_lock_pi = [&](bool try_only) -> ErrorOr<FlatPtr> {
+        auto& current_thread = *Thread::current();
+        u32 tid = static_cast<u32>(current_thread.tid().value());
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // The lock is free, take it. If others are still queued up, the next unlock has to come through us as well.
+                auto futex_queue = TRY(find_futex_queue(futex_key, false));
+                u32 new_value = tid;
+                if (futex_queue && !futex_queue->is_empty_and_no_imminent_waits())
+                    new_value |= FUTEX_WAITERS;
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, new_value);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (did_exchange.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    if (futex_queue)
+                        futex_queue->set_pi_owner(current_thread, 0);
+                    return 0;
+                }
+                continue;
+            }
+
+            if (owner_tid == tid)
+                return EDEADLK;
+            if (try_only)
+                return EAGAIN;
+
+            if (!(value & FUTEX_WAITERS)) {
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+            }
+
+            auto owner = Thread::from_tid(owner_tid);
+            if (!owner)
+                return ESRCH;
+
+            bool did_create;
+            LockRefPtr<FutexQueue> futex_queue;
+            do {
+                did_create = false;
+                futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
+                VERIFY(futex_queue);
+            } while (!did_create && !futex_queue->queue_imminent_wait());
+
+            // FIXME: Propagate the boost if the owner is itself blocked on another PI futex.
+            futex_queue->set_pi_owner(*owner, current_thread.priority());
+
+            // The owner may have unlocked the futex before we were queued up, in which case nobody would wake us up.
+            // From here on, an unlock clears the owner of the queue, which keeps us from blocking on a stale owner.
+            user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value() || (user_value.value() & FUTEX_TID_MASK) != owner_tid) {
+                futex_queue->cancel_imminent_wait();
+                futex_queue->update_pi_waiter_priority();
+                if (futex_queue->is_empty_and_no_imminent_waits())
+                    remove_futex_queue(futex_key);
+                if (!user_value.has_value())
+                    return EFAULT;
+                continue;
+            }
+
+            Thread::BlockResult block_result = futex_queue->wait_on(timeout, 0u, owner.ptr());
+
+            // We aren't waiting anymore, so the owner shouldn't run at our priority on our behalf.
+            futex_queue->update_pi_waiter_priority();
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(futex_key);
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto& current_thread = *Thread::current();
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != static_cast<u32>(current_thread.tid().value()))
+            return EPERM;
+
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        auto futex_queue = TRY(find_futex_queue(futex_key, false));
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_store_relaxed(params.userspace_address, 0))
+            return EFAULT;
+
+        if (futex_queue) {
+            // NOTE: The woken thread has to race for the lock like anyone else, and boosts the winner if it loses.
+            futex_queue->clear_pi_owner();
+            bool is_empty;
+            futex_queue->wake_n(1, {}, is_empty);
+            if (is_empty)
+                remove_futex_queue(futex_key);
+        }
+        return 0;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
@@ -310,6 +422,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_REQUEUE:
         return do_requeue({});
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_CMP_REQUEUE:
         return do_requeue(params.val3);
 
@@ -21,4 +21,19 @@ ErrorOr<FlatPtr> Process::sys$get_dir_entries(int fd, Userspace<void*> user_buff
     return count;
 }
 
+ErrorOr<FlatPtr> Process::sys$get_dir_entries_with_metadata(int fd, Userspace<void*> user_buffer, size_t user_size)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    TRY(require_promise(Pledge::rpath));
+    if (user_size > NumericLimits<ssize_t>::max())
+        return EINVAL;
+    auto description = TRY(open_file_description(fd));
+    auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(user_buffer, static_cast<size_t>(user_size)));
+    // Unveiled paths can hide a directory's children from stat(), so we let userspace ask for their metadata in that case.
+    bool may_look_up_metadata = veil_state() == VeilState::None;
+    auto count = TRY(description->get_dir_entries_with_metadata(credentials(), may_look_up_metadata, buffer, user_size));
+    return count;
+}
+
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~O_CLOEXEC)
+        return EINVAL;
+
+    auto io_ring = TRY(IORing::try_create(entries));
+    auto description = TRY(OpenFileDescription::try_create(move(io_ring)));
+    description->set_readable(true);
+    // NOTE: The ring is mapped shared and writable, which mmap() only allows for writable descriptions.
+    description->set_writable(true);
+
+    u32 fd_flags = 0;
+    if (flags & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 min_complete)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto description = TRY(open_file_description(fd));
+    auto* io_ring = description->io_ring();
+    if (!io_ring)
+        return EINVAL;
+    return TRY(io_ring->enter(*this, min_complete));
+}
+
+}
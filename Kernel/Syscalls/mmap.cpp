@@ -423,6 +423,12 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
+        if (advice == MADV_HUGEPAGE || advice == MADV_NOHUGEPAGE) {
+            if (!region->vmobject().is_anonymous())
+                return EINVAL;
+            region->set_large_pages_enabled(advice == MADV_HUGEPAGE);
+            return 0;
+        }
         return EINVAL;
     });
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <Kernel/PerformanceEventBuffer.h>
 #include <Kernel/Process.h>
 
@@ -30,4 +31,23 @@ ErrorOr<FlatPtr> Process::sys$perf_register_string(Userspace<char const*> user_s
     return events_buffer->register_string(move(string));
 }
 
+ErrorOr<FlatPtr> Process::sys$perf_signposts(Userspace<perf_signpost const*> user_signposts, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    if (count > PERF_SIGNPOSTS_MAX_BATCH)
+        return EINVAL;
+    auto* events_buffer = current_perf_events_buffer();
+    if (!events_buffer)
+        return 0;
+
+    Array<perf_signpost, PERF_SIGNPOSTS_MAX_BATCH> signposts;
+    TRY(copy_n_from_user(signposts.data(), user_signposts, count));
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < count; ++i) {
+        auto const& signpost = signposts[i];
+        TRY(events_buffer->append_signpost(pid(), current_thread->tid(), signpost.timestamp, signpost.string_id, signpost.arg, { signpost.stack, array_size(signpost.stack) }));
+    }
+    return 0;
+}
+
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -15,6 +16,7 @@ namespace Kernel {
 bool g_profiling_all_threads;
 PerformanceEventBuffer* g_global_perf_events;
 u64 g_profiling_event_mask;
+static bool s_profiling_all_threads_with_hardware_counters;
 
 // NOTE: event_mask needs to be passed as a pointer as u64
 //       does not fit into a register on 32bit architectures.
@@ -49,8 +51,18 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         }
 
         SpinlockLocker lock(g_profiling_lock);
-        if (!TimeManagement::the().enable_profile_timer())
+        if (s_profiling_all_threads_with_hardware_counters) {
+            PerformanceCounters::disable();
+            s_profiling_all_threads_with_hardware_counters = false;
+        }
+        if ((event_mask & PERF_EVENT_HARDWARE_COUNTERS) != 0)
+            TRY(PerformanceCounters::enable(event_mask));
+        if (!TimeManagement::the().enable_profile_timer()) {
+            if ((event_mask & PERF_EVENT_HARDWARE_COUNTERS) != 0)
+                PerformanceCounters::disable();
             return ENOTSUP;
+        }
+        s_profiling_all_threads_with_hardware_counters = (event_mask & PERF_EVENT_HARDWARE_COUNTERS) != 0;
         g_profiling_all_threads = true;
         PerformanceManager::add_process_created_event(*Scheduler::colonel());
         Process::for_each([](auto& process) {
@@ -58,6 +70,7 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
             return IterationDecision::Continue;
         });
         g_profiling_event_mask = event_mask;
+        TimeManagement::the().set_signposts_enabled((event_mask & PERF_EVENT_SIGNPOST) != 0);
         return 0;
     }
 
@@ -71,6 +84,8 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
     if (!credentials->is_superuser() && profile_process_credentials->uid() != credentials->euid())
         return EPERM;
     SpinlockLocker lock(g_profiling_lock);
+    if ((event_mask & PERF_EVENT_HARDWARE_COUNTERS) != 0 && !PerformanceCounters::can_count(event_mask))
+        return ENOTSUP;
     g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
     process->set_profiling(true);
     if (!process->create_perf_events_buffer_if_needed()) {
@@ -82,6 +97,15 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         process->set_profiling(false);
         return ENOTSUP;
     }
+    if ((event_mask & PERF_EVENT_HARDWARE_COUNTERS) != 0 && !process->is_profiling_hardware_counters()) {
+        if (auto result = PerformanceCounters::enable(event_mask); result.is_error()) {
+            TimeManagement::the().disable_profile_timer();
+            process->set_profiling(false);
+            return result.release_error();
+        }
+        process->set_profiling_hardware_counters(true);
+    }
+    TimeManagement::the().set_signposts_enabled((event_mask & PERF_EVENT_SIGNPOST) != 0);
     return 0;
 }
 
@@ -97,6 +121,10 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
+        if (s_profiling_all_threads_with_hardware_counters) {
+            PerformanceCounters::disable();
+            s_profiling_all_threads_with_hardware_counters = false;
+        }
         g_profiling_all_threads = false;
         return 0;
     }
@@ -114,6 +142,10 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     // FIXME: If we enabled the profile timer and it's not supported, how do we disable it now?
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
+    if (process->is_profiling_hardware_counters()) {
+        PerformanceCounters::disable();
+        process->set_profiling_hardware_counters(false);
+    }
     process->set_profiling(false);
     return 0;
 }
@@ -65,7 +65,7 @@ ErrorOr<FlatPtr> Process::sys$sched_getparam(pid_t pid, Userspace<struct sched_p
         if (!credentials->is_superuser() && credentials->euid() != peer_credentials->uid() && credentials->uid() != peer_credentials->uid())
             return EPERM;
 
-        priority = (int)peer->priority();
+        priority = (int)peer->base_priority();
     }
 
     struct sched_param param {
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// NOTE: Data is staged through a kernel buffer of at most this size, so it never has to visit userspace.
+static constexpr size_t max_sendfile_chunk_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.count == 0)
+        return 0;
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    // Like other systems, only support sending from files that can't block on read.
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    Optional<off_t> offset;
+    if (params.offset) {
+        off_t initial_offset = 0;
+        TRY(copy_from_user(&initial_offset, params.offset));
+        if (initial_offset < 0)
+            return EINVAL;
+        offset = initial_offset;
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", params.out_fd, params.in_fd, offset, params.count);
+
+    auto buffer = TRY(KBuffer::try_create_with_size("sendfile"sv, min(params.count, max_sendfile_chunk_size)));
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+
+    size_t total_sent = 0;
+    while (total_sent < params.count) {
+        auto chunk_size = min(params.count - total_sent, buffer->size());
+        auto nread_or_error = offset.has_value()
+            ? in_description->read(kernel_buffer, offset.value() + total_sent, chunk_size)
+            : in_description->read(kernel_buffer, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_sent > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.release_value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, kernel_buffer, nread);
+        auto nwritten = nwritten_or_error.is_error() ? 0 : nwritten_or_error.value();
+
+        // Put back whatever we read but couldn't send, so the next call picks up right there.
+        if (!offset.has_value() && nwritten < nread)
+            (void)in_description->seek(-static_cast<off_t>(nread - nwritten), SEEK_CUR);
+
+        if (nwritten_or_error.is_error()) {
+            if (total_sent > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        total_sent += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+
+    if (offset.has_value()) {
+        off_t new_offset = offset.value() + total_sent;
+        TRY(copy_to_user(params.offset, &new_offset));
+    }
+    return total_sent;
+}
+
+}
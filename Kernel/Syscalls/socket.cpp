@@ -11,12 +11,12 @@
 
 namespace Kernel {
 
-#define REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(domain) \
-    do {                                          \
-        if (domain == AF_INET)                    \
-            TRY(require_promise(Pledge::inet));   \
-        else if (domain == AF_LOCAL)              \
-            TRY(require_promise(Pledge::unix));   \
+#define REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(domain)     \
+    do {                                              \
+        if (domain == AF_INET || domain == AF_PACKET) \
+            TRY(require_promise(Pledge::inet));       \
+        else if (domain == AF_LOCAL)                  \
+            TRY(require_promise(Pledge::unix));       \
     } while (0)
 
 static void setup_socket_fd(Process::OpenFileDescriptions& fds, int fd, NonnullLockRefPtr<OpenFileDescription> description, int type)
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/SwapTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void SwapTask::spawn()
+{
+    LockRefPtr<Thread> swap_thread;
+    (void)Process::create_kernel_process(swap_thread, KString::must_create("Swap Task"sv), [] {
+        dbgln("SwapTask is running");
+        for (;;) {
+            // Pages that nobody accessed between two passes get compressed, for as long as memory is running low.
+            (void)Thread::current()->sleep(Time::from_seconds(1));
+            if (MM.memory_pressure_level() == Memory::MemoryPressureLevel::Normal)
+                continue;
+            auto swapped_out_page_count = MM.swap_out_cold_pages();
+            dbgln_if(SWAP_DEBUG, "SwapTask: Swapped out {} pages", swapped_out_page_count);
+        }
+    });
+}
+
+}
@@ -18,7 +18,7 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
     (void)Process::create_kernel_process(syncd_thread, KString::must_create("VFS Sync Task"sv), [] {
         dbgln("VFS SyncTask is running");
         for (;;) {
-            VirtualFileSystem::sync();
+            VirtualFileSystem::writeback();
             (void)Thread::current()->sleep(Time::from_seconds(1));
         }
     });
@@ -15,6 +15,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/KCOVDevice.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FutexQueue.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PageDirectory.h>
@@ -33,6 +34,8 @@
 
 namespace Kernel {
 
+DEFINE_SLAB_CACHE(Thread);
+
 static Singleton<SpinlockProtected<Thread::GlobalList>> s_list;
 
 SpinlockProtected<Thread::GlobalList>& Thread::all_instances()
@@ -1446,6 +1449,31 @@ LockRefPtr<Thread> Thread::from_tid(ThreadID tid)
     });
 }
 
+void Thread::add_owned_pi_futex_queue(Badge<FutexQueue>, FutexQueue& futex_queue)
+{
+    m_owned_pi_futex_queues.with([&](auto& queues) {
+        // NOTE: If we can't keep track of the futex, we just don't inherit the priority of its waiters.
+        (void)queues.try_append(&futex_queue);
+    });
+}
+
+void Thread::remove_owned_pi_futex_queue(Badge<FutexQueue>, FutexQueue& futex_queue)
+{
+    m_owned_pi_futex_queues.with([&](auto& queues) {
+        queues.remove_first_matching([&](auto* queue) { return queue == &futex_queue; });
+    });
+}
+
+void Thread::update_inherited_priority()
+{
+    u32 inherited_priority = 0;
+    m_owned_pi_futex_queues.with([&](auto& queues) {
+        for (auto* queue : queues)
+            inherited_priority = max(inherited_priority, queue->pi_waiter_priority());
+    });
+    set_inherited_priority(inherited_priority);
+}
+
 void Thread::reset_fpu_state()
 {
     memcpy(&m_fpu_state, &Processor::clean_fpu_state(), sizeof(FPUState));
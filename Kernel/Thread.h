@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/EnumBits.h>
 #include <AK/Error.h>
@@ -18,6 +19,7 @@
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Forward.h>
+#include <Kernel/Heap/SlabCache.h>
 #include <Kernel/KString.h>
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
@@ -136,11 +138,13 @@ class Thread
     , public LockWeakable<Thread> {
     AK_MAKE_NONCOPYABLE(Thread);
     AK_MAKE_NONMOVABLE(Thread);
+    MAKE_SLAB_ALLOCATED(Thread);
 
     friend class Mutex;
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ProcessorReadyQueues;
 
 public:
     inline static Thread* current()
@@ -158,7 +162,15 @@ public:
     ProcessID pid() const;
 
     void set_priority(u32 p) { m_priority = p; }
-    u32 priority() const { return m_priority; }
+    // The priority the scheduler uses, which may be boosted by threads waiting on a PI futex we hold.
+    u32 priority() const { return max(m_priority, m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed)); }
+    u32 base_priority() const { return m_priority; }
+    void set_inherited_priority(u32 p) { m_inherited_priority.store(p, AK::MemoryOrder::memory_order_relaxed); }
+
+    // The PI futexes we own, whose waiters we inherit our priority from.
+    void add_owned_pi_futex_queue(Badge<FutexQueue>, FutexQueue&);
+    void remove_owned_pi_futex_queue(Badge<FutexQueue>, FutexQueue&);
+    void update_inherited_priority();
 
     void detach()
     {
@@ -460,6 +472,14 @@ public:
             return m_blockers.is_empty();
         }
 
+        template<typename Callback>
+        void for_each_blocker_locked(Callback callback) const
+        {
+            VERIFY(m_lock.is_locked());
+            for (auto& info : m_blockers)
+                callback(*info.blocker);
+        }
+
         virtual bool should_add_blocker(Blocker&, void*) { return true; }
 
         struct BlockerInfo {
@@ -544,7 +564,7 @@ public:
 
     class FutexBlocker final : public Blocker {
     public:
-        explicit FutexBlocker(FutexQueue&, u32);
+        explicit FutexBlocker(FutexQueue&, u32, Thread const* pi_owner = nullptr);
         virtual ~FutexBlocker();
 
         virtual Type blocker_type() const override { return Type::Futex; }
@@ -553,6 +573,7 @@ public:
         virtual bool setup_blocker() override;
 
         u32 bitset() const { return m_bitset; }
+        Thread const* pi_owner() const { return m_pi_owner; }
 
         void begin_requeue()
         {
@@ -567,6 +588,7 @@ public:
     protected:
         FutexQueue& m_futex_queue;
         u32 m_bitset { 0 };
+        Thread const* m_pi_owner { nullptr };
         u32 m_relock_flags { 0 };
         bool m_did_unblock { false };
     };
@@ -1161,6 +1183,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_ready_queue_cpu { 0 };
 
     friend class WaitQueue;
 
@@ -1300,6 +1323,8 @@ private:
     State m_state { Thread::State::Invalid };
     NonnullOwnPtr<KString> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    Atomic<u32> m_inherited_priority { 0 };
+    SpinlockProtected<Vector<FutexQueue*>> m_owned_pi_futex_queues { LockRank::None };
 
     State m_stop_state { Thread::State::Invalid };
 
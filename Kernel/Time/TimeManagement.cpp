@@ -183,6 +183,10 @@ time_t TimeManagement::boot_time()
 UNMAP_AFTER_INIT TimeManagement::TimeManagement()
     : m_time_page_region(MM.allocate_kernel_region(PAGE_SIZE, "Time page"sv, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow).release_value_but_fixme_should_propagate_errors())
 {
+    // The TSC can only be used to interpolate the time page if it ticks at a constant rate, even in deep C-states.
+    auto& processor = Processor::current();
+    m_tsc_is_invariant = processor.has_feature(CPUFeature::CONSTANT_TSC) && processor.has_feature(CPUFeature::NONSTOP_TSC);
+
     bool probe_non_legacy_hardware_timers = !(kernel_command_line().is_legacy_time_enabled());
     if (ACPI::is_enabled()) {
         if (!ACPI::Parser::the()->x86_specific_flags().cmos_rtc_not_present) {
@@ -428,20 +432,71 @@ bool TimeManagement::disable_profile_timer()
 {
     if (!m_profile_timer)
         return false;
-    if (m_profile_enable_count.fetch_sub(1) == 1)
+    if (m_profile_enable_count.fetch_sub(1) == 1) {
+        set_signposts_enabled(false);
         return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(1));
+    }
     return true;
 }
 
+void TimeManagement::set_signposts_enabled(bool enabled)
+{
+    u32 generation = 0;
+    if (enabled) {
+        // Zero means disabled, so it is skipped when the generation wraps around.
+        generation = m_signpost_generation.fetch_add(1) + 1;
+        if (generation == 0)
+            generation = m_signpost_generation.fetch_add(1) + 1;
+    }
+    time_page().signpost_generation = generation;
+}
+
 void TimeManagement::update_time_page()
 {
     auto& page = time_page();
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time;
     page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).to_timespec();
+    if (m_tsc_is_invariant) {
+        auto tsc = read_tsc();
+        calibrate_tsc_for_time_page(tsc);
+        page.tsc_at_update = tsc;
+        // NOTE: The TSC is only sampled on the processor that handles the timer. Nothing makes sure that the TSCs
+        //       of the other processors agree with it, so userspace only gets to use it while there is just one.
+        page.tsc_to_ns_multiplier = Processor::count() == 1 ? m_tsc_to_ns_multiplier : 0;
+        page.max_tsc_delta = m_max_tsc_delta;
+    }
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
+void TimeManagement::calibrate_tsc_for_time_page(u64 tsc)
+{
+    // Measure the TSC rate against the coarse monotonic clock over windows of about a second.
+    // The rate is only published once a full window has passed, until then userspace falls back to the syscall.
+    auto now = monotonic_time(TimePrecision::Coarse);
+    if (m_tsc_calibration_start_tsc == 0) {
+        m_tsc_calibration_start_tsc = tsc;
+        m_tsc_calibration_start_time = now;
+        return;
+    }
+
+    auto elapsed_ns = (now - m_tsc_calibration_start_time).to_nanoseconds();
+    if (elapsed_ns < 1'000'000'000)
+        return;
+
+    auto elapsed_tsc = tsc - m_tsc_calibration_start_tsc;
+    // NOTE: Keep elapsed_ns << 32 from overflowing if we were not updated for a while.
+    if (tsc > m_tsc_calibration_start_tsc && elapsed_ns < (1ll << 31)) {
+        m_tsc_to_ns_multiplier = (static_cast<u64>(elapsed_ns) << 32) / elapsed_tsc;
+        // The coarse clocks advance by one timer tick per update, so interpolating any further
+        // could run past the next update and make the clock go backwards.
+        u64 tick_length_ns = 1'000'000'000 / m_time_keeper_timer->ticks_per_second();
+        m_max_tsc_delta = (tick_length_ns << 32) / m_tsc_to_ns_multiplier;
+    }
+    m_tsc_calibration_start_tsc = tsc;
+    m_tsc_calibration_start_time = now;
+}
+
 TimePage& TimeManagement::time_page()
 {
     return *static_cast<TimePage*>((void*)m_time_page_region->vaddr().as_ptr());
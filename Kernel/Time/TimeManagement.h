@@ -61,6 +61,9 @@ public:
     bool enable_profile_timer();
     bool disable_profile_timer();
 
+    // Tells userspace tracepoints through the time page whether signposts are being recorded.
+    void set_signposts_enabled(bool);
+
     u64 uptime_ms() const;
     static Time now();
 
@@ -78,6 +81,7 @@ public:
 private:
     TimePage& time_page();
     void update_time_page();
+    void calibrate_tsc_for_time_page(u64 tsc);
 
     bool probe_and_set_legacy_hardware_timers();
     bool probe_and_set_non_legacy_hardware_timers();
@@ -106,9 +110,17 @@ private:
     LockRefPtr<HardwareTimerBase> m_time_keeper_timer;
 
     Atomic<u32> m_profile_enable_count { 0 };
+    Atomic<u32> m_signpost_generation { 0 };
     LockRefPtr<HardwareTimerBase> m_profile_timer;
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
+
+    // Only touched from update_time_page(), which runs on the BSP.
+    bool m_tsc_is_invariant { false };
+    u64 m_tsc_calibration_start_tsc { 0 };
+    Time m_tsc_calibration_start_time;
+    u64 m_tsc_to_ns_multiplier { 0 };
+    u64 m_max_tsc_delta { 0 };
 };
 
 }
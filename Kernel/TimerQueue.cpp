@@ -53,6 +53,8 @@ TimerQueue& TimerQueue::the()
 UNMAP_AFTER_INIT TimerQueue::TimerQueue()
 {
     m_ticks_per_second = TimeManagement::the().ticks_per_second();
+    m_wheel_slot_duration = Time::from_nanoseconds(1'000'000'000 / m_ticks_per_second);
+    m_wheel_next_slot = wheel_slot_for(TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE));
 }
 
 bool TimerQueue::add_timer_without_id(NonnullLockRefPtr<Timer> timer, clockid_t clock_id, Time const& deadline, Function<void()>&& callback)
@@ -92,7 +94,14 @@ void TimerQueue::add_timer_locked(NonnullLockRefPtr<Timer> timer)
     timer->clear_callback_finished();
     timer->set_in_use();
 
-    auto& queue = queue_for_timer(*timer);
+    if (is_monotonic(*timer)) {
+        // Timers that are already due go into the first slot we haven't looked at yet.
+        auto slot = max(wheel_slot_for(timer_expiration), m_wheel_next_slot);
+        wheel_slot(slot).append(timer.leak_ref());
+        return;
+    }
+
+    auto& queue = m_timer_queue_realtime;
     if (queue.list.is_empty()) {
         queue.list.append(timer.leak_ref());
         queue.next_timer_due = timer_expiration;
@@ -128,15 +137,14 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     }
 
     bool did_already_run = timer.set_cancelled();
-    auto& timer_queue = queue_for_timer(timer);
     if (!did_already_run) {
         timer.clear_in_use();
 
         SpinlockLocker lock(g_timerqueue_lock);
-        if (timer_queue.list.contains(timer)) {
+        if (timer.is_queued() && !m_timers_executing.contains(timer)) {
             // The timer has not fired, remove it
             VERIFY(timer.ref_count() > 1);
-            remove_timer_locked(timer_queue, timer);
+            remove_timer_locked(timer);
             return true;
         }
 
@@ -158,65 +166,103 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     return false;
 }
 
-void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
+void TimerQueue::remove_timer_locked(Timer& timer)
 {
-    bool was_next_timer = (queue.list.first() == &timer);
-    queue.list.remove(timer);
+    if (is_monotonic(timer)) {
+        // NOTE: The timer might not be in the wheel slot of its expiration, or even in the wheel at all if fire()
+        //       has already picked it up, so we unlink it from whichever list it is in.
+        timer.m_list_node.remove();
+    } else {
+        auto& queue = m_timer_queue_realtime;
+        bool was_next_timer = (queue.list.first() == &timer);
+        queue.list.remove(timer);
+        if (was_next_timer)
+            update_next_timer_due(queue);
+    }
+
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
     timer.unref();
 }
 
-void TimerQueue::fire()
+void TimerQueue::fire_timer_locked(Timer& timer, SpinlockLocker<Spinlock>& lock)
 {
-    SpinlockLocker lock(g_timerqueue_lock);
-
-    auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.first();
-        VERIFY(timer);
-        VERIFY(queue.next_timer_due == timer->m_expires);
+    VERIFY(!timer.is_queued());
+    m_timers_executing.append(timer);
+
+    lock.unlock();
+
+    // Defer executing the timer outside of the irq handler
+    Processor::deferred_call_queue([this, timer = &timer]() {
+        // Check if we were cancelled in between being triggered
+        // by the timer irq handler and now. If so, just drop
+        // our reference and don't execute the callback.
+        if (!timer->set_cancelled()) {
+            timer->m_callback();
+            SpinlockLocker lock(g_timerqueue_lock);
+            m_timers_executing.remove(*timer);
+        }
+        timer->clear_in_use();
+        timer->set_callback_finished();
+        // Drop the reference we added when queueing the timer
+        timer->unref();
+    });
 
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(*timer);
+    lock.lock();
+}
 
-            m_timers_executing.append(*timer);
+void TimerQueue::fire_wheel_timers(SpinlockLocker<Spinlock>& lock)
+{
+    auto now_slot = wheel_slot_for(TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE));
+    // If we have fallen behind by more than a whole turn of the wheel, looking at every slot once is enough.
+    auto first_slot = max(m_wheel_next_slot, now_slot >= wheel_slot_count ? now_slot - wheel_slot_count + 1 : 0);
+
+    for (auto slot = first_slot; slot <= now_slot; ++slot) {
+        // The timers that have come due are gathered first, since the lock is dropped while we fire each one.
+        // Until then, cancel_timer() can still take them out of this list like it would out of the wheel.
+        Timer::List due_timers;
+        for (auto it = wheel_slot(slot).begin(); it != wheel_slot(slot).end();) {
+            auto& timer = *it;
+            ++it;
+            if (timer.now(true) > timer.m_expires) {
+                timer.m_list_node.remove();
+                due_timers.append(timer);
+            }
+        }
+        while (auto* timer = due_timers.first()) {
+            due_timers.remove(*timer);
+            fire_timer_locked(*timer, lock);
+        }
+    }
 
-            update_next_timer_due(queue);
+    // The current slot stays around, since more of its timers will come due before the next tick.
+    m_wheel_next_slot = now_slot;
+}
 
-            lock.unlock();
-
-            // Defer executing the timer outside of the irq handler
-            Processor::deferred_call_queue([this, timer]() {
-                // Check if we were cancelled in between being triggered
-                // by the timer irq handler and now. If so, just drop
-                // our reference and don't execute the callback.
-                if (!timer->set_cancelled()) {
-                    timer->m_callback();
-                    SpinlockLocker lock(g_timerqueue_lock);
-                    m_timers_executing.remove(*timer);
-                }
-                timer->clear_in_use();
-                timer->set_callback_finished();
-                // Drop the reference we added when queueing the timer
-                timer->unref();
-            });
-
-            lock.lock();
-            timer = queue.list.first();
-        }
-    };
+void TimerQueue::fire_realtime_timers(SpinlockLocker<Spinlock>& lock)
+{
+    auto& queue = m_timer_queue_realtime;
+    auto* timer = queue.list.first();
+    while (timer && timer->now(true) > timer->m_expires) {
+        VERIFY(queue.next_timer_due == timer->m_expires);
+        queue.list.remove(*timer);
+        update_next_timer_due(queue);
+        fire_timer_locked(*timer, lock);
+        timer = queue.list.first();
+    }
+}
 
-    if (!m_timer_queue_monotonic.list.is_empty())
-        fire_timers(m_timer_queue_monotonic);
+void TimerQueue::fire()
+{
+    SpinlockLocker lock(g_timerqueue_lock);
+    fire_wheel_timers(lock);
     if (!m_timer_queue_realtime.list.is_empty())
-        fire_timers(m_timer_queue_realtime);
+        fire_realtime_timers(lock);
 }
 
 void TimerQueue::update_next_timer_due(Queue& queue)
@@ -6,12 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/OwnPtr.h>
 #include <AK/Time.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
@@ -93,32 +95,51 @@ public:
     void fire();
 
 private:
+    // Timers on the realtime clock are kept sorted by their expiration, since the clock can jump.
     struct Queue {
         Timer::List list;
         Time next_timer_due {};
     };
-    void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
-    void add_timer_locked(NonnullLockRefPtr<Timer>);
 
-    Queue& queue_for_timer(Timer& timer)
+    // Timers on the monotonic clocks go into a hashed timing wheel, where every slot holds the timers that expire
+    // within one tick's worth of time (or a multiple of wheel_slot_count ticks later), in no particular order.
+    // This makes adding and cancelling timers O(1), and firing them only has to look at the slots that have come due.
+    static constexpr size_t wheel_slot_count = 512;
+
+    static bool is_monotonic(Timer const& timer)
     {
         switch (timer.m_clock_id) {
         case CLOCK_MONOTONIC:
         case CLOCK_MONOTONIC_COARSE:
         case CLOCK_MONOTONIC_RAW:
-            return m_timer_queue_monotonic;
+            return true;
         case CLOCK_REALTIME:
         case CLOCK_REALTIME_COARSE:
-            return m_timer_queue_realtime;
+            return false;
         default:
             VERIFY_NOT_REACHED();
         }
     }
 
+    u64 wheel_slot_for(Time const& time) const { return time.to_nanoseconds() / m_wheel_slot_duration.to_nanoseconds(); }
+    Timer::List& wheel_slot(u64 slot) { return m_wheel[slot % wheel_slot_count]; }
+    bool is_in_wheel(Timer const& timer) const { return timer.is_queued() && is_monotonic(timer) && !m_timers_executing.contains(timer); }
+
+    void remove_timer_locked(Timer&);
+    void update_next_timer_due(Queue&);
+    void add_timer_locked(NonnullLockRefPtr<Timer>);
+    void fire_wheel_timers(SpinlockLocker<Spinlock>&);
+    void fire_realtime_timers(SpinlockLocker<Spinlock>&);
+    void fire_timer_locked(Timer&, SpinlockLocker<Spinlock>&);
+
     u64 m_timer_id_count { 0 };
     u64 m_ticks_per_second { 0 };
-    Queue m_timer_queue_monotonic;
+
+    Array<Timer::List, wheel_slot_count> m_wheel;
+    Time m_wheel_slot_duration;
+    // The first slot that may still hold timers that have come due.
+    u64 m_wheel_next_slot { 0 };
+
     Queue m_timer_queue_realtime;
     Timer::List m_timers_executing;
 };
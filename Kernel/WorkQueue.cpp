@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/WaitQueue.h>
@@ -14,47 +15,115 @@ namespace Kernel {
 
 WorkQueue* g_io_work;
 WorkQueue* g_ata_work;
+WorkQueue* g_readahead_work;
 
 UNMAP_AFTER_INIT void WorkQueue::initialize()
 {
-    g_io_work = new WorkQueue("IO WorkQueue Task"sv);
-    g_ata_work = new WorkQueue("ATA WorkQueue Task"sv);
+    // NOTE: I/O completions are queued from interrupt handlers, so they are run on the processor that handled the interrupt.
+    g_io_work = new WorkQueue("IO WorkQueue Task"sv, Binding::PerProcessor, 4);
+    // NOTE: ATA port operations are serialized by the ports anyway, so a single worker is enough.
+    g_ata_work = new WorkQueue("ATA WorkQueue Task"sv, Binding::Unbound, 1);
+    // NOTE: Readahead blocks on storage I/O, whose completions may be handled on g_io_work, so it gets its own queue.
+    g_readahead_work = new WorkQueue("Readahead WorkQueue Task"sv, Binding::Unbound, 4);
 }
 
-UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name)
+UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name, Binding binding, size_t max_workers_per_pool)
+    : m_name(MUST(KString::try_create(name)))
+    , m_binding(binding)
+    , m_max_workers_per_pool(max_workers_per_pool)
 {
-    LockRefPtr<Thread> thread;
-    auto name_kstring = KString::try_create(name);
-    if (name_kstring.is_error())
-        TODO();
-    (void)Process::create_kernel_process(thread, name_kstring.release_value(), [this] {
-        for (;;) {
-            WorkItem* item;
-            bool have_more;
-            m_items.with([&](auto& items) {
-                item = items.take_first();
-                have_more = !items.is_empty();
-            });
-            if (item) {
-                item->function();
-                delete item;
-
-                if (have_more)
-                    continue;
+    VERIFY(max_workers_per_pool > 0);
+    size_t pool_count = 1;
+    if (binding == Binding::PerProcessor) {
+        // Thread affinity is a u32 bitmask, so workers can only be bound to the first 32 processors.
+        // Items queued on any processor beyond those go to one more pool that isn't bound.
+        m_bound_pool_count = min<size_t>(Processor::count(), sizeof(u32) * 8);
+        pool_count = m_bound_pool_count + (Processor::count() > m_bound_pool_count ? 1 : 0);
+    }
+    for (size_t i = 0; i < pool_count; ++i) {
+        bool is_bound = i < m_bound_pool_count;
+        auto affinity = is_bound ? 1u << i : THREAD_AFFINITY_DEFAULT;
+        auto pool = MUST(adopt_nonnull_own_or_enomem(new (nothrow) Pool(*this, affinity)));
+        pool->state.with([](auto& state) { state.worker_count = 1; });
+
+        auto process_name = is_bound ? KString::formatted("{} #{}", name, i) : KString::try_create(name);
+        if (process_name.is_error())
+            TODO();
+        LockRefPtr<Thread> thread;
+        pool->process = Process::create_kernel_process(thread, process_name.release_value(), worker_main, pool.ptr(), affinity);
+        // If we can't create the thread we're in trouble...
+        VERIFY(pool->process);
+        m_pools.append(move(pool));
+    }
+}
+
+UNMAP_AFTER_INIT WorkQueue::Pool::Pool(WorkQueue& queue, u32 affinity)
+    : queue(queue)
+    , affinity(affinity)
+{
+}
+
+void WorkQueue::worker_main(void* data)
+{
+    auto& pool = *static_cast<Pool*>(data);
+    for (;;) {
+        WorkItem* item;
+        bool should_spawn_worker = false;
+        pool.state.with([&](auto& state) {
+            item = state.items.take_first();
+            if (!item) {
+                state.idle_worker_count++;
+                return;
             }
-            [[maybe_unused]] auto result = m_wait_queue.wait_on({});
+            should_spawn_worker = !state.items.is_empty() && state.idle_worker_count == 0 && state.worker_count < pool.queue.m_max_workers_per_pool;
+            if (should_spawn_worker)
+                state.worker_count++;
+        });
+
+        if (!item) {
+            [[maybe_unused]] auto result = pool.wait_queue.wait_on({});
+            pool.state.with([](auto& state) { state.idle_worker_count--; });
+            continue;
         }
-    });
-    // If we can't create the thread we're in trouble...
-    m_thread = thread.release_nonnull();
+
+        if (should_spawn_worker)
+            pool.queue.spawn_worker(pool);
+        item->function();
+        delete item;
+    }
+}
+
+void WorkQueue::spawn_worker(Pool& pool)
+{
+    LockRefPtr<Thread> thread;
+    auto thread_name = KString::try_create(m_name->view());
+    if (!thread_name.is_error())
+        thread = pool.process->create_kernel_thread(worker_main, &pool, THREAD_PRIORITY_NORMAL, thread_name.release_value(), pool.affinity, false);
+    // Note: If we can't add a worker, the ones we have will get to the work eventually.
+    if (!thread)
+        pool.state.with([](auto& state) { state.worker_count--; });
 }
 
 void WorkQueue::do_queue(WorkItem& item)
 {
-    m_items.with([&](auto& items) {
-        items.append(item);
+    auto processor_id = Processor::current_id();
+    auto& pool = m_pools[processor_id < m_bound_pool_count ? processor_id : m_pools.size() - 1];
+    pool.state.with([&](auto& state) {
+        state.items.append(item);
+    });
+
+    if (!Processor::current_in_irq()) {
+        pool.wait_queue.wake_one();
+        return;
+    }
+
+    // Interrupt handlers tend to queue several items at once, e.g. one for every request that completed.
+    // Wake the workers for all of them in one go, once the handler is done.
+    if (pool.pending_wake_count.fetch_add(1) > 0)
+        return;
+    Processor::deferred_call_queue([&pool] {
+        pool.wait_queue.wake_n(pool.pending_wake_count.exchange(0));
     });
-    m_wait_queue.wake_one();
 }
 
 }
@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtrVector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/WaitQueue.h>
@@ -17,6 +19,7 @@ namespace Kernel {
 
 extern WorkQueue* g_io_work;
 extern WorkQueue* g_ata_work;
+extern WorkQueue* g_readahead_work;
 
 class WorkQueue {
     AK_MAKE_NONCOPYABLE(WorkQueue);
@@ -51,7 +54,14 @@ public:
     }
 
 private:
-    explicit WorkQueue(StringView);
+    // Note: Work items queued on a per-processor queue are run by workers on the processor that queued them,
+    // those queued on an unbound queue (or on a processor past the 32 that threads can be bound to) by workers on any processor.
+    enum class Binding {
+        Unbound,
+        PerProcessor,
+    };
+
+    WorkQueue(StringView, Binding, size_t max_workers_per_pool);
 
     struct WorkItem {
     public:
@@ -59,11 +69,40 @@ private:
         Function<void()> function;
     };
 
+    // The workers that run the items queued on one processor, or on all of them for an unbound queue.
+    // A pool starts out with a single worker, and gets another one whenever all of its workers are
+    // busy while there is still work left, up to the maximum of the queue.
+    struct Pool {
+        AK_MAKE_NONCOPYABLE(Pool);
+        AK_MAKE_NONMOVABLE(Pool);
+
+    public:
+        Pool(WorkQueue&, u32 affinity);
+
+        struct State {
+            IntrusiveList<&WorkItem::m_node> items;
+            size_t worker_count { 0 };
+            size_t idle_worker_count { 0 };
+        };
+
+        WorkQueue& queue;
+        u32 const affinity;
+        LockRefPtr<Process> process;
+        WaitQueue wait_queue;
+        Atomic<u32> pending_wake_count { 0 };
+        SpinlockProtected<State> state { LockRank::None };
+    };
+
+    static void worker_main(void*);
+    void spawn_worker(Pool&);
     void do_queue(WorkItem&);
 
-    LockRefPtr<Thread> m_thread;
-    WaitQueue m_wait_queue;
-    SpinlockProtected<IntrusiveList<&WorkItem::m_node>> m_items { LockRank::None };
+    NonnullOwnPtr<KString> m_name;
+    Binding const m_binding;
+    size_t const m_max_workers_per_pool;
+    // The first pools are bound to the processor with the same index. Any pool after those is unbound.
+    size_t m_bound_pool_count { 0 };
+    NonnullOwnPtrVector<Pool> m_pools;
 };
 
 }
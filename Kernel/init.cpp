@@ -21,6 +21,7 @@
 #include <Kernel/Devices/HID/HIDManagement.h>
 #include <Kernel/Devices/KCOVDevice.h>
 #include <Kernel/Devices/MemoryDevice.h>
+#include <Kernel/Devices/MemoryPressureDevice.h>
 #include <Kernel/Devices/NullDevice.h>
 #include <Kernel/Devices/PCISerialDevice.h>
 #include <Kernel/Devices/RandomDevice.h>
@@ -30,6 +31,7 @@
 #include <Kernel/FileSystem/Ext2FileSystem.h>
 #include <Kernel/FileSystem/SysFS.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Firmware/Directory.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Interrupts/Directory.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Firmware/ACPI/Initialize.h>
 #include <Kernel/Firmware/ACPI/Parser.h>
@@ -58,6 +60,7 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/SwapTask.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/WorkQueue.h>
@@ -301,8 +304,6 @@ void init_stage2(void*)
     // The colonel process gets away without having to do this because it never exits.
     Process::register_new(Process::current());
 
-    WorkQueue::initialize();
-
     if (kernel_command_line().is_smp_enabled() && APIC::initialized() && APIC::the().enabled_processor_count() > 1) {
         // We can't start the APs until we have a scheduler up and running.
         // We need to be able to process ICI messages, otherwise another
@@ -311,6 +312,9 @@ void init_stage2(void*)
         APIC::the().boot_aps();
     }
 
+    // NOTE: The per-processor work queues need to know about all processors.
+    WorkQueue::initialize();
+
     // Initialize the PCI Bus as early as possible, for early boot (PCI based) serial logging
     PCI::initialize();
     if (!PCI::Access::is_disabled()) {
@@ -333,6 +337,8 @@ void init_stage2(void*)
 
     SyncTask::spawn();
     FinalizerTask::spawn();
+    if (kernel_command_line().is_page_compression_enabled())
+        SwapTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -340,6 +346,7 @@ void init_stage2(void*)
         USB::USBManagement::initialize();
     }
     FirmwareSysFSDirectory::initialize();
+    InterruptsSysFSDirectory::initialize();
 
     if (!PCI::Access::is_disabled()) {
         VirtIO::detect();
@@ -354,6 +361,7 @@ void init_stage2(void*)
     (void)MemoryDevice::must_create().leak_ref();
     (void)ZeroDevice::must_create().leak_ref();
     (void)FullDevice::must_create().leak_ref();
+    (void)MemoryPressureDevice::must_create().leak_ref();
     (void)RandomDevice::must_create().leak_ref();
     (void)SelfTTYDevice::must_create().leak_ref();
     PTYMultiplexer::initialize();
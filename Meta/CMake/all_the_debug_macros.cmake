@@ -58,6 +58,7 @@ set(FILE_WATCHER_DEBUG ON)
 set(FILL_PATH_DEBUG ON)
 set(FORK_DEBUG ON)
 set(FRAMEBUFFER_DEVICE_DEBUG ON)
+set(FUNCTION_DEBUG ON)
 set(FUTEX_DEBUG ON)
 set(FUTEXQUEUE_DEBUG ON)
 set(GEMINI_DEBUG ON)
@@ -76,6 +77,7 @@ set(HIGHLIGHT_FOCUSED_FRAME_DEBUG ON)
 set(HPET_COMPARATOR_DEBUG ON)
 set(HPET_DEBUG ON)
 set(HTML_SCRIPT_DEBUG ON)
+set(HTTP2_DEBUG ON)
 set(HTTPJOB_DEBUG ON)
 set(HTTPSJOB_DEBUG ON)
 set(HUNKS_DEBUG ON)
@@ -96,6 +98,7 @@ set(ITEM_RECTS_DEBUG ON)
 set(JOB_DEBUG ON)
 set(JPG_DEBUG ON)
 set(JS_BYTECODE_DEBUG ON)
+set(JS_JIT_DEBUG ON)
 set(JS_MODULE_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
@@ -133,6 +136,7 @@ set(NT_DEBUG ON)
 set(NVME_DEBUG ON)
 set(OCCLUSIONS_DEBUG ON)
 set(OFFD_DEBUG ON)
+set(PACKET_SOCKET_DEBUG ON)
 set(PAGE_FAULT_DEBUG ON)
 set(HTML_PARSER_DEBUG ON)
 set(PATA_DEBUG ON)
@@ -175,6 +179,7 @@ set(SPAM_DEBUG ON)
 set(SQL_DEBUG ON)
 set(SQLSERVER_DEBUG ON)
 set(STORAGE_DEVICE_DEBUG ON)
+set(SWAP_DEBUG ON)
 set(SYNTAX_HIGHLIGHTING_DEBUG ON)
 set(SYSCALL_1_DEBUG ON)
 set(SYSFS_DEBUG ON)
@@ -203,6 +208,7 @@ set(VIRTIO_DEBUG ON)
 set(VIRTUAL_CONSOLE_DEBUG ON)
 set(VMWARE_BACKDOOR_DEBUG ON)
 set(VOLATILE_PAGE_RANGES_DEBUG ON)
+set(VP9_DEBUG ON)
 set(VRA_DEBUG ON)
 set(WAITBLOCK_DEBUG ON)
 set(WAITQUEUE_DEBUG ON)
@@ -92,6 +92,25 @@ struct AK::Formatter<DateTime> : Formatter<FormatString> {
     }
 };
 
+// The generated tables store when each offset stops being in effect as a plain timestamp, so that looking up the offset
+// for a point in time does not need to convert any dates.
+static i64 until_seconds_since_epoch(Optional<DateTime> const& until)
+{
+    if (!until.has_value())
+        return 0;
+
+    // FIXME: This implementation does not take last_weekday, after_weekday, or before_weekday into account.
+    return AK::Time::from_timestamp(
+        until->year,
+        until->month.value_or(1),
+        until->day.value_or(1),
+        until->hour.value_or(0),
+        until->minute.value_or(0),
+        until->second.value_or(0),
+        0)
+        .to_seconds();
+}
+
 template<>
 struct AK::Formatter<TimeZoneOffset> : Formatter<FormatString> {
     ErrorOr<void> format(FormatBuilder& builder, TimeZoneOffset const& time_zone_offset)
@@ -99,7 +118,7 @@ struct AK::Formatter<TimeZoneOffset> : Formatter<FormatString> {
         return Formatter<FormatString>::format(builder,
             "{{ {}, {}, {}, {}, {}, {}, {} }}"sv,
             time_zone_offset.offset,
-            time_zone_offset.until.value_or({}),
+            until_seconds_since_epoch(time_zone_offset.until),
             time_zone_offset.until.has_value(),
             time_zone_offset.dst_rule_index.value_or(-1),
             time_zone_offset.dst_offset,
@@ -512,7 +531,7 @@ struct DateTime {
 struct TimeZoneOffset {
     i64 offset { 0 };
 
-    DateTime until {};
+    i64 until { 0 };
     bool has_until { false };
 
     i32 dst_rule { -1 };
@@ -641,12 +660,18 @@ static Array<DaylightSavingsOffset const*, 2> find_dst_offsets(TimeZoneOffset co
         return (time >= new_time_in_effect) ? &new_offset : current_offset;
     };
 
+    // The rules that apply are the ones whose range of years contains the year of the given time. Working that year out
+    // once is much cheaper than converting the first and last year of every rule into a point in time.
+    auto year = static_cast<i32>(seconds_since_epoch_to_year(time.to_seconds()));
+    if (time < AK::Time::from_timestamp(year, 1, 1, 0, 0, 0, 0))
+        --year;
+    else if (time >= AK::Time::from_timestamp(year + 1, 1, 1, 0, 0, 0, 0))
+        ++year;
+
     for (size_t index = 0; (index < dst_rules.size()) && (!standard_offset || !daylight_offset); ++index) {
         auto const& dst_rule = dst_rules[index];
 
-        auto year_from = AK::Time::from_timestamp(dst_rule.year_from, 1, 1, 0, 0, 0, 0);
-        auto year_to = AK::Time::from_timestamp(dst_rule.year_to + 1, 1, 1, 0, 0, 0, 0);
-        if ((time < year_from) || (time >= year_to))
+        if ((year < dst_rule.year_from) || (year > dst_rule.year_to))
             continue;
 
         if (dst_rule.offset == 0)
@@ -689,16 +714,22 @@ static TimeZoneOffset const& find_time_zone_offset(TimeZone time_zone, AK::Time
 {
     auto const& time_zone_offsets = s_time_zone_offsets[to_underlying(time_zone)];
 
-    size_t index = 0;
-    for (; index < time_zone_offsets.size(); ++index) {
-        auto const& time_zone_offset = time_zone_offsets[index];
+    // The offsets are ordered by the time they stop being in effect, and only the last one is in effect indefinitely.
+    // Find the first one that is still in effect at the given time.
+    size_t low = 0;
+    size_t high = time_zone_offsets.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        auto const& time_zone_offset = time_zone_offsets[middle];
 
-        if (!time_zone_offset.has_until || (time_zone_offset.until.time_since_epoch() > time))
-            break;
+        if (!time_zone_offset.has_until || (AK::Time::from_seconds(time_zone_offset.until) > time))
+            high = middle;
+        else
+            low = middle + 1;
     }
 
-    VERIFY(index < time_zone_offsets.size());
-    return time_zone_offsets[index];
+    VERIFY(low < time_zone_offsets.size());
+    return time_zone_offsets[low];
 }
 
 Optional<Offset> get_time_zone_offset(TimeZone time_zone, AK::Time time)
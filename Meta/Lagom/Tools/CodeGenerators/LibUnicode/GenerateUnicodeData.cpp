@@ -725,6 +725,116 @@ struct SpecialCasing {
     return {};
 }
 
+// Property lookups go through two-stage tables, rather than a binary search through a property's code point ranges.
+// Every code point maps to the set of values the property has for it: the first stage maps the block a code point is
+// in to one of the deduplicated blocks of the second stage, which holds the index of the code point's set of values.
+struct PropertyTable {
+    u32 block_shift { 0 };
+    Vector<u32> block_indices;
+    Vector<u32> blocks;
+    Vector<Vector<size_t>> value_sets;
+};
+
+static constexpr u32 s_code_point_count = 0x110000;
+
+static size_t smallest_unsigned_type_size(size_t max_value)
+{
+    if (max_value <= NumericLimits<u8>::max())
+        return sizeof(u8);
+    if (max_value <= NumericLimits<u16>::max())
+        return sizeof(u16);
+    return sizeof(u32);
+}
+
+static StringView smallest_unsigned_type(size_t max_value)
+{
+    switch (smallest_unsigned_type_size(max_value)) {
+    case sizeof(u8):
+        return "u8"sv;
+    case sizeof(u16):
+        return "u16"sv;
+    default:
+        return "u32"sv;
+    }
+}
+
+static PropertyTable build_property_table(PropList const& property_list, Vector<String> const& property_names)
+{
+    Vector<Vector<size_t>> value_sets;
+    HashMap<Vector<size_t>, u32> value_set_indices;
+    value_sets.append({});
+    value_set_indices.set({}, 0);
+
+    // Every code point starts out in the empty set, and moves to another set for every value it has. Most code points
+    // make the same moves as their neighbours, so those are remembered by the set and the value they add.
+    Vector<u32> code_point_value_sets;
+    code_point_value_sets.resize(s_code_point_count);
+    HashMap<u64, u32> value_set_transitions;
+
+    for (size_t value = 0; value < property_names.size(); ++value) {
+        for (auto const& range : property_list.find(property_names[value])->value) {
+            for (u32 code_point = range.first; code_point <= range.last; ++code_point) {
+                auto& value_set_index = code_point_value_sets[code_point];
+                auto transition = (static_cast<u64>(value_set_index) << 32) | value;
+                if (auto next_index = value_set_transitions.get(transition); next_index.has_value()) {
+                    value_set_index = *next_index;
+                    continue;
+                }
+
+                auto value_set = value_sets[value_set_index];
+                if (value_set.is_empty() || value_set.last() != value)
+                    value_set.append(value);
+
+                u32 next_index = value_sets.size();
+                if (auto existing_index = value_set_indices.get(value_set); existing_index.has_value()) {
+                    next_index = *existing_index;
+                } else {
+                    value_set_indices.set(value_set, next_index);
+                    value_sets.append(move(value_set));
+                }
+                value_set_transitions.set(transition, next_index);
+                value_set_index = next_index;
+            }
+        }
+    }
+
+    // Small blocks mean a big first stage, and big blocks mean fewer of them are alike, so try which size comes out smallest.
+    Optional<PropertyTable> smallest_table;
+    size_t smallest_table_size = 0;
+
+    for (u32 block_shift = 4; block_shift <= 9; ++block_shift) {
+        PropertyTable table;
+        table.block_shift = block_shift;
+
+        u32 block_size = 1u << block_shift;
+        HashMap<Vector<u32>, u32> unique_blocks;
+
+        for (u32 first_code_point = 0; first_code_point < s_code_point_count; first_code_point += block_size) {
+            Vector<u32> block;
+            block.append(code_point_value_sets.data() + first_code_point, block_size);
+
+            u32 block_index = unique_blocks.size();
+            if (auto existing_index = unique_blocks.get(block); existing_index.has_value()) {
+                block_index = *existing_index;
+            } else {
+                table.blocks.extend(block);
+                unique_blocks.set(move(block), block_index);
+            }
+            table.block_indices.append(block_index);
+        }
+
+        auto table_size = table.block_indices.size() * smallest_unsigned_type_size(unique_blocks.size() - 1)
+            + table.blocks.size() * smallest_unsigned_type_size(value_sets.size() - 1);
+        if (!smallest_table.has_value() || table_size < smallest_table_size) {
+            smallest_table = move(table);
+            smallest_table_size = table_size;
+        }
+    }
+
+    smallest_table->value_sets = move(value_sets);
+    return smallest_table.release_value();
+}
+
 static ErrorOr<void> generate_unicode_data_implementation(Core::Stream::BufferedFile& file, UnicodeData const& unicode_data)
 {
     StringBuilder builder;
@@ -934,24 +1044,67 @@ static constexpr Array<CodePointRange, @size@> @name@ { {
 )~~~");
     };
 
-    auto append_prop_list = [&](StringView collection_name, StringView property_format, PropList const& property_list) {
-        for (auto const& property : property_list) {
-            auto name = String::formatted(property_format, property.key);
-            append_code_point_range_list(move(name), property.value);
-        }
-
+    auto append_prop_list = [&](StringView collection_name, PropList const& property_list) {
         auto property_names = property_list.keys();
         quick_sort(property_names);
 
+        auto table = build_property_table(property_list, property_names);
+        auto word_count = max<size_t>(1, ceil_div(property_names.size(), static_cast<size_t>(64)));
+
+        auto append_values = [&](auto const& values, size_t max_values_per_row) {
+            size_t values_in_current_row = 0;
+            for (auto value : values) {
+                if (values_in_current_row++ > 0)
+                    generator.append(" ");
+                generator.append(String::formatted("{},", value));
+                if (values_in_current_row == max_values_per_row) {
+                    values_in_current_row = 0;
+                    generator.append("\n    ");
+                }
+            }
+        };
+
         generator.set("name", collection_name);
-        generator.set("size", String::number(property_names.size()));
+        generator.set("block_shift", String::number(table.block_shift));
+        generator.set("block_index_type", smallest_unsigned_type(table.blocks.size() >> table.block_shift));
+        generator.set("block_count", String::number(table.block_indices.size()));
+        generator.set("value_set_index_type", smallest_unsigned_type(table.value_sets.size() - 1));
+        generator.set("blocks_size", String::number(table.blocks.size()));
+        generator.set("word_count", String::number(word_count));
+        generator.set("value_set_count", String::number(table.value_sets.size()));
+
         generator.append(R"~~~(
-static constexpr Array<Span<CodePointRange const>, @size@> @name@ { {)~~~");
+static constexpr u32 @name@_block_shift = @block_shift@;
 
-        for (auto const& property_name : property_names) {
-            generator.set("name", String::formatted(property_format, property_name));
-            generator.append(R"~~~(
-    @name@.span(),)~~~");
+static constexpr Array<@block_index_type@, @block_count@> @name@_block_indices { {
+    )~~~");
+        append_values(table.block_indices, 40);
+
+        generator.append(R"~~~(
+} };
+
+static constexpr Array<@value_set_index_type@, @blocks_size@> @name@_blocks { {
+    )~~~");
+        append_values(table.blocks, 40);
+
+        generator.append(R"~~~(
+} };
+
+static constexpr Array<Array<u64, @word_count@>, @value_set_count@> @name@_value_sets { {)~~~");
+
+        for (auto const& value_set : table.value_sets) {
+            Vector<u64> words;
+            words.resize(word_count);
+            for (auto value : value_set)
+                words[value / 64] |= 1ull << (value % 64);
+
+            generator.append("\n    { { ");
+            for (size_t i = 0; i < words.size(); ++i) {
+                if (i > 0)
+                    generator.append(", ");
+                generator.append(String::formatted("{:#x}", words[i]));
+            }
+            generator.append(" } },");
         }
 
         generator.append(R"~~~(
@@ -959,14 +1112,14 @@ static constexpr Array<Span<CodePointRange const>, @size@> @name@ { {)~~~");
 )~~~");
     };
 
-    append_prop_list("s_general_categories"sv, "s_general_category_{}"sv, unicode_data.general_categories);
-    append_prop_list("s_properties"sv, "s_property_{}"sv, unicode_data.prop_list);
-    append_prop_list("s_scripts"sv, "s_script_{}"sv, unicode_data.script_list);
-    append_prop_list("s_script_extensions"sv, "s_script_extension_{}"sv, unicode_data.script_extensions);
-    append_prop_list("s_blocks"sv, "s_block_{}"sv, unicode_data.block_list);
-    append_prop_list("s_grapheme_break_properties"sv, "s_grapheme_break_property_{}"sv, unicode_data.grapheme_break_props);
-    append_prop_list("s_word_break_properties"sv, "s_word_break_property_{}"sv, unicode_data.word_break_props);
-    append_prop_list("s_sentence_break_properties"sv, "s_sentence_break_property_{}"sv, unicode_data.sentence_break_props);
+    append_prop_list("s_general_categories"sv, unicode_data.general_categories);
+    append_prop_list("s_properties"sv, unicode_data.prop_list);
+    append_prop_list("s_scripts"sv, unicode_data.script_list);
+    append_prop_list("s_script_extensions"sv, unicode_data.script_extensions);
+    append_prop_list("s_blocks"sv, unicode_data.block_list);
+    append_prop_list("s_grapheme_break_properties"sv, unicode_data.grapheme_break_props);
+    append_prop_list("s_word_break_properties"sv, unicode_data.word_break_props);
+    append_prop_list("s_sentence_break_properties"sv, unicode_data.sentence_break_props);
 
     auto append_code_point_display_names = [&](StringView type, StringView name, auto const& display_names) {
         constexpr size_t max_values_per_row = 30;
@@ -1087,11 +1240,16 @@ Optional<StringView> code_point_abbreviation(u32 code_point)
         generator.append(R"~~~(
 bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
 {
-    auto index = static_cast<@enum_title@UnderlyingType>(@enum_snake@);
-    auto const& ranges = @collection_name@.at(index);
+    constexpr u32 block_size = 1u << @collection_name@_block_shift;
+    if (code_point >= @collection_name@_block_indices.size() * block_size)
+        return false;
+
+    auto block_index = @collection_name@_block_indices[code_point >> @collection_name@_block_shift];
+    auto value_set_index = @collection_name@_blocks[block_index * block_size + (code_point & (block_size - 1))];
+    auto const& value_set = @collection_name@_value_sets[value_set_index];
 
-    auto const* range = binary_search(ranges, code_point, nullptr, CodePointRangeComparator {});
-    return range != nullptr;
+    auto value = static_cast<@enum_title@UnderlyingType>(@enum_snake@);
+    return (value_set.at(value / 64) & (1ull << (value % 64))) != 0;
 }
 )~~~");
     };
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+"""Compare two sets of benchmark results written by LibTest's --json option.
+
+Each argument is either a single results file or a directory of them, like the one the run-benchmarks target
+fills. Benchmarks whose median got slower by more than the threshold are reported as regressions, and make the
+script exit with a non-zero status so that it can gate CI.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+
+def load_results(path):
+    """Load benchmark results.
+
+    Args:
+        path (str): a results file, or a directory of them
+
+    Returns:
+        dict: median time in microseconds for every (suite, benchmark) pair that passed
+    """
+    if os.path.isdir(path):
+        filenames = [os.path.join(path, name) for name in sorted(os.listdir(path)) if name.endswith('.json')]
+    else:
+        filenames = [path]
+
+    results = {}
+    for filename in filenames:
+        with open(filename, 'r') as file:
+            suite = json.load(file)
+        for benchmark in suite['benchmarks']:
+            if benchmark['passed']:
+                results[(suite['suite'], benchmark['name'])] = benchmark['median_us']
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two sets of LibTest benchmark results.')
+    parser.add_argument('baseline', help='results file or directory to compare against')
+    parser.add_argument('current', help='results file or directory to check')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='percentage by which a median may get slower before it counts as a regression')
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+
+    regressions = 0
+    for key in sorted(baseline.keys() & current.keys()):
+        before = max(baseline[key], 1)
+        after = max(current[key], 1)
+        change = (after - before) * 100.0 / before
+        marker = ''
+        if change > args.threshold:
+            marker = '  REGRESSION'
+            regressions += 1
+        print('{}/{}: {}us -> {}us ({:+.1f}%){}'.format(key[0], key[1], before, after, change, marker))
+
+    for key in sorted(baseline.keys() - current.keys()):
+        print('{}/{}: missing from current results'.format(key[0], key[1]))
+
+    if regressions:
+        print('{} benchmark(s) got more than {}% slower.'.format(regressions, args.threshold))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Arena.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+TEST_CASE(allocations_are_aligned)
+{
+    Arena arena;
+    for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+        (void)arena.allocate(1, 1);
+        auto* pointer = arena.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<FlatPtr>(pointer) % alignment, 0u);
+    }
+}
+
+TEST_CASE(large_allocations)
+{
+    Arena arena(64);
+    auto* small = static_cast<u8*>(arena.allocate(16));
+    auto* large = static_cast<u8*>(arena.allocate(64 * KiB));
+    __builtin_memset(small, 0xaa, 16);
+    __builtin_memset(large, 0x55, 64 * KiB);
+    EXPECT_EQ(small[15], 0xaa);
+    EXPECT_EQ(large[0], 0x55);
+    EXPECT_EQ(large[64 * KiB - 1], 0x55);
+    EXPECT(arena.used_bytes() >= 64 * KiB);
+
+    arena.clear();
+    EXPECT_EQ(arena.used_bytes(), 0u);
+}
+
+struct DestructionCounter {
+    Vector<int>& destroyed;
+    int id;
+
+    ~DestructionCounter() { destroyed.append(id); }
+};
+
+TEST_CASE(destructors_run_in_reverse_order)
+{
+    Vector<int> destroyed;
+    {
+        Arena arena;
+        for (int i = 0; i < 3; ++i)
+            arena.make<DestructionCounter>(destroyed, i);
+        EXPECT(destroyed.is_empty());
+
+        arena.clear();
+        EXPECT_EQ(destroyed.size(), 3u);
+        EXPECT_EQ(destroyed[0], 2);
+        EXPECT_EQ(destroyed[2], 0);
+
+        arena.make<DestructionCounter>(destroyed, 3);
+    }
+    EXPECT_EQ(destroyed.size(), 4u);
+    EXPECT_EQ(destroyed[3], 3);
+}
+
+TEST_CASE(copy_string)
+{
+    Arena arena;
+    StringView copy;
+    {
+        String original = "Well hello friends!";
+        copy = arena.copy(original);
+    }
+    EXPECT_EQ(copy, "Well hello friends!"sv);
+    EXPECT_EQ(arena.copy(""sv), ""sv);
+}
+
+TEST_CASE(vector_append)
+{
+    Arena arena;
+    ArenaVector<String> strings(arena);
+    for (int i = 0; i < 1000; ++i)
+        strings.append(String::number(i));
+
+    EXPECT_EQ(strings.size(), 1000u);
+    EXPECT(strings.capacity() >= 1000u);
+    EXPECT_EQ(strings.first(), "0");
+    EXPECT_EQ(strings[500], "500");
+    EXPECT_EQ(strings.last(), "999");
+
+    EXPECT_EQ(strings.take_last(), "999");
+    EXPECT_EQ(strings.size(), 999u);
+
+    size_t total = 0;
+    for (auto& string : strings)
+        total += string.length();
+    EXPECT_EQ(total, 10u + 90u * 2 + 899u * 3);
+}
+
+TEST_CASE(vectors_interleaved)
+{
+    Arena arena;
+    ArenaVector<int> a(arena);
+    ArenaVector<int> b(arena);
+    for (int i = 0; i < 100; ++i) {
+        a.append(i);
+        b.append(-i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(a[i], i);
+        EXPECT_EQ(b[i], -i);
+    }
+}
+
+TEST_CASE(vector_move)
+{
+    Arena arena;
+    ArenaVector<int> a(arena);
+    a.append(1);
+    a.append(2);
+
+    ArenaVector<int> b(move(a));
+    EXPECT(a.is_empty());
+    EXPECT_EQ(b.size(), 2u);
+    EXPECT_EQ(b[1], 2);
+
+    a = move(b);
+    EXPECT(b.is_empty());
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_EQ(a.span()[0], 1);
+}
+
+TEST_CASE(vector_destroys_elements)
+{
+    Vector<int> destroyed;
+    Arena arena;
+    {
+        ArenaVector<DestructionCounter> counters(arena);
+        counters.ensure_capacity(2);
+        counters.empend(destroyed, 0);
+        counters.empend(destroyed, 1);
+        EXPECT(destroyed.is_empty());
+    }
+    EXPECT_EQ(destroyed.size(), 2u);
+}
+
+struct Node {
+    int value;
+    Node* left { nullptr };
+    Node* right { nullptr };
+};
+
+static constexpr int node_count = 100'000;
+
+BENCHMARK_CASE(build_tree_with_kmalloc)
+{
+    for (int round = 0; round < 10; ++round) {
+        Vector<Node*> nodes;
+        for (int i = 0; i < node_count; ++i) {
+            auto* node = new Node { i };
+            if (i > 0)
+                node->left = nodes[(i - 1) / 2];
+            nodes.append(node);
+        }
+        for (auto* node : nodes)
+            delete node;
+    }
+}
+
+BENCHMARK_CASE(build_tree_with_arena)
+{
+    for (int round = 0; round < 10; ++round) {
+        Arena arena;
+        ArenaVector<Node*> nodes(arena);
+        for (int i = 0; i < node_count; ++i) {
+            auto& node = arena.make<Node>(i);
+            if (i > 0)
+                node.left = nodes[(i - 1) / 2];
+            nodes.append(&node);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/CountingBloomFilter.h>
+#include <AK/HashFunctions.h>
+
+TEST_CASE(add_and_remove)
+{
+    CountingBloomFilter<12> filter;
+    EXPECT(!filter.may_contain(int_hash(1)));
+
+    filter.add(int_hash(1));
+    filter.add(int_hash(2));
+    EXPECT(filter.may_contain(int_hash(1)));
+    EXPECT(filter.may_contain(int_hash(2)));
+
+    filter.remove(int_hash(1));
+    EXPECT(!filter.may_contain(int_hash(1)));
+    EXPECT(filter.may_contain(int_hash(2)));
+
+    filter.remove(int_hash(2));
+    EXPECT(!filter.may_contain(int_hash(2)));
+}
+
+TEST_CASE(duplicate_hashes)
+{
+    CountingBloomFilter<12> filter;
+    filter.add(int_hash(1));
+    filter.add(int_hash(1));
+
+    filter.remove(int_hash(1));
+    EXPECT(filter.may_contain(int_hash(1)));
+    filter.remove(int_hash(1));
+    EXPECT(!filter.may_contain(int_hash(1)));
+}
+
+TEST_CASE(shared_slots)
+{
+    // These two hashes share their first slot, but not their second one.
+    CountingBloomFilter<4> filter;
+    filter.add(0x21);
+    EXPECT(!filter.may_contain(0x31));
+
+    filter.add(0x31);
+    filter.remove(0x21);
+    EXPECT(filter.may_contain(0x31));
+    EXPECT(!filter.may_contain(0x21));
+}
+
+TEST_CASE(saturated_counters_stay_set)
+{
+    CountingBloomFilter<12> filter;
+    for (size_t i = 0; i < 300; ++i)
+        filter.add(int_hash(1));
+    for (size_t i = 0; i < 300; ++i)
+        filter.remove(int_hash(1));
+    EXPECT(filter.may_contain(int_hash(1)));
+
+    filter.clear();
+    EXPECT(!filter.may_contain(int_hash(1)));
+}
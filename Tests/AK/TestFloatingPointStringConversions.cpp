@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/BitCast.h>
+#include <AK/FloatingPointStringConversions.h>
+#include <AK/NumericLimits.h>
+
+static void expect_shortest_decimal(double value, u64 mantissa, i32 exponent)
+{
+    auto decimal = convert_double_to_shortest_decimal(value);
+    EXPECT_EQ(decimal.mantissa, mantissa);
+    EXPECT_EQ(decimal.exponent, exponent);
+}
+
+TEST_CASE(shortest_decimal)
+{
+    expect_shortest_decimal(1.0, 1, 0);
+    expect_shortest_decimal(123000.0, 123, 3);
+    expect_shortest_decimal(0.1, 1, -1);
+    expect_shortest_decimal(0.1 + 0.2, 30000000000000004, -17);
+    expect_shortest_decimal(1.0 / 3.0, 3333333333333333, -16);
+    expect_shortest_decimal(9007199254740992.0, 9007199254740992, 0);
+    expect_shortest_decimal(1e23, 1, 23);
+    expect_shortest_decimal(NumericLimits<double>::max(), 17976931348623157, 292);
+    expect_shortest_decimal(NumericLimits<double>::min(), 22250738585072014, -324);
+    // The smallest subnormal.
+    expect_shortest_decimal(bit_cast<double>(1ull), 5, -324);
+}
+
+static void expect_double(u64 mantissa, i64 exponent, u64 expected_bits)
+{
+    auto value = convert_decimal_to_double(mantissa, exponent);
+    EXPECT(value.has_value());
+    EXPECT_EQ(bit_cast<u64>(value.value()), expected_bits);
+}
+
+TEST_CASE(decimal_to_double)
+{
+    expect_double(0, 0, 0);
+    expect_double(1, 0, bit_cast<u64>(1.0));
+    expect_double(1, -1, bit_cast<u64>(0.1));
+    expect_double(314159, -5, bit_cast<u64>(3.14159));
+    expect_double(17976931348623157, 292, bit_cast<u64>(NumericLimits<double>::max()));
+    expect_double(5, -324, 1);
+    expect_double(22250738585072011, -324, 0x000fffffffffffff);
+
+    // Halfway between 2^53 and the next double, which rounds to even.
+    expect_double(9007199254740993, 0, bit_cast<u64>(9007199254740992.0));
+    expect_double(9007199254740995, 0, bit_cast<u64>(9007199254740996.0));
+
+    // Out of range.
+    expect_double(18, 307, bit_cast<u64>(__builtin_huge_val()));
+    expect_double(1, 309, bit_cast<u64>(__builtin_huge_val()));
+    expect_double(2, -324, 0);
+    expect_double(1, -400, 0);
+}
+
+TEST_CASE(round_trip)
+{
+    u64 state = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < 100'000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        auto bits = state & 0x7fffffffffffffffull;
+        auto value = bit_cast<double>(bits);
+        // Skip zero, infinity and NaNs.
+        if (!(value > 0 && value < __builtin_huge_val()))
+            continue;
+        auto decimal = convert_double_to_shortest_decimal(value);
+        auto round_tripped = convert_decimal_to_double(decimal.mantissa, decimal.exponent);
+        EXPECT(round_tripped.has_value());
+        EXPECT_EQ(bit_cast<u64>(round_tripped.value()), bits);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/FlyString.h>
+#include <AK/Vector.h>
+#include <pthread.h>
+
+TEST_CASE(interning)
+{
+    FlyString a = "hello friends"sv;
+    FlyString b = String("hello friends");
+    FlyString c = "hello enemies"sv;
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.impl(), b.impl());
+    EXPECT_NE(a, c);
+    EXPECT(a.impl()->is_fly());
+    EXPECT_EQ(a.hash(), "hello friends"sv.hash());
+}
+
+TEST_CASE(interning_again_after_destruction)
+{
+    {
+        FlyString a = "ephemeral"sv;
+        EXPECT_EQ(a.view(), "ephemeral"sv);
+    }
+    FlyString a = "ephemeral"sv;
+    FlyString b = String("ephemeral");
+    EXPECT_EQ(a.impl(), b.impl());
+}
+
+TEST_CASE(interning_from_multiple_threads)
+{
+    static constexpr int thread_count = 8;
+    static constexpr int strings_per_thread = 2000;
+
+    // Half of the strings are interned by every thread, so their impls are shared between the threads and keep being
+    // referenced on one thread while their last reference goes away on another.
+    auto thread_main = [](void* argument) -> void* {
+        auto id = reinterpret_cast<FlatPtr>(argument);
+        auto text_for = [&](int i) {
+            if (i % 2 == 0)
+                return String::formatted("shared string {}", i);
+            return String::formatted("thread {} string {}", id, i);
+        };
+        Vector<FlyString> strings;
+        for (int round = 0; round < 4; ++round) {
+            strings.clear();
+            for (int i = 0; i < strings_per_thread; ++i)
+                strings.append(text_for(i));
+            for (int i = 0; i < strings_per_thread; ++i) {
+                FlyString string = text_for(i).view();
+                if (string.impl() != strings[i].impl() || string.view() != text_for(i))
+                    return reinterpret_cast<void*>(1);
+            }
+        }
+        return nullptr;
+    };
+
+    pthread_t threads[thread_count];
+    for (int i = 0; i < thread_count; ++i)
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, thread_main, reinterpret_cast<void*>(i)), 0);
+    for (int i = 0; i < thread_count; ++i) {
+        void* result = nullptr;
+        EXPECT_EQ(pthread_join(threads[i], &result), 0);
+        EXPECT_EQ(result, nullptr);
+    }
+}
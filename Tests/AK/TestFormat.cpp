@@ -345,3 +345,13 @@ TEST_CASE(format_wchar)
     EXPECT_EQ(String::formatted("{:6d}", L'a'), "    97");
     EXPECT_EQ(String::formatted("{:#x}", L'\U0001F41E'), "0x1f41e");
 }
+
+BENCHMARK_CASE(format_decimal_integers)
+{
+    StringBuilder builder;
+    for (u64 i = 0; i < 1'000'000; ++i) {
+        builder.clear();
+        builder.appendff("{} {}", i, i * 0x9e3779b97f4a7c15ull);
+    }
+    EXPECT(!builder.is_empty());
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Function.h>
+#include <AK/NoAllocationGuard.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+
+TEST_CASE(call)
+{
+    Function<int(int)> add_one = [](int value) { return value + 1; };
+    EXPECT_EQ(add_one(41), 42);
+
+    Function<int(int)> empty;
+    EXPECT(!empty);
+    EXPECT(add_one);
+}
+
+TEST_CASE(four_pointers_are_stored_inline)
+{
+    void* a = nullptr;
+    void* b = nullptr;
+    void* c = nullptr;
+    size_t d = 4;
+    auto lambda = [a, b, c, d] { return (a == b && b == c) ? d : 0; };
+    static_assert(sizeof(lambda) == 4 * sizeof(void*));
+
+    NoAllocationGuard guard;
+    Function<size_t()> function = move(lambda);
+    Function<size_t()> moved = move(function);
+    EXPECT(!function);
+    EXPECT_EQ(moved(), 4u);
+}
+
+TEST_CASE(custom_inline_capacity)
+{
+    static_assert(sizeof(Function<void(), 8 * sizeof(void*)>) > sizeof(Function<void()>));
+
+    u64 a = 1, b = 2, c = 3, d = 4, e = 5, f = 6;
+    NoAllocationGuard guard;
+    Function<u64(), 8 * sizeof(void*)> function = [a, b, c, d, e, f] { return a + b + c + d + e + f; };
+    EXPECT_EQ(function(), 21u);
+}
+
+TEST_CASE(heap_allocated_callable)
+{
+    u64 values[16];
+    for (size_t i = 0; i < 16; ++i)
+        values[i] = i;
+    Function<u64()> function = [values] {
+        u64 sum = 0;
+        for (auto value : values)
+            sum += value;
+        return sum;
+    };
+    Function<u64()> moved = move(function);
+    EXPECT(!function);
+    EXPECT_EQ(moved(), 120u);
+}
+
+TEST_CASE(over_aligned_callable)
+{
+    struct alignas(64) Aligned {
+        int value;
+    };
+    Aligned aligned { 7 };
+    Function<bool()> function = [aligned] { return (reinterpret_cast<FlatPtr>(&aligned) % 64) == 0 && aligned.value == 7; };
+    EXPECT(function());
+}
+
+TEST_CASE(move_only_captures)
+{
+    auto owned = make<Vector<int>>();
+    owned->append(1);
+    owned->append(2);
+    Function<size_t()> function = [owned = move(owned)] { return owned->size(); };
+    Function<size_t()> moved;
+    moved = move(function);
+    EXPECT_EQ(moved(), 2u);
+}
@@ -9,6 +9,7 @@
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(construct)
 {
@@ -309,3 +310,72 @@ TEST_CASE(reinsertion)
     map.remove("__sak");
     map.set("__sak");
 }
+
+static constexpr int benchmark_table_size = 100'000;
+
+BENCHMARK_CASE(benchmark_insert)
+{
+    for (int round = 0; round < 20; ++round) {
+        HashTable<int> table;
+        for (int i = 0; i < benchmark_table_size; ++i)
+            table.set(i);
+        EXPECT_EQ(table.size(), static_cast<size_t>(benchmark_table_size));
+    }
+}
+
+BENCHMARK_CASE(benchmark_lookup_hits)
+{
+    HashTable<int> table;
+    for (int i = 0; i < benchmark_table_size; ++i)
+        table.set(i);
+
+    size_t found = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < benchmark_table_size; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, 50u * benchmark_table_size);
+}
+
+BENCHMARK_CASE(benchmark_lookup_misses)
+{
+    HashTable<int> table;
+    for (int i = 0; i < benchmark_table_size; ++i)
+        table.set(i);
+
+    size_t found = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < benchmark_table_size; ++i)
+            found += table.contains(-i - 1);
+    }
+    EXPECT_EQ(found, 0u);
+}
+
+BENCHMARK_CASE(benchmark_remove)
+{
+    for (int round = 0; round < 20; ++round) {
+        HashTable<int> table;
+        for (int i = 0; i < benchmark_table_size; ++i)
+            table.set(i);
+        for (int i = 0; i < benchmark_table_size; ++i)
+            table.remove(i);
+        EXPECT(table.is_empty());
+    }
+}
+
+BENCHMARK_CASE(benchmark_string_lookups)
+{
+    Vector<String> strings;
+    HashTable<String> table;
+    for (int i = 0; i < benchmark_table_size; ++i) {
+        strings.append(String::formatted("string number {}", i));
+        table.set(strings.last());
+    }
+
+    size_t found = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (auto& string : strings)
+            found += table.contains(string);
+    }
+    EXPECT_EQ(found, 20u * benchmark_table_size);
+}
@@ -7,7 +7,9 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/HashMap.h>
+#include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
 #include <AK/JsonValue.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -134,3 +136,107 @@ TEST_CASE(json_parse_long_decimals)
     auto value = JsonValue::from_string("1644452550.6489999294281"sv);
     EXPECT_EQ(value.value().as_double(), 1644452550.6489999294281);
 }
+
+TEST_CASE(json_parse_escapes)
+{
+    // Long enough to go past the part of strings that's scanned a word at a time.
+    auto value = JsonValue::from_string(R"("a long string with \"escapes\" \\ \/ \n\té and a long tail after them")"sv);
+    EXPECT_EQ(value.value().as_string(), "a long string with \"escapes\" \\ / \n\té and a long tail after them");
+
+    EXPECT(JsonValue::from_string("\"a long string with a\ncontrol character\""sv).is_error());
+    EXPECT(JsonValue::from_string("\"an unterminated long string"sv).is_error());
+    EXPECT(JsonValue::from_string(R"("an unknown escape \q")"sv).is_error());
+    EXPECT(JsonValue::from_string(R"("a truncated escape \u00")"sv).is_error());
+}
+
+class JsonEventRecorder final : public JsonParser::Handler {
+public:
+    StringBuilder events;
+
+    virtual ErrorOr<void> on_object_start() override { return record("{"sv); }
+    virtual ErrorOr<void> on_object_key(StringView key) override { return record(String::formatted("key:{}", key)); }
+    virtual ErrorOr<void> on_object_end() override { return record("}"sv); }
+    virtual ErrorOr<void> on_array_start() override { return record("["sv); }
+    virtual ErrorOr<void> on_array_end() override { return record("]"sv); }
+    virtual ErrorOr<void> on_string(StringView string) override { return record(String::formatted("string:{}", string)); }
+    virtual ErrorOr<void> on_value(JsonValue value) override { return record(value.to_string()); }
+
+private:
+    ErrorOr<void> record(StringView event)
+    {
+        if (!events.is_empty())
+            events.append(' ');
+        events.append(event);
+        return {};
+    }
+};
+
+TEST_CASE(json_parse_with_handler)
+{
+    JsonEventRecorder recorder;
+    auto result = JsonParser(R"({ "name": "Well\nHello", "list": [1, -2.5, true, null, {}], "empty": [] })"sv).parse(recorder);
+    EXPECT(!result.is_error());
+    EXPECT_EQ(recorder.events.string_view(), "{ key:name string:Well\nHello key:list [ 1 -2.5 true null { } ] key:empty [ ] }"sv);
+}
+
+class JsonHandlerThatIgnoresEverything : public JsonParser::Handler {
+public:
+    virtual ErrorOr<void> on_object_start() override { return {}; }
+    virtual ErrorOr<void> on_object_key(StringView) override { return {}; }
+    virtual ErrorOr<void> on_object_end() override { return {}; }
+    virtual ErrorOr<void> on_array_start() override { return {}; }
+    virtual ErrorOr<void> on_array_end() override { return {}; }
+    virtual ErrorOr<void> on_string(StringView) override { return {}; }
+    virtual ErrorOr<void> on_value(JsonValue) override { return {}; }
+};
+
+class JsonHandlerThatGivesUp final : public JsonHandlerThatIgnoresEverything {
+public:
+    size_t values_seen { 0 };
+
+    virtual ErrorOr<void> on_value(JsonValue) override
+    {
+        if (++values_seen == 2)
+            return Error::from_string_literal("Seen enough");
+        return {};
+    }
+};
+
+TEST_CASE(json_parse_with_handler_error)
+{
+    JsonHandlerThatGivesUp handler;
+    auto result = JsonParser("[1, 2, 3, 4]"sv).parse(handler);
+    EXPECT(result.is_error());
+    EXPECT_EQ(handler.values_seen, 2u);
+}
+
+static String make_large_json_document()
+{
+    StringBuilder builder;
+    builder.append('[');
+    for (size_t i = 0; i < 20'000; ++i) {
+        if (i > 0)
+            builder.append(',');
+        builder.appendff(R"({{"id": {}, "name": "Entry number {}", "description": "Nothing \"special\" about it", "tags": ["one", "two", "three"], "enabled": true}})", i, i);
+    }
+    builder.append(']');
+    return builder.build();
+}
+
+BENCHMARK_CASE(json_parse_large_document)
+{
+    auto json = make_large_json_document();
+    for (size_t i = 0; i < 5; ++i) {
+        auto value = JsonValue::from_string(json);
+        EXPECT_EQ(value.value().as_array().size(), 20'000u);
+    }
+}
+
+BENCHMARK_CASE(json_parse_large_document_with_handler)
+{
+    auto json = make_large_json_document();
+    for (size_t i = 0; i < 5; ++i) {
+        JsonHandlerThatIgnoresEverything handler;
+        EXPECT(!JsonParser(json).parse(handler).is_error());
+    }
+}
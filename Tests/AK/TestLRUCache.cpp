@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/LRUCache.h>
+#include <AK/String.h>
+
+TEST_CASE(construct)
+{
+    LRUCache<int, int> cache { 3 };
+    EXPECT(cache.is_empty());
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.capacity(), 3u);
+    EXPECT_EQ(cache.get(1), nullptr);
+}
+
+TEST_CASE(evicts_least_recently_set)
+{
+    LRUCache<int, int> cache { 3 };
+    cache.set(1, 10);
+    cache.set(2, 20);
+    cache.set(3, 30);
+    cache.set(4, 40);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT(!cache.contains(1));
+    EXPECT_EQ(*cache.get(4), 40);
+}
+
+TEST_CASE(hit_makes_entry_most_recently_used)
+{
+    LRUCache<int, int> cache { 3 };
+    cache.set(1, 10);
+    cache.set(2, 20);
+    cache.set(3, 30);
+    EXPECT_EQ(*cache.get(1), 10);
+    cache.set(4, 40);
+    EXPECT(cache.contains(1));
+    EXPECT(!cache.contains(2));
+}
+
+TEST_CASE(replace_existing_entry)
+{
+    LRUCache<int, int> cache { 2 };
+    cache.set(1, 10);
+    cache.set(2, 20);
+    cache.set(1, 11);
+    cache.set(3, 30);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(*cache.get(1), 11);
+    EXPECT(!cache.contains(2));
+}
+
+TEST_CASE(cost_function)
+{
+    LRUCache<String, int> cache { 10, [](auto& key, auto&) { return key.length(); } };
+    cache.set("abcd", 1);
+    cache.set("efgh", 2);
+    EXPECT_EQ(cache.total_cost(), 8u);
+    cache.set("ijkl", 3);
+    EXPECT_EQ(cache.total_cost(), 8u);
+    EXPECT(!cache.contains("abcd"));
+
+    // Entries that don't fit at all are dropped, without evicting anything else.
+    cache.set("this is too long", 4);
+    EXPECT(!cache.contains("this is too long"));
+    EXPECT_EQ(cache.size(), 2u);
+
+    EXPECT_EQ(*cache.get("efgh"sv), 2);
+    EXPECT_EQ(cache.take("efgh"), 2);
+    EXPECT_EQ(cache.total_cost(), 4u);
+}
+
+TEST_CASE(evict_until_within)
+{
+    LRUCache<int, int> cache { 4 };
+    for (int i = 0; i < 4; ++i)
+        cache.set(i, i);
+    cache.evict_until_within(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT(cache.contains(3));
+    EXPECT_EQ(cache.capacity(), 4u);
+
+    cache.set_capacity(0);
+    EXPECT(cache.is_empty());
+    EXPECT_EQ(cache.total_cost(), 0u);
+}
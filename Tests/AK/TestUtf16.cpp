@@ -11,6 +11,7 @@
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf16View.h>
+#include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
 {
@@ -50,6 +51,21 @@ TEST_CASE(decode_utf8)
     EXPECT_EQ(i, expected.size());
 }
 
+TEST_CASE(decode_utf8_with_long_ascii_runs)
+{
+    // Runs of ASCII are converted a word at a time, and everything else a code point at a time, invalid bytes included.
+    auto utf8 = "Hello, well met! Привет, мир! 😀 \xd0 and a long tail of ASCII \xf0\x9f"sv;
+    auto string = AK::utf8_to_utf16(utf8);
+
+    Vector<u16, 1> expected;
+    for (u32 code_point : Utf8View { utf8 })
+        AK::code_point_to_utf16(expected, code_point);
+    EXPECT_EQ(string, expected);
+    EXPECT_EQ(string[0], 'H');
+    EXPECT_EQ(string[17], 1055u);
+    EXPECT_EQ(string.last(), 0xfffdu);
+}
+
 TEST_CASE(encode_utf8)
 {
     {
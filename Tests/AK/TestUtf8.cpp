@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -227,3 +228,59 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+TEST_CASE(long_ascii_runs)
+{
+    // Long enough runs of ASCII are scanned a word at a time, so put the other code points at every alignment.
+    for (size_t prefix_length = 0; prefix_length < 20; ++prefix_length) {
+        StringBuilder builder;
+        for (size_t i = 0; i < prefix_length; ++i)
+            builder.append('a');
+        builder.append("Привет, мир!"sv);
+        for (size_t i = 0; i < prefix_length; ++i)
+            builder.append('b');
+        auto string = builder.build();
+
+        Utf8View utf8 { string };
+        size_t valid_bytes;
+        EXPECT(utf8.validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, string.length());
+        EXPECT_EQ(utf8.length(), prefix_length * 2 + 12);
+
+        size_t i = 0;
+        for (auto code_point : utf8) {
+            if (i < prefix_length)
+                EXPECT_EQ(code_point, (u32)'a');
+            else if (i == prefix_length)
+                EXPECT_EQ(code_point, 0x41Fu);
+            else if (i >= prefix_length + 12)
+                EXPECT_EQ(code_point, (u32)'b');
+            ++i;
+        }
+
+        builder.append((char)0xd0);
+        builder.append("tail of the string"sv);
+        auto invalid_string = builder.build();
+
+        Utf8View invalid_utf8 { invalid_string };
+        EXPECT(!invalid_utf8.validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, string.length());
+        EXPECT_EQ(invalid_utf8.length(), prefix_length * 2 + 12 + 1 + 18);
+    }
+}
+
+BENCHMARK_CASE(validate_and_count_mostly_ascii_text)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 10'000; ++i)
+        builder.append("The quick brown fox jumps over the lazy dog, naïvely. "sv);
+    auto string = builder.build();
+
+    size_t total_length = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        Utf8View utf8 { string };
+        EXPECT(utf8.validate());
+        total_length += utf8.length();
+    }
+    EXPECT_EQ(total_length, 100u * 10'000u * 54u);
+}
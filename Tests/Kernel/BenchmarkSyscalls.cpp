@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr size_t iterations = 100000;
+
+BENCHMARK_CASE(getppid)
+{
+    // Note: LibC caches getpid(), but getppid() goes to the kernel every time, so this measures the bare syscall path.
+    for (size_t i = 0; i < iterations; ++i)
+        EXPECT(getppid() >= 0);
+}
+
+BENCHMARK_CASE(sched_yield)
+{
+    for (size_t i = 0; i < iterations; ++i)
+        sched_yield();
+}
+
+BENCHMARK_CASE(read_dev_zero)
+{
+    int fd = open("/dev/zero", O_RDONLY);
+    EXPECT(fd >= 0);
+    char buffer[4096];
+    for (size_t i = 0; i < iterations; ++i)
+        EXPECT_EQ(read(fd, buffer, sizeof(buffer)), static_cast<ssize_t>(sizeof(buffer)));
+    close(fd);
+}
+
+BENCHMARK_CASE(open_close)
+{
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        int fd = open("/etc/passwd", O_RDONLY);
+        EXPECT(fd >= 0);
+        close(fd);
+    }
+}
+
+BENCHMARK_CASE(stat)
+{
+    struct stat st;
+    for (size_t i = 0; i < iterations / 10; ++i)
+        EXPECT_EQ(stat("/usr/lib", &st), 0);
+}
+
+BENCHMARK_CASE(mmap_munmap)
+{
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        auto* region = mmap(nullptr, 64 * KiB, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        EXPECT(region != MAP_FAILED);
+        munmap(region, 64 * KiB);
+    }
+}
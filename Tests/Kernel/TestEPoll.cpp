@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static int add(int epfd, int fd, u32 events)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event);
+}
+
+TEST_CASE(level_triggered)
+{
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epfd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add(epfd, pipe_fds[0], EPOLLIN), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+    EXPECT_EQ(events[0].events, EPOLLIN);
+
+    // Still readable, so it must be reported again.
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 1);
+
+    char c;
+    EXPECT_EQ(read(pipe_fds[0], &c, 1), 1);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epfd);
+}
+
+TEST_CASE(edge_triggered_and_oneshot)
+{
+    int epfd = epoll_create1(0);
+    EXPECT(epfd >= 0);
+    int edge_fds[2];
+    int oneshot_fds[2];
+    EXPECT_EQ(pipe(edge_fds), 0);
+    EXPECT_EQ(pipe(oneshot_fds), 0);
+    EXPECT_EQ(add(epfd, edge_fds[0], EPOLLIN | EPOLLET), 0);
+    EXPECT_EQ(add(epfd, oneshot_fds[0], EPOLLIN | EPOLLONESHOT), 0);
+
+    EXPECT_EQ(write(edge_fds[1], "x", 1), 1);
+    EXPECT_EQ(write(oneshot_fds[1], "x", 1), 1);
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 2);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 0);
+
+    // New data is a new edge, but the one-shot interest stays disarmed until it's modified.
+    EXPECT_EQ(write(edge_fds[1], "y", 1), 1);
+    EXPECT_EQ(write(oneshot_fds[1], "y", 1), 1);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 1);
+    EXPECT_EQ(events[0].data.fd, edge_fds[0]);
+
+    epoll_event rearm {};
+    rearm.events = EPOLLIN | EPOLLONESHOT;
+    rearm.data.fd = oneshot_fds[0];
+    EXPECT_EQ(epoll_ctl(epfd, EPOLL_CTL_MOD, oneshot_fds[0], &rearm), 0);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 1);
+    EXPECT_EQ(events[0].data.fd, oneshot_fds[0]);
+
+    close(edge_fds[0]);
+    close(edge_fds[1]);
+    close(oneshot_fds[0]);
+    close(oneshot_fds[1]);
+    close(epfd);
+}
+
+TEST_CASE(ctl_errors)
+{
+    int epfd = epoll_create1(0);
+    EXPECT(epfd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(add(epfd, pipe_fds[0], EPOLLIN), 0);
+    EXPECT_EQ(add(epfd, pipe_fds[0], EPOLLIN), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    EXPECT_EQ(epoll_ctl(epfd, EPOLL_CTL_DEL, pipe_fds[1], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    EXPECT_EQ(add(epfd, epfd, EPOLLIN), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(add(pipe_fds[0], pipe_fds[1], EPOLLOUT), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(epoll_ctl(epfd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), 0);
+    epoll_event events[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epfd, events, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epfd);
+}
+
+TEST_CASE(wait_blocks_until_ready)
+{
+    int epfd = epoll_create1(0);
+    EXPECT(epfd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add(epfd, pipe_fds[0], EPOLLIN), 0);
+
+    int child_pid = fork();
+    EXPECT(child_pid >= 0);
+    if (child_pid == 0) {
+        usleep(100'000);
+        (void)write(pipe_fds[1], "x", 1);
+        exit(EXIT_SUCCESS);
+    }
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epfd, events, 4, -1), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epfd);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <Kernel/API/DirectoryEntryWithMetadata.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static HashMap<String, DirectoryEntryWithMetadata> read_entries(int fd, size_t buffer_size = 4096)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(buffer_size));
+    auto size = MUST(Core::System::get_dir_entries_with_metadata(fd, buffer.bytes()));
+
+    HashMap<String, DirectoryEntryWithMetadata> entries;
+    for (size_t offset = 0; offset < size;) {
+        auto const& entry = *reinterpret_cast<DirectoryEntryWithMetadata const*>(buffer.data() + offset);
+        entries.set(String { entry.name, entry.name_length }, entry);
+        offset += entry.total_size();
+    }
+    return entries;
+}
+
+TEST_CASE(entries_come_with_their_metadata)
+{
+    char path[] = "/tmp/dir_entries_test.XXXXXX";
+    EXPECT_NE(mkdtemp(path), nullptr);
+    auto directory = String { path };
+
+    auto file_fd = MUST(Core::System::open(String::formatted("{}/file", directory), O_CREAT | O_WRONLY, 0640));
+    EXPECT_EQ(MUST(Core::System::write(file_fd, "hello friends"sv.bytes())), 13u);
+    MUST(Core::System::close(file_fd));
+    MUST(Core::System::mkdir(String::formatted("{}/subdirectory", directory), 0755));
+    MUST(Core::System::symlink("file"sv, String::formatted("{}/link", directory)));
+
+    auto fd = MUST(Core::System::open(directory, O_RDONLY | O_DIRECTORY));
+    auto entries = read_entries(fd);
+    EXPECT_EQ(entries.size(), 5u);
+
+    for (auto name : { "file"sv, "subdirectory"sv, "link"sv }) {
+        auto entry = entries.get(name);
+        EXPECT(entry.has_value());
+        EXPECT(entry->has_metadata);
+
+        auto expected_metadata = MUST(Core::System::lstat(String::formatted("{}/{}", directory, name)));
+        EXPECT_EQ(entry->inode_index, expected_metadata.st_ino);
+        EXPECT_EQ(entry->metadata.st_ino, expected_metadata.st_ino);
+        EXPECT_EQ(entry->metadata.st_mode, expected_metadata.st_mode);
+        EXPECT_EQ(entry->metadata.st_size, expected_metadata.st_size);
+        EXPECT_EQ(entry->metadata.st_mtim.tv_sec, expected_metadata.st_mtim.tv_sec);
+    }
+    EXPECT_EQ(entries.get("file"sv)->file_type, DT_REG);
+    EXPECT_EQ(entries.get("file"sv)->metadata.st_size, 13);
+    EXPECT_EQ(entries.get("subdirectory"sv)->file_type, DT_DIR);
+    EXPECT_EQ(entries.get("link"sv)->file_type, DT_LNK);
+
+    // A buffer that is too small for all of the entries tells us to try again with a bigger one.
+    auto small_buffer = MUST(ByteBuffer::create_uninitialized(sizeof(DirectoryEntryWithMetadata)));
+    auto result = Core::System::get_dir_entries_with_metadata(fd, small_buffer.bytes());
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    MUST(Core::System::close(fd));
+    MUST(Core::System::unlink(String::formatted("{}/link", directory)));
+    MUST(Core::System::unlink(String::formatted("{}/file", directory)));
+    MUST(Core::System::rmdir(String::formatted("{}/subdirectory", directory)));
+    MUST(Core::System::rmdir(directory));
+}
+
+TEST_CASE(not_a_directory)
+{
+    auto fd = MUST(Core::System::open("/etc/passwd"sv, O_RDONLY));
+    auto buffer = MUST(ByteBuffer::create_uninitialized(4096));
+    auto result = Core::System::get_dir_entries_with_metadata(fd, buffer.bytes());
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), ENOTDIR);
+    MUST(Core::System::close(fd));
+}
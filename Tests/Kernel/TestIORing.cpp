@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IORing.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <unistd.h>
+
+TEST_CASE(nop_and_invalid_fd)
+{
+    auto ring = MUST(Core::IORing::create(4));
+    EXPECT(ring->try_submit_nop(1));
+    Array<u8, 4> buffer {};
+    EXPECT(ring->try_submit_read(-1, buffer, 2));
+    EXPECT_EQ(MUST(ring->enter(2)), 2u);
+
+    auto first = ring->take_completion();
+    EXPECT(first.has_value());
+    EXPECT_EQ(first->user_data, 1u);
+    EXPECT_EQ(first->result, 0);
+
+    auto second = ring->take_completion();
+    EXPECT(second.has_value());
+    EXPECT_EQ(second->user_data, 2u);
+    EXPECT_EQ(second->result, -EBADF);
+
+    EXPECT(!ring->take_completion().has_value());
+}
+
+TEST_CASE(submission_queue_full)
+{
+    auto ring = MUST(Core::IORing::create(2));
+    EXPECT(ring->try_submit_nop(1));
+    EXPECT(ring->try_submit_nop(2));
+    EXPECT(!ring->try_submit_nop(3));
+    EXPECT_EQ(MUST(ring->enter()), 2u);
+    EXPECT(ring->try_submit_nop(3));
+}
+
+TEST_CASE(pending_read_completes_after_write_in_same_batch)
+{
+    auto ring = MUST(Core::IORing::create(4));
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    // The read is parked until the write from the same batch makes the pipe readable.
+    Array<u8, 5> read_buffer {};
+    EXPECT(ring->try_submit_read(pipe_fds[0], read_buffer, 1));
+    EXPECT(ring->try_submit_write(pipe_fds[1], "hello"sv.bytes(), 2));
+    EXPECT_EQ(MUST(ring->enter(2)), 2u);
+
+    auto write_completion = ring->take_completion();
+    EXPECT(write_completion.has_value());
+    EXPECT_EQ(write_completion->user_data, 2u);
+    EXPECT_EQ(write_completion->result, 5);
+
+    auto read_completion = ring->take_completion();
+    EXPECT(read_completion.has_value());
+    EXPECT_EQ(read_completion->user_data, 1u);
+    EXPECT_EQ(read_completion->result, 5);
+    EXPECT_EQ(StringView(read_buffer.span()), "hello"sv);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/QuickSort.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <serenity.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Measures how long common syscalls take, one operation at a time, with any number of threads doing the same thing.
+// The output is one line per operation and thread count, so that the output of two builds can be diffed.
+
+struct Worker;
+
+struct Operation {
+    StringView name;
+    // Expensive operations run this many times fewer iterations.
+    size_t cost { 1 };
+    ErrorOr<void> (*set_up)(Worker&) { nullptr };
+    bool (*run_once)(Worker&) { nullptr };
+    void (*tear_down)(Worker&) { nullptr };
+};
+
+struct Worker {
+    Operation const* operation { nullptr };
+    size_t iterations { 0 };
+    int fds[2] { -1, -1 };
+    pthread_t helper {};
+    u32 futex_word { 0 };
+    char buffer[4096] {};
+    Vector<u64> latencies_in_nanoseconds;
+    int error { 0 };
+};
+
+static u64 now_in_nanoseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+}
+
+static void close_fds(Worker& worker)
+{
+    for (auto& fd : worker.fds) {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+}
+
+static ErrorOr<void> open_dev_zero(Worker& worker)
+{
+    worker.fds[0] = TRY(Core::System::open("/dev/zero"sv, O_RDONLY));
+    return {};
+}
+
+static ErrorOr<void> open_dev_null(Worker& worker)
+{
+    worker.fds[0] = TRY(Core::System::open("/dev/null"sv, O_WRONLY));
+    return {};
+}
+
+// The read end always has a byte in it, so polling it never blocks.
+static ErrorOr<void> open_readable_pipe(Worker& worker)
+{
+    auto fds = TRY(Core::System::pipe2(0));
+    worker.fds[0] = fds[0];
+    worker.fds[1] = fds[1];
+    TRY(Core::System::write(worker.fds[1], "x"sv.bytes()));
+    return {};
+}
+
+static void* echo_helper(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    char byte;
+    while (read(worker.fds[1], &byte, 1) == 1) {
+        if (write(worker.fds[1], &byte, 1) != 1)
+            break;
+    }
+    return nullptr;
+}
+
+static ErrorOr<void> open_local_socket_pair(Worker& worker)
+{
+    TRY(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, worker.fds));
+    if (auto rc = pthread_create(&worker.helper, nullptr, echo_helper, &worker); rc != 0)
+        return Error::from_errno(rc);
+    return {};
+}
+
+static void close_local_socket_pair(Worker& worker)
+{
+    // Note: Shutting down our end makes the helper's read() return 0, after which it exits.
+    shutdown(worker.fds[0], SHUT_RDWR);
+    pthread_join(worker.helper, nullptr);
+    close_fds(worker);
+}
+
+// The futex word is 1 while the helper has work to do, 0 once it's done, and 2 when it should exit.
+static void* futex_helper(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    for (;;) {
+        u32 value;
+        while ((value = AK::atomic_load(&worker.futex_word)) == 0)
+            futex_wait(&worker.futex_word, 0, nullptr, 0, false);
+        if (value == 2)
+            return nullptr;
+        AK::atomic_store(&worker.futex_word, 0u);
+        futex_wake(&worker.futex_word, 1, false);
+    }
+}
+
+static ErrorOr<void> start_futex_helper(Worker& worker)
+{
+    if (auto rc = pthread_create(&worker.helper, nullptr, futex_helper, &worker); rc != 0)
+        return Error::from_errno(rc);
+    return {};
+}
+
+static void stop_futex_helper(Worker& worker)
+{
+    AK::atomic_store(&worker.futex_word, 2u);
+    futex_wake(&worker.futex_word, 1, false);
+    pthread_join(worker.helper, nullptr);
+}
+
+static Operation const s_operations[] = {
+    { "getppid"sv, 1, nullptr, [](Worker&) { return getppid() >= 0; }, nullptr },
+    { "read-4KiB"sv, 1, open_dev_zero, [](Worker& worker) { return read(worker.fds[0], worker.buffer, sizeof(worker.buffer)) == static_cast<ssize_t>(sizeof(worker.buffer)); }, close_fds },
+    { "write-4KiB"sv, 1, open_dev_null, [](Worker& worker) { return write(worker.fds[0], worker.buffer, sizeof(worker.buffer)) == static_cast<ssize_t>(sizeof(worker.buffer)); }, close_fds },
+    { "poll"sv, 1, open_readable_pipe, [](Worker& worker) {
+         struct pollfd pollfd { worker.fds[0], POLLIN, 0 };
+         return poll(&pollfd, 1, -1) == 1;
+     },
+        close_fds },
+    { "select"sv, 1, open_readable_pipe, [](Worker& worker) {
+         fd_set read_fds;
+         FD_ZERO(&read_fds);
+         FD_SET(worker.fds[0], &read_fds);
+         return select(worker.fds[0] + 1, &read_fds, nullptr, nullptr, nullptr) == 1;
+     },
+        close_fds },
+    { "futex-wake"sv, 1, nullptr, [](Worker& worker) { return futex_wake(&worker.futex_word, 1, false) >= 0; }, nullptr },
+    { "futex-roundtrip"sv, 10, start_futex_helper, [](Worker& worker) {
+         AK::atomic_store(&worker.futex_word, 1u);
+         futex_wake(&worker.futex_word, 1, false);
+         while (AK::atomic_load(&worker.futex_word) == 1)
+             futex_wait(&worker.futex_word, 1, nullptr, 0, false);
+         return true;
+     },
+        stop_futex_helper },
+    { "local-socket-roundtrip"sv, 10, open_local_socket_pair, [](Worker& worker) {
+         char byte = 'x';
+         return write(worker.fds[0], &byte, 1) == 1 && read(worker.fds[0], &byte, 1) == 1;
+     },
+        close_local_socket_pair },
+    { "mmap-munmap-64KiB"sv, 10, nullptr, [](Worker&) {
+         auto* region = static_cast<u8*>(mmap(nullptr, 64 * KiB, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+         if (region == MAP_FAILED)
+             return false;
+         // Touch the first page so that this includes a page fault.
+         region[0] = 1;
+         return munmap(region, 64 * KiB) == 0;
+     },
+        nullptr },
+    { "fork-wait"sv, 100, nullptr, [](Worker&) {
+         auto pid = fork();
+         if (pid < 0)
+             return false;
+         if (pid == 0)
+             _exit(0);
+         return waitpid(pid, nullptr, 0) == pid;
+     },
+        nullptr },
+    { "spawn-wait"sv, 100, nullptr, [](Worker&) {
+         char const* argv[] = { "/bin/true", nullptr };
+         pid_t pid;
+         if (posix_spawn(&pid, argv[0], nullptr, nullptr, const_cast<char**>(argv), environ) != 0)
+             return false;
+         return waitpid(pid, nullptr, 0) == pid;
+     },
+        nullptr },
+};
+
+static Atomic<size_t> s_ready_workers;
+static Atomic<bool> s_go;
+
+static void* run_worker(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    auto& operation = *worker.operation;
+
+    ++s_ready_workers;
+    while (!s_go)
+        sched_yield();
+
+    for (size_t i = 0; i < worker.iterations; ++i) {
+        auto start = now_in_nanoseconds();
+        if (!operation.run_once(worker)) {
+            worker.error = errno ? errno : EIO;
+            break;
+        }
+        worker.latencies_in_nanoseconds.unchecked_append(now_in_nanoseconds() - start);
+    }
+    return nullptr;
+}
+
+static ErrorOr<void> run_operation(Operation const& operation, size_t thread_count, size_t iterations)
+{
+    Vector<Worker> workers;
+    TRY(workers.try_resize(thread_count));
+    for (auto& worker : workers) {
+        worker.operation = &operation;
+        worker.iterations = max<size_t>(iterations / operation.cost, 1);
+        TRY(worker.latencies_in_nanoseconds.try_ensure_capacity(worker.iterations));
+        if (operation.set_up)
+            TRY(operation.set_up(worker));
+    }
+
+    s_ready_workers = 0;
+    s_go = false;
+    Vector<pthread_t> threads;
+    TRY(threads.try_resize(thread_count));
+    for (size_t i = 0; i < thread_count; ++i) {
+        if (auto rc = pthread_create(&threads[i], nullptr, run_worker, &workers[i]); rc != 0)
+            return Error::from_errno(rc);
+    }
+    while (s_ready_workers < thread_count)
+        sched_yield();
+
+    auto start = now_in_nanoseconds();
+    s_go = true;
+    for (auto thread : threads)
+        pthread_join(thread, nullptr);
+    auto elapsed = max<u64>(now_in_nanoseconds() - start, 1);
+
+    Vector<u64> latencies;
+    int error = 0;
+    for (auto& worker : workers) {
+        if (worker.error)
+            error = worker.error;
+        TRY(latencies.try_extend(worker.latencies_in_nanoseconds));
+        if (operation.tear_down)
+            operation.tear_down(worker);
+    }
+    if (error)
+        return Error::from_errno(error);
+
+    quick_sort(latencies);
+    auto percentile = [&](size_t percent) {
+        return latencies[min(latencies.size() - 1, latencies.size() * percent / 100)];
+    };
+    outln("{:<24} {:>7} {:>12} {:>10} {:>10} {:>10} {:>12}", operation.name, thread_count,
+        latencies.size() * 1'000'000'000 / elapsed, percentile(50), percentile(90), percentile(99), latencies.last());
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    size_t iterations = 10000;
+    Vector<size_t> thread_counts;
+    Vector<StringView> operation_names;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure the latency and throughput of common syscalls.");
+    args_parser.add_option(iterations, "Number of times each thread runs a cheap operation", "iterations", 'n', "count");
+    args_parser.add_option(thread_counts, "Comma-separated numbers of threads to run each operation on (default: 1, 2, 4, ... up to the number of CPUs)", "threads", 't', "counts");
+    args_parser.add_positional_argument(operation_names, "Only run these operations", "operation", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    auto cpu_count = max<long>(sysconf(_SC_NPROCESSORS_ONLN), 1);
+    if (thread_counts.is_empty()) {
+        for (size_t count = 1; count < static_cast<size_t>(cpu_count); count *= 2)
+            thread_counts.append(count);
+        thread_counts.append(cpu_count);
+    }
+
+    outln("# {} CPUs, {} iterations per thread, latencies in ns", cpu_count, iterations);
+    outln("{:<24} {:>7} {:>12} {:>10} {:>10} {:>10} {:>12}", "# operation", "threads", "ops/s", "p50", "p90", "p99", "max");
+
+    int failures = 0;
+    for (auto const& operation : s_operations) {
+        if (!operation_names.is_empty() && !operation_names.contains_slow(operation.name))
+            continue;
+        for (auto thread_count : thread_counts) {
+            if (thread_count == 0)
+                continue;
+            if (auto result = run_operation(operation, thread_count, iterations); result.is_error()) {
+                warnln("{} on {} threads failed: {}", operation.name, thread_count, result.error());
+                ++failures;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
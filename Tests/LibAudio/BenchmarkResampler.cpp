@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/FixedArray.h>
+#include <AK/Math.h>
+#include <LibAudio/Resampler.h>
+#include <LibAudio/SampleFormats.h>
+#include <LibCore/ElapsedTimer.h>
+
+// Ten seconds of audio, which is played back in chunks of about a tenth of a second.
+static constexpr u32 seconds = 10;
+static constexpr size_t chunk_size = 4096;
+
+static FixedArray<Audio::Sample> test_signal(u32 sample_rate)
+{
+    auto signal = MUST(FixedArray<Audio::Sample>::try_create(sample_rate * seconds));
+    for (size_t i = 0; i < signal.size(); ++i) {
+        auto time = static_cast<float>(i) / sample_rate;
+        signal[i] = { AK::sin(2 * AK::Pi<float> * 440 * time) * 0.4f, AK::sin(2 * AK::Pi<float> * 1234 * time) * 0.4f };
+    }
+    return signal;
+}
+
+static void resample(u32 source, u32 target)
+{
+    auto signal = test_signal(source);
+    auto resampler = MUST(Audio::SincResampler::try_create(source, target));
+
+    auto timer = Core::ElapsedTimer::start_new();
+    size_t output_samples = 0;
+    for (size_t i = 0; i < signal.size(); i += chunk_size) {
+        auto resampled = MUST(resampler.resample(signal.span().slice(i, min(chunk_size, signal.size() - i))));
+        output_samples += resampled.size();
+    }
+    auto elapsed_milliseconds = max(timer.elapsed(), 1);
+    EXPECT(output_samples > 0);
+    outln("{} Hz to {} Hz: {}x realtime", source, target, seconds * 1000 / elapsed_milliseconds);
+}
+
+BENCHMARK_CASE(resample_44100_to_48000)
+{
+    resample(44100, 48000);
+}
+
+BENCHMARK_CASE(resample_96000_to_48000)
+{
+    resample(96000, 48000);
+}
+
+BENCHMARK_CASE(resample_192000_to_44100)
+{
+    resample(192000, 44100);
+}
+
+static void convert(Audio::PcmSampleFormat format)
+{
+    constexpr size_t sample_count = 48000 * seconds;
+    auto data = MUST(ByteBuffer::create_zeroed(sample_count * 2 * Audio::pcm_bits_per_sample(format) / 8));
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<u8>(i * 7);
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(sample_count));
+
+    auto timer = Core::ElapsedTimer::start_new();
+    Audio::convert_pcm_to_samples(format, 2, data, samples.span());
+    auto elapsed_milliseconds = max(timer.elapsed(), 1);
+    outln("{}: {} MB/s", Audio::sample_format_name(format), data.size() / 1000 / elapsed_milliseconds);
+}
+
+BENCHMARK_CASE(convert_int16)
+{
+    convert(Audio::PcmSampleFormat::Int16);
+}
+
+BENCHMARK_CASE(convert_int24)
+{
+    convert(Audio::PcmSampleFormat::Int24);
+}
+
+BENCHMARK_CASE(convert_float32)
+{
+    convert(Audio::PcmSampleFormat::Float32);
+}
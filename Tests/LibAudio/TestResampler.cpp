@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Math.h>
+#include <AK/Vector.h>
+#include <LibAudio/Resampler.h>
+
+static Vector<Audio::Sample> sine(float frequency, u32 sample_rate, size_t count)
+{
+    Vector<Audio::Sample> samples;
+    for (size_t i = 0; i < count; ++i) {
+        auto value = AK::sin(2 * AK::Pi<float> * frequency * i / sample_rate) * 0.5f;
+        samples.append({ value, -value });
+    }
+    return samples;
+}
+
+static Vector<Audio::Sample> resample_in_chunks(Audio::SincResampler& resampler, Span<Audio::Sample const> samples, size_t chunk_size)
+{
+    Vector<Audio::Sample> resampled;
+    while (!samples.is_empty()) {
+        auto chunk = samples.trim(chunk_size);
+        auto output = MUST(resampler.resample(chunk));
+        resampled.extend(Vector<Audio::Sample> { output.span() });
+        samples = samples.slice(chunk.size());
+    }
+    return resampled;
+}
+
+TEST_CASE(same_rate_passes_samples_through)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(48000, 48000));
+    auto input = sine(1000, 48000, 100);
+    auto output = MUST(resampler.resample(input));
+    EXPECT_EQ(output.size(), input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+        EXPECT_EQ(output[i].left, input[i].left);
+}
+
+TEST_CASE(output_length_follows_rate_ratio)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+    auto input = sine(440, 44100, 44100);
+    auto output = resample_in_chunks(resampler, input, 1000);
+    // Apart from the samples held back for the filter, one second of input gives one second of output.
+    EXPECT(output.size() <= 48000u);
+    EXPECT(output.size() > 48000u - 64);
+}
+
+TEST_CASE(constant_signal_stays_constant)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+    Vector<Audio::Sample> input;
+    for (size_t i = 0; i < 4410; ++i)
+        input.append({ 0.25f, -0.25f });
+    auto output = resample_in_chunks(resampler, input, 441);
+    // Skip the start, where the filter still sees the silence before the first sample.
+    for (size_t i = 100; i < output.size(); ++i) {
+        EXPECT_APPROXIMATE(output[i].left, 0.25f);
+        EXPECT_APPROXIMATE(output[i].right, -0.25f);
+    }
+}
+
+TEST_CASE(sine_keeps_its_shape)
+{
+    struct Rates {
+        u32 source;
+        u32 target;
+    };
+    for (auto [source, target] : Array<Rates, 3> { Rates { 44100, 48000 }, Rates { 96000, 48000 }, Rates { 48000, 44101 } }) {
+        auto resampler = MUST(Audio::SincResampler::try_create(source, target));
+        auto input = sine(1000, source, source / 10);
+        auto output = resample_in_chunks(resampler, input, 777);
+
+        // The filter delays everything by the samples it holds back, which we find by trying out all the delays.
+        float smallest_error = NumericLimits<float>::max();
+        for (size_t delay = 0; delay < 128; ++delay) {
+            float error = 0;
+            for (size_t i = 200; i + delay < output.size(); ++i) {
+                auto expected = AK::sin(2 * AK::Pi<float> * 1000 * i / target) * 0.5f;
+                error = max(error, AK::fabs(output[i + delay].left - expected));
+            }
+            smallest_error = min(smallest_error, error);
+        }
+        EXPECT(smallest_error < 0.01f);
+    }
+}
+
+TEST_CASE(frequencies_above_new_nyquist_are_removed)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(96000, 48000));
+    // This would alias down to 12 kHz if it was just decimated.
+    auto input = sine(36000, 96000, 9600);
+    auto output = resample_in_chunks(resampler, input, 1024);
+    for (size_t i = 100; i < output.size(); ++i)
+        EXPECT(AK::fabs(output[i].left) < 0.01f);
+}
+
+TEST_CASE(reset_forgets_previous_input)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+    auto input = sine(440, 44100, 1000);
+    auto first = MUST(resampler.resample(input));
+    resampler.reset();
+    auto second = MUST(resampler.resample(input));
+    EXPECT_EQ(first.size(), second.size());
+    for (size_t i = 0; i < first.size(); ++i)
+        EXPECT_EQ(first[i].left, second[i].left);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/FixedArray.h>
+#include <LibAudio/SampleFormats.h>
+
+// Negative values reach all the way to -1, so the largest positive ones fall just short of 1.
+static constexpr float int16_max = 32767.0f / 32768.0f;
+
+TEST_CASE(int16_stereo)
+{
+    // Enough samples to go through both the vector loop and the tail.
+    Array<u8, 20> data { 0x00, 0x00, 0xff, 0x7f, 0x00, 0x80, 0x00, 0x40, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x20, 0x00, 0xe0, 0xff, 0x7f, 0x00, 0x80 };
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(5));
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Int16, 2, data, samples.span());
+    Array<float, 10> expected { 0.0f, int16_max, -1.0f, 0.5f, -0.5f, 0.0f, 0.25f, -0.25f, int16_max, -1.0f };
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_APPROXIMATE(samples[i].left, expected[i * 2]);
+        EXPECT_APPROXIMATE(samples[i].right, expected[i * 2 + 1]);
+    }
+}
+
+TEST_CASE(int16_mono_goes_to_both_channels)
+{
+    Array<u8, 14> data { 0x00, 0x40, 0x00, 0xc0, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x80, 0x00, 0x20, 0x00, 0xe0 };
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(7));
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Int16, 1, data, samples.span());
+    Array<float, 7> expected { 0.5f, -0.5f, 0.0f, int16_max, -1.0f, 0.25f, -0.25f };
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_APPROXIMATE(samples[i].left, expected[i]);
+        EXPECT_APPROXIMATE(samples[i].right, expected[i]);
+    }
+}
+
+TEST_CASE(int24)
+{
+    Array<u8, 15> data { 0x00, 0x00, 0x40, 0x00, 0x00, 0xc0, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00 };
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(5));
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Int24, 1, data, samples.span());
+    Array<float, 5> expected { 0.5f, -0.5f, 1.0f, -1.0f, 0.0f };
+    for (size_t i = 0; i < samples.size(); ++i)
+        EXPECT_APPROXIMATE(samples[i].left, expected[i]);
+}
+
+TEST_CASE(uint8_is_centered_on_128)
+{
+    Array<u8, 4> data { 0x80, 0x00, 0xc0, 0x40 };
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(2));
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Uint8, 2, data, samples.span());
+    EXPECT_APPROXIMATE(samples[0].left, 0.0f);
+    EXPECT_APPROXIMATE(samples[0].right, -1.0f);
+    EXPECT_APPROXIMATE(samples[1].left, 0.5f);
+    EXPECT_APPROXIMATE(samples[1].right, -0.5f);
+}
+
+TEST_CASE(float32_and_float64)
+{
+    Array<float, 4> floats { 0.5f, -0.25f, 1.0f, 0.0f };
+    auto samples = MUST(FixedArray<Audio::Sample>::try_create(2));
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Float32, 2, { floats.data(), sizeof(floats) }, samples.span());
+    EXPECT_EQ(samples[0].left, 0.5f);
+    EXPECT_EQ(samples[0].right, -0.25f);
+    EXPECT_EQ(samples[1].left, 1.0f);
+
+    Array<double, 2> doubles { -0.75, 0.125 };
+    Audio::convert_pcm_to_samples(Audio::PcmSampleFormat::Float64, 1, { doubles.data(), sizeof(doubles) }, samples.span());
+    EXPECT_EQ(samples[0].left, -0.75f);
+    EXPECT_EQ(samples[0].right, -0.75f);
+    EXPECT_EQ(samples[1].right, 0.125f);
+}
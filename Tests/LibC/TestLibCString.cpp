@@ -29,3 +29,147 @@ TEST_CASE(strtok_r_delimiters_only)
     // The string to which `saved_str` initially points to shouldn't be modified.
     EXPECT_EQ(strcmp(dummy, "a;"), 0);
 }
+
+static constexpr size_t buffer_size = 16 * KiB;
+
+static void fill_with_pattern(u8* buffer, size_t size, u8 seed)
+{
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = static_cast<u8>(i * 7 + seed);
+}
+
+TEST_CASE(memcpy_sizes_and_alignments)
+{
+    static u8 source[buffer_size];
+    static u8 destination[buffer_size];
+    fill_with_pattern(source, buffer_size, 1);
+
+    // Cover the small sizes, the boundaries between the different copy strategies, and unaligned ends.
+    static constexpr size_t sizes[] = { 0, 1, 2, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255, 256, 1000, 2047, 2048, 4099, 8192 };
+    for (size_t size : sizes) {
+        for (size_t source_offset = 0; source_offset < 33; source_offset += 5) {
+            for (size_t destination_offset = 0; destination_offset < 33; destination_offset += 3) {
+                memset(destination, 0xcc, buffer_size);
+                EXPECT_EQ(memcpy(destination + destination_offset, source + source_offset, size), destination + destination_offset);
+                EXPECT_EQ(memcmp(destination + destination_offset, source + source_offset, size), 0);
+                for (size_t i = 0; i < destination_offset; ++i)
+                    EXPECT_EQ(destination[i], 0xcc);
+                EXPECT_EQ(destination[destination_offset + size], 0xcc);
+            }
+        }
+    }
+}
+
+TEST_CASE(memcpy_huge)
+{
+    static constexpr size_t size = 5 * MiB + 3;
+    auto* source = static_cast<u8*>(malloc(size));
+    auto* destination = static_cast<u8*>(malloc(size + 1));
+    fill_with_pattern(source, size, 3);
+    destination[size] = 0xcc;
+
+    memcpy(destination + 1, source, size - 1);
+    EXPECT_EQ(memcmp(destination + 1, source, size - 1), 0);
+    EXPECT_EQ(destination[size], 0xcc);
+
+    free(source);
+    free(destination);
+}
+
+TEST_CASE(memmove_forward_overlap)
+{
+    static u8 buffer[buffer_size];
+    static u8 expected[buffer_size];
+    static constexpr size_t sizes[] = { 5, 40, 100, 300, 5000 };
+    static constexpr size_t distances[] = { 1, 7, 16, 33, 200 };
+    for (size_t size : sizes) {
+        for (size_t distance : distances) {
+            fill_with_pattern(buffer, buffer_size, 5);
+            fill_with_pattern(expected, buffer_size, 5);
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = expected[i + distance];
+
+            memmove(buffer, buffer + distance, size);
+            EXPECT_EQ(memcmp(buffer, expected, size + distance), 0);
+        }
+    }
+}
+
+TEST_CASE(memcmp_finds_first_difference)
+{
+    u8 a[64];
+    u8 b[64];
+    fill_with_pattern(a, sizeof(a), 0);
+    for (size_t position = 0; position < sizeof(a); ++position) {
+        memcpy(b, a, sizeof(b));
+        b[position] = a[position] + 1;
+        if (position + 1 < sizeof(b))
+            b[position + 1] = a[position + 1] - 1;
+        EXPECT(memcmp(a, b, sizeof(a)) < 0);
+        EXPECT(memcmp(b, a, sizeof(a)) > 0);
+        EXPECT_EQ(memcmp(a, b, position), 0);
+    }
+}
+
+TEST_CASE(strlen_alignments)
+{
+    char buffer[256];
+    for (size_t start = 0; start < 32; ++start) {
+        for (size_t length = 0; length < 100; ++length) {
+            memset(buffer, 'a', sizeof(buffer));
+            buffer[start + length] = '\0';
+            EXPECT_EQ(strlen(buffer + start), length);
+        }
+    }
+}
+
+// The sizes are passed through a volatile so the compiler can't turn the calls into inline copies.
+static void benchmark_memcpy(size_t size, size_t iterations)
+{
+    static u8 source[buffer_size + 64];
+    static u8 destination[buffer_size + 64];
+    size_t volatile volatile_size = size;
+    for (size_t i = 0; i < iterations; ++i)
+        memcpy(destination + (i & 7), source + (i & 15), volatile_size);
+}
+
+BENCHMARK_CASE(memcpy_small)
+{
+    for (size_t size = 1; size <= 64; ++size)
+        benchmark_memcpy(size, 200'000);
+}
+
+BENCHMARK_CASE(memcpy_medium)
+{
+    for (size_t size = 128; size <= buffer_size; size *= 2)
+        benchmark_memcpy(size, 200'000);
+}
+
+BENCHMARK_CASE(memset_small)
+{
+    static u8 destination[128];
+    for (size_t size = 1; size <= 64; ++size) {
+        size_t volatile volatile_size = size;
+        for (size_t i = 0; i < 200'000; ++i)
+            memset(destination + (i & 7), static_cast<int>(i), volatile_size);
+    }
+}
+
+BENCHMARK_CASE(memcmp_equal)
+{
+    static u8 a[buffer_size];
+    static u8 b[buffer_size];
+    size_t volatile volatile_size = buffer_size;
+    for (size_t i = 0; i < 10'000; ++i)
+        EXPECT_EQ(memcmp(a, b, volatile_size), 0);
+}
+
+BENCHMARK_CASE(strlen_short_and_long)
+{
+    static char string[buffer_size];
+    memset(string, 'a', sizeof(string) - 1);
+    for (size_t i = 0; i < 10'000; ++i) {
+        EXPECT_EQ(strlen(string + sizeof(string) - 1 - (i & 31)), i & 31);
+        EXPECT_EQ(strlen(string + (i & 15)), sizeof(string) - 1 - (i & 15));
+    }
+}
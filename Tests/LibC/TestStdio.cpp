@@ -6,6 +6,8 @@
 
 #include <LibTest/TestCase.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -54,3 +56,40 @@ TEST_CASE(sprintf_sign)
     EXPECT_EQ(buf1, "+12"sv);
     EXPECT_EQ(buf2, "-12"sv);
 }
+
+// Lines and reads that are longer than the stdio buffer go around it, and the buffer grows as it keeps filling up.
+TEST_CASE(long_lines_and_large_reads)
+{
+    static constexpr size_t long_line_length = 100000;
+    auto* fp = fopen("/tmp/longlinetest", "w+");
+    VERIFY(fp != nullptr);
+
+    fputs("short\n", fp);
+    for (size_t i = 0; i < long_line_length; ++i)
+        fputc('a' + i % 26, fp);
+    fputs("\nlast", fp);
+    rewind(fp);
+
+    char* line = nullptr;
+    size_t line_size = 0;
+    EXPECT_EQ(getline(&line, &line_size, fp), 6);
+    EXPECT_EQ(line, "short\n"sv);
+    EXPECT_EQ(getline(&line, &line_size, fp), static_cast<ssize_t>(long_line_length + 1));
+    EXPECT_EQ(line[long_line_length - 1], static_cast<char>('a' + (long_line_length - 1) % 26));
+    EXPECT_EQ(line[long_line_length], '\n');
+    EXPECT_EQ(getline(&line, &line_size, fp), 4);
+    EXPECT_EQ(line, "last"sv);
+    EXPECT_EQ(getline(&line, &line_size, fp), -1);
+    free(line);
+
+    rewind(fp);
+    auto* buffer = static_cast<char*>(malloc(long_line_length));
+    VERIFY(buffer != nullptr);
+    EXPECT_EQ(fgetc(fp), 's');
+    EXPECT_EQ(fread(buffer, 1, long_line_length, fp), long_line_length);
+    EXPECT_EQ(memcmp(buffer, "hort\nabc", 8), 0);
+    free(buffer);
+
+    fclose(fp);
+    unlink("/tmp/longlinetest");
+}
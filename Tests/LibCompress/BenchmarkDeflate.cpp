@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <AK/StringBuilder.h>
+#include <LibCompress/Deflate.h>
+#include <LibCore/ElapsedTimer.h>
+
+// Something resembling a system log, which compresses about as well as typical text does.
+static ByteBuffer const& log_like_data()
+{
+    static ByteBuffer data;
+    if (!data.is_empty())
+        return data;
+
+    constexpr StringView services[] = { "WindowServer"sv, "LookupServer"sv, "RequestServer"sv, "ImageDecoder"sv };
+    constexpr StringView messages[] = { "Client connected"sv, "Request finished with status 200"sv, "Compositing took"sv, "Resolved name"sv };
+    u32 state = 1;
+    auto next_random = [&](u32 limit) {
+        state = state * 1103515245 + 12345;
+        return (state >> 16) % limit;
+    };
+
+    StringBuilder builder;
+    while (builder.length() < 4 * MiB) {
+        builder.appendff("2022-10-{:02} 12:{:02}:{:02} {}({}): {} {}\n", next_random(28) + 1, next_random(60), next_random(60),
+            services[next_random(4)], next_random(90) + 10, messages[next_random(4)], next_random(100000));
+    }
+    data = builder.to_byte_buffer();
+    return data;
+}
+
+static void compress_with_level(int level)
+{
+    auto const& data = log_like_data();
+    auto timer = Core::ElapsedTimer::start_new();
+    auto compressed = Compress::DeflateCompressor::compress_all(data, static_cast<Compress::DeflateCompressor::CompressionLevel>(level));
+    auto elapsed_milliseconds = max(timer.elapsed(), 1);
+    EXPECT(compressed.has_value());
+    outln("Level {}: compressed to {:.1}% at {} MB/s", level, 100.0 * compressed->size() / data.size(), data.size() / 1000 / elapsed_milliseconds);
+}
+
+BENCHMARK_CASE(compress_level_1)
+{
+    compress_with_level(1);
+}
+
+BENCHMARK_CASE(compress_level_4)
+{
+    compress_with_level(4);
+}
+
+BENCHMARK_CASE(compress_level_6)
+{
+    compress_with_level(6);
+}
+
+BENCHMARK_CASE(compress_level_9)
+{
+    compress_with_level(9);
+}
+
+BENCHMARK_CASE(decompress)
+{
+    auto const& data = log_like_data();
+    auto compressed = Compress::DeflateCompressor::compress_all(data, Compress::DeflateCompressor::CompressionLevel::GOOD);
+    EXPECT(compressed.has_value());
+
+    auto timer = Core::ElapsedTimer::start_new();
+    auto decompressed = Compress::DeflateDecompressor::decompress_all(*compressed);
+    auto elapsed_milliseconds = max(timer.elapsed(), 1);
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed->bytes() == data.bytes());
+    outln("Decompressed at {} MB/s", data.size() / 1000 / elapsed_milliseconds);
+}
@@ -27,11 +27,15 @@ TEST_CASE(canonical_code_simple)
     };
 
     auto const huffman = Compress::CanonicalCode::from_bytes(code).value();
-    auto memory_stream = InputMemoryStream { input };
-    auto bit_stream = InputBitStream { memory_stream };
-
-    for (size_t idx = 0; idx < 9; ++idx)
-        EXPECT_EQ(huffman.read_symbol(bit_stream), output[idx]);
+    u64 bits = 0;
+    for (size_t idx = 0; idx < input.size(); ++idx)
+        bits |= static_cast<u64>(input[idx]) << (idx * 8);
+
+    for (size_t idx = 0; idx < 9; ++idx) {
+        auto const entry = huffman.decode_symbol(bits);
+        EXPECT_EQ(entry & 0xffff, output[idx]);
+        bits >>= entry >> 16;
+    }
 }
 
 TEST_CASE(canonical_code_complex)
@@ -47,11 +51,31 @@ TEST_CASE(canonical_code_complex)
     };
 
     auto const huffman = Compress::CanonicalCode::from_bytes(code).value();
-    auto memory_stream = InputMemoryStream { input };
-    auto bit_stream = InputBitStream { memory_stream };
+    u64 bits = 0;
+    for (size_t idx = 0; idx < input.size(); ++idx)
+        bits |= static_cast<u64>(input[idx]) << (idx * 8);
+
+    for (size_t idx = 0; idx < 12; ++idx) {
+        auto const entry = huffman.decode_symbol(bits);
+        EXPECT_EQ(entry & 0xffff, output[idx]);
+        bits >>= entry >> 16;
+    }
+}
+
+TEST_CASE(canonical_code_long_codes)
+{
+    // Codes of every length up to 15, most of which don't fit the primary lookup table
+    Array<u8, 16> const code {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15
+    };
 
-    for (size_t idx = 0; idx < 12; ++idx)
-        EXPECT_EQ(huffman.read_symbol(bit_stream), output[idx]);
+    auto const huffman = Compress::CanonicalCode::from_bytes(code).value();
+    for (u32 symbol = 0; symbol < code.size(); ++symbol) {
+        // Symbol n < 15 is encoded as n one bits followed by a zero bit, symbol 15 as 15 one bits
+        u32 const length = code[symbol];
+        u64 const bits = (symbol == 15 ? 0x7fff : (1ull << symbol) - 1) | (0xdeadbeefull << length);
+        EXPECT_EQ(huffman.decode_symbol(bits), length << 16 | symbol);
+    }
 }
 
 TEST_CASE(deflate_decompress_compressed_block)
@@ -98,6 +122,28 @@ TEST_CASE(deflate_decompress_multiple_blocks)
     EXPECT(decompressed.value().bytes() == (ReadonlyBytes { uncompressed, sizeof(uncompressed) - 1 }));
 }
 
+TEST_CASE(deflate_decompress_flushed_streams_sharing_history)
+{
+    // Two "Hello" messages compressed with permessage-deflate, with context takeover (RFC 7692 section 7.2.3.2)
+    Array<u8, 11> const first_message { 0xf2, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00, 0x00, 0x00, 0xff, 0xff };
+    Array<u8, 9> const second_message { 0xf2, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff };
+    u8 output[16];
+
+    InputMemoryStream first_stream { first_message };
+    Compress::DeflateDecompressor first_decompressor { first_stream };
+    auto first_size = first_decompressor.read({ output, sizeof(output) });
+    EXPECT_EQ(StringView(output, first_size), "Hello"sv);
+    EXPECT(first_decompressor.handle_any_error());
+    EXPECT(first_decompressor.ended_on_block_boundary());
+
+    InputMemoryStream second_stream { second_message };
+    Compress::DeflateDecompressor second_decompressor { second_stream };
+    second_decompressor.set_history("Hello"sv.bytes());
+    auto second_size = second_decompressor.read({ output, sizeof(output) });
+    EXPECT_EQ(StringView(output, second_size), "Hello"sv);
+    EXPECT(second_decompressor.ended_on_block_boundary());
+}
+
 TEST_CASE(deflate_decompress_zeroes)
 {
     Array<u8, 20> const compressed {
@@ -154,3 +200,23 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(compressed.has_value());
 }
+
+TEST_CASE(deflate_round_trip_all_levels)
+{
+    // Random data that repeats itself at distances both within a block and across blocks, as well as beyond the maximum distance
+    auto size = Compress::DeflateCompressor::block_size * 5;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(original.data(), 40000);
+    for (size_t i = 40000; i < size; i++)
+        original[i] = (i % 7 == 0) ? get_random<u8>() : original[i - (i % 3 == 0 ? 40000 : 30000)];
+
+    for (int level = 0; level <= 10; level++) {
+        auto compressed = Compress::DeflateCompressor::compress_all(original, static_cast<Compress::DeflateCompressor::CompressionLevel>(level));
+        EXPECT(compressed.has_value());
+        if (level > 0)
+            EXPECT(compressed->size() < size);
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
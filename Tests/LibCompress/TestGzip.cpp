@@ -95,3 +95,38 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_round_trip_chunked)
+{
+    // Repetitive data, so that chunks refer back into the chunks before them
+    auto original = ByteBuffer::create_uninitialized(200 * KiB).release_value();
+    fill_with_random(original.data(), 8 * KiB);
+    for (size_t i = 8 * KiB; i < original.size(); ++i)
+        original[i] = original[i % (8 * KiB)] ^ (i % 1021 == 0);
+
+    Compress::ChunkedGzipCompressor compressor { original, Compress::DeflateCompressor::CompressionLevel::GOOD, 16 * KiB };
+    EXPECT_EQ(compressor.chunk_count(), 13u);
+    // Chunks can be compressed in any order
+    for (size_t i = compressor.chunk_count(); i > 0; --i)
+        compressor.compress_chunk(i - 1);
+    auto compressed = compressor.finish();
+    EXPECT(compressed.has_value());
+    EXPECT(compressed->size() < 20 * KiB);
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(gzip_round_trip_chunked_empty)
+{
+    Compress::ChunkedGzipCompressor compressor { ReadonlyBytes {} };
+    EXPECT_EQ(compressor.chunk_count(), 1u);
+    compressor.compress_chunk(0);
+    auto compressed = compressor.finish();
+    EXPECT(compressed.has_value());
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed->is_empty());
+}
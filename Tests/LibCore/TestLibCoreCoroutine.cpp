@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibCore/Coroutine.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static Core::Coroutine<int> forty_two()
+{
+    co_return 42;
+}
+
+static Core::Coroutine<int> add_one_later()
+{
+    co_await Core::sleep_for(1);
+    auto value = co_await forty_two();
+    co_return value + 1;
+}
+
+TEST_CASE(await_nested_coroutines)
+{
+    Core::EventLoop loop;
+    auto coroutine = add_one_later();
+    EXPECT(!coroutine.is_done());
+    EXPECT_EQ(coroutine.await(), 43);
+}
+
+// NOTE: Coroutines keep references to their arguments, but not to the captures of a lambda, so the tests use functions.
+static Core::Coroutine<void> count_steps(int& steps)
+{
+    ++steps;
+    co_await Core::sleep_for(1);
+    ++steps;
+}
+
+TEST_CASE(coroutines_run_until_they_first_wait)
+{
+    Core::EventLoop loop;
+    int steps = 0;
+    auto coroutine = count_steps(steps);
+    EXPECT_EQ(steps, 1);
+    coroutine.await();
+    EXPECT_EQ(steps, 2);
+}
+
+static Core::Coroutine<ErrorOr<size_t>> read_everything(Core::Stream::LocalSocket& socket)
+{
+    Array<u8, 16> buffer;
+    size_t total = 0;
+    while (true) {
+        auto result = co_await Core::read_some(socket, buffer);
+        if (result.is_error())
+            co_return result.release_error();
+        if (result.value().is_empty())
+            co_return total;
+        total += result.value().size();
+    }
+}
+
+static Core::Coroutine<void> write_and_close(Core::Stream::LocalSocket& socket, ReadonlyBytes data)
+{
+    co_await Core::sleep_for(1);
+    auto result = co_await Core::write_all(socket, data);
+    EXPECT(!result.is_error());
+    socket.close();
+}
+
+TEST_CASE(read_and_write_sockets)
+{
+    Core::EventLoop loop;
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    auto reader = MUST(Core::Stream::LocalSocket::adopt_fd(fds[0]));
+    auto writer = MUST(Core::Stream::LocalSocket::adopt_fd(fds[1]));
+    MUST(writer->set_blocking(false));
+
+    auto reading = read_everything(*reader);
+    EXPECT(!reading.is_done());
+
+    Array<u8, 100> data;
+    data.fill('x');
+    auto writing = write_and_close(*writer, data);
+
+    writing.await();
+    auto result = reading.await();
+    EXPECT(!result.is_error());
+    EXPECT_EQ(result.value(), data.size());
+}
+
+TEST_CASE(destroying_a_waiting_coroutine)
+{
+    Core::EventLoop loop;
+    int steps = 0;
+    {
+        auto coroutine = count_steps(steps);
+    }
+
+    auto timer = Core::Timer::create_single_shot(10, [&] { loop.quit(0); });
+    timer->start();
+    loop.exec();
+    EXPECT_EQ(steps, 1);
+}
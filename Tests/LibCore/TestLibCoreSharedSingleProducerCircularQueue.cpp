@@ -181,6 +181,49 @@ TEST_CASE(single_producer_multi_consumer)
     EXPECT_EQ(dequeue_count.load(), (size_t)test_count);
 }
 
+// Like producer_consumer_multithread, but both sides sleep instead of spinning.
+TEST_CASE(blocking_producer_consumer)
+{
+    auto queue = MUST(TestQueue::try_create());
+    auto const test_count = queue.size() * 4;
+
+    auto second_thread = Threading::Thread::construct([&queue]() {
+        auto copied_queue = queue;
+        for (size_t i = 0; i < test_count; ++i) {
+            auto result = copied_queue.blocking_dequeue();
+            if (result.is_error())
+                FAIL("Unexpected error while dequeueing.");
+            else
+                EXPECT_EQ(result.value(), (int)i);
+        }
+        return 0;
+    });
+    second_thread->start();
+
+    for (size_t i = 0; i < test_count; ++i) {
+        if (queue.blocking_enqueue((int)i).is_error())
+            FAIL("Unexpected error while enqueueing.");
+    }
+
+    (void)second_thread->join();
+
+    EXPECT_EQ(queue.weak_used(), (size_t)0);
+}
+
+TEST_CASE(blocking_timeout)
+{
+    auto queue = MUST(TestQueue::try_create());
+    auto empty_result = queue.blocking_dequeue(Time::from_milliseconds(10));
+    EXPECT(empty_result.is_error());
+    EXPECT_EQ(empty_result.release_error(), TestQueue::QueueStatus::Empty);
+
+    for (size_t i = 0; i < queue.size() - 1; ++i)
+        EXPECT(!queue.try_enqueue((int)i).is_error());
+    auto full_result = queue.blocking_enqueue(0, Time::from_milliseconds(10));
+    EXPECT(full_result.is_error());
+    EXPECT_EQ(full_result.release_error(), TestQueue::QueueStatus::Full);
+}
+
 Function<intptr_t()> dequeuer(TestQueue& queue, Atomic<size_t>& dequeue_count, size_t const test_count)
 {
     return [&queue, &dequeue_count, test_count]() {
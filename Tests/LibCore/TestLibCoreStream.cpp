@@ -465,6 +465,65 @@ TEST_CASE(buffered_small_file_read)
     EXPECT(!file->can_read_line().value());
 }
 
+TEST_CASE(buffered_small_file_read_in_place)
+{
+    auto maybe_file = Core::Stream::File::open("/usr/Tests/LibCore/small.txt"sv, Core::Stream::OpenMode::Read);
+    EXPECT(!maybe_file.is_error());
+    auto maybe_buffered_file = Core::Stream::BufferedFile::create(maybe_file.release_value());
+    EXPECT(!maybe_buffered_file.is_error());
+    auto file = maybe_buffered_file.release_value();
+
+    static constexpr StringView expected_lines[] {
+        "Well"sv,
+        "hello"sv,
+        "friends!"sv,
+        ":^)"sv
+    };
+
+    for (auto const& line : expected_lines) {
+        VERIFY(file->can_read_line().release_value());
+        auto maybe_read_line = file->read_line_in_place();
+        EXPECT(!maybe_read_line.is_error());
+        EXPECT_EQ(maybe_read_line.value(), line);
+    }
+    EXPECT(!file->can_read_line().is_error());
+    EXPECT(!file->can_read_line().value());
+}
+
+TEST_CASE(buffered_local_socket_peek_and_discard)
+{
+    Core::EventLoop event_loop;
+
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    auto writer = Core::Stream::LocalSocket::adopt_fd(fds[1]).release_value();
+    auto maybe_buffered_socket = Core::Stream::BufferedLocalSocket::create(Core::Stream::LocalSocket::adopt_fd(fds[0]).release_value(), 8);
+    EXPECT(!maybe_buffered_socket.is_error());
+    auto reader = maybe_buffered_socket.release_value();
+
+    EXPECT(writer->write_or_error("key: value\r\nabc"sv.bytes()));
+
+    auto peeked = reader->peek_some();
+    EXPECT(!peeked.is_error());
+    EXPECT_EQ(StringView { peeked.value() }, "key: val"sv);
+    reader->discard(5);
+
+    // Making room for the rest of the line moves "val" to the front of the buffer.
+    auto maybe_line = reader->read_until_in_place("\r\n"sv);
+    EXPECT(!maybe_line.is_error());
+    EXPECT_EQ(StringView { maybe_line.value() }, "value"sv);
+
+    Array<u8, 16> buffer;
+    auto maybe_rest = reader->read(buffer);
+    EXPECT(!maybe_rest.is_error());
+    EXPECT_EQ(StringView { maybe_rest.value() }, "a"sv);
+
+    // With nothing buffered, reads that are larger than the buffer bypass it.
+    maybe_rest = reader->read(buffer);
+    EXPECT(!maybe_rest.is_error());
+    EXPECT_EQ(StringView { maybe_rest.value() }, "bc"sv);
+}
+
 constexpr auto buffered_sent_data = "Well hello friends!\n:^)\nThis shouldn't be present. :^("sv;
 constexpr auto first_line = "Well hello friends!"sv;
 constexpr auto second_line = ":^)"sv;
@@ -23,6 +23,35 @@ static String read_all(String const& path)
     return String { content.bytes() };
 }
 
+static String dump_ast(Cpp::ASTNode const& root)
+{
+    int pipefd[2] = {};
+    if (pipe(pipefd) < 0) {
+        perror("pipe");
+        exit(1);
+    }
+
+    FILE* input_stream = fdopen(pipefd[0], "r");
+    FILE* output_stream = fdopen(pipefd[1], "w");
+
+    root.dump(output_stream);
+
+    fclose(output_stream);
+
+    ByteBuffer buffer;
+    while (!feof(input_stream)) {
+        char chunk[4096];
+        size_t size = fread(chunk, sizeof(char), sizeof(chunk), input_stream);
+        if (size == 0)
+            break;
+        buffer.append(chunk, size);
+    }
+
+    fclose(input_stream);
+
+    return String { reinterpret_cast<char const*>(buffer.data()), buffer.size() };
+}
+
 TEST_CASE(test_regression)
 {
     Core::DirIterator directory_iterator(TESTS_ROOT_DIR, Core::DirIterator::Flags::SkipDots);
@@ -48,33 +77,49 @@ TEST_CASE(test_regression)
 
         EXPECT(parser.errors().is_empty());
 
-        int pipefd[2] = {};
-        if (pipe(pipefd) < 0) {
-            perror("pipe");
-            exit(1);
-        }
-
-        FILE* input_stream = fdopen(pipefd[0], "r");
-        FILE* output_stream = fdopen(pipefd[1], "w");
-
-        root->dump(output_stream);
-
-        fclose(output_stream);
-
-        ByteBuffer buffer;
-        while (!feof(input_stream)) {
-            char chunk[4096];
-            size_t size = fread(chunk, sizeof(char), sizeof(chunk), input_stream);
-            if (size == 0)
-                break;
-            buffer.append(chunk, size);
-        }
-
-        fclose(input_stream);
-
-        String content { reinterpret_cast<char const*>(buffer.data()), buffer.size() };
+        auto content = dump_ast(*root);
 
         auto equal = content == target_ast;
         EXPECT(equal);
     }
 }
+
+TEST_CASE(incremental_parse)
+{
+    auto original_source = R"~~~(int first(int a) { return a + 1; }
+struct Second {
+    int x;
+};
+int third() { return 3; }
+int fourth() { return first(4); }
+)~~~"sv;
+    auto edited_source = R"~~~(int first(int a) { return a + 1; }
+struct Second {
+    int x;
+};
+int third() { return 33 + first(3); }
+int fourth() { return first(4); }
+void fifth();
+)~~~"sv;
+
+    Cpp::Preprocessor original_preprocessor("test.cpp"sv, original_source);
+    Cpp::Parser original_parser(original_preprocessor.process_and_lex(), "test.cpp"sv);
+    original_parser.parse();
+
+    Cpp::Preprocessor edited_preprocessor("test.cpp"sv, edited_source);
+    auto edited_tokens = edited_preprocessor.process_and_lex();
+
+    Cpp::Parser full_parser(edited_tokens, "test.cpp"sv);
+    auto full_root = full_parser.parse();
+
+    Cpp::Parser incremental_parser(edited_tokens, "test.cpp"sv);
+    auto incremental_root = incremental_parser.parse_incrementally(original_parser);
+
+    EXPECT_EQ(incremental_parser.reused_declaration_count(), 2u);
+    EXPECT_EQ(incremental_root->declarations().size(), 5u);
+    EXPECT_EQ(dump_ast(*incremental_root), dump_ast(*full_root));
+
+    auto node = incremental_parser.node_at({ 2, 8 });
+    EXPECT(node);
+    EXPECT_EQ(node->start(), full_parser.node_at({ 2, 8 })->start());
+}
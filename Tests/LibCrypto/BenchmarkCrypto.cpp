@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Hash/MD5.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHA2.h>
+
+static ByteBuffer const& input_data()
+{
+    static ByteBuffer data;
+    if (!data.is_empty())
+        return data;
+
+    data = ByteBuffer::create_uninitialized(4 * MiB).release_value();
+    u32 state = 1;
+    for (auto& byte : data.bytes()) {
+        state = state * 1103515245 + 12345;
+        byte = state >> 24;
+    }
+    return data;
+}
+
+template<typename HashType>
+static void hash_input_data()
+{
+    HashType hash;
+    hash.update(input_data());
+    auto digest = hash.digest();
+    EXPECT_EQ(digest.data_length(), HashType::digest_size());
+}
+
+BENCHMARK_CASE(md5_4MiB)
+{
+    hash_input_data<Crypto::Hash::MD5>();
+}
+
+BENCHMARK_CASE(sha1_4MiB)
+{
+    hash_input_data<Crypto::Hash::SHA1>();
+}
+
+BENCHMARK_CASE(sha256_4MiB)
+{
+    hash_input_data<Crypto::Hash::SHA256>();
+}
+
+BENCHMARK_CASE(sha512_4MiB)
+{
+    hash_input_data<Crypto::Hash::SHA512>();
+}
+
+static void encrypt_input_data_with_aes_cbc(size_t key_bits)
+{
+    auto key = ByteBuffer::create_zeroed(key_bits / 8).release_value();
+    Crypto::Cipher::AESCipher::CBCMode cipher(key, key_bits, Crypto::Cipher::Intent::Encryption);
+    auto out = cipher.create_aligned_buffer(input_data().size()).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.encrypt(input_data(), out_span, iv);
+    EXPECT(out_span.size() >= input_data().size());
+}
+
+BENCHMARK_CASE(aes_128_cbc_encrypt_4MiB)
+{
+    encrypt_input_data_with_aes_cbc(128);
+}
+
+BENCHMARK_CASE(aes_256_cbc_encrypt_4MiB)
+{
+    encrypt_input_data_with_aes_cbc(256);
+}
@@ -201,6 +201,28 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_multiplication_with_karatsuba)
+{
+    // (2^3200 - 1)^2 = 2^6400 - 2^3201 + 1, which is long enough to be multiplied with Karatsuba's method.
+    Vector<u32, Crypto::STARTING_WORD_SIZE> words;
+    for (size_t i = 0; i < 100; ++i)
+        words.append(UINT32_MAX);
+    Crypto::UnsignedBigInteger num(move(words));
+    auto result = num.multiplied_by(num);
+
+    Vector<u32> expected_result;
+    expected_result.resize(200);
+    expected_result[0] = 1;
+    expected_result[100] = UINT32_MAX - 1;
+    for (size_t i = 101; i < 200; ++i)
+        expected_result[i] = UINT32_MAX;
+    EXPECT_EQ(result.words(), expected_result);
+
+    // Numbers of very different lengths are multiplied in pieces.
+    auto longer = result.plus(12345);
+    EXPECT_EQ(longer.multiplied_by(num).divided_by(num).quotient, longer);
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -224,6 +246,16 @@ TEST_CASE(test_unsigned_bigint_division_with_big_numbers)
     EXPECT_EQ(result.remainder, expected.remainder);
 }
 
+TEST_CASE(test_unsigned_bigint_division_with_correction)
+{
+    // The first estimate of the quotient is one too large here, so the denominator has to be added back.
+    Crypto::UnsignedBigInteger num1({ 3, 0, 0x80000000 });
+    Crypto::UnsignedBigInteger num2({ 1, 0, 0x20000000 });
+    auto result = num1.divided_by(num2);
+    EXPECT_EQ(result.quotient, Crypto::UnsignedBigInteger(3));
+    EXPECT_EQ(result.remainder, Crypto::UnsignedBigInteger({ 0, 0, 0x20000000 }));
+}
+
 TEST_CASE(test_unsigned_bigint_division_combined_test)
 {
     auto num1 = bigint_fibonacci(497);
@@ -304,6 +336,17 @@ TEST_CASE(test_bigint_large_odd_fibonacci_with_carry_modular_power)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_bigint_modular_power_with_long_exponent)
+{
+    // Fermat's little theorem, with the Mersenne prime 2^521 - 1. The exponent is long enough to use a wide window.
+    auto prime = Crypto::UnsignedBigInteger(1).shift_left(521).minus(1);
+    auto result = Crypto::NumberTheory::ModularPower(3, prime.minus(1), prime);
+    EXPECT_EQ(result, Crypto::UnsignedBigInteger(1));
+
+    result = Crypto::NumberTheory::ModularPower(3, prime.minus(2), prime);
+    EXPECT_EQ(result.multiplied_by(3).divided_by(prime).remainder, Crypto::UnsignedBigInteger(1));
+}
+
 TEST_CASE(test_bigint_modular_power_extra_tests)
 {
     struct {
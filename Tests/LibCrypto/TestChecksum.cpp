@@ -33,3 +33,41 @@ TEST_CASE(test_crc32)
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+// Long enough for the vectorized implementations to kick in, with a tail that they leave to the portable ones
+static ByteBuffer long_test_data()
+{
+    auto data = ByteBuffer::create_uninitialized(100000).release_value();
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (i * 7) % 251;
+    return data;
+}
+
+TEST_CASE(test_adler32_long)
+{
+    auto data = long_test_data();
+    EXPECT_EQ(Crypto::Checksum::Adler32(data).digest(), 0x437bc42eu);
+    EXPECT_EQ(Crypto::Checksum::Adler32(data.bytes().trim(999)).digest(), 0x1977e5ceu);
+
+    // The largest possible sums, which have to be reduced before they overflow
+    data.bytes().fill(0xff);
+    EXPECT_EQ(Crypto::Checksum::Adler32(data).digest(), 0x149a302cu);
+}
+
+TEST_CASE(test_crc32_long)
+{
+    auto data = long_test_data();
+    EXPECT_EQ(Crypto::Checksum::CRC32(data).digest(), 0xb0a8c3cdu);
+    EXPECT_EQ(Crypto::Checksum::CRC32(data.bytes().trim(999)).digest(), 0x0eca3478u);
+}
+
+TEST_CASE(test_crc32_combine)
+{
+    auto data = long_test_data();
+    auto first = Crypto::Checksum::CRC32(data.bytes().trim(12345)).digest();
+    auto second = Crypto::Checksum::CRC32(data.bytes().slice(12345)).digest();
+    EXPECT_EQ(first, 0x9c334688u);
+    EXPECT_EQ(second, 0xeba19fb2u);
+    EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, data.size() - 12345), 0xb0a8c3cdu);
+    EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, 0, 0), first);
+}
@@ -5,6 +5,8 @@
  */
 
 #include <LibCrypto/Authentication/HMAC.h>
+#include <LibCrypto/Hash/HKDF.h>
+#include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/Hash/MD5.h>
 #include <LibCrypto/Hash/SHA1.h>
 #include <LibCrypto/Hash/SHA2.h>
@@ -145,3 +147,32 @@ TEST_CASE(test_hmac_sha512_reuse)
 
     EXPECT(memcmp(mac_0.data, mac_1.data, hmac.digest_size()) == 0);
 }
+
+// https://www.rfc-editor.org/rfc/rfc5869#appendix-A.1
+TEST_CASE(test_hkdf_sha256)
+{
+    u8 input_keying_material[22];
+    memset(input_keying_material, 0x0b, sizeof(input_keying_material));
+    u8 salt[13] { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c };
+    u8 info[10] { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9 };
+    u8 expected_prk[32] {
+        0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f, 0x0d, 0xc4, 0x7b, 0xba, 0x63,
+        0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31, 0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5
+    };
+    u8 expected_okm[42] {
+        0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36, 0x2f, 0x2a,
+        0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf,
+        0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65
+    };
+
+    Crypto::Hash::HKDF<Crypto::Hash::SHA256> hkdf;
+    auto prk = MUST(hkdf.extract({ salt, sizeof(salt) }, { input_keying_material, sizeof(input_keying_material) }));
+    EXPECT_EQ(prk.bytes(), (ReadonlyBytes { expected_prk, sizeof(expected_prk) }));
+    auto okm = MUST(hkdf.expand(prk, { info, sizeof(info) }, sizeof(expected_okm)));
+    EXPECT_EQ(okm.bytes(), (ReadonlyBytes { expected_okm, sizeof(expected_okm) }));
+
+    // The hash manager has to come to the same result.
+    Crypto::Hash::HKDF<Crypto::Hash::Manager> hkdf_manager(Crypto::Hash::HashKind::SHA256);
+    auto okm_from_manager = MUST(hkdf_manager.expand(MUST(hkdf_manager.extract({ salt, sizeof(salt) }, { input_keying_material, sizeof(input_keying_material) })), { info, sizeof(info) }, sizeof(expected_okm)));
+    EXPECT_EQ(okm_from_manager.bytes(), (ReadonlyBytes { expected_okm, sizeof(expected_okm) }));
+}
@@ -142,6 +142,27 @@ TEST_CASE(test_SHA1_hash_successive_updates)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_many_blocks)
+{
+    u8 result[] {
+        0x38, 0xf3, 0xaa, 0x58, 0x7f, 0x4a, 0xa0, 0x49, 0x65, 0xa3, 0x59, 0xf9, 0x15, 0x10, 0x92, 0x75, 0x9b, 0x3a, 0x4c, 0x2a
+    };
+    u8 message[1000];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = i * 7;
+    auto digest = Crypto::Hash::SHA1::hash(message, sizeof(message));
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+
+    // Unaligned updates that straddle blocks, and some that cover several of them.
+    Crypto::Hash::SHA1 hasher;
+    hasher.update(message, 3);
+    hasher.update(message + 3, 70);
+    hasher.update(message + 73, 200);
+    hasher.update(message + 273, 727);
+    digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -166,6 +187,66 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_peek_keeps_state)
+{
+    Crypto::Hash::SHA256 sha;
+    sha.update("Well hello "sv);
+    auto partial_digest = sha.peek();
+    EXPECT(memcmp(partial_digest.data, Crypto::Hash::SHA256::hash("Well hello "sv).data, Crypto::Hash::SHA256::digest_size()) == 0);
+
+    sha.update("friends"sv);
+    auto digest = sha.digest();
+    EXPECT(memcmp(digest.data, Crypto::Hash::SHA256::hash("Well hello friends"sv).data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many_blocks)
+{
+    u8 result[] {
+        0x89, 0xf4, 0xff, 0x56, 0xa2, 0x5d, 0xd1, 0xdb, 0x06, 0xa4, 0xce, 0x60, 0x33, 0x60, 0x37, 0x75, 0xd7, 0x05, 0xfb, 0x96, 0xf3, 0x0f, 0x86, 0x93, 0x73, 0x3f, 0xef, 0x60, 0x2a, 0x1c, 0xa5, 0x32
+    };
+    u8 message[1000];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = i * 7;
+    auto digest = Crypto::Hash::SHA256::hash(message, sizeof(message));
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+
+    // Unaligned updates that straddle blocks, and some that cover several of them.
+    Crypto::Hash::SHA256 sha;
+    sha.update(message, 3);
+    sha.update(message + 3, 70);
+    sha.update(message + 73, 200);
+    sha.update(message + 273, 727);
+    digest = sha.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    u8 message[1000];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = i * 7;
+
+    // More messages than are hashed side by side, with lengths around where the padding takes another block.
+    size_t const lengths[] { 0, 55, 56, 64, 1000, 1, 63, 119, 120, 128, 999, 500, 3 };
+    Vector<ReadonlyBytes> messages;
+    for (auto length : lengths)
+        messages.append({ message, length });
+
+    auto digests = Crypto::Hash::SHA256::hash_many(messages);
+    EXPECT_EQ(digests.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+
+    u8 result[] {
+        0x9b, 0x20, 0x50, 0x1d, 0xfd, 0x1d, 0x99, 0x16, 0x1c, 0x25, 0x79, 0x50, 0xf3, 0x44, 0x4f, 0x3e, 0x49, 0x23, 0x0c, 0x35, 0x1c, 0x5c, 0x8e, 0x09, 0x43, 0xef, 0x36, 0x9f, 0x85, 0xf5, 0x20, 0x5d
+    };
+    EXPECT(memcmp(result, digests[2].data, Crypto::Hash::SHA256::digest_size()) == 0);
+
+    EXPECT(Crypto::Hash::SHA256::hash_many({}).is_empty());
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
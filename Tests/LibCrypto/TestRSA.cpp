@@ -5,6 +5,7 @@
  */
 
 #include <LibCrypto/Hash/SHA2.h>
+#include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibCrypto/PK/PK.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTest/TestCase.h>
@@ -135,3 +136,30 @@ TEST_CASE(test_RSA_EMSA_PSS_construction)
     Crypto::PK::RSA rsa;
     Crypto::PK::RSA_EMSA_PSS<Crypto::Hash::SHA256> rsa_esma_pss(rsa);
 }
+
+TEST_CASE(test_RSA_EMSA_PSS_verify)
+{
+    // Signed with `openssl dgst -sha256 -sigopt rsa_padding_mode:pss -sigopt rsa_pss_saltlen:32`.
+    Crypto::PK::RSA rsa(
+        "121057367055480685190044664577706461791489562832213403209047913171096845672488370712658522118641351404151113021729213501303860875375603564018855937411660314425824325746345454125348351347430393303834365238440873458649720764317003372760170239676017613990615243215214515440606356836534388124455418447631460775703"_bigint,
+        "0"_bigint,
+        "65537"_bigint);
+    u8 signature[128] {
+        0x38, 0x63, 0x93, 0x7e, 0xf8, 0x8f, 0xc1, 0x9e, 0xbf, 0x43, 0x35, 0x65, 0x67, 0x1e, 0xde, 0x19,
+        0x9a, 0xf9, 0x04, 0x9d, 0x36, 0x63, 0xae, 0x73, 0xca, 0xe0, 0x11, 0xe1, 0x40, 0x24, 0xf5, 0x31,
+        0x5b, 0x27, 0xda, 0x68, 0x1a, 0xe3, 0x55, 0xd5, 0x6d, 0x7e, 0x7f, 0x15, 0x34, 0xb2, 0xa2, 0x2d,
+        0x30, 0xcf, 0x3a, 0xae, 0x91, 0x7a, 0xfe, 0x7e, 0x52, 0x03, 0xe1, 0xca, 0x55, 0x27, 0xaa, 0x91,
+        0x3c, 0x0c, 0xdf, 0x9e, 0x66, 0x5d, 0xb9, 0xb4, 0xe2, 0x5e, 0x41, 0xb5, 0xe9, 0xe5, 0x7b, 0xdc,
+        0x3b, 0xf5, 0x74, 0xdc, 0xb2, 0xed, 0xb8, 0xdb, 0x16, 0x1a, 0xe9, 0x84, 0xf2, 0xa6, 0xeb, 0x93,
+        0xe0, 0x60, 0x4a, 0x50, 0xb0, 0x15, 0x80, 0x52, 0x2a, 0x7b, 0x22, 0xdc, 0x4a, 0x31, 0xfe, 0xec,
+        0x90, 0x56, 0x2d, 0xfb, 0x57, 0x3f, 0x66, 0x82, 0x23, 0xa0, 0x94, 0x18, 0x99, 0x70, 0xfa, 0xe1
+    };
+
+    u8 encoded_message_buffer[128];
+    auto encoded_message = Bytes { encoded_message_buffer, sizeof(encoded_message_buffer) };
+    rsa.verify({ signature, sizeof(signature) }, encoded_message);
+
+    Crypto::PK::EMSA_PSS<Crypto::Hash::SHA256, Crypto::Hash::SHA256::DigestSize> pss;
+    EXPECT(pss.verify("The quick brown fox jumps over the lazy dog"sv.bytes(), encoded_message, 1024 - 1) == Crypto::VerificationConsistency::Consistent);
+    EXPECT(pss.verify("The quick brown fox jumps over the lazy cat"sv.bytes(), encoded_message, 1024 - 1) == Crypto::VerificationConsistency::Inconsistent);
+}
@@ -61,3 +61,101 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_translucent)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(0, 0, 255, 100));
+    }
+}
+
+// A source bitmap with a mix of opaque, translucent and transparent pixels, like most window contents and web page layers.
+static NonnullRefPtr<Gfx::Bitmap> create_bitmap_with_alpha(Gfx::BitmapFormat format, int size)
+{
+    auto bitmap = Gfx::Bitmap::try_create(format, { size, size }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++)
+            bitmap->set_pixel(x, y, Color(x & 0xff, y & 0xff, (x + y) & 0xff, (x * 3) & 0xff));
+    }
+    return bitmap;
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_bitmap_with_alpha(Gfx::BitmapFormat::BGRA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_bitmap_with_alpha(Gfx::BitmapFormat::BGRA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(blit_rgba)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_bitmap_with_alpha(Gfx::BitmapFormat::RGBA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, source, source->rect(), 1.0f, false);
+    }
+}
+
+BENCHMARK_CASE(draw_integer_scaled_bitmap)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_bitmap_with_alpha(Gfx::BitmapFormat::BGRA8888, bitmap_size / 2);
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_bitmap_with_alpha(Gfx::BitmapFormat::BGRA8888, 1500);
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect());
+    }
+}
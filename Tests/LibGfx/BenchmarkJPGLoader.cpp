@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibCore/MappedFile.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+
+static void decode_repeatedly(StringView path, int run_count)
+{
+    auto file = Core::MappedFile::map(path).release_value();
+    for (int run = 0; run < run_count; run++) {
+        auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        auto frame = jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+        EXPECT(frame.image);
+    }
+}
+
+BENCHMARK_CASE(decode_non_subsampled)
+{
+    decode_repeatedly("/res/html/misc/jpgsuite_files/non-subsampled-lena.jpg"sv, 50);
+}
+
+BENCHMARK_CASE(decode_chroma_quartered)
+{
+    decode_repeatedly("/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg"sv, 50);
+}
+
+BENCHMARK_CASE(decode_large)
+{
+    decode_repeatedly("/res/html/misc/jpgsuite_files/oh-lena.jpg"sv, 20);
+}
+
+BENCHMARK_CASE(decode_progressive)
+{
+    decode_repeatedly("/res/html/misc/jpgsuite_files/progressive-lena.jpg"sv, 50);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Font/GlyphAtlas.h>
+
+static NonnullRefPtr<Gfx::Bitmap> make_glyph(u32 glyph_id, Gfx::IntSize size)
+{
+    auto glyph = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, size));
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x)
+            glyph->scanline(y)[x] = 0x00ffffff | ((glyph_id * 31 + x * 7 + y * 13) & 0xff) << 24;
+    }
+    return glyph;
+}
+
+static bool atlas_contains_glyph_at(Gfx::GlyphAtlas const& atlas, Gfx::IntRect const& rect, Gfx::Bitmap const& glyph)
+{
+    if (rect.size() != glyph.size())
+        return false;
+    for (int y = 0; y < glyph.height(); ++y) {
+        for (int x = 0; x < glyph.width(); ++x) {
+            if (atlas.bitmap()->scanline(rect.y() + y)[rect.x() + x] != glyph.scanline(y)[x])
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE(insert_and_find)
+{
+    Gfx::GlyphAtlas atlas;
+    EXPECT(!atlas.find(1, {}).has_value());
+
+    auto glyph = make_glyph(1, { 7, 12 });
+    auto rect = atlas.insert(1, {}, *glyph);
+    EXPECT(rect.has_value());
+    EXPECT(atlas_contains_glyph_at(atlas, *rect, *glyph));
+    EXPECT_EQ(atlas.find(1, {}), rect);
+
+    // Each subpixel offset is a glyph of its own.
+    EXPECT(!atlas.find(1, { 2 }).has_value());
+    auto other_glyph = make_glyph(2, { 8, 12 });
+    auto other_rect = atlas.insert(1, { 2 }, *other_glyph);
+    EXPECT(other_rect.has_value());
+    EXPECT(!other_rect->intersects(*rect));
+    EXPECT(atlas_contains_glyph_at(atlas, *rect, *glyph));
+}
+
+TEST_CASE(glyphs_too_large_for_the_atlas)
+{
+    Gfx::GlyphAtlas atlas;
+    auto glyph = make_glyph(1, { 10, Gfx::GlyphAtlas::max_height });
+    EXPECT(!Gfx::GlyphAtlas::can_hold(glyph->size()));
+    EXPECT(!atlas.insert(1, {}, *glyph).has_value());
+}
+
+TEST_CASE(least_recently_used_glyphs_are_evicted)
+{
+    Gfx::GlyphAtlas atlas;
+    Gfx::IntSize size { 32, 32 };
+    auto glyphs_per_atlas = (Gfx::GlyphAtlas::width / size.width()) * (Gfx::GlyphAtlas::max_height / size.height());
+
+    // Glyph 0 is used all the time, so it has to survive filling the atlas several times over.
+    auto frequently_used_glyph = make_glyph(0, size);
+    EXPECT(atlas.insert(0, {}, *frequently_used_glyph).has_value());
+
+    for (u32 glyph_id = 1; glyph_id < 3u * glyphs_per_atlas; ++glyph_id) {
+        auto glyph = make_glyph(glyph_id, size);
+        auto rect = atlas.insert(glyph_id, {}, *glyph);
+        EXPECT(rect.has_value());
+        EXPECT(atlas_contains_glyph_at(atlas, *rect, *glyph));
+
+        auto frequently_used_rect = atlas.find(0, {});
+        EXPECT(frequently_used_rect.has_value());
+        EXPECT(atlas_contains_glyph_at(atlas, *frequently_used_rect, *frequently_used_glyph));
+    }
+
+    // The glyphs that went onto the second shelf when the atlas was first filled are long gone.
+    auto glyphs_per_shelf = Gfx::GlyphAtlas::width / size.width();
+    EXPECT(!atlas.find(glyphs_per_shelf, {}).has_value());
+}
+
+TEST_CASE(evicting_does_not_change_bitmaps_still_in_use)
+{
+    Gfx::GlyphAtlas atlas;
+    Gfx::IntSize size { Gfx::GlyphAtlas::width, Gfx::GlyphAtlas::max_height / 4 };
+
+    auto first_glyph = make_glyph(0, size);
+    auto first_rect = atlas.insert(0, {}, *first_glyph);
+    EXPECT(first_rect.has_value());
+    for (u32 glyph_id = 1; glyph_id < 4; ++glyph_id)
+        EXPECT(atlas.insert(glyph_id, {}, *make_glyph(glyph_id, size)).has_value());
+
+    auto bitmap_in_use = atlas.bitmap();
+    EXPECT(atlas.insert(4, {}, *make_glyph(4, size)).has_value());
+    EXPECT(!atlas.find(0, {}).has_value());
+    EXPECT_NE(atlas.bitmap(), bitmap_in_use);
+    for (int y = 0; y < first_glyph->height(); ++y)
+        EXPECT_EQ(bitmap_in_use->scanline(first_rect->y() + y)[0], first_glyph->scanline(y)[0]);
+}
@@ -77,6 +77,54 @@ TEST_CASE(test_jpg)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_jpg_progressive)
+{
+    // This is chroma-quartered-lena.jpg converted to a progressive JPEG (with restart intervals) without re-encoding it.
+    auto baseline_file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg"sv).release_value();
+    auto progressive_file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/progressive-lena.jpg"sv).release_value();
+    auto baseline_jpg = Gfx::JPGImageDecoderPlugin((u8 const*)baseline_file->data(), baseline_file->size());
+    auto progressive_jpg = Gfx::JPGImageDecoderPlugin((u8 const*)progressive_file->data(), progressive_file->size());
+    EXPECT(progressive_jpg.sniff());
+
+    auto baseline_frame = baseline_jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+    auto progressive_frame = progressive_jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(progressive_frame.image->size(), baseline_frame.image->size());
+
+    size_t mismatched_pixels = 0;
+    for (int y = 0; y < baseline_frame.image->height(); ++y) {
+        for (int x = 0; x < baseline_frame.image->width(); ++x) {
+            if (progressive_frame.image->get_pixel(x, y) != baseline_frame.image->get_pixel(x, y))
+                ++mismatched_pixels;
+        }
+    }
+    EXPECT_EQ(mismatched_pixels, 0u);
+}
+
+TEST_CASE(test_jpg_progressive_truncated)
+{
+    // The scans that made it into a truncated progressive JPEG still give a (blurrier) image.
+    auto file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/progressive-lena.jpg"sv).release_value();
+    auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size() / 2);
+
+    auto frame = jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(512, 512));
+}
+
+TEST_CASE(test_jpg_downscaled)
+{
+    // JPEGs are scaled down by 1/2, 1/4 or 1/8, as far as they can be while still being at least as large as asked for.
+    auto file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg"sv).release_value();
+    auto decode_for_ideal_size = [&](Gfx::IntSize ideal_size) {
+        auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        return jpg.downscaled_frame(0, ideal_size).release_value_but_fixme_should_propagate_errors().image->size();
+    };
+
+    EXPECT_EQ(decode_for_ideal_size({ 64, 64 }), Gfx::IntSize(64, 64));
+    EXPECT_EQ(decode_for_ideal_size({ 65, 10 }), Gfx::IntSize(128, 128));
+    EXPECT_EQ(decode_for_ideal_size({ 256, 256 }), Gfx::IntSize(256, 256));
+    EXPECT_EQ(decode_for_ideal_size({ 1000, 1000 }), Gfx::IntSize(512, 512));
+}
+
 TEST_CASE(test_pbm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/pbmsuite_files/buggie-raw.pbm"sv).release_value();
@@ -119,6 +167,80 @@ TEST_CASE(test_png)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_png_interlaced)
+{
+    // This is buggie.png re-encoded with Adam7 interlacing.
+    auto file = Core::MappedFile::map("/res/graphics/buggie.png"sv).release_value();
+    auto interlaced_file = Core::MappedFile::map("/res/html/misc/pngsuite_files/buggie-interlaced.png"sv).release_value();
+    auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    auto interlaced_png = Gfx::PNGImageDecoderPlugin((u8 const*)interlaced_file->data(), interlaced_file->size());
+    EXPECT(interlaced_png.sniff());
+
+    auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+    auto interlaced_frame = interlaced_png.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(interlaced_frame.image->size(), frame.image->size());
+
+    size_t mismatched_pixels = 0;
+    for (int y = 0; y < frame.image->height(); ++y) {
+        for (int x = 0; x < frame.image->width(); ++x) {
+            if (interlaced_frame.image->get_pixel(x, y) != frame.image->get_pixel(x, y))
+                ++mismatched_pixels;
+        }
+    }
+    EXPECT_EQ(mismatched_pixels, 0u);
+}
+
+TEST_CASE(test_png_truncated)
+{
+    // The scanlines that made it into a truncated PNG are still shown, the rest of the image is left transparent.
+    auto file = Core::MappedFile::map("/res/graphics/buggie.png"sv).release_value();
+    auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    auto truncated_png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size() / 2);
+
+    auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+    auto truncated_frame = truncated_png.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(truncated_frame.image->size(), frame.image->size());
+
+    for (int x = 0; x < frame.image->width(); ++x) {
+        EXPECT_EQ(truncated_frame.image->get_pixel(x, 0), frame.image->get_pixel(x, 0));
+        EXPECT_EQ(truncated_frame.image->get_pixel(x, 120).alpha(), 0);
+    }
+    EXPECT_EQ(frame.image->get_pixel(32, 120).alpha(), 255);
+}
+
+TEST_CASE(test_png_interlaced_truncated)
+{
+    // The passes that made it into a truncated interlaced PNG still give a (blockier) image.
+    auto file = Core::MappedFile::map("/res/html/misc/pngsuite_files/buggie-interlaced.png"sv).release_value();
+    auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size() / 2);
+
+    auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(64, 138));
+}
+
+TEST_CASE(test_png_downscaled)
+{
+    // PNGs are scaled down by only decoding every 2nd, 4th or 8th pixel in each direction, for interlaced ones only from the first few passes.
+    for (auto path : { "/res/graphics/buggie.png"sv, "/res/html/misc/pngsuite_files/buggie-interlaced.png"sv }) {
+        auto file = Core::MappedFile::map(path).release_value();
+        auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        auto downscaled_png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+
+        auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+        auto downscaled_frame = downscaled_png.downscaled_frame(0, { 16, 16 }).release_value_but_fixme_should_propagate_errors();
+        EXPECT_EQ(downscaled_frame.image->size(), Gfx::IntSize(16, 35));
+
+        size_t mismatched_pixels = 0;
+        for (int y = 0; y < downscaled_frame.image->height(); ++y) {
+            for (int x = 0; x < downscaled_frame.image->width(); ++x) {
+                if (downscaled_frame.image->get_pixel(x, y) != frame.image->get_pixel(x * 4, y * 4))
+                    ++mismatched_pixels;
+            }
+        }
+        EXPECT_EQ(mismatched_pixels, 0u);
+    }
+}
+
 TEST_CASE(test_ppm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/ppmsuite_files/buggie-raw.ppm"sv).release_value();
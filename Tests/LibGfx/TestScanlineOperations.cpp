@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibGfx/ScanlineOperations.h>
+
+// The vectorized operations must match Color pixel for pixel, including the scalar tails of odd-sized runs.
+
+static Vector<u32> random_pixels(size_t count)
+{
+    Vector<u32> pixels;
+    for (size_t i = 0; i < count; ++i)
+        pixels.append(get_random<u32>());
+    return pixels;
+}
+
+static Vector<u32> random_pixels_with_alpha(size_t count, u8 alpha)
+{
+    auto pixels = random_pixels(count);
+    for (auto& pixel : pixels)
+        pixel = (pixel & 0x00ffffff) | (alpha << 24);
+    return pixels;
+}
+
+TEST_CASE(blend_scanline_onto_opaque_pixels)
+{
+    for (size_t count : { 0, 1, 7, 64, 123 }) {
+        auto dst = random_pixels_with_alpha(count, 0xff);
+        auto src = random_pixels(count);
+        // Make sure the special cases of fully transparent and fully opaque sources show up.
+        if (count > 2) {
+            src[0] &= 0x00ffffff;
+            src[1] |= 0xff000000;
+        }
+
+        auto expected = dst;
+        for (size_t i = 0; i < count; ++i)
+            expected[i] = Color::from_argb(dst[i]).blend(Color::from_argb(src[i])).value();
+
+        Gfx::blend_scanline(dst.data(), src.data(), count);
+        EXPECT_EQ(dst, expected);
+    }
+}
+
+TEST_CASE(blend_scanline_onto_translucent_pixels)
+{
+    auto dst = random_pixels(123);
+    auto src = random_pixels(123);
+    // Mix in some runs of opaque destination pixels, so both paths get used.
+    for (size_t i = 16; i < 48; ++i)
+        dst[i] |= 0xff000000;
+
+    auto expected = dst;
+    for (size_t i = 0; i < dst.size(); ++i)
+        expected[i] = Color::from_argb(dst[i]).blend(Color::from_argb(src[i])).value();
+
+    Gfx::blend_scanline(dst.data(), src.data(), dst.size());
+    EXPECT_EQ(dst, expected);
+}
+
+TEST_CASE(blend_scanline_onto_opaque)
+{
+    // The destination's alpha is ignored, like for a BGRx8888 bitmap.
+    auto dst = random_pixels(123);
+    auto src = random_pixels(123);
+
+    auto expected = dst;
+    for (size_t i = 0; i < dst.size(); ++i)
+        expected[i] = Color::from_rgb(dst[i]).blend(Color::from_argb(src[i])).value();
+
+    Gfx::blend_scanline_onto_opaque(dst.data(), src.data(), dst.size());
+    EXPECT_EQ(dst, expected);
+}
+
+TEST_CASE(blend_color_into_scanline)
+{
+    for (u8 alpha : { 0x00, 0x01, 0x80, 0xfe, 0xff }) {
+        auto dst = random_pixels(123);
+        for (size_t i = 0; i < 64; ++i)
+            dst[i] |= 0xff000000;
+        auto color = Color(12, 34, 56, alpha);
+
+        auto expected = dst;
+        for (auto& pixel : expected)
+            pixel = Color::from_argb(pixel).blend(color).value();
+
+        Gfx::blend_color_into_scanline(dst.data(), color, dst.size());
+        EXPECT_EQ(dst, expected);
+    }
+}
+
+TEST_CASE(swap_red_and_blue_in_scanline)
+{
+    auto src = random_pixels(123);
+    Vector<u32> dst;
+    dst.resize(src.size());
+
+    Gfx::swap_red_and_blue_in_scanline(dst.data(), src.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        auto rgba = src[i];
+        EXPECT_EQ(dst[i], (rgba & 0xff00ff00) | ((rgba & 0xff) << 16) | ((rgba >> 16) & 0xff));
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/Vector.h>
+#include <LibHTTP/HPack.h>
+#include <LibTest/TestCase.h>
+
+using HTTP::HPack::Header;
+
+template<size_t N>
+static ReadonlyBytes bytes(u8 const (&data)[N])
+{
+    return { data, N };
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-C.2
+TEST_CASE(literal_header_fields)
+{
+    HTTP::HPack::Decoder decoder;
+
+    u8 const with_indexing[] = { 0x40, 0x0a, 'c', 'u', 's', 't', 'o', 'm', '-', 'k', 'e', 'y', 0x0d, 'c', 'u', 's', 't', 'o', 'm', '-', 'h', 'e', 'a', 'd', 'e', 'r' };
+    auto headers = MUST(decoder.decode(bytes(with_indexing)));
+    EXPECT_EQ(headers, (Vector<Header> { { "custom-key", "custom-header" } }));
+
+    u8 const without_indexing[] = { 0x04, 0x0c, '/', 's', 'a', 'm', 'p', 'l', 'e', '/', 'p', 'a', 't', 'h' };
+    headers = MUST(decoder.decode(bytes(without_indexing)));
+    EXPECT_EQ(headers, (Vector<Header> { { ":path", "/sample/path" } }));
+
+    u8 const never_indexed[] = { 0x10, 0x08, 'p', 'a', 's', 's', 'w', 'o', 'r', 'd', 0x06, 's', 'e', 'c', 'r', 'e', 't' };
+    headers = MUST(decoder.decode(bytes(never_indexed)));
+    EXPECT_EQ(headers, (Vector<Header> { { "password", "secret" } }));
+
+    // Index 62 is the first dynamic table entry, i.e. the one added above.
+    u8 const indexed[] = { 0x82, 0xbe };
+    headers = MUST(decoder.decode(bytes(indexed)));
+    EXPECT_EQ(headers, (Vector<Header> { { ":method", "GET" }, { "custom-key", "custom-header" } }));
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-C.4
+TEST_CASE(requests_with_huffman_coding)
+{
+    HTTP::HPack::Decoder decoder;
+
+    u8 const first_request[] = { 0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+    auto headers = MUST(decoder.decode(bytes(first_request)));
+    EXPECT_EQ(headers, (Vector<Header> { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" } }));
+
+    u8 const second_request[] = { 0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf };
+    headers = MUST(decoder.decode(bytes(second_request)));
+    EXPECT_EQ(headers, (Vector<Header> { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" }, { "cache-control", "no-cache" } }));
+
+    u8 const third_request[] = { 0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f, 0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf };
+    headers = MUST(decoder.decode(bytes(third_request)));
+    EXPECT_EQ(headers, (Vector<Header> { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/index.html" }, { ":authority", "www.example.com" }, { "custom-key", "custom-value" } }));
+}
+
+TEST_CASE(invalid_header_blocks)
+{
+    HTTP::HPack::Decoder decoder;
+
+    // Index 0 is never valid, and there is no dynamic table entry yet.
+    u8 const index_zero[] = { 0x80 };
+    EXPECT(decoder.decode(bytes(index_zero)).is_error());
+    u8 const index_out_of_range[] = { 0xbe };
+    EXPECT(decoder.decode(bytes(index_out_of_range)).is_error());
+
+    // A string literal that claims to be longer than the block.
+    u8 const truncated[] = { 0x04, 0x0c, '/', 's' };
+    EXPECT(decoder.decode(bytes(truncated)).is_error());
+
+    // A table size update above the limit we advertised.
+    u8 const table_size_update[] = { 0x3f, 0xe1, 0x3f };
+    EXPECT(decoder.decode(bytes(table_size_update)).is_error());
+}
+
+TEST_CASE(huffman_coding)
+{
+    auto encoded = MUST(HTTP::HPack::huffman_encode("www.example.com"sv));
+    u8 const expected[] = { 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+    EXPECT_EQ(encoded.bytes(), bytes(expected));
+    EXPECT_EQ(MUST(HTTP::HPack::huffman_decode(encoded)), "www.example.com");
+
+    // Padding longer than 7 bits.
+    u8 const long_padding[] = { 0xff, 0xff };
+    EXPECT(HTTP::HPack::huffman_decode(bytes(long_padding)).is_error());
+}
+
+TEST_CASE(encoder_round_trip)
+{
+    Vector<Header> headers {
+        { ":method", "GET" },
+        { ":scheme", "https" },
+        { ":path", "/some/resource?query=1" },
+        { ":authority", "serenityos.org" },
+        { "accept-encoding", "gzip, deflate" },
+        { "user-agent", "Mozilla/5.0 (SerenityOS) LibWeb+LibJS/1.0 Browser/1.0" },
+        { "x-custom", "" },
+        { "cookie", "name=value" },
+    };
+
+    HTTP::HPack::Encoder encoder;
+    auto block = MUST(encoder.encode(headers));
+
+    HTTP::HPack::Decoder decoder;
+    EXPECT_EQ(MUST(decoder.decode(block)), headers);
+}
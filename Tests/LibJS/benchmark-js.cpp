@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// A few thousand lines of the kind of code the parser sees in a typical script.
+static String const& large_script()
+{
+    static String source;
+    if (!source.is_null())
+        return source;
+
+    StringBuilder builder;
+    for (size_t i = 0; i < 2000; ++i) {
+        builder.appendff("function f{}(a, b) {{ const o = {{ x: a, y: [b, {}, 'str'] }}; return o.x + o.y.length * {}; }}\n", i, i, i);
+        builder.appendff("class C{} {{ constructor() {{ this.v = {}; }} get value() {{ return this.v ?? f{}(1, 2); }} }}\n", i, i, i);
+    }
+    source = builder.to_string();
+    return source;
+}
+
+static void parse_and_run(StringView source)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    auto script_or_error = JS::Script::parse(source, interpreter->realm());
+    EXPECT(!script_or_error.is_error());
+    if (script_or_error.is_error())
+        return;
+
+    auto result = interpreter->run(script_or_error.value());
+    EXPECT(!result.is_error());
+}
+
+BENCHMARK_CASE(parse_large_script)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto script_or_error = JS::Script::parse(large_script(), interpreter->realm());
+    EXPECT(!script_or_error.is_error());
+}
+
+BENCHMARK_CASE(run_arithmetic_loop)
+{
+    parse_and_run("let sum = 0; for (let i = 0; i < 200000; ++i) sum += i % 7; if (sum !== 599994) throw new Error();"sv);
+}
+
+BENCHMARK_CASE(run_property_access)
+{
+    parse_and_run("const o = { a: 1, b: 2 }; let sum = 0; for (let i = 0; i < 100000; ++i) sum += o.a + o.b; if (sum !== 300000) throw new Error();"sv);
+}
+
+BENCHMARK_CASE(run_function_calls)
+{
+    parse_and_run("function add(a, b) { return a + b; } let sum = 0; for (let i = 0; i < 100000; ++i) sum = add(sum, 1); if (sum !== 100000) throw new Error();"sv);
+}
+
+BENCHMARK_CASE(run_string_building)
+{
+    parse_and_run("let s = ''; for (let i = 0; i < 20000; ++i) s += String.fromCharCode(97 + i % 26); if (s.length !== 20000) throw new Error();"sv);
+}
+
+BENCHMARK_CASE(run_array_methods)
+{
+    parse_and_run("const a = Array.from({ length: 50000 }, (_, i) => i); const b = a.map(x => x * 2).filter(x => x % 3 === 0); if (b.reduce((s, x) => s + x, 0) <= 0) throw new Error();"sv);
+}
@@ -138,3 +138,55 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(constant_folding)
+{
+    EXPECT_NO_EXCEPTION_ALL("if (1 + 2 * 3 - 4 / 2 !== 5) throw new Exception('failed');\n"
+                            "if (7 % 3 !== 1 || -7 % 3 !== -1) throw new Exception('failed');\n"
+                            "if (!(1 < 2) || 2 <= 1 || 0 / 0 === 0 / 0) throw new Exception('failed');\n"
+                            "if (1 + '2' !== '12') throw new Exception('failed');");
+}
+
+TEST_CASE(registers_in_exception_handlers)
+{
+    EXPECT_NO_EXCEPTION_ALL("function f(o, i) {\n"
+                            "    var base = i * 2;\n"
+                            "    try {\n"
+                            "        return o.a.b + base;\n"
+                            "    } catch (e) {\n"
+                            "        return base * 10;\n"
+                            "    }\n"
+                            "}\n"
+                            "if ([f({ a: { b: 1 } }, 1), f({}, 2), f({ a: { b: 3 } }, 3)].join(',') !== '3,40,9') throw new Exception('failed');");
+}
+
+TEST_CASE(register_reuse)
+{
+    EXPECT_NO_EXCEPTION_ALL("function f(a, b) { return [a + 1, [b, a], [b * 2, a * 2], `${a}${b}`]; }\n"
+                            "if (f(1, 2).toString() !== '2,2,1,4,2,12') throw new Exception('failed');\n"
+                            "function *g(n) { for (var i = 0; i < n; ++i) yield i * 2 + 1; }\n"
+                            "var total = 0;\n"
+                            "for (var x of g(4)) total += x;\n"
+                            "if (total !== 16) throw new Exception('failed');");
+}
+
+TEST_CASE(jit)
+{
+    // NOTE: Everything runs in loops long enough for the functions to be compiled to native code part of the way through.
+    JS::Bytecode::g_jit_enabled = true;
+    EXPECT_NO_EXCEPTION_ALL("function sum(n) { var total = 0; for (var i = 0; i < n; ++i) total = total + i * 2 - (i & 3); return total; }\n"
+                            "if (sum(5000) !== 24987500) throw new Exception('failed');\n"
+                            "function edges(i) { return [2147483647 + i, -2147483648 - i, 65536 * 65536 * i, 1 / (0 * -i), i + 0.5, i + '!', i < NaN, i | 0x40000000].join(); }\n"
+                            "for (var i = 1; i < 2000; ++i) {\n"
+                            "    if (edges(i) !== [2147483647 + i, -2147483648 - i, 4294967296 * i, -Infinity, i + 0.5, i + '!', false, i | 0x40000000].join()) throw new Exception('failed');\n"
+                            "}\n"
+                            "function maybe_throw(o, i) { try { return o.a.b + i; } catch (e) { return -i; } }\n"
+                            "var total = 0;\n"
+                            "for (var i = 0; i < 3000; ++i) total += maybe_throw(i % 2 ? {} : { a: { b: 1 } }, i);\n"
+                            "if (total !== 0) throw new Exception('failed');\n"
+                            "function *g(n) { for (var i = 0; i < n; ++i) yield i; }\n"
+                            "var yielded = 0;\n"
+                            "for (var x of g(3000)) yielded += x;\n"
+                            "if (yielded !== 4498500) throw new Exception('failed');");
+    JS::Bytecode::g_jit_enabled = false;
+}
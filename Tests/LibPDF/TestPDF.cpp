@@ -6,6 +6,7 @@
 
 #include <AK/Forward.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <LibCore/MappedFile.h>
 #include <LibPDF/Document.h>
 #include <LibTest/Macros.h>
@@ -51,3 +52,40 @@ TEST_CASE(truncated_pdf_header_issue_10717)
     auto document = PDF::Document::create(string.bytes());
     EXPECT(document.is_error());
 }
+
+TEST_CASE(inherited_page_attributes)
+{
+    // The page itself only has a parent, everything else comes from the page tree node.
+    Vector<StringView> objects {
+        "<< /Type /Catalog /Pages 2 0 R >>"sv,
+        "<< /Type /Pages /Kids [3 0 R] /Count 1 /Resources << /Font << >> >> /MediaBox [0 0 300 200] /Rotate 90 >>"sv,
+        "<< /Type /Page /Parent 2 0 R >>"sv,
+    };
+
+    StringBuilder builder;
+    builder.append("%PDF-1.4\n"sv);
+    Vector<size_t> offsets;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        offsets.append(builder.length());
+        builder.appendff("{} 0 obj\n{}\nendobj\n", i + 1, objects[i]);
+    }
+    auto xref_offset = builder.length();
+    builder.appendff("xref\n0 {}\n0000000000 65535 f \n", objects.size() + 1);
+    for (auto offset : offsets)
+        builder.appendff("{:010} 00000 n \n", offset);
+    builder.appendff("trailer\n<< /Size {} /Root 1 0 R >>\nstartxref\n{}\n%%EOF\n", objects.size() + 1, xref_offset);
+    auto bytes = builder.to_byte_buffer();
+
+    auto document = PDF::Document::create(bytes);
+    EXPECT(!document.is_error());
+    EXPECT(!document.value()->initialize().is_error());
+    EXPECT_EQ(document.value()->get_page_count(), 1U);
+
+    auto page = document.value()->get_page(0);
+    EXPECT(!page.is_error());
+    EXPECT_EQ(page.value().media_box.width(), 300.0f);
+    EXPECT_EQ(page.value().crop_box.height(), 200.0f);
+    EXPECT_EQ(page.value().rotate, 90);
+    EXPECT(page.value().resources->contains("Font"sv));
+    EXPECT(page.value().contents.has<Empty>());
+}
@@ -1099,3 +1099,97 @@ TEST_CASE(inversion_state_in_char_class)
         EXPECT_EQ(result.capture_group_matches.first()[1].view.to_string(), "}"sv);
     }
 }
+
+TEST_CASE(lazy_dfa)
+{
+    EXPECT_EQ(Regex<ECMA262>("(a|aa)+b"sv).parser_result.execution_engine, regex::ExecutionEngine::LazyDFA);
+    EXPECT_EQ(Regex<ECMA262>("(a)\\1"sv).parser_result.execution_engine, regex::ExecutionEngine::Backtracking);
+    EXPECT_EQ(Regex<ECMA262>("a(?=b)"sv).parser_result.execution_engine, regex::ExecutionEngine::Backtracking);
+    EXPECT_EQ(Regex<ECMA262>("(?<!a)b"sv).parser_result.execution_engine, regex::ExecutionEngine::Backtracking);
+
+    {
+        // This would take exponential time to fail if we backtracked from every position.
+        Regex<ECMA262> re("(a|aa)+b"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match(String::repeated('a', 80)).success, false);
+        EXPECT_EQ(re.has_match(String::formatted("{}b", String::repeated('a', 80))), true);
+    }
+    {
+        // Matches and captures still come from backtracking, only the start positions are chosen by the DFA.
+        Regex<ECMA262> re("needle(\\d+)"sv, ECMAScriptFlags::Global);
+        auto result = re.match("hay needle1 hay hay needle22 needle"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[1].view.to_string(), "needle22"sv);
+        EXPECT_EQ(result.matches[1].global_offset, 20u);
+        EXPECT_EQ(result.capture_group_matches[0][0].view.to_string(), "1"sv);
+        EXPECT_EQ(result.capture_group_matches[1][0].view.to_string(), "22"sv);
+    }
+
+    Array tests {
+        Tuple { "^foo"sv, "bar\nfoo"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Multiline, "foo"sv },
+        Tuple { "^foo"sv, "bar\nfoo"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, ""sv },
+        Tuple { "foo$"sv, "foo bar"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, ""sv },
+        Tuple { "\\bis\\b"sv, "this is"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, "is"sv },
+        Tuple { "a{2,3}c"sv, "acaacaaaac"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, "aac"sv },
+        Tuple { "[^a]b"sv, "abbb"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, "bb"sv },
+        Tuple { "x.y"sv, "x\ny xzy"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, "xzy"sv },
+        Tuple { "HELLO"sv, "say hello"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive, "hello"sv },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>(), test.get<2>());
+        EXPECT_EQ(re.parser_result.execution_engine, regex::ExecutionEngine::LazyDFA);
+        auto result = re.match(test.get<1>());
+        EXPECT_EQ(result.success, !test.get<3>().is_empty());
+        if (result.success)
+            EXPECT_EQ(result.matches.first().view.to_string(), test.get<3>());
+    }
+
+    {
+        // POSIX patterns compare whole strings at once.
+        Regex<PosixExtended> re("hello (friends|world)"sv, PosixFlags::Insensitive);
+        EXPECT_EQ(re.parser_result.execution_engine, regex::ExecutionEngine::LazyDFA);
+        auto result = re.search("well, HELLO WORLD"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), "HELLO WORLD"sv);
+        EXPECT_EQ(re.search("hello there, world"sv).success, false);
+    }
+}
+
+TEST_CASE(required_prefix)
+{
+    EXPECT_EQ(Regex<ECMA262>("(ab)c+d"sv).parser_result.required_prefix, (Vector<u32> { 'a', 'b', 'c' }));
+    EXPECT_EQ(Regex<ECMA262>("^\\bfoo|bar"sv).parser_result.required_prefix, Vector<u32> {});
+    EXPECT_EQ(Regex<PosixExtended>("^hello*"sv).parser_result.required_prefix, (Vector<u32> { 'h', 'e', 'l', 'l' }));
+
+    Array tests {
+        Tuple { "needle(\\d)"sv, "hay needle needle1 needle2"sv, 2u, "needle1"sv },
+        Tuple { "aab"sv, "aaab"sv, 1u, "aab"sv },
+        Tuple { "needle"sv, "haystack"sv, 0u, ""sv },
+    };
+
+    auto options = ECMAScriptOptions { ECMAScriptFlags::Global };
+    options.reset_flag((ECMAScriptFlags)regex::AllFlags::Internal_Stateful);
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>(), options);
+        auto result = re.match(test.get<1>());
+        EXPECT_EQ(result.matches.size(), test.get<2>());
+        if (result.success)
+            EXPECT_EQ(result.matches.first().view.to_string(), test.get<3>());
+
+        auto utf16 = AK::utf8_to_utf16(test.get<1>());
+        result = re.match(Utf16View { utf16 });
+        EXPECT_EQ(result.matches.size(), test.get<2>());
+        if (result.success)
+            EXPECT_EQ(result.matches.first().view.to_string(), test.get<3>());
+    }
+
+    {
+        Regex<PosixExtended> re("friends?"sv);
+        auto result = re.search("hello friend, hello friends"sv);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[1].view.to_string(), "friends"sv);
+        EXPECT_EQ(result.matches[1].global_offset, 20u);
+    }
+}
@@ -123,6 +123,7 @@ constexpr static u32 pointers[] = {
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Serializer&);
 void insert_and_get_to_and_from_btree(int);
 void insert_into_and_scan_btree(int);
+void bulk_load_and_scan_btree(int, int);
 
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Serializer& serializer)
 {
@@ -224,6 +225,91 @@ void insert_into_and_scan_btree(int num_keys)
     }
 }
 
+void bulk_load_and_scan_btree(int num_keys, int copies)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    NonnullRefPtr<SQL::TupleDescriptor> tuple_descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    tuple_descriptor->append({ "schema", "table", "key_value", SQL::SQLType::Integer, SQL::Order::Ascending });
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = SQL::BTree::construct(serializer, tuple_descriptor, false, 0);
+        btree->on_new_root = [&]() {
+            serializer.heap().set_user_value(0, btree->root());
+        };
+
+        Vector<SQL::Key> sorted_keys;
+        for (auto value = 0; value < num_keys; value++) {
+            for (auto copy = 0; copy < copies; copy++) {
+                SQL::Key k(tuple_descriptor);
+                k[0] = value;
+                k.set_pointer(value * copies + copy + 1);
+                sorted_keys.append(k);
+            }
+        }
+        EXPECT(btree->bulk_load(sorted_keys));
+
+        // The tree takes regular inserts after being bulk loaded.
+        SQL::Key k(tuple_descriptor);
+        k[0] = num_keys;
+        k.set_pointer(num_keys * copies + 1);
+        EXPECT(btree->insert(k));
+    }
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = SQL::BTree::construct(serializer, tuple_descriptor, false, heap->user_value(0));
+
+        int count = 0;
+        for (auto iter = btree->begin(); !iter.is_end(); iter++, count++)
+            EXPECT_EQ((*iter).pointer(), (u32)count + 1);
+        EXPECT_EQ(count, num_keys * copies + 1);
+
+        for (auto value = 0; value <= num_keys; value += 7) {
+            SQL::Key k(tuple_descriptor);
+            k[0] = value;
+            auto iter = btree->lower_bound(k);
+            EXPECT(!iter.is_end());
+            EXPECT_EQ((*iter).pointer(), (u32)(value * copies + 1));
+        }
+    }
+}
+
+TEST_CASE(btree_bulk_load)
+{
+    bulk_load_and_scan_btree(1, 1);
+    bulk_load_and_scan_btree(2, 1);
+    bulk_load_and_scan_btree(3000, 1);
+}
+
+TEST_CASE(btree_bulk_load_duplicates)
+{
+    bulk_load_and_scan_btree(1000, 5);
+}
+
+TEST_CASE(btree_bulk_load_rejects_duplicates_in_unique_tree)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    auto heap = SQL::Heap::construct("/tmp/test.db");
+    EXPECT(!heap->open().is_error());
+    SQL::Serializer serializer(heap);
+    NonnullRefPtr<SQL::TupleDescriptor> tuple_descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    tuple_descriptor->append({ "schema", "table", "key_value", SQL::SQLType::Integer, SQL::Order::Ascending });
+    auto btree = SQL::BTree::construct(serializer, tuple_descriptor, true, 0);
+
+    Vector<SQL::Key> sorted_keys;
+    for (auto value : { 1, 2, 2, 3 }) {
+        SQL::Key k(tuple_descriptor);
+        k[0] = value;
+        sorted_keys.append(k);
+    }
+    EXPECT(!btree->bulk_load(sorted_keys));
+}
+
 TEST_CASE(btree_one_key)
 {
     insert_and_get_to_and_from_btree(1);
@@ -7,6 +7,7 @@
 #include <unistd.h>
 
 #include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
@@ -116,7 +117,7 @@ TEST_CASE(create_heap)
     ScopeGuard guard([]() { unlink("/tmp/test.db"); });
     auto heap = SQL::Heap::construct("/tmp/test.db");
     EXPECT(!heap->open().is_error());
-    EXPECT_EQ(heap->version(), 0x00000001u);
+    EXPECT_EQ(heap->version(), 0x00000002u);
 }
 
 TEST_CASE(create_from_dev_random)
@@ -225,3 +226,48 @@ TEST_CASE(insert_100_into_table)
 {
     insert_and_verify(100);
 }
+
+TEST_CASE(log_is_removed_on_close)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        (void)setup_table(db);
+        commit(db);
+        EXPECT_EQ(access("/tmp/test.db-wal", F_OK), 0);
+    }
+    EXPECT_NE(access("/tmp/test.db-wal", F_OK), 0);
+}
+
+TEST_CASE(replay_log_after_crash)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/crashed.db");
+    });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        (void)setup_table(db);
+        insert_into_table(db, 100);
+        commit(db);
+
+        // Pretend the process died right after the log was synced, before
+        // any of the blocks made it to the heap file.
+        auto log = MUST(Core::File::open("/tmp/test.db-wal", Core::OpenMode::ReadOnly))->read_all();
+        EXPECT(!log.is_empty());
+        (void)MUST(Core::File::open("/tmp/crashed.db", Core::OpenMode::WriteOnly | Core::OpenMode::Truncate));
+        auto crashed_log = MUST(Core::File::open("/tmp/crashed.db-wal", Core::OpenMode::WriteOnly | Core::OpenMode::Truncate));
+        EXPECT(crashed_log->write(log.data(), (int)log.size()));
+
+        // A record that was only partially written when the process died is ignored.
+        EXPECT(crashed_log->write(log.data(), 100));
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/crashed.db");
+        EXPECT(!db->open().is_error());
+        verify_table_contents(db, 100);
+    }
+    EXPECT_NE(access("/tmp/crashed.db-wal", F_OK), 0);
+}
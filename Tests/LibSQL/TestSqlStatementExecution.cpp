@@ -754,4 +754,182 @@ TEST_CASE(binary_operator_failure)
     expect_failure(move(result), '&');
 }
 
+TEST_CASE(create_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+
+    auto result = execute(database, "CREATE INDEX IntIndex ON TestSchema.TestTable (IntColumn);");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    auto table_or_error = database->get_table("TESTSCHEMA", "TESTTABLE");
+    EXPECT(!table_or_error.is_error());
+    auto table = table_or_error.release_value();
+    EXPECT_EQ(table->num_indexes(), 1u);
+    EXPECT_EQ(table->indexes()[0].name(), "INTINDEX");
+    EXPECT_EQ(table->indexes()[0].key_definition()[0].name(), "INTCOLUMN");
+
+    auto expect_error = [&](StringView sql, SQL::SQLErrorCode expected_error) {
+        auto result = try_execute(database, sql);
+        EXPECT(result.is_error());
+        EXPECT_EQ(result.release_error().error(), expected_error);
+    };
+
+    expect_error("CREATE INDEX IntIndex ON TestSchema.TestTable (IntColumn);"sv, SQL::SQLErrorCode::IndexExists);
+    expect_error("CREATE INDEX OtherIndex ON TestSchema.DoesNotExist (IntColumn);"sv, SQL::SQLErrorCode::TableDoesNotExist);
+    expect_error("CREATE INDEX OtherIndex ON TestSchema.TestTable (DoesNotExist);"sv, SQL::SQLErrorCode::ColumnDoesNotExist);
+    EXPECT(!try_execute(database, "CREATE INDEX IF NOT EXISTS IntIndex ON TestSchema.TestTable (IntColumn);").is_error());
+}
+
+TEST_CASE(select_using_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+
+    // Insert the rows in a scrambled order, half of them before the indexes exist and half after.
+    auto insert_rows = [&](int first, int last) {
+        for (auto count = first; count < last; ++count) {
+            auto value = (count * 37) % 500;
+            auto result = execute(database, String::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{:03}', {} );", value, value / 2));
+            EXPECT_EQ(result.size(), 1u);
+        }
+    };
+    insert_rows(0, 250);
+    execute(database, "CREATE INDEX IntIndex ON TestSchema.TestTable (IntColumn);");
+    execute(database, "CREATE INDEX TextIndex ON TestSchema.TestTable (TextColumn, IntColumn);");
+    insert_rows(250, 500);
+
+    auto expect_plan = [&](StringView where_clause, StringView expected_plan) {
+        auto result = execute(database, String::formatted("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE {};", where_clause));
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0].to_string(), expected_plan);
+    };
+
+    auto expect_rows = [&](StringView where_clause, Function<bool(int)> predicate) {
+        auto result = execute(database, String::formatted("SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE {};", where_clause));
+
+        Vector<int> result_values;
+        for (auto& row : result) {
+            auto value = row.row[0].to_string().substring(1).to_int().value();
+            EXPECT_EQ(row.row[1].to_int().value(), value / 2);
+            result_values.append(value);
+        }
+        quick_sort(result_values);
+
+        Vector<int> expected_values;
+        for (auto value = 0; value < 500; ++value) {
+            if (predicate(value))
+                expected_values.append(value);
+        }
+        EXPECT_EQ(result_values, expected_values);
+    };
+
+    expect_plan("IntColumn = 7"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN = 7)"sv);
+    expect_rows("IntColumn = 7"sv, [](int value) { return value / 2 == 7; });
+
+    expect_plan("IntColumn > 200"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN > 200)"sv);
+    expect_rows("IntColumn > 200"sv, [](int value) { return value / 2 > 200; });
+
+    expect_plan("10 >= IntColumn"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN <= 10)"sv);
+    expect_rows("10 >= IntColumn"sv, [](int value) { return value / 2 <= 10; });
+
+    expect_plan("(IntColumn >= 20) AND ((IntColumn < 30) AND (IntColumn > 19))"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN >= 20 AND INTCOLUMN < 30)"sv);
+    expect_rows("(IntColumn >= 20) AND ((IntColumn < 30) AND (IntColumn > 19))"sv, [](int value) { return value / 2 >= 20 && value / 2 < 30; });
+
+    expect_plan("(IntColumn > 5) AND (TextColumn = 'T100')"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX TEXTINDEX (TEXTCOLUMN = 'T100')"sv);
+    expect_rows("(IntColumn > 5) AND (TextColumn = 'T100')"sv, [](int value) { return value == 100; });
+
+    expect_plan("TextColumn >= 'T490'"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX TEXTINDEX (TEXTCOLUMN >= 'T490')"sv);
+    expect_rows("TextColumn >= 'T490'"sv, [](int value) { return value >= 490; });
+
+    expect_plan("(IntColumn > 10) AND (IntColumn < 5)"sv, "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN > 10 AND INTCOLUMN < 5)"sv);
+    expect_rows("(IntColumn > 10) AND (IntColumn < 5)"sv, [](int) { return false; });
+
+    // These can't use an index, and have to fall back to scanning the whole table.
+    expect_plan("(IntColumn = 7) OR (IntColumn = 8)"sv, "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+    expect_rows("(IntColumn = 7) OR (IntColumn = 8)"sv, [](int value) { return value / 2 == 7 || value / 2 == 8; });
+
+    expect_plan("(IntColumn + 1) = 8"sv, "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+    expect_plan("IntColumn = 7.5"sv, "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+    expect_plan("'T100' = TextColumn"sv, "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+}
+
+TEST_CASE(select_with_batched_where_clause)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+
+    // Enough rows to span a few batches.
+    for (auto count = 0; count < 2500; ++count) {
+        auto result = execute(database, String::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{:04}', {} );", count, count % 100));
+        EXPECT_EQ(result.size(), 1u);
+    }
+
+    auto select = [&](StringView where_clause) {
+        auto result = execute(database, String::formatted("SELECT TextColumn FROM TestSchema.TestTable WHERE {};", where_clause));
+        Vector<int> values;
+        for (auto& row : result)
+            values.append(row.row[0].to_string().substring(1).to_int().value());
+        quick_sort(values);
+        return values;
+    };
+
+    auto expect_rows = [&](StringView where_clause, Function<bool(int)> predicate) {
+        Vector<int> expected_values;
+        for (auto value = 0; value < 2500; ++value) {
+            if (predicate(value))
+                expected_values.append(value);
+        }
+        EXPECT_EQ(select(where_clause), expected_values);
+
+        // The OR keeps the WHERE clause from being evaluated in batches, so this evaluates it row by row instead.
+        EXPECT_EQ(select(String::formatted("({}) OR (1 = 0)", where_clause)), expected_values);
+    };
+
+    expect_rows("IntColumn = 7"sv, [](int value) { return value % 100 == 7; });
+    expect_rows("IntColumn <> 7"sv, [](int value) { return value % 100 != 7; });
+    expect_rows("IntColumn < 7.5"sv, [](int value) { return value % 100 < 8; });
+    expect_rows("7.5 < IntColumn"sv, [](int value) { return value % 100 > 7; });
+    expect_rows("IntColumn > -1"sv, [](int) { return true; });
+    expect_rows("IntColumn = NULL"sv, [](int) { return false; });
+    expect_rows("IntColumn >= 'abc'"sv, [](int) { return true; });
+    expect_rows("TextColumn >= 'T2400'"sv, [](int value) { return value >= 2400; });
+    expect_rows("'T0100' > TextColumn"sv, [](int value) { return value < 100; });
+    expect_rows("(TextColumn < 'T1000') AND (IntColumn >= 50) AND (IntColumn <= 52)"sv, [](int value) { return value < 1000 && value % 100 >= 50 && value % 100 <= 52; });
+    expect_rows("(TestTable.IntColumn > 90) AND (TextColumn <> 'T0095')"sv, [](int value) { return value % 100 > 90 && value != 95; });
+}
+
+TEST_CASE(index_survives_reopening_database)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+        create_table(database);
+        execute(database, "CREATE INDEX IntIndex ON TestSchema.TestTable (IntColumn);");
+        for (auto count = 0; count < 100; ++count)
+            execute(database, String::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+        EXPECT(!database->commit().is_error());
+    }
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+        auto result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn < 10;");
+        EXPECT_EQ(result[0].row[0].to_string(), "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX INTINDEX (INTCOLUMN < 10)");
+
+        execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T100', 5 );");
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 5;");
+        EXPECT_EQ(result.size(), 2u);
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn < 10;");
+        EXPECT_EQ(result.size(), 11u);
+    }
+}
+
 }
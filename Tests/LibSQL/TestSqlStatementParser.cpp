@@ -776,3 +776,69 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(create_index)
+{
+    EXPECT(parse("CREATE INDEX"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name ();"sv).is_error());
+    EXPECT(parse("CREATE INDEX IF EXISTS index_name ON table_name (column_name);"sv).is_error());
+    EXPECT(parse("CREATE INDEX schema1.index_name ON schema2.table_name (column_name);"sv).is_error());
+
+    auto validate = [](StringView sql, StringView expected_schema, StringView expected_index, StringView expected_table, Vector<StringView> expected_columns, bool expected_is_unique, bool expected_is_error_if_index_exists) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::CreateIndex>(*statement));
+
+        auto const& create_index = static_cast<SQL::AST::CreateIndex const&>(*statement);
+        EXPECT_EQ(create_index.schema_name(), expected_schema);
+        EXPECT_EQ(create_index.index_name(), expected_index);
+        EXPECT_EQ(create_index.table_name(), expected_table);
+        EXPECT_EQ(create_index.is_unique(), expected_is_unique);
+        EXPECT_EQ(create_index.is_error_if_index_exists(), expected_is_error_if_index_exists);
+
+        auto const& indexed_columns = create_index.indexed_columns();
+        EXPECT_EQ(indexed_columns.size(), expected_columns.size());
+        for (size_t i = 0; i < indexed_columns.size(); ++i) {
+            auto const& expression = indexed_columns[i].expression();
+            EXPECT(is<SQL::AST::ColumnNameExpression>(*expression));
+            EXPECT_EQ(static_cast<SQL::AST::ColumnNameExpression const&>(*expression).column_name(), expected_columns[i]);
+        }
+    };
+
+    validate("CREATE INDEX index_name ON table_name (column_name);"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN_NAME"sv }, false, true);
+    validate("CREATE INDEX schema_name.index_name ON table_name (column_name);"sv, "SCHEMA_NAME"sv, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN_NAME"sv }, false, true);
+    validate("CREATE INDEX index_name ON schema_name.table_name (column_name);"sv, "SCHEMA_NAME"sv, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN_NAME"sv }, false, true);
+    validate("CREATE INDEX index_name ON table_name (column1, column2 DESC);"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv, "COLUMN2"sv }, false, true);
+    validate("CREATE UNIQUE INDEX index_name ON table_name (column_name);"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN_NAME"sv }, true, true);
+    validate("CREATE INDEX IF NOT EXISTS index_name ON table_name (column_name);"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN_NAME"sv }, false, false);
+}
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN"sv).is_error());
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY PLAN;"sv).is_error());
+    EXPECT(parse("EXPLAIN DESCRIBE TABLE table_name;"sv).is_error());
+
+    auto validate = [](StringView sql) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::Explain>(*statement));
+        EXPECT(is<SQL::AST::Select>(*static_cast<SQL::AST::Explain const&>(*statement).select_statement()));
+    };
+
+    validate("EXPLAIN SELECT * FROM table_name;"sv);
+    validate("EXPLAIN QUERY PLAN SELECT * FROM table_name WHERE column_name = 1;"sv);
+}
@@ -113,3 +113,19 @@ TEST_CASE(test_TLS_hello_handshake)
 
     loop.exec();
 }
+
+TEST_CASE(test_TLS_session_resumption)
+{
+    auto session_cache = TLS::SessionCache::create();
+    for (size_t i = 0; i < 2; ++i) {
+        Core::EventLoop loop;
+        TLS::Options options;
+        options.set_root_certificates(s_root_ca_certificates);
+        options.set_session_cache(session_cache);
+
+        auto tls = MUST(TLS::TLSv12::connect(DEFAULT_SERVER, port, move(options)));
+        EXPECT(tls->is_established());
+        EXPECT_EQ(session_cache->size(), 1u);
+        tls->close();
+    }
+}
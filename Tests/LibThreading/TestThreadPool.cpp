@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(parallel_for_visits_every_index_once)
+{
+    Threading::ThreadPool pool(4);
+    Array<Atomic<int>, 10000> visits {};
+
+    pool.parallel_for(0, visits.size(), [&](size_t i) { visits[i].fetch_add(1); });
+
+    for (auto& count : visits)
+        EXPECT_EQ(count.load(), 1);
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    Threading::ThreadPool pool(2);
+    Atomic<size_t> total { 0 };
+
+    pool.parallel_for(0, 16, [&](size_t) {
+        pool.parallel_for(0, 100, [&](size_t) { total.fetch_add(1); }, 1);
+    },
+        1);
+
+    EXPECT_EQ(total.load(), 1600u);
+}
+
+TEST_CASE(submitted_tasks_run_before_destruction)
+{
+    Atomic<int> count { 0 };
+    {
+        Threading::ThreadPool pool(3);
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&] { count.fetch_add(1); }, i % 2 ? Threading::ThreadPool::Priority::Low : Threading::ThreadPool::Priority::High);
+    }
+    EXPECT_EQ(count.load(), 1000);
+}
+
+TEST_CASE(run_resolves_promise_on_event_loop)
+{
+    Core::EventLoop loop;
+    Threading::ThreadPool pool(2);
+
+    auto promise = pool.run<int>([] { return 42; });
+    EXPECT_EQ(promise->await(), 42);
+}
+
+TEST_CASE(parallel_sort)
+{
+    Threading::ThreadPool pool(4);
+    Vector<u32> values;
+    for (size_t i = 0; i < 100000; ++i)
+        values.append(get_random<u32>());
+
+    pool.parallel_sort(values.span());
+
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+}
+
+TEST_CASE(parallel_sort_with_comparator)
+{
+    Threading::ThreadPool pool(3);
+    Vector<int> values;
+    for (int i = 0; i < 50000; ++i)
+        values.append(i);
+
+    pool.parallel_sort(values.span(), [](auto a, auto b) { return a > b; });
+
+    for (int i = 0; i < 50000; ++i)
+        EXPECT_EQ(values[i], 49999 - i);
+}
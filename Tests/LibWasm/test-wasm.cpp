@@ -122,7 +122,7 @@ TESTJS_GLOBAL_FUNCTION(parse_webassembly_module, parseWebAssemblyModule)
     auto import_value = vm.argument(1);
     if (import_value.is_object()) {
         auto& import_object = import_value.as_object();
-        for (auto& property : import_object.shape().property_table()) {
+        for (auto& property : import_object.shape().property_table_ordered()) {
             auto value = import_object.get_without_side_effects(property.key);
             if (!value.is_object() || !is<WebAssemblyModule>(value.as_object()))
                 continue;
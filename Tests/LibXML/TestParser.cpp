@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/StringBuilder.h>
+#include <LibCore/MemoryStream.h>
 #include <LibTest/TestCase.h>
 #include <LibXML/Parser/Parser.h>
 
@@ -29,3 +31,34 @@ TEST_CASE(character_reference_integer_overflow)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+struct EventRecorder : public XML::Listener {
+    virtual void element_start(XML::Name const& name, HashMap<XML::Name, String> const& attributes) override
+    {
+        builder.appendff("<{}", name);
+        if (auto value = attributes.get("a"); value.has_value())
+            builder.appendff(" a={}", *value);
+        builder.append('>');
+    }
+    virtual void element_end(XML::Name const& name) override { builder.appendff("</{}>", name); }
+    virtual void text(String const& text) override { builder.append(text); }
+
+    StringBuilder builder;
+};
+
+TEST_CASE(listener_events)
+{
+    XML::Parser parser("<a a=\"1\">x<b/>y<c>z</c></a>"sv);
+    EventRecorder recorder;
+    EXPECT(!parser.parse_with_listener(recorder).is_error());
+    EXPECT_EQ(recorder.builder.string_view(), "<a a=1>x<b></b>y<c>z</c></a>"sv);
+}
+
+TEST_CASE(listener_events_from_stream)
+{
+    auto source = "<a><b>text</b><c a=\"2\"/></a>"sv;
+    auto stream = MUST(Core::Stream::MemoryStream::construct({ const_cast<u8*>(source.bytes().data()), source.length() }));
+    EventRecorder recorder;
+    EXPECT(!XML::Parser::parse_stream_with_listener(*stream, recorder, {}).is_error());
+    EXPECT_EQ(recorder.builder.string_view(), "<a><b>text</b><c a=2></c></a>"sv);
+}
@@ -24,6 +24,7 @@
 #include <LibGUI/TabWidget.h>
 #include <LibMain/Main.h>
 #include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWebView/OutOfProcessWebView.h>
 #include <LibWebView/RequestServerAdapter.h>
 #include <unistd.h>
 
@@ -129,6 +130,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (!specified_urls.is_empty())
         first_url = url_from_argument_string(specified_urls.first());
 
+    // New tabs are opened often enough that it's worth having their WebContent process ready before they are.
+    WebView::OutOfProcessWebView::set_prewarm_web_content_process(true);
+
     Browser::CookieJar cookie_jar;
     auto window = Browser::BrowserWindow::construct(cookie_jar, first_url);
 
@@ -30,6 +30,7 @@ void Cell::set_data(String new_data)
     }
 
     m_data = move(new_data);
+    m_compiled_formula = nullptr;
     m_dirty = true;
     m_evaluated_externally = false;
 }
@@ -43,6 +44,7 @@ void Cell::set_data(JS::Value new_data)
 
     builder.append(new_data.to_string_without_side_effects());
     m_data = builder.build();
+    m_compiled_formula = nullptr;
 
     m_evaluated_data = move(new_data);
 }
@@ -95,26 +97,22 @@ void Cell::update_data(Badge<Sheet>)
     TemporaryChange cell_change { m_sheet->current_evaluated_cell(), this };
     if (!m_dirty)
         return;
-
-    if (m_dirty) {
-        m_dirty = false;
-        if (m_kind == Formula) {
-            if (!m_evaluated_externally) {
-                auto value_or_error = m_sheet->evaluate(m_data, this);
-                if (value_or_error.is_error()) {
-                    m_evaluated_data = JS::js_undefined();
-                    m_thrown_value = *value_or_error.release_error().release_value();
-                } else {
-                    m_evaluated_data = value_or_error.release_value();
-                    m_thrown_value = {};
-                }
-            }
-        }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
+    m_dirty = false;
+
+    // Whatever this cell reads this time around is recorded again while evaluating it.
+    // Note: Cells that got their value from another cell keep the reference to it, since they are not evaluated themselves.
+    if (!m_evaluated_externally)
+        clear_references();
+
+    if (m_kind == Formula) {
+        if (!m_evaluated_externally) {
+            auto value_or_error = evaluate_formula();
+            if (value_or_error.is_error()) {
+                m_evaluated_data = JS::js_undefined();
+                m_thrown_value = *value_or_error.release_error().release_value();
+            } else {
+                m_evaluated_data = value_or_error.release_value();
+                m_thrown_value = {};
             }
         }
     }
@@ -140,6 +138,14 @@ void Cell::update_data(Badge<Sheet>)
     }
 }
 
+JS::ThrowCompletionOr<JS::Value> Cell::evaluate_formula()
+{
+    // The formula only gets parsed again once it changes, recalculating the cell just runs it.
+    if (!m_compiled_formula)
+        m_compiled_formula = TRY(m_sheet->parse(m_data, this));
+    return m_sheet->run(*m_compiled_formula, this);
+}
+
 void Cell::update()
 {
     m_sheet->update(*this);
@@ -175,6 +181,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::clear_references()
+{
+    for (auto& referenced_cell : m_referenced_cells) {
+        if (referenced_cell)
+            referenced_cell->m_referencing_cells.remove_all_matching([this](auto const& ptr) { return !ptr || ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(Cell const& other)
@@ -182,6 +198,7 @@ void Cell::copy_from(Cell const& other)
     m_dirty = true;
     m_evaluated_externally = other.m_evaluated_externally;
     m_data = other.m_data;
+    m_compiled_formula = nullptr;
     m_evaluated_data = other.m_evaluated_data;
     m_kind = other.m_kind;
     m_type = other.m_type;
@@ -15,6 +15,7 @@
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
 #include <LibGUI/Command.h>
+#include <LibJS/Script.h>
 
 namespace Spreadsheet {
 
@@ -44,10 +45,12 @@ struct Cell : public Weakable<Cell> {
     }
 
     void reference_from(Cell*);
+    void clear_references();
 
     void set_data(String new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void set_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
 
     StringView name_for_javascript(Sheet const& sheet) const
@@ -71,6 +74,7 @@ struct Cell : public Weakable<Cell> {
     const JS::Value& evaluated_data() const { return m_evaluated_data; }
     Kind kind() const { return m_kind; }
     Vector<WeakPtr<Cell>> const& referencing_cells() const { return m_referencing_cells; }
+    Vector<WeakPtr<Cell>> const& referenced_cells() const { return m_referenced_cells; }
 
     void set_type(StringView name);
     void set_type(CellType const*);
@@ -82,6 +86,8 @@ struct Cell : public Weakable<Cell> {
         if (position != m_position) {
             m_dirty = true;
             m_position = move(position);
+            m_name_for_javascript = {};
+            m_compiled_formula = nullptr;
         }
     }
 
@@ -114,6 +120,8 @@ struct Cell : public Weakable<Cell> {
     void copy_from(Cell const&);
 
 private:
+    JS::ThrowCompletionOr<JS::Value> evaluate_formula();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
     String m_data;
@@ -121,7 +129,10 @@ private:
     JS::Value m_thrown_value;
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
+    // The cells that have to be updated after this one, and the ones this one was evaluated from.
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
+    RefPtr<JS::Script> m_compiled_formula;
     CellType const* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
@@ -128,18 +128,65 @@ void Sheet::update()
         return;
     }
     m_visited_cells_in_update.clear();
-    Vector<Cell&> cells_copy;
+    Vector<Cell*> dirty_cells;
 
     // Grab a copy as updates might insert cells into the table.
     for (auto& it : m_cells) {
         if (it.value->dirty()) {
-            cells_copy.append(*it.value);
+            dirty_cells.append(it.value);
             m_workbook.set_dirty(true);
         }
     }
 
-    for (auto& cell : cells_copy)
-        update(cell);
+    // Everything that depends on a changed cell has to be recalculated as well.
+    // Note: Cells of other sheets are only marked, they get recalculated once they are read, or their own sheet updates.
+    for (size_t i = 0; i < dirty_cells.size(); ++i) {
+        for (auto& referencing_cell_ptr : dirty_cells[i]->referencing_cells()) {
+            auto* referencing_cell = referencing_cell_ptr.ptr();
+            if (!referencing_cell || referencing_cell->dirty())
+                continue;
+            referencing_cell->set_dirty();
+            if (&referencing_cell->sheet() == this)
+                dirty_cells.append(referencing_cell);
+        }
+    }
+
+    // Recalculate every cell after all the cells it depends on, so that each of them is evaluated only once.
+    HashMap<Cell*, size_t> pending_dependency_counts;
+    for (auto* cell : dirty_cells)
+        pending_dependency_counts.set(cell, 0);
+    for (auto* cell : dirty_cells) {
+        for (auto& referencing_cell : cell->referencing_cells()) {
+            if (auto it = pending_dependency_counts.find(referencing_cell.ptr()); it != pending_dependency_counts.end())
+                ++it->value;
+        }
+    }
+
+    Vector<Cell*> ready_cells;
+    for (auto* cell : dirty_cells) {
+        if (pending_dependency_counts.get(cell).value() == 0)
+            ready_cells.append(cell);
+    }
+
+    for (size_t i = 0; i < ready_cells.size(); ++i) {
+        auto* cell = ready_cells[i];
+        for (auto& referencing_cell : cell->referencing_cells()) {
+            auto it = pending_dependency_counts.find(referencing_cell.ptr());
+            if (it == pending_dependency_counts.end() || it->value == 0)
+                continue;
+            if (--it->value == 0)
+                ready_cells.append(it->key);
+        }
+        update(*cell);
+    }
+
+    // Whatever is left is part of a cyclic reference chain, and is updated in no particular order.
+    if (ready_cells.size() != dirty_cells.size()) {
+        for (auto* cell : dirty_cells) {
+            if (pending_dependency_counts.get(cell).value() != 0)
+                update(*cell);
+        }
+    }
 
     m_visited_cells_in_update.clear();
 }
@@ -164,7 +211,12 @@ void Sheet::update(Cell& cell)
 
 JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
 {
-    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
+    auto script = TRY(parse(source, on_behalf_of));
+    return run(script, on_behalf_of);
+}
+
+JS::ThrowCompletionOr<NonnullRefPtr<JS::Script>> Sheet::parse(StringView source, Cell* on_behalf_of)
+{
     auto name = on_behalf_of ? on_behalf_of->name_for_javascript(*this) : "cell <unknown>"sv;
     auto script_or_error = JS::Script::parse(
         source,
@@ -174,7 +226,13 @@ JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_beh
     if (script_or_error.is_error())
         return interpreter().vm().throw_completion<JS::SyntaxError>(script_or_error.error().first().to_string());
 
-    return interpreter().run(script_or_error.value());
+    return script_or_error.release_value();
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::run(JS::Script& script, Cell* on_behalf_of)
+{
+    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
+    return interpreter().run(script);
 }
 
 Cell* Sheet::at(StringView name)
@@ -702,10 +760,10 @@ JsonObject Sheet::gather_documentation() const
             dbgln("Sheet::gather_documentation(): Failed to parse the documentation for '{}'!", it.key.to_display_string());
     };
 
-    for (auto& it : interpreter().realm().global_object().shape().property_table())
+    for (auto& it : interpreter().realm().global_object().shape().property_table_ordered())
         add_docs_from(it, interpreter().realm().global_object());
 
-    for (auto& it : global_object().shape().property_table())
+    for (auto& it : global_object().shape().property_table_ordered())
         add_docs_from(it, global_object());
 
     m_cached_documentation = move(object);
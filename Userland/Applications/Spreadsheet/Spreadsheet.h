@@ -122,6 +122,8 @@ public:
     }
 
     JS::ThrowCompletionOr<JS::Value> evaluate(StringView, Cell* = nullptr);
+    JS::ThrowCompletionOr<NonnullRefPtr<JS::Script>> parse(StringView, Cell* = nullptr);
+    JS::ThrowCompletionOr<JS::Value> run(JS::Script&, Cell* = nullptr);
     JS::Interpreter& interpreter() const;
     SheetGlobalObject& global_object() const { return *m_global_object; }
 
@@ -99,6 +99,10 @@ String ProcessModel::column_name(int column) const
         return "Private";
     case Column::CleanInode:
         return "CleanI";
+    case Column::Unique:
+        return "USS";
+    case Column::Proportional:
+        return "PSS";
     case Column::PurgeableVolatile:
         return "Purg:V";
     case Column::PurgeableNonvolatile:
@@ -161,6 +165,8 @@ GUI::Variant ProcessModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
         case Column::Physical:
         case Column::DirtyPrivate:
         case Column::CleanInode:
+        case Column::Unique:
+        case Column::Proportional:
         case Column::PurgeableVolatile:
         case Column::PurgeableNonvolatile:
         case Column::CPU:
@@ -211,6 +217,10 @@ GUI::Variant ProcessModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
             return (int)thread.current_state.amount_dirty_private;
         case Column::CleanInode:
             return (int)thread.current_state.amount_clean_inode;
+        case Column::Unique:
+            return (int)thread.current_state.amount_unique;
+        case Column::Proportional:
+            return (int)thread.current_state.amount_proportional;
         case Column::PurgeableVolatile:
             return (int)thread.current_state.amount_purgeable_volatile;
         case Column::PurgeableNonvolatile:
@@ -277,6 +287,10 @@ GUI::Variant ProcessModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
             return human_readable_size(thread.current_state.amount_dirty_private);
         case Column::CleanInode:
             return human_readable_size(thread.current_state.amount_clean_inode);
+        case Column::Unique:
+            return human_readable_size(thread.current_state.amount_unique);
+        case Column::Proportional:
+            return human_readable_size(thread.current_state.amount_proportional);
         case Column::PurgeableVolatile:
             return human_readable_size(thread.current_state.amount_purgeable_volatile);
         case Column::PurgeableNonvolatile:
@@ -453,6 +467,8 @@ void ProcessModel::update()
                 state.amount_resident = process.amount_resident;
                 state.amount_dirty_private = process.amount_dirty_private;
                 state.amount_clean_inode = process.amount_clean_inode;
+                state.amount_unique = process.amount_unique;
+                state.amount_proportional = process.amount_proportional;
                 state.amount_purgeable_volatile = process.amount_purgeable_volatile;
                 state.amount_purgeable_nonvolatile = process.amount_purgeable_nonvolatile;
                 state.syscall_count = thread.syscall_count;
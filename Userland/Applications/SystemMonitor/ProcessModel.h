@@ -34,6 +34,8 @@ public:
         Pledge,
         Physical,
         CleanInode,
+        Unique,
+        Proportional,
         PurgeableVolatile,
         PurgeableNonvolatile,
         Veil,
@@ -115,6 +117,8 @@ private:
         size_t amount_resident { 0 };
         size_t amount_dirty_private { 0 };
         size_t amount_clean_inode { 0 };
+        size_t amount_unique { 0 };
+        size_t amount_proportional { 0 };
         size_t amount_purgeable_volatile { 0 };
         size_t amount_purgeable_nonvolatile { 0 };
         unsigned syscall_count { 0 };
@@ -159,6 +163,8 @@ private:
             this->amount_resident = other.amount_resident;
             this->amount_dirty_private = other.amount_dirty_private;
             this->amount_clean_inode = other.amount_clean_inode;
+            this->amount_unique = other.amount_unique;
+            this->amount_proportional = other.amount_proportional;
             this->amount_purgeable_volatile = other.amount_purgeable_volatile;
             this->amount_purgeable_nonvolatile = other.amount_purgeable_nonvolatile;
             this->syscall_count = other.syscall_count;
@@ -19,7 +19,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto app = TRY(GUI::Application::try_create(arguments));
     auto window = TRY(GUI::Window::try_create());
 
-    auto document = Video::MatroskaReader::parse_matroska_from_file("/home/anon/Videos/test-webm.webm"sv);
+    auto reader = Video::MatroskaReader::open_file("/home/anon/Videos/test-webm.webm"sv);
+    if (!reader)
+        return 1;
+    auto document = reader->parse_headers();
+    if (!document)
+        return 1;
     auto const& optional_track = document->track_for_track_type(Video::TrackEntry::TrackType::Video);
     if (!optional_track.has_value())
         return 1;
@@ -36,8 +41,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(main_widget->try_add_child(image_widget));
 
     Video::VP9::Decoder vp9_decoder;
-    for (auto const& cluster : document->clusters()) {
-        for (auto const& block : cluster.blocks()) {
+    // Clusters are only read as they are needed, so decoding can start right after the first one.
+    while (auto cluster = reader->read_next_cluster()) {
+        for (auto const& block : cluster->blocks()) {
             if (block.track_number() != track.track_number())
                 continue;
 
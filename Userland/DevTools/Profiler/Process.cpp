@@ -43,6 +43,21 @@ void Process::handle_thread_exit(pid_t tid, EventSerialNumber serial)
 
 HashMap<String, OwnPtr<MappedObject>> g_mapped_object_cache;
 
+String MappedObject::symbolicate(FlatPtr address, u32* offset)
+{
+    if (auto it = symbol_cache.find(address); it != symbol_cache.end()) {
+        if (offset)
+            *offset = it->value.offset;
+        return it->value.name;
+    }
+    u32 symbol_offset = 0;
+    auto name = elf.symbolicate(address, &symbol_offset);
+    symbol_cache.set(address, { name, symbol_offset });
+    if (offset)
+        *offset = symbol_offset;
+    return name;
+}
+
 static MappedObject* get_or_create_mapped_object(String const& path)
 {
     if (auto it = g_mapped_object_cache.find(path); it != g_mapped_object_cache.end())
@@ -121,7 +136,7 @@ String LibraryMetadata::Library::symbolicate(FlatPtr ptr, u32* offset) const
     if (!object)
         return String::formatted("?? <{:p}>", ptr);
 
-    return object->elf.symbolicate(ptr - base, offset);
+    return object->symbolicate(ptr - base, offset);
 }
 
 LibraryMetadata::Library const* LibraryMetadata::library_containing(FlatPtr ptr) const
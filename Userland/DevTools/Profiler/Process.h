@@ -19,6 +19,15 @@ namespace Profiler {
 struct MappedObject {
     NonnullRefPtr<Core::MappedFile> file;
     ELF::Image elf;
+
+    // The same few addresses show up in most samples of a profile, so every one of them is only symbolicated once.
+    struct Symbol {
+        String name;
+        u32 offset { 0 };
+    };
+    HashMap<FlatPtr, Symbol> symbol_cache {};
+
+    String symbolicate(FlatPtr address, u32* offset);
 };
 
 extern HashMap<String, OwnPtr<MappedObject>> g_mapped_object_cache;
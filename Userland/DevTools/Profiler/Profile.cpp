@@ -9,13 +9,15 @@
 #include "ProfileModel.h"
 #include "SamplesModel.h"
 #include "SourceModel.h"
+#include <AK/Array.h>
+#include <AK/CharacterTypes.h>
+#include <AK/GenericLexer.h>
 #include <AK/HashTable.h>
 #include <AK/LexicalPath.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/QuickSort.h>
 #include <AK/RefPtr.h>
 #include <AK/Try.h>
-#include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibELF/Image.h>
 #include <LibSymbolication/Symbolication.h>
@@ -41,6 +43,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     for (size_t i = 0; i < m_events.size(); ++i) {
         if (m_events[i].data.has<Event::SignpostData>())
             m_signpost_indices.append(i);
+        else if (m_events[i].data.has<Event::LockContentionData>())
+            m_lock_contention_indices.append(i);
     }
 
     m_first_timestamp = m_events.first().timestamp;
@@ -122,6 +126,9 @@ void Profile::rebuild_tree()
             continue;
         }
 
+        if (!sample_counter_filter_contains(event))
+            continue;
+
         m_filtered_event_indices.append(event_index);
 
         if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
@@ -234,15 +241,120 @@ void Profile::rebuild_tree()
 Optional<MappedObject> g_kernel_debuginfo_object;
 OwnPtr<Debug::DebugInfo> g_kernel_debug_info;
 
-ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path)
+// Perfcore files easily grow to hundreds of megabytes, which is way too much to parse into a single JsonValue.
+// Instead, we only look for where values begin and end, and parse the events one by one.
+static Optional<size_t> find_end_of_json_value(StringView json, size_t offset)
+{
+    auto skip_string = [&](size_t offset) -> Optional<size_t> {
+        for (++offset; offset < json.length(); ++offset) {
+            if (json[offset] == '\\')
+                ++offset;
+            else if (json[offset] == '"')
+                return offset + 1;
+        }
+        return {};
+    };
+
+    if (offset >= json.length())
+        return {};
+    if (json[offset] == '"')
+        return skip_string(offset);
+
+    if (json[offset] != '{' && json[offset] != '[') {
+        while (offset < json.length() && !is_any_of(",]} \t\r\n"sv)(json[offset]))
+            ++offset;
+        return offset;
+    }
+
+    size_t depth = 0;
+    while (offset < json.length()) {
+        switch (json[offset]) {
+        case '"': {
+            auto end = skip_string(offset);
+            if (!end.has_value())
+                return {};
+            offset = end.value();
+            continue;
+        }
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0)
+                return offset + 1;
+            break;
+        default:
+            break;
+        }
+        ++offset;
+    }
+    return {};
+}
+
+// Calls the callback with the key and the unparsed value of every member of a JSON object, or with an empty key and
+// every element of a JSON array.
+template<typename Callback>
+static ErrorOr<void> for_each_json_member(StringView json, Callback callback)
 {
-    auto file = TRY(Core::File::open(path, Core::OpenMode::ReadOnly));
+    GenericLexer lexer { json };
+    lexer.ignore_while(is_ascii_space);
+    bool is_object = lexer.consume_specific('{');
+    if (!is_object && !lexer.consume_specific('['))
+        return Error::from_string_literal("Invalid perfcore format (expected a JSON object or array)");
+    auto closing = is_object ? '}' : ']';
+
+    lexer.ignore_while(is_ascii_space);
+    if (lexer.consume_specific(closing))
+        return {};
+
+    while (!lexer.is_eof()) {
+        StringView key;
+        if (is_object) {
+            // NOTE: None of the keys we look for have escapes in them.
+            auto key_end = find_end_of_json_value(json, lexer.tell());
+            if (!lexer.next_is('"') || !key_end.has_value())
+                return Error::from_string_literal("Invalid perfcore format (malformed key)");
+            key = json.substring_view(lexer.tell() + 1, key_end.value() - lexer.tell() - 2);
+            lexer.ignore(key_end.value() - lexer.tell());
+            lexer.ignore_while(is_ascii_space);
+            if (!lexer.consume_specific(':'))
+                return Error::from_string_literal("Invalid perfcore format (expected ':')");
+            lexer.ignore_while(is_ascii_space);
+        }
 
-    auto json = JsonValue::from_string(file->read_all());
-    if (json.is_error() || !json.value().is_object())
-        return Error::from_string_literal("Invalid perfcore format (not a JSON object)");
+        auto value_end = find_end_of_json_value(json, lexer.tell());
+        if (!value_end.has_value())
+            return Error::from_string_literal("Invalid perfcore format (truncated value)");
+        auto value = json.substring_view(lexer.tell(), value_end.value() - lexer.tell());
+        lexer.ignore(value.length());
+        TRY(callback(key, value));
+
+        lexer.ignore_while(is_ascii_space);
+        if (lexer.consume_specific(closing))
+            return {};
+        if (!lexer.consume_specific(','))
+            return Error::from_string_literal("Invalid perfcore format (expected ',')");
+        lexer.ignore_while(is_ascii_space);
+    }
+    return Error::from_string_literal("Invalid perfcore format (truncated)");
+}
 
-    auto const& object = json.value().as_object();
+ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path)
+{
+    auto file = TRY(Core::MappedFile::map(path));
+    StringView json { file->bytes() };
+
+    Optional<StringView> strings_json;
+    Optional<StringView> events_json;
+    TRY(for_each_json_member(json, [&](StringView key, StringView value) -> ErrorOr<void> {
+        if (key == "strings"sv)
+            strings_json = value;
+        else if (key == "events"sv)
+            events_json = value;
+        return {};
+    }));
 
     if (!g_kernel_debuginfo_object.has_value()) {
         auto debuginfo_file_or_error = Core::MappedFile::map("/boot/Kernel.debug"sv);
@@ -253,29 +365,31 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         }
     }
 
-    auto const* strings_value = object.get_ptr("strings"sv);
-    if (!strings_value || !strings_value->is_array())
+    if (!strings_json.has_value())
+        return Error::from_string_literal("Malformed profile (strings is not an array)");
+    auto strings_value = JsonValue::from_string(strings_json.value());
+    if (strings_value.is_error() || !strings_value.value().is_array())
         return Error::from_string_literal("Malformed profile (strings is not an array)");
 
     HashMap<FlatPtr, String> profile_strings;
-    for (FlatPtr string_id = 0; string_id < strings_value->as_array().size(); ++string_id) {
-        auto const& value = strings_value->as_array().at(string_id);
+    for (FlatPtr string_id = 0; string_id < strings_value.value().as_array().size(); ++string_id) {
+        auto const& value = strings_value.value().as_array().at(string_id);
         profile_strings.set(string_id, value.to_string());
     }
 
-    auto const* events_value = object.get_ptr("events"sv);
-    if (!events_value || !events_value->is_array())
+    if (!events_json.has_value() || !events_json->starts_with('['))
         return Error::from_string_literal("Malformed profile (events is not an array)");
 
-    auto const& perf_events = events_value->as_array();
-
     NonnullOwnPtrVector<Process> all_processes;
     HashMap<pid_t, Process*> current_processes;
     Vector<Event> events;
     EventSerialNumber next_serial;
 
-    for (auto const& perf_event_value : perf_events.values()) {
-        auto const& perf_event = perf_event_value.as_object();
+    TRY(for_each_json_member(events_json.value(), [&](StringView, StringView perf_event_json) -> ErrorOr<void> {
+        auto perf_event_value = JsonValue::from_string(perf_event_json);
+        if (perf_event_value.is_error() || !perf_event_value.value().is_object())
+            return Error::from_string_literal("Malformed profile (event is not an object)");
+        auto const& perf_event = perf_event_value.value().as_object();
 
         Event event;
 
@@ -289,7 +403,17 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         auto type_string = perf_event.get("type"sv).to_string();
 
         if (type_string == "sample"sv) {
-            event.data = Event::SampleData {};
+            auto counter = perf_event.get("counter"sv).as_string_or({});
+            Event::SampleData data;
+            if (counter == "cpu_cycles"sv)
+                data.counter = SampleCounter::CpuCycles;
+            else if (counter == "cache_misses"sv)
+                data.counter = SampleCounter::CacheMisses;
+            else if (counter == "branch_misses"sv)
+                data.counter = SampleCounter::BranchMisses;
+            else if (counter == "tlb_misses"sv)
+                data.counter = SampleCounter::TlbMisses;
+            event.data = data;
         } else if (type_string == "malloc"sv) {
             event.data = Event::MallocData {
                 .ptr = perf_event.get("ptr"sv).to_number<FlatPtr>(),
@@ -319,13 +443,13 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->library_metadata.handle_mmap(ptr, size, name);
-            continue;
+            return {};
         } else if (type_string == "munmap"sv) {
             event.data = Event::MunmapData {
                 .ptr = perf_event.get("ptr"sv).to_number<FlatPtr>(),
                 .size = perf_event.get("size"sv).to_number<size_t>(),
             };
-            continue;
+            return {};
         } else if (type_string == "process_create"sv) {
             auto parent_pid = perf_event.get("parent_pid"sv).to_number<pid_t>();
             auto executable = perf_event.get("executable"sv).to_string();
@@ -344,7 +468,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
 
             current_processes.set(sampled_process->pid, sampled_process);
             all_processes.append(move(sampled_process));
-            continue;
+            return {};
         } else if (type_string == "process_exec"sv) {
             auto executable = perf_event.get("executable"sv).to_string();
             event.data = Event::ProcessExecData {
@@ -366,13 +490,13 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
 
             current_processes.set(sampled_process->pid, sampled_process);
             all_processes.append(move(sampled_process));
-            continue;
+            return {};
         } else if (type_string == "process_exit"sv) {
             auto* old_process = current_processes.get(event.pid).value();
             old_process->end_valid = event.serial;
 
             current_processes.remove(event.pid);
-            continue;
+            return {};
         } else if (type_string == "thread_create"sv) {
             auto parent_tid = perf_event.get("parent_tid"sv).to_number<pid_t>();
             event.data = Event::ThreadCreateData {
@@ -381,12 +505,12 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->handle_thread_create(event.tid, event.serial);
-            continue;
+            return {};
         } else if (type_string == "thread_exit"sv) {
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->handle_thread_exit(event.tid, event.serial);
-            continue;
+            return {};
         } else if (type_string == "read"sv) {
             auto const string_index = perf_event.get("filename_index"sv).to_number<FlatPtr>();
             event.data = Event::ReadData {
@@ -396,6 +520,12 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
                 .start_timestamp = perf_event.get("start_timestamp"sv).to_number<size_t>(),
                 .success = perf_event.get("success"sv).to_bool()
             };
+        } else if (type_string == "lock_contention"sv) {
+            event.data = Event::LockContentionData {
+                .lock = perf_event.get("lock"sv).to_number<FlatPtr>(),
+                .wait_ns = perf_event.get("wait_ns"sv).to_number<u64>(),
+                .name = perf_event.get("name"sv).to_string(),
+            };
         } else {
             dbgln("Unknown event type '{}'", type_string);
             VERIFY_NOT_REACHED();
@@ -415,7 +545,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
 
             if (maybe_kernel_base.has_value() && ptr >= maybe_kernel_base.value()) {
                 if (g_kernel_debuginfo_object.has_value()) {
-                    symbol = g_kernel_debuginfo_object->elf.symbolicate(ptr - maybe_kernel_base.value(), &offset);
+                    symbol = g_kernel_debuginfo_object->symbolicate(ptr - maybe_kernel_base.value(), &offset);
                 } else {
                     symbol = String::formatted("?? <{:p}>", ptr);
                 }
@@ -437,13 +567,14 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         }
 
         if (event.frames.size() < 2)
-            continue;
+            return {};
 
         FlatPtr innermost_frame_address = event.frames.at(1).address;
         event.in_kernel = maybe_kernel_base.has_value() && innermost_frame_address >= maybe_kernel_base.value();
 
         events.append(move(event));
-    }
+        return {};
+    }));
 
     if (events.is_empty())
         return Error::from_string_literal("No events captured (targeted process was never on CPU)");
@@ -542,6 +673,54 @@ bool Profile::process_filter_contains(pid_t pid, EventSerialNumber serial)
         [&](auto const& process_filter) { return pid == process_filter.pid && serial >= process_filter.start_valid && serial <= process_filter.end_valid; });
 }
 
+StringView sample_counter_name(SampleCounter counter)
+{
+    switch (counter) {
+    case SampleCounter::Timer:
+        return "Timer Samples"sv;
+    case SampleCounter::CpuCycles:
+        return "CPU Cycles"sv;
+    case SampleCounter::CacheMisses:
+        return "Cache Misses"sv;
+    case SampleCounter::BranchMisses:
+        return "Branch Mispredictions"sv;
+    case SampleCounter::TlbMisses:
+        return "TLB Misses"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void Profile::set_sample_counter_filter(Optional<SampleCounter> counter)
+{
+    if (m_sample_counter_filter == counter)
+        return;
+    m_sample_counter_filter = counter;
+    rebuild_tree();
+}
+
+bool Profile::sample_counter_filter_contains(Event const& event) const
+{
+    if (!m_sample_counter_filter.has_value())
+        return true;
+    auto const* sample_data = event.data.get_pointer<Event::SampleData>();
+    return sample_data && sample_data->counter == *m_sample_counter_filter;
+}
+
+Vector<SampleCounter> Profile::sample_counters() const
+{
+    Array<bool, to_underlying(SampleCounter::TlbMisses) + 1> seen_counters {};
+    for (auto const& event : m_events) {
+        if (auto const* sample_data = event.data.get_pointer<Event::SampleData>())
+            seen_counters[to_underlying(sample_data->counter)] = true;
+    }
+    Vector<SampleCounter> counters;
+    for (size_t i = 0; i < seen_counters.size(); ++i) {
+        if (seen_counters[i])
+            counters.append(static_cast<SampleCounter>(i));
+    }
+    return counters;
+}
+
 void Profile::set_inverted(bool inverted)
 {
     if (m_inverted == inverted)
@@ -141,6 +141,17 @@ struct ProcessFilter {
     }
 };
 
+// What a sample was taken on: the profile timer, or one of the processor's hardware performance counters.
+enum class SampleCounter {
+    Timer,
+    CpuCycles,
+    CacheMisses,
+    BranchMisses,
+    TlbMisses,
+};
+
+StringView sample_counter_name(SampleCounter);
+
 class Profile {
 public:
     static ErrorOr<NonnullOwnPtr<Profile>> load_from_perfcore_file(StringView path);
@@ -183,6 +194,7 @@ public:
         Vector<Frame> frames;
 
         struct SampleData {
+            SampleCounter counter { SampleCounter::Timer };
         };
 
         struct MallocData {
@@ -231,7 +243,13 @@ public:
             bool success;
         };
 
-        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData> data { nullptr };
+        struct LockContentionData {
+            FlatPtr lock {};
+            u64 wait_ns {};
+            String name;
+        };
+
+        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData, LockContentionData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -253,6 +271,12 @@ public:
     bool has_process_filter() const { return !m_process_filters.is_empty(); }
     bool process_filter_contains(pid_t pid, EventSerialNumber serial);
 
+    // Which kind of samples the tree and the timeline are weighted by, or all events if there is none.
+    Optional<SampleCounter> sample_counter_filter() const { return m_sample_counter_filter; }
+    void set_sample_counter_filter(Optional<SampleCounter>);
+    bool sample_counter_filter_contains(Event const&) const;
+    Vector<SampleCounter> sample_counters() const;
+
     bool is_inverted() const { return m_inverted; }
     void set_inverted(bool);
 
@@ -286,6 +310,16 @@ public:
         }
     }
 
+    template<typename Callback>
+    void for_each_lock_contention(Callback callback) const
+    {
+        for (auto index : m_lock_contention_indices) {
+            auto const& event = m_events[index];
+            if (callback(event) == IterationDecision::Break)
+                break;
+        }
+    }
+
 private:
     Profile(Vector<Process>, Vector<Event>);
 
@@ -309,6 +343,7 @@ private:
     Vector<Process> m_processes;
     Vector<Event> m_events;
     Vector<size_t> m_signpost_indices;
+    Vector<size_t> m_lock_contention_indices;
     Vector<size_t> m_filtered_signpost_indices;
 
     bool m_has_timestamp_filter_range { false };
@@ -316,6 +351,7 @@ private:
     u64 m_timestamp_filter_range_end { 0 };
 
     Vector<ProcessFilter> m_process_filters;
+    Optional<SampleCounter> m_sample_counter_filter;
 
     NonnullRefPtr<FileEventNode> m_file_event_nodes;
 
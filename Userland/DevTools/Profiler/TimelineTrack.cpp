@@ -59,7 +59,7 @@ void TimelineTrack::paint_event(GUI::PaintEvent& event)
         return min(end_of_trace, max(timestamp, start_of_trace));
     };
 
-    recompute_histograms_if_needed({ start_of_trace, end_of_trace, (size_t)m_profile.length_in_ms() });
+    recompute_histograms_if_needed({ start_of_trace, end_of_trace, (size_t)m_profile.length_in_ms(), m_profile.sample_counter_filter() });
 
     float column_width = this->column_width();
     float frame_height = (float)frame_inner_rect().height() / (float)m_max_value;
@@ -94,6 +94,19 @@ void TimelineTrack::paint_event(GUI::PaintEvent& event)
         painter.fill_rect({ x, frame_thickness() + kernel_column_height, cw, height() - frame_thickness() * 2 }, kernel_color);
     }
 
+    // Lock contention is drawn as a strip along the bottom, spanning the time the thread spent waiting.
+    constexpr int lock_contention_height = 3;
+    m_profile.for_each_lock_contention([&](Profile::Event const& event) {
+        if (event.pid != m_process.pid || !m_process.valid_at(event.serial))
+            return IterationDecision::Continue;
+        auto wait_ms = event.data.get<Profile::Event::LockContentionData>().wait_ns / 1'000'000;
+        auto start = clamp_timestamp(event.timestamp - min(wait_ms, event.timestamp));
+        int x1 = (int)((float)(start - start_of_trace) * column_width);
+        int x2 = (int)((float)(clamp_timestamp(event.timestamp) - start_of_trace) * column_width);
+        painter.fill_rect({ x1, height() - frame_thickness() - lock_contention_height, max(1, x2 - x1), lock_contention_height }, Color::from_rgb(0xe0a030));
+        return IterationDecision::Continue;
+    });
+
     u64 normalized_start_time = clamp_timestamp(min(m_view.select_start_time(), m_view.select_end_time()));
     u64 normalized_end_time = clamp_timestamp(max(m_view.select_start_time(), m_view.select_end_time()));
     u64 normalized_hover_time = clamp_timestamp(m_view.hover_time());
@@ -150,8 +163,10 @@ void TimelineTrack::recompute_histograms_if_needed(HistogramInputs const& inputs
         return min(inputs.end, max(timestamp, inputs.start));
     };
 
+    m_cached_histogram_inputs = inputs;
     m_kernel_histogram = Histogram { inputs.start, inputs.end, inputs.columns };
     m_user_histogram = Histogram { inputs.start, inputs.end, inputs.columns };
+    m_max_value = 0;
 
     for (auto const& event : m_profile.events()) {
         if (event.pid != m_process.pid)
@@ -160,6 +175,9 @@ void TimelineTrack::recompute_histograms_if_needed(HistogramInputs const& inputs
         if (!m_process.valid_at(event.serial))
             continue;
 
+        if (!m_profile.sample_counter_filter_contains(event))
+            continue;
+
         auto& histogram = event.in_kernel ? *m_kernel_histogram : *m_user_histogram;
         histogram.insert(clamp_timestamp(event.timestamp), 1 + event.lost_samples);
     }
@@ -8,12 +8,11 @@
 #pragma once
 
 #include "Histogram.h"
+#include "Profile.h"
 #include <LibGUI/Frame.h>
 
 namespace Profiler {
 
-struct Process;
-class Profile;
 class TimelineView;
 
 class TimelineTrack final : public GUI::Frame {
@@ -39,6 +38,7 @@ private:
         u64 start { 0 };
         u64 end { 0 };
         size_t columns { 0 };
+        Optional<SampleCounter> sample_counter;
     };
 
     void recompute_histograms_if_needed(HistogramInputs const&);
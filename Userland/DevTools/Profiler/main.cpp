@@ -20,6 +20,7 @@
 #include <LibCore/Timer.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
+#include <LibGUI/ActionGroup.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
@@ -299,6 +300,27 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(view_menu->try_add_action(disassembly_action));
     TRY(view_menu->try_add_action(source_action));
 
+    // Profiles that sampled on hardware performance counters can be weighted by each of them in turn.
+    auto sample_counters = profile->sample_counters();
+    auto sample_counter_action_group = make<GUI::ActionGroup>();
+    sample_counter_action_group->set_exclusive(true);
+    if (sample_counters.size() > 1 || (sample_counters.size() == 1 && sample_counters.first() != SampleCounter::Timer)) {
+        TRY(view_menu->try_add_separator());
+        auto add_sample_counter_action = [&](String name, Optional<SampleCounter> counter) -> ErrorOr<void> {
+            auto action = GUI::Action::create_checkable(move(name), [&, counter](auto&) {
+                profile->set_sample_counter_filter(counter);
+                timeline_view->update();
+            });
+            action->set_checked(!counter.has_value());
+            sample_counter_action_group->add_action(*action);
+            TRY(view_menu->try_add_action(action));
+            return {};
+        };
+        TRY(add_sample_counter_action("&All Events", {}));
+        for (auto counter : sample_counters)
+            TRY(add_sample_counter_action(sample_counter_name(counter), counter));
+    }
+
     auto help_menu = TRY(window->try_add_menu("&Help"));
     TRY(help_menu->try_add_action(GUI::CommonActions::make_help_action([](auto&) {
         Desktop::Launcher::open(URL::create_with_file_protocol("/usr/share/man/man1/Profiler.md"), "/bin/Help");
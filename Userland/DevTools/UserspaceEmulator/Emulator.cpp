@@ -234,7 +234,7 @@ int Emulator::exec()
     while (!m_shutdown) {
         if (m_steps_til_pause) [[likely]] {
             m_cpu->save_base_eip();
-            auto insn = X86::Instruction::from_stream(*m_cpu, true, true);
+            auto const& insn = m_cpu->fetch_instruction();
             // Exec cycle
             if constexpr (trace) {
                 outln("{:p}  \033[33;1m{}\033[0m", m_cpu->base_eip(), insn.to_string(m_cpu->base_eip(), symbol_provider));
@@ -384,7 +384,7 @@ void Emulator::handle_repl()
     }
 }
 
-Vector<FlatPtr> Emulator::raw_backtrace()
+Vector<FlatPtr, 128> Emulator::raw_backtrace()
 {
     Vector<FlatPtr, 128> backtrace;
     backtrace.append(m_cpu->base_eip());
@@ -490,7 +490,7 @@ String Emulator::create_backtrace_line(FlatPtr address)
     return String::formatted("=={}==    {:p}  [{}]: {} (\e[34;1m{}\e[0m:{})", getpid(), address, maybe_symbol->lib_name, maybe_symbol->symbol, LexicalPath::basename(source_position.file_path), source_position.line_number);
 }
 
-void Emulator::dump_backtrace(Vector<FlatPtr> const& backtrace)
+void Emulator::dump_backtrace(Span<FlatPtr const> backtrace)
 {
     for (auto const& address : backtrace) {
         reportln("{}"sv, create_backtrace_line(address));
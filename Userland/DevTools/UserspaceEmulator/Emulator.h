@@ -58,8 +58,8 @@ public:
 
     bool load_elf();
     void dump_backtrace();
-    void dump_backtrace(Vector<FlatPtr> const&);
-    Vector<FlatPtr> raw_backtrace();
+    void dump_backtrace(Span<FlatPtr const>);
+    Vector<FlatPtr, 128> raw_backtrace();
 
     int exec();
     void handle_repl();
@@ -162,6 +162,9 @@ private:
     int virt$disown(pid_t);
     int virt$dup2(int, int);
     int virt$emuctl(FlatPtr, FlatPtr, FlatPtr);
+    int virt$epoll_create(int flags);
+    int virt$epoll_ctl(FlatPtr);
+    int virt$epoll_wait(FlatPtr);
     int virt$execve(FlatPtr);
     void virt$exit(int);
     int virt$fchmod(int, mode_t);
@@ -172,6 +175,7 @@ private:
     int virt$ftruncate(int fd, FlatPtr length_addr);
     int virt$futex(FlatPtr);
     int virt$get_dir_entries(int fd, FlatPtr buffer, ssize_t);
+    int virt$get_dir_entries_with_metadata(int fd, FlatPtr buffer, ssize_t);
     int virt$get_process_name(FlatPtr buffer, int size);
     int virt$get_stack_bounds(FlatPtr, FlatPtr);
     int virt$getcwd(FlatPtr buffer, size_t buffer_size);
@@ -209,6 +213,7 @@ private:
     u32 virt$open(u32);
     FlatPtr virt$perf_event(int type, FlatPtr arg1, FlatPtr arg2);
     FlatPtr virt$perf_register_string(FlatPtr, size_t);
+    FlatPtr virt$perf_signposts(FlatPtr, size_t);
     int virt$pipe(FlatPtr pipefd, int flags);
     u32 virt$pledge(u32);
     int virt$poll(FlatPtr);
@@ -225,6 +230,7 @@ private:
     int virt$sched_getparam(pid_t, FlatPtr);
     int virt$sched_setparam(int, FlatPtr);
     int virt$sendfd(int, int);
+    int virt$sendfile(FlatPtr);
     int virt$sendmsg(int sockfd, FlatPtr msg_addr, int flags);
     int virt$set_coredump_metadata(FlatPtr address);
     int virt$set_mmap_name(FlatPtr);
@@ -18,6 +18,7 @@
 #include <sched.h>
 #include <serenity.h>
 #include <strings.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/poll.h>
@@ -78,6 +79,12 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$dup2(arg1, arg2);
     case SC_emuctl:
         return virt$emuctl(arg1, arg2, arg3);
+    case SC_epoll_create:
+        return virt$epoll_create(arg1);
+    case SC_epoll_ctl:
+        return virt$epoll_ctl(arg1);
+    case SC_epoll_wait:
+        return virt$epoll_wait(arg1);
     case SC_execve:
         return virt$execve(arg1);
     case SC_exit:
@@ -99,6 +106,8 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$futex(arg1);
     case SC_get_dir_entries:
         return virt$get_dir_entries(arg1, arg2, arg3);
+    case SC_get_dir_entries_with_metadata:
+        return virt$get_dir_entries_with_metadata(arg1, arg2, arg3);
     case SC_get_process_name:
         return virt$get_process_name(arg1, arg2);
     case SC_get_stack_bounds:
@@ -175,6 +184,8 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$perf_event((int)arg1, arg2, arg3);
     case SC_perf_register_string:
         return virt$perf_register_string(arg1, arg2);
+    case SC_perf_signposts:
+        return virt$perf_signposts(arg1, arg2);
     case SC_pipe:
         return virt$pipe(arg1, arg2);
     case SC_pledge:
@@ -207,6 +218,8 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$sched_setparam(arg1, arg2);
     case SC_sendfd:
         return virt$sendfd(arg1, arg2);
+    case SC_sendfile:
+        return virt$sendfile(arg1);
     case SC_sendmsg:
         return virt$sendmsg(arg1, arg2, arg3);
     case SC_set_coredump_metadata:
@@ -277,6 +290,23 @@ int Emulator::virt$sendfd(int socket, int fd)
     return syscall(SC_sendfd, socket, fd);
 }
 
+int Emulator::virt$sendfile(FlatPtr params_addr)
+{
+    Syscall::SC_sendfile_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    off_t offset = 0;
+    auto* offset_addr = params.offset;
+    if (offset_addr) {
+        mmu().copy_from_vm(&offset, (FlatPtr)offset_addr, sizeof(offset));
+        params.offset = &offset;
+    }
+    int rc = syscall(SC_sendfile, &params);
+    if (offset_addr && rc >= 0)
+        mmu().copy_to_vm((FlatPtr)offset_addr, &offset, sizeof(offset));
+    return rc;
+}
+
 int Emulator::virt$recvfd(int socket, int options)
 {
     return syscall(SC_recvfd, socket, options);
@@ -307,6 +337,19 @@ FlatPtr Emulator::virt$perf_event(int event, FlatPtr arg1, FlatPtr arg2)
     return -ENOSYS;
 }
 
+FlatPtr Emulator::virt$perf_signposts(FlatPtr signposts, size_t count)
+{
+    // NOTE: Tracepoints never fire in here since we don't map the time page, but they still flush on exit.
+    if (count > PERF_SIGNPOSTS_MAX_BATCH)
+        return -EINVAL;
+    for (size_t i = 0; i < count; ++i) {
+        perf_signpost signpost;
+        mmu().copy_from_vm(&signpost, signposts + i * sizeof(perf_signpost), sizeof(signpost));
+        virt$perf_event(PERF_EVENT_SIGNPOST, signpost.string_id, signpost.arg);
+    }
+    return 0;
+}
+
 FlatPtr Emulator::virt$perf_register_string(FlatPtr string, size_t size)
 {
     char* buffer = (char*)alloca(size + 4);
@@ -867,6 +910,8 @@ u32 Emulator::virt$munmap(FlatPtr address, size_t size)
         m_range_allocator.deallocate(region->range());
         mmu().remove_region(*region);
     }
+    if (!marked_for_deletion.is_empty())
+        m_cpu->invalidate_instruction_cache();
     return 0;
 }
 
@@ -946,6 +991,7 @@ FlatPtr Emulator::virt$mremap(FlatPtr params_addr)
         auto* ptr = mremap(mmap_region.data(), mmap_region.size(), mmap_region.size(), params.flags);
         if (ptr == MAP_FAILED)
             return -errno;
+        m_cpu->invalidate_instruction_cache();
         return (FlatPtr)ptr;
     }
     return -EINVAL;
@@ -1009,6 +1055,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
     if (has_non_mmapped_region)
         return -EINVAL;
 
+    m_cpu->invalidate_instruction_cache();
     return 0;
 }
 
@@ -1113,6 +1160,19 @@ int Emulator::virt$get_dir_entries(int fd, FlatPtr buffer, ssize_t size)
     return rc;
 }
 
+int Emulator::virt$get_dir_entries_with_metadata(int fd, FlatPtr buffer, ssize_t size)
+{
+    auto buffer_result = ByteBuffer::create_uninitialized(size);
+    if (buffer_result.is_error())
+        return -ENOMEM;
+    auto& host_buffer = buffer_result.value();
+    int rc = syscall(SC_get_dir_entries_with_metadata, fd, host_buffer.data(), host_buffer.size());
+    if (rc < 0)
+        return rc;
+    mmu().copy_to_vm(buffer, host_buffer.data(), host_buffer.size());
+    return rc;
+}
+
 int Emulator::virt$ioctl([[maybe_unused]] int fd, unsigned request, [[maybe_unused]] FlatPtr arg)
 {
     switch (request) {
@@ -1504,6 +1564,49 @@ int Emulator::virt$dup2(int old_fd, int new_fd)
     return syscall(SC_dup2, old_fd, new_fd);
 }
 
+int Emulator::virt$epoll_create(int flags)
+{
+    return syscall(SC_epoll_create, flags);
+}
+
+int Emulator::virt$epoll_ctl(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_ctl_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    epoll_event event {};
+    if (params.event)
+        mmu().copy_from_vm(&event, (FlatPtr)params.event, sizeof(event));
+    params.event = params.event ? &event : nullptr;
+    return syscall(SC_epoll_ctl, &params);
+}
+
+int Emulator::virt$epoll_wait(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_wait_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    if (params.maxevents <= 0)
+        return -EINVAL;
+
+    Vector<epoll_event> events;
+    events.resize(params.maxevents);
+    struct timespec timeout;
+    u32 sigmask;
+
+    if (params.timeout)
+        mmu().copy_from_vm(&timeout, (FlatPtr)params.timeout, sizeof(timeout));
+    if (params.sigmask)
+        mmu().copy_from_vm(&sigmask, (FlatPtr)params.sigmask, sizeof(sigmask));
+
+    int rc = epoll_pwait(params.epfd, events.data(), params.maxevents, params.timeout ? timeout.tv_sec * 1000 + timeout.tv_nsec / 1'000'000 : -1, params.sigmask ? &sigmask : nullptr);
+    if (rc < 0)
+        return -errno;
+
+    mmu().copy_to_vm((FlatPtr)params.events, events.data(), sizeof(epoll_event) * rc);
+    return rc;
+}
+
 int Emulator::virt$sched_getparam(pid_t pid, FlatPtr user_addr)
 {
     sched_param user_param;
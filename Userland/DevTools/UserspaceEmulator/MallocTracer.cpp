@@ -19,14 +19,22 @@ namespace UserspaceEmulator {
 MallocTracer::MallocTracer(Emulator& emulator)
     : m_emulator(emulator)
 {
+    // BacktraceId 0 is the empty backtrace.
+    m_backtraces.append({});
+}
+
+static MallocRegionMetadata* malloc_metadata_for(Region& region)
+{
+    if (!is<MmapRegion>(region) || !static_cast<MmapRegion const&>(region).is_malloc_block())
+        return nullptr;
+    return static_cast<MmapRegion&>(region).malloc_metadata();
 }
 
 template<typename Callback>
 inline void MallocTracer::for_each_mallocation(Callback callback) const
 {
     m_emulator.mmu().for_each_region([&](auto& region) {
-        if (is<MmapRegion>(region) && static_cast<const MmapRegion&>(region).is_malloc_block()) {
-            auto* malloc_data = static_cast<MmapRegion&>(region).malloc_metadata();
+        if (auto* malloc_data = malloc_metadata_for(region)) {
             for (auto& mallocation : malloc_data->mallocations) {
                 if (mallocation.used && callback(mallocation) == IterationDecision::Break)
                     return IterationDecision::Break;
@@ -72,8 +80,8 @@ void MallocTracer::target_did_malloc(Badge<Emulator>, FlatPtr address, size_t si
         VERIFY(existing_mallocation->freed);
         existing_mallocation->size = size;
         existing_mallocation->freed = false;
-        existing_mallocation->malloc_backtrace = m_emulator.raw_backtrace();
-        existing_mallocation->free_backtrace.clear();
+        existing_mallocation->malloc_backtrace = current_backtrace();
+        existing_mallocation->free_backtrace = 0;
         return;
     }
 
@@ -83,7 +91,7 @@ void MallocTracer::target_did_malloc(Badge<Emulator>, FlatPtr address, size_t si
     }
     auto* mallocation = mmap_region.malloc_metadata()->mallocation_for_address(address);
     VERIFY(mallocation);
-    *mallocation = { address, size, true, false, m_emulator.raw_backtrace(), Vector<FlatPtr>() };
+    *mallocation = { address, size, true, false, current_backtrace(), 0 };
 }
 
 void MallocTracer::target_did_change_chunk_size(Badge<Emulator>, FlatPtr block, size_t chunk_size)
@@ -135,7 +143,7 @@ void MallocTracer::target_did_free(Badge<Emulator>, FlatPtr address)
             m_emulator.dump_backtrace();
         } else {
             mallocation->freed = true;
-            mallocation->free_backtrace = m_emulator.raw_backtrace();
+            mallocation->free_backtrace = current_backtrace();
         }
         return;
     }
@@ -171,7 +179,7 @@ void MallocTracer::target_did_realloc(Badge<Emulator>, FlatPtr address, size_t s
 
     existing_mallocation->size = size;
     // FIXME: Should we track malloc/realloc backtrace separately perhaps?
-    existing_mallocation->malloc_backtrace = m_emulator.raw_backtrace();
+    existing_mallocation->malloc_backtrace = current_backtrace();
 }
 
 Mallocation* MallocTracer::find_mallocation(FlatPtr address)
@@ -184,12 +192,20 @@ Mallocation* MallocTracer::find_mallocation(FlatPtr address)
 
 Mallocation* MallocTracer::find_mallocation_before(FlatPtr address)
 {
+    // Within a block the mallocations are ordered by their addresses, so the closest one is the last one below the address
+    // in the closest block that has any.
     Mallocation* found_mallocation = nullptr;
-    for_each_mallocation([&](auto& mallocation) {
-        if (mallocation.address >= address)
+    m_emulator.mmu().for_each_region_downwards_from(address, [&](auto& region) {
+        auto* malloc_data = malloc_metadata_for(region);
+        if (!malloc_data)
             return IterationDecision::Continue;
-        if (!found_mallocation || (mallocation.address > found_mallocation->address))
-            found_mallocation = const_cast<Mallocation*>(&mallocation);
+        for (size_t i = malloc_data->mallocations.size(); i > 0; --i) {
+            auto& mallocation = malloc_data->mallocations[i - 1];
+            if (mallocation.used && mallocation.address < address) {
+                found_mallocation = &mallocation;
+                return IterationDecision::Break;
+            }
+        }
         return IterationDecision::Continue;
     });
     return found_mallocation;
@@ -198,16 +214,46 @@ Mallocation* MallocTracer::find_mallocation_before(FlatPtr address)
 Mallocation* MallocTracer::find_mallocation_after(FlatPtr address)
 {
     Mallocation* found_mallocation = nullptr;
-    for_each_mallocation([&](auto& mallocation) {
-        if (mallocation.address <= address)
+    m_emulator.mmu().for_each_region_upwards_from(address, [&](auto& region) {
+        auto* malloc_data = malloc_metadata_for(region);
+        if (!malloc_data)
             return IterationDecision::Continue;
-        if (!found_mallocation || (mallocation.address < found_mallocation->address))
-            found_mallocation = const_cast<Mallocation*>(&mallocation);
+        for (auto& mallocation : malloc_data->mallocations) {
+            if (mallocation.used && mallocation.address > address) {
+                found_mallocation = &mallocation;
+                return IterationDecision::Break;
+            }
+        }
         return IterationDecision::Continue;
     });
     return found_mallocation;
 }
 
+BacktraceId MallocTracer::current_backtrace()
+{
+    auto backtrace = m_emulator.raw_backtrace();
+
+    unsigned hash = 0;
+    for (auto address : backtrace)
+        hash = pair_int_hash(hash, ptr_hash(address));
+
+    auto& ids = m_backtrace_ids_by_hash.ensure(hash);
+    for (auto id : ids) {
+        if (m_backtraces[id].span() == backtrace.span())
+            return id;
+    }
+
+    BacktraceId id = m_backtraces.size();
+    m_backtraces.append(Vector<FlatPtr> { backtrace.span() });
+    ids.append(id);
+    return id;
+}
+
+void MallocTracer::dump_backtrace(BacktraceId id)
+{
+    m_emulator.dump_backtrace(m_backtraces[id]);
+}
+
 void MallocTracer::audit_read(Region const& region, FlatPtr address, size_t size)
 {
     if (!m_auditing_enabled)
@@ -236,12 +282,12 @@ void MallocTracer::audit_read(Region const& region, FlatPtr address, size_t size
         size_t distance_to_mallocation_after = mallocation_after ? (mallocation_after->address - address) : 0;
         if (mallocation_before && (!mallocation_after || distance_to_mallocation_before < distance_to_mallocation_after)) {
             reportln("=={}==  Address is {} byte(s) after block of size {}, identity {:p}, allocated at:"sv, getpid(), distance_to_mallocation_before, mallocation_before->size, mallocation_before->address);
-            m_emulator.dump_backtrace(mallocation_before->malloc_backtrace);
+            dump_backtrace(mallocation_before->malloc_backtrace);
             return;
         }
         if (mallocation_after && (!mallocation_before || distance_to_mallocation_after < distance_to_mallocation_before)) {
             reportln("=={}==  Address is {} byte(s) before block of size {}, identity {:p}, allocated at:"sv, getpid(), distance_to_mallocation_after, mallocation_after->size, mallocation_after->address);
-            m_emulator.dump_backtrace(mallocation_after->malloc_backtrace);
+            dump_backtrace(mallocation_after->malloc_backtrace);
         }
         return;
     }
@@ -252,9 +298,9 @@ void MallocTracer::audit_read(Region const& region, FlatPtr address, size_t size
         reportln("\n=={}==  \033[31;1mUse-after-free\033[0m, invalid {}-byte read at address {:p}"sv, getpid(), size, address);
         m_emulator.dump_backtrace();
         reportln("=={}==  Address is {} byte(s) into block of size {}, allocated at:"sv, getpid(), offset_into_mallocation, mallocation->size);
-        m_emulator.dump_backtrace(mallocation->malloc_backtrace);
+        dump_backtrace(mallocation->malloc_backtrace);
         reportln("=={}==  Later freed at:"sv, getpid());
-        m_emulator.dump_backtrace(mallocation->free_backtrace);
+        dump_backtrace(mallocation->free_backtrace);
         return;
     }
 }
@@ -282,12 +328,12 @@ void MallocTracer::audit_write(Region const& region, FlatPtr address, size_t siz
         size_t distance_to_mallocation_after = mallocation_after ? (mallocation_after->address - address) : 0;
         if (mallocation_before && (!mallocation_after || distance_to_mallocation_before < distance_to_mallocation_after)) {
             reportln("=={}==  Address is {} byte(s) after block of size {}, identity {:p}, allocated at:"sv, getpid(), distance_to_mallocation_before, mallocation_before->size, mallocation_before->address);
-            m_emulator.dump_backtrace(mallocation_before->malloc_backtrace);
+            dump_backtrace(mallocation_before->malloc_backtrace);
             return;
         }
         if (mallocation_after && (!mallocation_before || distance_to_mallocation_after < distance_to_mallocation_before)) {
             reportln("=={}==  Address is {} byte(s) before block of size {}, identity {:p}, allocated at:"sv, getpid(), distance_to_mallocation_after, mallocation_after->size, mallocation_after->address);
-            m_emulator.dump_backtrace(mallocation_after->malloc_backtrace);
+            dump_backtrace(mallocation_after->malloc_backtrace);
         }
         return;
     }
@@ -298,9 +344,9 @@ void MallocTracer::audit_write(Region const& region, FlatPtr address, size_t siz
         reportln("\n=={}==  \033[31;1mUse-after-free\033[0m, invalid {}-byte write at address {:p}"sv, getpid(), size, address);
         m_emulator.dump_backtrace();
         reportln("=={}==  Address is {} byte(s) into block of size {}, allocated at:"sv, getpid(), offset_into_mallocation, mallocation->size);
-        m_emulator.dump_backtrace(mallocation->malloc_backtrace);
+        dump_backtrace(mallocation->malloc_backtrace);
         reportln("=={}==  Later freed at:"sv, getpid());
-        m_emulator.dump_backtrace(mallocation->free_backtrace);
+        dump_backtrace(mallocation->free_backtrace);
         return;
     }
 }
@@ -418,7 +464,7 @@ void MallocTracer::dump_leak_report()
         ++leaks_found;
         bytes_leaked += mallocation.size;
         reportln("\n=={}==  \033[31;1mLeak\033[0m, {}-byte allocation at address {:p}"sv, getpid(), mallocation.size, mallocation.address);
-        m_emulator.dump_backtrace(mallocation.malloc_backtrace);
+        dump_backtrace(mallocation.malloc_backtrace);
         return IterationDecision::Continue;
     });
 
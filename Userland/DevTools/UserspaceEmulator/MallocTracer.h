@@ -27,6 +27,9 @@ struct GraphNode {
 
 using MemoryGraph = HashMap<FlatPtr, GraphNode>;
 
+// An index into the backtraces that the MallocTracer has seen, where 0 is the empty backtrace.
+using BacktraceId = u32;
+
 struct Mallocation {
     bool contains(FlatPtr a) const
     {
@@ -38,8 +41,8 @@ struct Mallocation {
     bool used { false };
     bool freed { false };
 
-    Vector<FlatPtr> malloc_backtrace;
-    Vector<FlatPtr> free_backtrace;
+    BacktraceId malloc_backtrace { 0 };
+    BacktraceId free_backtrace { 0 };
 };
 
 class MallocRegionMetadata {
@@ -82,8 +85,15 @@ private:
 
     void update_metadata(MmapRegion& mmap_region, size_t chunk_size);
 
+    BacktraceId current_backtrace();
+    void dump_backtrace(BacktraceId);
+
     Emulator& m_emulator;
 
+    // Most allocations are made from a handful of places, so every distinct backtrace is only stored once.
+    Vector<Vector<FlatPtr>> m_backtraces;
+    HashMap<unsigned, Vector<BacktraceId, 1>> m_backtrace_ids_by_hash;
+
     MemoryGraph m_memory_graph {};
 
     bool m_auditing_enabled { true };
@@ -113,11 +113,19 @@ void SoftCPU::update_code_cache()
         TODO();
     }
 
-    // FIXME: This cache needs to be invalidated if the code region is ever unmapped.
     m_cached_code_region = region;
     m_cached_code_base_ptr = region->data();
 }
 
+void SoftCPU::invalidate_instruction_cache()
+{
+    // NOTE: The instructions themselves are left alone, since we might be in the middle of executing one of them.
+    for (auto& entry : m_instruction_cache)
+        entry.length = 0;
+    m_cached_code_region = nullptr;
+    m_cached_code_base_ptr = nullptr;
+}
+
 ValueWithShadow<u8> SoftCPU::read_memory8(X86::LogicalAddress address)
 {
     VERIFY(address.selector() == 0x1b || address.selector() == 0x23 || address.selector() == 0x2b);
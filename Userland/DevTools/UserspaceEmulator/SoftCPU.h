@@ -12,7 +12,9 @@
 #include "SoftFPU.h"
 #include "SoftVPU.h"
 #include "ValueWithShadow.h"
+#include <AK/Array.h>
 #include <AK/ByteReader.h>
+#include <AK/Optional.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -61,6 +63,13 @@ public:
         m_eip = eip;
     }
 
+    // Decodes the instruction at EIP and advances past it, same as X86::Instruction::from_stream(), except that the
+    // instructions are only decoded the first time they are executed. The returned reference is valid until the next call.
+    X86::Instruction const& fetch_instruction();
+
+    // Has to be called whenever executable memory could have changed, i.e. when anything was mapped, unmapped or protected.
+    void invalidate_instruction_cache();
+
     struct Flags {
         enum Flag {
             CF = 0x0001, // 0b0000'0000'0000'0001
@@ -1340,8 +1349,33 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+
+    // A direct-mapped cache of decoded instructions, indexed by the low bits of their address.
+    struct CachedInstruction {
+        u32 eip { 0 };
+        // Zero if the entry is unused.
+        u32 length { 0 };
+        Optional<X86::Instruction> instruction;
+    };
+    static constexpr size_t instruction_cache_size = 4096;
+    Array<CachedInstruction, instruction_cache_size> m_instruction_cache;
 };
 
+ALWAYS_INLINE X86::Instruction const& SoftCPU::fetch_instruction()
+{
+    auto& entry = m_instruction_cache[m_eip % instruction_cache_size];
+    if (entry.eip == m_eip && entry.length != 0) [[likely]] {
+        m_eip += entry.length;
+        return *entry.instruction;
+    }
+
+    auto eip = m_eip;
+    entry.instruction = X86::Instruction::from_stream(*this, true, true);
+    entry.eip = eip;
+    entry.length = m_eip - eip;
+    return *entry.instruction;
+}
+
 ALWAYS_INLINE u8 SoftCPU::read8()
 {
     if (!m_cached_code_region || !m_cached_code_region->contains(m_eip))
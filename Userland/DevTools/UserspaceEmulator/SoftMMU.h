@@ -105,6 +105,29 @@ public:
         }
     }
 
+    // Visits the regions that start at or below the address (which includes the one containing it), closest first.
+    template<typename Callback>
+    void for_each_region_downwards_from(FlatPtr address, Callback callback)
+    {
+        for (size_t i = min(first_region_index_ending_after(address) + 1, m_regions.size()); i > 0; --i) {
+            auto& region = m_regions[i - 1];
+            if (region.base() > address)
+                continue;
+            if (callback(region) == IterationDecision::Break)
+                return;
+        }
+    }
+
+    // Visits the regions that end above the address (which includes the one containing it), closest first.
+    template<typename Callback>
+    void for_each_region_upwards_from(FlatPtr address, Callback callback)
+    {
+        for (size_t i = first_region_index_ending_after(address); i < m_regions.size(); ++i) {
+            if (callback(m_regions[i]) == IterationDecision::Break)
+                return;
+        }
+    }
+
     template<typename Type, typename Callback>
     void for_each_region_of_type(Callback callback)
     {
@@ -138,6 +161,21 @@ public:
     }
 
 private:
+    size_t first_region_index_ending_after(FlatPtr address) const
+    {
+        // The regions are sorted by their addresses and don't overlap, so their ends are sorted too.
+        size_t low = 0;
+        size_t high = m_regions.size();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (m_regions[middle].end() > address)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        return low;
+    }
+
     Emulator& m_emulator;
 
     Region* m_page_to_region_map[786432] = { nullptr };
@@ -14,7 +14,6 @@
 #include <LibAudio/UserSampleQueue.h>
 #include <LibCore/Event.h>
 #include <LibThreading/Mutex.h>
-#include <time.h>
 
 namespace Audio {
 
@@ -78,7 +77,7 @@ void ConnectionToServer::update_good_sleep_time()
     auto sample_rate = static_cast<double>(get_sample_rate());
     auto buffer_play_time_ns = 1'000'000'000.0 / (sample_rate / static_cast<double>(AUDIO_BUFFER_SIZE));
     // A factor of 1 should be good for now.
-    m_good_sleep_time = Time::from_nanoseconds(static_cast<unsigned>(buffer_play_time_ns)).to_timespec();
+    m_good_sleep_time = Time::from_nanoseconds(static_cast<unsigned>(buffer_play_time_ns));
 }
 
 // Non-realtime audio writing loop
@@ -97,12 +96,14 @@ void ConnectionToServer::custom_event(Core::CustomEvent&)
 
         m_user_queue->discard_samples(available_samples);
 
-        // FIXME: Could we receive interrupts in a good non-IPC way instead?
-        auto result = m_buffer->try_blocking_enqueue(next_chunk, [this]() {
-            nanosleep(&m_good_sleep_time, nullptr);
-        });
+        // The server wakes us up through the queue as soon as it has taken a buffer out.
+        // The timeout only makes sure that we notice if that never happens.
+        ErrorOr<void, AudioQueue::QueueStatus> result = AudioQueue::QueueStatus::Full;
+        do {
+            result = m_buffer->blocking_enqueue(next_chunk, m_good_sleep_time);
+        } while (result.is_error() && result.error() == AudioQueue::QueueStatus::Full);
         if (result.is_error())
-            dbgln("Error while writing samples to shared buffer: {}", result.error());
+            dbgln("Error while writing samples to shared buffer: {}", to_underlying(result.error()));
     }
 }
 
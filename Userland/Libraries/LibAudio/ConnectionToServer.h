@@ -11,6 +11,7 @@
 #include <AK/FixedArray.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <LibAudio/Queue.h>
 #include <LibAudio/UserSampleQueue.h>
 #include <LibCore/EventLoop.h>
@@ -86,7 +87,7 @@ private:
 
     // A good amount of time to sleep when the queue is full.
     // (Only used for non-realtime enqueues)
-    timespec m_good_sleep_time {};
+    Time m_good_sleep_time {};
 };
 
 }
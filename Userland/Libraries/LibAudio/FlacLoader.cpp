@@ -55,6 +55,7 @@ MaybeLoaderError FlacLoaderPlugin::initialize()
         return m_error.release_value();
 
     TRY(parse_header());
+    m_bit_reader = LOADER_TRY(adopt_nonnull_own_or_enomem(new (nothrow) FlacBitReader(*m_stream)));
     TRY(reset());
     return {};
 }
@@ -216,6 +217,8 @@ MaybeLoaderError FlacLoaderPlugin::seek(int int_sample_index)
     // No seektable or no fitting entry: Perform normal forward read
     if (!maybe_target_seekpoint.has_value()) {
         if (sample_index < m_loaded_samples) {
+            m_bit_reader->discard_buffered_data();
+            m_unread_data.clear_with_capacity();
             LOADER_TRY(m_stream->seek(m_data_start_location, Core::Stream::SeekMode::SetPosition));
             m_loaded_samples = 0;
         }
@@ -236,6 +239,8 @@ MaybeLoaderError FlacLoaderPlugin::seek(int int_sample_index)
 
         dbgln_if(AFLACLOADER_DEBUG, "Seeking to seektable: sample index {}, byte offset {}, sample count {}", target_seekpoint.sample_index, target_seekpoint.byte_offset, target_seekpoint.num_samples);
         auto position = target_seekpoint.byte_offset + m_data_start_location;
+        m_bit_reader->discard_buffered_data();
+        m_unread_data.clear_with_capacity();
         if (m_stream->seek(static_cast<i64>(position), Core::Stream::SeekMode::SetPosition).is_error())
             return LoaderError { LoaderError::Category::IO, m_loaded_samples, String::formatted("Invalid seek position {}", position) };
 
@@ -255,11 +260,21 @@ LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_i
 
     // FIXME: samples_to_read is calculated wrong, because when seeking not all samples are loaded.
     size_t samples_to_read = min(max_bytes_to_read_from_input, remaining_samples);
-    auto samples = FixedArray<Sample>::must_create_but_fixme_should_propagate_errors(samples_to_read);
+    auto samples = LOADER_TRY(FixedArray<Sample>::try_create(samples_to_read));
+    TRY(read_samples(samples.span()));
+    return samples;
+}
+
+ErrorOr<size_t, LoaderError> FlacLoaderPlugin::read_samples(Span<Sample> samples)
+{
+    ssize_t remaining_samples = static_cast<ssize_t>(m_total_samples - m_loaded_samples);
+    if (remaining_samples <= 0)
+        return 0;
+    samples = samples.trim(remaining_samples);
     size_t sample_index = 0;
 
     if (m_unread_data.size() > 0) {
-        size_t to_transfer = min(m_unread_data.size(), samples_to_read);
+        size_t to_transfer = min(m_unread_data.size(), samples.size());
         dbgln_if(AFLACLOADER_DEBUG, "Reading {} samples from unread sample buffer (size {})", to_transfer, m_unread_data.size());
         AK::TypedTransfer<Sample>::move(samples.data(), m_unread_data.data(), to_transfer);
         if (to_transfer < m_unread_data.size())
@@ -270,14 +285,14 @@ LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_i
         sample_index += to_transfer;
     }
 
-    while (sample_index < samples_to_read) {
-        TRY(next_frame(samples.span().slice(sample_index)));
-        sample_index += m_current_frame->sample_count;
+    while (sample_index < samples.size()) {
+        TRY(next_frame(samples.slice(sample_index)));
+        sample_index += min(m_current_frame->sample_count, samples.size() - sample_index);
     }
 
     m_loaded_samples += sample_index;
 
-    return samples;
+    return sample_index;
 }
 
 // 11.21. FRAME
@@ -290,55 +305,55 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
         }                                                                                                                               \
     } while (0)
 
-    auto bit_stream = LOADER_TRY(BigEndianInputBitStream::construct(*m_stream));
+    auto& bit_stream = *m_bit_reader;
 
     // TODO: Check the CRC-16 checksum (and others) by keeping track of read data
 
     // 11.22. FRAME_HEADER
-    u16 sync_code = LOADER_TRY(bit_stream->read_bits<u16>(14));
+    u16 sync_code = LOADER_TRY(bit_stream.read_bits<u16>(14));
     FLAC_VERIFY(sync_code == 0b11111111111110, LoaderError::Category::Format, "Sync code");
-    bool reserved_bit = LOADER_TRY(bit_stream->read_bit());
+    bool reserved_bit = LOADER_TRY(bit_stream.read_bit());
     FLAC_VERIFY(reserved_bit == 0, LoaderError::Category::Format, "Reserved frame header bit");
     // 11.22.2. BLOCKING STRATEGY
-    [[maybe_unused]] bool blocking_strategy = LOADER_TRY(bit_stream->read_bit());
+    [[maybe_unused]] bool blocking_strategy = LOADER_TRY(bit_stream.read_bit());
 
-    u32 sample_count = TRY(convert_sample_count_code(LOADER_TRY(bit_stream->read_bits<u8>(4))));
+    u32 sample_count = TRY(convert_sample_count_code(LOADER_TRY(bit_stream.read_bits<u8>(4))));
 
-    u32 frame_sample_rate = TRY(convert_sample_rate_code(LOADER_TRY(bit_stream->read_bits<u8>(4))));
+    u32 frame_sample_rate = TRY(convert_sample_rate_code(LOADER_TRY(bit_stream.read_bits<u8>(4))));
 
-    u8 channel_type_num = LOADER_TRY(bit_stream->read_bits<u8>(4));
+    u8 channel_type_num = LOADER_TRY(bit_stream.read_bits<u8>(4));
     FLAC_VERIFY(channel_type_num < 0b1011, LoaderError::Category::Format, "Channel assignment");
     FlacFrameChannelType channel_type = (FlacFrameChannelType)channel_type_num;
 
-    PcmSampleFormat bit_depth = TRY(convert_bit_depth_code(LOADER_TRY(bit_stream->read_bits<u8>(3))));
+    PcmSampleFormat bit_depth = TRY(convert_bit_depth_code(LOADER_TRY(bit_stream.read_bits<u8>(3))));
 
-    reserved_bit = LOADER_TRY(bit_stream->read_bit());
+    reserved_bit = LOADER_TRY(bit_stream.read_bit());
     FLAC_VERIFY(reserved_bit == 0, LoaderError::Category::Format, "Reserved frame header end bit");
 
     // 11.22.8. CODED NUMBER
     // FIXME: sample number can be 8-56 bits, frame number can be 8-48 bits
-    m_current_sample_or_frame = LOADER_TRY(read_utf8_char(*bit_stream));
+    m_current_sample_or_frame = LOADER_TRY(read_utf8_char(bit_stream));
 
     // Conditional header variables
     // 11.22.9. BLOCK SIZE INT
     if (sample_count == FLAC_BLOCKSIZE_AT_END_OF_HEADER_8) {
-        sample_count = LOADER_TRY(bit_stream->read_bits<u32>(8)) + 1;
+        sample_count = LOADER_TRY(bit_stream.read_bits<u32>(8)) + 1;
     } else if (sample_count == FLAC_BLOCKSIZE_AT_END_OF_HEADER_16) {
-        sample_count = LOADER_TRY(bit_stream->read_bits<u32>(16)) + 1;
+        sample_count = LOADER_TRY(bit_stream.read_bits<u32>(16)) + 1;
     }
 
     // 11.22.10. SAMPLE RATE INT
     if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_8) {
-        frame_sample_rate = LOADER_TRY(bit_stream->read_bits<u32>(8)) * 1000;
+        frame_sample_rate = LOADER_TRY(bit_stream.read_bits<u32>(8)) * 1000;
     } else if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_16) {
-        frame_sample_rate = LOADER_TRY(bit_stream->read_bits<u32>(16));
+        frame_sample_rate = LOADER_TRY(bit_stream.read_bits<u32>(16));
     } else if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_16X10) {
-        frame_sample_rate = LOADER_TRY(bit_stream->read_bits<u32>(16)) * 10;
+        frame_sample_rate = LOADER_TRY(bit_stream.read_bits<u32>(16)) * 10;
     }
 
     // 11.22.11. FRAME CRC
     // TODO: check header checksum, see above
-    [[maybe_unused]] u8 checksum = LOADER_TRY(bit_stream->read_bits<u8>(8));
+    [[maybe_unused]] u8 checksum = LOADER_TRY(bit_stream.read_bits<u8>(8));
 
     dbgln_if(AFLACLOADER_DEBUG, "Frame: {} samples, {}bit {}Hz, channeltype {:x}, {} number {}, header checksum {}", sample_count, pcm_bits_per_sample(bit_depth), frame_sample_rate, channel_type_num, blocking_strategy ? "sample" : "frame", m_current_sample_or_frame, checksum);
 
@@ -350,30 +365,27 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     };
 
     u8 subframe_count = frame_channel_type_to_channel_count(channel_type);
-    Vector<Vector<i32>> current_subframes;
-    current_subframes.ensure_capacity(subframe_count);
+    VERIFY(subframe_count <= m_subframe_samples.size());
 
     for (u8 i = 0; i < subframe_count; ++i) {
-        FlacSubframeHeader new_subframe = TRY(next_subframe_header(*bit_stream, i));
-        Vector<i32> subframe_samples = TRY(parse_subframe(new_subframe, *bit_stream));
-        current_subframes.unchecked_append(move(subframe_samples));
+        FlacSubframeHeader new_subframe = TRY(next_subframe_header(i));
+        TRY(parse_subframe(new_subframe, m_subframe_samples[i]));
     }
 
     // 11.2. Overview ("The audio data is composed of...")
-    bit_stream->align_to_byte_boundary();
+    bit_stream.align_to_byte_boundary();
 
     // 11.23. FRAME_FOOTER
     // TODO: check checksum, see above
-    [[maybe_unused]] u16 footer_checksum = LOADER_TRY(bit_stream->read_bits<u16>(16));
+    [[maybe_unused]] u16 footer_checksum = LOADER_TRY(bit_stream.read_bits<u16>(16));
     dbgln_if(AFLACLOADER_DEBUG, "Subframe footer checksum: {}", footer_checksum);
 
-    Vector<i32> left;
-    Vector<i32> right;
+    // Undo the inter-channel decorrelation in place, so that the first two subframes end up being left and right.
+    auto& left = m_subframe_samples[0];
+    auto& right = subframe_count > 1 ? m_subframe_samples[1] : m_subframe_samples[0];
 
     switch (channel_type) {
     case FlacFrameChannelType::Mono:
-        left = right = current_subframes[0];
-        break;
     case FlacFrameChannelType::Stereo:
     // TODO mix together surround channels on each side?
     case FlacFrameChannelType::StereoCenter:
@@ -382,62 +394,62 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     case FlacFrameChannelType::Surround5p1:
     case FlacFrameChannelType::Surround6p1:
     case FlacFrameChannelType::Surround7p1:
-        left = current_subframes[0];
-        right = current_subframes[1];
         break;
     case FlacFrameChannelType::LeftSideStereo:
         // channels are left (0) and side (1)
-        left = current_subframes[0];
-        right.ensure_capacity(left.size());
         for (size_t i = 0; i < left.size(); ++i) {
             // right = left - side
-            right.unchecked_append(left[i] - current_subframes[1][i]);
+            right[i] = left[i] - right[i];
         }
         break;
     case FlacFrameChannelType::RightSideStereo:
         // channels are side (0) and right (1)
-        right = current_subframes[1];
-        left.ensure_capacity(right.size());
         for (size_t i = 0; i < right.size(); ++i) {
             // left = right + side
-            left.unchecked_append(right[i] + current_subframes[0][i]);
+            left[i] = right[i] + left[i];
         }
         break;
     case FlacFrameChannelType::MidSideStereo:
         // channels are mid (0) and side (1)
-        left.ensure_capacity(current_subframes[0].size());
-        right.ensure_capacity(current_subframes[0].size());
-        for (size_t i = 0; i < current_subframes[0].size(); ++i) {
-            i64 mid = current_subframes[0][i];
-            i64 side = current_subframes[1][i];
-            mid *= 2;
-            // prevent integer division errors
-            left.unchecked_append(static_cast<i32>((mid + side) / 2));
-            right.unchecked_append(static_cast<i32>((mid - side) / 2));
+        for (size_t i = 0; i < left.size(); ++i) {
+            i64 mid = left[i];
+            i64 side = right[i];
+            // The lowest bit of the mid channel was lost when it was averaged, but it is the same as the one of the side channel.
+            mid = (mid << 1) | (side & 1);
+            left[i] = static_cast<i32>((mid + side) >> 1);
+            right[i] = static_cast<i32>((mid - side) >> 1);
         }
         break;
     }
 
-    VERIFY(left.size() == right.size() && left.size() == m_current_frame->sample_count);
+    if (m_current_frame->sample_rate != m_sample_rate) {
+        ResampleHelper<i32> left_resampler(m_current_frame->sample_rate, m_sample_rate);
+        left = left_resampler.resample(left);
+        if (&right != &left) {
+            ResampleHelper<i32> right_resampler(m_current_frame->sample_rate, m_sample_rate);
+            right = right_resampler.resample(right);
+        }
+    }
+
+    VERIFY(left.size() == right.size());
+    auto frame_sample_count = left.size();
 
     float sample_rescale = static_cast<float>(1 << (pcm_bits_per_sample(m_current_frame->bit_depth) - 1));
     dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {:.1f}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
+    float sample_scale = 1.0f / sample_rescale;
 
     // zip together channels
-    auto samples_to_directly_copy = min(target_vector.size(), m_current_frame->sample_count);
-    for (size_t i = 0; i < samples_to_directly_copy; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
-        target_vector[i] = frame;
-    }
+    auto samples_to_directly_copy = min(target_vector.size(), frame_sample_count);
+    for (size_t i = 0; i < samples_to_directly_copy; ++i)
+        target_vector[i] = { left[i] * sample_scale, right[i] * sample_scale };
+
     // move superfluous data into the class buffer instead
-    auto result = m_unread_data.try_grow_capacity(m_current_frame->sample_count - samples_to_directly_copy);
+    auto result = m_unread_data.try_ensure_capacity(m_unread_data.size() + frame_sample_count - samples_to_directly_copy);
     if (result.is_error())
         return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(samples_to_directly_copy + m_current_sample_or_frame), "Couldn't allocate sample buffer for superfluous data" };
 
-    for (size_t i = samples_to_directly_copy; i < m_current_frame->sample_count; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
-        m_unread_data.unchecked_append(frame);
-    }
+    for (size_t i = samples_to_directly_copy; i < frame_sample_count; ++i)
+        m_unread_data.unchecked_append({ left[i] * sample_scale, right[i] * sample_scale });
 
     return {};
 #undef FLAC_VERIFY
@@ -531,8 +543,9 @@ u8 frame_channel_type_to_channel_count(FlacFrameChannelType channel_type)
 }
 
 // 11.25. SUBFRAME_HEADER
-ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(BigEndianInputBitStream& bit_stream, u8 channel_index)
+ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(u8 channel_index)
 {
+    auto& bit_stream = *m_bit_reader;
     u8 bits_per_sample = static_cast<u16>(pcm_bits_per_sample(m_current_frame->bit_depth));
 
     // For inter-channel correlation, the side channel needs an extra bit for its samples
@@ -579,13 +592,8 @@ ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(
     // 11.25.2. WASTED BITS PER SAMPLE FLAG
     bool has_wasted_bits = LOADER_TRY(bit_stream.read_bit());
     u8 k = 0;
-    if (has_wasted_bits) {
-        bool current_k_bit = 0;
-        do {
-            current_k_bit = LOADER_TRY(bit_stream.read_bit());
-            ++k;
-        } while (current_k_bit != 1);
-    }
+    if (has_wasted_bits)
+        k = LOADER_TRY(bit_stream.read_unary()) + 1;
 
     return FlacSubframeHeader {
         subframe_type,
@@ -595,9 +603,10 @@ ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(
     };
 }
 
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, Vector<i32>& samples)
 {
-    Vector<i32> samples;
+    auto& bit_input = *m_bit_reader;
+    samples.clear_with_capacity();
 
     switch (subframe_header.type) {
     case FlacSubframeType::Constant: {
@@ -605,7 +614,7 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeH
         u64 constant_value = LOADER_TRY(bit_input.read_bits<u64>(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample));
         dbgln_if(AFLACLOADER_DEBUG, "Constant subframe: {}", constant_value);
 
-        samples.ensure_capacity(m_current_frame->sample_count);
+        LOADER_TRY(samples.try_ensure_capacity(m_current_frame->sample_count));
         VERIFY(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample != 0);
         i32 constant = sign_extend(static_cast<u32>(constant_value), subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample);
         for (u32 i = 0; i < m_current_frame->sample_count; ++i) {
@@ -615,37 +624,37 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeH
     }
     case FlacSubframeType::Fixed: {
         dbgln_if(AFLACLOADER_DEBUG, "Fixed LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_fixed_lpc(subframe_header, bit_input));
+        TRY(decode_fixed_lpc(subframe_header, samples));
         break;
     }
     case FlacSubframeType::Verbatim: {
         dbgln_if(AFLACLOADER_DEBUG, "Verbatim subframe");
-        samples = TRY(decode_verbatim(subframe_header, bit_input));
+        TRY(decode_verbatim(subframe_header, samples));
         break;
     }
     case FlacSubframeType::LPC: {
         dbgln_if(AFLACLOADER_DEBUG, "Custom LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_custom_lpc(subframe_header, bit_input));
+        TRY(decode_custom_lpc(subframe_header, samples));
         break;
     }
     default:
         return LoaderError { LoaderError::Category::Unimplemented, static_cast<size_t>(m_current_sample_or_frame), "Unhandled FLAC subframe type" };
     }
 
-    for (size_t i = 0; i < samples.size(); ++i) {
-        samples[i] <<= subframe_header.wasted_bits_per_sample;
+    if (subframe_header.wasted_bits_per_sample > 0) {
+        for (auto& sample : samples)
+            sample <<= subframe_header.wasted_bits_per_sample;
     }
 
-    ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
-    return resampler.resample(samples);
+    return {};
 }
 
 // 11.29. SUBFRAME_VERBATIM
 // Decode a subframe that isn't actually encoded, usually seen in random data
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    auto& bit_input = *m_bit_reader;
+    LOADER_TRY(decoded.try_ensure_capacity(m_current_frame->sample_count));
 
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     for (size_t i = 0; i < m_current_frame->sample_count; ++i) {
@@ -654,15 +663,15 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframe
             subframe.bits_per_sample - subframe.wasted_bits_per_sample));
     }
 
-    return decoded;
+    return {};
 }
 
 // 11.28. SUBFRAME_LPC
 // Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    auto& bit_input = *m_bit_reader;
+    LOADER_TRY(decoded.try_ensure_capacity(m_current_frame->sample_count));
 
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     // warm-up samples
@@ -681,18 +690,17 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
     // shift needed on the data (signed!)
     i8 lpc_shift = sign_extend(LOADER_TRY(bit_input.read_bits<u8>(5)), 5);
 
-    Vector<i32> coefficients;
-    coefficients.ensure_capacity(subframe.order);
+    // The order is at most 32, so the coefficients fit on the stack.
+    Array<i32, 32> coefficients;
     // read coefficients
     for (auto i = 0; i < subframe.order; ++i) {
         u32 raw_coefficient = LOADER_TRY(bit_input.read_bits<u32>(lpc_precision));
-        i32 coefficient = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
-        coefficients.unchecked_append(coefficient);
+        coefficients[i] = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
     }
 
-    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients);
+    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients.span().trim(subframe.order));
 
-    TRY(decode_residual(decoded, subframe, bit_input));
+    TRY(decode_residual(decoded, subframe));
 
     // approximate the waveform with the predictor
     for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
@@ -709,15 +717,15 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
         decoded[i] += sample >> lpc_shift;
     }
 
-    return decoded;
+    return {};
 }
 
 // 11.27. SUBFRAME_FIXED
 // Decode a subframe encoded with one of the fixed linear predictor codings
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    auto& bit_input = *m_bit_reader;
+    LOADER_TRY(decoded.try_ensure_capacity(m_current_frame->sample_count));
 
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     // warm-up samples
@@ -727,7 +735,7 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
             subframe.bits_per_sample - subframe.wasted_bits_per_sample));
     }
 
-    TRY(decode_residual(decoded, subframe, bit_input));
+    TRY(decode_residual(decoded, subframe));
 
     dbgln_if(AFLACLOADER_DEBUG, "decoded length {}, {} order predictor", decoded.size(), subframe.order);
 
@@ -777,13 +785,14 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
     default:
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), String::formatted("Unrecognized predictor order {}", subframe.order) };
     }
-    return decoded;
+    return {};
 }
 
 // 11.30. RESIDUAL
 // Decode the residual, the "error" between the function approximation and the actual audio data
-MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe)
 {
+    auto& bit_input = *m_bit_reader;
     // 11.30.1. RESIDUAL_CODING_METHOD
     auto residual_mode = static_cast<FlacResidualMode>(LOADER_TRY(bit_input.read_bits<u8>(2)));
     u8 partition_order = LOADER_TRY(bit_input.read_bits<u8>(4));
@@ -792,27 +801,27 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSub
     if (residual_mode == FlacResidualMode::Rice4Bit) {
         // 11.30.2. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB
         // decode a single Rice partition with four bits for the order k
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(4, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(4, partitions, i, subframe, decoded));
     } else if (residual_mode == FlacResidualMode::Rice5Bit) {
         // 11.30.3. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB2
         // five bits equivalent
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(5, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(5, partitions, i, subframe, decoded));
     } else
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Reserved residual coding method" };
 
+    if (decoded.size() != m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Residual doesn't cover the entire subframe" };
+
     return {};
 }
 
 // 11.30.2.1. EXP_GOLOMB_PARTITION and 11.30.3.1. EXP_GOLOMB2_PARTITION
 // Decode a single Rice partition as part of the residual, every partition can have its own Rice parameter k
-ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+ALWAYS_INLINE MaybeLoaderError FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, Vector<i32>& decoded)
 {
+    auto& bit_input = *m_bit_reader;
     // 11.30.2.2. EXP GOLOMB PARTITION ENCODING PARAMETER and 11.30.3.2. EXP-GOLOMB2 PARTITION ENCODING PARAMETER
     u8 k = LOADER_TRY(bit_input.read_bits<u8>(partition_type));
 
@@ -824,30 +833,30 @@ ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_rice_pa
     if (partition_index == 0)
         residual_sample_count -= subframe.order;
 
-    Vector<i32> rice_partition;
-    rice_partition.resize(residual_sample_count);
+    // The residual is appended to the warm-up samples, so everything has to fit into what the subframe reserved.
+    if (decoded.size() + residual_sample_count > m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Residual partition too large" };
 
     // escape code for unencoded binary partition
     if (k == (1 << partition_type) - 1) {
         u8 unencoded_bps = LOADER_TRY(bit_input.read_bits<u8>(5));
         for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(bit_input.read_bits<u8>(unencoded_bps));
+            auto value = LOADER_TRY(bit_input.read_bits<u32>(unencoded_bps));
+            decoded.unchecked_append(unencoded_bps == 0 ? 0 : static_cast<i32>(sign_extend(value, unencoded_bps)));
         }
     } else {
-        for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input));
-        }
+        for (size_t r = 0; r < residual_sample_count; ++r)
+            decoded.unchecked_append(LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input)));
     }
 
-    return rice_partition;
+    return {};
 }
 
 // Decode a single number encoded with Rice/Exponential-Golomb encoding (the unsigned variant)
-ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 k, BigEndianInputBitStream& bit_input)
+ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 k, FlacBitReader& bit_input)
 {
-    u8 q = 0;
-    while (TRY(bit_input.read_bit()) == 0)
-        ++q;
+    // The quotient is coded in unary, which the bit reader skips over in one go.
+    u32 q = TRY(bit_input.read_unary());
 
     // least significant bits (remainder)
     u32 rem = TRY(bit_input.read_bits<u32>(k));
@@ -856,13 +865,10 @@ ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 k, BigEndianInputBitStr
     return rice_to_signed(value);
 }
 
-ErrorOr<u64> read_utf8_char(BigEndianInputBitStream& input)
+ErrorOr<u64> read_utf8_char(FlacBitReader& input)
 {
     u64 character;
-    u8 buffer = 0;
-    Bytes buffer_bytes { &buffer, 1 };
-    TRY(input.read(buffer_bytes));
-    u8 start_byte = buffer_bytes[0];
+    u8 start_byte = TRY(input.read_bits<u8>(8));
     // Signal byte is zero: ASCII character
     if ((start_byte & 0b10000000) == 0) {
         return start_byte;
@@ -877,8 +883,7 @@ ErrorOr<u64> read_utf8_char(BigEndianInputBitStream& input)
     u8 start_byte_bitmask = AK::exp2(bits_from_start_byte) - 1;
     character = start_byte_bitmask & start_byte;
     for (u8 i = length - 1; i > 0; --i) {
-        TRY(input.read(buffer_bytes));
-        u8 current_byte = buffer_bytes[0];
+        u8 current_byte = TRY(input.read_bits<u8>(8));
         character = (character << 6) | (current_byte & 0b00111111);
     }
     return character;
@@ -8,6 +8,8 @@
 
 #include "FlacTypes.h"
 #include "Loader.h"
+#include <AK/Array.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Error.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
@@ -25,6 +27,107 @@ using Core::Stream::BigEndianInputBitStream;
 // There was no intensive fine-tuning done to determine this value, so improvements may definitely be possible.
 constexpr size_t FLAC_BUFFER_SIZE = 8 * KiB;
 
+// Reads bits in big-endian order, like BigEndianInputBitStream, but several bytes at a time.
+// It keeps up to 64 bits in a cache that is refilled from a buffer of the underlying stream, so most reads are just a shift.
+// As it reads ahead of what it hands out, the underlying stream may only be used directly (e.g. to seek)
+// after calling discard_buffered_data().
+class FlacBitReader {
+public:
+    explicit FlacBitReader(Core::Stream::Stream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    ALWAYS_INLINE ErrorOr<bool> read_bit()
+    {
+        return TRY(read_bits<u8>(1)) != 0;
+    }
+
+    // Reads at most 32 bits at once, or 64 bits in two steps.
+    template<Unsigned T = u64>
+    ALWAYS_INLINE ErrorOr<T> read_bits(size_t count)
+    {
+        VERIFY(count <= 8 * sizeof(T));
+        if (count > 32) {
+            u64 high_bits = TRY(read_bits<u32>(count - 32));
+            return static_cast<T>((high_bits << 32) | TRY(read_bits<u32>(32)));
+        }
+        if (count == 0)
+            return 0;
+        if (m_cache_size < count)
+            TRY(refill_cache(count));
+        auto result = static_cast<T>(m_cache >> (64 - count));
+        m_cache <<= count;
+        m_cache_size -= count;
+        return result;
+    }
+
+    // Counts the zero bits up to the next one bit, and consumes them including the one bit.
+    ALWAYS_INLINE ErrorOr<u32> read_unary()
+    {
+        u32 zero_count = 0;
+        for (;;) {
+            // The unused bits at the end of the cache are always zero, so this finds the next one bit if there is any.
+            if (m_cache != 0) {
+                auto leading_zeros = static_cast<size_t>(count_leading_zeroes(m_cache));
+                zero_count += leading_zeros;
+                m_cache <<= leading_zeros;
+                m_cache <<= 1;
+                m_cache_size -= leading_zeros + 1;
+                return zero_count;
+            }
+            zero_count += m_cache_size;
+            m_cache_size = 0;
+            TRY(refill_cache(1));
+        }
+    }
+
+    void align_to_byte_boundary()
+    {
+        // The cache is only ever refilled with whole bytes.
+        auto bits_to_skip = m_cache_size % 8;
+        m_cache <<= bits_to_skip;
+        m_cache_size -= bits_to_skip;
+    }
+
+    bool is_aligned_to_byte_boundary() const { return m_cache_size % 8 == 0; }
+
+    void discard_buffered_data()
+    {
+        m_cache = 0;
+        m_cache_size = 0;
+        m_buffer_position = 0;
+        m_buffer_size = 0;
+    }
+
+private:
+    ErrorOr<void> refill_cache(size_t required_bits)
+    {
+        while (m_cache_size <= 56) {
+            if (m_buffer_position == m_buffer_size) {
+                auto read_bytes = TRY(m_stream.read(m_buffer));
+                m_buffer_position = 0;
+                m_buffer_size = read_bytes.size();
+                if (m_buffer_size == 0)
+                    break;
+            }
+            m_cache |= static_cast<u64>(m_buffer[m_buffer_position++]) << (56 - m_cache_size);
+            m_cache_size += 8;
+        }
+        if (m_cache_size < required_bits)
+            return Error::from_string_literal("Unexpected end of FLAC stream");
+        return {};
+    }
+
+    Core::Stream::Stream& m_stream;
+    Array<u8, 4 * KiB> m_buffer;
+    size_t m_buffer_position { 0 };
+    size_t m_buffer_size { 0 };
+    // The next bits to read, starting at the most significant one.
+    u64 m_cache { 0 };
+    size_t m_cache_size { 0 };
+};
+
 ALWAYS_INLINE u8 frame_channel_type_to_channel_count(FlacFrameChannelType channel_type);
 // Sign-extend an arbitrary-size signed number to 64 bit signed
 ALWAYS_INLINE i64 sign_extend(u32 n, u8 size);
@@ -34,9 +137,9 @@ ALWAYS_INLINE i32 rice_to_signed(u32 x);
 
 // decoders
 // read a UTF-8 encoded number, even if it is not a valid codepoint
-ALWAYS_INLINE ErrorOr<u64> read_utf8_char(BigEndianInputBitStream& input);
+ALWAYS_INLINE ErrorOr<u64> read_utf8_char(FlacBitReader& input);
 // decode a single number encoded with exponential golomb encoding of the specified order
-ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 order, BigEndianInputBitStream& bit_input);
+ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 order, FlacBitReader& bit_input);
 
 // Loader for the Free Lossless Audio Codec (FLAC)
 // This loader supports all audio features of FLAC, although audio from more than two channels is discarded.
@@ -56,6 +159,7 @@ public:
     virtual MaybeLoaderError initialize() override;
 
     virtual LoaderSamples get_more_samples(size_t max_bytes_to_read_from_input = 128 * KiB) override;
+    virtual ErrorOr<size_t, LoaderError> read_samples(Span<Sample>) override;
 
     virtual MaybeLoaderError reset() override;
     virtual MaybeLoaderError seek(int sample_index) override;
@@ -79,16 +183,16 @@ private:
     // Fetches and writes the next FLAC frame
     MaybeLoaderError next_frame(Span<Sample>);
     // Helper of next_frame that fetches a sub frame's header
-    ErrorOr<FlacSubframeHeader, LoaderError> next_subframe_header(BigEndianInputBitStream& bit_input, u8 channel_index);
-    // Helper of next_frame that decompresses a subframe
-    ErrorOr<Vector<i32>, LoaderError> parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input);
+    ErrorOr<FlacSubframeHeader, LoaderError> next_subframe_header(u8 channel_index);
+    // Helper of next_frame that decompresses a subframe into the given buffer
+    MaybeLoaderError parse_subframe(FlacSubframeHeader& subframe_header, Vector<i32>& samples);
     // Subframe-internal data decoders (heavy lifting)
-    ErrorOr<Vector<i32>, LoaderError> decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    ErrorOr<Vector<i32>, LoaderError> decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    ErrorOr<Vector<i32>, LoaderError> decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    MaybeLoaderError decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
+    MaybeLoaderError decode_fixed_lpc(FlacSubframeHeader& subframe, Vector<i32>& decoded);
+    MaybeLoaderError decode_verbatim(FlacSubframeHeader& subframe, Vector<i32>& decoded);
+    MaybeLoaderError decode_custom_lpc(FlacSubframeHeader& subframe, Vector<i32>& decoded);
+    MaybeLoaderError decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe);
     // decode a single rice partition that has its own rice parameter
-    ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
+    ALWAYS_INLINE MaybeLoaderError decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, Vector<i32>& decoded);
     MaybeLoaderError load_seektable(FlacRawMetadataBlock&);
 
     // Converters for special coding used in frame headers
@@ -116,7 +220,11 @@ private:
     // keep track of the start of the data in the FLAC stream to seek back more easily
     u64 m_data_start_location { 0 };
     OwnPtr<Core::Stream::SeekableStream> m_stream;
+    // All frames are read through this, after the header.
+    OwnPtr<FlacBitReader> m_bit_reader;
     Optional<FlacFrameHeader> m_current_frame;
+    // The decoded samples of every channel in the current frame. These are kept around to not allocate for every frame.
+    Array<Vector<i32>, 8> m_subframe_samples;
     // Whatever the last get_more_samples() call couldn't return gets stored here.
     Vector<Sample, FLAC_BUFFER_SIZE> m_unread_data;
     u64 m_current_sample_or_frame { 0 };
@@ -35,6 +35,10 @@ public:
 
     virtual LoaderSamples get_more_samples(size_t max_bytes_to_read_from_input = 128 * KiB) = 0;
 
+    // Decodes the next samples straight into the given buffer, without allocating anything per call.
+    // Returns how many samples it decoded, which is less than the buffer holds only at the end of the stream.
+    virtual ErrorOr<size_t, LoaderError> read_samples(Span<Sample>) = 0;
+
     virtual MaybeLoaderError reset() = 0;
 
     virtual MaybeLoaderError seek(int const sample_index) = 0;
@@ -63,6 +67,7 @@ public:
     static Result<NonnullRefPtr<Loader>, LoaderError> create(Bytes& buffer) { return adopt_ref(*new Loader(TRY(try_create(buffer)))); }
 
     LoaderSamples get_more_samples(size_t max_samples_to_read_from_input = 128 * KiB) const { return m_plugin->get_more_samples(max_samples_to_read_from_input); }
+    ErrorOr<size_t, LoaderError> read_samples(Span<Sample> samples) const { return m_plugin->read_samples(samples); }
 
     MaybeLoaderError reset() const { return m_plugin->reset(); }
     MaybeLoaderError seek(int const position) const { return m_plugin->seek(position); }
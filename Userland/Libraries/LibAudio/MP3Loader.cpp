@@ -8,11 +8,26 @@
 #include "MP3HuffmanTables.h"
 #include "MP3Tables.h"
 #include <AK/FixedArray.h>
+#include <AK/SIMD.h>
 #include <LibCore/File.h>
 #include <LibCore/FileStream.h>
 
 namespace Audio {
 
+using AK::SIMD::f32x4;
+
+static ALWAYS_INLINE f32x4 load4(float const* data)
+{
+    f32x4 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static ALWAYS_INLINE void store4(float* data, f32x4 value)
+{
+    __builtin_memcpy(data, &value, sizeof(value));
+}
+
 DSP::MDCT<12> MP3LoaderPlugin::s_mdct_12;
 DSP::MDCT<36> MP3LoaderPlugin::s_mdct_36;
 
@@ -91,6 +106,7 @@ MaybeLoaderError MP3LoaderPlugin::reset()
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     m_loaded_samples = 0;
     m_bit_reservoir.discard_or_error(m_bit_reservoir.size());
     return {};
@@ -108,6 +124,7 @@ MaybeLoaderError MP3LoaderPlugin::seek(int const position)
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     m_bit_reservoir.discard_or_error(m_bit_reservoir.size());
     m_input_stream->handle_any_error();
     m_bitstream->handle_any_error();
@@ -119,44 +136,49 @@ MaybeLoaderError MP3LoaderPlugin::seek(int const position)
 LoaderSamples MP3LoaderPlugin::get_more_samples(size_t max_samples_to_read_from_input)
 {
     FixedArray<Sample> samples = LOADER_TRY(FixedArray<Sample>::try_create(max_samples_to_read_from_input));
+    auto samples_read = TRY(read_samples(samples.span()));
+    if (samples_read == samples.size())
+        return samples;
+    // Don't hand out the part of the buffer that we couldn't fill at the end of the stream.
+    return LOADER_TRY(FixedArray<Sample>::try_create(samples.span().trim(samples_read)));
+}
 
-    size_t samples_to_read = max_samples_to_read_from_input;
-    while (samples_to_read > 0) {
+ErrorOr<size_t, LoaderError> MP3LoaderPlugin::read_samples(Span<Sample> samples)
+{
+    size_t samples_read = 0;
+    while (samples_read < samples.size()) {
         if (!m_current_frame.has_value()) {
             auto maybe_frame = read_next_frame();
             if (maybe_frame.is_error()) {
-                if (m_input_stream->unreliable_eof()) {
-                    return FixedArray<Sample> {};
-                }
+                if (m_input_stream->unreliable_eof())
+                    break;
                 return maybe_frame.release_error();
             }
             m_current_frame = maybe_frame.release_value();
-            if (!m_current_frame.has_value())
-                break;
             m_is_first_frame = false;
             m_current_frame_read = 0;
         }
 
         bool const is_stereo = m_current_frame->header.channel_count() == 2;
-        for (; m_current_frame_read < 576 && samples_to_read > 0; m_current_frame_read++) {
-            auto const left_sample = m_current_frame->channels[0].granules[0].pcm[m_current_frame_read / 32][m_current_frame_read % 32];
-            auto const right_sample = is_stereo ? m_current_frame->channels[1].granules[0].pcm[m_current_frame_read / 32][m_current_frame_read % 32] : left_sample;
-            samples[samples.size() - samples_to_read] = Sample { left_sample, right_sample };
-            samples_to_read--;
-        }
-        for (; m_current_frame_read < 1152 && samples_to_read > 0; m_current_frame_read++) {
-            auto const left_sample = m_current_frame->channels[0].granules[1].pcm[(m_current_frame_read - 576) / 32][(m_current_frame_read - 576) % 32];
-            auto const right_sample = is_stereo ? m_current_frame->channels[1].granules[1].pcm[(m_current_frame_read - 576) / 32][(m_current_frame_read - 576) % 32] : left_sample;
-            samples[samples.size() - samples_to_read] = Sample { left_sample, right_sample };
-            samples_to_read--;
+        while (m_current_frame_read < 1152 && samples_read < samples.size()) {
+            // The 18 rows of 32 samples each in a granule are contiguous, so they can be read as one block.
+            auto const granule_index = m_current_frame_read / 576;
+            auto const* left = m_current_frame->channels[0].granules[granule_index].pcm[0].data();
+            auto const* right = is_stereo ? m_current_frame->channels[1].granules[granule_index].pcm[0].data() : left;
+            auto const granule_offset = m_current_frame_read % 576;
+            auto const count = min(576 - granule_offset, samples.size() - samples_read);
+            for (size_t i = 0; i < count; i++)
+                samples[samples_read + i] = Sample { left[granule_offset + i], right[granule_offset + i] };
+            samples_read += count;
+            m_current_frame_read += count;
         }
         if (m_current_frame_read == 1152) {
             m_current_frame = {};
         }
     }
 
-    m_loaded_samples += samples.size();
-    return samples;
+    m_loaded_samples += samples_read;
+    return samples_read;
 }
 
 MaybeLoaderError MP3LoaderPlugin::build_seek_table()
@@ -260,10 +282,9 @@ ErrorOr<MP3::MP3Frame, LoaderError> MP3LoaderPlugin::read_frame_data(MP3::Header
     if (m_bitstream->has_any_error())
         return LoaderError { LoaderError::Category::IO, m_loaded_samples, "Read error" };
 
-    auto maybe_buffer = ByteBuffer::create_uninitialized(header.slot_count);
-    if (maybe_buffer.is_error())
+    if (m_frame_data.try_resize(header.slot_count).is_error())
         return LoaderError { LoaderError::Category::IO, m_loaded_samples, "Out of memory" };
-    auto& buffer = maybe_buffer.value();
+    auto& buffer = m_frame_data;
 
     size_t old_reservoir_size = m_bit_reservoir.size();
     if (m_bitstream->read(buffer) != buffer.size())
@@ -341,7 +362,7 @@ ErrorOr<MP3::MP3Frame, LoaderError> MP3LoaderPlugin::read_frame_data(MP3::Header
                 for (size_t band_index = 0; band_index < 32; band_index++) {
                     in_samples[band_index] = granule.filter_bank_input[band_index][sample_index];
                 }
-                synthesis(m_synthesis_buffer[channel_index], in_samples, granule.pcm[sample_index]);
+                synthesis(m_synthesis_buffer[channel_index], m_synthesis_buffer_offset[channel_index], in_samples, granule.pcm[sample_index]);
             }
         }
     }
@@ -845,38 +866,30 @@ void MP3LoaderPlugin::transform_samples_to_time(Array<float, 576> const& input,
 }
 
 // ISO/IEC 11172-3 (Figure A.2)
-void MP3LoaderPlugin::synthesis(Array<float, 1024>& V, Array<float, 32>& samples, Array<float, 32>& result)
+void MP3LoaderPlugin::synthesis(Array<float, 1024>& V, size_t& V_offset, Array<float, 32>& samples, Array<float, 32>& result)
 {
-    for (size_t i = 1023; i >= 64; i--) {
-        V[i] = V[i - 64];
-    }
+    // V is a ring buffer that starts at V_offset. Shifting it by 64 values just means moving the start back,
+    // and since the start is always a multiple of 64, none of the blocks of 4 values used below wrap around.
+    V_offset = (V_offset - 64) & 1023;
 
     for (size_t i = 0; i < 64; i++) {
-        V[i] = 0;
-        for (size_t k = 0; k < 32; k++) {
-            float const N = MP3::Tables::SynthesisSubbandFilterCoefficients[i][k];
-            V[i] += N * samples[k];
-        }
-    }
-
-    Array<float, 512> U;
-    for (size_t i = 0; i < 8; i++) {
-        for (size_t j = 0; j < 32; j++) {
-            U[i * 64 + j] = V[i * 128 + j];
-            U[i * 64 + 32 + j] = V[i * 128 + 96 + j];
-        }
+        f32x4 sum {};
+        for (size_t k = 0; k < 32; k += 4)
+            sum += load4(&MP3::Tables::SynthesisSubbandFilterCoefficients[i][k]) * load4(&samples[k]);
+        V[V_offset + i] = sum[0] + sum[1] + sum[2] + sum[3];
     }
 
-    Array<float, 512> W;
-    for (size_t i = 0; i < 512; i++) {
-        W[i] = U[i] * MP3::Tables::WindowSynthesis[i];
-    }
-
-    for (size_t j = 0; j < 32; j++) {
-        result[j] = 0;
-        for (size_t k = 0; k < 16; k++) {
-            result[j] += W[j + 32 * k];
+    // Windowing and summation, without building U and W: the j-th sample sums up every 32nd value of W,
+    // which alternately comes from the first and the last 32 values of every 128 values of V.
+    for (size_t j = 0; j < 32; j += 4) {
+        f32x4 sum {};
+        for (size_t i = 0; i < 8; i++) {
+            auto const first = (V_offset + i * 128) & 1023;
+            auto const last = (V_offset + i * 128 + 96) & 1023;
+            sum += load4(&V[first + j]) * load4(&MP3::Tables::WindowSynthesis[i * 64 + j]);
+            sum += load4(&V[last + j]) * load4(&MP3::Tables::WindowSynthesis[i * 64 + 32 + j]);
         }
+        store4(&result[j], sum);
     }
 }
 
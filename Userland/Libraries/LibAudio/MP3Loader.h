@@ -8,6 +8,7 @@
 
 #include "Loader.h"
 #include "MP3Types.h"
+#include <AK/ByteBuffer.h>
 #include <AK/MemoryStream.h>
 #include <AK/Tuple.h>
 #include <LibCore/FileStream.h>
@@ -26,6 +27,7 @@ public:
 
     virtual MaybeLoaderError initialize() override;
     virtual LoaderSamples get_more_samples(size_t max_bytes_to_read_from_input = 128 * KiB) override;
+    virtual ErrorOr<size_t, LoaderError> read_samples(Span<Sample>) override;
 
     virtual MaybeLoaderError reset() override;
     virtual MaybeLoaderError seek(int const position) override;
@@ -52,12 +54,14 @@ private:
     static void reduce_alias(MP3::Granule&, size_t max_subband_index = 576);
     static void process_stereo(MP3::MP3Frame&, size_t granule_index);
     static void transform_samples_to_time(Array<float, 576> const& input, size_t input_offset, Array<float, 36>& output, MP3::BlockType block_type);
-    static void synthesis(Array<float, 1024>& V, Array<float, 32>& samples, Array<float, 32>& result);
+    static void synthesis(Array<float, 1024>& V, size_t& V_offset, Array<float, 32>& samples, Array<float, 32>& result);
     static Span<MP3::Tables::ScaleFactorBand const> get_scalefactor_bands(MP3::Granule const&, int samplerate);
 
     AK::Vector<AK::Tuple<size_t, int>> m_seek_table;
     AK::Array<AK::Array<AK::Array<float, 18>, 32>, 2> m_last_values {};
     AK::Array<AK::Array<float, 1024>, 2> m_synthesis_buffer {};
+    // The synthesis buffers are used as ring buffers, this is where each of them currently starts.
+    AK::Array<size_t, 2> m_synthesis_buffer_offset {};
     static DSP::MDCT<36> s_mdct_36;
     static DSP::MDCT<12> s_mdct_12;
 
@@ -75,6 +79,8 @@ private:
     OwnPtr<Core::InputFileStream> m_input_stream;
     OwnPtr<InputBitStream> m_bitstream;
     DuplexMemoryStream m_bit_reservoir;
+    // Reused for the main data of every frame.
+    ByteBuffer m_frame_data;
     Optional<LoaderError> m_error {};
 };
 
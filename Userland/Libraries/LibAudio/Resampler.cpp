@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Resampler.h"
+#include <AK/Math.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+
+namespace Audio {
+
+using AK::SIMD::f32x4;
+
+// The number of zero crossings of the sinc on either side of its center.
+// More of them make the transition band narrower, at the cost of a longer filter.
+static constexpr u32 filter_zero_crossings = 16;
+// Leaves some room below the Nyquist frequency for the transition band.
+static constexpr double filter_cutoff = 0.95;
+// Rates in awkward ratios would need lots of phases; beyond this, phases get rounded down to one of this many.
+static constexpr u32 max_filter_count = 1024;
+
+static ALWAYS_INLINE f32x4 load_unaligned(float const* data)
+{
+    f32x4 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static u32 greatest_common_divisor(u32 a, u32 b)
+{
+    while (b != 0) {
+        auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+ErrorOr<SincResampler> SincResampler::try_create(u32 source, u32 target)
+{
+    VERIFY(source > 0);
+    VERIFY(target > 0);
+    SincResampler resampler { source, target };
+    TRY(resampler.compute_filter_bank());
+    resampler.reset();
+    return resampler;
+}
+
+ErrorOr<void> SincResampler::compute_filter_bank()
+{
+    auto divisor = greatest_common_divisor(m_source, m_target);
+    m_phase_count = m_target / divisor;
+    m_step = m_source / divisor;
+    m_filter_count = min(m_phase_count, max_filter_count);
+
+    // When downsampling, everything above the new Nyquist frequency has to go, which makes the sinc wider.
+    auto cutoff = filter_cutoff * min(1.0, static_cast<double>(m_target) / static_cast<double>(m_source));
+    m_tap_count = align_up_to(static_cast<size_t>(AK::ceil(2 * filter_zero_crossings / cutoff)), 4);
+
+    TRY(m_filter_bank.try_resize(m_filter_count * m_tap_count));
+    auto const half_length = static_cast<double>(m_tap_count) / 2;
+    for (u32 filter = 0; filter < m_filter_count; ++filter) {
+        auto fraction = static_cast<double>(filter) / static_cast<double>(m_filter_count);
+        auto coefficients = m_filter_bank.span().slice(filter * m_tap_count, m_tap_count);
+        double sum = 0;
+        for (size_t tap = 0; tap < m_tap_count; ++tap) {
+            // The distance of this tap from the output sample, in input samples.
+            auto distance = static_cast<double>(tap) - (half_length - 1) - fraction;
+            auto x = AK::Pi<double> * cutoff * distance;
+            auto sinc = distance == 0 ? 1.0 : AK::sin(x) / x;
+            // Blackman window, which reaches zero at the ends of the filter.
+            auto window_phase = AK::Pi<double> * distance / half_length;
+            auto window = 0.42 + 0.5 * AK::cos(window_phase) + 0.08 * AK::cos(2 * window_phase);
+            auto coefficient = sinc * window;
+            coefficients[tap] = static_cast<float>(coefficient);
+            sum += coefficient;
+        }
+        // Normalizing every phase to unity gain keeps constant signals constant.
+        for (auto& coefficient : coefficients)
+            coefficient = static_cast<float>(coefficient / sum);
+    }
+    return {};
+}
+
+void SincResampler::reset()
+{
+    // Start out with silence before the first sample, so that the first output sample lines up with it.
+    auto const history = m_tap_count / 2 - 1;
+    m_left.clear_with_capacity();
+    m_right.clear_with_capacity();
+    m_left.resize(history);
+    m_right.resize(history);
+    m_position = 0;
+    m_phase = 0;
+}
+
+ErrorOr<FixedArray<Sample>> SincResampler::resample(Span<Sample const> samples)
+{
+    if (m_source == m_target)
+        return FixedArray<Sample>::try_create(samples);
+
+    TRY(m_left.try_ensure_capacity(m_left.size() + samples.size()));
+    TRY(m_right.try_ensure_capacity(m_right.size() + samples.size()));
+    for (auto const& sample : samples) {
+        m_left.unchecked_append(sample.left);
+        m_right.unchecked_append(sample.right);
+    }
+
+    // Count the output samples first, so we can allocate them in one go.
+    size_t output_count = 0;
+    if (m_left.size() >= m_position + m_tap_count) {
+        auto const available_positions = m_left.size() - m_tap_count - m_position;
+        output_count = (static_cast<u64>(available_positions + 1) * m_phase_count - m_phase + m_step - 1) / m_step;
+    }
+    auto output = TRY(FixedArray<Sample>::try_create(output_count));
+
+    auto const* left = m_left.data();
+    auto const* right = m_right.data();
+    for (auto& output_sample : output) {
+        VERIFY(m_position + m_tap_count <= m_left.size());
+        auto filter = m_filter_count == m_phase_count ? m_phase : static_cast<u32>(static_cast<u64>(m_phase) * m_filter_count / m_phase_count);
+        auto const* coefficients = m_filter_bank.data() + filter * m_tap_count;
+
+        f32x4 left_sum {};
+        f32x4 right_sum {};
+        for (size_t tap = 0; tap < m_tap_count; tap += 4) {
+            auto coefficient = load_unaligned(coefficients + tap);
+            left_sum += coefficient * load_unaligned(left + m_position + tap);
+            right_sum += coefficient * load_unaligned(right + m_position + tap);
+        }
+        output_sample = Sample {
+            left_sum[0] + left_sum[1] + left_sum[2] + left_sum[3],
+            right_sum[0] + right_sum[1] + right_sum[2] + right_sum[3],
+        };
+
+        m_phase += m_step;
+        m_position += m_phase / m_phase_count;
+        m_phase %= m_phase_count;
+    }
+
+    // Drop the input that no future output sample will look at.
+    auto consumed = min(m_position, m_left.size());
+    m_left.remove(0, consumed);
+    m_right.remove(0, consumed);
+    m_position -= consumed;
+
+    return output;
+}
+
+}
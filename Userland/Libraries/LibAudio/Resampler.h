@@ -7,14 +7,18 @@
 #pragma once
 
 #include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibAudio/Sample.h>
 
 namespace Audio {
 
 // Small helper to resample from one playback rate to another
 // This isn't really "smart", in that we just insert (or drop) samples.
-// Should do better...
+// For playback of Audio::Samples, use SincResampler below instead.
 template<typename SampleType>
 class ResampleHelper {
 public:
@@ -84,4 +88,53 @@ private:
     SampleType m_last_sample_r {};
 };
 
+// Band-limited resampler for streams of stereo samples.
+// Every output sample is the input convolved with a windowed sinc filter, whose cutoff is the lower of the two Nyquist
+// frequencies. The filter is precomputed for every position that an output sample can have between two input
+// samples (the phases), so producing a sample is a single dot product per channel.
+// The last few input samples are kept around, so consecutive calls to resample() form one continuous signal; this
+// delays the output by half the length of the filter.
+class SincResampler {
+public:
+    static ErrorOr<SincResampler> try_create(u32 source, u32 target);
+
+    // Returns as many resampled samples as there is enough input for by now.
+    ErrorOr<FixedArray<Sample>> resample(Span<Sample const>);
+
+    // Forgets about all previous input, e.g. after seeking.
+    void reset();
+
+    u32 source() const { return m_source; }
+    u32 target() const { return m_target; }
+
+private:
+    SincResampler(u32 source, u32 target)
+        : m_source(source)
+        , m_target(target)
+    {
+    }
+
+    ErrorOr<void> compute_filter_bank();
+
+    u32 m_source { 0 };
+    u32 m_target { 0 };
+
+    // The ratio between the rates in lowest terms: for every m_phase_count output samples, m_step input samples pass.
+    u32 m_phase_count { 1 };
+    u32 m_step { 1 };
+
+    // Always a multiple of four, so the filters can be applied with SIMD.
+    size_t m_tap_count { 0 };
+    // Has m_tap_count coefficients for every phase, or for a quantized subset of them if there are too many.
+    Vector<float> m_filter_bank;
+    u32 m_filter_count { 0 };
+
+    // The input samples that are still needed, by channel.
+    Vector<float> m_left;
+    Vector<float> m_right;
+    // Where the filter for the next output sample starts in the input, and its phase.
+    size_t m_position { 0 };
+    u32 m_phase { 0 };
+};
+
 }
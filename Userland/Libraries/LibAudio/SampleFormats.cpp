@@ -5,9 +5,20 @@
  */
 
 #include "SampleFormats.h"
+#include <AK/Endian.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 
 namespace Audio {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+
+// The conversions below write straight into the samples, viewed as an array of floats.
+static_assert(sizeof(Sample) == 2 * sizeof(float));
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "PCM data is read without byte swapping");
+
 u16 pcm_bits_per_sample(PcmSampleFormat format)
 {
     switch (format) {
@@ -33,4 +44,94 @@ String sample_format_name(PcmSampleFormat format)
     return String::formatted("PCM {}bit {}", pcm_bits_per_sample(format), is_float ? "Float" : "LE");
 }
 
+static ALWAYS_INLINE void store_unaligned(float* data, f32x4 value)
+{
+    __builtin_memcpy(data, &value, sizeof(value));
+}
+
+// Reads one signed integer value, scaled up to the full range of an i32.
+template<PcmSampleFormat format>
+static ALWAYS_INLINE i32 read_integer(u8 const* data)
+{
+    if constexpr (format == PcmSampleFormat::Uint8) {
+        // 8-bit PCM is the only unsigned one; silence is at 128.
+        return (static_cast<i32>(data[0]) - 128) << 24;
+    } else if constexpr (format == PcmSampleFormat::Int16) {
+        i16 value;
+        __builtin_memcpy(&value, data, sizeof(value));
+        return static_cast<i32>(value) << 16;
+    } else if constexpr (format == PcmSampleFormat::Int32) {
+        i32 value;
+        __builtin_memcpy(&value, data, sizeof(value));
+        return value;
+    } else {
+        static_assert(format == PcmSampleFormat::Int24);
+        // There's no i24 type, so we put the three bytes in the top of an i32 instead.
+        return static_cast<i32>((static_cast<u32>(data[0]) << 8) | (static_cast<u32>(data[1]) << 16) | (static_cast<u32>(data[2]) << 24));
+    }
+}
+
+template<PcmSampleFormat format, size_t value_size>
+static void convert_integers(ReadonlyBytes data, float* values, size_t count)
+{
+    constexpr float scale = 1.0f / static_cast<float>(NumericLimits<i32>::max());
+    auto const* bytes = data.data();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, bytes += 4 * value_size) {
+        i32x4 integers {
+            read_integer<format>(bytes),
+            read_integer<format>(bytes + value_size),
+            read_integer<format>(bytes + 2 * value_size),
+            read_integer<format>(bytes + 3 * value_size),
+        };
+        store_unaligned(values + i, AK::SIMD::to_f32x4(integers) * scale);
+    }
+    for (; i < count; ++i, bytes += value_size)
+        values[i] = static_cast<float>(read_integer<format>(bytes)) * scale;
+}
+
+void convert_pcm_to_samples(PcmSampleFormat format, u16 channel_count, ReadonlyBytes data, Span<Sample> samples)
+{
+    VERIFY(channel_count == 1 || channel_count == 2);
+    auto const value_count = samples.size() * channel_count;
+    VERIFY(data.size() == value_count * pcm_bits_per_sample(format) / 8);
+
+    // Mono values go into the second half first, and are spread out over both channels afterwards.
+    auto* values = reinterpret_cast<float*>(samples.data()) + (channel_count == 1 ? samples.size() : 0);
+
+    switch (format) {
+    case PcmSampleFormat::Uint8:
+        convert_integers<PcmSampleFormat::Uint8, 1>(data, values, value_count);
+        break;
+    case PcmSampleFormat::Int16:
+        convert_integers<PcmSampleFormat::Int16, 2>(data, values, value_count);
+        break;
+    case PcmSampleFormat::Int24:
+        convert_integers<PcmSampleFormat::Int24, 3>(data, values, value_count);
+        break;
+    case PcmSampleFormat::Int32:
+        convert_integers<PcmSampleFormat::Int32, 4>(data, values, value_count);
+        break;
+    case PcmSampleFormat::Float32:
+        __builtin_memcpy(values, data.data(), data.size());
+        break;
+    case PcmSampleFormat::Float64:
+        for (size_t i = 0; i < value_count; ++i) {
+            double value;
+            __builtin_memcpy(&value, data.offset(i * sizeof(double)), sizeof(double));
+            values[i] = static_cast<float>(value);
+        }
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    // Going front to back never overwrites a value before it has been read.
+    if (channel_count == 1) {
+        for (size_t i = 0; i < samples.size(); ++i)
+            samples[i] = Sample { values[i] };
+    }
+}
+
 }
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <AK/String.h>
 #include <AK/Types.h>
+#include <LibAudio/Sample.h>
 
 namespace Audio {
 
@@ -24,4 +26,8 @@ enum class PcmSampleFormat : u8 {
 // Most of the read code only cares about how many bits to read or write
 u16 pcm_bits_per_sample(PcmSampleFormat format);
 String sample_format_name(PcmSampleFormat format);
+
+// Converts interleaved little-endian PCM data with one or two channels into samples. Mono data ends up on both sides.
+// The data has to contain exactly as many values as are needed for the samples.
+void convert_pcm_to_samples(PcmSampleFormat format, u16 channel_count, ReadonlyBytes data, Span<Sample> samples);
 }
@@ -8,9 +8,7 @@
 #include "WavLoader.h"
 #include "LoaderError.h"
 #include <AK/Debug.h>
-#include <AK/Endian.h>
 #include <AK/FixedArray.h>
-#include <AK/NumericLimits.h>
 #include <AK/Try.h>
 #include <LibCore/MemoryStream.h>
 
@@ -39,85 +37,6 @@ WavLoaderPlugin::WavLoaderPlugin(Bytes const& buffer)
 {
 }
 
-template<typename SampleReader>
-MaybeLoaderError WavLoaderPlugin::read_samples_from_stream(Core::Stream::Stream& stream, SampleReader read_sample, FixedArray<Sample>& samples) const
-{
-    switch (m_num_channels) {
-    case 1:
-        for (auto& sample : samples)
-            sample = Sample(LOADER_TRY(read_sample(stream)));
-        break;
-    case 2:
-        for (auto& sample : samples) {
-            auto left_channel_sample = LOADER_TRY(read_sample(stream));
-            auto right_channel_sample = LOADER_TRY(read_sample(stream));
-            sample = Sample(left_channel_sample, right_channel_sample);
-        }
-        break;
-    default:
-        VERIFY_NOT_REACHED();
-    }
-    return {};
-}
-
-// There's no i24 type + we need to do the endianness conversion manually anyways.
-static ErrorOr<double> read_sample_int24(Core::Stream::Stream& stream)
-{
-    u8 byte = 0;
-    TRY(stream.read(Bytes { &byte, 1 }));
-    i32 sample1 = byte;
-    TRY(stream.read(Bytes { &byte, 1 }));
-    i32 sample2 = byte;
-    TRY(stream.read(Bytes { &byte, 1 }));
-    i32 sample3 = byte;
-
-    i32 value = 0;
-    value = sample1 << 8;
-    value |= sample2 << 16;
-    value |= sample3 << 24;
-    return static_cast<double>(value) / static_cast<double>((1 << 24) - 1);
-}
-
-template<typename T>
-static ErrorOr<double> read_sample(Core::Stream::Stream& stream)
-{
-    T sample { 0 };
-    TRY(stream.read(Bytes { &sample, sizeof(T) }));
-    if constexpr (IsIntegral<T>) {
-        return static_cast<double>(AK::convert_between_host_and_little_endian(sample)) / static_cast<double>(NumericLimits<T>::max());
-    } else {
-        return static_cast<double>(AK::convert_between_host_and_little_endian(sample));
-    }
-}
-
-LoaderSamples WavLoaderPlugin::samples_from_pcm_data(Bytes const& data, size_t samples_to_read) const
-{
-    FixedArray<Sample> samples = LOADER_TRY(FixedArray<Sample>::try_create(samples_to_read));
-    auto stream = LOADER_TRY(Core::Stream::MemoryStream::construct(move(data)));
-
-    switch (m_sample_format) {
-    case PcmSampleFormat::Uint8:
-        TRY(read_samples_from_stream(*stream, read_sample<u8>, samples));
-        break;
-    case PcmSampleFormat::Int16:
-        TRY(read_samples_from_stream(*stream, read_sample<i16>, samples));
-        break;
-    case PcmSampleFormat::Int24:
-        TRY(read_samples_from_stream(*stream, read_sample_int24, samples));
-        break;
-    case PcmSampleFormat::Float32:
-        TRY(read_samples_from_stream(*stream, read_sample<float>, samples));
-        break;
-    case PcmSampleFormat::Float64:
-        TRY(read_samples_from_stream(*stream, read_sample<double>, samples));
-        break;
-    default:
-        VERIFY_NOT_REACHED();
-    }
-
-    return samples;
-}
-
 LoaderSamples WavLoaderPlugin::get_more_samples(size_t max_samples_to_read_from_input)
 {
     if (!m_stream)
@@ -134,20 +53,45 @@ LoaderSamples WavLoaderPlugin::get_more_samples(size_t max_samples_to_read_from_
 
     // Might truncate if not evenly divisible by the sample size
     auto max_samples_to_read = max_samples_to_read_from_input / bytes_per_sample;
-    auto samples_to_read = min(max_samples_to_read, remaining_samples);
-    auto bytes_to_read = samples_to_read * bytes_per_sample;
+    auto samples = LOADER_TRY(FixedArray<Sample>::try_create(min(max_samples_to_read, remaining_samples)));
+    TRY(read_samples(samples.span()));
+    return samples;
+}
+
+ErrorOr<size_t, LoaderError> WavLoaderPlugin::read_samples(Span<Sample> samples)
+{
+    if (!m_stream)
+        return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(m_loaded_samples), "No stream; initialization failed" };
+
+    samples = samples.trim(m_total_samples - m_loaded_samples);
+    if (samples.is_empty())
+        return 0;
+
+    size_t bytes_per_sample = m_num_channels * pcm_bits_per_sample(m_sample_format) / 8;
+    auto bytes_to_read = samples.size() * bytes_per_sample;
 
     dbgln_if(AWAVLOADER_DEBUG, "Read {} bytes WAV with num_channels {} sample rate {}, "
                                "bits per sample {}, sample format {}",
         bytes_to_read, m_num_channels, m_sample_rate,
         pcm_bits_per_sample(m_sample_format), sample_format_name(m_sample_format));
 
-    auto sample_data = LOADER_TRY(ByteBuffer::create_zeroed(bytes_to_read));
-    LOADER_TRY(m_stream->read(sample_data.bytes()));
+    // The buffer for the raw data sticks around, so that reading doesn't allocate once it's large enough.
+    LOADER_TRY(m_sample_data.try_resize(bytes_to_read));
+    auto remaining_data = m_sample_data.bytes();
+    while (!remaining_data.is_empty()) {
+        auto read_data = LOADER_TRY(m_stream->read(remaining_data));
+        if (read_data.is_empty())
+            break;
+        remaining_data = remaining_data.slice(read_data.size());
+    }
+    // A truncated file ends in silence.
+    remaining_data.fill(0);
+
+    convert_pcm_to_samples(m_sample_format, m_num_channels, m_sample_data, samples);
 
     // m_loaded_samples should contain the amount of actually loaded samples
-    m_loaded_samples += samples_to_read;
-    return samples_from_pcm_data(sample_data.bytes(), samples_to_read);
+    m_loaded_samples += samples.size();
+    return samples.size();
 }
 
 MaybeLoaderError WavLoaderPlugin::seek(int sample_index)
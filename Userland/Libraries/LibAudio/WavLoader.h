@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/FixedArray.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
@@ -35,6 +36,7 @@ public:
     virtual MaybeLoaderError initialize() override;
 
     virtual LoaderSamples get_more_samples(size_t max_samples_to_read_from_input = 128 * KiB) override;
+    virtual ErrorOr<size_t, LoaderError> read_samples(Span<Sample>) override;
 
     virtual MaybeLoaderError reset() override { return seek(0); }
 
@@ -53,15 +55,12 @@ public:
 private:
     MaybeLoaderError parse_header();
 
-    LoaderSamples samples_from_pcm_data(Bytes const& data, size_t samples_to_read) const;
-    template<typename SampleReader>
-    MaybeLoaderError read_samples_from_stream(Core::Stream::Stream& stream, SampleReader read_sample, FixedArray<Sample>& samples) const;
-
     // This is only kept around for compatibility for now.
     RefPtr<Core::File> m_file;
     OwnPtr<Core::Stream::SeekableStream> m_stream;
     // The constructor might set this so that we can initialize the data stream later.
     Optional<Bytes const&> m_backing_memory;
+    ByteBuffer m_sample_data;
 
     u32 m_sample_rate { 0 };
     u16 m_num_channels { 0 };
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <cpuid.h>
+#include <string.h>
+
+extern "C" {
+
+extern void* memcpy_sse2(void*, void const*, size_t);
+extern void* memcpy_sse2_erms(void*, void const*, size_t);
+extern void* memcpy_avx2(void*, void const*, size_t);
+
+constexpr u32 tcg_signature_ebx = 0x54474354;
+constexpr u32 tcg_signature_ecx = 0x43544743;
+constexpr u32 tcg_signature_edx = 0x47435447;
+
+// Bits 27 and 28 of ecx in cpuid[eax = 1] indicate that the OS uses XSAVE and that AVX is supported
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+
+// Bit 5 of ebx in cpuid[eax = 7] indicates support for AVX2
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+
+// Bit 9 of ebx in cpuid[eax = 7] indicates support for "Enhanced REP MOVSB/STOSB"
+constexpr u32 cpuid_7_ebx_bit_erms = 1 << 9;
+
+// Bits 1 and 2 of XCR0 indicate that the OS saves the SSE and AVX register state
+constexpr u32 xcr0_sse_and_avx_state = 0b110;
+
+namespace {
+bool os_supports_avx()
+{
+    u32 eax, ebx, ecx, edx;
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & cpuid_1_ecx_bit_osxsave) || !(ecx & cpuid_1_ecx_bit_avx))
+        return false;
+
+    u32 xcr0_low, xcr0_high;
+    asm volatile("xgetbv"
+                 : "=a"(xcr0_low), "=d"(xcr0_high)
+                 : "c"(0));
+    return (xcr0_low & xcr0_sse_and_avx_state) == xcr0_sse_and_avx_state;
+}
+
+[[gnu::used]] decltype(&memcpy) resolve_memcpy()
+{
+    u32 eax, ebx, ecx, edx;
+
+    __cpuid(0x40000000, eax, ebx, ecx, edx);
+    bool is_tcg = ebx == tcg_signature_ebx && ecx == tcg_signature_ecx && edx == tcg_signature_edx;
+
+    // See the comment in memset.cpp, TCG's REP MOVSB is as slow as its REP STOSB.
+    if (is_tcg)
+        return memcpy_sse2;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    if ((ebx & cpuid_7_ebx_bit_avx2) && os_supports_avx())
+        return memcpy_avx2;
+
+    if (ebx & cpuid_7_ebx_bit_erms)
+        return memcpy_sse2_erms;
+
+    return memcpy_sse2;
+}
+}
+
+#if !defined(__clang__) && !defined(_DYNAMIC_LOADER)
+[[gnu::ifunc("resolve_memcpy")]] void* memcpy(void*, void const*, size_t);
+#else
+// DynamicLoader can't self-relocate IFUNCs.
+// FIXME: There's a circular dependency between LibC and libunwind when built with Clang,
+// so the IFUNC resolver could be called before LibC has been relocated, returning bogus addresses.
+void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
+{
+    static decltype(&memcpy) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memcpy();
+
+    return s_impl(dest_ptr, src_ptr, n);
+}
+#endif
+}
@@ -66,6 +66,10 @@ public:
     u8 const* readptr(size_t& available_size);
     void readptr_increase(size_t increment);
 
+    // Like readptr(), but reads more data into the buffer first if it's empty.
+    // Returns nothing if the stream isn't buffered, or if there's nothing left to read.
+    u8 const* fill_and_readptr(size_t& available_size);
+
     enum Flags : u8 {
         None = 0,
         LastRead = 1,
@@ -79,9 +83,11 @@ private:
         ~Buffer();
 
         int mode() const { return m_mode; }
+        size_t capacity() const { return m_capacity; }
         void setbuf(u8* data, int mode, size_t size);
         // Make sure to call realize() before enqueuing any data.
         // Dequeuing can be attempted without it.
+        // This is also where a buffer that keeps filling up grows, while it's empty.
         void realize(int fd);
         void drop();
 
@@ -99,6 +105,8 @@ private:
 
     private:
         constexpr static auto unget_buffer_size = MB_CUR_MAX;
+        // Buffers start out at BUFSIZ, and double every time they fill up completely, up to this size.
+        constexpr static size_t max_adaptive_capacity = 64 * KiB;
         constexpr static u32 ungotten_mask = ((u32)0xffffffff) >> (sizeof(u32) * 8 - unget_buffer_size);
 
         // Note: the fields here are arranged this way
@@ -112,6 +120,9 @@ private:
         Array<u8, unget_buffer_size> m_unget_buffer { 0 };
         u32 m_ungotten : unget_buffer_size { 0 };
         bool m_data_is_malloced : 1 { false };
+        // Set when the size was picked with setvbuf(), so it doesn't grow.
+        bool m_capacity_is_fixed : 1 { false };
+        bool m_was_filled_up : 1 { false };
         // When m_begin == m_end, we want to distinguish whether
         // the buffer is full or empty.
         bool m_empty : 1 { true };
@@ -140,19 +151,26 @@ public:
     using List = IntrusiveList<&FILE::m_list_node>;
 };
 
+// Locks the file for the duration of a stdio call. As long as the process has only one thread, nobody else
+// could be using the file, so the lock is skipped. A second thread can only be created by this one, and not
+// while it's in here, so it's enough to check that once.
 class ScopedFileLock {
 public:
     ScopedFileLock(FILE* file)
         : m_file(file)
+        , m_locked(__pthread_is_multithreaded)
     {
-        m_file->lock();
+        if (m_locked)
+            m_file->lock();
     }
 
     ~ScopedFileLock()
     {
-        m_file->unlock();
+        if (m_locked)
+            m_file->unlock();
     }
 
 private:
     FILE* m_file;
+    bool m_locked;
 };
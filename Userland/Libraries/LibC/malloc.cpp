@@ -21,6 +21,7 @@
 #include <sys/internals.h>
 #include <sys/mman.h>
 #include <syscall.h>
+#include <unistd.h>
 
 class PthreadMutexLocker {
 public:
@@ -50,6 +51,11 @@ bool __heap_is_stable = true;
 constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
+// Allocations of up to 496 bytes are served from a per-thread cache of free chunks,
+// which is refilled from and flushed to the shared allocators in batches.
+constexpr size_t number_of_thread_cached_size_classes = 6;
+constexpr size_t number_of_chunks_to_keep_per_thread_cached_size_class = 32;
+constexpr size_t thread_cache_batch_size = number_of_chunks_to_keep_per_thread_cached_size_class / 2;
 
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
@@ -116,6 +122,10 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_exited_thread_cache_hits;
+    size_t number_of_exited_thread_cache_misses;
+    size_t number_of_exited_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -135,6 +145,32 @@ struct BigAllocator {
     Vector<BigAllocationBlock*, number_of_big_blocks_to_keep_around_per_size_class> blocks;
 };
 
+#ifndef NO_TLS
+struct ThreadCache {
+    struct Bin {
+        FreelistEntry* freelist;
+        size_t count;
+    };
+    Bin bins[number_of_thread_cached_size_classes];
+
+    size_t number_of_hits;
+    size_t number_of_misses;
+    size_t number_of_flushes;
+
+    bool is_registered;
+    bool is_disabled;
+    pid_t tid;
+    ThreadCache* prev;
+    ThreadCache* next;
+};
+
+// NOTE: This has to be constant-initialized (all zeroes), as it is used before any constructors run.
+static __thread ThreadCache s_thread_cache;
+
+// All thread caches that have been used at least once, protected by s_malloc_mutex.
+static ThreadCache* s_thread_caches = nullptr;
+#endif
+
 // Allocators will be initialized in __malloc_init.
 // We can not rely on global constructors to initialize them,
 // because they must be initialized before other global constructors
@@ -294,6 +330,226 @@ enum class CallerWillInitializeMemory {
 __thread bool s_allocation_enabled = true;
 #endif
 
+// NOTE: The caller must hold s_malloc_mutex.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block && s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block && s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+
+    return ptr;
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(*block);
+        allocator->usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(*block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+static ThreadCache::Bin* thread_cache_bin_for_size(size_t chunk_size)
+{
+    for (size_t i = 0; i < number_of_thread_cached_size_classes; ++i) {
+        if (size_classes[i] == chunk_size)
+            return &s_thread_cache.bins[i];
+    }
+    return nullptr;
+}
+
+static void* thread_cache_allocate(Allocator& allocator, size_t align)
+{
+    // Chunks of all size classes are 16-byte aligned.
+    if (align > 16 || s_thread_cache.is_disabled)
+        return nullptr;
+    auto* bin = thread_cache_bin_for_size(allocator.size);
+    if (!bin)
+        return nullptr;
+    if (!bin->freelist) {
+        ++s_thread_cache.number_of_misses;
+        return nullptr;
+    }
+    ++s_thread_cache.number_of_hits;
+    auto* entry = bin->freelist;
+    bin->freelist = entry->next;
+    --bin->count;
+    return entry;
+}
+
+static void thread_cache_register()
+{
+    if (s_thread_cache.is_registered)
+        return;
+    s_thread_cache.is_registered = true;
+    s_thread_cache.tid = gettid();
+    s_thread_cache.next = s_thread_caches;
+    if (s_thread_caches)
+        s_thread_caches->prev = &s_thread_cache;
+    s_thread_caches = &s_thread_cache;
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void thread_cache_refill(Allocator& allocator, size_t align)
+{
+    if (align > 16 || s_thread_cache.is_disabled)
+        return;
+    auto* bin = thread_cache_bin_for_size(allocator.size);
+    if (!bin)
+        return;
+    thread_cache_register();
+    while (bin->count < thread_cache_batch_size) {
+        auto ptr_or_error = allocate_chunk(allocator, allocator.size, align);
+        if (ptr_or_error.is_error())
+            break;
+        auto* entry = (FreelistEntry*)ptr_or_error.value();
+        entry->next = bin->freelist;
+        bin->freelist = entry;
+        ++bin->count;
+    }
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void thread_cache_flush_bin(ThreadCache::Bin& bin, size_t count_to_keep)
+{
+    while (bin.count > count_to_keep) {
+        auto* entry = bin.freelist;
+        bin.freelist = entry->next;
+        --bin.count;
+        free_chunk((ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+}
+
+static bool thread_cache_deallocate(ChunkedBlock& block, void* ptr)
+{
+    if (s_thread_cache.is_disabled)
+        return false;
+    // NOTE: The chunk size of a block can't change while one of its chunks is in use, so this is safe to read without the lock.
+    auto* bin = thread_cache_bin_for_size(block.m_size);
+    if (!bin)
+        return false;
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block.bytes_per_chunk());
+
+    if (bin->count >= number_of_chunks_to_keep_per_thread_cached_size_class) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        ++s_thread_cache.number_of_flushes;
+        thread_cache_flush_bin(*bin, thread_cache_batch_size);
+    }
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = bin->freelist;
+    bin->freelist = entry;
+    ++bin->count;
+    return true;
+}
+#endif
+
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
 {
 #ifndef NO_TLS
@@ -322,6 +578,17 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifndef NO_TLS
+    if (allocator) {
+        if (auto* ptr = thread_cache_allocate(*allocator, align)) {
+            if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+            ue_notify_malloc(ptr, size);
+            return ptr;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -366,79 +633,14 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return ptr;
     }
 
-    ChunkedBlock* block = nullptr;
-    void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
-    if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
-    }
+    auto* ptr = TRY(allocate_chunk(*allocator, good_size, align));
 
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+#ifndef NO_TLS
+    thread_cache_refill(*allocator, align);
+#endif
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -460,6 +662,11 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifndef NO_TLS
+    if (magic == MAGIC_PAGE_HEADER && thread_cache_deallocate(*(ChunkedBlock*)block_base, ptr))
+        return;
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -495,46 +702,7 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    free_chunk(block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -720,6 +888,33 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_thread_exit()
+{
+#ifndef NO_TLS
+    if (!s_thread_cache.is_registered)
+        return;
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& bin : s_thread_cache.bins)
+        thread_cache_flush_bin(bin, 0);
+
+    g_malloc_stats.number_of_exited_thread_cache_hits += s_thread_cache.number_of_hits;
+    g_malloc_stats.number_of_exited_thread_cache_misses += s_thread_cache.number_of_misses;
+    g_malloc_stats.number_of_exited_thread_cache_flushes += s_thread_cache.number_of_flushes;
+
+    if (s_thread_cache.prev)
+        s_thread_cache.prev->next = s_thread_cache.next;
+    else
+        s_thread_caches = s_thread_cache.next;
+    if (s_thread_cache.next)
+        s_thread_cache.next->prev = s_thread_cache.prev;
+
+    s_thread_cache.is_registered = false;
+    // Anything freed from here on goes straight back to the shared allocators.
+    s_thread_cache.is_disabled = true;
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
@@ -743,5 +938,32 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+#ifndef NO_TLS
+    dbgln();
+    // NOTE: Printing allocates, so take a snapshot of the thread caches first instead of printing with s_malloc_mutex held.
+    struct ThreadCacheStats {
+        pid_t tid;
+        size_t hits;
+        size_t misses;
+        size_t flushes;
+    };
+    ThreadCacheStats thread_cache_stats[64];
+    size_t thread_cache_count = 0;
+    {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        for (auto* cache = s_thread_caches; cache && thread_cache_count < array_size(thread_cache_stats); cache = cache->next)
+            thread_cache_stats[thread_cache_count++] = { cache->tid, cache->number_of_hits, cache->number_of_misses, cache->number_of_flushes };
+    }
+    auto hit_rate = [](size_t hits, size_t misses) -> size_t {
+        return hits + misses ? hits * 100 / (hits + misses) : 0;
+    };
+    for (size_t i = 0; i < thread_cache_count; ++i) {
+        auto const& stats = thread_cache_stats[i];
+        dbgln("thread {} cache hits: {}, misses: {}, flushes: {} ({}% hit rate)", stats.tid, stats.hits, stats.misses, stats.flushes, hit_rate(stats.hits, stats.misses));
+    }
+    auto exited_hits = g_malloc_stats.number_of_exited_thread_cache_hits;
+    auto exited_misses = g_malloc_stats.number_of_exited_thread_cache_misses;
+    dbgln("exited thread cache hits: {}, misses: {}, flushes: {} ({}% hit rate)", exited_hits, exited_misses, g_malloc_stats.number_of_exited_thread_cache_flushes, hit_rate(exited_hits, exited_misses));
+#endif
 }
 }
@@ -22,6 +22,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/internals.h>
 #include <sys/mman.h>
 #include <syscall.h>
 #include <time.h>
@@ -42,6 +43,8 @@ __thread size_t s_stack_size;
 __thread int s_thread_cancel_state = PTHREAD_CANCEL_ENABLE;
 __thread int s_thread_cancel_type = PTHREAD_CANCEL_DEFERRED;
 
+bool __pthread_is_multithreaded = false;
+
 #define __RETURN_PTHREAD_ERROR(rc) \
     return ((rc) < 0 ? -(rc) : 0)
 
@@ -59,6 +62,8 @@ extern "C" {
 [[noreturn]] static void exit_thread(void* code, void* stack_location, size_t stack_size)
 {
     __pthread_key_destroy_for_current_thread();
+    __malloc_thread_exit();
+    perf_flush_signposts();
     syscall(SC_exit_thread, code, stack_location, stack_size);
     VERIFY_NOT_REACHED();
 }
@@ -145,6 +150,7 @@ int pthread_create(pthread_t* thread, pthread_attr_t* attributes, void* (*start_
         used_attributes->stack_size,
         used_attributes->stack_location);
 
+    __pthread_is_multithreaded = true;
     return create_thread(thread, start_routine, argument_to_start_routine, used_attributes);
 }
 
@@ -232,6 +238,7 @@ int pthread_mutex_destroy(pthread_mutex_t*)
 int pthread_mutexattr_init(pthread_mutexattr_t* attr)
 {
     attr->type = PTHREAD_MUTEX_NORMAL;
+    attr->protocol = PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -258,6 +265,23 @@ int pthread_mutexattr_gettype(pthread_mutexattr_t* attr, int* type)
     return 0;
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_mutexattr_setprotocol.html
+int pthread_mutexattr_setprotocol(pthread_mutexattr_t* attr, int protocol)
+{
+    // FIXME: Implement PTHREAD_PRIO_PROTECT.
+    if (protocol != PTHREAD_PRIO_NONE && protocol != PTHREAD_PRIO_INHERIT)
+        return ENOTSUP;
+    attr->protocol = protocol;
+    return 0;
+}
+
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_mutexattr_getprotocol.html
+int pthread_mutexattr_getprotocol(pthread_mutexattr_t const* attr, int* protocol)
+{
+    *protocol = attr->protocol;
+    return 0;
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_attr_init.html
 int pthread_attr_init(pthread_attr_t* attributes)
 {
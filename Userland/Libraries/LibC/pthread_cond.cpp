@@ -155,6 +155,13 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
+    // NOTE: Waiters on a priority inheritance mutex have to go through FUTEX_LOCK_PI, so we can't requeue them there.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
     int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
     VERIFY(rc >= 0);
     return 0;
@@ -97,6 +97,62 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// How often we check whether a contended mutex has become free before going to sleep.
+// Most critical sections are short, so the owner is likely done before a futex round trip would be.
+static constexpr int MUTEX_SPIN_COUNT = 100;
+
+static ALWAYS_INLINE void spin_wait_hint()
+{
+#if ARCH(I386) || ARCH(X86_64)
+    __builtin_ia32_pause();
+#elif ARCH(AARCH64)
+    asm volatile("yield");
+#endif
+}
+
+static ALWAYS_INLINE void did_lock_mutex(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+    mutex->level = 0;
+}
+
+// Mutexes with PTHREAD_PRIO_INHERIT store the owner's thread ID in the lock word, so the kernel can boost it.
+static int pi_mutex_lock(pthread_mutex_t* mutex, bool try_only)
+{
+    u32 tid = gettid();
+    u32 value = MUTEX_UNLOCKED;
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, value, tid, AK::memory_order_acquire)) [[likely]] {
+        did_lock_mutex(mutex);
+        return 0;
+    }
+    if ((value & FUTEX_TID_MASK) == tid) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE) {
+            mutex->level++;
+            return 0;
+        }
+        return EDEADLK;
+    }
+    if (try_only)
+        return EBUSY;
+
+    int rc = futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    if (rc < 0)
+        return errno;
+    did_lock_mutex(mutex);
+    return 0;
+}
+
+static void pi_mutex_unlock(pthread_mutex_t* mutex)
+{
+    u32 value = gettid();
+    // If anyone is waiting, the kernel has to pick who is next and undo any priority boost.
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_UNLOCKED, AK::memory_order_release)) [[likely]]
+        return;
+    int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    VERIFY(rc >= 0);
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_init.html
 int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attributes)
 {
@@ -104,19 +160,21 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_trylock.html
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_lock(mutex, true);
+
     u32 expected = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
 
     if (exchanged) [[likely]] {
-        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-        mutex->level = 0;
+        did_lock_mutex(mutex);
         return 0;
     } else if (mutex->type == __PTHREAD_MUTEX_RECURSIVE) {
         pthread_t owner = AK::atomic_load(&mutex->owner, AK::memory_order_relaxed);
@@ -132,13 +190,14 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_lock(mutex, false);
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
     if (exchanged) [[likely]] {
-        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-        mutex->level = 0;
+        did_lock_mutex(mutex);
         return 0;
     } else if (mutex->type == __PTHREAD_MUTEX_RECURSIVE) {
         pthread_t owner = AK::atomic_load(&mutex->owner, AK::memory_order_relaxed);
@@ -149,6 +208,16 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         }
     }
 
+    // Spin path: as long as nobody is asleep on the mutex, its owner is probably running and about to release it.
+    for (int i = 0; i < MUTEX_SPIN_COUNT && value == MUTEX_LOCKED_NO_NEED_TO_WAKE; ++i) {
+        spin_wait_hint();
+        value = AK::atomic_load(&mutex->lock, AK::memory_order_relaxed);
+        if (value == MUTEX_UNLOCKED && AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire)) {
+            did_lock_mutex(mutex);
+            return 0;
+        }
+    }
+
     // Slow path: wait, record the fact that we're going to wait, and always
     // remember to wake the next thread up once we release the mutex.
     if (value != MUTEX_LOCKED_NEED_TO_WAKE)
@@ -159,14 +228,15 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     }
 
-    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-    mutex->level = 0;
+    did_lock_mutex(mutex);
     return 0;
 }
 
 int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_lock(mutex, false);
+
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
@@ -176,9 +246,7 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
         value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     }
 
-    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-    mutex->level = 0;
+    did_lock_mutex(mutex);
     return 0;
 }
 
@@ -193,6 +261,11 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        pi_mutex_unlock(mutex);
+        return 0;
+    }
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1, false);
@@ -29,6 +29,9 @@ static constexpr u32 SEM_MAGIC = 0x78951230;
 // threads.
 static constexpr u32 POST_WAKES = 1 << 31;
 
+// How often sem_wait() checks for a free slot before going to sleep.
+static constexpr int SEM_SPIN_COUNT = 100;
+
 static constexpr auto sem_path_prefix = "/tmp/semaphore/"sv;
 static constexpr auto SEM_NAME_MAX = PATH_MAX - sem_path_prefix.length();
 static ErrorOr<String> sem_name_to_path(char const* name)
@@ -321,6 +324,7 @@ int sem_timedwait(sem_t* sem, const struct timespec* abstime)
     u32 value = AK::atomic_load(&sem->value, AK::memory_order_relaxed);
     bool responsible_for_waking = false;
     bool process_shared = sem->flags & SEM_FLAG_PROCESS_SHARED;
+    int spins_left = SEM_SPIN_COUNT;
 
     while (true) {
         u32 count = value & ~POST_WAKES;
@@ -352,6 +356,18 @@ int sem_timedwait(sem_t* sem, const struct timespec* abstime)
             }
             return 0;
         }
+        // Nobody is asleep yet, so a slot is likely to be posted soon. Spin for a bit
+        // before taking the trip through the kernel.
+        if (value == 0 && spins_left > 0) {
+            --spins_left;
+#if ARCH(I386) || ARCH(X86_64)
+            __builtin_ia32_pause();
+#elif ARCH(AARCH64)
+            asm volatile("yield");
+#endif
+            value = AK::atomic_load(&sem->value, AK::memory_order_relaxed);
+            continue;
+        }
         // We're probably going to sleep, so attempt to set the flag. We do not
         // commit to sleeping yet, though, as setting the flag may fail and
         // cause us to reevaluate what we're doing.
@@ -364,7 +380,9 @@ int sem_timedwait(sem_t* sem, const struct timespec* abstime)
         }
         // At this point, we're committed to sleeping.
         responsible_for_waking = true;
-        futex_wait(&sem->value, value, abstime, CLOCK_REALTIME, process_shared);
+        int rc = futex_wait(&sem->value, value, abstime, CLOCK_REALTIME, process_shared);
+        if (rc < 0 && errno == ETIMEDOUT)
+            return -1;
         // This is the state we will probably see upon being waked:
         value = 1;
     }
@@ -6,6 +6,7 @@
 
 #include <Kernel/API/POSIX/fcntl.h>
 #include <Kernel/API/Syscall.h>
+#include <Kernel/API/TimePage.h>
 #include <arpa/inet.h>
 #include <errno.h>
 #include <serenity.h>
@@ -89,6 +90,69 @@ int perf_register_string(char const* string, size_t string_length)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+// Until the first tracepoint is hit, this points at a non-zero value so that it will map the time page.
+static uint32_t const s_unmapped_signpost_generation = UINT32_MAX;
+static uint32_t const s_disabled_signpost_generation = 0;
+uint32_t const volatile* __perf_signpost_generation = &s_unmapped_signpost_generation;
+
+static constexpr uintptr_t s_unregistered_string_id = UINTPTR_MAX;
+
+static __thread struct perf_signpost s_signposts[PERF_SIGNPOSTS_MAX_BATCH];
+static __thread size_t s_signpost_count;
+
+static bool map_signpost_generation()
+{
+    auto rc = syscall(SC_map_time_page);
+    if ((int)rc < 0 && (int)rc > -EMAXERRNO) {
+        // Without the time page, there is no way of knowing whether anyone is listening, so we don't bother.
+        __perf_signpost_generation = &s_disabled_signpost_generation;
+        return false;
+    }
+    __perf_signpost_generation = &reinterpret_cast<Kernel::TimePage*>(rc)->signpost_generation;
+    return *__perf_signpost_generation != 0;
+}
+
+void __perf_tracepoint_hit(struct perf_tracepoint* tracepoint, uintptr_t arg)
+{
+    if (__perf_signpost_generation == &s_unmapped_signpost_generation && !map_signpost_generation())
+        return;
+
+    // Every time profiling starts over, the kernel has forgotten about the strings registered before.
+    // NOTE: The time page is shared by all processes, so this also happens in those that aren't being profiled. They fail
+    //       to register the name, and remember that until the next generation so it only costs them one syscall.
+    auto generation = *__perf_signpost_generation;
+    if (generation == 0)
+        return;
+    if (tracepoint->generation != generation) {
+        int string_id = perf_register_string(tracepoint->name, strlen(tracepoint->name));
+        tracepoint->string_id = string_id < 0 ? s_unregistered_string_id : string_id;
+        tracepoint->generation = generation;
+    }
+    if (tracepoint->string_id == s_unregistered_string_id)
+        return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+    auto& signpost = s_signposts[s_signpost_count++];
+    signpost.timestamp = static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1'000'000;
+    signpost.string_id = tracepoint->string_id;
+    signpost.arg = arg;
+    signpost.stack[0] = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+    signpost.stack[1] = reinterpret_cast<uintptr_t>(__builtin_return_address(1));
+    if (s_signpost_count == PERF_SIGNPOSTS_MAX_BATCH)
+        perf_flush_signposts();
+}
+
+int perf_flush_signposts()
+{
+    if (s_signpost_count == 0)
+        return 0;
+    int rc = syscall(SC_perf_signposts, s_signposts, s_signpost_count);
+    s_signpost_count = 0;
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size)
 {
     int rc = syscall(SC_get_stack_bounds, user_stack_base, user_stack_size);
@@ -101,6 +165,18 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int io_ring_create(uint32_t entries, int flags)
+{
+    int rc = syscall(SC_io_ring_create, entries, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, uint32_t min_complete)
+{
+    int rc = syscall(SC_io_ring_enter, fd, min_complete);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_readlink(char const* path, size_t path_length, char* buffer, size_t buffer_size)
 {
     Syscall::SC_readlink_params small_params {
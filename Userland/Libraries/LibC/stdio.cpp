@@ -181,7 +181,13 @@ size_t FILE::read(u8* data, size_t size)
             // Let's see if the buffer has something queued for us.
             size_t queued_size;
             u8 const* queued_data = m_buffer.begin_dequeue(queued_size);
-            if (queued_size == 0) {
+            if (queued_size == 0 && size >= m_buffer.capacity()) {
+                // Nothing buffered, and the rest wouldn't fit anyway, so read it without copying it through the buffer.
+                ssize_t nread = do_read(data, size);
+                if (nread <= 0)
+                    return total_read;
+                actual_size = nread;
+            } else if (queued_size == 0) {
                 // Nothing buffered; we're going to have to read some.
                 bool read_some_more = read_into_buffer();
                 if (read_some_more) {
@@ -189,10 +195,11 @@ size_t FILE::read(u8* data, size_t size)
                     continue;
                 }
                 return total_read;
+            } else {
+                actual_size = min(size, queued_size);
+                memcpy(data, queued_data, actual_size);
+                m_buffer.did_dequeue(actual_size);
             }
-            actual_size = min(size, queued_size);
-            memcpy(data, queued_data, actual_size);
-            m_buffer.did_dequeue(actual_size);
         } else {
             // Read directly into the user buffer.
             ssize_t nread = do_read(data, size);
@@ -219,7 +226,13 @@ size_t FILE::write(u8 const* data, size_t size)
     while (size > 0) {
         size_t actual_size;
 
-        if (m_buffer.may_use()) {
+        if (m_buffer.may_use() && !m_buffer.is_not_empty() && size >= m_buffer.capacity()) {
+            // Nothing buffered, and the rest wouldn't fit anyway, so write it without copying it through the buffer.
+            ssize_t nwritten = do_write(data, size);
+            if (nwritten < 0)
+                return total_written;
+            actual_size = nwritten;
+        } else if (m_buffer.may_use()) {
             m_buffer.realize(m_fd);
             // Try writing into the buffer.
             size_t available_size;
@@ -290,13 +303,19 @@ bool FILE::gets(T* data, size_t size)
             }
             size_t actual_size = min(size - 1, queued_size);
             T const* newline = nullptr;
-            for (size_t i = 0; i < actual_size; ++i) {
-                if (queued_data[i] != '\n')
-                    continue;
+            if constexpr (sizeof(T) == 1) {
+                newline = static_cast<T const*>(memchr(queued_data, '\n', actual_size));
+                if (newline)
+                    actual_size = newline - queued_data + 1;
+            } else {
+                for (size_t i = 0; i < actual_size; ++i) {
+                    if (queued_data[i] != '\n')
+                        continue;
 
-                newline = &queued_data[i];
-                actual_size = i + 1;
-                break;
+                    newline = &queued_data[i];
+                    actual_size = i + 1;
+                    break;
+                }
             }
             memcpy(data, queued_data, actual_size * sizeof(T));
             m_buffer.did_dequeue(actual_size * sizeof(T));
@@ -379,6 +398,21 @@ void FILE::readptr_increase(size_t increment)
     m_buffer.did_dequeue(increment);
 }
 
+u8 const* FILE::fill_and_readptr(size_t& available_size)
+{
+    available_size = 0;
+    if (!m_buffer.may_use())
+        return nullptr;
+
+    m_flags |= Flags::LastRead;
+    m_flags &= ~Flags::LastWrite;
+
+    auto const* data = m_buffer.begin_dequeue(available_size);
+    if (available_size == 0 && read_into_buffer())
+        data = m_buffer.begin_dequeue(available_size);
+    return data;
+}
+
 FILE::Buffer::~Buffer()
 {
     if (m_data_is_malloced)
@@ -399,6 +433,17 @@ void FILE::Buffer::realize(int fd)
         m_data = reinterpret_cast<u8*>(malloc(m_capacity));
         m_data_is_malloced = true;
     }
+
+    // A buffer that fills up completely is too small for how this file is used, so make the next reads
+    // or writes bigger. This can only be done while there's nothing in it.
+    if (m_was_filled_up && m_empty && m_data_is_malloced && !m_capacity_is_fixed && m_capacity < max_adaptive_capacity) {
+        m_was_filled_up = false;
+        auto new_capacity = min(m_capacity * 2, max_adaptive_capacity);
+        if (auto* new_data = reinterpret_cast<u8*>(realloc(m_data, new_capacity))) {
+            m_data = new_data;
+            m_capacity = new_capacity;
+        }
+    }
 }
 
 void FILE::Buffer::setbuf(u8* data, int mode, size_t size)
@@ -408,6 +453,11 @@ void FILE::Buffer::setbuf(u8* data, int mode, size_t size)
     if (data != nullptr) {
         m_data = data;
         m_capacity = size;
+        m_capacity_is_fixed = true;
+    } else if (size != 0) {
+        // We allocate the buffer ourselves, but the caller picked its size.
+        m_capacity = size;
+        m_capacity_is_fixed = true;
     }
 }
 
@@ -510,6 +560,8 @@ void FILE::Buffer::did_enqueue(size_t actual_size)
     }
 
     m_empty = false;
+    if (m_begin == m_end)
+        m_was_filled_up = true;
 }
 
 bool FILE::Buffer::enqueue_front(u8 byte)
@@ -680,34 +732,58 @@ ssize_t getdelim(char** lineptr, size_t* n, int delim, FILE* stream)
         }
     }
 
-    char* ptr;
-    char* eptr;
-    for (ptr = *lineptr, eptr = *lineptr + *n;;) {
-        int c = fgetc(stream);
+    // Makes sure that there's room for `size` more bytes and the null terminator.
+    auto ensure_capacity = [&](size_t length, size_t size) {
+        if (length + size + 1 <= *n)
+            return true;
+        size_t new_size = max(*n * 2, length + size + 1);
+        auto* new_line = static_cast<char*>(realloc(*lineptr, new_size));
+        if (new_line == nullptr)
+            return false;
+        *lineptr = new_line;
+        *n = new_size;
+        return true;
+    };
+
+    VERIFY(stream);
+    ScopedFileLock lock(stream);
+
+    size_t length = 0;
+    while (true) {
+        // Take whole chunks of the buffer at a time, up to the delimiter.
+        size_t available_size;
+        auto const* data = stream->fill_and_readptr(available_size);
+        if (available_size > 0) {
+            auto const* delimiter = static_cast<u8 const*>(memchr(data, delim, available_size));
+            size_t chunk_size = delimiter ? delimiter - data + 1 : available_size;
+            if (!ensure_capacity(length, chunk_size))
+                return -1;
+            memcpy(*lineptr + length, data, chunk_size);
+            stream->readptr_increase(chunk_size);
+            length += chunk_size;
+            if (delimiter) {
+                (*lineptr)[length] = '\0';
+                return length;
+            }
+            continue;
+        }
+
+        // Either the stream is unbuffered, or we've reached the end (or an error).
+        int c = fgetc_unlocked(stream);
         if (c == -1) {
-            if (feof(stream)) {
-                *ptr = '\0';
-                return ptr == *lineptr ? -1 : ptr - *lineptr;
+            if (stream->eof()) {
+                (*lineptr)[length] = '\0';
+                return length == 0 ? -1 : length;
             } else {
                 return -1;
             }
         }
-        *ptr++ = c;
+        if (!ensure_capacity(length, 1))
+            return -1;
+        (*lineptr)[length++] = c;
         if (c == delim) {
-            *ptr = '\0';
-            return ptr - *lineptr;
-        }
-        if (ptr + 2 >= eptr) {
-            char* nbuf;
-            size_t nbuf_sz = *n * 2;
-            ssize_t d = ptr - *lineptr;
-            if ((nbuf = static_cast<char*>(realloc(*lineptr, nbuf_sz))) == nullptr) {
-                return -1;
-            }
-            *lineptr = nbuf;
-            *n = nbuf_sz;
-            eptr = nbuf + nbuf_sz;
-            ptr = nbuf + d;
+            (*lineptr)[length] = '\0';
+            return length;
         }
     }
 }
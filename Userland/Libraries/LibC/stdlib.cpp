@@ -5,6 +5,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/FloatingPointStringConversions.h>
 #include <AK/HashMap.h>
 #include <AK/Noncopyable.h>
 #include <AK/Random.h>
@@ -19,6 +20,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <serenity.h>
 #include <signal.h>
 #include <spawn.h>
 #include <stdio.h>
@@ -187,6 +189,7 @@ extern "C" {
 void exit(int status)
 {
     __cxa_finalize(nullptr);
+    perf_flush_signposts();
 
     if (secure_getenv("LIBC_DUMP_MALLOC_STATS"))
         serenity_dump_malloc_stats();
@@ -647,6 +650,20 @@ double strtod(char const* str, char** endptr)
         }
     }
 
+    if (base == 10) {
+        // This is exact (and a lot faster) almost all of the time. If we ran out of room for the digits, the
+        // exact value lies somewhere between `digits` and `digits + 1`, so both have to round the same way.
+        u64 mantissa = sign != Sign::Negative ? static_cast<u64>(digits.number()) : -static_cast<u64>(digits.number());
+        auto value = convert_decimal_to_double(mantissa, exponent);
+        if (value.has_value() && digits_overflow && convert_decimal_to_double(mantissa + 1, exponent) != value)
+            value.clear();
+        if (value.has_value()) {
+            if (*value == 0.0 || *value == __builtin_huge_val())
+                errno = ERANGE;
+            return sign != Sign::Negative ? *value : -*value;
+        }
+    }
+
     // TODO: If `exponent` is large, this could be made faster.
     double value = digits.number();
     double scale = 1;
@@ -49,6 +49,7 @@ size_t strcspn(char const* s, char const* reject)
     }
 }
 
+#if ARCH(I386)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strlen.html
 size_t strlen(char const* str)
 {
@@ -57,6 +58,11 @@ size_t strlen(char const* str)
         ++len;
     return len;
 }
+#elif ARCH(X86_64)
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/strlen.S
+#else
+#    error Unknown architecture
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strnlen.html
 size_t strnlen(char const* str, size_t maxlen)
@@ -115,6 +121,17 @@ int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto* s1 = (uint8_t const*)v1;
     auto* s2 = (uint8_t const*)v2;
+
+    // Skip over the equal prefix a word at a time, the first difference is then found byte by byte.
+    for (; n >= sizeof(FlatPtr); n -= sizeof(FlatPtr), s1 += sizeof(FlatPtr), s2 += sizeof(FlatPtr)) {
+        FlatPtr word1;
+        FlatPtr word2;
+        __builtin_memcpy(&word1, s1, sizeof(FlatPtr));
+        __builtin_memcpy(&word2, s2, sizeof(FlatPtr));
+        if (word1 != word2)
+            break;
+    }
+
     while (n-- > 0) {
         if (*s1++ != *s2++)
             return s1[-1] < s2[-1] ? -1 : 1;
@@ -127,19 +144,21 @@ int timingsafe_memcmp(void const* b1, void const* b2, size_t len)
     return AK::timing_safe_compare(b1, b2, len) ? 1 : 0;
 }
 
+#if ARCH(I386)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memcpy.html
 void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
 {
-#if ARCH(I386) || ARCH(X86_64)
     void* original_dest = dest_ptr;
     asm volatile(
         "rep movsb"
         : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
     return original_dest;
+}
+#elif ARCH(X86_64)
+// For x86-64, optimized ASM implementations are found in ./arch/x86_64/memcpy.S
 #else
 #    error Unknown architecture
 #endif
-}
 
 #if ARCH(I386)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memset.html
@@ -52,6 +52,9 @@ int adjtime(const struct timeval* delta, struct timeval* old_delta)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+static Kernel::TimePage* get_kernel_time_page();
+static bool read_interpolated_time_from_time_page(Kernel::TimePage&, clockid_t, struct timespec*);
+
 int gettimeofday(struct timeval* __restrict__ tv, void* __restrict__)
 {
     if (!tv) {
@@ -59,9 +62,13 @@ int gettimeofday(struct timeval* __restrict__ tv, void* __restrict__)
         return -1;
     }
 
+    // NOTE: Only take the precise clock if it can be read without a syscall, the coarse one always can.
     struct timespec ts = {};
-    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) < 0)
-        return -1;
+    auto* kernel_time_page = get_kernel_time_page();
+    if (!kernel_time_page || !read_interpolated_time_from_time_page(*kernel_time_page, CLOCK_REALTIME, &ts)) {
+        if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) < 0)
+            return -1;
+    }
 
     TIMESPEC_TO_TIMEVAL(tv, &ts);
     return 0;
@@ -452,21 +459,68 @@ static Kernel::TimePage* get_kernel_time_page()
     return s_kernel_time_page;
 }
 
+static bool read_interpolated_time_from_time_page(Kernel::TimePage& kernel_time_page, clockid_t clock_id, struct timespec* ts)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    auto base_clock_id = Kernel::time_page_interpolation_base(clock_id);
+    u32 update_iteration;
+    u64 tsc;
+    u64 tsc_at_update;
+    u64 tsc_to_ns_multiplier;
+    u64 max_tsc_delta;
+    do {
+        update_iteration = AK::atomic_load(&kernel_time_page.update1, AK::memory_order_acquire);
+        *ts = kernel_time_page.clocks[base_clock_id];
+        tsc_at_update = kernel_time_page.tsc_at_update;
+        tsc_to_ns_multiplier = kernel_time_page.tsc_to_ns_multiplier;
+        max_tsc_delta = kernel_time_page.max_tsc_delta;
+        u32 tsc_low, tsc_high;
+        asm volatile("rdtsc"
+                     : "=a"(tsc_low), "=d"(tsc_high));
+        tsc = ((u64)tsc_high << 32) | tsc_low;
+    } while (update_iteration != AK::atomic_load(&kernel_time_page.update2, AK::memory_order_acquire));
+
+    if (tsc_to_ns_multiplier == 0)
+        return false;
+
+    // NOTE: The delta is clamped to one timer tick, since the next update only moves the coarse clock forward by that much.
+    u64 tsc_delta = tsc > tsc_at_update ? min(tsc - tsc_at_update, max_tsc_delta) : 0;
+    u64 delta_ns = (tsc_delta * tsc_to_ns_multiplier) >> 32;
+    ts->tv_sec += delta_ns / 1'000'000'000;
+    ts->tv_nsec += delta_ns % 1'000'000'000;
+    if (ts->tv_nsec >= 1'000'000'000) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1'000'000'000;
+    }
+    return true;
+#else
+    (void)kernel_time_page;
+    (void)clock_id;
+    (void)ts;
+    return false;
+#endif
+}
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
-    if (Kernel::time_page_supports(clock_id)) {
+    if (Kernel::time_page_supports(clock_id) || Kernel::time_page_supports_interpolation(clock_id)) {
         if (!ts) {
             errno = EFAULT;
             return -1;
         }
 
         if (auto* kernel_time_page = get_kernel_time_page()) {
-            u32 update_iteration;
-            do {
-                update_iteration = AK::atomic_load(&kernel_time_page->update1, AK::memory_order_acquire);
-                *ts = kernel_time_page->clocks[clock_id];
-            } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
-            return 0;
+            if (Kernel::time_page_supports_interpolation(clock_id)) {
+                if (read_interpolated_time_from_time_page(*kernel_time_page, clock_id, ts))
+                    return 0;
+            } else {
+                u32 update_iteration;
+                do {
+                    update_iteration = AK::atomic_load(&kernel_time_page->update1, AK::memory_order_acquire);
+                    *ts = kernel_time_page->clocks[clock_id];
+                } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
+                return 0;
+            }
         }
     }
 
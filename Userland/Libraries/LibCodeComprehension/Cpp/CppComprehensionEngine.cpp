@@ -43,7 +43,7 @@ CppComprehensionEngine::DocumentData const* CppComprehensionEngine::get_document
     return document_data.value();
 }
 
-OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data_for(String const& file)
+OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data_for(String const& file, OwnPtr<DocumentData> previous_version)
 {
     if (m_unfinished_documents.contains(file)) {
         return {};
@@ -53,7 +53,7 @@ OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_docu
     auto document = filedb().get_or_read_from_filesystem(file);
     if (!document.has_value())
         return {};
-    return create_document_data(move(document.value()), file);
+    return create_document_data(move(document.value()), file, move(previous_version));
 }
 
 void CppComprehensionEngine::set_document_data(String const& file, OwnPtr<DocumentData>&& data)
@@ -393,7 +393,13 @@ String CppComprehensionEngine::document_path_from_include_path(StringView includ
 
 void CppComprehensionEngine::on_edit(String const& file)
 {
-    set_document_data(file, create_document_data_for(file));
+    auto absolute_path = filedb().to_absolute_path(file);
+    OwnPtr<DocumentData> previous_version;
+    if (auto document = m_documents.find(absolute_path); document != m_documents.end()) {
+        previous_version = move(document->value);
+        m_documents.remove(document);
+    }
+    set_document_data(absolute_path, create_document_data_for(absolute_path, move(previous_version)));
 }
 
 void CppComprehensionEngine::file_opened([[maybe_unused]] String const& file)
@@ -612,7 +618,11 @@ CodeComprehension::DeclarationType CppComprehensionEngine::type_of_declaration(C
     return CodeComprehension::DeclarationType::Variable;
 }
 
-OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data(String text, String const& filename)
+// Every version of a document that parts of its AST were taken over from is kept alive, so once there are this many,
+// the document is parsed from scratch again.
+static constexpr size_t max_previous_versions_to_keep = 16;
+
+OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data(String text, String const& filename, OwnPtr<DocumentData> previous_version)
 {
     auto document_data = make<DocumentData>();
     document_data->m_filename = filename;
@@ -646,7 +656,19 @@ OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_docu
 
     document_data->m_parser = make<Parser>(move(tokens), filename);
 
-    auto root = document_data->parser().parse();
+    RefPtr<TranslationUnit> root;
+    if (previous_version && previous_version->m_parser && previous_version->m_preprocessors_of_previous_versions.size() < max_previous_versions_to_keep) {
+        root = document_data->parser().parse_incrementally(previous_version->parser());
+
+        if (document_data->parser().reused_declaration_count() > 0) {
+            document_data->m_texts_of_previous_versions = move(previous_version->m_texts_of_previous_versions);
+            document_data->m_texts_of_previous_versions.append(move(previous_version->m_text));
+            document_data->m_preprocessors_of_previous_versions = move(previous_version->m_preprocessors_of_previous_versions);
+            document_data->m_preprocessors_of_previous_versions.append(previous_version->m_preprocessor.release_nonnull());
+        }
+    } else {
+        root = document_data->parser().parse();
+    }
 
     if constexpr (CPP_LANGUAGE_SERVER_DEBUG)
         root->dump();
@@ -93,6 +93,11 @@ private:
 
         HashMap<SymbolName, Symbol> m_symbols;
         HashTable<String> m_available_headers;
+
+        // Declarations that were taken over from earlier versions of the document still refer to their text and
+        // preprocessed tokens, so those stay around for as long as this version does.
+        Vector<String> m_texts_of_previous_versions;
+        Vector<NonnullOwnPtr<Preprocessor>> m_preprocessors_of_previous_versions;
     };
 
     Vector<CodeComprehension::AutocompleteResultEntry> autocomplete_property(DocumentData const&, MemberExpression const&, const String partial_text) const;
@@ -118,7 +123,7 @@ private:
     DocumentData const* get_or_create_document_data(String const& file);
     void set_document_data(String const& file, OwnPtr<DocumentData>&& data);
 
-    OwnPtr<DocumentData> create_document_data_for(String const& file);
+    OwnPtr<DocumentData> create_document_data_for(String const& file, OwnPtr<DocumentData> previous_version = {});
     String document_path_from_include_path(StringView include_path) const;
     void update_declared_symbols(DocumentData&);
     void update_todo_entries(DocumentData&);
@@ -129,7 +134,7 @@ private:
     Optional<CodeComprehension::ProjectLocation> find_preprocessor_definition(DocumentData const&, const GUI::TextPosition&);
     Optional<Cpp::Preprocessor::Substitution> find_preprocessor_substitution(DocumentData const&, Cpp::Position const&);
 
-    OwnPtr<DocumentData> create_document_data(String text, String const& filename);
+    OwnPtr<DocumentData> create_document_data(String text, String const& filename, OwnPtr<DocumentData> previous_version = {});
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_property(DocumentData const&, ASTNode const&, Optional<Token> containing_token) const;
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_name(DocumentData const&, ASTNode const&, Optional<Token> containing_token) const;
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_include(DocumentData const&, Token include_path_token, Cpp::Position const& cursor_position) const;
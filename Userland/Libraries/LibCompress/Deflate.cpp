@@ -10,6 +10,7 @@
 #include <AK/BinaryHeap.h>
 #include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
@@ -22,54 +23,43 @@ static constexpr u8 deflate_special_code_length_long_zeros = 18;
 
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = CanonicalCode::from_bytes(fixed_literal_bit_lengths).value();
-    initialized = true;
-
+    // Initializing the static like this is thread-safe, which decompressing on several threads at once relies on.
+    static CanonicalCode const code = CanonicalCode::from_bytes(fixed_literal_bit_lengths).value();
     return code;
 }
 
 CanonicalCode const& CanonicalCode::fixed_distance_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = CanonicalCode::from_bytes(fixed_distance_bit_lengths).value();
-    initialized = true;
-
+    static CanonicalCode const code = CanonicalCode::from_bytes(fixed_distance_bit_lengths).value();
     return code;
 }
 
 Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
     CanonicalCode code;
 
     auto non_zero_symbols = 0;
     auto last_non_zero = -1;
+    size_t max_code_length = 0;
     for (size_t i = 0; i < bytes.size(); i++) {
         if (bytes[i] != 0) {
             non_zero_symbols++;
             last_non_zero = i;
+            max_code_length = max<size_t>(max_code_length, bytes[i]);
         }
     }
-    if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
-        code.m_symbol_values.append(last_non_zero);
+    if (non_zero_symbols == 1) { // special case - only 1 symbol, the code 1 is left unused
+        code.m_primary_table_bits = 1;
+        code.m_decoding_table.append(1 << 16 | last_non_zero);
+        code.m_decoding_table.append(0);
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
         return code;
     }
+    if (max_code_length > 15)
+        return {};
 
+    // Codes are assigned in order of their length, and within the same length in the order of their symbol (RFC 1951 - 3.2.2)
     auto next_code = 0;
     for (size_t code_length = 1; code_length <= 15; ++code_length) {
         next_code <<= 1;
@@ -82,8 +72,6 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
-            code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
 
@@ -95,24 +83,51 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         return {};
     }
 
-    return code;
-}
+    // As codes are read lsb-first, the table is indexed by their reversed bits. Every code fills all the entries whose
+    // lowest bits are the code, whatever the bits after it are.
+    code.m_primary_table_bits = min(max_code_length, max_primary_table_bits);
+    auto primary_table_size = 1u << code.m_primary_table_bits;
+    auto primary_table_mask = primary_table_size - 1;
+    code.m_decoding_table.resize(primary_table_size);
+
+    // Longer codes are grouped by their first m_primary_table_bits bits, each of these groups getting a sub-table as large as its longest code needs
+    Array<u8, 1 << max_primary_table_bits> sub_table_bits {};
+    for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
+        auto code_length = code.m_bit_code_lengths[symbol];
+        if (code_length > code.m_primary_table_bits) {
+            auto& bits = sub_table_bits[code.m_bit_codes[symbol] & primary_table_mask];
+            bits = max<u8>(bits, code_length - code.m_primary_table_bits);
+        }
+    }
+    for (size_t prefix = 0; prefix < primary_table_size; ++prefix) {
+        if (sub_table_bits[prefix] == 0)
+            continue;
+        code.m_decoding_table[prefix] = sub_table_flag | sub_table_bits[prefix] << 16 | code.m_decoding_table.size();
+        code.m_decoding_table.resize(code.m_decoding_table.size() + (1u << sub_table_bits[prefix]));
+    }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
-{
-    u32 code_bits = 1;
-
-    for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
-            return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
+        u32 code_length = code.m_bit_code_lengths[symbol];
+        if (code_length == 0)
+            continue;
+        u32 entry = code_length << 16 | symbol;
+        u32 bits = code.m_bit_codes[symbol];
+
+        if (code_length <= code.m_primary_table_bits) {
+            for (auto index = bits; index < primary_table_size; index += 1u << code_length)
+                code.m_decoding_table[index] = entry;
+            continue;
+        }
+
+        auto link = code.m_decoding_table[bits & primary_table_mask];
+        auto sub_table_offset = link & 0xffff;
+        auto sub_table_size = 1u << ((link >> 16) & 0xff);
+        auto remaining_code_length = code_length - code.m_primary_table_bits;
+        for (auto index = bits >> code.m_primary_table_bits; index < sub_table_size; index += 1u << remaining_code_length)
+            code.m_decoding_table[sub_table_offset + index] = entry;
     }
+
+    return code;
 }
 
 void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
@@ -120,206 +135,277 @@ void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
     stream.write_bits(m_bit_codes[symbol], m_bit_code_lengths[symbol]);
 }
 
-DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
-    : m_decompressor(decompressor)
-    , m_literal_codes(literal_codes)
-    , m_distance_codes(distance_codes)
+DeflateDecompressor::DeflateDecompressor(InputStream& stream)
+    : m_input_stream(stream)
 {
 }
 
-bool DeflateDecompressor::CompressedBlock::try_read_more()
+bool DeflateDecompressor::refill_input_buffer()
 {
-    if (m_eof == true)
-        return false;
-
-    auto const symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    // Keep the bytes that may still be in the bit buffer around, see unused_input()
+    auto kept_bytes = min<size_t>(m_input_position, sizeof(m_bit_buffer));
+    memmove(m_input_buffer, m_input_buffer + m_input_position - kept_bytes, kept_bytes);
+    m_input_position = kept_bytes;
+    m_input_size = kept_bytes + m_input_stream.read({ m_input_buffer + kept_bytes, input_buffer_size - kept_bytes });
+    return m_input_size > m_input_position;
+}
 
-    if (symbol >= 286) { // invalid deflate literal/length symbol
-        m_decompressor.set_fatal_error();
-        return false;
+ALWAYS_INLINE void DeflateDecompressor::refill_bits()
+{
+    // Load as many whole bytes as fit into the bit buffer at once. The bits of the bytes that don't fit anymore are loaded too,
+    // but as they are the exact same bits the next refill will load, it doesn't matter that they are already there.
+    if (m_input_size - m_input_position >= sizeof(u64)) [[likely]] {
+        u64 bytes;
+        __builtin_memcpy(&bytes, m_input_buffer + m_input_position, sizeof(bytes));
+        m_bit_buffer |= AK::convert_between_host_and_little_endian(bytes) << m_bit_count;
+        auto loaded_bytes = (63 - m_bit_count) / 8;
+        m_input_position += loaded_bytes;
+        m_bit_count += loaded_bytes * 8;
+        return;
     }
 
-    if (symbol < 256) {
-        m_decompressor.m_output_stream << static_cast<u8>(symbol);
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
-        if (!m_distance_codes.has_value()) {
-            m_decompressor.set_fatal_error();
-            return false;
-        }
-
-        auto const length = m_decompressor.decode_length(symbol);
-        auto const distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
-        if (distance_symbol >= 30) { // invalid deflate distance symbol
-            m_decompressor.set_fatal_error();
-            return false;
-        }
-        auto const distance = m_decompressor.decode_distance(distance_symbol);
-
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            if (m_decompressor.m_output_stream.handle_any_error()) {
-                m_decompressor.set_fatal_error();
-                return false; // a back reference was requested that was too far back (outside our current sliding window)
-            }
-            m_decompressor.m_output_stream << byte;
-        }
-
-        return true;
+    while (m_bit_count <= 56) {
+        if (m_input_position == m_input_size && !refill_input_buffer())
+            return;
+        m_bit_buffer |= static_cast<u64>(m_input_buffer[m_input_position++]) << m_bit_count;
+        m_bit_count += 8;
     }
 }
 
-DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
-    : m_decompressor(decompressor)
-    , m_bytes_remaining(length)
+Optional<u32> DeflateDecompressor::read_bits(size_t count)
 {
+    VERIFY(count <= 32);
+    if (m_bit_count < count)
+        refill_bits();
+    if (m_bit_count < count)
+        return {};
+    u32 bits = m_bit_buffer & ((1ull << count) - 1);
+    m_bit_buffer >>= count;
+    m_bit_count -= count;
+    return bits;
 }
 
-bool DeflateDecompressor::UncompressedBlock::try_read_more()
+void DeflateDecompressor::align_to_byte_boundary()
 {
-    if (m_bytes_remaining == 0)
-        return false;
-
-    auto const nread = min(m_bytes_remaining, m_decompressor.m_output_stream.remaining_contiguous_space());
-    m_bytes_remaining -= nread;
-
-    m_decompressor.m_input_stream >> m_decompressor.m_output_stream.reserve_contiguous_space(nread);
-
-    return true;
+    // Drop the rest of the current byte, and hand the whole bytes back to the input buffer
+    m_input_position -= m_bit_count / 8;
+    m_bit_buffer = 0;
+    m_bit_count = 0;
 }
 
-DeflateDecompressor::DeflateDecompressor(InputStream& stream)
-    : m_input_stream(stream)
+ReadonlyBytes DeflateDecompressor::unused_input() const
 {
+    VERIFY(m_state == State::Idle && m_read_final_block);
+    auto position = m_input_position - m_bit_count / 8;
+    return { m_input_buffer + position, m_input_size - position };
 }
 
-DeflateDecompressor::~DeflateDecompressor()
+void DeflateDecompressor::set_history(ReadonlyBytes history)
 {
-    if (m_state == State::ReadingCompressedBlock)
-        m_compressed_block.~CompressedBlock();
-    if (m_state == State::ReadingUncompressedBlock)
-        m_uncompressed_block.~UncompressedBlock();
+    VERIFY(m_window_end == 0);
+    auto size = min(history.size(), history_size);
+    history.slice(history.size() - size).copy_to({ m_window, size });
+    m_window_end = size;
+    m_window_read_position = size;
 }
 
-size_t DeflateDecompressor::read(Bytes bytes)
+bool DeflateDecompressor::read_block_header()
 {
-    size_t total_read = 0;
-    while (total_read < bytes.size()) {
-        if (has_any_error())
-            break;
-
-        auto slice = bytes.slice(total_read);
-
-        if (m_state == State::Idle) {
-            if (m_read_final_bock)
-                break;
-
-            m_read_final_bock = m_input_stream.read_bit();
-            auto const block_type = m_input_stream.read_bits(2);
-
-            if (m_input_stream.has_any_error()) {
-                set_fatal_error();
-                break;
-            }
+    auto header = read_bits(3);
+    if (!header.has_value())
+        return false;
 
-            if (block_type == 0b00) {
-                m_input_stream.align_to_byte_boundary();
+    m_read_final_block = *header & 1;
+    auto const block_type = *header >> 1;
 
-                LittleEndian<u16> length, negated_length;
-                m_input_stream >> length >> negated_length;
+    if (block_type == 0b00) {
+        align_to_byte_boundary();
 
-                if (m_input_stream.has_any_error()) {
-                    set_fatal_error();
-                    break;
-                }
+        u8 lengths[4];
+        for (auto& byte : lengths) {
+            if (m_input_position == m_input_size && !refill_input_buffer())
+                return false;
+            byte = m_input_buffer[m_input_position++];
+        }
+        u16 length = lengths[0] | lengths[1] << 8;
+        u16 negated_length = lengths[2] | lengths[3] << 8;
+        if ((length ^ 0xffff) != negated_length)
+            return false;
 
-                if ((length ^ 0xffff) != negated_length) {
-                    set_fatal_error();
-                    break;
-                }
+        m_state = State::ReadingUncompressedBlock;
+        m_uncompressed_bytes_remaining = length;
+        return true;
+    }
 
-                m_state = State::ReadingUncompressedBlock;
-                new (&m_uncompressed_block) UncompressedBlock(*this, length);
+    if (block_type == 0b01) {
+        m_state = State::ReadingCompressedBlock;
+        m_literal_codes = &CanonicalCode::fixed_literal_codes();
+        m_distance_codes = &CanonicalCode::fixed_distance_codes();
+        return true;
+    }
 
-                continue;
-            }
+    if (block_type == 0b10) {
+        if (!decode_codes())
+            return false;
+        m_state = State::ReadingCompressedBlock;
+        return true;
+    }
 
-            if (block_type == 0b01) {
-                m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes());
+    return false;
+}
 
-                continue;
-            }
+bool DeflateDecompressor::decode_compressed_block(size_t output_limit)
+{
+    auto* window = m_window;
+    auto output_position = m_window_end;
+    ScopeGuard update_window_end = [&] { m_window_end = output_position; };
+
+    while (output_position < output_limit) {
+        // 48 bits are enough for the longest possible length and distance codes including their extra bits
+        if (m_bit_count < 48)
+            refill_bits();
+
+        auto entry = m_literal_codes->decode_symbol(m_bit_buffer);
+        auto code_length = entry >> 16;
+        if (code_length == 0 || code_length > m_bit_count)
+            return false; // an invalid code, or we ran out of input
+        m_bit_buffer >>= code_length;
+        m_bit_count -= code_length;
+
+        auto symbol = entry & 0xffff;
+        if (symbol < 256) {
+            window[output_position++] = symbol;
+            continue;
+        }
+        if (symbol == 256) {
+            m_state = State::Idle;
+            return true;
+        }
+        if (symbol >= 286 || !m_distance_codes) // invalid deflate literal/length symbol
+            return false;
 
-            if (block_type == 0b10) {
-                CanonicalCode literal_codes;
-                Optional<CanonicalCode> distance_codes;
-                decode_codes(literal_codes, distance_codes);
+        auto const& length_symbol = packed_length_symbols[symbol - 257];
+        if (length_symbol.extra_bits > m_bit_count)
+            return false;
+        size_t length = length_symbol.base_length + (m_bit_buffer & ((1u << length_symbol.extra_bits) - 1));
+        m_bit_buffer >>= length_symbol.extra_bits;
+        m_bit_count -= length_symbol.extra_bits;
 
-                if (m_input_stream.has_any_error()) {
-                    set_fatal_error();
-                    break;
-                }
+        entry = m_distance_codes->decode_symbol(m_bit_buffer);
+        code_length = entry >> 16;
+        if (code_length == 0 || code_length > m_bit_count)
+            return false;
+        m_bit_buffer >>= code_length;
+        m_bit_count -= code_length;
 
-                m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, literal_codes, distance_codes);
+        auto distance_symbol = entry & 0xffff;
+        if (distance_symbol >= 30) // invalid deflate distance symbol
+            return false;
+        auto const& packed_distance = packed_distances[distance_symbol];
+        if (packed_distance.extra_bits > m_bit_count)
+            return false;
+        size_t distance = packed_distance.base_distance + (m_bit_buffer & ((1u << packed_distance.extra_bits) - 1));
+        m_bit_buffer >>= packed_distance.extra_bits;
+        m_bit_count -= packed_distance.extra_bits;
+
+        if (distance > output_position)
+            return false; // a back reference was requested that was too far back (outside our current sliding window)
+
+        // The source and destination overlap if the distance is shorter than the length, in which case the copy repeats the
+        // last `distance` bytes. Copying 8 bytes at a time still works if they are at least 8 bytes apart.
+        u8* destination = window + output_position;
+        u8 const* source = destination - distance;
+        if (distance >= sizeof(u64)) {
+            for (size_t i = 0; i < length; i += sizeof(u64))
+                __builtin_memcpy(destination + i, source + i, sizeof(u64));
+        } else if (distance == 1) {
+            __builtin_memset(destination, *source, length);
+        } else {
+            for (size_t i = 0; i < length; ++i)
+                destination[i] = source[i];
+        }
+        output_position += length;
+    }
 
-                continue;
-            }
+    return true;
+}
 
-            set_fatal_error();
-            break;
+bool DeflateDecompressor::copy_uncompressed_block(size_t output_limit)
+{
+    while (m_uncompressed_bytes_remaining > 0 && m_window_end < output_limit) {
+        auto count = min(m_uncompressed_bytes_remaining, output_limit - m_window_end);
+        if (m_input_position < m_input_size) {
+            count = min(count, m_input_size - m_input_position);
+            __builtin_memcpy(m_window + m_window_end, m_input_buffer + m_input_position, count);
+            m_input_position += count;
+        } else {
+            // Large uncompressed blocks can be read straight into the window
+            count = m_input_stream.read({ m_window + m_window_end, count });
+            if (count == 0)
+                return false;
         }
+        m_window_end += count;
+        m_uncompressed_bytes_remaining -= count;
+    }
 
-        if (m_state == State::ReadingCompressedBlock) {
-            auto nread = m_output_stream.read(slice);
-
-            while (nread < slice.size() && m_compressed_block.try_read_more()) {
-                nread += m_output_stream.read(slice.slice(nread));
-            }
+    if (m_uncompressed_bytes_remaining == 0)
+        m_state = State::Idle;
+    return true;
+}
 
-            if (m_input_stream.has_any_error()) {
-                set_fatal_error();
-                break;
-            }
+bool DeflateDecompressor::decode_more()
+{
+    // Everything that was decoded has been read, so all we have to keep is the history
+    if (m_window_end > history_size) {
+        memmove(m_window, m_window + m_window_end - history_size, history_size);
+        m_window_end = history_size;
+    }
+    m_window_read_position = m_window_end;
 
-            total_read += nread;
-            if (nread == slice.size())
-                break;
+    auto output_limit = m_window_end + decode_chunk_size;
+    while (m_window_end < output_limit) {
+        if (m_state == State::Idle) {
+            if (m_read_final_block)
+                return true;
+            if (!read_block_header())
+                return false;
+        } else if (m_state == State::ReadingCompressedBlock) {
+            if (!decode_compressed_block(output_limit))
+                return false;
+        } else {
+            if (!copy_uncompressed_block(output_limit))
+                return false;
+        }
+    }
+    return true;
+}
 
-            m_compressed_block.~CompressedBlock();
-            m_state = State::Idle;
+size_t DeflateDecompressor::read(Bytes bytes)
+{
+    size_t total_read = 0;
+    while (total_read < bytes.size()) {
+        if (has_any_error())
+            break;
 
+        if (m_window_read_position < m_window_end) {
+            auto count = min(bytes.size() - total_read, m_window_end - m_window_read_position);
+            __builtin_memcpy(bytes.data() + total_read, m_window + m_window_read_position, count);
+            m_window_read_position += count;
+            total_read += count;
             continue;
         }
 
-        if (m_state == State::ReadingUncompressedBlock) {
-            auto nread = m_output_stream.read(slice);
-
-            while (nread < slice.size() && m_uncompressed_block.try_read_more()) {
-                nread += m_output_stream.read(slice.slice(nread));
-            }
-
-            if (m_input_stream.has_any_error()) {
-                set_fatal_error();
-                break;
-            }
-
-            total_read += nread;
-            if (nread == slice.size())
-                break;
-
-            m_uncompressed_block.~UncompressedBlock();
-            m_state = State::Idle;
-
-            continue;
+        // Whatever was decoded before an error is still handed out, only then the error is reported
+        if (m_failed) {
+            set_fatal_error();
+            break;
         }
 
-        VERIFY_NOT_REACHED();
+        if (m_state == State::Idle && m_read_final_block)
+            break;
+
+        if (!decode_more())
+            m_failed = true;
     }
     return total_read;
 }
@@ -351,7 +437,7 @@ bool DeflateDecompressor::discard_or_error(size_t count)
     return true;
 }
 
-bool DeflateDecompressor::unreliable_eof() const { return m_state == State::Idle && m_read_final_bock; }
+bool DeflateDecompressor::unreliable_eof() const { return m_state == State::Idle && m_read_final_block && m_window_read_position == m_window_end; }
 
 bool DeflateDecompressor::handle_any_error()
 {
@@ -377,134 +463,110 @@ Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
-u32 DeflateDecompressor::decode_length(u32 symbol)
-{
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
-    if (symbol <= 264)
-        return symbol - 254;
-
-    if (symbol <= 284) {
-        auto extra_bits = (symbol - 261) / 4;
-        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + m_input_stream.read_bits(extra_bits);
-    }
-
-    if (symbol == 285)
-        return 258;
-
-    VERIFY_NOT_REACHED();
-}
-
-u32 DeflateDecompressor::decode_distance(u32 symbol)
+bool DeflateDecompressor::decode_codes()
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
-    if (symbol <= 3)
-        return symbol + 1;
-
-    if (symbol <= 29) {
-        auto extra_bits = (symbol / 2) - 1;
-        return ((symbol % 2 + 2) << extra_bits) + 1 + m_input_stream.read_bits(extra_bits);
-    }
-
-    VERIFY_NOT_REACHED();
-}
-
-void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
-{
-    auto literal_code_count = m_input_stream.read_bits(5) + 257;
-    auto distance_code_count = m_input_stream.read_bits(5) + 1;
-    auto code_length_count = m_input_stream.read_bits(4) + 4;
+    auto literal_code_count = read_bits(5);
+    auto distance_code_count = read_bits(5);
+    auto code_length_count = read_bits(4);
+    if (!literal_code_count.has_value() || !distance_code_count.has_value() || !code_length_count.has_value())
+        return false;
+    *literal_code_count += 257;
+    *distance_code_count += 1;
+    *code_length_count += 4;
 
     // First we have to extract the code lengths of the code that was used to encode the code lengths of
     // the code that was used to encode the block.
 
     u8 code_lengths_code_lengths[19] = { 0 };
-    for (size_t i = 0; i < code_length_count; ++i) {
-        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = m_input_stream.read_bits(3);
+    for (size_t i = 0; i < *code_length_count; ++i) {
+        auto code_length = read_bits(3);
+        if (!code_length.has_value())
+            return false;
+        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = *code_length;
     }
 
     // Now we can extract the code that was used to encode the code lengths of the code that was used to
     // encode the block.
 
     auto code_length_code_result = CanonicalCode::from_bytes({ code_lengths_code_lengths, sizeof(code_lengths_code_lengths) });
-    if (!code_length_code_result.has_value()) {
-        set_fatal_error();
-        return;
-    }
-    auto const code_length_code = code_length_code_result.value();
+    if (!code_length_code_result.has_value())
+        return false;
+    auto const code_length_code = code_length_code_result.release_value();
 
     // Next we extract the code lengths of the code that was used to encode the block.
 
     Vector<u8> code_lengths;
-    while (code_lengths.size() < literal_code_count + distance_code_count) {
-        auto symbol = code_length_code.read_symbol(m_input_stream);
-
-        if (symbol == UINT32_MAX) {
-            set_fatal_error();
-            return;
-        }
+    while (code_lengths.size() < *literal_code_count + *distance_code_count) {
+        if (m_bit_count < 7)
+            refill_bits();
+        auto entry = code_length_code.decode_symbol(m_bit_buffer);
+        auto code_length = entry >> 16;
+        if (code_length == 0 || code_length > m_bit_count)
+            return false;
+        m_bit_buffer >>= code_length;
+        m_bit_count -= code_length;
+        auto symbol = entry & 0xffff;
 
         if (symbol < deflate_special_code_length_copy) {
             code_lengths.append(static_cast<u8>(symbol));
             continue;
         } else if (symbol == deflate_special_code_length_zeros) {
-            auto nrepeat = 3 + m_input_stream.read_bits(3);
-            for (size_t j = 0; j < nrepeat; ++j)
+            auto nrepeat = read_bits(3);
+            if (!nrepeat.has_value())
+                return false;
+            for (size_t j = 0; j < 3 + *nrepeat; ++j)
                 code_lengths.append(0);
             continue;
         } else if (symbol == deflate_special_code_length_long_zeros) {
-            auto nrepeat = 11 + m_input_stream.read_bits(7);
-            for (size_t j = 0; j < nrepeat; ++j)
+            auto nrepeat = read_bits(7);
+            if (!nrepeat.has_value())
+                return false;
+            for (size_t j = 0; j < 11 + *nrepeat; ++j)
                 code_lengths.append(0);
             continue;
         } else {
             VERIFY(symbol == deflate_special_code_length_copy);
 
-            if (code_lengths.is_empty()) {
-                set_fatal_error();
-                return;
-            }
+            if (code_lengths.is_empty())
+                return false;
 
-            auto nrepeat = 3 + m_input_stream.read_bits(2);
-            for (size_t j = 0; j < nrepeat; ++j)
+            auto nrepeat = read_bits(2);
+            if (!nrepeat.has_value())
+                return false;
+            for (size_t j = 0; j < 3 + *nrepeat; ++j)
                 code_lengths.append(code_lengths.last());
         }
     }
 
-    if (code_lengths.size() != literal_code_count + distance_code_count) {
-        set_fatal_error();
-        return;
-    }
+    if (code_lengths.size() != *literal_code_count + *distance_code_count)
+        return false;
 
     // Now we extract the code that was used to encode literals and lengths in the block.
 
-    auto literal_code_result = CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count));
-    if (!literal_code_result.has_value()) {
-        set_fatal_error();
-        return;
-    }
-    literal_code = literal_code_result.value();
+    auto literal_code_result = CanonicalCode::from_bytes(code_lengths.span().trim(*literal_code_count));
+    if (!literal_code_result.has_value())
+        return false;
+    m_dynamic_literal_codes = literal_code_result.release_value();
+    m_literal_codes = &m_dynamic_literal_codes;
+    m_distance_codes = nullptr;
 
     // Now we extract the code that was used to encode distances in the block.
 
-    if (distance_code_count == 1) {
-        auto length = code_lengths[literal_code_count];
+    if (*distance_code_count == 1) {
+        auto length = code_lengths[*literal_code_count];
 
-        if (length == 0) {
-            return;
-        } else if (length != 1) {
-            set_fatal_error();
-            return;
-        }
+        if (length == 0)
+            return true;
+        else if (length != 1)
+            return false;
     }
 
-    auto distance_code_result = CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count));
-    if (!distance_code_result.has_value()) {
-        set_fatal_error();
-        return;
-    }
-    distance_code = distance_code_result.value();
+    auto distance_code_result = CanonicalCode::from_bytes(code_lengths.span().slice(*literal_code_count));
+    if (!distance_code_result.has_value())
+        return false;
+    m_dynamic_distance_codes = distance_code_result.release_value();
+    m_distance_codes = &m_dynamic_distance_codes;
+    return true;
 }
 
 DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel compression_level)
@@ -514,16 +576,20 @@ DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel comp
 {
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+    for (auto& slot : m_hash_head)
+        slot = empty_slot;
 }
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    // Either the stream was ended, or everything written to it was sync flushed
+    VERIFY(m_finished || m_pending_block_size == 0);
 }
 
 size_t DeflateCompressor::write(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
+    m_has_written = true;
 
     if (bytes.size() == 0)
         return 0; // recursion base case
@@ -554,25 +620,36 @@ u16 DeflateCompressor::hash_sequence(u8 const* bytes)
     return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) * knuth_constant) >> (32 - hash_bits);
 }
 
-size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
+ALWAYS_INLINE size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
+    // Most candidates can be rejected by checking the last two bytes a longer match than the previous one would need
+    u16 start_end;
+    u16 candidate_end;
+    __builtin_memcpy(&start_end, &m_rolling_window[start + previous_match_length - 1], sizeof(u16));
+    __builtin_memcpy(&candidate_end, &m_rolling_window[candidate + previous_match_length - 1], sizeof(u16));
+    if (start_end != candidate_end)
+        return 0;
+
+    // Find the actual length, comparing 8 bytes at a time where possible
+    size_t match_length = 0;
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        u64 start_bytes;
+        u64 candidate_bytes;
+        __builtin_memcpy(&start_bytes, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_bytes, &m_rolling_window[candidate + match_length], sizeof(u64));
+        if (auto difference = AK::convert_between_host_and_little_endian(start_bytes ^ candidate_bytes); difference != 0) {
+            match_length += count_trailing_zeroes(difference) / 8;
+            return match_length > previous_match_length ? match_length : 0;
+        }
+        match_length += sizeof(u64);
     }
-
-    // Find the actual length
-    auto match_length = previous_match_length + 1;
-    while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
+    while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length])
         match_length++;
-    }
 
-    VERIFY(match_length > previous_match_length);
     VERIFY(match_length <= maximum_match_length);
-    return match_length;
+    return match_length > previous_match_length ? match_length : 0;
 }
 
 size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t maximum_match_length, size_t& match_position)
@@ -585,8 +662,9 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
     if (previous_match_length >= m_compression_constants.max_lazy_length)
         return 0; // the previous match is already pretty, we shouldn't waste another full search
     if (previous_match_length >= m_compression_constants.good_match_length)
-        max_chain_length /= 4; // we already have a pretty good much, so do a shorter search
+        max_chain_length = max(max_chain_length / 4, 1u); // we already have a pretty good much, so do a shorter search
 
+    auto great_match_length = min(m_compression_constants.great_match_length, maximum_match_length);
     auto candidate = m_hash_head[hash];
     auto match_found = false;
     while (max_chain_length--) {
@@ -594,7 +672,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_match_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -604,8 +682,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length >= great_match_length)
+                return match_length; // the match is good enough, don't waste time looking for a longer one
         }
 
         candidate = m_hash_prev[candidate % window_size];
@@ -694,10 +772,6 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array
 
 void DeflateCompressor::lz77_compress_block()
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
-        slot = empty_slot;
-    }
-
     auto insert_hash = [&](auto pos, auto hash) {
         auto window_pos = pos % window_size;
         m_hash_prev[window_pos] = m_hash_head[hash];
@@ -724,45 +798,69 @@ void DeflateCompressor::lz77_compress_block()
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
-    VERIFY(m_compression_constants.great_match_length <= max_match_length);
-
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
-    size_t current_position;
-    for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
-        auto hash = hash_sequence(&m_rolling_window[current_position]);
-        size_t match_position;
-        auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
-
-        insert_hash(current_position, hash);
-
-        // if the previous match is as good as the new match, just use it
-        if (previous_match_length != 0 && previous_match_length >= match_length) {
-            emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
-
-            // skip all the bytes that are included in this match
-            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
-                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+    auto hashable_end = block_end - min_match_length + 1;
+    size_t current_position = block_size;
+
+    if (!m_compression_constants.lazy_matching) {
+        while (current_position < hashable_end) {
+            auto hash = hash_sequence(&m_rolling_window[current_position]);
+            size_t match_position;
+            auto match_length = find_back_match(current_position, hash, 0, min(max_match_length, block_end - current_position), match_position);
+
+            insert_hash(current_position, hash);
+
+            if (match_length == 0) {
+                emit_literal(m_rolling_window[current_position++]);
+                continue;
             }
-            current_position = (current_position - 1) + previous_match_length - 1;
-            previous_match_length = 0;
-            continue;
-        }
 
-        if (match_length == 0) {
-            VERIFY(previous_match_length == 0);
-            emit_literal(m_rolling_window[current_position]);
-            continue;
-        }
+            emit_back_reference(current_position - match_position, match_length);
 
-        // if this is a lazy match, and the new match is better than the old one, output previous as literal
-        if (previous_match_length != 0) {
-            emit_literal(m_rolling_window[current_position - 1]);
+            // inserting all the bytes of long matches takes time, and they rarely start a new match anyway
+            if (match_length <= m_compression_constants.max_lazy_length) {
+                for (size_t j = current_position + 1; j < min(current_position + match_length, hashable_end); j++)
+                    insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            }
+            current_position += match_length;
         }
+    } else {
+        for (; current_position < hashable_end; current_position++) {
+            auto hash = hash_sequence(&m_rolling_window[current_position]);
+            size_t match_position;
+            auto match_length = find_back_match(current_position, hash, previous_match_length,
+                min(max_match_length, block_end - current_position), match_position);
+
+            insert_hash(current_position, hash);
+
+            // if the previous match is as good as the new match, just use it
+            if (previous_match_length != 0 && previous_match_length >= match_length) {
+                emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
+
+                // skip all the bytes that are included in this match
+                for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, hashable_end); j++) {
+                    insert_hash(j, hash_sequence(&m_rolling_window[j]));
+                }
+                current_position = (current_position - 1) + previous_match_length - 1;
+                previous_match_length = 0;
+                continue;
+            }
+
+            if (match_length == 0) {
+                VERIFY(previous_match_length == 0);
+                emit_literal(m_rolling_window[current_position]);
+                continue;
+            }
+
+            // if this is a lazy match, and the new match is better than the old one, output previous as literal
+            if (previous_match_length != 0) {
+                emit_literal(m_rolling_window[current_position - 1]);
+            }
 
-        previous_match_length = match_length;
-        previous_match_position = match_position;
+            previous_match_length = match_length;
+            previous_match_position = match_position;
+        }
     }
 
     // clean up leftover lazy match
@@ -1045,8 +1143,24 @@ void DeflateCompressor::flush()
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+    slide_window();
+}
+
+void DeflateCompressor::slide_window()
+{
+    // The block we just compressed becomes the first half of the window, so that the next block can refer back into it.
     // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
     pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+
+    auto slide = [](u16& position) {
+        position = (position == empty_slot || position < block_size) ? empty_slot : position - block_size;
+    };
+    for (auto& slot : m_hash_head)
+        slide(slot);
+    for (size_t i = 0; i < block_size; i++) {
+        m_hash_prev[i] = m_hash_prev[i + block_size];
+        slide(m_hash_prev[i]);
+    }
 }
 
 void DeflateCompressor::final_flush()
@@ -1056,6 +1170,39 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_has_written);
+
+    // The dictionary goes where the previous block would be, right before the pending block
+    dictionary = dictionary.slice(dictionary.size() - min(dictionary.size(), block_size));
+    auto dictionary_start = block_size - dictionary.size();
+    dictionary.copy_to({ m_rolling_window + dictionary_start, dictionary.size() });
+
+    for (size_t position = dictionary_start; position + min_match_length <= block_size; position++) {
+        auto hash = hash_sequence(&m_rolling_window[position]);
+        m_hash_prev[position] = m_hash_head[hash];
+        m_hash_head[hash] = position;
+    }
+}
+
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+
+    if (m_pending_block_size != 0)
+        flush();
+
+    // An empty uncompressed block, which is what aligns the output to a byte boundary
+    m_output_stream.write_bit(false);
+    m_output_stream.write_bits(0b00, 2);
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    m_output_stream << len;
+    LittleEndian<u16> nlen = ~0;
+    m_output_stream << nlen;
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
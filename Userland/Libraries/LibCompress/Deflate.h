@@ -9,7 +9,6 @@
 
 #include <AK/BitStream.h>
 #include <AK/ByteBuffer.h>
-#include <AK/CircularDuplexStream.h>
 #include <AK/Endian.h>
 #include <AK/Vector.h>
 #include <LibCompress/DeflateTables.h>
@@ -19,7 +18,6 @@ namespace Compress {
 class CanonicalCode {
 public:
     CanonicalCode() = default;
-    u32 read_symbol(InputBitStream&) const;
     void write_symbol(OutputBitStream&, u32) const;
 
     static CanonicalCode const& fixed_literal_codes();
@@ -27,10 +25,27 @@ public:
 
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
+    // Looks up the symbol whose code makes up the lowest bits of `bits`, and returns it together with the length of that code as
+    // (length << 16 | symbol). The length is 0 if the bits don't start with a valid code.
+    ALWAYS_INLINE u32 decode_symbol(u64 bits) const
+    {
+        // Codes up to m_primary_table_bits long are decoded with a single lookup, longer ones take another one in the sub-table
+        // for their first m_primary_table_bits bits.
+        auto entry = m_decoding_table.data()[bits & ((1u << m_primary_table_bits) - 1)];
+        if (entry & sub_table_flag) [[unlikely]] {
+            auto sub_table_bits = (entry >> 16) & 0xff;
+            entry = m_decoding_table.data()[(entry & 0xffff) + ((bits >> m_primary_table_bits) & ((1u << sub_table_bits) - 1))];
+        }
+        return entry;
+    }
+
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
-    Vector<u16> m_symbol_values;
+    static constexpr size_t max_primary_table_bits = 9;
+    static constexpr u32 sub_table_flag = 1u << 31;
+
+    // Decompression - indexed by the (bit-reversed) next bits of the input
+    Vector<u32> m_decoding_table;
+    size_t m_primary_table_bits { 0 };
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -38,69 +53,77 @@ private:
 };
 
 class DeflateDecompressor final : public InputStream {
-private:
-    class CompressedBlock {
-    public:
-        CompressedBlock(DeflateDecompressor&, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes);
+public:
+    DeflateDecompressor(InputStream&);
+    ~DeflateDecompressor() = default;
 
-        bool try_read_more();
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t) override;
 
-    private:
-        bool m_eof { false };
+    bool unreliable_eof() const override;
+    bool handle_any_error() override;
 
-        DeflateDecompressor& m_decompressor;
-        CanonicalCode m_literal_codes;
-        Optional<CanonicalCode> m_distance_codes;
-    };
+    // The input is read ahead in bulk, so the bytes following the deflate stream may already have been read from the underlying stream.
+    // Once the stream has ended, these are the bytes that were read but not used.
+    ReadonlyBytes unused_input() const;
 
-    class UncompressedBlock {
-    public:
-        UncompressedBlock(DeflateDecompressor&, size_t);
+    // Lets back references refer to data that was decompressed before this stream started,
+    // e.g. by a previous stream sharing the same window, as WebSocket messages do (RFC 7692).
+    void set_history(ReadonlyBytes);
 
-        bool try_read_more();
+    // Streams that were flushed instead of finished end after a block that isn't the final one.
+    // After running out of input, this tells whether that happened right where a new block would have started.
+    bool ended_on_block_boundary() const { return m_state == State::Idle && m_bit_count < 8 && m_input_position == m_input_size; }
 
-    private:
-        DeflateDecompressor& m_decompressor;
-        size_t m_bytes_remaining;
-    };
+    static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
+private:
     enum class State {
         Idle,
         ReadingCompressedBlock,
         ReadingUncompressedBlock
     };
 
-public:
-    friend CompressedBlock;
-    friend UncompressedBlock;
-
-    DeflateDecompressor(InputStream&);
-    ~DeflateDecompressor();
+    static constexpr size_t input_buffer_size = 4 * KiB;
+    static constexpr size_t history_size = 32 * KiB; // back references can't refer further back than this
+    static constexpr size_t decode_chunk_size = 32 * KiB;
+    static constexpr size_t window_slack = 512; // a back reference may end a bit past the chunk, and copies may overshoot by up to 7 bytes
 
-    size_t read(Bytes) override;
-    bool read_or_error(Bytes) override;
-    bool discard_or_error(size_t) override;
+    bool refill_input_buffer();
+    void refill_bits();
+    Optional<u32> read_bits(size_t count);
+    void align_to_byte_boundary();
 
-    bool unreliable_eof() const override;
-    bool handle_any_error() override;
+    bool decode_more();
+    bool read_block_header();
+    bool decode_codes();
+    bool decode_compressed_block(size_t output_limit);
+    bool copy_uncompressed_block(size_t output_limit);
 
-    static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
-
-private:
-    u32 decode_length(u32);
-    u32 decode_distance(u32);
-    void decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
-
-    bool m_read_final_bock { false };
+    bool m_read_final_block { false };
+    bool m_failed { false };
 
     State m_state { State::Idle };
-    union {
-        CompressedBlock m_compressed_block;
-        UncompressedBlock m_uncompressed_block;
-    };
-
-    InputBitStream m_input_stream;
-    CircularDuplexStream<32 * KiB> m_output_stream;
+    size_t m_uncompressed_bytes_remaining { 0 };
+    CanonicalCode const* m_literal_codes { nullptr };
+    CanonicalCode const* m_distance_codes { nullptr };
+    CanonicalCode m_dynamic_literal_codes;
+    CanonicalCode m_dynamic_distance_codes;
+
+    // The input is read into m_input_buffer in bulk, and from there into a bit buffer of up to 64 bits.
+    // NOTE: The bytes that are still in the bit buffer stay in m_input_buffer (just before m_input_position), so they can be handed back.
+    InputStream& m_input_stream;
+    u8 m_input_buffer[input_buffer_size];
+    size_t m_input_position { 0 };
+    size_t m_input_size { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+
+    // The output is decoded into a window holding the history that back references can refer to, followed by the output that wasn't read yet.
+    u8 m_window[history_size + decode_chunk_size + window_slack];
+    size_t m_window_read_position { 0 };
+    size_t m_window_end { 0 };
 };
 
 class DeflateCompressor final : public OutputStream {
@@ -112,30 +135,40 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_match_distance = 32768;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
+                                   // When matching greedily, only the bytes of matches at most this long are inserted into the hash table
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
         size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        bool lazy_matching;        // Whether to check if the next byte starts a longer match before taking the current one
     };
 
-    // These constants were shamelessly "borrowed" from zlib
+    // These constants were shamelessly "borrowed" from zlib, so that levels 1-9 trade speed for size like they do there
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, false },
+        { 4, 4, 8, 1, false }, // NOTE: zlib checks 4 candidates here, we only look at the most recent one to be as fast as possible
+        { 4, 5, 16, 8, false },
+        { 4, 6, 32, 32, false },
+        { 4, 4, 16, 16, true },
+        { 8, 16, 32, 32, true },
+        { 8, 16, 128, 128, true },
+        { 8, 32, 128, 256, true },
+        { 32, 128, 258, 1024, true },
+        { 32, 258, 258, 4096, true },
+        { max_match_length, max_match_length, max_match_length, 1 << hash_bits, true } // disable all limits
     };
 
+    // Any level from 0 to 9 can be used, the named ones are just the common choices
     enum class CompressionLevel : int {
         STORE = 0,
-        FAST,
-        GOOD,
-        GREAT,
-        BEST // WARNING: this one can take an unreasonable amount of time!
+        FAST = 1,
+        GOOD = 6,
+        GREAT = 9,
+        BEST = 10 // WARNING: this one can take an unreasonable amount of time!
     };
 
     DeflateCompressor(OutputStream&, CompressionLevel = CompressionLevel::GOOD);
@@ -145,6 +178,14 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
 
+    // Lets back references refer to data that precedes the input, like the data compressed by another compressor just before.
+    // Only the last 32 KiB of the dictionary are used, and it has to be set before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
+    // Compresses what was written so far and ends the output on a byte boundary, but without ending the deflate stream.
+    // Once nothing else is written, the output can be followed by that of another compressor (one using the same dictionary).
+    void sync_flush();
+
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
@@ -155,6 +196,7 @@ private:
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
     void lz77_compress_block();
+    void slide_window();
 
     // Huffman Coding
     struct code_length_symbol {
@@ -176,6 +218,7 @@ private:
     void flush();
 
     bool m_finished { false };
+    bool m_has_written { false };
     CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     OutputBitStream m_output_stream;
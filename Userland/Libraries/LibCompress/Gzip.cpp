@@ -8,6 +8,7 @@
 #include <LibCompress/Gzip.h>
 
 #include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <LibCore/DateTime.h>
 
@@ -38,6 +39,60 @@ bool BlockHeader::supported_by_implementation() const
     return true;
 }
 
+void GzipDecompressor::PushbackInputStream::push_back(ReadonlyBytes bytes)
+{
+    if (bytes.is_empty())
+        return;
+    auto remaining = m_pushed_back.bytes().slice(m_pushed_back_offset);
+    auto buffer = ByteBuffer::create_uninitialized(bytes.size() + remaining.size()).release_value_but_fixme_should_propagate_errors();
+    bytes.copy_to(buffer);
+    remaining.copy_to(buffer.bytes().slice(bytes.size()));
+    m_pushed_back = move(buffer);
+    m_pushed_back_offset = 0;
+}
+
+size_t GzipDecompressor::PushbackInputStream::read(Bytes bytes)
+{
+    auto nread = m_pushed_back.bytes().slice(m_pushed_back_offset).copy_trimmed_to(bytes);
+    m_pushed_back_offset += nread;
+    if (nread < bytes.size())
+        nread += m_stream.read(bytes.slice(nread));
+    return nread;
+}
+
+bool GzipDecompressor::PushbackInputStream::read_or_error(Bytes bytes)
+{
+    if (read(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool GzipDecompressor::PushbackInputStream::discard_or_error(size_t count)
+{
+    auto ndiscarded = min(count, m_pushed_back.size() - m_pushed_back_offset);
+    m_pushed_back_offset += ndiscarded;
+    if (ndiscarded < count && !m_stream.discard_or_error(count - ndiscarded)) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool GzipDecompressor::PushbackInputStream::unreliable_eof() const
+{
+    return m_pushed_back_offset == m_pushed_back.size() && m_stream.unreliable_eof();
+}
+
+bool GzipDecompressor::PushbackInputStream::handle_any_error()
+{
+    bool handled_errors = m_stream.handle_any_error();
+    return Stream::handle_any_error() || handled_errors;
+}
+
 GzipDecompressor::GzipDecompressor(InputStream& stream)
     : m_input_stream(stream)
 {
@@ -69,6 +124,8 @@ size_t GzipDecompressor::read(Bytes bytes)
             }
 
             if (nread < slice.size()) {
+                m_input_stream.push_back(current_member().m_stream.unused_input());
+
                 LittleEndian<u32> crc32, input_size;
                 m_input_stream >> crc32 >> input_size;
 
@@ -225,7 +282,7 @@ GzipCompressor::GzipCompressor(OutputStream& stream)
 {
 }
 
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+void GzipCompressor::write_header(OutputStream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -235,7 +292,12 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
+    stream << Bytes { &header, sizeof(header) };
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    write_header(m_output_stream);
     DeflateCompressor compressed_stream { m_output_stream };
     VERIFY(compressed_stream.write_or_error(bytes));
     compressed_stream.final_flush();
@@ -270,4 +332,58 @@ Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+ChunkedGzipCompressor::ChunkedGzipCompressor(ReadonlyBytes input, DeflateCompressor::CompressionLevel compression_level, size_t chunk_size)
+    : m_input(input)
+    , m_compression_level(compression_level)
+{
+    VERIFY(chunk_size > 0);
+    size_t offset = 0;
+    do {
+        auto size = min(chunk_size, input.size() - offset);
+        m_chunks.append({ input.slice(offset, size), {}, 0 });
+        offset += size;
+    } while (offset < input.size());
+}
+
+void ChunkedGzipCompressor::compress_chunk(size_t index)
+{
+    auto& chunk = m_chunks[index];
+    DuplexMemoryStream output_stream;
+    // NOTE: Compressors are too large to live on the (possibly small) stack of a worker thread.
+    auto compressor = make<DeflateCompressor>(output_stream, m_compression_level);
+
+    auto offset = chunk.input.data() - m_input.data();
+    compressor->set_dictionary(m_input.trim(offset));
+    compressor->write_or_error(chunk.input);
+    // All but the last chunk must not end the deflate stream
+    if (index == m_chunks.size() - 1)
+        compressor->final_flush();
+    else
+        compressor->sync_flush();
+
+    if (compressor->handle_any_error())
+        return;
+    chunk.compressed = output_stream.copy_into_contiguous_buffer();
+    chunk.crc32 = Crypto::Checksum::CRC32 { chunk.input }.digest();
+}
+
+Optional<ByteBuffer> ChunkedGzipCompressor::finish()
+{
+    DuplexMemoryStream output_stream;
+    GzipCompressor::write_header(output_stream);
+
+    u32 crc32 = 0;
+    for (auto& chunk : m_chunks) {
+        if (!chunk.compressed.has_value())
+            return {};
+        output_stream << chunk.compressed->bytes();
+        crc32 = Crypto::Checksum::CRC32::combine(crc32, chunk.crc32, chunk.input.size());
+    }
+
+    LittleEndian<u32> digest = crc32;
+    LittleEndian<u32> size = m_input.size();
+    output_stream << digest << size;
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Noncopyable.h>
 #include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
@@ -54,6 +55,30 @@ public:
     static bool is_likely_compressed(ReadonlyBytes bytes);
 
 private:
+    // The deflate stream of a member reads its input ahead, so whatever it read past its end is handed back here, to be read
+    // again as the member's trailer and the next member's header.
+    class PushbackInputStream final : public InputStream {
+    public:
+        PushbackInputStream(InputStream& stream)
+            : m_stream(stream)
+        {
+        }
+
+        void push_back(ReadonlyBytes);
+
+        size_t read(Bytes) override;
+        bool read_or_error(Bytes) override;
+        bool discard_or_error(size_t) override;
+
+        bool unreliable_eof() const override;
+        bool handle_any_error() override;
+
+    private:
+        InputStream& m_stream;
+        ByteBuffer m_pushed_back;
+        size_t m_pushed_back_offset { 0 };
+    };
+
     class Member {
     public:
         Member(BlockHeader header, InputStream& stream)
@@ -71,7 +96,7 @@ private:
     Member const& current_member() const { return m_current_member.value(); }
     Member& current_member() { return m_current_member.value(); }
 
-    InputStream& m_input_stream;
+    PushbackInputStream m_input_stream;
     u8 m_partial_header[sizeof(BlockHeader)];
     size_t m_partial_header_offset { 0 };
     Optional<Member> m_current_member;
@@ -90,7 +115,41 @@ public:
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes);
 
 private:
+    friend class ChunkedGzipCompressor;
+
+    static void write_header(OutputStream&);
+
     OutputStream& m_output_stream;
 };
 
+// Compresses data into a single gzip member made of chunks that are compressed independently of each other, like pigz does.
+// Every chunk uses the 32 KiB of input before it as its dictionary, so the result is almost as small as when compressing all of it at once.
+// NOTE: compress_chunk() may be called from several threads at once, as long as every chunk is only compressed once.
+class ChunkedGzipCompressor {
+    AK_MAKE_NONCOPYABLE(ChunkedGzipCompressor);
+    AK_MAKE_NONMOVABLE(ChunkedGzipCompressor);
+
+public:
+    static constexpr size_t default_chunk_size = 128 * KiB;
+
+    ChunkedGzipCompressor(ReadonlyBytes input, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD, size_t chunk_size = default_chunk_size);
+
+    size_t chunk_count() const { return m_chunks.size(); }
+    void compress_chunk(size_t index);
+
+    // Stitches the compressed chunks together, once all of them were compressed.
+    Optional<ByteBuffer> finish();
+
+private:
+    struct Chunk {
+        ReadonlyBytes input;
+        Optional<ByteBuffer> compressed;
+        u32 crc32 { 0 };
+    };
+
+    ReadonlyBytes m_input;
+    DeflateCompressor::CompressionLevel m_compression_level;
+    Vector<Chunk> m_chunks;
+};
+
 }
@@ -65,6 +65,22 @@ u32 Zlib::checksum()
     return m_checksum;
 }
 
+// The zlib header only records which of these four groups the zlib compression level belongs to, we use the typical level of each.
+static DeflateCompressor::CompressionLevel deflate_compression_level(ZlibCompressionLevel compression_level)
+{
+    switch (compression_level) {
+    case ZlibCompressionLevel::Fastest:
+        return DeflateCompressor::CompressionLevel::FAST;
+    case ZlibCompressionLevel::Fast:
+        return static_cast<DeflateCompressor::CompressionLevel>(4);
+    case ZlibCompressionLevel::Default:
+        return DeflateCompressor::CompressionLevel::GOOD;
+    case ZlibCompressionLevel::Best:
+        return DeflateCompressor::CompressionLevel::GREAT;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 ZlibCompressor::ZlibCompressor(OutputStream& stream, ZlibCompressionLevel compression_level)
     : m_output_stream(stream)
 {
@@ -73,8 +89,7 @@ ZlibCompressor::ZlibCompressor(OutputStream& stream, ZlibCompressionLevel compre
 
     write_header(compression_method, compression_level);
 
-    // FIXME: Find a way to compress with Deflate's "Best" compression level.
-    m_compressor = make<DeflateCompressor>(stream, static_cast<DeflateCompressor::CompressionLevel>(compression_level));
+    m_compressor = make<DeflateCompressor>(stream, deflate_compression_level(compression_level));
 }
 
 ZlibCompressor::~ZlibCompressor()
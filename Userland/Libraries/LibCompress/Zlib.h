@@ -47,6 +47,9 @@ public:
     Optional<ByteBuffer> decompress();
     u32 checksum();
 
+    // The deflate stream inside the zlib container, for decompressing it piece by piece with a DeflateDecompressor.
+    ReadonlyBytes compressed_data() const { return m_data_bytes; }
+
     static Optional<Zlib> try_create(ReadonlyBytes data);
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
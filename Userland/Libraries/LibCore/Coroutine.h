@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/Timer.h>
+#include <coroutine>
+#include <errno.h>
+
+namespace Core {
+
+template<typename T>
+class Coroutine;
+
+namespace Detail {
+
+struct CoroutinePromiseBase {
+    // Resumes whoever is co_awaiting the coroutine, if anyone is yet, once it has finished.
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            if (auto awaiter = handle.promise().awaiter)
+                return awaiter;
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept { }
+    };
+
+    // Coroutines start running right away, up to the point where they first have to wait for something.
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { VERIFY_NOT_REACHED(); }
+
+    std::coroutine_handle<> awaiter;
+};
+
+template<typename T>
+struct CoroutinePromise : public CoroutinePromiseBase {
+    Coroutine<T> get_return_object();
+    void return_value(T&& value) { result = move(value); }
+    void return_value(T const& value) { result = value; }
+
+    Optional<T> result;
+};
+
+template<>
+struct CoroutinePromise<void> : public CoroutinePromiseBase {
+    Coroutine<void> get_return_object();
+    void return_void() { }
+};
+
+}
+
+// The return type of coroutines that run on the event loop. A coroutine can co_await another one to get its result,
+// and the other awaitables in this file to wait for file descriptors and timers without blocking the event loop.
+// Destroying a Coroutine before it has finished destroys its frame, along with anything it was waiting on.
+template<typename T>
+class [[nodiscard]] Coroutine {
+    AK_MAKE_NONCOPYABLE(Coroutine);
+
+public:
+    using promise_type = Detail::CoroutinePromise<T>;
+
+    Coroutine(Coroutine&& other)
+        : m_handle(exchange(other.m_handle, {}))
+    {
+    }
+
+    Coroutine& operator=(Coroutine&& other)
+    {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    ~Coroutine()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool is_done() const { return m_handle.done(); }
+
+    bool await_ready() const { return m_handle.done(); }
+    void await_suspend(std::coroutine_handle<> awaiter) { m_handle.promise().awaiter = awaiter; }
+    T await_resume()
+    {
+        if constexpr (!IsSame<T, void>)
+            return m_handle.promise().result.release_value();
+    }
+
+    // Pumps the current event loop until the coroutine has finished, for the places that aren't coroutines themselves.
+    T await()
+    {
+        while (!is_done())
+            EventLoop::current().pump();
+        return await_resume();
+    }
+
+private:
+    friend promise_type;
+
+    explicit Coroutine(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template<typename T>
+Coroutine<T> Detail::CoroutinePromise<T>::get_return_object()
+{
+    return Coroutine<T> { std::coroutine_handle<CoroutinePromise<T>>::from_promise(*this) };
+}
+
+inline Coroutine<void> Detail::CoroutinePromise<void>::get_return_object()
+{
+    return Coroutine<void> { std::coroutine_handle<CoroutinePromise<void>>::from_promise(*this) };
+}
+
+// co_await-ing this suspends the coroutine until the file descriptor is readable or writable.
+// The notifier only exists while the coroutine is waiting on it, so it never fires for nobody.
+class NotifierAwaiter {
+    AK_MAKE_NONCOPYABLE(NotifierAwaiter);
+    AK_MAKE_NONMOVABLE(NotifierAwaiter);
+
+public:
+    NotifierAwaiter(int fd, Notifier::Event event)
+        : m_fd(fd)
+        , m_event(event)
+    {
+    }
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_notifier = Notifier::construct(m_fd, m_event);
+        auto resume = [this, handle] {
+            m_notifier->set_enabled(false);
+            handle.resume();
+        };
+        if (m_event == Notifier::Event::Read)
+            m_notifier->on_ready_to_read = move(resume);
+        else
+            m_notifier->on_ready_to_write = move(resume);
+    }
+    void await_resume() { }
+
+private:
+    int m_fd { -1 };
+    Notifier::Event m_event { Notifier::Event::None };
+    RefPtr<Notifier> m_notifier;
+};
+
+// co_await-ing this suspends the coroutine until the given number of milliseconds have passed.
+class TimerAwaiter {
+    AK_MAKE_NONCOPYABLE(TimerAwaiter);
+    AK_MAKE_NONMOVABLE(TimerAwaiter);
+
+public:
+    explicit TimerAwaiter(int milliseconds)
+        : m_milliseconds(milliseconds)
+    {
+    }
+
+    ~TimerAwaiter()
+    {
+        if (m_timer)
+            m_timer->stop();
+    }
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_timer = Timer::create_single_shot(m_milliseconds, [handle] { handle.resume(); });
+        m_timer->start();
+    }
+    void await_resume() { }
+
+private:
+    int m_milliseconds { 0 };
+    RefPtr<Timer> m_timer;
+};
+
+inline NotifierAwaiter wait_until_readable(int fd) { return { fd, Notifier::Event::Read }; }
+inline NotifierAwaiter wait_until_writable(int fd) { return { fd, Notifier::Event::Write }; }
+inline TimerAwaiter sleep_for(int milliseconds) { return TimerAwaiter { milliseconds }; }
+
+// Reads whatever is available into the buffer, waiting until something is. Like Stream::read(), an empty result
+// means the other side closed the connection. The result points into the caller's buffer, nothing is copied.
+template<typename SocketType>
+Coroutine<ErrorOr<Bytes>> read_some(SocketType& socket, Bytes buffer)
+{
+    while (true) {
+        auto can_read = socket.can_read_without_blocking();
+        if (can_read.is_error())
+            co_return can_read.release_error();
+        if (can_read.value())
+            co_return socket.read(buffer);
+        co_await wait_until_readable(socket.fd());
+    }
+}
+
+// Writes all of the given bytes. If the socket isn't blocking, this waits for it to become writable when needed
+// instead of failing with EAGAIN.
+template<typename SocketType>
+Coroutine<ErrorOr<void>> write_all(SocketType& socket, ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto result = socket.write(bytes);
+        if (result.is_error()) {
+            if (result.error().is_errno() && (result.error().code() == EAGAIN || result.error().code() == EWOULDBLOCK)) {
+                co_await wait_until_writable(socket.fd());
+                continue;
+            }
+            co_return result.release_error();
+        }
+        bytes = bytes.slice(result.value());
+    }
+    co_return ErrorOr<void> {};
+}
+
+}
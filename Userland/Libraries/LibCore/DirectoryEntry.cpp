@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/DirectoryEntry.h>
+#include <LibCore/System.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifdef __serenity__
+#    include <Kernel/API/DirectoryEntryWithMetadata.h>
+#endif
+
+namespace Core {
+
+DirectoryEntry::Type DirectoryEntry::type_from_dirent_type(unsigned char dirent_type)
+{
+    switch (dirent_type) {
+    case DT_BLK:
+        return Type::BlockDevice;
+    case DT_CHR:
+        return Type::CharacterDevice;
+    case DT_DIR:
+        return Type::Directory;
+    case DT_REG:
+        return Type::File;
+    case DT_FIFO:
+        return Type::NamedPipe;
+    case DT_SOCK:
+        return Type::Socket;
+    case DT_LNK:
+        return Type::SymbolicLink;
+    default:
+        return Type::Unknown;
+    }
+}
+
+DirectoryEntry::Type DirectoryEntry::type_from_mode(mode_t mode)
+{
+    if (S_ISBLK(mode))
+        return Type::BlockDevice;
+    if (S_ISCHR(mode))
+        return Type::CharacterDevice;
+    if (S_ISDIR(mode))
+        return Type::Directory;
+    if (S_ISREG(mode))
+        return Type::File;
+    if (S_ISFIFO(mode))
+        return Type::NamedPipe;
+    if (S_ISSOCK(mode))
+        return Type::Socket;
+    if (S_ISLNK(mode))
+        return Type::SymbolicLink;
+    return Type::Unknown;
+}
+
+static bool is_dot_or_dot_dot(StringView name)
+{
+    return name == "."sv || name == ".."sv;
+}
+
+#ifdef __serenity__
+// Lists the directory along with the metadata of its entries, which the kernel can look up while it's traversing the
+// directory anyway. Entries it couldn't look up are left without metadata.
+static ErrorOr<Vector<DirectoryEntry>> read_all_with_metadata(int fd)
+{
+    struct stat directory_metadata = TRY(System::fstat(fd));
+    auto buffer = TRY(ByteBuffer::create_uninitialized(max(static_cast<size_t>(directory_metadata.st_size), static_cast<size_t>(4096))));
+    size_t size = 0;
+    while (true) {
+        auto size_or_error = System::get_dir_entries_with_metadata(fd, buffer.bytes());
+        // The buffer was too small for all of the entries.
+        if (size_or_error.is_error() && size_or_error.error().code() == EINVAL) {
+            TRY(buffer.try_resize(buffer.size() * 2));
+            continue;
+        }
+        size = TRY(size_or_error);
+        break;
+    }
+
+    Vector<DirectoryEntry> entries;
+    for (size_t offset = 0; offset < size;) {
+        auto const& serialized_entry = *reinterpret_cast<DirectoryEntryWithMetadata const*>(buffer.data() + offset);
+        offset += serialized_entry.total_size();
+
+        StringView name { serialized_entry.name, serialized_entry.name_length };
+        if (is_dot_or_dot_dot(name))
+            continue;
+
+        DirectoryEntry entry;
+        entry.type = DirectoryEntry::type_from_dirent_type(serialized_entry.file_type);
+        entry.name = name;
+        entry.inode_index = serialized_entry.inode_index;
+        if (serialized_entry.has_metadata) {
+            entry.metadata = serialized_entry.metadata;
+            entry.type = DirectoryEntry::type_from_mode(serialized_entry.metadata.st_mode);
+        }
+        TRY(entries.try_append(move(entry)));
+    }
+    return entries;
+}
+#endif
+
+static ErrorOr<Vector<DirectoryEntry>> read_all_without_metadata(DIR* dir)
+{
+    Vector<DirectoryEntry> entries;
+    while (true) {
+        errno = 0;
+        auto* dirent = readdir(dir);
+        if (!dirent) {
+            if (errno != 0)
+                return Error::from_errno(errno);
+            break;
+        }
+        if (is_dot_or_dot_dot({ dirent->d_name, strlen(dirent->d_name) }))
+            continue;
+
+        DirectoryEntry entry;
+        entry.type = DirectoryEntry::type_from_dirent_type(dirent->d_type);
+        entry.name = dirent->d_name;
+        entry.inode_index = dirent->d_ino;
+        TRY(entries.try_append(move(entry)));
+    }
+    return entries;
+}
+
+ErrorOr<Vector<DirectoryEntry>> DirectoryEntry::read_all(StringView directory_path, FetchMetadata fetch_metadata, FollowSymlinks follow_symlinks)
+{
+    auto fd = TRY(System::open(directory_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    auto* dir = fdopendir(fd);
+    if (!dir) {
+        auto error = Error::from_errno(errno);
+        (void)System::close(fd);
+        return error;
+    }
+    ScopeGuard close_dir = [dir] { closedir(dir); };
+
+    bool follow = follow_symlinks == FollowSymlinks::Yes;
+    bool wants_metadata = fetch_metadata == FetchMetadata::Yes;
+
+    Vector<DirectoryEntry> entries;
+#ifdef __serenity__
+    if (wants_metadata || follow)
+        entries = TRY(read_all_with_metadata(fd));
+    else
+        entries = TRY(read_all_without_metadata(dir));
+#else
+    entries = TRY(read_all_without_metadata(dir));
+#endif
+
+    for (auto& entry : entries) {
+        // The metadata we may already have is that of the link itself, not of what it points to.
+        bool is_link_to_follow = follow && entry.type == Type::SymbolicLink;
+        bool needs_stat = is_link_to_follow
+            || (!entry.metadata.has_value() && (wants_metadata || entry.type == Type::Unknown));
+        if (!needs_stat)
+            continue;
+
+        // The name is relative to the directory we already have open, so the kernel doesn't have to resolve the whole path again.
+        struct stat metadata;
+        if (fstatat(fd, entry.name.characters(), &metadata, follow ? 0 : AT_SYMLINK_NOFOLLOW) == 0) {
+            entry.metadata = metadata;
+            entry.type = type_from_mode(metadata.st_mode);
+        } else if (is_link_to_follow) {
+            entry.metadata.clear();
+        }
+    }
+    return entries;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace Core {
+
+struct DirectoryEntry {
+    enum class Type {
+        Unknown,
+        BlockDevice,
+        CharacterDevice,
+        Directory,
+        File,
+        NamedPipe,
+        Socket,
+        SymbolicLink,
+    };
+
+    enum class FetchMetadata : bool {
+        No,
+        Yes,
+    };
+
+    enum class FollowSymlinks : bool {
+        No,
+        Yes,
+    };
+
+    Type type { Type::Unknown };
+    String name;
+    ino_t inode_index { 0 };
+    // Only filled in if it was asked for, or if it was needed to find out the type. Stays empty if stat-ing the entry
+    // failed, e.g. because it's a symbolic link that points nowhere.
+    Optional<struct stat> metadata;
+
+    static Type type_from_dirent_type(unsigned char);
+    static Type type_from_mode(mode_t);
+
+    // Reads all entries of a directory, except for `.` and `..`, in the order the file system returns them.
+    // Reading a directory this way only takes a single get_dir_entries syscall, which already gives us the names,
+    // inode indices and types. If metadata is asked for, get_dir_entries_with_metadata hands it out along with the
+    // entries, and only the entries the kernel couldn't look up are stat-ed one by one, as are those of unknown type.
+    // When following symbolic links, links are stat-ed too, and get the type and metadata of what they point to.
+    static ErrorOr<Vector<DirectoryEntry>> read_all(StringView directory_path, FetchMetadata = FetchMetadata::No, FollowSymlinks = FollowSymlinks::No);
+};
+
+}
@@ -37,6 +37,7 @@
 #include <unistd.h>
 
 #ifdef __serenity__
+#    include <sys/epoll.h>
 extern bool s_global_initializers_ran;
 #endif
 
@@ -72,6 +73,51 @@ static thread_local HashTable<Notifier*>* s_notifiers;
 thread_local int EventLoop::s_wake_pipe_fds[2];
 thread_local bool EventLoop::s_wake_pipe_initialized { false };
 
+#ifdef __serenity__
+// On Serenity, notifiers stay registered with an epoll, so that a wakeup costs O(ready fds) instead of O(all fds).
+// Several notifiers may watch the same fd, the epoll is told about the union of their event masks.
+static thread_local int s_epoll_fd { -1 };
+static thread_local HashMap<int, Vector<Notifier*, 1>>* s_notifiers_by_fd;
+
+static u32 epoll_events_for_notifiers(Vector<Notifier*, 1> const& notifiers)
+{
+    u32 events = 0;
+    for (auto* notifier : notifiers) {
+        if (notifier->event_mask() & Notifier::Read)
+            events |= EPOLLIN;
+        if (notifier->event_mask() & Notifier::Write)
+            events |= EPOLLOUT;
+        if (notifier->event_mask() & Notifier::Exceptional)
+            VERIFY_NOT_REACHED();
+    }
+    return events;
+}
+
+static void update_epoll_interest(int fd, int op, u32 events)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(s_epoll_fd, op, fd, &event) < 0) {
+        // NOTE: The fd may have been closed before its notifier was disabled, in which case the kernel already forgot about it.
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: epoll_ctl({}, {}) failed: {}", op, fd, strerror(errno));
+    }
+}
+
+static void initialize_epoll(int wake_pipe_read_fd)
+{
+    if (s_epoll_fd >= 0)
+        close(s_epoll_fd);
+    s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    VERIFY(s_epoll_fd >= 0);
+    update_epoll_interest(wake_pipe_read_fd, EPOLL_CTL_ADD, EPOLLIN);
+
+    if (!s_notifiers_by_fd)
+        s_notifiers_by_fd = new HashMap<int, Vector<Notifier*, 1>>;
+    s_notifiers_by_fd->clear();
+}
+#endif
+
 void EventLoop::initialize_wake_pipes()
 {
     if (!s_wake_pipe_initialized) {
@@ -85,6 +131,11 @@ void EventLoop::initialize_wake_pipes()
 #endif
         VERIFY(rc == 0);
         s_wake_pipe_initialized = true;
+
+#ifdef __serenity__
+        // NOTE: This also runs again in a forked child, which must not share its epoll with the parent.
+        initialize_epoll(s_wake_pipe_fds[0]);
+#endif
     }
 }
 
@@ -671,9 +722,14 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifdef __serenity__
+    epoll_event ready_events[64];
+#else
     fd_set rfds;
     fd_set wfds;
+#endif
 retry:
+#ifndef __serenity__
     FD_ZERO(&rfds);
     FD_ZERO(&wfds);
 
@@ -696,6 +752,7 @@ retry:
         if (notifier->event_mask() & Notifier::Exceptional)
             VERIFY_NOT_REACHED();
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -720,7 +777,19 @@ retry:
     }
 
 try_select_again:
+#ifdef __serenity__
+    // NOTE: Round up, so that we don't wake up just before the next timer and spin.
+    int timeout_ms = should_wait_forever ? -1 : static_cast<int>(min<i64>(static_cast<i64>(timeout.tv_sec) * 1000 + (timeout.tv_usec + 999) / 1000, NumericLimits<int>::max()));
+    int marked_fd_count = epoll_wait(s_epoll_fd, ready_events, array_size(ready_events), timeout_ms);
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (ready_events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
     int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+    bool wake_pipe_is_readable = marked_fd_count > 0 && FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -731,7 +800,7 @@ try_select_again:
         dbgln("Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -789,6 +858,24 @@ try_select_again:
     if (!marked_fd_count)
         return;
 
+#ifdef __serenity__
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto fd = ready_events[i].data.fd;
+        auto it = s_notifiers_by_fd->find(fd);
+        if (it == s_notifiers_by_fd->end())
+            continue;
+        // NOTE: Like select(), report errors and hang-ups as the fd being ready.
+        auto events = ready_events[i].events;
+        bool is_readable = events & (EPOLLIN | EPOLLERR | EPOLLHUP);
+        bool is_writable = events & (EPOLLOUT | EPOLLERR | EPOLLHUP);
+        for (auto* notifier : it->value) {
+            if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
+                post_event(*notifier, make<NotifierReadEvent>(fd));
+            if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
+                post_event(*notifier, make<NotifierWriteEvent>(fd));
+        }
+    }
+#else
     for (auto& notifier : *s_notifiers) {
         if (FD_ISSET(notifier->fd(), &rfds)) {
             if (notifier->event_mask() & Notifier::Event::Read)
@@ -799,6 +886,7 @@ try_select_again:
                 post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
         }
     }
+#endif
 }
 
 bool EventLoopTimer::has_expired(Time const& now) const
@@ -863,12 +951,45 @@ void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
     s_notifiers->set(&notifier);
+#ifdef __serenity__
+    auto& notifiers = s_notifiers_by_fd->ensure(notifier.fd());
+    bool is_new_fd = notifiers.is_empty();
+    if (!notifiers.contains_slow(&notifier))
+        notifiers.append(&notifier);
+    update_epoll_interest(notifier.fd(), is_new_fd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, epoll_events_for_notifiers(notifiers));
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->remove(&notifier);
+    if (s_notifiers->remove(&notifier)) {
+#ifdef __serenity__
+        auto it = s_notifiers_by_fd->find(notifier.fd());
+        VERIFY(it != s_notifiers_by_fd->end());
+        it->value.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+        if (it->value.is_empty()) {
+            s_notifiers_by_fd->remove(it);
+            update_epoll_interest(notifier.fd(), EPOLL_CTL_DEL, 0);
+        } else {
+            update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD, epoll_events_for_notifiers(it->value));
+        }
+#endif
+    }
+}
+
+void EventLoop::notifier_event_mask_changed(Badge<Notifier>, Notifier& notifier)
+{
+#ifdef __serenity__
+    if (!s_notifiers || !s_notifiers->contains(&notifier))
+        return;
+    auto it = s_notifiers_by_fd->find(notifier.fd());
+    VERIFY(it != s_notifiers_by_fd->end());
+    update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD, epoll_events_for_notifiers(it->value));
+#else
+    // NOTE: select() picks up the new event mask by itself the next time we wait.
+    (void)notifier;
+#endif
 }
 
 void EventLoop::wake_current()
@@ -15,6 +15,7 @@ class ConfigFile;
 class CustomEvent;
 class DateTime;
 class DirIterator;
+struct DirectoryEntry;
 class DeferredInvocationContext;
 class ElapsedTimer;
 class Event;
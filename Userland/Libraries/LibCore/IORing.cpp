@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/OwnPtr.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    // NOTE: The kernel rounds the entry count up to a power of two, so make sure we map the whole ring.
+    u32 rounded_entries = 1;
+    while (rounded_entries < entries)
+        rounded_entries <<= 1;
+    auto size = round_up_to_power_of_two(io_ring_mapping_size(rounded_entries), PAGE_SIZE);
+
+    auto data_or_error = System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_FILE | MAP_SHARED, fd, 0);
+    if (data_or_error.is_error()) {
+        (void)System::close(fd);
+        return data_or_error.release_error();
+    }
+    auto* data = static_cast<u8*>(data_or_error.release_value());
+    auto ring = adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, data, size));
+    if (ring.is_error()) {
+        (void)System::munmap(data, size);
+        (void)System::close(fd);
+    }
+    return ring;
+}
+
+IORing::IORing(int fd, u8* data, size_t size)
+    : m_fd(fd)
+    , m_data(data)
+    , m_size(size)
+{
+}
+
+IORing::~IORing()
+{
+    MUST(System::munmap(m_data, m_size));
+    MUST(System::close(m_fd));
+}
+
+bool IORing::try_submit(IORingSubmission const& submission)
+{
+    auto& ring_header = header();
+    auto head = AK::atomic_load(&ring_header.submission_head, AK::memory_order_acquire);
+    auto tail = ring_header.submission_tail;
+    if (tail - head >= ring_header.submission_entries)
+        return false;
+
+    auto* submissions = reinterpret_cast<IORingSubmission*>(m_data + ring_header.submissions_offset);
+    submissions[tail & (ring_header.submission_entries - 1)] = submission;
+    AK::atomic_store(&ring_header.submission_tail, tail + 1, AK::memory_order_release);
+    return true;
+}
+
+bool IORing::try_submit_nop(u64 user_data)
+{
+    IORingSubmission submission {};
+    submission.opcode = IORingOpcode::Nop;
+    submission.user_data = user_data;
+    return try_submit(submission);
+}
+
+bool IORing::try_submit_read(int fd, Bytes buffer, u64 user_data, Optional<u64> offset)
+{
+    IORingSubmission submission {};
+    submission.opcode = offset.has_value() ? IORingOpcode::PRead : IORingOpcode::Read;
+    submission.fd = fd;
+    submission.offset = offset.value_or(0);
+    submission.buffer = reinterpret_cast<FlatPtr>(buffer.data());
+    submission.length = buffer.size();
+    submission.user_data = user_data;
+    return try_submit(submission);
+}
+
+bool IORing::try_submit_write(int fd, ReadonlyBytes buffer, u64 user_data, Optional<u64> offset)
+{
+    IORingSubmission submission {};
+    submission.opcode = offset.has_value() ? IORingOpcode::PWrite : IORingOpcode::Write;
+    submission.fd = fd;
+    submission.offset = offset.value_or(0);
+    submission.buffer = reinterpret_cast<FlatPtr>(buffer.data());
+    submission.length = buffer.size();
+    submission.user_data = user_data;
+    return try_submit(submission);
+}
+
+ErrorOr<size_t> IORing::enter(u32 min_complete)
+{
+    return System::io_ring_enter(m_fd, min_complete);
+}
+
+Optional<IORing::Completion> IORing::take_completion()
+{
+    auto& ring_header = header();
+    auto head = ring_header.completion_head;
+    auto tail = AK::atomic_load(&ring_header.completion_tail, AK::memory_order_acquire);
+    if (head == tail)
+        return {};
+
+    auto const* completions = reinterpret_cast<IORingCompletion const*>(m_data + ring_header.completions_offset);
+    auto const& completion = completions[head & (ring_header.completion_entries - 1)];
+    Completion result { completion.user_data, completion.result };
+    AK::atomic_store(&ring_header.completion_head, head + 1, AK::memory_order_release);
+    return result;
+}
+
+}
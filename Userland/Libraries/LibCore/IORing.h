@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <Kernel/API/IORing.h>
+
+namespace Core {
+
+// A mapped kernel I/O ring. Queue up any number of operations with try_submit_*(), hand them all to the
+// kernel with a single enter(), then drain the results with take_completion().
+// The ring's fd becomes readable when completions are waiting, so it can be watched with a Core::Notifier.
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    struct Completion {
+        u64 user_data { 0 };
+        // The number of bytes transferred, or a negated errno.
+        i64 result { 0 };
+    };
+
+    static ErrorOr<NonnullOwnPtr<IORing>> create(u32 entries);
+    ~IORing();
+
+    int fd() const { return m_fd; }
+
+    // These return false when the submission queue is full, call enter() to make room.
+    bool try_submit_nop(u64 user_data);
+    bool try_submit_read(int fd, Bytes, u64 user_data, Optional<u64> offset = {});
+    bool try_submit_write(int fd, ReadonlyBytes, u64 user_data, Optional<u64> offset = {});
+
+    // Submits everything queued so far and waits until at least `min_complete` completions are available.
+    ErrorOr<size_t> enter(u32 min_complete = 0);
+
+    Optional<Completion> take_completion();
+
+private:
+    IORing(int fd, u8* data, size_t size);
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_data); }
+    bool try_submit(IORingSubmission const&);
+
+    int m_fd { -1 };
+    u8* m_data { nullptr };
+    size_t m_size { 0 };
+};
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <LibCore/MemoryPressureNotifier.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> MemoryPressureNotifier::create()
+{
+    auto fd = TRY(System::open("/dev/memorypressure"sv, O_RDONLY | O_NONBLOCK | O_CLOEXEC));
+    auto level_or_error = read_level(fd);
+    if (level_or_error.is_error()) {
+        (void)System::close(fd);
+        return level_or_error.release_error();
+    }
+
+    auto notifier = Notifier::construct(fd, Notifier::Event::Read);
+    return adopt_nonnull_ref_or_enomem(new (nothrow) MemoryPressureNotifier(move(notifier), level_or_error.value()));
+}
+
+MemoryPressureNotifier::MemoryPressureNotifier(NonnullRefPtr<Notifier> notifier, MemoryPressureLevel level)
+    : m_notifier(move(notifier))
+    , m_level(level)
+{
+    m_notifier->on_ready_to_read = [this] {
+        auto level_or_error = read_level(m_notifier->fd());
+        if (level_or_error.is_error()) {
+            if (level_or_error.error().code() != EAGAIN)
+                dbgln("MemoryPressureNotifier: {}", level_or_error.error());
+            return;
+        }
+        if (level_or_error.value() == m_level)
+            return;
+        m_level = level_or_error.value();
+        if (on_change)
+            on_change(m_level);
+    };
+}
+
+MemoryPressureNotifier::~MemoryPressureNotifier()
+{
+    m_notifier->on_ready_to_read = nullptr;
+    (void)System::close(m_notifier->fd());
+}
+
+ErrorOr<MemoryPressureLevel> MemoryPressureNotifier::read_level(int fd)
+{
+    char buffer[16];
+    auto nread = TRY(System::read(fd, { buffer, sizeof(buffer) }));
+    auto line = StringView { buffer, static_cast<size_t>(nread) }.trim_whitespace();
+    if (line == "normal"sv)
+        return MemoryPressureLevel::Normal;
+    if (line == "low"sv)
+        return MemoryPressureLevel::Low;
+    if (line == "critical"sv)
+        return MemoryPressureLevel::Critical;
+    return Error::from_string_literal("Unknown memory pressure level");
+}
+
+}
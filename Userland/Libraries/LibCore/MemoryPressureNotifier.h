@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <LibCore/Notifier.h>
+
+namespace Core {
+
+enum class MemoryPressureLevel {
+    Normal,
+    Low,
+    Critical,
+};
+
+// Lets a process know when the system is running low on memory, so that caches and the like can shrink
+// before allocations start to fail. See memorypressure(4).
+class MemoryPressureNotifier final : public RefCounted<MemoryPressureNotifier> {
+    AK_MAKE_NONCOPYABLE(MemoryPressureNotifier);
+
+public:
+    // Note: This opens /dev/memorypressure, so call it before dropping the rpath pledge or unveiling.
+    static ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> create();
+    ~MemoryPressureNotifier();
+
+    MemoryPressureLevel level() const { return m_level; }
+
+    Function<void(MemoryPressureLevel)> on_change;
+
+private:
+    MemoryPressureNotifier(NonnullRefPtr<Notifier>, MemoryPressureLevel);
+
+    static ErrorOr<MemoryPressureLevel> read_level(int fd);
+
+    NonnullRefPtr<Notifier> m_notifier;
+    MemoryPressureLevel m_level { MemoryPressureLevel::Normal };
+};
+
+}
@@ -63,6 +63,8 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
         process.amount_shared = process_object.get("amount_shared"sv).to_u32();
         process.amount_dirty_private = process_object.get("amount_dirty_private"sv).to_u32();
         process.amount_clean_inode = process_object.get("amount_clean_inode"sv).to_u32();
+        process.amount_unique = process_object.get("amount_unique"sv).to_u32();
+        process.amount_proportional = process_object.get("amount_proportional"sv).to_u32();
         process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile"sv).to_u32();
         process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile"sv).to_u32();
 
@@ -55,6 +55,8 @@ struct ProcessStatistics {
     size_t amount_shared;
     size_t amount_dirty_private;
     size_t amount_clean_inode;
+    size_t amount_unique;
+    size_t amount_proportional;
     size_t amount_purgeable_volatile;
     size_t amount_purgeable_nonvolatile;
 
@@ -15,10 +15,12 @@
 #include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/NumericLimits.h>
+#include <AK/Optional.h>
 #include <AK/Platform.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Variant.h>
 #include <AK/Weakable.h>
@@ -29,6 +31,11 @@
 #include <sched.h>
 #include <sys/mman.h>
 
+#ifdef __serenity__
+#    include <serenity.h>
+#    include <time.h>
+#endif
+
 namespace Core {
 
 // A circular lock-free queue (or a buffer) with a single producer,
@@ -100,6 +107,7 @@ public:
         auto our_tail = m_queue->m_queue->m_tail.load() % Size;
         m_queue->m_queue->m_data[our_tail] = to_insert;
         m_queue->m_queue->m_tail.fetch_add(1);
+        notify(m_queue->m_queue->m_enqueue_sequence, m_queue->m_queue->m_enqueue_waiters);
 
         return {};
     }
@@ -125,6 +133,22 @@ public:
         return {};
     }
 
+    // Enqueues, sleeping until a consumer has made room if the queue is full.
+    // Unlike polling with try_blocking_enqueue(), this wakes up as soon as something was dequeued.
+    // If a timeout is given, gives up with QueueStatus::Full once it expires.
+    ErrorOr<void, QueueStatus> blocking_enqueue(ValueType to_insert, Optional<Time> timeout = {})
+    {
+        VERIFY(!m_queue.is_null());
+        while (true) {
+            auto sequence = m_queue->m_queue->m_dequeue_sequence.load();
+            auto result = try_enqueue(to_insert);
+            if (!result.is_error() || result.error() != QueueStatus::Full)
+                return result;
+            if (!wait(m_queue->m_queue->m_dequeue_sequence, m_queue->m_queue->m_dequeue_waiters, sequence, timeout))
+                return QueueStatus::Full;
+        }
+    }
+
     ErrorOr<ValueType, QueueStatus> try_dequeue()
     {
         VERIFY(!m_queue.is_null());
@@ -141,11 +165,27 @@ public:
                 auto data = move(m_queue->m_queue->m_data[old_head % Size]);
                 m_queue->m_queue->m_head.fetch_add(1);
                 m_queue->m_queue->m_head_protector.store(NumericLimits<size_t>::max(), AK::MemoryOrder::memory_order_release);
+                notify(m_queue->m_queue->m_dequeue_sequence, m_queue->m_queue->m_dequeue_waiters);
                 return { move(data) };
             }
         }
     }
 
+    // Dequeues, sleeping until the producer has enqueued something if the queue is empty.
+    // If a timeout is given, gives up with QueueStatus::Empty once it expires.
+    ErrorOr<ValueType, QueueStatus> blocking_dequeue(Optional<Time> timeout = {})
+    {
+        VERIFY(!m_queue.is_null());
+        while (true) {
+            auto sequence = m_queue->m_queue->m_enqueue_sequence.load();
+            auto result = try_dequeue();
+            if (!result.is_error() || result.error() != QueueStatus::Empty)
+                return result;
+            if (!wait(m_queue->m_queue->m_enqueue_sequence, m_queue->m_queue->m_enqueue_waiters, sequence, timeout))
+                return QueueStatus::Empty;
+        }
+    }
+
     // The "real" head as seen by the outside world. Don't use m_head directly unless you know what you're doing.
     size_t head() const
     {
@@ -173,9 +213,52 @@ private:
         AK_CACHE_ALIGNED Atomic<size_t, AK::MemoryOrder::memory_order_seq_cst> m_head { 0 };
         AK_CACHE_ALIGNED Atomic<size_t, AK::MemoryOrder::memory_order_seq_cst> m_head_protector { NumericLimits<size_t>::max() };
 
+        // These are bumped after every enqueue and dequeue respectively, so that blocking_enqueue() and blocking_dequeue()
+        // can sleep on them with a futex. The waiter counts let the other side skip the wake syscall if nobody is sleeping.
+        AK_CACHE_ALIGNED Atomic<u32, AK::MemoryOrder::memory_order_seq_cst> m_enqueue_sequence { 0 };
+        Atomic<u32, AK::MemoryOrder::memory_order_seq_cst> m_enqueue_waiters { 0 };
+        AK_CACHE_ALIGNED Atomic<u32, AK::MemoryOrder::memory_order_seq_cst> m_dequeue_sequence { 0 };
+        Atomic<u32, AK::MemoryOrder::memory_order_seq_cst> m_dequeue_waiters { 0 };
+
         alignas(ValueType) Array<ValueType, Size> m_data;
     };
 
+    using Sequence = Atomic<u32, AK::MemoryOrder::memory_order_seq_cst>;
+
+    static void notify(Sequence& sequence, Sequence& waiters)
+    {
+        sequence.fetch_add(1);
+        // A waiter registers itself before checking the sequence again, so either we see it here,
+        // or it sees the new sequence number and doesn't go to sleep.
+        if (waiters.load() == 0)
+            return;
+#ifdef __serenity__
+        futex_wake(const_cast<u32*>(sequence.ptr()), NumericLimits<u32>::max(), true);
+#endif
+    }
+
+    // Returns false if the timeout expired before the sequence changed.
+    static bool wait(Sequence& sequence, Sequence& waiters, u32 old_sequence, Optional<Time> timeout)
+    {
+        auto deadline = timeout.has_value() ? Time::now_monotonic() + *timeout : Time::max();
+        waiters.fetch_add(1);
+        while (sequence.load() == old_sequence) {
+            if (timeout.has_value() && Time::now_monotonic() >= deadline) {
+                waiters.fetch_sub(1);
+                return false;
+            }
+#ifdef __serenity__
+            // The queue lives in memory that's shared between processes, so this can't be a private futex.
+            auto deadline_timespec = deadline.to_timespec();
+            futex_wait(const_cast<u32*>(sequence.ptr()), old_sequence, timeout.has_value() ? &deadline_timespec : nullptr, CLOCK_MONOTONIC, true);
+#else
+            sched_yield();
+#endif
+        }
+        waiters.fetch_sub(1);
+        return true;
+    }
+
     class RefCountedSharedMemorySPCQ : public RefCounted<RefCountedSharedMemorySPCQ> {
         friend class SharedSingleProducerCircularQueue;
 
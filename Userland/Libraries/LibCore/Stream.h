@@ -12,6 +12,7 @@
 #include <AK/IPv4Address.h>
 #include <AK/MemMem.h>
 #include <AK/Noncopyable.h>
+#include <AK/NumericLimits.h>
 #include <AK/Result.h>
 #include <AK/Span.h>
 #include <AK/String.h>
@@ -313,6 +314,9 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    // NOTE: This is meant for syscalls that write to the socket directly, like sendfile().
+    int fd() const { return m_helper.fd(); }
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -388,6 +392,9 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    // NOTE: This is meant for waiting on several sockets at once with poll().
+    int fd() const { return m_helper.fd(); }
+
     virtual ~UDPSocket() override { close(); }
 
 private:
@@ -458,6 +465,9 @@ public:
     /// already closed.
     ErrorOr<int> release_fd();
 
+    // NOTE: This is meant for waiting on the socket from outside, like Core::wait_until_readable() does.
+    int fd() const { return m_helper.fd(); }
+
     virtual ~LocalSocket() { close(); }
 
 private:
@@ -501,6 +511,7 @@ public:
     BufferedHelper(BufferedHelper&& other)
         : m_stream(move(other.m_stream))
         , m_buffer(move(other.m_buffer))
+        , m_buffer_start(exchange(other.m_buffer_start, 0))
         , m_buffered_size(exchange(other.m_buffered_size, 0))
     {
     }
@@ -509,6 +520,7 @@ public:
     {
         m_stream = move(other.m_stream);
         m_buffer = move(other.m_buffer);
+        m_buffer_start = exchange(other.m_buffer_start, 0);
         m_buffered_size = exchange(other.m_buffered_size, 0);
         return *this;
     }
@@ -536,29 +548,20 @@ public:
         if (!buffer.size())
             return Error::from_errno(ENOBUFS);
 
+        // Reads that are at least as large as our buffer would only be copied through it, so they go straight to the stream.
+        if (m_buffered_size == 0 && buffer.size() >= m_buffer.size())
+            return buffer.slice(0, TRY(read_from_stream(buffer)));
+
         // Fill the internal buffer if it has run dry.
         if (m_buffered_size == 0)
             TRY(populate_read_buffer());
 
         // Let's try to take all we can from the buffer first.
-        size_t buffer_nread = 0;
-        if (m_buffered_size > 0) {
-            // FIXME: Use a circular buffer to avoid shifting the buffer
-            //        contents.
-            size_t amount_to_take = min(buffer.size(), m_buffered_size);
-            auto slice_to_take = m_buffer.span().slice(0, amount_to_take);
-            auto slice_to_shift = m_buffer.span().slice(amount_to_take);
-
-            slice_to_take.copy_to(buffer);
-            buffer_nread += amount_to_take;
+        auto slice_to_take = buffered_data().trim(buffer.size());
+        slice_to_take.copy_to(buffer);
+        discard(slice_to_take.size());
 
-            if (amount_to_take < m_buffered_size) {
-                m_buffer.overwrite(0, slice_to_shift.data(), m_buffered_size - amount_to_take);
-            }
-            m_buffered_size -= amount_to_take;
-        }
-
-        return Bytes { buffer.data(), buffer_nread };
+        return Bytes { buffer.data(), slice_to_take.size() };
     }
 
     // Reads into the buffer until \n is encountered.
@@ -577,74 +580,44 @@ public:
     template<size_t N>
     ErrorOr<Bytes> read_until_any_of(Bytes buffer, Array<StringView, N> candidates)
     {
-        if (!stream().is_open())
-            return Error::from_errno(ENOTCONN);
-
         if (buffer.is_empty())
             return Error::from_errno(ENOBUFS);
 
-        // We fill the buffer through can_read_line.
-        if (!TRY(can_read_line()))
-            return Bytes {};
-
-        if (stream().is_eof()) {
-            if (buffer.size() < m_buffered_size) {
-                // Normally, reading from an EOFed stream and receiving bytes
-                // would mean that the stream is no longer EOF. However, it's
-                // possible with a buffered stream that the user is able to read
-                // the buffer contents even when the underlying stream is EOF.
-                // We already violate this invariant once by giving the user the
-                // chance to read the remaining buffer contents, but if the user
-                // doesn't give us a big enough buffer, then we would be
-                // violating the invariant twice the next time the user attempts
-                // to read, which is No Good. So let's give a descriptive error
-                // to the caller about why it can't read.
-                return Error::from_errno(EMSGSIZE);
-            }
-        }
-
-        // The intention here is to try to match all of the possible
-        // delimiter candidates and try to find the longest one we can
-        // remove from the buffer after copying up to the delimiter to the
-        // user buffer.
-        Optional<size_t> longest_match;
-        size_t match_size = 0;
-        for (auto& candidate : candidates) {
-            auto result = AK::memmem_optional(m_buffer.data(), m_buffered_size, candidate.bytes().data(), candidate.bytes().size());
-            if (result.has_value()) {
-                auto previous_match = longest_match.value_or(*result);
-                if ((previous_match < *result) || (previous_match == *result && match_size < candidate.length())) {
-                    longest_match = result;
-                    match_size = candidate.length();
-                }
-            }
-        }
-        if (longest_match.has_value()) {
-            auto size_written_to_user_buffer = *longest_match;
-            auto buffer_to_take = m_buffer.span().slice(0, size_written_to_user_buffer);
-            auto buffer_to_shift = m_buffer.span().slice(size_written_to_user_buffer + match_size);
-
-            buffer_to_take.copy_to(buffer);
-            m_buffer.overwrite(0, buffer_to_shift.data(), buffer_to_shift.size());
-
-            m_buffered_size -= size_written_to_user_buffer + match_size;
-
-            return buffer.slice(0, size_written_to_user_buffer);
-        }
+        auto taken = TRY(take_until_any_of(candidates.span(), buffer.size()));
+        taken.copy_to(buffer);
+        return buffer.slice(0, taken.size());
+    }
 
-        // If we still haven't found anything, then it's most likely the case
-        // that the delimiter ends beyond the length of the caller-passed
-        // buffer. Let's just fill the caller's buffer up.
-        auto readable_size = min(m_buffered_size, buffer.size());
-        auto buffer_to_take = m_buffer.span().slice(0, readable_size);
-        auto buffer_to_shift = m_buffer.span().slice(readable_size);
+    // These work like read_line() and read_until(), but return a view into the internal buffer instead of copying
+    // into a caller-provided one. The view stays valid until the next read from this stream.
+    ErrorOr<StringView> read_line_in_place(size_t max_size = NumericLimits<size_t>::max())
+    {
+        return StringView { TRY(read_until_in_place("\n"sv, max_size)) };
+    }
 
-        buffer_to_take.copy_to(buffer);
-        m_buffer.overwrite(0, buffer_to_shift.data(), buffer_to_shift.size());
+    ErrorOr<ReadonlyBytes> read_until_in_place(StringView candidate, size_t max_size = NumericLimits<size_t>::max())
+    {
+        Array candidates { candidate };
+        return take_until_any_of(candidates.span(), max_size);
+    }
 
-        m_buffered_size -= readable_size;
+    // Returns what's buffered without consuming it, filling the buffer first if it's empty.
+    // The view stays valid until the next read from this stream.
+    ErrorOr<ReadonlyBytes> peek_some()
+    {
+        if (m_buffered_size == 0)
+            TRY(populate_read_buffer());
+        return buffered_data();
+    }
 
-        return buffer.slice(0, readable_size);
+    // Consumes bytes that were looked at with peek_some().
+    void discard(size_t count)
+    {
+        VERIFY(count <= m_buffered_size);
+        m_buffer_start += count;
+        m_buffered_size -= count;
+        if (m_buffered_size == 0)
+            m_buffer_start = 0;
     }
 
     // Returns whether a line can be read, populating the buffer in the process.
@@ -653,7 +626,7 @@ public:
         if (stream().is_eof() && m_buffered_size > 0)
             return true;
 
-        if (m_buffer.span().slice(0, m_buffered_size).contains_slow('\n'))
+        if (buffered_data().contains_slow('\n'))
             return true;
 
         if (!stream().is_readable())
@@ -699,45 +672,110 @@ public:
 
     void clear_buffer()
     {
+        m_buffer_start = 0;
         m_buffered_size = 0;
     }
 
 private:
-    ErrorOr<ReadonlyBytes> populate_read_buffer()
+    ReadonlyBytes buffered_data() const { return m_buffer.span().slice(m_buffer_start, m_buffered_size); }
+
+    // Finds the first of the candidates in the buffer, and consumes everything up to and including it.
+    // Returns the bytes before the delimiter, as a view into the buffer.
+    ErrorOr<ReadonlyBytes> take_until_any_of(Span<StringView const> candidates, size_t max_size)
     {
-        if (m_buffered_size == m_buffer.size())
+        if (!stream().is_open())
+            return Error::from_errno(ENOTCONN);
+
+        // We fill the buffer through can_read_line.
+        if (!TRY(can_read_line()))
             return ReadonlyBytes {};
 
-        auto fillable_slice = m_buffer.span().slice(m_buffered_size);
-        size_t nread = 0;
-        do {
-            auto result = stream().read(fillable_slice);
+        if (stream().is_eof()) {
+            if (max_size < m_buffered_size) {
+                // Normally, reading from an EOFed stream and receiving bytes
+                // would mean that the stream is no longer EOF. However, it's
+                // possible with a buffered stream that the user is able to read
+                // the buffer contents even when the underlying stream is EOF.
+                // We already violate this invariant once by giving the user the
+                // chance to read the remaining buffer contents, but if the user
+                // doesn't give us a big enough buffer, then we would be
+                // violating the invariant twice the next time the user attempts
+                // to read, which is No Good. So let's give a descriptive error
+                // to the caller about why it can't read.
+                return Error::from_errno(EMSGSIZE);
+            }
+        }
+
+        // The intention here is to try to match all of the possible
+        // delimiter candidates and try to find the longest one we can
+        // remove from the buffer after returning everything up to the
+        // delimiter.
+        auto data = buffered_data();
+        Optional<size_t> longest_match;
+        size_t match_size = 0;
+        for (auto& candidate : candidates) {
+            auto result = AK::memmem_optional(data.data(), data.size(), candidate.bytes().data(), candidate.bytes().size());
+            if (result.has_value()) {
+                auto previous_match = longest_match.value_or(*result);
+                if ((previous_match < *result) || (previous_match == *result && match_size < candidate.length())) {
+                    longest_match = result;
+                    match_size = candidate.length();
+                }
+            }
+        }
+        if (longest_match.has_value() && *longest_match <= max_size) {
+            discard(*longest_match + match_size);
+            return data.slice(0, *longest_match);
+        }
+
+        // If we still haven't found anything, then it's most likely the case
+        // that the delimiter ends beyond the length of the caller-passed
+        // buffer. Let's just fill the caller's buffer up.
+        auto readable_size = min(m_buffered_size, max_size);
+        discard(readable_size);
+        return data.slice(0, readable_size);
+    }
+
+    // Reads from the stream, retrying on EINTR and treating EAGAIN as having read nothing.
+    ErrorOr<size_t> read_from_stream(Bytes buffer)
+    {
+        while (true) {
+            auto result = stream().read(buffer);
             if (result.is_error()) {
                 if (!result.error().is_errno())
-                    return result.error();
+                    return result.release_error();
                 if (result.error().code() == EINTR)
                     continue;
                 if (result.error().code() == EAGAIN)
-                    break;
-                return result.error();
+                    return 0;
+                return result.release_error();
             }
-            auto read_size = result.value().size();
-            m_buffered_size += read_size;
-            nread += read_size;
-            break;
-        } while (true);
+            return result.value().size();
+        }
+    }
+
+    ErrorOr<ReadonlyBytes> populate_read_buffer()
+    {
+        // Consuming data only moves the start of the buffered data forward, so it's moved back to the front
+        // here, once we run out of room behind it.
+        if (m_buffer_start + m_buffered_size == m_buffer.size() && m_buffer_start > 0) {
+            m_buffer.overwrite(0, m_buffer.data() + m_buffer_start, m_buffered_size);
+            m_buffer_start = 0;
+        }
+
+        if (m_buffer_start + m_buffered_size == m_buffer.size())
+            return ReadonlyBytes {};
+
+        auto fillable_slice = m_buffer.span().slice(m_buffer_start + m_buffered_size);
+        auto nread = TRY(read_from_stream(fillable_slice));
+        m_buffered_size += nread;
         return fillable_slice.slice(0, nread);
     }
 
     NonnullOwnPtr<T> m_stream;
-    // FIXME: Replacing this with a circular buffer would be really nice and
-    //        would avoid excessive copies; however, right now
-    //        AK::CircularDuplexBuffer inlines its entire contents, and that
-    //        would make for a very large object on the stack.
-    //
-    //        The proper fix is to make a CircularQueue which uses a buffer on
-    //        the heap.
     ByteBuffer m_buffer;
+    // The buffered data is the m_buffered_size bytes of m_buffer starting at m_buffer_start.
+    size_t m_buffer_start { 0 };
     size_t m_buffered_size { 0 };
 };
 
@@ -780,6 +818,10 @@ public:
     template<size_t N>
     ErrorOr<Bytes> read_until_any_of(Bytes buffer, Array<StringView, N> candidates) { return m_helper.read_until_any_of(move(buffer), move(candidates)); }
     ErrorOr<bool> can_read_line() { return m_helper.can_read_line(); }
+    ErrorOr<StringView> read_line_in_place(size_t max_size = NumericLimits<size_t>::max()) { return m_helper.read_line_in_place(max_size); }
+    ErrorOr<ReadonlyBytes> read_until_in_place(StringView candidate, size_t max_size = NumericLimits<size_t>::max()) { return m_helper.read_until_in_place(candidate, max_size); }
+    ErrorOr<ReadonlyBytes> peek_some() { return m_helper.peek_some(); }
+    void discard(size_t count) { m_helper.discard(count); }
 
     size_t buffer_size() const { return m_helper.buffer_size(); }
 
@@ -799,6 +841,10 @@ public:
     virtual ErrorOr<StringView> read_line(Bytes buffer) = 0;
     virtual ErrorOr<Bytes> read_until(Bytes buffer, StringView candidate) = 0;
     virtual ErrorOr<bool> can_read_line() = 0;
+    virtual ErrorOr<StringView> read_line_in_place(size_t max_size = NumericLimits<size_t>::max()) = 0;
+    virtual ErrorOr<ReadonlyBytes> read_until_in_place(StringView candidate, size_t max_size = NumericLimits<size_t>::max()) = 0;
+    virtual ErrorOr<ReadonlyBytes> peek_some() = 0;
+    virtual void discard(size_t count) = 0;
     virtual size_t buffer_size() const = 0;
 };
 
@@ -849,9 +895,16 @@ public:
     template<size_t N>
     ErrorOr<Bytes> read_until_any_of(Bytes buffer, Array<StringView, N> candidates) { return m_helper.read_until_any_of(move(buffer), move(candidates)); }
     virtual ErrorOr<bool> can_read_line() override { return m_helper.can_read_line(); }
+    virtual ErrorOr<StringView> read_line_in_place(size_t max_size = NumericLimits<size_t>::max()) override { return m_helper.read_line_in_place(max_size); }
+    virtual ErrorOr<ReadonlyBytes> read_until_in_place(StringView candidate, size_t max_size = NumericLimits<size_t>::max()) override { return m_helper.read_until_in_place(candidate, max_size); }
+    virtual ErrorOr<ReadonlyBytes> peek_some() override { return m_helper.peek_some(); }
+    virtual void discard(size_t count) override { m_helper.discard(count); }
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    // NOTE: Only writes may bypass the buffer this way, as reads have to go through it.
+    int fd() const { return m_helper.stream().fd(); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
@@ -184,6 +184,31 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<int> io_ring_create(u32 entries, int flags)
+{
+    int rc = syscall(SC_io_ring_create, entries, flags);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_create", rc, rc);
+}
+
+ErrorOr<size_t> io_ring_enter(int fd, u32 min_complete)
+{
+    int rc = syscall(SC_io_ring_enter, fd, min_complete);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_enter", rc, static_cast<size_t>(rc));
+}
+
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    Syscall::SC_sendfile_params params { out_fd, in_fd, offset, count };
+    int rc = syscall(SC_sendfile, &params);
+    HANDLE_SYSCALL_RETURN_VALUE("sendfile", rc, static_cast<size_t>(rc));
+}
+
+ErrorOr<size_t> get_dir_entries_with_metadata(int fd, Bytes buffer)
+{
+    int rc = syscall(SC_get_dir_entries_with_metadata, fd, buffer.data(), buffer.size());
+    HANDLE_SYSCALL_RETURN_VALUE("get_dir_entries_with_metadata", rc, static_cast<size_t>(rc));
+}
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -47,6 +47,10 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<int> io_ring_create(u32 entries, int flags);
+ErrorOr<size_t> io_ring_enter(int fd, u32 min_complete);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+ErrorOr<size_t> get_dir_entries_with_metadata(int fd, Bytes buffer);
 #else
 inline ErrorOr<void> unveil(StringView, StringView)
 {
@@ -138,10 +138,15 @@ Optional<FlatPtr> Reader::peek_memory(FlatPtr address) const
     if (!region.has_value())
         return {};
 
-    FlatPtr offset_in_region = address - region->region_start;
-    auto* region_data = bit_cast<u8 const*>(image().program_header(region->program_header_index).raw_data());
+    // NOTE: The kernel leaves out the parts of a region that are all zeroes at either end, as well as the contents of
+    //       file-backed regions that were never writable. We can't tell those apart, so we don't know either.
+    auto program_header = image().program_header(region->program_header_index);
+    auto segment_start = program_header.vaddr().get();
+    if (address < segment_start || address - segment_start + sizeof(FlatPtr) > program_header.size_in_image())
+        return {};
+
     FlatPtr value { 0 };
-    ByteReader::load(region_data + offset_in_region, value);
+    ByteReader::load(bit_cast<u8 const*>(program_header.raw_data()) + (address - segment_start), value);
     return value;
 }
 
@@ -37,6 +37,52 @@ NonnullRefPtr<TranslationUnit> Parser::parse()
     return unit;
 }
 
+NonnullRefPtr<TranslationUnit> Parser::parse_incrementally(Parser const& previous)
+{
+    LOG_SCOPE();
+    auto previous_root = previous.root_node();
+    if (m_tokens.is_empty() || !previous_root)
+        return parse();
+
+    auto is_same_token = [](Token const& a, Token const& b) {
+        return a.type() == b.type() && a.start() == b.start() && a.end() == b.end() && a.text() == b.text();
+    };
+
+    auto const& previous_tokens = previous.tokens();
+    size_t unchanged_token_count = 0;
+    while (unchanged_token_count < min(m_tokens.size(), previous_tokens.size()) && is_same_token(m_tokens[unchanged_token_count], previous_tokens[unchanged_token_count]))
+        ++unchanged_token_count;
+
+    auto unit = create_root_ast_node(m_tokens.first().start(), m_tokens.last().end());
+
+    // A declaration is parsed the same way again if its own tokens and the one after it, which the parser looks at to
+    // see that the declaration is over, are unchanged.
+    NonnullRefPtrVector<Declaration> declarations;
+    auto previous_declarations = previous_root->declarations();
+    for (size_t i = 0; i < previous_declarations.size(); ++i) {
+        auto end_token_index = previous.m_declaration_end_token_indices[i];
+        if (end_token_index >= unchanged_token_count)
+            break;
+        auto& declaration = previous_declarations[i];
+        declaration.set_parent(*unit);
+        declarations.append(declaration);
+        m_declaration_end_token_indices.append(end_token_index);
+        m_state.token_index = end_token_index;
+    }
+    m_reused_declaration_count = declarations.size();
+
+    if (!declarations.is_empty()) {
+        for (auto& node : previous.m_nodes) {
+            if (&node != previous_root.ptr() && (eof() || node.start() < peek().start()))
+                m_nodes.append(node);
+        }
+    }
+
+    declarations.extend(parse_declarations_in_translation_unit(*unit));
+    unit->set_declarations(move(declarations));
+    return unit;
+}
+
 NonnullRefPtrVector<Declaration> Parser::parse_declarations_in_translation_unit(ASTNode& parent)
 {
     NonnullRefPtrVector<Declaration> declarations;
@@ -44,6 +90,7 @@ NonnullRefPtrVector<Declaration> Parser::parse_declarations_in_translation_unit(
         auto declaration = parse_single_declaration_in_translation_unit(parent);
         if (declaration) {
             declarations.append(declaration.release_nonnull());
+            m_declaration_end_token_indices.append(m_state.token_index);
         } else {
             error("unexpected token"sv);
             consume();
@@ -23,6 +23,14 @@ public:
     ~Parser() = default;
 
     NonnullRefPtr<TranslationUnit> parse();
+
+    // Parses the tokens of a new version of a document, taking the top-level declarations that are followed by
+    // unchanged tokens from the parse of its previous version instead of parsing them again.
+    // NOTE: The reused nodes point into the text and the preprocessor of the previous version,
+    //       so those have to outlive this parser.
+    NonnullRefPtr<TranslationUnit> parse_incrementally(Parser const& previous);
+    size_t reused_declaration_count() const { return m_reused_declaration_count; }
+
     bool eof() const;
 
     RefPtr<ASTNode> node_at(Position) const;
@@ -192,6 +200,9 @@ private:
     RefPtr<TranslationUnit> m_root_node;
     Vector<String> m_errors;
     NonnullRefPtrVector<ASTNode> m_nodes;
+    // For every top-level declaration, the index of the first token after it.
+    Vector<size_t> m_declaration_end_token_indices;
+    size_t m_reused_declaration_count { 0 };
 };
 
 }
@@ -6,43 +6,123 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BuiltinWrappers.h>
 
 namespace Crypto {
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N * M) where N is the number of words in the quotient and M the number of words in the denominator
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * Knuth's Algorithm D (The Art of Computer Programming, Volume 2, 4.3.1), as written in "Hacker's Delight".
+ * Both numbers are shifted left until the top bit of the denominator is set. Then, from the most significant one,
+ * each word of the quotient is estimated from the top two words of what's left of the numerator and the top word
+ * of the denominator. The estimate is off by at most 2, which one more word of the denominator narrows down to 1,
+ * and that is fixed up by adding the denominator back if the subtraction went negative.
+ * The quotient and the remainder may be the same integer as the numerator or the denominator.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+    VERIFY(denominator_length > 0);
+
+    if (numerator_length < denominator_length) {
+        remainder.set_to(numerator);
+        quotient.set_to(0);
+        return;
+    }
+
+    if (denominator_length == 1) {
+        DoubleWord divisor = denominator.m_words[0];
+        DoubleWord remainder_word = 0;
+        temp_scratch.set_to_0();
+        temp_scratch.m_words.resize_and_keep_capacity(numerator_length);
+        for (size_t i = numerator_length; i-- > 0;) {
+            auto dividend = (remainder_word << bits_in_word) | numerator.m_words[i];
+            temp_scratch.m_words[i] = static_cast<Word>(dividend / divisor);
+            remainder_word = dividend % divisor;
+        }
+        quotient.set_to(temp_scratch);
+        remainder.set_to(static_cast<Word>(remainder_word));
+        return;
+    }
+
+    // The scratch space holds the normalized numerator, with an extra word on top, followed by the normalized denominator.
+    temp_scratch.set_to_0();
+    temp_scratch.m_words.resize_and_keep_capacity(numerator_length + 1 + denominator_length);
+    auto* u = temp_scratch.m_words.data();
+    auto* v = u + numerator_length + 1;
+
+    auto shift = count_leading_zeroes(denominator.m_words[denominator_length - 1]);
+    auto shift_left_word = [&](Word high, Word low) -> Word {
+        return shift == 0 ? high : (high << shift) | (low >> (bits_in_word - shift));
+    };
+    for (size_t i = denominator_length - 1; i > 0; --i)
+        v[i] = shift_left_word(denominator.m_words[i], denominator.m_words[i - 1]);
+    v[0] = denominator.m_words[0] << shift;
+    u[numerator_length] = shift_left_word(0, numerator.m_words[numerator_length - 1]);
+    for (size_t i = numerator_length - 1; i > 0; --i)
+        u[i] = shift_left_word(numerator.m_words[i], numerator.m_words[i - 1]);
+    u[0] = numerator.m_words[0] << shift;
+
+    auto quotient_length = numerator_length - denominator_length + 1;
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(quotient_length);
+
+    constexpr DoubleWord base = 1ull << bits_in_word;
+    auto const top_word = v[denominator_length - 1];
+    auto const second_word = v[denominator_length - 2];
+    for (size_t j = quotient_length; j-- > 0;) {
+        auto* window = u + j;
+        auto dividend = (static_cast<DoubleWord>(window[denominator_length]) << bits_in_word) | window[denominator_length - 1];
+        auto estimate = dividend / top_word;
+        auto estimate_remainder = dividend % top_word;
+        while (estimate >= base || estimate * second_word > ((estimate_remainder << bits_in_word) | window[denominator_length - 2])) {
+            --estimate;
+            estimate_remainder += top_word;
+            if (estimate_remainder >= base)
+                break;
+        }
+
+        // window -= estimate * v
+        i64 borrow = 0;
+        for (size_t i = 0; i < denominator_length; ++i) {
+            auto product = estimate * v[i];
+            i64 difference = static_cast<i64>(window[i]) - borrow - static_cast<i64>(product & (base - 1));
+            window[i] = static_cast<Word>(difference);
+            borrow = static_cast<i64>(product >> bits_in_word) - (difference >> bits_in_word);
+        }
+        i64 top = static_cast<i64>(window[denominator_length]) - borrow;
+        window[denominator_length] = static_cast<Word>(top);
+
+        if (top < 0) {
+            // The estimate was one too large, so add the denominator back.
+            --estimate;
+            DoubleWord carry = 0;
+            for (size_t i = 0; i < denominator_length; ++i) {
+                auto sum = static_cast<DoubleWord>(window[i]) + v[i] + carry;
+                window[i] = static_cast<Word>(sum);
+                carry = sum >> bits_in_word;
             }
+            window[denominator_length] += static_cast<Word>(carry);
         }
+        quotient.m_words[j] = static_cast<Word>(estimate);
     }
+
+    // What's left of the numerator is the remainder, still shifted left.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i)
+        remainder.m_words[i] = shift == 0 ? u[i] : (u[i] >> shift) | (u[i + 1] << (bits_in_word - shift));
 }
 
 /**
@@ -13,10 +13,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     UnsignedBigInteger& ep,
     UnsignedBigInteger& base,
     UnsignedBigInteger const& m,
-    UnsignedBigInteger& temp_1,
-    UnsignedBigInteger& temp_2,
-    UnsignedBigInteger& temp_3,
-    UnsignedBigInteger& temp_4,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& temp_multiply,
     UnsignedBigInteger& temp_quotient,
     UnsignedBigInteger& temp_remainder,
@@ -26,8 +23,8 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     while (!(ep < 1)) {
         if (ep.words()[0] % 2 == 1) {
             // exp = (exp * base) % m;
-            multiply_without_allocation(exp, base, temp_1, temp_2, temp_3, temp_multiply);
-            divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+            multiply_without_allocation(exp, base, temp_scratch, temp_multiply);
+            divide_without_allocation(temp_multiply, m, temp_scratch, temp_quotient, temp_remainder);
             exp.set_to(temp_remainder);
         }
 
@@ -36,8 +33,8 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
         ep.set_to(temp_quotient);
 
         // base = (base * base) % m;
-        multiply_without_allocation(base, base, temp_1, temp_2, temp_3, temp_multiply);
-        divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+        multiply_without_allocation(base, base, temp_scratch, temp_multiply);
+        divide_without_allocation(temp_multiply, m, temp_scratch, temp_quotient, temp_remainder);
         base.set_to(temp_remainder);
 
         // Note that not clamping here would cause future calculations (multiply, specifically) to allocate even more unused space
@@ -70,44 +67,20 @@ ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
     return static_cast<u32>(-k0);
 }
 
-/**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
- */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
 /**
  * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
  * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
+UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger::Word* z, UnsignedBigInteger::Word const* x, UnsignedBigInteger::Word y_digit, size_t num_words)
 {
-    UnsignedBigInteger::Word carry { 0 };
+    // NOTE: x[i] * y_digit + z[i] + carry is at most (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1, so it always fits in a u64.
+    u64 carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
+        u64 result = static_cast<u64>(x[i]) * y_digit + z[i] + carry;
+        z[i] = static_cast<UnsignedBigInteger::Word>(result);
+        carry = result >> UnsignedBigInteger::BITS_IN_WORD;
     }
-    return carry;
+    return static_cast<UnsignedBigInteger::Word>(carry);
 }
 
 /**
@@ -134,19 +107,25 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     z.set_to(0);
     z.resize_with_leading_zeros(num_words * 2);
 
+    // NOTE: This goes through the words directly, as the bounds checks of Vector would take up a good part of the time otherwise.
+    auto* z_words = z.m_words.data();
+    auto const* x_words = x.m_words.data();
+    auto const* y_words = y.m_words.data();
+    auto const* modulo_words = modulo.m_words.data();
+
     UnsignedBigInteger::Word previous_double_carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
         // z[i->num_words+i] += x * y_i
-        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z, i, x, y.m_words[i], num_words);
+        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z_words + i, x_words, y_words[i], num_words);
         // z[i->num_words+i] += modulo * (z_i * k)
-        UnsignedBigInteger::Word t = z.m_words[i] * k;
-        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z, i, modulo, t, num_words);
+        UnsignedBigInteger::Word t = z_words[i] * k;
+        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z_words + i, modulo_words, t, num_words);
 
         // Compute the carry by combining all of the carries of the previous computations
         // Put it "right after" the range that we computed above
         UnsignedBigInteger::Word temp_carry = previous_double_carry + carry_1;
         UnsignedBigInteger::Word overall_carry = temp_carry + carry_2;
-        z.m_words[num_words + i] = overall_carry;
+        z_words[num_words + i] = overall_carry;
 
         // Detect if there was a "double carry" for this word by checking if our carry results are smaller than their components
         previous_double_carry = (temp_carry < carry_1 || overall_carry < carry_2) ? 1 : 0;
@@ -164,10 +143,10 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     // (With carry, of course.)
     UnsignedBigInteger::Word c { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
-        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
+        UnsignedBigInteger::Word z_digit = z_words[num_words + i];
+        UnsignedBigInteger::Word modulo_digit = modulo_words[i];
         UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
-        z.m_words[i] = new_z_digit;
+        z_words[i] = new_z_digit;
         // Detect if the subtraction underflowed - from "Hacker's Delight"
         c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
     }
@@ -197,9 +176,13 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
+    // The exponent is scanned with a sliding window: runs of zero bits only cost squarings, and every window
+    // starts and ends with a set bit, so only the odd powers of x have to be precomputed.
+    // Larger windows need fewer multiplications, but take longer to precompute, so they only pay off for longer exponents.
+    constexpr size_t max_window_size = 6;
+    size_t exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    size_t window_size = exponent_bits > 671 ? 6 : exponent_bits > 239 ? 5 : exponent_bits > 79 ? 4 : exponent_bits > 23 ? 3 : 1;
+    VERIFY(window_size <= max_window_size);
 
     size_t num_words = modulo.trimmed_length();
     UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
@@ -208,51 +191,68 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 
     // rr = ( 2 ^ (2 * modulo.length() * BITS_IN_WORD) ) % modulo
     shift_left_by_n_words(one, 2 * num_words, x);
-    divide_without_allocation(x, modulo, temp_z, one, z, zz, temp_extra, rr);
+    divide_without_allocation(x, modulo, temp_z, temp_extra, rr);
     rr.resize_with_leading_zeros(num_words);
 
     // x = base [% modulo, if x doesn't already fit in modulo's words]
     x.set_to(base);
     if (x.trimmed_length() > num_words)
-        divide_without_allocation(base, modulo, temp_z, one, z, zz, temp_extra, x);
+        divide_without_allocation(base, modulo, temp_z, temp_extra, x);
     x.resize_with_leading_zeros(num_words);
 
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
-    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
-
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
-    zz.set_to(0);
-    zz.resize_with_leading_zeros(num_words);
-
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
+    // Compute the montgomery forms of the odd powers of x. powers[i] = x^(2i + 1)
+    UnsignedBigInteger powers[1 << (max_window_size - 1)];
+    size_t power_count = 1 << (window_size - 1);
+    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[0]);
+    if (power_count > 1) {
+        // zz = x^2
+        almost_montgomery_multiplication_without_allocation(powers[0], powers[0], modulo, temp_z, k, num_words, zz);
+        for (size_t i = 1; i < power_count; ++i)
+            almost_montgomery_multiplication_without_allocation(powers[i - 1], zz, modulo, temp_z, k, num_words, powers[i]);
+    }
+
+    // z = 1, in montgomery form, in case the exponent is 0.
+    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, z);
+
+    auto exponent_bit = [&](size_t index) {
+        return (exponent.m_words[index / UnsignedBigInteger::BITS_IN_WORD] >> (index % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    };
+
+    bool z_is_one = true;
+    for (ssize_t bit = exponent_bits - 1; bit >= 0;) {
+        if (!exponent_bit(bit)) {
+            if (!z_is_one) {
                 almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                swap(z, zz);
+            }
+            --bit;
+            continue;
+        }
+
+        // Take the longest window that fits and ends with a set bit.
+        ssize_t lowest_bit = max<ssize_t>(bit - window_size + 1, 0);
+        while (!exponent_bit(lowest_bit))
+            ++lowest_bit;
+        size_t window = 0;
+        for (ssize_t i = bit; i >= lowest_bit; --i)
+            window = (window << 1) | exponent_bit(i);
+        auto& power = powers[window >> 1];
+
+        if (z_is_one) {
+            z.set_to(power);
+            z_is_one = false;
+        } else {
+            for (ssize_t i = bit; i >= lowest_bit; --i) {
                 almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                swap(z, zz);
             }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
             almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
             swap(z, zz);
-
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
         }
+        bit = lowest_bit - 1;
     }
 
     almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
@@ -274,7 +274,7 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
         dbgln("Encountered the modulo branch during a montgomery modular power. Params : {} - {} - {}", base, exponent, modulo);
         // We just clobber all the other temporaries that we don't need for the division.
         // This is wasteful, but we're on the edgiest of cases already.
-        divide_without_allocation(zz, modulo, temp_z, rr, z, x, temp_extra, result);
+        divide_without_allocation(zz, modulo, temp_z, temp_extra, result);
     }
 
     result.clamp_to_trimmed_length();
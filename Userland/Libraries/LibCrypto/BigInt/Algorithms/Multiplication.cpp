@@ -9,38 +9,167 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+
+// Below this many words, the bookkeeping of Karatsuba costs more than the multiplications it saves.
+static constexpr size_t karatsuba_threshold = 40;
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
- * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Complexity: O(N * M) where N and M are the number of words in the two numbers
+ * output[0, left_length + right_length) = left * right
+ */
+static void schoolbook_multiply(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t j = 0; j < right_length; ++j) {
+        DoubleWord right_word = right[j];
+        DoubleWord carry = 0;
+        for (size_t i = 0; i < left_length; ++i) {
+            DoubleWord product = left[i] * right_word + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(product);
+            carry = product >> UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[j + left_length] = static_cast<Word>(carry);
+    }
+}
+
+// words[0, length) += value[0, value_length), returns the carry out of words[length - 1].
+static Word add_words(Word* words, size_t length, Word const* value, size_t value_length)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(words[i]) + value[i] + carry;
+        words[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry && i < length; ++i) {
+        words[i] += 1;
+        carry = words[i] == 0;
+    }
+    return static_cast<Word>(carry);
+}
+
+// words[0, length) -= value[0, value_length), which must not make it negative.
+static void subtract_words(Word* words, size_t length, Word const* value, size_t value_length)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(words[i]) - value[i] - borrow;
+        words[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) ? 1 : 0;
+    }
+    for (; borrow && i < length; ++i) {
+        borrow = words[i] == 0;
+        words[i] -= 1;
+    }
+    VERIFY(borrow == 0);
+}
+
+// The number of scratch words that multiply_words() needs for operands of these lengths.
+static size_t multiplication_scratch_size(size_t left_length, size_t right_length)
+{
+    if (left_length < right_length)
+        swap(left_length, right_length);
+    if (right_length < karatsuba_threshold)
+        return 0;
+
+    if (left_length > right_length) {
+        // The longer number is multiplied in pieces as long as the shorter one, each product going through scratch space.
+        auto scratch_size = multiplication_scratch_size(right_length, right_length);
+        if (auto last_piece_length = left_length % right_length; last_piece_length != 0)
+            scratch_size = max(scratch_size, multiplication_scratch_size(right_length, last_piece_length));
+        return 2 * right_length + scratch_size;
+    }
+
+    auto high_length = right_length - right_length / 2;
+    return 4 * (high_length + 1) + multiplication_scratch_size(high_length + 1, high_length + 1);
+}
+
+/**
+ * Complexity: O(N^1.58) where N is the number of words in the larger number, if both numbers are about as long
+ * output[0, left_length + right_length) = left * right, using Karatsuba's method:
+ * With x = x1 * B + x0 and y = y1 * B + y0, x * y = x1y1 * B^2 + ((x0 + x1)(y0 + y1) - x0y0 - x1y1) * B + x0y0,
+ * which takes three multiplications of half the size instead of four.
+ */
+static void multiply_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length, Word* scratch)
+{
+    if (left_length < right_length) {
+        swap(left, right);
+        swap(left_length, right_length);
+    }
+
+    if (right_length < karatsuba_threshold) {
+        schoolbook_multiply(output, left, left_length, right, right_length);
+        return;
+    }
+
+    if (left_length > right_length) {
+        __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+        auto* piece_product = scratch;
+        for (size_t offset = 0; offset < left_length; offset += right_length) {
+            auto piece_length = min(right_length, left_length - offset);
+            multiply_words(piece_product, left + offset, piece_length, right, right_length, scratch + 2 * right_length);
+            add_words(output + offset, left_length + right_length - offset, piece_product, piece_length + right_length);
+        }
+        return;
+    }
+
+    auto length = left_length;
+    auto low_length = length / 2;
+    auto high_length = length - low_length;
+
+    // x0y0 and x1y1 go straight into their places in the output.
+    multiply_words(output, left, low_length, right, low_length, scratch);
+    multiply_words(output + 2 * low_length, left + low_length, high_length, right + low_length, high_length, scratch);
+
+    auto* left_sum = scratch;
+    auto* right_sum = scratch + high_length + 1;
+    auto* middle = scratch + 2 * (high_length + 1);
+    auto* next_scratch = scratch + 4 * (high_length + 1);
+
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(Word));
+    left_sum[high_length] = add_words(left_sum, high_length, left, low_length);
+    __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(Word));
+    right_sum[high_length] = add_words(right_sum, high_length, right, low_length);
+
+    multiply_words(middle, left_sum, high_length + 1, right_sum, high_length + 1, next_scratch);
+    subtract_words(middle, 2 * (high_length + 1), output, 2 * low_length);
+    subtract_words(middle, 2 * (high_length + 1), output + 2 * low_length, 2 * high_length);
+
+    // The middle term is less than 2 * B * B^high_length, so its top word is always zero, and only the rest has to be added.
+    VERIFY(middle[2 * high_length + 1] == 0);
+    add_words(output + low_length, 2 * length - low_length, middle, 2 * high_length + 1);
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the larger number, or O(N^1.58) for long numbers of similar lengths
+ * The output must not be one of the inputs.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    VERIFY(&output != &left && &output != &right);
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    auto left_length = left.trimmed_length();
+    auto right_length = right.trimmed_length();
+    if (left_length == 0 || right_length == 0) {
+        output.set_to(0);
+        return;
+    }
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    output.set_to_0();
+    output.m_words.resize_and_keep_capacity(left_length + right_length);
+    temp_scratch.set_to_0();
+    temp_scratch.m_words.resize_and_keep_capacity(multiplication_scratch_size(left_length, right_length));
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    multiply_words(output.m_words.data(), left.m_words.data(), left_length, right.m_words.data(), right_length, temp_scratch.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
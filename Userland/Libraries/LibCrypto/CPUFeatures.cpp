@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+#if CRYPTO_HAS_X86_ACCELERATION
+// Bits of ecx in cpuid[eax = 1]
+constexpr u32 cpuid_1_ecx_bit_pclmulqdq = 1 << 1;
+constexpr u32 cpuid_1_ecx_bit_ssse3 = 1 << 9;
+constexpr u32 cpuid_1_ecx_bit_sse4_1 = 1 << 19;
+constexpr u32 cpuid_1_ecx_bit_aes = 1 << 25;
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+// Bits of ebx in cpuid[eax = 7, ecx = 0]
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+constexpr u32 cpuid_7_ebx_bit_sha = 1 << 29;
+
+static u32 cpuid_1_ecx()
+{
+    static u32 const s_ecx = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return 0u;
+        return ecx;
+    }();
+    return s_ecx;
+}
+
+static u32 cpuid_7_ebx()
+{
+    static u32 const s_ebx = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return 0u;
+        return ebx;
+    }();
+    return s_ebx;
+}
+
+bool cpu_supports_aes_ni()
+{
+    return cpuid_1_ecx() & cpuid_1_ecx_bit_aes;
+}
+
+bool cpu_supports_pclmul()
+{
+    auto ecx = cpuid_1_ecx();
+    return (ecx & cpuid_1_ecx_bit_pclmulqdq) && (ecx & cpuid_1_ecx_bit_ssse3);
+}
+
+bool cpu_supports_ssse3()
+{
+    return cpuid_1_ecx() & cpuid_1_ecx_bit_ssse3;
+}
+
+bool cpu_supports_sha()
+{
+    auto ecx = cpuid_1_ecx();
+    return (cpuid_7_ebx() & cpuid_7_ebx_bit_sha) && (ecx & cpuid_1_ecx_bit_ssse3) && (ecx & cpuid_1_ecx_bit_sse4_1);
+}
+
+bool cpu_supports_avx2()
+{
+    static bool const s_supports_avx2 = [] {
+        constexpr u32 xcr0_sse_and_avx_state = 0b110;
+
+        auto ecx = cpuid_1_ecx();
+        if (!(ecx & cpuid_1_ecx_bit_osxsave) || !(ecx & cpuid_1_ecx_bit_avx))
+            return false;
+
+        // The kernel also has to preserve the upper halves of the YMM registers across context switches.
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        if ((xcr0_low & xcr0_sse_and_avx_state) != xcr0_sse_and_avx_state)
+            return false;
+
+        return (cpuid_7_ebx() & cpuid_7_ebx_bit_avx2) != 0;
+    }();
+    return s_supports_avx2;
+}
+#endif
+
+}
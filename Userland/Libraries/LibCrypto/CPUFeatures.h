@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+
+// NOTE: The kernel can't use SSE, so it always sticks to the portable implementations.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define CRYPTO_HAS_X86_ACCELERATION 1
+#else
+#    define CRYPTO_HAS_X86_ACCELERATION 0
+#endif
+
+namespace Crypto {
+
+#if CRYPTO_HAS_X86_ACCELERATION
+// Whether AESENC and friends are available.
+bool cpu_supports_aes_ni();
+// Whether PCLMULQDQ is available, along with the SSSE3 byte shuffles that go with it.
+bool cpu_supports_pclmul();
+bool cpu_supports_ssse3();
+// Whether the SHA extensions are available, along with the SSSE3 and SSE4.1 shuffles and blends that go with them.
+bool cpu_supports_sha();
+// Whether AVX2 is available, and the kernel preserves the YMM registers.
+bool cpu_supports_avx2();
+#endif
+
+}
@@ -6,16 +6,150 @@
 
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
-void Adler32::update(ReadonlyBytes data)
+static constexpr u32 modulus = 65521;
+// The most bytes that can be summed up before b has to be reduced to not overflow 32 bits (as in zlib)
+static constexpr size_t max_bytes_without_reduction = 5552;
+
+static void update_scalar(u32& state_a, u32& state_b, u8 const* bytes, size_t size)
+{
+    // NOTE: Working on copies lets the compiler keep them in registers, the references might alias the bytes as far as it knows.
+    u32 a = state_a;
+    u32 b = state_b;
+    while (size > 0) {
+        auto count = min(size, max_bytes_without_reduction);
+        size -= count;
+        for (; count >= 4; count -= 4, bytes += 4) {
+            a += bytes[0];
+            b += a;
+            a += bytes[1];
+            b += a;
+            a += bytes[2];
+            b += a;
+            a += bytes[3];
+            b += a;
+        }
+        for (; count > 0; count--, bytes++) {
+            a += *bytes;
+            b += a;
+        }
+        a %= modulus;
+        b %= modulus;
+    }
+    state_a = a;
+    state_b = b;
+}
+
+#if CRYPTO_HAS_X86_ACCELERATION
+// Both vectorized versions work on 32 byte blocks: a block adds the sum of its bytes to a, and to b it adds 32 times the previous a
+// plus its bytes weighted by 32 down to 1. The weighted sums are computed with multiply-add instructions.
+// Returns the number of bytes processed, which is a multiple of 32.
+static constexpr size_t block_size = 32;
+static constexpr size_t max_blocks_without_reduction = max_bytes_without_reduction / block_size;
+
+static u32 horizontal_sum(__m128i sums)
+{
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sums);
+}
+
+[[gnu::target("avx2")]] static u32 horizontal_sum(__m256i sums)
+{
+    return horizontal_sum(_mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1)));
+}
+
+[[gnu::target("ssse3")]] static size_t update_with_ssse3(u32& a, u32& b, u8 const* bytes, size_t size)
+{
+    auto const first_half_weights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const second_half_weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+
+    size_t blocks = size / block_size;
+    size_t processed = blocks * block_size;
+    while (blocks > 0) {
+        auto count = min(blocks, max_blocks_without_reduction);
+        blocks -= count;
+
+        // The sum of all the a's from before each block, multiplied by 32 at the end
+        auto previous_a_sums = _mm_cvtsi32_si128(a * count);
+        auto a_sums = zero;
+        auto b_sums = _mm_cvtsi32_si128(b);
+        for (; count > 0; count--, bytes += block_size) {
+            auto first_half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+            auto second_half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + 16));
+
+            previous_a_sums = _mm_add_epi32(previous_a_sums, a_sums);
+            a_sums = _mm_add_epi32(a_sums, _mm_sad_epu8(first_half, zero));
+            a_sums = _mm_add_epi32(a_sums, _mm_sad_epu8(second_half, zero));
+            b_sums = _mm_add_epi32(b_sums, _mm_madd_epi16(_mm_maddubs_epi16(first_half, first_half_weights), ones));
+            b_sums = _mm_add_epi32(b_sums, _mm_madd_epi16(_mm_maddubs_epi16(second_half, second_half_weights), ones));
+        }
+        b_sums = _mm_add_epi32(b_sums, _mm_slli_epi32(previous_a_sums, 5));
+
+        a = (a + horizontal_sum(a_sums)) % modulus;
+        b = horizontal_sum(b_sums) % modulus;
+    }
+    return processed;
+}
+
+[[gnu::target("avx2")]] static size_t update_with_avx2(u32& a, u32& b, u8 const* bytes, size_t size)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    auto const weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm256_set1_epi16(1);
+    auto const zero = _mm256_setzero_si256();
+
+    size_t blocks = size / block_size;
+    size_t processed = blocks * block_size;
+    while (blocks > 0) {
+        auto count = min(blocks, max_blocks_without_reduction);
+        blocks -= count;
+
+        auto previous_a_sums = _mm256_zextsi128_si256(_mm_cvtsi32_si128(a * count));
+        auto a_sums = zero;
+        auto b_sums = _mm256_zextsi128_si256(_mm_cvtsi32_si128(b));
+        for (; count > 0; count--, bytes += block_size) {
+            auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes));
+
+            previous_a_sums = _mm256_add_epi32(previous_a_sums, a_sums);
+            a_sums = _mm256_add_epi32(a_sums, _mm256_sad_epu8(block, zero));
+            b_sums = _mm256_add_epi32(b_sums, _mm256_madd_epi16(_mm256_maddubs_epi16(block, weights), ones));
+        }
+        b_sums = _mm256_add_epi32(b_sums, _mm256_slli_epi32(previous_a_sums, 5));
+
+        a = (a + horizontal_sum(a_sums)) % modulus;
+        b = horizontal_sum(b_sums) % modulus;
     }
+    return processed;
+}
+#endif
+
+void Adler32::update(ReadonlyBytes data)
+{
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+#if CRYPTO_HAS_X86_ACCELERATION
+    size_t processed = 0;
+    if (cpu_supports_avx2())
+        processed = update_with_avx2(m_state_a, m_state_b, bytes, size);
+    else if (cpu_supports_ssse3())
+        processed = update_with_ssse3(m_state_a, m_state_b, bytes, size);
+    bytes += processed;
+    size -= processed;
+#endif
+
+    update_scalar(m_state_a, m_state_b, bytes, size);
 };
 
 u32 Adler32::digest()
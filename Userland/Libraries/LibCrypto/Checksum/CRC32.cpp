@@ -5,10 +5,16 @@
  */
 
 #include <AK/Array.h>
+#include <AK/Assertions.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
 static constexpr auto generate_table()
@@ -30,13 +36,103 @@ static constexpr auto generate_table()
     return data;
 }
 
-static constexpr auto table = generate_table();
+// tables[n][i] is the CRC of byte i followed by n zero bytes, which allows processing 8 bytes at a time ("slicing-by-8")
+static constexpr auto generate_tables()
+{
+    Array<Array<u32, 256>, 8> data {};
+    data[0] = generate_table();
+    for (auto n = 1u; n < data.size(); n++) {
+        for (auto i = 0u; i < 256; i++)
+            data[n][i] = data[0][data[n - 1][i] & 0xFF] ^ (data[n - 1][i] >> 8);
+    }
+    return data;
+}
+
+static constexpr auto tables = generate_tables();
+
+static u32 update_with_tables(u32 state, ReadonlyBytes data)
+{
+    auto const* bytes = data.data();
+    auto const* end = bytes + data.size();
+
+    for (; end - bytes >= 8; bytes += 8) {
+        u32 low = (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) ^ state;
+        u32 high = bytes[4] | bytes[5] << 8 | bytes[6] << 16 | bytes[7] << 24;
+        state = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+
+    for (; bytes < end; bytes++)
+        state = tables[0][(state ^ *bytes) & 0xFF] ^ (state >> 8);
+    return state;
+}
+
+#if CRYPTO_HAS_X86_ACCELERATION
+// Folds 16 bytes at a time with carry-less multiplication, then reduces the remaining 128 bits to the CRC, as described in
+// Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction". The constants are powers of x modulo the
+// (bit-reflected) CRC32 polynomial, the same ones the Linux kernel uses.
+[[gnu::target("pclmul")]] static __m128i fold(__m128i accumulator, __m128i constants, __m128i next_block)
+{
+    auto low = _mm_clmulepi64_si128(accumulator, constants, 0x00);
+    auto high = _mm_clmulepi64_si128(accumulator, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next_block);
+}
+
+[[gnu::target("pclmul")]] static u32 update_with_pclmul(u32 state, u8 const* bytes, size_t size)
+{
+    VERIFY(size >= 64 && size % 16 == 0);
+    auto const fold_by_4_constants = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+    auto const fold_by_1_constants = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+    auto const reduce_64_constant = _mm_set_epi64x(0, 0x163cd6124);
+    auto const barrett_constants = _mm_set_epi64x(0x1F7011641, 0x1DB710641);
+    auto const mask_32 = _mm_set_epi32(0, 0, 0, ~0);
+
+    auto load = [&] {
+        auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+        bytes += 16;
+        size -= 16;
+        return block;
+    };
+
+    // Keep 4 blocks in flight, so that the multiplications of one don't have to wait for those of another
+    auto x0 = _mm_xor_si128(load(), _mm_cvtsi32_si128(state));
+    auto x1 = load();
+    auto x2 = load();
+    auto x3 = load();
+    while (size >= 64) {
+        x0 = fold(x0, fold_by_4_constants, load());
+        x1 = fold(x1, fold_by_4_constants, load());
+        x2 = fold(x2, fold_by_4_constants, load());
+        x3 = fold(x3, fold_by_4_constants, load());
+    }
+
+    x0 = fold(x0, fold_by_1_constants, x1);
+    x0 = fold(x0, fold_by_1_constants, x2);
+    x0 = fold(x0, fold_by_1_constants, x3);
+    while (size >= 16)
+        x0 = fold(x0, fold_by_1_constants, load());
+
+    // 128 bits to 64 bits
+    x0 = _mm_xor_si128(_mm_clmulepi64_si128(x0, fold_by_1_constants, 0x10), _mm_srli_si128(x0, 8));
+    // 64 bits to 32 bits
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 4), _mm_clmulepi64_si128(_mm_and_si128(x0, mask_32), reduce_64_constant, 0x00));
+    // Barrett reduction of the remaining bits
+    auto quotient = _mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x0, mask_32), barrett_constants, 0x10), mask_32);
+    x0 = _mm_xor_si128(x0, _mm_clmulepi64_si128(quotient, barrett_constants, 0x00));
+    return _mm_cvtsi128_si32(_mm_srli_si128(x0, 4));
+}
+#endif
 
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (data.size() >= 64 && cpu_supports_pclmul()) {
+        auto folded_size = data.size() & ~15;
+        m_state = update_with_pclmul(m_state, data.data(), folded_size);
+        data = data.slice(folded_size);
     }
+#endif
+    m_state = update_with_tables(m_state, data);
 };
 
 u32 CRC32::digest()
@@ -44,4 +140,41 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Multiplies two polynomials modulo the CRC32 polynomial, both in the same reflected bit order as the CRC itself
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 bit = 1u << 31; bit != 0; bit >>= 1) {
+        if (a & bit)
+            product ^= b;
+        b = (b & 1) ? 0xEDB88320 ^ (b >> 1) : b >> 1;
+    }
+    return product;
+}
+
+// x^(2^n) modulo the CRC32 polynomial
+static constexpr auto generate_power_of_x_table()
+{
+    Array<u32, 32> data {};
+    data[0] = 1u << 30; // x^1
+    for (auto i = 1u; i < data.size(); i++)
+        data[i] = multiply_modulo_polynomial(data[i - 1], data[i - 1]);
+    return data;
+}
+
+static constexpr auto power_of_x_table = generate_power_of_x_table();
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, size_t second_length)
+{
+    // Appending n bytes to the first piece multiplies its CRC by x^(8n), the second piece's CRC is then simply added to that.
+    // NOTE: x^(2^n) repeats with a period that divides 2^32 - 1, which the table wraps around with.
+    u32 shift = 1u << 31; // x^0
+    size_t power = 3;     // 8n = n * 2^3
+    for (auto length = second_length; length != 0; length >>= 1, power++) {
+        if (length & 1)
+            shift = multiply_modulo_polynomial(power_of_x_table[power % power_of_x_table.size()], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_digest) ^ second_digest;
+}
+
 }
@@ -29,6 +29,9 @@ public:
     virtual void update(ReadonlyBytes data) override;
     virtual u32 digest() override;
 
+    // Computes the CRC32 of two pieces of data concatenated, given the CRC32 of each piece and the length of the second one.
+    static u32 combine(u32 first_digest, u32 second_digest, size_t second_length);
+
 private:
     u32 m_state { ~0u };
 };
@@ -4,10 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
@@ -153,6 +159,16 @@ void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+#if CRYPTO_HAS_X86_ACCELERATION
+void AESCipherKey::update_hardware_round_keys()
+{
+    // NOTE: Our round keys are made up of big-endian words, AES-NI wants them as plain bytes.
+    auto const* keys = round_keys();
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i)
+        ByteReader::store(m_hardware_round_keys + i * 4, AK::convert_between_host_and_big_endian(keys[i]));
+}
+#endif
+
 void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 {
     u32* round_key;
@@ -197,8 +213,123 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+#if CRYPTO_HAS_X86_ACCELERATION
+[[gnu::target("aes")]] static void encrypt_block_with_aes_ni(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    auto const* round_keys = reinterpret_cast<__m128i const*>(key.hardware_round_keys());
+    auto rounds = key.rounds();
+
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&round_keys[0]));
+    for (size_t i = 1; i < rounds; ++i)
+        state = _mm_aesenc_si128(state, _mm_loadu_si128(&round_keys[i]));
+    state = _mm_aesenclast_si128(state, _mm_loadu_si128(&round_keys[rounds]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+// NOTE: This relies on the decryption key schedule being that of the "equivalent inverse cipher" (FIPS-197 section 5.3.5),
+//       which is what both our table-based implementation and AESDEC expect.
+[[gnu::target("aes")]] static void decrypt_block_with_aes_ni(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    auto const* round_keys = reinterpret_cast<__m128i const*>(key.hardware_round_keys());
+    auto rounds = key.rounds();
+
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&round_keys[0]));
+    for (size_t i = 1; i < rounds; ++i)
+        state = _mm_aesdec_si128(state, _mm_loadu_si128(&round_keys[i]));
+    state = _mm_aesdeclast_si128(state, _mm_loadu_si128(&round_keys[rounds]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+[[gnu::target("aes")]] static __m128i counter_block(u64 high, u64 low)
+{
+    return _mm_set_epi64x(static_cast<i64>(AK::convert_between_host_and_big_endian(low)), static_cast<i64>(AK::convert_between_host_and_big_endian(high)));
+}
+
+static void increment_counter(u64& high, u64& low)
+{
+    if (++low == 0)
+        ++high;
+}
+
+[[gnu::target("aes")]] static void encrypt_in_counter_mode_with_aes_ni(AESCipherKey const& key, ReadonlyBytes const* in, Bytes out, Bytes counter)
+{
+    constexpr size_t block_size = AESCipherBlock::block_size();
+    // Encrypting several independent blocks at once keeps the AES unit busy, as each AESENC has to wait for the previous one on the same block.
+    constexpr size_t parallel_block_count = 4;
+
+    auto rounds = key.rounds();
+    __m128i round_keys[15];
+    for (size_t i = 0; i <= rounds; ++i)
+        round_keys[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(key.hardware_round_keys()) + i);
+
+    VERIFY(counter.size() >= block_size);
+    u64 high = AK::convert_between_host_and_big_endian(ByteReader::load64(counter.offset_pointer(0)));
+    u64 low = AK::convert_between_host_and_big_endian(ByteReader::load64(counter.offset_pointer(8)));
+
+    size_t offset = 0;
+    while (out.size() - offset >= parallel_block_count * block_size) {
+        __m128i blocks[parallel_block_count];
+        for (size_t j = 0; j < parallel_block_count; ++j) {
+            blocks[j] = _mm_xor_si128(counter_block(high, low), round_keys[0]);
+            increment_counter(high, low);
+        }
+        for (size_t i = 1; i < rounds; ++i) {
+            for (size_t j = 0; j < parallel_block_count; ++j)
+                blocks[j] = _mm_aesenc_si128(blocks[j], round_keys[i]);
+        }
+        for (size_t j = 0; j < parallel_block_count; ++j) {
+            blocks[j] = _mm_aesenclast_si128(blocks[j], round_keys[rounds]);
+            if (in)
+                blocks[j] = _mm_xor_si128(blocks[j], _mm_loadu_si128(reinterpret_cast<__m128i const*>(in->offset_pointer(offset + j * block_size))));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.offset_pointer(offset + j * block_size)), blocks[j]);
+        }
+        offset += parallel_block_count * block_size;
+    }
+
+    while (offset < out.size()) {
+        auto block = _mm_xor_si128(counter_block(high, low), round_keys[0]);
+        increment_counter(high, low);
+        for (size_t i = 1; i < rounds; ++i)
+            block = _mm_aesenc_si128(block, round_keys[i]);
+        block = _mm_aesenclast_si128(block, round_keys[rounds]);
+
+        auto size = min(block_size, out.size() - offset);
+        if (size == block_size) {
+            if (in)
+                block = _mm_xor_si128(block, _mm_loadu_si128(reinterpret_cast<__m128i const*>(in->offset_pointer(offset))));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.offset_pointer(offset)), block);
+        } else {
+            u8 key_stream[block_size];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(key_stream), block);
+            for (size_t i = 0; i < size; ++i)
+                out[offset + i] = in ? (*in)[offset + i] ^ key_stream[i] : key_stream[i];
+        }
+        offset += size;
+    }
+
+    ByteReader::store(counter.offset_pointer(0), AK::convert_between_host_and_big_endian(high));
+    ByteReader::store(counter.offset_pointer(8), AK::convert_between_host_and_big_endian(low));
+}
+
+bool AESCipher::encrypt_in_counter_mode_with_hardware(ReadonlyBytes const* in, Bytes out, Bytes counter) const
+{
+    if (!cpu_supports_aes_ni())
+        return false;
+    VERIFY(!in || in->size() >= out.size());
+    encrypt_in_counter_mode_with_aes_ni(m_key, in, out, counter);
+    return true;
+}
+#endif
+
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (cpu_supports_aes_ni()) {
+        encrypt_block_with_aes_ni(key(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -291,6 +422,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (cpu_supports_aes_ni()) {
+        decrypt_block_with_aes_ni(key(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Vector.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Cipher/Cipher.h>
 #include <LibCrypto/Cipher/Mode/CBC.h>
 #include <LibCrypto/Cipher/Mode/CTR.h>
@@ -73,6 +74,11 @@ struct AESCipherKey : public CipherKey {
         return (u32 const*)m_rd_keys;
     }
 
+#if CRYPTO_HAS_X86_ACCELERATION
+    // The same round keys, laid out as AESENC/AESDEC expect them.
+    u8 const* hardware_round_keys() const { return m_hardware_round_keys; }
+#endif
+
     AESCipherKey(ReadonlyBytes user_key, size_t key_bits, Intent intent)
         : m_bits(key_bits)
     {
@@ -80,6 +86,9 @@ struct AESCipherKey : public CipherKey {
             expand_encrypt_key(user_key, key_bits);
         else
             expand_decrypt_key(user_key, key_bits);
+#if CRYPTO_HAS_X86_ACCELERATION
+        update_hardware_round_keys();
+#endif
     }
 
     virtual ~AESCipherKey() override = default;
@@ -94,8 +103,15 @@ protected:
     }
 
 private:
+#if CRYPTO_HAS_X86_ACCELERATION
+    void update_hardware_round_keys();
+#endif
+
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+#if CRYPTO_HAS_X86_ACCELERATION
+    u8 m_hardware_round_keys[(MAX_ROUND_COUNT + 1) * 16] { 0 };
+#endif
     size_t m_rounds;
     size_t m_bits;
 };
@@ -120,6 +136,13 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+#if CRYPTO_HAS_X86_ACCELERATION
+    // Encrypts `in` in CTR mode (or just produces the key stream if there is no `in`), treating `counter` as a 128-bit big-endian integer
+    // that is left pointing past the last block, just like CTR<AESCipher> does.
+    // Returns false without doing anything if the CPU lacks AES-NI.
+    bool encrypt_in_counter_mode_with_hardware(ReadonlyBytes const* in, Bytes out, Bytes counter) const;
+#endif
+
 #ifndef KERNEL
     virtual String class_name() const override
     {
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+#include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
+
+namespace Crypto::Cipher {
+
+ChaCha20Poly1305::ChaCha20Poly1305(ReadonlyBytes key)
+{
+    VERIFY(key.size() == key_size);
+    key.copy_to({ m_key, key_size });
+}
+
+void ChaCha20Poly1305::encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const
+{
+    VERIFY(nonce.size() == nonce_size);
+    VERIFY(tag.size() >= tag_size);
+
+    // The block with counter 0 is used for the one-time Poly1305 key, so the data is encrypted starting at 1.
+    ChaCha20 cipher { { m_key, key_size }, nonce, 1 };
+    cipher.encrypt(in, out);
+
+    compute_tag(out.trim(in.size()), nonce, aad, tag);
+}
+
+VerificationConsistency ChaCha20Poly1305::decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const
+{
+    VERIFY(nonce.size() == nonce_size);
+
+    u8 expected_tag[tag_size];
+    compute_tag(in, nonce, aad, { expected_tag, tag_size });
+    if (tag.size() != tag_size || !timing_safe_compare(expected_tag, tag.data(), tag_size))
+        return VerificationConsistency::Inconsistent;
+
+    ChaCha20 cipher { { m_key, key_size }, nonce, 1 };
+    cipher.decrypt(in, out);
+    return VerificationConsistency::Consistent;
+}
+
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8
+void ChaCha20Poly1305::compute_tag(ReadonlyBytes ciphertext, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const
+{
+    // https://datatracker.ietf.org/doc/html/rfc8439#section-2.6
+    // The one-time key is the first 32 bytes of the key stream block with counter 0.
+    u8 one_time_key[32] {};
+    Bytes one_time_key_bytes { one_time_key, sizeof(one_time_key) };
+    ChaCha20 key_generator { { m_key, key_size }, nonce, 0 };
+    key_generator.encrypt(one_time_key_bytes, one_time_key_bytes);
+
+    static constexpr u8 zero_padding[16] {};
+    auto padding_for = [](size_t length) { return ReadonlyBytes { zero_padding, (16 - length % 16) % 16 }; };
+
+    Authentication::Poly1305 poly1305 { one_time_key_bytes };
+    poly1305.update(aad);
+    poly1305.update(padding_for(aad.size()));
+    poly1305.update(ciphertext);
+    poly1305.update(padding_for(ciphertext.size()));
+
+    u8 lengths[16];
+    ByteReader::store(lengths, AK::convert_between_host_and_little_endian<u64>(aad.size()));
+    ByteReader::store(lengths + 8, AK::convert_between_host_and_little_endian<u64>(ciphertext.size()));
+    poly1305.update({ lengths, sizeof(lengths) });
+
+    // FIXME: Poly1305 only fails to produce a digest if it runs out of memory.
+    auto digest = MUST(poly1305.digest());
+    digest.bytes().copy_to(tag);
+    secure_zero(one_time_key, sizeof(one_time_key));
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <LibCrypto/Verification.h>
+
+namespace Crypto::Cipher {
+
+// The ChaCha20-Poly1305 AEAD construction
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8
+class ChaCha20Poly1305 {
+public:
+    static constexpr size_t key_size = 32;
+    static constexpr size_t nonce_size = 12;
+    static constexpr size_t tag_size = 16;
+
+    explicit ChaCha20Poly1305(ReadonlyBytes key);
+
+    // Encrypts `in` into `out` (which must be at least as large), and writes the authentication tag of the ciphertext and `aad` into `tag`.
+    void encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const;
+    // Decrypts `in` into `out`, unless the tag doesn't match; `out` is left untouched in that case.
+    VerificationConsistency decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const;
+
+private:
+    void compute_tag(ReadonlyBytes ciphertext, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const;
+
+    u8 m_key[key_size];
+};
+
+}
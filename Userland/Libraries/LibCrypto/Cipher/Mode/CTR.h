@@ -168,6 +168,14 @@ protected:
         __builtin_memcpy(m_ivec_storage, ivec.data(), IV_length());
         Bytes iv { m_ivec_storage, IV_length() };
 
+        if constexpr (IsSame<IncrementFunctionType, IncrementInplace> && requires { cipher.encrypt_in_counter_mode_with_hardware(in, out, iv); }) {
+            if (cipher.encrypt_in_counter_mode_with_hardware(in, out.slice(0, length), iv)) {
+                if (ivec_out)
+                    __builtin_memcpy(ivec_out->data(), iv.data(), min(ivec_out->size(), IV_length()));
+                return;
+            }
+        }
+
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
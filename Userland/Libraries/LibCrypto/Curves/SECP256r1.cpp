@@ -10,16 +10,19 @@
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <AK/UFixedBigInt.h>
+#include <AK/Vector.h>
 #include <LibCrypto/Curves/SECP256r1.h>
 
 namespace Crypto::Curves {
 
 static constexpr u256 REDUCE_PRIME { u128 { 0x0000000000000001ull, 0xffffffff00000000ull }, u128 { 0xffffffffffffffffull, 0x00000000fffffffe } };
 static constexpr u256 REDUCE_ORDER { u128 { 0x0c46353d039cdaafull, 0x4319055258e8617bull }, u128 { 0x0000000000000000ull, 0x00000000ffffffff } };
-static constexpr u256 PRIME_INVERSE_MOD_R { u128 { 0x0000000000000001ull, 0x0000000100000000ull }, u128 { 0x0000000000000000ull, 0xffffffff00000002ull } };
 static constexpr u256 PRIME { u128 { 0xffffffffffffffffull, 0x00000000ffffffffull }, u128 { 0x0000000000000000ull, 0xffffffff00000001ull } };
+static constexpr u64 PRIME_LIMBS[4] { 0xffffffffffffffffull, 0x00000000ffffffffull, 0x0000000000000000ull, 0xffffffff00000001ull };
 static constexpr u256 R2_MOD_PRIME { u128 { 0x0000000000000003ull, 0xfffffffbffffffffull }, u128 { 0xfffffffffffffffeull, 0x00000004fffffffdull } };
 static constexpr u256 ONE { 1u };
+// 1 in Montgomery form, which is 2^256 % p
+static constexpr u256 ONE_MONTGOMERY = REDUCE_PRIME;
 static constexpr u256 B_MONTGOMERY { u128 { 0xd89cdf6229c4bddfull, 0xacf005cd78843090ull }, u128 { 0xe5a220abf7212ed6ull, 0xdc30061d04874834ull } };
 
 static u256 import_big_endian(ReadonlyBytes data)
@@ -55,10 +58,18 @@ static u256 select(u256 const& left, u256 const& right, bool condition)
     return (left & mask) | (right & ~mask);
 }
 
-static u512 multiply(u256 const& left, u256 const& right)
+// Returns the low 64 bits of a * b + c + carry, and puts the high 64 bits into carry. This can't overflow, as it's at most 2^128 - 1.
+ALWAYS_INLINE static u64 multiply_add(u64 a, u64 b, u64 c, u64& carry)
 {
-    auto result = left.wide_multiply(right);
-    return { result.low, result.high };
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 result = static_cast<unsigned __int128>(a) * b + c + carry;
+    carry = static_cast<u64>(result >> 64);
+    return static_cast<u64>(result);
+#else
+    u128 result = u128 { a, 0u } * u128 { b, 0u } + u128 { c, 0u } + u128 { carry, 0u };
+    carry = result.high();
+    return result.low();
+#endif
 }
 
 static u256 modular_reduce(u256 const& value)
@@ -81,60 +92,102 @@ static u256 modular_reduce_order(u256 const& value)
     return select(value, other, carry);
 }
 
-static u256 modular_add(u256 const& left, u256 const& right, bool carry_in = false)
+ALWAYS_INLINE static u64 add_with_carry(u64 a, u64 b, u64& carry)
 {
-    bool carry = carry_in;
-    u256 output = left.addc(right, carry);
-
-    // If there is left carry, subtract p by adding 2^256 - p
-    u64 t = carry;
-    carry = false;
-    u256 addend { u128 { t, -(t << 32) }, u128 { -t, (t << 32) - (t << 1) } };
-    output = output.addc(addend, carry);
+    u64 sum;
+    bool carry_out = __builtin_add_overflow(a, b, &sum);
+    carry_out |= __builtin_add_overflow(sum, carry, &sum);
+    carry = carry_out;
+    return sum;
+}
 
-    // If there is still left carry, subtract p by adding 2^256 - p
-    t = carry;
-    addend = { u128 { t, -(t << 32) }, u128 { -t, (t << 32) - (t << 1) } };
-    return output + addend;
+ALWAYS_INLINE static u64 subtract_with_borrow(u64 a, u64 b, u64& borrow)
+{
+    u64 difference;
+    bool borrow_out = __builtin_sub_overflow(a, b, &difference);
+    borrow_out |= __builtin_sub_overflow(difference, borrow, &difference);
+    borrow = borrow_out;
+    return difference;
 }
 
-static u256 modular_sub(u256 const& left, u256 const& right)
+// NOTE: All of the field arithmetic below works on 64-bit limbs, and keeps its results fully reduced, i.e. less than p, as long as its inputs are.
+//       This means that values can be compared directly, and zero always looks the same.
+
+// Subtracts p from value[0, 4) + 2^256 * carry if that is at least p.
+ALWAYS_INLINE static u256 reduce_once(u64 const (&value)[4], u64 carry)
 {
-    bool borrow = false;
-    u256 output = left.subc(right, borrow);
+    u64 borrow = 0;
+    u64 reduced[4];
+    for (size_t i = 0; i < 4; ++i)
+        reduced[i] = subtract_with_borrow(value[i], PRIME_LIMBS[i], borrow);
+
+    u64 mask = -(carry | (borrow ^ 1));
+    for (size_t i = 0; i < 4; ++i)
+        reduced[i] = (reduced[i] & mask) | (value[i] & ~mask);
+    return { u128 { reduced[0], reduced[1] }, u128 { reduced[2], reduced[3] } };
+}
 
-    // If there is left borrow, add p by subtracting 2^256 - p
-    u64 t = borrow;
-    borrow = false;
-    u256 sub { u128 { t, -(t << 32) }, u128 { -t, (t << 32) - (t << 1) } };
-    output = output.subc(sub, borrow);
+static u256 modular_add(u256 const& left, u256 const& right)
+{
+    u64 const a[4] { left.low().low(), left.low().high(), left.high().low(), left.high().high() };
+    u64 const b[4] { right.low().low(), right.low().high(), right.high().low(), right.high().high() };
+
+    // The sum is less than 2p, so subtracting p once is enough, if it's at least p.
+    u64 carry = 0;
+    u64 sum[4];
+    for (size_t i = 0; i < 4; ++i)
+        sum[i] = add_with_carry(a[i], b[i], carry);
+    return reduce_once(sum, carry);
+}
 
-    // If there is still left borrow, add p by subtracting 2^256 - p
-    t = borrow;
-    sub = { u128 { t, -(t << 32) }, u128 { -t, (t << 32) - (t << 1) } };
-    return output - sub;
+static u256 modular_sub(u256 const& left, u256 const& right)
+{
+    u64 const a[4] { left.low().low(), left.low().high(), left.high().low(), left.high().high() };
+    u64 const b[4] { right.low().low(), right.low().high(), right.high().low(), right.high().high() };
+
+    u64 borrow = 0;
+    u64 difference[4];
+    for (size_t i = 0; i < 4; ++i)
+        difference[i] = subtract_with_borrow(a[i], b[i], borrow);
+
+    // If the difference went negative, add p back.
+    u64 mask = -borrow;
+    u64 carry = 0;
+    for (size_t i = 0; i < 4; ++i)
+        difference[i] = add_with_carry(difference[i], PRIME_LIMBS[i] & mask, carry);
+    return { u128 { difference[0], difference[1] }, u128 { difference[2], difference[3] } };
 }
 
 static u256 modular_multiply(u256 const& left, u256 const& right)
 {
     // Modular multiplication using the Montgomery method: https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
     // This requires that the inputs to this function are in Montgomery form.
+    // The reduction is interleaved with the multiplication, one limb at a time ("CIOS" in Koc et al., "Analyzing and Comparing
+    // Montgomery Multiplication Algorithms"). As p = -1 mod 2^64, the multiple of p that clears the lowest limb is that limb itself.
+    u64 const a[4] { left.low().low(), left.low().high(), left.high().low(), left.high().high() };
+    u64 const b[4] { right.low().low(), right.low().high(), right.high().low(), right.high().high() };
+
+    u64 t[5] {};
+    for (size_t i = 0; i < 4; ++i) {
+        // t += a * b[i]
+        u64 carry = 0;
+        for (size_t j = 0; j < 4; ++j)
+            t[j] = multiply_add(a[j], b[i], t[j], carry);
+        u64 top = t[4] + carry;
+        u64 top_carry = top < carry;
+
+        // t = (t + t[0] * p) / 2^64
+        u64 m = t[0];
+        carry = 0;
+        multiply_add(m, PRIME_LIMBS[0], t[0], carry);
+        for (size_t j = 1; j < 4; ++j)
+            t[j - 1] = multiply_add(m, PRIME_LIMBS[j], t[j], carry);
+        t[3] = top + carry;
+        t[4] = top_carry + (t[3] < carry);
+    }
 
-    // T = left * right
-    u512 mult = multiply(left, right);
-
-    // m = ((T mod R) * curve_p')
-    u512 m = multiply(mult.low(), PRIME_INVERSE_MOD_R);
-
-    // mp = (m mod R) * curve_p
-    u512 mp = multiply(m.low(), PRIME);
-
-    // t = (T + mp)
-    bool carry = false;
-    mult.low().addc(mp.low(), carry);
-
-    // output = t / R
-    return modular_add(mult.high(), mp.high(), carry);
+    // The result is less than 2p, so subtracting p once is enough, if it's at least p.
+    return reduce_once({ t[0], t[1], t[2], t[3] }, t[4]);
 }
 
 static u256 modular_square(u256 const& value)
@@ -205,11 +258,8 @@ static void point_double(JacobianPoint& output_point, JacobianPoint const& point
 {
     // Based on "Point Doubling" from http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
 
-    // if (Y == 0)
-    //   return POINT_AT_INFINITY
-    if (point.y.is_zero_constant_time()) {
-        VERIFY_NOT_REACHED();
-    }
+    // NOTE: The point at infinity is any point with Z = 0, and doubling it gives Z' = 0 again, so it needs no special case.
+    //       Y can't be 0 otherwise, as no point on this curve has an order of 2.
 
     u256 temp;
 
@@ -258,12 +308,8 @@ static void point_double(JacobianPoint& output_point, JacobianPoint const& point
 static void point_add(JacobianPoint& output_point, JacobianPoint const& point_a, JacobianPoint const& point_b)
 {
     // Based on "Point Addition" from  http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
-    if (point_a.x.is_zero_constant_time() && point_a.y.is_zero_constant_time() && point_a.z.is_zero_constant_time()) {
-        output_point.x = point_b.x;
-        output_point.y = point_b.y;
-        output_point.z = point_b.z;
-        return;
-    }
+    bool a_is_infinity = point_a.z.is_zero_constant_time();
+    bool b_is_infinity = point_b.z.is_zero_constant_time();
 
     u256 temp;
 
@@ -286,13 +332,11 @@ static void point_add(JacobianPoint& output_point, JacobianPoint const& point_a,
     //     return POINT_AT_INFINITY
     //   else
     //     return POINT_DOUBLE(X1, Y1, Z1)
-    if (u1.is_equal_to_constant_time(u2)) {
-        if (s1.is_equal_to_constant_time(s2)) {
-            point_double(output_point, point_a);
-            return;
-        } else {
-            VERIFY_NOT_REACHED();
-        }
+    // NOTE: For S1 != S2, H = 0 makes the formulas below give Z3 = 0 on their own.
+    //       The points being equal only happens with negligible probability during a scalar multiplication.
+    if (u1.is_equal_to_constant_time(u2) && s1.is_equal_to_constant_time(s2) && !a_is_infinity && !b_is_infinity) {
+        point_double(output_point, point_a);
+        return;
     }
 
     // H = U2 - U1
@@ -316,24 +360,69 @@ static void point_add(JacobianPoint& output_point, JacobianPoint const& point_a,
     // Z3 = H*Z1*Z2
     u256 z3 = modular_multiply(h, point_a.z);
     z3 = modular_multiply(z3, point_b.z);
-    // return (X3, Y3, Z3)
-    output_point.x = x3;
-    output_point.y = y3;
-    output_point.z = z3;
+
+    // If either point is the point at infinity, the result is the other one.
+    output_point.x = select(select(x3, point_a.x, b_is_infinity), point_b.x, a_is_infinity);
+    output_point.y = select(select(y3, point_a.y, b_is_infinity), point_b.y, a_is_infinity);
+    output_point.z = select(select(z3, point_a.z, b_is_infinity), point_b.z, a_is_infinity);
+}
+
+// A point with Z = 1, which saves a good part of the work of adding it.
+struct AffinePoint {
+    u256 x;
+    u256 y;
+};
+
+static void point_add_affine(JacobianPoint& output_point, JacobianPoint const& point_a, AffinePoint const& point_b)
+{
+    // Like point_add(), with Z2 = 1.
+    bool a_is_infinity = point_a.z.is_zero_constant_time();
+
+    u256 temp = modular_square(point_a.z);
+    // U2 = X2*Z1^2
+    u256 u2 = modular_multiply(point_b.x, temp);
+    // S2 = Y2*Z1^3
+    u256 s2 = modular_multiply(point_b.y, temp);
+    s2 = modular_multiply(s2, point_a.z);
+
+    u256 x1 = point_a.x;
+    u256 y1 = point_a.y;
+    if (x1.is_equal_to_constant_time(u2) && y1.is_equal_to_constant_time(s2) && !a_is_infinity) {
+        point_double(output_point, point_a);
+        return;
+    }
+
+    // H = U2 - X1
+    u256 h = modular_sub(u2, point_a.x);
+    u256 h2 = modular_square(h);
+    u256 h3 = modular_multiply(h2, h);
+    // R = S2 - Y1
+    u256 r = modular_sub(s2, point_a.y);
+    // X3 = R^2 - H^3 - 2*X1*H^2
+    u256 x3 = modular_square(r);
+    x3 = modular_sub(x3, h3);
+    u256 x1h2 = modular_multiply(point_a.x, h2);
+    x3 = modular_sub(x3, modular_add(x1h2, x1h2));
+    // Y3 = R*(X1*H^2 - X3) - Y1*H^3
+    u256 y3 = modular_sub(x1h2, x3);
+    y3 = modular_multiply(y3, r);
+    y3 = modular_sub(y3, modular_multiply(point_a.y, h3));
+    // Z3 = H*Z1
+    u256 z3 = modular_multiply(h, point_a.z);
+
+    output_point.x = select(x3, point_b.x, a_is_infinity);
+    output_point.y = select(y3, point_b.y, a_is_infinity);
+    output_point.z = select(z3, ONE_MONTGOMERY, a_is_infinity);
 }
 
 static void convert_jacobian_to_affine(JacobianPoint& point)
 {
-    u256 temp;
-    // X' = X/Z^2
-    temp = modular_square(point.z);
-    temp = modular_inverse(temp);
-    point.x = modular_multiply(point.x, temp);
-    // Y' = Y/Z^3
-    temp = modular_square(point.z);
-    temp = modular_multiply(temp, point.z);
-    temp = modular_inverse(temp);
-    point.y = modular_multiply(point.y, temp);
+    // X' = X/Z^2, Y' = Y/Z^3
+    u256 z_inverse = modular_inverse(point.z);
+    u256 z_inverse_2 = modular_square(z_inverse);
+    point.x = modular_multiply(point.x, z_inverse_2);
+    point.y = modular_multiply(point.y, modular_multiply(z_inverse_2, z_inverse));
+    point.z = ONE_MONTGOMERY;
 }
 
 static bool is_point_on_curve(JacobianPoint const& point)
@@ -362,21 +451,101 @@ ErrorOr<ByteBuffer> SECP256r1::generate_private_key()
     return buffer;
 }
 
-ErrorOr<ByteBuffer> SECP256r1::generate_public_key(ReadonlyBytes a)
+// The scalar is processed in 4-bit windows, from the least significant one.
+static constexpr size_t WINDOW_BITS = 4;
+static constexpr size_t WINDOW_COUNT = 256 / WINDOW_BITS;
+static constexpr size_t WINDOW_SIZE = 1 << WINDOW_BITS;
+
+static u64 scalar_window(u256 const& scalar, size_t index)
 {
-    // clang-format off
-    u8 generator_bytes[65] {
-        0x04,
-        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
-        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
-        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
-        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
-    };
-    // clang-format on
-    return compute_coordinate(a, { generator_bytes, 65 });
+    u64 const limbs[4] { scalar.low().low(), scalar.low().high(), scalar.high().low(), scalar.high().high() };
+    constexpr size_t windows_per_limb = 64 / WINDOW_BITS;
+    return (limbs[index / windows_per_limb] >> (index % windows_per_limb * WINDOW_BITS)) & (WINDOW_SIZE - 1);
 }
 
-ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes)
+// NOTE: The lookups below read every entry, so that which one was wanted doesn't show in the memory access pattern.
+static JacobianPoint select_point(JacobianPoint const (&points)[WINDOW_SIZE], u64 index)
+{
+    JacobianPoint result;
+    for (u64 i = 0; i < WINDOW_SIZE; ++i) {
+        bool is_wanted = i == index;
+        result.x = select(result.x, points[i].x, is_wanted);
+        result.y = select(result.y, points[i].y, is_wanted);
+        result.z = select(result.z, points[i].z, is_wanted);
+    }
+    return result;
+}
+
+static AffinePoint select_point(AffinePoint const (&points)[WINDOW_SIZE], u64 index)
+{
+    AffinePoint result = points[1];
+    for (u64 i = 2; i < WINDOW_SIZE; ++i) {
+        bool is_wanted = i == index;
+        result.x = select(result.x, points[i].x, is_wanted);
+        result.y = select(result.y, points[i].y, is_wanted);
+    }
+    return result;
+}
+
+static JacobianPoint generator_in_montgomery_form()
+{
+    static constexpr u256 GENERATOR_X { u128 { 0xf4a13945d898c296ull, 0x77037d812deb33a0ull }, u128 { 0xf8bce6e563a440f2ull, 0x6b17d1f2e12c4247ull } };
+    static constexpr u256 GENERATOR_Y { u128 { 0xcbb6406837bf51f5ull, 0x2bce33576b315eceull }, u128 { 0x8ee7eb4a7c0f9e16ull, 0x4fe342e2fe1a7f9bull } };
+    return { to_montgomery(GENERATOR_X), to_montgomery(GENERATOR_Y), ONE_MONTGOMERY };
+}
+
+// Multiples of the generator, so that multiplying it by a scalar takes only one addition per window, and no doublings.
+struct GeneratorTable {
+    // points[i][d] = d * 16^i * G, for d from 1 to 15 (points[i][0] isn't used)
+    AffinePoint points[WINDOW_COUNT][WINDOW_SIZE];
+};
+
+static GeneratorTable const& generator_table()
+{
+    static GeneratorTable const* s_table = [] {
+        auto* table = new GeneratorTable;
+        Vector<JacobianPoint> points;
+        points.resize(WINDOW_COUNT * WINDOW_SIZE);
+
+        auto base = generator_in_montgomery_form();
+        for (size_t i = 0; i < WINDOW_COUNT; ++i) {
+            auto* window_points = &points[i * WINDOW_SIZE];
+            window_points[1] = base;
+            for (size_t d = 2; d < WINDOW_SIZE; ++d)
+                point_add(window_points[d], window_points[d - 1], base);
+            for (size_t j = 0; j < WINDOW_BITS; ++j)
+                point_double(base, base);
+        }
+
+        // Converting all the points to affine coordinates only takes one inversion with Montgomery's trick:
+        // Invert the product of all Z coordinates, then peel the individual inverses off it one at a time.
+        Vector<u256> z_products;
+        z_products.resize(points.size());
+        u256 product = ONE_MONTGOMERY;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (i % WINDOW_SIZE != 0)
+                product = modular_multiply(product, points[i].z);
+            z_products[i] = product;
+        }
+        u256 inverse = modular_inverse(product);
+        for (size_t i = points.size(); i-- > 0;) {
+            if (i % WINDOW_SIZE == 0)
+                continue;
+            // inverse = 1 / (Z_1 * ... * Z_i), so 1 / Z_i = inverse * (Z_1 * ... * Z_i-1)
+            u256 z_inverse = modular_multiply(inverse, i == 1 ? ONE_MONTGOMERY : z_products[i - 1]);
+            inverse = modular_multiply(inverse, points[i].z);
+
+            u256 z_inverse_2 = modular_square(z_inverse);
+            auto& point = table->points[i / WINDOW_SIZE][i % WINDOW_SIZE];
+            point.x = modular_multiply(points[i].x, z_inverse_2);
+            point.y = modular_multiply(points[i].y, modular_multiply(z_inverse_2, z_inverse));
+        }
+        return table;
+    }();
+    return *s_table;
+}
+
+static ErrorOr<u256> import_scalar(ReadonlyBytes scalar_bytes)
 {
     VERIFY(scalar_bytes.size() == 32);
 
@@ -385,6 +554,60 @@ ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, Re
     scalar = modular_reduce_order(scalar);
     if (scalar.is_zero_constant_time())
         return Error::from_string_literal("SECP256r1: scalar is zero");
+    return scalar;
+}
+
+static ErrorOr<ByteBuffer> export_point(JacobianPoint& point)
+{
+    if (point.z.is_zero_constant_time())
+        return Error::from_string_literal("SECP256r1: result is the point at infinity");
+
+    // Convert from Jacobian coordinates back to Affine coordinates
+    convert_jacobian_to_affine(point);
+
+    // Make sure the resulting point is on the curve
+    VERIFY(is_point_on_curve(point));
+
+    // Convert the result back from Montgomery form
+    point.x = from_montgomery(point.x);
+    point.y = from_montgomery(point.y);
+    // Final modular reduction on the coordinates
+    point.x = modular_reduce(point.x);
+    point.y = modular_reduce(point.y);
+
+    // Export the values into an output buffer
+    auto buf = TRY(ByteBuffer::create_uninitialized(65));
+    buf[0] = 0x04;
+    export_big_endian(point.x, buf.bytes().slice(1, 32));
+    export_big_endian(point.y, buf.bytes().slice(33, 32));
+    return buf;
+}
+
+ErrorOr<ByteBuffer> SECP256r1::generate_public_key(ReadonlyBytes a)
+{
+    u256 scalar = TRY(import_scalar(a));
+
+    auto const& table = generator_table();
+
+    // Calculate the scalar times generator multiplication in constant time
+    JacobianPoint result;
+    JacobianPoint temp_result;
+    for (size_t i = 0; i < WINDOW_COUNT; ++i) {
+        auto window = scalar_window(scalar, i);
+        point_add_affine(temp_result, result, select_point(table.points[i], window));
+
+        auto condition = window != 0;
+        result.x = select(result.x, temp_result.x, condition);
+        result.y = select(result.y, temp_result.y, condition);
+        result.z = select(result.z, temp_result.z, condition);
+    }
+
+    return export_point(result);
+}
+
+ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes)
+{
+    u256 scalar = TRY(import_scalar(scalar_bytes));
 
     // Make sure the point is uncompressed
     if (point_bytes.size() != 65 || point_bytes[0] != 0x04)
@@ -405,41 +628,24 @@ ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, Re
     if (!is_point_on_curve(point))
         return Error::from_string_literal("SECP256r1: point is not on the curve");
 
-    JacobianPoint result;
-    JacobianPoint temp_result;
+    // multiples[d] = d * point
+    JacobianPoint multiples[WINDOW_SIZE];
+    multiples[1] = point;
+    for (size_t d = 2; d < WINDOW_SIZE; ++d)
+        point_add(multiples[d], multiples[d - 1], point);
 
-    // Calculate the scalar times point multiplication in constant time
-    for (auto i = 0; i < 256; i++) {
-        point_add(temp_result, result, point);
-
-        auto condition = (scalar & 1u) == 1u;
-        result.x = select(result.x, temp_result.x, condition);
-        result.y = select(result.y, temp_result.y, condition);
-        result.z = select(result.z, temp_result.z, condition);
-
-        point_double(point, point);
-        scalar >>= 1u;
+    // Calculate the scalar times point multiplication in constant time, from the most significant window down
+    JacobianPoint result;
+    for (size_t i = WINDOW_COUNT; i-- > 0;) {
+        for (size_t j = 0; j < WINDOW_BITS; ++j)
+            point_double(result, result);
+        // NOTE: multiples[0] is the point at infinity, which point_add() handles without branching.
+        JacobianPoint temp_result;
+        point_add(temp_result, result, select_point(multiples, scalar_window(scalar, i)));
+        result = temp_result;
     }
 
-    // Convert from Jacobian coordinates back to Affine coordinates
-    convert_jacobian_to_affine(result);
-
-    // Make sure the resulting point is on the curve
-    VERIFY(is_point_on_curve(result));
-
-    // Convert the result back from Montgomery form
-    result.x = from_montgomery(result.x);
-    result.y = from_montgomery(result.y);
-    // Final modular reduction on the coordinates
-    result.x = modular_reduce(result.x);
-    result.y = modular_reduce(result.y);
-
-    // Export the values into an output buffer
-    auto buf = TRY(ByteBuffer::create_uninitialized(65));
-    buf[0] = 0x04;
-    export_big_endian(result.x, buf.bytes().slice(1, 32));
-    export_big_endian(result.y, buf.bytes().slice(33, 32));
-    return buf;
+    return export_point(result);
 }
 
 ErrorOr<ByteBuffer> SECP256r1::derive_premaster_key(ReadonlyBytes shared_point)
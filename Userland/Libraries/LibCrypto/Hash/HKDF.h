@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <LibCrypto/Authentication/HMAC.h>
+
+namespace Crypto::Hash {
+
+// HMAC-based Extract-and-Expand Key Derivation Function
+// https://www.rfc-editor.org/rfc/rfc5869
+template<typename HashT>
+class HKDF {
+public:
+    using HashType = HashT;
+
+    // Any arguments are passed on to the hash function's constructor (e.g. the HashKind of a Hash::Manager).
+    template<typename... Args>
+    explicit HKDF(Args... args)
+        : m_hash(args...)
+    {
+    }
+
+    size_t digest_size() const { return m_hash.digest_size(); }
+
+    // https://www.rfc-editor.org/rfc/rfc5869#section-2.2
+    ErrorOr<ByteBuffer> extract(ReadonlyBytes salt, ReadonlyBytes input_keying_material) const
+    {
+        // "if not provided, [the salt] is set to a string of HashLen zeros."
+        ByteBuffer zero_salt;
+        if (salt.is_empty()) {
+            zero_salt = TRY(ByteBuffer::create_zeroed(digest_size()));
+            salt = zero_salt;
+        }
+
+        Authentication::HMAC<HashType> hmac(salt, m_hash);
+        auto prk = hmac.process(input_keying_material);
+        return ByteBuffer::copy(prk.immutable_data(), digest_size());
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc5869#section-2.3
+    ErrorOr<ByteBuffer> expand(ReadonlyBytes pseudorandom_key, ReadonlyBytes info, size_t output_length) const
+    {
+        auto hash_length = digest_size();
+        if (output_length > 255 * hash_length)
+            return Error::from_string_literal("HKDF output is too long");
+
+        auto output = TRY(ByteBuffer::create_uninitialized(output_length));
+        Authentication::HMAC<HashType> hmac(pseudorandom_key, m_hash);
+
+        // T(0) = empty string, T(N) = HMAC-Hash(PRK, T(N-1) | info | N)
+        size_t offset = 0;
+        for (u8 counter = 1; offset < output_length; ++counter) {
+            if (counter > 1)
+                hmac.update(output.bytes().slice(offset - hash_length, hash_length));
+            hmac.update(info);
+            hmac.update(&counter, 1);
+            auto block = hmac.digest();
+            auto block_length = min(hash_length, output_length - offset);
+            output.overwrite(offset, block.immutable_data(), block_length);
+            offset += block_length;
+        }
+
+        return output;
+    }
+
+private:
+    HashType m_hash;
+};
+
+}
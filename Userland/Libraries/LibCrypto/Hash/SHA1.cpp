@@ -7,8 +7,13 @@
 #include <AK/Endian.h>
 #include <AK/Memory.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 
@@ -20,8 +25,9 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
 inline void SHA1::transform(u8 const* data)
 {
     u32 blocks[80];
-    for (size_t i = 0; i < 16; ++i)
-        blocks[i] = AK::convert_between_host_and_network_endian(((u32 const*)data)[i]);
+    // NOTE: The data may come straight from the message, so it isn't necessarily aligned.
+    for (size_t i = 0, j = 0; i < 16; ++i, j += 4)
+        blocks[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
 
     // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
     for (size_t i = 16; i < Rounds; ++i)
@@ -67,16 +73,112 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+#if CRYPTO_HAS_X86_ACCELERATION
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i load_message_words(u8 const* data, __m128i byte_swap)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), byte_swap);
+}
+
+// Message words 4n to 4n + 3, from those before them
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i next_message_words(__m128i words_minus_16, __m128i words_minus_12, __m128i words_minus_8, __m128i words_minus_4)
+{
+    return _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(words_minus_16, words_minus_12), words_minus_8), words_minus_4);
+}
+
+// Does 4 rounds, with e being the a from 4 rounds ago (which the next 4 rounds need as their e)
+template<int RoundFunction>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void four_rounds(__m128i& abcd, __m128i& e, __m128i message_words)
+{
+    auto e_plus_message_words = _mm_sha1nexte_epu32(e, message_words);
+    e = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e_plus_message_words, RoundFunction);
+}
+
+[[gnu::target("sha,sse4.1")]] static void transform_blocks_with_sha_extensions(u32 (&state)[5], u8 const* data, size_t block_count)
+{
+    auto const byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    // The instructions keep a in the highest element
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1B);
+    auto e = _mm_set_epi32(state[4], 0, 0, 0);
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto abcd_before = abcd;
+        auto e_before = e;
+
+        auto w0 = load_message_words(data, byte_swap);
+        auto w1 = load_message_words(data + 16, byte_swap);
+        auto w2 = load_message_words(data + 32, byte_swap);
+        auto w3 = load_message_words(data + 48, byte_swap);
+
+        // The first 4 rounds add e themselves, as there are no rounds before them to have computed it
+        auto e_plus_message_words = _mm_add_epi32(e, w0);
+        e = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e_plus_message_words, 0);
+        four_rounds<0>(abcd, e, w1);
+        four_rounds<0>(abcd, e, w2);
+        four_rounds<0>(abcd, e, w3);
+        four_rounds<0>(abcd, e, w0 = next_message_words(w0, w1, w2, w3));
+        four_rounds<1>(abcd, e, w1 = next_message_words(w1, w2, w3, w0));
+        four_rounds<1>(abcd, e, w2 = next_message_words(w2, w3, w0, w1));
+        four_rounds<1>(abcd, e, w3 = next_message_words(w3, w0, w1, w2));
+        four_rounds<1>(abcd, e, w0 = next_message_words(w0, w1, w2, w3));
+        four_rounds<1>(abcd, e, w1 = next_message_words(w1, w2, w3, w0));
+        four_rounds<2>(abcd, e, w2 = next_message_words(w2, w3, w0, w1));
+        four_rounds<2>(abcd, e, w3 = next_message_words(w3, w0, w1, w2));
+        four_rounds<2>(abcd, e, w0 = next_message_words(w0, w1, w2, w3));
+        four_rounds<2>(abcd, e, w1 = next_message_words(w1, w2, w3, w0));
+        four_rounds<2>(abcd, e, w2 = next_message_words(w2, w3, w0, w1));
+        four_rounds<3>(abcd, e, w3 = next_message_words(w3, w0, w1, w2));
+        four_rounds<3>(abcd, e, w0 = next_message_words(w0, w1, w2, w3));
+        four_rounds<3>(abcd, e, w1 = next_message_words(w1, w2, w3, w0));
+        four_rounds<3>(abcd, e, w2 = next_message_words(w2, w3, w0, w1));
+        four_rounds<3>(abcd, e, w3 = next_message_words(w3, w0, w1, w2));
+
+        // Rotated, the a from 4 rounds before the end is the final e
+        e = _mm_sha1nexte_epu32(e, e_before);
+        abcd = _mm_add_epi32(abcd, abcd_before);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = _mm_extract_epi32(e, 3);
+}
+#endif
+
+void SHA1::transform_blocks(u8 const* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (cpu_supports_sha()) {
+        transform_blocks_with_sha_extensions(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA1::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += 512;
+        m_data_length = 0;
     }
+
+    // Whole blocks are hashed right from the message, without copying them into the buffer first
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += 512 * block_count;
+
+    m_data_length = length % BlockSize;
+    __builtin_memcpy(m_data_buffer, message + block_count * BlockSize, m_data_length);
 }
 
 SHA1::DigestType SHA1::digest()
@@ -98,7 +200,7 @@ SHA1::DigestType SHA1::peek()
     __builtin_memcpy(state, m_state, 20);
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -114,7 +216,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -131,7 +233,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (size_t i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
@@ -4,9 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/QuickSort.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -66,32 +72,261 @@ inline void SHA256::transform(u8 const* data)
     m_state[7] += h;
 }
 
-void SHA256::update(u8 const* message, size_t length)
+#if CRYPTO_HAS_X86_ACCELERATION
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i load_message_words(u8 const* data, __m128i byte_swap)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), byte_swap);
+}
+
+// Message words 4n to 4n + 3, from those before them
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i next_message_words(__m128i words_minus_16, __m128i words_minus_12, __m128i words_minus_8, __m128i words_minus_4)
+{
+    auto words_minus_7 = _mm_alignr_epi8(words_minus_4, words_minus_8, 4);
+    return _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(words_minus_16, words_minus_12), words_minus_7), words_minus_4);
+}
+
+// Does rounds 4n to 4n + 3, with the state split into its a, b, e and f and its c, d, g and h words
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void four_rounds(__m128i& abef, __m128i& cdgh, __m128i message_words, size_t n)
+{
+    auto words = _mm_add_epi32(message_words, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[n * 4])));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(words, 0x0E));
+}
+
+[[gnu::target("sha,sse4.1")]] static void transform_blocks_with_sha_extensions(u32 (&state)[8], u8 const* data, size_t block_count)
+{
+    auto const byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    auto dcba = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0]));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4]));
+    auto badc = _mm_shuffle_epi32(dcba, 0xB1);
+    auto efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+    auto abef = _mm_alignr_epi8(badc, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, badc, 0xF0);
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto abef_before = abef;
+        auto cdgh_before = cdgh;
+
+        auto w0 = load_message_words(data, byte_swap);
+        auto w1 = load_message_words(data + 16, byte_swap);
+        auto w2 = load_message_words(data + 32, byte_swap);
+        auto w3 = load_message_words(data + 48, byte_swap);
+        four_rounds(abef, cdgh, w0, 0);
+        four_rounds(abef, cdgh, w1, 1);
+        four_rounds(abef, cdgh, w2, 2);
+        four_rounds(abef, cdgh, w3, 3);
+        for (size_t n = 4; n < 16; n += 4) {
+            four_rounds(abef, cdgh, w0 = next_message_words(w0, w1, w2, w3), n);
+            four_rounds(abef, cdgh, w1 = next_message_words(w1, w2, w3, w0), n + 1);
+            four_rounds(abef, cdgh, w2 = next_message_words(w2, w3, w0, w1), n + 2);
+            four_rounds(abef, cdgh, w3 = next_message_words(w3, w0, w1, w2), n + 3);
         }
-        m_data_buffer[m_data_length++] = message[i];
+
+        abef = _mm_add_epi32(abef, abef_before);
+        cdgh = _mm_add_epi32(cdgh, cdgh_before);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1B);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+// The AVX2 versions hash 8 messages side by side, one in each 32-bit lane.
+template<int Bits>
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i rotate_right(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, Bits), _mm256_slli_epi32(x, 32 - Bits));
+}
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+
+[[gnu::target("avx2")]] static void transform_8_lanes(__m256i (&state)[8], u8 const* const (&blocks)[8], __m256i active_lanes)
+{
+    __m256i m[64];
+    for (size_t i = 0; i < 16; ++i) {
+        u32 words[8];
+        for (size_t lane = 0; lane < 8; ++lane) {
+            __builtin_memcpy(&words[lane], blocks[lane] + i * 4, sizeof(u32));
+            words[lane] = AK::convert_between_host_and_big_endian(words[lane]);
+        }
+        m[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words));
     }
+    for (size_t i = 16; i < 64; ++i) {
+        auto sign0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<7>(m[i - 15]), rotate_right<18>(m[i - 15])), _mm256_srli_epi32(m[i - 15], 3));
+        auto sign1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<17>(m[i - 2]), rotate_right<19>(m[i - 2])), _mm256_srli_epi32(m[i - 2], 10));
+        m[i] = add(add(sign1, m[i - 7]), add(sign0, m[i - 16]));
+    }
+
+    auto a = state[0], b = state[1], c = state[2], d = state[3],
+         e = state[4], f = state[5], g = state[6], h = state[7];
+    for (size_t i = 0; i < 64; ++i) {
+        auto ep1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<6>(e), rotate_right<11>(e)), rotate_right<25>(e));
+        auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto temp0 = add(add(h, ep1), add(ch, add(_mm256_set1_epi32(SHA256Constants::RoundConstants[i]), m[i])));
+        auto ep0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<2>(a), rotate_right<13>(a)), rotate_right<22>(a));
+        auto maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        auto temp1 = add(ep0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, temp0);
+        d = c;
+        c = b;
+        b = a;
+        a = add(temp0, temp1);
+    }
+
+    __m256i const results[8] { a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = _mm256_blendv_epi8(state[i], add(state[i], results[i]), active_lanes);
+}
+
+[[gnu::target("avx2")]] static void hash_many_with_avx2(Span<ReadonlyBytes const> messages, Span<SHA256::DigestType> digests)
+{
+    constexpr size_t block_size = 64;
+    struct Lane {
+        u8 const* message { nullptr };
+        size_t message_blocks { 0 };
+        size_t block_count { 0 };
+        // The last bytes of the message, padded and followed by its length
+        u8 tail[2 * block_size] {};
+    };
+    static u8 const unused_block[block_size] {};
+
+    // Messages of similar lengths go side by side, so that few lanes idle while the others finish
+    Vector<size_t> order;
+    for (size_t i = 0; i < messages.size(); ++i)
+        order.append(i);
+    quick_sort(order, [&](size_t a, size_t b) { return messages[a].size() > messages[b].size(); });
+
+    for (size_t first = 0; first < order.size(); first += 8) {
+        Lane lanes[8];
+        size_t lane_count = min<size_t>(8, order.size() - first);
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            auto message = messages[order[first + lane]];
+            auto& state = lanes[lane];
+            state.message = message.data();
+            state.message_blocks = message.size() / block_size;
+            auto tail_size = message.size() % block_size;
+            __builtin_memcpy(state.tail, message.data() + state.message_blocks * block_size, tail_size);
+            state.tail[tail_size] = 0x80;
+            auto tail_blocks = tail_size + 1 + sizeof(u64) <= block_size ? 1 : 2;
+            auto bit_length = AK::convert_between_host_and_big_endian(static_cast<u64>(message.size()) * 8);
+            __builtin_memcpy(state.tail + tail_blocks * block_size - sizeof(u64), &bit_length, sizeof(u64));
+            state.block_count = state.message_blocks + tail_blocks;
+        }
+
+        __m256i state[8];
+        for (size_t i = 0; i < 8; ++i)
+            state[i] = _mm256_set1_epi32(SHA256Constants::InitializationHashes[i]);
+
+        auto block_counts = _mm256_setr_epi32(lanes[0].block_count, lanes[1].block_count, lanes[2].block_count, lanes[3].block_count,
+            lanes[4].block_count, lanes[5].block_count, lanes[6].block_count, lanes[7].block_count);
+        for (size_t block = 0; block < lanes[0].block_count; ++block) {
+            u8 const* blocks[8];
+            for (size_t lane = 0; lane < 8; ++lane) {
+                auto& state = lanes[lane];
+                if (block < state.message_blocks)
+                    blocks[lane] = state.message + block * block_size;
+                else if (block < state.block_count)
+                    blocks[lane] = state.tail + (block - state.message_blocks) * block_size;
+                else
+                    blocks[lane] = unused_block;
+            }
+            transform_8_lanes(state, blocks, _mm256_cmpgt_epi32(block_counts, _mm256_set1_epi32(block)));
+        }
+
+        u32 words[8][8];
+        for (size_t i = 0; i < 8; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(words[i]), state[i]);
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+            auto& digest = digests[order[first + lane]];
+            for (size_t i = 0; i < 8; ++i) {
+                auto word = AK::convert_between_host_and_big_endian(words[i][lane]);
+                __builtin_memcpy(digest.data + i * sizeof(u32), &word, sizeof(u32));
+            }
+        }
+    }
+}
+#endif
+
+void SHA256::transform_blocks(u8 const* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (cpu_supports_sha()) {
+        transform_blocks_with_sha_extensions(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
+void SHA256::update(u8 const* message, size_t length)
+{
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += 512;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed right from the message, without copying them into the buffer first
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += 512 * block_count;
+
+    m_data_length = length % BlockSize;
+    __builtin_memcpy(m_data_buffer, message + block_count * BlockSize, m_data_length);
+}
+
+Vector<SHA256::DigestType> SHA256::hash_many(Span<ReadonlyBytes const> messages)
+{
+    Vector<DigestType> digests;
+    digests.resize(messages.size());
+
+#if CRYPTO_HAS_X86_ACCELERATION
+    // NOTE: With the SHA extensions, hashing one message after another is faster still.
+    if (!cpu_supports_sha() && cpu_supports_avx2()) {
+        hash_many_with_avx2(messages, digests);
+        return digests;
+    }
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = hash(messages[i].data(), messages[i].size());
+    return digests;
 }
 
 SHA256::DigestType SHA256::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA256::DigestType SHA256::peek()
+{
+    // NOTE: Finish a copy, so that the hash can still be updated afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA256::DigestType SHA256::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -107,7 +342,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -124,7 +359,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -198,12 +433,19 @@ void SHA384::update(u8 const* message, size_t length)
 
 SHA384::DigestType SHA384::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA384::DigestType SHA384::peek()
+{
+    // NOTE: Finish a copy, so that the hash can still be updated afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA384::DigestType SHA384::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
@@ -322,12 +564,19 @@ void SHA512::update(u8 const* message, size_t length)
 
 SHA512::DigestType SHA512::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA512::DigestType SHA512::peek()
+{
+    // NOTE: Finish a copy, so that the hash can still be updated afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA512::DigestType SHA512::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
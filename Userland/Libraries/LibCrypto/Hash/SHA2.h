@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/StringBuilder.h>
+#include <AK/Vector.h>
 #include <LibCrypto/Hash/HashFunction.h>
 
 #ifndef KERNEL
@@ -100,6 +101,9 @@ public:
     inline static DigestType hash(ByteBuffer const& buffer) { return hash(buffer.data(), buffer.size()); }
     inline static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
+    // Hashes several independent messages. Where the CPU can hash a number of them side by side, this is faster than hashing one after another.
+    static Vector<DigestType> hash_many(Span<ReadonlyBytes const> messages);
+
 #ifndef KERNEL
     virtual String class_name() const override
     {
@@ -116,7 +120,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -168,6 +174,7 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
 
     u8 m_data_buffer[BlockSize] {};
@@ -220,6 +227,7 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
 
     u8 m_data_buffer[BlockSize] {};
@@ -78,88 +78,106 @@ public:
         for (size_t i = 0; i < DB.size(); ++i)
             DB_data[i] ^= DB_mask[i];
 
-        auto count = (8 - (em_length * 8 - em_bits));
-        DB_data[0] &= (0xff >> count) << count;
+        DB_data[0] &= 0xff >> (em_length * 8 - em_bits);
 
         out.overwrite(0, DB.data(), DB.size());
         out.overwrite(DB.size(), hash.data, hash_fn.DigestSize);
         out[DB.size() + hash_fn.DigestSize] = 0xbc;
     }
 
+    // https://www.rfc-editor.org/rfc/rfc8017#section-9.1.2
     virtual VerificationConsistency verify(ReadonlyBytes msg, ReadonlyBytes emsg, size_t em_bits) override
     {
         auto& hash_fn = this->hasher();
         hash_fn.update(msg);
         auto message_hash = hash_fn.digest();
 
-        if (emsg.size() < HashFunction::DigestSize + SaltLength + 2)
+        constexpr auto hash_length = HashFunction::DigestSize;
+        auto em_length = (em_bits + 7) / 8;
+
+        // NOTE: The encoded message may come with leading zeros to spare (e.g. when it's as long as the modulus),
+        //       or without some it needs (when it's the result of a big integer export).
+        while (emsg.size() > em_length) {
+            if (emsg[0] != 0)
+                return VerificationConsistency::Inconsistent;
+            emsg = emsg.slice(1);
+        }
+        Vector<u8, 512> padded_emsg;
+        if (emsg.size() < em_length) {
+            padded_emsg.resize(em_length);
+            emsg.copy_to(padded_emsg.span().slice(em_length - emsg.size()));
+            emsg = padded_emsg;
+        }
+
+        if (em_length < hash_length + SaltLength + 2)
             return VerificationConsistency::Inconsistent;
 
-        if (emsg[emsg.size() - 1] != 0xbc)
+        if (emsg[em_length - 1] != 0xbc)
             return VerificationConsistency::Inconsistent;
 
-        auto mask_length = emsg.size() - HashFunction::DigestSize - 1;
+        auto mask_length = em_length - hash_length - 1;
         auto masked_DB = emsg.slice(0, mask_length);
-        auto H = emsg.slice(mask_length, HashFunction::DigestSize);
+        auto H = emsg.slice(mask_length, hash_length);
 
-        auto length_to_check = 8 * emsg.size() - em_bits;
-        auto octet = masked_DB[0];
-        for (size_t i = 0; i < length_to_check; ++i)
-            if ((octet >> (8 - i)) & 0x01)
-                return VerificationConsistency::Inconsistent;
+        // The leftmost 8 * emLen - emBits bits of the leftmost octet in maskedDB have to be zero.
+        auto unused_bits = 8 * em_length - em_bits;
+        u8 unused_bits_mask = ~(0xff >> unused_bits);
+        if (masked_DB[0] & unused_bits_mask)
+            return VerificationConsistency::Inconsistent;
 
-        Vector<u8, 256> DB_mask;
+        Vector<u8, 512> DB_mask;
         DB_mask.resize(mask_length);
-        Bytes DB_mask_buffer { DB_mask };
-        MGF1(H, mask_length, DB_mask_buffer);
+        MGF1(H, mask_length, DB_mask.span());
 
-        Vector<u8, 256> DB;
+        Vector<u8, 512> DB;
         DB.resize(mask_length);
 
         for (size_t i = 0; i < mask_length; ++i)
             DB[i] = masked_DB[i] ^ DB_mask[i];
 
-        DB[0] &= 0xff >> (8 - length_to_check);
+        DB[0] &= ~unused_bits_mask;
 
-        auto check_octets = emsg.size() - HashFunction::DigestSize - SaltLength - 2;
-        for (size_t i = 0; i < check_octets; ++i) {
+        // DB = PS || 0x01 || salt, where PS is all zeros.
+        auto padding_length = em_length - hash_length - SaltLength - 2;
+        for (size_t i = 0; i < padding_length; ++i) {
             if (DB[i])
                 return VerificationConsistency::Inconsistent;
         }
 
-        if (DB[check_octets + 1] != 0x01)
+        if (DB[padding_length] != 0x01)
             return VerificationConsistency::Inconsistent;
 
         auto* salt = DB.span().offset(mask_length - SaltLength);
-        u8 m_prime[8 + HashFunction::DigestSize + SaltLength] { 0 };
+        u8 m_prime[8 + hash_length + SaltLength] { 0 };
 
         auto m_prime_buffer = Bytes { m_prime, sizeof(m_prime) };
 
-        m_prime_buffer.overwrite(8, message_hash.data, HashFunction::DigestSize);
-        m_prime_buffer.overwrite(8 + HashFunction::DigestSize, salt, SaltLength);
+        m_prime_buffer.overwrite(8, message_hash.data, hash_length);
+        m_prime_buffer.overwrite(8 + hash_length, salt, SaltLength);
 
         hash_fn.update(m_prime_buffer);
         auto H_prime = hash_fn.digest();
 
-        if (!timing_safe_compare(message_hash.data, H_prime.data, HashFunction::DigestSize))
+        if (!timing_safe_compare(H.data(), H_prime.data, hash_length))
             return VerificationConsistency::Inconsistent;
 
         return VerificationConsistency::Consistent;
     }
 
+    // https://www.rfc-editor.org/rfc/rfc8017#appendix-B.2.1
     void MGF1(ReadonlyBytes seed, size_t length, Bytes out)
     {
         auto& hash_fn = this->hasher();
-        ByteBuffer T;
-        for (size_t counter = 0; counter < length / HashFunction::DigestSize - 1; ++counter) {
+        size_t offset = 0;
+        for (u32 counter = 0; offset < length; ++counter) {
+            u8 counter_bytes[4] { (u8)(counter >> 24), (u8)(counter >> 16), (u8)(counter >> 8), (u8)counter };
             hash_fn.update(seed);
-            hash_fn.update((u8*)&counter, 4);
-            if (auto result = T.try_append(hash_fn.digest().data, HashFunction::DigestSize); result.is_error()) {
-                dbgln("EMSA_PSS: MGF1 digest failed: {}", result.error());
-                return;
-            }
+            hash_fn.update(counter_bytes, 4);
+            auto digest = hash_fn.digest();
+            auto size = min(length - offset, HashFunction::DigestSize);
+            out.overwrite(offset, digest.data, size);
+            offset += size;
         }
-        out.overwrite(0, T.data(), length);
     }
 
 private:
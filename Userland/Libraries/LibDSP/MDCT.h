@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 
 namespace DSP {
@@ -19,7 +20,7 @@ public:
     {
         for (size_t n = 0; n < N; n++) {
             for (size_t k = 0; k < N / 2; k++) {
-                m_phi[n][k] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
+                m_phi[k][n] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
             }
         }
     }
@@ -28,16 +29,28 @@ public:
     {
         assert(N == 2 * data.size());
         assert(N == output.size());
-        for (size_t n = 0; n < N; n++) {
+
+        // The table is stored with the outputs next to each other, so four of them can be accumulated at once.
+        size_t n = 0;
+        for (; n + 4 <= N; n += 4) {
+            AK::SIMD::f32x4 sum {};
+            for (size_t k = 0; k < N / 2; k++) {
+                AK::SIMD::f32x4 phi;
+                __builtin_memcpy(&phi, &m_phi[k][n], sizeof(phi));
+                sum += data[k] * phi;
+            }
+            __builtin_memcpy(&output[n], &sum, sizeof(sum));
+        }
+        for (; n < N; n++) {
             output[n] = 0;
             for (size_t k = 0; k < N / 2; k++) {
-                output[n] += data[k] * m_phi[n][k];
+                output[n] += data[k] * m_phi[k][n];
             }
         }
     }
 
 private:
-    Array<Array<float, N / 2>, N> m_phi;
+    Array<Array<float, N>, N / 2> m_phi;
 };
 
 }
@@ -38,6 +38,11 @@ static HashMap<String, NonnullRefPtr<ELF::DynamicLoader>> s_loaders;
 static String s_main_program_name;
 static OrderedHashMap<String, NonnullRefPtr<ELF::DynamicObject>> s_global_objects;
 
+// Every object that gets linked looks up mostly the same names (everything links against LibC, most GUI programs
+// against LibGUI and LibGfx, ...), and an uncached lookup goes through the hash tables of all global objects.
+// The names point into the string tables of loaded objects, which are never unmapped.
+static HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>> s_relocation_symbol_cache;
+
 using EntryPointFunction = int (*)(int, char**, char**);
 using LibCExitFunction = void (*)(int);
 using DlIteratePhdrCallbackFunction = int (*)(struct dl_phdr_info*, size_t, void*);
@@ -82,11 +87,29 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol_for_relocation(StringView name)
+{
+    if (auto cached_result = s_relocation_symbol_cache.get(name); cached_result.has_value())
+        return cached_result.value();
+
+    auto result = lookup_global_symbol(name);
+    s_relocation_symbol_cache.set(name, result);
+    return result;
+}
+
 static String get_library_name(String path)
 {
     return LexicalPath::basename(move(path));
 }
 
+static void add_global_object(String const& filename, NonnullRefPtr<DynamicObject> object)
+{
+    s_global_objects.set(get_library_name(filename), move(object));
+
+    // Lookups that found nothing or only a weak definition might find something else now.
+    s_relocation_symbol_cache.clear();
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(String const& filename, int fd, String const& filepath)
 {
     auto result = ELF::DynamicLoader::try_create(fd, filename, filepath);
@@ -105,7 +128,7 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(String c
 
     // This actually maps the library at the intended and final place.
     auto main_library_object = loader->map();
-    s_global_objects.set(get_library_name(filename), *main_library_object);
+    add_global_object(filename, *main_library_object);
 
     return loader;
 }
@@ -367,7 +390,7 @@ static Result<void, DlErrorMessage> link_main_library(String const& name, int fl
     for (auto& loader : loaders) {
         auto dynamic_object = loader.map();
         if (dynamic_object)
-            s_global_objects.set(get_library_name(dynamic_object->filepath()), *dynamic_object);
+            add_global_object(dynamic_object->filepath(), *dynamic_object);
     }
 
     for (auto& loader : loaders) {
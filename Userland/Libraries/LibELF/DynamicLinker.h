@@ -15,6 +15,9 @@ namespace ELF {
 class DynamicLinker {
 public:
     static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(StringView symbol);
+    // Like lookup_global_symbol(), but remembers the result until the set of global objects changes.
+    // Only to be used while relocating objects, which happens on one thread at a time.
+    static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol_for_relocation(StringView symbol);
     [[noreturn]] static void linker_main(String&& main_program_name, int fd, bool is_secure, int argc, char** argv, char** envp);
 
 private:
@@ -491,7 +491,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     case R_X86_64_64: {
 #endif
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol_for_relocation(symbol);
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK)
                 return RelocationResult::ResolveLater;
@@ -510,7 +510,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
 #if ARCH(I386)
     case R_386_PC32: {
         auto symbol = relocation.symbol();
-        auto result = lookup_symbol(symbol);
+        auto result = lookup_symbol_for_relocation(symbol);
         if (!result.has_value())
             return RelocationResult::Failed;
         auto relative_offset = result.value().address - m_dynamic_object->base_address().offset(relocation.offset());
@@ -522,7 +522,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     case R_X86_64_GLOB_DAT: {
 #endif
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol_for_relocation(symbol);
         VirtualAddress symbol_location;
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK) {
@@ -574,7 +574,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
         FlatPtr symbol_value;
         DynamicObject const* dynamic_object_of_symbol;
         if (relocation.symbol_index() != 0) {
-            auto res = lookup_symbol(symbol);
+            auto res = lookup_symbol_for_relocation(symbol);
             if (!res.has_value())
                 break;
             VERIFY(symbol.type() != STT_GNU_IFUNC);
@@ -603,7 +603,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
         if (m_dynamic_object->must_bind_now()) {
             // Eagerly BIND_NOW the PLT entries, doing all the symbol looking goodness
             // The patch method returns the address for the LAZY fixup path, but we don't need it here
-            m_dynamic_object->patch_plt_entry(relocation.offset_in_section());
+            m_dynamic_object->patch_plt_entry(relocation.offset_in_section(), lookup_symbol_for_relocation(relocation.symbol()));
         } else {
             auto relocation_address = (FlatPtr*)relocation.address().as_ptr();
 
@@ -725,4 +725,12 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const E
     return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object() };
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol_for_relocation(const ELF::DynamicObject::Symbol& symbol)
+{
+    if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
+        return DynamicLinker::lookup_global_symbol_for_relocation(symbol.name());
+
+    return lookup_symbol(symbol);
+}
+
 } // end namespace ELF
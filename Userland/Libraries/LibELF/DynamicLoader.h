@@ -134,6 +134,7 @@ private:
         ResolveLater = 2,
     };
     RelocationResult do_relocation(DynamicObject::Relocation const&, ShouldInitializeWeak should_initialize_weak);
+    static Optional<DynamicObject::SymbolLookupResult> lookup_symbol_for_relocation(const ELF::DynamicObject::Symbol&);
     void do_relr_relocations();
     void find_tls_size_and_alignment();
 
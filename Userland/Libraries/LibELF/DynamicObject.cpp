@@ -482,6 +482,12 @@ NonnullRefPtr<DynamicObject> DynamicObject::create(String const& filepath, Virtu
 
 // offset is in PLT relocation table
 VirtualAddress DynamicObject::patch_plt_entry(u32 relocation_offset)
+{
+    auto relocation = plt_relocation_section().relocation_at_offset(relocation_offset);
+    return patch_plt_entry(relocation_offset, DynamicLoader::lookup_symbol(relocation.symbol()));
+}
+
+VirtualAddress DynamicObject::patch_plt_entry(u32 relocation_offset, Optional<SymbolLookupResult> const& result)
 {
     auto relocation = plt_relocation_section().relocation_at_offset(relocation_offset);
 #if ARCH(I386)
@@ -493,7 +499,6 @@ VirtualAddress DynamicObject::patch_plt_entry(u32 relocation_offset)
     auto relocation_address = (FlatPtr*)relocation.address().as_ptr();
 
     VirtualAddress symbol_location;
-    auto result = DynamicLoader::lookup_symbol(symbol);
     if (result.has_value()) {
         symbol_location = result.value().address;
 
@@ -332,6 +332,8 @@ public:
 
     // Will be called from _fixup_plt_entry, as part of the PLT trampoline
     VirtualAddress patch_plt_entry(u32 relocation_offset);
+    // Same as above, for callers that have already looked up the relocation's symbol.
+    VirtualAddress patch_plt_entry(u32 relocation_offset, Optional<SymbolLookupResult> const&);
 
     bool elf_is_dynamic() const { return m_is_elf_dynamic; }
 
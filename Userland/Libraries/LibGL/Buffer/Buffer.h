@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/RefCounted.h>
+#include <LibGL/GL/gl.h>
+
+namespace GL {
+
+// A buffer object's data store, as created by glBufferData(). Vertex and index arrays are read from it for as long as
+// it stays bound, so static geometry only has to be handed over once.
+class Buffer final : public RefCounted<Buffer> {
+public:
+    ErrorOr<void> set_data(void const* data, size_t size, GLenum usage)
+    {
+        auto new_data = TRY(ByteBuffer::create_zeroed(size));
+        if (data)
+            new_data.overwrite(0, data, size);
+        m_data = move(new_data);
+        m_usage = usage;
+        return {};
+    }
+
+    void replace_data(void const* data, size_t offset, size_t size)
+    {
+        VERIFY(offset + size <= m_data.size());
+        m_data.overwrite(offset, data, size);
+    }
+
+    size_t size() const { return m_data.size(); }
+    GLenum usage() const { return m_usage; }
+    void const* offset_data(size_t offset) const { return m_data.data() + offset; }
+
+private:
+    ByteBuffer m_data;
+    GLenum m_usage { GL_STATIC_DRAW };
+};
+
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibGL/GLContext.h>
+
+namespace GL {
+
+RefPtr<Buffer>* GLContext::buffer_binding(GLenum target)
+{
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return &m_array_buffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return &m_element_array_buffer;
+    default:
+        return nullptr;
+    }
+}
+
+void GLContext::gl_bind_buffer(GLenum target, GLuint buffer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+
+    // Buffer name 0 unbinds the target, which makes the vertex array functions take client pointers again
+    if (buffer == 0) {
+        *binding = nullptr;
+        return;
+    }
+
+    auto it = m_allocated_buffers.find(buffer);
+    RETURN_WITH_ERROR_IF(it == m_allocated_buffers.end(), GL_INVALID_OPERATION);
+
+    // The buffer object is created the first time its name gets bound
+    if (it->value.is_null())
+        it->value = adopt_ref(*new Buffer);
+    *binding = it->value;
+}
+
+void GLContext::gl_buffer_data(GLenum target, GLsizeiptr size, void const* data, GLenum usage)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(!(usage == GL_STREAM_DRAW
+                             || usage == GL_STREAM_READ
+                             || usage == GL_STREAM_COPY
+                             || usage == GL_STATIC_DRAW
+                             || usage == GL_STATIC_READ
+                             || usage == GL_STATIC_COPY
+                             || usage == GL_DYNAMIC_DRAW
+                             || usage == GL_DYNAMIC_READ
+                             || usage == GL_DYNAMIC_COPY),
+        GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(size < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(binding->is_null(), GL_INVALID_OPERATION);
+
+    auto result = (*binding)->set_data(data, static_cast<size_t>(size), usage);
+    RETURN_WITH_ERROR_IF(result.is_error(), GL_OUT_OF_MEMORY);
+}
+
+void GLContext::gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, void const* data)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(offset < 0 || size < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(binding->is_null(), GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(static_cast<size_t>(offset + size) > (*binding)->size(), GL_INVALID_VALUE);
+
+    (*binding)->replace_data(data, offset, size);
+}
+
+void GLContext::gl_delete_buffers(GLsizei n, GLuint const* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    for (auto i = 0; i < n; ++i) {
+        GLuint name = buffers[i];
+        if (name == 0)
+            continue;
+
+        auto it = m_allocated_buffers.find(name);
+        if (it == m_allocated_buffers.end())
+            continue;
+
+        // If a buffer that is currently bound is deleted, the binding reverts to 0
+        auto buffer = it->value;
+        if (buffer) {
+            if (m_array_buffer == buffer)
+                m_array_buffer = nullptr;
+            if (m_element_array_buffer == buffer)
+                m_element_array_buffer = nullptr;
+        }
+
+        m_buffer_name_allocator.free(name);
+        m_allocated_buffers.remove(it);
+    }
+}
+
+void GLContext::gl_gen_buffers(GLsizei n, GLuint* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    m_buffer_name_allocator.allocate(n, buffers);
+
+    // Initialize all buffer names with a nullptr
+    for (auto i = 0; i < n; ++i)
+        m_allocated_buffers.set(buffers[i], nullptr);
+}
+
+GLboolean GLContext::gl_is_buffer(GLuint buffer)
+{
+    RETURN_VALUE_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION, GL_FALSE);
+
+    auto it = m_allocated_buffers.find(buffer);
+    if (it == m_allocated_buffers.end())
+        return GL_FALSE;
+    return it->value.is_null() ? GL_FALSE : GL_TRUE;
+}
+
+}
@@ -489,6 +489,23 @@ extern "C" {
 #define GL_CLIP_PLANE4 0x3004
 #define GL_CLIP_PLANE5 0x3005
 
+// Buffer objects
+#define GL_BUFFER_SIZE 0x8764
+#define GL_BUFFER_USAGE 0x8765
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_ARRAY_BUFFER_BINDING 0x8894
+#define GL_ELEMENT_ARRAY_BUFFER_BINDING 0x8895
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STREAM_READ 0x88E1
+#define GL_STREAM_COPY 0x88E2
+#define GL_STATIC_DRAW 0x88E4
+#define GL_STATIC_READ 0x88E5
+#define GL_STATIC_COPY 0x88E6
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_DYNAMIC_READ 0x88E9
+#define GL_DYNAMIC_COPY 0x88EA
+
 GLAPI void glBegin(GLenum mode);
 GLAPI void glClear(GLbitfield mask);
 GLAPI void glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
@@ -686,6 +703,12 @@ GLAPI void glClipPlane(GLenum plane, GLdouble const* equation);
 GLAPI void glGetClipPlane(GLenum plane, GLdouble* equation);
 GLAPI void glArrayElement(GLint i);
 GLAPI void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+GLAPI void glBindBuffer(GLenum target, GLuint buffer);
+GLAPI void glBufferData(GLenum target, GLsizeiptr size, void const* data, GLenum usage);
+GLAPI void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void const* data);
+GLAPI void glDeleteBuffers(GLsizei n, GLuint const* buffers);
+GLAPI void glGenBuffers(GLsizei n, GLuint* buffers);
+GLAPI GLboolean glIsBuffer(GLuint buffer);
 
 #ifdef __cplusplus
 }
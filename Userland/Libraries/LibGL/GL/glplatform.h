@@ -33,6 +33,8 @@ typedef int GLfixed;
 typedef long long GLint64;
 typedef unsigned long long GLuint64;
 typedef int GLsizei;
+typedef long GLintptr;
+typedef long GLsizeiptr;
 typedef void GLvoid;
 typedef float GLfloat;
 typedef double GLclampd;
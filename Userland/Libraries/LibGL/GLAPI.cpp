@@ -67,6 +67,11 @@ void glBegin(GLenum mode)
     g_gl_context->gl_begin(mode);
 }
 
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    g_gl_context->gl_bind_buffer(target, buffer);
+}
+
 void glBindTexture(GLenum target, GLuint texture)
 {
     g_gl_context->gl_bind_texture(target, texture);
@@ -82,6 +87,16 @@ void glBlendFunc(GLenum sfactor, GLenum dfactor)
     return g_gl_context->gl_blend_func(sfactor, dfactor);
 }
 
+void glBufferData(GLenum target, GLsizeiptr size, void const* data, GLenum usage)
+{
+    g_gl_context->gl_buffer_data(target, size, data, usage);
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void const* data)
+{
+    g_gl_context->gl_buffer_sub_data(target, offset, size, data);
+}
+
 void glCallList(GLuint list)
 {
     return g_gl_context->gl_call_list(list);
@@ -241,6 +256,11 @@ void glDepthRange(GLdouble min, GLdouble max)
     g_gl_context->gl_depth_range(min, max);
 }
 
+void glDeleteBuffers(GLsizei n, GLuint const* buffers)
+{
+    g_gl_context->gl_delete_buffers(n, buffers);
+}
+
 void glDeleteLists(GLuint list, GLsizei range)
 {
     return g_gl_context->gl_delete_lists(list, range);
@@ -384,6 +404,11 @@ void glFrustum(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLd
     g_gl_context->gl_frustum(left, right, bottom, top, nearVal, farVal);
 }
 
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    g_gl_context->gl_gen_buffers(n, buffers);
+}
+
 GLuint glGenLists(GLsizei range)
 {
     return g_gl_context->gl_gen_lists(range);
@@ -459,6 +484,11 @@ void glHint(GLenum target, GLenum mode)
     g_gl_context->gl_hint(target, mode);
 }
 
+GLboolean glIsBuffer(GLuint buffer)
+{
+    return g_gl_context->gl_is_buffer(buffer);
+}
+
 GLboolean glIsEnabled(GLenum cap)
 {
     return g_gl_context->gl_is_enabled(cap);
@@ -135,6 +135,11 @@ void GLContext::gl_end()
     RETURN_WITH_ERROR_IF(!m_in_draw_state, GL_INVALID_OPERATION);
     m_in_draw_state = false;
 
+    draw_vertex_list();
+}
+
+void GLContext::draw_vertex_list()
+{
     Vector<size_t, 32> enabled_texture_units;
     for (size_t i = 0; i < m_texture_units.size(); ++i) {
         if (m_texture_units[i].texture_2d_enabled())
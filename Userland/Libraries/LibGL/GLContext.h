@@ -15,6 +15,7 @@
 #include <AK/Tuple.h>
 #include <AK/Variant.h>
 #include <AK/Vector.h>
+#include <LibGL/Buffer/Buffer.h>
 #include <LibGL/Tex/NameAllocator.h>
 #include <LibGL/Tex/Texture.h>
 #include <LibGL/Tex/TextureUnit.h>
@@ -207,6 +208,12 @@ public:
     void gl_array_element(GLint i);
     void gl_copy_tex_sub_image_2d(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
     void gl_point_size(GLfloat size);
+    void gl_bind_buffer(GLenum target, GLuint buffer);
+    void gl_buffer_data(GLenum target, GLsizeiptr size, void const* data, GLenum usage);
+    void gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, void const* data);
+    void gl_delete_buffers(GLsizei n, GLuint const* buffers);
+    void gl_gen_buffers(GLsizei n, GLuint* buffers);
+    GLboolean gl_is_buffer(GLuint buffer);
 
 private:
     void sync_device_config();
@@ -218,6 +225,26 @@ private:
 
     void build_extension_string();
 
+    void draw_vertex_list();
+    RefPtr<Buffer>* buffer_binding(GLenum target);
+
+    // The vertices of a glBegin() / glEnd() block in a display list, put together when the list was compiled.
+    struct CompiledVertices {
+        GLenum mode { GL_POINTS };
+        Vector<GPU::Vertex> vertices;
+
+        // The vertices before one of these was set within the block take the attribute that is current when the list
+        // gets called, so they come first; afterwards, the last value set within the block becomes the current one.
+        size_t inherited_color_count { 0 };
+        size_t inherited_normal_count { 0 };
+        Vector<size_t> inherited_tex_coord_counts;
+        Optional<FloatVector4> final_color;
+        Optional<FloatVector3> final_normal;
+        Vector<Optional<FloatVector4>> final_tex_coords;
+    };
+
+    void draw_compiled_vertices(CompiledVertices const*);
+
     template<typename T>
     T* store_in_listing(T value)
     {
@@ -342,6 +369,12 @@ private:
 
     TextureNameAllocator m_name_allocator;
     HashMap<GLuint, RefPtr<Texture>> m_allocated_textures;
+
+    // Buffer objects
+    TextureNameAllocator m_buffer_name_allocator;
+    HashMap<GLuint, RefPtr<Buffer>> m_allocated_buffers;
+    RefPtr<Buffer> m_array_buffer;
+    RefPtr<Buffer> m_element_array_buffer;
     HashMap<GLenum, RefPtr<Texture>> m_default_textures;
     Vector<TextureUnit> m_texture_units;
     TextureUnit* m_active_texture_unit;
@@ -388,6 +421,23 @@ private:
         struct FunctionAndArgs {
             Variant<Fns...> function;
             Variant<TupleTypeForArgumentListOf<Fns>...> arguments;
+
+            template<auto member>
+            bool is_call_to() const
+            {
+                return function.visit([](auto function) {
+                    if constexpr (IsSame<decltype(function), decltype(member)>)
+                        return function == member;
+                    else
+                        return false;
+                });
+            }
+
+            template<auto member>
+            ArgumentsFor<member> const& arguments_of() const
+            {
+                return arguments.template get<ArgumentsFor<member>>();
+            }
         };
 
         using FunctionsAndArgs = FunctionAndArgs<
@@ -459,10 +509,12 @@ private:
             decltype(&GLContext::gl_clip_plane),
             decltype(&GLContext::gl_array_element),
             decltype(&GLContext::gl_copy_tex_sub_image_2d),
-            decltype(&GLContext::gl_point_size)>;
+            decltype(&GLContext::gl_point_size),
+            decltype(&GLContext::draw_compiled_vertices)>;
 
         using ExtraSavedArguments = Variant<
-            FloatMatrix4x4>;
+            FloatMatrix4x4,
+            CompiledVertices>;
 
         Vector<NonnullOwnPtr<ExtraSavedArguments>> saved_arguments;
         Vector<FunctionsAndArgs> entries;
@@ -479,12 +531,17 @@ private:
     };
     Optional<CurrentListing> m_current_listing_index;
 
+    void compile_listing(Listing&);
+    Optional<size_t> compile_vertices(Span<Listing::FunctionsAndArgs const> entries, CompiledVertices&) const;
+
     struct VertexAttribPointer {
         GLint size { 4 };
         GLenum type { GL_FLOAT };
         bool normalize { true };
         GLsizei stride { 0 };
         void const* pointer { 0 };
+        // If set, the pointer is an offset into this buffer object.
+        RefPtr<Buffer> buffer;
     };
 
     static void read_from_vertex_attribute_pointer(VertexAttribPointer const&, int index, float* elements);
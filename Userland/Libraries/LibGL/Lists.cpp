@@ -101,6 +101,7 @@ void GLContext::gl_end_list()
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
     RETURN_WITH_ERROR_IF(!m_current_listing_index.has_value(), GL_INVALID_OPERATION);
 
+    compile_listing(m_current_listing_index->listing);
     m_listings[m_current_listing_index->index] = move(m_current_listing_index->listing);
     m_current_listing_index.clear();
 }
@@ -144,6 +145,139 @@ void GLContext::gl_new_list(GLuint list, GLenum mode)
     m_current_listing_index = CurrentListing { {}, static_cast<size_t>(list - 1), mode };
 }
 
+void GLContext::compile_listing(Listing& listing)
+{
+    // Every glBegin() / glEnd() block that only specifies vertices and their attributes is replaced by a single
+    // entry that draws the vertices we put together right here, instead of replaying every call that made them.
+    Vector<Listing::FunctionsAndArgs> entries;
+    entries.ensure_capacity(listing.entries.size());
+    for (size_t i = 0; i < listing.entries.size();) {
+        auto& entry = listing.entries[i];
+        if (entry.is_call_to<&GLContext::gl_begin>()) {
+            CompiledVertices compiled;
+            if (auto block_size = compile_vertices(listing.entries.span().slice(i), compiled); block_size.has_value()) {
+                listing.saved_arguments.empend(make<Listing::ExtraSavedArguments>(move(compiled)));
+                auto const* saved_vertices = listing.saved_arguments.last()->get_pointer<CompiledVertices>();
+                entries.empend(&GLContext::draw_compiled_vertices, Listing::ArgumentsFor<&GLContext::draw_compiled_vertices> { saved_vertices });
+                i += block_size.value();
+                continue;
+            }
+        }
+        entries.append(move(entry));
+        ++i;
+    }
+    listing.entries = move(entries);
+}
+
+Optional<size_t> GLContext::compile_vertices(Span<Listing::FunctionsAndArgs const> entries, CompiledVertices& compiled) const
+{
+    auto mode = entries[0].arguments_of<&GLContext::gl_begin>().get<0>();
+    if (mode > GL_POLYGON)
+        return {};
+    compiled.mode = mode;
+
+    auto const num_texture_units = m_device_info.num_texture_units;
+    Optional<FloatVector4> color;
+    Optional<FloatVector3> normal;
+    Vector<Optional<FloatVector4>> tex_coords;
+    tex_coords.resize(num_texture_units);
+    compiled.inherited_tex_coord_counts.resize(num_texture_units);
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        auto const& entry = entries[i];
+        if (entry.is_call_to<&GLContext::gl_end>()) {
+            compiled.final_color = color;
+            compiled.final_normal = normal;
+            compiled.final_tex_coords = move(tex_coords);
+            return i + 1;
+        }
+
+        if (entry.is_call_to<&GLContext::gl_vertex>()) {
+            auto const& arguments = entry.arguments_of<&GLContext::gl_vertex>();
+            GPU::Vertex vertex;
+            vertex.position = {
+                static_cast<float>(arguments.get<0>()),
+                static_cast<float>(arguments.get<1>()),
+                static_cast<float>(arguments.get<2>()),
+                static_cast<float>(arguments.get<3>()),
+            };
+
+            if (color.has_value())
+                vertex.color = color.value();
+            else
+                compiled.inherited_color_count = compiled.vertices.size() + 1;
+
+            if (normal.has_value())
+                vertex.normal = normal.value();
+            else
+                compiled.inherited_normal_count = compiled.vertices.size() + 1;
+
+            for (size_t unit = 0; unit < num_texture_units; ++unit) {
+                if (tex_coords[unit].has_value())
+                    vertex.tex_coords[unit] = tex_coords[unit].value();
+                else
+                    compiled.inherited_tex_coord_counts[unit] = compiled.vertices.size() + 1;
+            }
+
+            compiled.vertices.append(vertex);
+        } else if (entry.is_call_to<&GLContext::gl_color>()) {
+            auto const& arguments = entry.arguments_of<&GLContext::gl_color>();
+            color = FloatVector4 {
+                static_cast<float>(arguments.get<0>()),
+                static_cast<float>(arguments.get<1>()),
+                static_cast<float>(arguments.get<2>()),
+                static_cast<float>(arguments.get<3>()),
+            };
+        } else if (entry.is_call_to<&GLContext::gl_normal>()) {
+            auto const& arguments = entry.arguments_of<&GLContext::gl_normal>();
+            normal = FloatVector3 { arguments.get<0>(), arguments.get<1>(), arguments.get<2>() };
+        } else if (entry.is_call_to<&GLContext::gl_tex_coord>()) {
+            auto const& arguments = entry.arguments_of<&GLContext::gl_tex_coord>();
+            tex_coords[0] = FloatVector4 { arguments.get<0>(), arguments.get<1>(), arguments.get<2>(), arguments.get<3>() };
+        } else if (entry.is_call_to<&GLContext::gl_multi_tex_coord>()) {
+            auto const& arguments = entry.arguments_of<&GLContext::gl_multi_tex_coord>();
+            auto target = arguments.get<0>();
+            // Leave invalid targets to be reported when the list gets called
+            if (target < GL_TEXTURE0 || target >= GL_TEXTURE0 + num_texture_units)
+                return {};
+            tex_coords[target - GL_TEXTURE0] = FloatVector4 { arguments.get<1>(), arguments.get<2>(), arguments.get<3>(), arguments.get<4>() };
+        } else {
+            return {};
+        }
+    }
+
+    // The list ended before the block did
+    return {};
+}
+
+void GLContext::draw_compiled_vertices(CompiledVertices const* compiled)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    m_vertex_list.clear_with_capacity();
+    m_vertex_list.extend(compiled->vertices);
+    for (size_t i = 0; i < compiled->inherited_color_count; ++i)
+        m_vertex_list[i].color = m_current_vertex_color;
+    for (size_t i = 0; i < compiled->inherited_normal_count; ++i)
+        m_vertex_list[i].normal = m_current_vertex_normal;
+    for (size_t unit = 0; unit < compiled->inherited_tex_coord_counts.size(); ++unit) {
+        for (size_t i = 0; i < compiled->inherited_tex_coord_counts[unit]; ++i)
+            m_vertex_list[i].tex_coords[unit] = m_current_vertex_tex_coord[unit];
+    }
+
+    m_current_draw_mode = compiled->mode;
+    draw_vertex_list();
+
+    if (compiled->final_color.has_value())
+        m_current_vertex_color = compiled->final_color.value();
+    if (compiled->final_normal.has_value())
+        m_current_vertex_normal = compiled->final_normal.value();
+    for (size_t unit = 0; unit < compiled->final_tex_coords.size(); ++unit) {
+        if (compiled->final_tex_coords[unit].has_value())
+            m_current_vertex_tex_coord[unit] = compiled->final_tex_coords[unit].value();
+    }
+}
+
 void GLContext::invoke_list(size_t list_index)
 {
     auto& listing = m_listings[list_index - 1];
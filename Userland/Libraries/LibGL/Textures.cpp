@@ -203,7 +203,7 @@ void GLContext::gl_tex_coord_pointer(GLint size, GLenum type, GLsizei stride, vo
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
     auto& tex_coord_pointer = m_client_tex_coord_pointer[m_client_active_texture];
-    tex_coord_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    tex_coord_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_tex_env(GLenum target, GLenum pname, GLfloat param)
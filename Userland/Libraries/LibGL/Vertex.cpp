@@ -74,7 +74,7 @@ void GLContext::gl_color_pointer(GLint size, GLenum type, GLsizei stride, void c
         GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_color_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    m_client_color_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
@@ -152,6 +152,14 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void c
     if (!m_client_side_vertex_array_enabled)
         return;
 
+    // With a buffer object bound for the indices, the indices pointer is an offset into the buffer's data
+    if (m_element_array_buffer) {
+        auto offset = reinterpret_cast<FlatPtr>(indices);
+        auto index_size = type == GL_UNSIGNED_BYTE ? sizeof(GLubyte) : (type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+        RETURN_WITH_ERROR_IF(offset + count * index_size > m_element_array_buffer->size(), GL_INVALID_OPERATION);
+        indices = m_element_array_buffer->offset_data(offset);
+    }
+
     gl_begin(mode);
     for (int index = 0; index < count; index++) {
         int i = 0;
@@ -212,7 +220,7 @@ void GLContext::gl_normal_pointer(GLenum type, GLsizei stride, void const* point
         GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_normal_pointer = { .size = 3, .type = type, .stride = stride, .pointer = pointer };
+    m_client_normal_pointer = { .size = 3, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_vertex(GLdouble x, GLdouble y, GLdouble z, GLdouble w)
@@ -237,13 +245,15 @@ void GLContext::gl_vertex_pointer(GLint size, GLenum type, GLsizei stride, void
     RETURN_WITH_ERROR_IF(!(type == GL_SHORT || type == GL_INT || type == GL_FLOAT || type == GL_DOUBLE), GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_vertex_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    m_client_vertex_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 // General helper function to read arbitrary vertex attribute data into a float array
 void GLContext::read_from_vertex_attribute_pointer(VertexAttribPointer const& attrib, int index, float* elements)
 {
-    auto byte_ptr = reinterpret_cast<char const*>(attrib.pointer);
+    // With a buffer object bound to the array, its pointer is an offset into the buffer's data
+    void const* pointer = attrib.buffer ? attrib.buffer->offset_data(reinterpret_cast<FlatPtr>(attrib.pointer)) : attrib.pointer;
+    auto byte_ptr = reinterpret_cast<char const*>(pointer);
     auto normalize = attrib.normalize;
     size_t stride = attrib.stride;
 
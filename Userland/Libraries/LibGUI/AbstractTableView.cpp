@@ -47,6 +47,21 @@ void AbstractTableView::select_all()
     }
 }
 
+// Measuring every cell of a big model takes ages, and a sample spread over all of it gets the width about right.
+static constexpr int max_rows_measured_for_column_width = 1000;
+
+template<typename Callback>
+static void for_each_row_measured_for_column_width(int row_count, Callback callback)
+{
+    if (row_count <= max_rows_measured_for_column_width) {
+        for (int row = 0; row < row_count; ++row)
+            callback(row);
+        return;
+    }
+    for (int i = 0; i < max_rows_measured_for_column_width; ++i)
+        callback(static_cast<int>(static_cast<i64>(i) * row_count / max_rows_measured_for_column_width));
+}
+
 void AbstractTableView::auto_resize_column(int column)
 {
     if (!model())
@@ -64,7 +79,7 @@ void AbstractTableView::auto_resize_column(int column)
 
     int column_width = header_width;
     bool is_empty = true;
-    for (int row = 0; row < row_count; ++row) {
+    for_each_row_measured_for_column_width(row_count, [&](int row) {
         auto cell_data = model.index(row, column).data();
         int cell_width = 0;
         if (cell_data.is_icon()) {
@@ -77,7 +92,7 @@ void AbstractTableView::auto_resize_column(int column)
         if (is_empty && cell_width > 0)
             is_empty = false;
         column_width = max(column_width, cell_width);
-    }
+    });
 
     auto default_column_size = column_header().default_section_size(column);
     if (is_empty && column_header().is_default_section_size_initialized(column))
@@ -101,7 +116,7 @@ void AbstractTableView::update_column_sizes()
         if (column == m_key_column && model.is_column_sortable(column))
             header_width += HeaderView::sorting_arrow_width + HeaderView::sorting_arrow_offset;
         int column_width = header_width;
-        for (int row = 0; row < row_count; ++row) {
+        for_each_row_measured_for_column_width(row_count, [&](int row) {
             auto cell_data = model.index(row, column).data();
             int cell_width = 0;
             if (cell_data.is_icon()) {
@@ -113,7 +128,7 @@ void AbstractTableView::update_column_sizes()
                 cell_width = font().width(cell_data.to_string());
             }
             column_width = max(column_width, cell_width);
-        }
+        });
         column_header().set_section_size(column, max(m_column_header->section_size(column), column_width));
     }
 }
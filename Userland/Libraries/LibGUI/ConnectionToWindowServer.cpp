@@ -95,6 +95,12 @@ void ConnectionToWindowServer::paint(i32 window_id, Gfx::IntSize const& window_s
         Core::EventLoop::current().post_event(*window, make<MultiPaintEvent>(rects, window_size));
 }
 
+void ConnectionToWindowServer::did_switch_backing_store(i32 window_id, i32 serial)
+{
+    if (auto* window = Window::from_window_id(window_id))
+        window->did_switch_backing_store({}, serial);
+}
+
 void ConnectionToWindowServer::window_resized(i32 window_id, Gfx::IntRect const& new_rect)
 {
     if (auto* window = Window::from_window_id(window_id)) {
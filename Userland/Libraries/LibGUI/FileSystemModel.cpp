@@ -12,13 +12,16 @@
 #include <AK/StringBuilder.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/StandardPaths.h>
 #include <LibGUI/AbstractView.h>
 #include <LibGUI/FileIconProvider.h>
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/ImageDecoder.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/ThreadPool.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
@@ -28,13 +31,22 @@
 
 namespace GUI {
 
+// Below this, handing the stat calls to the thread pool costs more than it saves.
+static constexpr size_t parallel_stat_threshold = 256;
+
 ModelIndex FileSystemModel::Node::index(int column) const
 {
     if (!m_parent)
         return {};
-    for (size_t row = 0; row < m_parent->m_children.size(); ++row) {
-        if (&m_parent->m_children[row] == this)
+    // Rows only move when siblings get added or removed, so the row we were found at last time is almost always right.
+    auto& siblings = m_parent->m_children;
+    if (m_row_hint < siblings.size() && &siblings[m_row_hint] == this)
+        return m_model.create_index(m_row_hint, column, const_cast<Node*>(this));
+    for (size_t row = 0; row < siblings.size(); ++row) {
+        if (&siblings[row] == this) {
+            m_row_hint = row;
             return m_model.create_index(row, column, const_cast<Node*>(this));
+        }
     }
     VERIFY_NOT_REACHED();
 }
@@ -110,15 +122,39 @@ void FileSystemModel::Node::traverse_if_needed()
     }
     quick_sort(child_names);
 
+    Vector<OwnPtr<Node>> children;
+    children.ensure_capacity(child_names.size());
+    for (auto& child_name : child_names) {
+        auto child = adopt_own(*new Node(m_model));
+        child->name = move(child_name);
+        child->m_parent = this;
+        children.unchecked_append(move(child));
+    }
+
+    // Stat'ing every entry is what makes big directories slow to open, and the entries don't depend on each other.
+    Vector<u8> fetched;
+    fetched.resize(children.size());
+    Function<void(size_t)> fetch_child = [&](size_t i) {
+        auto& child = *children[i];
+        fetched[i] = child.fetch_data(LexicalPath::join(full_path, child.name).string(), false);
+    };
+    if (children.size() >= parallel_stat_threshold) {
+        Threading::ThreadPool::the().parallel_for(0, children.size(), fetch_child);
+    } else {
+        for (size_t i = 0; i < children.size(); ++i)
+            fetch_child(i);
+    }
+
     NonnullOwnPtrVector<Node> directory_children;
     NonnullOwnPtrVector<Node> file_children;
 
-    for (auto& child_name : child_names) {
-        auto maybe_child = create_child(child_name);
-        if (!maybe_child)
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (!fetched[i])
+            continue;
+        auto child = children[i].release_nonnull();
+        if (m_model.m_mode == DirectoriesOnly && !S_ISDIR(child->mode))
             continue;
 
-        auto child = maybe_child.release_nonnull();
         total_size += child->size;
         if (S_ISDIR(child->mode))
             directory_children.append(move(child));
@@ -621,7 +657,15 @@ static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
 
 static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
 {
-    auto bitmap = TRY(Gfx::Bitmap::try_load_from_file(path));
+    // The thumbnail is tiny, so we let the decoder skip most of the pixels of large images rather than decoding them at full size.
+    auto file = TRY(Core::MappedFile::map(path));
+    auto decoder = Gfx::ImageDecoder::try_create(file->bytes());
+    if (!decoder)
+        return Error::from_string_literal("Unable to decode image for thumbnail");
+    auto bitmap = TRY(decoder->downscaled_frame(0, { 32, 32 })).image;
+    if (!bitmap)
+        return Error::from_string_literal("Unable to decode image for thumbnail");
+
     auto thumbnail = TRY(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { 32, 32 }));
 
     double scale = min(32 / (double)bitmap->width(), 32 / (double)bitmap->height());
@@ -84,6 +84,7 @@ public:
 
         Node* m_parent { nullptr };
         NonnullOwnPtrVector<Node> m_children;
+        mutable size_t m_row_hint { 0 };
         bool m_has_traversed { false };
 
         bool m_selected { false };
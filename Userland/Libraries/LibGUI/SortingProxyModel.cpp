@@ -121,13 +121,17 @@ StringView SortingProxyModel::drag_data_type() const
     return source().drag_data_type();
 }
 
+Variant SortingProxyModel::sort_key(ModelIndex const& index) const
+{
+    auto data = index.data(m_sort_role);
+    if (data.is_string())
+        return data.as_string().to_lowercase();
+    return data;
+}
+
 bool SortingProxyModel::less_than(ModelIndex const& index1, ModelIndex const& index2) const
 {
-    auto data1 = index1.data(m_sort_role);
-    auto data2 = index2.data(m_sort_role);
-    if (data1.is_string() && data2.is_string())
-        return data1.as_string().to_lowercase() < data2.as_string().to_lowercase();
-    return data1 < data2;
+    return sort_key(index1) < sort_key(index2);
 }
 
 ModelIndex SortingProxyModel::index(int row, int column, ModelIndex const& parent) const
@@ -177,11 +181,16 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
         return;
     }
 
-    for (int i = 0; i < row_count; ++i)
+    // Fetch every key once up front, rather than asking the source model for two of them in every comparison.
+    Vector<Variant> keys;
+    keys.ensure_capacity(row_count);
+    for (int i = 0; i < row_count; ++i) {
         mapping.source_rows[i] = i;
+        keys.unchecked_append(sort_key(source().index(i, column, mapping.source_parent)));
+    }
 
     quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
+        bool is_less_than = keys[row1] < keys[row2];
         return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
     });
 
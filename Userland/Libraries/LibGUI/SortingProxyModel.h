@@ -38,7 +38,9 @@ public:
 
     virtual bool is_column_sortable(int column_index) const override;
 
-    virtual bool less_than(ModelIndex const&, ModelIndex const&) const;
+    // Rows are sorted by the keys this returns, which by default is the sort role data, with strings lowercased.
+    virtual Variant sort_key(ModelIndex const&) const;
+    bool less_than(ModelIndex const&, ModelIndex const&) const;
 
     ModelIndex map_to_source(ModelIndex const&) const;
     ModelIndex map_to_proxy(ModelIndex const&) const;
@@ -49,6 +49,8 @@ bool TextDocument::set_text(StringView text, AllowCallback allow_callback)
         set_text({});
     });
 
+    m_lines.ensure_capacity(text.count("\n"sv) + 1);
+
     size_t start_of_current_line = 0;
 
     auto add_line = [&](size_t current_position) -> bool {
@@ -165,16 +167,22 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, StringView text)
     set_text(document, text);
 }
 
+void TextDocumentLine::did_change(TextDocument& document)
+{
+    m_version = document.next_line_version({});
+    document.update_views({});
+}
+
 void TextDocumentLine::clear(TextDocument& document)
 {
     m_text.clear();
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::set_text(TextDocument& document, Vector<u32> const text)
 {
     m_text = move(text);
-    document.update_views({});
+    did_change(document);
 }
 
 bool TextDocumentLine::set_text(TextDocument& document, StringView text)
@@ -188,9 +196,11 @@ bool TextDocumentLine::set_text(TextDocument& document, StringView text)
     if (!utf8_view.validate()) {
         return false;
     }
+    // Lines of big files add up, so they shouldn't carry around any unused capacity.
+    m_text.ensure_capacity(utf8_view.length());
     for (auto code_point : utf8_view)
-        m_text.append(code_point);
-    document.update_views({});
+        m_text.unchecked_append(code_point);
+    did_change(document);
     return true;
 }
 
@@ -199,7 +209,7 @@ void TextDocumentLine::append(TextDocument& document, u32 const* code_points, si
     if (length == 0)
         return;
     m_text.append(code_points, length);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::append(TextDocument& document, u32 code_point)
@@ -219,7 +229,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
     } else {
         m_text.insert(index, code_point);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
@@ -229,27 +239,21 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
     } else {
         m_text.remove(index);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
 {
     VERIFY(length <= m_text.size());
 
-    Vector<u32> new_data;
-    new_data.ensure_capacity(m_text.size() - length);
-    for (size_t i = 0; i < start; ++i)
-        new_data.append(m_text[i]);
-    for (size_t i = (start + length); i < m_text.size(); ++i)
-        new_data.append(m_text[i]);
-    m_text = move(new_data);
-    document.update_views({});
+    m_text.remove(start, length);
+    did_change(document);
 }
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
     m_text.resize(length);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocument::append_line(NonnullOwnPtr<TextDocumentLine> line)
@@ -1115,11 +1119,14 @@ void TextDocument::merge_span_collections()
     auto collection_indices = m_span_collections.keys();
     quick_sort(collection_indices);
 
+    size_t span_count = 0;
+    for (auto& it : m_span_collections)
+        span_count += it.value.size();
+    sorted_spans.ensure_capacity(span_count);
+
     for (auto collection_index : collection_indices) {
-        auto spans = m_span_collections.get(collection_index).value();
-        for (auto span : spans) {
-            sorted_spans.append({ move(span), collection_index });
-        }
+        for (auto const& span : m_span_collections.find(collection_index)->value)
+            sorted_spans.unchecked_append({ span, collection_index });
     }
 
     quick_sort(sorted_spans, [](SpanAndCollectionIndex const& a, SpanAndCollectionIndex const& b) {
@@ -1137,6 +1144,7 @@ void TextDocument::merge_span_collections()
     };
 
     Vector<SpanAndCollectionIndex> merged_spans;
+    merged_spans.ensure_capacity(sorted_spans.size());
     for (auto& span_and_collection_index : sorted_spans) {
         if (merged_spans.is_empty()) {
             merged_spans.append(span_and_collection_index);
@@ -1188,10 +1196,10 @@ void TextDocument::merge_span_collections()
         merged_spans.append(move(last_part));
     }
 
-    m_spans.clear();
-    for (auto span : merged_spans) {
-        m_spans.append(move(span.span));
-    }
+    m_spans.clear_with_capacity();
+    m_spans.ensure_capacity(merged_spans.size());
+    for (auto& span : merged_spans)
+        m_spans.unchecked_append(move(span.span));
 }
 
 }
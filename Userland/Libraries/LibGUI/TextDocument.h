@@ -89,6 +89,7 @@ public:
     void unregister_client(Client&);
 
     void update_views(Badge<TextDocumentLine>);
+    u64 next_line_version(Badge<TextDocumentLine>) { return ++m_last_line_version; }
 
     String text() const;
     String text_in_range(TextRange const&) const;
@@ -148,6 +149,7 @@ private:
 
     HashTable<Client*> m_clients;
     bool m_client_notifications_enabled { true };
+    u64 m_last_line_version { 0 };
 
     UndoStack m_undo_stack;
 
@@ -187,9 +189,16 @@ public:
     bool is_empty() const { return length() == 0; }
     size_t leading_spaces() const;
 
+    // Changes whenever the text of the line does, and is never reused within a document,
+    // so clients can tell which lines they have to look at again after a change.
+    u64 version() const { return m_version; }
+
 private:
+    void did_change(TextDocument&);
+
     // NOTE: This vector is null terminated.
     Vector<u32> m_text;
+    u64 m_version { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
@@ -495,13 +495,17 @@ void TextEditor::paint_event(PaintEvent& event)
     text_clip_rect.translate_by(horizontal_scrollbar().value(), vertical_scrollbar().value());
     painter.add_clip_rect(text_clip_rect);
 
+    // Spans are sorted and don't overlap, so the first one that reaches into the visible lines can be found with a binary search.
     size_t span_index = 0;
     if (document().has_spans()) {
-        for (;;) {
-            if (span_index >= document().spans().size() || document().spans()[span_index].range.end().line() >= first_visible_line) {
-                break;
-            }
-            ++span_index;
+        auto const& spans = document().spans();
+        size_t search_end = spans.size();
+        while (span_index < search_end) {
+            auto middle = span_index + (search_end - span_index) / 2;
+            if (spans[middle].range.end().line() < first_visible_line)
+                span_index = middle + 1;
+            else
+                search_end = middle;
         }
     }
 
@@ -1779,11 +1783,25 @@ void TextEditor::recompute_all_visual_lines()
 
     m_reflow_requested = false;
 
+    VisualLinesLayout layout {
+        .available_width = visible_text_rect_in_inner_coordinates().width(),
+        .font = font(),
+        .line_height = line_height(),
+        .wrapping_mode = m_wrapping_mode,
+        .horizontal_content_padding = m_horizontal_content_padding,
+        .substitution_code_point = m_substitution_code_point,
+    };
+    bool layout_changed = layout != m_visual_lines_layout;
+    if (layout_changed)
+        m_visual_lines_layout = move(layout);
+
     int y_offset = 0;
     for (size_t line_index = 0; line_index < line_count(); ++line_index) {
-        recompute_visual_lines(line_index);
-        m_line_visual_data[line_index].visual_rect.set_y(y_offset);
-        y_offset += m_line_visual_data[line_index].visual_rect.height();
+        auto& visual_data = m_line_visual_data[line_index];
+        if (layout_changed || visual_data.line_version != line(line_index).version())
+            recompute_visual_lines(line_index);
+        visual_data.visual_rect.set_y(y_offset);
+        y_offset += visual_data.visual_rect.height();
     }
 
     update_content_size();
@@ -1818,6 +1836,7 @@ void TextEditor::recompute_visual_lines(size_t line_index)
     auto& visual_data = m_line_visual_data[line_index];
 
     visual_data.visual_line_breaks.clear_with_capacity();
+    visual_data.line_version = line.version();
 
     int available_width = visible_text_rect_in_inner_coordinates().width();
 
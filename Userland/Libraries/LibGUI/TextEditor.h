@@ -412,9 +412,25 @@ private:
     struct LineVisualData {
         Vector<size_t, 1> visual_line_breaks;
         Gfx::IntRect visual_rect;
+        // The version of the line these were computed for, see TextDocumentLine::version().
+        u64 line_version { 0 };
+    };
+
+    // Everything besides the text of a line that goes into its visual lines. When any of it
+    // changes, all lines have to be laid out again, otherwise only the ones that were edited.
+    struct VisualLinesLayout {
+        int available_width { 0 };
+        RefPtr<Gfx::Font const> font;
+        int line_height { 0 };
+        WrappingMode wrapping_mode { WrappingMode::NoWrap };
+        int horizontal_content_padding { 0 };
+        Optional<u32> substitution_code_point;
+
+        bool operator==(VisualLinesLayout const&) const = default;
     };
 
     NonnullOwnPtrVector<LineVisualData> m_line_visual_data;
+    VisualLinesLayout m_visual_lines_layout;
 
     OwnPtr<Syntax::Highlighter> m_highlighter;
     OwnPtr<AutocompleteProvider> m_autocomplete_provider;
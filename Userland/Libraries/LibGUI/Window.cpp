@@ -49,9 +49,48 @@ public:
 
     i32 serial() const { return m_serial; }
 
+    // Where this store is in the sequence of stores handed to WindowServer, or 0 if it never was.
+    u64 submission() const { return m_submission; }
+    void set_submission(u64 submission) { m_submission = submission; }
+
+    // Keeps track of what was painted into the other stores since this one was last brought up to date.
+    void add_stale_rects(Vector<Gfx::IntRect, 32> const& rects)
+    {
+        if (m_is_entirely_stale)
+            return;
+        if (m_stale_rects.size() + rects.size() > max_stale_rects) {
+            m_is_entirely_stale = true;
+            m_stale_rects.clear();
+            return;
+        }
+        m_stale_rects.extend(rects);
+    }
+    void mark_entirely_stale()
+    {
+        m_is_entirely_stale = true;
+        m_stale_rects.clear();
+    }
+    void update_stale_rects_from(WindowBackingStore const& store)
+    {
+        if (m_is_entirely_stale) {
+            memcpy(m_bitmap->scanline(0), store.bitmap().scanline(0), store.bitmap().size_in_bytes());
+        } else {
+            Painter painter(*m_bitmap);
+            for (auto& rect : m_stale_rects)
+                painter.blit(rect.location(), store.bitmap(), rect, 1.0f, false);
+        }
+        m_is_entirely_stale = false;
+        m_stale_rects.clear_with_capacity();
+    }
+
 private:
+    static constexpr size_t max_stale_rects = 64;
+
     NonnullRefPtr<Gfx::Bitmap> m_bitmap;
     const i32 m_serial;
+    u64 m_submission { 0 };
+    Vector<Gfx::IntRect, 32> m_stale_rects;
+    bool m_is_entirely_stale { false };
 };
 
 static NeverDestroyed<HashTable<Window*>> all_windows;
@@ -197,6 +236,9 @@ void Window::server_did_destroy()
     m_pending_paint_event_rects.clear();
     m_back_store = nullptr;
     m_front_store = nullptr;
+    m_spare_store = nullptr;
+    m_last_backing_store_submission = 0;
+    m_last_acknowledged_backing_store_submission = 0;
     m_cursor = Gfx::StandardCursor::None;
 }
 
@@ -279,6 +321,8 @@ void Window::set_rect(Gfx::IntRect const& a_rect)
         m_back_store = nullptr;
     if (m_front_store && m_front_store->size() != window_rect.size())
         m_front_store = nullptr;
+    if (m_spare_store && m_spare_store->size() != window_rect.size())
+        m_spare_store = nullptr;
     if (m_main_widget)
         m_main_widget->resize(window_rect.size());
 }
@@ -425,6 +469,7 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
             dbgln("Not enough memory to make backing store non-volatile. Falling back to single-buffered mode.");
             m_double_buffering_enabled = false;
             m_back_store = move(m_front_store);
+            m_spare_store = nullptr;
             created_new_backing_store = true;
         } else if (was_purged) {
             // The backing store bitmap was cleared, but it does have memory.
@@ -795,6 +840,7 @@ void Window::set_has_alpha_channel(bool value)
     m_pending_paint_event_rects.clear();
     m_back_store = nullptr;
     m_front_store = nullptr;
+    m_spare_store = nullptr;
 
     ConnectionToWindowServer::the().async_set_window_has_alpha_channel(m_window_id, value);
     update();
@@ -849,7 +895,28 @@ void Window::set_hovered_widget(Widget* widget)
 void Window::set_current_backing_store(WindowBackingStore& backing_store, bool flush_immediately)
 {
     auto& bitmap = backing_store.bitmap();
-    ConnectionToWindowServer::the().set_window_backing_store(m_window_id, 32, bitmap.pitch(), bitmap.anonymous_buffer().fd(), backing_store.serial(), bitmap.has_alpha_channel(), bitmap.size(), flush_immediately);
+    backing_store.set_submission(++m_last_backing_store_submission);
+    ConnectionToWindowServer::the().async_set_window_backing_store(m_window_id, 32, bitmap.pitch(), bitmap.anonymous_buffer().fd(), backing_store.serial(), bitmap.has_alpha_channel(), bitmap.size(), flush_immediately);
+}
+
+bool Window::is_in_use_by_window_server(WindowBackingStore const& backing_store) const
+{
+    // WindowServer handles the stores we give it in order, and tells us each time it switched to one.
+    // From then on, it's done with all the stores we gave it before.
+    return backing_store.submission() != 0 && backing_store.submission() >= m_last_acknowledged_backing_store_submission;
+}
+
+void Window::did_switch_backing_store(Badge<ConnectionToWindowServer>, i32 serial)
+{
+    acknowledge_backing_store(serial);
+}
+
+void Window::acknowledge_backing_store(i32 serial)
+{
+    for (auto* backing_store : { m_front_store.ptr(), m_back_store.ptr(), m_spare_store.ptr() }) {
+        if (backing_store && backing_store->serial() == serial)
+            m_last_acknowledged_backing_store_submission = max(m_last_acknowledged_backing_store_submission, backing_store->submission());
+    }
 }
 
 void Window::flip(Vector<Gfx::IntRect, 32> const& dirty_rects)
@@ -858,18 +925,57 @@ void Window::flip(Vector<Gfx::IntRect, 32> const& dirty_rects)
 
     set_current_backing_store(*m_front_store);
 
-    if (!m_back_store || m_back_store->size() != m_front_store->size()) {
-        m_back_store = create_backing_store(m_front_store->size());
+    for (auto* backing_store : { m_back_store.ptr(), m_spare_store.ptr() }) {
+        if (backing_store)
+            backing_store->add_stale_rects(dirty_rects);
+    }
+
+    // WindowServer might not have gotten around to the store we gave it last time yet, let alone this one.
+    // Rather than waiting for it, paint the next frame into the third store. We only have to wait if we're
+    // more than a frame ahead.
+    auto size = m_front_store->size();
+    if (m_back_store && m_back_store->size() != size)
+        m_back_store = nullptr;
+    if (m_spare_store && m_spare_store->size() != size)
+        m_spare_store = nullptr;
+
+    if (m_back_store && m_spare_store) {
+        while (is_in_use_by_window_server(*m_back_store) && is_in_use_by_window_server(*m_spare_store)) {
+            auto message = ConnectionToWindowServer::the().wait_for_specific_message<Messages::WindowClient::DidSwitchBackingStore>();
+            if (!message)
+                break;
+            if (auto* window = Window::from_window_id(message->window_id()))
+                window->acknowledge_backing_store(message->serial());
+        }
+    }
+
+    if (!m_back_store || is_in_use_by_window_server(*m_back_store))
+        swap(m_back_store, m_spare_store);
+    if (m_back_store && is_in_use_by_window_server(*m_back_store)) {
+        if (!m_spare_store)
+            m_spare_store = move(m_back_store);
+        else
+            m_back_store = nullptr;
+    }
+
+    if (m_back_store) {
+        bool was_purged = false;
+        if (!m_back_store->bitmap().set_nonvolatile(was_purged))
+            m_back_store = nullptr;
+        else if (was_purged)
+            m_back_store->mark_entirely_stale();
+    }
+
+    if (!m_back_store) {
+        m_back_store = create_backing_store(size);
         VERIFY(m_back_store);
         memcpy(m_back_store->bitmap().scanline(0), m_front_store->bitmap().scanline(0), m_front_store->bitmap().size_in_bytes());
         m_back_store->bitmap().set_volatile();
         return;
     }
 
-    // Copy whatever was painted from the front to the back.
-    Painter painter(m_back_store->bitmap());
-    for (auto& dirty_rect : dirty_rects)
-        painter.blit(dirty_rect.location(), m_front_store->bitmap(), dirty_rect, 1.0f, false);
+    // Copy whatever was painted into the other stores since this one was last used.
+    m_back_store->update_stale_rects_from(*m_front_store);
 
     m_back_store->bitmap().set_volatile();
 }
@@ -197,6 +197,7 @@ public:
     static void for_each_window(Badge<ConnectionToWindowServer>, Function<void(Window&)>);
     static void update_all_windows(Badge<ConnectionToWindowServer>);
     void notify_state_changed(Badge<ConnectionToWindowServer>, bool minimized, bool maximized, bool occluded);
+    void did_switch_backing_store(Badge<ConnectionToWindowServer>, i32 serial);
 
     virtual bool is_visible_for_timer_purposes() const override { return m_visible_for_timer_purposes; }
 
@@ -258,6 +259,8 @@ private:
     OwnPtr<WindowBackingStore> create_backing_store(Gfx::IntSize const&);
     void set_current_backing_store(WindowBackingStore&, bool flush_immediately = false);
     void flip(Vector<Gfx::IntRect, 32> const& dirty_rects);
+    bool is_in_use_by_window_server(WindowBackingStore const&) const;
+    void acknowledge_backing_store(i32 serial);
     void force_update();
 
     bool are_cursors_the_same(AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&, AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&) const;
@@ -266,6 +269,9 @@ private:
 
     OwnPtr<WindowBackingStore> m_front_store;
     OwnPtr<WindowBackingStore> m_back_store;
+    OwnPtr<WindowBackingStore> m_spare_store;
+    u64 m_last_backing_store_submission { 0 };
+    u64 m_last_acknowledged_backing_store_submission { 0 };
 
     NonnullRefPtr<Menubar> m_menubar;
 
@@ -55,8 +55,7 @@ bool Job::can_read_line() const
 
 String Job::read_line(size_t size)
 {
-    ByteBuffer buffer = ByteBuffer::create_uninitialized(size).release_value_but_fixme_should_propagate_errors();
-    auto bytes_read = MUST(m_socket->read_until(buffer, "\r\n"sv));
+    auto bytes_read = MUST(m_socket->read_until_in_place("\r\n"sv, size));
     return String::copy(bytes_read);
 }
 
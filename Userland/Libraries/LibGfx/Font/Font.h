@@ -15,6 +15,7 @@
 #include <LibCore/MappedFile.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Size.h>
+#include <math.h>
 
 namespace Gfx {
 
@@ -53,6 +54,23 @@ private:
     IntSize m_size { 0, 0 };
 };
 
+// Where a glyph sits horizontally within the pixel it starts in, for fonts that can rasterize at fractional positions.
+struct GlyphSubpixelOffset {
+    static constexpr u8 steps_per_pixel = 4;
+
+    // A glyph at x is drawn at pixel_for_position(x), shifted right by for_position(x).
+    static int pixel_for_position(float x) { return static_cast<int>(floorf(roundf(x * steps_per_pixel) / steps_per_pixel)); }
+    static GlyphSubpixelOffset for_position(float x)
+    {
+        auto steps = static_cast<int>(roundf(x * steps_per_pixel)) - pixel_for_position(x) * steps_per_pixel;
+        return { static_cast<u8>(steps) };
+    }
+
+    float to_float() const { return static_cast<float>(x) / steps_per_pixel; }
+
+    u8 x { 0 };
+};
+
 class Glyph {
 public:
     Glyph(GlyphBitmap const& glyph_bitmap, int left_bearing, int advance, int ascent)
@@ -65,6 +83,17 @@ public:
 
     Glyph(RefPtr<Bitmap> bitmap, int left_bearing, int advance, int ascent)
         : m_bitmap(bitmap)
+        , m_bitmap_rect(bitmap ? bitmap->rect() : IntRect {})
+        , m_left_bearing(left_bearing)
+        , m_advance(advance)
+        , m_ascent(ascent)
+    {
+    }
+
+    // A glyph that's one part of a larger bitmap, e.g. a glyph atlas.
+    Glyph(RefPtr<Bitmap> bitmap, IntRect const& bitmap_rect, int left_bearing, int advance, int ascent)
+        : m_bitmap(bitmap)
+        , m_bitmap_rect(bitmap_rect)
         , m_left_bearing(left_bearing)
         , m_advance(advance)
         , m_ascent(ascent)
@@ -74,6 +103,7 @@ public:
     bool is_glyph_bitmap() const { return !m_bitmap; }
     GlyphBitmap glyph_bitmap() const { return m_glyph_bitmap; }
     RefPtr<Bitmap> bitmap() const { return m_bitmap; }
+    IntRect const& bitmap_rect() const { return m_bitmap_rect; }
     int left_bearing() const { return m_left_bearing; }
     int advance() const { return m_advance; }
     int ascent() const { return m_ascent; }
@@ -81,6 +111,7 @@ public:
 private:
     GlyphBitmap m_glyph_bitmap;
     RefPtr<Bitmap> m_bitmap;
+    IntRect m_bitmap_rect;
     int m_left_bearing;
     int m_advance;
     int m_ascent;
@@ -123,6 +154,7 @@ public:
 
     virtual u16 weight() const = 0;
     virtual Glyph glyph(u32 code_point) const = 0;
+    virtual Glyph glyph(u32 code_point, GlyphSubpixelOffset) const { return glyph(code_point); }
     virtual bool contains_glyph(u32 code_point) const = 0;
 
     virtual u8 glyph_width(u32 code_point) const = 0;
@@ -5,9 +5,14 @@
  */
 
 #include <AK/FlyString.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/QuickSort.h>
 #include <LibCore/DirIterator.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/Font/TrueType/Font.h>
@@ -72,6 +77,11 @@ String FontDatabase::default_fonts_lookup_path()
     return s_default_fonts_lookup_path;
 }
 
+String FontDatabase::font_index_path()
+{
+    return String::formatted("{}.json", s_default_fonts_lookup_path);
+}
+
 Font& FontDatabase::default_font()
 {
     if (!s_default_font) {
@@ -115,47 +125,165 @@ Font& FontDatabase::default_fixed_width_font()
     return *s_fixed_width_font;
 }
 
+// What the font index knows about every font, which is enough to find the ones a query asks for without loading them.
+struct FontDatabase::IndexedFont {
+    String path;
+    String family;
+    String variant;
+    String qualified_name;
+    unsigned weight { 0 };
+    unsigned slope { 0 };
+};
+
 struct FontDatabase::Private {
     HashMap<String, NonnullRefPtr<Gfx::Font>> full_name_to_font_map;
     Vector<RefPtr<Typeface>> typefaces;
+
+    // Fonts from the font index that nobody has asked for yet.
+    Vector<IndexedFont> unloaded_fonts;
 };
 
+// The index records the modification time of the lookup path it was made from. Adding or removing a font changes that,
+// which makes the index stale, and we go back to loading everything until it is written again.
+ErrorOr<Vector<FontDatabase::IndexedFont>> FontDatabase::read_font_index()
+{
+    auto file = TRY(Core::Stream::File::open(font_index_path(), Core::Stream::OpenMode::Read));
+    auto contents = TRY(file->read_all());
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_object())
+        return Error::from_string_literal("Font index is not an object");
+
+    auto directory = TRY(Core::System::stat(s_default_fonts_lookup_path));
+    auto const& index = json.as_object();
+    if (index.get("directory_modification_time"sv).to_i64(-1) != directory.st_mtime)
+        return Error::from_string_literal("Font index is stale");
+
+    auto fonts = index.get("fonts"sv);
+    if (!fonts.is_array())
+        return Error::from_string_literal("Font index has no fonts");
+
+    Vector<IndexedFont> indexed_fonts;
+    TRY(indexed_fonts.try_ensure_capacity(fonts.as_array().size()));
+    for (auto const& value : fonts.as_array().values()) {
+        if (!value.is_object())
+            return Error::from_string_literal("Font index entry is not an object");
+        auto const& font = value.as_object();
+        indexed_fonts.unchecked_append({
+            .path = font.get("path"sv).to_string(),
+            .family = font.get("family"sv).to_string(),
+            .variant = font.get("variant"sv).to_string(),
+            .qualified_name = font.get("qualified_name"sv).as_string_or({}),
+            .weight = font.get("weight"sv).to_u32(),
+            .slope = font.get("slope"sv).to_u32(),
+        });
+    }
+    return indexed_fonts;
+}
+
 FontDatabase::FontDatabase()
     : m_private(make<Private>())
 {
+    if (auto index = read_font_index(); !index.is_error()) {
+        m_private->unloaded_fonts = index.release_value();
+        return;
+    }
+
     Core::DirIterator dir_iterator(s_default_fonts_lookup_path, Core::DirIterator::SkipDots);
     if (dir_iterator.has_error()) {
         warnln("DirIterator: {}", dir_iterator.error_string());
         exit(1);
     }
+    while (dir_iterator.has_next())
+        load_font(dir_iterator.next_full_path());
+}
+
+void FontDatabase::load_font(String const& path)
+{
+    if (path.ends_with(".font"sv)) {
+        if (auto font = Gfx::BitmapFont::load_from_file(path)) {
+            m_private->full_name_to_font_map.set(font->qualified_name(), *font);
+            auto typeface = get_or_create_typeface(font->family(), font->variant());
+            typeface->add_bitmap_font(font);
+        }
+    } else if (path.ends_with(".ttf"sv)) {
+        // FIXME: What about .otf
+        if (auto font_or_error = TTF::Font::try_load_from_file(path); !font_or_error.is_error()) {
+            auto font = font_or_error.release_value();
+            auto typeface = get_or_create_typeface(font->family(), font->variant());
+            typeface->set_vector_font(move(font));
+        }
+    } else if (path.ends_with(".woff"sv)) {
+        if (auto font_or_error = WOFF::Font::try_load_from_file(path); !font_or_error.is_error()) {
+            auto font = font_or_error.release_value();
+            auto typeface = get_or_create_typeface(font->family(), font->variant());
+            typeface->set_vector_font(move(font));
+        }
+    }
+}
+
+void FontDatabase::load_indexed_fonts_if(Function<bool(IndexedFont const&)> predicate)
+{
+    m_private->unloaded_fonts.remove_all_matching([&](auto const& font) {
+        if (!predicate(font))
+            return false;
+        load_font(font.path);
+        return true;
+    });
+}
+
+ErrorOr<void> FontDatabase::write_font_index()
+{
+    auto directory = TRY(Core::System::stat(s_default_fonts_lookup_path));
+
+    JsonArray fonts;
+    auto add_font = [&](String const& path, auto const& font, String qualified_name = {}) {
+        JsonObject object;
+        object.set("path", path);
+        object.set("family", font.family());
+        object.set("variant", font.variant());
+        if (!qualified_name.is_null())
+            object.set("qualified_name", move(qualified_name));
+        object.set("weight", font.weight());
+        object.set("slope", font.slope());
+        fonts.append(move(object));
+    };
+
+    Core::DirIterator dir_iterator(s_default_fonts_lookup_path, Core::DirIterator::SkipDots);
+    if (dir_iterator.has_error())
+        return Error::from_errno(dir_iterator.error());
     while (dir_iterator.has_next()) {
         auto path = dir_iterator.next_full_path();
-
         if (path.ends_with(".font"sv)) {
-            if (auto font = Gfx::BitmapFont::load_from_file(path)) {
-                m_private->full_name_to_font_map.set(font->qualified_name(), *font);
-                auto typeface = get_or_create_typeface(font->family(), font->variant());
-                typeface->add_bitmap_font(font);
-            }
+            if (auto font_or_error = Gfx::BitmapFont::try_load_from_file(path); !font_or_error.is_error())
+                add_font(path, *font_or_error.value(), font_or_error.value()->qualified_name());
         } else if (path.ends_with(".ttf"sv)) {
-            // FIXME: What about .otf
-            if (auto font_or_error = TTF::Font::try_load_from_file(path); !font_or_error.is_error()) {
-                auto font = font_or_error.release_value();
-                auto typeface = get_or_create_typeface(font->family(), font->variant());
-                typeface->set_vector_font(move(font));
-            }
+            if (auto font_or_error = TTF::Font::try_load_from_file(path); !font_or_error.is_error())
+                add_font(path, *font_or_error.value());
         } else if (path.ends_with(".woff"sv)) {
-            if (auto font_or_error = WOFF::Font::try_load_from_file(path); !font_or_error.is_error()) {
-                auto font = font_or_error.release_value();
-                auto typeface = get_or_create_typeface(font->family(), font->variant());
-                typeface->set_vector_font(move(font));
-            }
+            if (auto font_or_error = WOFF::Font::try_load_from_file(path); !font_or_error.is_error())
+                add_font(path, *font_or_error.value());
         }
     }
+
+    JsonObject index;
+    index.set("directory_modification_time", static_cast<i64>(directory.st_mtime));
+    index.set("fonts", move(fonts));
+
+    // Write the index next to its final location first, so that nobody ever sees half of it.
+    auto index_path = font_index_path();
+    auto temporary_path = String::formatted("{}.tmp", index_path);
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+        if (!file->write_or_error(index.to_string().bytes()))
+            return Error::from_string_literal("Could not write the font index");
+    }
+    TRY(Core::System::rename(temporary_path, index_path));
+    return {};
 }
 
 void FontDatabase::for_each_font(Function<void(Gfx::Font const&)> callback)
 {
+    load_indexed_fonts_if([](auto const&) { return true; });
     Vector<RefPtr<Gfx::Font>> fonts;
     fonts.ensure_capacity(m_private->full_name_to_font_map.size());
     for (auto& it : m_private->full_name_to_font_map)
@@ -167,6 +295,7 @@ void FontDatabase::for_each_font(Function<void(Gfx::Font const&)> callback)
 
 void FontDatabase::for_each_fixed_width_font(Function<void(Gfx::Font const&)> callback)
 {
+    load_indexed_fonts_if([](auto const&) { return true; });
     Vector<RefPtr<Gfx::Font>> fonts;
     fonts.ensure_capacity(m_private->full_name_to_font_map.size());
     for (auto& it : m_private->full_name_to_font_map) {
@@ -180,6 +309,7 @@ void FontDatabase::for_each_fixed_width_font(Function<void(Gfx::Font const&)> ca
 
 RefPtr<Gfx::Font> FontDatabase::get_by_name(StringView name)
 {
+    load_indexed_fonts_if([&](auto const& font) { return font.qualified_name == name; });
     auto it = m_private->full_name_to_font_map.find(name);
     if (it == m_private->full_name_to_font_map.end()) {
         auto parts = name.split_view(" "sv);
@@ -198,6 +328,7 @@ RefPtr<Gfx::Font> FontDatabase::get_by_name(StringView name)
 
 RefPtr<Gfx::Font> FontDatabase::get(FlyString const& family, float point_size, unsigned weight, unsigned slope, Font::AllowInexactSizeMatch allow_inexact_size_match)
 {
+    load_indexed_fonts_if([&](auto const& font) { return font.family == family && font.weight == weight && font.slope == slope; });
     for (auto typeface : m_private->typefaces) {
         if (typeface->family() == family && typeface->weight() == weight && typeface->slope() == slope)
             return typeface->get_font(point_size, allow_inexact_size_match);
@@ -207,6 +338,7 @@ RefPtr<Gfx::Font> FontDatabase::get(FlyString const& family, float point_size, u
 
 RefPtr<Gfx::Font> FontDatabase::get(FlyString const& family, FlyString const& variant, float point_size, Font::AllowInexactSizeMatch allow_inexact_size_match)
 {
+    load_indexed_fonts_if([&](auto const& font) { return font.family == family && font.variant == variant; });
     for (auto typeface : m_private->typefaces) {
         if (typeface->family() == family && typeface->variant() == variant)
             return typeface->get_font(point_size, allow_inexact_size_match);
@@ -227,6 +359,7 @@ RefPtr<Typeface> FontDatabase::get_or_create_typeface(String const& family, Stri
 
 void FontDatabase::for_each_typeface(Function<void(Typeface const&)> callback)
 {
+    load_indexed_fonts_if([](auto const&) { return true; });
     for (auto typeface : m_private->typefaces) {
         callback(*typeface);
     }
@@ -43,6 +43,7 @@ public:
     static String fixed_width_font_query();
 
     static String default_fonts_lookup_path();
+    static String font_index_path();
     static void set_default_font_query(String);
     static void set_window_title_font_query(String);
     static void set_fixed_width_font_query(String);
@@ -56,11 +57,20 @@ public:
 
     void for_each_typeface(Function<void(Typeface const&)>);
 
+    // Writes an index of the fonts in the lookup path to the font index path. As long as the lookup path doesn't change
+    // afterwards, processes then only load the fonts they actually use, instead of every single one of them.
+    static ErrorOr<void> write_font_index();
+
 private:
     FontDatabase();
     ~FontDatabase() = default;
 
+    struct IndexedFont;
+    static ErrorOr<Vector<IndexedFont>> read_font_index();
+
     RefPtr<Typeface> get_or_create_typeface(String const& family, String const& variant);
+    void load_font(String const& path);
+    void load_indexed_fonts_if(Function<bool(IndexedFont const&)>);
 
     struct Private;
     OwnPtr<Private> m_private;
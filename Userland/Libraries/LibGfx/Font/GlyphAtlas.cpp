@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Memory.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+
+namespace Gfx {
+
+// Rounding shelf heights up a little lets glyphs of similar heights share shelves.
+static int shelf_height_for(int glyph_height)
+{
+    return align_up_to(max(glyph_height, 1), 4);
+}
+
+Optional<IntRect> GlyphAtlas::find(u32 glyph_id, GlyphSubpixelOffset subpixel_offset)
+{
+    auto it = m_entries.find(key_for(glyph_id, subpixel_offset));
+    if (it == m_entries.end())
+        return {};
+    m_shelves[it->value.shelf_index].last_used = ++m_use_counter;
+    return it->value.rect;
+}
+
+Optional<IntRect> GlyphAtlas::insert(u32 glyph_id, GlyphSubpixelOffset subpixel_offset, Bitmap const& glyph)
+{
+    VERIFY(glyph.format() == BitmapFormat::BGRA8888);
+    if (!can_hold(glyph.size()))
+        return {};
+
+    auto shelf_index = find_shelf_with_room_for(glyph.size());
+    if (!shelf_index.has_value())
+        shelf_index = add_shelf(shelf_height_for(glyph.height()));
+    if (!shelf_index.has_value())
+        shelf_index = evict_shelf_for(shelf_height_for(glyph.height()));
+    if (!shelf_index.has_value())
+        return {};
+
+    auto& shelf = m_shelves[*shelf_index];
+    IntRect rect { shelf.used_width, shelf.y, glyph.width(), glyph.height() };
+    for (int y = 0; y < glyph.height(); ++y)
+        fast_u32_copy(m_bitmap->scanline(rect.y() + y) + rect.x(), glyph.scanline(y), glyph.width());
+
+    auto key = key_for(glyph_id, subpixel_offset);
+    shelf.used_width += glyph.width();
+    shelf.last_used = ++m_use_counter;
+    shelf.keys.append(key);
+    m_entries.set(key, { rect, *shelf_index });
+    return rect;
+}
+
+Optional<size_t> GlyphAtlas::find_shelf_with_room_for(IntSize const& size)
+{
+    auto height = shelf_height_for(size.height());
+    for (size_t i = 0; i < m_shelves.size(); ++i) {
+        auto& shelf = m_shelves[i];
+        if (shelf.height == height && shelf.used_width + size.width() <= width)
+            return i;
+    }
+    return {};
+}
+
+Optional<size_t> GlyphAtlas::add_shelf(int height)
+{
+    if (m_used_height + height > max_height)
+        return {};
+
+    int bitmap_height = m_bitmap ? m_bitmap->height() : 0;
+    if (m_used_height + height > bitmap_height) {
+        auto new_height = max(bitmap_height, initial_height);
+        while (new_height < m_used_height + height)
+            new_height *= 2;
+        if (resize_bitmap(min(new_height, max_height)).is_error())
+            return {};
+    }
+
+    m_shelves.append({ .y = m_used_height, .height = height });
+    m_used_height += height;
+    return m_shelves.size() - 1;
+}
+
+Optional<size_t> GlyphAtlas::evict_shelf_for(int height)
+{
+    // Prefer a shelf of just the right height, so the space doesn't go to waste on smaller glyphs.
+    Optional<size_t> least_recently_used;
+    Optional<size_t> least_recently_used_taller;
+    for (size_t i = 0; i < m_shelves.size(); ++i) {
+        auto& shelf = m_shelves[i];
+        if (shelf.height == height && (!least_recently_used.has_value() || shelf.last_used < m_shelves[*least_recently_used].last_used))
+            least_recently_used = i;
+        if (shelf.height > height && (!least_recently_used_taller.has_value() || shelf.last_used < m_shelves[*least_recently_used_taller].last_used))
+            least_recently_used_taller = i;
+    }
+    if (!least_recently_used.has_value())
+        least_recently_used = least_recently_used_taller;
+
+    // Someone might still be about to draw one of the evicted glyphs from the current bitmap.
+    if (make_bitmap_unshared().is_error())
+        return {};
+
+    if (!least_recently_used.has_value()) {
+        // Every shelf is too short for this glyph, so start over.
+        m_entries.clear();
+        m_shelves.clear();
+        m_used_height = 0;
+        return add_shelf(height);
+    }
+
+    evict(m_shelves[*least_recently_used]);
+    return least_recently_used;
+}
+
+void GlyphAtlas::evict(Shelf& shelf)
+{
+    for (auto key : shelf.keys)
+        m_entries.remove(key);
+    shelf.keys.clear();
+    shelf.used_width = 0;
+}
+
+ErrorOr<void> GlyphAtlas::resize_bitmap(int height)
+{
+    auto new_bitmap = TRY(Bitmap::try_create(BitmapFormat::BGRA8888, { width, height }));
+    new_bitmap->fill(Color::Transparent);
+    if (m_bitmap) {
+        for (int y = 0; y < m_bitmap->height(); ++y)
+            fast_u32_copy(new_bitmap->scanline(y), m_bitmap->scanline(y), width);
+    }
+    m_bitmap = move(new_bitmap);
+    return {};
+}
+
+ErrorOr<void> GlyphAtlas::make_bitmap_unshared()
+{
+    if (!m_bitmap || m_bitmap->ref_count() == 1)
+        return {};
+    m_bitmap = TRY(m_bitmap->clone());
+    return {};
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
+
+namespace Gfx {
+
+// Keeps the rasterized glyphs of one font at one size in a single bitmap, so drawing a run of text
+// reads from one place instead of dozens of small bitmaps. Glyphs are packed onto shelves of equal height,
+// and when the atlas is full, the shelf that was used least recently is evicted as a whole.
+class GlyphAtlas {
+    AK_MAKE_NONCOPYABLE(GlyphAtlas);
+    AK_MAKE_NONMOVABLE(GlyphAtlas);
+
+public:
+    GlyphAtlas() = default;
+
+    static constexpr int width = 512;
+    static constexpr int initial_height = 64;
+    static constexpr int max_height = 1024;
+
+    // Glyphs larger than this are better off not being cached in the atlas.
+    static bool can_hold(IntSize const& size) { return size.width() <= width && size.height() <= max_height / 4; }
+
+    RefPtr<Bitmap> bitmap() const { return m_bitmap; }
+
+    Optional<IntRect> find(u32 glyph_id, GlyphSubpixelOffset);
+
+    // Copies the glyph into the atlas, and returns where it ended up.
+    Optional<IntRect> insert(u32 glyph_id, GlyphSubpixelOffset, Bitmap const& glyph);
+
+private:
+    struct Shelf {
+        int y { 0 };
+        int height { 0 };
+        int used_width { 0 };
+        u64 last_used { 0 };
+        Vector<u32> keys;
+    };
+
+    struct Entry {
+        IntRect rect;
+        size_t shelf_index { 0 };
+    };
+
+    static u32 key_for(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) { return glyph_id * GlyphSubpixelOffset::steps_per_pixel + subpixel_offset.x; }
+
+    Optional<size_t> find_shelf_with_room_for(IntSize const&);
+    Optional<size_t> add_shelf(int height);
+    Optional<size_t> evict_shelf_for(int height);
+    void evict(Shelf&);
+    ErrorOr<void> resize_bitmap(int height);
+    ErrorOr<void> make_bitmap_unshared();
+
+    RefPtr<Bitmap> m_bitmap;
+    Vector<Shelf> m_shelves;
+    HashMap<u32, Entry> m_entries;
+    int m_used_height { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
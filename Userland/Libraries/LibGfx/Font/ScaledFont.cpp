@@ -38,22 +38,35 @@ ALWAYS_INLINE int ScaledFont::unicode_view_width(T const& view) const
     return longest_width;
 }
 
-RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id) const
+RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
 {
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(glyph_id);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
-
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
-    m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
-    return glyph_bitmap;
+    return m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
 }
 
-Gfx::Glyph ScaledFont::glyph(u32 code_point) const
+Gfx::Glyph ScaledFont::glyph(u32 code_point, GlyphSubpixelOffset subpixel_offset) const
 {
     auto id = glyph_id_for_code_point(code_point);
-    auto bitmap = rasterize_glyph(id);
     auto metrics = glyph_metrics(id);
+
+    if (auto rect = m_glyph_atlas.find(id, subpixel_offset); rect.has_value())
+        return Gfx::Glyph(m_glyph_atlas.bitmap(), *rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+
+    if (auto it = m_cached_large_glyph_bitmaps.find(id); it != m_cached_large_glyph_bitmaps.end())
+        return Gfx::Glyph(it->value, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+
+    auto bitmap = rasterize_glyph(id, subpixel_offset);
+    if (!bitmap)
+        return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+
+    if (!GlyphAtlas::can_hold(bitmap->size())) {
+        if (subpixel_offset.x != 0)
+            bitmap = rasterize_glyph(id);
+        m_cached_large_glyph_bitmaps.set(id, bitmap);
+        return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+    }
+
+    if (auto rect = m_glyph_atlas.insert(id, subpixel_offset, *bitmap); rect.has_value())
+        return Gfx::Glyph(m_glyph_atlas.bitmap(), *rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
     return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
 }
 
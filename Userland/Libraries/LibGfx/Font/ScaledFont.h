@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/Font.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Font/VectorFont.h>
 
 #define POINTS_PER_INCH 72.0f
@@ -30,7 +31,7 @@ public:
     u32 glyph_id_for_code_point(u32 code_point) const { return m_font->glyph_id_for_code_point(code_point); }
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale); }
-    RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id) const;
+    RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset = {}) const;
 
     // ^Gfx::Font
     virtual NonnullRefPtr<Font> clone() const override { return *this; } // FIXME: clone() should not need to be implemented
@@ -40,7 +41,8 @@ public:
     virtual Gfx::FontPixelMetrics pixel_metrics() const override;
     virtual u8 slope() const override { return m_font->slope(); }
     virtual u16 weight() const override { return m_font->weight(); }
-    virtual Gfx::Glyph glyph(u32 code_point) const override;
+    virtual Gfx::Glyph glyph(u32 code_point) const override { return glyph(code_point, {}); }
+    virtual Gfx::Glyph glyph(u32 code_point, GlyphSubpixelOffset) const override;
     virtual bool contains_glyph(u32 code_point) const override { return m_font->glyph_id_for_code_point(code_point) > 0; }
     virtual u8 glyph_width(u32 code_point) const override;
     virtual int glyph_or_emoji_width(u32 code_point) const override;
@@ -71,7 +73,9 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
-    mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+    mutable GlyphAtlas m_glyph_atlas;
+    // Glyphs too large for the atlas, which are always rasterized at whole pixel positions.
+    mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_large_glyph_bitmaps;
 
     template<typename T>
     int unicode_view_width(T const& view) const;
@@ -4,8 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/SIMDMath.h>
 #include <LibGfx/Font/TrueType/Glyf.h>
-#include <LibGfx/Path.h>
 #include <LibGfx/Point.h>
 
 namespace TTF {
@@ -189,19 +189,89 @@ Optional<Glyf::Glyph::ComponentIterator::Item> Glyf::Glyph::ComponentIterator::n
     };
 }
 
+// Rasterizing a glyph needs a coverage buffer, and glyphs get rasterized one after another.
+// Rather than allocating a new buffer for each of them, one is kept around per thread.
+static thread_local Vector<float> s_coverage_buffer;
+static constexpr size_t max_kept_coverage_buffer_size = 512 * 512;
+
 Rasterizer::Rasterizer(Gfx::IntSize size)
     : m_size(size)
+    , m_stride(size.width() + 2)
+    , m_data(move(s_coverage_buffer))
+{
+    m_data.resize_and_keep_capacity(m_stride * m_size.height());
+    __builtin_memset(m_data.data(), 0, m_data.size() * sizeof(float));
+}
+
+Rasterizer::~Rasterizer()
+{
+    if (m_data.capacity() <= max_kept_coverage_buffer_size)
+        s_coverage_buffer = move(m_data);
+}
+
+void Rasterizer::line_to(Gfx::FloatPoint point)
+{
+    draw_line(m_cursor, point);
+    m_cursor = point;
+}
+
+void Rasterizer::quadratic_bezier_curve_to(Gfx::FloatPoint control, Gfx::FloatPoint point)
 {
-    m_data.resize(m_size.width() * m_size.height());
-    for (int i = 0; i < m_size.width() * m_size.height(); i++) {
-        m_data[i] = 0.0f;
+    auto start = m_cursor;
+    m_cursor = point;
+
+    // A quadratic curve strays at most a quarter of this from the line between its end points, and splitting it into
+    // n lines divides that by n^2. That gives the number of lines needed to stay within max_error pixels of the curve.
+    constexpr float max_error = 0.025f;
+    auto deviation = start - control * 2 + point;
+    float distance = sqrtf(deviation.x() * deviation.x() + deviation.y() * deviation.y());
+    int line_count = max(1, static_cast<int>(ceilf(sqrtf(distance / (4 * max_error)))));
+    float step = 1.0f / line_count;
+    auto previous = start;
+    for (int i = 1; i < line_count; ++i) {
+        float t = i * step;
+        auto next = (start * (1.0f - t) + control * t) * (1.0f - t) + (control * (1.0f - t) + point * t) * t;
+        draw_line(previous, next);
+        previous = next;
     }
+    draw_line(previous, point);
 }
 
-void Rasterizer::draw_path(Gfx::Path& path)
+ALWAYS_INLINE static u32 pixel_for_coverage(float coverage)
 {
-    for (auto& line : path.split_lines()) {
-        draw_line(line.from, line.to);
+    if (coverage < 0.0f)
+        coverage = -coverage;
+    if (coverage > 1.0f)
+        coverage = 1.0f;
+    return (static_cast<u32>(coverage * 255.0f) << 24) | 0x00ffffff;
+}
+
+// Turns one row of coverage deltas into white pixels, with the accumulated coverage as their alpha.
+static void accumulate_scanline(float const* deltas, Gfx::ARGB32* pixels, int width)
+{
+    using AK::SIMD::f32x4;
+    using AK::SIMD::u32x4;
+
+    float accumulator = 0.0f;
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        f32x4 coverage;
+        __builtin_memcpy(&coverage, deltas + x, sizeof(coverage));
+
+        // Running sum within the vector, followed by whatever came before it.
+        coverage += f32x4 { 0.0f, coverage[0], coverage[1], coverage[2] };
+        coverage += f32x4 { 0.0f, 0.0f, coverage[0], coverage[1] };
+        coverage += accumulator;
+        accumulator = coverage[3];
+
+        coverage = AK::SIMD::clamp(coverage < 0.0f ? -coverage : coverage, 0.0f, 1.0f);
+        auto alpha = (u32x4)AK::SIMD::to_i32x4(coverage * 255.0f);
+        u32x4 result = (alpha << 24) | 0x00ffffff;
+        __builtin_memcpy(pixels + x, &result, sizeof(result));
+    }
+    for (; x < width; ++x) {
+        accumulator += deltas[x];
+        pixels[x] = pixel_for_coverage(accumulator);
     }
 }
 
@@ -211,54 +281,13 @@ RefPtr<Gfx::Bitmap> Rasterizer::accumulate()
     if (bitmap_or_error.is_error())
         return {};
     auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
-    Color base_color = Color::from_rgb(0xffffff);
-    for (int y = 0; y < m_size.height(); y++) {
-        float accumulator = 0.0;
-        for (int x = 0; x < m_size.width(); x++) {
-            accumulator += m_data[y * m_size.width() + x];
-            float value = accumulator;
-            if (value < 0.0f) {
-                value = -value;
-            }
-            if (value > 1.0f) {
-                value = 1.0;
-            }
-            u8 alpha = value * 255.0f;
-            bitmap->set_pixel(x, y, base_color.with_alpha(alpha));
-        }
-    }
+    for (int y = 0; y < m_size.height(); y++)
+        accumulate_scanline(m_data.data() + y * m_stride, bitmap->scanline(y), m_size.width());
     return bitmap;
 }
 
 void Rasterizer::draw_line(Gfx::FloatPoint p0, Gfx::FloatPoint p1)
 {
-    // FIXME: Shift x and y according to dy/dx
-    if (p0.x() < 0.0f) {
-        p0.set_x(roundf(p0.x()));
-    }
-    if (p0.y() < 0.0f) {
-        p0.set_y(roundf(p0.y()));
-    }
-    if (p1.x() < 0.0f) {
-        p1.set_x(roundf(p1.x()));
-    }
-    if (p1.y() < 0.0f) {
-        p1.set_y(roundf(p1.y()));
-    }
-
-    if (!(p0.x() >= 0.0f && p0.y() >= 0.0f && p0.x() <= m_size.width() && p0.y() <= m_size.height())) {
-        dbgln("!P0({},{})", p0.x(), p0.y());
-        return;
-    }
-
-    if (!(p1.x() >= 0.0f && p1.y() >= 0.0f && p1.x() <= m_size.width() && p1.y() <= m_size.height())) {
-        dbgln("!P1({},{})", p1.x(), p1.y());
-        return;
-    }
-
-    VERIFY(p0.x() >= 0.0f && p0.y() >= 0.0f && p0.x() <= m_size.width() && p0.y() <= m_size.height());
-    VERIFY(p1.x() >= 0.0f && p1.y() >= 0.0f && p1.x() <= m_size.width() && p1.y() <= m_size.height());
-
     // If we're on the same Y, there's no need to draw
     if (p0.y() == p1.y()) {
         return;
@@ -267,31 +296,42 @@ void Rasterizer::draw_line(Gfx::FloatPoint p0, Gfx::FloatPoint p1)
     float direction = -1.0;
     if (p1.y() < p0.y()) {
         direction = 1.0;
-        auto tmp = p0;
-        p0 = p1;
-        p1 = tmp;
+        swap(p0, p1);
     }
 
+    // Anything above or below the canvas doesn't affect the rows on it, so that part of the line can go.
+    float const height = m_size.height();
+    if (p1.y() <= 0.0f || p0.y() >= height)
+        return;
     float dxdy = (p1.x() - p0.x()) / (p1.y() - p0.y());
+    if (p0.y() < 0.0f) {
+        p0.set_x(p0.x() - p0.y() * dxdy);
+        p0.set_y(0.0f);
+    }
+    if (p1.y() > height) {
+        p1.set_x(p1.x() - (p1.y() - height) * dxdy);
+        p1.set_y(height);
+    }
+
+    // Parts of the line left of the canvas cover everything to their right, so they're moved onto its left edge.
+    // Those right of it don't cover anything, so they go into the spare column to the right of each row.
+    float const max_x = m_size.width();
+    auto clamp_x = [max_x](float x) { return clamp(x, 0.0f, max_x); };
+
     u32 y0 = floorf(p0.y());
     u32 y1 = ceilf(p1.y());
     float x_cur = p0.x();
 
     for (u32 y = y0; y < y1; y++) {
-        u32 line_offset = m_size.width() * y;
+        float* line = m_data.data() + m_stride * y;
 
         float dy = min(y + 1.0f, p1.y()) - max((float)y, p0.y());
         float directed_dy = dy * direction;
         float x_next = x_cur + dy * dxdy;
-        if (x_next < 0.0f) {
-            x_next = 0.0f;
-        }
-        float x0 = x_cur;
-        float x1 = x_next;
-        if (x1 < x0) {
-            x1 = x_cur;
-            x0 = x_next;
-        }
+        float x0 = clamp_x(x_cur);
+        float x1 = clamp_x(x_next);
+        if (x1 < x0)
+            swap(x0, x1);
         float x0_floor = floorf(x0);
         float x1_ceil = ceilf(x1);
         u32 x0i = x0_floor;
@@ -299,23 +339,21 @@ void Rasterizer::draw_line(Gfx::FloatPoint p0, Gfx::FloatPoint p1)
         if (x1_ceil <= x0_floor + 1.0f) {
             // If x0 and x1 are within the same pixel, then area to the right is (1 - (mid(x0, x1) - x0_floor)) * dy
             float area = ((x0 + x1) * 0.5f) - x0_floor;
-            m_data[line_offset + x0i] += directed_dy * (1.0f - area);
-            m_data[line_offset + x0i + 1] += directed_dy * area;
+            line[x0i] += directed_dy * (1.0f - area);
+            line[x0i + 1] += directed_dy * area;
         } else {
-            float dydx = 1.0f / dxdy;
-            if (dydx < 0)
-                dydx = -dydx;
+            float dydx = dy / (x1 - x0);
 
             float x0_right = 1.0f - (x0 - x0_floor);
             u32 x1_floor_i = floorf(x1);
             float area_upto_here = 0.5f * x0_right * x0_right * dydx;
-            m_data[line_offset + x0i] += direction * area_upto_here;
+            line[x0i] += direction * area_upto_here;
             for (u32 x = x0i + 1; x < x1_floor_i; x++) {
-                m_data[line_offset + x] += direction * dydx;
+                line[x] += direction * dydx;
                 area_upto_here += dydx;
             }
             float remaining_area = (dy - area_upto_here);
-            m_data[line_offset + x1_floor_i] += direction * remaining_area;
+            line[x1_floor_i] += direction * remaining_area;
         }
 
         x_cur = x_next;
@@ -394,7 +432,6 @@ void Glyf::Glyph::rasterize_impl(Rasterizer& rasterizer, Gfx::AffineTransform co
     get_ttglyph_offsets(m_slice, num_points, flags_offset, &x_offset, &y_offset);
 
     // Prepare to render glyph.
-    Gfx::Path path;
     PointIterator point_iterator(m_slice, num_points, flags_offset, x_offset, y_offset, transform);
 
     int last_contour_end = -1;
@@ -415,7 +452,7 @@ void Glyf::Glyph::rasterize_impl(Rasterizer& rasterizer, Gfx::AffineTransform co
             auto opt_item = point_iterator.next();
             VERIFY(opt_item.has_value());
             contour_start = opt_item.value().point;
-            path.move_to(contour_start.value());
+            rasterizer.move_to(contour_start.value());
             contour_size--;
         } else if (!last_offcurve_point.has_value()) {
             if (contour_size > 0) {
@@ -427,7 +464,7 @@ void Glyf::Glyph::rasterize_impl(Rasterizer& rasterizer, Gfx::AffineTransform co
                 auto item = opt_item.value();
                 contour_size--;
                 if (item.on_curve) {
-                    path.line_to(item.point);
+                    rasterizer.line_to(item.point);
                 } else if (contour_size > 0) {
                     auto opt_next_item = point_iterator.next();
                     // FIXME: Should we draw a quadratic bezier to the first point here?
@@ -437,18 +474,18 @@ void Glyf::Glyph::rasterize_impl(Rasterizer& rasterizer, Gfx::AffineTransform co
                     auto next_item = opt_next_item.value();
                     contour_size--;
                     if (next_item.on_curve) {
-                        path.quadratic_bezier_curve_to(item.point, next_item.point);
+                        rasterizer.quadratic_bezier_curve_to(item.point, next_item.point);
                     } else {
                         auto mid_point = (item.point + next_item.point) * 0.5f;
-                        path.quadratic_bezier_curve_to(item.point, mid_point);
+                        rasterizer.quadratic_bezier_curve_to(item.point, mid_point);
                         last_offcurve_point = next_item.point;
                     }
                 } else {
-                    path.quadratic_bezier_curve_to(item.point, contour_start.value());
+                    rasterizer.quadratic_bezier_curve_to(item.point, contour_start.value());
                     contour_start = {};
                 }
             } else {
-                path.line_to(contour_start.value());
+                rasterizer.line_to(contour_start.value());
                 contour_start = {};
             }
         } else {
@@ -463,28 +500,26 @@ void Glyf::Glyph::rasterize_impl(Rasterizer& rasterizer, Gfx::AffineTransform co
                 auto item = opt_item.value();
                 contour_size--;
                 if (item.on_curve) {
-                    path.quadratic_bezier_curve_to(point0, item.point);
+                    rasterizer.quadratic_bezier_curve_to(point0, item.point);
                 } else {
                     auto mid_point = (point0 + item.point) * 0.5f;
-                    path.quadratic_bezier_curve_to(point0, mid_point);
+                    rasterizer.quadratic_bezier_curve_to(point0, mid_point);
                     last_offcurve_point = item.point;
                 }
             } else {
-                path.quadratic_bezier_curve_to(point0, contour_start.value());
+                rasterizer.quadratic_bezier_curve_to(point0, contour_start.value());
                 contour_start = {};
             }
         }
     }
-
-    rasterizer.draw_path(path);
 }
 
-RefPtr<Gfx::Bitmap> Glyf::Glyph::rasterize_simple(i16 font_ascender, i16 font_descender, float x_scale, float y_scale) const
+RefPtr<Gfx::Bitmap> Glyf::Glyph::rasterize_simple(i16 font_ascender, i16 font_descender, float x_scale, float y_scale, Gfx::GlyphSubpixelOffset subpixel_offset) const
 {
     u32 width = (u32)(ceilf((m_xmax - m_xmin) * x_scale)) + 2;
     u32 height = (u32)(ceilf((font_ascender - font_descender) * y_scale)) + 2;
     Rasterizer rasterizer(Gfx::IntSize(width, height));
-    auto affine = Gfx::AffineTransform().scale(x_scale, -y_scale).translate(-m_xmin, -font_ascender);
+    auto affine = Gfx::AffineTransform().translate(subpixel_offset.to_float(), 0).scale(x_scale, -y_scale).translate(-m_xmin, -font_ascender);
     rasterize_impl(rasterizer, affine);
     return rasterizer.accumulate();
 }
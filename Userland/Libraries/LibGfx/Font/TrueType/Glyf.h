@@ -10,6 +10,7 @@
 #include <AK/Vector.h>
 #include <LibGfx/AffineTransform.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
 #include <LibGfx/Font/TrueType/Tables.h>
 #include <math.h>
 
@@ -18,13 +19,22 @@ namespace TTF {
 class Rasterizer {
 public:
     Rasterizer(Gfx::IntSize);
-    void draw_path(Gfx::Path&);
+    ~Rasterizer();
+
+    // Outlines are drawn straight into the coverage buffer, without building a Gfx::Path first.
+    void move_to(Gfx::FloatPoint point) { m_cursor = point; }
+    void line_to(Gfx::FloatPoint);
+    void quadratic_bezier_curve_to(Gfx::FloatPoint control, Gfx::FloatPoint);
+
     RefPtr<Gfx::Bitmap> accumulate();
 
 private:
     void draw_line(Gfx::FloatPoint, Gfx::FloatPoint);
 
     Gfx::IntSize m_size;
+    Gfx::FloatPoint m_cursor;
+    // Each row has room for an extra column on the right, which is where lines right of the glyph end up.
+    size_t m_stride { 0 };
     Vector<float> m_data;
 };
 
@@ -63,13 +73,13 @@ public:
             }
         }
         template<typename GlyphCb>
-        RefPtr<Gfx::Bitmap> rasterize(i16 font_ascender, i16 font_descender, float x_scale, float y_scale, GlyphCb glyph_callback) const
+        RefPtr<Gfx::Bitmap> rasterize(i16 font_ascender, i16 font_descender, float x_scale, float y_scale, Gfx::GlyphSubpixelOffset subpixel_offset, GlyphCb glyph_callback) const
         {
             switch (m_type) {
             case Type::Simple:
-                return rasterize_simple(font_ascender, font_descender, x_scale, y_scale);
+                return rasterize_simple(font_ascender, font_descender, x_scale, y_scale, subpixel_offset);
             case Type::Composite:
-                return rasterize_composite(font_ascender, font_descender, x_scale, y_scale, glyph_callback);
+                return rasterize_composite(font_ascender, font_descender, x_scale, y_scale, subpixel_offset, glyph_callback);
             }
             VERIFY_NOT_REACHED();
         }
@@ -102,14 +112,14 @@ public:
         };
 
         void rasterize_impl(Rasterizer&, Gfx::AffineTransform const&) const;
-        RefPtr<Gfx::Bitmap> rasterize_simple(i16 ascender, i16 descender, float x_scale, float y_scale) const;
+        RefPtr<Gfx::Bitmap> rasterize_simple(i16 ascender, i16 descender, float x_scale, float y_scale, Gfx::GlyphSubpixelOffset) const;
         template<typename GlyphCb>
-        RefPtr<Gfx::Bitmap> rasterize_composite(i16 font_ascender, i16 font_descender, float x_scale, float y_scale, GlyphCb glyph_callback) const
+        RefPtr<Gfx::Bitmap> rasterize_composite(i16 font_ascender, i16 font_descender, float x_scale, float y_scale, Gfx::GlyphSubpixelOffset subpixel_offset, GlyphCb glyph_callback) const
         {
-            u32 width = (u32)(ceilf((m_xmax - m_xmin) * x_scale)) + 1;
+            u32 width = (u32)(ceilf((m_xmax - m_xmin) * x_scale)) + 2;
             u32 height = (u32)(ceilf((font_ascender - font_descender) * y_scale)) + 1;
             Rasterizer rasterizer(Gfx::IntSize(width, height));
-            auto affine = Gfx::AffineTransform().scale(x_scale, -y_scale).translate(-m_xmin, -font_ascender);
+            auto affine = Gfx::AffineTransform().translate(subpixel_offset.to_float(), 0).scale(x_scale, -y_scale).translate(-m_xmin, -font_ascender);
             ComponentIterator component_iterator(m_slice);
             while (true) {
                 auto opt_item = component_iterator.next();
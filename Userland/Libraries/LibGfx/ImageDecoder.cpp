@@ -18,6 +18,18 @@
 
 namespace Gfx {
 
+int downscale_factor_for_ideal_size(IntSize size, IntSize ideal_size)
+{
+    int factor = 1;
+    while (factor < 8) {
+        int next_factor = factor * 2;
+        if (ceil_div(size.width(), next_factor) < ideal_size.width() || ceil_div(size.height(), next_factor) < ideal_size.height())
+            break;
+        factor = next_factor;
+    }
+    return factor;
+}
+
 RefPtr<ImageDecoder> ImageDecoder::try_create(ReadonlyBytes bytes)
 {
     auto* data = bytes.data();
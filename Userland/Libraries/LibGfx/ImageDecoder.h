@@ -25,6 +25,9 @@ struct ImageFrameDescriptor {
     int duration { 0 };
 };
 
+// The largest of 1, 2, 4 and 8 that an image of the given size can be scaled down by (rounding up) while staying at least as large as ideal_size.
+int downscale_factor_for_ideal_size(IntSize size, IntSize ideal_size);
+
 class ImageDecoderPlugin {
 public:
     virtual ~ImageDecoderPlugin() = default;
@@ -41,6 +44,12 @@ public:
     virtual size_t frame_count() = 0;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) = 0;
 
+    // Like frame(), but the image may come out smaller, though never smaller than ideal_size (unless the image itself is).
+    // This is for callers that are going to show the image scaled down anyway: plugins that can decode straight to a smaller
+    // size override it, which saves both the work and the memory for pixels that would be thrown away. Frames are only
+    // decoded once, so this has to be called before frame() to make a difference.
+    virtual ErrorOr<ImageFrameDescriptor> downscaled_frame(size_t index, IntSize) { return frame(index); }
+
 protected:
     ImageDecoderPlugin() = default;
 };
@@ -60,6 +69,12 @@ public:
     size_t loop_count() const { return m_plugin->loop_count(); }
     size_t frame_count() const { return m_plugin->frame_count(); }
     ErrorOr<ImageFrameDescriptor> frame(size_t index) const { return m_plugin->frame(index); }
+    ErrorOr<ImageFrameDescriptor> downscaled_frame(size_t index, IntSize ideal_size) const
+    {
+        if (ideal_size.is_empty())
+            return m_plugin->frame(index);
+        return m_plugin->downscaled_frame(index, ideal_size);
+    }
 
 private:
     explicit ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin>);
@@ -8,6 +8,8 @@
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDMath.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
 
@@ -68,6 +70,10 @@
 
 namespace Gfx {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+using AK::SIMD::u32x4;
+
 constexpr static u8 zigzag_map[64] {
     0, 1, 8, 16, 9, 2, 3, 10,
     17, 24, 32, 25, 18, 11, 4, 5,
@@ -85,25 +91,15 @@ using Marker = u16;
  * MCU means group of data units that are coded together. A data unit is an 8x8
  * block of component data. In interleaved scans, number of non-interleaved data
  * units of a component C is Ch * Cv, where Ch and Cv represent the horizontal &
- * vertical subsampling factors of the component, respectively. A MacroBlock is
- * an 8x8 block of RGB values before encoding, and 8x8 block of YCbCr values when
- * we're done decoding the huffman stream.
+ * vertical subsampling factors of the component, respectively. A MacroBlock holds
+ * the quantized DCT coefficients of the 8x8 blocks of the YCbCr components while
+ * we're decoding the huffman stream(s), and the 8x8 blocks of YCbCr values after
+ * the inverse DCT.
  */
 struct Macroblock {
-    union {
-        i32 y[64] = { 0 };
-        i32 r[64];
-    };
-
-    union {
-        i32 cb[64] = { 0 };
-        i32 g[64];
-    };
-
-    union {
-        i32 cr[64] = { 0 };
-        i32 b[64];
-    };
+    i32 y[64] = { 0 };
+    i32 cb[64] = { 0 };
+    i32 cr[64] = { 0 };
 };
 
 struct MacroblockMeta {
@@ -149,12 +145,36 @@ struct StartOfFrame {
     u16 width { 0 };
 };
 
+/**
+ * A scan codes either all the coefficients of its components at once (sequential
+ * JPEGs), or only a band of them, or only some of their bits (progressive JPEGs).
+ * In the latter case, `spectral_selection_start` and `spectral_selection_end` give
+ * the band of coefficients (in zigzag order) the scan is about. The first scan of
+ * a band codes the coefficients shifted right by `successive_approximation_low`
+ * bits, and later scans of the same band add one more bit at a time, in which case
+ * `successive_approximation_high` is the bit position the previous scan stopped at.
+ */
+struct Scan {
+    // Indices into JPGLoadingContext::components, in the order they're interleaved in.
+    Vector<u8, 3> components;
+    u8 spectral_selection_start { 0 };
+    u8 spectral_selection_end { 63 };
+    u8 successive_approximation_high { 0 };
+    u8 successive_approximation_low { 0 };
+};
+
 struct HuffmanTableSpec {
+    // Codes of at most this many bits are decoded with a single lookup.
+    static constexpr u8 lookup_bits = 9;
+
     u8 type { 0 };
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
     Vector<u16> codes;
+    // Indexed by the next `lookup_bits` bits of the stream. Holds the length of the code in the high byte and its
+    // symbol in the low byte, or 0 if the code is longer than `lookup_bits`.
+    u16 lookup[1 << lookup_bits] = { 0 };
 };
 
 struct HuffmanStreamState {
@@ -182,60 +202,96 @@ struct JPGLoadingContext {
     u8 component_count { 0 };
     Vector<ComponentSpec, 3> components;
     RefPtr<Gfx::Bitmap> bitmap;
+    // If set, we only need an image about this large, and decode it scaled down by downscale_factor.
+    IntSize ideal_size;
+    u32 downscale_factor { 1 };
     u16 dc_reset_interval { 0 };
     HashMap<u8, HuffmanTableSpec> dc_tables;
     HashMap<u8, HuffmanTableSpec> ac_tables;
+    Scan current_scan;
     HuffmanStreamState huffman_stream;
     i32 previous_dc_values[3] = { 0 };
+    // Number of blocks left that have no more coefficients in the band of the current progressive scan.
+    u32 end_of_band_run { 0 };
     MacroblockMeta mblock_meta;
 };
 
 static void generate_huffman_codes(HuffmanTableSpec& table)
 {
+    constexpr size_t lookup_size = 1 << HuffmanTableSpec::lookup_bits;
+
     unsigned code = 0;
-    for (auto number_of_codes : table.code_counts) {
-        for (int i = 0; i < number_of_codes; i++)
+    size_t code_cursor = 0;
+    for (u8 code_length = 1; code_length <= 16; code_length++) {
+        for (int i = 0; i < table.code_counts[code_length - 1]; i++) {
+            if (code_length <= HuffmanTableSpec::lookup_bits) {
+                // Every index starting with this code decodes to it.
+                auto unused_bits = HuffmanTableSpec::lookup_bits - code_length;
+                auto first_index = min<size_t>(code << unused_bits, lookup_size);
+                auto end_index = min<size_t>((code + 1) << unused_bits, lookup_size);
+                for (size_t index = first_index; index < end_index; index++)
+                    table.lookup[index] = (code_length << 8) | table.symbols[code_cursor];
+            }
             table.codes.append(code++);
+            code_cursor++;
+        }
         code <<= 1;
     }
 }
 
+// Returns the next `count` (at most 16) bits of the stream without consuming them. Past its end, the stream reads as zeroes.
+static u16 peek_huffman_bits(HuffmanStreamState const& hstream, u8 count)
+{
+    u32 bits = 0;
+    for (size_t i = 0; i < 3; i++) {
+        auto offset = hstream.byte_offset + i;
+        bits = (bits << 8) | (offset < hstream.stream.size() ? hstream.stream[offset] : 0);
+    }
+    return (bits >> (24 - hstream.bit_offset - count)) & ((1u << count) - 1);
+}
+
+static bool skip_huffman_bits(HuffmanStreamState& hstream, u8 count)
+{
+    size_t bit_position = hstream.byte_offset * 8 + hstream.bit_offset + count;
+    if (bit_position > hstream.stream.size() * 8) {
+        dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
+        return false;
+    }
+    hstream.byte_offset = bit_position / 8;
+    hstream.bit_offset = bit_position % 8;
+    return true;
+}
+
 static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
 {
-    if (count > (8 * sizeof(size_t))) {
+    if (count > 16) {
         dbgln_if(JPG_DEBUG, "Can't read {} bits at once!", count);
         return {};
     }
-    size_t value = 0;
-    while (count--) {
-        if (hstream.byte_offset >= hstream.stream.size()) {
-            dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
-            return {};
-        }
-        u8 current_byte = hstream.stream[hstream.byte_offset];
-        u8 current_bit = 1u & (u32)(current_byte >> (7 - hstream.bit_offset)); // MSB first.
-        hstream.bit_offset++;
-        value = (value << 1) | (size_t)current_bit;
-        if (hstream.bit_offset == 8) {
-            hstream.byte_offset++;
-            hstream.bit_offset = 0;
-        }
-    }
+    auto value = peek_huffman_bits(hstream, count);
+    if (!skip_huffman_bits(hstream, count))
+        return {};
     return value;
 }
 
 static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, HuffmanTableSpec const& table)
 {
-    unsigned code = 0;
+    if (auto entry = table.lookup[peek_huffman_bits(hstream, HuffmanTableSpec::lookup_bits)]; entry != 0) {
+        if (!skip_huffman_bits(hstream, entry >> 8))
+            return {};
+        return entry & 0xFF;
+    }
+
+    auto bits = peek_huffman_bits(hstream, 16);
     size_t code_cursor = 0;
     for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
-        auto result = read_huffman_bits(hstream);
-        if (!result.has_value())
-            return {};
-        code = (code << 1) | (i32)result.release_value();
+        unsigned code = bits >> (15 - i);
         for (int j = 0; j < table.code_counts[i]; j++) {
-            if (code == table.codes[code_cursor])
+            if (code == table.codes[code_cursor]) {
+                if (!skip_huffman_bits(hstream, i + 1))
+                    return {};
                 return table.symbols[code_cursor];
+            }
             code_cursor++;
         }
     }
@@ -244,6 +300,18 @@ static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, HuffmanTableSpe
     return {};
 }
 
+// Reads a `length` bit coefficient (or difference of DC coefficients), which is negative if its MSB is 0.
+static Optional<i32> read_coefficient(HuffmanStreamState& hstream, u8 length)
+{
+    auto bits_or_error = read_huffman_bits(hstream, length);
+    if (!bits_or_error.has_value())
+        return {};
+    i32 coefficient = bits_or_error.release_value();
+    if (length != 0 && coefficient < (1 << (length - 1)))
+        coefficient -= (1 << length) - 1;
+    return coefficient;
+}
+
 static inline i32* get_component(Macroblock& block, unsigned component)
 {
     switch (component) {
@@ -256,166 +324,300 @@ static inline i32* get_component(Macroblock& block, unsigned component)
     }
 }
 
-/**
- * Build the macroblocks possible by reading single (MCU) subsampled pair of CbCr.
- * Depending on the sampling factors, we may not see triples of y, cb, cr in that
- * order. If sample factors differ from one, we'll read more than one block of y-
- * coefficients before we get to read a cb-cr block.
-
- * In the function below, `hcursor` and `vcursor` denote the location of the block
- * we're building in the macroblock matrix. `vfactor_i` and `hfactor_i` are cursors
- * that iterate over the vertical and horizontal subsampling factors, respectively.
- * When we finish one iteration of the innermost loop, we'll have the coefficients
- * of one of the components of block at position `mb_index`. When the outermost loop
- * finishes first iteration, we'll have all the luminance coefficients for all the
- * macroblocks that share the chrominance data. Next two iterations (assuming that
- * we are dealing with three components) will fill up the blocks with chroma data.
- */
-static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static bool decode_dc_coefficient(JPGLoadingContext& context, unsigned component_i, i32* block)
 {
-    for (unsigned component_i = 0; component_i < context.component_count; component_i++) {
-        auto& component = context.components[component_i];
+    auto& scan = context.current_scan;
 
-        if (component.dc_destination_id >= context.dc_tables.size())
-            return false;
-        if (component.ac_destination_id >= context.ac_tables.size())
+    if (scan.successive_approximation_high > 0) {
+        // Refining scans only send the next bit of the coefficient.
+        auto bit_or_error = read_huffman_bits(context.huffman_stream);
+        if (!bit_or_error.has_value())
             return false;
+        block[0] |= bit_or_error.release_value() << scan.successive_approximation_low;
+        return true;
+    }
 
-        for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-            for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                Macroblock& block = macroblocks[mb_index];
+    auto& dc_table = context.dc_tables.find(context.components[component_i].dc_destination_id)->value;
+    auto symbol_or_error = get_next_symbol(context.huffman_stream, dc_table);
+    if (!symbol_or_error.has_value())
+        return false;
 
-                auto& dc_table = context.dc_tables.find(component.dc_destination_id)->value;
-                auto& ac_table = context.ac_tables.find(component.ac_destination_id)->value;
+    // For DC coefficients, symbol encodes the length of the coefficient.
+    auto dc_length = symbol_or_error.release_value();
+    if (dc_length > 11) {
+        dbgln_if(JPG_DEBUG, "DC coefficient too long: {}!", dc_length);
+        return false;
+    }
 
-                auto symbol_or_error = get_next_symbol(context.huffman_stream, dc_table);
-                if (!symbol_or_error.has_value())
-                    return false;
+    // DC coefficients are encoded as the difference between previous and current DC values.
+    auto dc_diff_or_error = read_coefficient(context.huffman_stream, dc_length);
+    if (!dc_diff_or_error.has_value())
+        return false;
 
-                // For DC coefficients, symbol encodes the length of the coefficient.
-                auto dc_length = symbol_or_error.release_value();
-                if (dc_length > 11) {
-                    dbgln_if(JPG_DEBUG, "DC coefficient too long: {}!", dc_length);
-                    return false;
-                }
+    auto& previous_dc = context.previous_dc_values[component_i];
+    previous_dc += dc_diff_or_error.release_value();
+    block[0] = previous_dc << scan.successive_approximation_low;
+    return true;
+}
+
+// Decodes the AC coefficients of a sequential scan, or the first scan of a band in a progressive one.
+static bool decode_ac_coefficients(JPGLoadingContext& context, HuffmanTableSpec const& ac_table, i32* block)
+{
+    auto& scan = context.current_scan;
+
+    if (context.end_of_band_run > 0) {
+        context.end_of_band_run--;
+        return true;
+    }
 
-                auto coeff_or_error = read_huffman_bits(context.huffman_stream, dc_length);
-                if (!coeff_or_error.has_value())
+    for (u32 j = max<u8>(scan.spectral_selection_start, 1); j <= scan.spectral_selection_end;) {
+        auto symbol_or_error = get_next_symbol(context.huffman_stream, ac_table);
+        if (!symbol_or_error.has_value())
+            return false;
+
+        // AC symbols encode 2 pieces of information, the high 4 bits represent
+        // number of zeroes to be stuffed before reading the coefficient. Low 4
+        // bits represent the magnitude of the coefficient.
+        auto ac_symbol = symbol_or_error.release_value();
+        u8 run_length = ac_symbol >> 4;
+        u8 coeff_length = ac_symbol & 0x0F;
+
+        if (coeff_length == 0) {
+            // ac_symbol = 0xF0 means we need to skip 16 zeroes.
+            if (run_length == 15) {
+                j += 16;
+                continue;
+            }
+
+            // Otherwise, this is the end of the block's band, and of the bands of the next 2^run_length - 1
+            // blocks, plus a number of blocks given by the next run_length bits. Sequential scans only use 0x00.
+            context.end_of_band_run = (1 << run_length) - 1;
+            if (run_length != 0) {
+                auto extra_blocks_or_error = read_huffman_bits(context.huffman_stream, run_length);
+                if (!extra_blocks_or_error.has_value())
                     return false;
+                context.end_of_band_run += extra_blocks_or_error.release_value();
+            }
+            return true;
+        }
 
-                // DC coefficients are encoded as the difference between previous and current DC values.
-                i32 dc_diff = coeff_or_error.release_value();
+        j += run_length;
+        if (j > scan.spectral_selection_end) {
+            dbgln_if(JPG_DEBUG, "Run-length exceeded boundaries. Cursor: {}, Skipping: {}!", j, run_length);
+            return false;
+        }
 
-                // If MSB in diff is 0, the difference is -ve. Otherwise +ve.
-                if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
-                    dc_diff -= (1 << dc_length) - 1;
+        if (coeff_length > 10) {
+            dbgln_if(JPG_DEBUG, "AC coefficient too long: {}!", coeff_length);
+            return false;
+        }
 
-                auto select_component = get_component(block, component_i);
-                auto& previous_dc = context.previous_dc_values[component_i];
-                select_component[0] = previous_dc += dc_diff;
+        auto coefficient_or_error = read_coefficient(context.huffman_stream, coeff_length);
+        if (!coefficient_or_error.has_value())
+            return false;
+        block[zigzag_map[j++]] = coefficient_or_error.release_value() << scan.successive_approximation_low;
+    }
 
-                // Compute the AC coefficients.
-                for (int j = 1; j < 64;) {
-                    symbol_or_error = get_next_symbol(context.huffman_stream, ac_table);
-                    if (!symbol_or_error.has_value())
-                        return false;
+    return true;
+}
 
-                    // AC symbols encode 2 pieces of information, the high 4 bits represent
-                    // number of zeroes to be stuffed before reading the coefficient. Low 4
-                    // bits represent the magnitude of the coefficient.
-                    auto ac_symbol = symbol_or_error.release_value();
-                    if (ac_symbol == 0)
-                        break;
+// Decodes a refining scan of a band of AC coefficients in a progressive JPEG, see ITU T.81 G.1.2.3.
+static bool refine_ac_coefficients(JPGLoadingContext& context, HuffmanTableSpec const& ac_table, i32* block)
+{
+    auto& scan = context.current_scan;
+    i32 const positive_bit = 1 << scan.successive_approximation_low;
+    i32 const negative_bit = -positive_bit;
+
+    // Coefficients that are non-zero already get a correction bit each, no matter where they are.
+    auto refine_coefficient = [&](i32& coefficient) {
+        auto bit_or_error = read_huffman_bits(context.huffman_stream);
+        if (!bit_or_error.has_value())
+            return false;
+        if (bit_or_error.value() != 0 && (coefficient & positive_bit) == 0)
+            coefficient += coefficient >= 0 ? positive_bit : negative_bit;
+        return true;
+    };
 
-                    // ac_symbol = 0xF0 means we need to skip 16 zeroes.
-                    u8 run_length = ac_symbol == 0xF0 ? 16 : ac_symbol >> 4;
-                    j += run_length;
+    u32 j = scan.spectral_selection_start;
+    if (context.end_of_band_run == 0) {
+        for (; j <= scan.spectral_selection_end; j++) {
+            auto symbol_or_error = get_next_symbol(context.huffman_stream, ac_table);
+            if (!symbol_or_error.has_value())
+                return false;
 
-                    if (j >= 64) {
-                        dbgln_if(JPG_DEBUG, "Run-length exceeded boundaries. Cursor: {}, Skipping: {}!", j, run_length);
-                        return false;
-                    }
+            auto ac_symbol = symbol_or_error.release_value();
+            u8 run_length = ac_symbol >> 4;
+            u8 coeff_length = ac_symbol & 0x0F;
 
-                    u8 coeff_length = ac_symbol & 0x0F;
-                    if (coeff_length > 10) {
-                        dbgln_if(JPG_DEBUG, "AC coefficient too long: {}!", coeff_length);
+            // Coefficients that become non-zero in this scan can only be +1 or -1 at this bit position.
+            i32 new_coefficient = 0;
+            if (coeff_length != 0) {
+                if (coeff_length != 1) {
+                    dbgln_if(JPG_DEBUG, "Invalid coefficient length in refining scan: {}!", coeff_length);
+                    return false;
+                }
+                auto sign_or_error = read_huffman_bits(context.huffman_stream);
+                if (!sign_or_error.has_value())
+                    return false;
+                new_coefficient = sign_or_error.value() != 0 ? positive_bit : negative_bit;
+            } else if (run_length != 15) {
+                context.end_of_band_run = 1 << run_length;
+                if (run_length != 0) {
+                    auto extra_blocks_or_error = read_huffman_bits(context.huffman_stream, run_length);
+                    if (!extra_blocks_or_error.has_value())
                         return false;
-                    }
-
-                    if (coeff_length != 0) {
-                        coeff_or_error = read_huffman_bits(context.huffman_stream, coeff_length);
-                        if (!coeff_or_error.has_value())
-                            return false;
-                        i32 ac_coefficient = coeff_or_error.release_value();
-                        if (ac_coefficient < (1 << (coeff_length - 1)))
-                            ac_coefficient -= (1 << coeff_length) - 1;
+                    context.end_of_band_run += extra_blocks_or_error.release_value();
+                }
+                break;
+            }
 
-                        select_component[zigzag_map[j++]] = ac_coefficient;
-                    }
+            // Skip run_length coefficients that are still zero, refining the ones in between.
+            for (; j <= scan.spectral_selection_end; j++) {
+                auto& coefficient = block[zigzag_map[j]];
+                if (coefficient != 0) {
+                    if (!refine_coefficient(coefficient))
+                        return false;
+                } else {
+                    if (run_length == 0)
+                        break;
+                    run_length--;
                 }
             }
+
+            if (new_coefficient != 0 && j <= scan.spectral_selection_end)
+                block[zigzag_map[j]] = new_coefficient;
+        }
+    }
+
+    if (context.end_of_band_run > 0) {
+        // The rest of the band has no new coefficients, but the existing ones still need refining.
+        for (; j <= scan.spectral_selection_end; j++) {
+            auto& coefficient = block[zigzag_map[j]];
+            if (coefficient != 0 && !refine_coefficient(coefficient))
+                return false;
         }
+        context.end_of_band_run--;
     }
 
     return true;
 }
 
-static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
+static bool decode_block(JPGLoadingContext& context, unsigned component_i, i32* block)
 {
-    Vector<Macroblock> macroblocks;
-    macroblocks.resize(context.mblock_meta.padded_total);
+    auto& scan = context.current_scan;
 
-    if constexpr (JPG_DEBUG) {
-        dbgln("Image width: {}", context.frame.width);
-        dbgln("Image height: {}", context.frame.height);
-        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
-        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
-        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
+    if (scan.spectral_selection_start == 0) {
+        if (!decode_dc_coefficient(context, component_i, block))
+            return false;
+        if (scan.spectral_selection_end == 0)
+            return true;
     }
 
-    // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
+    auto& ac_table = context.ac_tables.find(context.components[component_i].ac_destination_id)->value;
+    if (scan.successive_approximation_high == 0)
+        return decode_ac_coefficients(context, ac_table, block);
+    return refine_ac_coefficients(context, ac_table, block);
+}
 
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
+/**
+ * Build the macroblocks possible by reading single (MCU) subsampled pair of CbCr.
+ * Depending on the sampling factors, we may not see triples of y, cb, cr in that
+ * order. If sample factors differ from one, we'll read more than one block of y-
+ * coefficients before we get to read a cb-cr block.
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
+ * In the function below, `hcursor` and `vcursor` denote the location of the block
+ * we're building in the macroblock matrix. `vfactor_i` and `hfactor_i` are cursors
+ * that iterate over the vertical and horizontal subsampling factors, respectively.
+ * When we finish one iteration of the innermost loop, we'll have the coefficients
+ * of one of the components of block at position `mb_index`. When the outermost loop
+ * finishes first iteration, we'll have all the luminance coefficients for all the
+ * macroblocks that share the chrominance data. Next two iterations (assuming that
+ * we are dealing with three components in the scan) will fill up the blocks with
+ * chroma data.
+ */
+static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+{
+    for (auto component_i : context.current_scan.components) {
+        auto& component = context.components[component_i];
+        for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+            for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                if (!decode_block(context, component_i, get_component(macroblocks[mb_index], component_i)))
+                    return false;
+            }
+        }
+    }
 
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
+    return true;
+}
+
+static void handle_restart_interval(JPGLoadingContext& context, u32 mcu_index)
+{
+    if (context.dc_reset_interval == 0 || mcu_index == 0 || mcu_index % context.dc_reset_interval != 0)
+        return;
+
+    context.previous_dc_values[0] = 0;
+    context.previous_dc_values[1] = 0;
+    context.previous_dc_values[2] = 0;
+    context.end_of_band_run = 0;
+
+    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+    //  the 0th bit of the next byte. (The markers themselves aren't part of the stream.)
+    if (context.huffman_stream.bit_offset > 0) {
+        context.huffman_stream.bit_offset = 0;
+        context.huffman_stream.byte_offset++;
+    }
+}
+
+static bool decode_huffman_stream(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    context.previous_dc_values[0] = 0;
+    context.previous_dc_values[1] = 0;
+    context.previous_dc_values[2] = 0;
+    context.end_of_band_run = 0;
+
+    if (context.current_scan.components.size() == 1) {
+        // Scans of a single component aren't interleaved, even if the component is subsampled. They simply go over
+        // the component's blocks in raster order, and only over the ones that are needed to cover the image.
+        auto component_i = context.current_scan.components[0];
+        auto& component = context.components[component_i];
+        u32 hstep = context.hsample_factor / component.hsample_factor;
+        u32 vstep = context.vsample_factor / component.vsample_factor;
+        u32 component_width = ceil_div<u32>(context.frame.width, hstep);
+        u32 component_height = ceil_div<u32>(context.frame.height, vstep);
+        u32 hblocks = ceil_div<u32>(component_width, 8);
+        u32 vblocks = ceil_div<u32>(component_height, 8);
+
+        for (u32 vblock = 0; vblock < vblocks; vblock++) {
+            for (u32 hblock = 0; hblock < hblocks; hblock++) {
+                handle_restart_interval(context, vblock * hblocks + hblock);
+                u32 mb_index = vblock * vstep * context.mblock_meta.hpadded_count + hblock * hstep;
+                if (!decode_block(context, component_i, get_component(macroblocks[mb_index], component_i))) {
+                    dbgln_if(JPG_DEBUG, "Failed to decode block {} of component {}", vblock * hblocks + hblock, component_i);
+                    return false;
                 }
             }
+        }
+        return true;
+    }
+
+    u32 mcu_index = 0;
+    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+            handle_restart_interval(context, mcu_index++);
 
             if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
                 if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
+                    dbgln("Failed to build Macroblock {}", vcursor * context.mblock_meta.hpadded_count + hcursor);
                     dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
                     dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
                 }
-                return {};
+                return false;
             }
         }
     }
 
-    return macroblocks;
+    return true;
 }
 
 static inline bool bounds_okay(const size_t cursor, const size_t delta, const size_t bound)
@@ -445,6 +647,7 @@ static inline bool is_valid_marker(const Marker marker)
     case JPG_DQT:
     case JPG_RST:
     case JPG_SOF0:
+    case JPG_SOF2:
     case JPG_SOI:
     case JPG_SOS:
         return true;
@@ -503,23 +706,29 @@ static bool read_start_of_scan(InputMemoryStream& stream, JPGLoadingContext& con
     stream >> component_count;
     if (stream.handle_any_error())
         return false;
-    if (component_count != context.component_count) {
+    if (component_count == 0 || component_count > context.component_count) {
         dbgln_if(JPG_DEBUG, "{}: Unsupported number of components: {}!", stream.offset(), component_count);
         return false;
     }
 
+    Scan scan;
     for (int i = 0; i < component_count; i++) {
         u8 component_id = 0;
         stream >> component_id;
         if (stream.handle_any_error())
             return false;
 
-        auto& component = context.components[i];
-        if (component.id != component_id) {
+        // A scan may leave components out, but the ones it has come in the same order as in the frame.
+        u8 component_i = scan.components.is_empty() ? 0 : scan.components.last() + 1;
+        while (component_i < context.component_count && context.components[component_i].id != component_id)
+            component_i++;
+        if (component_i == context.component_count) {
             dbgln("JPEG decode failed (component.id != component_id)");
             return false;
         }
+        scan.components.append(component_i);
 
+        auto& component = context.components[component_i];
         u8 table_ids = 0;
         stream >> table_ids;
         if (stream.handle_any_error())
@@ -527,44 +736,59 @@ static bool read_start_of_scan(InputMemoryStream& stream, JPGLoadingContext& con
 
         component.dc_destination_id = table_ids >> 4;
         component.ac_destination_id = table_ids & 0x0F;
-
-        if (context.dc_tables.size() != context.ac_tables.size()) {
-            dbgln_if(JPG_DEBUG, "{}: DC & AC table count mismatch!", stream.offset());
-            return false;
-        }
-
-        if (!context.dc_tables.contains(component.dc_destination_id)) {
-            dbgln_if(JPG_DEBUG, "DC table (id: {}) does not exist!", component.dc_destination_id);
-            return false;
-        }
-
-        if (!context.ac_tables.contains(component.ac_destination_id)) {
-            dbgln_if(JPG_DEBUG, "AC table (id: {}) does not exist!", component.ac_destination_id);
-            return false;
-        }
     }
 
-    u8 spectral_selection_start = 0;
-    stream >> spectral_selection_start;
+    stream >> scan.spectral_selection_start;
     if (stream.handle_any_error())
         return false;
-    u8 spectral_selection_end = 0;
-    stream >> spectral_selection_end;
+    stream >> scan.spectral_selection_end;
     if (stream.handle_any_error())
         return false;
     u8 successive_approximation = 0;
     stream >> successive_approximation;
     if (stream.handle_any_error())
         return false;
-    // The three values should be fixed for baseline JPEGs utilizing sequential DCT.
-    if (spectral_selection_start != 0 || spectral_selection_end != 63 || successive_approximation != 0) {
+    scan.successive_approximation_high = successive_approximation >> 4;
+    scan.successive_approximation_low = successive_approximation & 0x0F;
+
+    bool is_valid_scan;
+    if (context.frame.type == StartOfFrame::FrameType::Progressive_DCT) {
+        // DC and AC coefficients are never in the same scan, and only DC coefficients can be interleaved.
+        if (scan.spectral_selection_start == 0)
+            is_valid_scan = scan.spectral_selection_end == 0;
+        else
+            is_valid_scan = scan.spectral_selection_start <= scan.spectral_selection_end && scan.spectral_selection_end <= 63 && component_count == 1;
+        is_valid_scan = is_valid_scan && scan.successive_approximation_high <= 13 && scan.successive_approximation_low <= 13;
+    } else {
+        // The three values should be fixed for baseline JPEGs utilizing sequential DCT.
+        is_valid_scan = scan.spectral_selection_start == 0 && scan.spectral_selection_end == 63 && successive_approximation == 0;
+    }
+    if (!is_valid_scan) {
         dbgln_if(JPG_DEBUG, "{}: ERROR! Start of Selection: {}, End of Selection: {}, Successive Approximation: {}!",
             stream.offset(),
-            spectral_selection_start,
-            spectral_selection_end,
+            scan.spectral_selection_start,
+            scan.spectral_selection_end,
             successive_approximation);
         return false;
     }
+
+    // Refining DC coefficients is a matter of reading single bits, so only the other scans need tables.
+    bool needs_dc_tables = scan.spectral_selection_start == 0 && scan.successive_approximation_high == 0;
+    bool needs_ac_tables = scan.spectral_selection_end > 0;
+    for (auto component_i : scan.components) {
+        auto& component = context.components[component_i];
+        if (needs_dc_tables && !context.dc_tables.contains(component.dc_destination_id)) {
+            dbgln_if(JPG_DEBUG, "DC table (id: {}) does not exist!", component.dc_destination_id);
+            return false;
+        }
+
+        if (needs_ac_tables && !context.ac_tables.contains(component.ac_destination_id)) {
+            dbgln_if(JPG_DEBUG, "AC table (id: {}) does not exist!", component.ac_destination_id);
+            return false;
+        }
+    }
+
+    context.current_scan = move(scan);
     return true;
 }
 
@@ -637,8 +861,10 @@ static bool read_huffman_table(InputMemoryStream& stream, JPGLoadingContext& con
         if (stream.handle_any_error())
             return false;
 
+        generate_huffman_codes(table);
+
         auto& huffman_table = table.type == 0 ? context.dc_tables : context.ac_tables;
-        huffman_table.set(table.destination_id, table);
+        huffman_table.set(table_destination_id, move(table));
         VERIFY(huffman_table.size() <= 2);
 
         bytes_to_read -= 1 + 16 + total_codes;
@@ -843,25 +1069,11 @@ static bool skip_marker_with_length(InputMemoryStream& stream)
     return !stream.handle_any_error();
 }
 
-static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+ALWAYS_INLINE static f32x4 load_as_f32x4(i32 const* values)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 i = 0; i < context.component_count; i++) {
-                auto& component = context.components[i];
-                u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        int* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
-                }
-            }
-        }
-    }
+    i32x4 vector;
+    __builtin_memcpy(&vector, values, sizeof(vector));
+    return AK::SIMD::to_f32x4(vector);
 }
 
 static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
@@ -881,181 +1093,136 @@ static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& ma
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
+    // Both passes of the IDCT scale their inputs by s0-s7 first, which we can do together with the dequantization.
+    float const scale_factors[8] = { s0, s1, s2, s3, s4, s5, s6, s7 };
+    float dequantization_tables[2][64];
+    for (u32 i = 0; i < 64; i++) {
+        float scale_factor = scale_factors[i / 8] * scale_factors[i % 8];
+        dequantization_tables[0][i] = context.luma_table[i] * scale_factor;
+        dequantization_tables[1][i] = context.chroma_table[i] * scale_factor;
+    }
+
+    // Does a 1D IDCT on 4 columns of a block at once, each vector holding one row of them.
+    auto inverse_dct_columns = [&](f32x4(&rows)[8]) {
+        f32x4 const g0 = rows[0];
+        f32x4 const g1 = rows[4];
+        f32x4 const g2 = rows[2];
+        f32x4 const g3 = rows[6];
+        f32x4 const g4 = rows[5];
+        f32x4 const g5 = rows[1];
+        f32x4 const g6 = rows[7];
+        f32x4 const g7 = rows[3];
+
+        f32x4 const f0 = g0;
+        f32x4 const f1 = g1;
+        f32x4 const f2 = g2;
+        f32x4 const f3 = g3;
+        f32x4 const f4 = g4 - g7;
+        f32x4 const f5 = g5 + g6;
+        f32x4 const f6 = g5 - g6;
+        f32x4 const f7 = g4 + g7;
+
+        f32x4 const e0 = f0;
+        f32x4 const e1 = f1;
+        f32x4 const e2 = f2 - f3;
+        f32x4 const e3 = f2 + f3;
+        f32x4 const e4 = f4;
+        f32x4 const e5 = f5 - f7;
+        f32x4 const e6 = f6;
+        f32x4 const e7 = f5 + f7;
+        f32x4 const e8 = f4 + f6;
+
+        f32x4 const d0 = e0;
+        f32x4 const d1 = e1;
+        f32x4 const d2 = e2 * m1;
+        f32x4 const d3 = e3;
+        f32x4 const d4 = e4 * m2;
+        f32x4 const d5 = e5 * m3;
+        f32x4 const d6 = e6 * m4;
+        f32x4 const d7 = e7;
+        f32x4 const d8 = e8 * m5;
+
+        f32x4 const c0 = d0 + d1;
+        f32x4 const c1 = d0 - d1;
+        f32x4 const c2 = d2 - d3;
+        f32x4 const c3 = d3;
+        f32x4 const c4 = d4 + d8;
+        f32x4 const c5 = d5 + d7;
+        f32x4 const c6 = d6 - d8;
+        f32x4 const c7 = d7;
+        f32x4 const c8 = c5 - c6;
+
+        f32x4 const b0 = c0 + c3;
+        f32x4 const b1 = c1 + c2;
+        f32x4 const b2 = c1 - c2;
+        f32x4 const b3 = c0 - c3;
+        f32x4 const b4 = c4 - c8;
+        f32x4 const b5 = c8;
+        f32x4 const b6 = c6 - c7;
+        f32x4 const b7 = c7;
+
+        rows[0] = b0 + b7;
+        rows[1] = b1 + b6;
+        rows[2] = b2 + b5;
+        rows[3] = b3 + b4;
+        rows[4] = b3 - b4;
+        rows[5] = b2 - b5;
+        rows[6] = b1 - b6;
+        rows[7] = b0 - b7;
+    };
+
+    // The block is held as its left and right halves, so doing the row pass like the column pass requires transposing it.
+    auto transpose = [](f32x4(&halves)[2][8]) {
+        f32x4 transposed[2][8];
+        for (u32 row = 0; row < 8; ++row) {
+            for (u32 column = 0; column < 8; ++column)
+                transposed[row / 4][column][row % 4] = halves[column / 4][row][column % 4];
+        }
+        __builtin_memcpy(halves, transposed, sizeof(transposed));
+    };
+
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u32 component_i = 0; component_i < context.component_count; component_i++) {
                 auto& component = context.components[component_i];
+                float const* table = dequantization_tables[component.qtable_id == 0 ? 0 : 1];
                 for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
                     for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
+
+                        bool is_subsampled = component.hsample_factor != context.hsample_factor || component.vsample_factor != context.vsample_factor;
+                        if (context.downscale_factor == 8 && !is_subsampled) {
+                            // At 1/8 of the size, the whole block becomes a single pixel of its average value, which is what the DC coefficient is.
+                            u32 quantization_factor = component.qtable_id == 0 ? context.luma_table[0] : context.chroma_table[0];
+                            i32 average = (block_component[0] * static_cast<i32>(quantization_factor) + 4) >> 3;
+                            for (u32 i = 0; i < 64; ++i)
+                                block_component[i] = average;
+                            continue;
                         }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
+
+                        f32x4 halves[2][8];
+                        for (u32 row = 0; row < 8; ++row) {
+                            for (u32 half = 0; half < 2; ++half) {
+                                f32x4 factors;
+                                __builtin_memcpy(&factors, &table[row * 8 + half * 4], sizeof(factors));
+                                halves[half][row] = load_as_f32x4(&block_component[row * 8 + half * 4]) * factors;
+                            }
                         }
-                    }
-                }
-            }
-        }
-    }
-}
 
-static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
-{
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            Macroblock const& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                        inverse_dct_columns(halves[0]);
+                        inverse_dct_columns(halves[1]);
+                        transpose(halves);
+                        inverse_dct_columns(halves[0]);
+                        inverse_dct_columns(halves[1]);
+                        transpose(halves);
+
+                        for (u32 row = 0; row < 8; ++row) {
+                            for (u32 half = 0; half < 2; ++half) {
+                                auto values = AK::SIMD::to_i32x4(AK::SIMD::floor_int_range(halves[half][row] + 0.5f));
+                                __builtin_memcpy(&block_component[row * 8 + half * 4], &values, sizeof(values));
+                            }
                         }
                     }
                 }
@@ -1073,36 +1240,106 @@ static bool compose_bitmap(JPGLoadingContext& context, Vector<Macroblock> const&
     if (bitmap_or_error.is_error())
         return false;
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
+    // Converts YCbCr to RGB, a row of 4 pixels at a time. Each chroma sample covers hsample_factor x vsample_factor pixels.
+    for (u32 y = 0; y < context.frame.height; y++) {
         const u32 block_row = y / 8;
         const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
+        const u32 chroma_block_row = block_row - block_row % context.vsample_factor;
+        const u32 chroma_pixel_row = (y % (8 * context.vsample_factor)) / context.vsample_factor;
+        ARGB32* scanline = context.bitmap->scanline(y);
+
+        for (u32 block_column = 0; block_column < context.mblock_meta.hcount; block_column++) {
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
-            const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            auto& chroma = macroblocks[chroma_block_row * context.mblock_meta.hpadded_count + block_column - block_column % context.hsample_factor];
+            const u32 chroma_pixel_index = chroma_pixel_row * 8 + (block_column % context.hsample_factor) * 8 / context.hsample_factor;
+
+            ARGB32 pixels[8];
+            for (u32 half = 0; half < 2; half++) {
+                auto luma = load_as_f32x4(&block.y[pixel_row * 8 + half * 4]);
+                f32x4 cb;
+                f32x4 cr;
+                if (context.hsample_factor == 1) {
+                    cb = load_as_f32x4(&chroma.cb[chroma_pixel_index + half * 4]);
+                    cr = load_as_f32x4(&chroma.cr[chroma_pixel_index + half * 4]);
+                } else {
+                    i32 const* cb_samples = &chroma.cb[chroma_pixel_index + half * 2];
+                    i32 const* cr_samples = &chroma.cr[chroma_pixel_index + half * 2];
+                    cb = f32x4 { (float)cb_samples[0], (float)cb_samples[0], (float)cb_samples[1], (float)cb_samples[1] };
+                    cr = f32x4 { (float)cr_samples[0], (float)cr_samples[0], (float)cr_samples[1], (float)cr_samples[1] };
+                }
+
+                // The extra 0.5 makes the conversion to integers below round to the nearest value.
+                auto r = AK::SIMD::to_u32x4(AK::SIMD::clamp(luma + 1.402f * cr + 128.5f, 0.0f, 255.0f));
+                auto g = AK::SIMD::to_u32x4(AK::SIMD::clamp(luma - 0.344f * cb - 0.714f * cr + 128.5f, 0.0f, 255.0f));
+                auto b = AK::SIMD::to_u32x4(AK::SIMD::clamp(luma + 1.772f * cb + 128.5f, 0.0f, 255.0f));
+                u32x4 argb = 0xff000000 | (r << 16) | (g << 8) | b;
+                __builtin_memcpy(&pixels[half * 4], &argb, sizeof(argb));
+            }
+
+            const u32 x = block_column * 8;
+            __builtin_memcpy(&scanline[x], pixels, min(8u, context.frame.width - x) * sizeof(ARGB32));
         }
     }
 
     return true;
 }
 
-static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
+// Like compose_bitmap(), but each pixel is the average of a square of downscale_factor x downscale_factor pixels of the full
+// size image. Since the factor divides 8, none of the squares straddle the edge of a block.
+static bool compose_downscaled_bitmap(JPGLoadingContext& context, Vector<Macroblock> const& macroblocks)
 {
-    auto marker = read_marker_at_cursor(stream);
-    if (stream.handle_any_error())
-        return false;
-    if (marker != JPG_SOI) {
-        dbgln_if(JPG_DEBUG, "{}: SOI not found: {:x}!", stream.offset(), marker);
+    u32 const factor = context.downscale_factor;
+    IntSize const size { static_cast<int>(ceil_div<u32>(context.frame.width, factor)), static_cast<int>(ceil_div<u32>(context.frame.height, factor)) };
+    auto bitmap_or_error = Bitmap::try_create(BitmapFormat::BGRx8888, size);
+    if (bitmap_or_error.is_error())
         return false;
+    context.bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
+
+    // YCbCr to RGB is linear (up to the clamping), so averaging YCbCr first gives the same colors as averaging RGB.
+    auto to_channel = [](float value) {
+        return static_cast<u32>(clamp(value + 128.5f, 0.0f, 255.0f));
+    };
+    float const pixels_per_square = factor * factor;
+
+    for (u32 y = 0; y < static_cast<u32>(size.height()); y++) {
+        ARGB32* scanline = context.bitmap->scanline(y);
+        for (u32 x = 0; x < static_cast<u32>(size.width()); x++) {
+            i32 luma_sum = 0;
+            i32 cb_sum = 0;
+            i32 cr_sum = 0;
+            for (u32 source_y = y * factor; source_y < (y + 1) * factor; source_y++) {
+                const u32 block_row = source_y / 8;
+                const u32 chroma_block_row = block_row - block_row % context.vsample_factor;
+                const u32 chroma_pixel_row = (source_y % (8 * context.vsample_factor)) / context.vsample_factor;
+                for (u32 source_x = x * factor; source_x < (x + 1) * factor; source_x++) {
+                    const u32 block_column = source_x / 8;
+                    const u32 chroma_block_column = block_column - block_column % context.hsample_factor;
+                    const u32 chroma_pixel_column = (source_x % (8 * context.hsample_factor)) / context.hsample_factor;
+                    auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
+                    auto& chroma = macroblocks[chroma_block_row * context.mblock_meta.hpadded_count + chroma_block_column];
+                    luma_sum += block.y[(source_y % 8) * 8 + source_x % 8];
+                    cb_sum += chroma.cb[chroma_pixel_row * 8 + chroma_pixel_column];
+                    cr_sum += chroma.cr[chroma_pixel_row * 8 + chroma_pixel_column];
+                }
+            }
+
+            float luma = luma_sum / pixels_per_square;
+            float cb = cb_sum / pixels_per_square;
+            float cr = cr_sum / pixels_per_square;
+            u32 r = to_channel(luma + 1.402f * cr);
+            u32 g = to_channel(luma - 0.344f * cb - 0.714f * cr);
+            u32 b = to_channel(luma + 1.772f * cb);
+            scanline[x] = 0xff000000 | (r << 16) | (g << 8) | b;
+        }
     }
-    for (;;) {
-        marker = read_marker_at_cursor(stream);
-        if (stream.handle_any_error())
-            return false;
 
+    return true;
+}
+
+// Reads marker segments up to and including the header of the next scan, starting with the one of `marker`.
+static bool read_marker_segments_until_scan(InputMemoryStream& stream, JPGLoadingContext& context, Marker marker)
+{
+    for (;;) {
         // Set frame type if the marker marks a new frame.
         if (marker >= 0xFFC0 && marker <= 0xFFCF) {
             // Ignore interleaved markers.
@@ -1126,6 +1363,7 @@ static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
             dbgln_if(JPG_DEBUG, "{}: Unexpected marker {:x}!", stream.offset(), marker);
             return false;
         case JPG_SOF0:
+        case JPG_SOF2:
             if (!read_start_of_frame(stream, context))
                 return false;
             context.state = JPGLoadingContext::FrameDecoded;
@@ -1151,25 +1389,50 @@ static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
             }
             break;
         }
+
+        marker = read_marker_at_cursor(stream);
+        if (stream.handle_any_error())
+            return false;
     }
 
     VERIFY_NOT_REACHED();
 }
 
-static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& context)
+static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
+{
+    auto marker = read_marker_at_cursor(stream);
+    if (stream.handle_any_error())
+        return false;
+    if (marker != JPG_SOI) {
+        dbgln_if(JPG_DEBUG, "{}: SOI not found: {:x}!", stream.offset(), marker);
+        return false;
+    }
+
+    marker = read_marker_at_cursor(stream);
+    if (stream.handle_any_error())
+        return false;
+    return read_marker_segments_until_scan(stream, context, marker);
+}
+
+// Collects the huffman stream of the current scan, and returns the marker that ends it.
+static Optional<Marker> scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& context)
 {
+    context.huffman_stream.stream.clear_with_capacity();
+    context.huffman_stream.byte_offset = 0;
+    context.huffman_stream.bit_offset = 0;
+
     u8 last_byte;
     u8 current_byte = 0;
     stream >> current_byte;
     if (stream.handle_any_error())
-        return false;
+        return {};
 
     for (;;) {
         last_byte = current_byte;
         stream >> current_byte;
         if (stream.handle_any_error()) {
             dbgln_if(JPG_DEBUG, "{}: EOI not found!", stream.offset());
-            return false;
+            return {};
         }
 
         if (last_byte == 0xFF) {
@@ -1178,22 +1441,22 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
             if (current_byte == 0x00) {
                 stream >> current_byte;
                 if (stream.handle_any_error())
-                    return false;
+                    return {};
                 context.huffman_stream.stream.append(last_byte);
                 continue;
             }
             Marker marker = 0xFF00 | current_byte;
-            if (marker == JPG_EOI)
-                return true;
             if (marker >= JPG_RST0 && marker <= JPG_RST7) {
-                context.huffman_stream.stream.append(marker);
+                // Restart intervals are found by counting MCUs, so the markers themselves aren't needed.
                 stream >> current_byte;
                 if (stream.handle_any_error())
-                    return false;
+                    return {};
                 continue;
             }
+            if (marker == JPG_EOI || is_valid_marker(marker))
+                return marker;
             dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", stream.offset(), marker);
-            return false;
+            return {};
         } else {
             context.huffman_stream.stream.append(last_byte);
         }
@@ -1208,19 +1471,52 @@ static bool decode_jpg(JPGLoadingContext& context)
 
     if (!parse_header(stream, context))
         return false;
-    if (!scan_huffman_stream(stream, context))
-        return false;
 
-    auto result = decode_huffman_stream(context);
-    if (!result.has_value()) {
-        dbgln_if(JPG_DEBUG, "{}: Failed to decode Macroblocks!", stream.offset());
-        return false;
+    if (!context.ideal_size.is_empty())
+        context.downscale_factor = downscale_factor_for_ideal_size({ context.frame.width, context.frame.height }, context.ideal_size);
+
+    Vector<Macroblock> macroblocks;
+    macroblocks.resize(context.mblock_meta.padded_total);
+
+    if constexpr (JPG_DEBUG) {
+        dbgln("Image width: {}", context.frame.width);
+        dbgln("Image height: {}", context.frame.height);
+        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
+        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
+        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
+    }
+
+    // Every scan of a progressive JPEG adds detail to the whole image. If one of them is broken (usually because the
+    // file is truncated), we show what the ones before it gave us, like a partially loaded image in a browser would.
+    size_t decoded_scan_count = 0;
+    auto can_show_partial_image = [&] {
+        return context.frame.type == StartOfFrame::FrameType::Progressive_DCT && decoded_scan_count > 0;
+    };
+
+    for (;;) {
+        auto marker = scan_huffman_stream(stream, context);
+        if (!marker.has_value() || !decode_huffman_stream(context, macroblocks)) {
+            dbgln_if(JPG_DEBUG, "{}: Failed to decode Macroblocks!", stream.offset());
+            if (can_show_partial_image())
+                break;
+            return false;
+        }
+        decoded_scan_count++;
+
+        if (marker.value() == JPG_EOI)
+            break;
+
+        // Progressive (and non-interleaved sequential) JPEGs have more scans, possibly with new tables in between.
+        if (!read_marker_segments_until_scan(stream, context, marker.value())) {
+            if (can_show_partial_image())
+                break;
+            return false;
+        }
     }
 
-    auto macroblocks = result.release_value();
-    dequantize(context, macroblocks);
     inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
+    if (context.downscale_factor > 1)
+        return compose_downscaled_bitmap(context, macroblocks);
     if (!compose_bitmap(context, macroblocks))
         return false;
     return true;
@@ -1301,4 +1597,11 @@ ErrorOr<ImageFrameDescriptor> JPGImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<ImageFrameDescriptor> JPGImageDecoderPlugin::downscaled_frame(size_t index, IntSize ideal_size)
+{
+    if (m_context->state < JPGLoadingContext::State::BitmapDecoded)
+        m_context->ideal_size = ideal_size;
+    return frame(index);
+}
+
 }
@@ -24,6 +24,7 @@ public:
     virtual size_t loop_count() override;
     virtual size_t frame_count() override;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) override;
+    virtual ErrorOr<ImageFrameDescriptor> downscaled_frame(size_t index, IntSize ideal_size) override;
 
 private:
     OwnPtr<JPGLoadingContext> m_context;
@@ -31,7 +31,7 @@ public:
     }
 
     template<typename... Args>
-    constexpr Matrix(Args... args)
+    constexpr Matrix(Args... args) requires((IsConvertible<Args, T> && ...))
         : Matrix({ (T)args... })
     {
     }
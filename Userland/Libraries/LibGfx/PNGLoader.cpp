@@ -8,18 +8,22 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/FixedArray.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <LibGfx/PNGShared.h>
+#include <LibGfx/ScanlineOperations.h>
 #include <string.h>
 
-#ifdef __serenity__
-#    include <LibCompress/Deflate.h>
-#endif
-
 namespace Gfx {
 
+using AK::SIMD::i16x4;
+using AK::SIMD::u8x4;
+
 struct PNG_IHDR {
     NetworkOrdered<u32> width;
     NetworkOrdered<u32> height;
@@ -32,11 +36,6 @@ struct PNG_IHDR {
 
 static_assert(AssertSize<PNG_IHDR, 13>());
 
-struct Scanline {
-    PNG::FilterType filter;
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -94,10 +93,10 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
-    ByteBuffer* decompression_buffer { nullptr };
+    // If set, we only need an image about this large, and only decode every downscale_factor-th pixel of every downscale_factor-th row.
+    IntSize ideal_size;
+    int downscale_factor { 1 };
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
@@ -157,6 +156,7 @@ public:
     }
 
     bool at_end() const { return !m_size_remaining; }
+    size_t remaining() const { return m_size_remaining; }
 
 private:
     u8 const* m_data_ptr { nullptr };
@@ -177,10 +177,94 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(AssertSize<Pixel, 4>());
 
+// Sub, Average and Paeth depend on the pixel to the left, so unfiltering them is sequential from one pixel to the next.
+// The bytes within a pixel are independent of each other though, so for 3 and 4 bytes per pixel (8-bit RGB and RGBA, by far
+// the most common kinds of PNG) we unfilter all of a pixel's bytes at once, which also lets Paeth pick its predictor without branching.
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static i16x4 load_pixel(u8 const* data)
+{
+    if constexpr (bytes_per_pixel == 4) {
+        u8x4 pixel;
+        __builtin_memcpy(&pixel, data, sizeof(pixel));
+        return __builtin_convertvector(pixel, i16x4);
+    }
+    i16x4 pixel {};
+    for (size_t i = 0; i < bytes_per_pixel; ++i)
+        pixel[i] = data[i];
+    return pixel;
+}
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static void store_pixel(u8* data, i16x4 pixel)
+{
+    if constexpr (bytes_per_pixel == 4) {
+        auto bytes = __builtin_convertvector(pixel, u8x4);
+        __builtin_memcpy(data, &bytes, sizeof(bytes));
+        return;
+    }
+    for (size_t i = 0; i < bytes_per_pixel; ++i)
+        data[i] = pixel[i];
+}
+
+ALWAYS_INLINE static i16x4 absolute_value(i16x4 value)
+{
+    auto sign = value >> 15;
+    return (value ^ sign) - sign;
+}
+
+template<size_t bytes_per_pixel>
+static void unfilter_scanline_by_pixel(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data)
+{
+    i16x4 left {};
+    i16x4 upper_left {};
+    size_t const size = scanline_data.size() - scanline_data.size() % bytes_per_pixel;
+
+    switch (filter) {
+    case PNG::FilterType::Sub:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            left = (load_pixel<bytes_per_pixel>(&scanline_data[i]) + left) & 0xff;
+            store_pixel<bytes_per_pixel>(&scanline_data[i], left);
+        }
+        break;
+    case PNG::FilterType::Average:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto above = load_pixel<bytes_per_pixel>(&previous_scanlines_data[i]);
+            left = (load_pixel<bytes_per_pixel>(&scanline_data[i]) + ((left + above) >> 1)) & 0xff;
+            store_pixel<bytes_per_pixel>(&scanline_data[i], left);
+        }
+        break;
+    case PNG::FilterType::Paeth:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto above = load_pixel<bytes_per_pixel>(&previous_scanlines_data[i]);
+            // With predictor = left + above - upper_left, these are its distances to left, above and upper_left.
+            auto predictor_left = absolute_value(above - upper_left);
+            auto predictor_above = absolute_value(left - upper_left);
+            auto predictor_upper_left = absolute_value(left + above - 2 * upper_left);
+            i16x4 nearest_is_left = (predictor_left <= predictor_above) & (predictor_left <= predictor_upper_left);
+            i16x4 nearest_is_above = ~nearest_is_left & (predictor_above <= predictor_upper_left);
+            i16x4 nearest_is_upper_left = ~(nearest_is_left | nearest_is_above);
+            auto nearest = (left & nearest_is_left) | (above & nearest_is_above) | (upper_left & nearest_is_upper_left);
+            left = (load_pixel<bytes_per_pixel>(&scanline_data[i]) + nearest) & 0xff;
+            upper_left = above;
+            store_pixel<bytes_per_pixel>(&scanline_data[i], left);
+        }
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
     VERIFY(filter != PNG::FilterType::None);
 
+    if (filter != PNG::FilterType::Up) {
+        if (bytes_per_complete_pixel == 3)
+            return unfilter_scanline_by_pixel<3>(filter, scanline_data, previous_scanlines_data);
+        if (bytes_per_complete_pixel == 4)
+            return unfilter_scanline_by_pixel<4>(filter, scanline_data, previous_scanlines_data);
+    }
+
     switch (filter) {
     case PNG::FilterType::Sub:
         // This loop starts at bytes_per_complete_pixel because all bytes before that are
@@ -233,132 +317,84 @@ static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, Reado
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<const T*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes scanline_data, Pixel* pixels, int width)
+{
+    auto* gray_values = reinterpret_cast<const T*>(scanline_data.data());
+    for (int i = 0; i < width; ++i) {
+        auto& pixel = pixels[i];
+        pixel.r = gray_values[i];
+        pixel.g = gray_values[i];
+        pixel.b = gray_values[i];
+        pixel.a = 0xff;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes scanline_data, Pixel* pixels, int width)
+{
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(scanline_data.data());
+    for (int i = 0; i < width; ++i) {
+        auto& pixel = pixels[i];
+        pixel.r = tuples[i].gray;
+        pixel.g = tuples[i].gray;
+        pixel.b = tuples[i].gray;
+        pixel.a = tuples[i].a;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes scanline_data, Pixel* pixels, int width)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline_data.data());
+    for (int i = 0; i < width; ++i) {
+        auto& pixel = pixels[i];
+        pixel.r = triplets[i].r;
+        pixel.g = triplets[i].g;
+        pixel.b = triplets[i].b;
+        pixel.a = 0xff;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes scanline_data, Pixel* pixels, int width, Triplet<T> transparency_value)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline_data.data());
+    for (int i = 0; i < width; ++i) {
+        auto& pixel = pixels[i];
+        pixel.r = triplets[i].r;
+        pixel.g = triplets[i].g;
+        pixel.b = triplets[i].b;
+        if (triplets[i] == transparency_value)
+            pixel.a = 0x00;
+        else
+            pixel.a = 0xff;
     }
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+// Converts one unfiltered scanline of `width` pixels to BGRA.
+NEVER_INLINE FLATTEN static ErrorOr<void> unpack_scanline(PNGLoadingContext& context, ReadonlyBytes scanline_data, ARGB32* destination, int width)
 {
-    // First unfilter the scanlines:
-
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
-    size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
-    }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
-
-    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
-    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
-    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
-    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
-    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
-    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
-    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
-
-    u8 dummy_scanline_bytes[bytes_per_scanline];
-    memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
-    auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
-
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
-
-            data_start += bytes_per_scanline;
-        }
-        previous_scanlines_data = context.scanlines[y].data;
-    }
+    auto* pixels = reinterpret_cast<Pixel*>(destination);
 
-    // Now unpack the scanlines to RGBA:
     switch (context.color_type) {
     case PNG::ColorType::Greyscale:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(scanline_data, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(scanline_data, pixels, width);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            auto* gray_values = scanline_data.data();
+            for (int x = 0; x < width; ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
+                auto& pixel = pixels[x];
+                pixel.r = value * (0xff / bit_depth_squared);
+                pixel.g = value * (0xff / bit_depth_squared);
+                pixel.b = value * (0xff / bit_depth_squared);
+                pixel.a = 0xff;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -366,9 +402,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::GreyscaleWithAlpha:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(scanline_data, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(scanline_data, pixels, width);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -376,39 +412,37 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case PNG::ColorType::Truecolor:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                unpack_triplets_with_transparency_value<u8>(scanline_data, pixels, width, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(scanline_data, pixels, width, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(scanline_data, pixels, width);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(scanline_data, pixels, width);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::TruecolorWithAlpha:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
+            // This is already RGBA, which only needs its red and blue swapped.
+            swap_red_and_blue_in_scanline(destination, reinterpret_cast<u32 const*>(scanline_data.data()), width);
+            return {};
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
+            auto* quartets = reinterpret_cast<Quartet<u16> const*>(scanline_data.data());
+            for (int i = 0; i < width; ++i) {
+                auto& pixel = pixels[i];
+                pixel.r = quartets[i].r & 0xFF;
+                pixel.g = quartets[i].g & 0xFF;
+                pixel.b = quartets[i].b & 0xFF;
+                pixel.a = quartets[i].a & 0xFF;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -416,42 +450,38 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::IndexedColor:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            auto* palette_index = scanline_data.data();
+            for (int i = 0; i < width; ++i) {
+                auto& pixel = pixels[i];
+                if (palette_index[i] >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at((int)palette_index[i]);
+                auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
+                    ? context.palette_transparency_data.data()[palette_index[i]]
+                    : 0xff;
+                pixel.r = color.r;
+                pixel.g = color.g;
+                pixel.b = color.b;
+                pixel.a = transparency;
             }
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            auto* palette_indices = scanline_data.data();
+            for (int i = 0; i < width; ++i) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
+                auto& pixel = pixels[i];
+                if ((size_t)palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixel.r = color.r;
+                pixel.g = color.g;
+                pixel.b = color.b;
+                pixel.a = transparency;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -463,15 +493,52 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     }
 
     // Swap r and b values:
-    for (int y = 0; y < context.height; ++y) {
-        auto* pixels = (Pixel*)context.bitmap->scanline(y);
-        for (int i = 0; i < context.bitmap->width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
+    swap_red_and_blue_in_scanline(destination, destination, width);
+    return {};
+}
+
+// Inflates and unfilters the image data one scanline at a time, handing each one to on_scanline as soon as it's ready,
+// so that only the current and the previous scanline need to be kept around rather than the whole decompressed image.
+// Returns how many scanlines were decoded, which is less than `height` if the image data ended early.
+template<typename Callback>
+static ErrorOr<int> decode_scanlines(PNGLoadingContext& context, InputStream& image_data, int width, int height, Callback on_scanline)
+{
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+
+    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
+    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
+    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
+    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
+    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
+    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
+    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
+
+    auto scanline = TRY(ByteBuffer::create_uninitialized(row_size.value()));
+    // The scanline above the first one is treated as all zeroes.
+    auto previous_scanline = TRY(ByteBuffer::create_zeroed(row_size.value()));
+
+    for (int y = 0; y < height; ++y) {
+        u8 filter_type = 0;
+        if (!image_data.read_or_error({ &filter_type, sizeof(filter_type) }) || !image_data.read_or_error(scanline.bytes())) {
+            image_data.handle_any_error();
+            return y;
         }
-    }
 
-    return {};
+        if (filter_type > 4) {
+            context.state = PNGLoadingContext::State::Error;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
+        }
+        auto filter = static_cast<PNG::FilterType>(filter_type);
+
+        if (filter != PNG::FilterType::None)
+            unfilter_scanline(filter, scanline.bytes(), previous_scanline.bytes(), bytes_per_complete_pixel);
+
+        TRY(on_scanline(y, scanline.bytes()));
+        swap(scanline, previous_scanline);
+    }
+    return height;
 }
 
 static bool decode_png_header(PNGLoadingContext& context)
@@ -551,36 +618,31 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, InputStream& image_data)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
+    int const factor = context.downscale_factor;
+    auto pixels = TRY(FixedArray<ARGB32>::try_create(factor > 1 ? context.width : 0));
 
-    for (int y = 0; y < context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
+    auto decoded_scanlines = TRY(decode_scanlines(context, image_data, context.width, context.height, [&](int y, ReadonlyBytes scanline) -> ErrorOr<void> {
+        if (factor == 1)
+            return unpack_scanline(context, scanline, context.bitmap->scanline(y), context.width);
 
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+        // Every scanline has to be unfiltered for the ones below it, but only the ones we keep need to be unpacked.
+        if (y % factor)
+            return {};
+        TRY(unpack_scanline(context, scanline, pixels.data(), context.width));
+        auto* destination = context.bitmap->scanline(y / factor);
+        for (int x = 0; x < context.bitmap->width(); ++x)
+            destination[x] = pixels[x * factor];
+        return {};
+    }));
 
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    // If the image data got cut off, we still show the rows we have and leave the rest transparent.
+    if (decoded_scanlines == 0) {
+        context.state = PNGLoadingContext::State::Error;
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
     }
-
-    context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
+    return {};
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -633,65 +695,89 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+// After each pass, the pixels decoded so far form a grid with cells of this size, the decoded pixel being in the top left corner of each cell.
+static int adam7_cell_width[8] = { 1, 8, 4, 4, 2, 2, 1, 1 };
+static int adam7_cell_height[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
+
+// Returns how many scanlines of the pass were decoded, like decode_scanlines().
+static ErrorOr<int> decode_adam7_pass(PNGLoadingContext& context, InputStream& image_data, int pass)
 {
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+    int width = adam7_width(context, pass);
+    int height = adam7_height(context, pass);
 
     // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
-        return {};
-
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    if (!width || !height)
+        return height;
+
+    int const factor = context.downscale_factor;
+    auto pixels = TRY(FixedArray<ARGB32>::try_create(width));
+    return decode_scanlines(context, image_data, width, height, [&](int y, ReadonlyBytes scanline) -> ErrorOr<void> {
+        int dy = adam7_starty[pass] + y * adam7_stepy[pass];
+        if (dy % factor)
+            return {};
+        TRY(unpack_scanline(context, scanline, pixels.data(), width));
 
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
+        // Copy the subimage row into the main image according to the pass pattern
+        auto* destination = context.bitmap->scanline(dy / factor);
+        for (int x = 0, dx = adam7_startx[pass]; x < width; ++x, dx += adam7_stepx[pass]) {
+            if (dx % factor == 0)
+                destination[dx / factor] = pixels[x];
         }
+        return {};
+    });
+}
 
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+// When decoding at 1/2, 1/4 or 1/8 of the size, we only need the pixels in every 2nd, 4th or 8th row and column. Those are all
+// in the first 5, 3 or 1 passes respectively, so the rest of the image data doesn't even have to be inflated.
+static int adam7_passes_for_downscale_factor(int factor)
+{
+    switch (factor) {
+    case 1:
+        return 7;
+    case 2:
+        return 5;
+    case 4:
+        return 3;
+    case 8:
+        return 1;
+    default:
+        VERIFY_NOT_REACHED();
     }
+}
 
-    subimage_context.bitmap = TRY(Bitmap::try_create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
-
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
+// Fills in the pixels that the passes after the last complete one would have provided by stretching out the ones we have,
+// so an image whose data got cut off looks like a lower resolution version of itself rather than a sparse grid of dots.
+static void fill_in_missing_adam7_passes(PNGLoadingContext& context, int complete_passes)
+{
+    int pass = max(complete_passes, 1);
+    int cell_width = max(adam7_cell_width[pass] / context.downscale_factor, 1);
+    int cell_height = max(adam7_cell_height[pass] / context.downscale_factor, 1);
+    if (cell_width == 1 && cell_height == 1)
+        return;
+
+    for (int y = 0; y < context.bitmap->height(); ++y) {
+        auto* scanline = context.bitmap->scanline(y);
+        auto const* decoded_scanline = context.bitmap->scanline(y - y % cell_height);
+        for (int x = 0; x < context.bitmap->width(); ++x)
+            scanline[x] = decoded_scanline[x - x % cell_width];
     }
-    return {};
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, InputStream& image_data)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-    context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+    for (int pass = 1; pass <= adam7_passes_for_downscale_factor(context.downscale_factor); ++pass) {
+        auto decoded_scanlines = TRY(decode_adam7_pass(context, image_data, pass));
+        if (decoded_scanlines == adam7_height(context, pass))
+            continue;
+
+        // The image data got cut off. As long as we got something, show what we have instead of failing.
+        if (pass == 1 && decoded_scanlines == 0) {
+            context.state = PNGLoadingContext::State::Error;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
+        }
+        fill_in_missing_adam7_passes(context, pass - 1);
+        break;
+    }
     return {};
 }
 
@@ -711,28 +797,36 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
 
-    auto result = Compress::Zlib::decompress_all(context.compressed_data.span());
-    if (!result.has_value()) {
+    auto zlib = Compress::Zlib::try_create(context.compressed_data.span());
+    if (!zlib.has_value()) {
         context.state = PNGLoadingContext::State::Error;
         return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
     }
-    context.decompression_buffer = &result.value();
-    context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
+    // The image data is inflated as it's being decoded, instead of all at once up front.
+    InputMemoryStream compressed_image_data { zlib->compressed_data() };
+    Compress::DeflateDecompressor image_data { compressed_image_data };
+
+    IntSize size { context.width, context.height };
+    if (!context.ideal_size.is_empty()) {
+        context.downscale_factor = downscale_factor_for_ideal_size(size, context.ideal_size);
+        size = { ceil_div(context.width, context.downscale_factor), ceil_div(context.height, context.downscale_factor) };
+    }
+
+    context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, size));
     switch (context.interlace_method) {
     case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context));
+        TRY(decode_png_bitmap_simple(context, image_data));
         break;
     case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context));
+        TRY(decode_png_adam7(context, image_data));
         break;
     default:
         context.state = PNGLoadingContext::State::Error;
         return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
     }
 
-    context.decompression_buffer = nullptr;
+    context.compressed_data.clear();
 
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
@@ -859,21 +953,27 @@ static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
         dbgln_if(PNG_DEBUG, "Bail at chunk_type");
         return false;
     }
+    // If the file got cut off in the middle of the image data, we keep what there is of it so that at least part of the image can be shown.
+    bool is_image_data = !strcmp((char const*)chunk_type, "IDAT");
     ReadonlyBytes chunk_data;
     if (!streamer.wrap_bytes(chunk_data, chunk_size)) {
         dbgln_if(PNG_DEBUG, "Bail at chunk_data");
+        if (is_image_data && streamer.wrap_bytes(chunk_data, streamer.remaining()))
+            process_IDAT(chunk_data, context);
         return false;
     }
     u32 chunk_crc;
     if (!streamer.read(chunk_crc)) {
         dbgln_if(PNG_DEBUG, "Bail at chunk_crc");
+        if (is_image_data)
+            process_IDAT(chunk_data, context);
         return false;
     }
     dbgln_if(PNG_DEBUG, "Chunk type: '{}', size: {}, crc: {:x}", chunk_type, chunk_size, chunk_crc);
 
     if (!strcmp((char const*)chunk_type, "IHDR"))
         return process_IHDR(chunk_data, context);
-    if (!strcmp((char const*)chunk_type, "IDAT"))
+    if (is_image_data)
         return process_IDAT(chunk_data, context);
     if (!strcmp((char const*)chunk_type, "PLTE"))
         return process_PLTE(chunk_data, context);
@@ -955,4 +1055,11 @@ ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::downscaled_frame(size_t index, IntSize ideal_size)
+{
+    if (m_context->state < PNGLoadingContext::State::BitmapDecoded)
+        m_context->ideal_size = ideal_size;
+    return frame(index);
+}
+
 }
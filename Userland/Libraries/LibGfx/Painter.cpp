@@ -31,6 +31,7 @@
 #include <LibGfx/FillPathImplementation.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/Path.h>
+#include <LibGfx/ScanlineOperations.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextLayout.h>
 #include <stdio.h>
@@ -121,8 +122,7 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_argb(dst[j]).blend(color).value();
+        blend_color_into_scanline(dst, color, physical_rect.width());
         dst += dst_skip;
     }
 }
@@ -804,39 +804,40 @@ struct BlitState {
     BitmapFormat src_format;
 };
 
-// FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
-//        Ideally we'd have a more generic solution that allows any source format.
-static void swap_red_and_blue_channels(Color& color)
-{
-    u32 rgba = color.value();
-    u32 bgra = (rgba & 0xff00ff00)
-        | ((rgba & 0x000000ff) << 16)
-        | ((rgba & 0x00ff0000) >> 16);
-    color = Color::from_argb(bgra);
-}
-
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
-    for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            }
+    // The opacity only changes the alpha of the source pixels, so that's done up front (through a table, as there
+    // are only 256 possible alphas) into a scratch row, which then gets blended in one go.
+    u8 source_alpha_with_opacity[256];
+    for (int alpha = 0; alpha < 256; ++alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = alpha / 255.0;
+            source_alpha_with_opacity[alpha] = 255 * (state.opacity * pixel_opacity);
+        } else {
+            source_alpha_with_opacity[alpha] = state.opacity * 255;
         }
+    }
+
+    Vector<ARGB32> row;
+    row.resize(state.column_count);
+
+    for (int row_index = 0; row_index < state.row_count; ++row_index) {
+        // FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
+        //        Ideally we'd have a more generic solution that allows any source format.
+        if (state.src_format == BitmapFormat::RGBA8888)
+            swap_red_and_blue_in_scanline(row.data(), state.src, row.size());
+        else
+            fast_u32_copy(row.data(), state.src, row.size());
+
+        for (auto& pixel : row)
+            pixel = (pixel & 0x00ffffff) | (source_alpha_with_opacity[pixel >> 24] << 24);
+
+        if constexpr (has_alpha & BlitState::DstAlpha)
+            blend_scanline(state.dst, row.data(), row.size());
+        else
+            blend_scanline_onto_opaque(state.dst, row.data(), row.size());
+
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
@@ -1077,13 +1078,7 @@ void Painter::blit(IntPoint const& position, Gfx::Bitmap const& source, IntRect
         u32 const* src = source.scanline(src_rect.top() + first_row) + src_rect.left() + first_column;
         size_t const src_skip = source.pitch() / sizeof(u32);
         for (int row = first_row; row <= last_row; ++row) {
-            for (int i = 0; i < clipped_rect.width(); ++i) {
-                u32 rgba = src[i];
-                u32 bgra = (rgba & 0xff00ff00)
-                    | ((rgba & 0x000000ff) << 16)
-                    | ((rgba & 0x00ff0000) >> 16);
-                dst[i] = bgra;
-            }
+            swap_red_and_blue_in_scanline(dst, src, clipped_rect.width());
             dst += dst_skip;
             src += src_skip;
         }
@@ -1109,22 +1104,26 @@ template<bool has_alpha_channel, typename GetPixel>
 ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, IntRect const& dst_rect, IntRect const& src_rect, Gfx::Bitmap const& source, int hfactor, int vfactor, GetPixel get_pixel, float opacity)
 {
     bool has_opacity = opacity != 1.0f;
+
+    // Each source row is stretched out once, and then copied or blended into all the rows it covers.
+    Vector<ARGB32> row;
+    row.resize(src_rect.width() * hfactor);
+
     for (int y = 0; y < src_rect.height(); ++y) {
         int dst_y = dst_rect.y() + y * vfactor;
         for (int x = 0; x < src_rect.width(); ++x) {
             auto src_pixel = get_pixel(source, x + src_rect.left(), y + src_rect.top());
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
-            for (int yo = 0; yo < vfactor; ++yo) {
-                auto* scanline = (Color*)target.scanline(dst_y + yo);
-                int dst_x = dst_rect.x() + x * hfactor;
-                for (int xo = 0; xo < hfactor; ++xo) {
-                    if constexpr (has_alpha_channel)
-                        scanline[dst_x + xo] = scanline[dst_x + xo].blend(src_pixel);
-                    else
-                        scanline[dst_x + xo] = src_pixel;
-                }
-            }
+            for (int xo = 0; xo < hfactor; ++xo)
+                row[x * hfactor + xo] = src_pixel.value();
+        }
+        for (int yo = 0; yo < vfactor; ++yo) {
+            auto* scanline = target.scanline(dst_y + yo) + dst_rect.x();
+            if constexpr (has_alpha_channel)
+                blend_scanline(scanline, row.data(), row.size());
+            else
+                fast_u32_copy(scanline, row.data(), row.size());
         }
     }
 }
@@ -1162,12 +1161,18 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 clipped_src_bottom_shifted = (clipped_src_rect.y() + clipped_src_rect.height()) * shift;
     i64 clipped_src_right_shifted = (clipped_src_rect.x() + clipped_src_rect.width()) * shift;
 
+    // The resampled pixels of each row are collected first, so they can be copied or blended in one go.
+    // As desired_x only ever grows, the pixels that map into the source rect are a contiguous run.
+    Vector<ARGB32> row;
+    row.resize(clipped_rect.width());
+
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
-        auto* scanline = (Color*)target.scanline(y);
         auto desired_y = ((y - dst_rect.y()) * vscale + src_top);
         if (desired_y < clipped_src_rect.top() || desired_y > clipped_src_bottom_shifted)
             continue;
 
+        int row_start = 0;
+        int row_length = 0;
         for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
             auto desired_x = ((x - dst_rect.x()) * hscale + src_left);
             if (desired_x < clipped_src_rect.left() || desired_x > clipped_src_right_shifted)
@@ -1221,12 +1226,16 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
 
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
-            if constexpr (has_alpha_channel) {
-                scanline[x] = scanline[x].blend(src_pixel);
-            } else {
-                scanline[x] = src_pixel;
-            }
+            if (row_length == 0)
+                row_start = x - clipped_rect.left();
+            row[row_start + row_length++] = src_pixel.value();
         }
+
+        auto* scanline = target.scanline(y) + clipped_rect.left() + row_start;
+        if constexpr (has_alpha_channel)
+            blend_scanline(scanline, row.data() + row_start, row_length);
+        else
+            fast_u32_copy(scanline, row.data() + row_start, row_length);
     }
 }
 
@@ -1315,12 +1324,48 @@ FLATTEN void Painter::draw_glyph(IntPoint const& point, u32 code_point, Font con
     if (glyph.is_glyph_bitmap()) {
         draw_bitmap(top_left, glyph.glyph_bitmap(), color);
     } else {
-        blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap()->rect(), [color](Color pixel) -> Color {
+        blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap_rect(), [color](Color pixel) -> Color {
             return pixel.multiply(color);
         });
     }
 }
 
+void Painter::blit_glyphs(Gfx::Bitmap const& source, Span<GlyphBlit const> glyphs, Color color)
+{
+    if (scale() != 1 || source.scale() != 1) {
+        for (auto& glyph : glyphs) {
+            blit_filtered(glyph.position, source, glyph.src_rect, [color](Color pixel) -> Color {
+                return pixel.multiply(color);
+            });
+        }
+        return;
+    }
+
+    // Glyph pixels are white, with their coverage in the alpha channel. Multiplied with the text color
+    // (like draw_glyph() does), that's the text color with the coverage scaling its alpha.
+    u8 alpha_for_coverage[256];
+    for (int coverage = 0; coverage < 256; ++coverage)
+        alpha_for_coverage[coverage] = coverage * color.alpha() / 255;
+    ARGB32 const rgb = color.value() & 0x00ffffff;
+
+    Vector<ARGB32, 128> row;
+    for (auto& glyph : glyphs) {
+        auto dst_rect = IntRect(glyph.position, glyph.src_rect.size()).translated(translation());
+        auto clipped_rect = dst_rect.intersected(clip_rect());
+        if (clipped_rect.is_empty())
+            continue;
+        auto src_origin = glyph.src_rect.location() + (clipped_rect.location() - dst_rect.location());
+
+        row.resize(clipped_rect.width());
+        for (int y = 0; y < clipped_rect.height(); ++y) {
+            ARGB32 const* src = source.scanline(src_origin.y() + y) + src_origin.x();
+            for (size_t x = 0; x < row.size(); ++x)
+                row[x] = rgb | (alpha_for_coverage[src[x] >> 24] << 24);
+            blend_scanline(m_target->scanline(clipped_rect.y() + y) + clipped_rect.x(), row.data(), row.size());
+        }
+    }
+}
+
 void Painter::draw_emoji(IntPoint const& point, Gfx::Bitmap const& emoji, Font const& font)
 {
     IntRect dst_rect {
@@ -1340,14 +1385,26 @@ void Painter::draw_glyph_or_emoji(IntPoint const& point, u32 code_point, Font co
     return draw_glyph_or_emoji(point, it, font, color);
 }
 
-void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator& it, Font const& font, Color color)
+// FIXME: These should live somewhere else.
+static constexpr u32 text_variation_selector = 0xFE0E;
+static constexpr u32 emoji_variation_selector = 0xFE0F;
+static constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
+static constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+
+static bool may_start_emoji_sequence(u32 code_point, Optional<u32> next_code_point)
 {
-    // FIXME: These should live somewhere else.
-    constexpr u32 text_variation_selector = 0xFE0E;
-    constexpr u32 emoji_variation_selector = 0xFE0F;
-    constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
-    constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+    auto code_point_is_regional_indicator = code_point >= regional_indicator_symbol_a && code_point <= regional_indicator_symbol_z;
+    return false
+        // Flag emojis consist of two regional indicators.
+        || code_point_is_regional_indicator
+        // U+00A9 (copyright) or U+00AE (registered) are text glyphs by default,
+        // keycap emojis ({#,*,0-9} U+FE0F U+20E3) start with a regular ASCII character.
+        // Both cases are handled by peeking for the variation selector.
+        || next_code_point == emoji_variation_selector;
+}
 
+void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator& it, Font const& font, Color color)
+{
     auto initial_it = it;
     u32 code_point = *it;
     auto next_code_point = it.peek(1);
@@ -1362,16 +1419,8 @@ void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator&
             ++it;
     };
 
-    auto code_point_is_regional_indicator = code_point >= regional_indicator_symbol_a && code_point <= regional_indicator_symbol_z;
     auto font_contains_glyph = font.contains_glyph(code_point);
-
-    auto check_for_emoji = false
-        // Flag emojis consist of two regional indicators.
-        || code_point_is_regional_indicator
-        // U+00A9 (copyright) or U+00AE (registered) are text glyphs by default,
-        // keycap emojis ({#,*,0-9} U+FE0F U+20E3) start with a regular ASCII character.
-        // Both cases are handled by peeking for the variation selector.
-        || next_code_point == emoji_variation_selector;
+    auto check_for_emoji = may_start_emoji_sequence(code_point, next_code_point);
 
     // If the font contains the glyph, and we know it's not the start of an emoji, draw a text glyph.
     if (font_contains_glyph && !check_for_emoji) {
@@ -2394,6 +2443,16 @@ void Painter::draw_text_run(FloatPoint const& baseline_start, Utf8View const& st
 
     u32 last_code_point = 0;
 
+    // Consecutive glyphs that live in the same bitmap (a vector font's glyph atlas) get blitted together.
+    RefPtr<Gfx::Bitmap> glyph_run_bitmap;
+    Vector<GlyphBlit, 64> glyph_run;
+    auto flush_glyph_run = [&] {
+        if (!glyph_run.is_empty())
+            blit_glyphs(*glyph_run_bitmap, glyph_run, color);
+        glyph_run.clear_with_capacity();
+        glyph_run_bitmap = nullptr;
+    };
+
     for (auto code_point_iterator = string.begin(); code_point_iterator != string.end(); ++code_point_iterator) {
         auto code_point = *code_point_iterator;
         if (should_paint_as_space(code_point)) {
@@ -2404,10 +2463,32 @@ void Painter::draw_text_run(FloatPoint const& baseline_start, Utf8View const& st
 
         // FIXME: this is probably not the real space taken for complex emojis
         x += font.glyphs_horizontal_kerning(last_code_point, code_point);
-        draw_glyph_or_emoji({ static_cast<int>(x), y }, code_point_iterator, font, color);
+
+        auto next_code_point = code_point_iterator.peek(1);
+        if (font.contains_glyph(code_point) && !may_start_emoji_sequence(code_point, next_code_point)) {
+            auto glyph = font.glyph(code_point, GlyphSubpixelOffset::for_position(x));
+            if (glyph.is_glyph_bitmap()) {
+                flush_glyph_run();
+                draw_bitmap({ static_cast<int>(x) + glyph.left_bearing(), y }, glyph.glyph_bitmap(), color);
+            } else {
+                if (glyph.bitmap() != glyph_run_bitmap) {
+                    flush_glyph_run();
+                    glyph_run_bitmap = glyph.bitmap();
+                }
+                glyph_run.append({ { GlyphSubpixelOffset::pixel_for_position(x) + glyph.left_bearing(), y }, glyph.bitmap_rect() });
+            }
+            if (next_code_point == text_variation_selector)
+                ++code_point_iterator;
+        } else {
+            flush_glyph_run();
+            draw_glyph_or_emoji({ static_cast<int>(x), y }, code_point_iterator, font, color);
+        }
+
         x += font.glyph_or_emoji_width(code_point) + font.glyph_spacing();
         last_code_point = code_point;
     }
+
+    flush_glyph_run();
 }
 
 }
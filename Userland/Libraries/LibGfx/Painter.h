@@ -181,6 +181,12 @@ protected:
     Vector<State, 4> m_state_stack;
 
 private:
+    struct GlyphBlit {
+        IntPoint position;
+        IntRect src_rect;
+    };
+    void blit_glyphs(Gfx::Bitmap const&, Span<GlyphBlit const>, Color);
+
     Vector<DirectionalRun> split_text_into_directional_runs(Utf8View const&, TextDirection initial_direction);
     bool text_contains_bidirectional_text(Utf8View const&, TextDirection);
     template<typename DrawGlyphFunction>
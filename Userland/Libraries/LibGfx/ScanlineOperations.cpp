@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
+#include <LibGfx/ScanlineOperations.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <cpuid.h>
+#    define GFX_HAS_AVX2_DISPATCH 1
+#else
+#    define GFX_HAS_AVX2_DISPATCH 0
+#endif
+
+namespace Gfx {
+
+using AK::SIMD::u16x16;
+using AK::SIMD::u16x8;
+using AK::SIMD::u32x4;
+using AK::SIMD::u32x8;
+
+// The same vectors, viewed as twice as many 16-bit lanes.
+template<typename VectorType>
+struct HalfWidthLanes;
+template<>
+struct HalfWidthLanes<u32x4> {
+    using Type = u16x8;
+};
+template<>
+struct HalfWidthLanes<u32x8> {
+    using Type = u16x16;
+};
+
+template<typename VectorType>
+constexpr size_t lane_count = sizeof(VectorType) / sizeof(u32);
+
+enum class DestinationAlpha {
+    FromPixels,
+    Opaque,
+};
+
+template<DestinationAlpha destination_alpha>
+ALWAYS_INLINE static ARGB32 blend_pixel(ARGB32 dst, ARGB32 src)
+{
+    auto dst_color = destination_alpha == DestinationAlpha::Opaque ? Color::from_rgb(dst) : Color::from_argb(dst);
+    return dst_color.blend(Color::from_argb(src)).value();
+}
+
+// NOTE: These work on pointers rather than taking and returning vectors, so that nothing but the AVX2 entry points
+//       ever sees a 256-bit vector crossing a function boundary (which is an ABI change without AVX enabled).
+template<typename VectorType, DestinationAlpha destination_alpha>
+ALWAYS_INLINE static bool blend_lanes(ARGB32* dst, ARGB32 const* src)
+{
+    using HalfVector = typename HalfWidthLanes<VectorType>::Type;
+
+    VectorType destination;
+    VectorType source;
+    __builtin_memcpy(&destination, dst, sizeof(destination));
+    __builtin_memcpy(&source, src, sizeof(source));
+
+    if constexpr (destination_alpha == DestinationAlpha::FromPixels) {
+        // Color::blend() has to divide by the resulting alpha in general, which doesn't vectorize well.
+        // Onto opaque pixels (by far the most common case) it boils down to a plain weighted average though.
+        u32 combined = destination[0];
+        for (size_t i = 1; i < lane_count<VectorType>; ++i)
+            combined &= destination[i];
+        if ((combined >> 24) != 0xff)
+            return false;
+    }
+
+    // out = (dst * (255 - alpha) + src * alpha) / 255 for each channel, with red and blue side by side in
+    // 16-bit lanes, then green (and a zero) the same way. Neither sum can exceed 255 * 255, so nothing overflows.
+    VectorType alpha = source >> 24;
+    alpha |= alpha << 16;
+    auto source_alpha = (HalfVector)alpha;
+    auto inverse_alpha = 255 - source_alpha;
+
+    auto red_blue = (HalfVector)(destination & 0x00ff00ff) * inverse_alpha + (HalfVector)(source & 0x00ff00ff) * source_alpha;
+    auto green = (HalfVector)((destination >> 8) & 0xff) * inverse_alpha + (HalfVector)((source >> 8) & 0xff) * source_alpha;
+
+    // Exact division by 255 for anything up to 255 * 255.
+    red_blue = (red_blue + 1 + (red_blue >> 8)) >> 8;
+    green = (green + 1 + (green >> 8)) >> 8;
+
+    VectorType result = (VectorType)red_blue | ((VectorType)green << 8) | 0xff000000;
+    __builtin_memcpy(dst, &result, sizeof(result));
+    return true;
+}
+
+template<typename VectorType, DestinationAlpha destination_alpha>
+ALWAYS_INLINE static void blend_scanline_impl(ARGB32* dst, ARGB32 const* src, size_t count)
+{
+    constexpr auto lanes = lane_count<VectorType>;
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        if (!blend_lanes<VectorType, destination_alpha>(dst + i, src + i)) {
+            for (size_t j = i; j < i + lanes; ++j)
+                dst[j] = blend_pixel<destination_alpha>(dst[j], src[j]);
+        }
+    }
+    for (; i < count; ++i)
+        dst[i] = blend_pixel<destination_alpha>(dst[i], src[i]);
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void blend_color_into_scanline_impl(ARGB32* dst, Color color, size_t count)
+{
+    constexpr auto lanes = lane_count<VectorType>;
+    ARGB32 colors[lanes];
+    for (auto& pixel : colors)
+        pixel = color.value();
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        if (!blend_lanes<VectorType, DestinationAlpha::FromPixels>(dst + i, colors)) {
+            for (size_t j = i; j < i + lanes; ++j)
+                dst[j] = blend_pixel<DestinationAlpha::FromPixels>(dst[j], color.value());
+        }
+    }
+    for (; i < count; ++i)
+        dst[i] = blend_pixel<DestinationAlpha::FromPixels>(dst[i], color.value());
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void swap_red_and_blue_in_scanline_impl(ARGB32* dst, u32 const* src, size_t count)
+{
+    constexpr auto lanes = lane_count<VectorType>;
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        VectorType pixels;
+        __builtin_memcpy(&pixels, src + i, sizeof(pixels));
+        pixels = (pixels & 0xff00ff00) | ((pixels & 0xff) << 16) | ((pixels >> 16) & 0xff);
+        __builtin_memcpy(dst + i, &pixels, sizeof(pixels));
+    }
+    for (; i < count; ++i)
+        dst[i] = (src[i] & 0xff00ff00) | ((src[i] & 0xff) << 16) | ((src[i] >> 16) & 0xff);
+}
+
+#if GFX_HAS_AVX2_DISPATCH
+static bool cpu_supports_avx2()
+{
+    static bool const s_supports_avx2 = [] {
+        constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+        constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+        constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+        constexpr u32 xcr0_sse_and_avx_state = 0b110;
+
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        if (!(ecx & cpuid_1_ecx_bit_osxsave) || !(ecx & cpuid_1_ecx_bit_avx))
+            return false;
+
+        // The kernel also has to preserve the upper halves of the YMM registers across context switches.
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        if ((xcr0_low & xcr0_sse_and_avx_state) != xcr0_sse_and_avx_state)
+            return false;
+
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & cpuid_7_ebx_bit_avx2) != 0;
+    }();
+    return s_supports_avx2;
+}
+
+[[gnu::target("avx2")]] static void blend_scanline_avx2(ARGB32* dst, ARGB32 const* src, size_t count)
+{
+    blend_scanline_impl<u32x8, DestinationAlpha::FromPixels>(dst, src, count);
+}
+
+[[gnu::target("avx2")]] static void blend_scanline_onto_opaque_avx2(ARGB32* dst, ARGB32 const* src, size_t count)
+{
+    blend_scanline_impl<u32x8, DestinationAlpha::Opaque>(dst, src, count);
+}
+
+[[gnu::target("avx2")]] static void blend_color_into_scanline_avx2(ARGB32* dst, Color color, size_t count)
+{
+    blend_color_into_scanline_impl<u32x8>(dst, color, count);
+}
+
+[[gnu::target("avx2")]] static void swap_red_and_blue_in_scanline_avx2(ARGB32* dst, u32 const* src, size_t count)
+{
+    swap_red_and_blue_in_scanline_impl<u32x8>(dst, src, count);
+}
+#endif
+
+void blend_scanline(ARGB32* dst, ARGB32 const* src, size_t count)
+{
+#if GFX_HAS_AVX2_DISPATCH
+    if (cpu_supports_avx2())
+        return blend_scanline_avx2(dst, src, count);
+#endif
+    blend_scanline_impl<u32x4, DestinationAlpha::FromPixels>(dst, src, count);
+}
+
+void blend_scanline_onto_opaque(ARGB32* dst, ARGB32 const* src, size_t count)
+{
+#if GFX_HAS_AVX2_DISPATCH
+    if (cpu_supports_avx2())
+        return blend_scanline_onto_opaque_avx2(dst, src, count);
+#endif
+    blend_scanline_impl<u32x4, DestinationAlpha::Opaque>(dst, src, count);
+}
+
+void blend_color_into_scanline(ARGB32* dst, Color color, size_t count)
+{
+#if GFX_HAS_AVX2_DISPATCH
+    if (cpu_supports_avx2())
+        return blend_color_into_scanline_avx2(dst, color, count);
+#endif
+    blend_color_into_scanline_impl<u32x4>(dst, color, count);
+}
+
+void swap_red_and_blue_in_scanline(ARGB32* dst, u32 const* src, size_t count)
+{
+#if GFX_HAS_AVX2_DISPATCH
+    if (cpu_supports_avx2())
+        return swap_red_and_blue_in_scanline_avx2(dst, src, count);
+#endif
+    swap_red_and_blue_in_scanline_impl<u32x4>(dst, src, count);
+}
+
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibGfx/Color.h>
+
+// Vectorized operations on runs of 32-bit pixels, used by Painter for its hot loops.
+// Each of them produces exactly the same pixels as doing the operation one pixel at a time with Color,
+// they're just several times faster. On x86, the widest vector extension the CPU supports is picked at runtime.
+
+namespace Gfx {
+
+// dst[i] = Color::from_argb(dst[i]).blend(Color::from_argb(src[i]))
+void blend_scanline(ARGB32* dst, ARGB32 const* src, size_t count);
+
+// Like blend_scanline(), but the destination pixels are taken to be opaque whatever their alpha (e.g. for BGRx8888 targets).
+void blend_scanline_onto_opaque(ARGB32* dst, ARGB32 const* src, size_t count);
+
+// dst[i] = Color::from_argb(dst[i]).blend(color)
+void blend_color_into_scanline(ARGB32* dst, Color color, size_t count);
+
+// Converts RGBA8888 pixels to BGRA8888 (or back, it's the same operation).
+void swap_red_and_blue_in_scanline(ARGB32* dst, u32 const* src, size_t count);
+
+}
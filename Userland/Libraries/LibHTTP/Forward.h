@@ -8,6 +8,8 @@
 
 namespace HTTP {
 
+class Http2Connection;
+class Http2StreamClient;
 class HttpRequest;
 class HttpResponse;
 class HttpsJob;
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HPack.h>
+
+namespace HTTP::HPack {
+
+struct StaticTableEntry {
+    StringView name;
+    StringView value;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-A
+static constexpr StaticTableEntry static_table[] = {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+};
+
+static constexpr size_t static_table_size = sizeof(static_table) / sizeof(static_table[0]);
+
+struct HuffmanCode {
+    u32 code;
+    u8 length;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-B
+static constexpr HuffmanCode huffman_codes[] = {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+};
+
+static constexpr u16 eos_symbol = 256;
+
+struct HuffmanTree {
+    struct Node {
+        i16 children[2] { -1, -1 };
+        i16 symbol { -1 };
+    };
+    Vector<Node> nodes;
+};
+
+static HuffmanTree const& huffman_tree()
+{
+    static HuffmanTree const s_tree = [] {
+        HuffmanTree tree;
+        tree.nodes.append({});
+        for (u16 symbol = 0; symbol <= eos_symbol; ++symbol) {
+            auto [code, length] = huffman_codes[symbol];
+            size_t node = 0;
+            for (int bit = length - 1; bit >= 0; --bit) {
+                auto direction = (code >> bit) & 1;
+                if (tree.nodes[node].children[direction] < 0) {
+                    tree.nodes[node].children[direction] = static_cast<i16>(tree.nodes.size());
+                    tree.nodes.append({});
+                }
+                node = tree.nodes[node].children[direction];
+            }
+            tree.nodes[node].symbol = static_cast<i16>(symbol);
+        }
+        return tree;
+    }();
+    return s_tree;
+}
+
+ErrorOr<String> huffman_decode(ReadonlyBytes data)
+{
+    auto& tree = huffman_tree();
+    StringBuilder builder;
+    size_t node = 0;
+    size_t bits_since_last_symbol = 0;
+    bool only_ones_since_last_symbol = true;
+    for (auto byte : data) {
+        for (int bit = 7; bit >= 0; --bit) {
+            auto direction = (byte >> bit) & 1;
+            auto next = tree.nodes[node].children[direction];
+            if (next < 0)
+                return Error::from_string_literal("HPACK: Invalid Huffman code");
+            node = next;
+            ++bits_since_last_symbol;
+            only_ones_since_last_symbol &= direction == 1;
+
+            auto symbol = tree.nodes[node].symbol;
+            if (symbol < 0)
+                continue;
+            // "A Huffman-encoded string literal containing the EOS symbol MUST be treated as a decoding error."
+            if (symbol == eos_symbol)
+                return Error::from_string_literal("HPACK: EOS symbol in Huffman-encoded string");
+            builder.append(static_cast<char>(symbol));
+            node = 0;
+            bits_since_last_symbol = 0;
+            only_ones_since_last_symbol = true;
+        }
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+    // "A padding strictly longer than 7 bits MUST be treated as a decoding error.
+    //  A padding not corresponding to the most significant bits of the code for the EOS symbol MUST be treated as a decoding error."
+    if (bits_since_last_symbol > 7 || !only_ones_since_last_symbol)
+        return Error::from_string_literal("HPACK: Invalid padding in Huffman-encoded string");
+    return builder.to_string();
+}
+
+size_t huffman_encoded_length(StringView string)
+{
+    size_t bits = 0;
+    for (auto ch : string)
+        bits += huffman_codes[static_cast<u8>(ch)].length;
+    return (bits + 7) / 8;
+}
+
+ErrorOr<ByteBuffer> huffman_encode(StringView string)
+{
+    ByteBuffer buffer;
+    TRY(buffer.try_ensure_capacity(huffman_encoded_length(string)));
+
+    u64 bit_buffer = 0;
+    size_t bit_count = 0;
+    for (auto ch : string) {
+        auto [code, length] = huffman_codes[static_cast<u8>(ch)];
+        bit_buffer = (bit_buffer << length) | code;
+        bit_count += length;
+        while (bit_count >= 8) {
+            bit_count -= 8;
+            TRY(buffer.try_append(static_cast<u8>(bit_buffer >> bit_count)));
+        }
+    }
+    // Pad with the most significant bits of the EOS code, i.e. all ones.
+    if (bit_count > 0)
+        TRY(buffer.try_append(static_cast<u8>((bit_buffer << (8 - bit_count)) | (0xff >> bit_count))));
+    return buffer;
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.1
+static ErrorOr<u32> decode_integer(ReadonlyBytes data, size_t& offset, u8 prefix_bits)
+{
+    if (offset >= data.size())
+        return Error::from_string_literal("HPACK: Unexpected end of header block");
+
+    u32 max_prefix_value = (1u << prefix_bits) - 1;
+    u64 value = data[offset++] & max_prefix_value;
+    if (value < max_prefix_value)
+        return static_cast<u32>(value);
+
+    size_t shift = 0;
+    while (true) {
+        if (offset >= data.size())
+            return Error::from_string_literal("HPACK: Unexpected end of header block");
+        auto byte = data[offset++];
+        value += static_cast<u64>(byte & 0x7f) << shift;
+        if (value > NumericLimits<u32>::max())
+            return Error::from_string_literal("HPACK: Integer overflow");
+        shift += 7;
+        if (!(byte & 0x80))
+            break;
+    }
+    return static_cast<u32>(value);
+}
+
+static ErrorOr<void> encode_integer(ByteBuffer& buffer, u32 value, u8 prefix_bits, u8 flags)
+{
+    u32 max_prefix_value = (1u << prefix_bits) - 1;
+    if (value < max_prefix_value)
+        return buffer.try_append(static_cast<u8>(flags | value));
+
+    TRY(buffer.try_append(static_cast<u8>(flags | max_prefix_value)));
+    value -= max_prefix_value;
+    while (value >= 0x80) {
+        TRY(buffer.try_append(static_cast<u8>((value & 0x7f) | 0x80)));
+        value >>= 7;
+    }
+    return buffer.try_append(static_cast<u8>(value));
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+static ErrorOr<String> decode_string(ReadonlyBytes data, size_t& offset)
+{
+    if (offset >= data.size())
+        return Error::from_string_literal("HPACK: Unexpected end of header block");
+
+    bool is_huffman_encoded = data[offset] & 0x80;
+    auto length = TRY(decode_integer(data, offset, 7));
+    if (length > data.size() - offset)
+        return Error::from_string_literal("HPACK: String literal exceeds header block");
+
+    auto bytes = data.slice(offset, length);
+    offset += length;
+    if (is_huffman_encoded)
+        return huffman_decode(bytes);
+    return String { bytes };
+}
+
+static ErrorOr<void> encode_string(ByteBuffer& buffer, StringView string)
+{
+    if (auto huffman_length = huffman_encoded_length(string); huffman_length < string.length()) {
+        TRY(encode_integer(buffer, huffman_length, 7, 0x80));
+        return buffer.try_append(TRY(huffman_encode(string)));
+    }
+    TRY(encode_integer(buffer, string.length(), 7, 0));
+    return buffer.try_append(string.bytes());
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-4.1
+static size_t entry_size(Header const& header)
+{
+    return header.name.length() + header.value.length() + 32;
+}
+
+Header const* DynamicTable::get(size_t index) const
+{
+    if (index == 0 || index > m_entries.size())
+        return nullptr;
+    return &m_entries[m_entries.size() - index];
+}
+
+void DynamicTable::add(Header header)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#section-4.4
+    // "an attempt to add an entry larger than the maximum size causes the table to be emptied of all existing entries and results in an empty table."
+    auto size = entry_size(header);
+    if (size > m_max_size) {
+        evict_to_fit(0);
+        return;
+    }
+    evict_to_fit(m_max_size - size);
+    m_entries.append(move(header));
+    m_size += size;
+}
+
+void DynamicTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_to_fit(max_size);
+}
+
+void DynamicTable::evict_to_fit(size_t target_size)
+{
+    size_t evicted_count = 0;
+    while (m_size > target_size) {
+        m_size -= entry_size(m_entries[evicted_count]);
+        ++evicted_count;
+    }
+    m_entries.remove(0, evicted_count);
+}
+
+ErrorOr<Header> Decoder::header_at(size_t index) const
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#section-2.3.3
+    if (index == 0)
+        return Error::from_string_literal("HPACK: Index 0 is not a valid table index");
+    if (index <= static_table_size)
+        return Header { static_table[index - 1].name, static_table[index - 1].value };
+    if (auto const* header = m_dynamic_table.get(index - static_table_size))
+        return *header;
+    return Error::from_string_literal("HPACK: Table index out of range");
+}
+
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes data)
+{
+    Vector<Header> headers;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        auto byte = data[offset];
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.1
+        if (byte & 0x80) {
+            auto index = TRY(decode_integer(data, offset, 7));
+            TRY(headers.try_append(TRY(header_at(index))));
+            continue;
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.3
+        if ((byte & 0xe0) == 0x20) {
+            // "This dynamic table size update MUST occur at the beginning of the first header block following the change to the dynamic table size."
+            if (!headers.is_empty())
+                return Error::from_string_literal("HPACK: Dynamic table size update after a header field");
+            auto max_size = TRY(decode_integer(data, offset, 5));
+            if (max_size > m_max_dynamic_table_size_limit)
+                return Error::from_string_literal("HPACK: Dynamic table size update exceeds the limit");
+            m_dynamic_table.set_max_size(max_size);
+            continue;
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.2
+        // With incremental indexing (01), without indexing (0000) or never indexed (0001).
+        bool add_to_dynamic_table = (byte & 0xc0) == 0x40;
+        auto index = TRY(decode_integer(data, offset, add_to_dynamic_table ? 6 : 4));
+        Header header;
+        if (index == 0)
+            header.name = TRY(decode_string(data, offset));
+        else
+            header.name = TRY(header_at(index)).name;
+        header.value = TRY(decode_string(data, offset));
+
+        if (add_to_dynamic_table)
+            m_dynamic_table.add(header);
+        TRY(headers.try_append(move(header)));
+    }
+    return headers;
+}
+
+ErrorOr<ByteBuffer> Encoder::encode(Vector<Header> const& headers) const
+{
+    ByteBuffer buffer;
+    for (auto& header : headers) {
+        Optional<size_t> name_index;
+        Optional<size_t> index;
+        for (size_t i = 0; i < static_table_size; ++i) {
+            if (static_table[i].name != header.name)
+                continue;
+            if (!name_index.has_value())
+                name_index = i + 1;
+            if (static_table[i].value == header.value) {
+                index = i + 1;
+                break;
+            }
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.1
+        if (index.has_value()) {
+            TRY(encode_integer(buffer, *index, 7, 0x80));
+            continue;
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.2.2 and section-6.2.3
+        // NOTE: Credentials are sent as "never indexed", so that intermediaries don't put them in a table either.
+        bool is_sensitive = header.name.is_one_of("authorization"sv, "cookie"sv, "proxy-authorization"sv);
+        TRY(encode_integer(buffer, name_index.value_or(0), 4, is_sensitive ? 0x10 : 0x00));
+        if (!name_index.has_value())
+            TRY(encode_string(buffer, header.name));
+        TRY(encode_string(buffer, header.value));
+    }
+    return buffer;
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// HPACK: Header Compression for HTTP/2
+// https://www.rfc-editor.org/rfc/rfc7541
+
+namespace HTTP::HPack {
+
+struct Header {
+    String name;
+    String value;
+
+    bool operator==(Header const&) const = default;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-2.3.2
+class DynamicTable {
+public:
+    static constexpr size_t default_max_size = 4096;
+
+    Header const* get(size_t index) const;
+    void add(Header);
+    void set_max_size(size_t);
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+private:
+    void evict_to_fit(size_t);
+
+    // NOTE: The newest entry is at the back, i.e. index 1 refers to the last element.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { default_max_size };
+};
+
+class Decoder {
+public:
+    // Decodes one complete header block (i.e. a HEADERS frame plus its CONTINUATION frames).
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes);
+
+    // The upper bound for the dynamic table size, as advertised to the peer (SETTINGS_HEADER_TABLE_SIZE).
+    void set_max_dynamic_table_size_limit(size_t limit) { m_max_dynamic_table_size_limit = limit; }
+
+private:
+    ErrorOr<Header> header_at(size_t index) const;
+
+    DynamicTable m_dynamic_table;
+    size_t m_max_dynamic_table_size_limit { DynamicTable::default_max_size };
+};
+
+// NOTE: The encoder never adds to the dynamic table, so it doesn't need to track the peer's.
+//       Names are expected to be lowercase, as HTTP/2 requires.
+class Encoder {
+public:
+    ErrorOr<ByteBuffer> encode(Vector<Header> const&) const;
+};
+
+ErrorOr<String> huffman_decode(ReadonlyBytes);
+ErrorOr<ByteBuffer> huffman_encode(StringView);
+size_t huffman_encoded_length(StringView);
+
+}
@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/StringBuilder.h>
+#include <AK/URL.h>
+#include <LibCore/EventLoop.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+namespace Flags {
+static constexpr u8 EndStream = 0x1;
+static constexpr u8 Ack = 0x1;
+static constexpr u8 EndHeaders = 0x4;
+static constexpr u8 Padded = 0x8;
+static constexpr u8 Priority = 0x20;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.5.2
+enum class SettingsParameter : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+static constexpr size_t frame_header_size = 9;
+// NOTE: We don't raise SETTINGS_MAX_FRAME_SIZE, so this is the largest frame the peer may send us.
+static constexpr u32 max_received_frame_size = 16384;
+static constexpr u32 max_window_size = 0x7fffffff;
+static constexpr u32 max_stream_id = 0x7fffffff;
+static constexpr u32 default_window_size = 65535;
+// The stream clients buffer whatever they receive, so we can hand out generous windows and replenish them right away.
+static constexpr u32 stream_receive_window = 1 * MiB;
+static constexpr u32 connection_receive_window = 16 * MiB;
+static constexpr size_t max_header_block_size = 256 * KiB;
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (static_cast<u32>(bytes[0]) << 24) | (static_cast<u32>(bytes[1]) << 16) | (static_cast<u32>(bytes[2]) << 8) | bytes[3];
+}
+
+static void write_u32(Bytes bytes, u32 value)
+{
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.1
+static Optional<ReadonlyBytes> remove_padding(u8 flags, ReadonlyBytes payload)
+{
+    if (!(flags & Flags::Padded))
+        return payload;
+    if (payload.is_empty())
+        return {};
+    // "If the length of the padding is the length of the frame payload or greater, the recipient MUST treat this as a connection error of type PROTOCOL_ERROR."
+    size_t padding_length = payload[0];
+    if (padding_length >= payload.size())
+        return {};
+    return payload.slice(1, payload.size() - 1 - padding_length);
+}
+
+ErrorOr<NonnullRefPtr<Http2Connection>> Http2Connection::try_create(Core::Stream::BufferedSocketBase& socket)
+{
+    auto connection = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Http2Connection(socket)));
+    TRY(connection->send_connection_preface());
+
+    // The server's preface may have arrived along with the end of the TLS handshake, so we might not be told about it.
+    Core::deferred_invoke([weak_connection = connection->make_weak_ptr()] {
+        if (weak_connection)
+            const_cast<Http2Connection&>(*weak_connection).read_from_socket();
+    });
+    return connection;
+}
+
+Http2Connection::Http2Connection(Core::Stream::BufferedSocketBase& socket)
+    : m_socket(socket)
+{
+    m_socket.on_ready_to_read = [this] {
+        read_from_socket();
+    };
+}
+
+Http2Connection::~Http2Connection()
+{
+    m_socket.on_ready_to_read = nullptr;
+}
+
+bool Http2Connection::can_open_stream() const
+{
+    return is_open() && m_next_stream_id <= max_stream_id && m_streams.size() < m_peer_max_concurrent_streams;
+}
+
+ErrorOr<u32> Http2Connection::open_stream(HttpRequest const& request, Http2StreamClient& client)
+{
+    if (!can_open_stream())
+        return Error::from_string_literal("Cannot open another stream on this HTTP/2 connection");
+
+    auto const& url = request.url();
+    StringBuilder path_builder;
+    path_builder.append(URL::percent_encode(url.path(), URL::PercentEncodeSet::EncodeURI));
+    if (!url.query().is_empty()) {
+        path_builder.append('?');
+        path_builder.append(url.query());
+    }
+    StringBuilder authority_builder;
+    authority_builder.append(url.host());
+    if (url.port().has_value())
+        authority_builder.appendff(":{}", *url.port());
+
+    // https://www.rfc-editor.org/rfc/rfc9113#section-8.3.1
+    Vector<HPack::Header> headers;
+    headers.append({ ":method", request.method_name() });
+    headers.append({ ":scheme", url.scheme() });
+    headers.append({ ":authority", authority_builder.to_string() });
+    headers.append({ ":path", path_builder.to_string() });
+    for (auto& header : request.headers()) {
+        // https://www.rfc-editor.org/rfc/rfc9113#section-8.2.2
+        // "An endpoint MUST NOT generate an HTTP/2 message containing connection-specific header fields."
+        // NOTE: Host is superseded by :authority.
+        if (header.name.is_one_of_ignoring_case("Connection"sv, "Keep-Alive"sv, "Proxy-Connection"sv, "Transfer-Encoding"sv, "Upgrade"sv, "Host"sv))
+            continue;
+        // "The only exception to this is the TE header field, which MAY be present in an HTTP/2 request; when it is, it MUST NOT contain any value other than "trailers"."
+        if (header.name.equals_ignoring_case("TE"sv) && !header.value.equals_ignoring_case("trailers"sv))
+            continue;
+        headers.append({ header.name.to_lowercase(), header.value });
+    }
+    auto has_body = !request.body().is_empty();
+    if (has_body)
+        headers.append({ "content-length", String::number(request.body().size()) });
+
+    auto header_block = TRY(m_encoder.encode(headers));
+
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+
+    auto stream = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Stream));
+    stream->id = stream_id;
+    stream->client = &client;
+    stream->send_window = m_peer_initial_window_size;
+    stream->is_local_closed = !has_body;
+    if (has_body)
+        stream->pending_body = TRY(ByteBuffer::copy(request.body()));
+    m_streams.set(stream_id, move(stream));
+
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Opening stream {} for {} {}", stream_id, request.method_name(), url);
+
+    auto result = send_header_block(stream_id, header_block, !has_body);
+    if (!result.is_error() && has_body)
+        result = send_pending_body(*m_streams.get(stream_id).value());
+    if (result.is_error()) {
+        // NOTE: The caller learns about the failure from our return value, so don't notify the client as well.
+        m_streams.remove(stream_id);
+        fail_connection(ErrorCode::InternalError);
+        return result.release_error();
+    }
+    return stream_id;
+}
+
+void Http2Connection::close_stream(u32 stream_id)
+{
+    if (!m_streams.contains(stream_id))
+        return;
+
+    // NOTE: Streams that have completed in both directions are gone already, so this one is being cancelled.
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Cancelling stream {}", stream_id);
+    if (!m_is_closed) {
+        u8 payload[4];
+        write_u32({ payload, sizeof(payload) }, to_underlying(ErrorCode::Cancel));
+        (void)send_frame(FrameType::RstStream, 0, stream_id, { payload, sizeof(payload) });
+    }
+    remove_stream(stream_id);
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-3.4
+ErrorOr<void> Http2Connection::send_connection_preface()
+{
+    if (!m_socket.write_or_error("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv.bytes()))
+        return Error::from_string_literal("Failed to write the HTTP/2 connection preface");
+
+    u8 settings[12];
+    auto append_setting = [&](size_t offset, SettingsParameter parameter, u32 value) {
+        settings[offset] = to_underlying(parameter) >> 8;
+        settings[offset + 1] = to_underlying(parameter) & 0xff;
+        write_u32({ settings + offset + 2, 4 }, value);
+    };
+    // We don't have any use for server push.
+    append_setting(0, SettingsParameter::EnablePush, 0);
+    append_setting(6, SettingsParameter::InitialWindowSize, stream_receive_window);
+    TRY(send_frame(FrameType::Settings, 0, 0, { settings, sizeof(settings) }));
+
+    // The initial connection window can only be changed with a WINDOW_UPDATE.
+    return send_window_update(0, connection_receive_window - default_window_size);
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-4.1
+ErrorOr<void> Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    VERIFY(payload.size() <= 0xffffff);
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Sending frame of type {} with flags {:#x} on stream {} ({} bytes)", to_underlying(type), flags, stream_id, payload.size());
+
+    auto frame = TRY(ByteBuffer::create_uninitialized(frame_header_size + payload.size()));
+    frame[0] = payload.size() >> 16;
+    frame[1] = payload.size() >> 8;
+    frame[2] = payload.size();
+    frame[3] = to_underlying(type);
+    frame[4] = flags;
+    write_u32(frame.bytes().slice(5, 4), stream_id & max_stream_id);
+    if (!payload.is_empty())
+        frame.overwrite(frame_header_size, payload.data(), payload.size());
+
+    // NOTE: Write the whole frame at once, so that it doesn't end up split over several TLS records.
+    if (!m_socket.write_or_error(frame))
+        return Error::from_string_literal("Failed to write an HTTP/2 frame");
+    return {};
+}
+
+ErrorOr<void> Http2Connection::send_header_block(u32 stream_id, ReadonlyBytes block, bool end_stream)
+{
+    // https://www.rfc-editor.org/rfc/rfc9113#section-4.3
+    // "Each field block is transmitted as a contiguous sequence of frames, with no interleaved frames of any other type or from any other stream."
+    auto first_fragment = block.slice(0, min<size_t>(block.size(), m_peer_max_frame_size));
+    u8 flags = end_stream ? Flags::EndStream : 0;
+    if (first_fragment.size() == block.size())
+        flags |= Flags::EndHeaders;
+    TRY(send_frame(FrameType::Headers, flags, stream_id, first_fragment));
+
+    for (size_t offset = first_fragment.size(); offset < block.size();) {
+        auto fragment = block.slice(offset, min<size_t>(block.size() - offset, m_peer_max_frame_size));
+        offset += fragment.size();
+        TRY(send_frame(FrameType::Continuation, offset == block.size() ? Flags::EndHeaders : 0, stream_id, fragment));
+    }
+    return {};
+}
+
+ErrorOr<void> Http2Connection::send_window_update(u32 stream_id, u32 increment)
+{
+    u8 payload[4];
+    write_u32({ payload, sizeof(payload) }, increment);
+    return send_frame(FrameType::WindowUpdate, 0, stream_id, { payload, sizeof(payload) });
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-5.2
+ErrorOr<void> Http2Connection::send_pending_body(Stream& stream)
+{
+    if (stream.is_local_closed)
+        return {};
+
+    while (stream.pending_body_offset < stream.pending_body.size()) {
+        auto window = min(stream.send_window, m_connection_send_window);
+        if (window <= 0) {
+            dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} is blocked by flow control", stream.id);
+            return {};
+        }
+        auto remaining = stream.pending_body.size() - stream.pending_body_offset;
+        auto size = min(min(remaining, static_cast<size_t>(window)), static_cast<size_t>(m_peer_max_frame_size));
+        auto is_last = size == remaining;
+        TRY(send_frame(FrameType::Data, is_last ? Flags::EndStream : 0, stream.id, stream.pending_body.bytes().slice(stream.pending_body_offset, size)));
+        stream.pending_body_offset += size;
+        stream.send_window -= size;
+        m_connection_send_window -= size;
+    }
+
+    stream.pending_body.clear();
+    stream.pending_body_offset = 0;
+    stream.is_local_closed = true;
+    close_stream_if_done(stream.id);
+    return {};
+}
+
+ErrorOr<void> Http2Connection::send_pending_bodies()
+{
+    Vector<u32> stream_ids;
+    for (auto& it : m_streams) {
+        if (!it.value->is_local_closed)
+            stream_ids.append(it.key);
+    }
+    for (auto stream_id : stream_ids) {
+        if (m_connection_send_window <= 0)
+            break;
+        if (auto stream = m_streams.get(stream_id); stream.has_value())
+            TRY(send_pending_body(*stream.value()));
+    }
+    return {};
+}
+
+void Http2Connection::read_from_socket()
+{
+    // NOTE: Stream clients may let go of the last reference to us while we're handling their frames.
+    NonnullRefPtr<Http2Connection> protector { *this };
+
+    u8 buffer[16 * KiB];
+    while (!m_is_closed) {
+        auto can_read_without_blocking = m_socket.can_read_without_blocking();
+        if (can_read_without_blocking.is_error())
+            return fail_connection(ErrorCode::InternalError);
+        if (!can_read_without_blocking.value())
+            break;
+
+        auto result = m_socket.read({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            dbgln_if(HTTP2_DEBUG, "Http2Connection: Failed to read from the socket: {}", result.error());
+            return fail_connection(ErrorCode::InternalError);
+        }
+        auto bytes = result.release_value();
+        if (bytes.is_empty())
+            break;
+        if (m_read_buffer.try_append(bytes).is_error())
+            return fail_connection(ErrorCode::InternalError);
+    }
+
+    size_t offset = 0;
+    while (!m_is_closed && m_read_buffer.size() - offset >= frame_header_size) {
+        auto header = m_read_buffer.bytes().slice(offset, frame_header_size);
+        u32 length = (header[0] << 16) | (header[1] << 8) | header[2];
+        // https://www.rfc-editor.org/rfc/rfc9113#section-4.2
+        // "An endpoint MUST send an error code of FRAME_SIZE_ERROR if a frame exceeds the size defined in SETTINGS_MAX_FRAME_SIZE"
+        if (length > max_received_frame_size)
+            return fail_connection(ErrorCode::FrameSizeError);
+        if (m_read_buffer.size() - offset - frame_header_size < length)
+            break;
+
+        auto type = static_cast<FrameType>(header[3]);
+        auto flags = header[4];
+        auto stream_id = read_u32(header.slice(5)) & max_stream_id;
+        auto payload = m_read_buffer.bytes().slice(offset + frame_header_size, length);
+        offset += frame_header_size + length;
+
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame of type {} with flags {:#x} on stream {} ({} bytes)", to_underlying(type), flags, stream_id, length);
+        if (auto result = handle_frame(type, flags, stream_id, payload); result.is_error()) {
+            dbgln("Http2Connection: {}", result.error());
+            return fail_connection(m_connection_error_code.value_or(ErrorCode::InternalError));
+        }
+    }
+
+    if (m_is_closed)
+        return;
+
+    if (offset > 0) {
+        auto remaining = m_read_buffer.size() - offset;
+        if (remaining > 0)
+            memmove(m_read_buffer.data(), m_read_buffer.data() + offset, remaining);
+        m_read_buffer.resize(remaining);
+    }
+
+    if (m_socket.is_eof() || !m_socket.is_open()) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Connection closed by the peer");
+        fail_connection(ErrorCode::NoError);
+    }
+}
+
+Error Http2Connection::connection_error(ErrorCode code, StringView reason)
+{
+    m_connection_error_code = code;
+    return Error::from_string_view(reason);
+}
+
+ErrorOr<void> Http2Connection::handle_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_header_block_stream_id.has_value() && type != FrameType::Continuation)
+        return connection_error(ErrorCode::ProtocolError, "Expected a CONTINUATION frame"sv);
+
+    switch (type) {
+    case FrameType::Data:
+        return handle_data(flags, stream_id, payload);
+    case FrameType::Headers:
+        return handle_headers(flags, stream_id, payload);
+    case FrameType::Priority:
+        // NOTE: We don't prioritize anything, so there's nothing to do with these.
+        return {};
+    case FrameType::RstStream:
+        return handle_rst_stream(stream_id, payload);
+    case FrameType::Settings:
+        return handle_settings(flags, stream_id, payload);
+    case FrameType::PushPromise:
+        // "A client cannot push. Thus, servers MUST treat the receipt of a PUSH_PROMISE frame as a connection error of type PROTOCOL_ERROR."
+        // We've disabled push, so the same goes for us.
+        return connection_error(ErrorCode::ProtocolError, "Received a PUSH_PROMISE even though push is disabled"sv);
+    case FrameType::Ping:
+        return handle_ping(flags, stream_id, payload);
+    case FrameType::GoAway:
+        return handle_goaway(stream_id, payload);
+    case FrameType::WindowUpdate:
+        return handle_window_update(stream_id, payload);
+    case FrameType::Continuation:
+        return handle_continuation(flags, stream_id, payload);
+    }
+
+    // "Implementations MUST ignore and discard frames of unknown types."
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.1
+ErrorOr<void> Http2Connection::handle_data(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a DATA frame for stream 0"sv);
+
+    // NOTE: Flow control covers the entire payload, padding included.
+    m_unacknowledged_received_size += payload.size();
+    if (m_unacknowledged_received_size > connection_receive_window)
+        return connection_error(ErrorCode::FlowControlError, "Peer exceeded the connection flow-control window"sv);
+    if (m_unacknowledged_received_size >= connection_receive_window / 2) {
+        TRY(send_window_update(0, m_unacknowledged_received_size));
+        m_unacknowledged_received_size = 0;
+    }
+
+    auto data = remove_padding(flags, payload);
+    if (!data.has_value())
+        return connection_error(ErrorCode::ProtocolError, "Invalid padding in a DATA frame"sv);
+
+    auto stream = m_streams.get(stream_id);
+    if (!stream.has_value()) {
+        if (stream_id % 2 == 0 || stream_id >= m_next_stream_id)
+            return connection_error(ErrorCode::ProtocolError, "Received a DATA frame for an idle stream"sv);
+        // We've closed this stream already, so we don't care for its data anymore.
+        return {};
+    }
+    if (stream.value()->is_remote_closed) {
+        reset_stream(stream_id, ErrorCode::StreamClosed);
+        return {};
+    }
+
+    bool end_stream = flags & Flags::EndStream;
+    stream.value()->unacknowledged_received_size += payload.size();
+    if (stream.value()->unacknowledged_received_size > stream_receive_window) {
+        reset_stream(stream_id, ErrorCode::FlowControlError);
+        return {};
+    }
+    if (!end_stream && stream.value()->unacknowledged_received_size >= stream_receive_window / 2) {
+        TRY(send_window_update(stream_id, stream.value()->unacknowledged_received_size));
+        stream.value()->unacknowledged_received_size = 0;
+    }
+
+    if (end_stream)
+        stream.value()->is_remote_closed = true;
+    stream.value()->client->did_receive_http2_data(*data, end_stream);
+    if (end_stream)
+        close_stream_if_done(stream_id);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.2
+ErrorOr<void> Http2Connection::handle_headers(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a HEADERS frame for stream 0"sv);
+
+    auto fragment = remove_padding(flags, payload);
+    if (!fragment.has_value())
+        return connection_error(ErrorCode::ProtocolError, "Invalid padding in a HEADERS frame"sv);
+    if (flags & Flags::Priority) {
+        // NOTE: The stream dependency and weight are of no interest to us.
+        if (fragment->size() < 5)
+            return connection_error(ErrorCode::FrameSizeError, "HEADERS frame is too short for its priority fields"sv);
+        fragment = fragment->slice(5);
+    }
+
+    m_header_block.clear();
+    TRY(m_header_block.try_append(*fragment));
+    m_header_block_stream_id = stream_id;
+    m_header_block_ends_stream = flags & Flags::EndStream;
+
+    if (flags & Flags::EndHeaders)
+        return handle_header_block_end();
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.10
+ErrorOr<void> Http2Connection::handle_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (!m_header_block_stream_id.has_value() || *m_header_block_stream_id != stream_id)
+        return connection_error(ErrorCode::ProtocolError, "Unexpected CONTINUATION frame"sv);
+    if (m_header_block.size() + payload.size() > max_header_block_size)
+        return connection_error(ErrorCode::EnhanceYourCalm, "Header block is too large"sv);
+
+    TRY(m_header_block.try_append(payload));
+    if (flags & Flags::EndHeaders)
+        return handle_header_block_end();
+    return {};
+}
+
+ErrorOr<void> Http2Connection::handle_header_block_end()
+{
+    auto stream_id = m_header_block_stream_id.release_value();
+    auto end_stream = m_header_block_ends_stream;
+    auto block = move(m_header_block);
+
+    // NOTE: Header blocks have to be decoded even if we don't care about the stream anymore, to keep the dynamic table in sync.
+    auto headers = m_decoder.decode(block);
+    if (headers.is_error())
+        return connection_error(ErrorCode::CompressionError, "Failed to decode a header block"sv);
+
+    auto stream = m_streams.get(stream_id);
+    if (!stream.has_value()) {
+        if (stream_id % 2 == 0 || stream_id >= m_next_stream_id)
+            return connection_error(ErrorCode::ProtocolError, "Received a HEADERS frame for an idle stream"sv);
+        return {};
+    }
+    if (stream.value()->is_remote_closed) {
+        reset_stream(stream_id, ErrorCode::StreamClosed);
+        return {};
+    }
+
+    if (end_stream)
+        stream.value()->is_remote_closed = true;
+    stream.value()->client->did_receive_http2_headers(headers.value(), end_stream);
+    if (end_stream)
+        close_stream_if_done(stream_id);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.4
+ErrorOr<void> Http2Connection::handle_rst_stream(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a RST_STREAM frame for stream 0"sv);
+    if (payload.size() != 4)
+        return connection_error(ErrorCode::FrameSizeError, "RST_STREAM frame has the wrong size"sv);
+
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} was reset with error code {}", stream_id, read_u32(payload));
+    fail_stream(stream_id);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.5
+ErrorOr<void> Http2Connection::handle_settings(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a SETTINGS frame for a stream"sv);
+    if (flags & Flags::Ack) {
+        if (!payload.is_empty())
+            return connection_error(ErrorCode::FrameSizeError, "SETTINGS acknowledgement has a payload"sv);
+        return {};
+    }
+    if (payload.size() % 6 != 0)
+        return connection_error(ErrorCode::FrameSizeError, "SETTINGS frame has the wrong size"sv);
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto parameter = static_cast<SettingsParameter>((payload[offset] << 8) | payload[offset + 1]);
+        auto value = read_u32(payload.slice(offset + 2, 4));
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Peer setting {} = {}", to_underlying(parameter), value);
+
+        switch (parameter) {
+        case SettingsParameter::HeaderTableSize:
+            // Our encoder doesn't use the dynamic table, so it can't get any smaller.
+            break;
+        case SettingsParameter::EnablePush:
+            if (value > 1)
+                return connection_error(ErrorCode::ProtocolError, "Invalid SETTINGS_ENABLE_PUSH value"sv);
+            break;
+        case SettingsParameter::MaxConcurrentStreams:
+            m_peer_max_concurrent_streams = value;
+            break;
+        case SettingsParameter::InitialWindowSize: {
+            if (value > max_window_size)
+                return connection_error(ErrorCode::FlowControlError, "Invalid SETTINGS_INITIAL_WINDOW_SIZE value"sv);
+            // "When the value of SETTINGS_INITIAL_WINDOW_SIZE changes, a receiver MUST adjust the size of all stream flow-control windows that it maintains by the difference between the new value and the old value."
+            auto delta = static_cast<i64>(value) - static_cast<i64>(m_peer_initial_window_size);
+            for (auto& it : m_streams) {
+                it.value->send_window += delta;
+                if (it.value->send_window > max_window_size)
+                    return connection_error(ErrorCode::FlowControlError, "SETTINGS_INITIAL_WINDOW_SIZE overflows a stream window"sv);
+            }
+            m_peer_initial_window_size = value;
+            break;
+        }
+        case SettingsParameter::MaxFrameSize:
+            if (value < 16384 || value > 0xffffff)
+                return connection_error(ErrorCode::ProtocolError, "Invalid SETTINGS_MAX_FRAME_SIZE value"sv);
+            m_peer_max_frame_size = value;
+            break;
+        case SettingsParameter::MaxHeaderListSize:
+        default:
+            // "An endpoint that receives a SETTINGS frame with any unknown or unsupported identifier MUST ignore that setting."
+            break;
+        }
+    }
+
+    TRY(send_frame(FrameType::Settings, Flags::Ack, 0, {}));
+
+    // A larger window may let us send more of the request bodies.
+    return send_pending_bodies();
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.7
+ErrorOr<void> Http2Connection::handle_ping(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a PING frame for a stream"sv);
+    if (payload.size() != 8)
+        return connection_error(ErrorCode::FrameSizeError, "PING frame has the wrong size"sv);
+    if (flags & Flags::Ack)
+        return {};
+    return send_frame(FrameType::Ping, Flags::Ack, 0, payload);
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.8
+ErrorOr<void> Http2Connection::handle_goaway(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError, "Received a GOAWAY frame for a stream"sv);
+    if (payload.size() < 8)
+        return connection_error(ErrorCode::FrameSizeError, "GOAWAY frame is too short"sv);
+
+    auto last_stream_id = read_u32(payload) & max_stream_id;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Received GOAWAY with last stream {} and error code {}", last_stream_id, read_u32(payload.slice(4)));
+    m_received_goaway = true;
+
+    // Streams after the last one weren't processed by the server, so they're not going to get a response.
+    Vector<u32> unprocessed_stream_ids;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            unprocessed_stream_ids.append(it.key);
+    }
+    for (auto unprocessed_stream_id : unprocessed_stream_ids)
+        fail_stream(unprocessed_stream_id);
+
+    if (m_streams.is_empty())
+        fail_connection(ErrorCode::NoError);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.9
+ErrorOr<void> Http2Connection::handle_window_update(u32 stream_id, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return connection_error(ErrorCode::FrameSizeError, "WINDOW_UPDATE frame has the wrong size"sv);
+
+    auto increment = read_u32(payload) & max_window_size;
+    if (stream_id == 0) {
+        if (increment == 0)
+            return connection_error(ErrorCode::ProtocolError, "WINDOW_UPDATE with a zero increment"sv);
+        m_connection_send_window += increment;
+        if (m_connection_send_window > max_window_size)
+            return connection_error(ErrorCode::FlowControlError, "WINDOW_UPDATE overflows the connection window"sv);
+        return send_pending_bodies();
+    }
+
+    auto stream = m_streams.get(stream_id);
+    if (!stream.has_value())
+        return {};
+    if (increment == 0) {
+        reset_stream(stream_id, ErrorCode::ProtocolError);
+        return {};
+    }
+    stream.value()->send_window += increment;
+    if (stream.value()->send_window > max_window_size) {
+        reset_stream(stream_id, ErrorCode::FlowControlError);
+        return {};
+    }
+    return send_pending_body(*stream.value());
+}
+
+void Http2Connection::reset_stream(u32 stream_id, ErrorCode error_code)
+{
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Resetting stream {} with error code {}", stream_id, to_underlying(error_code));
+    u8 payload[4];
+    write_u32({ payload, sizeof(payload) }, to_underlying(error_code));
+    (void)send_frame(FrameType::RstStream, 0, stream_id, { payload, sizeof(payload) });
+    fail_stream(stream_id);
+}
+
+void Http2Connection::fail_stream(u32 stream_id)
+{
+    auto stream = m_streams.get(stream_id);
+    if (!stream.has_value())
+        return;
+    // NOTE: If we already have the complete response, the client doesn't need to hear about the rest.
+    auto* client = stream.value()->is_remote_closed ? nullptr : stream.value()->client;
+    remove_stream(stream_id);
+    if (client)
+        client->did_fail_http2_stream();
+}
+
+void Http2Connection::close_stream_if_done(u32 stream_id)
+{
+    auto stream = m_streams.get(stream_id);
+    if (!stream.has_value() || !stream.value()->is_local_closed || !stream.value()->is_remote_closed)
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} is done", stream_id);
+    remove_stream(stream_id);
+}
+
+void Http2Connection::remove_stream(u32 stream_id)
+{
+    m_streams.remove(stream_id);
+    Core::deferred_invoke([weak_this = make_weak_ptr()] {
+        if (weak_this && weak_this->on_stream_closed)
+            weak_this->on_stream_closed();
+    });
+
+    if (m_received_goaway && m_streams.is_empty())
+        fail_connection(ErrorCode::NoError);
+}
+
+void Http2Connection::fail_connection(ErrorCode error_code)
+{
+    if (m_is_closed)
+        return;
+    m_is_closed = true;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Closing connection with error code {}", to_underlying(error_code));
+
+    // https://www.rfc-editor.org/rfc/rfc9113#section-5.4.1
+    // NOTE: We never accept streams from the server, so the last stream identifier is always 0.
+    u8 payload[8] {};
+    write_u32({ payload + 4, 4 }, to_underlying(error_code));
+    (void)send_frame(FrameType::GoAway, 0, 0, { payload, sizeof(payload) });
+    m_socket.on_ready_to_read = nullptr;
+    m_socket.close();
+
+    auto streams = move(m_streams);
+    for (auto& it : streams) {
+        if (!it.value->is_remote_closed)
+            it.value->client->did_fail_http2_stream();
+    }
+
+    Core::deferred_invoke([weak_this = make_weak_ptr()] {
+        if (weak_this && weak_this->on_close)
+            weak_this->on_close();
+    });
+}
+
+}
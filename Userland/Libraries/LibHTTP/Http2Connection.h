@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+#include <AK/Weakable.h>
+#include <LibCore/Stream.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/HttpRequest.h>
+
+// HTTP/2, as specified by RFC 9113.
+// https://www.rfc-editor.org/rfc/rfc9113
+
+namespace HTTP {
+
+// Receives the response for one stream of an Http2Connection.
+// NOTE: None of these are called anymore once the stream has been closed with Http2Connection::close_stream().
+class Http2StreamClient {
+public:
+    virtual ~Http2StreamClient() = default;
+
+    virtual void did_receive_http2_headers(Vector<HPack::Header> const&, bool end_stream) = 0;
+    virtual void did_receive_http2_data(ReadonlyBytes, bool end_stream) = 0;
+    virtual void did_fail_http2_stream() = 0;
+};
+
+// The client side of an HTTP/2 connection, multiplexing any number of requests over one socket.
+// The socket is expected to have negotiated "h2" (via ALPN), and must outlive the connection.
+class Http2Connection
+    : public RefCounted<Http2Connection>
+    , public Weakable<Http2Connection> {
+public:
+    static ErrorOr<NonnullRefPtr<Http2Connection>> try_create(Core::Stream::BufferedSocketBase&);
+    ~Http2Connection();
+
+    // Sends the request on a new stream; the response is reported to the client.
+    ErrorOr<u32> open_stream(HttpRequest const&, Http2StreamClient&);
+    // Forgets about a stream, cancelling it if it's still in progress.
+    void close_stream(u32 stream_id);
+
+    // Whether the connection is still accepting new streams, i.e. it's neither closed nor going away.
+    bool is_open() const { return !m_is_closed && !m_received_goaway; }
+    // Whether another stream may be opened now, as per the peer's SETTINGS_MAX_CONCURRENT_STREAMS.
+    bool can_open_stream() const;
+    size_t active_stream_count() const { return m_streams.size(); }
+
+    // Called (deferred) whenever a stream goes away, to give queued requests a chance to go out.
+    Function<void()> on_stream_closed;
+    // Called (deferred) once the connection can't be used anymore, after a GOAWAY or a connection error.
+    Function<void()> on_close;
+
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        RstStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    // https://www.rfc-editor.org/rfc/rfc9113#section-7
+    enum class ErrorCode : u32 {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeout = 0x4,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+        ConnectError = 0xa,
+        EnhanceYourCalm = 0xb,
+        InadequateSecurity = 0xc,
+        Http11Required = 0xd,
+    };
+
+private:
+    explicit Http2Connection(Core::Stream::BufferedSocketBase&);
+
+    struct Stream {
+        u32 id { 0 };
+        Http2StreamClient* client { nullptr };
+        i64 send_window { 0 };
+        size_t unacknowledged_received_size { 0 };
+        // The part of the request body that's waiting for the send window to open up.
+        ByteBuffer pending_body;
+        size_t pending_body_offset { 0 };
+        bool is_local_closed { false };
+        bool is_remote_closed { false };
+    };
+
+    ErrorOr<void> send_connection_preface();
+    ErrorOr<void> send_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> send_header_block(u32 stream_id, ReadonlyBytes block, bool end_stream);
+    ErrorOr<void> send_window_update(u32 stream_id, u32 increment);
+    ErrorOr<void> send_pending_body(Stream&);
+    ErrorOr<void> send_pending_bodies();
+
+    void read_from_socket();
+    // Records the error code to close the connection with.
+    Error connection_error(ErrorCode, StringView reason);
+    ErrorOr<void> handle_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_data(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_headers(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_header_block_end();
+    ErrorOr<void> handle_rst_stream(u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_settings(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_ping(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_goaway(u32 stream_id, ReadonlyBytes payload);
+    ErrorOr<void> handle_window_update(u32 stream_id, ReadonlyBytes payload);
+
+    void reset_stream(u32 stream_id, ErrorCode);
+    void fail_stream(u32 stream_id);
+    void close_stream_if_done(u32 stream_id);
+    void remove_stream(u32 stream_id);
+    void fail_connection(ErrorCode);
+
+    Core::Stream::BufferedSocketBase& m_socket;
+    ByteBuffer m_read_buffer;
+
+    HashMap<u32, NonnullOwnPtr<Stream>> m_streams;
+    u32 m_next_stream_id { 1 };
+
+    HPack::Decoder m_decoder;
+    HPack::Encoder m_encoder;
+
+    // A header block that spans HEADERS and CONTINUATION frames.
+    ByteBuffer m_header_block;
+    Optional<u32> m_header_block_stream_id;
+    bool m_header_block_ends_stream { false };
+
+    // Values of the peer's settings, as far as they concern us.
+    u32 m_peer_max_concurrent_streams { NumericLimits<u32>::max() };
+    u32 m_peer_initial_window_size { 65535 };
+    u32 m_peer_max_frame_size { 16384 };
+
+    i64 m_connection_send_window { 65535 };
+    size_t m_unacknowledged_received_size { 0 };
+
+    Optional<ErrorCode> m_connection_error_code;
+    bool m_received_goaway { false };
+    bool m_is_closed { false };
+};
+
+}
@@ -110,6 +110,13 @@ Job::Job(HttpRequest&& request, Core::Stream::Stream& output_stream)
 {
 }
 
+Job::~Job()
+{
+    // NOTE: The connection would otherwise keep telling us about a stream we're no longer around for.
+    if (m_http2_stream_id.has_value() && m_http2_connection)
+        m_http2_connection->close_stream(*m_http2_stream_id);
+}
+
 void Job::start(Core::Stream::Socket& socket)
 {
     VERIFY(!m_socket);
@@ -121,8 +128,45 @@ void Job::start(Core::Stream::Socket& socket)
     });
 }
 
+void Job::start(Http2Connection& connection)
+{
+    VERIFY(!m_socket && !m_http2_connection);
+    m_http2_connection = connection;
+    dbgln_if(HTTPJOB_DEBUG, "HttpJob: Starting {} on HTTP/2 connection {}", url(), &connection);
+    auto stream_id = connection.open_stream(m_request, *this);
+    if (stream_id.is_error()) {
+        dbgln_if(HTTPJOB_DEBUG, "HttpJob: Failed to open an HTTP/2 stream: {}", stream_id.error());
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        return;
+    }
+    m_http2_stream_id = stream_id.release_value();
+}
+
+bool Job::send_request_ahead(Core::Stream::Socket& socket)
+{
+    VERIFY(!m_socket);
+    // https://httpwg.org/specs/rfc9112.html#pipelining
+    // "A user agent SHOULD NOT pipeline requests after a non-idempotent method, until the final response status code for that method has been received"
+    // NOTE: We're stricter than that, and only pipeline the idempotent methods that carry no body.
+    if (m_request.method() != HttpRequest::Method::GET && m_request.method() != HttpRequest::Method::HEAD)
+        return false;
+
+    dbgln_if(HTTPJOB_DEBUG, "HttpJob: Sending request for {} ahead", url());
+    if (!socket.write_or_error(m_request.to_raw_request()))
+        return false;
+    m_request_was_sent_ahead = true;
+    return true;
+}
+
 void Job::shutdown(ShutdownMode mode)
 {
+    if (m_http2_stream_id.has_value()) {
+        // NOTE: The connection is shared with other jobs, so only ever close our stream.
+        if (m_http2_connection)
+            m_http2_connection->close_stream(*m_http2_stream_id);
+        m_http2_stream_id = {};
+        return;
+    }
     if (!m_socket)
         return;
     if (mode == ShutdownMode::CloseSocket) {
@@ -188,8 +232,7 @@ void Job::register_on_ready_to_read(Function<void()> callback)
 
 ErrorOr<String> Job::read_line(size_t size)
 {
-    auto buffer = TRY(ByteBuffer::create_uninitialized(size));
-    auto bytes_read = TRY(m_socket->read_until(buffer, "\r\n"sv));
+    auto bytes_read = TRY(m_socket->read_until_in_place("\r\n"sv, size));
     return String::copy(bytes_read);
 }
 
@@ -212,16 +255,28 @@ ErrorOr<ByteBuffer> Job::receive(size_t size)
 
 void Job::on_socket_connected()
 {
-    auto raw_request = m_request.to_raw_request();
+    if (!m_request_was_sent_ahead) {
+        auto raw_request = m_request.to_raw_request();
 
-    if constexpr (JOB_DEBUG) {
-        dbgln("Job: raw_request:");
-        dbgln("{}", String::copy(raw_request));
-    }
+        if constexpr (JOB_DEBUG) {
+            dbgln("Job: raw_request:");
+            dbgln("{}", String::copy(raw_request));
+        }
 
-    bool success = m_socket->write_or_error(raw_request);
-    if (!success)
-        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        bool success = m_socket->write_or_error(raw_request);
+        if (!success)
+            deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+    } else {
+        // The response may have already been read into the socket's buffer along with the previous one,
+        // in which case we won't get notified about it.
+        deferred_invoke([this] {
+            if (!m_socket || !m_socket->on_ready_to_read)
+                return;
+            auto can_read_without_blocking = m_socket->can_read_without_blocking();
+            if (!can_read_without_blocking.is_error() && can_read_without_blocking.value())
+                m_socket->on_ready_to_read();
+        });
+    }
 
     register_on_ready_to_read([&] {
         dbgln_if(JOB_DEBUG, "Ready to read for {}, state = {}, cancelled = {}", m_request.url(), to_underlying(m_state), is_cancelled());
@@ -370,34 +425,7 @@ void Job::on_socket_connected()
                 return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
             }
             auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            if (name.equals_ignoring_case("Set-Cookie"sv)) {
-                dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
-                m_set_cookie_headers.append(move(value));
-
-                auto can_read_without_blocking = m_socket->can_read_without_blocking();
-                if (can_read_without_blocking.is_error())
-                    return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                if (!can_read_without_blocking.value())
-                    return;
-            } else if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
-                StringBuilder builder;
-                builder.append(existing_value.value());
-                builder.append(',');
-                builder.append(value);
-                m_headers.set(name, builder.build());
-            } else {
-                m_headers.set(name, value);
-            }
-            if (name.equals_ignoring_case("Content-Encoding"sv)) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
-            } else if (name.equals_ignoring_case("Content-Length"sv)) {
-                auto length = value.to_uint();
-                if (length.has_value())
-                    m_content_length = length.value();
-            }
-            dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+            add_header(name, move(value));
 
             auto can_read_without_blocking = m_socket->can_read_without_blocking();
             if (can_read_without_blocking.is_error())
@@ -500,6 +528,10 @@ void Job::on_socket_connected()
             if (!can_read_without_blocking.value())
                 break;
 
+            // NOTE: Don't read past the end of the body, whatever follows belongs to the next response on this connection.
+            if (m_content_length.has_value())
+                read_size = min(read_size, static_cast<u64>(m_content_length.value() - min(m_received_size, static_cast<size_t>(m_content_length.value()))));
+
             dbgln_if(JOB_DEBUG, "Waiting for payload for {}", m_request.url());
             auto maybe_payload = receive(read_size);
             if (maybe_payload.is_error()) {
@@ -584,6 +616,114 @@ void Job::on_socket_connected()
     });
 }
 
+void Job::add_header(StringView name, String value)
+{
+    if (name.equals_ignoring_case("Set-Cookie"sv)) {
+        dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
+        m_set_cookie_headers.append(move(value));
+        return;
+    }
+
+    if (name.equals_ignoring_case("Content-Encoding"sv)) {
+        // Assume that any content-encoding means that we can't decode it as a stream :(
+        dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+        m_can_stream_response = false;
+    } else if (name.equals_ignoring_case("Content-Length"sv)) {
+        auto length = value.to_uint();
+        if (length.has_value())
+            m_content_length = length.value();
+    }
+    dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+
+    if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
+        StringBuilder builder;
+        builder.append(existing_value.value());
+        builder.append(',');
+        builder.append(value);
+        m_headers.set(name, builder.build());
+    } else {
+        m_headers.set(name, move(value));
+    }
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-8.3.2
+void Job::did_receive_http2_headers(Vector<HPack::Header> const& headers, bool end_stream)
+{
+    if (is_cancelled() || m_state == State::Finished)
+        return;
+
+    if (m_state == State::InBody) {
+        // These are trailers, which we don't have any use for.
+        if (end_stream)
+            finish_up();
+        return;
+    }
+
+    Optional<u32> status;
+    for (auto& header : headers) {
+        if (header.name == ":status")
+            status = header.value.to_uint();
+    }
+    if (!status.has_value()) {
+        dbgln("Job: HTTP/2 response for {} has no valid :status", m_request.url());
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+    }
+    // NOTE: Informational (1xx) responses are followed by the actual one.
+    if (*status >= 100 && *status < 200)
+        return;
+
+    m_code = *status;
+    for (auto& header : headers) {
+        // NOTE: Pseudo-header fields aren't headers of the response.
+        if (!header.name.starts_with(':'))
+            add_header(header.name, header.value);
+    }
+
+    if (on_headers_received) {
+        if (!m_set_cookie_headers.is_empty())
+            m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_string());
+        on_headers_received(m_headers, m_code);
+    }
+    m_state = State::InBody;
+
+    if (end_stream)
+        finish_up();
+}
+
+void Job::did_receive_http2_data(ReadonlyBytes data, bool end_stream)
+{
+    if (is_cancelled() || m_state == State::Finished)
+        return;
+
+    if (m_state != State::InBody) {
+        dbgln("Job: Received HTTP/2 data before the response headers for {}", m_request.url());
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+    }
+
+    if (!data.is_empty()) {
+        auto buffer = ByteBuffer::copy(data);
+        if (buffer.is_error())
+            return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        m_received_buffers.append(make<ReceivedBuffer>(buffer.release_value()));
+        m_buffered_size += data.size();
+        m_received_size += data.size();
+        flush_received_buffers();
+
+        deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+    }
+
+    if (end_stream)
+        finish_up();
+}
+
+void Job::did_fail_http2_stream()
+{
+    m_http2_stream_id = {};
+    if (is_cancelled() || m_state == State::Finished)
+        return;
+    deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+}
+
 void Job::timer_event(Core::TimerEvent& event)
 {
     event.accept();
@@ -10,22 +10,34 @@
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
+#include <AK/WeakPtr.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
 namespace HTTP {
 
-class Job : public Core::NetworkJob {
+class Job
+    : public Core::NetworkJob
+    , public Http2StreamClient {
     C_OBJECT(Job);
 
 public:
     explicit Job(HttpRequest&&, Core::Stream::Stream&);
-    virtual ~Job() override = default;
+    virtual ~Job() override;
 
     virtual void start(Core::Stream::Socket&) override;
+    // Sends the request as a new stream on an HTTP/2 connection, instead of over a socket of our own.
+    void start(Http2Connection&);
     virtual void shutdown(ShutdownMode) override;
 
+    // Writes the request to a connection that is still busy with another job, so that it can be
+    // pipelined behind that one. Only idempotent requests are pipelined; returns whether we did.
+    bool send_request_ahead(Core::Stream::Socket&);
+    // The connection the request was sent ahead on went away, send it again once we're started.
+    void discard_request_sent_ahead() { m_request_was_sent_ahead = false; }
+
     Core::Stream::Socket const* socket() const { return m_socket; }
     URL url() const { return m_request.url(); }
 
@@ -40,6 +52,11 @@ protected:
     ErrorOr<String> read_line(size_t);
     ErrorOr<ByteBuffer> receive(size_t);
     void timer_event(Core::TimerEvent&) override;
+    void add_header(StringView name, String value);
+
+    virtual void did_receive_http2_headers(Vector<HPack::Header> const&, bool end_stream) override;
+    virtual void did_receive_http2_data(ReadonlyBytes, bool end_stream) override;
+    virtual void did_fail_http2_stream() override;
 
     enum class State {
         InStatus,
@@ -80,6 +97,10 @@ protected:
     bool m_can_stream_response { true };
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
+    bool m_request_was_sent_ahead { false };
+
+    WeakPtr<Http2Connection> m_http2_connection;
+    Optional<u32> m_http2_stream_id;
 };
 
 }
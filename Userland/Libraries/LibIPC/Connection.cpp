@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
 #include <LibIPC/Stub.h>
@@ -25,6 +26,9 @@ ErrorOr<void> ConnectionBase::post_message(Message const& message)
     return post_message(message.encode());
 }
 
+// Batched messages are written right away once this many bytes have piled up.
+static constexpr size_t max_batched_bytes = 64 * KiB;
+
 ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
 {
     // NOTE: If this connection is being shut down, but has not yet been destroyed,
@@ -32,11 +36,11 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
-    // Prepend the message size.
     uint32_t message_size = buffer.data.size();
-    TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
 
 #ifdef __serenity__
+    // NOTE: The file descriptors travel separately from the bytes and are picked up in order as messages are
+    //       decoded, so it's fine to send them ahead of a batched message.
     for (auto& fd : buffer.fds) {
         if (auto result = m_socket->send_fd(fd.value()); result.is_error()) {
             shutdown_with_error(result.error());
@@ -48,7 +52,41 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
         warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-    ReadonlyBytes bytes_to_write { buffer.data.span() };
+    if (m_batch_outgoing_messages) {
+        bool was_empty = m_outgoing_bytes.is_empty();
+        TRY(m_outgoing_bytes.try_append(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
+        TRY(m_outgoing_bytes.try_append(buffer.data.data(), buffer.data.size()));
+
+        if (m_outgoing_bytes.size() >= max_batched_bytes)
+            return flush_outgoing_messages();
+
+        if (was_empty) {
+            deferred_invoke([this] {
+                if (auto result = flush_outgoing_messages(); result.is_error())
+                    dbgln("IPC::ConnectionBase::flush_outgoing_messages: {}", result.error());
+            });
+        }
+        return {};
+    }
+
+    // Prepend the message size.
+    TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
+    return write_to_socket(buffer.data.span());
+}
+
+ErrorOr<void> ConnectionBase::flush_outgoing_messages()
+{
+    if (m_outgoing_bytes.is_empty())
+        return {};
+
+    ScopeGuard clear_outgoing_bytes = [this] { m_outgoing_bytes.clear_with_capacity(); };
+    if (!m_socket->is_open())
+        return Error::from_string_literal("Trying to flush_outgoing_messages during IPC shutdown");
+    return write_to_socket(m_outgoing_bytes.span());
+}
+
+ErrorOr<void> ConnectionBase::write_to_socket(ReadonlyBytes bytes_to_write)
+{
     int writes_done = 0;
     size_t initial_size = bytes_to_write.size();
     while (!bytes_to_write.is_empty()) {
@@ -196,6 +234,10 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
+    // Whatever we're waiting for might well be the response to a message that's still queued.
+    if (flush_outgoing_messages().is_error())
+        return {};
+
     for (;;) {
         // Double check we don't already have the event waiting for us.
         // Otherwise we might end up blocked for a while for no reason.
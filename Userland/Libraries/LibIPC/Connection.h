@@ -35,6 +35,7 @@ public:
 
     bool is_open() const { return m_socket->is_open(); }
     ErrorOr<void> post_message(Message const&);
+    ErrorOr<void> flush_outgoing_messages();
 
     void shutdown();
     virtual void die() { }
@@ -57,6 +58,11 @@ protected:
     ErrorOr<void> post_message(MessageBuffer);
     void handle_messages();
 
+    // When set, posted messages are collected and written to the socket together at the end of the current event
+    // loop turn, instead of each getting a write of its own. Only use this if the event loop keeps running for as
+    // long as the connection is alive, as messages that are still queued when it stops are never sent.
+    void set_batch_outgoing_messages(bool batch) { m_batch_outgoing_messages = batch; }
+
     IPC::Stub& m_local_stub;
 
     NonnullOwnPtr<Core::Stream::LocalSocket> m_socket;
@@ -66,6 +72,12 @@ protected:
     ByteBuffer m_unprocessed_bytes;
 
     u32 m_local_endpoint_magic { 0 };
+
+private:
+    ErrorOr<void> write_to_socket(ReadonlyBytes);
+
+    Vector<u8> m_outgoing_bytes;
+    bool m_batch_outgoing_messages { false };
 };
 
 template<typename LocalEndpoint, typename PeerEndpoint>
@@ -32,6 +32,8 @@ public:
         , m_client_id(client_id)
     {
         VERIFY(this->socket().is_open());
+        // Servers keep running their event loop while they have clients, and often send several messages per turn.
+        this->set_batch_outgoing_messages(true);
         this->socket().on_ready_to_read = [this] {
             // FIXME: Do something about errors.
             (void)this->drain_messages_from_peer();
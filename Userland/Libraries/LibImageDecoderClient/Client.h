@@ -30,7 +30,8 @@ class Client final
     IPC_CLIENT_CONNECTION(Client, "/tmp/user/%uid/portal/image"sv);
 
 public:
-    Optional<DecodedImage> decode_image(ReadonlyBytes);
+    // With an ideal_size, the image may be decoded smaller than it really is, but at least that large.
+    Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size = {});
 
     Function<void()> on_death;
 
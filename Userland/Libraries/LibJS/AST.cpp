@@ -15,8 +15,10 @@
 #include <AK/TemporaryChange.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -205,6 +207,31 @@ void LabelledStatement::dump(int indent) const
     m_labelled_item->dump(indent + 2);
 }
 
+FunctionBody::FunctionBody(SourceRange source_range)
+    : ScopeNode(source_range)
+{
+}
+
+FunctionBody::~FunctionBody() = default;
+
+void FunctionBody::set_bytecode_executables(NonnullRefPtr<Bytecode::FunctionExecutables> executables) const
+{
+    m_bytecode_executables = move(executables);
+}
+
+void FunctionBody::ensure_parsed() const
+{
+    if (!m_lazily_parsed_source)
+        return;
+
+    auto source = m_lazily_parsed_source.release_nonnull();
+    auto body = Parser::parse_lazily_parsed_function_body(*source, source_range().filename);
+    VERIFY(body->in_strict_mode() == in_strict_mode());
+
+    // NOTE: Parsing the body is not observable, so it's fine for this to change a const node.
+    const_cast<FunctionBody&>(*this).take_contents_of(*body);
+}
+
 // 10.2.1.3 Runtime Semantics: EvaluateBody, https://tc39.es/ecma262/#sec-runtime-semantics-evaluatebody
 Completion FunctionBody::execute(Interpreter& interpreter) const
 {
@@ -1976,6 +2003,12 @@ void ASTNode::dump(int indent) const
     outln("{}", class_name());
 }
 
+void FunctionBody::dump(int indent) const
+{
+    ensure_parsed();
+    ScopeNode::dump(indent);
+}
+
 void ScopeNode::dump(int indent) const
 {
     ASTNode::dump(indent);
@@ -4336,6 +4369,14 @@ void ScopeNode::add_hoisted_function(NonnullRefPtr<FunctionDeclaration> declarat
     m_functions_hoistable_with_annexB_extension.append(move(declaration));
 }
 
+void ScopeNode::take_contents_of(ScopeNode& other)
+{
+    m_children = move(other.m_children);
+    m_lexical_declarations = move(other.m_lexical_declarations);
+    m_var_declarations = move(other.m_var_declarations);
+    m_functions_hoistable_with_annexB_extension = move(other.m_functions_hoistable_with_annexB_extension);
+}
+
 // 16.2.1.11 Runtime Semantics: Evaluation, https://tc39.es/ecma262/#sec-module-semantics-runtime-semantics-evaluation
 Completion ImportStatement::execute(Interpreter& interpreter) const
 {
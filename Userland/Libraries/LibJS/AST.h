@@ -70,6 +70,7 @@ public:
     virtual bool is_private_identifier() const { return false; }
     virtual bool is_scope_node() const { return false; }
     virtual bool is_program() const { return false; }
+    virtual bool is_function_body() const { return false; }
     virtual bool is_class_declaration() const { return false; }
     virtual bool is_function_declaration() const { return false; }
     virtual bool is_variable_declaration() const { return false; }
@@ -265,6 +266,8 @@ protected:
     {
     }
 
+    void take_contents_of(ScopeNode&);
+
 private:
     virtual bool is_scope_node() const final { return true; }
 
@@ -519,19 +522,40 @@ public:
 
 class FunctionBody final : public ScopeNode {
 public:
-    explicit FunctionBody(SourceRange source_range)
-        : ScopeNode(source_range)
-    {
-    }
+    explicit FunctionBody(SourceRange);
+    virtual ~FunctionBody() override;
 
     void set_strict_mode() { m_in_strict_mode = true; }
 
     bool in_strict_mode() const { return m_in_strict_mode; }
 
     virtual Completion execute(Interpreter&) const override;
+    virtual void dump(int indent) const override;
+
+    // NOTE: Bodies of functions declared outside of classes are only validated by the parser at first, and kept as the
+    //       function's source text. Their nodes are created once the function is called, see ensure_parsed().
+    struct LazilyParsedSource {
+        String function_source_text;
+        Position function_start;
+        Program::Type program_type { Program::Type::Script };
+        bool starts_in_strict_mode { false };
+    };
+
+    bool is_lazily_parsed() const { return m_lazily_parsed_source; }
+    void set_lazily_parsed_source(LazilyParsedSource source) { m_lazily_parsed_source = make<LazilyParsedSource>(move(source)); }
+    void ensure_parsed() const;
+
+    // NOTE: The bytecode for this body is generated when a function with it is first called, and kept here so that
+    //       other function objects made from the same code don't have to generate it again.
+    RefPtr<Bytecode::FunctionExecutables> const& bytecode_executables() const { return m_bytecode_executables; }
+    void set_bytecode_executables(NonnullRefPtr<Bytecode::FunctionExecutables>) const;
 
 private:
+    virtual bool is_function_body() const override { return true; }
+
     bool m_in_strict_mode { false };
+    mutable OwnPtr<LazilyParsedSource> m_lazily_parsed_source;
+    mutable RefPtr<Bytecode::FunctionExecutables> m_bytecode_executables;
 };
 
 class Expression : public ASTNode {
@@ -2132,6 +2156,9 @@ inline bool ASTNode::fast_is<ScopeNode>() const { return is_scope_node(); }
 template<>
 inline bool ASTNode::fast_is<Program>() const { return is_program(); }
 
+template<>
+inline bool ASTNode::fast_is<FunctionBody>() const { return is_function_body(); }
+
 template<>
 inline bool ASTNode::fast_is<ClassDeclaration>() const { return is_class_declaration(); }
 
@@ -582,7 +582,7 @@ Bytecode::CodeGenerationErrorOr<void> AssignmentExpression::generate_bytecode(By
                         generator.emit<Bytecode::Op::PutByValue>(*base_object_register, *computed_property_register);
                     } else if (expression.property().is_identifier()) {
                         auto identifier_table_ref = generator.intern_identifier(verify_cast<Identifier>(expression.property()).string());
-                        generator.emit<Bytecode::Op::PutById>(*base_object_register, identifier_table_ref);
+                        generator.emit<Bytecode::Op::PutById>(*base_object_register, identifier_table_ref, generator.next_property_lookup_cache());
                     } else {
                         return Bytecode::CodeGenerationError {
                             &expression,
@@ -1033,7 +1033,7 @@ Bytecode::CodeGenerationErrorOr<void> ObjectExpression::generate_bytecode(Byteco
             if (property_kind != Bytecode::Op::PropertyKind::Spread)
                 TRY(property.value().generate_bytecode(generator));
 
-            generator.emit<Bytecode::Op::PutById>(object_reg, key_name, property_kind);
+            generator.emit<Bytecode::Op::PutById>(object_reg, key_name, generator.next_property_lookup_cache(), property_kind);
         } else {
             TRY(property.key().generate_bytecode(generator));
             auto property_reg = generator.allocate_register();
@@ -1156,7 +1156,7 @@ static Bytecode::CodeGenerationErrorOr<void> generate_object_binding_pattern_byt
             }
 
             generator.emit<Bytecode::Op::Load>(value_reg);
-            generator.emit<Bytecode::Op::GetById>(generator.intern_identifier(identifier));
+            generator.emit<Bytecode::Op::GetById>(generator.intern_identifier(identifier), generator.next_property_lookup_cache());
         } else {
             auto expression = name.get<NonnullRefPtr<Expression>>();
             TRY(expression->generate_bytecode(generator));
@@ -1421,8 +1421,30 @@ Bytecode::CodeGenerationErrorOr<void> VariableDeclaration::generate_bytecode(Byt
     return {};
 }
 
+static Optional<Bytecode::Op::CallBuiltin::Builtin> builtin_for_call(MemberExpression const& callee, size_t argument_count)
+{
+    if (callee.is_computed() || argument_count != 1)
+        return {};
+
+    auto const& property_name = verify_cast<Identifier>(callee.property()).string();
+    if (property_name == "charCodeAt"sv)
+        return Bytecode::Op::CallBuiltin::Builtin::StringPrototypeCharCodeAt;
+    if (property_name == "push"sv)
+        return Bytecode::Op::CallBuiltin::Builtin::ArrayPrototypePush;
+
+    if (!is<Identifier>(callee.object()) || static_cast<Identifier const&>(callee.object()).string() != "Math"sv)
+        return {};
+    if (property_name == "abs"sv)
+        return Bytecode::Op::CallBuiltin::Builtin::MathAbs;
+    if (property_name == "floor"sv)
+        return Bytecode::Op::CallBuiltin::Builtin::MathFloor;
+    return {};
+}
+
 Bytecode::CodeGenerationErrorOr<void> CallExpression::generate_bytecode(Bytecode::Generator& generator) const
 {
+    Optional<Bytecode::Op::CallBuiltin::Builtin> builtin;
+
     auto callee_reg = generator.allocate_register();
     auto this_reg = generator.allocate_register();
     generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
@@ -1452,9 +1474,10 @@ Bytecode::CodeGenerationErrorOr<void> CallExpression::generate_bytecode(Bytecode
             generator.emit<Bytecode::Op::GetByValue>(this_reg);
         } else {
             auto identifier_table_ref = generator.intern_identifier(verify_cast<Identifier>(member_expression.property()).string());
-            generator.emit<Bytecode::Op::GetById>(identifier_table_ref);
+            generator.emit<Bytecode::Op::GetById>(identifier_table_ref, generator.next_property_lookup_cache());
         }
         generator.emit<Bytecode::Op::Store>(callee_reg);
+        builtin = builtin_for_call(member_expression, m_arguments.size());
     } else {
         // FIXME: this = global object in sloppy mode.
         TRY(m_callee->generate_bytecode(generator));
@@ -1469,6 +1492,12 @@ Bytecode::CodeGenerationErrorOr<void> CallExpression::generate_bytecode(Bytecode
         argument_registers.append(arg_reg);
     }
 
+    // NOTE: Whether the callee really is the built-in can only be known at runtime, so CallBuiltin checks that.
+    if (builtin.has_value() && !m_arguments.first().is_spread) {
+        generator.emit<Bytecode::Op::CallBuiltin>(*builtin, callee_reg, this_reg, argument_registers.first());
+        return {};
+    }
+
     Bytecode::Op::Call::CallType call_type;
     if (is<NewExpression>(*this)) {
         call_type = Bytecode::Op::Call::CallType::Construct;
@@ -1707,7 +1736,7 @@ Bytecode::CodeGenerationErrorOr<void> TaggedTemplateLiteral::generate_bytecode(B
     generator.emit<Bytecode::Op::Store>(raw_strings_reg);
 
     generator.emit<Bytecode::Op::Load>(strings_reg);
-    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_identifier("raw"));
+    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_identifier("raw"), generator.next_property_lookup_cache());
 
     generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
     auto this_reg = generator.allocate_register();
@@ -1833,6 +1862,7 @@ Bytecode::CodeGenerationErrorOr<void> TryStatement::generate_bytecode(Bytecode::
     TRY(m_block->generate_bytecode(generator));
     if (!generator.is_current_block_terminated()) {
         if (m_finalizer) {
+            generator.emit<Bytecode::Op::LeaveUnwindContext>();
             generator.emit<Bytecode::Op::Jump>(finalizer_target);
         } else {
             auto& block = generator.make_block();
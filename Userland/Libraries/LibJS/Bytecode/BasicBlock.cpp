@@ -64,4 +64,11 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::replace_instruction_stream(ReadonlyBytes instructions)
+{
+    VERIFY(instructions.size() <= m_buffer_capacity);
+    __builtin_memcpy(m_buffer, instructions.data(), instructions.size());
+    m_buffer_size = instructions.size();
+}
+
 }
@@ -13,8 +13,11 @@
 
 namespace JS::Bytecode {
 
+struct RegisterWindow;
+
 struct UnwindInfo {
     Executable const* executable;
+    RegisterWindow const* frame;
     BasicBlock const* handler;
     BasicBlock const* finalizer;
 };
@@ -36,6 +39,11 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Replaces the instructions of this block with the ones in `instructions`, taking ownership of them.
+    // The caller is responsible for the instructions that were in the block before.
+    bool can_replace_instruction_stream(size_t size) const { return size <= m_buffer_capacity; }
+    void replace_instruction_stream(ReadonlyBytes instructions);
+
     void terminate(Badge<Generator>) { m_is_terminated = true; }
     bool is_terminated() const { return m_is_terminated; }
 
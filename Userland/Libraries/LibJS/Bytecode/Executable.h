@@ -6,26 +6,72 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/RefCounted.h>
+#include <AK/WeakPtr.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Shape.h>
 
 namespace JS::Bytecode {
 
+// An inline cache for a GetById or PutById instruction, remembering where the property was found for the last few
+// shapes the instruction has seen. Shapes are held weakly, so a shape that dies can't be mistaken for a new one that
+// happens to be allocated at the same address; in-place changes to a shape are caught by its mutation serial.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes_to_remember = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        u32 shape_mutation_serial { 0 };
+        // Whether the property lives on the direct prototype of the object rather than on the object itself.
+        bool is_in_prototype { false };
+        WeakPtr<Shape> prototype_shape;
+        u32 prototype_shape_mutation_serial { 0 };
+        u32 property_offset { 0 };
+    };
+
+    AK::Array<Entry, max_number_of_shapes_to_remember> entries;
+    size_t next_entry_to_replace { 0 };
+};
+
 struct Executable {
     FlyString name;
     NonnullOwnPtrVector<BasicBlock> basic_blocks;
     NonnullOwnPtr<StringTable> string_table;
     NonnullOwnPtr<IdentifierTable> identifier_table;
+    // NOTE: This is mutable, as the caches are filled in while the executable runs.
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
 
+    // NOTE: These are mutable, as an executable is compiled to native code once it has run often enough.
+    // The hotness goes up by one for every call and every jump.
+    mutable u32 hotness { 0 };
+    mutable bool did_try_to_compile_to_native_code { false };
+    mutable OwnPtr<JIT::NativeExecutable> native_executable {};
+
     String const& get_string(StringTableIndex index) const { return string_table->get(index); }
     FlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
     void dump() const;
 };
 
+// The executables for the body and the default parameter values of a function. They only depend on the function's
+// code, so every function object made from the same code shares them, along with their caches and native code.
+struct FunctionExecutables : public RefCounted<FunctionExecutables> {
+    FunctionExecutables(NonnullOwnPtr<Executable> body, NonnullOwnPtrVector<Executable> default_parameters)
+        : body(move(body))
+        , default_parameters(move(default_parameters))
+    {
+    }
+
+    NonnullOwnPtr<Executable> body;
+    NonnullOwnPtrVector<Executable> default_parameters;
+};
+
 }
@@ -17,6 +17,7 @@
     O(BitwiseOr)                     \
     O(BitwiseXor)                    \
     O(Call)                          \
+    O(CallBuiltin)                   \
     O(ConcatString)                  \
     O(ContinuePendingUnwind)         \
     O(CopyObjectExcludingProperties) \
@@ -109,6 +110,11 @@ public:
     void replace_references(BasicBlock const&, BasicBlock const&);
     static void destroy(Instruction&);
 
+    // Calls `callback(Register&, RegisterAccess)` for each register operand of the instruction.
+    // NOTE: NewArray reads all registers from the first to the last element, but only reports those two.
+    template<typename Callback>
+    void visit_registers(Callback);
+
 protected:
     explicit Instruction(Type type)
         : m_type(type)
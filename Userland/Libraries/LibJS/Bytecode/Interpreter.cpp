@@ -11,6 +11,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Realm.h>
@@ -19,6 +20,8 @@ namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_jit_enabled = false;
+PropertyLookupCacheStatistics g_property_lookup_cache_statistics;
 
 Interpreter* Interpreter::current()
 {
@@ -46,30 +49,47 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     TemporaryChange restore_executable { m_current_executable, &executable };
     VERIFY(m_saved_exception.is_null());
 
-    bool pushed_execution_context = false;
-    ExecutionContext execution_context(vm().heap());
+    // NOTE: This is only needed for the outermost unit, so don't pay for setting one up on every call.
+    Optional<ExecutionContext> execution_context;
     if (vm().execution_context_stack().is_empty() || !vm().running_execution_context().lexical_environment) {
         // The "normal" interpreter pushes an execution context without environment so in that case we also want to push one.
-        execution_context.this_value = &m_realm.global_object();
+        execution_context.emplace(vm().heap());
+        execution_context->this_value = &m_realm.global_object();
         static FlyString global_execution_context_name = "(*BC* global execution context)";
-        execution_context.function_name = global_execution_context_name;
-        execution_context.lexical_environment = &m_realm.global_environment();
-        execution_context.variable_environment = &m_realm.global_environment();
-        execution_context.realm = &m_realm;
-        execution_context.is_strict_mode = executable.is_strict_mode;
-        vm().push_execution_context(execution_context);
-        pushed_execution_context = true;
+        execution_context->function_name = global_execution_context_name;
+        execution_context->lexical_environment = &m_realm.global_environment();
+        execution_context->variable_environment = &m_realm.global_environment();
+        execution_context->realm = &m_realm;
+        execution_context->is_strict_mode = executable.is_strict_mode;
+        vm().push_execution_context(*execution_context);
     }
 
     auto block = entry_point ?: &executable.basic_blocks.first();
     if (in_frame)
         m_register_windows.append(in_frame);
     else
-        m_register_windows.append(make<RegisterWindow>(MarkedVector<Value>(vm().heap()), MarkedVector<Environment*>(vm().heap()), MarkedVector<Environment*>(vm().heap())));
+        m_register_windows.append(allocate_register_window());
 
     registers().resize(executable.number_of_registers);
+    ++executable.hotness;
 
     for (;;) {
+        compile_to_native_code_if_hot(executable);
+        if (auto* native_executable = executable.native_executable.ptr()) {
+            auto exit_reason = native_executable->run(*this, registers().data(), *block);
+            if (exit_reason == JIT::ExitReason::Jump) {
+                block = m_pending_jump.release_value();
+                continue;
+            }
+            if (exit_reason == JIT::ExitReason::Exception) {
+                if (auto* handler = unwind_to_handler(m_saved_exception.value())) {
+                    block = handler;
+                    continue;
+                }
+            }
+            break;
+        }
+
         Bytecode::InstructionStreamIterator pc(block->instruction_stream());
         bool will_jump = false;
         bool will_return = false;
@@ -77,38 +97,15 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
             auto& instruction = *pc;
             auto ran_or_error = instruction.execute(*this);
             if (ran_or_error.is_error()) {
-                auto exception_value = *ran_or_error.throw_completion().value();
-                m_saved_exception = make_handle(exception_value);
-                if (m_unwind_contexts.is_empty())
-                    break;
-                auto& unwind_context = m_unwind_contexts.last();
-                if (unwind_context.executable != m_current_executable)
-                    break;
-                if (unwind_context.handler) {
-                    block = unwind_context.handler;
-                    unwind_context.handler = nullptr;
-
-                    // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
-                    if (!unwind_context.finalizer)
-                        m_unwind_contexts.take_last();
-
-                    accumulator() = exception_value;
-                    m_saved_exception = {};
-                    will_jump = true;
-                    break;
-                }
-                if (unwind_context.finalizer) {
-                    block = unwind_context.finalizer;
-                    m_unwind_contexts.take_last();
+                if (auto* handler = unwind_to_handler(*ran_or_error.throw_completion().value())) {
+                    block = handler;
                     will_jump = true;
-                    break;
                 }
-                // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
-                // If you run into this, you probably forgot to remove the current unwind_context somewhere.
-                VERIFY_NOT_REACHED();
+                break;
             }
             if (m_pending_jump.has_value()) {
                 block = m_pending_jump.release_value();
+                ++executable.hotness;
                 will_jump = true;
                 break;
             }
@@ -155,8 +152,8 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     // in which case this is a no-op.
     vm().run_queued_promise_jobs();
 
-    if (pushed_execution_context) {
-        VERIFY(&vm().running_execution_context() == &execution_context);
+    if (execution_context.has_value()) {
+        VERIFY(&vm().running_execution_context() == &execution_context.value());
         vm().pop_execution_context();
     }
 
@@ -175,9 +172,80 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     return { return_value, nullptr };
 }
 
+NonnullOwnPtr<RegisterWindow> Interpreter::allocate_register_window()
+{
+    if (!m_recycled_register_windows.is_empty())
+        return m_recycled_register_windows.take_last();
+    return make<RegisterWindow>(MarkedVector<Value>(vm().heap()), MarkedVector<Environment*>(vm().heap()), MarkedVector<Environment*>(vm().heap()));
+}
+
+void Interpreter::recycle_register_window(NonnullOwnPtr<RegisterWindow> window)
+{
+    if (m_recycled_register_windows.size() == max_recycled_register_windows)
+        return;
+    // NOTE: This keeps the capacity of the vectors around, so that the next user doesn't have to grow them again.
+    window->registers.clear_with_capacity();
+    window->saved_lexical_environments.clear_with_capacity();
+    window->saved_variable_environments.clear_with_capacity();
+    m_recycled_register_windows.append(move(window));
+}
+
+BasicBlock const* Interpreter::unwind_to_handler(Value exception_value)
+{
+    m_saved_exception = make_handle(exception_value);
+    if (m_unwind_contexts.is_empty())
+        return nullptr;
+    auto& unwind_context = m_unwind_contexts.last();
+    // NOTE: Executables are shared between function objects, so a nested call may run the same one; only unwind to handlers of the running frame.
+    if (unwind_context.executable != m_current_executable || unwind_context.frame != &window())
+        return nullptr;
+    if (unwind_context.handler) {
+        auto* handler = unwind_context.handler;
+        unwind_context.handler = nullptr;
+
+        // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
+        if (!unwind_context.finalizer)
+            m_unwind_contexts.take_last();
+
+        accumulator() = exception_value;
+        m_saved_exception = {};
+        return handler;
+    }
+    if (unwind_context.finalizer) {
+        auto* finalizer = unwind_context.finalizer;
+        m_unwind_contexts.take_last();
+        return finalizer;
+    }
+    // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
+    // If you run into this, you probably forgot to remove the current unwind_context somewhere.
+    VERIFY_NOT_REACHED();
+}
+
+JIT::ExitReason Interpreter::run_instruction_for_native_code(Instruction const& instruction)
+{
+    auto ran_or_error = instruction.execute(*this);
+    if (ran_or_error.is_error()) {
+        m_saved_exception = make_handle(*ran_or_error.throw_completion().value());
+        return JIT::ExitReason::Exception;
+    }
+    if (m_pending_jump.has_value())
+        return JIT::ExitReason::Jump;
+    if (!m_return_value.is_empty())
+        return JIT::ExitReason::Return;
+    return JIT::ExitReason::Continue;
+}
+
+void Interpreter::compile_to_native_code_if_hot(Executable const& executable)
+{
+    if (!g_jit_enabled || executable.did_try_to_compile_to_native_code || executable.hotness < JIT::Compiler::hotness_threshold)
+        return;
+    executable.did_try_to_compile_to_native_code = true;
+    executable.native_executable = JIT::Compiler::compile(executable);
+}
+
 void Interpreter::enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target)
 {
-    m_unwind_contexts.empend(m_current_executable, handler_target.has_value() ? &handler_target->block() : nullptr, finalizer_target.has_value() ? &finalizer_target->block() : nullptr);
+    m_unwind_contexts.empend(m_current_executable, &window(), handler_target.has_value() ? &handler_target->block() : nullptr, finalizer_target.has_value() ? &finalizer_target->block() : nullptr);
 }
 
 void Interpreter::leave_unwind_context()
@@ -207,6 +275,16 @@ VM::InterpreterExecutionScope Interpreter::ast_interpreter_scope()
 
 AK::Array<OwnPtr<PassManager>, static_cast<UnderlyingType<Interpreter::OptimizationLevel>>(Interpreter::OptimizationLevel::__Count)> Interpreter::s_optimization_pipelines {};
 
+void PropertyLookupCacheStatistics::dump() const
+{
+    auto hit_percentage = [](u64 hits, u64 misses) {
+        return hits + misses ? hits * 100 / (hits + misses) : 0;
+    };
+    outln("Property lookup caches:");
+    outln("  GetById: {} hits, {} misses ({}% hit rate)", get_by_id_hits, get_by_id_misses, hit_percentage(get_by_id_hits, get_by_id_misses));
+    outln("  PutById: {} hits, {} misses ({}% hit rate)", put_by_id_hits, put_by_id_misses, hit_percentage(put_by_id_hits, put_by_id_misses));
+}
+
 Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::OptimizationLevel level)
 {
     auto underlying_level = to_underlying(level);
@@ -228,6 +306,10 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::MergeBlocks>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::FoldConstants>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AllocateRegisters>();
     } else {
         VERIFY_NOT_REACHED();
     }
@@ -13,6 +13,7 @@
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Heap/Handle.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibJS/Runtime/Value.h>
 
@@ -38,6 +39,8 @@ public:
     ThrowCompletionOr<Value> run(Bytecode::Executable const& executable, Bytecode::BasicBlock const* entry_point = nullptr)
     {
         auto value_and_frame = run_and_return_frame(executable, entry_point);
+        if (value_and_frame.frame)
+            recycle_register_window(value_and_frame.frame.release_nonnull());
         return move(value_and_frame.value);
     }
 
@@ -47,6 +50,10 @@ public:
     };
     ValueAndFrame run_and_return_frame(Bytecode::Executable const&, Bytecode::BasicBlock const* entry_point, RegisterWindow* = nullptr);
 
+    // Hands a frame returned by run_and_return_frame() back once nothing needs it anymore, so that a later call can
+    // use it instead of allocating a new one.
+    void recycle_register_window(NonnullOwnPtr<RegisterWindow>);
+
     ALWAYS_INLINE Value& accumulator() { return reg(Register::accumulator()); }
     Value& reg(Register const& r) { return registers()[r.index()]; }
 
@@ -63,6 +70,9 @@ public:
     void leave_unwind_context();
     ThrowCompletionOr<void> continue_pending_unwind(Label const& resume_label);
 
+    // Used by native code to run the instructions it has no fast path for.
+    JIT::ExitReason run_instruction_for_native_code(Instruction const&);
+
     Executable const& current_executable() { return *m_current_executable; }
 
     enum class OptimizationLevel {
@@ -86,11 +96,22 @@ private:
 
     MarkedVector<Value>& registers() { return window().registers; }
 
+    // Stores the exception and finds the handler or finalizer for it in the current executable, if there is one.
+    BasicBlock const* unwind_to_handler(Value exception_value);
+
+    static void compile_to_native_code_if_hot(Executable const&);
+
+    NonnullOwnPtr<RegisterWindow> allocate_register_window();
+
     static AK::Array<OwnPtr<PassManager>, static_cast<UnderlyingType<Interpreter::OptimizationLevel>>(Interpreter::OptimizationLevel::__Count)> s_optimization_pipelines;
 
     VM& m_vm;
     Realm& m_realm;
     Vector<Variant<NonnullOwnPtr<RegisterWindow>, RegisterWindow*>> m_register_windows;
+
+    // NOTE: One for each level of nesting of calls in hot code is plenty.
+    static constexpr size_t max_recycled_register_windows = 16;
+    Vector<NonnullOwnPtr<RegisterWindow>, max_recycled_register_windows> m_recycled_register_windows;
     Optional<BasicBlock const*> m_pending_jump;
     Value m_return_value;
     Executable const* m_current_executable { nullptr };
@@ -100,5 +121,17 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_jit_enabled;
+
+struct PropertyLookupCacheStatistics {
+    u64 get_by_id_hits { 0 };
+    u64 get_by_id_misses { 0 };
+    u64 put_by_id_hits { 0 };
+    u64 put_by_id_misses { 0 };
+
+    void dump() const;
+};
+
+extern PropertyLookupCacheStatistics g_property_lookup_cache_statistics;
 
 }
@@ -45,7 +45,7 @@ String Instruction::to_string(Bytecode::Executable const& executable) const
 
 namespace JS::Bytecode::Op {
 
-static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind)
+static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind, CacheablePropertyMetadata* cacheable_metadata = nullptr)
 {
     auto& vm = interpreter.vm();
 
@@ -69,7 +69,7 @@ static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value,
         break;
     }
     case PropertyKind::KeyValue: {
-        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object));
+        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object, cacheable_metadata));
         if (!succeeded && vm.in_strict_mode())
             return vm.throw_completion<TypeError>(ErrorType::ReferenceNullishSetProperty, name, interpreter.accumulator().to_string_without_side_effects());
         break;
@@ -285,7 +285,16 @@ ThrowCompletionOr<void> CopyObjectExcludingProperties::execute_impl(Bytecode::In
 ThrowCompletionOr<void> ConcatString::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    interpreter.reg(m_lhs) = TRY(add(vm, interpreter.reg(m_lhs), interpreter.accumulator()));
+    auto& lhs = interpreter.reg(m_lhs);
+    auto rhs = interpreter.accumulator();
+
+    // OPTIMIZATION: Template literals mostly concatenate strings, which doesn't need any of the conversions in add().
+    if (lhs.is_string() && rhs.is_string()) {
+        lhs = js_rope_string(vm, lhs.as_string(), rhs.as_string());
+        return {};
+    }
+
+    lhs = TRY(add(vm, lhs, rhs));
     return {};
 }
 
@@ -404,11 +413,75 @@ ThrowCompletionOr<void> SetVariable::execute_impl(Bytecode::Interpreter& interpr
     return {};
 }
 
+static void fill_property_lookup_cache(PropertyLookupCache& cache, Shape const& shape, CacheablePropertyMetadata const& metadata)
+{
+    if (metadata.type == CacheablePropertyMetadata::Type::NotCacheable)
+        return;
+    VERIFY(metadata.property_offset.has_value());
+
+    // Reuse the entry for this shape if there is one (it has to be stale), otherwise evict the oldest one.
+    PropertyLookupCache::Entry* entry = nullptr;
+    for (auto& existing_entry : cache.entries) {
+        if (existing_entry.shape.ptr() == &shape) {
+            entry = &existing_entry;
+            break;
+        }
+    }
+    if (!entry) {
+        entry = &cache.entries[cache.next_entry_to_replace];
+        cache.next_entry_to_replace = (cache.next_entry_to_replace + 1) % PropertyLookupCache::max_number_of_shapes_to_remember;
+    }
+
+    *entry = {};
+    entry->shape = shape.make_weak_ptr<Shape>();
+    entry->shape_mutation_serial = shape.mutation_serial();
+    entry->property_offset = *metadata.property_offset;
+    if (metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+        auto& prototype_shape = metadata.prototype->shape();
+        entry->is_in_prototype = true;
+        entry->prototype_shape = prototype_shape.make_weak_ptr<Shape>();
+        entry->prototype_shape_mutation_serial = prototype_shape.mutation_serial();
+    }
+}
+
 ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
+
+    // OPTIMIZATION: Don't create a String object just to look up the length of a string, as that would resolve it if it's a rope.
+    if (interpreter.accumulator().is_string()) {
+        if (auto value = interpreter.accumulator().as_string().get(vm, interpreter.current_executable().get_identifier(m_property)); value.has_value()) {
+            interpreter.accumulator() = *value;
+            return {};
+        }
+    }
+
     auto* object = TRY(interpreter.accumulator().to_object(vm));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+
+    auto& shape = object->shape();
+    for (auto& entry : cache.entries) {
+        if (entry.shape.ptr() != &shape || entry.shape_mutation_serial != shape.mutation_serial())
+            continue;
+        Object const* holder = object;
+        if (entry.is_in_prototype) {
+            holder = shape.prototype();
+            if (!holder || entry.prototype_shape.ptr() != &holder->shape() || entry.prototype_shape_mutation_serial != holder->shape().mutation_serial())
+                continue;
+        }
+        // NOTE: A data property can become an accessor property without the shape changing.
+        auto value = holder->get_direct(entry.property_offset);
+        if (value.is_accessor())
+            break;
+        ++g_property_lookup_cache_statistics.get_by_id_hits;
+        interpreter.accumulator() = value;
+        return {};
+    }
+
+    ++g_property_lookup_cache_statistics.get_by_id_misses;
+    CacheablePropertyMetadata cacheable_metadata;
+    interpreter.accumulator() = TRY(object->internal_get(interpreter.current_executable().get_identifier(m_property), object, &cacheable_metadata));
+    fill_property_lookup_cache(cache, object->shape(), cacheable_metadata);
     return {};
 }
 
@@ -416,9 +489,33 @@ ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter
 {
     auto& vm = interpreter.vm();
     auto* object = TRY(interpreter.reg(m_base).to_object(vm));
-    PropertyKey name = interpreter.current_executable().get_identifier(m_property);
     auto value = interpreter.accumulator();
-    return put_by_property_key(object, value, name, interpreter, m_kind);
+
+    if (m_kind != PropertyKind::KeyValue) {
+        PropertyKey name = interpreter.current_executable().get_identifier(m_property);
+        return put_by_property_key(object, value, name, interpreter, m_kind);
+    }
+
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+
+    // NOTE: Only existing writable data properties of the object itself are cached, so there is no shape change to care about.
+    auto& shape = object->shape();
+    for (auto& entry : cache.entries) {
+        if (entry.is_in_prototype || entry.shape.ptr() != &shape || entry.shape_mutation_serial != shape.mutation_serial())
+            continue;
+        if (object->get_direct(entry.property_offset).is_accessor())
+            break;
+        ++g_property_lookup_cache_statistics.put_by_id_hits;
+        object->put_direct(entry.property_offset, value);
+        return {};
+    }
+
+    ++g_property_lookup_cache_statistics.put_by_id_misses;
+    PropertyKey name = interpreter.current_executable().get_identifier(m_property);
+    CacheablePropertyMetadata cacheable_metadata;
+    TRY(put_by_property_key(object, value, name, interpreter, m_kind, &cacheable_metadata));
+    fill_property_lookup_cache(cache, object->shape(), cacheable_metadata);
+    return {};
 }
 
 ThrowCompletionOr<void> DeleteById::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -495,28 +592,24 @@ ThrowCompletionOr<void> JumpUndefined::execute_impl(Bytecode::Interpreter& inter
     return {};
 }
 
-ThrowCompletionOr<void> Call::execute_impl(Bytecode::Interpreter& interpreter) const
+static ThrowCompletionOr<void> perform_call(Bytecode::Interpreter& interpreter, Call::CallType type, Value callee, Value this_value, Span<Register const> arguments)
 {
     auto& vm = interpreter.vm();
 
-    auto callee = interpreter.reg(m_callee);
-
-    if (m_type == CallType::Call && !callee.is_function())
+    if (type == Call::CallType::Call && !callee.is_function())
         return vm.throw_completion<TypeError>(ErrorType::IsNotA, callee.to_string_without_side_effects(), "function"sv);
 
-    if (m_type == CallType::Construct && !callee.is_constructor())
+    if (type == Call::CallType::Construct && !callee.is_constructor())
         return vm.throw_completion<TypeError>(ErrorType::IsNotA, callee.to_string_without_side_effects(), "constructor"sv);
 
     auto& function = callee.as_function();
 
-    auto this_value = interpreter.reg(m_this_value);
-
     MarkedVector<Value> argument_values { vm.heap() };
-    for (size_t i = 0; i < m_argument_count; ++i)
-        argument_values.append(interpreter.reg(m_arguments[i]));
+    for (auto argument : arguments)
+        argument_values.append(interpreter.reg(argument));
 
     Value return_value;
-    if (m_type == CallType::Call)
+    if (type == Call::CallType::Call)
         return_value = TRY(call(vm, function, this_value, move(argument_values)));
     else
         return_value = TRY(construct(vm, function, move(argument_values)));
@@ -525,6 +618,83 @@ ThrowCompletionOr<void> Call::execute_impl(Bytecode::Interpreter& interpreter) c
     return {};
 }
 
+ThrowCompletionOr<void> Call::execute_impl(Bytecode::Interpreter& interpreter) const
+{
+    return perform_call(interpreter, m_type, interpreter.reg(m_callee), interpreter.reg(m_this_value), { m_arguments, m_argument_count });
+}
+
+static FunctionObject* builtin_function(Realm& realm, CallBuiltin::Builtin builtin)
+{
+    auto& global_object = realm.global_object();
+    switch (builtin) {
+    case CallBuiltin::Builtin::ArrayPrototypePush:
+        return global_object.array_prototype_push_function();
+    case CallBuiltin::Builtin::MathAbs:
+        return global_object.math_abs_function();
+    case CallBuiltin::Builtin::MathFloor:
+        return global_object.math_floor_function();
+    case CallBuiltin::Builtin::StringPrototypeCharCodeAt:
+        return global_object.string_prototype_char_code_at_function();
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Returns an empty Optional if the built-in has to be called the normal way after all.
+// NOTE: These must behave exactly like the built-ins do for the cases they handle.
+static ThrowCompletionOr<Optional<Value>> call_builtin_directly(VM& vm, CallBuiltin::Builtin builtin, Value this_value, Value argument)
+{
+    switch (builtin) {
+    case CallBuiltin::Builtin::ArrayPrototypePush: {
+        // 23.1.3.23 Array.prototype.push ( ...items ), https://tc39.es/ecma262/#sec-array.prototype.push
+        if (!this_value.is_object())
+            return Optional<Value> {};
+        auto& object = this_value.as_object();
+        auto length = TRY(length_of_array_like(vm, object));
+        auto new_length = length + 1;
+        if (new_length > MAX_ARRAY_LIKE_INDEX)
+            return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+        TRY(object.set(length, argument, Object::ShouldThrowExceptions::Yes));
+        auto new_length_value = Value(new_length);
+        TRY(object.set(vm.names.length, new_length_value, Object::ShouldThrowExceptions::Yes));
+        return new_length_value;
+    }
+    case CallBuiltin::Builtin::MathAbs:
+        if (!argument.is_number())
+            return Optional<Value> {};
+        return Value(fabs(argument.as_double()));
+    case CallBuiltin::Builtin::MathFloor:
+        if (!argument.is_number())
+            return Optional<Value> {};
+        return Value(floor(argument.as_double()));
+    case CallBuiltin::Builtin::StringPrototypeCharCodeAt: {
+        if (!this_value.is_string() || !argument.is_number())
+            return Optional<Value> {};
+        auto& string = this_value.as_string();
+        auto position = MUST(argument.to_integer_or_infinity(vm));
+        if (position < 0 || position >= string.length_in_utf16_code_units())
+            return js_nan();
+        return Value(string.utf16_string_view().code_unit_at(position));
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ThrowCompletionOr<void> CallBuiltin::execute_impl(Bytecode::Interpreter& interpreter) const
+{
+    auto callee = interpreter.reg(m_callee);
+    auto this_value = interpreter.reg(m_this_value);
+
+    if (callee.is_object() && &callee.as_object() == builtin_function(interpreter.realm(), m_builtin)) {
+        auto result = TRY(call_builtin_directly(interpreter.vm(), m_builtin, this_value, interpreter.reg(m_argument)));
+        if (result.has_value()) {
+            interpreter.accumulator() = result.release_value();
+            return {};
+        }
+    }
+
+    return perform_call(interpreter, Call::CallType::Call, callee, this_value, { &m_argument, 1 });
+}
+
 ThrowCompletionOr<void> NewFunction::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
@@ -653,10 +823,20 @@ void Yield::replace_references_impl(BasicBlock const& from, BasicBlock const& to
 ThrowCompletionOr<void> GetByValue::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    auto* object = TRY(interpreter.reg(m_base).to_object(vm));
+    auto base = interpreter.reg(m_base);
+    auto* object = base.is_string() ? nullptr : TRY(base.to_object(vm));
 
     auto property_key = TRY(interpreter.accumulator().to_property_key(vm));
 
+    // OPTIMIZATION: See GetById.
+    if (!object) {
+        if (auto value = base.as_string().get(vm, property_key); value.has_value()) {
+            interpreter.accumulator() = *value;
+            return {};
+        }
+        object = TRY(base.to_object(vm));
+    }
+
     interpreter.accumulator() = TRY(object->get(property_key));
     return {};
 }
@@ -1008,6 +1188,26 @@ String Call::to_string_impl(Bytecode::Executable const&) const
     return builder.to_string();
 }
 
+static StringView builtin_name(CallBuiltin::Builtin builtin)
+{
+    switch (builtin) {
+    case CallBuiltin::Builtin::ArrayPrototypePush:
+        return "Array.prototype.push"sv;
+    case CallBuiltin::Builtin::MathAbs:
+        return "Math.abs"sv;
+    case CallBuiltin::Builtin::MathFloor:
+        return "Math.floor"sv;
+    case CallBuiltin::Builtin::StringPrototypeCharCodeAt:
+        return "String.prototype.charCodeAt"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+String CallBuiltin::to_string_impl(Bytecode::Executable const&) const
+{
+    return String::formatted("CallBuiltin {} callee:{}, this:{}, argument:{}", builtin_name(m_builtin), m_callee, m_this_value, m_argument);
+}
+
 String NewFunction::to_string_impl(Bytecode::Executable const&) const
 {
     return "NewFunction";
@@ -30,10 +30,18 @@ public:
     {
     }
 
+    Register src() const { return m_src; }
+
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_src, RegisterAccess::Read);
+    }
+
 private:
     Register m_src;
 };
@@ -46,6 +54,8 @@ public:
     {
     }
 
+    Value value() const { return m_value; }
+
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
@@ -62,10 +72,18 @@ public:
     {
     }
 
+    Register dst() const { return m_dst; }
+
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_dst, RegisterAccess::Write);
+    }
+
 private:
     Register m_dst;
 };
@@ -107,6 +125,14 @@ private:
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
                                                                                \
+        Register lhs() const { return m_lhs_reg; }                             \
+                                                                               \
+        template<typename Callback>                                            \
+        void visit_registers_impl(Callback callback)                           \
+        {                                                                      \
+            callback(m_lhs_reg, RegisterAccess::Read);                         \
+        }                                                                      \
+                                                                               \
     private:                                                                   \
         Register m_lhs_reg;                                                    \
     };
@@ -199,6 +225,14 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_from_object, RegisterAccess::Read);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            callback(m_excluded_names[i], RegisterAccess::Read);
+    }
+
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
 private:
@@ -244,11 +278,24 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        if (m_element_count == 0)
+            return;
+        callback(m_elements[0], RegisterAccess::Read);
+        callback(m_elements[1], RegisterAccess::Read);
+    }
+
     size_t length_impl() const
     {
         return sizeof(*this) + sizeof(Register) * (m_element_count == 0 ? 0 : 2);
     }
 
+    size_t element_count() const { return m_element_count; }
+    Register first_element() const { return m_elements[0]; }
+    Register last_element() const { return m_elements[1]; }
+
 private:
     size_t m_element_count { 0 };
     Register m_elements[];
@@ -278,6 +325,12 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_lhs, RegisterAccess::ReadWrite);
+    }
+
 private:
     Register m_lhs;
 };
@@ -398,9 +451,10 @@ private:
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(IdentifierTableIndex property)
+    GetById(IdentifierTableIndex property, u32 cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -410,6 +464,7 @@ public:
 
 private:
     IdentifierTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 enum class PropertyKind {
@@ -422,11 +477,12 @@ enum class PropertyKind {
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, IdentifierTableIndex property, PropertyKind kind = PropertyKind::KeyValue)
+    PutById(Register base, IdentifierTableIndex property, u32 cache_index, PropertyKind kind = PropertyKind::KeyValue)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
         , m_kind(kind)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -434,10 +490,17 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base, RegisterAccess::Read);
+    }
+
 private:
     Register m_base;
     IdentifierTableIndex m_property;
     PropertyKind m_kind;
+    u32 m_cache_index { 0 };
 };
 
 class DeleteById final : public Instruction {
@@ -468,6 +531,12 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base, RegisterAccess::Read);
+    }
+
 private:
     Register m_base;
 };
@@ -486,6 +555,13 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base, RegisterAccess::Read);
+        callback(m_property, RegisterAccess::Read);
+    }
+
 private:
     Register m_base;
     Register m_property;
@@ -504,6 +580,12 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base, RegisterAccess::Read);
+    }
+
 private:
     Register m_base;
 };
@@ -600,6 +682,15 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_callee, RegisterAccess::Read);
+        callback(m_this_value, RegisterAccess::Read);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            callback(m_arguments[i], RegisterAccess::Read);
+    }
+
     size_t length_impl() const
     {
         return sizeof(*this) + sizeof(Register) * m_argument_count;
@@ -613,6 +704,46 @@ private:
     Register m_arguments[];
 };
 
+// A call of one argument that looks like a call to one of a few well-known built-in functions. If the callee is
+// still that built-in at runtime, the common cases are handled right here, without building an argument list or
+// entering the native function. Anything else is called like Call would.
+class CallBuiltin final : public Instruction {
+public:
+    enum class Builtin {
+        ArrayPrototypePush,
+        MathAbs,
+        MathFloor,
+        StringPrototypeCharCodeAt,
+    };
+
+    CallBuiltin(Builtin builtin, Register callee, Register this_value, Register argument)
+        : Instruction(Type::CallBuiltin)
+        , m_builtin(builtin)
+        , m_callee(callee)
+        , m_this_value(this_value)
+        , m_argument(argument)
+    {
+    }
+
+    ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
+    String to_string_impl(Bytecode::Executable const&) const;
+    void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_callee, RegisterAccess::Read);
+        callback(m_this_value, RegisterAccess::Read);
+        callback(m_argument, RegisterAccess::Read);
+    }
+
+private:
+    Builtin m_builtin;
+    Register m_callee;
+    Register m_this_value;
+    Register m_argument;
+};
+
 class NewClass final : public Instruction {
 public:
     explicit NewClass(ClassExpression const& class_expression)
@@ -763,6 +894,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
 
+    auto& next_target() const { return m_next_target; }
+
 private:
     Label m_next_target;
 };
@@ -962,6 +1095,35 @@ ALWAYS_INLINE void Instruction::replace_references(BasicBlock const& from, Basic
 #undef __BYTECODE_OP
 }
 
+template<typename Callback>
+ALWAYS_INLINE void Instruction::visit_registers(Callback callback)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return static_cast<Bytecode::Op::op&>(*this).visit_registers_impl(callback);
+#define __BYTECODE_BINARY_OP(op, ...) __BYTECODE_OP(op)
+
+    switch (type()) {
+        __BYTECODE_OP(Load)
+        __BYTECODE_OP(Store)
+        __BYTECODE_OP(CopyObjectExcludingProperties)
+        __BYTECODE_OP(NewArray)
+        __BYTECODE_OP(ConcatString)
+        __BYTECODE_OP(PutById)
+        __BYTECODE_OP(GetByValue)
+        __BYTECODE_OP(PutByValue)
+        __BYTECODE_OP(DeleteByValue)
+        __BYTECODE_OP(Call)
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_BINARY_OP)
+    default:
+        // The remaining instructions only operate on the accumulator.
+        return;
+    }
+
+#undef __BYTECODE_BINARY_OP
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::Call)
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Renumbers the registers so that registers which are never live at the same time share a slot,
+// which shrinks the register window every call has to allocate.
+// Registers that are read before being written on entry, the ones exception handlers read, and the
+// ones NewArray takes an element range of are left out of this and keep their relative order.
+void AllocateRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto liveness = compute_register_liveness(executable);
+    auto register_count = executable.executable.number_of_registers;
+
+    Vector<bool> pinned;
+    pinned.resize(register_count);
+    for (size_t i = 0; i < register_count; ++i)
+        pinned[i] = liveness.live_on_entry[i] || liveness.live_on_unwind[i];
+
+    Vector<bool> used;
+    used.resize(register_count);
+    Vector<HashTable<u32>> interferences;
+    interferences.resize(register_count);
+
+    for (auto& block : executable.executable.basic_blocks) {
+        Vector<Instruction*> instructions;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            instructions.append(&const_cast<Instruction&>(*it));
+            ++it;
+        }
+
+        HashTable<u32> live;
+        auto& live_out = liveness.live_out.get(&block).value();
+        for (u32 i = first_allocatable_register_index; i < register_count; ++i) {
+            if (live_out[i])
+                live.set(i);
+        }
+
+        for (size_t i = instructions.size(); i-- > 0;) {
+            auto& instruction = *instructions[i];
+
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto& new_array = static_cast<Op::NewArray const&>(instruction);
+                if (new_array.element_count() != 0) {
+                    for (auto index = new_array.first_element().index(); index <= new_array.last_element().index(); ++index) {
+                        pinned[index] = true;
+                        used[index] = true;
+                        live.set(index);
+                    }
+                }
+                continue;
+            }
+
+            Vector<u32, 2> definitions;
+            Vector<u32, 4> uses;
+            instruction.visit_registers([&](Register& reg, RegisterAccess access) {
+                if (reg.index() < first_allocatable_register_index)
+                    return;
+                used[reg.index()] = true;
+                if (access != RegisterAccess::Read)
+                    definitions.append(reg.index());
+                if (access != RegisterAccess::Write)
+                    uses.append(reg.index());
+            });
+
+            for (auto definition : definitions) {
+                for (auto live_register : live) {
+                    if (live_register == definition)
+                        continue;
+                    interferences[definition].set(live_register);
+                    interferences[live_register].set(definition);
+                }
+            }
+            for (auto definition : definitions)
+                live.remove(definition);
+            for (auto use : uses)
+                live.set(use);
+        }
+    }
+
+    Vector<u32> mapping;
+    mapping.resize(register_count);
+    for (u32 i = 0; i < first_allocatable_register_index && i < register_count; ++i)
+        mapping[i] = i;
+
+    // The pinned registers go first, in the order they were in.
+    u32 next_pinned_slot = first_allocatable_register_index;
+    for (u32 i = first_allocatable_register_index; i < register_count; ++i) {
+        if (pinned[i])
+            mapping[i] = next_pinned_slot++;
+    }
+
+    // Then the rest get the lowest slot that none of the registers they interfere with have been given already.
+    u32 slot_count = next_pinned_slot;
+    Vector<bool> assigned;
+    assigned.resize(register_count);
+    Vector<bool> taken_slots;
+    for (u32 i = first_allocatable_register_index; i < register_count; ++i) {
+        if (pinned[i] || !used[i])
+            continue;
+
+        taken_slots.clear_with_capacity();
+        taken_slots.resize(slot_count - next_pinned_slot);
+        for (auto other : interferences[i]) {
+            if (!pinned[other] && assigned[other])
+                taken_slots[mapping[other] - next_pinned_slot] = true;
+        }
+
+        size_t slot = 0;
+        while (slot < taken_slots.size() && taken_slots[slot])
+            ++slot;
+        mapping[i] = next_pinned_slot + slot;
+        assigned[i] = true;
+        slot_count = max(slot_count, mapping[i] + 1);
+    }
+
+    if (slot_count >= register_count) {
+        finished();
+        return;
+    }
+
+    for (auto& block : executable.executable.basic_blocks) {
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            instruction.visit_registers([&](Register& reg, RegisterAccess) {
+                reg = Register(mapping[reg.index()]);
+            });
+        }
+    }
+
+    executable.executable.number_of_registers = slot_count;
+
+    finished();
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static bool is_accumulator_load(Instruction const& instruction)
+{
+    return instruction.type() == Instruction::Type::Load || instruction.type() == Instruction::Type::LoadImmediate;
+}
+
+// Drops Stores into registers that are never read afterwards, Loads of the register the accumulator was
+// just stored into (or loaded from), and Loads whose result is overwritten by the next instruction.
+// Returns whether anything was dropped.
+static bool eliminate_dead_stores(BasicBlock& block, Vector<bool> live)
+{
+    Vector<Instruction const*> instructions;
+    InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        instructions.append(&*it);
+        ++it;
+    }
+
+    Vector<bool> dead;
+    dead.resize(instructions.size());
+
+    // Walk the block backwards, keeping track of which registers may still be read.
+    for (size_t i = instructions.size(); i-- > 0;) {
+        auto& instruction = const_cast<Instruction&>(*instructions[i]);
+        if (instruction.type() == Instruction::Type::Store) {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            if (dst >= first_allocatable_register_index && !live[dst])
+                dead[i] = true;
+            live[dst] = false;
+            continue;
+        }
+
+        if (instruction.type() == Instruction::Type::NewArray) {
+            auto& new_array = static_cast<Op::NewArray const&>(instruction);
+            if (new_array.element_count() != 0) {
+                for (auto index = new_array.first_element().index(); index <= new_array.last_element().index(); ++index)
+                    live[index] = true;
+            }
+            continue;
+        }
+
+        instruction.visit_registers([&](Register& reg, RegisterAccess access) {
+            if (access != RegisterAccess::Write)
+                live[reg.index()] = true;
+        });
+    }
+
+    // Walk it forwards, keeping track of which register (if any) has the same value as the accumulator.
+    Optional<u32> register_in_accumulator;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (dead[i])
+            continue;
+        auto& instruction = *instructions[i];
+
+        if (instruction.type() == Instruction::Type::Load) {
+            auto src = static_cast<Op::Load const&>(instruction).src().index();
+            if (register_in_accumulator == src) {
+                dead[i] = true;
+                continue;
+            }
+        }
+
+        if (is_accumulator_load(instruction)) {
+            // Loading twice in a row makes the first Load pointless.
+            for (size_t next = i + 1; next < instructions.size(); ++next) {
+                if (dead[next])
+                    continue;
+                if (is_accumulator_load(*instructions[next]))
+                    dead[i] = true;
+                break;
+            }
+            if (dead[i])
+                continue;
+        }
+
+        switch (instruction.type()) {
+        case Instruction::Type::Load:
+            register_in_accumulator = static_cast<Op::Load const&>(instruction).src().index();
+            break;
+        case Instruction::Type::Store:
+            register_in_accumulator = static_cast<Op::Store const&>(instruction).dst().index();
+            break;
+        default:
+            register_in_accumulator = {};
+            break;
+        }
+    }
+
+    if (!dead.contains_slow(true))
+        return false;
+
+    BasicBlockRewriter rewriter { block };
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (dead[i])
+            rewriter.drop(*instructions[i]);
+        else
+            rewriter.keep(*instructions[i]);
+    }
+    return rewriter.commit();
+}
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    // Dropping one Store may make the Loads that fed it pointless, and the other way around,
+    // so go at it a few times.
+    static constexpr size_t max_rounds = 4;
+    for (size_t round = 0; round < max_rounds; ++round) {
+        auto liveness = compute_register_liveness(executable);
+        bool changed = false;
+
+        for (auto& block : executable.executable.basic_blocks) {
+            auto live = liveness.live_out.get(&block).value();
+            for (size_t i = 0; i < live.size(); ++i) {
+                if (liveness.live_on_unwind[i])
+                    live[i] = true;
+            }
+            if (eliminate_dead_stores(block, move(live)))
+                changed = true;
+        }
+
+        if (!changed)
+            break;
+    }
+
+    finished();
+}
+
+}
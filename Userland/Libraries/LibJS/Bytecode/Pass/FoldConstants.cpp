@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Evaluates a binary operation on two numbers, if it's one we know how to evaluate without side effects.
+static Optional<Value> fold_numeric_binary_op(Instruction::Type type, double lhs, double rhs)
+{
+    switch (type) {
+    case Instruction::Type::Add:
+        return Value(lhs + rhs);
+    case Instruction::Type::Sub:
+        return Value(lhs - rhs);
+    case Instruction::Type::Mul:
+        return Value(lhs * rhs);
+    case Instruction::Type::Div:
+        return Value(lhs / rhs);
+    case Instruction::Type::Mod:
+        return Value(fmod(lhs, rhs));
+    case Instruction::Type::LessThan:
+        return Value(lhs < rhs);
+    case Instruction::Type::LessThanEquals:
+        return Value(lhs <= rhs);
+    case Instruction::Type::GreaterThan:
+        return Value(lhs > rhs);
+    case Instruction::Type::GreaterThanEquals:
+        return Value(lhs >= rhs);
+    // NOTE: For two numbers, loose and strict equality are the same thing.
+    case Instruction::Type::LooselyEquals:
+    case Instruction::Type::StrictlyEquals:
+        return Value(lhs == rhs);
+    case Instruction::Type::LooselyInequals:
+    case Instruction::Type::StrictlyInequals:
+        return Value(lhs != rhs);
+    default:
+        return {};
+    }
+}
+
+static Optional<Register> binary_op_lhs(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+#define __BYTECODE_BINARY_OP(op, ...) \
+    case Instruction::Type::op:       \
+        return static_cast<Op::op const&>(instruction).lhs();
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_BINARY_OP)
+#undef __BYTECODE_BINARY_OP
+    default:
+        return {};
+    }
+}
+
+// Tracks the constants that end up in the accumulator and in registers within a block, and evaluates
+// the arithmetic and comparisons done on them ahead of time. Loads of registers known to hold a constant
+// become LoadImmediates, which EliminateDeadStores can then get rid of the stores for.
+void FoldConstants::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks) {
+        BasicBlockRewriter rewriter { block };
+        HashMap<u32, Value> register_constants;
+        Optional<Value> accumulator_constant;
+        bool changed = false;
+
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = *it;
+            ++it;
+
+            switch (instruction.type()) {
+            case Instruction::Type::LoadImmediate:
+                accumulator_constant = static_cast<Op::LoadImmediate const&>(instruction).value();
+                rewriter.keep(instruction);
+                continue;
+            case Instruction::Type::Load: {
+                auto src = static_cast<Op::Load const&>(instruction).src();
+                if (auto constant = register_constants.get(src.index()); constant.has_value()) {
+                    accumulator_constant = *constant;
+                    rewriter.replace<Op::LoadImmediate>(instruction, *constant);
+                    changed = true;
+                } else {
+                    accumulator_constant = {};
+                    rewriter.keep(instruction);
+                }
+                continue;
+            }
+            case Instruction::Type::Store: {
+                auto dst = static_cast<Op::Store const&>(instruction).dst();
+                if (accumulator_constant.has_value())
+                    register_constants.set(dst.index(), *accumulator_constant);
+                else
+                    register_constants.remove(dst.index());
+                rewriter.keep(instruction);
+                continue;
+            }
+            default:
+                break;
+            }
+
+            if (auto lhs = binary_op_lhs(instruction); lhs.has_value() && accumulator_constant.has_value()) {
+                auto lhs_constant = register_constants.get(lhs->index());
+                if (lhs_constant.has_value() && lhs_constant->is_number() && accumulator_constant->is_number()) {
+                    if (auto result = fold_numeric_binary_op(instruction.type(), lhs_constant->as_double(), accumulator_constant->as_double()); result.has_value()) {
+                        accumulator_constant = *result;
+                        rewriter.replace<Op::LoadImmediate>(instruction, *result);
+                        changed = true;
+                        continue;
+                    }
+                }
+            }
+
+            // Everything else leaves something unknown in the accumulator, and ConcatString writes its register too.
+            accumulator_constant = {};
+            const_cast<Instruction&>(instruction).visit_registers([&](Register& reg, RegisterAccess access) {
+                if (access != RegisterAccess::Read)
+                    register_constants.remove(reg.index());
+            });
+            rewriter.keep(instruction);
+
+            // Whatever comes after a terminator is never run.
+            if (instruction.is_terminator())
+                break;
+        }
+
+        // Keep the unreachable tail around as-is, it's not worth the trouble.
+        while (!it.at_end()) {
+            rewriter.keep(*it);
+            ++it;
+        }
+
+        if (changed)
+            (void)rewriter.commit();
+    }
+
+    finished();
+}
+
+}
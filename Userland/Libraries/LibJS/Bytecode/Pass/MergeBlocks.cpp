@@ -103,6 +103,9 @@ void MergeBlocks::perform(PassPipelineExecutable& executable)
             if (entry == cfg.end())
                 break;
             auto& successor = *entry->value.begin();
+            // Stop at a successor that's already part of another merged block, copying it here would run it twice.
+            if (blocks_to_remove.contains_slow(successor))
+                break;
             successors.append(successor);
             auto it = blocks_to_merge.find(successor);
             if (it == blocks_to_merge.end())
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode {
+
+RegisterLiveness compute_register_liveness(PassPipelineExecutable const& executable)
+{
+    VERIFY(executable.cfg.has_value());
+
+    auto& blocks = executable.executable.basic_blocks;
+    auto register_count = executable.executable.number_of_registers;
+
+    struct BlockSummary {
+        // Registers read by the block before it stores anything in them.
+        Vector<bool> uses;
+        // Registers the block stores something in.
+        Vector<bool> definitions;
+        Vector<bool> live_in;
+        Vector<bool> live_out;
+        // FinishUnwind jumps to its target without being a terminator, so those edges aren't part of the cfg.
+        Vector<BasicBlock const*> unwind_finish_targets;
+    };
+
+    HashMap<BasicBlock const*, size_t> block_indices;
+    Vector<BlockSummary> summaries;
+    summaries.resize(blocks.size());
+
+    for (size_t block_index = 0; block_index < blocks.size(); ++block_index) {
+        auto& block = blocks[block_index];
+        auto& summary = summaries[block_index];
+        block_indices.set(&block, block_index);
+        summary.uses.resize(register_count);
+        summary.definitions.resize(register_count);
+        summary.live_in.resize(register_count);
+        summary.live_out.resize(register_count);
+
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+
+            auto note_read = [&](u32 index) {
+                if (index >= first_allocatable_register_index && !summary.definitions[index])
+                    summary.uses[index] = true;
+            };
+
+            if (instruction.type() == Instruction::Type::FinishUnwind) {
+                summary.unwind_finish_targets.append(&static_cast<Op::FinishUnwind const&>(instruction).next_target().block());
+                continue;
+            }
+
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto& new_array = static_cast<Op::NewArray const&>(instruction);
+                if (new_array.element_count() != 0) {
+                    for (auto index = new_array.first_element().index(); index <= new_array.last_element().index(); ++index)
+                        note_read(index);
+                }
+                continue;
+            }
+
+            instruction.visit_registers([&](Register& reg, RegisterAccess access) {
+                if (access != RegisterAccess::Write)
+                    note_read(reg.index());
+                if (access != RegisterAccess::Read && reg.index() >= first_allocatable_register_index)
+                    summary.definitions[reg.index()] = true;
+            });
+        }
+    }
+
+    // Iterate to a fixed point. Going through the blocks backwards tends to get there faster, as liveness flows backwards.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t block_index = blocks.size(); block_index-- > 0;) {
+            auto& summary = summaries[block_index];
+
+            auto merge_live_in_of = [&](BasicBlock const* successor) {
+                auto& successor_live_in = summaries[*block_indices.get(successor)].live_in;
+                for (size_t i = 0; i < register_count; ++i) {
+                    if (successor_live_in[i])
+                        summary.live_out[i] = true;
+                }
+            };
+
+            if (auto successors = executable.cfg->find(&blocks[block_index]); successors != executable.cfg->end()) {
+                for (auto* successor : successors->value)
+                    merge_live_in_of(successor);
+            }
+            for (auto* successor : summary.unwind_finish_targets)
+                merge_live_in_of(successor);
+
+            for (size_t i = 0; i < register_count; ++i) {
+                bool live_in = summary.uses[i] || (summary.live_out[i] && !summary.definitions[i]);
+                if (live_in && !summary.live_in[i]) {
+                    summary.live_in[i] = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    RegisterLiveness liveness;
+    liveness.live_on_unwind.resize(register_count);
+    if (!blocks.is_empty())
+        liveness.live_on_entry = summaries.first().live_in;
+    else
+        liveness.live_on_entry.resize(register_count);
+
+    auto note_unwind_target = [&](BasicBlock const& target) {
+        auto& target_live_in = summaries[*block_indices.get(&target)].live_in;
+        for (size_t i = 0; i < register_count; ++i) {
+            if (target_live_in[i])
+                liveness.live_on_unwind[i] = true;
+        }
+    };
+
+    for (size_t block_index = 0; block_index < blocks.size(); ++block_index) {
+        InstructionStreamIterator it { blocks[block_index].instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = *it;
+            ++it;
+            if (instruction.type() != Instruction::Type::EnterUnwindContext)
+                continue;
+            auto& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(instruction);
+            if (enter_unwind_context.handler_target().has_value())
+                note_unwind_target(enter_unwind_context.handler_target()->block());
+            if (enter_unwind_context.finalizer_target().has_value())
+                note_unwind_target(enter_unwind_context.finalizer_target()->block());
+        }
+
+        liveness.live_out.set(&blocks[block_index], move(summaries[block_index].live_out));
+    }
+
+    return liveness;
+}
+
+}
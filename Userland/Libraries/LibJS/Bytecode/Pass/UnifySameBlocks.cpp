@@ -22,6 +22,9 @@ void UnifySameBlocks::perform(PassPipelineExecutable& executable)
 
     for (size_t i = 0; i < executable.executable.basic_blocks.size(); ++i) {
         auto& block = executable.executable.basic_blocks[i];
+        // A block that's already being replaced can't replace others, as it's about to go away.
+        if (equal_blocks.contains(&block))
+            continue;
         auto block_bytes = block.instruction_stream();
         for (auto& candidate_block : executable.executable.basic_blocks.span().slice(i + 1)) {
             // FIXME: This can probably be relaxed a bit...
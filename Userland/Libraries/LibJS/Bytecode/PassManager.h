@@ -67,6 +67,9 @@ public:
 
     void perform(Executable& executable)
     {
+        // Any native code was compiled from the blocks we're about to rewrite.
+        executable.native_executable = nullptr;
+        executable.did_try_to_compile_to_native_code = false;
         PassPipelineExecutable pipeline_executable { executable };
         perform(pipeline_executable);
     }
@@ -83,6 +86,71 @@ private:
     NonnullOwnPtrVector<Pass> m_passes;
 };
 
+struct RegisterLiveness {
+    // The registers whose current value may still be read once the block has run, indexed by register.
+    HashMap<BasicBlock const*, Vector<bool>> live_out;
+    // The registers that may be read before anything is stored in them.
+    Vector<bool> live_on_entry;
+    // The registers that may be read by an exception handler or finalizer before anything is stored in them.
+    // As an exception can transfer control to those from anywhere in the protected region, these have to be
+    // considered live all throughout.
+    Vector<bool> live_on_unwind;
+};
+
+// NOTE: Registers below this index aren't tracked: $0 is the accumulator, and $1 is never handed out by the generator.
+static constexpr u32 first_allocatable_register_index = 2;
+
+RegisterLiveness compute_register_liveness(PassPipelineExecutable const&);
+
+// Builds a new instruction stream for a block out of (some of) its instructions and new ones.
+class BasicBlockRewriter {
+public:
+    explicit BasicBlockRewriter(BasicBlock& block)
+        : m_block(block)
+    {
+    }
+
+    void keep(Instruction const& instruction)
+    {
+        m_stream.append(reinterpret_cast<u8 const*>(&instruction), instruction.length());
+    }
+
+    void drop(Instruction const& instruction)
+    {
+        m_dropped_instructions.append(&const_cast<Instruction&>(instruction));
+    }
+
+    template<typename OpType, typename... Args>
+    void replace(Instruction const& instruction, Args&&... args)
+    {
+        drop(instruction);
+        auto offset = m_stream.size();
+        m_stream.resize(offset + sizeof(OpType));
+        new (m_stream.data() + offset) OpType(forward<Args>(args)...);
+        m_added_instructions.append(offset);
+    }
+
+    // Returns false (and leaves the block alone) if the new instructions don't fit into the block.
+    bool commit()
+    {
+        if (!m_block.can_replace_instruction_stream(m_stream.size())) {
+            for (auto offset : m_added_instructions)
+                Instruction::destroy(*reinterpret_cast<Instruction*>(m_stream.data() + offset));
+            return false;
+        }
+        for (auto* instruction : m_dropped_instructions)
+            Instruction::destroy(*instruction);
+        m_block.replace_instruction_stream(m_stream.span());
+        return true;
+    }
+
+private:
+    BasicBlock& m_block;
+    Vector<u8> m_stream;
+    Vector<Instruction*> m_dropped_instructions;
+    Vector<size_t> m_added_instructions;
+};
+
 namespace Passes {
 
 class GenerateCFG : public Pass {
@@ -121,6 +189,33 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+class FoldConstants : public Pass {
+public:
+    FoldConstants() = default;
+    ~FoldConstants() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    ~EliminateDeadStores() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class AllocateRegisters : public Pass {
+public:
+    AllocateRegisters() = default;
+    ~AllocateRegisters() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 class DumpCFG : public Pass {
 public:
     DumpCFG(FILE* file)
@@ -10,6 +10,12 @@
 
 namespace JS::Bytecode {
 
+enum class RegisterAccess {
+    Read,
+    Write,
+    ReadWrite,
+};
+
 class Register {
 public:
     constexpr static u32 accumulator_index = 0;
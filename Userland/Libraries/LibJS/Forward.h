@@ -255,9 +255,14 @@ class Handle;
 template<class T, size_t inline_capacity = 32>
 class MarkedVector;
 
+namespace JIT {
+class NativeExecutable;
+}
+
 namespace Bytecode {
 class BasicBlock;
 struct Executable;
+struct FunctionExecutables;
 class Generator;
 class Instruction;
 class Interpreter;
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Debug.h>
 #include <LibJS/Heap/BlockAllocator.h>
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/Heap.h>
@@ -19,8 +20,16 @@ CellAllocator::CellAllocator(size_t cell_size)
 
 Cell* CellAllocator::allocate_cell(Heap& heap)
 {
+    SweepStatistics statistics;
+    while (m_usable_blocks.is_empty() && m_empty_blocks.is_empty() && !m_blocks_to_sweep.is_empty())
+        sweep_block(*m_blocks_to_sweep.first(), statistics);
+
+    if (m_usable_blocks.is_empty() && !m_empty_blocks.is_empty())
+        m_usable_blocks.append(*m_empty_blocks.first());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
+        heap.did_create_heap_block({}, *block);
         m_usable_blocks.append(*block.leak_ptr());
     }
 
@@ -32,19 +41,54 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     return cell;
 }
 
-void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
+void CellAllocator::schedule_sweep(Badge<Heap>)
+{
+    auto schedule = [&](BlockList& blocks) {
+        while (!blocks.is_empty()) {
+            auto& block = *blocks.first();
+            block.set_needs_sweep(true);
+            m_blocks_to_sweep.append(block);
+        }
+    };
+    schedule(m_full_blocks);
+    schedule(m_usable_blocks);
+    schedule(m_empty_blocks);
+}
+
+void CellAllocator::finish_sweeping(Badge<Heap>, SweepStatistics& statistics)
 {
-    auto& heap = block.heap();
-    block.m_list_node.remove();
-    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
-    block.~HeapBlock();
-    heap.block_allocator().deallocate_block(&block);
+    while (!m_blocks_to_sweep.is_empty())
+        sweep_block(*m_blocks_to_sweep.first(), statistics);
 }
 
-void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
+void CellAllocator::free_empty_blocks(Badge<Heap>, SweepStatistics& statistics)
 {
-    VERIFY(!block.is_full());
-    m_usable_blocks.append(block);
+    while (!m_empty_blocks.is_empty()) {
+        auto& block = *m_empty_blocks.first();
+        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", &block, block.cell_size());
+        ++statistics.freed_blocks;
+        auto& heap = block.heap();
+        heap.did_destroy_heap_block({}, block);
+        block.m_list_node.remove();
+        // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
+        block.~HeapBlock();
+        heap.block_allocator().deallocate_block(&block);
+    }
+}
+
+void CellAllocator::sweep_block(HeapBlock& block, SweepStatistics& statistics)
+{
+    VERIFY(block.needs_sweep());
+    auto result = block.sweep();
+    statistics.live_cells += result.live_cells;
+    statistics.collected_cells += result.collected_cells;
+
+    if (result.live_cells == 0)
+        m_empty_blocks.append(block);
+    else if (block.is_full())
+        m_full_blocks.append(block);
+    else
+        m_usable_blocks.append(block);
 }
 
 }
@@ -33,18 +33,41 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_blocks_to_sweep) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
+        for (auto& block : m_empty_blocks) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
-    void block_did_become_empty(Badge<Heap>, HeapBlock&);
-    void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    struct SweepStatistics {
+        size_t live_cells { 0 };
+        size_t collected_cells { 0 };
+        size_t freed_blocks { 0 };
+    };
+
+    // Called once marking is done. The blocks are then swept one at a time, as we need room for new cells.
+    void schedule_sweep(Badge<Heap>);
+    // Sweeps all the blocks that are still waiting for it.
+    void finish_sweeping(Badge<Heap>, SweepStatistics&);
+    // NOTE: Dead cells may still look at the blocks of other dead cells while they're being swept (e.g. a Handle finding
+    //       its Heap), so blocks that became empty are only given back once no allocator has anything left to sweep.
+    void free_empty_blocks(Badge<Heap>, SweepStatistics&);
 
 private:
+    void sweep_block(HeapBlock&, SweepStatistics&);
+
     const size_t m_cell_size;
 
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_blocks_to_sweep;
+    BlockList m_empty_blocks;
 };
 
 }
@@ -92,17 +92,67 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    auto collection_measurement_timer = Core::ElapsedTimer::start_new();
+    Core::ElapsedTimer collection_measurement_timer(true);
+    collection_measurement_timer.start();
+    if (collection_type == CollectionType::CollectGarbage && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    // NOTE: Cells that died in the last collection may still point to cells that have been swept since,
+    //       so they have to be gone before we can look for roots and mark again.
+    finish_sweeping();
+
     if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
         HashTable<Cell*> roots;
         gather_roots(roots);
         mark_live_cells(roots);
     }
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    auto time_spent_marking = collection_measurement_timer.elapsed_time();
+
+    // NOTE: A container may deregister itself while we're doing this, so we step past it before calling into it.
+    for (auto it = m_weak_containers.begin(); it != m_weak_containers.end();) {
+        auto& weak_container = *it;
+        ++it;
+        weak_container.remove_dead_cells({});
+    }
+
+    for (auto& allocator : m_allocators)
+        allocator->schedule_sweep({});
+
+    // The mutator normally sweeps blocks as it needs them, but we want the whole picture for a report,
+    // and nothing may be left behind when the heap goes away.
+    if (collection_type == CollectionType::CollectEverything || print_report) {
+        sweep_dead_cells(print_report, collection_measurement_timer, time_spent_marking);
+        return;
+    }
+    record_pause(collection_measurement_timer.elapsed_time());
+}
+
+void Heap::record_pause(Time pause)
+{
+    auto milliseconds = pause.to_milliseconds();
+    size_t bucket = 0;
+    while (bucket < pause_histogram_bucket_count - 1 && milliseconds >= (1ll << bucket))
+        ++bucket;
+    ++m_pause_histogram[bucket];
+    m_longest_pause = max(m_longest_pause, pause);
+}
+
+void Heap::dump_pause_histogram() const
+{
+    size_t total = 0;
+    for (auto count : m_pause_histogram)
+        total += count;
+
+    dbgln("Garbage collection pauses ({} in total, longest: {} ms)", total, m_longest_pause.to_milliseconds());
+    for (size_t bucket = 0; bucket < pause_histogram_bucket_count; ++bucket) {
+        auto lower_bound = bucket == 0 ? 0 : 1ll << (bucket - 1);
+        if (bucket == pause_histogram_bucket_count - 1)
+            dbgln("  >= {:>4} ms: {}", lower_bound, m_pause_histogram[bucket]);
+        else
+            dbgln("  {:>4}-{:<4} ms: {}", lower_bound, 1ll << bucket, m_pause_histogram[bucket]);
+    }
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -164,18 +214,12 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
         add_possible_value(data);
     }
 
-    HashTable<HeapBlock*> all_live_heap_blocks;
-    for_each_block([&](auto& block) {
-        all_live_heap_blocks.set(&block);
-        return IterationDecision::Continue;
-    });
-
     for (auto possible_pointer : possible_pointers) {
         if (!possible_pointer)
             continue;
         dbgln_if(HEAP_DEBUG, "  ? {}", (void const*)possible_pointer);
         auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<Cell const*>(possible_pointer));
-        if (all_live_heap_blocks.contains(possible_heap_block)) {
+        if (m_live_heap_blocks.contains(possible_heap_block)) {
             if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
                 if (cell->state() == Cell::State::Live) {
                     dbgln_if(HEAP_DEBUG, "  ?-> {}", (void const*)cell);
@@ -188,6 +232,8 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     }
 }
 
+// Marks everything reachable from the roots. Cells are marked as soon as they're seen, but their edges are only
+// visited once they come off the work queue, so long chains of cells don't turn into deep recursion.
 class MarkingVisitor final : public Cell::Visitor {
 public:
     MarkingVisitor() = default;
@@ -199,8 +245,17 @@ public:
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
-        cell.visit_edges(*this);
+        m_work_queue.append(&cell);
     }
+
+    void mark_all_reachable_cells()
+    {
+        while (!m_work_queue.is_empty())
+            m_work_queue.take_last()->visit_edges(*this);
+    }
+
+private:
+    Vector<Cell*> m_work_queue;
 };
 
 void Heap::mark_live_cells(HashTable<Cell*> const& roots)
@@ -210,6 +265,7 @@ void Heap::mark_live_cells(HashTable<Cell*> const& roots)
     MarkingVisitor visitor;
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.mark_all_reachable_cells();
 
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
@@ -217,51 +273,38 @@ void Heap::mark_live_cells(HashTable<Cell*> const& roots)
     m_uprooted_cells.clear();
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::finish_sweeping()
+{
+    CellAllocator::SweepStatistics statistics;
+    for (auto& allocator : m_allocators)
+        allocator->finish_sweeping({}, statistics);
+    for (auto& allocator : m_allocators)
+        allocator->free_empty_blocks({}, statistics);
+}
+
+void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer, Time time_spent_marking)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
-    Vector<HeapBlock*, 32> empty_blocks;
-    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t freed_blocks = 0;
 
-    for_each_block([&](auto& block) {
-        bool block_has_live_cells = false;
-        bool block_was_full = block.is_full();
-        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
-            if (!cell->is_marked()) {
-                dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
-                ++collected_cells;
-                collected_cell_bytes += block.cell_size();
-            } else {
-                cell->set_marked(false);
-                block_has_live_cells = true;
-                ++live_cells;
-                live_cell_bytes += block.cell_size();
-            }
-        });
-        if (!block_has_live_cells)
-            empty_blocks.append(&block);
-        else if (block_was_full != block.is_full())
-            full_blocks_that_became_usable.append(&block);
-        return IterationDecision::Continue;
-    });
-
-    for (auto& weak_container : m_weak_containers)
-        weak_container.remove_dead_cells({});
-
-    for (auto* block : empty_blocks) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
+    for (auto& allocator : m_allocators) {
+        CellAllocator::SweepStatistics statistics;
+        allocator->finish_sweeping({}, statistics);
+        collected_cells += statistics.collected_cells;
+        live_cells += statistics.live_cells;
+        collected_cell_bytes += statistics.collected_cells * allocator->cell_size();
+        live_cell_bytes += statistics.live_cells * allocator->cell_size();
     }
 
-    for (auto* block : full_blocks_that_became_usable) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+    for (auto& allocator : m_allocators) {
+        CellAllocator::SweepStatistics statistics;
+        allocator->free_empty_blocks({}, statistics);
+        freed_blocks += statistics.freed_blocks;
     }
 
     if constexpr (HEAP_DEBUG) {
@@ -271,7 +314,8 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    int time_spent = measurement_timer.elapsed();
+    auto time_spent = measurement_timer.elapsed_time();
+    record_pause(time_spent);
 
     if (print_report) {
         size_t live_block_count = 0;
@@ -282,15 +326,26 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent);
+        dbgln("     Time spent: {} ms (marking: {} ms, sweeping: {} ms)", time_spent.to_milliseconds(), time_spent_marking.to_milliseconds(), (time_spent - time_spent_marking).to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        dbgln("   Freed blocks: {} ({} bytes)", freed_blocks, freed_blocks * HeapBlock::block_size);
         dbgln("=============================================");
+        dump_pause_histogram();
     }
 }
 
+bool Heap::sweep_cell_if_dead(Cell& cell)
+{
+    auto* block = HeapBlock::from_cell(&cell);
+    if (!block->needs_sweep() || cell.is_marked())
+        return false;
+    dbgln_if(HEAP_DEBUG, "  ~ {} (found through a weak reference)", &cell);
+    block->deallocate(&cell);
+    return true;
+}
+
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
 {
     VERIFY(!m_handles.contains(impl));
@@ -303,6 +358,16 @@ void Heap::did_destroy_handle(Badge<HandleImpl>, HandleImpl& impl)
     m_handles.remove(impl);
 }
 
+void Heap::did_create_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.set(&block);
+}
+
+void Heap::did_destroy_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.remove(&block);
+}
+
 void Heap::did_create_marked_vector(Badge<MarkedVectorBase>, MarkedVectorBase& vector)
 {
     VERIFY(!m_marked_vectors.contains(vector));
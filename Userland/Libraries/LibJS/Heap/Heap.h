@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -75,17 +77,35 @@ public:
     void defer_gc(Badge<DeferGC>);
     void undefer_gc(Badge<DeferGC>);
 
+    void did_create_heap_block(Badge<CellAllocator>, HeapBlock&);
+    void did_destroy_heap_block(Badge<CellAllocator>, HeapBlock&);
+
     BlockAllocator& block_allocator() { return m_block_allocator; }
 
+    // How long every collection so far took, bucketed by powers of two: [0, 1) ms, [1, 2) ms, [2, 4) ms, and so on.
+    // The last bucket also takes everything longer than that.
+    static constexpr size_t pause_histogram_bucket_count = 12;
+    using PauseHistogram = AK::Array<size_t, pause_histogram_bucket_count>;
+    PauseHistogram const& pause_histogram() const { return m_pause_histogram; }
+    void dump_pause_histogram() const;
+
     void uproot_cell(Cell* cell);
 
+    // Cells that die in a collection are only destroyed once their block gets swept, which happens whenever its
+    // CellAllocator needs room. Weak pointers to them stay set until then, so anything that can find a cell through
+    // a weak reference must call this before handing it out. If the cell is dead, it's destroyed right away
+    // (clearing the weak pointers) and this returns true.
+    bool sweep_cell_if_dead(Cell&);
+
 private:
     Cell* allocate_cell(size_t);
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(HashTable<Cell*> const& live_cells);
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void finish_sweeping();
+    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&, Time time_spent_marking);
+    void record_pause(Time);
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -113,6 +133,12 @@ private:
 
     Vector<Cell*> m_uprooted_cells;
 
+    // NOTE: This is kept up to date as blocks come and go, so the conservative root scan doesn't have to gather them first.
+    HashTable<HeapBlock*> m_live_heap_blocks;
+
+    PauseHistogram m_pause_histogram {};
+    Time m_longest_pause;
+
     BlockAllocator m_block_allocator;
 
     size_t m_gc_deferrals { 0 };
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Debug.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Platform.h>
 #include <LibJS/Heap/Heap.h>
@@ -39,6 +40,23 @@ HeapBlock::HeapBlock(Heap& heap, size_t cell_size)
     ASAN_POISON_MEMORY_REGION(m_storage, block_size - sizeof(HeapBlock));
 }
 
+HeapBlock::SweepResult HeapBlock::sweep()
+{
+    SweepResult result;
+    for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+        if (!cell->is_marked()) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            deallocate(cell);
+            ++result.collected_cells;
+        } else {
+            cell->set_marked(false);
+            ++result.live_cells;
+        }
+    });
+    m_needs_sweep = false;
+    return result;
+}
+
 void HeapBlock::deallocate(Cell* cell)
 {
     VERIFY(is_valid_cell_pointer(cell));
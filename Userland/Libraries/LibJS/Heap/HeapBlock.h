@@ -49,6 +49,18 @@ public:
 
     void deallocate(Cell*);
 
+    // After a collection, blocks are only swept once their CellAllocator needs room, so until then, a cell in this block
+    // that isn't marked is dead, even though it hasn't been destroyed yet.
+    bool needs_sweep() const { return m_needs_sweep; }
+    void set_needs_sweep(bool needs_sweep) { m_needs_sweep = needs_sweep; }
+
+    struct SweepResult {
+        size_t live_cells { 0 };
+        size_t collected_cells { 0 };
+    };
+    // Destroys every cell that wasn't marked, and unmarks the rest.
+    SweepResult sweep();
+
     template<typename Callback>
     void for_each_cell(Callback callback)
     {
@@ -111,6 +123,7 @@ private:
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
     FreelistEntry* m_freelist { nullptr };
+    bool m_needs_sweep { false };
     alignas(Cell) u8 m_storage[];
 
 public:
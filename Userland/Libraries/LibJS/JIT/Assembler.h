@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// Just enough of an x86_64 assembler for the baseline JIT.
+// Memory operands are always [base + disp32], and all jumps use 32-bit displacements,
+// which keeps the encodings uniform at the price of a few bytes here and there.
+class Assembler {
+public:
+    enum class Reg : u8 {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSP = 4,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15,
+    };
+
+    enum class Condition : u8 {
+        Overflow = 0x0,
+        NotOverflow = 0x1,
+        Below = 0x2,
+        AboveOrEqual = 0x3,
+        Equal = 0x4,
+        NotEqual = 0x5,
+        BelowOrEqual = 0x6,
+        Above = 0x7,
+        Sign = 0x8,
+        NotSign = 0x9,
+        LessThan = 0xc,
+        GreaterThanOrEqual = 0xd,
+        LessThanOrEqual = 0xe,
+        GreaterThan = 0xf,
+    };
+
+    enum class ALUOp : u8 {
+        // These are the opcodes of the "op r/m32, r32" forms, the "/digit" of the immediate forms is opcode >> 3.
+        Add = 0x01,
+        Or = 0x09,
+        And = 0x21,
+        Sub = 0x29,
+        Xor = 0x31,
+        Cmp = 0x39,
+    };
+
+    struct Label {
+        Optional<size_t> offset;
+        // Offsets of the rel32 fields that refer to this label.
+        Vector<size_t> jump_slots;
+    };
+
+    explicit Assembler(Vector<u8>& output)
+        : m_output(output)
+    {
+    }
+
+    size_t offset() const { return m_output.size(); }
+
+    void bind(Label& label)
+    {
+        VERIFY(!label.offset.has_value());
+        label.offset = offset();
+    }
+
+    // Fills in all the jumps to labels. Every label that was jumped to must have been bound by now.
+    void link(Label const& label)
+    {
+        VERIFY(label.offset.has_value());
+        for (auto slot : label.jump_slots) {
+            i32 displacement = static_cast<i32>(*label.offset) - static_cast<i32>(slot + 4);
+            for (size_t i = 0; i < 4; ++i)
+                m_output[slot + i] = (static_cast<u32>(displacement) >> (i * 8)) & 0xff;
+        }
+    }
+
+    void mov(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x89);
+        emit_modrm_register(src, dst);
+    }
+
+    void mov(Reg dst, u64 immediate)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xb8 | (to_underlying(dst) & 7));
+        emit64(immediate);
+    }
+
+    // dst = [base + displacement]
+    void load(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(true, dst, base);
+        emit8(0x8b);
+        emit_modrm_memory(dst, base, displacement);
+    }
+
+    // [base + displacement] = src
+    void store(Reg base, i32 displacement, Reg src)
+    {
+        emit_rex(true, src, base);
+        emit8(0x89);
+        emit_modrm_memory(src, base, displacement);
+    }
+
+    // 32-bit arithmetic, which zeroes the upper half of dst (except for Cmp, which doesn't write it).
+    void alu32(ALUOp op, Reg dst, Reg src)
+    {
+        emit_rex(false, src, dst);
+        emit8(to_underlying(op));
+        emit_modrm_register(src, dst);
+    }
+
+    void alu32(ALUOp op, Reg dst, i32 immediate)
+    {
+        emit_rex(false, Reg::RAX, dst);
+        emit8(0x81);
+        emit_modrm_register(static_cast<Reg>(to_underlying(op) >> 3), dst);
+        emit32(immediate);
+    }
+
+    void alu64(ALUOp op, Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(to_underlying(op));
+        emit_modrm_register(src, dst);
+    }
+
+    void alu64(ALUOp op, Reg dst, i32 immediate)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0x81);
+        emit_modrm_register(static_cast<Reg>(to_underlying(op) >> 3), dst);
+        emit32(immediate);
+    }
+
+    void imul32(Reg dst, Reg src)
+    {
+        emit_rex(false, dst, src);
+        emit8(0x0f);
+        emit8(0xaf);
+        emit_modrm_register(dst, src);
+    }
+
+    void test32(Reg lhs, Reg rhs)
+    {
+        emit_rex(false, rhs, lhs);
+        emit8(0x85);
+        emit_modrm_register(rhs, lhs);
+    }
+
+    void test64(Reg lhs, Reg rhs)
+    {
+        emit_rex(true, rhs, lhs);
+        emit8(0x85);
+        emit_modrm_register(rhs, lhs);
+    }
+
+    void test32(Reg lhs, u32 immediate)
+    {
+        emit_rex(false, Reg::RAX, lhs);
+        emit8(0xf7);
+        emit_modrm_register(Reg::RAX, lhs);
+        emit32(immediate);
+    }
+
+    void shift_right64(Reg dst, u8 amount)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xc1);
+        emit_modrm_register(static_cast<Reg>(5), dst);
+        emit8(amount);
+    }
+
+    // dst = condition ? 1 : 0, with the upper bits of dst cleared.
+    void set(Condition condition, Reg dst)
+    {
+        // NOTE: A REX prefix is needed to get at the low byte of anything past rbx.
+        if (to_underlying(dst) >= 4)
+            emit8(0x40 | (to_underlying(dst) >= 8 ? 1 : 0));
+        emit8(0x0f);
+        emit8(0x90 | to_underlying(condition));
+        emit_modrm_register(Reg::RAX, dst);
+
+        // movzx dst32, dst8
+        if (to_underlying(dst) >= 4)
+            emit8(0x40 | (to_underlying(dst) >= 8 ? 0b101 : 0));
+        emit8(0x0f);
+        emit8(0xb6);
+        emit_modrm_register(dst, dst);
+    }
+
+    void jump(Label& label)
+    {
+        emit8(0xe9);
+        emit_label_slot(label);
+    }
+
+    void jump_if(Condition condition, Label& label)
+    {
+        emit8(0x0f);
+        emit8(0x80 | to_underlying(condition));
+        emit_label_slot(label);
+    }
+
+    void jump(Reg target)
+    {
+        emit_rex(false, Reg::RAX, target);
+        emit8(0xff);
+        emit_modrm_register(static_cast<Reg>(4), target);
+    }
+
+    void call(Reg target)
+    {
+        emit_rex(false, Reg::RAX, target);
+        emit8(0xff);
+        emit_modrm_register(static_cast<Reg>(2), target);
+    }
+
+    void push(Reg reg)
+    {
+        if (to_underlying(reg) >= 8)
+            emit8(0x41);
+        emit8(0x50 | (to_underlying(reg) & 7));
+    }
+
+    void pop(Reg reg)
+    {
+        if (to_underlying(reg) >= 8)
+            emit8(0x41);
+        emit8(0x58 | (to_underlying(reg) & 7));
+    }
+
+    void ret() { emit8(0xc3); }
+
+private:
+    void emit8(u8 value) { m_output.append(value); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    // `reg` goes into ModRM.reg, `rm` into ModRM.rm (or the SIB base).
+    void emit_rex(bool wide, Reg reg, Reg rm)
+    {
+        u8 rex = 0x40;
+        if (wide)
+            rex |= 0b1000;
+        if (to_underlying(reg) >= 8)
+            rex |= 0b100;
+        if (to_underlying(rm) >= 8)
+            rex |= 0b1;
+        if (rex != 0x40)
+            emit8(rex);
+    }
+
+    void emit_modrm_register(Reg reg, Reg rm)
+    {
+        emit8(0b11000000 | ((to_underlying(reg) & 7) << 3) | (to_underlying(rm) & 7));
+    }
+
+    void emit_modrm_memory(Reg reg, Reg base, i32 displacement)
+    {
+        // NOTE: We always use the disp32 form, which also sidesteps the special meaning of rbp/r13 with no displacement.
+        emit8(0b10000000 | ((to_underlying(reg) & 7) << 3) | (to_underlying(base) & 7));
+        // rsp and r12 can only be used as a base through a SIB byte.
+        if ((to_underlying(base) & 7) == 4)
+            emit8(0x24);
+        emit32(static_cast<u32>(displacement));
+    }
+
+    void emit_label_slot(Label& label)
+    {
+        label.jump_slots.append(offset());
+        emit32(0);
+    }
+
+    Vector<u8>& m_output;
+};
+
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Platform.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Compiler.h>
+
+namespace JS::JIT {
+
+// NOTE: The native code keeps these in callee-saved registers, so they survive the calls into C++.
+static constexpr auto REGISTERS_BASE = Assembler::Reg::R13;
+static constexpr auto INTERPRETER = Assembler::Reg::R12;
+
+static u64 cxx_run_instruction(Bytecode::Interpreter* interpreter, Bytecode::Instruction const* instruction)
+{
+    return to_underlying(interpreter->run_instruction_for_native_code(*instruction));
+}
+
+static u64 cxx_to_boolean(Value const* value)
+{
+    return value->to_boolean();
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& bytecode_executable)
+{
+#if ARCH(X86_64)
+    Compiler compiler { bytecode_executable };
+
+    for (auto& block : bytecode_executable.basic_blocks)
+        compiler.compile_block(block);
+
+    HashMap<Bytecode::BasicBlock const*, size_t> block_offsets;
+    for (auto& it : compiler.m_block_labels) {
+        compiler.m_assembler.link(*it.value);
+        block_offsets.set(it.key, *it.value->offset);
+    }
+    compiler.m_assembler.link(compiler.m_exit_label);
+
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled {} ({} blocks) into {} bytes of native code", bytecode_executable.name, bytecode_executable.basic_blocks.size(), compiler.m_output.size());
+    return NativeExecutable::try_create(compiler.m_output.span(), move(block_offsets));
+#else
+    (void)bytecode_executable;
+    return nullptr;
+#endif
+}
+
+Compiler::Compiler(Bytecode::Executable const& bytecode_executable)
+    : m_bytecode_executable(bytecode_executable)
+    , m_assembler(m_output)
+{
+    // The common entry point: u64 entry(Value* registers, Interpreter*, void const* block_entry)
+    // Once the callee-saved registers we use are saved, the stack is 16-byte aligned again, as calls want it to be.
+    m_assembler.push(Reg::RBP);
+    m_assembler.mov(Reg::RBP, Reg::RSP);
+    m_assembler.push(INTERPRETER);
+    m_assembler.push(REGISTERS_BASE);
+    m_assembler.mov(REGISTERS_BASE, Reg::RDI);
+    m_assembler.mov(INTERPRETER, Reg::RSI);
+    m_assembler.jump(Reg::RDX);
+
+    // Everything that leaves native code comes through here, with the ExitReason in rax.
+    m_assembler.bind(m_exit_label);
+    m_assembler.pop(REGISTERS_BASE);
+    m_assembler.pop(INTERPRETER);
+    m_assembler.pop(Reg::RBP);
+    m_assembler.ret();
+}
+
+Assembler::Label& Compiler::label_for(Bytecode::BasicBlock const& block)
+{
+    return *m_block_labels.ensure(&block, [] { return make<Assembler::Label>(); });
+}
+
+void Compiler::compile_block(Bytecode::BasicBlock const& block)
+{
+    m_assembler.bind(label_for(block));
+
+    Bytecode::InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        ++it;
+        compile_instruction(instruction);
+        // Whatever comes after a terminator is never run.
+        if (instruction.is_terminator())
+            break;
+    }
+
+    m_assembler.mov(Reg::RAX, to_underlying(ExitReason::FellOffBlock));
+    m_assembler.jump(m_exit_label);
+}
+
+void Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    using Type = Bytecode::Instruction::Type;
+    using ALUOp = Assembler::ALUOp;
+    using Condition = Assembler::Condition;
+
+    switch (instruction.type()) {
+    case Type::Load:
+        return compile_load(static_cast<Bytecode::Op::Load const&>(instruction));
+    case Type::LoadImmediate:
+        return compile_load_immediate(static_cast<Bytecode::Op::LoadImmediate const&>(instruction));
+    case Type::Store:
+        return compile_store(static_cast<Bytecode::Op::Store const&>(instruction));
+    case Type::Jump:
+        return compile_jump(static_cast<Bytecode::Op::Jump const&>(instruction));
+    case Type::JumpConditional:
+        return compile_jump_conditional(static_cast<Bytecode::Op::JumpConditional const&>(instruction));
+    case Type::JumpNullish:
+        return compile_jump_if_tag_matches(static_cast<Bytecode::Op::Jump const&>(instruction), IS_NULLISH_EXTRACT_PATTERN, IS_NULLISH_PATTERN);
+    case Type::JumpUndefined:
+        return compile_jump_if_tag_matches(static_cast<Bytecode::Op::Jump const&>(instruction), 0xffff, UNDEFINED_TAG);
+    case Type::Increment:
+        return compile_increment_or_decrement(instruction, ALUOp::Add);
+    case Type::Decrement:
+        return compile_increment_or_decrement(instruction, ALUOp::Sub);
+    case Type::Add:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::Add const&>(instruction).lhs());
+    case Type::Sub:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::Sub const&>(instruction).lhs());
+    case Type::Mul:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::Mul const&>(instruction).lhs());
+    case Type::BitwiseAnd:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::BitwiseAnd const&>(instruction).lhs());
+    case Type::BitwiseOr:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::BitwiseOr const&>(instruction).lhs());
+    case Type::BitwiseXor:
+        return compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::BitwiseXor const&>(instruction).lhs());
+    case Type::LessThan:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::LessThan const&>(instruction).lhs(), Condition::LessThan);
+    case Type::LessThanEquals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::LessThanEquals const&>(instruction).lhs(), Condition::LessThanOrEqual);
+    case Type::GreaterThan:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::GreaterThan const&>(instruction).lhs(), Condition::GreaterThan);
+    case Type::GreaterThanEquals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::GreaterThanEquals const&>(instruction).lhs(), Condition::GreaterThanOrEqual);
+    case Type::StrictlyEquals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::StrictlyEquals const&>(instruction).lhs(), Condition::Equal);
+    case Type::LooselyEquals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::LooselyEquals const&>(instruction).lhs(), Condition::Equal);
+    case Type::StrictlyInequals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::StrictlyInequals const&>(instruction).lhs(), Condition::NotEqual);
+    case Type::LooselyInequals:
+        return compile_int32_comparison(instruction, static_cast<Bytecode::Op::LooselyInequals const&>(instruction).lhs(), Condition::NotEqual);
+    default:
+        return compile_generic(instruction);
+    }
+}
+
+void Compiler::load_register(Reg dst, Bytecode::Register reg)
+{
+    m_assembler.load(dst, REGISTERS_BASE, reg.index() * sizeof(Value));
+}
+
+void Compiler::store_register(Bytecode::Register reg, Reg src)
+{
+    m_assembler.store(REGISTERS_BASE, reg.index() * sizeof(Value), src);
+}
+
+// NOTE: This clobbers rdx.
+void Compiler::jump_unless_int32(Reg value, Assembler::Label& label)
+{
+    m_assembler.mov(Reg::RDX, value);
+    m_assembler.shift_right64(Reg::RDX, TAG_SHIFT);
+    m_assembler.alu64(Assembler::ALUOp::Cmp, Reg::RDX, INT32_TAG);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, label);
+}
+
+// Turns the 32 bits at the bottom of `value` (with the top ones clear) into an Int32 Value. This clobbers rdx.
+void Compiler::box_int32(Reg value)
+{
+    m_assembler.mov(Reg::RDX, SHIFTED_INT32_TAG);
+    m_assembler.alu64(Assembler::ALUOp::Or, value, Reg::RDX);
+}
+
+// Turns a 0 or 1 in `value` into a Boolean Value. This clobbers rdx.
+void Compiler::box_boolean(Reg value)
+{
+    m_assembler.mov(Reg::RDX, BOOLEAN_TAG << TAG_SHIFT);
+    m_assembler.alu64(Assembler::ALUOp::Or, value, Reg::RDX);
+}
+
+void Compiler::call_helper(void const* function)
+{
+    m_assembler.mov(Reg::RAX, reinterpret_cast<u64>(function));
+    m_assembler.call(Reg::RAX);
+}
+
+void Compiler::compile_generic(Bytecode::Instruction const& instruction)
+{
+    m_assembler.mov(Reg::RDI, INTERPRETER);
+    m_assembler.mov(Reg::RSI, reinterpret_cast<u64>(&instruction));
+    call_helper(reinterpret_cast<void const*>(&cxx_run_instruction));
+    m_assembler.test64(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, m_exit_label);
+}
+
+void Compiler::compile_load(Bytecode::Op::Load const& instruction)
+{
+    load_register(Reg::RAX, instruction.src());
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_load_immediate(Bytecode::Op::LoadImmediate const& instruction)
+{
+    m_assembler.mov(Reg::RAX, instruction.value().encoded());
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_store(Bytecode::Op::Store const& instruction)
+{
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    store_register(instruction.dst(), Reg::RAX);
+}
+
+void Compiler::compile_jump(Bytecode::Op::Jump const& instruction)
+{
+    m_assembler.jump(label_for(instruction.true_target()->block()));
+}
+
+void Compiler::compile_jump_conditional(Bytecode::Op::JumpConditional const& instruction)
+{
+    auto& true_label = label_for(instruction.true_target()->block());
+    auto& false_label = label_for(instruction.false_target()->block());
+    Assembler::Label not_boolean;
+    Assembler::Label slow_case;
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+
+    m_assembler.mov(Reg::RDX, Reg::RAX);
+    m_assembler.shift_right64(Reg::RDX, TAG_SHIFT);
+    m_assembler.alu64(Assembler::ALUOp::Cmp, Reg::RDX, BOOLEAN_TAG);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, not_boolean);
+    m_assembler.test32(Reg::RAX, 1);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_label);
+    m_assembler.jump(false_label);
+
+    m_assembler.bind(not_boolean);
+    jump_unless_int32(Reg::RAX, slow_case);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_label);
+    m_assembler.jump(false_label);
+
+    m_assembler.bind(slow_case);
+    m_assembler.mov(Reg::RDI, REGISTERS_BASE);
+    call_helper(reinterpret_cast<void const*>(&cxx_to_boolean));
+    m_assembler.test64(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_label);
+    m_assembler.jump(false_label);
+
+    m_assembler.link(not_boolean);
+    m_assembler.link(slow_case);
+}
+
+void Compiler::compile_jump_if_tag_matches(Bytecode::Op::Jump const& instruction, u16 tag_mask, u16 tag)
+{
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.shift_right64(Reg::RAX, TAG_SHIFT);
+    m_assembler.alu32(Assembler::ALUOp::And, Reg::RAX, tag_mask);
+    m_assembler.alu32(Assembler::ALUOp::Cmp, Reg::RAX, tag);
+    m_assembler.jump_if(Assembler::Condition::Equal, label_for(instruction.true_target()->block()));
+    m_assembler.jump(label_for(instruction.false_target()->block()));
+}
+
+void Compiler::compile_increment_or_decrement(Bytecode::Instruction const& instruction, Assembler::ALUOp op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    jump_unless_int32(Reg::RAX, slow_case);
+    m_assembler.alu32(op, Reg::RAX, 1);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    box_int32(Reg::RAX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.bind(slow_case);
+    compile_generic(instruction);
+    m_assembler.bind(done);
+
+    m_assembler.link(slow_case);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_int32_arithmetic(Bytecode::Instruction const& instruction, Bytecode::Register lhs)
+{
+    using Type = Bytecode::Instruction::Type;
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, lhs);
+    load_register(Reg::RCX, Bytecode::Register::accumulator());
+    jump_unless_int32(Reg::RAX, slow_case);
+    jump_unless_int32(Reg::RCX, slow_case);
+
+    switch (instruction.type()) {
+    case Type::Add:
+        m_assembler.alu32(Assembler::ALUOp::Add, Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Type::Sub:
+        m_assembler.alu32(Assembler::ALUOp::Sub, Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Type::Mul: {
+        Assembler::Label nonzero_result;
+        m_assembler.mov(Reg::RDX, Reg::RAX);
+        m_assembler.imul32(Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        m_assembler.test32(Reg::RAX, Reg::RAX);
+        m_assembler.jump_if(Assembler::Condition::NotEqual, nonzero_result);
+        // A zero result from a negative operand is -0, which isn't an Int32.
+        m_assembler.alu32(Assembler::ALUOp::Or, Reg::RDX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Sign, slow_case);
+        m_assembler.bind(nonzero_result);
+        m_assembler.link(nonzero_result);
+        break;
+    }
+    case Type::BitwiseAnd:
+        m_assembler.alu32(Assembler::ALUOp::And, Reg::RAX, Reg::RCX);
+        break;
+    case Type::BitwiseOr:
+        m_assembler.alu32(Assembler::ALUOp::Or, Reg::RAX, Reg::RCX);
+        break;
+    case Type::BitwiseXor:
+        m_assembler.alu32(Assembler::ALUOp::Xor, Reg::RAX, Reg::RCX);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    box_int32(Reg::RAX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.bind(slow_case);
+    compile_generic(instruction);
+    m_assembler.bind(done);
+
+    m_assembler.link(slow_case);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_int32_comparison(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Assembler::Condition condition)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, lhs);
+    load_register(Reg::RCX, Bytecode::Register::accumulator());
+    jump_unless_int32(Reg::RAX, slow_case);
+    jump_unless_int32(Reg::RCX, slow_case);
+
+    m_assembler.alu32(Assembler::ALUOp::Cmp, Reg::RAX, Reg::RCX);
+    m_assembler.set(condition, Reg::RAX);
+    box_boolean(Reg::RAX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.bind(slow_case);
+    compile_generic(instruction);
+    m_assembler.bind(done);
+
+    m_assembler.link(slow_case);
+    m_assembler.link(done);
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::Bytecode::Op {
+class Jump;
+class JumpConditional;
+class Load;
+class LoadImmediate;
+class Store;
+}
+
+namespace JS::JIT {
+
+// A baseline JIT, which turns every instruction of an executable into a call to its existing implementation,
+// except for the simple ones and the Int32 cases of arithmetic and comparisons, which it emits inline.
+class Compiler {
+public:
+    // How many calls and jumps an executable has to go through before it gets compiled.
+    static constexpr u32 hotness_threshold = 1000;
+
+    // Returns nullptr if there's no JIT for this architecture, or the code couldn't be set up.
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+    explicit Compiler(Bytecode::Executable const&);
+
+    using Reg = Assembler::Reg;
+
+    void compile_block(Bytecode::BasicBlock const&);
+    void compile_instruction(Bytecode::Instruction const&);
+
+    void compile_load(Bytecode::Op::Load const&);
+    void compile_load_immediate(Bytecode::Op::LoadImmediate const&);
+    void compile_store(Bytecode::Op::Store const&);
+    void compile_jump(Bytecode::Op::Jump const&);
+    void compile_jump_conditional(Bytecode::Op::JumpConditional const&);
+    // JumpNullish and JumpUndefined, which only differ in the tags they look for.
+    void compile_jump_if_tag_matches(Bytecode::Op::Jump const&, u16 tag_mask, u16 tag);
+    void compile_increment_or_decrement(Bytecode::Instruction const&, Assembler::ALUOp);
+    void compile_int32_arithmetic(Bytecode::Instruction const&, Bytecode::Register lhs);
+    void compile_int32_comparison(Bytecode::Instruction const&, Bytecode::Register lhs, Assembler::Condition);
+
+    // Calls the instruction's own implementation, and leaves native code if it asks for anything but carrying on.
+    void compile_generic(Bytecode::Instruction const&);
+
+    void load_register(Reg dst, Bytecode::Register);
+    void store_register(Bytecode::Register, Reg src);
+    void jump_unless_int32(Reg value, Assembler::Label& label);
+    void box_int32(Reg value);
+    void box_boolean(Reg value);
+    void call_helper(void const* function);
+
+    Assembler::Label& label_for(Bytecode::BasicBlock const&);
+
+    Bytecode::Executable const& m_bytecode_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler;
+    HashMap<Bytecode::BasicBlock const*, NonnullOwnPtr<Assembler::Label>> m_block_labels;
+    Assembler::Label m_exit_label;
+};
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+OwnPtr<NativeExecutable> NativeExecutable::try_create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+{
+    // NOTE: The code is written while the memory is writable and only then made executable, as we don't get to have both at once.
+    auto* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to allocate {} bytes for native code", code.size());
+        return nullptr;
+    }
+    __builtin_memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to make native code executable");
+        munmap(memory, code.size());
+        return nullptr;
+    }
+
+    auto* executable = new (nothrow) NativeExecutable(memory, code.size(), move(block_offsets));
+    if (!executable) {
+        munmap(memory, code.size());
+        return nullptr;
+    }
+    return adopt_own(*executable);
+}
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_offsets(move(block_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    munmap(m_code, m_size);
+}
+
+ExitReason NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers, Bytecode::BasicBlock const& block) const
+{
+    // The code starts out with a common prologue, which jumps to the block entry it's given.
+    using EntryPoint = u64 (*)(Value* registers, Bytecode::Interpreter*, void const* block_entry);
+    auto entry_point = reinterpret_cast<EntryPoint>(m_code);
+    auto block_offset = m_block_offsets.get(&block);
+    VERIFY(block_offset.has_value());
+    return static_cast<ExitReason>(entry_point(registers, &interpreter, static_cast<u8 const*>(m_code) + *block_offset));
+}
+
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Why native code handed control back to the interpreter loop.
+enum class ExitReason : u64 {
+    // Only used by the instruction helpers, never returned from native code.
+    Continue = 0,
+    // The end of a block was reached without jumping anywhere, which ends the executable.
+    FellOffBlock,
+    // An instruction asked the interpreter to jump to a block (see Interpreter::jump()).
+    Jump,
+    // An instruction set the return value.
+    Return,
+    // An instruction threw; the exception is in the interpreter's saved exception.
+    Exception,
+};
+
+// The machine code for a Bytecode::Executable, with an entry point for every basic block.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    static OwnPtr<NativeExecutable> try_create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+    ~NativeExecutable();
+
+    // Runs the code for `block` (and whatever it jumps to) until something needs the interpreter loop.
+    ExitReason run(Bytecode::Interpreter&, Value* registers, Bytecode::BasicBlock const& block) const;
+
+private:
+    NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_offsets;
+};
+
+}
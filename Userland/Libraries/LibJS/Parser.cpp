@@ -276,6 +276,9 @@ private:
     bool m_contains_await_expression { false };
 };
 
+// NOTE: Parsing the body of a small function again takes longer than the nodes for it would save.
+static constexpr size_t minimum_source_length_for_lazily_parsed_function = 128;
+
 class OperatorPrecedenceTable {
 public:
     constexpr OperatorPrecedenceTable()
@@ -410,6 +413,25 @@ Parser::Parser(Lexer lexer, Program::Type program_type, Optional<EvalInitialStat
     }
 }
 
+NonnullRefPtr<FunctionBody> Parser::parse_lazily_parsed_function_body(FunctionBody::LazilyParsedSource const& source, StringView filename)
+{
+    Lexer lexer { source.function_source_text, filename, source.function_start.line, source.function_start.column };
+    Parser parser { move(lexer), source.program_type };
+    parser.m_state.strict_mode = source.starts_in_strict_mode;
+    parser.m_state.parse_next_function_body_eagerly = true;
+
+    // NOTE: Nothing about the code around the function but its strictness affects its body, so an empty program
+    //       is enough of a scope to parse it in.
+    auto program = adopt_ref(*new Program({ filename, {}, {} }, source.program_type));
+    ScopePusher program_scope = ScopePusher::program_scope(parser, *program);
+    auto function = parser.parse_function_node<FunctionExpression>();
+
+    // The function was parsed without errors before, so it must be parsed the same way again.
+    VERIFY(!parser.has_errors());
+    VERIFY(is<FunctionBody>(function->body()));
+    return static_cast<FunctionBody&>(const_cast<Statement&>(function->body()));
+}
+
 Associativity Parser::operator_associativity(TokenType type) const
 {
     switch (type) {
@@ -1382,6 +1404,9 @@ Parser::PrimaryExpressionParseResult Parser::parse_primary_expression()
             if (auto arrow_function_result = try_arrow_function_parse_or_fail(paren_position, true))
                 return { arrow_function_result.release_nonnull(), false };
         }
+        // NOTE: A function in parentheses is most likely called right away, so its body isn't worth parsing lazily.
+        if (match(TokenType::Function))
+            m_state.parse_next_function_body_eagerly = true;
         auto expression = parse_expression(0);
         consume(TokenType::ParenClose);
         if (is<FunctionExpression>(*expression)) {
@@ -1861,6 +1886,8 @@ NonnullRefPtr<TemplateLiteral> Parser::parse_template_literal(bool is_tagged)
 {
     auto rule_start = push_start();
     consume(TokenType::TemplateLiteralStart);
+    if (is_tagged)
+        m_has_tagged_template_literals = true;
 
     NonnullRefPtrVector<Expression> expressions;
     NonnullRefPtrVector<Expression> raw_strings;
@@ -2534,6 +2561,13 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options, Op
         : push_start();
     VERIFY(!(parse_options & FunctionNodeParseOptions::IsGetterFunction && parse_options & FunctionNodeParseOptions::IsSetterFunction));
 
+    // NOTE: Only the bodies of plain function declarations and expressions outside of classes are parsed lazily, as
+    //       nothing but the strictness of the code around them affects how they're parsed.
+    auto must_parse_body_eagerly = exchange(m_state.parse_next_function_body_eagerly, false);
+    auto can_parse_body_lazily = !must_parse_body_eagerly
+        && parse_options == FunctionNodeParseOptions::CheckForFunctionAndName
+        && !m_state.referenced_private_names;
+
     TemporaryChange super_property_access_rollback(m_state.allow_super_property_lookup, !!(parse_options & FunctionNodeParseOptions::AllowSuperPropertyLookup));
     TemporaryChange super_constructor_call_rollback(m_state.allow_super_constructor_call, !!(parse_options & FunctionNodeParseOptions::AllowSuperConstructorCall));
     TemporaryChange break_context_rollback(m_state.in_break_context, false);
@@ -2610,6 +2644,15 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options, Op
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
     auto source_text = String { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+
+    if (can_parse_body_lazily && !has_errors() && source_text.length() >= minimum_source_length_for_lazily_parsed_function) {
+        auto lazily_parsed_body = create_ast_node<FunctionBody>(body->source_range());
+        if (body->in_strict_mode())
+            lazily_parsed_body->set_strict_mode();
+        lazily_parsed_body->set_lazily_parsed_source({ source_text, rule_start.position(), m_program_type, m_state.strict_mode });
+        body = move(lazily_parsed_body);
+    }
+
     return create_ast_node<FunctionNodeType>(
         { m_state.current_token.filename(), rule_start.position(), position() },
         name, move(source_text), move(body), move(parameters), function_length,
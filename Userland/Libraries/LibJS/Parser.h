@@ -54,6 +54,8 @@ public:
 
     NonnullRefPtr<Program> parse_program(bool starts_in_strict_mode = false);
 
+    static NonnullRefPtr<FunctionBody> parse_lazily_parsed_function_body(FunctionBody::LazilyParsedSource const&, StringView filename);
+
     template<typename FunctionNodeType>
     NonnullRefPtr<FunctionNodeType> parse_function_node(u8 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName, Optional<Position> const& function_start = {});
     Vector<FunctionNode::Parameter> parse_formal_parameters(int& function_length, u8 parse_options = 0);
@@ -202,6 +204,9 @@ public:
 
     bool has_errors() const { return m_state.errors.size(); }
     Vector<Error> const& errors() const { return m_state.errors; }
+
+    // Tagged templates have a template object per parse node and realm, so programs with them can't be parsed once and reused.
+    bool has_tagged_template_literals() const { return m_has_tagged_template_literals; }
     void print_errors(bool print_hint = true) const
     {
         for (auto& error : m_state.errors) {
@@ -325,6 +330,7 @@ private:
         bool in_class_field_initializer { false };
         bool in_class_static_init_block { false };
         bool function_might_need_arguments_object { false };
+        bool parse_next_function_body_eagerly { false };
 
         ParserState(Lexer, Program::Type);
     };
@@ -348,5 +354,6 @@ private:
     Vector<ParserState> m_saved_state;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
     Program::Type m_program_type;
+    bool m_has_tagged_template_literals { false };
 };
 }
@@ -690,12 +690,14 @@ ThrowCompletionOr<Value> perform_eval(VM& vm, Value x, CallerMode strict_caller,
         if (Bytecode::g_dump_bytecode)
             executable->dump();
         auto result_or_error = bytecode_interpreter->run_and_return_frame(*executable, nullptr);
+        if (!result_or_error.value.is_error()) {
+            auto& result = result_or_error.frame->registers[0];
+            if (!result.is_empty())
+                eval_result = result;
+        }
+        bytecode_interpreter->recycle_register_window(result_or_error.frame.release_nonnull());
         if (result_or_error.value.is_error())
             return result_or_error.value.release_error();
-
-        auto& result = result_or_error.frame->registers[0];
-        if (!result.is_empty())
-            eval_result = result;
     } else {
         auto& ast_interpreter = vm.interpreter();
         eval_result = TRY(program->execute(ast_interpreter));
@@ -9,6 +9,7 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -28,6 +29,31 @@ namespace JS {
 
 static HashTable<Object*> s_array_join_seen_objects;
 
+// NOTE: HasProperty is true and Get returns the value for any index of an Array that has an own data property, so
+//       the built-ins below look at those elements directly, rather than going through the generic operations.
+
+// The element at the given index, if the object is an Array with an own data property there.
+static Optional<Value> own_array_element(Object const& object, size_t index)
+{
+    if (!is<Array>(object))
+        return {};
+    auto element = object.indexed_properties().get(index);
+    if (!element.has_value() || element->value.is_accessor())
+        return {};
+    return element->value;
+}
+
+// The first `length` elements of an Array that keeps at least that many of them packed in simple storage.
+static Optional<Span<Value const>> packed_array_elements(Object const& object, size_t length)
+{
+    if (!is<Array>(object))
+        return {};
+    auto elements = object.indexed_properties().packed_elements();
+    if (!elements.has_value() || elements->size() < length)
+        return {};
+    return elements->trim(length);
+}
+
 ArrayPrototype::ArrayPrototype(Realm& realm)
     : Array(*realm.global_object().object_prototype())
 {
@@ -704,17 +730,18 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::for_each)
         auto property_key = PropertyKey { k };
 
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
-
         // c. If kPresent is true, then
-        if (k_present) {
-            // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
-
-            // ii. Perform ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
-            TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
+        //     i. Let kValue be ? Get(O, Pk).
+        auto k_value = own_array_element(*object, k);
+        if (!k_value.has_value()) {
+            if (!TRY(object->has_property(property_key)))
+                continue;
+            k_value = TRY(object->get(property_key));
         }
 
+        // ii. Perform ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
+        TRY(call(vm, callback_function.as_function(), this_arg, *k_value, Value(k), object));
+
         // d. Set k to k + 1.
     }
 
@@ -902,6 +929,24 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
             from_index = from_argument;
     }
     auto value_to_find = vm.argument(0);
+    if (auto elements = packed_array_elements(*this_object, length); elements.has_value()) {
+        auto element_kind = this_object->indexed_properties().element_kind();
+        if (has_only_numbers(element_kind) && !value_to_find.is_number())
+            return Value(false);
+        if (has_only_int32s(element_kind) && value_to_find.is_int32()) {
+            auto int32_to_find = value_to_find.as_i32();
+            for (u64 i = from_index; i < length; ++i) {
+                if ((*elements)[i].as_i32() == int32_to_find)
+                    return Value(true);
+            }
+            return Value(false);
+        }
+        for (u64 i = from_index; i < length; ++i) {
+            if (same_value_zero((*elements)[i], value_to_find))
+                return Value(true);
+        }
+        return Value(false);
+    }
     for (u64 i = from_index; i < length; ++i) {
         auto element = TRY(this_object->get(i));
         if (same_value_zero(element, value_to_find))
@@ -956,6 +1001,24 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
     }
 
     // 10. Repeat, while k < len,
+    if (auto elements = packed_array_elements(*object, length); elements.has_value()) {
+        auto element_kind = object->indexed_properties().element_kind();
+        if (has_only_numbers(element_kind) && !search_element.is_number())
+            return Value(-1);
+        if (has_only_int32s(element_kind) && search_element.is_int32()) {
+            auto int32_to_find = search_element.as_i32();
+            for (; k < length; ++k) {
+                if ((*elements)[k].as_i32() == int32_to_find)
+                    return Value(k);
+            }
+            return Value(-1);
+        }
+        for (; k < length; ++k) {
+            if (is_strictly_equal(search_element, (*elements)[k]))
+                return Value(k);
+        }
+        return Value(-1);
+    }
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
 
@@ -1067,6 +1130,24 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
     }
 
     // 8. Repeat, while k ≥ 0,
+    if (auto elements = packed_array_elements(*object, length); elements.has_value()) {
+        auto element_kind = object->indexed_properties().element_kind();
+        if (has_only_numbers(element_kind) && !search_element.is_number())
+            return Value(-1);
+        if (has_only_int32s(element_kind) && search_element.is_int32()) {
+            auto int32_to_find = search_element.as_i32();
+            for (; k >= 0; --k) {
+                if ((*elements)[k].as_i32() == int32_to_find)
+                    return Value((size_t)k);
+            }
+            return Value(-1);
+        }
+        for (; k >= 0; --k) {
+            if (is_strictly_equal(search_element, (*elements)[k]))
+                return Value((size_t)k);
+        }
+        return Value(-1);
+    }
     for (; k >= 0; --k) {
         auto property_key = PropertyKey { k };
 
@@ -1119,19 +1200,20 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         auto property_key = PropertyKey { k };
 
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
-
         // c. If kPresent is true, then
-        if (k_present) {
-            // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+        //     i. Let kValue be ? Get(O, Pk).
+        auto k_value = own_array_element(*object, k);
+        if (!k_value.has_value()) {
+            if (!TRY(object->has_property(property_key)))
+                continue;
+            k_value = TRY(object->get(property_key));
+        }
 
-            // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
-            auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
+        // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
+        auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, *k_value, Value(k), object));
 
-            // iii. Perform ? CreateDataPropertyOrThrow(A, Pk, mappedValue).
-            TRY(array->create_data_property_or_throw(property_key, mapped_value));
-        }
+        // iii. Perform ? CreateDataPropertyOrThrow(A, Pk, mappedValue).
+        TRY(array->create_data_property_or_throw(property_key, mapped_value));
 
         // d. Set k to k + 1.
     }
@@ -1555,6 +1637,28 @@ ThrowCompletionOr<void> array_merge_sort(VM& vm, Function<ThrowCompletionOr<doub
     return {};
 }
 
+// What ToString would make of an int32, written to the end of the given buffer.
+static StringView int32_to_string(i32 value, Span<char> buffer)
+{
+    auto magnitude = value < 0 ? 0u - static_cast<u32>(value) : static_cast<u32>(value);
+    auto start = buffer.size();
+    do {
+        buffer[--start] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        buffer[--start] = '-';
+    return { buffer.offset(start), buffer.size() - start };
+}
+
+// Whether CompareArrayElements without a comparefn puts a before b, without making the strings it compares.
+static bool int32_sorts_before(i32 a, i32 b)
+{
+    char a_buffer[11];
+    char b_buffer[11];
+    return int32_to_string(a, a_buffer) < int32_to_string(b, b_buffer);
+}
+
 // 23.1.3.30 Array.prototype.sort ( comparefn ), https://tc39.es/ecma262/#sec-array.prototype.sort
 // 1.1.1.1 Array.prototype.sort ( comparefn ), https://tc39.es/proposal-change-array-by-copy/#sec-array.prototype.sort
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
@@ -1570,6 +1674,22 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 3. Let len be ? LengthOfArrayLike(obj).
     auto length = TRY(length_of_array_like(vm, *object));
 
+    // NOTE: Nothing can observe how int32 elements are sorted when there's no comparefn, so we don't have to go through
+    //       the steps below, which would make strings out of them for every comparison. As they'd be equal as strings
+    //       only if they're equal, the sort doesn't have to be stable either.
+    if (comparefn.is_undefined()) {
+        if (auto elements = packed_array_elements(*object, length); elements.has_value() && has_only_int32s(object->indexed_properties().element_kind())) {
+            Vector<i32> sorted_values;
+            sorted_values.ensure_capacity(length);
+            for (auto element : *elements)
+                sorted_values.unchecked_append(element.as_i32());
+            quick_sort(sorted_values, int32_sorts_before);
+            for (size_t j = 0; j < length; ++j)
+                TRY(object->set(j, Value(sorted_values[j]), Object::ShouldThrowExceptions::Yes));
+            return object;
+        }
+    }
+
     // 4. Let SortCompare be a new Abstract Closure with parameters (x, y) that captures comparefn and performs the following steps when called:
     Function<ThrowCompletionOr<double>(Value, Value)> sort_compare = [&](auto x, auto y) -> ThrowCompletionOr<double> {
         // a. Return ? CompareArrayElements(x, y, comparefn).
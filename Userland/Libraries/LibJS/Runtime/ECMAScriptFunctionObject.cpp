@@ -443,11 +443,13 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
                     argument_value = execution_context_arguments[i];
                 } else if (parameter.default_value) {
                     if (auto* bytecode_interpreter = Bytecode::Interpreter::current()) {
-                        auto value_and_frame = bytecode_interpreter->run_and_return_frame(*m_default_parameter_bytecode_executables[default_parameter_index - 1], nullptr);
+                        auto value_and_frame = bytecode_interpreter->run_and_return_frame(m_bytecode_executables->default_parameters[default_parameter_index - 1], nullptr);
+                        // Resulting value is in the accumulator.
+                        if (!value_and_frame.value.is_error())
+                            argument_value = value_and_frame.frame->registers.at(0);
+                        bytecode_interpreter->recycle_register_window(value_and_frame.frame.release_nonnull());
                         if (value_and_frame.value.is_error())
                             return value_and_frame.value.release_error();
-                        // Resulting value is in the accumulator.
-                        argument_value = value_and_frame.frame->registers.at(0);
                     } else if (interpreter) {
                         argument_value = TRY(parameter.default_value->execute(*interpreter)).release_value();
                     }
@@ -785,8 +787,17 @@ Completion ECMAScriptFunctionObject::ordinary_call_evaluate_body()
     if (m_kind == FunctionKind::AsyncGenerator)
         return vm.throw_completion<InternalError>(ErrorType::NotImplemented, "Async Generator function execution");
 
+    // NOTE: The body might only have been validated so far, in which case it is parsed now that it's needed.
+    if (is<FunctionBody>(*m_ecmascript_code))
+        static_cast<FunctionBody const&>(*m_ecmascript_code).ensure_parsed();
+
     if (bytecode_interpreter) {
-        if (!m_bytecode_executable) {
+        // NOTE: Function bodies keep the bytecode generated for them, so it's shared by every function object made from the same code.
+        auto const* function_body = is<FunctionBody>(*m_ecmascript_code) ? static_cast<FunctionBody const*>(m_ecmascript_code.ptr()) : nullptr;
+        if (!m_bytecode_executables && function_body)
+            m_bytecode_executables = function_body->bytecode_executables();
+
+        if (!m_bytecode_executables) {
             auto compile = [&](auto& node, auto kind, auto name) -> ThrowCompletionOr<NonnullOwnPtr<Bytecode::Executable>> {
                 auto executable_result = Bytecode::Generator::generate(node, kind);
                 if (executable_result.is_error())
@@ -806,20 +817,30 @@ Completion ECMAScriptFunctionObject::ordinary_call_evaluate_body()
                 return bytecode_executable;
             };
 
-            m_bytecode_executable = TRY(compile(*m_ecmascript_code, m_kind, m_name));
+            auto body_executable = TRY(compile(*m_ecmascript_code, m_kind, m_name));
 
             size_t default_parameter_index = 0;
+            NonnullOwnPtrVector<Bytecode::Executable> default_parameter_executables;
             for (auto& parameter : m_formal_parameters) {
                 if (!parameter.default_value)
                     continue;
                 auto executable = TRY(compile(*parameter.default_value, FunctionKind::Normal, String::formatted("default parameter #{} for {}", default_parameter_index, m_name)));
-                m_default_parameter_bytecode_executables.append(move(executable));
+                default_parameter_executables.append(move(executable));
             }
+
+            m_bytecode_executables = adopt_ref(*new Bytecode::FunctionExecutables(move(body_executable), move(default_parameter_executables)));
+            if (function_body)
+                function_body->set_bytecode_executables(*m_bytecode_executables);
         }
         TRY(function_declaration_instantiation(nullptr));
-        auto result_and_frame = bytecode_interpreter->run_and_return_frame(*m_bytecode_executable, nullptr);
+        auto result_and_frame = bytecode_interpreter->run_and_return_frame(*m_bytecode_executables->body, nullptr);
 
         VERIFY(result_and_frame.frame != nullptr);
+
+        // NOTE: Only a generator needs the frame after it has returned.
+        if (m_kind == FunctionKind::Normal || result_and_frame.value.is_error())
+            bytecode_interpreter->recycle_register_window(result_and_frame.frame.release_nonnull());
+
         if (result_and_frame.value.is_error())
             return result_and_frame.value.release_error();
 
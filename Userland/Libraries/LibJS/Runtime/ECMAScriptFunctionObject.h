@@ -52,7 +52,7 @@ public:
 
     void set_is_class_constructor() { m_is_class_constructor = true; };
 
-    auto& bytecode_executable() const { return m_bytecode_executable; }
+    Bytecode::Executable const* bytecode_executable() const { return m_bytecode_executables ? m_bytecode_executables->body.ptr() : nullptr; }
 
     Environment* environment() { return m_environment; }
     virtual Realm* realm() const override { return m_realm; }
@@ -105,8 +105,7 @@ private:
     ThrowCompletionOr<void> function_declaration_instantiation(Interpreter*);
 
     FlyString m_name;
-    OwnPtr<Bytecode::Executable> m_bytecode_executable;
-    Vector<OwnPtr<Bytecode::Executable>> m_default_parameter_bytecode_executables;
+    RefPtr<Bytecode::FunctionExecutables> m_bytecode_executables;
     i32 m_function_length { 0 };
 
     // Internal Slots of ECMAScript Function Objects, https://tc39.es/ecma262/#table-internal-slots-of-ecmascript-function-objects
@@ -37,9 +37,13 @@ bool FinalizationRegistry::remove_by_token(Cell& unregister_token)
 
 void FinalizationRegistry::remove_dead_cells(Badge<Heap>)
 {
+    // NOTE: A registry that died itself won't be around to run any cleanup jobs.
+    if (!is_marked())
+        return;
+
     auto any_cells_were_removed = false;
     for (auto& record : m_records) {
-        if (!record.target || record.target->state() == Cell::State::Live)
+        if (!record.target || record.target->is_marked())
             continue;
         record.target = nullptr;
         any_cells_were_removed = true;
@@ -302,11 +302,15 @@ void GlobalObject::initialize_global_object(Realm& realm)
     // 27.6.1.1 AsyncGenerator.prototype.constructor, https://tc39.es/ecma262/#sec-asyncgenerator-prototype-constructor
     m_async_generator_prototype->define_direct_property(vm.names.constructor, m_async_generator_function_prototype, Attribute::Configurable);
 
+    m_array_prototype_push_function = &m_array_prototype->get_without_side_effects(vm.names.push).as_function();
     m_array_prototype_values_function = &m_array_prototype->get_without_side_effects(vm.names.values).as_function();
     m_date_constructor_now_function = &m_date_constructor->get_without_side_effects(vm.names.now).as_function();
     m_eval_function = &get_without_side_effects(vm.names.eval).as_function();
     m_json_parse_function = &get_without_side_effects(vm.names.JSON).as_object().get_without_side_effects(vm.names.parse).as_function();
+    m_math_abs_function = &get_without_side_effects(vm.names.Math).as_object().get_without_side_effects(vm.names.abs).as_function();
+    m_math_floor_function = &get_without_side_effects(vm.names.Math).as_object().get_without_side_effects(vm.names.floor).as_function();
     m_object_prototype_to_string_function = &m_object_prototype->get_without_side_effects(vm.names.toString).as_function();
+    m_string_prototype_char_code_at_function = &m_string_prototype->get_without_side_effects(vm.names.charCodeAt).as_function();
 }
 
 GlobalObject::~GlobalObject() = default;
@@ -323,11 +327,15 @@ void GlobalObject::visit_edges(Visitor& visitor)
     visitor.visit(m_async_generator_prototype);
     visitor.visit(m_generator_prototype);
     visitor.visit(m_intl_segments_prototype);
+    visitor.visit(m_array_prototype_push_function);
     visitor.visit(m_array_prototype_values_function);
     visitor.visit(m_date_constructor_now_function);
     visitor.visit(m_eval_function);
     visitor.visit(m_json_parse_function);
+    visitor.visit(m_math_abs_function);
+    visitor.visit(m_math_floor_function);
     visitor.visit(m_object_prototype_to_string_function);
+    visitor.visit(m_string_prototype_char_code_at_function);
     visitor.visit(m_throw_type_error_function);
 
 #define __JS_ENUMERATE(ClassName, snake_name, PrototypeName, ConstructorName, ArrayType) \
@@ -356,6 +364,8 @@ void GlobalObject::visit_edges(Visitor& visitor)
 
 Realm* GlobalObject::associated_realm()
 {
+    if (m_associated_realm)
+        heap().sweep_cell_if_dead(*m_associated_realm);
     return m_associated_realm;
 }
 
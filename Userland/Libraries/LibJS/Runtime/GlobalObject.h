@@ -48,11 +48,15 @@ public:
     // Not included in JS_ENUMERATE_INTL_OBJECTS due to missing distinct constructor
     Object* intl_segments_prototype() { return m_intl_segments_prototype; }
 
+    FunctionObject* array_prototype_push_function() const { return m_array_prototype_push_function; }
     FunctionObject* array_prototype_values_function() const { return m_array_prototype_values_function; }
     FunctionObject* date_constructor_now_function() const { return m_date_constructor_now_function; }
     FunctionObject* eval_function() const { return m_eval_function; }
     FunctionObject* json_parse_function() const { return m_json_parse_function; }
+    FunctionObject* math_abs_function() const { return m_math_abs_function; }
+    FunctionObject* math_floor_function() const { return m_math_floor_function; }
     FunctionObject* object_prototype_to_string_function() const { return m_object_prototype_to_string_function; }
+    FunctionObject* string_prototype_char_code_at_function() const { return m_string_prototype_char_code_at_function; }
     FunctionObject* throw_type_error_function() const { return m_throw_type_error_function; }
 
 #define __JS_ENUMERATE(ClassName, snake_name, PrototypeName, ConstructorName, ArrayType) \
@@ -142,11 +146,15 @@ private:
     // Not included in JS_ENUMERATE_INTL_OBJECTS due to missing distinct constructor
     Object* m_intl_segments_prototype { nullptr };
 
+    FunctionObject* m_array_prototype_push_function { nullptr };
     FunctionObject* m_array_prototype_values_function { nullptr };
     FunctionObject* m_date_constructor_now_function { nullptr };
     FunctionObject* m_eval_function { nullptr };
     FunctionObject* m_json_parse_function { nullptr };
+    FunctionObject* m_math_abs_function { nullptr };
+    FunctionObject* m_math_floor_function { nullptr };
     FunctionObject* m_object_prototype_to_string_function { nullptr };
+    FunctionObject* m_string_prototype_char_code_at_function { nullptr };
     FunctionObject* m_throw_type_error_function { nullptr };
 
 #define __JS_ENUMERATE(ClassName, snake_name, PrototypeName, ConstructorName, ArrayType) \
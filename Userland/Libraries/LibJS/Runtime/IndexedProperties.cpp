@@ -17,6 +17,42 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements)
+        update_element_kind_for(value);
+}
+
+void SimpleIndexedPropertyStorage::update_element_kind_for(Value value)
+{
+    if (value.is_empty()) {
+        make_element_kind_holey();
+        return;
+    }
+    if (value.is_int32())
+        return;
+    bool is_holey = !is_packed(m_element_kind);
+    if (value.is_number()) {
+        if (has_only_int32s(m_element_kind))
+            m_element_kind = is_holey ? ElementKind::HoleyDouble : ElementKind::PackedDouble;
+        return;
+    }
+    m_element_kind = is_holey ? ElementKind::Holey : ElementKind::Packed;
+}
+
+void SimpleIndexedPropertyStorage::make_element_kind_holey()
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_element_kind = ElementKind::HoleyInt32;
+        break;
+    case ElementKind::PackedDouble:
+        m_element_kind = ElementKind::HoleyDouble;
+        break;
+    case ElementKind::Packed:
+        m_element_kind = ElementKind::Holey;
+        break;
+    default:
+        break;
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -49,27 +85,35 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        if (index > m_array_size)
+            make_element_kind_holey();
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
     m_packed_elements[index] = value;
+    update_element_kind_for(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    make_element_kind_holey();
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
+    if (m_array_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
     return { m_packed_elements.take_first(), default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
+    if (m_array_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
     auto last_element = m_packed_elements[m_array_size];
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
@@ -77,6 +121,10 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
+    else if (new_size > m_array_size)
+        make_element_kind_holey();
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -276,6 +324,27 @@ size_t IndexedProperties::real_size() const
     return static_cast<GenericIndexedPropertyStorage const&>(*m_storage).size();
 }
 
+ElementKind IndexedProperties::element_kind() const
+{
+    if (!m_storage)
+        return ElementKind::PackedInt32;
+    if (!m_storage->is_simple_storage())
+        return ElementKind::Holey;
+    return static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).element_kind();
+}
+
+Optional<Span<Value const>> IndexedProperties::packed_elements() const
+{
+    if (!m_storage)
+        return Span<Value const> {};
+    if (!m_storage->is_simple_storage())
+        return {};
+    auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
+    if (!is_packed(storage.element_kind()))
+        return {};
+    return storage.elements().span().trim(storage.array_like_size());
+}
+
 Vector<u32> IndexedProperties::indices() const
 {
     if (!m_storage)
@@ -15,12 +15,30 @@ namespace JS {
 struct ValueAndAttributes {
     Value value;
     PropertyAttributes attributes { default_attributes };
+    // Where the property lives in the object's storage, for named properties.
+    Optional<u32> property_offset {};
 };
 
 class IndexedProperties;
 class IndexedPropertyIterator;
 class GenericIndexedPropertyStorage;
 
+// What is known about the elements of a simple storage, so that built-ins can take shortcuts with them.
+// Packed kinds have an element at every index below the array-like size, holey ones may not.
+// Elements only ever move to a more general kind, until the storage becomes empty again.
+enum class ElementKind : u8 {
+    PackedInt32,
+    PackedDouble,
+    Packed,
+    HoleyInt32,
+    HoleyDouble,
+    Holey,
+};
+
+constexpr bool is_packed(ElementKind kind) { return kind <= ElementKind::Packed; }
+constexpr bool has_only_int32s(ElementKind kind) { return kind == ElementKind::PackedInt32 || kind == ElementKind::HoleyInt32; }
+constexpr bool has_only_numbers(ElementKind kind) { return has_only_int32s(kind) || kind == ElementKind::PackedDouble || kind == ElementKind::HoleyDouble; }
+
 class IndexedPropertyStorage {
 public:
     virtual ~IndexedPropertyStorage() = default;
@@ -60,13 +78,18 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return m_element_kind; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void update_element_kind_for(Value);
+    void make_element_kind_holey();
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -138,6 +161,11 @@ public:
 
     size_t real_size() const;
 
+    // Elements kept in generic storage may be anything, anywhere.
+    ElementKind element_kind() const;
+    // The elements below the array-like size, if they're in simple storage and have no holes.
+    Optional<Span<Value const>> packed_elements() const;
+
     Vector<u32> indices() const;
 
     template<typename Callback>
@@ -32,6 +32,19 @@ void DateTimeFormat::visit_edges(Cell::Visitor& visitor)
     Base::visit_edges(visitor);
     if (m_bound_format)
         visitor.visit(m_bound_format);
+    if (m_number_format)
+        visitor.visit(m_number_format);
+    if (m_two_digit_number_format)
+        visitor.visit(m_two_digit_number_format);
+    if (m_fractional_second_number_format)
+        visitor.visit(m_fractional_second_number_format);
+}
+
+Vector<PatternPartition> const& DateTimeFormat::pattern_parts()
+{
+    if (m_pattern_parts.is_empty())
+        m_pattern_parts = partition_pattern(pattern());
+    return m_pattern_parts;
 }
 
 DateTimeFormat::Style DateTimeFormat::style_from_string(StringView style)
@@ -549,26 +562,33 @@ ThrowCompletionOr<Vector<PatternPartition>> format_date_time_pattern(VM& vm, Dat
         return static_cast<NumberFormat*>(number_format);
     };
 
-    // 4. Let nfOptions be OrdinaryObjectCreate(null).
-    auto* number_format_options = Object::create(realm, nullptr);
+    // NOTE: nf, nf2 and nf3 are created the first time this DateTimeFormat formats anything, and cached on it afterwards.
+    if (!date_time_format.number_format()) {
+        // 4. Let nfOptions be OrdinaryObjectCreate(null).
+        auto* number_format_options = Object::create(realm, nullptr);
 
-    // 5. Perform ! CreateDataPropertyOrThrow(nfOptions, "useGrouping", false).
-    MUST(number_format_options->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
+        // 5. Perform ! CreateDataPropertyOrThrow(nfOptions, "useGrouping", false).
+        MUST(number_format_options->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
 
-    // 6. Let nf be ? Construct(%NumberFormat%, « locale, nfOptions »).
-    auto* number_format = TRY(construct_number_format(number_format_options));
+        // 6. Let nf be ? Construct(%NumberFormat%, « locale, nfOptions »).
+        date_time_format.set_number_format(TRY(construct_number_format(number_format_options)));
+    }
+    auto* number_format = date_time_format.number_format();
 
-    // 7. Let nf2Options be OrdinaryObjectCreate(null).
-    auto* number_format_options2 = Object::create(realm, nullptr);
+    if (!date_time_format.two_digit_number_format()) {
+        // 7. Let nf2Options be OrdinaryObjectCreate(null).
+        auto* number_format_options2 = Object::create(realm, nullptr);
 
-    // 8. Perform ! CreateDataPropertyOrThrow(nf2Options, "minimumIntegerDigits", 2).
-    MUST(number_format_options2->create_data_property_or_throw(vm.names.minimumIntegerDigits, Value(2)));
+        // 8. Perform ! CreateDataPropertyOrThrow(nf2Options, "minimumIntegerDigits", 2).
+        MUST(number_format_options2->create_data_property_or_throw(vm.names.minimumIntegerDigits, Value(2)));
 
-    // 9. Perform ! CreateDataPropertyOrThrow(nf2Options, "useGrouping", false).
-    MUST(number_format_options2->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
+        // 9. Perform ! CreateDataPropertyOrThrow(nf2Options, "useGrouping", false).
+        MUST(number_format_options2->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
 
-    // 10. Let nf2 be ? Construct(%NumberFormat%, « locale, nf2Options »).
-    auto* number_format2 = TRY(construct_number_format(number_format_options2));
+        // 10. Let nf2 be ? Construct(%NumberFormat%, « locale, nf2Options »).
+        date_time_format.set_two_digit_number_format(TRY(construct_number_format(number_format_options2)));
+    }
+    auto* number_format2 = date_time_format.two_digit_number_format();
 
     // 11. Let fractionalSecondDigits be dateTimeFormat.[[FractionalSecondDigits]].
     Optional<u8> fractional_second_digits;
@@ -578,17 +598,20 @@ ThrowCompletionOr<Vector<PatternPartition>> format_date_time_pattern(VM& vm, Dat
     if (date_time_format.has_fractional_second_digits()) {
         fractional_second_digits = date_time_format.fractional_second_digits();
 
-        // a. Let nf3Options be OrdinaryObjectCreate(null).
-        auto* number_format_options3 = Object::create(realm, nullptr);
+        if (!date_time_format.fractional_second_number_format()) {
+            // a. Let nf3Options be OrdinaryObjectCreate(null).
+            auto* number_format_options3 = Object::create(realm, nullptr);
 
-        // b. Perform ! CreateDataPropertyOrThrow(nf3Options, "minimumIntegerDigits", fractionalSecondDigits).
-        MUST(number_format_options3->create_data_property_or_throw(vm.names.minimumIntegerDigits, Value(*fractional_second_digits)));
+            // b. Perform ! CreateDataPropertyOrThrow(nf3Options, "minimumIntegerDigits", fractionalSecondDigits).
+            MUST(number_format_options3->create_data_property_or_throw(vm.names.minimumIntegerDigits, Value(*fractional_second_digits)));
 
-        // c. Perform ! CreateDataPropertyOrThrow(nf3Options, "useGrouping", false).
-        MUST(number_format_options3->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
+            // c. Perform ! CreateDataPropertyOrThrow(nf3Options, "useGrouping", false).
+            MUST(number_format_options3->create_data_property_or_throw(vm.names.useGrouping, Value(false)));
 
-        // d. Let nf3 be ? Construct(%NumberFormat%, « locale, nf3Options »).
-        number_format3 = TRY(construct_number_format(number_format_options3));
+            // d. Let nf3 be ? Construct(%NumberFormat%, « locale, nf3Options »).
+            date_time_format.set_fractional_second_number_format(TRY(construct_number_format(number_format_options3)));
+        }
+        number_format3 = date_time_format.fractional_second_number_format();
     }
 
     // 13. Let tm be ToLocalTime(x, dateTimeFormat.[[Calendar]], dateTimeFormat.[[TimeZone]]).
@@ -816,7 +839,7 @@ ThrowCompletionOr<Vector<PatternPartition>> format_date_time_pattern(VM& vm, Dat
 ThrowCompletionOr<Vector<PatternPartition>> partition_date_time_pattern(VM& vm, DateTimeFormat& date_time_format, double time)
 {
     // 1. Let patternParts be PartitionPattern(dateTimeFormat.[[Pattern]]).
-    auto pattern_parts = partition_pattern(date_time_format.pattern());
+    auto pattern_parts = date_time_format.pattern_parts();
 
     // 2. Let result be ? FormatDateTimePattern(dateTimeFormat, patternParts, x, undefined).
     auto result = TRY(format_date_time_pattern(vm, date_time_format, move(pattern_parts), time, nullptr));
@@ -76,7 +76,14 @@ public:
     void set_time_style(StringView style) { m_time_style = style_from_string(style); };
 
     String const& pattern() const { return Patterns::pattern; };
-    void set_pattern(String pattern) { Patterns::pattern = move(pattern); }
+    void set_pattern(String pattern)
+    {
+        Patterns::pattern = move(pattern);
+        m_pattern_parts.clear();
+    }
+
+    // The result of PartitionPattern(dateTimeFormat.[[Pattern]]), which only needs to be computed once.
+    Vector<PatternPartition> const& pattern_parts();
 
     Span<Unicode::CalendarRangePattern const> range_patterns() const { return m_range_patterns.span(); };
     void set_range_patterns(Vector<Unicode::CalendarRangePattern> range_patterns) { m_range_patterns = move(range_patterns); }
@@ -127,6 +134,17 @@ public:
     NativeFunction* bound_format() const { return m_bound_format; }
     void set_bound_format(NativeFunction* bound_format) { m_bound_format = bound_format; }
 
+    // The NumberFormat objects used by FormatDateTimePattern only depend on the locale and fractional second digits,
+    // so they are created the first time something is formatted and reused from then on.
+    NumberFormat* number_format() const { return m_number_format; }
+    void set_number_format(NumberFormat* number_format) { m_number_format = number_format; }
+
+    NumberFormat* two_digit_number_format() const { return m_two_digit_number_format; }
+    void set_two_digit_number_format(NumberFormat* number_format) { m_two_digit_number_format = number_format; }
+
+    NumberFormat* fractional_second_number_format() const { return m_fractional_second_number_format; }
+    void set_fractional_second_number_format(NumberFormat* number_format) { m_fractional_second_number_format = number_format; }
+
 private:
     static Style style_from_string(StringView style);
     static StringView style_to_string(Style style);
@@ -144,6 +162,11 @@ private:
     NativeFunction* m_bound_format { nullptr };             // [[BoundFormat]]
 
     String m_data_locale;
+
+    Vector<PatternPartition> m_pattern_parts;
+    NumberFormat* m_number_format { nullptr };
+    NumberFormat* m_two_digit_number_format { nullptr };
+    NumberFormat* m_fractional_second_number_format { nullptr };
 };
 
 enum class OptionRequired {
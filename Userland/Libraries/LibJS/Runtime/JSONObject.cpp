@@ -11,6 +11,7 @@
 #include <AK/StringBuilder.h>
 #include <AK/Utf16View.h>
 #include <AK/Utf8View.h>
+#include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigIntObject.h>
@@ -387,6 +388,78 @@ String JSONObject::quote_json_string(String string)
     return builder.to_string();
 }
 
+// Creates the values for JSON.parse() as the parser comes across them, without building a JsonValue tree first.
+class JSONParseValueBuilder final : public JsonParser::Handler {
+public:
+    explicit JSONParseValueBuilder(VM& vm)
+        : m_vm(vm)
+        , m_containers(vm.heap())
+    {
+    }
+
+    Value value() const { return m_value; }
+
+    virtual ErrorOr<void> on_object_start() override
+    {
+        auto& realm = *m_vm.current_realm();
+        m_containers.append(Object::create(realm, realm.global_object().object_prototype()));
+        m_container_states.append({});
+        return {};
+    }
+
+    virtual ErrorOr<void> on_object_key(StringView key) override
+    {
+        m_container_states.last().key = key;
+        return {};
+    }
+
+    virtual ErrorOr<void> on_array_start() override
+    {
+        m_containers.append(MUST(Array::create(*m_vm.current_realm(), 0)));
+        m_container_states.append({});
+        return {};
+    }
+
+    virtual ErrorOr<void> on_object_end() override { return end_container(); }
+    virtual ErrorOr<void> on_array_end() override { return end_container(); }
+    virtual ErrorOr<void> on_string(StringView string) override { return add(js_string(m_vm, String { string })); }
+    virtual ErrorOr<void> on_value(JsonValue value) override { return add(JSONObject::parse_json_value(m_vm, value)); }
+
+private:
+    ErrorOr<void> end_container()
+    {
+        auto container = m_containers.take_last();
+        m_container_states.take_last();
+        return add(container);
+    }
+
+    ErrorOr<void> add(Value value)
+    {
+        if (m_containers.is_empty()) {
+            m_value = value;
+            return {};
+        }
+        auto& container = m_containers.last().as_object();
+        auto& state = m_container_states.last();
+        if (is<Array>(container))
+            container.define_direct_property(state.next_index++, value, default_attributes);
+        else
+            container.define_direct_property(state.key, value, default_attributes);
+        return {};
+    }
+
+    struct ContainerState {
+        String key;
+        u32 next_index { 0 };
+    };
+
+    VM& m_vm;
+    // The objects and arrays that are still being parsed, which nothing else refers to yet.
+    MarkedVector<Value> m_containers;
+    Vector<ContainerState> m_container_states;
+    Value m_value;
+};
+
 // 25.5.1 JSON.parse ( text [ , reviver ] ), https://tc39.es/ecma262/#sec-json.parse
 JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
 {
@@ -395,10 +468,10 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     auto string = TRY(vm.argument(0).to_string(vm));
     auto reviver = vm.argument(1);
 
-    auto json = JsonValue::from_string(string);
-    if (json.is_error())
+    JSONParseValueBuilder builder(vm);
+    if (JsonParser(string).parse(builder).is_error())
         return vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
-    Value unfiltered = parse_json_value(vm, json.value());
+    Value unfiltered = builder.value();
     if (reviver.is_function()) {
         auto* root = Object::create(realm, realm.global_object().object_prototype());
         auto root_name = String::empty();
@@ -685,7 +685,7 @@ ThrowCompletionOr<Optional<PropertyDescriptor>> Object::internal_get_own_propert
     PropertyDescriptor descriptor;
 
     // 3. Let X be O's own property whose key is P.
-    auto [value, attributes] = *maybe_storage_entry;
+    auto [value, attributes, property_offset] = *maybe_storage_entry;
 
     // 4. If X is a data property, then
     if (!value.is_accessor()) {
@@ -712,6 +712,9 @@ ThrowCompletionOr<Optional<PropertyDescriptor>> Object::internal_get_own_propert
     // 7. Set D.[[Configurable]] to the value of X's [[Configurable]] attribute.
     descriptor.configurable = attributes.is_configurable();
 
+    // Non-standard: Remember where X lives, so that [[Get]] and [[Set]] can make the lookup cacheable.
+    descriptor.property_offset = property_offset;
+
     // 8. Return D.
     return descriptor;
 }
@@ -757,13 +760,16 @@ ThrowCompletionOr<bool> Object::internal_has_property(PropertyKey const& propert
 }
 
 // 10.1.8 [[Get]] ( P, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-get-p-receiver
-ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, Value receiver) const
+ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, Value receiver, CacheablePropertyMetadata* cacheable_metadata) const
 {
     VERIFY(!receiver.is_empty());
     VERIFY(property_key.is_valid());
 
     auto& vm = this->vm();
 
+    if (cacheable_metadata && !is_property_lookup_cacheable())
+        cacheable_metadata = nullptr;
+
     // 1. Let desc be ? O.[[GetOwnProperty]](P).
     auto descriptor = TRY(internal_get_own_property(property_key));
 
@@ -777,12 +783,33 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
             return js_undefined();
 
         // c. Return ? parent.[[Get]](P, Receiver).
-        return parent->internal_get(property_key, receiver);
+        // NOTE: Only properties found directly on the prototype of an ordinary object are cacheable, as it is then
+        //       enough for a cache to check the receiver's shape and the prototype's shape.
+        if (!cacheable_metadata || parent != shape().prototype())
+            return parent->internal_get(property_key, receiver);
+
+        CacheablePropertyMetadata parent_metadata;
+        auto value = TRY(parent->internal_get(property_key, receiver, &parent_metadata));
+        if (parent_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
+            *cacheable_metadata = {
+                .type = CacheablePropertyMetadata::Type::InPrototypeChain,
+                .property_offset = parent_metadata.property_offset,
+                .prototype = parent,
+            };
+        }
+        return value;
     }
 
     // 3. If IsDataDescriptor(desc) is true, return desc.[[Value]].
-    if (descriptor->is_data_descriptor())
+    if (descriptor->is_data_descriptor()) {
+        if (cacheable_metadata && descriptor->property_offset.has_value()) {
+            *cacheable_metadata = {
+                .type = CacheablePropertyMetadata::Type::OwnProperty,
+                .property_offset = descriptor->property_offset,
+            };
+        }
         return *descriptor->value;
+    }
 
     // 4. Assert: IsAccessorDescriptor(desc) is true.
     VERIFY(descriptor->is_accessor_descriptor());
@@ -799,21 +826,24 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
 }
 
 // 10.1.9 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-set-p-v-receiver
-ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Value value, Value receiver)
+ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Value value, Value receiver, CacheablePropertyMetadata* cacheable_metadata)
 {
     VERIFY(property_key.is_valid());
     VERIFY(!value.is_empty());
     VERIFY(!receiver.is_empty());
 
+    if (cacheable_metadata && !is_property_lookup_cacheable())
+        cacheable_metadata = nullptr;
+
     // 2. Let ownDesc be ? O.[[GetOwnProperty]](P).
     auto own_descriptor = TRY(internal_get_own_property(property_key));
 
     // 3. Return ? OrdinarySetWithOwnDescriptor(O, P, V, Receiver, ownDesc).
-    return ordinary_set_with_own_descriptor(property_key, value, receiver, own_descriptor);
+    return ordinary_set_with_own_descriptor(property_key, value, receiver, own_descriptor, cacheable_metadata);
 }
 
 // 10.1.9.2 OrdinarySetWithOwnDescriptor ( O, P, V, Receiver, ownDesc ), https://tc39.es/ecma262/#sec-ordinarysetwithowndescriptor
-ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey const& property_key, Value value, Value receiver, Optional<PropertyDescriptor> own_descriptor)
+ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey const& property_key, Value value, Value receiver, Optional<PropertyDescriptor> own_descriptor, CacheablePropertyMetadata* cacheable_metadata)
 {
     VERIFY(property_key.is_valid());
     VERIFY(!value.is_empty());
@@ -869,6 +899,15 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             // iii. Let valueDesc be the PropertyDescriptor { [[Value]]: V }.
             auto value_descriptor = PropertyDescriptor { .value = value };
 
+            // NOTE: Overwriting the value of an existing writable data property of ourselves doesn't change the shape,
+            //       so this can be done directly the next time around.
+            if (cacheable_metadata && &receiver.as_object() == this && existing_descriptor->property_offset.has_value()) {
+                *cacheable_metadata = {
+                    .type = CacheablePropertyMetadata::Type::OwnProperty,
+                    .property_offset = existing_descriptor->property_offset,
+                };
+            }
+
             // iv. Return ? Receiver.[[DefineOwnProperty]](P, valueDesc).
             return TRY(receiver.as_object().internal_define_own_property(property_key, value_descriptor));
         }
@@ -978,6 +1017,7 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
 
     Value value;
     PropertyAttributes attributes;
+    Optional<u32> property_offset;
 
     if (property_key.is_number()) {
         auto value_and_attributes = m_indexed_properties.get(property_key.as_number());
@@ -991,8 +1031,9 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
             return {};
         value = m_storage[metadata->offset];
         attributes = metadata->attributes;
+        property_offset = metadata->offset;
     }
-    return ValueAndAttributes { .value = value, .attributes = attributes };
+    return ValueAndAttributes { .value = value, .attributes = attributes, .property_offset = property_offset };
 }
 
 bool Object::storage_has(PropertyKey const& property_key) const
@@ -1007,7 +1048,8 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
 {
     VERIFY(property_key.is_valid());
 
-    auto [value, attributes] = value_and_attributes;
+    auto value = value_and_attributes.value;
+    auto attributes = value_and_attributes.attributes;
 
     if (property_key.is_number()) {
         auto index = property_key.as_number();
@@ -1052,12 +1094,23 @@ void Object::storage_delete(PropertyKey const& property_key)
     if (property_key.is_number())
         return m_indexed_properties.remove(property_key.as_number());
 
-    auto metadata = shape().lookup(property_key.to_string_or_symbol());
+    auto property_key_string_or_symbol = property_key.to_string_or_symbol();
+    auto metadata = shape().lookup(property_key_string_or_symbol);
     VERIFY(metadata.has_value());
 
+    // Deleting the property that was put last (e.g. a temporary one) just takes us back to the shape from before it.
+    if (!m_shape->is_unique()) {
+        if (auto* previous_shape = m_shape->shape_before_putting(property_key_string_or_symbol)) {
+            VERIFY(metadata->offset == m_storage.size() - 1);
+            set_shape(*previous_shape);
+            m_storage.take_last();
+            return;
+        }
+    }
+
     ensure_shape_is_unique();
 
-    shape().remove_property_from_unique_shape(property_key.to_string_or_symbol(), metadata->offset);
+    shape().remove_property_from_unique_shape(property_key_string_or_symbol, metadata->offset);
     m_storage.remove(metadata->offset);
 }
 
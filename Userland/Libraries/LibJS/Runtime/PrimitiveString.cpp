@@ -17,6 +17,8 @@ namespace JS {
 
 PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     : m_is_rope(true)
+    , m_has_length_in_utf16_code_units(true)
+    , m_length_in_utf16_code_units(lhs.length_in_utf16_code_units() + rhs.length_in_utf16_code_units())
     , m_lhs(&lhs)
     , m_rhs(&rhs)
 {
@@ -36,7 +38,10 @@ PrimitiveString::PrimitiveString(Utf16String string)
 
 PrimitiveString::~PrimitiveString()
 {
-    vm().string_cache().remove(m_utf8_string);
+    // NOTE: A resolved rope isn't in the cache, but another string with the same contents might be.
+    auto& string_cache = vm().string_cache();
+    if (auto it = string_cache.find(m_utf8_string); it != string_cache.end() && it->value == this)
+        string_cache.remove(it);
 }
 
 void PrimitiveString::visit_edges(Cell::Visitor& visitor)
@@ -62,6 +67,24 @@ bool PrimitiveString::is_empty() const
     VERIFY_NOT_REACHED();
 }
 
+size_t PrimitiveString::length_in_utf16_code_units() const
+{
+    if (m_has_length_in_utf16_code_units)
+        return m_length_in_utf16_code_units;
+
+    // Ropes get their length when they're made, so this is a string we have the contents of.
+    if (m_has_utf16_string) {
+        m_length_in_utf16_code_units = m_utf16_string.length_in_code_units();
+    } else {
+        size_t length = 0;
+        for (auto code_point : Utf8View(m_utf8_string))
+            length += code_point > 0xffff ? 2 : 1;
+        m_length_in_utf16_code_units = length;
+    }
+    m_has_length_in_utf16_code_units = true;
+    return m_length_in_utf16_code_units;
+}
+
 String const& PrimitiveString::string() const
 {
     resolve_rope_if_needed();
@@ -92,10 +115,8 @@ Optional<Value> PrimitiveString::get(VM& vm, PropertyKey const& property_key) co
     if (property_key.is_symbol())
         return {};
     if (property_key.is_string()) {
-        if (property_key.as_string() == vm.names.length.as_string()) {
-            auto length = utf16_string().length_in_code_units();
-            return Value(static_cast<double>(length));
-        }
+        if (property_key.as_string() == vm.names.length.as_string())
+            return Value(static_cast<double>(length_in_utf16_code_units()));
     }
     auto index = canonical_numeric_index_string(property_key, CanonicalIndexMode::IgnoreNumericRoundtrip);
     if (!index.is_index())
@@ -149,6 +170,9 @@ PrimitiveString* js_string(Heap& heap, String string)
 
     auto& string_cache = heap.vm().string_cache();
     auto it = string_cache.find(string);
+    // NOTE: A dead string removes itself from the cache once it's swept.
+    if (it != string_cache.end() && heap.sweep_cell_if_dead(*it->value))
+        it = string_cache.find(string);
     if (it == string_cache.end()) {
         auto* new_string = heap.allocate_without_realm<PrimitiveString>(string);
         string_cache.set(move(string), new_string);
@@ -225,8 +249,11 @@ void PrimitiveString::resolve_rope_if_needed() const
         pieces.append(current);
     }
 
-    // Now that we have all the pieces, we can concatenate them using a StringBuilder.
-    StringBuilder builder;
+    // Now that we have all the pieces, we can concatenate them using a StringBuilder that's large enough for all of them.
+    size_t length_in_bytes = 0;
+    for (auto const* piece : pieces)
+        length_in_bytes += piece->string().length();
+    StringBuilder builder(length_in_bytes);
 
     // We keep track of the previous piece in order to handle surrogate pairs spread across two pieces.
     PrimitiveString const* previous = nullptr;
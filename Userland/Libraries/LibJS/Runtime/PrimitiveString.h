@@ -27,6 +27,9 @@ public:
 
     bool is_empty() const;
 
+    // NOTE: This doesn't resolve a rope, as every rope knows how long it is.
+    size_t length_in_utf16_code_units() const;
+
     String const& string() const;
     bool has_utf8_string() const { return m_has_utf8_string; }
 
@@ -45,6 +48,9 @@ private:
     mutable bool m_is_rope { false };
     mutable bool m_has_utf8_string { false };
     mutable bool m_has_utf16_string { false };
+    mutable bool m_has_length_in_utf16_code_units { false };
+
+    mutable size_t m_length_in_utf16_code_units { 0 };
 
     mutable PrimitiveString* m_lhs { nullptr };
     mutable PrimitiveString* m_rhs { nullptr };
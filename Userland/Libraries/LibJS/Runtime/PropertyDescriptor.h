@@ -39,6 +39,10 @@ public:
     Optional<bool> writable {};
     Optional<bool> enumerable {};
     Optional<bool> configurable {};
+
+    // Not part of the specification type: where the property lives in the object's storage, if this
+    // describes an own named property of an ordinary object. Used to fill property lookup caches.
+    Optional<u32> property_offset {};
 };
 
 }
@@ -10,15 +10,63 @@
 
 namespace JS {
 
+ShapeStatistics g_shape_statistics;
+
+void ShapeStatistics::dump() const
+{
+    dbgln("Shape statistics:");
+    dbgln("    Shapes:                 {}", shapes);
+    dbgln("    Unique shapes:          {}", unique_shapes);
+    dbgln("    Property tables:        {}", property_tables);
+    dbgln("    Property table entries: {}", property_table_entries);
+}
+
+PropertyTable::PropertyTable()
+{
+    ++g_shape_statistics.property_tables;
+}
+
+PropertyTable::~PropertyTable()
+{
+    --g_shape_statistics.property_tables;
+    g_shape_statistics.property_table_entries -= m_properties.size();
+}
+
+NonnullRefPtr<PropertyTable> PropertyTable::clone_prefix(u32 property_count) const
+{
+    auto table = create();
+    table->m_properties.ensure_capacity(property_count);
+    for (auto& it : m_properties) {
+        if (it.value.offset < property_count)
+            table->set(it.key, it.value);
+    }
+    return table;
+}
+
+void PropertyTable::set(StringOrSymbol const& property_key, PropertyMetadata metadata)
+{
+    if (m_properties.set(property_key, metadata) == AK::HashSetResult::InsertedNewEntry)
+        ++g_shape_statistics.property_table_entries;
+}
+
+bool PropertyTable::remove(StringOrSymbol const& property_key)
+{
+    if (!m_properties.remove(property_key))
+        return false;
+    --g_shape_statistics.property_table_entries;
+    return true;
+}
+
 Shape* Shape::create_unique_clone() const
 {
     auto* new_shape = heap().allocate_without_realm<Shape>(m_realm);
     new_shape->m_unique = true;
+    ++g_shape_statistics.unique_shapes;
     new_shape->m_prototype = m_prototype;
     ensure_property_table();
-    new_shape->ensure_property_table();
-    (*new_shape->m_property_table) = *m_property_table;
-    new_shape->m_property_count = new_shape->m_property_table->size();
+    new_shape->m_property_table = m_property_table->clone_prefix(m_property_count);
+    new_shape->m_owns_property_table = true;
+    new_shape->m_property_count = m_property_count;
     return new_shape;
 }
 
@@ -29,6 +77,8 @@ Shape* Shape::get_or_prune_cached_forward_transition(TransitionKey const& key)
     auto it = m_forward_transitions->find(key);
     if (it == m_forward_transitions->end())
         return nullptr;
+    if (it->value)
+        heap().sweep_cell_if_dead(*it->value);
     if (!it->value) {
         // The cached forward transition has gone stale (from garbage collection). Prune it.
         m_forward_transitions->remove(it);
@@ -44,6 +94,8 @@ Shape* Shape::get_or_prune_cached_prototype_transition(Object* prototype)
     auto it = m_prototype_transitions->find(prototype);
     if (it == m_prototype_transitions->end())
         return nullptr;
+    if (it->value)
+        heap().sweep_cell_if_dead(*it->value);
     if (!it->value) {
         // The cached prototype transition has gone stale (from garbage collection). Prune it.
         m_prototype_transitions->remove(it);
@@ -87,9 +139,17 @@ Shape* Shape::create_prototype_transition(Object* new_prototype)
     return new_shape;
 }
 
+Shape* Shape::shape_before_putting(StringOrSymbol const& property_key)
+{
+    if (m_transition_type != TransitionType::Put || m_property_key != property_key)
+        return nullptr;
+    return m_previous;
+}
+
 Shape::Shape(Realm& realm)
     : m_realm(realm)
 {
+    ++g_shape_statistics.shapes;
 }
 
 Shape::Shape(Shape& previous_shape, StringOrSymbol const& property_key, PropertyAttributes attributes, TransitionType transition_type)
@@ -101,6 +161,7 @@ Shape::Shape(Shape& previous_shape, StringOrSymbol const& property_key, Property
     , m_attributes(attributes)
     , m_transition_type(transition_type)
 {
+    ++g_shape_statistics.shapes;
 }
 
 Shape::Shape(Shape& previous_shape, Object* new_prototype)
@@ -110,6 +171,14 @@ Shape::Shape(Shape& previous_shape, Object* new_prototype)
     , m_property_count(previous_shape.m_property_count)
     , m_transition_type(TransitionType::Prototype)
 {
+    ++g_shape_statistics.shapes;
+}
+
+Shape::~Shape()
+{
+    --g_shape_statistics.shapes;
+    if (m_unique)
+        --g_shape_statistics.unique_shapes;
 }
 
 void Shape::visit_edges(Cell::Visitor& visitor)
@@ -119,8 +188,10 @@ void Shape::visit_edges(Cell::Visitor& visitor)
     visitor.visit(m_prototype);
     visitor.visit(m_previous);
     m_property_key.visit_edges(visitor);
-    if (m_property_table) {
-        for (auto& it : *m_property_table)
+    // NOTE: The keys of a shared table that are visible to this shape have been put by this shape or the ones before it,
+    //       which are visited through m_previous, so we only need to visit the keys of a table we made ourselves.
+    if (m_property_table && m_owns_property_table) {
+        for (auto& it : m_property_table->properties())
             it.key.visit_edges(visitor);
     }
 }
@@ -129,25 +200,22 @@ Optional<PropertyMetadata> Shape::lookup(StringOrSymbol const& property_key) con
 {
     if (m_property_count == 0)
         return {};
-    auto property = property_table().get(property_key);
-    if (!property.has_value())
+    ensure_property_table();
+    auto property = m_property_table->get(property_key);
+    if (!property.has_value() || property->offset >= m_property_count)
         return {};
     return property;
 }
 
-FLATTEN HashMap<StringOrSymbol, PropertyMetadata> const& Shape::property_table() const
-{
-    ensure_property_table();
-    return *m_property_table;
-}
-
 Vector<Shape::Property> Shape::property_table_ordered() const
 {
     auto vec = Vector<Shape::Property>();
     vec.resize(property_count());
 
-    for (auto& it : property_table()) {
-        vec[it.value.offset] = { it.key, it.value };
+    ensure_property_table();
+    for (auto& it : m_property_table->properties()) {
+        if (it.value.offset < m_property_count)
+            vec[it.value.offset] = { it.key, it.value };
     }
 
     return vec;
@@ -157,20 +225,41 @@ void Shape::ensure_property_table() const
 {
     if (m_property_table)
         return;
-    m_property_table = make<HashMap<StringOrSymbol, PropertyMetadata>>();
-
-    u32 next_offset = 0;
 
+    Shape const* shape_with_table = nullptr;
+    bool has_configure_transition = false;
     Vector<Shape const&, 64> transition_chain;
-    for (auto* shape = m_previous; shape; shape = shape->m_previous) {
+    for (auto const* shape = this; shape; shape = shape->m_previous) {
         if (shape->m_property_table) {
-            *m_property_table = *shape->m_property_table;
-            next_offset = shape->m_property_count;
+            shape_with_table = shape;
             break;
         }
+        if (shape->m_transition_type == TransitionType::Configure)
+            has_configure_transition = true;
         transition_chain.append(*shape);
     }
-    transition_chain.append(*this);
+
+    u32 next_offset = 0;
+    if (shape_with_table)
+        next_offset = shape_with_table->m_property_count;
+
+    // If nothing has been put into the table of the shape we came from beyond its own properties, and we only put more
+    // properties since, we can put ours at the end and share the table with it and every shape in between.
+    if (shape_with_table && !has_configure_transition && shape_with_table->m_property_table->size() == next_offset) {
+        auto& table = *shape_with_table->m_property_table;
+        for (auto const& shape : transition_chain.in_reverse()) {
+            if (shape.m_transition_type == TransitionType::Put)
+                table.set(shape.m_property_key, { next_offset++, shape.m_attributes });
+            shape.m_property_table = table;
+        }
+        return;
+    }
+
+    if (shape_with_table)
+        m_property_table = shape_with_table->m_property_table->clone_prefix(next_offset);
+    else
+        m_property_table = PropertyTable::create();
+    m_owns_property_table = true;
 
     for (auto const& shape : transition_chain.in_reverse()) {
         if (!shape.m_property_key.is_valid()) {
@@ -180,8 +269,8 @@ void Shape::ensure_property_table() const
         if (shape.m_transition_type == TransitionType::Put) {
             m_property_table->set(shape.m_property_key, { next_offset++, shape.m_attributes });
         } else if (shape.m_transition_type == TransitionType::Configure) {
-            auto it = m_property_table->find(shape.m_property_key);
-            VERIFY(it != m_property_table->end());
+            auto it = m_property_table->properties().find(shape.m_property_key);
+            VERIFY(it != m_property_table->properties().end());
             it->value.attributes = shape.m_attributes;
         }
     }
@@ -191,21 +280,22 @@ void Shape::add_property_to_unique_shape(StringOrSymbol const& property_key, Pro
 {
     VERIFY(is_unique());
     VERIFY(m_property_table);
-    VERIFY(!m_property_table->contains(property_key));
+    VERIFY(!m_property_table->properties().contains(property_key));
     m_property_table->set(property_key, { static_cast<u32>(m_property_table->size()), attributes });
 
     VERIFY(m_property_count < NumericLimits<u32>::max());
     ++m_property_count;
+    ++m_mutation_serial;
 }
 
 void Shape::reconfigure_property_in_unique_shape(StringOrSymbol const& property_key, PropertyAttributes attributes)
 {
     VERIFY(is_unique());
     VERIFY(m_property_table);
-    auto it = m_property_table->find(property_key);
-    VERIFY(it != m_property_table->end());
+    auto it = m_property_table->properties().find(property_key);
+    VERIFY(it != m_property_table->properties().end());
     it->value.attributes = attributes;
-    m_property_table->set(property_key, it->value);
+    ++m_mutation_serial;
 }
 
 void Shape::remove_property_from_unique_shape(StringOrSymbol const& property_key, size_t offset)
@@ -214,20 +304,28 @@ void Shape::remove_property_from_unique_shape(StringOrSymbol const& property_key
     VERIFY(m_property_table);
     if (m_property_table->remove(property_key))
         --m_property_count;
-    for (auto& it : *m_property_table) {
+    for (auto& it : m_property_table->properties()) {
         VERIFY(it.value.offset != offset);
         if (it.value.offset > offset)
             --it.value.offset;
     }
+    ++m_mutation_serial;
 }
 
 void Shape::add_property_without_transition(StringOrSymbol const& property_key, PropertyAttributes attributes)
 {
     VERIFY(property_key.is_valid());
     ensure_property_table();
-    if (m_property_table->set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
+    // The properties that shapes we share our table with have put must not become ours.
+    if (m_property_table->ref_count() > 1 || m_property_table->size() != m_property_count) {
+        m_property_table = m_property_table->clone_prefix(m_property_count);
+        m_owns_property_table = true;
+    }
+    if (m_property_table->properties().set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
+        ++g_shape_statistics.property_table_entries;
         VERIFY(m_property_count < NumericLimits<u32>::max());
         ++m_property_count;
+        ++m_mutation_serial;
     }
 }
 
@@ -8,6 +8,8 @@
 
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
 #include <AK/StringView.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
@@ -24,6 +26,45 @@ struct PropertyMetadata {
     PropertyAttributes attributes { 0 };
 };
 
+// Shapes that got their properties through a chain of put transitions share one property table. Each of them only
+// looks at the entries with an offset below its own property count, which are exactly the properties that were put
+// on the way to it.
+class PropertyTable : public RefCounted<PropertyTable> {
+public:
+    static NonnullRefPtr<PropertyTable> create() { return adopt_ref(*new PropertyTable); }
+    ~PropertyTable();
+
+    // A table with just the entries that have an offset below the given property count.
+    NonnullRefPtr<PropertyTable> clone_prefix(u32 property_count) const;
+
+    size_t size() const { return m_properties.size(); }
+    Optional<PropertyMetadata> get(StringOrSymbol const& property_key) const { return m_properties.get(property_key); }
+    void set(StringOrSymbol const&, PropertyMetadata);
+    bool remove(StringOrSymbol const&);
+
+    // NOTE: Callers may change the metadata of existing entries in place, but must go through set() and remove() to
+    //       add or remove entries.
+    HashMap<StringOrSymbol, PropertyMetadata>& properties() { return m_properties; }
+    HashMap<StringOrSymbol, PropertyMetadata> const& properties() const { return m_properties; }
+
+private:
+    PropertyTable();
+
+    HashMap<StringOrSymbol, PropertyMetadata> m_properties;
+};
+
+// How many shapes and property tables are currently alive, and how many entries the tables hold between them.
+struct ShapeStatistics {
+    u64 shapes { 0 };
+    u64 unique_shapes { 0 };
+    u64 property_tables { 0 };
+    u64 property_table_entries { 0 };
+
+    void dump() const;
+};
+
+extern ShapeStatistics g_shape_statistics;
+
 struct TransitionKey {
     StringOrSymbol property_key;
     PropertyAttributes attributes { 0 };
@@ -38,7 +79,7 @@ class Shape final
     : public Cell
     , public Weakable<Shape> {
 public:
-    virtual ~Shape() override = default;
+    virtual ~Shape() override;
 
     enum class TransitionType {
         Invalid,
@@ -55,6 +96,10 @@ public:
     Shape* create_configure_transition(StringOrSymbol const&, PropertyAttributes attributes);
     Shape* create_prototype_transition(Object* new_prototype);
 
+    // If the given property was the last one to be put, the shape from before that. Going back to it lets an object get
+    // rid of the property without having to move to a unique shape.
+    Shape* shape_before_putting(StringOrSymbol const&);
+
     void add_property_without_transition(StringOrSymbol const&, PropertyAttributes);
     void add_property_without_transition(PropertyKey const&, PropertyAttributes);
 
@@ -68,7 +113,6 @@ public:
     Object const* prototype() const { return m_prototype; }
 
     Optional<PropertyMetadata> lookup(StringOrSymbol const&) const;
-    HashMap<StringOrSymbol, PropertyMetadata> const& property_table() const;
     u32 property_count() const { return m_property_count; }
 
     struct Property {
@@ -78,7 +122,15 @@ public:
 
     Vector<Property> property_table_ordered() const;
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    // Bumped whenever this shape is changed in place rather than through a transition (which is what
+    // happens to unique shapes), so that caches keyed on a shape can tell that it no longer looks the same.
+    u32 mutation_serial() const { return m_mutation_serial; }
+
+    void set_prototype_without_transition(Object* new_prototype)
+    {
+        m_prototype = new_prototype;
+        ++m_mutation_serial;
+    }
 
     void remove_property_from_unique_shape(StringOrSymbol const&, size_t offset);
     void add_property_to_unique_shape(StringOrSymbol const&, PropertyAttributes attributes);
@@ -95,7 +147,7 @@ private:
 
     Realm& m_realm;
 
-    mutable OwnPtr<HashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
+    mutable RefPtr<PropertyTable> m_property_table;
 
     OwnPtr<HashMap<TransitionKey, WeakPtr<Shape>>> m_forward_transitions;
     OwnPtr<HashMap<Object*, WeakPtr<Shape>>> m_prototype_transitions;
@@ -103,10 +155,14 @@ private:
     StringOrSymbol m_property_key;
     Object* m_prototype { nullptr };
     u32 m_property_count { 0 };
+    u32 m_mutation_serial { 0 };
 
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
     bool m_unique : 1 { false };
+    // Whether this shape made its property table, rather than sharing one of the shapes it came from.
+    // The keys in a table are visited by the shape that made it, as the others can't all be reached from each other.
+    mutable bool m_owns_property_table : 1 { false };
 };
 
 }
@@ -9,6 +9,7 @@
 #include <AK/AllOf.h>
 #include <AK/Assertions.h>
 #include <AK/CharacterTypes.h>
+#include <AK/FloatingPointStringConversions.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
@@ -83,71 +84,12 @@ static String double_to_string(double d)
     if (d == static_cast<double>(INFINITY))
         return "Infinity";
 
-    StringBuilder number_string_builder;
-
-    size_t start_index = 0;
-    size_t end_index = 0;
-    size_t int_part_end = 0;
-
-    // generate integer part (reversed)
-    double int_part;
-    double frac_part;
-    frac_part = modf(d, &int_part);
-    while (int_part > 0) {
-        number_string_builder.append('0' + (int)fmod(int_part, 10));
-        end_index++;
-        int_part = floor(int_part / 10);
-    }
-
-    auto reversed_integer_part = number_string_builder.to_string().reverse();
-    number_string_builder.clear();
-    number_string_builder.append(reversed_integer_part);
-
-    int_part_end = end_index;
-
-    int exponent = 0;
-
-    // generate fractional part
-    while (frac_part > 0) {
-        double old_frac_part = frac_part;
-        frac_part *= 10;
-        frac_part = modf(frac_part, &int_part);
-        if (old_frac_part == frac_part)
-            break;
-        number_string_builder.append('0' + (int)int_part);
-        end_index++;
-        exponent--;
-    }
-
-    auto number_string = number_string_builder.to_string();
-
-    // FIXME: Remove this hack.
-    // FIXME: Instead find the shortest round-trippable representation.
-    // Remove decimals after the 15th position
-    if (end_index > int_part_end + 15) {
-        exponent += end_index - int_part_end - 15;
-        end_index = int_part_end + 15;
-    }
-
-    // remove leading zeroes
-    while (start_index < end_index && number_string[start_index] == '0') {
-        start_index++;
-    }
-
-    // remove trailing zeroes
-    while (end_index > 0 && number_string[end_index - 1] == '0') {
-        end_index--;
-        exponent++;
-    }
-
-    if (end_index <= start_index)
-        return "0";
-
-    auto digits = number_string.substring_view(start_index, end_index - start_index);
-
-    int number_of_digits = end_index - start_index;
-
-    exponent += number_of_digits;
+    // 5. Otherwise, let n, k, and s be integers such that k ≥ 1, 10^(k-1) ≤ s < 10^k, 𝔽(s × 10^(n-k)) is x, and k is as small as possible.
+    //    If there are multiple possibilities for s, choose the value of s for which s × 10^(n-k) is closest in value to ℝ(x).
+    auto decimal = convert_double_to_shortest_decimal(d);
+    auto digits = String::number(decimal.mantissa);
+    int number_of_digits = digits.length();
+    int exponent = decimal.exponent + number_of_digits;
 
     StringBuilder builder;
 
@@ -135,6 +135,8 @@ public:
     bool is_undefined() const { return m_value.tag == UNDEFINED_TAG; }
     bool is_null() const { return m_value.tag == NULL_TAG; }
     bool is_number() const { return is_double() || is_int32(); }
+    // NOTE: This is about how the number is encoded, and not whether it's an integer that fits into an i32.
+    bool is_int32() const { return m_value.tag == INT32_TAG; }
     bool is_string() const { return m_value.tag == STRING_TAG; }
     bool is_object() const { return m_value.tag == OBJECT_TAG; }
     bool is_boolean() const { return m_value.tag == BOOLEAN_TAG; }
@@ -275,6 +277,12 @@ public:
     {
     }
 
+    i32 as_i32() const
+    {
+        VERIFY(is_int32());
+        return static_cast<i32>(m_value.encoded & 0xFFFFFFFF);
+    }
+
     double as_double() const
     {
         VERIFY(is_number());
@@ -426,13 +434,6 @@ private:
     // A double is any Value which does not have the full exponent and top mantissa bit set or has
     // exactly only those bits set.
     bool is_double() const { return (m_value.encoded & CANON_NAN_BITS) != CANON_NAN_BITS || (m_value.encoded == CANON_NAN_BITS); }
-    bool is_int32() const { return m_value.tag == INT32_TAG; }
-
-    i32 as_i32() const
-    {
-        VERIFY(is_int32());
-        return static_cast<i32>(m_value.encoded & 0xFFFFFFFF);
-    }
 
     template<typename PointerType>
     PointerType* extract_pointer() const
@@ -16,6 +16,7 @@ public:
     explicit WeakContainer(Heap&);
     virtual ~WeakContainer();
 
+    // Called right after marking, before anything has been swept, so any cell that isn't marked is dead.
     virtual void remove_dead_cells(Badge<Heap>) = 0;
 
 protected:
@@ -22,7 +22,7 @@ WeakMap::WeakMap(Object& prototype)
 void WeakMap::remove_dead_cells(Badge<Heap>)
 {
     m_values.remove_all_matching([](Cell* key, Value) {
-        return key->state() != Cell::State::Live;
+        return !key->is_marked();
     });
 }
 
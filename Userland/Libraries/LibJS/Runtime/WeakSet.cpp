@@ -22,7 +22,7 @@ WeakSet::WeakSet(Object& prototype)
 void WeakSet::remove_dead_cells(Badge<Heap>)
 {
     m_values.remove_all_matching([](Cell* cell) {
-        return cell->state() != Cell::State::Live;
+        return !cell->is_marked();
     });
 }
 
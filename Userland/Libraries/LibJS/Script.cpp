@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/LRUCache.h>
 #include <LibJS/AST.h>
 #include <LibJS/Lexer.h>
 #include <LibJS/Parser.h>
@@ -12,26 +13,66 @@
 
 namespace JS {
 
+// Scripts are often evaluated again with the same source text, e.g. when a page is reloaded or a script is included
+// in several documents. Parsing doesn't depend on the realm, so the programs of recently parsed scripts are kept around
+// to be reused. The bytecode generated for their functions lives in the AST, so it's reused along with them.
+struct CachedProgram {
+    FlyString filename;
+    size_t line_number_offset { 0 };
+    NonnullRefPtr<Program> program;
+};
+
+// The cache is limited by the size of the source text, which the size of the AST is roughly proportional to.
+static constexpr size_t cached_source_text_size_budget = 4 * MiB;
+
+static LRUCache<String, CachedProgram>& cached_programs()
+{
+    static LRUCache<String, CachedProgram> programs { cached_source_text_size_budget, [](String const& source_text, CachedProgram const&) { return source_text.length(); } };
+    return programs;
+}
+
+static RefPtr<Program> find_cached_program(StringView source_text, FlyString const& filename, size_t line_number_offset)
+{
+    auto* cached_program = cached_programs().get(source_text);
+    if (!cached_program || cached_program->filename != filename || cached_program->line_number_offset != line_number_offset)
+        return {};
+    return cached_program->program;
+}
+
+void Script::clear_cache()
+{
+    cached_programs().clear();
+}
+
 // 16.1.5 ParseScript ( sourceText, realm, hostDefined ), https://tc39.es/ecma262/#sec-parse-script
 Result<NonnullRefPtr<Script>, Vector<Parser::Error>> Script::parse(StringView source_text, Realm& realm, StringView filename, HostDefined* host_defined, size_t line_number_offset)
 {
+    // NOTE: The AST refers to the filename it was parsed with, so the script keeps it alive for as long as it lives.
+    FlyString filename_string = filename;
+
+    if (auto program = find_cached_program(source_text, filename_string, line_number_offset))
+        return adopt_ref(*new Script(realm, move(filename_string), program.release_nonnull(), host_defined));
+
     // 1. Let script be ParseText(sourceText, Script).
-    auto parser = Parser(Lexer(source_text, filename, line_number_offset));
+    auto parser = Parser(Lexer(source_text, filename_string.view(), line_number_offset));
     auto script = parser.parse_program();
 
     // 2. If script is a List of errors, return body.
     if (parser.has_errors())
         return parser.errors();
 
+    if (!parser.has_tagged_template_literals())
+        cached_programs().set(source_text, CachedProgram { filename_string, line_number_offset, script });
+
     // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
-    return adopt_ref(*new Script(realm, filename, move(script), host_defined));
+    return adopt_ref(*new Script(realm, move(filename_string), move(script), host_defined));
 }
 
-Script::Script(Realm& realm, StringView filename, NonnullRefPtr<Program> parse_node, HostDefined* host_defined)
+Script::Script(Realm& realm, FlyString filename, NonnullRefPtr<Program> parse_node, HostDefined* host_defined)
     : m_vm(realm.vm())
     , m_realm(make_handle(&realm))
     , m_parse_node(move(parse_node))
-    , m_filename(filename)
+    , m_filename(move(filename))
     , m_host_defined(host_defined)
 {
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/FlyString.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <LibJS/AST.h>
@@ -27,14 +28,17 @@ public:
     ~Script() = default;
     static Result<NonnullRefPtr<Script>, Vector<Parser::Error>> parse(StringView source_text, Realm&, StringView filename = {}, HostDefined* = nullptr, size_t line_number_offset = 1);
 
+    // Drops the programs of recently parsed scripts that are kept around to be reused.
+    static void clear_cache();
+
     Realm& realm() { return *m_realm.cell(); }
     Program const& parse_node() const { return *m_parse_node; }
 
     HostDefined* host_defined() { return m_host_defined; }
-    StringView filename() const { return m_filename; }
+    StringView filename() const { return m_filename.view(); }
 
 private:
-    Script(Realm&, StringView filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
+    Script(Realm&, FlyString filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
     // Handles are not safe unless we keep the VM alive.
     NonnullRefPtr<VM> m_vm;
 
@@ -42,7 +46,7 @@ private:
     NonnullRefPtr<Program> m_parse_node; // [[ECMAScriptCode]]
 
     // Needed for potential lookups of modules.
-    String m_filename;
+    FlyString m_filename;
     HostDefined* m_host_defined { nullptr }; // [[HostDefined]]
 };
 
@@ -0,0 +1,84 @@
+test("searching int32 elements", () => {
+    const array = [3, 1, 4, 1, 5];
+    expect(array.indexOf(1)).toBe(1);
+    expect(array.indexOf(1, 2)).toBe(3);
+    expect(array.lastIndexOf(1)).toBe(3);
+    expect(array.indexOf("1")).toBe(-1);
+    expect(array.indexOf(1.5)).toBe(-1);
+    expect([0].indexOf(-0)).toBe(0);
+    expect([0].includes(-0)).toBeTrue();
+    expect(array.includes(5)).toBeTrue();
+    expect(array.includes(NaN)).toBeFalse();
+    expect(array.includes(undefined)).toBeFalse();
+});
+
+test("searching elements after they change kinds", () => {
+    const array = [1, 2, 3];
+    array.push(0.5);
+    expect(array.indexOf(0.5)).toBe(3);
+    array.push(NaN);
+    expect(array.indexOf(NaN)).toBe(-1);
+    expect(array.includes(NaN)).toBeTrue();
+    array.push("4");
+    expect(array.indexOf("4")).toBe(5);
+    expect(array.indexOf(4)).toBe(-1);
+    expect(array.lastIndexOf(2)).toBe(1);
+});
+
+test("searching holey elements", () => {
+    const array = [1, 2, 3];
+    delete array[1];
+    expect(array.indexOf(undefined)).toBe(-1);
+    expect(array.includes(undefined)).toBeTrue();
+    Array.prototype[1] = 2;
+    try {
+        expect(array.indexOf(2)).toBe(1);
+        expect(array.includes(2)).toBeTrue();
+    } finally {
+        delete Array.prototype[1];
+    }
+});
+
+test("searching an array that shrinks", () => {
+    const array = [1, 2, 3, 4];
+    const fromIndex = {
+        valueOf() {
+            array.length = 1;
+            return 0;
+        },
+    };
+    Array.prototype[2] = 3;
+    try {
+        expect(array.indexOf(3, fromIndex)).toBe(2);
+    } finally {
+        delete Array.prototype[2];
+    }
+});
+
+test("sorting int32 elements without a comparefn", () => {
+    expect([10, 9, 1, -1, -10, 100, 0, -2147483648, 2147483647].sort()).toEqual([
+        -1, -10, -2147483648, 0, 1, 10, 100, 2147483647, 9,
+    ]);
+    expect([3, 2, 1, 0.5].sort()).toEqual([0.5, 1, 2, 3]);
+});
+
+test("visiting elements that the callback changes", () => {
+    const array = [1, 2, 3, 4];
+    const visited = [];
+    array.forEach((value, index) => {
+        visited.push(value);
+        if (index === 0) {
+            array[1] = "two";
+            array.pop();
+        }
+    });
+    expect(visited).toEqual([1, "two", 3]);
+
+    const mapped = [1, 2, 3].map((value, index, array) => {
+        if (index === 0) delete array[1];
+        return value * 2;
+    });
+    expect(mapped).toHaveLength(3);
+    expect(1 in mapped).toBeFalse();
+    expect(mapped[2]).toBe(6);
+});
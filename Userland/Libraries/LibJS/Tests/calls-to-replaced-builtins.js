@@ -0,0 +1,52 @@
+test("calls to the built-ins themselves", () => {
+    expect(Math.abs(-2.5)).toBe(2.5);
+    expect(Math.abs(-0)).toBe(0);
+    expect(Math.abs("-3")).toBe(3);
+    expect(Math.floor(1.5)).toBe(1);
+    expect(Math.floor(NaN)).toBeNaN();
+    expect(Math.floor({ valueOf: () => 2.5 })).toBe(2);
+    expect("abc".charCodeAt(1)).toBe(98);
+    expect("abc".charCodeAt(3)).toBeNaN();
+    expect("abc".charCodeAt("2")).toBe(99);
+
+    const array = [1];
+    expect(array.push(2)).toBe(2);
+    expect(array).toEqual([1, 2]);
+
+    const arrayLike = { length: 1 };
+    expect(Array.prototype.push.call(arrayLike, "x")).toBe(2);
+    expect(arrayLike[1]).toBe("x");
+});
+
+test("calls to replaced built-ins", () => {
+    const originalAbs = Math.abs;
+    const originalCharCodeAt = String.prototype.charCodeAt;
+    const originalPush = Array.prototype.push;
+    try {
+        Math.abs = () => "replaced abs";
+        String.prototype.charCodeAt = () => "replaced charCodeAt";
+        Array.prototype.push = () => "replaced push";
+
+        expect(Math.abs(-1)).toBe("replaced abs");
+        expect("abc".charCodeAt(0)).toBe("replaced charCodeAt");
+        expect([].push(1)).toBe("replaced push");
+    } finally {
+        Math.abs = originalAbs;
+        String.prototype.charCodeAt = originalCharCodeAt;
+        Array.prototype.push = originalPush;
+    }
+});
+
+test("methods with the same name as a built-in", () => {
+    const Math = { floor: () => "shadowed floor" };
+    expect(Math.floor(1.5)).toBe("shadowed floor");
+
+    const object = { push: x => x * 2, charCodeAt: () => "own charCodeAt" };
+    expect(object.push(21)).toBe(42);
+    expect(object.charCodeAt(0)).toBe("own charCodeAt");
+});
+
+test("pushing onto a frozen array throws", () => {
+    const array = Object.freeze([1]);
+    expect(() => array.push(2)).toThrow(TypeError);
+});
@@ -0,0 +1,69 @@
+// NOTE: The functions in here are long enough for their bodies to be parsed lazily, i.e. only once they're called.
+
+test("lazily parsed functions behave like any other function", () => {
+    function outer(a, b) {
+        var hoisted = typeof inner;
+        var sum = a + (b ?? a * 2);
+        function inner(c) {
+            return sum + c + (typeof arguments[1] === "number" ? arguments[1] : 0);
+        }
+        {
+            function annexB() {
+                return hoisted;
+            }
+        }
+        return [inner(1, 2), annexB(), arguments.length];
+    }
+
+    expect(outer(1)).toEqual([6, "function", 1]);
+    expect(outer(1, 1)).toEqual([5, "function", 2]);
+    expect(outer.length).toBe(2);
+    expect(outer.toString().includes("function annexB()")).toBeTrue();
+});
+
+test("lazily parsed functions keep the strictness of the code around them", () => {
+    const makeFunctions = function () {
+        "use strict";
+        return function () {
+            // This is long enough to be parsed lazily, and strict due to the directive of the function around it.
+            return this;
+        };
+    };
+    const sloppy = function () {
+        // This is long enough to be parsed lazily, and not strict as there's no directive around it.
+        return this;
+    };
+
+    expect(makeFunctions()()).toBeUndefined();
+    expect(sloppy()).toBe(globalThis);
+});
+
+test("syntax errors in functions that are never called are still reported", () => {
+    const padding = "/* Long enough to be parsed lazily, though it should fail before parsing is deferred. */";
+    expect(`function f() { ${padding} let a; }`).toEval();
+    expect(`function f() { ${padding} let a; let a; }`).not.toEval();
+    expect(`function f() { ${padding} function g() { ${padding} return; } } return;`).not.toEval();
+    expect(`"use strict"; function f() { ${padding} with ({}) {} }`).not.toEval();
+});
+
+test("errors in lazily parsed functions point to where they were created", () => {
+    const lazy = {
+        f: function () {
+            // This is long enough to be parsed lazily, and isn't in parentheses like the one below.
+            return new Error();
+        },
+    }.f;
+    const eager = {
+        f: (function () {
+            // This is long enough to be parsed lazily, but being in parentheses makes it eager.
+            return new Error();
+        }),
+    }.f;
+
+    const frames = (error, lineOffset) =>
+        error.stack
+            .split("\n")
+            .slice(1, 3)
+            .map(frame => frame.replace(/:(\d+):/, (_, line) => `:${Number(line) + lineOffset}:`));
+    expect(frames(lazy(), 6)).toEqual(frames(eager(), 0));
+});
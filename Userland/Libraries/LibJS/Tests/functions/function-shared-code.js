@@ -0,0 +1,55 @@
+test("closures made from the same code keep their own environments", () => {
+    const makeCounter = (start = 10) => {
+        let count = start;
+        return (step = 1) => (count += step);
+    };
+    const counters = [];
+    for (let i = 0; i < 5; ++i) counters.push(makeCounter(i));
+    counters.push(makeCounter());
+
+    counters.forEach((counter, i) => expect(counter()).toBe(i === 5 ? 11 : i + 1));
+    expect(counters[2](5)).toBe(8);
+    expect(counters[3]()).toBe(5);
+    expect(counters[5]()).toBe(12);
+});
+
+test("functions made from the same code get their own default parameter values", () => {
+    const makeFunction = base => (offset = base * 2) => base + offset;
+    const functions = [1, 2, 3].map(makeFunction);
+    expect(functions[0]()).toBe(3);
+    expect(functions[1]()).toBe(6);
+    expect(functions[2](1)).toBe(4);
+    expect(functions[2]()).toBe(9);
+});
+
+test("methods made from the same code see their own this values", () => {
+    const makeObject = value => ({
+        value,
+        method() {
+            return this.value;
+        },
+    });
+    const a = makeObject(1);
+    const b = makeObject(2);
+    expect(a.method()).toBe(1);
+    expect(b.method()).toBe(2);
+    expect(a.method.call(b)).toBe(2);
+});
+
+test("exceptions thrown by nested calls of the same code are caught by the right frame", () => {
+    const calls = [];
+    const run = depth => {
+        calls.push(depth);
+        if (depth === 0) throw new Error("innermost");
+        try {
+            run(depth - 1);
+        } catch (e) {
+            const caught = [depth, e.message];
+            if (depth === 1) throw new Error("rethrown");
+            return caught;
+        }
+        return "unreachable";
+    };
+    expect(run(2)).toEqual([2, "rethrown"]);
+    expect(calls).toEqual([2, 1, 0]);
+});
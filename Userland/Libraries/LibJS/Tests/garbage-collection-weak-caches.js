@@ -0,0 +1,34 @@
+test("strings that died in a collection can be made again", () => {
+    const makeString = i => "string that dies " + i;
+    for (let i = 0; i < 100; ++i) makeString(i);
+    gc();
+    for (let i = 0; i < 100; ++i) {
+        const string = makeString(i);
+        gc();
+        expect(string).toBe("string that dies " + i);
+        expect(string.length).toBe(17 + `${i}`.length);
+    }
+});
+
+test("objects can take the shape of objects that died in a collection", () => {
+    const makeObject = i => ({ shapeThatDiesA: i, shapeThatDiesB: i * 2 });
+    makeObject(0);
+    gc();
+    for (let i = 1; i < 10; ++i) {
+        const object = makeObject(i);
+        gc();
+        expect(Object.keys(object)).toEqual(["shapeThatDiesA", "shapeThatDiesB"]);
+        expect(object.shapeThatDiesB).toBe(i * 2);
+    }
+});
+
+test("objects can take prototypes of objects that died in a collection", () => {
+    const prototype = { fromPrototype: 1 };
+    const makeObject = () => Object.setPrototypeOf({ ownProperty: 2 }, prototype);
+    makeObject();
+    gc();
+    const object = makeObject();
+    gc();
+    expect(object.fromPrototype).toBe(1);
+    expect(object.ownProperty).toBe(2);
+});
@@ -0,0 +1,60 @@
+test("objects that share the start of their shapes see only their own properties", () => {
+    const a = {};
+    a.first = 1;
+    a.second = 2;
+    const b = {};
+    b.first = 3;
+    b.second = 4;
+    b.third = 5;
+    const c = {};
+    c.first = 6;
+    c.other = 7;
+
+    expect(Object.keys(a)).toEqual(["first", "second"]);
+    expect(a.third).toBeUndefined();
+    expect(a.other).toBeUndefined();
+    expect(Object.keys(b)).toEqual(["first", "second", "third"]);
+    expect(b.other).toBeUndefined();
+    expect(Object.keys(c)).toEqual(["first", "other"]);
+    expect(c.second).toBeUndefined();
+    expect(c.other).toBe(7);
+});
+
+test("reconfiguring a property doesn't affect objects with the same properties", () => {
+    const a = { x: 1, y: 2 };
+    const b = { x: 3, y: 4 };
+    Object.defineProperty(a, "x", { enumerable: false });
+    b.z = 5;
+
+    expect(Object.keys(a)).toEqual(["y"]);
+    expect(Object.keys(b)).toEqual(["x", "y", "z"]);
+    expect(Object.getOwnPropertyDescriptor(b, "x").enumerable).toBeTrue();
+});
+
+test("deleting the property that was added last", () => {
+    const a = { x: 1, y: 2 };
+    a.temporary = 3;
+    expect(delete a.temporary).toBeTrue();
+    expect(a.temporary).toBeUndefined();
+    expect(Object.keys(a)).toEqual(["x", "y"]);
+    a.z = 4;
+    expect(Object.keys(a)).toEqual(["x", "y", "z"]);
+    expect(a.z).toBe(4);
+
+    const b = { x: 5, y: 6 };
+    expect(delete b.x).toBeTrue();
+    expect(Object.keys(b)).toEqual(["y"]);
+    expect(b.y).toBe(6);
+});
+
+test("objects with many properties", () => {
+    const object = {};
+    for (let i = 0; i < 500; ++i) object[`property${i}`] = i;
+    for (let i = 0; i < 500; i += 2) delete object[`property${i}`];
+
+    const keys = Object.keys(object);
+    expect(keys).toHaveLength(250);
+    expect(keys[0]).toBe("property1");
+    expect(keys[249]).toBe("property499");
+    for (let i = 0; i < 500; ++i) expect(object[`property${i}`]).toBe(i % 2 ? i : undefined);
+});
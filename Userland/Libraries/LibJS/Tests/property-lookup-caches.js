@@ -0,0 +1,148 @@
+// NOTE: These exercise the shape-based caches of GetById and PutById, which only exist in bytecode mode.
+//       Every access site in here runs several times, so that the later runs take the cached path.
+
+describe("get", () => {
+    test("objects of different shapes at the same site", () => {
+        const get = o => o.foo;
+        const objects = [{ foo: 1 }, { bar: 0, foo: 2 }, { baz: 0, bar: 0, foo: 3 }, { foo: 4, x: 0 }, { y: 0, foo: 5 }];
+        for (let i = 0; i < 3; ++i) {
+            for (let j = 0; j < objects.length; ++j) expect(get(objects[j])).toBe(j + 1);
+        }
+    });
+
+    test("property changes are seen", () => {
+        const get = o => o.foo;
+        const o = { foo: 1 };
+        expect(get(o)).toBe(1);
+        expect(get(o)).toBe(1);
+        o.foo = 2;
+        expect(get(o)).toBe(2);
+        delete o.foo;
+        expect(get(o)).toBeUndefined();
+        o.foo = 3;
+        expect(get(o)).toBe(3);
+    });
+
+    test("data property turned into an accessor", () => {
+        const get = o => o.foo;
+        const o = { foo: 1 };
+        expect(get(o)).toBe(1);
+        expect(get(o)).toBe(1);
+        Object.defineProperty(o, "foo", { get: () => 2 });
+        expect(get(o)).toBe(2);
+        expect(get(o)).toBe(2);
+    });
+
+    test("properties found on the prototype", () => {
+        const get = o => o.foo;
+        const prototype = { foo: 1 };
+        const o = Object.create(prototype);
+        expect(get(o)).toBe(1);
+        expect(get(o)).toBe(1);
+        prototype.foo = 2;
+        expect(get(o)).toBe(2);
+        o.foo = 3;
+        expect(get(o)).toBe(3);
+        delete o.foo;
+        expect(get(o)).toBe(2);
+        delete prototype.foo;
+        expect(get(o)).toBeUndefined();
+    });
+
+    test("prototype replaced", () => {
+        const get = o => o.foo;
+        const o = Object.create({ foo: 1 });
+        expect(get(o)).toBe(1);
+        expect(get(o)).toBe(1);
+        Object.setPrototypeOf(o, { foo: 2 });
+        expect(get(o)).toBe(2);
+        expect(get(o)).toBe(2);
+    });
+
+    test("objects with unique shapes", () => {
+        const get = o => o.foo;
+        const o = {};
+        for (let i = 0; i < 200; ++i) o["p" + i] = i;
+        o.foo = 1;
+        expect(get(o)).toBe(1);
+        expect(get(o)).toBe(1);
+        delete o.p0;
+        expect(get(o)).toBe(1);
+        delete o.foo;
+        expect(get(o)).toBeUndefined();
+        o.foo = 2;
+        expect(get(o)).toBe(2);
+    });
+});
+
+describe("put", () => {
+    test("existing properties", () => {
+        const put = (o, value) => {
+            o.foo = value;
+        };
+        const o = { foo: 0 };
+        for (let i = 0; i < 5; ++i) {
+            put(o, i);
+            expect(o.foo).toBe(i);
+        }
+    });
+
+    test("property made non-writable", () => {
+        const put = (o, value) => {
+            o.foo = value;
+        };
+        const o = { foo: 0 };
+        put(o, 1);
+        put(o, 2);
+        Object.defineProperty(o, "foo", { writable: false });
+        put(o, 3);
+        expect(o.foo).toBe(2);
+    });
+
+    test("frozen object", () => {
+        const put = (o, value) => {
+            "use strict";
+            o.foo = value;
+        };
+        const o = { foo: 0 };
+        put(o, 1);
+        put(o, 2);
+        Object.freeze(o);
+        expect(() => put(o, 3)).toThrow(TypeError);
+        expect(o.foo).toBe(2);
+    });
+
+    test("data property turned into an accessor", () => {
+        const put = (o, value) => {
+            o.foo = value;
+        };
+        let setterValue;
+        const o = { foo: 0 };
+        put(o, 1);
+        put(o, 2);
+        Object.defineProperty(o, "foo", {
+            set: value => {
+                setterValue = value;
+            },
+        });
+        put(o, 3);
+        expect(setterValue).toBe(3);
+    });
+
+    test("setter on the prototype", () => {
+        const put = (o, value) => {
+            o.foo = value;
+        };
+        let setterValue;
+        const prototype = {
+            set foo(value) {
+                setterValue = value;
+            },
+        };
+        const o = Object.create(prototype);
+        put(o, 1);
+        put(o, 2);
+        expect(setterValue).toBe(2);
+        expect(Object.getOwnPropertyNames(o)).toEqual([]);
+    });
+});
@@ -28,3 +28,17 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("length of concatenated strings", () => {
+    expect(("\ud834" + "\udf06").length).toBe(2);
+    expect(("😀" + "a" + "\udf06").length).toBe(4);
+    expect(`${"ab"}${"\ud834"}${"\udf06"}${1}`.length).toBe(5);
+
+    let string = "";
+    for (let i = 0; i < 1000; ++i) {
+        string += i % 2 ? "\ud834" : "\udf06";
+        expect(string.length).toBe(i + 1);
+    }
+    expect(string[0]).toBe("\udf06");
+    expect(string.codePointAt(1)).toBe(0x1d306);
+});
@@ -6,10 +6,14 @@
 
 #include <LibPDF/CommonNames.h>
 #include <LibPDF/Document.h>
+#include <LibPDF/Fonts/PDFFont.h>
 #include <LibPDF/Parser.h>
 
 namespace PDF {
 
+// Page tree nodes are looked up by following /Parent, which must not loop forever in broken files.
+static constexpr size_t max_page_tree_depth = 256;
+
 String OutlineItem::to_string(int indent) const
 {
     auto indent_str = String::repeated("  "sv, indent + 1);
@@ -63,6 +67,8 @@ Document::Document(NonnullRefPtr<Parser> const& parser)
     m_parser->set_document(this);
 }
 
+Document::~Document() = default;
+
 PDFErrorOr<void> Document::initialize()
 {
     if (m_security_handler)
@@ -79,12 +85,27 @@ PDFErrorOr<Value> Document::get_or_load_value(u32 index)
     auto value = get_value(index);
     if (!value.has<Empty>()) // FIXME: Use Optional instead?
         return value;
+    if (auto* stream = m_cached_streams.get(index))
+        return *stream;
 
     auto object = TRY(m_parser->parse_object_with_index(index));
-    m_values.set(index, object);
+    if (object.has<NonnullRefPtr<Object>>() && object.get<NonnullRefPtr<Object>>()->is<StreamObject>())
+        m_cached_streams.set(index, object.get<NonnullRefPtr<Object>>()->cast<StreamObject>());
+    else
+        m_values.set(index, object);
     return object;
 }
 
+PDFErrorOr<NonnullRefPtr<PDFFont>> Document::get_or_create_font(NonnullRefPtr<DictObject> const& font_dictionary)
+{
+    if (auto font = m_fonts.get(font_dictionary); font.has_value())
+        return *font.value();
+
+    auto font = TRY(PDFFont::create(this, font_dictionary));
+    m_fonts.set(font_dictionary, font);
+    return font;
+}
+
 u32 Document::get_first_page_index() const
 {
     // FIXME: A PDF can have a different default first page, which
@@ -109,40 +130,29 @@ PDFErrorOr<Page> Document::get_page(u32 index)
     auto page_object = TRY(get_or_load_value(page_object_index));
     auto raw_page_object = TRY(resolve_to<DictObject>(page_object));
 
-    if (!raw_page_object->contains(CommonNames::Resources)) {
-        // This page inherits its resource dictionary
-        TODO();
-    }
+    NonnullRefPtr<DictObject> resources = adopt_ref(*new DictObject({}));
+    if (auto resources_value = TRY(get_inheritable_value(raw_page_object, CommonNames::Resources)); resources_value.has_value())
+        resources = TRY(resolve_to<DictObject>(resources_value.value()));
 
-    auto resources = TRY(raw_page_object->get_dict(this, CommonNames::Resources));
-    auto contents = TRY(raw_page_object->get_object(this, CommonNames::Contents));
+    // A page without contents is blank.
+    auto contents = raw_page_object->get(CommonNames::Contents).value_or({});
 
-    auto media_box_array = TRY(raw_page_object->get_array(this, CommonNames::MediaBox));
-    auto media_box = Rectangle {
-        media_box_array->at(0).to_float(),
-        media_box_array->at(1).to_float(),
-        media_box_array->at(2).to_float(),
-        media_box_array->at(3).to_float(),
-    };
+    auto media_box_value = TRY(get_inheritable_value(raw_page_object, CommonNames::MediaBox));
+    if (!media_box_value.has_value())
+        return Error { Error::Type::MalformedPDF, "Page has no media box" };
+    auto media_box = TRY(get_rectangle(media_box_value.value()));
 
     auto crop_box = media_box;
-    if (raw_page_object->contains(CommonNames::CropBox)) {
-        auto crop_box_array = TRY(raw_page_object->get_array(this, CommonNames::CropBox));
-        crop_box = Rectangle {
-            crop_box_array->at(0).to_float(),
-            crop_box_array->at(1).to_float(),
-            crop_box_array->at(2).to_float(),
-            crop_box_array->at(3).to_float(),
-        };
-    }
+    if (auto crop_box_value = TRY(get_inheritable_value(raw_page_object, CommonNames::CropBox)); crop_box_value.has_value())
+        crop_box = TRY(get_rectangle(crop_box_value.value()));
 
     float user_unit = 1.0f;
     if (raw_page_object->contains(CommonNames::UserUnit))
         user_unit = raw_page_object->get_value(CommonNames::UserUnit).to_float();
 
     int rotate = 0;
-    if (raw_page_object->contains(CommonNames::Rotate)) {
-        rotate = raw_page_object->get_value(CommonNames::Rotate).get<int>();
+    if (auto rotate_value = TRY(get_inheritable_value(raw_page_object, CommonNames::Rotate)); rotate_value.has_value()) {
+        rotate = TRY(resolve_to<int>(rotate_value.value()));
         VERIFY(rotate % 90 == 0);
     }
 
@@ -151,6 +161,33 @@ PDFErrorOr<Page> Document::get_page(u32 index)
     return page;
 }
 
+PDFErrorOr<Optional<Value>> Document::get_inheritable_value(NonnullRefPtr<DictObject> const& page_object, FlyString const& key)
+{
+    auto node = page_object;
+    for (size_t depth = 0; depth < max_page_tree_depth; ++depth) {
+        if (auto value = node->get(key); value.has_value())
+            return value;
+        if (!node->contains(CommonNames::Parent))
+            return Optional<Value> {};
+        node = TRY(node->get_dict(this, CommonNames::Parent));
+    }
+    return Error { Error::Type::MalformedPDF, "Page tree is too deep" };
+}
+
+PDFErrorOr<Rectangle> Document::get_rectangle(Value const& value)
+{
+    auto array = TRY(resolve_to<ArrayObject>(value));
+    if (array->size() != 4)
+        return Error { Error::Type::MalformedPDF, "Rectangle must have four elements" };
+
+    return Rectangle {
+        array->at(0).to_float(),
+        array->at(1).to_float(),
+        array->at(2).to_float(),
+        array->at(3).to_float(),
+    };
+}
+
 PDFErrorOr<Value> Document::resolve(Value const& value)
 {
     if (value.has<Reference>()) {
@@ -8,6 +8,7 @@
 
 #include <AK/Format.h>
 #include <AK/HashMap.h>
+#include <AK/LRUCache.h>
 #include <AK/RefCounted.h>
 #include <AK/Weakable.h>
 #include <LibGfx/Color.h>
@@ -18,6 +19,8 @@
 
 namespace PDF {
 
+class PDFFont;
+
 struct Rectangle {
     float lower_left_x;
     float lower_left_y;
@@ -30,7 +33,9 @@ struct Rectangle {
 
 struct Page {
     NonnullRefPtr<DictObject> resources;
-    NonnullRefPtr<Object> contents;
+    // Left unresolved, so that the (usually large) content streams are only
+    // loaded while the page is being rendered.
+    Value contents;
     Rectangle media_box;
     Rectangle crop_box;
     float user_unit;
@@ -82,6 +87,8 @@ class Document final
 public:
     static PDFErrorOr<NonnullRefPtr<Document>> create(ReadonlyBytes bytes);
 
+    ~Document();
+
     // If a security handler is present, it is the caller's responsibility to ensure
     // this document is unencrypted before calling this function. The user does not
     // need to handle the case where the user password is the empty string.
@@ -106,6 +113,10 @@ public:
         return m_values.get(index).value_or({});
     }
 
+    // Fonts are expensive to parse, so every font dictionary is only turned into
+    // a PDFFont once, and shared by all pages that use it.
+    PDFErrorOr<NonnullRefPtr<PDFFont>> get_or_create_font(NonnullRefPtr<DictObject> const& font_dictionary);
+
     // Strips away the layer of indirection by turning indirect value
     // refs into the value they reference, and indirect values into
     // the value being wrapped.
@@ -133,8 +144,18 @@ public:
     }
 
 private:
+    // Decoded streams (page contents, images, embedded fonts) are by far the largest objects
+    // in a document, so only this many bytes of them are kept around. The ones that were used
+    // least recently are dropped first, and are parsed again if they are needed later.
+    static constexpr size_t stream_cache_budget = 64 * MiB;
+
     explicit Document(NonnullRefPtr<Parser> const& parser);
 
+    // Looks up an inheritable page attribute (ISO 32000 7.7.3.4), which may be
+    // specified on the page itself or on any of its ancestors in the page tree.
+    PDFErrorOr<Optional<Value>> get_inheritable_value(NonnullRefPtr<DictObject> const& page_object, FlyString const& key);
+    PDFErrorOr<Rectangle> get_rectangle(Value const&);
+
     // FIXME: Currently, to improve performance, we don't load any pages at Document
     // construction, rather we just load the page structure and populate
     // m_page_object_indices. However, we can be even lazier and defer page tree node
@@ -156,6 +177,8 @@ private:
     Vector<u32> m_page_object_indices;
     HashMap<u32, Page> m_pages;
     HashMap<u32, Value> m_values;
+    LRUCache<u32, NonnullRefPtr<StreamObject>> m_cached_streams { stream_cache_budget, [](u32, NonnullRefPtr<StreamObject> const& stream) { return stream->bytes().size(); } };
+    HashMap<NonnullRefPtr<DictObject>, NonnullRefPtr<PDFFont>> m_fonts;
     RefPtr<OutlineDict> m_outline;
     RefPtr<SecurityHandler> m_security_handler;
 };
@@ -184,7 +207,7 @@ struct Formatter<PDF::Page> : Formatter<FormatString> {
         return Formatter<FormatString>::format(builder,
             "Page {{\n  resources={}\n  contents={}\n  media_box={}\n  crop_box={}\n  user_unit={}\n  rotate={}\n}}"sv,
             page.resources->to_string(1),
-            page.contents->to_string(1),
+            page.contents.to_string(1),
             page.media_box,
             page.crop_box,
             page.user_unit,
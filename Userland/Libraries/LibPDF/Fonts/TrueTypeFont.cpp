@@ -26,11 +26,12 @@ PDFErrorOr<NonnullRefPtr<PDFFont>> TrueTypeFont::create(Document* document, Nonn
     auto ttf_font = TRY(TTF::Font::try_load_from_externally_owned_memory(font_file->bytes()));
     auto data = TRY(Type1Font::parse_data(document, dict));
 
-    return adopt_ref(*new TrueTypeFont(ttf_font, move(data)));
+    return adopt_ref(*new TrueTypeFont(font_file, ttf_font, move(data)));
 }
 
-TrueTypeFont::TrueTypeFont(NonnullRefPtr<TTF::Font> ttf_font, Type1Font::Data data)
-    : m_ttf_font(ttf_font)
+TrueTypeFont::TrueTypeFont(NonnullRefPtr<StreamObject> font_file, NonnullRefPtr<TTF::Font> ttf_font, Type1Font::Data data)
+    : m_font_file(move(font_file))
+    , m_ttf_font(ttf_font)
     , m_data(data)
 {
 }
@@ -15,13 +15,16 @@ class TrueTypeFont : public PDFFont {
 public:
     static PDFErrorOr<NonnullRefPtr<PDFFont>> create(Document*, NonnullRefPtr<DictObject>);
 
-    TrueTypeFont(NonnullRefPtr<TTF::Font> ttf_font, Type1Font::Data);
+    TrueTypeFont(NonnullRefPtr<StreamObject> font_file, NonnullRefPtr<TTF::Font> ttf_font, Type1Font::Data);
     ~TrueTypeFont() override = default;
 
     u32 char_code_to_code_point(u16 char_code) const override;
     float get_char_width(u16 char_code, float font_size) const override;
 
 private:
+    // The TTF::Font reads from the stream's memory, and the document may drop its own
+    // reference to the stream at any time.
+    NonnullRefPtr<StreamObject> m_font_file;
     NonnullRefPtr<TTF::Font> m_ttf_font;
     Type1Font::Data m_data;
 };
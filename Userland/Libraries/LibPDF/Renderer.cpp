@@ -67,15 +67,18 @@ PDFErrorOr<void> Renderer::render()
     // as one stream or multiple?
     ByteBuffer byte_buffer;
 
-    if (m_page.contents->is<ArrayObject>()) {
-        auto contents = m_page.contents->cast<ArrayObject>();
-        for (auto& ref : *contents) {
-            auto bytes = TRY(m_document->resolve_to<StreamObject>(ref))->bytes();
-            byte_buffer.append(bytes.data(), bytes.size());
+    if (m_page.contents.has<Empty>())
+        return {};
+
+    auto contents = TRY(m_document->resolve_to<Object>(m_page.contents));
+    if (contents->is<ArrayObject>()) {
+        for (auto& ref : *contents->cast<ArrayObject>()) {
+            auto stream = TRY(m_document->resolve_to<StreamObject>(ref));
+            byte_buffer.append(stream->bytes().data(), stream->bytes().size());
         }
     } else {
-        auto bytes = m_page.contents->cast<StreamObject>()->bytes();
-        byte_buffer.append(bytes.data(), bytes.size());
+        auto stream = contents->cast<StreamObject>();
+        byte_buffer.append(stream->bytes().data(), stream->bytes().size());
     }
 
     auto operators = TRY(Parser::parse_operators(m_document, byte_buffer));
@@ -347,8 +350,7 @@ RENDERER_HANDLER(text_set_font)
     auto target_font_name = MUST(m_document->resolve_to<NameObject>(args[0]))->name();
     auto fonts_dictionary = MUST(m_page.resources->get_dict(m_document, CommonNames::Font));
     auto font_dictionary = MUST(fonts_dictionary->get_dict(m_document, target_font_name));
-    auto font = TRY(PDFFont::create(m_document, font_dictionary));
-    text_state().font = font;
+    text_state().font = TRY(m_document->get_or_create_font(font_dictionary));
 
     // FIXME: We do not yet have the standard 14 fonts, as some of them are not open fonts,
     //        so we just use LiberationSerif for everything
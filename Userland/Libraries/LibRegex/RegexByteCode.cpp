@@ -154,8 +154,8 @@ static bool restore_string_position(MatchInput const& input, MatchState& state)
     return true;
 }
 
-OwnPtr<OpCode> ByteCode::s_opcodes[(size_t)OpCodeId::Last + 1];
-bool ByteCode::s_opcodes_initialized { false };
+thread_local OwnPtr<OpCode> ByteCode::s_opcodes[(size_t)OpCodeId::Last + 1];
+thread_local bool ByteCode::s_opcodes_initialized { false };
 
 void ByteCode::ensure_opcodes_initialized()
 {
@@ -180,6 +180,10 @@ ALWAYS_INLINE OpCode& ByteCode::get_opcode_by_id(OpCodeId id) const
 {
     VERIFY(id >= OpCodeId::First && id <= OpCodeId::Last);
 
+    // The bytecode may have been created on another thread.
+    if (!s_opcodes_initialized) [[unlikely]]
+        ensure_opcodes_initialized();
+
     auto& opcode = s_opcodes[(u32)id];
     opcode->set_bytecode(*const_cast<ByteCode*>(this));
     return *opcode;
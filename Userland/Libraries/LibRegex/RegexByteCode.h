@@ -515,10 +515,11 @@ private:
             empend((ByteCodeValueType)view[i]);
     }
 
-    void ensure_opcodes_initialized();
+    static void ensure_opcodes_initialized();
     ALWAYS_INLINE OpCode& get_opcode_by_id(OpCodeId id) const;
-    static OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
-    static bool s_opcodes_initialized;
+    // The opcodes point at the bytecode and state they're executing, so every thread needs its own.
+    static thread_local OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
+    static thread_local bool s_opcodes_initialized;
 };
 
 #define ENUMERATE_EXECUTION_RESULTS                          \
@@ -35,6 +35,7 @@ public:
     template<typename T>
     void print_bytecode(Regex<T> const& regex) const
     {
+        outln(m_file, "Execution engine: {}", regex.parser_result.execution_engine == ExecutionEngine::LazyDFA ? "lazy DFA"sv : "backtracking"sv);
         print_bytecode(regex.parser_result.bytecode);
     }
 
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/HashTable.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <LibRegex/RegexByteCode.h>
+#include <LibRegex/RegexLazyDFA.h>
+
+namespace regex {
+
+// A thread is the position of a Compare that's waiting for the next character, with the offset into the string for string compares
+// in the upper half. Reaching the end of the bytecode is represented by a thread at bytecode.size(), which makes a state accepting.
+static constexpr u64 unanchored_marker = NumericLimits<u64>::max();
+
+static constexpr size_t max_state_count = 4096;
+static constexpr size_t max_cache_resets = 8;
+
+static Optional<size_t> single_string_length(ByteCode const& bytecode, size_t instruction_position)
+{
+    // Strings only ever appear on their own in a compare, and are laid out as [Compare, 1, size, String, length, characters...].
+    if (bytecode.at(instruction_position + 1) != 1 || static_cast<CharacterCompareType>(bytecode.at(instruction_position + 3)) != CharacterCompareType::String)
+        return {};
+    return bytecode.at(instruction_position + 4);
+}
+
+static bool string_character_matches(MatchInput const& input, ByteCodeValueType expected, u32 ch)
+{
+    // NOTE: Anything outside of ASCII is compared in ways we don't model here, so let the backtracking VM decide.
+    if (expected > 0x7f)
+        return true;
+    if (input.regex_options & AllFlags::Insensitive)
+        return to_ascii_lowercase(ch) == to_ascii_lowercase(expected);
+    return ch == expected;
+}
+
+bool LazyDFA::can_execute(ByteCode const& bytecode)
+{
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            // These are only used for lookarounds, which move the string position around.
+            return false;
+        case OpCodeId::Compare: {
+            if (single_string_length(bytecode, state.instruction_position).has_value())
+                break;
+            for (auto& compare : to<OpCode_Compare>(opcode).flat_compares()) {
+                // Backreferences depend on the captures, which we don't keep track of.
+                if (compare.type == CharacterCompareType::Reference || compare.type == CharacterCompareType::String)
+                    return false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+    return true;
+}
+
+bool LazyDFA::can_run_on(RegexStringView const& view, size_t length)
+{
+    // Transitions are keyed by the character at a position, so every position has to be exactly one code unit.
+    // NOTE: Non-Unicode UTF-8 views index by byte, which would put us in the middle of code points.
+    if (length != view.length_in_code_units())
+        return false;
+    return view.unicode() || !view.is_u8_view();
+}
+
+bool LazyDFA::could_match_at(ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    return run(bytecode, input, position, false);
+}
+
+bool LazyDFA::could_match_after(ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    return run(bytecode, input, position, true);
+}
+
+bool LazyDFA::run(ByteCode const& bytecode, MatchInput const& input, size_t position, bool unanchored)
+{
+    if (!prepare(input))
+        return true;
+
+    auto length = input.view.length_in_code_units();
+    auto* state = initial_state(bytecode, input, position, unanchored);
+    for (;;) {
+        if (!state || state->is_accepting)
+            return true;
+        if (state->threads.is_empty() || position >= length)
+            return false;
+        state = transition(*state, bytecode, input, position++);
+    }
+}
+
+bool LazyDFA::prepare(MatchInput const& input)
+{
+    if (m_gave_up)
+        return false;
+
+    // The options decide how characters are compared and assertions are checked, so states can't be shared between them.
+    if (!m_options.has_value() || *m_options != input.regex_options.value()) {
+        reset();
+        m_options = input.regex_options.value();
+    }
+    return true;
+}
+
+void LazyDFA::reset()
+{
+    m_states.clear();
+    m_initial_states = {};
+}
+
+LazyDFA::State* LazyDFA::initial_state(ByteCode const& bytecode, MatchInput const& input, size_t position, bool unanchored)
+{
+    // Whether a CheckBegin passes only depends on whether we're at the start of the input or right after a newline.
+    size_t context = 2;
+    if (position == 0)
+        context = 0;
+    else if (input.view[position - 1] == '\n')
+        context = 1;
+
+    auto& initial_state = m_initial_states[context * 2 + (unanchored ? 1 : 0)];
+    if (initial_state)
+        return initial_state;
+
+    Vector<u64> threads;
+    Vector<size_t> instruction_positions;
+    instruction_positions.append(0);
+    add_threads(bytecode, input, position, instruction_positions, threads);
+    if (unanchored)
+        threads.append(unanchored_marker);
+
+    initial_state = intern(bytecode, move(threads));
+    return initial_state;
+}
+
+LazyDFA::State* LazyDFA::transition(State& state, ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    u32 ch = input.view[position];
+    if (ch < state.ascii_transitions.size()) {
+        if (auto* next_state = state.ascii_transitions[ch])
+            return next_state;
+    } else if (auto it = state.transitions.find(ch); it != state.transitions.end()) {
+        return it->value;
+    }
+
+    Vector<u64> next_threads;
+    Vector<size_t> instruction_positions;
+    bool unanchored = false;
+    for (auto thread : state.threads) {
+        if (thread == unanchored_marker) {
+            unanchored = true;
+            continue;
+        }
+        if (thread == bytecode.size())
+            continue;
+
+        auto instruction_position = static_cast<size_t>(thread & 0xffffffff);
+        auto string_offset = static_cast<size_t>(thread >> 32);
+
+        MatchState match_state;
+        match_state.instruction_position = instruction_position;
+        match_state.string_position = position;
+        match_state.string_position_in_code_units = position;
+        auto& compare = to<OpCode_Compare>(bytecode.get_opcode(match_state));
+
+        if (auto string_length = single_string_length(bytecode, instruction_position); string_length.has_value()) {
+            if (!string_character_matches(input, bytecode.at(instruction_position + 5 + string_offset), ch))
+                continue;
+            if (string_offset + 1 < *string_length)
+                next_threads.append(instruction_position | (static_cast<u64>(string_offset + 1) << 32));
+            else
+                instruction_positions.append(instruction_position + compare.size());
+            continue;
+        }
+
+        if (compare.execute(input, match_state) != ExecutionResult::Continue)
+            continue;
+        if (match_state.string_position != position + 1) {
+            // This compare consumed something other than a single character, which we can't follow.
+            m_gave_up = true;
+            reset();
+            return nullptr;
+        }
+        instruction_positions.append(instruction_position + compare.size());
+    }
+
+    if (unanchored)
+        instruction_positions.append(0);
+    add_threads(bytecode, input, position + 1, instruction_positions, next_threads);
+    if (unanchored)
+        next_threads.append(unanchored_marker);
+
+    auto cache_resets = m_cache_resets;
+    auto* next_state = intern(bytecode, move(next_threads));
+
+    // NOTE: If the cache was reset to make room, `state` is gone along with everything else.
+    if (!next_state || cache_resets != m_cache_resets)
+        return next_state;
+
+    if (ch < state.ascii_transitions.size())
+        state.ascii_transitions[ch] = next_state;
+    else
+        state.transitions.set(ch, next_state);
+    return next_state;
+}
+
+LazyDFA::State* LazyDFA::intern(ByteCode const& bytecode, Vector<u64>&& threads)
+{
+    quick_sort(threads);
+    size_t unique_count = 0;
+    for (size_t i = 0; i < threads.size(); ++i) {
+        if (unique_count == 0 || threads[unique_count - 1] != threads[i])
+            threads[unique_count++] = threads[i];
+    }
+    threads.shrink(unique_count);
+
+    if (auto it = m_states.find(threads); it != m_states.end())
+        return it->value.ptr();
+
+    if (m_states.size() >= max_state_count) {
+        // Start over instead of growing without bounds, but don't keep doing that for patterns that never settle down.
+        reset();
+        if (++m_cache_resets > max_cache_resets) {
+            m_gave_up = true;
+            return nullptr;
+        }
+    }
+
+    auto state = make<State>();
+    state->threads = threads;
+    state->is_accepting = threads.contains_slow(bytecode.size());
+    auto* state_ptr = state.ptr();
+    m_states.set(move(threads), move(state));
+    return state_ptr;
+}
+
+void LazyDFA::add_threads(ByteCode const& bytecode, MatchInput const& input, size_t position, Vector<size_t>& instruction_positions, Vector<u64>& threads)
+{
+    auto bytecode_size = bytecode.size();
+    HashTable<size_t> visited;
+
+    while (!instruction_positions.is_empty()) {
+        auto instruction_position = instruction_positions.take_last();
+        if (instruction_position >= bytecode_size) {
+            threads.append(bytecode_size);
+            continue;
+        }
+        if (visited.set(instruction_position) != AK::HashSetResult::InsertedNewEntry)
+            continue;
+
+        MatchState state;
+        state.instruction_position = instruction_position;
+        state.string_position = position;
+        state.string_position_in_code_units = position;
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_instruction_position = instruction_position + opcode.size();
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (single_string_length(bytecode, instruction_position) == 0u)
+                instruction_positions.append(next_instruction_position);
+            else
+                threads.append(instruction_position);
+            break;
+        case OpCodeId::Jump:
+            instruction_positions.append(next_instruction_position + static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            instruction_positions.append(next_instruction_position);
+            instruction_positions.append(next_instruction_position + static_cast<OpCode_ForkJump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            instruction_positions.append(next_instruction_position);
+            instruction_positions.append(next_instruction_position + static_cast<OpCode_ForkStay const&>(opcode).offset());
+            break;
+        case OpCodeId::JumpNonEmpty:
+            // NOTE: Taking the jump only matters for the empty check, both ways lead to the same matches.
+            instruction_positions.append(next_instruction_position);
+            instruction_positions.append(next_instruction_position + static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+            break;
+        case OpCodeId::Repeat:
+            // We don't count repetitions, so this may repeat any number of times.
+            instruction_positions.append(next_instruction_position);
+            instruction_positions.append(instruction_position - static_cast<OpCode_Repeat const&>(opcode).offset());
+            break;
+        case OpCodeId::CheckBegin:
+            if (opcode.execute(input, state) == ExecutionResult::Continue)
+                instruction_positions.append(next_instruction_position);
+            break;
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            // These depend on characters we haven't looked at yet, so just assume they pass.
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::ResetRepeat:
+            instruction_positions.append(next_instruction_position);
+            break;
+        case OpCodeId::Exit:
+            // An Exit before the end of the bytecode never succeeds.
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            VERIFY_NOT_REACHED();
+        }
+    }
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Forward.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// A DFA whose states are built on demand from the bytecode, one transition at a time.
+// It only ever answers whether a match *could* start at (or after) some position, which lets the matcher
+// skip running the backtracking VM where it can only fail. Captures and the exact bounds of a match
+// are still found by the backtracking VM.
+// NOTE: Assertions that depend on what comes after a position (and bounded repetitions) are assumed to pass,
+//       so this may report a possible match where there is none, but never the other way around.
+class LazyDFA {
+public:
+    static bool can_execute(ByteCode const&);
+    static bool can_run_on(RegexStringView const&, size_t length);
+
+    bool could_match_at(ByteCode const&, MatchInput const&, size_t position);
+    bool could_match_after(ByteCode const&, MatchInput const&, size_t position);
+
+private:
+    struct State {
+        Vector<u64> threads;
+        bool is_accepting { false };
+        Array<State*, 128> ascii_transitions {};
+        HashMap<u32, State*> transitions;
+    };
+
+    struct ThreadListTraits : public GenericTraits<Vector<u64>> {
+        static unsigned hash(Vector<u64> const& threads)
+        {
+            unsigned hash = 0;
+            for (auto thread : threads)
+                hash = pair_int_hash(hash, u64_hash(thread));
+            return hash;
+        }
+        static bool equals(Vector<u64> const& a, Vector<u64> const& b) { return a == b; }
+    };
+
+    bool run(ByteCode const&, MatchInput const&, size_t position, bool unanchored);
+    bool prepare(MatchInput const&);
+    void reset();
+
+    State* initial_state(ByteCode const&, MatchInput const&, size_t position, bool unanchored);
+    State* transition(State&, ByteCode const&, MatchInput const&, size_t position);
+    State* intern(ByteCode const&, Vector<u64>&& threads);
+    static void add_threads(ByteCode const&, MatchInput const&, size_t position, Vector<size_t>& instruction_positions, Vector<u64>& threads);
+
+    HashMap<Vector<u64>, NonnullOwnPtr<State>, ThreadListTraits> m_states;
+    Array<State*, 6> m_initial_states {};
+    Optional<AllFlags> m_options;
+    size_t m_cache_resets { 0 };
+    bool m_gave_up { false };
+};
+
+}
@@ -5,11 +5,14 @@
  */
 
 #include <AK/BumpAllocator.h>
+#include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
+#include <string.h>
 
 #if REGEX_DEBUG
 #    include <LibRegex/RegexDebug.h>
@@ -99,6 +102,62 @@ String Regex<Parser>::error_string(Optional<String> message) const
     return eb.build();
 }
 
+// Returns the first position at or after `start` where `prefix` appears in the view, or `start` itself if we can't search for it.
+static Optional<size_t> find_required_prefix(RegexStringView const& view, size_t start, Span<u32 const> prefix)
+{
+    // NOTE: This only works if positions are code units, and only for the parts of the prefix that are written the same way in the view.
+    if (view.is_u8_view() || view.is_u32_view())
+        return start;
+
+    if (!view.is_u16_view()) {
+        auto string = view.string_view();
+        Vector<char, 16> needle;
+        for (auto ch : prefix) {
+            if (ch > 0x7f)
+                break;
+            needle.append(static_cast<char>(ch));
+        }
+        if (needle.is_empty())
+            return start;
+
+        // memchr() is vectorized, so let it find the first character and check the rest ourselves.
+        auto const* characters = string.characters_without_null_termination();
+        for (size_t index = start; index + needle.size() <= string.length();) {
+            auto const* found = static_cast<char const*>(memchr(characters + index, needle.first(), string.length() - needle.size() + 1 - index));
+            if (!found)
+                return {};
+            auto offset = static_cast<size_t>(found - characters);
+            if (__builtin_memcmp(found + 1, needle.data() + 1, needle.size() - 1) == 0)
+                return offset;
+            index = offset + 1;
+        }
+        return {};
+    }
+
+    auto const& string = view.u16_view();
+    Vector<u16, 16> needle;
+    for (auto ch : prefix) {
+        if (ch > 0xffff || is_unicode_surrogate(ch))
+            break;
+        needle.append(static_cast<u16>(ch));
+    }
+    if (needle.is_empty())
+        return start;
+
+    auto const* code_units = string.data();
+    auto length = string.length_in_code_units();
+    for (size_t index = start; index + needle.size() <= length;) {
+        auto offset = AK::memmem_optional(code_units + index, (length - index) * sizeof(u16), needle.data(), needle.size() * sizeof(u16));
+        if (!offset.has_value())
+            return {};
+        // The match may be between two code units, in which case we keep looking from the second one.
+        if (*offset % sizeof(u16) == 0)
+            return index + *offset / sizeof(u16);
+        index += *offset / sizeof(u16) + 1;
+    }
+    return {};
+}
+
 template<typename Parser>
 RegexResult Matcher<Parser>::match(RegexStringView view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options) const
 {
@@ -200,6 +259,17 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         state.string_position_in_code_units = view_index;
         bool succeeded = false;
 
+        // OPTIMIZATION: Let the lazy DFA rule out the positions a match can't start at, so we only backtrack where it might succeed.
+        auto* lazy_dfa = m_lazy_dfa && LazyDFA::can_run_on(view, view_length) ? m_lazy_dfa.ptr() : nullptr;
+        bool should_look_ahead = continue_search;
+
+        // OPTIMIZATION: Every match starts with the required prefix, so we can search for that instead of trying every position.
+        auto& required_prefix = m_pattern->parser_result.required_prefix;
+        bool should_skip_to_required_prefix = continue_search
+            && !required_prefix.is_empty()
+            && !input.regex_options.has_flag_set(AllFlags::Insensitive)
+            && view_length == view.length_in_code_units();
+
         if (view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
             // Run the code until it tries to consume something.
             // This allows non-consuming code to run on empty strings, for instance
@@ -230,6 +300,13 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            if (should_skip_to_required_prefix) {
+                auto next_index = find_required_prefix(view, view_index, required_prefix);
+                if (!next_index.has_value())
+                    break;
+                view_index = *next_index;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -248,9 +325,24 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
+            if (lazy_dfa) {
+                auto& bytecode = m_pattern->parser_result.bytecode;
+                if (should_look_ahead) {
+                    if (!lazy_dfa->could_match_after(bytecode, input, view_index))
+                        break;
+                    should_look_ahead = false;
+                }
+                if (!lazy_dfa->could_match_at(bytecode, input, view_index)) {
+                    if (!continue_search)
+                        break;
+                    continue;
+                }
+            }
+
             auto success = execute(input, state, operations);
             if (success) {
                 succeeded = true;
+                should_look_ahead = continue_search;
 
                 if (input.regex_options.has_flag_set(AllFlags::MatchNotEndOfLine) && state.string_position == input.view.length()) {
                     if (!continue_search)
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexLazyDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
@@ -57,6 +58,8 @@ public:
         : m_pattern(pattern)
         , m_regex_options(regex_options.value_or({}))
     {
+        if (m_pattern->parser_result.execution_engine == ExecutionEngine::LazyDFA)
+            m_lazy_dfa = make<LazyDFA>();
     }
     ~Matcher() = default;
 
@@ -78,6 +81,7 @@ private:
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+    mutable OwnPtr<LazyDFA> m_lazy_dfa;
 };
 
 template<class Parser>
@@ -233,6 +237,7 @@ public:
 private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
+    void fill_required_prefix();
 };
 
 // free standing functions for match, search and has_match
@@ -9,6 +9,7 @@
 #include <AK/Stack.h>
 #include <LibRegex/Regex.h>
 #include <LibRegex/RegexBytecodeStreamOptimizer.h>
+#include <LibRegex/RegexLazyDFA.h>
 #if REGEX_DEBUG
 #    include <AK/ScopeGuard.h>
 #    include <AK/ScopeLogger.h>
@@ -28,6 +29,18 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(split_basic_blocks(parser_result.bytecode));
 
     parser_result.bytecode.flatten();
+
+    if (parser_result.error != Error::NoError)
+        return;
+
+    // Find out what every match starts with, so the matcher can skip ahead to where that appears.
+    fill_required_prefix();
+    dbgln_if(REGEX_DEBUG, "[optimizer] Every match starts with {} literal characters", parser_result.required_prefix.size());
+
+    // Without backreferences and lookarounds, a DFA can tell us where matches can start.
+    if (LazyDFA::can_execute(parser_result.bytecode))
+        parser_result.execution_engine = ExecutionEngine::LazyDFA;
+    dbgln_if(REGEX_DEBUG, "[optimizer] Selected the {} execution engine", parser_result.execution_engine == ExecutionEngine::LazyDFA ? "lazy DFA"sv : "backtracking"sv);
 }
 
 template<typename Parser>
@@ -622,6 +635,53 @@ void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&
     }
 }
 
+template<typename Parser>
+void Regex<Parser>::fill_required_prefix()
+{
+    // Collect the characters every match has to start with, i.e. the compares we run into before the first branch.
+    auto& bytecode = parser_result.bytecode;
+    auto& prefix = parser_result.required_prefix;
+    auto bytecode_size = bytecode.size();
+
+    // NOTE: The same parse result may be optimized more than once.
+    prefix.clear();
+
+    MatchState state;
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.arguments_count() != 1)
+                return;
+            auto offset = state.instruction_position + 3;
+            auto type = static_cast<CharacterCompareType>(bytecode.at(offset));
+            if (type == CharacterCompareType::Char) {
+                prefix.append(bytecode.at(offset + 1));
+            } else if (type == CharacterCompareType::String) {
+                auto length = bytecode.at(offset + 1);
+                for (size_t i = 0; i < length; ++i)
+                    prefix.append(bytecode.at(offset + 2 + i));
+            } else {
+                return;
+            }
+            break;
+        }
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::Checkpoint:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckBoundary:
+            break;
+        default:
+            return;
+        }
+        state.instruction_position += opcode.size();
+    }
+}
+
 void Optimizer::append_alternation(ByteCode& target, ByteCode&& left, ByteCode&& right)
 {
     Array<ByteCode, 2> alternatives;
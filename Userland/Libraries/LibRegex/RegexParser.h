@@ -44,6 +44,12 @@ template<>
 struct ParserTraits<ECMA262Parser> : public GenericParserTraits<ECMAScriptOptions> {
 };
 
+enum class ExecutionEngine : u8 {
+    Backtracking,
+    // Positions at which no match can start are ruled out by a lazy DFA before backtracking.
+    LazyDFA,
+};
+
 class Parser {
 public:
     struct Result {
@@ -55,6 +61,8 @@ public:
         Token error_token;
         Vector<FlyString> capture_groups;
         AllOptions options;
+        ExecutionEngine execution_engine { ExecutionEngine::Backtracking };
+        Vector<u32> required_prefix {};
     };
 
     explicit Parser(Lexer& lexer)
@@ -801,6 +801,36 @@ private:
     bool m_is_error_if_table_exists;
 };
 
+class CreateIndex : public Statement {
+public:
+    CreateIndex(String schema_name, String index_name, String table_name, NonnullRefPtrVector<OrderingTerm> indexed_columns, bool is_unique, bool is_error_if_index_exists)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_table_name(move(table_name))
+        , m_indexed_columns(move(indexed_columns))
+        , m_is_unique(is_unique)
+        , m_is_error_if_index_exists(is_error_if_index_exists)
+    {
+    }
+
+    String const& schema_name() const { return m_schema_name; }
+    String const& index_name() const { return m_index_name; }
+    String const& table_name() const { return m_table_name; }
+    NonnullRefPtrVector<OrderingTerm> const& indexed_columns() const { return m_indexed_columns; }
+    bool is_unique() const { return m_is_unique; }
+    bool is_error_if_index_exists() const { return m_is_error_if_index_exists; }
+
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    String m_schema_name;
+    String m_index_name;
+    String m_table_name;
+    NonnullRefPtrVector<OrderingTerm> m_indexed_columns;
+    bool m_is_unique;
+    bool m_is_error_if_index_exists;
+};
+
 class AlterTable : public Statement {
 public:
     String const& schema_name() const { return m_schema_name; }
@@ -1048,6 +1078,9 @@ public:
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
 
+    // Describes how execute() reads each of the tables in the FROM clause, one row per table.
+    ResultOr<ResultSet> explain(ExecutionContext&) const;
+
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
     bool m_select_all;
@@ -1059,6 +1092,20 @@ private:
     RefPtr<LimitClause> m_limit_clause;
 };
 
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Select> select_statement)
+        : m_select_statement(move(select_statement))
+    {
+    }
+
+    NonnullRefPtr<Select> const& select_statement() const { return m_select_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Select> m_select_statement;
+};
+
 class DescribeTable : public Statement {
 public:
     DescribeTable(NonnullRefPtr<QualifiedTableName> qualified_table_name)
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> CreateIndex::execute(ExecutionContext& context) const
+{
+    auto schema_name = m_schema_name.is_empty() ? String { "default"sv } : m_schema_name;
+
+    auto table_def = TRY(context.database->get_table(schema_name, m_table_name));
+    if (!table_def)
+        return Result { SQLCommand::Create, SQLErrorCode::TableDoesNotExist, String::formatted("{}.{}", schema_name, m_table_name) };
+
+    for (auto& index : table_def->indexes()) {
+        if (index.name() != m_index_name)
+            continue;
+        if (m_is_error_if_index_exists)
+            return Result { SQLCommand::Create, SQLErrorCode::IndexExists, m_index_name };
+        return ResultSet { SQLCommand::Create };
+    }
+
+    if (m_is_unique)
+        return Result { SQLCommand::Create, SQLErrorCode::NotYetImplemented, "Unique indexes are not yet implemented"sv };
+
+    Vector<ColumnDef const*> key_parts;
+    for (auto& indexed_column : m_indexed_columns) {
+        if (!is<ColumnNameExpression>(*indexed_column.expression()))
+            return Result { SQLCommand::Create, SQLErrorCode::NotYetImplemented, "Indexes on expressions are not yet implemented"sv };
+        if (indexed_column.order() == Order::Descending)
+            return Result { SQLCommand::Create, SQLErrorCode::NotYetImplemented, "Descending indexes are not yet implemented"sv };
+
+        auto const& column_name = static_cast<ColumnNameExpression const&>(*indexed_column.expression()).column_name();
+        ColumnDef const* key_part = nullptr;
+        for (auto& column : table_def->columns()) {
+            if (column.name() == column_name)
+                key_part = &column;
+        }
+        if (!key_part)
+            return Result { SQLCommand::Create, SQLErrorCode::ColumnDoesNotExist, column_name };
+        key_parts.append(key_part);
+    }
+
+    auto index_def = IndexDef::construct(table_def.ptr(), m_index_name, false);
+    for (auto* key_part : key_parts)
+        index_def->append_column(key_part->name(), key_part->type());
+
+    TRY(context.database->add_index(*index_def));
+    return ResultSet { SQLCommand::Create };
+}
+
+}
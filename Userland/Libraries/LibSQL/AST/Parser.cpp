@@ -41,6 +41,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         consume();
         if (match(TokenType::Schema))
             return parse_create_schema_statement();
+        else if (match(TokenType::Unique) || match(TokenType::Index))
+            return parse_create_index_statement();
         else
             return parse_create_table_statement();
     case TokenType::Alter:
@@ -49,6 +51,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         return parse_drop_table_statement();
     case TokenType::Describe:
         return parse_describe_table_statement();
+    case TokenType::Explain:
+        return parse_explain_statement();
     case TokenType::Insert:
         return parse_insert_statement({});
     case TokenType::Update:
@@ -58,7 +62,7 @@ NonnullRefPtr<Statement> Parser::parse_statement()
     case TokenType::Select:
         return parse_select_statement({});
     default:
-        expected("CREATE, ALTER, DROP, DESCRIBE, INSERT, UPDATE, DELETE, or SELECT"sv);
+        expected("CREATE, ALTER, DROP, DESCRIBE, EXPLAIN, INSERT, UPDATE, DELETE, or SELECT"sv);
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -129,6 +133,43 @@ NonnullRefPtr<CreateTable> Parser::parse_create_table_statement()
     return create_ast_node<CreateTable>(move(schema_name), move(table_name), move(column_definitions), is_temporary, is_error_if_table_exists);
 }
 
+NonnullRefPtr<CreateIndex> Parser::parse_create_index_statement()
+{
+    // https://sqlite.org/lang_createindex.html
+    bool is_unique = consume_if(TokenType::Unique);
+    consume(TokenType::Index);
+
+    bool is_error_if_index_exists = true;
+    if (consume_if(TokenType::If)) {
+        consume(TokenType::Not);
+        consume(TokenType::Exists);
+        is_error_if_index_exists = false;
+    }
+
+    String schema_name;
+    String index_name;
+    parse_schema_and_table_name(schema_name, index_name);
+
+    consume(TokenType::On);
+
+    // NOTE: SQLite only allows qualifying the index name with a schema, but qualifying the table name is accepted too.
+    String table_schema_name;
+    String table_name;
+    parse_schema_and_table_name(table_schema_name, table_name);
+    if (!table_schema_name.is_empty()) {
+        if (!schema_name.is_empty() && schema_name != table_schema_name)
+            syntax_error("An index must be in the same schema as its table");
+        schema_name = move(table_schema_name);
+    }
+
+    NonnullRefPtrVector<OrderingTerm> indexed_columns;
+    parse_comma_separated_list(true, [&]() { indexed_columns.append(parse_ordering_term()); });
+
+    // FIXME: Parse the WHERE clause of partial indexes.
+
+    return create_ast_node<CreateIndex>(move(schema_name), move(index_name), move(table_name), move(indexed_columns), is_unique, is_error_if_index_exists);
+}
+
 NonnullRefPtr<AlterTable> Parser::parse_alter_table_statement()
 {
     // https://sqlite.org/lang_altertable.html
@@ -194,6 +235,18 @@ NonnullRefPtr<DescribeTable> Parser::parse_describe_table_statement()
     return create_ast_node<DescribeTable>(move(table_name));
 }
 
+NonnullRefPtr<Explain> Parser::parse_explain_statement()
+{
+    // https://sqlite.org/lang_explain.html
+    consume(TokenType::Explain);
+
+    // NOTE: Only the query plan is shown, so "EXPLAIN" and "EXPLAIN QUERY PLAN" are the same thing.
+    if (consume_if(TokenType::Query))
+        consume(TokenType::Plan);
+
+    return create_ast_node<Explain>(parse_select_statement({}));
+}
+
 NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_insert.html
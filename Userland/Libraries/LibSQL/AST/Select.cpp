@@ -5,28 +5,490 @@
  */
 
 #include <AK/NumericLimits.h>
+#include <AK/StringBuilder.h>
+#include <AK/TypeCasts.h>
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
+#include <math.h>
 
 namespace SQL::AST {
 
-ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
-{
-    NonnullRefPtrVector<ResultColumn> columns;
-
-    auto const& result_column_list = this->result_column_list();
-    VERIFY(!result_column_list.is_empty());
+// How the rows of one of the tables in the FROM clause are read: either all of them, or only
+// those whose value in the first key part of an index falls within a range.
+struct TableScan {
+    NonnullRefPtr<TableDef> table;
+    RefPtr<IndexDef> index;
+    KeyRange range;
+};
 
-    for (auto& table_descriptor : table_or_subquery_list()) {
+static ResultOr<Vector<NonnullRefPtr<TableDef>>> tables_in_from_clause(ExecutionContext& context, NonnullRefPtrVector<TableOrSubquery> const& table_or_subquery_list)
+{
+    Vector<NonnullRefPtr<TableDef>> tables;
+    for (auto& table_descriptor : table_or_subquery_list) {
         if (!table_descriptor.is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
 
         auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
         if (!table_def)
             return Result { SQLCommand::Select, SQLErrorCode::TableDoesNotExist, table_descriptor.table_name() };
+        tables.append(table_def.release_nonnull());
+    }
+    return tables;
+}
+
+static void collect_conjuncts(Expression const& expression, Vector<Expression const&>& conjuncts)
+{
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(expression);
+        if (binary_expression.type() == BinaryOperator::And) {
+            collect_conjuncts(binary_expression.lhs(), conjuncts);
+            collect_conjuncts(binary_expression.rhs(), conjuncts);
+            return;
+        }
+    }
+    if (is<ChainedExpression>(expression)) {
+        auto const& chained_expression = static_cast<ChainedExpression const&>(expression);
+        if (chained_expression.expressions().size() == 1) {
+            collect_conjuncts(chained_expression.expressions().first(), conjuncts);
+            return;
+        }
+    }
+    conjuncts.append(expression);
+}
+
+static bool is_column_of_table(Expression const& expression, String const& column_name, TableDef const& table, Vector<NonnullRefPtr<TableDef>> const& tables)
+{
+    if (!is<ColumnNameExpression>(expression))
+        return false;
+    auto const& column_expression = static_cast<ColumnNameExpression const&>(expression);
+    if (column_expression.column_name() != column_name)
+        return false;
+    if (!column_expression.table_name().is_empty())
+        return column_expression.table_name() == table.name();
+
+    // An unqualified column name only refers to this table if no other table has a column of that name.
+    for (auto& other_table : tables) {
+        if (other_table.ptr() == &table)
+            continue;
+        for (auto& column : other_table->columns()) {
+            if (column.name() == column_name)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Returns the value of a literal as it compares to the values in a column of the given type, if it
+// compares the same way no matter which side of the comparison operator the literal is on.
+static Optional<Value> literal_value_for_column(Expression const& expression, SQLType column_type)
+{
+    if (column_type == SQLType::Text) {
+        if (!is<StringLiteral>(expression))
+            return {};
+        return Value(static_cast<StringLiteral const&>(expression).value());
+    }
+
+    if (column_type != SQLType::Integer && column_type != SQLType::Float)
+        return {};
+
+    double sign = 1;
+    auto const* literal = &expression;
+    if (is<UnaryOperatorExpression>(*literal)) {
+        auto const& unary_expression = static_cast<UnaryOperatorExpression const&>(*literal);
+        if (unary_expression.type() != UnaryOperator::Minus && unary_expression.type() != UnaryOperator::Plus)
+            return {};
+        if (unary_expression.type() == UnaryOperator::Minus)
+            sign = -1;
+        literal = unary_expression.expression().ptr();
+    }
+    if (!is<NumericLiteral>(*literal))
+        return {};
+
+    auto value = sign * static_cast<NumericLiteral const&>(*literal).value();
+    if (column_type == SQLType::Float)
+        return Value(value);
+
+    // Integer columns convert whatever they are compared against to an integer, so only integral
+    // values compare the same way as they would against the column's values converted to floats.
+    if (value != static_cast<double>(static_cast<int>(value)))
+        return {};
+    return Value(static_cast<int>(value));
+}
+
+static void narrow_lower_bound(KeyRange& range, Value const& value, bool is_inclusive)
+{
+    if (range.lower_bound.has_value()) {
+        auto comparison = value.compare(range.lower_bound.value());
+        if (comparison < 0 || (comparison == 0 && (is_inclusive || !range.lower_bound_is_inclusive)))
+            return;
+    }
+    range.lower_bound = value;
+    range.lower_bound_is_inclusive = is_inclusive;
+}
+
+static void narrow_upper_bound(KeyRange& range, Value const& value, bool is_inclusive)
+{
+    if (range.upper_bound.has_value()) {
+        auto comparison = value.compare(range.upper_bound.value());
+        if (comparison > 0 || (comparison == 0 && (is_inclusive || !range.upper_bound_is_inclusive)))
+            return;
+    }
+    range.upper_bound = value;
+    range.upper_bound_is_inclusive = is_inclusive;
+}
+
+// Narrows the range to the rows for which a term of the WHERE clause can be true, if the term
+// compares the given column of the table against a literal. Returns whether it did.
+static bool narrow_range(KeyRange& range, Expression const& term, ColumnDef const& column, TableDef const& table, Vector<NonnullRefPtr<TableDef>> const& tables)
+{
+    if (!is<BinaryOperatorExpression>(term))
+        return false;
+    auto const& comparison = static_cast<BinaryOperatorExpression const&>(term);
+
+    auto type = comparison.type();
+    Optional<Value> value;
+    if (is_column_of_table(comparison.lhs(), column.name(), table, tables)) {
+        value = literal_value_for_column(comparison.rhs(), column.type());
+    } else if (is_column_of_table(comparison.rhs(), column.name(), table, tables)) {
+        // NULLs convert to text when compared against a string, so only numeric comparisons can be flipped.
+        if (column.type() == SQLType::Text)
+            return false;
+        value = literal_value_for_column(comparison.lhs(), column.type());
+        if (type == BinaryOperator::LessThan)
+            type = BinaryOperator::GreaterThan;
+        else if (type == BinaryOperator::LessThanEquals)
+            type = BinaryOperator::GreaterThanEquals;
+        else if (type == BinaryOperator::GreaterThan)
+            type = BinaryOperator::LessThan;
+        else if (type == BinaryOperator::GreaterThanEquals)
+            type = BinaryOperator::LessThanEquals;
+    }
+    if (!value.has_value())
+        return false;
+
+    switch (type) {
+    case BinaryOperator::Equals:
+        narrow_lower_bound(range, value.value(), true);
+        narrow_upper_bound(range, value.value(), true);
+        return true;
+    case BinaryOperator::LessThan:
+        narrow_upper_bound(range, value.value(), false);
+        return true;
+    case BinaryOperator::LessThanEquals:
+        narrow_upper_bound(range, value.value(), true);
+        return true;
+    case BinaryOperator::GreaterThan:
+        narrow_lower_bound(range, value.value(), false);
+        return true;
+    case BinaryOperator::GreaterThanEquals:
+        narrow_lower_bound(range, value.value(), true);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Picks the index whose first key part is restricted the most by the WHERE clause: an equality
+// beats a range bounded on both ends, which beats a range bounded on one end. The WHERE clause is
+// still evaluated for every row that is read, so the range only has to contain all matching rows.
+static TableScan plan_table_scan(TableDef& table, Vector<NonnullRefPtr<TableDef>> const& tables, RefPtr<Expression> const& where_clause)
+{
+    TableScan scan { table, nullptr, {} };
+    if (!where_clause)
+        return scan;
+
+    Vector<Expression const&> conjuncts;
+    collect_conjuncts(*where_clause, conjuncts);
+
+    auto score = [](KeyRange const& range) {
+        if (range.lower_bound.has_value() && range.upper_bound.has_value())
+            return range.lower_bound->compare(range.upper_bound.value()) == 0 ? 3 : 2;
+        return range.lower_bound.has_value() || range.upper_bound.has_value() ? 1 : 0;
+    };
+
+    auto best_score = 0;
+    for (auto& index : table.indexes()) {
+        auto const& first_key_part = index.key_definition().first();
+        KeyRange range;
+        for (auto& conjunct : conjuncts)
+            narrow_range(range, conjunct, first_key_part, table, tables);
+
+        if (auto index_score = score(range); index_score > best_score) {
+            best_score = index_score;
+            scan.index = index;
+            scan.range = move(range);
+        }
+    }
+    return scan;
+}
+
+static ErrorOr<Vector<Row>> read_rows(Database& database, TableScan const& scan)
+{
+    if (scan.index)
+        return database.select_range(*scan.table, *scan.index, scan.range);
+    return database.select_all(*scan.table);
+}
+
+static String describe_table_scan(TableScan const& scan)
+{
+    StringBuilder builder;
+    auto table_name = String::formatted("{}.{}", scan.table->parent()->name(), scan.table->name());
+    if (!scan.index) {
+        builder.appendff("SCAN TABLE {}", table_name);
+        return builder.to_string();
+    }
+
+    auto const& range = scan.range;
+    auto const& column_name = scan.index->key_definition().first().name();
+    auto format_value = [](Value const& value) {
+        if (value.type() == SQLType::Text)
+            return String::formatted("'{}'", value.to_string());
+        return value.to_string();
+    };
+
+    builder.appendff("SEARCH TABLE {} USING INDEX {} (", table_name, scan.index->name());
+    if (range.lower_bound.has_value() && range.upper_bound.has_value() && range.lower_bound->compare(range.upper_bound.value()) == 0) {
+        builder.appendff("{} = {}", column_name, format_value(range.lower_bound.value()));
+    } else {
+        if (range.lower_bound.has_value())
+            builder.appendff("{} {} {}", column_name, range.lower_bound_is_inclusive ? ">=" : ">", format_value(range.lower_bound.value()));
+        if (range.lower_bound.has_value() && range.upper_bound.has_value())
+            builder.append(" AND "sv);
+        if (range.upper_bound.has_value())
+            builder.appendff("{} {} {}", column_name, range.upper_bound_is_inclusive ? "<=" : "<", format_value(range.upper_bound.value()));
+    }
+    builder.append(')');
+    return builder.to_string();
+}
+
+// The WHERE clause is evaluated on this many rows at a time, if all of its terms compare a column to a constant.
+static constexpr size_t BATCH_SIZE = 1024;
 
+// A term of the WHERE clause that compares a column of the rows to a constant. Instead of walking
+// the expression tree for every row, it is evaluated over a whole batch of rows at once: the values
+// of the column are gathered into a buffer of their type, and then compared to the constant in a
+// tight loop. The outcome is the same as that of Value::compare().
+struct ColumnFilter {
+    size_t column_index { 0 };
+    SQLType column_type { SQLType::Null };
+    BinaryOperator type { BinaryOperator::Equals };
+    Value constant { SQLType::Null };
+    bool constant_is_lhs { false };
+};
+
+static bool is_comparison(BinaryOperator type)
+{
+    switch (type) {
+    case BinaryOperator::Equals:
+    case BinaryOperator::NotEquals:
+    case BinaryOperator::LessThan:
+    case BinaryOperator::LessThanEquals:
+    case BinaryOperator::GreaterThan:
+    case BinaryOperator::GreaterThanEquals:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool is_constant(Expression const& expression)
+{
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<NullLiteral>(expression))
+        return true;
+    if (!is<UnaryOperatorExpression>(expression))
+        return false;
+    auto const& unary_expression = static_cast<UnaryOperatorExpression const&>(expression);
+    return (unary_expression.type() == UnaryOperator::Minus || unary_expression.type() == UnaryOperator::Plus) && is<NumericLiteral>(*unary_expression.expression());
+}
+
+// Finds the column the same way ColumnNameExpression::evaluate() does. Columns that don't exist or
+// are ambiguous are left to it, so that it reports the error.
+static Optional<size_t> column_index_in_row(ColumnNameExpression const& column, TupleDescriptor const& descriptor)
+{
+    Optional<size_t> index_in_row;
+    for (auto ix = 0u; ix < descriptor.size(); ix++) {
+        auto& column_descriptor = descriptor[ix];
+        if (!column.table_name().is_empty() && column_descriptor.table != column.table_name())
+            continue;
+        if (column_descriptor.name == column.column_name()) {
+            if (index_in_row.has_value())
+                return {};
+            index_in_row = ix;
+        }
+    }
+    return index_in_row;
+}
+
+// Returns the filters the WHERE clause consists of, or nothing if it has terms that aren't a comparison
+// between a column and a constant.
+static ResultOr<Optional<Vector<ColumnFilter>>> column_filters_for_where_clause(ExecutionContext& context, Expression const& where_clause, TupleDescriptor const& descriptor)
+{
+    Vector<Expression const&> conjuncts;
+    collect_conjuncts(where_clause, conjuncts);
+
+    Vector<ColumnFilter> filters;
+    for (auto& conjunct : conjuncts) {
+        if (!is<BinaryOperatorExpression>(conjunct))
+            return Optional<Vector<ColumnFilter>> {};
+        auto const& comparison = static_cast<BinaryOperatorExpression const&>(conjunct);
+        if (!is_comparison(comparison.type()))
+            return Optional<Vector<ColumnFilter>> {};
+
+        Expression const* column;
+        Expression const* constant;
+        auto constant_is_lhs = false;
+        if (is<ColumnNameExpression>(*comparison.lhs()) && is_constant(*comparison.rhs())) {
+            column = comparison.lhs().ptr();
+            constant = comparison.rhs().ptr();
+        } else if (is<ColumnNameExpression>(*comparison.rhs()) && is_constant(*comparison.lhs())) {
+            column = comparison.rhs().ptr();
+            constant = comparison.lhs().ptr();
+            constant_is_lhs = true;
+        } else {
+            return Optional<Vector<ColumnFilter>> {};
+        }
+
+        auto column_index = column_index_in_row(static_cast<ColumnNameExpression const&>(*column), descriptor);
+        if (!column_index.has_value())
+            return Optional<Vector<ColumnFilter>> {};
+        // NOTE: Assigning to a Value converts to its type, so the constant has to be constructed in place.
+        filters.append(ColumnFilter { column_index.value(), descriptor[column_index.value()].type, comparison.type(), TRY(constant->evaluate(context)), constant_is_lhs });
+    }
+    return filters;
+}
+
+static int compare_floats(double lhs, double rhs)
+{
+    auto diff = lhs - rhs;
+    if (fabs(diff) < NumericLimits<double>::epsilon())
+        return 0;
+    return diff < 0 ? -1 : 1;
+}
+
+// Compares the value of the filter's column in each selected row of the batch to the filter's constant.
+static void compare_column(ColumnFilter const& filter, Span<Tuple> batch, Span<u16 const> selection, Span<int> comparisons)
+{
+    auto const& constant = filter.constant;
+
+    // The left hand side decides how the values are compared, see IntegerImpl::compare() and friends.
+    enum class Kind {
+        Integer,
+        Float,
+        Text,
+        Other,
+    };
+    auto kind = Kind::Other;
+    auto lhs_type = filter.constant_is_lhs ? constant.type() : filter.column_type;
+    if (constant.is_null())
+        kind = Kind::Other;
+    else if (lhs_type == SQLType::Integer && !filter.constant_is_lhs)
+        kind = Kind::Integer;
+    else if (lhs_type == SQLType::Float && (filter.column_type == SQLType::Integer || filter.column_type == SQLType::Float))
+        kind = Kind::Float;
+    else if (lhs_type == SQLType::Text && filter.column_type == SQLType::Text)
+        kind = Kind::Text;
+
+    // NULLs, and values that don't have the type of their column, are compared one by one.
+    Array<bool, BATCH_SIZE> is_typed;
+    auto gather = [&](auto&& store) {
+        for (auto ix = 0u; ix < selection.size(); ix++) {
+            auto const& value = batch[selection[ix]][filter.column_index];
+            is_typed[ix] = kind != Kind::Other && !value.is_null() && value.type() == filter.column_type;
+            if (is_typed[ix])
+                store(ix, value);
+            else
+                comparisons[ix] = filter.constant_is_lhs ? constant.compare(value) : value.compare(constant);
+        }
+    };
+
+    switch (kind) {
+    case Kind::Integer: {
+        Array<int, BATCH_SIZE> values;
+        gather([&](auto ix, Value const& value) { values[ix] = value.to_int().value(); });
+        auto other = constant.to_int();
+        for (auto ix = 0u; ix < selection.size(); ix++) {
+            if (is_typed[ix])
+                comparisons[ix] = other.has_value() ? (values[ix] > other.value()) - (values[ix] < other.value()) : 1;
+        }
+        return;
+    }
+    case Kind::Float: {
+        Array<double, BATCH_SIZE> values;
+        gather([&](auto ix, Value const& value) { values[ix] = value.to_double().value(); });
+        auto other = constant.to_double();
+        for (auto ix = 0u; ix < selection.size(); ix++) {
+            if (!is_typed[ix])
+                continue;
+            if (!other.has_value())
+                comparisons[ix] = 1;
+            else
+                comparisons[ix] = filter.constant_is_lhs ? compare_floats(other.value(), values[ix]) : compare_floats(values[ix], other.value());
+        }
+        return;
+    }
+    case Kind::Text: {
+        Array<String, BATCH_SIZE> values;
+        gather([&](auto ix, Value const& value) { values[ix] = value.to_string(); });
+        auto other = constant.to_string();
+        for (auto ix = 0u; ix < selection.size(); ix++) {
+            if (!is_typed[ix])
+                continue;
+            auto const& lhs = filter.constant_is_lhs ? other : values[ix];
+            auto const& rhs = filter.constant_is_lhs ? values[ix] : other;
+            comparisons[ix] = lhs == rhs ? 0 : (lhs < rhs ? -1 : 1);
+        }
+        return;
+    }
+    case Kind::Other:
+        gather([](auto, Value const&) {});
+        return;
+    }
+}
+
+// Removes the rows that don't pass the filter from the selection.
+static void apply_column_filter(ColumnFilter const& filter, Span<Tuple> batch, Vector<u16, BATCH_SIZE>& selection)
+{
+    Array<int, BATCH_SIZE> comparisons;
+    compare_column(filter, batch, selection.span(), comparisons.span());
+
+    auto passes = [&](int comparison) {
+        switch (filter.type) {
+        case BinaryOperator::Equals:
+            return comparison == 0;
+        case BinaryOperator::NotEquals:
+            return comparison != 0;
+        case BinaryOperator::LessThan:
+            return comparison < 0;
+        case BinaryOperator::LessThanEquals:
+            return comparison <= 0;
+        case BinaryOperator::GreaterThan:
+            return comparison > 0;
+        case BinaryOperator::GreaterThanEquals:
+            return comparison >= 0;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    };
+
+    size_t selected = 0;
+    for (auto ix = 0u; ix < selection.size(); ix++) {
+        if (passes(comparisons[ix]))
+            selection[selected++] = selection[ix];
+    }
+    selection.shrink(selected);
+}
+
+ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    NonnullRefPtrVector<ResultColumn> columns;
+
+    auto const& result_column_list = this->result_column_list();
+    VERIFY(!result_column_list.is_empty());
+
+    auto tables = TRY(tables_in_from_clause(context, table_or_subquery_list()));
+    for (auto& table_def : tables) {
         if (result_column_list.size() == 1 && result_column_list[0].type() == ResultType::All) {
             for (auto& col : table_def->columns()) {
                 columns.append(
@@ -57,20 +519,16 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     tuple.append(Value(SQLType::Boolean, true));
     rows.append(tuple);
 
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor.is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+    for (auto& table_def : tables) {
         if (table_def->num_columns() == 0)
             continue;
 
         auto old_descriptor_size = descriptor->size();
         descriptor->extend(table_def->to_tuple_descriptor());
 
+        auto table_rows = TRY(read_rows(*context.database, plan_table_scan(*table_def, tables, where_clause())));
         while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
             auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
 
             for (auto& table_row : table_rows) {
                 auto new_row = cartesian_row;
@@ -88,15 +546,8 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     }
     Tuple sort_key(sort_descriptor);
 
-    for (auto& row : rows) {
+    auto insert_result_row = [&](Tuple& row) -> ResultOr<void> {
         context.current_row = &row;
-
-        if (where_clause()) {
-            auto where_result = TRY(where_clause()->evaluate(context));
-            if (!where_result)
-                continue;
-        }
-
         tuple.clear();
 
         for (auto& col : columns) {
@@ -113,6 +564,39 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
 
         result.insert_row(tuple, sort_key);
+        return {};
+    };
+
+    Optional<Vector<ColumnFilter>> column_filters;
+    if (where_clause())
+        column_filters = TRY(column_filters_for_where_clause(context, *where_clause(), *descriptor));
+
+    if (column_filters.has_value()) {
+        for (size_t batch_start = 0; batch_start < rows.size(); batch_start += BATCH_SIZE) {
+            auto batch = rows.span().slice(batch_start, min(BATCH_SIZE, rows.size() - batch_start));
+
+            Vector<u16, BATCH_SIZE> selection;
+            for (u16 ix = 0; ix < batch.size(); ix++)
+                selection.unchecked_append(ix);
+            for (auto& filter : column_filters.value()) {
+                if (selection.is_empty())
+                    break;
+                apply_column_filter(filter, batch, selection);
+            }
+
+            for (auto ix : selection)
+                TRY(insert_result_row(batch[ix]));
+        }
+    } else {
+        for (auto& row : rows) {
+            if (where_clause()) {
+                context.current_row = &row;
+                auto where_result = TRY(where_clause()->evaluate(context));
+                if (!where_result)
+                    continue;
+            }
+            TRY(insert_result_row(row));
+        }
     }
 
     if (m_limit_clause != nullptr) {
@@ -145,4 +629,28 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     return result;
 }
 
+ResultOr<ResultSet> Select::explain(ExecutionContext& context) const
+{
+    auto tables = TRY(tables_in_from_clause(context, table_or_subquery_list()));
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->append({ .name = "plan" });
+
+    ResultSet result { SQLCommand::Explain };
+    TRY(result.try_ensure_capacity(tables.size()));
+
+    for (auto& table_def : tables) {
+        Tuple tuple(descriptor);
+        tuple[0] = describe_table_scan(plan_table_scan(*table_def, tables, where_clause()));
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    return m_select_statement->explain(context);
+}
+
 }
@@ -46,6 +46,8 @@ void BTree::initialize_root()
     } else {
         set_pointer(new_record_pointer());
         m_root = make<TreeNode>(*this, nullptr, pointer());
+        // Write the empty root right away; the heap can't be flushed with a gap where its block should be.
+        serializer().serialize_and_write(*m_root.ptr(), m_root->pointer());
         if (on_new_root)
             on_new_root();
     }
@@ -87,20 +89,108 @@ Optional<u32> BTree::get(Key& key)
 }
 
 BTreeIterator BTree::find(Key const& key)
+{
+    auto iterator = lower_bound(key);
+    if (iterator.is_end() || (*iterator).match(key) != 0)
+        return end();
+    return iterator;
+}
+
+BTreeIterator BTree::lower_bound(Key const& key)
 {
     if (!m_root)
         initialize_root();
     VERIFY(m_root);
-    for (auto node = m_root->node_for(key); node; node = node->up()) {
-        for (auto ix = 0u; ix < node->size(); ix++) {
-            auto match = (*node)[ix].match(key);
-            if (match == 0)
-                return BTreeIterator(node, (int)ix);
-            else if (match > 0)
-                return end();
+
+    // Keys equal to a key in a node can be in the subtrees on either side of it, so this descends left
+    // of the first key in the node that is not less than the one searched for. That key is the answer
+    // if nothing in the subtree is.
+    auto result = end();
+    for (auto* node = m_root.ptr(); node;) {
+        auto ix = 0u;
+        while (ix < node->size() && (*node)[ix].match(key) < 0)
+            ++ix;
+        if (ix < node->size())
+            result = BTreeIterator(node, (int)ix);
+        if (node->is_leaf())
+            break;
+        node = node->down_node(ix);
+    }
+    return result;
+}
+
+// Nodes are filled up to this length when bulk loading, which leaves some room for keys inserted later.
+static constexpr size_t BULK_LOAD_NODE_LENGTH = BLOCKSIZE * 9 / 10;
+
+bool BTree::bulk_load(Vector<Key> const& keys)
+{
+    VERIFY(!m_root && !pointer());
+    if (keys.is_empty())
+        return true;
+    if (!duplicates_allowed()) {
+        for (auto ix = 1u; ix < keys.size(); ix++) {
+            if (keys[ix - 1] == keys[ix])
+                return false;
         }
     }
-    return end();
+
+    // The levels of the tree are built from the leaves up. Between every two nodes of a level, one key
+    // moves up to the level above, with those two nodes as its children.
+    Vector<Key> level_keys = keys;
+    Vector<u32> level_children;
+    OwnPtr<TreeNode> node;
+    while (true) {
+        Vector<ByteBuffer> level_key_values;
+        for (auto& key : level_keys)
+            level_key_values.append(TreeNode::key_values(key));
+
+        Vector<Key> separators;
+        Vector<u32> nodes;
+        for (size_t start = 0; start < level_keys.size();) {
+            auto end = start;
+            auto length = 2 * sizeof(u32);
+            while (end < level_keys.size()) {
+                auto previous_key_values = end > start ? level_key_values[end - 1].bytes() : ReadonlyBytes {};
+                auto entry_length = TreeNode::entry_length(level_key_values[end], previous_key_values);
+                if (end > start && length + entry_length > BULK_LOAD_NODE_LENGTH)
+                    break;
+                length += entry_length;
+                ++end;
+            }
+            // The key after the node moves up, and needs a node on its right.
+            if (end == level_keys.size() - 1) {
+                if (end - start > 1)
+                    --end;
+                else
+                    ++end;
+            }
+
+            node = make<TreeNode>(*this, new_record_pointer());
+            node->m_is_leaf = level_children.is_empty();
+            for (auto ix = start; ix <= end; ix++) {
+                if (ix < end)
+                    node->m_entries.append(level_keys[ix]);
+                node->m_down.empend(node.ptr(), node->m_is_leaf ? 0u : level_children[ix]);
+            }
+            serializer().serialize_and_write(*node, node->pointer());
+            nodes.append(node->pointer());
+
+            if (end < level_keys.size())
+                separators.append(level_keys[end]);
+            start = end + 1;
+        }
+
+        if (nodes.size() == 1)
+            break;
+        level_keys = move(separators);
+        level_children = move(nodes);
+    }
+
+    set_pointer(node->pointer());
+    m_root = move(node);
+    if (on_new_root)
+        on_new_root();
+    return true;
 }
 
 void BTree::list_tree()
@@ -77,6 +77,9 @@ public:
 
 private:
     TreeNode(BTree&, TreeNode*, DownPointer&, u32 = 0);
+    static ByteBuffer key_values(Key const&);
+    static size_t entry_length(ReadonlyBytes key_values, ReadonlyBytes previous_key_values);
+    Key deserialize_key(Serializer&, ByteBuffer& previous_key_values) const;
     void dump_if(int, String&& = "");
     bool insert_in_leaf(Key const&);
     void just_insert(Key const&, TreeNode* = nullptr);
@@ -104,10 +107,16 @@ public:
     bool update_key_pointer(Key const&);
     Optional<u32> get(Key&);
     BTreeIterator find(Key const& key);
+    // Returns the first entry that is not less than the key. Parts of the key that are null match any value.
+    BTreeIterator lower_bound(Key const& key);
     BTreeIterator begin();
     static BTreeIterator end();
     void list_tree();
 
+    // Builds the tree bottom-up from keys sorted in ascending order, writing every node once. The tree
+    // has to be empty. Returns false if the keys contain duplicates and the tree doesn't allow them.
+    bool bulk_load(Vector<Key> const& keys);
+
     Function<void(void)> on_new_root;
 
 private:
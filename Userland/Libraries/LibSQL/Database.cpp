@@ -6,8 +6,10 @@
  */
 
 #include <AK/Format.h>
+#include <AK/QuickSort.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
+#include <AK/TypeCasts.h>
 
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
@@ -42,6 +44,11 @@ ErrorOr<void> Database::open()
         m_heap->set_table_columns_root(m_table_columns->root());
     };
 
+    m_table_indexes = BTree::construct(m_serializer, IndexDef::index_def()->to_tuple_descriptor(), m_heap->table_indexes_root());
+    m_table_indexes->on_new_root = [&]() {
+        m_heap->set_table_indexes_root(m_table_indexes->root());
+    };
+
     m_open = true;
     auto default_schema = TRY(get_schema("default"));
     if (!default_schema) {
@@ -171,9 +178,68 @@ ErrorOr<RefPtr<TableDef>> Database::get_table(String const& schema, String const
          column_iterator++) {
         ret->append_column(*column_iterator);
     }
+    auto index_key = IndexDef::make_key(ret);
+    for (auto index_iterator = m_table_indexes->find(index_key);
+         !index_iterator.is_end() && ((*index_iterator)["table_hash"].to_u32().value() == hash);
+         index_iterator++) {
+        auto index_def = IndexDef::construct(ret.ptr(), (*index_iterator)["index_name"].to_string(), (*index_iterator)["unique"].to_int().value() != 0, (*index_iterator).pointer());
+        auto index_hash = index_def->hash();
+        for (auto key_part_iterator = m_table_columns->find(ColumnDef::make_key(index_def));
+             !key_part_iterator.is_end() && ((*key_part_iterator)["table_hash"].to_u32().value() == index_hash);
+             key_part_iterator++) {
+            index_def->append_column((*key_part_iterator)["column_name"].to_string(), (SQLType)((int)(*key_part_iterator)["column_type"]));
+        }
+        ret->append_index(index_def);
+    }
     return RefPtr<TableDef>(ret);
 }
 
+ErrorOr<void> Database::add_index(IndexDef& index)
+{
+    VERIFY(is_open());
+    auto& table = *verify_cast<TableDef>(index.parent());
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    if (!m_table_indexes->insert(index.key())) {
+        warnln("Duplicate index name '{}' on table '{}'.'{}'"sv, index.name(), table.parent()->name(), table.name());
+        return Error::from_string_literal("Duplicate index name");
+    }
+    for (auto& key_part : index.key_definition()) {
+        VERIFY(m_table_columns->insert(key_part.key()));
+    }
+    table.append_index(index);
+
+    Vector<Key> keys;
+    for (auto& row : TRY(select_all(table)))
+        keys.append(index_key_for_row(index, row));
+    quick_sort(keys);
+    VERIFY(index_tree(index)->bulk_load(keys));
+    return {};
+}
+
+NonnullRefPtr<BTree> Database::index_tree(IndexDef const& index)
+{
+    auto hash = index.hash();
+    if (auto tree = m_index_trees.get(hash); tree.has_value())
+        return *tree.value();
+
+    auto tree = BTree::construct(m_serializer, index.to_tuple_descriptor(), index.unique(), index.pointer());
+    tree->on_new_root = [this, &btree = *tree, key = index.key()]() mutable {
+        key.set_pointer(btree.root());
+        VERIFY(m_table_indexes->update_key_pointer(key));
+    };
+    m_index_trees.set(hash, tree);
+    return tree;
+}
+
+Key Database::index_key_for_row(IndexDef const& index, Row const& row)
+{
+    Key key(index.to_tuple_descriptor());
+    for (auto& key_part : index.key_definition())
+        key[key_part.name()] = row[key_part.name()];
+    key.set_pointer(row.pointer());
+    return key;
+}
+
 ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -184,6 +250,37 @@ ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
     return ret;
 }
 
+ErrorOr<Vector<Row>> Database::select_range(TableDef const& table, IndexDef const& index, KeyRange const& range)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    auto tree = index_tree(index);
+    auto const& first_key_part = index.key_definition().first();
+
+    // A key with only the first key part set sorts before every entry with the same value in that
+    // key part, so looking it up lands on the first entry of the range.
+    auto iterator = tree->begin();
+    if (range.lower_bound.has_value()) {
+        Key lower_bound(index.to_tuple_descriptor());
+        lower_bound[first_key_part.name()] = range.lower_bound.value();
+        iterator = tree->lower_bound(lower_bound);
+    }
+
+    Vector<Row> ret;
+    for (; !iterator.is_end(); iterator++) {
+        auto const& value = (*iterator)[first_key_part.name()];
+        if (range.lower_bound.has_value() && !range.lower_bound_is_inclusive && value.compare(range.lower_bound.value()) == 0)
+            continue;
+        if (range.upper_bound.has_value()) {
+            auto comparison = value.compare(range.upper_bound.value());
+            if (comparison > 0 || (comparison == 0 && !range.upper_bound_is_inclusive))
+                break;
+        }
+        auto pointer = (*iterator).pointer();
+        ret.append(m_serializer.deserialize_block<Row>(pointer, table, pointer));
+    }
+    return ret;
+}
+
 ErrorOr<Vector<Row>> Database::match(TableDef const& table, Key const& key)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -209,12 +306,13 @@ ErrorOr<void> Database::insert(Row& row)
     row.next_pointer(row.table()->pointer());
     TRY(update(row));
 
-    // TODO update indexes defined on table.
-
     auto table_key = row.table()->key();
     table_key.set_pointer(row.pointer());
     VERIFY(m_tables->update_key_pointer(table_key));
     row.table()->set_pointer(row.pointer());
+
+    for (auto& index : row.table()->indexes())
+        VERIFY(index_tree(index)->insert(index_key_for_row(index, row)));
     return {};
 }
 
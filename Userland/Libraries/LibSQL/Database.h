@@ -16,6 +16,17 @@
 
 namespace SQL {
 
+/**
+ * A range of values in the first key part of an index. A bound that is not
+ * set leaves that end of the range open.
+ */
+struct KeyRange {
+    Optional<Value> lower_bound;
+    bool lower_bound_is_inclusive { true };
+    Optional<Value> upper_bound;
+    bool upper_bound_is_inclusive { true };
+};
+
 /**
  * A Database object logically connects a Heap with the SQL data we want
  * to store in it. It has BTree pointers for B-Trees holding the definitions
@@ -39,7 +50,10 @@ public:
     static Key get_table_key(String const&, String const&);
     ErrorOr<RefPtr<TableDef>> get_table(String const&, String const&);
 
+    ErrorOr<void> add_index(IndexDef& index);
+
     ErrorOr<Vector<Row>> select_all(TableDef const&);
+    ErrorOr<Vector<Row>> select_range(TableDef const&, IndexDef const&, KeyRange const&);
     ErrorOr<Vector<Row>> match(TableDef const&, Key const&);
     ErrorOr<void> insert(Row&);
     ErrorOr<void> update(Row&);
@@ -47,15 +61,20 @@ public:
 private:
     explicit Database(String);
 
+    NonnullRefPtr<BTree> index_tree(IndexDef const&);
+    static Key index_key_for_row(IndexDef const&, Row const&);
+
     bool m_open { false };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
     RefPtr<BTree> m_tables;
     RefPtr<BTree> m_table_columns;
+    RefPtr<BTree> m_table_indexes;
 
     HashMap<u32, RefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, RefPtr<TableDef>> m_table_cache;
+    HashMap<u32, NonnullRefPtr<BTree>> m_index_trees;
 };
 
 }
@@ -50,6 +50,7 @@ class ColumnDefinition;
 class ColumnNameExpression;
 class CommonTableExpression;
 class CommonTableExpressionList;
+class CreateIndex;
 class CreateTable;
 class Delete;
 class DropColumn;
@@ -57,6 +58,7 @@ class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
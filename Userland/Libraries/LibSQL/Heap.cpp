@@ -8,29 +8,58 @@
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <LibCore/IODevice.h>
+#include <LibCrypto/Checksum/CRC32.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Serializer.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 namespace SQL {
 
+// Blocks read from the heap file that are kept around, i.e. 1 MiB worth of them.
+constexpr static size_t PAGE_CACHE_BLOCKS = 1024;
+
+// The write-ahead log consists of one record per flush. A record is a header
+// of a magic number, the number of blocks in the record and a CRC32 of the
+// rest of the record, followed by the number and contents of each block.
+// Records that were only partially written when the process died fail the
+// checksum and are ignored.
+constexpr static u32 LOG_RECORD_MAGIC = 0x4c415753; // "SWAL"
+constexpr static size_t LOG_RECORD_HEADER_SIZE = 3 * sizeof(u32);
+constexpr static size_t LOG_RECORD_BLOCK_SIZE = sizeof(u32) + BLOCKSIZE;
+
+// Once the log grows beyond this size, the heap file is synced and the log is emptied.
+constexpr static size_t LOG_CHECKPOINT_SIZE = 4 * MiB;
+
 Heap::Heap(String file_name)
+    : m_page_cache(PAGE_CACHE_BLOCKS)
 {
     set_name(move(file_name));
 }
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
+    if (!m_file)
+        return;
+    if (!m_dirty_blocks.is_empty()) {
+        if (auto maybe_error = flush(); maybe_error.is_error()) {
             warnln("~Heap({}): {}", name(), maybe_error.error());
+            return;
+        }
+    }
+    // Leave the log behind if the heap file can't be synced, so that it gets replayed on the next open().
+    if (auto maybe_error = checkpoint(); maybe_error.is_error()) {
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+        return;
     }
+    unlink(log_file_name().characters());
 }
 
 ErrorOr<void> Heap::open()
 {
     size_t file_size = 0;
+    bool heap_file_exists = false;
     struct stat stat_buffer;
     if (stat(name().characters(), &stat_buffer) != 0) {
         if (errno != ENOENT) {
@@ -41,6 +70,7 @@ ErrorOr<void> Heap::open()
         warnln("Heap::open({}): can only use regular files"sv, name());
         return Error::from_string_literal("Heap::open(): can only use regular files");
     } else {
+        heap_file_exists = true;
         file_size = stat_buffer.st_size;
     }
     if (file_size > 0)
@@ -52,8 +82,30 @@ ErrorOr<void> Heap::open()
         return Error::from_string_literal("Heap::open(): could not open file");
     }
     m_file = file_or_error.value();
-    if (file_size > 0) {
+
+    if (auto error_maybe = open_log(); error_maybe.is_error()) {
+        m_file = nullptr;
+        return error_maybe.error();
+    }
+    // A log without a heap file belongs to a database that has since been deleted.
+    u32 replayed_blocks = 0;
+    if (heap_file_exists) {
+        auto replayed_blocks_or_error = replay_log();
+        if (replayed_blocks_or_error.is_error()) {
+            m_file = nullptr;
+            return replayed_blocks_or_error.release_error();
+        }
+        replayed_blocks = replayed_blocks_or_error.release_value();
+    } else if (auto error_maybe = checkpoint(); error_maybe.is_error()) {
+        m_file = nullptr;
+        return error_maybe.error();
+    }
+
+    if (file_size > 0 || replayed_blocks > 0) {
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
+            // The log is empty at this point, and this isn't a heap file it belongs with.
+            unlink(log_file_name().characters());
+            m_log_file = nullptr;
             m_file = nullptr;
             return error_maybe.error();
         }
@@ -70,10 +122,13 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         warnln("Heap({})::read_block({}): Heap file not opened"sv, name(), block);
         return Error::from_string_literal("Heap()::read_block(): Heap file not opened");
     }
-    auto buffer_or_empty = m_write_ahead_log.get(block);
+    auto buffer_or_empty = m_dirty_blocks.get(block);
     if (buffer_or_empty.has_value())
         return buffer_or_empty.release_value();
 
+    if (auto* cached = m_page_cache.get(block))
+        return *cached;
+
     if (block >= m_next_block) {
         warnln("Heap({})::read_block({}): block # out of range (>= {})"sv, name(), block, m_next_block);
         return Error::from_string_literal("Heap()::read_block(): block # out of range");
@@ -90,6 +145,7 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         *ret.offset_pointer(2), *ret.offset_pointer(3),
         *ret.offset_pointer(4), *ret.offset_pointer(5),
         *ret.offset_pointer(6), *ret.offset_pointer(7));
+    m_page_cache.set(block, ret);
     return ret;
 }
 
@@ -175,19 +231,136 @@ u32 Heap::new_record_pointer()
 ErrorOr<void> Heap::flush()
 {
     VERIFY(!m_file.is_null());
+    if (m_dirty_blocks.is_empty())
+        return {};
+
     Vector<u32> blocks;
-    for (auto& wal_entry : m_write_ahead_log) {
-        blocks.append(wal_entry.key);
+    for (auto& dirty_block : m_dirty_blocks) {
+        blocks.append(dirty_block.key);
     }
     quick_sort(blocks);
+
+    // Once the blocks are in the log the flush is durable, so the heap file
+    // itself doesn't need to be synced for every flush.
+    TRY(append_to_log(blocks));
     for (auto& block : blocks) {
-        auto buffer_it = m_write_ahead_log.find(block);
-        VERIFY(buffer_it != m_write_ahead_log.end());
+        auto buffer_it = m_dirty_blocks.find(block);
+        VERIFY(buffer_it != m_dirty_blocks.end());
         dbgln_if(SQL_DEBUG, "Flushing block {} to {}", block, name());
         TRY(write_block(block, buffer_it->value));
     }
-    m_write_ahead_log.clear();
+    for (auto& dirty_block : m_dirty_blocks)
+        m_page_cache.set(dirty_block.key, move(dirty_block.value));
+    m_dirty_blocks.clear();
     dbgln_if(SQL_DEBUG, "WAL flushed. Heap size = {}", size());
+
+    if (m_log_size >= LOG_CHECKPOINT_SIZE)
+        TRY(checkpoint());
+    return {};
+}
+
+ErrorOr<void> Heap::open_log()
+{
+    auto file_or_error = Core::File::open(log_file_name(), Core::OpenMode::ReadWrite);
+    if (file_or_error.is_error()) {
+        warnln("Heap::open({}): could not open log: {}"sv, name(), file_or_error.error());
+        return Error::from_string_literal("Heap::open(): could not open log file");
+    }
+    m_log_file = file_or_error.release_value();
+    return {};
+}
+
+ErrorOr<u32> Heap::replay_log()
+{
+    VERIFY(!m_log_file.is_null());
+    auto log = m_log_file->read_all();
+    if (log.is_empty())
+        return 0u;
+
+    u32 replayed_blocks = 0;
+    size_t offset = 0;
+    while (log.size() - offset >= LOG_RECORD_HEADER_SIZE) {
+        u32 magic;
+        u32 block_count;
+        u32 checksum;
+        memcpy(&magic, log.offset_pointer(offset), sizeof(u32));
+        memcpy(&block_count, log.offset_pointer(offset + sizeof(u32)), sizeof(u32));
+        memcpy(&checksum, log.offset_pointer(offset + 2 * sizeof(u32)), sizeof(u32));
+        if (magic != LOG_RECORD_MAGIC)
+            break;
+        auto available = log.size() - offset - LOG_RECORD_HEADER_SIZE;
+        if (block_count > available / LOG_RECORD_BLOCK_SIZE)
+            break;
+        auto record = log.bytes().slice(offset + LOG_RECORD_HEADER_SIZE, block_count * LOG_RECORD_BLOCK_SIZE);
+        if (Crypto::Checksum::CRC32(record).digest() != checksum)
+            break;
+
+        dbgln_if(SQL_DEBUG, "Replaying {} blocks from the log of {}", block_count, name());
+        for (auto ix = 0u; ix < block_count; ix++) {
+            auto block_record = record.slice(ix * LOG_RECORD_BLOCK_SIZE, LOG_RECORD_BLOCK_SIZE);
+            u32 block;
+            memcpy(&block, block_record.data(), sizeof(u32));
+            auto buffer = TRY(ByteBuffer::copy(block_record.slice(sizeof(u32))));
+            m_next_block = max(m_next_block, block + 1);
+            TRY(write_block(block, buffer));
+        }
+        replayed_blocks += block_count;
+        offset += LOG_RECORD_HEADER_SIZE + record.size();
+    }
+    if (offset < log.size())
+        warnln("Heap({}): Ignoring {} bytes at the end of the log that were not completely written"sv, name(), log.size() - offset);
+
+    TRY(checkpoint());
+    return replayed_blocks;
+}
+
+ErrorOr<void> Heap::append_to_log(Vector<u32> const& blocks)
+{
+    VERIFY(!m_log_file.is_null());
+    auto record = TRY(ByteBuffer::create_zeroed(LOG_RECORD_HEADER_SIZE + blocks.size() * LOG_RECORD_BLOCK_SIZE));
+    auto offset = LOG_RECORD_HEADER_SIZE;
+    for (auto block : blocks) {
+        auto& buffer = m_dirty_blocks.find(block)->value;
+        if (buffer.size() > BLOCKSIZE) {
+            warnln("Heap({})::flush(): Oversized block {} ({} > {})"sv, name(), block, buffer.size(), BLOCKSIZE);
+            return Error::from_string_literal("Heap()::flush(): Oversized block");
+        }
+        record.overwrite(offset, &block, sizeof(u32));
+        record.overwrite(offset + sizeof(u32), buffer.data(), buffer.size());
+        offset += LOG_RECORD_BLOCK_SIZE;
+    }
+
+    u32 block_count = blocks.size();
+    u32 checksum = Crypto::Checksum::CRC32(record.bytes().slice(LOG_RECORD_HEADER_SIZE)).digest();
+    record.overwrite(0, &LOG_RECORD_MAGIC, sizeof(u32));
+    record.overwrite(sizeof(u32), &block_count, sizeof(u32));
+    record.overwrite(2 * sizeof(u32), &checksum, sizeof(u32));
+
+    if (!m_log_file->write(record.data(), (int)record.size())) {
+        warnln("Heap({})::flush(): Could not write log: {}"sv, name(), m_log_file->error_string());
+        return Error::from_string_literal("Heap()::flush(): Could not write log");
+    }
+    if (fsync(m_log_file->fd()) < 0) {
+        warnln("Heap({})::flush(): Could not sync log: {}"sv, name(), strerror(errno));
+        return Error::from_string_literal("Heap()::flush(): Could not sync log");
+    }
+    m_log_size += record.size();
+    return {};
+}
+
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(!m_file.is_null() && !m_log_file.is_null());
+    if (fsync(m_file->fd()) < 0) {
+        warnln("Heap({})::checkpoint(): Could not sync heap file: {}"sv, name(), strerror(errno));
+        return Error::from_string_literal("Heap()::checkpoint(): Could not sync heap file");
+    }
+    // The log is synced after truncating it as well, so that a crash can't bring back records that were already checkpointed.
+    if (!m_log_file->truncate(0) || !m_log_file->seek(0) || fsync(m_log_file->fd()) < 0) {
+        warnln("Heap({})::checkpoint(): Could not empty log: {}"sv, name(), strerror(errno));
+        return Error::from_string_literal("Heap()::checkpoint(): Could not empty log");
+    }
+    m_log_size = 0;
     return {};
 }
 
@@ -198,6 +371,7 @@ constexpr static int TABLES_ROOT_OFFSET = 20;
 constexpr static int TABLE_COLUMNS_ROOT_OFFSET = 24;
 constexpr static int FREE_LIST_OFFSET = 28;
 constexpr static int USER_VALUES_OFFSET = 32;
+constexpr static int TABLE_INDEXES_ROOT_OFFSET = 96;
 
 ErrorOr<void> Heap::read_zero_block()
 {
@@ -211,12 +385,18 @@ ErrorOr<void> Heap::read_zero_block()
     dbgln_if(SQL_DEBUG, "Read zero block from {}", name());
     memcpy(&m_version, buffer.offset_pointer(VERSION_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Version: {}.{}", (m_version & 0xFFFF0000) >> 16, (m_version & 0x0000FFFF));
+    if (m_version != HEAP_VERSION) {
+        warnln("{}: Heap file version {}.{} is not supported"sv, name(), (m_version & 0xFFFF0000) >> 16, (m_version & 0x0000FFFF));
+        return Error::from_string_literal("Heap()::read_zero_block(): Heap file version is not supported");
+    }
     memcpy(&m_schemas_root, buffer.offset_pointer(SCHEMAS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_tables_root);
     memcpy(&m_tables_root, buffer.offset_pointer(TABLES_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     memcpy(&m_table_columns_root, buffer.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
+    memcpy(&m_table_indexes_root, buffer.offset_pointer(TABLE_INDEXES_ROOT_OFFSET), sizeof(u32));
+    dbgln_if(SQL_DEBUG, "Table indexes root node: {}", m_table_indexes_root);
     memcpy(&m_free_list, buffer.offset_pointer(FREE_LIST_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
     memcpy(m_user_values.data(), buffer.offset_pointer(USER_VALUES_OFFSET), m_user_values.size() * sizeof(u32));
@@ -235,6 +415,7 @@ void Heap::update_zero_block()
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     dbgln_if(SQL_DEBUG, "Table Columns root node: {}", m_table_columns_root);
+    dbgln_if(SQL_DEBUG, "Table Indexes root node: {}", m_table_indexes_root);
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix]) {
@@ -251,16 +432,18 @@ void Heap::update_zero_block()
     buffer.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer.overwrite(FREE_LIST_OFFSET, &m_free_list, sizeof(u32));
     buffer.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
+    buffer.overwrite(TABLE_INDEXES_ROOT_OFFSET, &m_table_indexes_root, sizeof(u32));
 
     add_to_wal(0, buffer);
 }
 
 void Heap::initialize_zero_block()
 {
-    m_version = 0x00000001;
+    m_version = HEAP_VERSION;
     m_schemas_root = 0;
     m_tables_root = 0;
     m_table_columns_root = 0;
+    m_table_indexes_root = 0;
     m_next_block = 1;
     m_free_list = 0;
     for (auto& user : m_user_values) {
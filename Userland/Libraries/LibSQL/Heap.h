@@ -9,6 +9,7 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
+#include <AK/LRUCache.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
@@ -18,6 +19,9 @@ namespace SQL {
 
 constexpr static u32 BLOCKSIZE = 1024;
 
+// Version 2 changed the layout of B-Tree nodes.
+constexpr static u32 HEAP_VERSION = 0x00000002;
+
 /**
  * A Heap is a logical container for database (SQL) data. Conceptually a
  * Heap can be a database file, or a memory block, or another storage medium.
@@ -28,6 +32,15 @@ constexpr static u32 BLOCKSIZE = 1024;
  * assumed that a single SQL database is backed by a single Heap.
  *
  * Currently only B-Trees and tuple stores are implemented.
+ *
+ * Blocks written by the datastructures are kept in memory until the Heap is
+ * flushed. A flush first appends all of them to a write-ahead log file next
+ * to the heap file, and syncs that log once. Only then the blocks are written
+ * to their place in the heap file. If that gets interrupted, the log is
+ * replayed the next time the Heap is opened. The log is emptied again once
+ * it grows large, and when the Heap is closed.
+ *
+ * Blocks read from the heap file are kept in a page cache with LRU eviction.
  */
 class Heap : public Core::Object {
     C_OBJECT(Heap);
@@ -65,6 +78,14 @@ public:
         m_table_columns_root = root;
         update_zero_block();
     }
+
+    u32 table_indexes_root() const { return m_table_indexes_root; }
+
+    void set_table_indexes_root(u32 root)
+    {
+        m_table_indexes_root = root;
+        update_zero_block();
+    }
     u32 version() const { return m_version; }
 
     u32 user_value(size_t index) const
@@ -88,7 +109,8 @@ public:
             *buffer.offset_pointer(2), *buffer.offset_pointer(3),
             *buffer.offset_pointer(4), *buffer.offset_pointer(5),
             *buffer.offset_pointer(6), *buffer.offset_pointer(7));
-        m_write_ahead_log.set(block, buffer);
+        m_page_cache.remove(block);
+        m_dirty_blocks.set(block, buffer);
     }
 
     ErrorOr<void> flush();
@@ -98,20 +120,29 @@ private:
 
     ErrorOr<void> write_block(u32, ByteBuffer&);
     ErrorOr<void> seek_block(u32);
+    String log_file_name() const { return String::formatted("{}-wal", name()); }
+    ErrorOr<void> open_log();
+    ErrorOr<u32> replay_log();
+    ErrorOr<void> append_to_log(Vector<u32> const& blocks);
+    ErrorOr<void> checkpoint();
     ErrorOr<void> read_zero_block();
     void initialize_zero_block();
     void update_zero_block();
 
     RefPtr<Core::File> m_file { nullptr };
+    RefPtr<Core::File> m_log_file { nullptr };
+    size_t m_log_size { 0 };
     u32 m_free_list { 0 };
     u32 m_next_block { 1 };
     u32 m_end_of_file { 1 };
     u32 m_schemas_root { 0 };
     u32 m_tables_root { 0 };
     u32 m_table_columns_root { 0 };
-    u32 m_version { 0x00000001 };
+    u32 m_table_indexes_root { 0 };
+    u32 m_version { HEAP_VERSION };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<u32, ByteBuffer> m_write_ahead_log;
+    HashMap<u32, ByteBuffer> m_dirty_blocks;
+    LRUCache<u32, ByteBuffer> m_page_cache;
 };
 
 }
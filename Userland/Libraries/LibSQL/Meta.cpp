@@ -71,10 +71,10 @@ void ColumnDef::set_default_value(Value const& default_value)
     m_default = default_value;
 }
 
-Key ColumnDef::make_key(TableDef const& table_def)
+Key ColumnDef::make_key(Relation const& relation)
 {
     Key key(index_def());
-    key["table_hash"] = table_def.key().hash();
+    key["table_hash"] = relation.key().hash();
     return key;
 }
 
@@ -129,6 +129,7 @@ Key IndexDef::key() const
     key["table_hash"] = parent_relation()->key().hash();
     key["index_name"] = name();
     key["unique"] = unique() ? 1 : 0;
+    key.set_pointer(pointer());
     return key;
 }
 
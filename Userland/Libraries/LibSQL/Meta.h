@@ -80,7 +80,8 @@ public:
     Value const& default_value() const { return m_default; }
 
     static NonnullRefPtr<IndexDef> index_def();
-    static Key make_key(TableDef const&);
+    // The relation is either the table the column belongs to, or the index the column is a key part of.
+    static Key make_key(Relation const&);
 
 protected:
     ColumnDef(Relation*, size_t, String, SQLType);
@@ -136,6 +137,7 @@ public:
     Key key() const override;
     void append_column(String, SQLType);
     void append_column(Key const&);
+    void append_index(NonnullRefPtr<IndexDef> index) { m_indexes.append(move(index)); }
     size_t num_columns() { return m_columns.size(); }
     size_t num_indexes() { return m_indexes.size(); }
     NonnullRefPtrVector<ColumnDef> const& columns() const { return m_columns; }
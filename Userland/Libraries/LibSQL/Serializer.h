@@ -26,6 +26,11 @@ public:
     {
     }
 
+    explicit Serializer(ByteBuffer buffer)
+        : m_buffer(move(buffer))
+    {
+    }
+
     void get_block(u32 pointer)
     {
         VERIFY(m_heap.ptr() != nullptr);
@@ -107,6 +112,18 @@ public:
 
     void serialize(String const&);
 
+    void serialize_bytes(ReadonlyBytes bytes)
+    {
+        write(bytes.data(), bytes.size());
+    }
+
+    ReadonlyBytes deserialize_bytes(size_t size)
+    {
+        return { read(size), size };
+    }
+
+    [[nodiscard]] ReadonlyBytes bytes() const { return m_buffer.bytes(); }
+
     template<typename T>
     bool serialize_and_write(T const& t, u32 pointer)
     {
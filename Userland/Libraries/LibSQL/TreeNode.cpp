@@ -111,19 +111,67 @@ TreeNode::TreeNode(BTree& tree, TreeNode* up, TreeNode* left, u32 pointer)
     m_is_leaf = left->pointer() == 0;
 }
 
+// Keys are stored without their descriptor, which is the same for all keys in the tree, and without
+// the bytes at their start that they have in common with the key before them in the node:
+//   u32 key pointer, u16 length of the shared prefix, u16 length of the rest, the rest of the values
+ByteBuffer TreeNode::key_values(Key const& key)
+{
+    Serializer serializer;
+    for (auto ix = 0u; ix < key.size(); ix++)
+        serializer.serialize<Value>(key[ix]);
+    return ByteBuffer::copy(serializer.bytes()).release_value_but_fixme_should_propagate_errors();
+}
+
+static size_t common_prefix_length(ReadonlyBytes a, ReadonlyBytes b)
+{
+    size_t length = 0;
+    while (length < a.size() && length < b.size() && a[length] == b[length])
+        ++length;
+    return length;
+}
+
+size_t TreeNode::entry_length(ReadonlyBytes key_values, ReadonlyBytes previous_key_values)
+{
+    return 2 * sizeof(u32) + 2 * sizeof(u16) + key_values.size() - common_prefix_length(key_values, previous_key_values);
+}
+
+Key TreeNode::deserialize_key(Serializer& serializer, ByteBuffer& previous_key_values) const
+{
+    auto key_pointer = serializer.deserialize<u32>();
+    auto prefix_length = serializer.deserialize<u16>();
+    auto suffix_length = serializer.deserialize<u16>();
+    VERIFY(prefix_length <= previous_key_values.size());
+
+    auto values = ByteBuffer::copy(previous_key_values.bytes().trim(prefix_length)).release_value_but_fixme_should_propagate_errors();
+    values.append(serializer.deserialize_bytes(suffix_length));
+    Serializer values_serializer(values);
+
+    Key key(m_tree.descriptor());
+    key.clear();
+    for (auto ix = 0u; ix < m_tree.descriptor()->size(); ix++)
+        key.append(values_serializer.deserialize<Value>());
+    key.set_pointer(key_pointer);
+
+    previous_key_values = move(values);
+    return key;
+}
+
 void TreeNode::deserialize(Serializer& serializer)
 {
     auto nodes = serializer.deserialize<u32>();
     dbgln_if(SQL_DEBUG, "Deserializing node. Size {}", nodes);
     if (nodes > 0) {
+        // Nodes constructed with a parent start out with an empty left pointer, which the one read here replaces.
+        m_down.clear();
+        ByteBuffer previous_key_values;
         for (u32 i = 0; i < nodes; i++) {
             auto left = serializer.deserialize<u32>();
             dbgln_if(SQL_DEBUG, "Down[{}] {}", i, left);
-            if (!m_down.is_empty())
+            if (i > 0)
                 VERIFY((left == 0) == m_is_leaf);
             else
                 m_is_leaf = (left == 0);
-            m_entries.append(serializer.deserialize<Key>(m_tree.descriptor()));
+            m_entries.append(deserialize_key(serializer, previous_key_values));
             m_down.empend(this, left);
         }
         auto right = serializer.deserialize<u32>();
@@ -138,11 +186,19 @@ void TreeNode::serialize(Serializer& serializer) const
     u32 sz = size();
     serializer.serialize<u32>(sz);
     if (sz > 0) {
+        ByteBuffer previous_key_values;
         for (auto ix = 0u; ix < size(); ix++) {
             auto& entry = m_entries[ix];
             dbgln_if(SQL_DEBUG, "Serializing Left[{}] = {}", ix, m_down[ix].pointer());
             serializer.serialize<u32>(is_leaf() ? 0u : m_down[ix].pointer());
-            serializer.serialize<Key>(entry);
+
+            auto values = key_values(entry);
+            auto prefix_length = common_prefix_length(values, previous_key_values);
+            serializer.serialize<u32>(entry.pointer());
+            serializer.serialize<u16>((u16)prefix_length);
+            serializer.serialize<u16>((u16)(values.size() - prefix_length));
+            serializer.serialize_bytes(values.bytes().slice(prefix_length));
+            previous_key_values = move(values);
         }
         dbgln_if(SQL_DEBUG, "Serializing Right = {}", m_down[size()].pointer());
         serializer.serialize<u32>(is_leaf() ? 0u : m_down[size()].pointer());
@@ -153,9 +209,12 @@ size_t TreeNode::length() const
 {
     if (!size())
         return 0;
-    size_t len = sizeof(u32);
+    size_t len = 2 * sizeof(u32);
+    ByteBuffer previous_key_values;
     for (auto& key : m_entries) {
-        len += sizeof(u32) + key.length();
+        auto values = key_values(key);
+        len += entry_length(values, previous_key_values);
+        previous_key_values = move(values);
     }
     return len;
 }
@@ -346,7 +405,7 @@ void TreeNode::split()
     dump_if(SQL_DEBUG, "Split Left To WAL");
     tree().serializer().serialize_and_write(*this, pointer());
     new_node->dump_if(SQL_DEBUG, "Split Right to WAL");
-    tree().serializer().serialize_and_write(*new_node, pointer());
+    tree().serializer().serialize_and_write(*new_node, new_node->pointer());
 
     m_up->just_insert(median, new_node);
 }
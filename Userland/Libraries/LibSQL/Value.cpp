@@ -316,7 +316,8 @@ Value& Value::operator=(Vector<Value> const& vector)
 
 size_t Value::length() const
 {
-    return m_impl.visit([&](auto& impl) { return impl.length(); });
+    // The type flags byte written by serialize() counts towards the length as well.
+    return sizeof(u8) + m_impl.visit([&](auto& impl) { return impl.length(); });
 }
 
 u32 Value::hash() const
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Try.h>
+
+namespace SoftGPU {
+
+/**
+ * Tiled3DBuffer<T> stores values at X, Y and Z coordinates just like
+ * Typed3DBuffer<T>, but lays out every Z slice in square tiles of
+ * 4x4 values instead of in rows. Values that are close to each other
+ * in either direction then mostly end up in the same cache lines, which
+ * is what texture sampling wants, regardless of how a texture is rotated
+ * or scaled on screen.
+ */
+template<typename T>
+class Tiled3DBuffer final : public RefCounted<Tiled3DBuffer<T>> {
+public:
+    static constexpr int tile_size = 4;
+
+    static ErrorOr<NonnullRefPtr<Tiled3DBuffer<T>>> try_create(int width, int height, int depth)
+    {
+        VERIFY(width > 0 && height > 0 && depth > 0);
+        auto tile_columns = ceil_div(width, tile_size);
+        auto tile_rows = ceil_div(height, tile_size);
+        auto data = TRY(FixedArray<T>::try_create(tile_columns * tile_rows * tile_size * tile_size * depth));
+        return adopt_ref(*new Tiled3DBuffer(width, height, depth, tile_columns, tile_rows, move(data)));
+    }
+
+    ALWAYS_INLINE T* buffer_pointer(int x, int y, int z)
+    {
+        return &m_data[index_of(x, y, z)];
+    }
+
+    ALWAYS_INLINE T const* buffer_pointer(int x, int y, int z) const
+    {
+        return &m_data[index_of(x, y, z)];
+    }
+
+    int depth() const { return m_depth; }
+    int height() const { return m_height; }
+    int width() const { return m_width; }
+
+private:
+    static constexpr int tile_shift = 2;
+    static constexpr int tile_mask = tile_size - 1;
+    static_assert(1 << tile_shift == tile_size);
+
+    Tiled3DBuffer(int width, int height, int depth, int tile_columns, int tile_rows, FixedArray<T> data)
+        : m_data(move(data))
+        , m_depth(depth)
+        , m_height(height)
+        , m_width(width)
+        , m_tile_columns(tile_columns)
+        , m_tile_rows(tile_rows)
+    {
+    }
+
+    ALWAYS_INLINE size_t index_of(int x, int y, int z) const
+    {
+        auto tile = (z * m_tile_rows + (y >> tile_shift)) * m_tile_columns + (x >> tile_shift);
+        return tile * tile_size * tile_size + (y & tile_mask) * tile_size + (x & tile_mask);
+    }
+
+    FixedArray<T> m_data;
+    int m_depth;
+    int m_height;
+    int m_width;
+    int m_tile_columns;
+    int m_tile_rows;
+};
+
+}
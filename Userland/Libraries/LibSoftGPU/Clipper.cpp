@@ -94,6 +94,43 @@ FLATTEN static void clip_plane(Vector<GPU::Vertex>& input_list, Vector<GPU::Vert
     }
 }
 
+template<Clipper::ClipPlane plane>
+static constexpr u8 outcode_bit(FloatVector4 const& vertex)
+{
+    return point_within_clip_plane<plane>(vertex) ? 0 : 1 << to_underlying(plane);
+}
+
+// One bit for every frustum plane that the vertex lies outside of.
+static constexpr u8 frustum_outcode(FloatVector4 const& vertex)
+{
+    return outcode_bit<Clipper::ClipPlane::Left>(vertex)
+        | outcode_bit<Clipper::ClipPlane::Right>(vertex)
+        | outcode_bit<Clipper::ClipPlane::Top>(vertex)
+        | outcode_bit<Clipper::ClipPlane::Bottom>(vertex)
+        | outcode_bit<Clipper::ClipPlane::Near>(vertex)
+        | outcode_bit<Clipper::ClipPlane::Far>(vertex);
+}
+
+Clipper::Classification Clipper::classify_triangle(GPU::Vertex const& v0, GPU::Vertex const& v1, GPU::Vertex const& v2, Vector<FloatVector4> const& user_planes)
+{
+    auto const outcode0 = frustum_outcode(v0.clip_coordinates);
+    auto const outcode1 = frustum_outcode(v1.clip_coordinates);
+    auto const outcode2 = frustum_outcode(v2.clip_coordinates);
+    if ((outcode0 & outcode1 & outcode2) != 0)
+        return Classification::Outside;
+
+    bool is_inside = (outcode0 | outcode1 | outcode2) == 0;
+    for (auto const& plane : user_planes) {
+        auto const within0 = point_within_user_plane(v0.eye_coordinates, plane);
+        auto const within1 = point_within_user_plane(v1.eye_coordinates, plane);
+        auto const within2 = point_within_user_plane(v2.eye_coordinates, plane);
+        if (!within0 && !within1 && !within2)
+            return Classification::Outside;
+        is_inside = is_inside && within0 && within1 && within2;
+    }
+    return is_inside ? Classification::Inside : Classification::Intersecting;
+}
+
 void Clipper::clip_points_against_frustum(Vector<GPU::Vertex>& vertices)
 {
     m_vertex_buffer.clear_with_capacity();
@@ -25,8 +25,18 @@ public:
         User, // Within view space
     };
 
+    enum class Classification : u8 {
+        Inside,
+        Outside,
+        Intersecting,
+    };
+
     Clipper() = default;
 
+    // Tells whether the triangle lies entirely within the frustum and the user-defined planes, so that it doesn't
+    // need clipping, or entirely outside of one of them, so that it can be dropped.
+    static Classification classify_triangle(GPU::Vertex const&, GPU::Vertex const&, GPU::Vertex const&, Vector<FloatVector4> const& user_planes);
+
     void clip_points_against_frustum(Vector<GPU::Vertex>& vertices);
     bool clip_line_against_frustum(GPU::Vertex& from, GPU::Vertex& to);
     void clip_triangle_against_frustum(Vector<GPU::Vertex>& input_vecs);
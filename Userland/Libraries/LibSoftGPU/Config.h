@@ -22,6 +22,10 @@ static constexpr int NUM_LIGHTS = 8;
 static constexpr int MAX_CLIP_PLANES = 6;
 static constexpr int SUBPIXEL_BITS = 6;
 
+// Triangles are binned into square tiles of this many pixels, which are rasterized in parallel. Needs to be even, so
+// that no pixel quad straddles two tiles.
+static constexpr int RASTERIZER_TILE_SIZE = 64;
+
 // See: https://www.khronos.org/opengl/wiki/Common_Mistakes#Texture_edge_color_problem
 // FIXME: make this dynamically configurable through ConfigServer
 static constexpr bool CLAMP_DEPRECATED_BEHAVIOR = false;
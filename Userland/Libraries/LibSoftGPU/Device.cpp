@@ -20,6 +20,7 @@
 #include <LibSoftGPU/Device.h>
 #include <LibSoftGPU/PixelQuad.h>
 #include <LibSoftGPU/SIMD.h>
+#include <LibThreading/ThreadPool.h>
 #include <math.h>
 
 namespace SoftGPU {
@@ -48,6 +49,9 @@ using AK::SIMD::u32x4;
 
 static constexpr int subpixel_factor = 1 << SUBPIXEL_BITS;
 
+// Below this, handing the tiles out to the thread pool costs more than it saves.
+static constexpr size_t min_triangles_for_parallel_rasterization = 32;
+
 // Returns positive values for counter-clockwise rotation of vertices. Note that it returns the
 // area of a parallelogram with sides {a, b} and {b, c}, so _double_ the area of the triangle {a, b, c}.
 constexpr static i32 edge_function(IntVector2 const& a, IntVector2 const& b, IntVector2 const& c)
@@ -66,6 +70,67 @@ constexpr static auto interpolate(T const& v0, T const& v1, T const& v2, Vector3
     return v0 * barycentric_coords.x() + v1 * barycentric_coords.y() + v2 * barycentric_coords.z();
 }
 
+// These load a component of four consecutive vertices into one SIMD vector per coordinate, and store it back.
+ALWAYS_INLINE static Vector4<f32x4> gather4(GPU::Vertex const* vertices, FloatVector4 GPU::Vertex::*component)
+{
+    auto const& a = vertices[0].*component;
+    auto const& b = vertices[1].*component;
+    auto const& c = vertices[2].*component;
+    auto const& d = vertices[3].*component;
+    return {
+        f32x4 { a.x(), b.x(), c.x(), d.x() },
+        f32x4 { a.y(), b.y(), c.y(), d.y() },
+        f32x4 { a.z(), b.z(), c.z(), d.z() },
+        f32x4 { a.w(), b.w(), c.w(), d.w() },
+    };
+}
+
+ALWAYS_INLINE static Vector3<f32x4> gather4(GPU::Vertex const* vertices, FloatVector3 GPU::Vertex::*component)
+{
+    auto const& a = vertices[0].*component;
+    auto const& b = vertices[1].*component;
+    auto const& c = vertices[2].*component;
+    auto const& d = vertices[3].*component;
+    return {
+        f32x4 { a.x(), b.x(), c.x(), d.x() },
+        f32x4 { a.y(), b.y(), c.y(), d.y() },
+        f32x4 { a.z(), b.z(), c.z(), d.z() },
+    };
+}
+
+ALWAYS_INLINE static void scatter4(Vector4<f32x4> const& values, GPU::Vertex* vertices, FloatVector4 GPU::Vertex::*component)
+{
+    for (size_t i = 0; i < 4; ++i)
+        vertices[i].*component = { values.x()[i], values.y()[i], values.z()[i], values.w()[i] };
+}
+
+ALWAYS_INLINE static void scatter4(Vector3<f32x4> const& values, GPU::Vertex* vertices, FloatVector3 GPU::Vertex::*component)
+{
+    for (size_t i = 0; i < 4; ++i)
+        vertices[i].*component = { values.x()[i], values.y()[i], values.z()[i] };
+}
+
+ALWAYS_INLINE static Vector4<f32x4> transform4(FloatMatrix4x4 const& matrix, Vector4<f32x4> const& v)
+{
+    auto const elements = matrix.elements();
+    return {
+        v.x() * elements[0][0] + v.y() * elements[0][1] + v.z() * elements[0][2] + v.w() * elements[0][3],
+        v.x() * elements[1][0] + v.y() * elements[1][1] + v.z() * elements[1][2] + v.w() * elements[1][3],
+        v.x() * elements[2][0] + v.y() * elements[2][1] + v.z() * elements[2][2] + v.w() * elements[2][3],
+        v.x() * elements[3][0] + v.y() * elements[3][1] + v.z() * elements[3][2] + v.w() * elements[3][3],
+    };
+}
+
+ALWAYS_INLINE static Vector3<f32x4> transform4(FloatMatrix3x3 const& matrix, Vector3<f32x4> const& v)
+{
+    auto const elements = matrix.elements();
+    return {
+        v.x() * elements[0][0] + v.y() * elements[0][1] + v.z() * elements[0][2],
+        v.x() * elements[1][0] + v.y() * elements[1][1] + v.z() * elements[1][2],
+        v.x() * elements[2][0] + v.y() * elements[2][1] + v.z() * elements[2][2],
+    };
+}
+
 static GPU::ColorType to_bgra32(FloatVector4 const& color)
 {
     auto clamped = color.clamped(0.0f, 1.0f);
@@ -650,7 +715,7 @@ void Device::rasterize_point(GPU::Vertex& point)
         rasterize_point_aliased(point);
 }
 
-void Device::rasterize_triangle(Triangle& triangle)
+bool Device::setup_triangle(Triangle& triangle)
 {
     INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
 
@@ -660,17 +725,17 @@ void Device::rasterize_triangle(Triangle& triangle)
 
     auto triangle_area = edge_function(v0, v1, v2);
     if (triangle_area == 0)
-        return;
+        return false;
 
     // Perform face culling
     if (m_options.enable_culling) {
         bool is_front = (m_options.front_face == GPU::WindingOrder::CounterClockwise ? triangle_area > 0 : triangle_area < 0);
 
         if (!is_front && m_options.cull_back)
-            return;
+            return false;
 
         if (is_front && m_options.cull_front)
-            return;
+            return false;
     }
 
     // Force counter-clockwise ordering of vertices
@@ -680,6 +745,27 @@ void Device::rasterize_triangle(Triangle& triangle)
         triangle_area *= -1;
     }
 
+    triangle.subpixel_coordinates[0] = v0;
+    triangle.subpixel_coordinates[1] = v1;
+    triangle.subpixel_coordinates[2] = v2;
+    triangle.area = triangle_area;
+
+    // Calculate render bounds based on the triangle's vertices
+    triangle.render_bounds = {};
+    triangle.render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    triangle.render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    triangle.render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    triangle.render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    return true;
+}
+
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& bounds)
+{
+    auto const v0 = triangle.subpixel_coordinates[0];
+    auto const v1 = triangle.subpixel_coordinates[1];
+    auto const v2 = triangle.subpixel_coordinates[2];
+    auto const triangle_area = triangle.area;
+
     auto const& vertex0 = triangle.vertices[0];
     auto const& vertex1 = triangle.vertices[1];
     auto const& vertex2 = triangle.vertices[2];
@@ -712,12 +798,9 @@ void Device::rasterize_triangle(Triangle& triangle)
             && edges.z() >= zero.z();
     };
 
-    // Calculate render bounds based on the triangle's vertices
-    Gfx::IntRect render_bounds;
-    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
-    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    auto render_bounds = triangle.render_bounds.intersected(bounds);
+    if (render_bounds.is_empty())
+        return;
 
     // Calculate depth of fragment for fog;
     // OpenGL 1.5 chapter 3.10: "An implementation may choose to approximate the
@@ -1033,18 +1116,30 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         m_options.texcoord_generation_enabled_coordinates,
         [](auto coordinates_enabled) { return coordinates_enabled != GPU::TexCoordGenerationCoordinate::None; });
 
-    // First, transform all vertices
-    for (auto& vertex : vertices) {
-        vertex.eye_coordinates = model_view_transform * vertex.position;
+    // First, transform the positions and normals of all vertices, four at a time
+    size_t batch_start = 0;
+    for (; batch_start + 4 <= vertices.size(); batch_start += 4) {
+        auto* batch = vertices.data() + batch_start;
 
+        auto const eye_coordinates = transform4(model_view_transform, gather4(batch, &GPU::Vertex::position));
+        scatter4(eye_coordinates, batch, &GPU::Vertex::eye_coordinates);
+        scatter4(transform4(projection_transform, eye_coordinates), batch, &GPU::Vertex::clip_coordinates);
+        scatter4(transform4(normal_transform, gather4(batch, &GPU::Vertex::normal)), batch, &GPU::Vertex::normal);
+    }
+    for (size_t i = batch_start; i < vertices.size(); ++i) {
+        auto& vertex = vertices[i];
+        vertex.eye_coordinates = model_view_transform * vertex.position;
+        vertex.clip_coordinates = projection_transform * vertex.eye_coordinates;
         vertex.normal = normal_transform * vertex.normal;
+    }
+
+    // Then light them and generate their texture coordinates
+    for (auto& vertex : vertices) {
         if (m_options.normalization_enabled)
             vertex.normal.normalize();
 
         calculate_vertex_lighting(vertex);
 
-        vertex.clip_coordinates = projection_transform * vertex.eye_coordinates;
-
         if (texture_coordinate_generation_enabled)
             generate_texture_coordinates(vertex, m_options);
 
@@ -1175,6 +1270,18 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
 
     // Clip triangles
     for (auto& triangle : m_triangle_list) {
+        // Most triangles are either entirely visible or entirely invisible, and don't need to go through the clipper
+        auto const classification = Clipper::classify_triangle(triangle.vertices[0], triangle.vertices[1], triangle.vertices[2], m_clip_planes);
+        if (classification == Clipper::Classification::Outside)
+            continue;
+        if (classification == Clipper::Classification::Inside) {
+            for (auto& vertex : triangle.vertices)
+                calculate_vertex_window_coordinates(vertex);
+            if (setup_triangle(triangle))
+                m_processed_triangles.append(triangle);
+            continue;
+        }
+
         m_clipped_vertices.clear_with_capacity();
         m_clipped_vertices.append(triangle.vertices[0]);
         m_clipped_vertices.append(triangle.vertices[1]);
@@ -1195,12 +1302,71 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         for (size_t i = 1; i < m_clipped_vertices.size() - 1; i++) {
             tri.vertices[1] = m_clipped_vertices[i];
             tri.vertices[2] = m_clipped_vertices[i + 1];
-            m_processed_triangles.append(tri);
+            if (setup_triangle(tri))
+                m_processed_triangles.append(tri);
+        }
+    }
+
+    // The statistics counters aren't safe to update from multiple threads, so the overlay keeps us on this one.
+    if (!ENABLE_STATISTICS_OVERLAY
+        && m_processed_triangles.size() >= min_triangles_for_parallel_rasterization
+        && Threading::ThreadPool::the().worker_count() > 1) {
+        rasterize_triangles_in_tiles();
+        return;
+    }
+
+    for (auto const& triangle : m_processed_triangles)
+        rasterize_triangle(triangle, m_frame_buffer->rect());
+}
+
+void Device::rasterize_triangles_in_tiles()
+{
+    // Every triangle goes into the bin of each tile that its bounds overlap. The tiles don't share any pixels, so
+    // they can be rasterized in parallel, while within a tile the triangles are drawn in the order they were
+    // submitted in, which keeps depth testing, stencil operations and blending working as before.
+    auto const frame_rect = m_frame_buffer->rect();
+    auto const tile_columns = ceil_div(frame_rect.width(), RASTERIZER_TILE_SIZE);
+    auto const tile_rows = ceil_div(frame_rect.height(), RASTERIZER_TILE_SIZE);
+    auto const tile_count = static_cast<size_t>(tile_columns * tile_rows);
+
+    if (m_tile_bins.size() != tile_count)
+        m_tile_bins.resize(tile_count);
+    for (auto& bin : m_tile_bins)
+        bin.clear_with_capacity();
+
+    for (size_t i = 0; i < m_processed_triangles.size(); ++i) {
+        auto bounds = m_processed_triangles[i].render_bounds.intersected(frame_rect);
+        if (m_options.scissor_enabled)
+            bounds.intersect(m_options.scissor_box);
+        if (bounds.is_empty())
+            continue;
+
+        auto const first_column = (bounds.left() - frame_rect.left()) / RASTERIZER_TILE_SIZE;
+        auto const last_column = (bounds.right() - frame_rect.left()) / RASTERIZER_TILE_SIZE;
+        auto const first_row = (bounds.top() - frame_rect.top()) / RASTERIZER_TILE_SIZE;
+        auto const last_row = (bounds.bottom() - frame_rect.top()) / RASTERIZER_TILE_SIZE;
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column)
+                m_tile_bins[row * tile_columns + column].append(i);
         }
     }
 
-    for (auto& triangle : m_processed_triangles)
-        rasterize_triangle(triangle);
+    Threading::ThreadPool::the().parallel_for(
+        0, tile_count, [&](size_t tile_index) {
+            auto const& bin = m_tile_bins[tile_index];
+            if (bin.is_empty())
+                return;
+
+            Gfx::IntRect const tile_rect {
+                frame_rect.left() + static_cast<int>(tile_index % tile_columns) * RASTERIZER_TILE_SIZE,
+                frame_rect.top() + static_cast<int>(tile_index / tile_columns) * RASTERIZER_TILE_SIZE,
+                RASTERIZER_TILE_SIZE,
+                RASTERIZER_TILE_SIZE,
+            };
+            for (auto triangle_index : bin)
+                rasterize_triangle(m_processed_triangles[triangle_index], tile_rect);
+        },
+        1);
 }
 
 ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
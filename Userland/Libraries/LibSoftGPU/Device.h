@@ -90,7 +90,9 @@ private:
     void rasterize_point_antialiased(GPU::Vertex&);
     void rasterize_point(GPU::Vertex&);
 
-    void rasterize_triangle(Triangle&);
+    bool setup_triangle(Triangle&);
+    void rasterize_triangle(Triangle const&, Gfx::IntRect const& bounds);
+    void rasterize_triangles_in_tiles();
     void setup_blend_factors();
     void shade_fragments(PixelQuad&);
     void test_alpha(PixelQuad&);
@@ -101,6 +103,7 @@ private:
     Clipper m_clipper;
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
+    Vector<Vector<size_t>> m_tile_bins;
     Vector<GPU::Vertex> m_clipped_vertices;
     Array<Sampler, GPU::NUM_SAMPLERS> m_samplers;
     Vector<size_t> m_enabled_texture_units;
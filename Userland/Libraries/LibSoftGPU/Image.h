@@ -13,7 +13,7 @@
 #include <LibGPU/ImageDataLayout.h>
 #include <LibGfx/Vector3.h>
 #include <LibGfx/Vector4.h>
-#include <LibSoftGPU/Buffer/Typed3DBuffer.h>
+#include <LibSoftGPU/Buffer/Tiled3DBuffer.h>
 
 namespace SoftGPU {
 
@@ -59,7 +59,7 @@ private:
     unsigned m_num_levels { 0 };
     unsigned m_num_layers { 0 };
 
-    FixedArray<RefPtr<Typed3DBuffer<FloatVector4>>> m_mipmap_buffers;
+    FixedArray<RefPtr<Tiled3DBuffer<FloatVector4>>> m_mipmap_buffers;
 
     bool m_width_is_power_of_two { false };
     bool m_height_is_power_of_two { false };
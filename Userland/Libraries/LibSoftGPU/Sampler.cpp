@@ -18,6 +18,7 @@ using AK::SIMD::f32x4;
 using AK::SIMD::i32x4;
 using AK::SIMD::u32x4;
 
+using AK::SIMD::all;
 using AK::SIMD::clamp;
 using AK::SIMD::expand4;
 using AK::SIMD::floor_int_range;
@@ -140,12 +141,18 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv)
     auto max_level = expand4(image.num_levels() - 1.0f);
     auto level = min(max(log2_approximate(scale_factor) * 0.5f, min_level), max_level);
 
-    auto lower_level_texel = sample_2d_lod(uv, to_u32x4(level), m_config.texture_min_filter);
+    auto const lower_level = to_u32x4(level);
+    auto lower_level_texel = sample_2d_lod(uv, lower_level, m_config.texture_min_filter);
 
     if (m_config.mipmap_filter == GPU::MipMapFilter::Nearest)
         return lower_level_texel;
 
-    auto higher_level_texel = sample_2d_lod(uv, to_u32x4(min(level + 1.f, max_level)), m_config.texture_min_filter);
+    // Past the last level there is nothing to blend with, so we don't need to sample it twice
+    auto const higher_level = to_u32x4(min(level + 1.f, max_level));
+    if (all(higher_level == lower_level))
+        return lower_level_texel;
+
+    auto higher_level_texel = sample_2d_lod(uv, higher_level, m_config.texture_min_filter);
 
     return mix(lower_level_texel, higher_level_texel, frac_int_range(level));
 }
@@ -155,18 +162,26 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
     auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
     u32x4 const layer = expand4(0u);
 
-    u32x4 const width = {
-        image.level_width(level[0]),
-        image.level_width(level[1]),
-        image.level_width(level[2]),
-        image.level_width(level[3]),
-    };
-    u32x4 const height = {
-        image.level_height(level[0]),
-        image.level_height(level[1]),
-        image.level_height(level[2]),
-        image.level_height(level[3]),
-    };
+    // All four pixels of a quad usually sample the same level, in which case we only need to look up its size once
+    u32x4 width;
+    u32x4 height;
+    if (level[0] == level[1] && level[0] == level[2] && level[0] == level[3]) {
+        width = expand4(image.level_width(level[0]));
+        height = expand4(image.level_height(level[0]));
+    } else {
+        width = u32x4 {
+            image.level_width(level[0]),
+            image.level_width(level[1]),
+            image.level_width(level[2]),
+            image.level_width(level[3]),
+        };
+        height = u32x4 {
+            image.level_height(level[0]),
+            image.level_height(level[1]),
+            image.level_height(level[2]),
+            image.level_height(level[3]),
+        };
+    }
 
     u32x4 width_mask = width - 1;
     u32x4 height_mask = height - 1;
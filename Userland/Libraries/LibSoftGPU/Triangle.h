@@ -9,12 +9,18 @@
 #pragma once
 
 #include <LibGPU/Vertex.h>
+#include <LibGfx/Rect.h>
 #include <LibGfx/Vector2.h>
 
 namespace SoftGPU {
 
 struct Triangle {
     GPU::Vertex vertices[3];
+
+    // Filled in by Device::setup_triangle(), once the triangle has been culled and ordered counter-clockwise.
+    IntVector2 subpixel_coordinates[3];
+    i32 area { 0 };
+    Gfx::IntRect render_bounds;
 };
 
 }
@@ -94,6 +94,22 @@ enum class CipherSuite {
     AES_128_CCM_8_SHA256 = 0x1305,
 };
 
+// TLS 1.3 cipher suites only name the AEAD and the hash used by the key schedule,
+// and can't be negotiated with earlier versions (nor the other suites with TLS 1.3).
+constexpr bool is_tls13_cipher_suite(CipherSuite suite)
+{
+    switch (suite) {
+    case CipherSuite::AES_128_GCM_SHA256:
+    case CipherSuite::AES_256_GCM_SHA384:
+    case CipherSuite::CHACHA20_POLY1305_SHA256:
+    case CipherSuite::AES_128_CCM_SHA256:
+    case CipherSuite::AES_128_CCM_8_SHA256:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // Defined in RFC 5246 section 7.4.1.4.1
 enum class HashAlgorithm : u8 {
     None = 0,
@@ -103,6 +119,9 @@ enum class HashAlgorithm : u8 {
     SHA256 = 4,
     SHA384 = 5,
     SHA512 = 6,
+    // Defined in RFC 8446 section 4.2.3: the TLS 1.3 signature schemes that hash the message
+    // themselves (e.g. RSASSA-PSS) encode as this "hash" and one of the signatures below.
+    INTRINSIC = 8,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -111,6 +130,10 @@ enum class SignatureAlgorithm : u8 {
     RSA = 1,
     DSA = 2,
     ECDSA = 3,
+    // Defined in RFC 8446 section 4.2.3, always with HashAlgorithm::INTRINSIC.
+    RSA_PSS_RSAE_SHA256 = 4,
+    RSA_PSS_RSAE_SHA384 = 5,
+    RSA_PSS_RSAE_SHA512 = 6,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -170,6 +193,7 @@ enum class CipherAlgorithm {
     AES_128_CCM_8,
     AES_256_CBC,
     AES_256_GCM,
+    CHACHA20_POLY1305,
 };
 
 constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
@@ -182,6 +206,7 @@ constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
         return 128;
     case CipherAlgorithm::AES_256_CBC:
     case CipherAlgorithm::AES_256_GCM:
+    case CipherAlgorithm::CHACHA20_POLY1305:
         return 256;
     case CipherAlgorithm::Invalid:
     default:
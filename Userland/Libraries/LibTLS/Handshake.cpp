@@ -9,6 +9,7 @@
 #include <AK/Endian.h>
 #include <AK/Random.h>
 
+#include <LibCore/DateTime.h>
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
@@ -18,7 +19,51 @@ namespace TLS {
 
 ByteBuffer TLSv12::build_hello()
 {
-    fill_with_random(&m_context.local_random, 32);
+    // RFC 8446 section 4.1.2: The ClientHello sent in response to a HelloRetryRequest has to be the same as the first one,
+    //                         except for the key_share, cookie and pre_shared_key extensions.
+    bool is_retry = m_context.tls13.has_received_hello_retry_request;
+    bool can_resume_sessions = m_context.options.session_cache && !m_context.extensions.SNI.is_null();
+
+    bool offers_tls13 = m_context.options.max_version >= Version::V13 && !m_context.options.elliptic_curves.is_empty();
+    if (offers_tls13 && !m_context.tls13.key_share_curve)
+        offers_tls13 = generate_key_share(m_context.options.elliptic_curves.first());
+
+    if (!is_retry) {
+        fill_with_random(&m_context.local_random, 32);
+
+        // Offer to resume the last session with this host, if we still have it.
+        m_context.resumable_session = {};
+        if (can_resume_sessions)
+            m_context.resumable_session = m_context.options.session_cache->get(m_context.extensions.SNI);
+        if (m_context.resumable_session.has_value() && m_context.resumable_session->version == Version::V13 && !offers_tls13)
+            m_context.resumable_session = {};
+    }
+
+    // TLS 1.3 sessions are offered as a pre-shared key, which is all the server needs to recognize them.
+    bool offers_psk = m_context.resumable_session.has_value() && m_context.resumable_session->version == Version::V13;
+    m_context.tls13.is_psk_offered = offers_psk;
+    if (offers_psk && !is_retry) {
+        if (derive_early_secret(m_context.resumable_session->master_key).is_error()) {
+            dbgln("Failed to derive the early secret, not offering a pre-shared key");
+            offers_psk = false;
+            m_context.tls13.is_psk_offered = false;
+        }
+    }
+
+    if (!is_retry && m_context.resumable_session.has_value() && !offers_psk) {
+        auto& session = *m_context.resumable_session;
+        if (!session.ticket.is_empty()) {
+            // RFC 5077 section 3.4: "When presenting a ticket, the client MAY generate and include a Session ID in the TLS ClientHello.
+            //                        If the server accepts the ticket and the Session ID is not empty, then it MUST respond with the
+            //                        same Session ID present in the ClientHello."
+            // That's how we tell whether the ticket was accepted.
+            fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+            m_context.session_id_size = sizeof(m_context.session_id);
+        } else {
+            session.session_id.bytes().copy_to({ m_context.session_id, sizeof(m_context.session_id) });
+            m_context.session_id_size = session.session_id.size();
+        }
+    }
 
     auto packet_version = (u16)m_context.options.version;
     auto version = (u16)m_context.options.version;
@@ -58,9 +103,17 @@ ByteBuffer TLSv12::build_hello()
     }
 
     // Ciphers
-    builder.append((u16)(m_context.options.usable_cipher_suites.size() * sizeof(u16)));
-    for (auto suite : m_context.options.usable_cipher_suites)
-        builder.append((u16)suite);
+    auto should_offer_cipher_suite = [&](CipherSuite suite) { return offers_tls13 || !is_tls13_cipher_suite(suite); };
+    size_t cipher_suite_count = 0;
+    for (auto suite : m_context.options.usable_cipher_suites) {
+        if (should_offer_cipher_suite(suite))
+            ++cipher_suite_count;
+    }
+    builder.append((u16)(cipher_suite_count * sizeof(u16)));
+    for (auto suite : m_context.options.usable_cipher_suites) {
+        if (should_offer_cipher_suite(suite))
+            builder.append((u16)suite);
+    }
 
     // we don't like compression
     VERIFY(!m_context.options.use_compression);
@@ -86,6 +139,37 @@ ByteBuffer TLSv12::build_hello()
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
 
+    // session_ticket: 2b extension ID, 2b extension length, the ticket (if any)
+    size_t session_ticket_length = 0;
+    if (m_context.resumable_session.has_value() && !offers_psk)
+        session_ticket_length = m_context.resumable_session->ticket.size();
+    if (can_resume_sessions)
+        extension_length += 4 + session_ticket_length;
+
+    if (offers_tls13) {
+        // supported_versions: 2b extension ID, 2b extension length, 1b vector length, 2b each for TLS 1.3 and 1.2
+        extension_length += 4 + 1 + 2 * 2;
+        // key_share: 2b extension ID, 2b extension length, 2b vector length, 2b group, 2b key length, the key
+        extension_length += 4 + 2 + 2 + 2 + m_context.tls13.key_share_public_key.size();
+        // psk_key_exchange_modes: 2b extension ID, 2b extension length, 1b vector length, 1b mode
+        if (can_resume_sessions)
+            extension_length += 4 + 1 + 1;
+        // cookie: 2b extension ID, 2b extension length, 2b cookie length, the cookie
+        if (!m_context.tls13.cookie.is_empty())
+            extension_length += 4 + 2 + m_context.tls13.cookie.size();
+    }
+
+    // pre_shared_key: 2b extension ID, 2b extension length, 2b identities length, 2b ticket length, the ticket, 4b ticket age,
+    //                 2b binders length, 1b binder length, the binder
+    size_t binder_length = 0;
+    size_t binders_length = 0;
+    if (offers_psk) {
+        // NOTE: The binder is as long as the hash of the session's cipher suite, and so is the PSK itself.
+        binder_length = m_context.resumable_session->master_key.size();
+        binders_length = 2 + 1 + binder_length;
+        extension_length += 4 + 2 + 2 + m_context.resumable_session->ticket.size() + 4 + binders_length;
+    }
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -131,8 +215,87 @@ ByteBuffer TLSv12::build_hello()
     }
 
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension (RFC 7301)
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        // extension length
+        builder.append((u16)(alpn_length + 2));
+        // ProtocolNameList length
+        builder.append((u16)alpn_length);
+        auto append_protocol_name = [&](StringView name) {
+            builder.append((u8)name.length());
+            builder.append(name.bytes());
+        };
+        if (alpn_negotiated_length) {
+            append_protocol_name(m_context.negotiated_alpn);
+        } else {
+            for (auto& alpn : m_context.alpn)
+                append_protocol_name(alpn);
+        }
+    }
+
+    if (can_resume_sessions) {
+        // session_ticket extension (RFC 5077); an empty one asks the server for a new ticket.
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)session_ticket_length);
+        if (session_ticket_length)
+            builder.append(m_context.resumable_session->ticket.bytes());
+    }
+
+    if (offers_tls13) {
+        // supported_versions extension (RFC 8446 section 4.2.1)
+        builder.append((u16)HandshakeExtension::SupportedVersions);
+        builder.append((u16)(1 + 2 * 2));
+        builder.append((u8)(2 * 2));
+        builder.append((u16)Version::V13);
+        builder.append((u16)Version::V12);
+
+        // key_share extension (RFC 8446 section 4.2.8), with a single share for our preferred group
+        auto& public_key = m_context.tls13.key_share_public_key;
+        builder.append((u16)HandshakeExtension::KeyShare);
+        builder.append((u16)(2 + 2 + 2 + public_key.size()));
+        builder.append((u16)(2 + 2 + public_key.size()));
+        builder.append((u16)m_context.tls13.key_share_group);
+        builder.append((u16)public_key.size());
+        builder.append(public_key.bytes());
+
+        if (can_resume_sessions) {
+            // psk_key_exchange_modes extension (RFC 8446 section 4.2.9); without it, the server won't issue any tickets.
+            // We only do psk_dhe_ke, so that resumed sessions get forward secrecy as well.
+            builder.append((u16)HandshakeExtension::PskKeyExchangeModes);
+            builder.append((u16)2);
+            builder.append((u8)1);
+            builder.append((u8)1);
+        }
+
+        if (!m_context.tls13.cookie.is_empty()) {
+            // cookie extension (RFC 8446 section 4.2.2), echoed from the HelloRetryRequest
+            builder.append((u16)HandshakeExtension::Cookie);
+            builder.append((u16)(2 + m_context.tls13.cookie.size()));
+            builder.append((u16)m_context.tls13.cookie.size());
+            builder.append(m_context.tls13.cookie.bytes());
+        }
+    }
+
+    if (offers_psk) {
+        // pre_shared_key extension (RFC 8446 section 4.2.11), which has to be the last one.
+        auto& session = *m_context.resumable_session;
+        builder.append((u16)HandshakeExtension::PreSharedKey);
+        builder.append((u16)(2 + 2 + session.ticket.size() + 4 + binders_length));
+        builder.append((u16)(2 + session.ticket.size() + 4));
+        builder.append((u16)session.ticket.size());
+        builder.append(session.ticket.bytes());
+
+        // "For identities established externally [...]. For identities established via NewSessionTicket, the
+        //  obfuscated_ticket_age is the age of the ticket in milliseconds plus the ticket_age_add value modulo 2^32."
+        u32 ticket_age = (Core::DateTime::now().timestamp() - session.issue_time) * 1000;
+        u32 obfuscated_ticket_age = AK::convert_between_host_and_network_endian(ticket_age + session.ticket_age_add);
+        builder.append((u8 const*)&obfuscated_ticket_age, sizeof(obfuscated_ticket_age));
+
+        // The binder is filled in below, once the rest of the message is final.
+        builder.append((u16)(1 + binder_length));
+        builder.append((u8)binder_length);
+        for (size_t i = 0; i < binder_length; ++i)
+            builder.append((u8)0);
     }
 
     // set the "length" field of the packet
@@ -145,6 +308,20 @@ ByteBuffer TLSv12::build_hello()
     builder.set(payload_position + 2, remaining);
 
     auto packet = builder.build();
+
+    if (offers_psk) {
+        // RFC 8446 section 4.2.11.2: The binder covers the ClientHello "up to and including the PreSharedKeyExtension.identities field".
+        constexpr size_t header_size = 5;
+        auto binders_offset = packet.size() - binders_length;
+        auto binder = compute_psk_binder(packet.bytes().slice(header_size, binders_offset - header_size));
+        if (binder.is_error()) {
+            dbgln("Failed to compute the PSK binder: {}", binder.error());
+            return {};
+        }
+        VERIFY(binder.value().size() == binder_length);
+        packet.overwrite(binders_offset + 3, binder.value().data(), binder_length);
+    }
+
     update_packet(packet);
 
     return packet;
@@ -165,6 +342,21 @@ ByteBuffer TLSv12::build_handshake_finished()
     PacketBuilder builder { MessageType::Handshake, m_context.options.version, 12 + 64 };
     builder.append((u8)HandshakeType::Finished);
 
+    if (is_tls13()) {
+        auto hash = transcript_hash();
+        if (hash.is_error())
+            return {};
+        auto verify_data = compute_finished_verify_data(hmac_hash(), m_context.tls13.client_traffic_secret, hash.value());
+        if (verify_data.is_error())
+            return {};
+
+        builder.append_u24(verify_data.value().size());
+        builder.append(verify_data.value().bytes());
+        auto packet = builder.build();
+        update_packet(packet);
+        return packet;
+    }
+
     // RFC 5246 section 7.4.9: "In previous versions of TLS, the verify_data was always 12 octets
     //                          long.  In the current version of TLS, it depends on the cipher
     //                          suite.  Any cipher suite which does not explicitly specify
@@ -178,7 +370,8 @@ ByteBuffer TLSv12::build_handshake_finished()
     auto outbuffer = Bytes { out, verify_data_length };
     ByteBuffer dummy;
 
-    auto digest = m_context.handshake_hash.digest();
+    // NOTE: This only peeks at the hash, as the server's Finished message needs it to go on with our own.
+    auto digest = m_context.handshake_hash.peek();
     auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
     pseudorandom_function(outbuffer, m_context.master_key, (u8 const*)"client finished", 15, hashbuf, dummy);
 
@@ -216,8 +409,151 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         return (i8)Error::NeedMoreData;
     }
 
-    // TODO: Compare Hashes
-    dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+    if (is_tls13()) {
+        // RFC 8446 section 4.4.4: "Recipients of Finished messages MUST verify that the contents are correct and if
+        //                          incorrect MUST terminate the connection with a "decrypt_error" alert."
+        auto hash = transcript_hash();
+        if (hash.is_error())
+            return (i8)Error::OutOfMemory;
+        auto expected_verify_data = compute_finished_verify_data(hmac_hash(), m_context.tls13.server_traffic_secret, hash.value());
+        if (expected_verify_data.is_error())
+            return (i8)Error::OutOfMemory;
+        if (buffer.slice(index, size) != expected_verify_data.value().bytes()) {
+            dbgln("Server's finished message does not match the handshake");
+            return (i8)Error::NotSafe;
+        }
+
+        // Our own flight (and switching to the application traffic keys) has to account for this message.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    // RFC 5246 section 7.4.9: "verify_data
+    //                              PRF(master_secret, finished_label, Hash(handshake_messages))
+    //                                 [0..verify_data_length-1];"
+    // NOTE: The handshake hash doesn't include this message yet, which is just what we need here.
+    constexpr u32 verify_data_length = 12;
+    u8 expected_verify_data[verify_data_length];
+    auto digest = m_context.handshake_hash.peek();
+    pseudorandom_function(
+        { expected_verify_data, verify_data_length },
+        m_context.master_key,
+        (u8 const*)"server finished", 15,
+        ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() },
+        {});
+    if (buffer.slice(index, verify_data_length) != ReadonlyBytes { expected_verify_data, verify_data_length }) {
+        dbgln("Server's finished message does not match the handshake");
+        return (i8)Error::NotVerified;
+    }
+
+    if (m_context.is_resuming_session) {
+        // An abbreviated handshake ends with our own ChangeCipherSpec and Finished, which have to account for this message.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    store_session_for_resumption();
+    did_establish_connection();
+
+    return index + size;
+}
+
+bool TLSv12::finish_tls13_handshake()
+{
+    // RFC 8446 section 4.4: The server's Finished completes its flight, and anything after it is under the application traffic keys.
+    auto client_application_traffic_secret = derive_application_secrets();
+    if (client_application_traffic_secret.is_error()) {
+        dbgln("Failed to derive the application traffic secrets: {}", client_application_traffic_secret.error());
+        return false;
+    }
+
+    if (m_context.tls13.has_received_certificate_request) {
+        dbgln_if(TLS_DEBUG, "> Client Certificate");
+        auto packet = build_certificate();
+        write_packet(packet);
+    }
+
+    {
+        dbgln_if(TLS_DEBUG, "> client finished");
+        auto packet = build_handshake_finished();
+        if (packet.is_empty())
+            return false;
+        write_packet(packet);
+    }
+
+    if (derive_resumption_master_secret().is_error())
+        return false;
+
+    m_context.tls13.client_traffic_secret = client_application_traffic_secret.release_value();
+    if (install_traffic_keys(m_context.tls13.client_traffic_secret, true).is_error())
+        return false;
+
+    // Only the traffic secrets (for key updates) and the resumption secret (for tickets) are needed from here on.
+    m_context.tls13.early_secret.clear();
+    m_context.tls13.handshake_secret.clear();
+    m_context.tls13.master_secret.clear();
+    m_context.tls13.hello_retry_transcript.clear();
+
+    did_establish_connection();
+    return true;
+}
+
+ssize_t TLSv12::handle_post_handshake_payload(ReadonlyBytes vbuffer)
+{
+    auto buffer = vbuffer;
+    while (buffer.size() >= 4 && !m_context.critical_error) {
+        auto type = buffer[0];
+        size_t payload_size = buffer[1] * 0x10000 + buffer[2] * 0x100 + buffer[3] + 3;
+        if (payload_size + 1 > buffer.size())
+            return (i8)Error::NeedMoreData;
+
+        ssize_t payload_res = 0;
+        switch (type) {
+        case NewSessionTicket:
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            payload_res = handle_tls13_new_session_ticket(buffer.slice(1, payload_size));
+            break;
+        case KeyUpdate:
+            dbgln_if(TLS_DEBUG, "key update");
+            payload_res = handle_key_update(buffer.slice(1, payload_size));
+            break;
+        default:
+            // NOTE: We don't offer post_handshake_auth, so a CertificateRequest is just as unexpected as anything else.
+            dbgln("unexpected post-handshake message type {}", type);
+            payload_res = (i8)Error::UnexpectedMessage;
+            break;
+        }
+
+        if (payload_res < 0) {
+            AlertDescription description;
+            switch ((Error)payload_res) {
+            case Error::NeedMoreData:
+                return payload_res;
+            case Error::UnexpectedMessage:
+                description = AlertDescription::UnexpectedMessage;
+                break;
+            case Error::BrokenPacket:
+                description = AlertDescription::DecodeError;
+                break;
+            case Error::IllegalParameter:
+                description = AlertDescription::IllegalParameter;
+                break;
+            default:
+                description = AlertDescription::InternalError;
+                break;
+            }
+            auto packet = build_alert(true, (u8)description);
+            write_packet(packet);
+            return payload_res;
+        }
+
+        buffer = buffer.slice(payload_size + 1);
+    }
+    return vbuffer.size();
+}
+
+void TLSv12::did_establish_connection()
+{
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -229,12 +565,49 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     if (on_connected)
         on_connected();
+}
 
-    return index + size;
+void TLSv12::store_session_for_resumption()
+{
+    auto& cache = m_context.options.session_cache;
+    if (!cache || m_context.extensions.SNI.is_null())
+        return;
+
+    // A resumed session stays as it was, unless the server handed out a new ticket for it.
+    if (m_context.is_resuming_session && m_context.session_ticket.is_empty())
+        return;
+
+    // Without either, the server has no way of recognizing the session later.
+    if (m_context.session_ticket.is_empty() && m_context.session_id_size == 0)
+        return;
+
+    auto session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    if (session_id.is_error() || master_key.is_error())
+        return;
+
+    auto lifetime = SessionCache::default_lifetime_in_seconds;
+    // RFC 5077 section 3.3: "A ticket lifetime value of zero indicates that the lifetime of the ticket is unspecified."
+    if (!m_context.session_ticket.is_empty() && m_context.session_ticket_lifetime_hint != 0)
+        lifetime = min<time_t>(m_context.session_ticket_lifetime_hint, SessionCache::max_lifetime_in_seconds);
+
+    dbgln_if(TLS_DEBUG, "Storing session for {} (ticket: {} bytes, lifetime: {}s)", m_context.extensions.SNI, m_context.session_ticket.size(), lifetime);
+    cache->set(m_context.extensions.SNI,
+        CachedSession {
+            .session_id = session_id.release_value(),
+            .ticket = move(m_context.session_ticket),
+            .master_key = master_key.release_value(),
+            .cipher = m_context.cipher,
+            .expiry_time = Core::DateTime::now().timestamp() + lifetime,
+        });
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
 {
+    // TLS 1.3 has no renegotiation, but it does have messages of its own after the handshake.
+    if (m_context.connection_status == ConnectionStatus::Established && is_tls13())
+        return handle_post_handshake_payload(vbuffer);
+
     if (m_context.connection_status == ConnectionStatus::Established) {
         dbgln_if(TLS_DEBUG, "Renegotiation attempt ignored");
         // FIXME: We should properly say "NoRenegotiation", but that causes a handshake failure
@@ -299,6 +672,34 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case NewSessionTicket:
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (is_tls13()) {
+                // TLS 1.3 tickets are only sent after the handshake.
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
+                dbgln("unsupported: server mode");
+                VERIFY_NOT_REACHED();
+            } else {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            }
+            break;
+        case EncryptedExtensions:
+            if (m_context.handshake_messages[12] >= 1 || !is_tls13()) {
+                dbgln("unexpected encrypted extensions message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[12];
+            dbgln_if(TLS_DEBUG, "encrypted extensions");
+            payload_res = handle_encrypted_extensions(buffer.slice(1, payload_size));
+            break;
         case CertificateMessage:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -312,7 +713,10 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                     dbgln("unsupported: server mode");
                     VERIFY_NOT_REACHED();
                 }
-                payload_res = handle_certificate(buffer.slice(1, payload_size));
+                if (is_tls13())
+                    payload_res = handle_tls13_certificate(buffer.slice(1, payload_size));
+                else
+                    payload_res = handle_certificate(buffer.slice(1, payload_size));
             } else {
                 payload_res = (i8)Error::UnexpectedMessage;
             }
@@ -325,7 +729,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[5];
             dbgln_if(TLS_DEBUG, "server key exchange");
-            if (m_context.is_server) {
+            if (is_tls13()) {
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -339,7 +745,13 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 break;
             }
             ++m_context.handshake_messages[6];
-            if (m_context.is_server) {
+            if (is_tls13()) {
+                dbgln("certificate request");
+                if (m_context.connection_status == ConnectionStatus::Negotiating)
+                    payload_res = handle_tls13_certificate_request(buffer.slice(1, payload_size));
+                else
+                    payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("invalid request");
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
@@ -359,7 +771,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[7];
             dbgln_if(TLS_DEBUG, "server hello done");
-            if (m_context.is_server) {
+            if (is_tls13()) {
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -376,7 +790,12 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[8];
             dbgln_if(TLS_DEBUG, "certificate verify");
-            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+            if (is_tls13()) {
+                if (m_context.connection_status == ConnectionStatus::Negotiating)
+                    payload_res = handle_server_certificate_verify(buffer.slice(1, payload_size));
+                else
+                    payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.connection_status == ConnectionStatus::KeyExchange) {
                 payload_res = handle_certificate_verify(buffer.slice(1, payload_size));
             } else {
                 payload_res = (i8)Error::UnexpectedMessage;
@@ -420,6 +839,13 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             update_hash(buffer.slice(0, payload_size + 1), 0);
         }
 
+        // TLS 1.3 handshake traffic keys come from the transcript up to and including the ServerHello,
+        // and protect everything after it.
+        if (type == ServerHello && payload_res >= 0 && is_tls13() && write_packets != WritePacketStage::RetriedClientHello) {
+            if (derive_handshake_secrets().is_error())
+                payload_res = (i8)Error::OutOfMemory;
+        }
+
         // if something went wrong, send an alert about it
         if (payload_res < 0) {
             switch ((Error)payload_res) {
@@ -479,6 +905,16 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
                 break;
             }
+            case Error::IllegalParameter: {
+                auto packet = build_alert(true, (u8)AlertDescription::IllegalParameter);
+                write_packet(packet);
+                break;
+            }
+            case Error::MissingExtension: {
+                auto packet = build_alert(true, (u8)AlertDescription::MissingExtension);
+                write_packet(packet);
+                break;
+            }
             case Error::NeedMoreData:
                 // Ignore this, as it's not an "error"
                 dbgln_if(TLS_DEBUG, "More data needed");
@@ -526,7 +962,21 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("UNSUPPORTED: Server mode");
             VERIFY_NOT_REACHED();
             break;
+        case WritePacketStage::RetriedClientHello: {
+            dbgln_if(TLS_DEBUG, "> client hello (retry)");
+            auto packet = build_hello();
+            write_packet(packet);
+            break;
+        }
         case WritePacketStage::Finished:
+            if (is_tls13()) {
+                if (!finish_tls13_handshake()) {
+                    auto packet = build_alert(true, (u8)AlertDescription::InternalError);
+                    write_packet(packet);
+                    return (i8)Error::OutOfMemory;
+                }
+                break;
+            }
             // finished
             {
                 dbgln_if(TLS_DEBUG, "> change cipher spec");
@@ -538,7 +988,8 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 auto packet = build_handshake_finished();
                 write_packet(packet);
             }
-            m_context.connection_status = ConnectionStatus::Established;
+            store_session_for_resumption();
+            did_establish_connection();
             break;
         }
         payload_size++;
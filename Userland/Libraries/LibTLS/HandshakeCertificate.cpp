@@ -102,6 +102,163 @@ ssize_t TLSv12::handle_certificate(ReadonlyBytes buffer)
     return res;
 }
 
+ssize_t TLSv12::handle_tls13_certificate(ReadonlyBytes buffer)
+{
+    // RFC 8446 section 4.4.2:
+    // struct {
+    //     opaque cert_data<1..2^24-1>;
+    //     Extension extensions<0..2^16-1>;
+    // } CertificateEntry;
+    //
+    // struct {
+    //     opaque certificate_request_context<0..2^8-1>;
+    //     CertificateEntry certificate_list<0..2^24-1>;
+    // } Certificate;
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+    if (size < 4)
+        return (i8)Error::BrokenPacket;
+
+    size_t res = 3;
+    // "In the case of server authentication, this field SHALL be zero length."
+    if (buffer[res++] != 0)
+        return (i8)Error::IllegalParameter;
+
+    size_t certificate_list_length = buffer[res] * 0x10000 + buffer[res + 1] * 0x100 + buffer[res + 2];
+    res += 3;
+    if (certificate_list_length != size - 4)
+        return (i8)Error::BrokenPacket;
+
+    size_t end = res + certificate_list_length;
+    while (res < end) {
+        if (end - res < 3)
+            return (i8)Error::BrokenPacket;
+        size_t certificate_length = buffer[res] * 0x10000 + buffer[res + 1] * 0x100 + buffer[res + 2];
+        res += 3;
+        if (end - res < certificate_length + 2)
+            return (i8)Error::BrokenPacket;
+
+        auto certificate = Certificate::parse_asn1(buffer.slice(res, certificate_length), false);
+        if (certificate.has_value()) {
+            m_context.certificates.append(certificate.release_value());
+        } else if (m_context.certificates.is_empty()) {
+            // Everything hinges on the server's own certificate, which comes first.
+            dbgln("Failed to parse the server's certificate");
+            return (i8)Error::UnsupportedCertificate;
+        }
+        res += certificate_length;
+
+        // NOTE: The extensions are for OCSP stapling and certificate transparency, neither of which we do.
+        u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+        res += 2;
+        if (end - res < extensions_length)
+            return (i8)Error::BrokenPacket;
+        res += extensions_length;
+    }
+
+    if (m_context.certificates.is_empty())
+        return (i8)Error::UnsupportedCertificate;
+
+    return res;
+}
+
+ssize_t TLSv12::handle_tls13_certificate_request(ReadonlyBytes buffer)
+{
+    // RFC 8446 section 4.3.2:
+    // struct {
+    //     opaque certificate_request_context<0..2^8-1>;
+    //     Extension extensions<2..2^16-1>;
+    // } CertificateRequest;
+    if (buffer.size() < 4)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    u8 context_length = buffer[3];
+    if (size < 1u + context_length)
+        return (i8)Error::BrokenPacket;
+
+    auto context = ByteBuffer::copy(buffer.slice(4, context_length));
+    if (context.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.tls13.certificate_request_context = context.release_value();
+    m_context.tls13.has_received_certificate_request = true;
+
+    // NOTE: The extensions say which certificates would be acceptable, but we'll decline anyway, see build_certificate().
+    return 3 + size;
+}
+
+ssize_t TLSv12::handle_server_certificate_verify(ReadonlyBytes buffer)
+{
+    // RFC 8446 section 4.4.3:
+    // struct {
+    //     SignatureScheme algorithm;
+    //     opaque signature<0..2^16-1>;
+    // } CertificateVerify;
+    if (m_context.certificates.is_empty()) {
+        dbgln("unexpected certificate verify message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    if (buffer.size() < 7)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    SignatureAndHashAlgorithm algorithm { (HashAlgorithm)buffer[3], (SignatureAlgorithm)buffer[4] };
+    u16 signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(5)));
+    if (size != 4u + signature_length)
+        return (i8)Error::BrokenPacket;
+
+    // "RSA signatures MUST use an RSASSA-PSS algorithm, regardless of whether RSASSA-PKCS1-v1_5 algorithms appear in "signature_algorithms"."
+    if (algorithm.hash != HashAlgorithm::INTRINSIC) {
+        dbgln("Server signed its CertificateVerify with a TLS 1.2 signature algorithm");
+        return (i8)Error::IllegalParameter;
+    }
+
+    if (!m_context.verify_chain(m_context.extensions.SNI)) {
+        dbgln("certificate verification failed :(");
+        return (i8)Error::BadCertificate;
+    }
+
+    // "The digital signature is then computed over the concatenation of:
+    //  -  A string that consists of octet 32 (0x20) repeated 64 times
+    //  -  The context string
+    //  -  A single 0 byte which serves as the separator
+    //  -  The content to be signed"
+    // with the content being the transcript hash up to, but not including, this message.
+    constexpr auto context_string = "TLS 1.3, server CertificateVerify"sv;
+    auto hash = transcript_hash();
+    if (hash.is_error())
+        return (i8)Error::OutOfMemory;
+
+    u8 padding[64];
+    memset(padding, 0x20, sizeof(padding));
+    u8 separator = 0;
+    ByteBuffer content;
+    if (content.try_append(padding, sizeof(padding)).is_error()
+        || content.try_append(context_string.bytes()).is_error()
+        || content.try_append(&separator, 1).is_error()
+        || content.try_append(hash.value()).is_error()) {
+        return (i8)Error::OutOfMemory;
+    }
+
+    auto result = verify_rsa_signature(algorithm, content, buffer.slice(7, signature_length));
+    if (result < 0)
+        return result;
+
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    return 3 + size;
+}
+
 ssize_t TLSv12::handle_certificate_verify(ReadonlyBytes)
 {
     dbgln("FIXME: parse_verify");
@@ -10,6 +10,9 @@
 #include <AK/Random.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/Curves/SECP256r1.h>
+#include <LibCrypto/Curves/X25519.h>
+#include <LibCrypto/Curves/X448.h>
 #include <LibCrypto/NumberTheory/ModularFunctions.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibTLS/TLSv12.h>
@@ -307,10 +310,59 @@ void TLSv12::build_ecdhe_rsa_pre_master_secret(PacketBuilder& builder)
     builder.append(public_key);
 }
 
+bool TLSv12::generate_key_share(NamedCurve group)
+{
+    OwnPtr<Crypto::Curves::EllipticCurve> curve;
+    switch (group) {
+    case NamedCurve::x25519:
+        curve = make<Crypto::Curves::X25519>();
+        break;
+    case NamedCurve::x448:
+        curve = make<Crypto::Curves::X448>();
+        break;
+    case NamedCurve::secp256r1:
+        curve = make<Crypto::Curves::SECP256r1>();
+        break;
+    default:
+        dbgln("Can't generate a key share for unsupported group {}", (u16)group);
+        return false;
+    }
+
+    auto private_key = curve->generate_private_key();
+    if (private_key.is_error())
+        return false;
+    auto public_key = curve->generate_public_key(private_key.value());
+    if (public_key.is_error())
+        return false;
+
+    m_context.tls13.key_share_group = group;
+    m_context.tls13.key_share_curve = move(curve);
+    m_context.tls13.key_share_private_key = private_key.release_value();
+    m_context.tls13.key_share_public_key = public_key.release_value();
+    return true;
+}
+
 ByteBuffer TLSv12::build_certificate()
 {
     PacketBuilder builder { MessageType::Handshake, m_context.options.version };
 
+    if (is_tls13()) {
+        // FIXME: We can't sign a CertificateVerify yet, so all we can do is to decline with an empty Certificate message.
+        //        struct {
+        //            opaque certificate_request_context<0..2^8-1>;
+        //            CertificateEntry certificate_list<0..2^24-1>;
+        //        } Certificate;
+        auto& context = m_context.tls13.certificate_request_context;
+        builder.append((u8)HandshakeType::CertificateMessage);
+        builder.append_u24(1 + context.size() + 3);
+        builder.append((u8)context.size());
+        builder.append(context.bytes());
+        builder.append_u24(0);
+        auto packet = builder.build();
+        update_packet(packet);
+        return packet;
+    }
+
     Vector<Certificate const&> certificates;
     Vector<Certificate>* local_certificates = nullptr;
 
@@ -360,6 +412,17 @@ ByteBuffer TLSv12::build_certificate()
     return packet;
 }
 
+ByteBuffer TLSv12::build_key_update(bool request_update)
+{
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version };
+    builder.append((u8)HandshakeType::KeyUpdate);
+    builder.append_u24(1);
+    builder.append((u8)request_update);
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
 ByteBuffer TLSv12::build_client_key_exchange()
 {
     bool chain_verified = m_context.verify_chain(m_context.extensions.SNI);
@@ -9,6 +9,7 @@
 #include <AK/Endian.h>
 #include <AK/Random.h>
 
+#include <LibCore/DateTime.h>
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/Curves/EllipticCurve.h>
@@ -21,10 +22,24 @@
 
 namespace TLS {
 
+// RFC 8446 section 4.1.3: "For reasons of backward compatibility with middleboxes [...] the HelloRetryRequest message uses
+//                          the same structure as the ServerHello, but with Random set to the special value of the SHA-256 of
+//                          "HelloRetryRequest""
+static constexpr u8 hello_retry_request_random[32] = {
+    0xCF, 0x21, 0xAD, 0x74, 0xE5, 0x9A, 0x61, 0x11, 0xBE, 0x1D, 0x8C, 0x02, 0x1E, 0x65, 0xB8, 0x91,
+    0xC2, 0xA2, 0x11, 0x16, 0x7A, 0xBB, 0x8C, 0x5E, 0x07, 0x9E, 0x09, 0xE2, 0xC8, 0xA8, 0x33, 0x9C
+};
+
+// RFC 8446 section 4.1.3: A TLS 1.3 server negotiating TLS 1.2 ends its random with these bytes, which a client offering
+//                         TLS 1.3 MUST treat as an attempted downgrade.
+static constexpr u8 tls12_downgrade_sentinel[8] = { 'D', 'O', 'W', 'N', 'G', 'R', 'D', 0x01 };
+
 ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& write_packets)
 {
     write_packets = WritePacketStage::Initial;
-    if (m_context.connection_status != ConnectionStatus::Disconnected && m_context.connection_status != ConnectionStatus::Renegotiating) {
+    // After a HelloRetryRequest, we're still negotiating when the real ServerHello arrives.
+    auto is_after_hello_retry_request = m_context.tls13.has_received_hello_retry_request && m_context.connection_status == ConnectionStatus::Negotiating;
+    if (m_context.connection_status != ConnectionStatus::Disconnected && m_context.connection_status != ConnectionStatus::Renegotiating && !is_after_hello_retry_request) {
         dbgln("unexpected hello message");
         return (i8)Error::UnexpectedMessage;
     }
@@ -54,6 +69,7 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
 
     memcpy(m_context.remote_random, buffer.offset_pointer(res), sizeof(m_context.remote_random));
     res += sizeof(m_context.remote_random);
+    bool is_hello_retry_request = memcmp(m_context.remote_random, hello_retry_request_random, sizeof(hello_retry_request_random)) == 0;
 
     u8 session_length = buffer[res++];
     if (buffer.size() - res < session_length) {
@@ -61,6 +77,17 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: "If the ClientHello.session_id was non-empty, the server will look in its session cache
+    //                            for a match.  If a match is found and the server is willing to establish the new connection
+    //                            using the specified session state, the server will respond with the same value as was
+    //                            supplied by the client."
+    // NOTE: TLS 1.3 servers always echo it, so this only says something about resumption with TLS 1.2.
+    bool echoes_session_id = session_length == m_context.session_id_size
+        && memcmp(m_context.session_id, buffer.offset_pointer(res), session_length) == 0;
+    bool is_resuming_session = m_context.resumable_session.has_value()
+        && session_length != 0
+        && echoes_session_id;
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -84,11 +111,14 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
+    auto previous_cipher = m_context.cipher;
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
     // Simplification: We only support handshake hash functions via HMAC
-    m_context.handshake_hash.initialize(hmac_hash());
+    // NOTE: After a HelloRetryRequest, the hash is already going.
+    if (!m_context.tls13.has_received_hello_retry_request)
+        m_context.handshake_hash.initialize(hmac_hash());
 
     // Compression method
     if (buffer.size() - res < 1)
@@ -104,6 +134,11 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         write_packets = WritePacketStage::ServerHandshake;
     }
 
+    Optional<u16> key_share_group;
+    ReadonlyBytes key_share_key;
+    Optional<u16> selected_identity;
+    ReadonlyBytes cookie;
+
     // Presence of extensions is determined by availability of bytes after compression_method
     if (buffer.size() - res >= 2) {
         auto extensions_bytes_total = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res += 2)));
@@ -150,27 +185,7 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 dbgln("SNI host_name: {}", m_context.extensions.SNI);
             }
         } else if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size()) {
-            if (buffer.size() - res > 2) {
-                auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
-                    u8 const* alpn = buffer.offset_pointer(res + 2);
-                    size_t alpn_position = 0;
-                    while (alpn_position < alpn_length) {
-                        u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
-                            break;
-                        String alpn_str { (char const*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
-                            break;
-                        }
-                        alpn_position += alpn_length;
-                        if (!m_context.is_server) // server hello must contain one ALPN
-                            break;
-                    }
-                }
-            }
+            handle_alpn_extension(buffer.slice(res, extension_length));
             res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
@@ -187,15 +202,422 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
             // uncompressed points. Therefore, this extension can be safely ignored as it should always inform us
             // that the server supports uncompressed points.
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: The server announces a NewSessionTicket message with an empty extension, there's nothing to read.
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::SupportedVersions) {
+            // RFC 8446 section 4.2.1: "[...] the server MUST NOT send the "supported_versions" extension" unless it negotiates TLS 1.3.
+            if (extension_length != 2)
+                return (i8)Error::BrokenPacket;
+            auto selected_version = static_cast<Version>(AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res))));
+            if (selected_version != Version::V13 || !supports_version(selected_version) || !m_context.tls13.key_share_curve) {
+                dbgln("Server selected a version we didn't offer: {:04x}", (u16)selected_version);
+                return (i8)Error::IllegalParameter;
+            }
+            m_context.negotiated_version = Version::V13;
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::KeyShare) {
+            // A HelloRetryRequest only names the group it wants, the ServerHello comes with the server's share.
+            if (extension_length < 2)
+                return (i8)Error::BrokenPacket;
+            key_share_group = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+            if (!is_hello_retry_request) {
+                if (extension_length < 4)
+                    return (i8)Error::BrokenPacket;
+                u16 key_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res + 2)));
+                if (extension_length != 4 + key_length)
+                    return (i8)Error::BrokenPacket;
+                key_share_key = buffer.slice(res + 4, key_length);
+            }
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::PreSharedKey) {
+            if (extension_length != 2)
+                return (i8)Error::BrokenPacket;
+            selected_identity = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::Cookie) {
+            if (extension_length < 2)
+                return (i8)Error::BrokenPacket;
+            u16 cookie_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+            if (cookie_length == 0 || extension_length != 2 + cookie_length)
+                return (i8)Error::BrokenPacket;
+            cookie = buffer.slice(res + 2, cookie_length);
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", (u16)extension_type, extension_length);
             res += extension_length;
         }
     }
 
+    if (is_tls13()) {
+        if (!is_tls13_cipher_suite(cipher)) {
+            dbgln("Server selected a TLS 1.2 cipher suite for TLS 1.3");
+            return (i8)Error::IllegalParameter;
+        }
+
+        // RFC 8446 section 4.1.3: "A client which receives a legacy_session_id_echo field that does not match what it sent
+        //                          in the ClientHello MUST abort the handshake with an "illegal_parameter" alert."
+        if (!echoes_session_id)
+            return (i8)Error::IllegalParameter;
+
+        if (is_hello_retry_request) {
+            auto retry_group = key_share_group.has_value() ? Optional<NamedCurve>((NamedCurve)*key_share_group) : Optional<NamedCurve> {};
+            auto result = handle_hello_retry_request(buffer.slice(0, 3 + following_bytes), retry_group, cookie, write_packets);
+            if (result < 0)
+                return result;
+            return res;
+        }
+
+        if (m_context.tls13.has_received_hello_retry_request && cipher != previous_cipher) {
+            dbgln("Server changed its mind about the cipher suite after a HelloRetryRequest");
+            return (i8)Error::IllegalParameter;
+        }
+
+        // We only do (EC)DHE, with or without a pre-shared key, so there has to be a key share.
+        if (!key_share_group.has_value())
+            return (i8)Error::MissingExtension;
+        if (*key_share_group != (u16)m_context.tls13.key_share_group) {
+            dbgln("Server's key share is for a group we didn't offer a share for: {}", *key_share_group);
+            return (i8)Error::IllegalParameter;
+        }
+
+        auto& curve = *m_context.tls13.key_share_curve;
+        if (key_share_key.size() != curve.key_size())
+            return (i8)Error::IllegalParameter;
+        auto shared_point = curve.compute_coordinate(m_context.tls13.key_share_private_key, key_share_key);
+        if (shared_point.is_error())
+            return (i8)Error::IllegalParameter;
+        auto shared_secret = curve.derive_premaster_key(shared_point.value());
+        if (shared_secret.is_error())
+            return (i8)Error::IllegalParameter;
+        m_context.tls13.shared_secret = shared_secret.release_value();
+        m_context.tls13.key_share_private_key.clear();
+
+        if (selected_identity.has_value()) {
+            // We only ever offer one identity, and the PSK is tied to the hash of the session's cipher suite
+            // (whose length is that of the PSK itself).
+            if (!m_context.tls13.is_psk_offered || *selected_identity != 0 || m_context.resumable_session->master_key.size() != mac_length()) {
+                dbgln("Server selected a pre-shared key we can't use");
+                return (i8)Error::IllegalParameter;
+            }
+            dbgln_if(TLS_DEBUG, "Resuming session with a pre-shared key");
+            m_context.is_resuming_session = true;
+        } else if (derive_early_secret({}).is_error()) {
+            return (i8)Error::OutOfMemory;
+        }
+
+        // The handshake traffic keys are derived once this message is part of the transcript, see handle_handshake_payload().
+        return res;
+    }
+
+    // RFC 8446 section 4.1.3: "TLS 1.3 clients receiving a ServerHello indicating TLS 1.2 or below MUST check that the
+    //                          last 8 bytes are not equal to either of these values."
+    if (m_context.tls13.key_share_curve && memcmp(m_context.remote_random + 24, tls12_downgrade_sentinel, sizeof(tls12_downgrade_sentinel)) == 0) {
+        dbgln("Server supports TLS 1.3, but negotiated TLS 1.2 with us");
+        return (i8)Error::IllegalParameter;
+    }
+
+    if (is_tls13_cipher_suite(cipher)) {
+        dbgln("Server selected a TLS 1.3 cipher suite for TLS 1.2");
+        return (i8)Error::IllegalParameter;
+    }
+
+    if (is_resuming_session && cipher != m_context.resumable_session->cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        return (i8)Error::NotSafe;
+    }
+
+    if (is_resuming_session) {
+        // The server goes straight to ChangeCipherSpec and Finished, with keys derived from the session's master secret.
+        dbgln_if(TLS_DEBUG, "Resuming session");
+        auto master_key = ByteBuffer::copy(m_context.resumable_session->master_key);
+        if (master_key.is_error())
+            return (i8)Error::OutOfMemory;
+        m_context.master_key = master_key.release_value();
+        if (!expand_key())
+            return (i8)Error::NotUnderstood;
+        m_context.is_resuming_session = true;
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    }
+
+    return res;
+}
+
+void TLSv12::handle_alpn_extension(ReadonlyBytes extension)
+{
+    if (extension.size() <= 2)
+        return;
+
+    auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(extension.data()));
+    if (!alpn_length || alpn_length > extension.size() - 2)
+        return;
+
+    u8 const* alpn = extension.offset_pointer(2);
+    size_t alpn_position = 0;
+    while (alpn_position < alpn_length) {
+        u8 alpn_size = alpn[alpn_position++];
+        if (alpn_size + alpn_position > alpn_length)
+            break;
+        String alpn_str { (char const*)alpn + alpn_position, alpn_size };
+        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
+            m_context.negotiated_alpn = alpn_str;
+            dbgln_if(TLS_DEBUG, "negotiated alpn: {}", alpn_str);
+            break;
+        }
+        alpn_position += alpn_size;
+        if (!m_context.is_server) // server hello must contain one ALPN
+            break;
+    }
+}
+
+ssize_t TLSv12::handle_hello_retry_request(ReadonlyBytes hello_retry_request, Optional<NamedCurve> selected_group, ReadonlyBytes cookie, WritePacketStage& write_packets)
+{
+    // RFC 8446 section 4.1.4: "If a client receives a second HelloRetryRequest in the same connection [...],
+    //                          it MUST abort the handshake with an "unexpected_message" alert."
+    if (m_context.tls13.has_received_hello_retry_request)
+        return (i8)Error::UnexpectedMessage;
+
+    // "Clients MUST abort the handshake with an "illegal_parameter" alert if the HelloRetryRequest would not result in any change in the ClientHello."
+    if (!selected_group.has_value() && cookie.is_empty())
+        return (i8)Error::IllegalParameter;
+
+    if (selected_group.has_value()) {
+        // "[...] the selected_group field [...] MUST correspond to a group which was provided in the "supported_groups"
+        //  extension in the original ClientHello and [...] MUST NOT correspond to a group which was provided in the
+        //  "key_share" extension in the original ClientHello."
+        if (!m_context.options.elliptic_curves.contains_slow(*selected_group) || *selected_group == m_context.tls13.key_share_group)
+            return (i8)Error::IllegalParameter;
+        if (!generate_key_share(*selected_group))
+            return (i8)Error::IllegalParameter;
+    }
+
+    if (!cookie.is_empty()) {
+        auto cookie_copy = ByteBuffer::copy(cookie);
+        if (cookie_copy.is_error())
+            return (i8)Error::OutOfMemory;
+        m_context.tls13.cookie = cookie_copy.release_value();
+    }
+
+    // RFC 8446 section 4.4.1: "When the server responds to a ClientHello with a HelloRetryRequest, the value of ClientHello1
+    //                          is replaced with a special synthetic handshake message of handshake type "message_hash"
+    //                          containing Hash(ClientHello1)."
+    // NOTE: The ClientHello is still waiting in the hash's buffer, as we didn't know which hash to use when we sent it.
+    m_context.handshake_hash.update(ReadonlyBytes {});
+    auto client_hello_digest = m_context.handshake_hash.digest();
+    auto digest_size = m_context.handshake_hash.digest_size();
+
+    u8 message_hash_header[4] = { HandshakeType::MessageHash, 0, 0, (u8)digest_size };
+    u8 server_hello_type = HandshakeType::ServerHello;
+    ByteBuffer transcript;
+    if (transcript.try_append(message_hash_header, sizeof(message_hash_header)).is_error()
+        || transcript.try_append(client_hello_digest.immutable_data(), digest_size).is_error()) {
+        return (i8)Error::OutOfMemory;
+    }
+    m_context.handshake_hash.update(transcript);
+
+    // The PSK binder in the next ClientHello covers this whole exchange, the HelloRetryRequest itself gets hashed along with every other message.
+    if (transcript.try_append(&server_hello_type, 1).is_error() || transcript.try_append(hello_retry_request).is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.tls13.hello_retry_transcript = move(transcript);
+
+    dbgln_if(TLS_DEBUG, "HelloRetryRequest for group {}", selected_group.has_value() ? (u16)*selected_group : 0);
+    m_context.tls13.has_received_hello_retry_request = true;
+
+    // Expect another ServerHello for our second ClientHello.
+    m_context.handshake_messages[2] = 0;
+    write_packets = WritePacketStage::RetriedClientHello;
+    return hello_retry_request.size();
+}
+
+ssize_t TLSv12::handle_encrypted_extensions(ReadonlyBytes buffer)
+{
+    // struct {
+    //     Extension extensions<0..2^16-1>;
+    // } EncryptedExtensions;
+    if (m_context.connection_status != ConnectionStatus::Negotiating) {
+        dbgln("unexpected encrypted extensions message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    if (buffer.size() < 5)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(3)));
+    if (size != 2u + extensions_length)
+        return (i8)Error::BrokenPacket;
+
+    size_t res = 5;
+    size_t end = 3 + size;
+    while (res < end) {
+        if (end - res < 4)
+            return (i8)Error::BrokenPacket;
+        auto extension_type = (HandshakeExtension)AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+        u16 extension_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res + 2)));
+        res += 4;
+        if (end - res < extension_length)
+            return (i8)Error::BrokenPacket;
+
+        dbgln_if(TLS_DEBUG, "Encrypted extension {} with length {}", (u16)extension_type, extension_length);
+
+        // NOTE: Everything else in here (e.g. an empty server_name, or the server's supported_groups) is informational.
+        if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size())
+            handle_alpn_extension(buffer.slice(res, extension_length));
+
+        res += extension_length;
+    }
+
+    // With a pre-shared key, the server goes straight to its Finished message.
+    if (m_context.is_resuming_session)
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+
+    return res;
+}
+
+ssize_t TLSv12::handle_tls13_new_session_ticket(ReadonlyBytes buffer)
+{
+    // struct {
+    //     uint32 ticket_lifetime;
+    //     uint32 ticket_age_add;
+    //     opaque ticket_nonce<0..255>;
+    //     opaque ticket<1..2^16-1>;
+    //     Extension extensions<0..2^16-2>;
+    // } NewSessionTicket;
+    if (buffer.size() < 12)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    size_t end = 3 + size;
+    size_t res = 3;
+    if (end - res < 9)
+        return (i8)Error::BrokenPacket;
+    u32 lifetime = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(res)));
+    u32 age_add = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(res + 4)));
+    u8 nonce_length = buffer[res + 8];
+    res += 9;
+    if (end - res < nonce_length + 2u)
+        return (i8)Error::BrokenPacket;
+    auto nonce = buffer.slice(res, nonce_length);
+    res += nonce_length;
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+    res += 2;
+    if (ticket_length == 0 || end - res < ticket_length + 2u)
+        return (i8)Error::BrokenPacket;
+    auto ticket = buffer.slice(res, ticket_length);
+    res += ticket_length;
+    u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+    res += 2;
+    if (end - res != extensions_length)
+        return (i8)Error::BrokenPacket;
+    // NOTE: The only extension defined for this is early_data, which we don't do.
+    res += extensions_length;
+
+    auto& cache = m_context.options.session_cache;
+    // "The value of zero indicates that the ticket should be discarded immediately."
+    if (!cache || m_context.extensions.SNI.is_null() || lifetime == 0)
+        return res;
+
+    // "The PSK associated with the ticket is computed as:
+    //      HKDF-Expand-Label(resumption_master_secret, "resumption", ticket_nonce, Hash.length)"
+    auto psk = hkdf_expand_label(hmac_hash(), m_context.tls13.resumption_master_secret, "resumption"sv, nonce, mac_length());
+    auto ticket_copy = ByteBuffer::copy(ticket);
+    if (psk.is_error() || ticket_copy.is_error())
+        return (i8)Error::OutOfMemory;
+
+    auto now = Core::DateTime::now().timestamp();
+    auto lifetime_in_seconds = min<time_t>(lifetime, SessionCache::max_lifetime_in_seconds);
+    dbgln_if(TLS_DEBUG, "Storing TLS 1.3 session for {} (ticket: {} bytes, lifetime: {}s)", m_context.extensions.SNI, ticket_length, lifetime_in_seconds);
+    // NOTE: Servers may send several tickets, and we only keep the latest one.
+    cache->set(m_context.extensions.SNI,
+        CachedSession {
+            .ticket = ticket_copy.release_value(),
+            .master_key = psk.release_value(),
+            .cipher = m_context.cipher,
+            .expiry_time = now + lifetime_in_seconds,
+            .version = Version::V13,
+            .ticket_age_add = age_add,
+            .issue_time = now,
+        });
+
     return res;
 }
 
+ssize_t TLSv12::handle_key_update(ReadonlyBytes buffer)
+{
+    // enum { update_not_requested(0), update_requested(1), (255) } KeyUpdateRequest;
+    // struct {
+    //     KeyUpdateRequest request_update;
+    // } KeyUpdate;
+    if (buffer.size() < 4)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (size != 1)
+        return (i8)Error::BrokenPacket;
+
+    auto request_update = buffer[3];
+    if (request_update > 1)
+        return (i8)Error::IllegalParameter;
+
+    if (update_traffic_secret(false).is_error())
+        return (i8)Error::OutOfMemory;
+
+    if (request_update) {
+        // RFC 8446 section 4.6.3: "If the request_update field is set to "update_requested", then the receiver MUST send a
+        //                          KeyUpdate of its own with request_update set to "update_not_requested" prior to sending
+        //                          its next Application Data record."
+        auto packet = build_key_update(false);
+        write_packet(packet);
+        if (update_traffic_secret(true).is_error())
+            return (i8)Error::OutOfMemory;
+    }
+
+    return 3 + size;
+}
+
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // RFC 5077 section 3.3: "This message is sent by the server during the TLS handshake before the ChangeCipherSpec message."
+    if (m_context.connection_status != ConnectionStatus::KeyExchange) {
+        dbgln("unexpected new session ticket message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    // struct {
+    //     uint32 ticket_lifetime_hint;
+    //     opaque ticket<0..2^16-1>;
+    // } NewSessionTicket;
+    if (buffer.size() < 9)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (size < 6u + ticket_length) {
+        dbgln("new session ticket message too short for its ticket: {} < {}", size, 6 + ticket_length);
+        return (i8)Error::BrokenPacket;
+    }
+
+    // NOTE: An empty ticket means the server changed its mind about giving us one.
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.session_ticket = ticket.release_value();
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+
+    return 3 + size;
+}
+
 ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
 {
     if (buffer.size() < 3)
@@ -345,18 +767,30 @@ ssize_t TLSv12::handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes buffer)
 
 ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer)
 {
-    auto signature_hash = signature_buffer[0];
-    auto signature_algorithm = signature_buffer[1];
-    if (signature_algorithm != (u8)SignatureAlgorithm::RSA) {
-        dbgln("verify_rsa_server_key_exchange failed: Signature algorithm is not RSA, instead {}", signature_algorithm);
-        return (i8)Error::NotUnderstood;
-    }
+    if (signature_buffer.size() < 4)
+        return (i8)Error::NeedMoreData;
 
+    SignatureAndHashAlgorithm algorithm { (HashAlgorithm)signature_buffer[0], (SignatureAlgorithm)signature_buffer[1] };
     auto signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(signature_buffer.offset_pointer(2)));
     auto signature = signature_buffer.slice(4, signature_length);
 
+    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
+    if (message_result.is_error()) {
+        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        return (i8)Error::OutOfMemory;
+    }
+    auto message = message_result.release_value();
+    message.overwrite(0, m_context.local_random, 32);
+    message.overwrite(32, m_context.remote_random, 32);
+    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+
+    return verify_rsa_signature(algorithm, message, signature);
+}
+
+ssize_t TLSv12::verify_rsa_signature(SignatureAndHashAlgorithm algorithm, ReadonlyBytes message, ReadonlyBytes signature)
+{
     if (m_context.certificates.is_empty()) {
-        dbgln("verify_rsa_server_key_exchange failed: Attempting to verify signature without certificates");
+        dbgln("verify_rsa_signature failed: Attempting to verify signature without certificates");
         return (i8)Error::NotSafe;
     }
     // RFC5246 section 7.4.2: The sender's certificate MUST come first in the list.
@@ -364,49 +798,69 @@ ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buf
     Crypto::PK::RSAPrivateKey dummy_private_key;
     auto rsa = Crypto::PK::RSA(certificate_public_key, dummy_private_key);
 
-    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature_length);
+    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature.size());
     if (signature_verify_buffer_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        dbgln("verify_rsa_signature failed: Not enough memory");
         return (i8)Error::OutOfMemory;
     }
     auto signature_verify_buffer = signature_verify_buffer_result.release_value();
     auto signature_verify_bytes = signature_verify_buffer.bytes();
     rsa.verify(signature, signature_verify_bytes);
 
-    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
-    if (message_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
-        return (i8)Error::OutOfMemory;
-    }
-    auto message = message_result.release_value();
-    message.overwrite(0, m_context.local_random, 32);
-    message.overwrite(32, m_context.remote_random, 32);
-    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+    auto verification = Crypto::VerificationConsistency::Inconsistent;
+    if (algorithm.signature == SignatureAlgorithm::RSA) {
+        Crypto::Hash::HashKind hash_kind;
+        switch (algorithm.hash) {
+        case HashAlgorithm::SHA1:
+            hash_kind = Crypto::Hash::HashKind::SHA1;
+            break;
+        case HashAlgorithm::SHA256:
+            hash_kind = Crypto::Hash::HashKind::SHA256;
+            break;
+        case HashAlgorithm::SHA384:
+            hash_kind = Crypto::Hash::HashKind::SHA384;
+            break;
+        case HashAlgorithm::SHA512:
+            hash_kind = Crypto::Hash::HashKind::SHA512;
+            break;
+        default:
+            dbgln("verify_rsa_signature failed: Hash algorithm is not SHA1/256/384/512, instead {}", (u8)algorithm.hash);
+            return (i8)Error::NotUnderstood;
+        }
 
-    Crypto::Hash::HashKind hash_kind;
-    switch ((HashAlgorithm)signature_hash) {
-    case HashAlgorithm::SHA1:
-        hash_kind = Crypto::Hash::HashKind::SHA1;
-        break;
-    case HashAlgorithm::SHA256:
-        hash_kind = Crypto::Hash::HashKind::SHA256;
-        break;
-    case HashAlgorithm::SHA384:
-        hash_kind = Crypto::Hash::HashKind::SHA384;
-        break;
-    case HashAlgorithm::SHA512:
-        hash_kind = Crypto::Hash::HashKind::SHA512;
-        break;
-    default:
-        dbgln("verify_rsa_server_key_exchange failed: Hash algorithm is not SHA1/256/384/512, instead {}", signature_hash);
+        auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
+        verification = pkcs1.verify(message, signature_verify_bytes, signature.size() * 8);
+    } else if (algorithm.hash == HashAlgorithm::INTRINSIC) {
+        // RFC 8446 section 4.2.3: "The length of the Salt MUST be equal to the length of the output of the digest algorithm."
+        // RFC 8017 section 8.1.2: "EMSA-PSS-VERIFY (M', EM, modBits - 1)"
+        auto em_bits = certificate_public_key.modulus().one_based_index_of_highest_set_bit() - 1;
+        switch (algorithm.signature) {
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA256: {
+            Crypto::PK::EMSA_PSS<Crypto::Hash::SHA256, Crypto::Hash::SHA256::DigestSize> pss;
+            verification = pss.verify(message, signature_verify_bytes, em_bits);
+            break;
+        }
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA384: {
+            Crypto::PK::EMSA_PSS<Crypto::Hash::SHA384, Crypto::Hash::SHA384::DigestSize> pss;
+            verification = pss.verify(message, signature_verify_bytes, em_bits);
+            break;
+        }
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA512: {
+            Crypto::PK::EMSA_PSS<Crypto::Hash::SHA512, Crypto::Hash::SHA512::DigestSize> pss;
+            verification = pss.verify(message, signature_verify_bytes, em_bits);
+            break;
+        }
+        default:
+            dbgln("verify_rsa_signature failed: Signature scheme is not RSA-PSS, instead {}", (u8)algorithm.signature);
+            return (i8)Error::NotUnderstood;
+        }
+    } else {
+        dbgln("verify_rsa_signature failed: Signature algorithm is not RSA, instead {}", (u8)algorithm.signature);
         return (i8)Error::NotUnderstood;
     }
 
-    auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
-    auto verification = pkcs1.verify(message, signature_verify_bytes, signature_length * 8);
-
     if (verification == Crypto::VerificationConsistency::Inconsistent) {
-        dbgln("verify_rsa_server_key_exchange failed: Verification of signature inconsistent");
+        dbgln("verify_rsa_signature failed: Verification of signature inconsistent");
         return (i8)Error::NotSafe;
     }
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <LibCrypto/Hash/HKDF.h>
+#include <LibTLS/TLSv12.h>
+
+// The TLS 1.3 key schedule, as described in RFC 8446 section 7.
+
+namespace TLS {
+
+static Crypto::Hash::HashKind hash_kind_for_cipher_suite(CipherSuite suite)
+{
+    if (suite == CipherSuite::AES_256_GCM_SHA384)
+        return Crypto::Hash::HashKind::SHA384;
+    return Crypto::Hash::HashKind::SHA256;
+}
+
+static ErrorOr<ByteBuffer> hash_of_empty_string(Crypto::Hash::HashKind kind)
+{
+    Crypto::Hash::Manager hash { kind };
+    auto digest = hash.digest();
+    return ByteBuffer::copy(digest.immutable_data(), hash.digest_size());
+}
+
+static void log_secret(ReadonlyBytes client_random, StringView label, ReadonlyBytes secret)
+{
+    if constexpr (TLS_SSL_KEYLOG_DEBUG) {
+        auto file = MUST(Core::Stream::File::open("/home/anon/ssl_keylog"sv, Core::Stream::OpenMode::Append | Core::Stream::OpenMode::Write));
+        VERIFY(file->write_or_error(label.bytes()));
+        VERIFY(file->write_or_error(" "sv.bytes()));
+        VERIFY(file->write_or_error(encode_hex(client_random).bytes()));
+        VERIFY(file->write_or_error(" "sv.bytes()));
+        VERIFY(file->write_or_error(encode_hex(secret).bytes()));
+        VERIFY(file->write_or_error("\n"sv.bytes()));
+    }
+}
+
+ErrorOr<ByteBuffer> TLSv12::hkdf_expand_label(Crypto::Hash::HashKind kind, ReadonlyBytes secret, StringView label, ReadonlyBytes context, size_t length) const
+{
+    // struct {
+    //     uint16 length = Length;
+    //     opaque label<7..255> = "tls13 " + Label;
+    //     opaque context<0..255> = Context;
+    // } HkdfLabel;
+    constexpr auto label_prefix = "tls13 "sv;
+    VERIFY(label_prefix.length() + label.length() <= 255 && context.size() <= 255);
+
+    u16 network_length = AK::convert_between_host_and_network_endian((u16)length);
+    u8 label_length = label_prefix.length() + label.length();
+    u8 context_length = context.size();
+
+    ByteBuffer hkdf_label;
+    TRY(hkdf_label.try_append(&network_length, sizeof(network_length)));
+    TRY(hkdf_label.try_append(&label_length, sizeof(label_length)));
+    TRY(hkdf_label.try_append(label_prefix.bytes()));
+    TRY(hkdf_label.try_append(label.bytes()));
+    TRY(hkdf_label.try_append(&context_length, sizeof(context_length)));
+    TRY(hkdf_label.try_append(context));
+
+    Crypto::Hash::HKDF<Crypto::Hash::Manager> hkdf { kind };
+    return hkdf.expand(secret, hkdf_label, length);
+}
+
+ErrorOr<ByteBuffer> TLSv12::derive_secret(Crypto::Hash::HashKind kind, ReadonlyBytes secret, StringView label, ReadonlyBytes transcript_hash) const
+{
+    return hkdf_expand_label(kind, secret, label, transcript_hash, transcript_hash.size());
+}
+
+ErrorOr<ByteBuffer> TLSv12::compute_finished_verify_data(Crypto::Hash::HashKind kind, ReadonlyBytes base_key, ReadonlyBytes transcript_hash) const
+{
+    // RFC 8446 section 4.4.4: "finished_key = HKDF-Expand-Label(BaseKey, "finished", "", Hash.length)
+    //                          verify_data = HMAC(finished_key, Transcript-Hash(Handshake Context, Certificate*, CertificateVerify*))"
+    auto finished_key = TRY(hkdf_expand_label(kind, base_key, "finished"sv, {}, transcript_hash.size()));
+    Crypto::Authentication::HMAC<Crypto::Hash::Manager> hmac { finished_key.bytes(), kind };
+    auto digest = hmac.process(transcript_hash);
+    return ByteBuffer::copy(digest.immutable_data(), hmac.digest_size());
+}
+
+ErrorOr<ByteBuffer> TLSv12::transcript_hash()
+{
+    auto digest = m_context.handshake_hash.peek();
+    return ByteBuffer::copy(digest.immutable_data(), m_context.handshake_hash.digest_size());
+}
+
+ErrorOr<void> TLSv12::derive_early_secret(ReadonlyBytes psk)
+{
+    // The PSK belongs to the session we offer, so its hash is already known before the ServerHello.
+    auto cipher = psk.is_empty() ? m_context.cipher : m_context.resumable_session->cipher;
+    auto kind = hash_kind_for_cipher_suite(cipher);
+    Crypto::Hash::HKDF<Crypto::Hash::Manager> hkdf { kind };
+
+    // "If a given secret is not available, then the 0-value consisting of a string of Hash.length bytes set to zeros is used."
+    ByteBuffer zeros;
+    if (psk.is_empty()) {
+        zeros = TRY(ByteBuffer::create_zeroed(hkdf.digest_size()));
+        psk = zeros;
+    }
+
+    m_context.tls13.early_secret = TRY(hkdf.extract({}, psk));
+    return {};
+}
+
+ErrorOr<ByteBuffer> TLSv12::compute_psk_binder(ReadonlyBytes truncated_client_hello)
+{
+    // RFC 8446 section 4.2.11.2: The binder is computed like a Finished message, with the binder key as its base key,
+    //                            over the transcript up to the truncated ClientHello (including a HelloRetryRequest exchange).
+    auto kind = hash_kind_for_cipher_suite(m_context.resumable_session->cipher);
+    auto binder_key = TRY(derive_secret(kind, m_context.tls13.early_secret, "res binder"sv, TRY(hash_of_empty_string(kind))));
+
+    Crypto::Hash::Manager transcript { kind };
+    transcript.update(m_context.tls13.hello_retry_transcript);
+    transcript.update(truncated_client_hello);
+    auto digest = transcript.digest();
+
+    return compute_finished_verify_data(kind, binder_key, { digest.immutable_data(), transcript.digest_size() });
+}
+
+ErrorOr<void> TLSv12::derive_handshake_secrets()
+{
+    auto kind = hmac_hash();
+    Crypto::Hash::HKDF<Crypto::Hash::Manager> hkdf { kind };
+
+    auto derived_secret = TRY(derive_secret(kind, m_context.tls13.early_secret, "derived"sv, TRY(hash_of_empty_string(kind))));
+    m_context.tls13.handshake_secret = TRY(hkdf.extract(derived_secret, m_context.tls13.shared_secret));
+    m_context.tls13.shared_secret.clear();
+
+    auto hash = TRY(transcript_hash());
+    m_context.tls13.client_traffic_secret = TRY(derive_secret(kind, m_context.tls13.handshake_secret, "c hs traffic"sv, hash));
+    m_context.tls13.server_traffic_secret = TRY(derive_secret(kind, m_context.tls13.handshake_secret, "s hs traffic"sv, hash));
+
+    log_secret({ m_context.local_random, sizeof(m_context.local_random) }, "CLIENT_HANDSHAKE_TRAFFIC_SECRET"sv, m_context.tls13.client_traffic_secret);
+    log_secret({ m_context.local_random, sizeof(m_context.local_random) }, "SERVER_HANDSHAKE_TRAFFIC_SECRET"sv, m_context.tls13.server_traffic_secret);
+
+    // Everything after the ServerHello is encrypted, in both directions.
+    TRY(install_traffic_keys(m_context.tls13.client_traffic_secret, true));
+    TRY(install_traffic_keys(m_context.tls13.server_traffic_secret, false));
+    m_context.cipher_spec_set = 1;
+
+    return {};
+}
+
+ErrorOr<ByteBuffer> TLSv12::derive_application_secrets()
+{
+    auto kind = hmac_hash();
+    Crypto::Hash::HKDF<Crypto::Hash::Manager> hkdf { kind };
+
+    auto derived_secret = TRY(derive_secret(kind, m_context.tls13.handshake_secret, "derived"sv, TRY(hash_of_empty_string(kind))));
+    auto zeros = TRY(ByteBuffer::create_zeroed(hkdf.digest_size()));
+    m_context.tls13.master_secret = TRY(hkdf.extract(derived_secret, zeros));
+
+    auto hash = TRY(transcript_hash());
+    auto client_secret = TRY(derive_secret(kind, m_context.tls13.master_secret, "c ap traffic"sv, hash));
+    m_context.tls13.server_traffic_secret = TRY(derive_secret(kind, m_context.tls13.master_secret, "s ap traffic"sv, hash));
+
+    log_secret({ m_context.local_random, sizeof(m_context.local_random) }, "CLIENT_TRAFFIC_SECRET_0"sv, client_secret);
+    log_secret({ m_context.local_random, sizeof(m_context.local_random) }, "SERVER_TRAFFIC_SECRET_0"sv, m_context.tls13.server_traffic_secret);
+
+    // The server may send application data right after its Finished, but ours still goes out with the handshake keys.
+    TRY(install_traffic_keys(m_context.tls13.server_traffic_secret, false));
+    return client_secret;
+}
+
+ErrorOr<void> TLSv12::derive_resumption_master_secret()
+{
+    auto hash = TRY(transcript_hash());
+    m_context.tls13.resumption_master_secret = TRY(derive_secret(hmac_hash(), m_context.tls13.master_secret, "res master"sv, hash));
+    return {};
+}
+
+ErrorOr<void> TLSv12::install_traffic_keys(ReadonlyBytes secret, bool local)
+{
+    // RFC 8446 section 7.3: "[sender]_write_key = HKDF-Expand-Label(Secret, "key", "", key_length)
+    //                        [sender]_write_iv  = HKDF-Expand-Label(Secret, "iv", "", iv_length)"
+    auto kind = hmac_hash();
+    auto key = TRY(hkdf_expand_label(kind, secret, "key"sv, {}, key_length()));
+    auto iv = TRY(hkdf_expand_label(kind, secret, "iv"sv, {}, iv_length()));
+    iv.bytes().copy_to({ local ? m_context.crypto.local_aead_iv : m_context.crypto.remote_aead_iv, sizeof(m_context.crypto.local_aead_iv) });
+
+    auto intent = local ? Crypto::Cipher::Intent::Encryption : Crypto::Cipher::Intent::Decryption;
+    auto& cipher = local ? m_cipher_local : m_cipher_remote;
+    switch (get_cipher_algorithm(m_context.cipher)) {
+    case CipherAlgorithm::AES_128_GCM:
+    case CipherAlgorithm::AES_256_GCM:
+        cipher = Crypto::Cipher::AESCipher::GCMMode(key, key.size() * 8, intent, Crypto::Cipher::PaddingMode::RFC5246);
+        break;
+    case CipherAlgorithm::CHACHA20_POLY1305:
+        cipher = Crypto::Cipher::ChaCha20Poly1305(key);
+        break;
+    default:
+        dbgln("Requested unknown AEAD cipher");
+        VERIFY_NOT_REACHED();
+    }
+
+    // "[...] the sequence number is set to zero at the beginning of a connection and whenever the key is changed"
+    if (local)
+        m_context.local_sequence_number = 0;
+    else
+        m_context.remote_sequence_number = 0;
+    m_context.crypto.created = 1;
+
+    return {};
+}
+
+ErrorOr<void> TLSv12::update_traffic_secret(bool local)
+{
+    // RFC 8446 section 7.2: "application_traffic_secret_N+1 = HKDF-Expand-Label(application_traffic_secret_N, "traffic upd", "", Hash.length)"
+    auto& secret = local ? m_context.tls13.client_traffic_secret : m_context.tls13.server_traffic_secret;
+    secret = TRY(hkdf_expand_label(hmac_hash(), secret, "traffic upd"sv, {}, secret.size()));
+    return install_traffic_keys(secret, local);
+}
+
+}
@@ -76,7 +76,9 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 update_hash(packet.bytes(), header_size);
             }
         }
-        if (m_context.cipher_spec_set && m_context.crypto.created) {
+        if (m_context.cipher_spec_set && m_context.crypto.created && is_tls13()) {
+            encrypt_tls13_record(packet);
+        } else if (m_context.cipher_spec_set && m_context.crypto.created) {
             size_t length = packet.size() - header_size;
             size_t block_size = 0;
             size_t padding = 0;
@@ -90,6 +92,7 @@ void TLSv12::update_packet(ByteBuffer& packet)
                     padding = 0;
                     mac_size = 0; // AEAD provides its own authentication scheme.
                 },
+                [&](Crypto::Cipher::ChaCha20Poly1305&) { VERIFY_NOT_REACHED(); },
                 [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                     VERIFY(!is_aead());
                     block_size = cbc.cipher().block_size();
@@ -175,6 +178,7 @@ void TLSv12::update_packet(ByteBuffer& packet)
 
                         VERIFY(header_size + 8 + length + 16 == ct.size());
                     },
+                    [&](Crypto::Cipher::ChaCha20Poly1305&) { VERIFY_NOT_REACHED(); },
                     [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                         VERIFY(!is_aead());
                         // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
@@ -233,6 +237,132 @@ void TLSv12::update_packet(ByteBuffer& packet)
     ++m_context.local_sequence_number;
 }
 
+// RFC 8446 section 5.3: "The per-record nonce for the AEAD construction is formed as follows:
+//                       1.  The 64-bit record sequence number is encoded in network byte order and padded to the left with
+//                           zeros to iv_length.
+//                       2.  The padded sequence number is XORed with either the static client_write_iv or server_write_iv"
+static void compute_tls13_nonce(u8 const (&iv)[12], u64 sequence_number, Bytes nonce)
+{
+    VERIFY(nonce.size() >= 12);
+    memcpy(nonce.data(), iv, 12);
+    for (size_t i = 0; i < 8; ++i)
+        nonce[11 - i] ^= (sequence_number >> (i * 8)) & 0xff;
+}
+
+void TLSv12::encrypt_tls13_record(ByteBuffer& packet)
+{
+    // RFC 8446 section 5.2:
+    // struct {
+    //     opaque content[TLSPlaintext.length];
+    //     ContentType type;
+    //     uint8 zeros[length_of_padding];
+    // } TLSInnerPlaintext;
+    //
+    // struct {
+    //     ContentType opaque_type = application_data; /* 23 */
+    //     ProtocolVersion legacy_record_version = 0x0303; /* TLS v1.2 */
+    //     uint16 length;
+    //     opaque encrypted_record[TLSCiphertext.length];
+    // } TLSCiphertext;
+    constexpr size_t header_size = 5;
+    constexpr size_t tag_size = 16;
+    size_t length = packet.size() - header_size;
+
+    auto plaintext_result = ByteBuffer::create_uninitialized(length + 1);
+    auto ct_result = ByteBuffer::create_uninitialized(header_size + length + 1 + tag_size);
+    if (plaintext_result.is_error() || ct_result.is_error()) {
+        dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+        VERIFY_NOT_REACHED();
+    }
+    auto plaintext = plaintext_result.release_value();
+    auto ct = ct_result.release_value();
+
+    plaintext.overwrite(0, packet.offset_pointer(header_size), length);
+    plaintext[length] = packet[0];
+
+    ct[0] = (u8)MessageType::ApplicationData;
+    ct[1] = packet[1];
+    ct[2] = packet[2];
+    ByteReader::store(ct.offset_pointer(3), AK::convert_between_host_and_network_endian((u16)(length + 1 + tag_size)));
+
+    // "additional_data = TLSCiphertext.opaque_type || TLSCiphertext.legacy_record_version || TLSCiphertext.length"
+    auto aad = ct.bytes().slice(0, header_size);
+    auto ciphertext = ct.bytes().slice(header_size, length + 1);
+    auto tag = ct.bytes().slice(header_size + length + 1, tag_size);
+
+    // NOTE: Our GCM implementation takes a 16 byte IV, with the counter in the last 4 bytes.
+    u8 nonce[16] {};
+    compute_tls13_nonce(m_context.crypto.local_aead_iv, m_context.local_sequence_number, { nonce, sizeof(nonce) });
+
+    m_cipher_local.visit(
+        [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
+            gcm.encrypt(plaintext, ciphertext, { nonce, sizeof(nonce) }, aad, tag);
+        },
+        [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+            chacha.encrypt(plaintext, ciphertext, { nonce, 12 }, aad, tag);
+        },
+        [&](auto&) { VERIFY_NOT_REACHED(); });
+
+    packet = move(ct);
+}
+
+ssize_t TLSv12::decrypt_tls13_record(ReadonlyBytes record, ByteBuffer& decrypted, MessageType& type)
+{
+    constexpr size_t header_size = 5;
+    constexpr size_t tag_size = 16;
+    if (record.size() < header_size + 1 + tag_size) {
+        dbgln("Invalid packet length");
+        auto packet = build_alert(true, (u8)AlertDescription::DecodeError);
+        write_packet(packet);
+        return (i8)Error::BrokenPacket;
+    }
+
+    auto aad = record.slice(0, header_size);
+    auto ciphertext = record.slice(header_size, record.size() - header_size - tag_size);
+    auto tag = record.slice(record.size() - tag_size);
+
+    auto decrypted_result = ByteBuffer::create_uninitialized(ciphertext.size());
+    if (decrypted_result.is_error()) {
+        dbgln("Failed to allocate memory for the packet");
+        return (i8)Error::DecryptionFailed;
+    }
+    decrypted = decrypted_result.release_value();
+
+    u8 nonce[16] {};
+    compute_tls13_nonce(m_context.crypto.remote_aead_iv, m_context.remote_sequence_number, { nonce, sizeof(nonce) });
+
+    auto consistency = m_cipher_remote.visit(
+        [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
+            return gcm.decrypt(ciphertext, decrypted, { nonce, sizeof(nonce) }, aad, tag);
+        },
+        [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+            return chacha.decrypt(ciphertext, decrypted, { nonce, 12 }, aad, tag);
+        },
+        [&](auto&) -> Crypto::VerificationConsistency { VERIFY_NOT_REACHED(); });
+
+    if (consistency != Crypto::VerificationConsistency::Consistent) {
+        dbgln("integrity check failed (tag length {})", tag.size());
+        auto packet = build_alert(true, (u8)AlertDescription::BadRecordMAC);
+        write_packet(packet);
+        return (i8)Error::IntegrityCheckFailed;
+    }
+
+    // The real content type is the last non-zero byte, followed by any padding.
+    size_t content_length = decrypted.size();
+    while (content_length > 0 && decrypted[content_length - 1] == 0)
+        --content_length;
+    if (content_length == 0) {
+        dbgln("Record without a content type");
+        auto packet = build_alert(true, (u8)AlertDescription::UnexpectedMessage);
+        write_packet(packet);
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    type = (MessageType)decrypted[content_length - 1];
+    decrypted.resize(content_length - 1);
+    return 0;
+}
+
 void TLSv12::update_hash(ReadonlyBytes message, size_t header_size)
 {
     dbgln_if(TLS_DEBUG, "Update hash with message of size {}", message.size());
@@ -346,7 +476,32 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
     ByteBuffer decrypted;
 
-    if (m_context.cipher_spec_set && type != MessageType::ChangeCipher) {
+    if (is_tls13() && type == MessageType::ChangeCipher && m_context.connection_status != ConnectionStatus::Established) {
+        // RFC 8446 section 5: "An implementation may receive an unencrypted record of type change_cipher_spec consisting of
+        //                      the single byte value 0x01 at any time after the first ClientHello message has been sent or
+        //                      received and before the peer's Finished message has been received and MUST simply drop it
+        //                      without further processing."
+        // NOTE: It doesn't count towards the sequence number either, as it's not protected.
+        return header_size + length;
+    }
+
+    if (m_context.cipher_spec_set && is_tls13() && type == MessageType::ApplicationData) {
+        if constexpr (TLS_DEBUG) {
+            dbgln("Encrypted: ");
+            print_buffer(buffer.slice(header_size, length));
+        }
+
+        auto result = decrypt_tls13_record(buffer.slice(0, header_size + length), decrypted, type);
+        if (result < 0)
+            return result;
+        plain = decrypted;
+    } else if (m_context.cipher_spec_set && is_tls13() && type != MessageType::Alert) {
+        // Only an alert about our own records not making sense could reasonably come unprotected.
+        dbgln("unexpected unprotected record of type {}", (u8)type);
+        auto packet = build_alert(true, (u8)AlertDescription::UnexpectedMessage);
+        write_packet(packet);
+        return (i8)Error::UnexpectedMessage;
+    } else if (m_context.cipher_spec_set && !is_tls13() && type != MessageType::ChangeCipher) {
         if constexpr (TLS_DEBUG) {
             dbgln("Encrypted: ");
             print_buffer(buffer.slice(header_size, length));
@@ -427,6 +582,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
                 plain = decrypted;
             },
+            [&](Crypto::Cipher::ChaCha20Poly1305&) { VERIFY_NOT_REACHED(); },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
                 auto iv_size = iv_length();
@@ -522,8 +678,8 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
         }
         break;
     case MessageType::Alert:
-        dbgln_if(TLS_DEBUG, "alert message of length {}", length);
-        if (length >= 2) {
+        dbgln_if(TLS_DEBUG, "alert message of length {}", plain.size());
+        if (plain.size() >= 2) {
             if constexpr (TLS_DEBUG)
                 print_buffer(plain);
 
@@ -540,7 +696,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
                     dbgln("Server sent a close notify and we haven't agreed on a cipher suite. Treating it as a handshake failure.");
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/DateTime.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<CachedSession> SessionCache::get(String const& host)
+{
+    auto it = m_sessions.find(host);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.expiry_time <= Core::DateTime::now().timestamp()) {
+        dbgln_if(TLS_DEBUG, "Cached session for {} has expired", host);
+        m_sessions.remove(it);
+        return {};
+    }
+
+    return it->value;
+}
+
+void SessionCache::set(String const& host, CachedSession session)
+{
+    if (m_sessions.size() >= max_session_count && !m_sessions.contains(host)) {
+        auto now = Core::DateTime::now().timestamp();
+        m_sessions.remove_all_matching([&](auto&, auto& entry) { return entry.expiry_time <= now; });
+
+        // Still full, so make room by dropping the session that would've expired first.
+        if (m_sessions.size() >= max_session_count) {
+            auto oldest = m_sessions.begin();
+            for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+                if (it->value.expiry_time < oldest->value.expiry_time)
+                    oldest = it;
+            }
+            m_sessions.remove(oldest);
+        }
+    }
+
+    m_sessions.set(host, move(session));
+}
+
+void SessionCache::remove(String const& host)
+{
+    m_sessions.remove(host);
+}
+
+}
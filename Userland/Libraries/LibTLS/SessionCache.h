@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <LibTLS/CipherSuite.h>
+#include <LibTLS/TLSPacketBuilder.h>
+
+namespace TLS {
+
+// Everything needed to resume a session with an abbreviated handshake, as per RFC 5246 section 7.3 (session IDs)
+// and RFC 5077 (session tickets), or RFC 8446 section 2.2 (pre-shared keys from TLS 1.3 tickets).
+struct CachedSession {
+    // Either of these identifies the session to the server; the ticket is preferred if we have one.
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+
+    // For TLS 1.3 sessions, this is the pre-shared key derived from the ticket.
+    ByteBuffer master_key;
+    CipherSuite cipher { CipherSuite::Invalid };
+    time_t expiry_time { 0 };
+
+    Version version { Version::V12 };
+    // TLS 1.3 only: What it takes to compute the obfuscated_ticket_age (RFC 8446 section 4.2.11.1).
+    u32 ticket_age_add { 0 };
+    time_t issue_time { 0 };
+};
+
+// Remembers the sessions of finished handshakes by host name, so that later connections to the same host can resume them.
+// One cache can be shared by any number of connections, see Options::session_cache.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    static NonnullRefPtr<SessionCache> create() { return adopt_ref(*new SessionCache); }
+
+    // How long a session is kept when the server doesn't tell us, and the upper bound for what it tells us.
+    static constexpr time_t default_lifetime_in_seconds = 5 * 60;
+    static constexpr time_t max_lifetime_in_seconds = 24 * 60 * 60;
+
+    Optional<CachedSession> get(String const& host);
+    void set(String const& host, CachedSession);
+    void remove(String const& host);
+
+    size_t size() const { return m_sessions.size(); }
+
+private:
+    SessionCache() = default;
+
+    static constexpr size_t max_session_count = 256;
+
+    HashMap<String, CachedSession> m_sessions;
+};
+
+}
@@ -248,6 +248,11 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        if (m_context.is_resuming_session && m_context.connection_status != ConnectionStatus::Established && m_context.options.session_cache) {
+            // Don't offer this session again, so the next attempt gets a full handshake.
+            m_context.options.session_cache->remove(m_context.extensions.SNI);
+        }
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
@@ -317,7 +322,8 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
-    alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+    // NOTE: This is a warning, as servers drop the session of a connection that ends with a fatal alert, which prevents resuming it.
+    alert(AlertLevel::Warning, AlertDescription::CloseNotify);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/Base64.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
@@ -433,6 +434,7 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
     m_context.options = move(options);
     m_context.is_server = false;
     m_context.tls_buffer = {};
+    m_context.alpn = m_context.options.alpn_protocols;
 
     set_root_certificates(m_context.options.root_certificates.has_value()
             ? *m_context.options.root_certificates
@@ -441,6 +443,16 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
     setup_connection();
 }
 
+void TLSv12::add_alpn(StringView alpn)
+{
+    m_context.alpn.append(alpn);
+}
+
+bool TLSv12::has_alpn(StringView alpn) const
+{
+    return any_of(m_context.alpn, [&](auto& protocol) { return protocol == alpn; });
+}
+
 Vector<Certificate> TLSv12::parse_pem_certificate(ReadonlyBytes certificate_pem_buffer, ReadonlyBytes rsa_key) // FIXME: This should not be bound to RSA
 {
     if (certificate_pem_buffer.is_empty() || rsa_key.is_empty()) {
@@ -15,10 +15,12 @@
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
 #include <LibCrypto/Curves/EllipticCurve.h>
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -66,6 +68,7 @@ class Socket;
     ENUMERATE_ALERT_DESCRIPTION(InappropriateFallback, 86)  \
     ENUMERATE_ALERT_DESCRIPTION(UserCanceled, 90)           \
     ENUMERATE_ALERT_DESCRIPTION(NoRenegotiation, 100)       \
+    ENUMERATE_ALERT_DESCRIPTION(MissingExtension, 109)      \
     ENUMERATE_ALERT_DESCRIPTION(UnsupportedExtension, 110)  \
     ENUMERATE_ALERT_DESCRIPTION(NoError, 255)
 
@@ -111,6 +114,8 @@ enum class Error : i8 {
     NeedMoreData = -21,
     TimedOut = -22,
     OutOfMemory = -23,
+    IllegalParameter = -24,
+    MissingExtension = -25,
 };
 
 enum class AlertLevel : u8 {
@@ -123,13 +128,18 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
+    EncryptedExtensions = 0x08,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
     ServerHelloDone = 0x0e,
     CertificateVerify = 0x0f,
     ClientKeyExchange = 0x10,
-    Finished = 0x14
+    Finished = 0x14,
+    KeyUpdate = 0x18,
+    // Only ever part of the transcript hash, see RFC 8446 section 4.4.1.
+    MessageHash = 0xfe,
 };
 
 enum class HandshakeExtension : u16 {
@@ -138,6 +148,12 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
+    PreSharedKey = 0x29,
+    SupportedVersions = 0x2b,
+    Cookie = 0x2c,
+    PskKeyExchangeModes = 0x2d,
+    KeyShare = 0x33,
 };
 
 enum class NameType : u8 {
@@ -149,6 +165,8 @@ enum class WritePacketStage {
     ClientHandshake = 1,
     ServerHandshake = 2,
     Finished = 3,
+    // TLS 1.3: The server asked for another ClientHello with a HelloRetryRequest.
+    RetriedClientHello = 4,
 };
 
 enum class ConnectionStatus {
@@ -172,7 +190,12 @@ enum class ECCurveType : u8 {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
+// TLS 1.3 suites derive the whole 12 byte nonce from the key schedule instead, and leave
+// the key exchange to the key_share extension.
 #define ENUMERATE_CIPHERS(C)                                                                                                                              \
+    C(true, CipherSuite::AES_128_GCM_SHA256, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 12, true)                 \
+    C(true, CipherSuite::AES_256_GCM_SHA384, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 12, true)                 \
+    C(true, CipherSuite::CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 12, true)     \
     C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
     C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
     C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)           \
@@ -237,8 +260,14 @@ struct Options {
         return move(*this);                                     \
     }
 
+    // NOTE: This is what goes into the record headers and ClientHello.legacy_version; TLS 1.3 is
+    //       negotiated through the supported_versions extension, up to max_version.
     OPTION_WITH_DEFAULTS(Version, version, Version::V12)
+    OPTION_WITH_DEFAULTS(Version, max_version, Version::V13)
     OPTION_WITH_DEFAULTS(Vector<SignatureAndHashAlgorithm>, supported_signature_algorithms,
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA256 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA384 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA512 },
         { HashAlgorithm::SHA512, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA384, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA256, SignatureAlgorithm::RSA },
@@ -257,6 +286,10 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void(AlertDescription)>, alert_handler, [](auto) {})
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
+    // Protocols to offer via ALPN (RFC 7301), in order of preference; see TLSv12::alpn() for the outcome.
+    OPTION_WITH_DEFAULTS(Vector<String>, alpn_protocols, )
+    // Where to look up sessions to resume, and to store new ones in; no sessions are resumed without one.
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -271,6 +304,13 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    Version negotiated_version { Version::V12 };
+    // The session offered for resumption in our ClientHello, if any.
+    Optional<CachedSession> resumable_session;
+    bool is_resuming_session { false };
+    // From the server's NewSessionTicket message (RFC 5077 section 3.3).
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -285,10 +325,38 @@ struct Context {
         u8 local_mac[32];
         u8 local_iv[16];
         u8 remote_iv[16];
-        u8 local_aead_iv[4];
-        u8 remote_aead_iv[4];
+        // TLS 1.2 only uses the first 4 bytes, TLS 1.3 XORs the whole thing with the sequence number.
+        u8 local_aead_iv[12];
+        u8 remote_aead_iv[12];
     } crypto;
 
+    // RFC 8446 key schedule and handshake state, only used when negotiating TLS 1.3.
+    struct {
+        NamedCurve key_share_group { NamedCurve::x25519 };
+        OwnPtr<Crypto::Curves::EllipticCurve> key_share_curve;
+        ByteBuffer key_share_private_key;
+        ByteBuffer key_share_public_key;
+        ByteBuffer shared_secret;
+
+        ByteBuffer early_secret;
+        ByteBuffer handshake_secret;
+        ByteBuffer master_secret;
+        ByteBuffer client_traffic_secret;
+        ByteBuffer server_traffic_secret;
+        ByteBuffer resumption_master_secret;
+
+        // From a HelloRetryRequest, to be echoed in the second ClientHello.
+        ByteBuffer cookie;
+        // The message_hash of the first ClientHello followed by the HelloRetryRequest,
+        // which the PSK binder of the second ClientHello covers as well.
+        ByteBuffer hello_retry_transcript;
+        ByteBuffer certificate_request_context;
+
+        bool is_psk_offered { false };
+        bool has_received_hello_retry_request { false };
+        bool has_received_certificate_request { false };
+    } tls13;
+
     Crypto::Hash::Manager handshake_hash;
 
     ByteBuffer message_buffer;
@@ -321,12 +389,12 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[13] { 0 };
     ByteBuffer user_data;
     HashMap<String, Certificate> root_certificates;
 
     Vector<String> alpn;
-    StringView negotiated_alpn;
+    String negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -428,9 +496,11 @@ public:
 
     bool supports_version(Version v) const
     {
-        return v == Version::V12;
+        return v == Version::V12 || (v == Version::V13 && m_context.options.max_version >= Version::V13);
     }
 
+    Version negotiated_version() const { return m_context.negotiated_version; }
+
     void alert(AlertLevel, AlertDescription);
 
     bool can_read_line() const { return m_context.application_buffer.size() && memchr(m_context.application_buffer.data(), '\n', m_context.application_buffer.size()); }
@@ -451,6 +521,8 @@ private:
     void ensure_hmac(size_t digest_size, bool local);
 
     void update_packet(ByteBuffer& packet);
+    void encrypt_tls13_record(ByteBuffer& packet);
+    ssize_t decrypt_tls13_record(ReadonlyBytes record, ByteBuffer& decrypted, MessageType& type);
     void update_hash(ReadonlyBytes in, size_t header_size);
 
     void write_packet(ByteBuffer& packet);
@@ -465,6 +537,7 @@ private:
     ByteBuffer build_alert(bool critical, u8 code);
     ByteBuffer build_change_cipher_spec();
     ByteBuffer build_verify_request();
+    ByteBuffer build_key_update(bool request_update);
     void build_rsa_pre_master_secret(PacketBuilder&);
     void build_dhe_rsa_pre_master_secret(PacketBuilder&);
     void build_ecdhe_rsa_pre_master_secret(PacketBuilder&);
@@ -483,7 +556,17 @@ private:
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
+    ssize_t handle_hello_retry_request(ReadonlyBytes hello_retry_request, Optional<NamedCurve> selected_group, ReadonlyBytes cookie, WritePacketStage&);
+    ssize_t handle_encrypted_extensions(ReadonlyBytes);
+    ssize_t handle_tls13_certificate(ReadonlyBytes);
+    ssize_t handle_tls13_certificate_request(ReadonlyBytes);
+    ssize_t handle_server_certificate_verify(ReadonlyBytes);
+    ssize_t handle_tls13_new_session_ticket(ReadonlyBytes);
+    ssize_t handle_key_update(ReadonlyBytes);
+    ssize_t handle_post_handshake_payload(ReadonlyBytes);
+    void handle_alpn_extension(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
     ssize_t handle_random(ReadonlyBytes);
@@ -491,6 +574,25 @@ private:
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
     ssize_t verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer);
+    ssize_t verify_rsa_signature(SignatureAndHashAlgorithm, ReadonlyBytes message, ReadonlyBytes signature);
+
+    bool is_tls13() const { return m_context.negotiated_version == Version::V13; }
+    bool generate_key_share(NamedCurve);
+
+    // TLS 1.3 key schedule, see KeySchedule.cpp.
+    ErrorOr<ByteBuffer> hkdf_expand_label(Crypto::Hash::HashKind, ReadonlyBytes secret, StringView label, ReadonlyBytes context, size_t length) const;
+    ErrorOr<ByteBuffer> derive_secret(Crypto::Hash::HashKind, ReadonlyBytes secret, StringView label, ReadonlyBytes transcript_hash) const;
+    ErrorOr<ByteBuffer> compute_finished_verify_data(Crypto::Hash::HashKind, ReadonlyBytes base_key, ReadonlyBytes transcript_hash) const;
+    ErrorOr<ByteBuffer> transcript_hash();
+    ErrorOr<void> derive_early_secret(ReadonlyBytes psk);
+    ErrorOr<ByteBuffer> compute_psk_binder(ReadonlyBytes truncated_client_hello);
+    ErrorOr<void> derive_handshake_secrets();
+    // Installs the server's application traffic keys, and returns the client's secret, which only takes over after our Finished.
+    ErrorOr<ByteBuffer> derive_application_secrets();
+    ErrorOr<void> derive_resumption_master_secret();
+    ErrorOr<void> install_traffic_keys(ReadonlyBytes secret, bool local);
+    ErrorOr<void> update_traffic_secret(bool local);
+    bool finish_tls13_handshake();
 
     size_t key_length() const
     {
@@ -562,6 +664,9 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    void did_establish_connection();
+    void store_session_for_resumption();
+
     void try_disambiguate_error() const;
 
     bool m_eof { false };
@@ -574,7 +679,8 @@ private:
     using CipherVariant = Variant<
         Empty,
         Crypto::Cipher::AESCipher::CBCMode,
-        Crypto::Cipher::AESCipher::GCMMode>;
+        Crypto::Cipher::AESCipher::GCMMode,
+        Crypto::Cipher::ChaCha20Poly1305>;
     CipherVariant m_cipher_local {};
     CipherVariant m_cipher_remote {};
 
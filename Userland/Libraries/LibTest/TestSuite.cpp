@@ -8,10 +8,17 @@
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
 #include <AK/Function.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/LexicalPath.h>
+#include <AK/Math.h>
+#include <AK/QuickSort.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/Stream.h>
 #include <LibTest/TestSuite.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <string.h>
+#include <time.h>
 
 namespace Test {
 
@@ -21,23 +28,52 @@ class TestElapsedTimer {
 public:
     TestElapsedTimer() { restart(); }
 
-    void restart() { gettimeofday(&m_started, nullptr); }
+    void restart() { clock_gettime(CLOCK_MONOTONIC, &m_started); }
 
-    u64 elapsed_milliseconds()
-    {
-        struct timeval now = {};
-        gettimeofday(&now, nullptr);
-
-        struct timeval delta = {};
-        timersub(&now, &m_started, &delta);
+    u64 elapsed_milliseconds() { return elapsed_microseconds() / 1000; }
 
-        return delta.tv_sec * 1000 + delta.tv_usec / 1000;
+    u64 elapsed_microseconds()
+    {
+        struct timespec now = {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (now.tv_sec - m_started.tv_sec) * 1'000'000 + (now.tv_nsec - m_started.tv_nsec) / 1000;
     }
 
 private:
-    struct timeval m_started = {};
+    struct timespec m_started = {};
 };
 
+struct BenchmarkStatistics {
+    u64 min { 0 };
+    u64 max { 0 };
+    u64 median { 0 };
+    double mean { 0 };
+    double standard_deviation { 0 };
+};
+
+static BenchmarkStatistics compute_statistics(Vector<u64> samples)
+{
+    BenchmarkStatistics statistics;
+    if (samples.is_empty())
+        return statistics;
+
+    quick_sort(samples);
+    statistics.min = samples.first();
+    statistics.max = samples.last();
+    statistics.median = samples[samples.size() / 2];
+
+    double sum = 0;
+    for (auto sample : samples)
+        sum += sample;
+    statistics.mean = sum / samples.size();
+
+    double squared_deviations = 0;
+    for (auto sample : samples)
+        squared_deviations += (sample - statistics.mean) * (sample - statistics.mean);
+    statistics.standard_deviation = AK::sqrt(squared_deviations / samples.size());
+    return statistics;
+}
+
 // Declared in Macros.h
 void current_test_case_did_fail()
 {
@@ -66,10 +102,14 @@ int TestSuite::main(String const& suite_name, int argc, char** argv)
     bool do_benchmarks_only = false;
     bool do_list_cases = false;
     char const* search_string = "*";
+    char const* json_output_path = nullptr;
 
     args_parser.add_option(do_tests_only, "Only run tests.", "tests", 0);
     args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench", 0);
     args_parser.add_option(do_list_cases, "List available test cases.", "list", 0);
+    args_parser.add_option(m_benchmark_warmups, "Run each benchmark this many times before timing it.", "bench-warmups", 0, "count");
+    args_parser.add_option(m_benchmark_repetitions, "Time each benchmark this many times.", "bench-repetitions", 0, "count");
+    args_parser.add_option(json_output_path, "Write the benchmark timings to this file as JSON.", "json", 0, "path");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -88,7 +128,51 @@ int TestSuite::main(String const& suite_name, int argc, char** argv)
 
     outln("Running {} cases out of {}.", matching_tests.size(), m_cases.size());
 
-    return run(matching_tests);
+    m_benchmark_repetitions = max<size_t>(m_benchmark_repetitions, 1);
+    auto failed_count = run(matching_tests);
+
+    if (json_output_path) {
+        if (auto result = write_benchmark_results({ json_output_path, strlen(json_output_path) }); result.is_error()) {
+            warnln("Failed to write benchmark results to {}: {}", json_output_path, result.error());
+            return 1;
+        }
+    }
+
+    return failed_count;
+}
+
+ErrorOr<void> TestSuite::write_benchmark_results(StringView path) const
+{
+    JsonArray benchmarks;
+    for (auto const& result : m_benchmark_results) {
+        auto statistics = compute_statistics(result.samples_in_microseconds);
+
+        JsonArray samples;
+        for (auto sample : result.samples_in_microseconds)
+            samples.append(sample);
+
+        JsonObject benchmark;
+        benchmark.set("name", result.name);
+        benchmark.set("passed", result.passed);
+        benchmark.set("samples_us", move(samples));
+        benchmark.set("min_us", statistics.min);
+        benchmark.set("max_us", statistics.max);
+        benchmark.set("median_us", statistics.median);
+        benchmark.set("mean_us", statistics.mean);
+        benchmark.set("stddev_us", statistics.standard_deviation);
+        benchmarks.append(move(benchmark));
+    }
+
+    JsonObject root;
+    root.set("suite", LexicalPath::basename(m_suite_name));
+    root.set("warmups", m_benchmark_warmups);
+    root.set("repetitions", m_benchmark_repetitions);
+    root.set("benchmarks", move(benchmarks));
+
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Write));
+    if (!file->write_or_error(root.to_string().bytes()))
+        return Error::from_string_literal("Failed to write benchmark results");
+    return {};
 }
 
 NonnullRefPtrVector<TestCase> TestSuite::find_cases(String const& search, bool find_tests, bool find_benchmarks)
@@ -124,16 +208,36 @@ int TestSuite::run(NonnullRefPtrVector<TestCase> const& tests)
         warnln("Running {} '{}'.", test_type, t.name());
         m_current_test_case_passed = true;
 
-        TestElapsedTimer timer;
-        t.func()();
-        auto const time = timer.elapsed_milliseconds();
-
-        dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
-
         if (t.is_benchmark()) {
+            for (size_t i = 0; i < m_benchmark_warmups; ++i)
+                t.func()();
+
+            Vector<u64> samples;
+            TestElapsedTimer timer;
+            for (size_t i = 0; i < m_benchmark_repetitions; ++i) {
+                TestElapsedTimer repetition_timer;
+                t.func()();
+                samples.append(repetition_timer.elapsed_microseconds());
+            }
+            auto const time = timer.elapsed_milliseconds();
+
+            dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
+            if (m_benchmark_repetitions > 1) {
+                auto statistics = compute_statistics(samples);
+                dbgln("    {} repetitions: min {}us, median {}us, mean {:.1}us, stddev {:.1}us",
+                    samples.size(), statistics.min, statistics.median, statistics.mean, statistics.standard_deviation);
+            }
+
+            m_benchmark_results.append({ t.name(), m_current_test_case_passed, move(samples) });
             m_benchtime += time;
             benchmark_count++;
         } else {
+            TestElapsedTimer timer;
+            t.func()();
+            auto const time = timer.elapsed_milliseconds();
+
+            dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
+
             m_testtime += time;
             test_count++;
         }
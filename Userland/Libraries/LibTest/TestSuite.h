@@ -13,6 +13,7 @@
 #include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 #include <LibTest/TestCase.h>
 
 namespace Test {
@@ -46,6 +47,14 @@ public:
     void set_suite_setup(Function<void()> setup) { m_setup = move(setup); }
 
 private:
+    struct BenchmarkResult {
+        String name;
+        bool passed { true };
+        Vector<u64> samples_in_microseconds;
+    };
+
+    ErrorOr<void> write_benchmark_results(StringView path) const;
+
     static TestSuite* s_global;
     NonnullRefPtrVector<TestCase> m_cases;
     u64 m_testtime = 0;
@@ -53,6 +62,11 @@ private:
     String m_suite_name;
     bool m_current_test_case_passed = true;
     Function<void()> m_setup;
+
+    // Benchmarks run this many times untimed first, and are then timed once per repetition.
+    size_t m_benchmark_warmups = 0;
+    size_t m_benchmark_repetitions = 1;
+    Vector<BenchmarkResult> m_benchmark_results;
 };
 
 }
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+static thread_local ThreadPool* s_current_pool;
+static thread_local void* s_current_worker;
+
+ThreadPool& ThreadPool::the()
+{
+    static ThreadPool* s_the = new ThreadPool(max(sysconf(_SC_NPROCESSORS_ONLN), 1l));
+    return *s_the;
+}
+
+ThreadPool::ThreadPool(size_t worker_count)
+{
+    VERIFY(worker_count > 0);
+    m_workers.ensure_capacity(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+        m_workers.unchecked_append(make<Worker>());
+
+    // All workers have to exist before any of them starts stealing from the others.
+    for (auto& worker : m_workers) {
+        worker->thread = Thread::construct([this, &worker = *worker] { return worker_main(worker); }, "Pool worker"sv);
+        worker->thread->start();
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_idle_mutex);
+        m_exiting = true;
+        m_idle_condition.broadcast();
+    }
+    for (auto& worker : m_workers)
+        (void)worker->thread->join();
+}
+
+intptr_t ThreadPool::worker_main(Worker& worker)
+{
+    s_current_pool = this;
+    s_current_worker = &worker;
+
+    while (true) {
+        if (auto task = take_task(&worker); task.has_value()) {
+            (*task)();
+            continue;
+        }
+
+        MutexLocker locker(m_idle_mutex);
+        // Whoever queues a task bumps the task count before checking for idle workers, and we do it the other
+        // way around, so either they see us here and wake us up, or we see their task and don't go to sleep.
+        m_idle_worker_count.fetch_add(1);
+        while (m_queued_task_count.load() == 0 && !m_exiting)
+            m_idle_condition.wait();
+        m_idle_worker_count.fetch_sub(1);
+
+        // Queued tasks still run before the pool goes away.
+        if (m_exiting && m_queued_task_count.load() == 0)
+            return 0;
+    }
+}
+
+void ThreadPool::submit(Function<void()> task, Priority priority)
+{
+    m_queued_task_count.fetch_add(1);
+
+    if (s_current_pool == this && priority == Priority::Normal) {
+        auto& worker = *static_cast<Worker*>(s_current_worker);
+        MutexLocker locker(worker.mutex);
+        worker.tasks.append(move(task));
+    } else {
+        MutexLocker locker(m_shared_mutex);
+        m_shared_tasks[to_underlying(priority)].enqueue(move(task));
+    }
+
+    wake_a_worker();
+}
+
+void ThreadPool::wake_a_worker()
+{
+    if (m_idle_worker_count.load() == 0)
+        return;
+    MutexLocker locker(m_idle_mutex);
+    m_idle_condition.signal();
+}
+
+bool ThreadPool::run_pending_task()
+{
+    auto* current_worker = s_current_pool == this ? static_cast<Worker*>(s_current_worker) : nullptr;
+    auto task = take_task(current_worker);
+    if (!task.has_value())
+        return false;
+    (*task)();
+    return true;
+}
+
+Optional<ThreadPool::Task> ThreadPool::take_task(Worker* current_worker)
+{
+    if (m_queued_task_count.load() == 0)
+        return {};
+
+    auto task = take_shared_task(Priority::High);
+    if (!task.has_value() && current_worker)
+        task = take_own_task(*current_worker);
+    if (!task.has_value())
+        task = take_shared_task(Priority::Normal);
+    if (!task.has_value())
+        task = steal_task(current_worker);
+    if (!task.has_value())
+        task = take_shared_task(Priority::Low);
+
+    if (task.has_value())
+        m_queued_task_count.fetch_sub(1);
+    return task;
+}
+
+Optional<ThreadPool::Task> ThreadPool::take_own_task(Worker& worker)
+{
+    MutexLocker locker(worker.mutex);
+    if (worker.head == worker.tasks.size())
+        return {};
+    auto task = worker.tasks.take_last();
+    if (worker.head == worker.tasks.size()) {
+        worker.tasks.clear_with_capacity();
+        worker.head = 0;
+    }
+    return task;
+}
+
+Optional<ThreadPool::Task> ThreadPool::steal_task(Worker* current_worker)
+{
+    for (auto& worker : m_workers) {
+        if (worker.ptr() == current_worker)
+            continue;
+        MutexLocker locker(worker->mutex);
+        if (worker->head == worker->tasks.size())
+            continue;
+        auto task = move(worker->tasks[worker->head++]);
+        if (worker->head == worker->tasks.size()) {
+            worker->tasks.clear_with_capacity();
+            worker->head = 0;
+        }
+        return task;
+    }
+    return {};
+}
+
+Optional<ThreadPool::Task> ThreadPool::take_shared_task(Priority priority)
+{
+    MutexLocker locker(m_shared_mutex);
+    auto& tasks = m_shared_tasks[to_underlying(priority)];
+    if (tasks.is_empty())
+        return {};
+    return tasks.dequeue();
+}
+
+void ThreadPool::parallel_for(size_t begin, size_t end, Function<void(size_t)> const& body, size_t grain_size)
+{
+    if (begin >= end)
+        return;
+
+    size_t count = end - begin;
+    if (grain_size == 0)
+        grain_size = max(count / (worker_count() * 4), static_cast<size_t>(1));
+    size_t batch_count = ceil_div(count, grain_size);
+    if (batch_count == 1) {
+        for (size_t i = begin; i < end; ++i)
+            body(i);
+        return;
+    }
+
+    Mutex done_mutex;
+    ConditionVariable done_condition { done_mutex };
+    size_t remaining_batches = batch_count;
+
+    auto run_batch = [&](size_t batch) {
+        size_t batch_begin = begin + batch * grain_size;
+        size_t batch_end = min(batch_begin + grain_size, end);
+        for (size_t i = batch_begin; i < batch_end; ++i)
+            body(i);
+
+        MutexLocker locker(done_mutex);
+        if (--remaining_batches == 0)
+            done_condition.broadcast();
+    };
+
+    for (size_t batch = 1; batch < batch_count; ++batch)
+        submit([&run_batch, batch] { run_batch(batch); });
+    run_batch(0);
+
+    // Help out until none of our batches are left in the queues. The ones that are still unfinished after that
+    // are running on other threads, so it's safe to go to sleep then.
+    while (run_pending_task()) {
+        MutexLocker locker(done_mutex);
+        if (remaining_batches == 0)
+            return;
+    }
+
+    MutexLocker locker(done_mutex);
+    while (remaining_batches != 0)
+        done_condition.wait();
+}
+
+}
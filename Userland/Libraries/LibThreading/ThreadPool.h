@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Queue.h>
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Promise.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+// A pool of worker threads, one per CPU by default.
+//
+// Every worker has its own queue of tasks. Tasks that a worker submits go to the back of its own queue, and it
+// runs them newest first, while idle workers steal the oldest tasks from the other queues. Tasks from outside of
+// the pool, and tasks with a priority other than Normal, go to shared queues; High priority tasks are picked up
+// before anything else.
+//
+// Waiting for work in the pool (like parallel_for() does) never blocks a thread while there are queued tasks;
+// the waiting thread runs them instead. That makes it safe to use the helpers from within tasks.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    enum class Priority : u8 {
+        High,
+        Normal,
+        Low,
+    };
+
+    // The process-wide pool. It's created on first use and never destroyed.
+    static ThreadPool& the();
+
+    explicit ThreadPool(size_t worker_count);
+    ~ThreadPool();
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    void submit(Function<void()>, Priority = Priority::Normal);
+
+    // Runs the function on the pool, and resolves the returned promise on the calling thread's event loop.
+    template<typename Result>
+    NonnullRefPtr<Core::Promise<Result>> run(Function<Result()> function, Priority priority = Priority::Normal)
+    {
+        auto promise = Core::Promise<Result>::construct();
+        // Core::Object's reference count isn't atomic, so the reference that keeps the promise alive is taken
+        // and dropped on this thread, and the pool only passes a raw pointer around.
+        promise->ref();
+        submit([function = move(function), promise = promise.ptr(), origin_event_loop = &Core::EventLoop::current()]() mutable {
+            auto result = function();
+            origin_event_loop->deferred_invoke([promise, result = move(result)]() mutable {
+                promise->resolve(move(result));
+                promise->unref();
+            });
+            origin_event_loop->wake();
+        },
+            priority);
+        return promise;
+    }
+
+    // Calls body(i) for every i in [begin, end), split into batches of grain_size indices. A grain size of 0
+    // picks one that gives every worker a few batches. Returns once all calls have finished.
+    void parallel_for(size_t begin, size_t end, Function<void(size_t)> const& body, size_t grain_size = 0);
+
+    // Sorts chunks of the span in parallel, then merges them in parallel rounds. The sort isn't stable.
+    template<typename T, typename LessThan>
+    void parallel_sort(Span<T> span, LessThan less_than)
+    {
+        size_t chunk_count = min(worker_count() * 2, span.size() / minimum_sort_chunk_size);
+        if (chunk_count <= 1) {
+            quick_sort(span.begin(), span.end(), less_than);
+            return;
+        }
+
+        size_t chunk_size = ceil_div(span.size(), chunk_count);
+        parallel_for(0, chunk_count, [&](size_t chunk) {
+            auto chunk_span = sorted_chunk(span, chunk, chunk_size);
+            quick_sort(chunk_span.begin(), chunk_span.end(), less_than);
+        },
+            1);
+
+        Vector<T> buffer;
+        buffer.ensure_capacity(span.size());
+        for (auto& value : span)
+            buffer.unchecked_append(value);
+
+        // Every round merges neighbouring pairs of sorted runs, going back and forth between the span and the buffer.
+        Span<T> from = span;
+        Span<T> to = buffer.span();
+        for (size_t run_size = chunk_size; run_size < span.size(); run_size *= 2) {
+            size_t pair_count = ceil_div(span.size(), run_size * 2);
+            parallel_for(0, pair_count, [&](size_t pair) {
+                size_t start = pair * run_size * 2;
+                size_t middle = min(start + run_size, span.size());
+                size_t end = min(start + run_size * 2, span.size());
+                merge(from.slice(start, middle - start), from.slice(middle, end - middle), to.slice(start, end - start), less_than);
+            },
+                1);
+            swap(from, to);
+        }
+
+        if (from.data() != span.data()) {
+            for (size_t i = 0; i < span.size(); ++i)
+                span[i] = move(from[i]);
+        }
+    }
+
+    template<typename T>
+    void parallel_sort(Span<T> span)
+    {
+        parallel_sort(span, [](auto& a, auto& b) { return a < b; });
+    }
+
+    // Runs one queued task on the calling thread. Returns false if there was nothing to run.
+    bool run_pending_task();
+
+private:
+    using Task = Function<void()>;
+
+    struct Worker {
+        Mutex mutex;
+        // The owner takes tasks from the back, thieves from the front. Everything before `head` has been stolen.
+        Vector<Task> tasks;
+        size_t head { 0 };
+        RefPtr<Thread> thread;
+    };
+
+    static constexpr size_t minimum_sort_chunk_size = 4096;
+
+    template<typename T>
+    static Span<T> sorted_chunk(Span<T> span, size_t chunk, size_t chunk_size)
+    {
+        size_t start = min(chunk * chunk_size, span.size());
+        return span.slice(start, min(chunk_size, span.size() - start));
+    }
+
+    template<typename T, typename LessThan>
+    static void merge(Span<T> left, Span<T> right, Span<T> out, LessThan& less_than)
+    {
+        size_t i = 0;
+        size_t j = 0;
+        size_t k = 0;
+        while (i < left.size() && j < right.size()) {
+            if (less_than(right[j], left[i]))
+                out[k++] = move(right[j++]);
+            else
+                out[k++] = move(left[i++]);
+        }
+        while (i < left.size())
+            out[k++] = move(left[i++]);
+        while (j < right.size())
+            out[k++] = move(right[j++]);
+    }
+
+    intptr_t worker_main(Worker&);
+    Optional<Task> take_task(Worker* current_worker);
+    Optional<Task> take_own_task(Worker&);
+    Optional<Task> steal_task(Worker* current_worker);
+    Optional<Task> take_shared_task(Priority);
+    void wake_a_worker();
+
+    Vector<NonnullOwnPtr<Worker>> m_workers;
+
+    Mutex m_shared_mutex;
+    Array<Queue<Task>, 3> m_shared_tasks;
+
+    // The total number of queued tasks, so that workers know when it's worth looking for one.
+    Atomic<size_t> m_queued_task_count { 0 };
+
+    Mutex m_idle_mutex;
+    ConditionVariable m_idle_condition { m_idle_mutex };
+    Atomic<size_t> m_idle_worker_count { 0 };
+    bool m_exiting { false };
+};
+
+}
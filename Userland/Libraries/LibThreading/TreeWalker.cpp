@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/LexicalPath.h>
+#include <AK/OwnPtr.h>
+#include <AK/ScopeGuard.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/System.h>
+#include <LibThreading/ThreadPool.h>
+#include <LibThreading/TreeWalker.h>
+
+namespace Threading {
+
+// The number of subdirectories of the current directory that are read before we get to them.
+static constexpr size_t max_directories_read_ahead = 32;
+
+static String child_path(String const& parent_path, StringView name)
+{
+    StringBuilder builder;
+    builder.append(parent_path);
+    if (!parent_path.ends_with('/'))
+        builder.append('/');
+    builder.append(name);
+    return builder.to_string();
+}
+
+ErrorOr<void> TreeWalker::walk(String const& root_path)
+{
+    auto metadata_or_error = m_follow_symlinks == Core::DirectoryEntry::FollowSymlinks::Yes
+        ? Core::System::stat(root_path)
+        : Core::System::lstat(root_path);
+    if (metadata_or_error.is_error())
+        return handle_error(root_path, metadata_or_error.release_error());
+
+    Core::DirectoryEntry root;
+    root.metadata = metadata_or_error.release_value();
+    root.type = Core::DirectoryEntry::type_from_mode(root.metadata->st_mode);
+    root.name = LexicalPath::basename(root_path);
+    root.inode_index = root.metadata->st_ino;
+
+    if (on_entry)
+        TRY(on_entry(root_path, root, 0));
+    if (root.type != Core::DirectoryEntry::Type::Directory)
+        return {};
+
+    Listing listing;
+    start_reading(root_path, listing);
+    return visit_directory(root_path, root, 0, listing);
+}
+
+void TreeWalker::start_reading(String const& path, Listing& listing)
+{
+    // NOTE: Reference counts aren't atomic, so the task gets its own copy of the path that nothing else refers to.
+    ThreadPool::the().submit([this, path = String { path.view() }, &listing] {
+        auto result = Core::DirectoryEntry::read_all(path, m_fetch_metadata, m_follow_symlinks);
+        MutexLocker locker(m_mutex);
+        listing.result = move(result);
+        listing.is_done = true;
+        m_condition.broadcast();
+    });
+}
+
+void TreeWalker::wait_for(Listing& listing)
+{
+    // Help out with whatever is queued, that's probably the directory we're waiting for anyway.
+    while (true) {
+        {
+            MutexLocker locker(m_mutex);
+            if (listing.is_done)
+                return;
+        }
+        if (!ThreadPool::the().run_pending_task())
+            break;
+    }
+
+    MutexLocker locker(m_mutex);
+    while (!listing.is_done)
+        m_condition.wait();
+}
+
+ErrorOr<void> TreeWalker::visit_directory(String const& path, Core::DirectoryEntry const& directory, size_t depth, Listing& listing)
+{
+    wait_for(listing);
+
+    Vector<Core::DirectoryEntry> entries;
+    if (listing.result.is_error())
+        TRY(handle_error(path, listing.result.release_error()));
+    else
+        entries = listing.result.release_value();
+
+    // The listings of the subdirectories we've started reading, by entry index.
+    Vector<OwnPtr<Listing>> listings;
+    listings.resize(entries.size());
+    ScopeGuard wait_for_listings = [&] {
+        // The pool still refers to these, so they have to stay around until it's done with them, even if we bail out.
+        for (auto& child_listing : listings) {
+            if (child_listing)
+                wait_for(*child_listing);
+        }
+    };
+
+    size_t read_ahead_index = 0;
+    size_t read_ahead_count = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        while (read_ahead_index < entries.size() && read_ahead_count < max_directories_read_ahead) {
+            auto& entry = entries[read_ahead_index];
+            if (entry.type == Core::DirectoryEntry::Type::Directory) {
+                listings[read_ahead_index] = make<Listing>();
+                start_reading(child_path(path, entry.name), *listings[read_ahead_index]);
+                ++read_ahead_count;
+            }
+            ++read_ahead_index;
+        }
+
+        auto& entry = entries[i];
+        auto entry_path = child_path(path, entry.name);
+        if (on_entry)
+            TRY(on_entry(entry_path, entry, depth + 1));
+
+        if (listings[i]) {
+            --read_ahead_count;
+            TRY(visit_directory(entry_path, entry, depth + 1, *listings[i]));
+            listings[i] = nullptr;
+        }
+    }
+
+    if (on_leave_directory)
+        TRY(on_leave_directory(path, directory, depth));
+    return {};
+}
+
+ErrorOr<void> TreeWalker::handle_error(String const& path, Error error)
+{
+    if (on_error)
+        return on_error(path, error);
+    return error;
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/String.h>
+#include <LibCore/DirectoryEntry.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+
+namespace Threading {
+
+// Walks directory trees depth-first, like a recursive DirIterator loop would, but reads the directories it's about
+// to enter ahead of time on the thread pool, along with the metadata of their entries if that's asked for.
+//
+// All callbacks run on the thread that called walk(), in the same order a serial walk would call them, so they
+// don't have to be thread-safe.
+class TreeWalker {
+    AK_MAKE_NONCOPYABLE(TreeWalker);
+    AK_MAKE_NONMOVABLE(TreeWalker);
+
+public:
+    TreeWalker() = default;
+
+    void set_fetch_metadata(Core::DirectoryEntry::FetchMetadata fetch_metadata) { m_fetch_metadata = fetch_metadata; }
+    void set_follow_symlinks(Core::DirectoryEntry::FollowSymlinks follow_symlinks) { m_follow_symlinks = follow_symlinks; }
+
+    // Called for every file and directory, starting with the root. The root has a depth of 0.
+    Function<ErrorOr<void>(String const& path, Core::DirectoryEntry const&, size_t depth)> on_entry;
+    // Called after all entries inside of a directory have been visited.
+    Function<ErrorOr<void>(String const& path, Core::DirectoryEntry const&, size_t depth)> on_leave_directory;
+    // Called when a directory can't be read, or the root can't be stat-ed. Returning an error stops the walk, and
+    // returning nothing carries on as if the directory was empty. Without a callback, the walk stops.
+    Function<ErrorOr<void>(String const& path, Error const&)> on_error;
+
+    ErrorOr<void> walk(String const& root_path);
+
+private:
+    // A directory that is (being) read on the thread pool.
+    struct Listing {
+        bool is_done { false };
+        ErrorOr<Vector<Core::DirectoryEntry>> result { Vector<Core::DirectoryEntry> {} };
+    };
+
+    void start_reading(String const& path, Listing&);
+    void wait_for(Listing&);
+    ErrorOr<void> visit_directory(String const& path, Core::DirectoryEntry const&, size_t depth, Listing&);
+    ErrorOr<void> handle_error(String const& path, Error);
+
+    Core::DirectoryEntry::FetchMetadata m_fetch_metadata { Core::DirectoryEntry::FetchMetadata::No };
+    Core::DirectoryEntry::FollowSymlinks m_follow_symlinks { Core::DirectoryEntry::FollowSymlinks::No };
+
+    Mutex m_mutex;
+    ConditionVariable m_condition { m_mutex };
+};
+
+}
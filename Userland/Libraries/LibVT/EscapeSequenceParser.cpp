@@ -16,6 +16,29 @@ EscapeSequenceParser::EscapeSequenceParser(EscapeSequenceExecutor& executor)
 {
 }
 
+static constexpr bool is_printable_ascii(u8 byte)
+{
+    return byte >= 0x20 && byte <= 0x7f;
+}
+
+void EscapeSequenceParser::on_input(ReadonlyBytes bytes)
+{
+    size_t i = 0;
+    while (i < bytes.size()) {
+        // Most output is plain text, which the state machine would just hand over one character at a time.
+        if (m_state_machine.is_in_initial_state() && is_printable_ascii(bytes[i])) {
+            size_t run_end = i + 1;
+            while (run_end < bytes.size() && is_printable_ascii(bytes[run_end]))
+                ++run_end;
+            dbgln_if(ESCAPE_SEQUENCE_DEBUG, "on_input {} printable bytes", run_end - i);
+            m_executor.emit_printable_ascii(bytes.slice(i, run_end - i));
+            i = run_end;
+            continue;
+        }
+        on_input(bytes[i++]);
+    }
+}
+
 Vector<EscapeSequenceParser::OscParameter> EscapeSequenceParser::osc_parameters() const
 {
     VERIFY(m_osc_raw.size() >= m_osc_parameter_indexes.last());
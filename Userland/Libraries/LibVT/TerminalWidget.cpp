@@ -69,8 +69,7 @@ void TerminalWidget::set_pty_master_fd(int fd)
             set_pty_master_fd(-1);
             return;
         }
-        for (ssize_t i = 0; i < nread; ++i)
-            m_terminal.on_input(buffer[i]);
+        m_terminal.on_input({ buffer, static_cast<size_t>(nread) });
         flush_dirty_lines();
     };
 }
@@ -479,14 +478,20 @@ void TerminalWidget::flush_dirty_lines()
         m_terminal.m_need_full_flush = false;
         return;
     }
+    // Every run of dirty rows gets its own rect, so that a change near the top and the cursor moving at the bottom
+    // don't repaint everything in between.
     Gfx::IntRect rect;
     for (int i = 0; i < m_terminal.rows(); ++i) {
         if (m_terminal.visible_line(i).is_dirty()) {
             rect = rect.united(row_rect(i));
             m_terminal.visible_line(i).set_dirty(false);
+        } else if (!rect.is_empty()) {
+            update(rect);
+            rect = {};
         }
     }
-    update(rect);
+    if (!rect.is_empty())
+        update(rect);
 }
 
 void TerminalWidget::resize_event(GUI::ResizeEvent& event)
@@ -6,6 +6,7 @@
 
 #include "MatroskaReader.h"
 #include <AK/Function.h>
+#include <AK/QuickSort.h>
 #include <AK/Optional.h>
 #include <AK/Utf8View.h>
 #include <LibCore/MappedFile.h>
@@ -40,6 +41,26 @@ constexpr u32 CHANNELS_ID = 0x9F;
 constexpr u32 BIT_DEPTH_ID = 0x6264;
 constexpr u32 SIMPLE_BLOCK_ID = 0xA3;
 constexpr u32 TIMESTAMP_ID = 0xE7;
+constexpr u32 SEEK_HEAD_ID = 0x114D9B74;
+constexpr u32 SEEK_ID = 0x4DBB;
+constexpr u32 SEEK_ID_ID = 0x53AB;
+constexpr u32 SEEK_POSITION_ID = 0x53AC;
+constexpr u32 CUES_ID = 0x1C53BB6B;
+constexpr u32 CUE_POINT_ID = 0xBB;
+constexpr u32 CUE_TIME_ID = 0xB3;
+constexpr u32 CUE_TRACK_POSITIONS_ID = 0xB7;
+constexpr u32 CUE_TRACK_ID = 0xF7;
+constexpr u32 CUE_CLUSTER_POSITION_ID = 0xF1;
+
+// A size with all of its value bits set means that the size is unknown.
+static bool is_unknown_element_size(u64 size)
+{
+    for (size_t length = 1; length <= 8; length++) {
+        if (size == (1ull << (7 * length)) - 1)
+            return true;
+    }
+    return false;
+}
 
 OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_file(StringView path)
 {
@@ -57,7 +78,35 @@ OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_data(u8 const* data
     return reader.parse();
 }
 
+OwnPtr<MatroskaReader> MatroskaReader::open_file(StringView path)
+{
+    auto mapped_file_result = Core::MappedFile::map(path);
+    if (mapped_file_result.is_error())
+        return {};
+
+    auto mapped_file = mapped_file_result.release_value();
+    auto reader = make<MatroskaReader>((u8*)mapped_file->data(), mapped_file->size());
+    reader->m_mapped_file = move(mapped_file);
+    return reader;
+}
+
 OwnPtr<MatroskaDocument> MatroskaReader::parse()
+{
+    auto matroska_document = parse_headers();
+    if (!matroska_document)
+        return {};
+
+    while (m_streamer.position() < m_segment_contents_end) {
+        auto cluster = read_next_cluster();
+        if (!cluster)
+            break;
+        matroska_document->clusters().append(cluster.release_nonnull());
+    }
+
+    return matroska_document;
+}
+
+OwnPtr<MatroskaDocument> MatroskaReader::parse_headers()
 {
     auto first_element_id = m_streamer.read_variable_size_integer(false);
     dbgln_if(MATROSKA_TRACE_DEBUG, "First element ID is {:#010x}\n", first_element_id.value());
@@ -74,15 +123,109 @@ OwnPtr<MatroskaDocument> MatroskaReader::parse()
     if (!root_element_id.has_value() || root_element_id.value() != SEGMENT_ELEMENT_ID)
         return {};
 
+    auto segment_size = m_streamer.read_variable_size_integer();
+    if (!segment_size.has_value())
+        return {};
+    m_segment_contents_position = m_streamer.position();
+    if (is_unknown_element_size(segment_size.value()) || segment_size.value() > m_streamer.remaining())
+        m_segment_contents_end = m_streamer.size();
+    else
+        m_segment_contents_end = m_segment_contents_position + segment_size.value();
+
     auto matroska_document = make<MatroskaDocument>(header.value());
 
-    auto segment_parse_success = parse_segment_elements(*matroska_document);
-    if (!segment_parse_success)
-        return {};
+    dbgln_if(MATROSKA_DEBUG, "Parsing segment elements");
+    while (m_streamer.position() < m_segment_contents_end) {
+        auto element_position = m_streamer.position();
+        auto element_id = m_streamer.read_variable_size_integer(false);
+        if (!element_id.has_value())
+            return {};
+
+        if (element_id.value() == CLUSTER_ELEMENT_ID) {
+            // Everything from here on is read one cluster at a time.
+            m_first_cluster_position = element_position;
+            m_streamer.seek_to(element_position);
+            break;
+        }
+
+        if (!parse_segment_element(*matroska_document, element_id.value()))
+            return {};
+    }
+
+    // Cues are usually written after the clusters, so the seek head is the only way to find them without reading the whole file.
+    if (m_cues_position.has_value() && m_cue_points.is_empty()) {
+        auto position_after_headers = m_streamer.position();
+        if (m_streamer.seek_to(m_cues_position.value())) {
+            auto element_id = m_streamer.read_variable_size_integer(false);
+            if (element_id.has_value() && element_id.value() == CUES_ID && !parse_cues()) {
+                dbgln_if(MATROSKA_DEBUG, "Failed to parse the cues, seeking will not be possible");
+                m_cue_points.clear();
+            }
+        }
+        m_streamer.seek_to(position_after_headers);
+    }
 
     return matroska_document;
 }
 
+OwnPtr<Cluster> MatroskaReader::read_next_cluster()
+{
+    while (m_streamer.position() < m_segment_contents_end) {
+        auto element_id = m_streamer.read_variable_size_integer(false);
+        if (!element_id.has_value())
+            return {};
+
+        if (element_id.value() == CLUSTER_ELEMENT_ID)
+            return parse_cluster();
+
+        if (element_id.value() == CUES_ID && m_cue_points.is_empty()) {
+            if (!parse_cues())
+                return {};
+            continue;
+        }
+
+        // Anything else in between the clusters (e.g. tags) isn't needed for playback.
+        if (!read_unknown_element())
+            return {};
+    }
+    return {};
+}
+
+bool MatroskaReader::seek_to_timestamp(u64 track_number, u64 timestamp)
+{
+    if (m_cue_points.is_empty())
+        return false;
+
+    // Find the first cue point after the timestamp, then walk back to the closest one for our track.
+    size_t low = 0;
+    size_t high = m_cue_points.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_cue_points[middle].timestamp <= timestamp)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    size_t cluster_position;
+    for (;;) {
+        if (low == 0) {
+            // The timestamp is before the first cue point, so we start at the beginning.
+            VERIFY(m_first_cluster_position.has_value());
+            cluster_position = m_first_cluster_position.value();
+            break;
+        }
+        auto const& cue_point = m_cue_points[--low];
+        if (cue_point.track_number == track_number) {
+            cluster_position = m_segment_contents_position + cue_point.cluster_position;
+            break;
+        }
+    }
+
+    dbgln_if(MATROSKA_DEBUG, "Seeking to timestamp {} of track {} at position {}", timestamp, track_number, cluster_position);
+    return m_streamer.seek_to(cluster_position);
+}
+
 bool MatroskaReader::parse_master_element([[maybe_unused]] StringView element_name, Function<bool(u64)> element_consumer)
 {
     auto element_data_size = m_streamer.read_variable_size_integer();
@@ -136,31 +279,113 @@ Optional<EBMLHeader> MatroskaReader::parse_ebml_header()
     return header;
 }
 
-bool MatroskaReader::parse_segment_elements(MatroskaDocument& matroska_document)
+bool MatroskaReader::parse_segment_element(MatroskaDocument& matroska_document, u64 element_id)
 {
-    dbgln_if(MATROSKA_DEBUG, "Parsing segment elements");
-    auto success = parse_master_element("Segment"sv, [&](u64 element_id) {
-        if (element_id == SEGMENT_INFORMATION_ELEMENT_ID) {
-            auto segment_information = parse_information();
-            if (!segment_information)
-                return false;
-            matroska_document.set_segment_information(move(segment_information));
-        } else if (element_id == TRACK_ELEMENT_ID) {
-            return parse_tracks(matroska_document);
-        } else if (element_id == CLUSTER_ELEMENT_ID) {
-            auto cluster = parse_cluster();
-            if (!cluster)
+    if (element_id == SEGMENT_INFORMATION_ELEMENT_ID) {
+        auto segment_information = parse_information();
+        if (!segment_information)
+            return false;
+        matroska_document.set_segment_information(move(segment_information));
+    } else if (element_id == TRACK_ELEMENT_ID) {
+        return parse_tracks(matroska_document);
+    } else if (element_id == SEEK_HEAD_ID) {
+        return parse_seek_head();
+    } else if (element_id == CUES_ID) {
+        return parse_cues();
+    } else {
+        return read_unknown_element();
+    }
+
+    return true;
+}
+
+bool MatroskaReader::parse_seek_head()
+{
+    return parse_master_element("SeekHead"sv, [&](u64 element_id) {
+        if (element_id != SEEK_ID)
+            return read_unknown_element();
+
+        Optional<u64> seek_id;
+        Optional<u64> seek_position;
+        auto success = parse_master_element("Seek"sv, [&](u64 element_id) {
+            if (element_id == SEEK_ID_ID) {
+                // The ID is stored as binary data, which is read just like an unsigned integer.
+                seek_id = read_u64_element();
+                CHECK_HAS_VALUE(seek_id);
+            } else if (element_id == SEEK_POSITION_ID) {
+                seek_position = read_u64_element();
+                CHECK_HAS_VALUE(seek_position);
+            } else {
+                return read_unknown_element();
+            }
+            return true;
+        });
+        if (!success)
+            return false;
+
+        if (seek_id == CUES_ID && seek_position.has_value()) {
+            dbgln_if(MATROSKA_DEBUG, "Cues are at segment position {}", seek_position.value());
+            m_cues_position = m_segment_contents_position + seek_position.value();
+        }
+        return true;
+    });
+}
+
+bool MatroskaReader::parse_cues()
+{
+    auto success = parse_master_element("Cues"sv, [&](u64 element_id) {
+        if (element_id == CUE_POINT_ID)
+            return parse_cue_point();
+        return read_unknown_element();
+    });
+    if (!success)
+        return false;
+
+    quick_sort(m_cue_points, [](auto const& a, auto const& b) { return a.timestamp < b.timestamp; });
+    dbgln_if(MATROSKA_DEBUG, "Read {} cue points", m_cue_points.size());
+    return true;
+}
+
+bool MatroskaReader::parse_cue_point()
+{
+    u64 timestamp = 0;
+    auto first_track_position = m_cue_points.size();
+    auto success = parse_master_element("CuePoint"sv, [&](u64 element_id) {
+        if (element_id == CUE_TIME_ID) {
+            auto cue_time = read_u64_element();
+            CHECK_HAS_VALUE(cue_time);
+            timestamp = cue_time.value();
+        } else if (element_id == CUE_TRACK_POSITIONS_ID) {
+            CuePoint cue_point;
+            auto success = parse_master_element("CueTrackPositions"sv, [&](u64 element_id) {
+                if (element_id == CUE_TRACK_ID) {
+                    auto track_number = read_u64_element();
+                    CHECK_HAS_VALUE(track_number);
+                    cue_point.track_number = track_number.value();
+                } else if (element_id == CUE_CLUSTER_POSITION_ID) {
+                    auto cluster_position = read_u64_element();
+                    CHECK_HAS_VALUE(cluster_position);
+                    cue_point.cluster_position = cluster_position.value();
+                } else {
+                    return read_unknown_element();
+                }
+                return true;
+            });
+            if (!success)
                 return false;
-            matroska_document.clusters().append(cluster.release_nonnull());
+            m_cue_points.append(cue_point);
         } else {
             return read_unknown_element();
         }
-
         return true;
     });
+    if (!success)
+        return false;
 
-    dbgln("Success {}", success);
-    return success;
+    // The time may come after the positions, so it is only filled in at the end.
+    for (size_t i = first_track_position; i < m_cue_points.size(); i++)
+        m_cue_points[i].timestamp = timestamp;
+    return true;
 }
 
 OwnPtr<SegmentInformation> MatroskaReader::parse_information()
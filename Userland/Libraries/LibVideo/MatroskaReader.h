@@ -12,6 +12,8 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibCore/MappedFile.h>
 
 namespace Video {
 
@@ -25,13 +27,30 @@ public:
     static OwnPtr<MatroskaDocument> parse_matroska_from_file(StringView path);
     static OwnPtr<MatroskaDocument> parse_matroska_from_data(u8 const*, size_t);
 
+    // Maps the file for use with the streaming interface below, so that only the clusters that are actually read
+    // are ever loaded into memory.
+    static OwnPtr<MatroskaReader> open_file(StringView path);
+
+    // Parses the entire document, including all of its clusters.
     OwnPtr<MatroskaDocument> parse();
 
+    // Parses everything in front of the first cluster, plus the cues if the seek head points to them.
+    // The document that this returns has no clusters, they have to be read with read_next_cluster() instead.
+    OwnPtr<MatroskaDocument> parse_headers();
+    // Returns null at the end of the segment, or when the cluster is malformed.
+    OwnPtr<Cluster> read_next_cluster();
+    // Makes the next read_next_cluster() return the cluster that contains the last cue point for the track
+    // at or before the timestamp, which is given in the same units as the cluster timestamps.
+    // This only works if the file has cues, otherwise it returns false.
+    bool seek_to_timestamp(u64 track_number, u64 timestamp);
+
 private:
     class Streamer {
     public:
         Streamer(u8 const* data, size_t size)
-            : m_data_ptr(data)
+            : m_data_start(data)
+            , m_data_ptr(data)
+            , m_size(size)
             , m_size_remaining(size)
         {
         }
@@ -140,8 +159,23 @@ private:
         size_t remaining() const { return m_size_remaining; }
         void set_remaining(size_t remaining) { m_size_remaining = remaining; }
 
+        size_t size() const { return m_size; }
+        size_t position() const { return m_size - m_size_remaining; }
+
+        // NOTE: This must only be used between top-level elements, as it doesn't update the octet counts of master elements.
+        bool seek_to(size_t position)
+        {
+            if (position > m_size)
+                return false;
+            m_data_ptr = m_data_start + position;
+            m_size_remaining = m_size - position;
+            return true;
+        }
+
     private:
+        u8 const* m_data_start { nullptr };
         u8 const* m_data_ptr { nullptr };
+        size_t m_size { 0 };
         size_t m_size_remaining { 0 };
         Vector<size_t> m_octets_read { 0 };
     };
@@ -149,7 +183,10 @@ private:
     bool parse_master_element(StringView element_name, Function<bool(u64 element_id)> element_consumer);
     Optional<EBMLHeader> parse_ebml_header();
 
-    bool parse_segment_elements(MatroskaDocument&);
+    bool parse_segment_element(MatroskaDocument&, u64 element_id);
+    bool parse_seek_head();
+    bool parse_cues();
+    bool parse_cue_point();
     OwnPtr<SegmentInformation> parse_information();
 
     bool parse_tracks(MatroskaDocument&);
@@ -163,7 +200,22 @@ private:
     Optional<u64> read_u64_element();
     bool read_unknown_element();
 
+    struct CuePoint {
+        u64 timestamp { 0 };
+        u64 track_number { 0 };
+        // Relative to the start of the segment's data.
+        u64 cluster_position { 0 };
+    };
+
     Streamer m_streamer;
+    RefPtr<Core::MappedFile> m_mapped_file;
+
+    size_t m_segment_contents_position { 0 };
+    size_t m_segment_contents_end { 0 };
+    Optional<size_t> m_first_cluster_position;
+    Optional<size_t> m_cues_position;
+    // Sorted by timestamp.
+    Vector<CuePoint> m_cue_points;
 };
 
 }
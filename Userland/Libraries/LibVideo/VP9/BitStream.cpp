@@ -5,6 +5,7 @@
  */
 
 #include "BitStream.h"
+#include <AK/BuiltinWrappers.h>
 
 namespace Video::VP9 {
 
@@ -56,43 +57,66 @@ u16 BitStream::read_f16()
     return (read_f8() << 8u) | read_f8();
 }
 
+u32 BitStream::read_f32()
+{
+    return (static_cast<u32>(read_f16()) << 16u) | read_f16();
+}
+
 /* 9.2.1 */
 bool BitStream::init_bool(size_t bytes)
 {
     if (bytes < 1)
         return false;
-    m_bool_value = read_f8();
+    // The data of the bool decoder always starts at a byte boundary, which the read-ahead below relies on.
+    VERIFY(!m_current_byte.has_value());
+    m_bool_value = static_cast<u64>(read_byte()) << 56u;
+    m_bool_value_bits = 0;
+    m_bool_padding_bits = 0;
     m_bool_range = 255;
     m_bool_max_bits = (8 * bytes) - 8;
     return !read_bool(128);
 }
 
+void BitStream::fill_bool_value()
+{
+    while (m_bool_value_bits <= 48) {
+        auto shift = 48u - m_bool_value_bits;
+        if (m_bool_max_bits >= 8 && m_bytes_remaining >= 1) {
+            m_bool_value |= static_cast<u64>(read_byte()) << shift;
+            m_bool_max_bits -= 8;
+        } else {
+            // Past the end of the data, the spec reads zeros.
+            m_bool_padding_bits = min(m_bool_padding_bits, m_bool_value_bits) + 8;
+        }
+        m_bool_value_bits += 8;
+    }
+}
+
 /* 9.2.2 */
 bool BitStream::read_bool(u8 probability)
 {
     auto split = 1u + (((m_bool_range - 1u) * probability) >> 8u);
+    // The range is renormalized by at most 7 bits below, make sure we have those available.
+    if (m_bool_value_bits < 8)
+        fill_bool_value();
+
+    auto big_split = static_cast<u64>(split) << 56u;
     bool return_bool;
 
-    if (m_bool_value < split) {
+    if (m_bool_value < big_split) {
         m_bool_range = split;
         return_bool = false;
     } else {
         m_bool_range -= split;
-        m_bool_value -= split;
+        m_bool_value -= big_split;
         return_bool = true;
     }
 
-    while (m_bool_range < 128) {
-        bool new_bit;
-        if (m_bool_max_bits) {
-            new_bit = read_bit();
-            m_bool_max_bits--;
-        } else {
-            new_bit = false;
-        }
-        m_bool_range *= 2;
-        m_bool_value = (m_bool_value << 1u) + new_bit;
-    }
+    // Shift in as many bits as needed to bring the range back to at least 128, all at once.
+    auto shift = count_leading_zeroes(m_bool_range) - 24;
+    m_bool_range <<= shift;
+    m_bool_value <<= shift;
+    m_bool_value_bits -= shift;
 
     return return_bool;
 }
@@ -100,6 +124,19 @@ bool BitStream::read_bool(u8 probability)
 /* 9.2.3 */
 bool BitStream::exit_bool()
 {
+    // Put back whatever we read ahead, so that the padding is read from the stream just like the spec does it.
+    auto unread_bits = m_bool_value_bits > m_bool_padding_bits ? m_bool_value_bits - m_bool_padding_bits : 0u;
+    auto unread_bytes = ceil_div(unread_bits, 8u);
+    m_data_ptr -= unread_bytes;
+    m_bytes_remaining += unread_bytes;
+    m_bool_max_bits += unread_bytes * 8;
+    m_bool_value_bits = 0;
+    m_bool_padding_bits = 0;
+    // The first bits of the first byte that was put back have already been used.
+    auto used_bits = unread_bytes * 8 - unread_bits;
+    read_f(used_bits);
+    m_bool_max_bits -= used_bits;
+
     // FIXME: I'm not sure if this call to min is spec compliant, or if there is an issue elsewhere earlier in the parser.
     auto padding_element = read_f(min(m_bool_max_bits, (u64)bits_remaining()));
 
@@ -26,6 +26,7 @@ public:
     u8 read_f(size_t n);
     u8 read_f8();
     u16 read_f16();
+    u32 read_f32();
 
     /* (9.2) */
     bool init_bool(size_t bytes);
@@ -47,8 +48,15 @@ private:
     i8 m_current_bit_position { 0 };
     u64 m_bytes_read { 0 };
 
-    u8 m_bool_value { 0 };
-    u8 m_bool_range { 0 };
+    void fill_bool_value();
+
+    // BoolValue from the spec is kept in the top 8 bits, followed by bits that were read ahead of time,
+    // so that the decoder doesn't have to go back to the stream for every single bit.
+    u64 m_bool_value { 0 };
+    // How many of the bits below BoolValue are valid, and how many of those at the end are only zero padding after the data.
+    u32 m_bool_value_bits { 0 };
+    u32 m_bool_padding_bits { 0 };
+    u32 m_bool_range { 0 };
     u64 m_bool_max_bits { 0 };
 };
 
@@ -6,6 +6,7 @@
 
 #include "Decoder.h"
 #include "Utilities.h"
+#include <AK/Debug.h>
 
 namespace Video::VP9 {
 
@@ -171,8 +172,9 @@ bool Decoder::reconstruct(size_t, u32, u32, TXSize)
 bool Decoder::update_reference_frames()
 {
     for (auto i = 0; i < NUM_REF_FRAMES; i++) {
-        dbgln("updating frame {}? {}", i, (m_parser->m_refresh_frame_flags & (1 << i)) == 1);
-        if ((m_parser->m_refresh_frame_flags & (1 << i)) != 1)
+        bool refresh = (m_parser->m_refresh_frame_flags & (1 << i)) != 0;
+        dbgln_if(VP9_DEBUG, "updating frame {}? {}", i, refresh);
+        if (!refresh)
             continue;
         m_parser->m_ref_frame_width[i] = m_parser->m_frame_width;
         m_parser->m_ref_frame_height[i] = m_parser->m_frame_height;
@@ -7,6 +7,7 @@
 #include "Parser.h"
 #include "Decoder.h"
 #include "Utilities.h"
+#include <AK/Debug.h>
 
 namespace Video::VP9 {
 
@@ -16,6 +17,7 @@ namespace Video::VP9 {
 
 Parser::Parser(Decoder& decoder)
     : m_probability_tables(make<ProbabilityTables>())
+    , m_syntax_element_counter(make<SyntaxElementCounter>())
     , m_tree_parser(make<TreeParser>(*this))
     , m_decoder(decoder)
 {
@@ -45,13 +47,12 @@ void Parser::cleanup_tile_allocations()
 bool Parser::parse_frame(ByteBuffer const& frame_data)
 {
     m_bit_stream = make<BitStream>(frame_data.data(), frame_data.size());
-    m_syntax_element_counter = make<SyntaxElementCounter>();
 
     SAFE_CALL(uncompressed_header());
-    dbgln("Finished reading uncompressed header");
+    dbgln_if(VP9_DEBUG, "Finished reading uncompressed header");
     SAFE_CALL(trailing_bits());
     if (m_header_size_in_bytes == 0) {
-        dbgln("No header");
+        dbgln_if(VP9_DEBUG, "No header");
         return true;
     }
     m_probability_tables->load_probs(m_frame_context_idx);
@@ -59,15 +60,15 @@ bool Parser::parse_frame(ByteBuffer const& frame_data)
     m_syntax_element_counter->clear_counts();
 
     SAFE_CALL(m_bit_stream->init_bool(m_header_size_in_bytes));
-    dbgln("Reading compressed header");
+    dbgln_if(VP9_DEBUG, "Reading compressed header");
     SAFE_CALL(compressed_header());
-    dbgln("Finished reading compressed header");
+    dbgln_if(VP9_DEBUG, "Finished reading compressed header");
     SAFE_CALL(m_bit_stream->exit_bool());
 
     SAFE_CALL(decode_tiles());
     SAFE_CALL(refresh_probs());
 
-    dbgln("Finished reading frame!");
+    dbgln_if(VP9_DEBUG, "Finished reading frame!");
     return true;
 }
 
@@ -260,7 +261,7 @@ bool Parser::frame_size_with_refs()
     for (auto frame_index : m_ref_frame_idx) {
         found_ref = m_bit_stream->read_bit();
         if (found_ref) {
-            dbgln("Reading size from ref frame {}", frame_index);
+            dbgln_if(VP9_DEBUG, "Reading size from ref frame {}", frame_index);
             m_frame_width = m_ref_frame_width[frame_index];
             m_frame_height = m_ref_frame_height[frame_index];
             break;
@@ -756,7 +757,7 @@ bool Parser::decode_tiles()
     for (auto tile_row = 0; tile_row < tile_rows; tile_row++) {
         for (auto tile_col = 0; tile_col < tile_cols; tile_col++) {
             auto last_tile = (tile_row == tile_rows - 1) && (tile_col == tile_cols - 1);
-            auto tile_size = last_tile ? m_bit_stream->bytes_remaining() : m_bit_stream->read_f(32);
+            auto tile_size = last_tile ? m_bit_stream->bytes_remaining() : m_bit_stream->read_f32();
             m_mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
             m_mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
             m_mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
@@ -135,6 +135,10 @@ ErrorOr<void, ValidationError> AbstractMachine::validate(Module& module)
         return result.release_error();
     }
 
+    // Function bodies only have to be pre-decoded once, and they can't be before they're known to be valid.
+    for (auto& function : module.functions())
+        BytecodeInterpreter::pre_decode(function.body());
+
     return {};
 }
 
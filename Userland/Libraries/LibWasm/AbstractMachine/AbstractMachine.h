@@ -352,13 +352,22 @@ public:
             return true;
         u64 new_size = m_data.size() + size_to_grow;
         // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
+        u64 maximum_size = Constants::page_size * 65536;
+        if (new_size >= maximum_size)
             return false;
         if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
+            maximum_size = max.value() * Constants::page_size;
+            if (maximum_size < new_size)
                 return false;
         }
         auto previous_size = m_size;
+        // Modules commonly grow their memory a page at a time, so grow the capacity geometrically
+        // instead of copying everything on every grow.
+        if (new_size > m_data.capacity()) {
+            auto new_capacity = min(max(new_size, static_cast<u64>(m_data.capacity()) * 2), maximum_size);
+            if (m_data.try_ensure_capacity(new_capacity).is_error() && m_data.try_ensure_capacity(new_size).is_error())
+                return false;
+        }
         if (m_data.try_resize(new_size).is_error())
             return false;
         m_size = new_size;
@@ -505,8 +514,16 @@ public:
     Stack() = default;
 
     [[nodiscard]] ALWAYS_INLINE bool is_empty() const { return m_data.is_empty(); }
-    ALWAYS_INLINE void push(EntryType entry) { m_data.append(move(entry)); }
+    template<typename T>
+    ALWAYS_INLINE void push(T&& entry) { m_data.empend(forward<T>(entry)); }
     ALWAYS_INLINE auto pop() { return m_data.take_last(); }
+    // For when the top of the stack is known to be a value, which is cheaper than moving the whole entry out of the stack.
+    ALWAYS_INLINE Value pop_value()
+    {
+        auto value = m_data.last().get<Value>();
+        m_data.remove(m_data.size() - 1);
+        return value;
+    }
     ALWAYS_INLINE auto& peek() const { return m_data.last(); }
     ALWAYS_INLINE auto& peek() { return m_data.last(); }
 
@@ -32,7 +32,9 @@ namespace Wasm {
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap.clear();
-    auto& instructions = configuration.frame().expression().instructions();
+    auto& expression = configuration.frame().expression();
+    auto const is_observed = is_observing_every_instruction();
+    auto& instructions = is_observed ? expression.instructions() : expression.pre_decoded_instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
     auto const should_limit_instruction_count = configuration.should_limit_instruction_count();
@@ -47,7 +49,10 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
         }
         auto& instruction = instructions[current_ip_value.value()];
         auto old_ip = current_ip_value;
-        interpret(configuration, current_ip_value, instruction);
+        if (is_observed)
+            interpret(configuration, current_ip_value, instruction);
+        else
+            BytecodeInterpreter::interpret(configuration, current_ip_value, instruction);
         if (m_trap.has_value())
             return;
         if (current_ip_value == old_ip) // If no jump occurred
@@ -58,24 +63,60 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
+    auto label_index = configuration.nth_label_index(index.value());
+    auto& entries = configuration.stack().entries();
+    auto label = entries[*label_index].get<Label>();
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label.continuation().value(), label.arity());
 
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
+    // Drop everything between the label and the results in one go, the results themselves just move down (in order).
+    auto results_index = entries.size() - label.arity();
+    entries.remove(*label_index + 1, results_index - *label_index - 1);
+
+    configuration.ip() = label.continuation();
+}
+
+static Optional<Instruction> fuse_instructions(Vector<Instruction> const& instructions, size_t ip)
+{
+    auto opcode_at = [&](size_t offset) -> Optional<OpCode> {
+        if (ip + offset >= instructions.size())
+            return {};
+        return instructions[ip + offset].opcode();
+    };
+    auto& first = instructions[ip];
+
+    if (first.opcode() == Instructions::local_get) {
+        auto local = first.arguments().get<LocalIndex>();
+        auto second = opcode_at(1);
+        auto third = opcode_at(2);
+        if (second == Instructions::local_get && third == Instructions::i32_add)
+            return Instruction { Instructions::synthetic_i32_add2local, Instruction::LocalPairArgs { local, instructions[ip + 1].arguments().get<LocalIndex>() } };
+        if (second == Instructions::i32_const && (third == Instructions::i32_add || third == Instructions::i32_and)) {
+            auto opcode = third == Instructions::i32_add ? Instructions::synthetic_i32_addconstlocal : Instructions::synthetic_i32_andconstlocal;
+            return Instruction { opcode, Instruction::LocalAndConstantArgs { local, instructions[ip + 1].arguments().get<i32>() } };
         }
-        configuration.stack().pop();
+        if (second == Instructions::local_set)
+            return Instruction { Instructions::synthetic_local_copy, Instruction::LocalPairArgs { local, instructions[ip + 1].arguments().get<LocalIndex>() } };
+        return {};
     }
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
+    if (first.opcode() == Instructions::i32_const && opcode_at(1) == Instructions::local_set)
+        return Instruction { Instructions::synthetic_local_seti32_const, Instruction::LocalAndConstantArgs { instructions[ip + 1].arguments().get<LocalIndex>(), first.arguments().get<i32>() } };
 
-    configuration.ip() = label->continuation();
+    return {};
+}
+
+void BytecodeInterpreter::pre_decode(Expression const& expression)
+{
+    auto& instructions = expression.instructions();
+    Vector<Instruction> pre_decoded_instructions;
+    pre_decoded_instructions.ensure_capacity(instructions.size());
+    for (size_t ip = 0; ip < instructions.size(); ++ip) {
+        if (auto fused_instruction = fuse_instructions(instructions, ip); fused_instruction.has_value())
+            pre_decoded_instructions.unchecked_append(fused_instruction.release_value());
+        else
+            pre_decoded_instructions.unchecked_append(instructions[ip]);
+    }
+    expression.set_pre_decoded_instructions(move(pre_decoded_instructions));
 }
 
 template<typename ReadType, typename PushType>
@@ -104,7 +145,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
     auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
-    configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
+    entry.get<Value>() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
 void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAddress address)
@@ -145,12 +186,9 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
 template<typename PopType, typename PushType, typename Operator>
 void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
 {
-    auto rhs_entry = configuration.stack().pop();
-    auto& lhs_entry = configuration.stack().peek();
-    auto rhs_ptr = rhs_entry.get_pointer<Value>();
-    auto lhs_ptr = lhs_entry.get_pointer<Value>();
-    auto rhs = rhs_ptr->to<PopType>();
-    auto lhs = lhs_ptr->to<PopType>();
+    auto rhs = configuration.stack().pop_value().to<PopType>();
+    auto& lhs_value = configuration.stack().peek().get<Value>();
+    auto lhs = lhs_value.to<PopType>();
     PushType result;
     auto call_result = Operator {}(lhs.value(), rhs.value());
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
@@ -163,7 +201,7 @@ void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
         result = call_result;
     }
     dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", lhs.value(), Operator::name(), rhs.value(), result);
-    lhs_entry = Value(result);
+    lhs_value = Value(result);
 }
 
 template<typename PopType, typename PushType, typename Operator>
@@ -184,7 +222,7 @@ void BytecodeInterpreter::unary_operation(Configuration& configuration)
         result = call_result;
     }
     dbgln_if(WASM_TRACE_DEBUG, "map({}) {} = {}", Operator::name(), *value, result);
-    entry = Value(result);
+    *entry_ptr = Value(result);
 }
 
 template<typename T>
@@ -224,11 +262,9 @@ struct ConvertToRaw<double> {
 template<typename PopT, typename StoreT>
 void BytecodeInterpreter::pop_and_store(Configuration& configuration, Instruction const& instruction)
 {
-    auto entry = configuration.stack().pop();
-    auto value = ConvertToRaw<StoreT> {}(*entry.get<Value>().to<PopT>());
+    auto value = ConvertToRaw<StoreT> {}(*configuration.stack().pop_value().to<PopT>());
     dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary({}b)", value, sizeof(StoreT));
-    auto base_entry = configuration.stack().pop();
-    auto base = base_entry.get<Value>().to<i32>();
+    auto base = configuration.stack().pop_value().to<i32>();
     store_to_memory(configuration, instruction, { &value, sizeof(StoreT) }, *base);
 }
 
@@ -252,36 +288,23 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
 template<typename T>
 T BytecodeInterpreter::read_value(ReadonlyBytes data)
 {
+    // NOTE: The caller has already checked that the access is in bounds, so there's no need to go through a stream.
+    VERIFY(data.size() >= sizeof(T));
     LittleEndian<T> value;
-    InputMemoryStream stream { data };
-    stream >> value;
-    if (stream.handle_any_error()) {
-        dbgln("Read from {} failed", data.data());
-        m_trap = Trap { "Read from memory failed" };
-    }
+    __builtin_memcpy(&value, data.data(), sizeof(T));
     return value;
 }
 
 template<>
 float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
 {
-    InputMemoryStream stream { data };
-    LittleEndian<u32> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<float>(static_cast<u32>(raw_value));
+    return bit_cast<float>(read_value<u32>(data));
 }
 
 template<>
 double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
 {
-    InputMemoryStream stream { data };
-    LittleEndian<u64> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<double>(static_cast<u64>(raw_value));
+    return bit_cast<double>(read_value<u64>(data));
 }
 
 template<typename V, typename T>
@@ -329,21 +352,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
@@ -358,13 +366,47 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         configuration.stack().push(Value(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]));
         return;
     case Instructions::local_set.value(): {
-        auto entry = configuration.stack().pop();
-        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = move(entry.get<Value>());
+        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = configuration.stack().pop_value();
         return;
     }
     case Instructions::i32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I32 }, static_cast<i64>(instruction.arguments().get<i32>())));
+        configuration.stack().push(Value(instruction.arguments().get<i32>()));
+        return;
+    case Instructions::synthetic_i32_add2local.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalPairArgs>();
+        auto& locals = configuration.frame().locals();
+        auto result = Operators::Add {}(*locals[args.first.value()].to<u32>(), *locals[args.second.value()].to<u32>());
+        configuration.stack().push(Value(static_cast<i32>(result)));
+        configuration.ip() = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_i32_addconstlocal.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstantArgs>();
+        auto result = Operators::Add {}(*configuration.frame().locals()[args.local.value()].to<u32>(), static_cast<u32>(args.constant));
+        configuration.stack().push(Value(static_cast<i32>(result)));
+        configuration.ip() = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_i32_andconstlocal.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstantArgs>();
+        auto result = Operators::BitAnd {}(*configuration.frame().locals()[args.local.value()].to<i32>(), args.constant);
+        configuration.stack().push(Value(result));
+        configuration.ip() = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_local_seti32_const.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstantArgs>();
+        configuration.frame().locals()[args.local.value()] = Value(args.constant);
+        configuration.ip() = ip.value() + 2;
+        return;
+    }
+    case Instructions::synthetic_local_copy.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalPairArgs>();
+        auto& locals = configuration.frame().locals();
+        locals[args.second.value()] = locals[args.first.value()];
+        configuration.ip() = ip.value() + 2;
         return;
+    }
     case Instructions::i64_const.value():
         configuration.stack().push(Value(ValueType { ValueType::I64 }, instruction.arguments().get<i64>()));
         return;
@@ -431,8 +473,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
+        auto value = configuration.stack().pop_value().to<i32>();
         auto end_label = Label(arity, args.end_ip.value());
         if (value.value() == 0) {
             if (args.else_ip.has_value()) {
@@ -484,15 +525,13 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::br.value():
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     case Instructions::br_if.value(): {
-        auto entry = configuration.stack().pop();
-        if (entry.get<Value>().to<i32>().value_or(0) == 0)
+        if (configuration.stack().pop_value().to<i32>().value_or(0) == 0)
             return;
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     }
     case Instructions::br_table.value(): {
         auto& arguments = instruction.arguments().get<Instruction::TableBranchArgs>();
-        auto entry = configuration.stack().pop();
-        auto maybe_i = entry.get<Value>().to<i32>();
+        auto maybe_i = configuration.stack().pop_value().to<i32>();
         if (0 <= *maybe_i) {
             size_t i = *maybe_i;
             if (i < arguments.labels.size())
@@ -511,8 +550,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& args = instruction.arguments().get<Instruction::IndirectCallArgs>();
         auto table_address = configuration.frame().module().tables()[args.table.value()];
         auto table_instance = configuration.store().get(table_address);
-        auto entry = configuration.stack().pop();
-        auto index = entry.get<Value>().to<i32>();
+        auto index = configuration.stack().pop_value().to<i32>();
         TRAP_IF_NOT(index.value() >= 0);
         TRAP_IF_NOT(static_cast<size_t>(index.value()) < table_instance->elements().size());
         auto element = table_instance->elements()[index.value()];
@@ -644,14 +682,12 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::select.value():
     case Instructions::select_typed.value(): {
         // Note: The type seems to only be used for validation.
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
+        auto value = configuration.stack().pop_value().to<i32>();
         dbgln_if(WASM_TRACE_DEBUG, "select({})", value.value());
-        auto rhs_entry = configuration.stack().pop();
-        auto& lhs_entry = configuration.stack().peek();
-        auto rhs = move(rhs_entry.get<Value>());
-        auto lhs = move(lhs_entry.get<Value>());
-        configuration.stack().peek() = value.value() != 0 ? move(lhs) : move(rhs);
+        auto rhs = configuration.stack().pop_value();
+        auto& lhs = configuration.stack().peek().get<Value>();
+        if (value.value() == 0)
+            lhs = rhs;
         return;
     }
     case Instructions::i32_eqz.value():
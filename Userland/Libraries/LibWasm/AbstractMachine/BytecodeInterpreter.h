@@ -19,6 +19,12 @@ struct BytecodeInterpreter : public Interpreter {
     virtual String trap_reason() const override { return m_trap.value().reason; }
     virtual void clear_trap() override { m_trap.clear(); }
 
+    // Fuses common sequences of instructions in a (validated) function body into synthetic instructions, which then
+    // take the place of the first instruction of the sequence and skip over the rest of it.
+    // NOTE: Every instruction stays where it was, so branch targets (which are never in the middle of a sequence)
+    //       don't have to be adjusted.
+    static void pre_decode(Expression const&);
+
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
             : m_configuration_handle(configuration)
@@ -34,6 +40,9 @@ struct BytecodeInterpreter : public Interpreter {
 
 protected:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
+    // Whoever watches every instruction as it runs gets to see the original ones, one by one.
+    // Everyone else gets the pre-decoded ones, and no virtual dispatch per instruction.
+    virtual bool is_observing_every_instruction() const { return false; }
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
@@ -57,7 +66,6 @@ protected:
     template<typename T>
     T read_value(ReadonlyBytes data);
 
-    Vector<Value> pop_values(Configuration& configuration, size_t count);
     ALWAYS_INLINE bool trap_if_not(bool value, StringView reason)
     {
         if (!value)
@@ -77,6 +85,7 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
 
 private:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&) override;
+    virtual bool is_observing_every_instruction() const override { return pre_interpret_hook || post_interpret_hook; }
 };
 
 }
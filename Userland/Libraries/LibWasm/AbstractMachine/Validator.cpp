@@ -7,6 +7,7 @@
 #include <AK/HashTable.h>
 #include <AK/Result.h>
 #include <AK/SourceLocation.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Try.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Printer/Printer.h>
@@ -255,18 +256,20 @@ ErrorOr<void, ValidationError> Validator::validate(CodeSection const& section)
         auto& function_type = m_context.functions[function_index];
         auto& function = entry.func();
 
-        auto function_validator = fork();
-        function_validator.m_context.locals = {};
-        function_validator.m_context.locals.extend(function_type.parameters());
+        // NOTE: Only the locals, labels and return type differ between functions, so swap those out instead of
+        //       copying the whole context (which grows with the module) for every single function.
+        Vector<ValueType> locals;
+        locals.extend(function_type.parameters());
         for (auto& local : function.locals()) {
             for (size_t i = 0; i < local.n(); ++i)
-                function_validator.m_context.locals.append(local.type());
+                locals.append(local.type());
         }
 
-        function_validator.m_context.labels = { ResultType { function_type.results() } };
-        function_validator.m_context.return_ = ResultType { function_type.results() };
+        TemporaryChange locals_change { m_context.locals, move(locals) };
+        TemporaryChange labels_change { m_context.labels, Vector<ResultType> { ResultType { function_type.results() } } };
+        TemporaryChange return_change { m_context.return_, Optional<ResultType> { ResultType { function_type.results() } } };
 
-        TRY(function_validator.validate(function.body(), function_type.results()));
+        TRY(validate(function.body(), function_type.results()));
     }
 
     return {};
@@ -1928,7 +1931,7 @@ VALIDATE_INSTRUCTION(structured_end)
         return Errors::invalid("usage of structured end"sv);
 
     auto last_scope = m_entered_scopes.take_last();
-    m_context = m_parent_contexts.take_last();
+    m_context.labels.take_first();
     auto last_block_type = m_entered_blocks.take_last();
 
     switch (last_scope) {
@@ -1986,7 +1989,6 @@ VALIDATE_INSTRUCTION(block)
 
     m_entered_scopes.append(ChildScopeKind::Block);
     m_block_details.empend(stack.actual_size(), Empty {});
-    m_parent_contexts.append(m_context);
     m_entered_blocks.append(block_type);
     m_context.labels.prepend(ResultType { block_type.results() });
     return {};
@@ -2006,7 +2008,6 @@ VALIDATE_INSTRUCTION(loop)
 
     m_entered_scopes.append(ChildScopeKind::Block);
     m_block_details.empend(stack.actual_size(), Empty {});
-    m_parent_contexts.append(m_context);
     m_entered_blocks.append(block_type);
     m_context.labels.prepend(ResultType { block_type.parameters() });
     return {};
@@ -2030,7 +2031,6 @@ VALIDATE_INSTRUCTION(if_)
 
     m_entered_scopes.append(args.else_ip.has_value() ? ChildScopeKind::IfWithElse : ChildScopeKind::IfWithoutElse);
     m_block_details.empend(stack.actual_size(), BlockDetails::IfDetails { move(stack_snapshot) });
-    m_parent_contexts.append(m_context);
     m_entered_blocks.append(block_type);
     m_context.labels.prepend(ResultType { block_type.results() });
     return {};
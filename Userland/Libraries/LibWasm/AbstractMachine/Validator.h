@@ -329,7 +329,6 @@ private:
     };
 
     Context m_context;
-    Vector<Context> m_parent_contexts;
     Vector<ChildScopeKind> m_entered_scopes;
     Vector<BlockDetails> m_block_details;
     Vector<FunctionType> m_entered_blocks;
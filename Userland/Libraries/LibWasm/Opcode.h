@@ -224,8 +224,18 @@ namespace Instructions {
     ENUMERATE_SINGLE_BYTE_WASM_OPCODES(M) \
     ENUMERATE_MULTI_BYTE_WASM_OPCODES(M)
 
+// These are synthetic opcodes as well, but only the bytecode interpreter's pre-decoding pass produces them
+// (out of common sequences of instructions), so they never have to be validated.
+#define ENUMERATE_SYNTHETIC_WASM_OPCODES(M) \
+    M(synthetic_i32_add2local, 0xff02)      \
+    M(synthetic_i32_addconstlocal, 0xff03)  \
+    M(synthetic_i32_andconstlocal, 0xff04)  \
+    M(synthetic_local_seti32_const, 0xff05) \
+    M(synthetic_local_copy, 0xff06)
+
 #define M(name, value) static constexpr OpCode name = value;
 ENUMERATE_WASM_OPCODES(M)
+ENUMERATE_SYNTHETIC_WASM_OPCODES(M)
 #undef M
 
 static constexpr u32 i32_trunc_sat_f32_s_second = 0,
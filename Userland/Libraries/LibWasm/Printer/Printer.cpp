@@ -443,6 +443,8 @@ void Printer::print(Wasm::Instruction const& instruction)
             [&](GlobalIndex const& index) { print("(global index {})", index.value()); },
             [&](LabelIndex const& index) { print("(label index {})", index.value()); },
             [&](LocalIndex const& index) { print("(local index {})", index.value()); },
+            [&](Instruction::LocalPairArgs const& args) { print("(local index {}) (local index {})", args.first.value(), args.second.value()); },
+            [&](Instruction::LocalAndConstantArgs const& args) { print("(local index {}) (i32 {})", args.local.value(), args.constant); },
             [&](TableIndex const& index) { print("(table index {})", index.value()); },
             [&](Instruction::IndirectCallArgs const& args) { print("(indirect (type index {}) (table index {}))", args.type.value(), args.table.value()); },
             [&](Instruction::MemoryArgument const& args) { print("(memory (align {}) (offset {}))", args.align, args.offset); },
@@ -876,5 +878,10 @@ HashMap<Wasm::OpCode, String> Wasm::Names::instruction_names {
     { Instructions::table_fill, "table.fill" },
     { Instructions::structured_else, "synthetic:else" },
     { Instructions::structured_end, "synthetic:end" },
+    { Instructions::synthetic_i32_add2local, "synthetic:i32.add2local" },
+    { Instructions::synthetic_i32_addconstlocal, "synthetic:i32.addconstlocal" },
+    { Instructions::synthetic_i32_andconstlocal, "synthetic:i32.andconstlocal" },
+    { Instructions::synthetic_local_seti32_const, "synthetic:local.seti32.const" },
+    { Instructions::synthetic_local_copy, "synthetic:local.copy" },
 };
 HashMap<String, Wasm::OpCode> Wasm::Names::instructions_by_name;
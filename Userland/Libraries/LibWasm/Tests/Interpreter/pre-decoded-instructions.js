@@ -0,0 +1,52 @@
+// NOTE: The functions in this module are made of sequences that the interpreter fuses into synthetic instructions:
+//       (func $fused (param i32 i32) (result i32) (local i32 i32)
+//           i32.const 7  local.set 2
+//           local.get 0  local.set 3
+//           local.get 2  local.get 3  i32.add
+//           local.get 1  i32.const 255  i32.and
+//           i32.add
+//           local.get 3  i32.const -1  i32.add
+//           i32.mul)
+//       (func $loop (param i32) (result i32) (local i32 i32)
+//           loop  ;; Branches back to a fused instruction.
+//               local.get 1  local.get 2  i32.add  local.set 1
+//               local.get 2  i32.const 1  i32.add  local.tee 2
+//               local.get 0  i32.lt_s  br_if 0
+//           end
+//           local.get 1)
+//       (func $multi (result i32)
+//           block (result i32 i32)
+//               i32.const 1  i32.const 2  br 0
+//           end
+//           i32.sub)
+// prettier-ignore
+const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x15, 0x04, 0x60, 0x02, 0x7f, 0x7f, 0x01,
+        0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x00, 0x02, 0x7f, 0x7f, 0x03,
+        0x04, 0x03, 0x00, 0x01, 0x02, 0x07, 0x18, 0x03, 0x05, 0x66, 0x75, 0x73, 0x65, 0x64, 0x00, 0x00,
+        0x04, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x01, 0x05, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x00, 0x02, 0x0a,
+        0x4a, 0x03, 0x1e, 0x01, 0x02, 0x7f, 0x41, 0x07, 0x21, 0x02, 0x20, 0x00, 0x21, 0x03, 0x20, 0x02,
+        0x20, 0x03, 0x6a, 0x20, 0x01, 0x41, 0xff, 0x01, 0x71, 0x6a, 0x20, 0x03, 0x41, 0x7f, 0x6a, 0x6c,
+        0x0b, 0x1c, 0x01, 0x02, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x20, 0x02, 0x6a, 0x21, 0x01, 0x20, 0x02,
+        0x41, 0x01, 0x6a, 0x22, 0x02, 0x20, 0x00, 0x48, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b, 0x0c, 0x00,
+        0x02, 0x03, 0x41, 0x01, 0x41, 0x02, 0x0c, 0x00, 0x0b, 0x6b, 0x0b,
+]);
+
+test("fused instructions", () => {
+    const module = parseWebAssemblyModule(binary);
+    const fused = module.getExport("fused");
+    expect(module.invoke(fused, 5, 300)).toBe((7 + 5 + (300 & 255)) * (5 - 1));
+    expect(module.invoke(fused, 0, 0)).toBe(-7);
+    expect(module.invoke(fused, 2147483647, 1)).toBe(2147483634);
+});
+
+test("branching to a fused instruction", () => {
+    const module = parseWebAssemblyModule(binary);
+    expect(module.invoke(module.getExport("loop"), 10)).toBe(45);
+    expect(module.invoke(module.getExport("loop"), 0)).toBe(0);
+});
+
+test("branching with more than one result keeps them in order", () => {
+    const module = parseWebAssemblyModule(binary);
+    expect(module.invoke(module.getExport("multi"))).toBe(-1);
+});
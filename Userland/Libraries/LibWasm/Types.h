@@ -422,6 +422,16 @@ public:
         u32 offset;
     };
 
+    struct LocalPairArgs {
+        LocalIndex first;
+        LocalIndex second;
+    };
+
+    struct LocalAndConstantArgs {
+        LocalIndex local;
+        i32 constant;
+    };
+
     template<typename T>
     explicit Instruction(OpCode opcode, T argument)
         : m_opcode(opcode)
@@ -445,7 +455,9 @@ private:
         GlobalIndex,
         IndirectCallArgs,
         LabelIndex,
+        LocalAndConstantArgs,
         LocalIndex,
+        LocalPairArgs,
         MemoryArgument,
         StructuredInstructionArgs,
         TableBranchArgs,
@@ -641,10 +653,16 @@ public:
 
     auto& instructions() const { return m_instructions; }
 
+    // What the bytecode interpreter actually runs, see BytecodeInterpreter::pre_decode().
+    // NOTE: Each pre-decoded instruction is at the same position as the instruction it came from.
+    auto& pre_decoded_instructions() const { return m_pre_decoded_instructions.has_value() ? *m_pre_decoded_instructions : m_instructions; }
+    void set_pre_decoded_instructions(Vector<Instruction> instructions) const { m_pre_decoded_instructions = move(instructions); }
+
     static ParseResult<Expression> parse(InputStream& stream);
 
 private:
     Vector<Instruction> m_instructions;
+    mutable Optional<Vector<Instruction>> m_pre_decoded_instructions;
 };
 
 class GlobalSection {
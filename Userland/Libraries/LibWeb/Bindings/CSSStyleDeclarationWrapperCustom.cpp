@@ -32,7 +32,7 @@ JS::ThrowCompletionOr<bool> CSSStyleDeclarationWrapper::internal_has_property(JS
     return property_id_from_name(name.to_string()) != CSS::PropertyID::Invalid;
 }
 
-JS::ThrowCompletionOr<JS::Value> CSSStyleDeclarationWrapper::internal_get(JS::PropertyKey const& name, JS::Value receiver) const
+JS::ThrowCompletionOr<JS::Value> CSSStyleDeclarationWrapper::internal_get(JS::PropertyKey const& name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (!name.is_string())
         return Base::internal_get(name, receiver);
@@ -44,7 +44,7 @@ JS::ThrowCompletionOr<JS::Value> CSSStyleDeclarationWrapper::internal_get(JS::Pr
     return { js_string(vm(), String::empty()) };
 }
 
-JS::ThrowCompletionOr<bool> CSSStyleDeclarationWrapper::internal_set(JS::PropertyKey const& name, JS::Value value, JS::Value receiver)
+JS::ThrowCompletionOr<bool> CSSStyleDeclarationWrapper::internal_set(JS::PropertyKey const& name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     if (!name.is_string())
         return Base::internal_set(name, value, receiver);
@@ -10,6 +10,14 @@
 namespace Web {
 namespace Bindings {
 
+Wrapper* Wrappable::wrapper()
+{
+    // NOTE: The wrapper may have died without having been swept yet.
+    if (m_wrapper)
+        m_wrapper->heap().sweep_cell_if_dead(*m_wrapper);
+    return m_wrapper;
+}
+
 void Wrappable::set_wrapper(Wrapper& wrapper)
 {
     VERIFY(!m_wrapper);
@@ -18,8 +18,8 @@ public:
     virtual ~Wrappable() = default;
 
     void set_wrapper(Wrapper&);
-    Wrapper* wrapper() { return m_wrapper; }
-    Wrapper const* wrapper() const { return m_wrapper; }
+    Wrapper* wrapper();
+    Wrapper const* wrapper() const { return const_cast<Wrappable*>(this)->wrapper(); }
 
 private:
     WeakPtr<Wrapper> m_wrapper;
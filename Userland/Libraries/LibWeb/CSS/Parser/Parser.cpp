@@ -26,6 +26,7 @@
 #include <LibWeb/CSS/Parser/Function.h>
 #include <LibWeb/CSS/Parser/Parser.h>
 #include <LibWeb/CSS/Parser/Rule.h>
+#include <LibWeb/CSS/Parser/StyleSheetCache.h>
 #include <LibWeb/CSS/Selector.h>
 #include <LibWeb/CSS/StyleValue.h>
 #include <LibWeb/DOM/Document.h>
@@ -182,12 +183,21 @@ Parser::ParsedStyleSheet Parser::parse_a_stylesheet(TokenStream<T>& tokens, Opti
 NonnullRefPtr<CSSStyleSheet> Parser::parse_as_css_stylesheet(Optional<AK::URL> location)
 {
     // To parse a CSS stylesheet, first parse a stylesheet.
-    auto style_sheet = parse_a_stylesheet(m_token_stream, {});
+    auto raw_rules = parse_as_stylesheet_rules();
+    return convert_to_css_stylesheet(raw_rules, move(location));
+}
 
+NonnullRefPtrVector<Rule> Parser::parse_as_stylesheet_rules()
+{
+    return parse_a_stylesheet(m_token_stream, {}).rules;
+}
+
+NonnullRefPtr<CSSStyleSheet> Parser::convert_to_css_stylesheet(NonnullRefPtrVector<Rule> const& raw_rules, Optional<AK::URL> location)
+{
     // Interpret all of the resulting top-level qualified rules as style rules, defined below.
     NonnullRefPtrVector<CSSRule> rules;
-    for (auto& raw_rule : style_sheet.rules) {
-        auto rule = convert_to_rule(raw_rule);
+    for (size_t i = 0; i < raw_rules.size(); ++i) {
+        auto rule = convert_to_rule(raw_rules.ptr_at(i));
         // If any style rule is invalid, or any at-rule is not recognized or is invalid according to its grammar or context, it’s a parse error. Discard that rule.
         if (rule)
             rules.append(*rule);
@@ -6377,8 +6387,18 @@ RefPtr<CSS::CSSStyleSheet> parse_css_stylesheet(CSS::Parser::ParsingContext cons
 {
     if (css.is_empty())
         return CSS::CSSStyleSheet::create({}, location);
-    CSS::Parser::Parser parser(context, css);
-    return parser.parse_as_css_stylesheet(location);
+
+    auto& cache = CSS::Parser::StyleSheetCache::the();
+    auto raw_rules = cache.lookup(css);
+    if (!raw_rules.has_value()) {
+        CSS::Parser::Parser parser(context, css);
+        raw_rules = parser.parse_as_stylesheet_rules();
+        cache.store(css, *raw_rules);
+    }
+
+    // Note: The rules are already parsed, so this parser has no text of its own.
+    CSS::Parser::Parser parser(context, ""sv);
+    return parser.convert_to_css_stylesheet(*raw_rules, move(location));
 }
 
 RefPtr<CSS::ElementInlineCSSStyleDeclaration> parse_css_style_attribute(CSS::Parser::ParsingContext const& context, StringView css, DOM::Element& element)
@@ -123,6 +123,10 @@ public:
     ~Parser() = default;
 
     NonnullRefPtr<CSSStyleSheet> parse_as_css_stylesheet(Optional<AK::URL> location);
+    // Parsing a stylesheet into rules doesn't depend on the context, only interpreting them does,
+    // so the rules can be shared between documents (see StyleSheetCache).
+    NonnullRefPtrVector<Rule> parse_as_stylesheet_rules();
+    NonnullRefPtr<CSSStyleSheet> convert_to_css_stylesheet(NonnullRefPtrVector<Rule> const&, Optional<AK::URL> location);
     RefPtr<ElementInlineCSSStyleDeclaration> parse_as_style_attribute(DOM::Element&);
     RefPtr<CSSRule> parse_as_css_rule();
     Optional<StyleProperty> parse_as_supports_condition();
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWeb/CSS/Parser/StyleSheetCache.h>
+
+namespace Web::CSS::Parser {
+
+StyleSheetCache& StyleSheetCache::the()
+{
+    static StyleSheetCache cache;
+    return cache;
+}
+
+Optional<NonnullRefPtrVector<Rule>> StyleSheetCache::lookup(StringView css)
+{
+    if (auto* rules = m_entries.get(css))
+        return *rules;
+    return {};
+}
+
+void StyleSheetCache::store(StringView css, NonnullRefPtrVector<Rule> const& rules)
+{
+    m_entries.set(css, rules);
+}
+
+void StyleSheetCache::clear()
+{
+    m_entries.clear();
+}
+
+}
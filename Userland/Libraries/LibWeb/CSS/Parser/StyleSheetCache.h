@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/LRUCache.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <LibWeb/CSS/Parser/Rule.h>
+
+namespace Web::CSS::Parser {
+
+// The rules of stylesheets that were parsed recently, keyed by their text. Turning text into rules doesn't depend on
+// the document, so a stylesheet that many documents use (e.g. every page of a site) is only tokenized and parsed once,
+// and each document merely interprets the rules for itself.
+class StyleSheetCache {
+public:
+    static StyleSheetCache& the();
+
+    Optional<NonnullRefPtrVector<Rule>> lookup(StringView css);
+    void store(StringView css, NonnullRefPtrVector<Rule> const&);
+
+    void clear();
+
+    // The cache is limited by the size of the stylesheet text, which the size of the rules is roughly proportional to.
+    static constexpr size_t text_size_budget = 4 * MiB;
+
+private:
+    StyleSheetCache() = default;
+
+    LRUCache<String, NonnullRefPtrVector<Rule>> m_entries { text_size_budget, [](String const& text, NonnullRefPtrVector<Rule> const&) { return text.length(); } };
+};
+
+}
@@ -6,6 +6,7 @@
  */
 
 #include "Selector.h"
+#include <AK/StringHash.h>
 #include <LibWeb/CSS/Serialize.h>
 
 namespace Web::CSS {
@@ -23,6 +24,48 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    collect_ancestor_hashes();
+}
+
+u32 Selector::ancestor_hash(SimpleSelector::Type type, StringView name)
+{
+    // NOTE: Tag names and classes can match regardless of case, so we ignore it for all of them.
+    //       That can only make the ancestor filter let through a few more selectors than it has to.
+    return AK::case_insensitive_string_hash(name.characters_without_null_termination(), name.length(), to_underlying(type));
+}
+
+void Selector::collect_ancestor_hashes()
+{
+    size_t hash_count = 0;
+    auto append_hash = [&](u32 hash) {
+        if (hash == 0 || hash_count == m_ancestor_hashes.size())
+            return;
+        for (size_t i = 0; i < hash_count; ++i) {
+            if (m_ancestor_hashes[i] == hash)
+                return;
+        }
+        m_ancestor_hashes[hash_count++] = hash;
+    };
+
+    // Everything to the left of a descendant or child combinator has to match one of the ancestors.
+    // NOTE: We stop at the first sibling combinator, as it's not worth untangling the cases where that's still true.
+    for (size_t i = m_compound_selectors.size() - 1; i > 0; --i) {
+        auto combinator = m_compound_selectors[i].combinator;
+        if (combinator != Combinator::Descendant && combinator != Combinator::ImmediateChild)
+            break;
+        for (auto const& simple_selector : m_compound_selectors[i - 1].simple_selectors) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::TagName:
+            case SimpleSelector::Type::Id:
+            case SimpleSelector::Type::Class:
+                append_hash(ancestor_hash(simple_selector.type, simple_selector.name()));
+                break;
+            default:
+                break;
+            }
+        }
+    }
 }
 
 // https://www.w3.org/TR/selectors-4/#specificity-rules
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/RefCounted.h>
@@ -185,12 +186,20 @@ public:
     u32 specificity() const;
     String serialize() const;
 
+    // Hashes of tag names, IDs and classes that the ancestors of any element matching this selector have, see ancestor_hash().
+    // NOTE: Unused entries are 0.
+    auto const& ancestor_hashes() const { return m_ancestor_hashes; }
+    static u32 ancestor_hash(SimpleSelector::Type, StringView name);
+
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+
     Vector<CompoundSelector> m_compound_selectors;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
+    Array<u32, 8> m_ancestor_hashes {};
 };
 
 constexpr StringView pseudo_element_name(Selector::PseudoElement pseudo_element)
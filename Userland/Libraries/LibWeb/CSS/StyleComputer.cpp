@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
+#include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
 #include <AK/QuickSort.h>
 #include <AK/TemporaryChange.h>
@@ -22,11 +24,14 @@
 #include <LibWeb/CSS/SelectorEngine.h>
 #include <LibWeb/CSS/StyleComputer.h>
 #include <LibWeb/CSS/StyleSheet.h>
+#include <LibWeb/DOM/Attribute.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/FontCache.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
+#include <LibWeb/HTML/HTMLInputElement.h>
 #include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Namespace.h>
 #include <stdio.h>
 
 namespace Web::CSS {
@@ -145,6 +150,97 @@ void StyleComputer::for_each_stylesheet(CascadeOrigin cascade_origin, Callback c
     }
 }
 
+template<typename Callback>
+static void for_each_ancestor_hash(DOM::Element const& element, Callback callback)
+{
+    callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::TagName, element.local_name()));
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_null())
+        callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::Id, id));
+    for (auto const& class_name : element.class_names())
+        callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::Class, class_name));
+}
+
+void StyleComputer::push_ancestor(DOM::Element const& element)
+{
+    size_t hash_count = 0;
+    for_each_ancestor_hash(element, [&](u32 hash) {
+        m_ancestor_filter.add(hash);
+        m_ancestor_hashes.append(hash);
+        ++hash_count;
+    });
+    m_ancestors.append({ &element, hash_count });
+}
+
+void StyleComputer::pop_ancestor(DOM::Element const& element)
+{
+    // NOTE: We remove the hashes we added, since the element's classes and ID may have changed since it was pushed.
+    auto ancestor = m_ancestors.take_last();
+    VERIFY(ancestor.element == &element);
+    for (size_t i = 0; i < ancestor.hash_count; ++i)
+        m_ancestor_filter.remove(m_ancestor_hashes.take_last());
+}
+
+bool StyleComputer::ancestor_filter_rejects(Selector const& selector, DOM::Element const& element) const
+{
+    // The filter only describes the ancestors of the element if we're in the middle of traversing the tree down to it.
+    if (m_ancestors.is_empty() || m_ancestors.last().element != element.parent_element())
+        return false;
+
+    for (auto hash : selector.ancestor_hashes()) {
+        if (hash == 0)
+            break;
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
+static bool element_may_match_pseudo_class(Selector::SimpleSelector::PseudoClass::Type type, DOM::Element const& element)
+{
+    switch (type) {
+    case Selector::SimpleSelector::PseudoClass::Type::Link:
+        return element.is_link();
+    case Selector::SimpleSelector::PseudoClass::Type::Visited:
+        // NOTE: SelectorEngine never matches :visited, so there's no point in running these rules.
+        return false;
+    case Selector::SimpleSelector::PseudoClass::Type::Active:
+        return element.is_active();
+    case Selector::SimpleSelector::PseudoClass::Type::Hover: {
+        auto const* hovered_node = element.document().hovered_node();
+        return hovered_node && element.is_inclusive_ancestor_of(*hovered_node);
+    }
+    case Selector::SimpleSelector::PseudoClass::Type::Focus:
+        return element.is_focused();
+    case Selector::SimpleSelector::PseudoClass::Type::FocusWithin: {
+        auto const* focused_element = element.document().focused_element();
+        return focused_element && element.is_inclusive_ancestor_of(*focused_element);
+    }
+    case Selector::SimpleSelector::PseudoClass::Type::Checked:
+        return is<HTML::HTMLInputElement>(element);
+    case Selector::SimpleSelector::PseudoClass::Type::Root:
+        return is<HTML::HTMLHtmlElement>(element);
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static bool can_bucket_by_pseudo_class(Selector::SimpleSelector::PseudoClass::Type type)
+{
+    switch (type) {
+    case Selector::SimpleSelector::PseudoClass::Type::Link:
+    case Selector::SimpleSelector::PseudoClass::Type::Visited:
+    case Selector::SimpleSelector::PseudoClass::Type::Active:
+    case Selector::SimpleSelector::PseudoClass::Type::Hover:
+    case Selector::SimpleSelector::PseudoClass::Type::Focus:
+    case Selector::SimpleSelector::PseudoClass::Type::FocusWithin:
+    case Selector::SimpleSelector::PseudoClass::Type::Checked:
+    case Selector::SimpleSelector::PseudoClass::Type::Root:
+        return true;
+    default:
+        return false;
+    }
+}
+
 Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& element, CascadeOrigin cascade_origin, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
     if (cascade_origin == CascadeOrigin::Author) {
@@ -163,6 +259,20 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
             }
             if (auto it = m_rule_cache->rules_by_tag_name.find(element.local_name()); it != m_rule_cache->rules_by_tag_name.end())
                 rules_to_run.extend(it->value);
+            if (!m_rule_cache->rules_by_attribute_name.is_empty()) {
+                element.for_each_attribute([&](auto const& name, auto const&) {
+                    // NOTE: Attribute selectors are lowercased by the parser, and HTML elements match them regardless of case.
+                    auto it = m_rule_cache->rules_by_attribute_name.find(name);
+                    if (it == m_rule_cache->rules_by_attribute_name.end() && element.namespace_uri() == Namespace::HTML && any_of(name.view(), is_ascii_upper_alpha))
+                        it = m_rule_cache->rules_by_attribute_name.find(name.to_lowercase());
+                    if (it != m_rule_cache->rules_by_attribute_name.end())
+                        rules_to_run.extend(it->value);
+                });
+            }
+            for (auto const& it : m_rule_cache->rules_by_pseudo_class) {
+                if (element_may_match_pseudo_class(it.key, element))
+                    rules_to_run.extend(it.value);
+            }
             rules_to_run.extend(m_rule_cache->other_rules);
         }
 
@@ -170,6 +280,8 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         matching_rules.ensure_capacity(rules_to_run.size());
         for (auto const& rule_to_run : rules_to_run) {
             auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+            if (ancestor_filter_rejects(selector, element))
+                continue;
             if (SelectorEngine::matches(selector, element, pseudo_element))
                 matching_rules.append(rule_to_run);
         }
@@ -183,7 +295,7 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element, pseudo_element)) {
+                if (!ancestor_filter_rejects(selector, element) && SelectorEngine::matches(selector, element, pseudo_element)) {
                     matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
                     break;
                 }
@@ -1186,8 +1298,67 @@ NonnullRefPtr<StyleProperties> StyleComputer::create_document_style() const
     return style;
 }
 
+static bool can_share_style(DOM::Element const& element)
+{
+    // NOTE: SelectorEngine looks at more than attributes for these, so we'd have to compare them too.
+    if (is<HTML::HTMLInputElement>(element))
+        return false;
+    if (element.inline_style())
+        return false;
+    for (auto type : { Selector::SimpleSelector::PseudoClass::Type::Hover, Selector::SimpleSelector::PseudoClass::Type::Focus, Selector::SimpleSelector::PseudoClass::Type::FocusWithin, Selector::SimpleSelector::PseudoClass::Type::Active }) {
+        if (element_may_match_pseudo_class(type, element))
+            return false;
+    }
+    return true;
+}
+
+static bool have_same_attributes(DOM::Element const& a, DOM::Element const& b)
+{
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+    for (size_t i = 0; i < a.attribute_list_size(); ++i) {
+        auto const* a_attribute = a.attributes()->item(i);
+        auto const* b_attribute = b.attributes()->item(i);
+        if (a_attribute->name() != b_attribute->name() || a_attribute->value() != b_attribute->value())
+            return false;
+    }
+    return true;
+}
+
+// Siblings that have the same tag name and attributes match the same selectors, unless a selector looks at the position
+// of an element among its siblings, or at some state we can't tell from the attributes. In that case we can simply
+// reuse the style we already computed for the sibling. This helps a lot with lists, tables and the like.
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element const& element) const
+{
+    static constexpr size_t max_siblings_to_look_at = 8;
+
+    if (!element.parent_element() || !can_share_style(element))
+        return nullptr;
+
+    build_invalidation_data_if_needed();
+    if (m_invalidation_data->has_structural_selectors)
+        return nullptr;
+
+    size_t siblings_looked_at = 0;
+    for (auto const* sibling = element.previous_element_sibling(); sibling && siblings_looked_at < max_siblings_to_look_at; sibling = sibling->previous_element_sibling(), ++siblings_looked_at) {
+        if (!sibling->computed_css_values() || sibling->needs_style_update())
+            continue;
+        if (sibling->local_name() != element.local_name() || sibling->namespace_uri() != element.namespace_uri())
+            continue;
+        if (!have_same_attributes(*sibling, element) || !can_share_style(*sibling))
+            continue;
+        return const_cast<StyleProperties*>(sibling->computed_css_values());
+    }
+    return nullptr;
+}
+
 NonnullRefPtr<StyleProperties> StyleComputer::compute_style(DOM::Element& element, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
+    if (!pseudo_element.has_value()) {
+        if (auto style = find_shareable_style(element))
+            return style.release_nonnull();
+    }
+
     build_rule_cache_if_needed();
 
     auto style = StyleProperties::create();
@@ -1255,6 +1426,8 @@ void StyleComputer::build_rule_cache()
     size_t num_class_rules = 0;
     size_t num_id_rules = 0;
     size_t num_tag_name_rules = 0;
+    size_t num_attribute_rules = 0;
+    size_t num_pseudo_class_rules = 0;
     size_t num_pseudo_element_rules = 0;
 
     Vector<MatchingRule> matching_rules;
@@ -1297,6 +1470,26 @@ void StyleComputer::build_rule_cache()
                         }
                     }
                 }
+                if (!added_to_bucket) {
+                    for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
+                        if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Attribute) {
+                            m_rule_cache->rules_by_attribute_name.ensure(simple_selector.attribute().name).append(move(matching_rule));
+                            ++num_attribute_rules;
+                            added_to_bucket = true;
+                            break;
+                        }
+                    }
+                }
+                if (!added_to_bucket) {
+                    for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
+                        if (simple_selector.type == CSS::Selector::SimpleSelector::Type::PseudoClass && can_bucket_by_pseudo_class(simple_selector.pseudo_class().type)) {
+                            m_rule_cache->rules_by_pseudo_class.ensure(simple_selector.pseudo_class().type).append(move(matching_rule));
+                            ++num_pseudo_class_rules;
+                            added_to_bucket = true;
+                            break;
+                        }
+                    }
+                }
                 if (!added_to_bucket)
                     m_rule_cache->other_rules.append(move(matching_rule));
 
@@ -1312,15 +1505,284 @@ void StyleComputer::build_rule_cache()
         dbgln("           ID: {}", num_id_rules);
         dbgln("        Class: {}", num_class_rules);
         dbgln("      TagName: {}", num_tag_name_rules);
+        dbgln("    Attribute: {}", num_attribute_rules);
+        dbgln("  PseudoClass: {}", num_pseudo_class_rules);
         dbgln("PseudoElement: {}", num_pseudo_element_rules);
         dbgln("        Other: {}", m_rule_cache->other_rules.size());
-        dbgln("        Total: {}", num_class_rules + num_id_rules + num_tag_name_rules + m_rule_cache->other_rules.size());
+        dbgln("        Total: {}", num_class_rules + num_id_rules + num_tag_name_rules + num_attribute_rules + num_pseudo_class_rules + num_pseudo_element_rules + m_rule_cache->other_rules.size());
     }
 }
 
 void StyleComputer::invalidate_rule_cache()
 {
     m_rule_cache = nullptr;
+    m_invalidation_data = nullptr;
+}
+
+static bool is_structural_pseudo_class(Selector::SimpleSelector::PseudoClass::Type type)
+{
+    switch (type) {
+    case Selector::SimpleSelector::PseudoClass::Type::FirstChild:
+    case Selector::SimpleSelector::PseudoClass::Type::LastChild:
+    case Selector::SimpleSelector::PseudoClass::Type::OnlyChild:
+    case Selector::SimpleSelector::PseudoClass::Type::NthChild:
+    case Selector::SimpleSelector::PseudoClass::Type::NthLastChild:
+    case Selector::SimpleSelector::PseudoClass::Type::Empty:
+    case Selector::SimpleSelector::PseudoClass::Type::Root:
+    case Selector::SimpleSelector::PseudoClass::Type::FirstOfType:
+    case Selector::SimpleSelector::PseudoClass::Type::LastOfType:
+    case Selector::SimpleSelector::PseudoClass::Type::OnlyOfType:
+    case Selector::SimpleSelector::PseudoClass::Type::NthOfType:
+    case Selector::SimpleSelector::PseudoClass::Type::NthLastOfType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// NOTE: This has to be kept in sync with how SelectorEngine matches these pseudo-classes.
+static FlyString attribute_name_pseudo_class_depends_on(Selector::SimpleSelector::PseudoClass::Type type)
+{
+    switch (type) {
+    case Selector::SimpleSelector::PseudoClass::Type::Link:
+        return HTML::AttributeNames::href;
+    case Selector::SimpleSelector::PseudoClass::Type::Disabled:
+    case Selector::SimpleSelector::PseudoClass::Type::Enabled:
+        return HTML::AttributeNames::disabled;
+    case Selector::SimpleSelector::PseudoClass::Type::Checked:
+        return HTML::AttributeNames::type;
+    case Selector::SimpleSelector::PseudoClass::Type::Lang:
+        return HTML::AttributeNames::lang;
+    default:
+        return {};
+    }
+}
+
+void StyleComputer::build_invalidation_data_if_needed() const
+{
+    if (m_invalidation_data)
+        return;
+    const_cast<StyleComputer&>(*this).build_invalidation_data();
+}
+
+void StyleComputer::build_invalidation_data()
+{
+    m_invalidation_data = make<InvalidationData>();
+    auto& data = *m_invalidation_data;
+
+    enum class Position {
+        // The feature is in the rightmost compound selector.
+        Subject,
+        // The feature is only followed by descendant and child combinators.
+        Ancestor,
+        // The feature is followed by a sibling combinator somewhere.
+        SiblingOrAncestorOfSibling,
+        // The feature is inside the argument of a pseudo-class like :is() or :not(), so we don't bother working out where it is.
+        Unknown,
+    };
+
+    auto add_feature = [&](InvalidationSet& set, Position position, Selector::SimpleSelector const* subject_feature) {
+        switch (position) {
+        case Position::Subject:
+            set.invalidates_self = true;
+            break;
+        case Position::Ancestor:
+            if (!subject_feature) {
+                set.invalidates_subtree = true;
+                break;
+            }
+            switch (subject_feature->type) {
+            case Selector::SimpleSelector::Type::Class:
+                set.descendant_classes.set(subject_feature->name());
+                break;
+            case Selector::SimpleSelector::Type::Id:
+                set.descendant_ids.set(subject_feature->name());
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                set.descendant_attribute_names.set(subject_feature->attribute().name);
+                break;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+            break;
+        case Position::SiblingOrAncestorOfSibling:
+            set.invalidates_subtree = true;
+            set.invalidates_following_siblings = true;
+            break;
+        case Position::Unknown:
+            set.invalidates_self = true;
+            set.invalidates_subtree = true;
+            set.invalidates_following_siblings = true;
+            break;
+        }
+    };
+
+    Function<void(Selector const&, bool)> add_selector = [&](Selector const& selector, bool is_nested) {
+        auto const& compound_selectors = selector.compound_selectors();
+
+        // A class, ID or attribute that every element matching the selector has. Changes to ancestors only have to look at descendants that have it.
+        Selector::SimpleSelector const* subject_feature = nullptr;
+        for (auto const& simple_selector : compound_selectors.last().simple_selectors) {
+            if (simple_selector.type == Selector::SimpleSelector::Type::Class || simple_selector.type == Selector::SimpleSelector::Type::Id || simple_selector.type == Selector::SimpleSelector::Type::Attribute) {
+                subject_feature = &simple_selector;
+                break;
+            }
+        }
+
+        bool has_sibling_combinator_to_the_right = false;
+        for (size_t i = compound_selectors.size(); i-- > 0;) {
+            auto position = Position::Ancestor;
+            if (is_nested)
+                position = Position::Unknown;
+            else if (i == compound_selectors.size() - 1)
+                position = Position::Subject;
+            else if (has_sibling_combinator_to_the_right)
+                position = Position::SiblingOrAncestorOfSibling;
+
+            for (auto const& simple_selector : compound_selectors[i].simple_selectors) {
+                switch (simple_selector.type) {
+                case Selector::SimpleSelector::Type::Class:
+                    add_feature(data.class_invalidation_sets.ensure(simple_selector.name()), position, subject_feature);
+                    break;
+                case Selector::SimpleSelector::Type::Id:
+                    add_feature(data.id_invalidation_sets.ensure(simple_selector.name()), position, subject_feature);
+                    break;
+                case Selector::SimpleSelector::Type::Attribute:
+                    add_feature(data.attribute_invalidation_sets.ensure(simple_selector.attribute().name), position, subject_feature);
+                    break;
+                case Selector::SimpleSelector::Type::PseudoClass: {
+                    auto const& pseudo_class = simple_selector.pseudo_class();
+                    if (is_structural_pseudo_class(pseudo_class.type))
+                        data.has_structural_selectors = true;
+                    if (auto attribute_name = attribute_name_pseudo_class_depends_on(pseudo_class.type); !attribute_name.is_null()) {
+                        auto& set = data.attribute_invalidation_sets.ensure(attribute_name);
+                        add_feature(set, position, subject_feature);
+                        // NOTE: :link and :lang() look at the ancestors of the element too.
+                        if (pseudo_class.type == Selector::SimpleSelector::PseudoClass::Type::Link || pseudo_class.type == Selector::SimpleSelector::PseudoClass::Type::Lang)
+                            set.invalidates_subtree = true;
+                    }
+                    for (auto const& argument_selector : pseudo_class.argument_selector_list)
+                        add_selector(argument_selector, true);
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+
+            auto combinator = compound_selectors[i].combinator;
+            if (combinator == Selector::Combinator::NextSibling || combinator == Selector::Combinator::SubsequentSibling) {
+                has_sibling_combinator_to_the_right = true;
+                data.has_structural_selectors = true;
+            }
+        }
+    };
+
+    auto add_rules_from_sheets = [&](CascadeOrigin cascade_origin) {
+        for_each_stylesheet(cascade_origin, [&](auto& sheet) {
+            static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
+                for (auto const& selector : rule.selectors())
+                    add_selector(selector, false);
+            });
+        });
+    };
+    add_rules_from_sheets(CascadeOrigin::UserAgent);
+    add_rules_from_sheets(CascadeOrigin::Author);
+
+    if constexpr (LIBWEB_CSS_DEBUG) {
+        dbgln("Built invalidation data!");
+        dbgln("     Classes: {}", data.class_invalidation_sets.size());
+        dbgln("         IDs: {}", data.id_invalidation_sets.size());
+        dbgln("  Attributes: {}", data.attribute_invalidation_sets.size());
+        dbgln("  Structural: {}", data.has_structural_selectors);
+    }
+}
+
+void StyleComputer::apply_invalidation_set(InvalidationSet const& set, DOM::Element& element) const
+{
+    if (set.invalidates_subtree)
+        element.invalidate_style();
+    else if (set.invalidates_self)
+        element.set_needs_style_update(true);
+
+    bool has_descendant_features = !set.descendant_classes.is_empty() || !set.descendant_ids.is_empty() || !set.descendant_attribute_names.is_empty();
+    if (has_descendant_features && !set.invalidates_subtree) {
+        element.for_each_in_subtree_of_type<DOM::Element>([&](DOM::Element& descendant) {
+            if (descendant.needs_style_update())
+                return IterationDecision::Continue;
+            bool is_affected = any_of(descendant.class_names(), [&](auto const& class_name) { return set.descendant_classes.contains(class_name); });
+            if (!is_affected && !set.descendant_ids.is_empty()) {
+                if (auto id = descendant.attribute(HTML::AttributeNames::id); !id.is_null())
+                    is_affected = set.descendant_ids.contains(id);
+            }
+            if (!is_affected && !set.descendant_attribute_names.is_empty()) {
+                descendant.for_each_attribute([&](auto const& name, auto const&) {
+                    if (set.descendant_attribute_names.contains(name))
+                        is_affected = true;
+                });
+            }
+            if (is_affected)
+                descendant.set_needs_style_update(true);
+            return IterationDecision::Continue;
+        });
+    }
+
+    if (set.invalidates_following_siblings) {
+        for (auto* sibling = element.next_element_sibling(); sibling; sibling = sibling->next_element_sibling())
+            sibling->invalidate_style();
+    }
+}
+
+void StyleComputer::invalidate_style_after_attribute_change(DOM::Element& element, FlyString const& attribute_name, String const& old_value, String const& new_value)
+{
+    if (old_value == new_value)
+        return;
+
+    build_invalidation_data_if_needed();
+    auto const& data = *m_invalidation_data;
+
+    auto apply_sets_for_changed_tokens = [&](HashMap<FlyString, InvalidationSet> const& sets, auto old_tokens, auto new_tokens) {
+        for (auto const& token : old_tokens) {
+            if (new_tokens.contains_slow(token))
+                continue;
+            if (auto it = sets.find(token); it != sets.end())
+                apply_invalidation_set(it->value, element);
+        }
+        for (auto const& token : new_tokens) {
+            if (old_tokens.contains_slow(token))
+                continue;
+            if (auto it = sets.find(token); it != sets.end())
+                apply_invalidation_set(it->value, element);
+        }
+    };
+
+    if (attribute_name == HTML::AttributeNames::class_) {
+        // NOTE: This has to split the value the same way as Element::parse_attribute().
+        apply_sets_for_changed_tokens(data.class_invalidation_sets, old_value.split_view(is_ascii_space), new_value.split_view(is_ascii_space));
+    } else if (attribute_name == HTML::AttributeNames::id) {
+        Vector<StringView, 1> old_ids;
+        Vector<StringView, 1> new_ids;
+        if (!old_value.is_null())
+            old_ids.append(old_value);
+        if (!new_value.is_null())
+            new_ids.append(new_value);
+        apply_sets_for_changed_tokens(data.id_invalidation_sets, move(old_ids), move(new_ids));
+    } else {
+        // Any other attribute may be a presentational hint, or the inline style.
+        element.set_needs_style_update(true);
+    }
+
+    if (auto it = data.attribute_invalidation_sets.find(attribute_name); it != data.attribute_invalidation_sets.end())
+        apply_invalidation_set(it->value, element);
+}
+
+void StyleComputer::invalidate_style_after_children_changed(DOM::Node& node)
+{
+    build_invalidation_data_if_needed();
+
+    // Without selectors that look at siblings, inserting or removing nodes can only change the style of the nodes themselves.
+    if (m_invalidation_data->has_structural_selectors)
+        node.invalidate_style();
 }
 
 Gfx::IntRect StyleComputer::viewport_rect() const
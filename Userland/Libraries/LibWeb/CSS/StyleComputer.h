@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <AK/CountingBloomFilter.h>
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
@@ -70,6 +72,19 @@ public:
 
     void invalidate_rule_cache();
 
+    // Marks the elements whose style may change because an attribute of the given element changed.
+    // NOTE: A null value means that the attribute wasn't there before, or isn't there anymore.
+    void invalidate_style_after_attribute_change(DOM::Element&, FlyString const& attribute_name, String const& old_value, String const& new_value);
+
+    // Marks the elements whose style may change because children were inserted into or removed from the given node.
+    // NOTE: The inserted nodes themselves already need a style update.
+    void invalidate_style_after_children_changed(DOM::Node&);
+
+    // While the style tree is traversed, the elements above the one whose style is computed next are pushed here.
+    // That lets selectors whose ancestors can't all be there be rejected without walking up the tree.
+    void push_ancestor(DOM::Element const&);
+    void pop_ancestor(DOM::Element const&);
+
     Gfx::Font const& initial_font() const;
 
     void did_load_font(FlyString const& family_name);
@@ -99,22 +114,60 @@ private:
         Vector<MatchingRule> author_rules;
     };
 
+    bool ancestor_filter_rejects(Selector const&, DOM::Element const&) const;
+
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element const&) const;
+
     void cascade_declarations(StyleProperties&, DOM::Element&, Vector<MatchingRule> const&, CascadeOrigin, Important important) const;
 
     void build_rule_cache();
     void build_rule_cache_if_needed() const;
 
+    struct InvalidationSet;
+    void build_invalidation_data();
+    void build_invalidation_data_if_needed() const;
+    void apply_invalidation_set(InvalidationSet const&, DOM::Element&) const;
+
     DOM::Document& m_document;
 
     struct RuleCache {
         HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
         HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_attribute_name;
+        HashMap<Selector::SimpleSelector::PseudoClass::Type, Vector<MatchingRule>> rules_by_pseudo_class;
         HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
     };
     OwnPtr<RuleCache> m_rule_cache;
 
+    // Describes which elements may stop or start matching some selector when a class, ID or attribute of an element changes.
+    struct InvalidationSet {
+        bool invalidates_self { false };
+        bool invalidates_subtree { false };
+        bool invalidates_following_siblings { false };
+        // Descendants that have any of these may be affected, on top of what the flags above say.
+        HashTable<FlyString> descendant_classes;
+        HashTable<FlyString> descendant_ids;
+        HashTable<FlyString> descendant_attribute_names;
+    };
+    struct InvalidationData {
+        HashMap<FlyString, InvalidationSet> class_invalidation_sets;
+        HashMap<FlyString, InvalidationSet> id_invalidation_sets;
+        HashMap<FlyString, InvalidationSet> attribute_invalidation_sets;
+        // Whether any selector depends on the position of elements among their siblings.
+        bool has_structural_selectors { false };
+    };
+    OwnPtr<InvalidationData> m_invalidation_data;
+
+    struct Ancestor {
+        DOM::Element const* element { nullptr };
+        size_t hash_count { 0 };
+    };
+    Vector<Ancestor> m_ancestors;
+    Vector<u32> m_ancestor_hashes;
+    CountingBloomFilter<12> m_ancestor_filter;
+
     class FontLoader;
     HashMap<String, NonnullOwnPtr<FontLoader>> m_loaded_fonts;
 };
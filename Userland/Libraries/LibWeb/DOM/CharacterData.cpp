@@ -9,6 +9,7 @@
 #include <LibWeb/DOM/MutationType.h>
 #include <LibWeb/DOM/Range.h>
 #include <LibWeb/DOM/StaticNodeList.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -102,7 +103,11 @@ ExceptionOr<void> CharacterData::replace_data(size_t offset, size_t count, Strin
         parent()->children_changed();
 
     set_needs_style_update(true);
-    document().set_needs_layout();
+    // NOTE: Only the layout subtree around this node needs to be redone, if it has a relayout boundary.
+    if (auto* layout_node = this->layout_node())
+        layout_node->set_needs_layout();
+    else
+        document().set_needs_layout();
     return {};
 }
 
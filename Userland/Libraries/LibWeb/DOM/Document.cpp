@@ -7,6 +7,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/CharacterTypes.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
@@ -62,6 +63,7 @@
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
 #include <LibWeb/HTML/Scripting/WindowEnvironmentSettingsObject.h>
 #include <LibWeb/HTML/Window.h>
+#include <LibWeb/Layout/BlockContainer.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Layout/TreeBuilder.h>
@@ -689,6 +691,7 @@ void Document::tear_down_layout_tree()
     }
 
     m_layout_root = nullptr;
+    m_relayout_boundaries_needing_layout.clear();
 }
 
 Color Document::background_color(Gfx::Palette const& palette) const
@@ -777,6 +780,14 @@ void Document::set_needs_layout()
     schedule_layout_update();
 }
 
+void Document::schedule_layout_of_subtree(Badge<Layout::Node>, Layout::Box& relayout_boundary)
+{
+    if (m_relayout_boundaries_needing_layout.contains_slow(relayout_boundary))
+        return;
+    m_relayout_boundaries_needing_layout.append(relayout_boundary);
+    schedule_layout_update();
+}
+
 void Document::force_layout()
 {
     tear_down_layout_tree();
@@ -797,8 +808,10 @@ void Document::update_layout()
 
     update_style();
 
-    if (!m_needs_layout && m_layout_root)
+    if (!m_needs_layout && m_layout_root) {
+        update_layout_of_dirty_subtrees();
         return;
+    }
 
     if (!browsing_context())
         return;
@@ -813,6 +826,7 @@ void Document::update_layout()
 
     Layout::LayoutState layout_state;
     layout_state.used_values_per_layout_node.resize(layout_node_count());
+    layout_state.intrinsic_sizes = m_layout_root->take_cached_intrinsic_sizes();
 
     {
         Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
@@ -828,6 +842,13 @@ void Document::update_layout()
     }
 
     layout_state.commit();
+    m_layout_root->set_cached_intrinsic_sizes(move(layout_state.intrinsic_sizes));
+
+    m_layout_root->for_each_in_inclusive_subtree([&](auto& layout_node) {
+        layout_node.did_layout({});
+        return IterationDecision::Continue;
+    });
+    m_relayout_boundaries_needing_layout.clear();
 
     browsing_context()->set_needs_display();
 
@@ -840,6 +861,94 @@ void Document::update_layout()
     m_layout_update_timer->stop();
 }
 
+// Lays out the insides of the relayout boundaries that need it, using the results of the last layout for everything around them.
+void Document::update_layout_of_dirty_subtrees()
+{
+    if (m_relayout_boundaries_needing_layout.is_empty() || !browsing_context())
+        return;
+
+    auto relayout_boundaries = move(m_relayout_boundaries_needing_layout);
+    auto is_being_laid_out = [&](Layout::Node const& layout_node) {
+        for (auto const* ancestor = &layout_node; ancestor; ancestor = ancestor->parent()) {
+            if (any_of(relayout_boundaries, [&](auto const& relayout_boundary) { return &relayout_boundary == ancestor; }))
+                return true;
+        }
+        return false;
+    };
+
+    Layout::LayoutState layout_state;
+    layout_state.used_values_per_layout_node.resize(layout_node_count());
+    layout_state.intrinsic_sizes = m_layout_root->take_cached_intrinsic_sizes();
+
+    for (auto& relayout_boundary : relayout_boundaries) {
+        // NOTE: If a relayout boundary around this one gets laid out as well, that takes care of this one.
+        if (relayout_boundary.parent() && is_being_laid_out(*relayout_boundary.parent()))
+            continue;
+
+        // The boundary and its containing blocks keep the size and position they were given by the last layout.
+        Vector<Layout::Box const*> containing_blocks;
+        for (Layout::Box const* box = &relayout_boundary; box; box = box->containing_block())
+            containing_blocks.append(box);
+        for (auto const* box : containing_blocks.in_reverse()) {
+            auto const& paint_box = *box->paint_box();
+            auto const& box_model = box->box_model();
+            auto& used_values = layout_state.get_mutable(*box);
+            used_values.offset = paint_box.offset();
+            used_values.set_content_width(paint_box.content_width());
+            used_values.set_content_height(paint_box.content_height());
+            used_values.margin_left = box_model.margin.left;
+            used_values.margin_right = box_model.margin.right;
+            used_values.margin_top = box_model.margin.top;
+            used_values.margin_bottom = box_model.margin.bottom;
+            used_values.border_left = box_model.border.left;
+            used_values.border_right = box_model.border.right;
+            used_values.border_top = box_model.border.top;
+            used_values.border_bottom = box_model.border.bottom;
+            used_values.padding_left = box_model.padding.left;
+            used_values.padding_right = box_model.padding.right;
+            used_values.padding_top = box_model.padding.top;
+            used_values.padding_bottom = box_model.padding.bottom;
+            used_values.inset_left = box_model.inset.left;
+            used_values.inset_right = box_model.inset.right;
+            used_values.inset_top = box_model.inset.top;
+            used_values.inset_bottom = box_model.inset.bottom;
+        }
+
+        Layout::BlockFormattingContext parent_context(layout_state, verify_cast<Layout::BlockContainer>(*relayout_boundary.parent()), nullptr);
+        auto context = parent_context.create_independent_formatting_context_if_needed(layout_state, relayout_boundary);
+        if (!context) {
+            // NOTE: This shouldn't happen for a relayout boundary, but if it does, we can always fall back to a full layout.
+            m_layout_root->set_cached_intrinsic_sizes(move(layout_state.intrinsic_sizes));
+            set_needs_layout();
+            update_layout();
+            return;
+        }
+        context->run(relayout_boundary, Layout::LayoutMode::Normal);
+        context->parent_context_did_dimension_child_root_box();
+    }
+
+    // Only commit what's inside the boundaries, since the used values of everything else only served as input.
+    for (auto& used_values : layout_state.used_values_per_layout_node) {
+        if (used_values && !is_being_laid_out(used_values->node()))
+            used_values = nullptr;
+    }
+    layout_state.commit();
+    m_layout_root->set_cached_intrinsic_sizes(move(layout_state.intrinsic_sizes));
+
+    for (auto& relayout_boundary : relayout_boundaries) {
+        relayout_boundary.for_each_in_inclusive_subtree([&](auto& layout_node) {
+            layout_node.did_layout({});
+            return IterationDecision::Continue;
+        });
+        relayout_boundary.set_needs_display();
+    }
+
+    // NOTE: The stacking contexts belonged to the paintables we just replaced.
+    invalidate_stacking_context_tree();
+
+    m_layout_update_timer->stop();
+}
+
 [[nodiscard]] static bool update_style_recursively(DOM::Node& node)
 {
     bool const needs_full_style_update = node.document().needs_full_style_update();
@@ -851,6 +960,10 @@ void Document::update_layout()
     node.set_needs_style_update(false);
 
     if (needs_full_style_update || node.child_needs_style_update()) {
+        auto& style_computer = node.document().style_computer();
+        if (node.is_element())
+            style_computer.push_ancestor(static_cast<DOM::Element const&>(node));
+
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root()) {
                 if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
@@ -862,6 +975,9 @@ void Document::update_layout()
                 needs_relayout |= update_style_recursively(child);
             return IterationDecision::Continue;
         });
+
+        if (node.is_element())
+            style_computer.pop_ancestor(static_cast<DOM::Element const&>(node));
     }
 
     node.set_child_needs_style_update(false);
@@ -160,6 +160,7 @@ public:
     void update_layout();
 
     void set_needs_layout();
+    void schedule_layout_of_subtree(Badge<Layout::Node>, Layout::Box& relayout_boundary);
 
     void invalidate_layout();
     void invalidate_stacking_context_tree();
@@ -250,6 +251,7 @@ public:
     void set_associated_inert_template_document(Document& document) { m_associated_inert_template_document = document; }
 
     String ready_state() const;
+    HTML::DocumentReadyState readiness() const { return m_readiness; }
     void update_readiness(HTML::DocumentReadyState);
 
     void ref_from_node(Badge<Node>)
@@ -378,6 +380,8 @@ private:
 
     void tear_down_layout_tree();
 
+    void update_layout_of_dirty_subtrees();
+
     void evaluate_media_rules();
 
     ExceptionOr<void> run_the_document_write_steps(String);
@@ -483,6 +487,9 @@ private:
 
     bool m_needs_layout { false };
 
+    // Relayout boundaries that need to be laid out again, if we don't need a full layout anyway.
+    NonnullRefPtrVector<Layout::Box> m_relayout_boundaries_needing_layout;
+
     bool m_needs_full_style_update { false };
 
     HashTable<NodeIterator*> m_node_iterators;
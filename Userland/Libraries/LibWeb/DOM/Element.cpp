@@ -80,6 +80,7 @@ ExceptionOr<void> Element::set_attribute(FlyString const& name, String const& va
 
     // 3. Let attribute be the first attribute in this’s attribute list whose qualified name is qualifiedName, and null otherwise.
     auto* attribute = m_attributes->get_attribute(name);
+    auto old_value = attribute ? attribute->value() : String {};
 
     // 4. If attribute is null, create an attribute whose local name is qualifiedName, value is value, and node document is this’s node document, then append this attribute to this, and then return.
     if (!attribute) {
@@ -96,8 +97,7 @@ ExceptionOr<void> Element::set_attribute(FlyString const& name, String const& va
 
     parse_attribute(attribute->local_name(), value);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    document().style_computer().invalidate_style_after_attribute_change(*this, attribute->local_name(), old_value, value);
 
     return {};
 }
@@ -160,12 +160,15 @@ ExceptionOr<void> Element::set_attribute_ns(FlyString const& namespace_, FlyStri
 // https://dom.spec.whatwg.org/#dom-element-removeattribute
 void Element::remove_attribute(FlyString const& name)
 {
+    auto const* attribute = m_attributes->get_attribute(name);
+    auto local_name = attribute ? attribute->local_name() : name;
+    auto old_value = attribute ? attribute->value() : String {};
+
     m_attributes->remove_attribute(name);
 
     did_remove_attribute(name);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    document().style_computer().invalidate_style_after_attribute_change(*this, local_name, old_value, {});
 }
 
 // https://dom.spec.whatwg.org/#dom-element-hasattribute
@@ -198,8 +201,7 @@ DOM::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optional
 
             parse_attribute(new_attribute->local_name(), "");
 
-            // FIXME: Invalidate less.
-            document().invalidate_style();
+            document().style_computer().invalidate_style_after_attribute_change(*this, new_attribute->local_name(), {}, "");
 
             return true;
         }
@@ -210,12 +212,14 @@ DOM::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optional
 
     // 5. Otherwise, if force is not given or is false, remove an attribute given qualifiedName and this, and then return false.
     if (!force.has_value() || !force.value()) {
+        auto local_name = attribute->local_name();
+        auto old_value = attribute->value();
+
         m_attributes->remove_attribute(name);
 
         did_remove_attribute(name);
 
-        // FIXME: Invalidate less.
-        document().invalidate_style();
+        document().style_computer().invalidate_style_after_attribute_change(*this, local_name, old_value, {});
     }
 
     // 6. Return true.
@@ -380,6 +384,16 @@ Element::NeedsRelayout Element::recompute_style()
 
     m_computed_css_values = move(new_computed_css_values);
 
+    // NOTE: Our children may inherit some of the values that changed, so they have to be recomputed as well.
+    for_each_child([](auto& child) {
+        child.set_needs_style_update(true);
+    });
+    if (m_shadow_root) {
+        m_shadow_root->for_each_child([](auto& child) {
+            child.set_needs_style_update(true);
+        });
+    }
+
     if (required_invalidation == RequiredInvalidation::RepaintOnly && layout_node()) {
         layout_node()->apply_style(*m_computed_css_values);
         layout_node()->set_needs_display();
@@ -15,6 +15,7 @@
 #include <LibWeb/Bindings/NodeWrapper.h>
 #include <LibWeb/Bindings/NodeWrapperFactory.h>
 #include <LibWeb/DOM/Comment.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/DocumentType.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/DOM/ElementFactory.h>
@@ -433,7 +434,7 @@ void Node::insert_before(NonnullRefPtr<Node> node, RefPtr<Node> child, bool supp
     // 9. Run the children changed steps for parent.
     children_changed();
 
-    document().invalidate_style();
+    document().style_computer().invalidate_style_after_children_changed(*this);
 }
 
 // https://dom.spec.whatwg.org/#concept-node-pre-insert
@@ -585,7 +586,7 @@ void Node::remove(bool suppress_observers)
     // 21. Run the children changed steps for parent.
     parent->children_changed();
 
-    document().invalidate_style();
+    document().style_computer().invalidate_style_after_children_changed(*parent);
 }
 
 // https://dom.spec.whatwg.org/#concept-node-replace
@@ -205,6 +205,7 @@ class DOMRectReadOnly;
 }
 
 namespace Web::HTML {
+class BackForwardCache;
 class BrowsingContext;
 class BrowsingContextContainer;
 class CanvasRenderingContext2D;
@@ -338,6 +339,7 @@ namespace Web::Painting {
 enum class PaintPhase;
 class ButtonPaintable;
 class CheckBoxPaintable;
+class DisplayList;
 class LabelablePaintable;
 class Paintable;
 class PaintableBox;
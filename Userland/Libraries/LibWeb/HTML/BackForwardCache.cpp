@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/HashTable.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/BackForwardCache.h>
+
+namespace Web::HTML {
+
+static HashTable<BackForwardCache*>& all_caches()
+{
+    static HashTable<BackForwardCache*> caches;
+    return caches;
+}
+
+BackForwardCache::BackForwardCache()
+{
+    all_caches().set(this);
+}
+
+BackForwardCache::~BackForwardCache()
+{
+    all_caches().remove(this);
+}
+
+void BackForwardCache::clear_all()
+{
+    for (auto* cache : all_caches())
+        cache->clear();
+}
+
+bool BackForwardCache::can_store(DOM::Document const& document)
+{
+    // NOTE: A document that is still loading would have to pick up where it left off, which we can't do.
+    if (document.readiness() != DocumentReadyState::Complete)
+        return false;
+    auto const& url = document.url();
+    return url.protocol().is_one_of("http"sv, "https"sv, "file"sv);
+}
+
+void BackForwardCache::store(NonnullRefPtr<DOM::Document> document, Gfx::IntPoint const& scroll_offset)
+{
+    auto const& url = document->url();
+    m_entries.remove_all_matching([&](auto& entry) { return entry.document->url() == url; });
+    if (m_entries.size() == max_entries)
+        m_entries.remove(0);
+    dbgln_if(SPAM_DEBUG, "BackForwardCache: Storing {}", url);
+    m_entries.append({ move(document), scroll_offset });
+}
+
+Optional<BackForwardCache::Entry> BackForwardCache::take(AK::URL const& url)
+{
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (m_entries[i].document->url() == url)
+            return m_entries.take(i);
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibGfx/Point.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::HTML {
+
+// Recently left documents of a top-level browsing context, kept around so that going back or forward to them
+// doesn't have to fetch, parse and run them again. While it's in here, a document has no browsing context, so it
+// isn't fully active and its tasks (timers, fetches, ...) wait in the event loop until it comes back.
+// https://html.spec.whatwg.org/multipage/history.html#note-bfcache
+class BackForwardCache {
+    AK_MAKE_NONCOPYABLE(BackForwardCache);
+    AK_MAKE_NONMOVABLE(BackForwardCache);
+
+public:
+    struct Entry {
+        NonnullRefPtr<DOM::Document> document;
+        Gfx::IntPoint scroll_offset;
+    };
+
+    static constexpr size_t max_entries = 4;
+
+    static bool can_store(DOM::Document const&);
+
+    // Drops every kept document in the process, e.g. when memory is running low.
+    static void clear_all();
+
+    BackForwardCache();
+    ~BackForwardCache();
+
+    void store(NonnullRefPtr<DOM::Document>, Gfx::IntPoint const& scroll_offset);
+    Optional<Entry> take(AK::URL const&);
+    void clear() { m_entries.clear(); }
+
+private:
+    // NOTE: The least recently left document comes first.
+    Vector<Entry> m_entries;
+};
+
+}
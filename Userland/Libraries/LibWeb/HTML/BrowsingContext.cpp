@@ -21,6 +21,8 @@
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Layout/TextNode.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/PaintableBox.h>
+#include <LibWeb/Painting/StackingContext.h>
 
 namespace Web::HTML {
 
@@ -354,11 +356,18 @@ void BrowsingContext::set_size(Gfx::IntSize const& size)
 
 void BrowsingContext::set_needs_display()
 {
+    // NOTE: We don't know what changed, so everything outside the viewport has to be painted again as well.
+    if (auto* stacking_context = root_stacking_context())
+        stacking_context->invalidate_layers();
+
     set_needs_display(viewport_rect());
 }
 
 void BrowsingContext::set_needs_display(Gfx::IntRect const& rect)
 {
+    if (auto* stacking_context = root_stacking_context())
+        stacking_context->invalidate_layers_intersecting(rect);
+
     if (!viewport_rect().intersects(rect))
         return;
 
@@ -372,6 +381,14 @@ void BrowsingContext::set_needs_display(Gfx::IntRect const& rect)
         container()->layout_node()->set_needs_display();
 }
 
+Painting::StackingContext* BrowsingContext::root_stacking_context()
+{
+    auto* document = active_document();
+    if (!document || !document->layout_node() || !document->layout_node()->paint_box())
+        return nullptr;
+    return const_cast<Painting::StackingContext*>(document->layout_node()->paint_box()->stacking_context());
+}
+
 void BrowsingContext::scroll_to(Gfx::IntPoint const& position)
 {
     if (active_document())
@@ -125,6 +125,8 @@ private:
 
     void reset_cursor_blink_cycle();
 
+    Painting::StackingContext* root_stacking_context();
+
     WeakPtr<Page> m_page;
 
     FrameLoader m_loader;
@@ -155,7 +155,8 @@ bool HTMLLinkElement::load_favicon_and_use_if_window_is_active()
         return false;
 
     RefPtr<Gfx::Bitmap> favicon_bitmap;
-    auto decoded_image = Web::ImageDecoding::Decoder::the().decode_image(resource()->encoded_data());
+    // Favicons are shown at 16x16, so anything more than twice that (for HiDPI) is wasted.
+    auto decoded_image = Web::ImageDecoding::Decoder::the().decode_image(resource()->encoded_data(), Gfx::IntSize { 32, 32 });
     if (!decoded_image.has_value() || decoded_image->frames.is_empty()) {
         dbgln("Could not decode favicon {}", resource()->url());
         return false;
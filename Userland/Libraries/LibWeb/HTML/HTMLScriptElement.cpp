@@ -286,26 +286,8 @@ void HTMLScriptElement::prepare_script()
             if (parser_document)
                 begin_delaying_document_load_event(*parser_document);
 
-            ResourceLoader::the().load(
-                request,
-                [this, url](auto data, auto&, auto) {
-                    if (data.is_null()) {
-                        dbgln("HTMLScriptElement: Failed to load {}", url);
-                        return;
-                    }
-
-                    // FIXME: This is all ad-hoc and needs work.
-                    auto script = ClassicScript::create(url.to_string(), data, document().relevant_settings_object(), AK::URL());
-
-                    // When the chosen algorithm asynchronously completes, set the script's script to the result. At that time, the script is ready.
-                    m_script = script;
-                    script_became_ready();
-                },
-                [this](auto&, auto) {
-                    m_failed_to_load = true;
-                    dbgln("HONK! Failed to load script, but ready nonetheless.");
-                    script_became_ready();
-                });
+            // NOTE: This goes through the resource cache, so we can pick up scripts that the parser's preload scanner found early.
+            set_resource(ResourceLoader::the().load_resource(Resource::Type::Generic, request));
         } else if (m_script_type == ScriptType::Module) {
             // FIXME: -> "module"
             //        Fetch an external module script graph given url, settings object, and options.
@@ -430,6 +412,29 @@ void HTMLScriptElement::prepare_script()
     }
 }
 
+void HTMLScriptElement::resource_did_load()
+{
+    auto data = resource()->encoded_data();
+    if (data.is_null()) {
+        dbgln("HTMLScriptElement: Failed to load {}", resource()->url());
+        return;
+    }
+
+    // FIXME: This is all ad-hoc and needs work.
+    auto script = ClassicScript::create(resource()->url().to_string(), data, document().relevant_settings_object(), AK::URL());
+
+    // When the chosen algorithm asynchronously completes, set the script's script to the result. At that time, the script is ready.
+    m_script = script;
+    script_became_ready();
+}
+
+void HTMLScriptElement::resource_did_fail()
+{
+    m_failed_to_load = true;
+    dbgln("HONK! Failed to load script, but ready nonetheless.");
+    script_became_ready();
+}
+
 void HTMLScriptElement::script_became_ready()
 {
     m_script_ready = true;
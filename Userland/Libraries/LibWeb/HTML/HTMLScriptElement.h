@@ -10,10 +10,13 @@
 #include <LibWeb/DOM/DocumentLoadEventDelayer.h>
 #include <LibWeb/HTML/HTMLElement.h>
 #include <LibWeb/HTML/Scripting/Script.h>
+#include <LibWeb/Loader/Resource.h>
 
 namespace Web::HTML {
 
-class HTMLScriptElement final : public HTMLElement {
+class HTMLScriptElement final
+    : public HTMLElement
+    , public ResourceClient {
 public:
     using WrapperType = Bindings::HTMLScriptElementWrapper;
 
@@ -51,6 +54,10 @@ public:
     void set_source_line_number(Badge<HTMLParser>, size_t source_line_number) { m_source_line_number = source_line_number; }
 
 private:
+    // ^ResourceClient
+    virtual void resource_did_load() override;
+    virtual void resource_did_fail() override;
+
     void prepare_script();
     void script_became_ready();
     void when_the_script_is_ready(Function<void()>);
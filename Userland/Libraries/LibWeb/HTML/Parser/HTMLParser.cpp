@@ -2259,6 +2259,11 @@ void HTMLParser::handle_text(HTMLToken& token)
                 // that is blocking scripts and the script's "ready to be parser-executed"
                 // flag is set.
                 if (m_document->has_a_style_sheet_that_is_blocking_scripts() || !script->is_ready_to_be_parser_executed()) {
+                    // NOTE: While we're waiting, look ahead for other resources we're going to need, and start loading them too.
+                    if (!m_preload_scanner.has_value())
+                        m_preload_scanner.emplace(*m_document);
+                    m_preload_scanner->scan(m_tokenizer.unprocessed_input());
+
                     main_thread_event_loop().spin_until([&] {
                         return !m_document->has_a_style_sheet_that_is_blocking_scripts() && script->is_ready_to_be_parser_executed();
                     });
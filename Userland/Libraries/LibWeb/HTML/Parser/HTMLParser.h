@@ -8,6 +8,7 @@
 
 #include <AK/NonnullRefPtrVector.h>
 #include <LibWeb/DOM/Node.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
 #include <LibWeb/HTML/Parser/StackOfOpenElements.h>
@@ -162,6 +163,7 @@ private:
     ListOfActiveFormattingElements m_list_of_active_formatting_elements;
 
     HTMLTokenizer m_tokenizer;
+    Optional<HTMLPreloadScanner> m_preload_scanner;
 
     bool m_foster_parenting { false };
     bool m_frameset_ok { true };
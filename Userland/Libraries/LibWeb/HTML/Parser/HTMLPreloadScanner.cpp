@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document)
+    : m_document(document)
+{
+}
+
+void HTMLPreloadScanner::scan(StringView input)
+{
+    auto const* input_end = input.characters_without_null_termination() + input.length();
+    if (input.is_empty() || input_end == m_last_scanned_input_end)
+        return;
+    m_last_scanned_input_end = input_end;
+
+    m_base_url = m_document.base_url();
+
+    HTMLTokenizer tokenizer { input, "utf-8" };
+    for (;;) {
+        auto token = tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (!token->is_start_tag())
+            continue;
+
+        auto const& tag_name = token->tag_name();
+
+        if (tag_name == TagNames::base) {
+            if (auto href = token->attribute(AttributeNames::href); !href.is_null())
+                m_base_url = m_base_url.complete_url(href);
+        } else if (tag_name == TagNames::script) {
+            // NOTE: We don't support module scripts yet.
+            if (auto src = token->attribute(AttributeNames::src); !src.is_null() && !token->attribute(AttributeNames::type).equals_ignoring_case("module"sv))
+                preload(Resource::Type::Generic, src);
+        } else if (tag_name == TagNames::link) {
+            bool is_style_sheet = false;
+            bool is_alternate = false;
+            auto relationships = token->attribute(AttributeNames::rel).to_lowercase_string();
+            for (auto relationship : relationships.split_view(' ')) {
+                if (relationship == "stylesheet"sv)
+                    is_style_sheet = true;
+                else if (relationship == "alternate"sv)
+                    is_alternate = true;
+            }
+            if (auto href = token->attribute(AttributeNames::href); is_style_sheet && !is_alternate && !href.is_null())
+                preload(Resource::Type::Generic, href);
+        } else if (tag_name == TagNames::img) {
+            if (auto src = token->attribute(AttributeNames::src); !src.is_null())
+                preload(Resource::Type::Image, src);
+        }
+
+        // NOTE: The tree builder would normally tell the tokenizer about these, so we have to do it ourselves.
+        //       Otherwise, we'd go looking for tags inside scripts and style sheets.
+        if (tag_name == TagNames::script)
+            tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of(TagNames::style, TagNames::xmp, TagNames::iframe, TagNames::noembed, TagNames::noframes))
+            tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name.is_one_of(TagNames::textarea, TagNames::title))
+            tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name == TagNames::plaintext)
+            tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+    }
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, StringView url_string)
+{
+    auto url = m_base_url.complete_url(url_string);
+    if (!url.is_valid())
+        return;
+
+    // NOTE: Resources loaded from files don't go through the resource cache, so loading them early wouldn't help.
+    if (url.protocol() == "file"sv || url.protocol() == "data"sv)
+        return;
+
+    if (m_preloaded_urls.set(url) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    dbgln_if(HTML_PARSER_DEBUG, "HTMLPreloadScanner: Preloading {}", url);
+    auto request = LoadRequest::create_for_url_on_page(url, m_document.page());
+    if (auto resource = ResourceLoader::the().load_resource(type, request))
+        m_preloaded_resources.append(resource.release_nonnull());
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/URL.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// Looks ahead in input the parser hasn't gotten to yet, for scripts, style sheets and images that we're going to need.
+// We start loading those right away, so they're (hopefully) in the resource cache by the time their elements get created.
+// NOTE: This is a simplified take on the "speculative HTML parser" described in the spec:
+//       https://html.spec.whatwg.org/multipage/parsing.html#speculative-html-parsing
+class HTMLPreloadScanner {
+public:
+    explicit HTMLPreloadScanner(DOM::Document&);
+
+    void scan(StringView input);
+
+private:
+    void preload(Resource::Type, StringView url);
+
+    DOM::Document& m_document;
+    AK::URL m_base_url;
+
+    // NOTE: We remember what we've already looked at, so that we don't scan it again while the parser is still stuck in front of it.
+    char const* m_last_scanned_input_end { nullptr };
+
+    HashTable<AK::URL> m_preloaded_urls;
+    NonnullRefPtrVector<Resource> m_preloaded_resources;
+};
+
+}
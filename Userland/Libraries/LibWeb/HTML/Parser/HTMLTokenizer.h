@@ -125,6 +125,9 @@ public:
 
     String source() const { return m_decoded_input; }
 
+    // The part of the input that hasn't been consumed yet.
+    StringView unprocessed_input() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
+
     void insert_input_at_insertion_point(String const& input);
     void insert_eof();
     bool is_eof_inserted();
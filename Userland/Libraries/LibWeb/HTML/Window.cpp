@@ -85,6 +85,14 @@ Window::Window(DOM::Document& document)
 
 Window::~Window() = default;
 
+Bindings::WindowObject* Window::wrapper()
+{
+    // NOTE: The wrapper may have died without having been swept yet.
+    if (m_wrapper)
+        m_wrapper->heap().sweep_cell_if_dead(*m_wrapper);
+    return m_wrapper;
+}
+
 void Window::set_wrapper(Badge<Bindings::WindowObject>, Bindings::WindowObject& wrapper)
 {
     m_wrapper = wrapper.make_weak_ptr();
@@ -79,8 +79,8 @@ public:
     void did_call_location_reload(Badge<Bindings::LocationObject>);
     void did_call_location_replace(Badge<Bindings::LocationObject>, String url);
 
-    Bindings::WindowObject* wrapper() { return m_wrapper; }
-    Bindings::WindowObject const* wrapper() const { return m_wrapper; }
+    Bindings::WindowObject* wrapper();
+    Bindings::WindowObject const* wrapper() const { return const_cast<Window*>(this)->wrapper(); }
 
     void set_wrapper(Badge<Bindings::WindowObject>, Bindings::WindowObject&);
 
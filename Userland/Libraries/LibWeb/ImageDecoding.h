@@ -31,7 +31,10 @@ public:
     static void initialize(RefPtr<Decoder>&&);
     static Decoder& the();
 
-    virtual Optional<DecodedImage> decode_image(ReadonlyBytes) = 0;
+    Optional<DecodedImage> decode_image(ReadonlyBytes bytes) { return decode_image(bytes, {}); }
+
+    // With an ideal_size, the image may be decoded smaller than it really is, but at least that large.
+    virtual Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size) = 0;
 
 protected:
     explicit Decoder();
@@ -32,7 +32,40 @@ Box::~Box()
 void Box::set_needs_display()
 {
     if (paint_box())
-        browsing_context().set_needs_display(enclosing_int_rect(paint_box()->absolute_rect()));
+        browsing_context().set_needs_display(paint_box()->absolute_paint_rect());
+}
+
+bool Box::is_relayout_boundary() const
+{
+    // NOTE: We need the results of the last layout around, since we'll only lay out what's inside this box.
+    if (!paint_box() || is_initial_containing_block_box())
+        return false;
+
+    // Our position must not depend on anything but the block-level siblings before us.
+    if (is_inline() || is_floating() || is_absolutely_positioned() || is_flex_item())
+        return false;
+    auto const* parent = this->parent();
+    if (!parent || !parent->is_block_container() || parent->children_are_inline())
+        return false;
+    if (auto parent_display = parent->computed_values().display(); !parent_display.is_flow_inside() && !parent_display.is_flow_root_inside())
+        return false;
+
+    // Our insides must be formatted independently of the outside...
+    auto const& computed_values = this->computed_values();
+    if (computed_values.display().is_table_inside())
+        return false;
+    auto clips_overflow = [](CSS::Overflow overflow) {
+        return overflow != CSS::Overflow::Visible && overflow != CSS::Overflow::Clip;
+    };
+    if (!clips_overflow(computed_values.overflow_x()) || !clips_overflow(computed_values.overflow_y()))
+        return false;
+
+    // ...and our size must not depend on them.
+    // NOTE: Percentages are resolved against a containing block whose size may depend on our contents, so we don't allow them.
+    auto is_fixed_size = [](CSS::LengthPercentage const& size) {
+        return !size.is_auto() && size.is_length();
+    };
+    return is_fixed_size(computed_values.width()) && is_fixed_size(computed_values.height());
 }
 
 bool Box::is_body() const
@@ -25,6 +25,9 @@ public:
 
     bool is_body() const;
 
+    // Whether nothing outside of this box depends on what's inside it, so that it can be laid out on its own.
+    bool is_relayout_boundary() const;
+
     virtual Optional<float> intrinsic_width() const { return {}; }
     virtual Optional<float> intrinsic_height() const { return {}; }
     virtual Optional<float> intrinsic_aspect_ratio() const { return {}; }
@@ -92,4 +92,23 @@ void InitialContainingBlock::set_selection_end(LayoutPosition const& position)
     recompute_selection_states();
 }
 
+void InitialContainingBlock::set_cached_intrinsic_sizes(IntrinsicSizeCache cache)
+{
+    m_cached_intrinsic_sizes = move(cache);
+    for (auto& it : m_cached_intrinsic_sizes) {
+        it.value->min_content_height = {};
+        it.value->max_content_height = {};
+    }
+}
+
+void InitialContainingBlock::invalidate_cached_intrinsic_sizes(Node const& node)
+{
+    if (m_cached_intrinsic_sizes.is_empty())
+        return;
+    for (auto const* ancestor = &node; ancestor; ancestor = ancestor->parent()) {
+        if (is<NodeWithStyleAndBoxModelMetrics>(*ancestor))
+            m_cached_intrinsic_sizes.remove(static_cast<NodeWithStyleAndBoxModelMetrics const*>(ancestor));
+    }
+}
+
 }
@@ -8,6 +8,7 @@
 
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/Layout/BlockContainer.h>
+#include <LibWeb/Layout/LayoutState.h>
 
 namespace Web::Layout {
 
@@ -27,11 +28,19 @@ public:
     void build_stacking_context_tree_if_needed();
     void recompute_selection_states();
 
+    // NOTE: Only the intrinsic widths are kept between layouts, since intrinsic heights depend on the width they were computed at.
+    //       Intrinsic widths only depend on what's inside a box, so they stay valid until something in there needs layout.
+    using IntrinsicSizeCache = HashMap<NodeWithStyleAndBoxModelMetrics const*, NonnullOwnPtr<LayoutState::IntrinsicSizes>>;
+    IntrinsicSizeCache take_cached_intrinsic_sizes() { return move(m_cached_intrinsic_sizes); }
+    void set_cached_intrinsic_sizes(IntrinsicSizeCache);
+    void invalidate_cached_intrinsic_sizes(Node const&);
+
 private:
     void build_stacking_context_tree();
     virtual bool is_initial_containing_block_box() const override { return true; }
 
     LayoutRange m_selection;
+    IntrinsicSizeCache m_cached_intrinsic_sizes;
 };
 
 template<>
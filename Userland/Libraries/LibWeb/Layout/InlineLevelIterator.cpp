@@ -125,20 +125,17 @@ Optional<InlineLevelIterator::Item> InlineLevelIterator::next(float available_wi
         if (!m_text_node_context.has_value())
             enter_text_node(text_node);
 
-        auto chunk_opt = m_text_node_context->next_chunk;
-        if (!chunk_opt.has_value()) {
+        auto chunks = m_text_node_context->chunks;
+        if (m_text_node_context->next_chunk_index >= chunks.size()) {
             m_text_node_context = {};
             skip_to_next();
             return next(available_width);
         }
 
-        m_text_node_context->next_chunk = m_text_node_context->chunk_iterator.next();
-        if (!m_text_node_context->next_chunk.has_value())
+        auto& chunk = chunks[m_text_node_context->next_chunk_index++];
+        if (m_text_node_context->next_chunk_index == chunks.size())
             m_text_node_context->is_last_chunk = true;
 
-        auto& chunk = chunk_opt.value();
-        float chunk_width = text_node.font().width(chunk.view) + text_node.font().glyph_spacing();
-
         if (m_text_node_context->do_respect_linebreaks && chunk.has_breaking_newline) {
             return Item {
                 .type = Item::Type::ForcedBreak,
@@ -150,7 +147,7 @@ Optional<InlineLevelIterator::Item> InlineLevelIterator::next(float available_wi
             .node = &text_node,
             .offset_in_node = chunk.start,
             .length_in_node = chunk.length,
-            .width = chunk_width,
+            .width = chunk.width,
             .is_collapsible_whitespace = m_text_node_context->do_collapse && chunk.is_all_whitespace,
         };
 
@@ -254,9 +251,8 @@ void InlineLevelIterator::enter_text_node(Layout::TextNode const& text_node)
         .do_respect_linebreaks = do_respect_linebreaks,
         .is_first_chunk = true,
         .is_last_chunk = false,
-        .chunk_iterator = TextNode::ChunkIterator { text_node.text_for_rendering(), m_layout_mode, do_wrap_lines, do_respect_linebreaks },
+        .chunks = text_node.measured_chunks(m_layout_mode, do_wrap_lines, do_respect_linebreaks).span(),
     };
-    m_text_node_context->next_chunk = m_text_node_context->chunk_iterator.next();
 }
 
 void InlineLevelIterator::add_extra_box_model_metrics_to_item(Item& item, bool add_leading_metrics, bool add_trailing_metrics)
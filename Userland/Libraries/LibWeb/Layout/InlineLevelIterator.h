@@ -79,8 +79,8 @@ private:
         bool do_respect_linebreaks {};
         bool is_first_chunk {};
         bool is_last_chunk {};
-        TextNode::ChunkIterator chunk_iterator;
-        Optional<TextNode::Chunk> next_chunk {};
+        Span<TextNode::MeasuredChunk const> chunks;
+        size_t next_chunk_index { 0 };
     };
 
     Optional<TextNodeContext> m_text_node_context;
@@ -51,6 +51,26 @@ bool Node::is_out_of_flow(FormattingContext const& formatting_context) const
     return false;
 }
 
+void Node::set_needs_layout()
+{
+    if (m_needs_layout)
+        return;
+    m_needs_layout = true;
+
+    if (auto* initial_containing_block = document().layout_node())
+        initial_containing_block->invalidate_cached_intrinsic_sizes(*this);
+
+    for (auto* node = this; node; node = node->parent()) {
+        if (node != this)
+            node->m_child_needs_layout = true;
+        if (is<Box>(*node) && static_cast<Box const&>(*node).is_relayout_boundary()) {
+            document().schedule_layout_of_subtree({}, static_cast<Box&>(*node));
+            return;
+        }
+    }
+    document().set_needs_layout();
+}
+
 bool Node::can_contain_boxes_with_position_absolute() const
 {
     return computed_values().position() != CSS::Position::Static || is<InitialContainingBlock>(*this);
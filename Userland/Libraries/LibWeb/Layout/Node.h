@@ -118,6 +118,16 @@ public:
 
     virtual void set_needs_display();
 
+    // Marks this node as needing layout. If it's inside a relayout boundary, only the boundary's subtree is laid out again.
+    void set_needs_layout();
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void did_layout(Badge<DOM::Document>)
+    {
+        m_needs_layout = false;
+        m_child_needs_layout = false;
+    }
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -150,6 +160,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { false };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
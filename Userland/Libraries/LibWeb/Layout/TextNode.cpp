@@ -6,6 +6,7 @@
  */
 
 #include <AK/CharacterTypes.h>
+#include <AK/HashMap.h>
 #include <AK/StringBuilder.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/Layout/BlockContainer.h>
@@ -36,6 +37,13 @@ static bool is_all_whitespace(StringView string)
 void TextNode::compute_text_for_rendering(bool collapse)
 {
     auto& data = dom_node().data();
+
+    // NOTE: We get called on every layout, but the text only changes when the DOM node's data does.
+    if (collapse == m_text_for_rendering_is_collapsed && !m_text_for_rendering.is_null() && data.impl() == m_text_for_rendering_source.impl())
+        return;
+    m_text_for_rendering_source = data;
+    m_text_for_rendering_is_collapsed = collapse;
+
     if (!collapse || data.is_empty()) {
         m_text_for_rendering = data;
         return;
@@ -162,6 +170,85 @@ Optional<TextNode::Chunk> TextNode::ChunkIterator::try_commit_chunk(Utf8View::It
     return {};
 }
 
+// Width measurements of short runs of text, shared between all text nodes.
+// Most text is made of the same few words in the same few fonts, so this saves us from measuring them over and over.
+class TextRunWidthCache {
+public:
+    static constexpr size_t max_cacheable_run_length = 64;
+    static constexpr size_t max_entry_count = 16384;
+
+    static TextRunWidthCache& the()
+    {
+        static TextRunWidthCache s_the;
+        return s_the;
+    }
+
+    float width(Gfx::Font const& font, Utf8View const& run)
+    {
+        auto text = run.as_string();
+        if (text.length() > max_cacheable_run_length)
+            return font.width(run);
+
+        auto& per_font_cache = m_per_font_caches.ensure(&font, [&] { return PerFontCache { const_cast<Gfx::Font&>(font), {} }; });
+        if (auto it = per_font_cache.widths.find(text); it != per_font_cache.widths.end())
+            return it->value;
+
+        if (m_entry_count >= max_entry_count) {
+            m_per_font_caches.clear();
+            m_entry_count = 0;
+            return width(font, run);
+        }
+
+        float run_width = font.width(run);
+        per_font_cache.widths.set(text, run_width);
+        ++m_entry_count;
+        return run_width;
+    }
+
+private:
+    struct PerFontCache {
+        // NOTE: We keep the font alive, so that its address can't be reused by another font while we're caching it.
+        NonnullRefPtr<Gfx::Font> font;
+        HashMap<String, float> widths;
+    };
+
+    HashMap<Gfx::Font const*, PerFontCache> m_per_font_caches;
+    size_t m_entry_count { 0 };
+};
+
+Vector<TextNode::MeasuredChunk> const& TextNode::measured_chunks(LayoutMode layout_mode, bool wrap_lines, bool respect_linebreaks) const
+{
+    auto& font = this->font();
+    if (m_measured_chunks_cache.has_value()) {
+        auto& cache = *m_measured_chunks_cache;
+        if (cache.text.impl() == m_text_for_rendering.impl() && cache.font.ptr() == &font && cache.wrap_lines == wrap_lines && cache.respect_linebreaks == respect_linebreaks)
+            return cache.chunks;
+    }
+
+    MeasuredChunksCache cache {
+        .text = m_text_for_rendering,
+        .font = const_cast<Gfx::Font&>(font),
+        .wrap_lines = wrap_lines,
+        .respect_linebreaks = respect_linebreaks,
+        .chunks = {},
+    };
+
+    auto& run_width_cache = TextRunWidthCache::the();
+    ChunkIterator chunk_iterator { m_text_for_rendering, layout_mode, wrap_lines, respect_linebreaks };
+    for (auto chunk = chunk_iterator.next(); chunk.has_value(); chunk = chunk_iterator.next()) {
+        cache.chunks.append(MeasuredChunk {
+            .start = chunk->start,
+            .length = chunk->length,
+            .width = run_width_cache.width(font, chunk->view) + font.glyph_spacing(),
+            .has_breaking_newline = chunk->has_breaking_newline,
+            .is_all_whitespace = chunk->is_all_whitespace,
+        });
+    }
+
+    m_measured_chunks_cache = move(cache);
+    return m_measured_chunks_cache->chunks;
+}
+
 RefPtr<Painting::Paintable> TextNode::create_paintable() const
 {
     return Painting::TextPaintable::create(*this);
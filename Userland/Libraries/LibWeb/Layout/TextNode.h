@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Utf8View.h>
+#include <LibGfx/Font/Font.h>
 #include <LibWeb/DOM/Text.h>
 #include <LibWeb/Layout/Node.h>
 
@@ -48,12 +49,35 @@ public:
 
     void compute_text_for_rendering(bool collapse);
 
+    struct MeasuredChunk {
+        size_t start { 0 };
+        size_t length { 0 };
+        float width { 0 };
+        bool has_breaking_newline { false };
+        bool is_all_whitespace { false };
+    };
+
+    // NOTE: This is the text for rendering split into chunks, along with their widths in our font.
+    //       The result is kept around until the text, the font or the way we split changes.
+    Vector<MeasuredChunk> const& measured_chunks(LayoutMode, bool wrap_lines, bool respect_linebreaks) const;
+
     virtual RefPtr<Painting::Paintable> create_paintable() const override;
 
 private:
     virtual bool is_text_node() const final { return true; }
 
     String m_text_for_rendering;
+    String m_text_for_rendering_source;
+    bool m_text_for_rendering_is_collapsed { false };
+
+    struct MeasuredChunksCache {
+        String text;
+        RefPtr<Gfx::Font> font;
+        bool wrap_lines { false };
+        bool respect_linebreaks { false };
+        Vector<MeasuredChunk> chunks;
+    };
+    mutable Optional<MeasuredChunksCache> m_measured_chunks_cache;
 };
 
 template<>
@@ -171,7 +171,7 @@ bool FrameLoader::load(LoadRequest& request, Type type)
 
     auto& url = request.url();
 
-    if (type == Type::Navigation || type == Type::Reload) {
+    if (type == Type::Navigation || type == Type::Reload || type == Type::HistoryNavigation) {
         if (auto* page = browsing_context().page())
             page->client().page_did_start_loading(url);
     }
@@ -248,6 +248,9 @@ bool FrameLoader::load(const AK::URL& url, Type type)
         return false;
     }
 
+    if (type == Type::HistoryNavigation && restore_from_back_forward_cache(url))
+        return true;
+
     auto request = LoadRequest::create_for_url_on_page(url, browsing_context().page());
     return load(request, type);
 }
@@ -275,7 +278,52 @@ void FrameLoader::load_html(StringView html, const AK::URL& url)
 
     auto parser = HTML::HTMLParser::create(document, html, "utf-8");
     parser->run(url);
-    browsing_context().set_active_document(&parser->document());
+    set_active_document(parser->document(), false);
+}
+
+void FrameLoader::set_active_document(DOM::Document& document, bool is_restorable)
+{
+    RefPtr<DOM::Document> document_to_keep;
+    auto scroll_offset = browsing_context().viewport_scroll_offset();
+    if (auto* old_document = browsing_context().active_document(); old_document && old_document == m_restorable_document.ptr()) {
+        if (browsing_context().is_top_level() && HTML::BackForwardCache::can_store(*old_document))
+            document_to_keep = old_document;
+    }
+
+    browsing_context().set_active_document(&document);
+
+    if (is_restorable)
+        m_restorable_document = document;
+    else
+        m_restorable_document = nullptr;
+
+    if (document_to_keep)
+        m_back_forward_cache.store(document_to_keep.release_nonnull(), scroll_offset);
+}
+
+bool FrameLoader::restore_from_back_forward_cache(AK::URL const& url)
+{
+    auto entry = m_back_forward_cache.take(url);
+    if (!entry.has_value())
+        return false;
+
+    dbgln_if(SPAM_DEBUG, "FrameLoader: Restoring {} from the back/forward cache", url);
+
+    // NOTE: Whatever we were still loading would replace the document we're about to restore.
+    set_resource(nullptr);
+
+    auto* page = browsing_context().page();
+    if (page)
+        page->client().page_did_start_loading(url);
+
+    set_active_document(*entry->document, true);
+
+    // NOTE: This also builds the layout tree again, which was torn down when we left the document.
+    browsing_context().scroll_to(entry->scroll_offset);
+
+    if (page)
+        page->client().page_did_finish_loading(url);
+    return true;
 }
 
 static String s_error_page_url = "file:///res/html/error.html";
@@ -390,7 +438,7 @@ void FrameLoader::resource_did_load()
     document->set_encoding(resource()->encoding());
     document->set_content_type(resource()->mime_type());
 
-    browsing_context().set_active_document(document);
+    set_active_document(*document, true);
 
     if (!parse_document(*document, resource()->encoded_data())) {
         load_error_page(url, "Failed to parse content.");
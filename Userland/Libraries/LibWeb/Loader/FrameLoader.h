@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/WeakPtr.h>
 #include <LibWeb/Forward.h>
+#include <LibWeb/HTML/BackForwardCache.h>
 #include <LibWeb/Loader/Resource.h>
 
 namespace Web {
@@ -20,6 +22,7 @@ public:
     enum class Type {
         Navigation,
         Reload,
+        HistoryNavigation,
         IFrame,
     };
 
@@ -48,8 +51,17 @@ private:
 
     void store_response_cookies(AK::URL const& url, String const& cookies);
 
+    void set_active_document(DOM::Document&, bool is_restorable);
+    bool restore_from_back_forward_cache(AK::URL const&);
+
     HTML::BrowsingContext& m_browsing_context;
     size_t m_redirects_count { 0 };
+
+    HTML::BackForwardCache m_back_forward_cache;
+
+    // The active document, if it's the content of its URL rather than e.g. an error page about it,
+    // and so may be put into the back/forward cache when we navigate away from it.
+    WeakPtr<DOM::Document> m_restorable_document;
 };
 
 }
@@ -40,6 +40,11 @@ void Page::load(LoadRequest& request)
     top_level_browsing_context().loader().load(request, FrameLoader::Type::Navigation);
 }
 
+void Page::load_from_history(const AK::URL& url)
+{
+    top_level_browsing_context().loader().load(url, FrameLoader::Type::HistoryNavigation);
+}
+
 void Page::load_html(StringView html, const AK::URL& url)
 {
     top_level_browsing_context().loader().load_html(html, url);
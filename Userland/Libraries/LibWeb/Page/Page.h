@@ -45,6 +45,7 @@ public:
 
     void load(const AK::URL&);
     void load(LoadRequest&);
+    void load_from_history(const AK::URL&);
 
     void load_html(StringView, const AK::URL&);
 
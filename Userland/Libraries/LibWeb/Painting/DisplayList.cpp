@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Painter.h>
+#include <LibWeb/Layout/Box.h>
+#include <LibWeb/Painting/DisplayList.h>
+#include <LibWeb/Painting/PaintableBox.h>
+#include <LibWeb/Painting/StackingContext.h>
+
+namespace Web::Painting {
+
+static Optional<Gfx::IntRect> cull_rect_for(Paintable const& paintable, PaintPhase phase)
+{
+    if (!is<PaintableBox>(paintable))
+        return {};
+    auto const& paint_box = static_cast<PaintableBox const&>(paintable);
+    auto const& layout_box = paint_box.layout_box();
+
+    // NOTE: The root element and body backgrounds get propagated to the whole canvas.
+    if (layout_box.is_initial_containing_block_box() || layout_box.is_root_element() || layout_box.is_body())
+        return {};
+
+    switch (phase) {
+    case PaintPhase::Background:
+        // NOTE: Box shadows are painted outside the border box, and a clip rect starts a save/restore pair with the overlay phase.
+        if (!paint_box.computed_values().box_shadow().is_empty())
+            return {};
+        if (paint_box.computed_values().clip().is_rect() && layout_box.is_absolutely_positioned())
+            return {};
+        return enclosing_int_rect(paint_box.absolute_border_box_rect());
+    case PaintPhase::Border:
+        return enclosing_int_rect(paint_box.absolute_border_box_rect());
+    default:
+        return {};
+    }
+}
+
+void DisplayList::append_paint(Paintable const& paintable, PaintPhase phase, bool only_when_focused)
+{
+    m_commands.append(Command {
+        .type = Command::Type::Paint,
+        .phase = phase,
+        .paintable = &paintable,
+        .cull_rect = cull_rect_for(paintable, phase),
+        .only_when_focused = only_when_focused,
+    });
+}
+
+void DisplayList::append_before_children_paint(Paintable const& paintable, PaintPhase phase)
+{
+    m_commands.append(Command {
+        .type = Command::Type::BeforeChildrenPaint,
+        .phase = phase,
+        .paintable = &paintable,
+    });
+}
+
+void DisplayList::append_after_children_paint(Paintable const& paintable, PaintPhase phase)
+{
+    m_commands.append(Command {
+        .type = Command::Type::AfterChildrenPaint,
+        .phase = phase,
+        .paintable = &paintable,
+    });
+}
+
+void DisplayList::append_stacking_context(StackingContext const& stacking_context)
+{
+    m_commands.append(Command {
+        .type = Command::Type::PaintStackingContext,
+        .stacking_context = &stacking_context,
+    });
+}
+
+void DisplayList::replay(PaintContext& context) const
+{
+    auto& painter = context.painter();
+
+    for (auto const& command : m_commands) {
+        switch (command.type) {
+        case Command::Type::Paint:
+            if (command.only_when_focused && !context.has_focus())
+                break;
+            if (command.cull_rect.has_value() && painter.scale() == 1) {
+                // NOTE: The clip rect is in physical coordinates, while the cull rect is relative to the current translation.
+                if (!command.cull_rect->translated(painter.translation()).intersects(painter.clip_rect()))
+                    break;
+            }
+            command.paintable->paint(context, command.phase);
+            break;
+        case Command::Type::BeforeChildrenPaint:
+            command.paintable->before_children_paint(context, command.phase);
+            break;
+        case Command::Type::AfterChildrenPaint:
+            command.paintable->after_children_paint(context, command.phase);
+            break;
+        case Command::Type::PaintStackingContext:
+            command.stacking_context->paint(context);
+            break;
+        }
+    }
+}
+
+}
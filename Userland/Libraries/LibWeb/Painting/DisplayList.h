@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/Rect.h>
+#include <LibWeb/Painting/Paintable.h>
+
+namespace Web::Painting {
+
+// A recording of the order in which the paintables of a stacking context get to paint, in each phase.
+// Recording it walks the layout tree and works out the painting order (CSS 2.1 Appendix E) once,
+// after which we can replay it as many times as we like, skipping whatever is outside the area being repainted.
+class DisplayList {
+public:
+    struct Command {
+        enum class Type {
+            Paint,
+            BeforeChildrenPaint,
+            AfterChildrenPaint,
+            PaintStackingContext,
+        };
+
+        Type type { Type::Paint };
+        PaintPhase phase { PaintPhase::Background };
+        Paintable const* paintable { nullptr };
+        StackingContext const* stacking_context { nullptr };
+
+        // NOTE: If present, nothing gets painted outside of this rect, so the command can be skipped when it's not being repainted.
+        Optional<Gfx::IntRect> cull_rect;
+
+        bool only_when_focused { false };
+    };
+
+    void append_paint(Paintable const&, PaintPhase, bool only_when_focused = false);
+    void append_before_children_paint(Paintable const&, PaintPhase);
+    void append_after_children_paint(Paintable const&, PaintPhase);
+    void append_stacking_context(StackingContext const&);
+
+    void replay(PaintContext&) const;
+
+    size_t size() const { return m_commands.size(); }
+    bool is_empty() const { return m_commands.is_empty(); }
+
+private:
+    Vector<Command> m_commands;
+};
+
+}
@@ -90,6 +90,22 @@ Gfx::FloatRect PaintableBox::absolute_rect() const
     return *m_absolute_rect;
 }
 
+Gfx::IntRect PaintableBox::absolute_paint_rect() const
+{
+    // NOTE: The focus outline is drawn 4px outside the border box.
+    auto rect = enclosing_int_rect(absolute_border_box_rect()).inflated(8, 8);
+    for (auto const& shadow : computed_values().box_shadow()) {
+        if (shadow.placement != CSS::ShadowPlacement::Outer)
+            continue;
+        auto offset_x = static_cast<int>(shadow.offset_x.to_px(layout_box()));
+        auto offset_y = static_cast<int>(shadow.offset_y.to_px(layout_box()));
+        auto extent = 2 * static_cast<int>(shadow.blur_radius.to_px(layout_box())) + static_cast<int>(shadow.spread_distance.to_px(layout_box()));
+        auto shadow_rect = enclosing_int_rect(absolute_border_box_rect()).translated(offset_x, offset_y).inflated(2 * extent, 2 * extent);
+        rect = rect.united(shadow_rect);
+    }
+    return rect;
+}
+
 void PaintableBox::set_containing_line_box_fragment(Optional<Layout::LineBoxFragmentCoordinate> fragment_coordinate)
 {
     m_containing_line_box_fragment = fragment_coordinate;
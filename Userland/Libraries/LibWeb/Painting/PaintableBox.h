@@ -32,6 +32,7 @@ public:
     };
 
     Gfx::FloatRect absolute_rect() const;
+    Gfx::FloatPoint const& offset() const { return m_offset; }
     Gfx::FloatPoint effective_offset() const;
 
     void set_offset(Gfx::FloatPoint const&);
@@ -68,6 +69,9 @@ public:
         return rect;
     }
 
+    // The area that painting this box (but not its children) may touch, including shadows and the focus outline.
+    Gfx::IntRect absolute_paint_rect() const;
+
     float border_box_width() const
     {
         auto border_box = box_model().border_box();
@@ -21,10 +21,10 @@
 
 namespace Web::Painting {
 
-static void paint_node(Layout::Node const& layout_node, PaintContext& context, PaintPhase phase)
+static void record_node(DisplayList& display_list, Layout::Node const& layout_node, PaintPhase phase, bool only_when_focused = false)
 {
     if (auto const* paintable = layout_node.paintable())
-        paintable->paint(context, phase);
+        display_list.append_paint(*paintable, phase, only_when_focused);
 }
 
 StackingContext::StackingContext(Layout::Box& box, StackingContext* parent)
@@ -68,10 +68,10 @@ static PaintPhase to_paint_phase(StackingContext::StackingContextPaintPhase phas
     }
 }
 
-void StackingContext::paint_descendants(PaintContext& context, Layout::Node& box, StackingContextPaintPhase phase) const
+void StackingContext::record_descendants(DisplayList& display_list, Layout::Node const& box, StackingContextPaintPhase phase) const
 {
     if (auto* paintable = box.paintable())
-        paintable->before_children_paint(context, to_paint_phase(phase));
+        display_list.append_before_children_paint(*paintable, to_paint_phase(phase));
 
     box.for_each_child([&](auto& child) {
         // If `child` establishes its own stacking context, skip over it.
@@ -81,92 +81,104 @@ void StackingContext::paint_descendants(PaintContext& context, Layout::Node& box
         switch (phase) {
         case StackingContextPaintPhase::BackgroundAndBorders:
             if (!child_is_inline_or_replaced && !child.is_floating() && !child.is_positioned()) {
-                paint_node(child, context, PaintPhase::Background);
-                paint_node(child, context, PaintPhase::Border);
-                paint_descendants(context, child, phase);
+                record_node(display_list, child, PaintPhase::Background);
+                record_node(display_list, child, PaintPhase::Border);
+                record_descendants(display_list, child, phase);
             }
             break;
         case StackingContextPaintPhase::Floats:
             if (!child.is_positioned()) {
                 if (child.is_floating()) {
-                    paint_node(child, context, PaintPhase::Background);
-                    paint_node(child, context, PaintPhase::Border);
-                    paint_descendants(context, child, StackingContextPaintPhase::BackgroundAndBorders);
+                    record_node(display_list, child, PaintPhase::Background);
+                    record_node(display_list, child, PaintPhase::Border);
+                    record_descendants(display_list, child, StackingContextPaintPhase::BackgroundAndBorders);
                 }
-                paint_descendants(context, child, phase);
+                record_descendants(display_list, child, phase);
             }
             break;
         case StackingContextPaintPhase::BackgroundAndBordersForInlineLevelAndReplaced:
             if (!child.is_positioned()) {
                 if (child_is_inline_or_replaced) {
-                    paint_node(child, context, PaintPhase::Background);
-                    paint_node(child, context, PaintPhase::Border);
-                    paint_descendants(context, child, StackingContextPaintPhase::BackgroundAndBorders);
+                    record_node(display_list, child, PaintPhase::Background);
+                    record_node(display_list, child, PaintPhase::Border);
+                    record_descendants(display_list, child, StackingContextPaintPhase::BackgroundAndBorders);
                 }
-                paint_descendants(context, child, phase);
+                record_descendants(display_list, child, phase);
             }
             break;
         case StackingContextPaintPhase::Foreground:
             if (!child.is_positioned()) {
-                paint_node(child, context, PaintPhase::Foreground);
-                paint_descendants(context, child, phase);
+                record_node(display_list, child, PaintPhase::Foreground);
+                record_descendants(display_list, child, phase);
             }
             break;
         case StackingContextPaintPhase::FocusAndOverlay:
-            if (context.has_focus()) {
-                paint_node(child, context, PaintPhase::FocusOutline);
-            }
-            paint_node(child, context, PaintPhase::Overlay);
-            paint_descendants(context, child, phase);
+            // NOTE: Whether we have focus is decided when the display list is replayed.
+            record_node(display_list, child, PaintPhase::FocusOutline, true);
+            record_node(display_list, child, PaintPhase::Overlay);
+            record_descendants(display_list, child, phase);
             break;
         }
     });
 
     if (auto* paintable = box.paintable())
-        paintable->after_children_paint(context, to_paint_phase(phase));
+        display_list.append_after_children_paint(*paintable, to_paint_phase(phase));
 }
 
-void StackingContext::paint_internal(PaintContext& context) const
+DisplayList const& StackingContext::display_list() const
 {
+    if (m_display_list.has_value())
+        return *m_display_list;
+
     // For a more elaborate description of the algorithm, see CSS 2.1 Appendix E
+    DisplayList display_list;
+
     // Draw the background and borders for the context root (steps 1, 2)
-    paint_node(m_box, context, PaintPhase::Background);
-    paint_node(m_box, context, PaintPhase::Border);
+    record_node(display_list, m_box, PaintPhase::Background);
+    record_node(display_list, m_box, PaintPhase::Border);
 
-    auto paint_child = [&](auto* child) {
+    auto record_child = [&](auto* child) {
         auto parent = child->m_box.parent();
         auto* paintable = parent ? parent->paintable() : nullptr;
         if (paintable)
-            paintable->before_children_paint(context, PaintPhase::Foreground);
-        child->paint(context);
+            display_list.append_before_children_paint(*paintable, PaintPhase::Foreground);
+        display_list.append_stacking_context(*child);
         if (paintable)
-            paintable->after_children_paint(context, PaintPhase::Foreground);
+            display_list.append_after_children_paint(*paintable, PaintPhase::Foreground);
     };
 
     // Draw positioned descendants with negative z-indices (step 3)
     for (auto* child : m_children) {
         if (child->m_box.computed_values().z_index().has_value() && child->m_box.computed_values().z_index().value() < 0)
-            paint_child(child);
+            record_child(child);
     }
 
     // Draw the background and borders for block-level children (step 4)
-    paint_descendants(context, m_box, StackingContextPaintPhase::BackgroundAndBorders);
+    record_descendants(display_list, m_box, StackingContextPaintPhase::BackgroundAndBorders);
     // Draw the non-positioned floats (step 5)
-    paint_descendants(context, m_box, StackingContextPaintPhase::Floats);
+    record_descendants(display_list, m_box, StackingContextPaintPhase::Floats);
     // Draw inline content, replaced content, etc. (steps 6, 7)
-    paint_descendants(context, m_box, StackingContextPaintPhase::BackgroundAndBordersForInlineLevelAndReplaced);
-    paint_node(m_box, context, PaintPhase::Foreground);
-    paint_descendants(context, m_box, StackingContextPaintPhase::Foreground);
+    record_descendants(display_list, m_box, StackingContextPaintPhase::BackgroundAndBordersForInlineLevelAndReplaced);
+    record_node(display_list, m_box, PaintPhase::Foreground);
+    record_descendants(display_list, m_box, StackingContextPaintPhase::Foreground);
     // Draw other positioned descendants (steps 8, 9)
     for (auto* child : m_children) {
         if (child->m_box.computed_values().z_index().has_value() && child->m_box.computed_values().z_index().value() < 0)
             continue;
-        paint_child(child);
+        record_child(child);
     }
 
-    paint_node(m_box, context, PaintPhase::FocusOutline);
-    paint_node(m_box, context, PaintPhase::Overlay);
-    paint_descendants(context, m_box, StackingContextPaintPhase::FocusAndOverlay);
+    record_node(display_list, m_box, PaintPhase::FocusOutline, true);
+    record_node(display_list, m_box, PaintPhase::Overlay);
+    record_descendants(display_list, m_box, StackingContextPaintPhase::FocusAndOverlay);
+
+    m_display_list = move(display_list);
+    return *m_display_list;
+}
+
+void StackingContext::paint_internal(PaintContext& context) const
+{
+    display_list().replay(context);
 }
 
 Gfx::FloatMatrix4x4 StackingContext::get_transformation_matrix(CSS::Transformation const& transformation) const
@@ -291,13 +303,9 @@ void StackingContext::paint(PaintContext& context) const
     auto affine_transform = affine_transform_matrix();
 
     if (opacity < 1.0f || !affine_transform.is_identity()) {
-        auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, context.painter().target()->size());
-        if (bitmap_or_error.is_error())
+        auto* layer = ensure_layer(context);
+        if (!layer)
             return;
-        auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
-        Gfx::Painter painter(bitmap);
-        auto paint_context = context.clone(painter);
-        paint_internal(paint_context);
 
         auto transform_origin = this->transform_origin();
         auto source_rect = paintable().absolute_border_box_rect().translated(-transform_origin);
@@ -305,16 +313,80 @@ void StackingContext::paint(PaintContext& context) const
         auto transformed_destination_rect = affine_transform.map(source_rect).translated(transform_origin);
         source_rect.translate_by(transform_origin);
 
+        // NOTE: The layer bitmap starts at the top left of the (pixel-aligned) border box.
+        source_rect.translate_by(-layer->rect.location().to_type<float>());
+
         // NOTE: If the destination and source rects are the same size, we round the source rect to ensure that it's pixel-aligned.
         if (transformed_destination_rect.size() == source_rect.size())
-            context.painter().draw_scaled_bitmap(transformed_destination_rect.to_rounded<int>(), *bitmap, source_rect.to_rounded<int>(), opacity);
+            context.painter().draw_scaled_bitmap(transformed_destination_rect.to_rounded<int>(), *layer->bitmap, source_rect.to_rounded<int>(), opacity);
         else
-            context.painter().draw_scaled_bitmap(transformed_destination_rect.to_rounded<int>(), *bitmap, source_rect, opacity, Gfx::Painter::ScalingMode::BilinearBlend);
+            context.painter().draw_scaled_bitmap(transformed_destination_rect.to_rounded<int>(), *layer->bitmap, source_rect, opacity, Gfx::Painter::ScalingMode::BilinearBlend);
     } else {
         paint_internal(context);
     }
 }
 
+// Stacking contexts with opacity or a transform are painted into a layer of their own, which is then composited onto the page.
+// We hold on to that layer, so that it only has to be painted again when something inside it changes.
+StackingContext::Layer const* StackingContext::ensure_layer(PaintContext& context) const
+{
+    auto layer_rect = enclosing_int_rect(paintable().absolute_border_box_rect());
+    if (layer_rect.is_empty())
+        return nullptr;
+
+    if (m_layer.has_value()) {
+        auto const& layer = *m_layer;
+        bool is_still_valid = layer.rect == layer_rect
+            && layer.painted_with_focus == context.has_focus()
+            && (layer.scroll_offset == context.scroll_offset() || !has_fixed_position_descendant());
+        if (is_still_valid)
+            return &layer;
+        m_layer = {};
+    }
+
+    auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, layer_rect.size());
+    if (bitmap_or_error.is_error())
+        return nullptr;
+    auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    painter.translate(-layer_rect.location());
+    auto paint_context = context.clone(painter);
+    paint_internal(paint_context);
+
+    m_layer = Layer {
+        .bitmap = move(bitmap),
+        .rect = layer_rect,
+        .scroll_offset = context.scroll_offset(),
+        .painted_with_focus = context.has_focus(),
+    };
+    return &*m_layer;
+}
+
+bool StackingContext::has_fixed_position_descendant() const
+{
+    for (auto const* child : m_children) {
+        if (child->m_box.is_fixed_position() || child->has_fixed_position_descendant())
+            return true;
+    }
+    return false;
+}
+
+void StackingContext::invalidate_layers()
+{
+    m_layer = {};
+    for (auto* child : m_children)
+        child->invalidate_layers();
+}
+
+void StackingContext::invalidate_layers_intersecting(Gfx::IntRect const& rect)
+{
+    // NOTE: Rects are in the coordinate space of the page, before any transforms are applied.
+    if (m_layer.has_value() && m_layer->rect.intersects(rect))
+        m_layer = {};
+    for (auto* child : m_children)
+        child->invalidate_layers_intersecting(rect);
+}
+
 Gfx::FloatPoint StackingContext::transform_origin() const
 {
     auto style_value = m_box.computed_values().transform_origin();
@@ -325,6 +397,152 @@ Gfx::FloatPoint StackingContext::transform_origin() const
     return { x, y };
 }
 
+// FIXME: Support more overflow variations.
+static bool clips_hit_testing(PaintableBox const& paint_box)
+{
+    return paint_box.computed_values().overflow_x() == CSS::Overflow::Hidden && paint_box.computed_values().overflow_y() == CSS::Overflow::Hidden;
+}
+
+// Returns an empty Optional if no point is inside both rects.
+static Optional<Gfx::FloatRect> intersect_clips(Gfx::FloatRect const& a, Gfx::FloatRect const& b)
+{
+    auto left = max(a.left(), b.left());
+    auto top = max(a.top(), b.top());
+    auto right = min(a.right(), b.right());
+    auto bottom = min(a.bottom(), b.bottom());
+    if (right < left || bottom < top)
+        return {};
+    return Gfx::FloatRect::from_two_points({ left, top }, { right, bottom });
+}
+
+static Gfx::FloatRect hit_test_bounds(PaintableBox const& paint_box)
+{
+    auto bounds = paint_box.absolute_border_box_rect();
+    if (!is<PaintableWithLines>(paint_box) || !paint_box.layout_box().children_are_inline())
+        return bounds;
+
+    // NOTE: PaintableWithLines::hit_test() looks at the fragments, and into the inline blocks among them.
+    for (auto const& line_box : static_cast<PaintableWithLines const&>(paint_box).line_boxes()) {
+        for (auto const& fragment : line_box.fragments()) {
+            bounds = bounds.united(fragment.absolute_rect());
+            if (is<Layout::BlockContainer>(fragment.layout_node()) && fragment.layout_node().paintable() && is<PaintableBox>(*fragment.layout_node().paintable()))
+                bounds = bounds.united(hit_test_bounds(static_cast<PaintableBox const&>(*fragment.layout_node().paintable())));
+        }
+    }
+    return bounds;
+}
+
+u8 StackingContext::hit_test_candidate_kinds(PaintableBox const& paint_box)
+{
+    auto& layout_box = paint_box.layout_box();
+    u8 kinds = 0;
+    if (layout_box.is_positioned() && !paint_box.stacking_context())
+        kinds |= HitTestCandidate::PositionedDescendant;
+    if (layout_box.is_floating())
+        kinds |= HitTestCandidate::Float;
+    if (!layout_box.is_absolutely_positioned() && !layout_box.is_floating())
+        kinds |= HitTestCandidate::InFlowBlock;
+    return kinds;
+}
+
+void StackingContext::collect_hit_test_candidates(Paintable const& parent, Optional<Gfx::FloatRect> const& clip, Vector<HitTestCandidate>& candidates)
+{
+    for (auto const* child = parent.first_child(); child; child = child->next_sibling()) {
+        auto child_clip = clip;
+        if (is<PaintableBox>(*child)) {
+            auto const& paint_box = static_cast<PaintableBox const&>(*child);
+            if (clips_hit_testing(paint_box)) {
+                auto rect = paint_box.absolute_border_box_rect();
+                if (clip.has_value()) {
+                    child_clip = intersect_clips(*clip, rect);
+                    // Nothing in here can ever be hit.
+                    if (!child_clip.has_value())
+                        continue;
+                } else {
+                    child_clip = rect;
+                }
+            }
+            if (auto kinds = hit_test_candidate_kinds(paint_box))
+                candidates.append({ &paint_box, hit_test_bounds(paint_box), child_clip, kinds });
+        }
+        collect_hit_test_candidates(*child, child_clip, candidates);
+    }
+}
+
+StackingContext::HitTestIndex const& StackingContext::hit_test_index() const
+{
+    if (m_hit_test_index.has_value())
+        return *m_hit_test_index;
+
+    HitTestIndex index;
+    collect_hit_test_candidates(paintable(), {}, index.candidates);
+
+    if (!index.candidates.is_empty()) {
+        auto top = index.candidates.first().bounds.top();
+        auto bottom = index.candidates.first().bounds.bottom();
+        for (auto const& candidate : index.candidates) {
+            top = min(top, candidate.bounds.top());
+            bottom = max(bottom, candidate.bounds.bottom());
+        }
+
+        // NOTE: Very tall pages get taller bands rather than ever more of them.
+        static constexpr float min_band_height = 256;
+        static constexpr size_t max_band_count = 1024;
+        index.top = top;
+        index.band_height = max(min_band_height, (bottom - top) / max_band_count);
+        index.bands.resize(static_cast<size_t>((bottom - top) / index.band_height) + 1);
+
+        for (size_t i = 0; i < index.candidates.size(); ++i) {
+            auto const& bounds = index.candidates[i].bounds;
+            auto first_band = static_cast<size_t>((bounds.top() - top) / index.band_height);
+            auto last_band = min(static_cast<size_t>((bounds.bottom() - top) / index.band_height), index.bands.size() - 1);
+            for (auto band = first_band; band <= last_band; ++band)
+                index.bands[band].append(i);
+        }
+    }
+
+    m_hit_test_index = move(index);
+    return *m_hit_test_index;
+}
+
+// Finds the last candidate of the given kind in tree order that the position hits.
+Optional<HitTestResult> StackingContext::hit_test_candidates(Gfx::FloatPoint const& position, HitTestType type, HitTestCandidate::Kind kind) const
+{
+    // NOTE: A text cursor hit test can pick a box even if the position is nowhere near it, so it has to look at all of them.
+    if (type != HitTestType::Exact) {
+        Optional<HitTestResult> result;
+        paintable().for_each_in_subtree_of_type<PaintableBox>([&](auto const& paint_box) {
+            if (clips_hit_testing(paint_box) && !paint_box.absolute_border_box_rect().contains(position.x(), position.y()))
+                return TraversalDecision::SkipChildrenAndContinue;
+            if (hit_test_candidate_kinds(paint_box) & kind) {
+                if (auto candidate = paint_box.hit_test(position, type); candidate.has_value())
+                    result = move(candidate);
+            }
+            return TraversalDecision::Continue;
+        });
+        return result;
+    }
+
+    auto const& index = hit_test_index();
+    if (index.bands.is_empty() || position.y() < index.top)
+        return {};
+    auto band = static_cast<size_t>((position.y() - index.top) / index.band_height);
+    if (band >= index.bands.size())
+        return {};
+
+    auto const& candidates_in_band = index.bands[band];
+    for (size_t i = candidates_in_band.size(); i > 0; --i) {
+        auto const& candidate = index.candidates[candidates_in_band[i - 1]];
+        if (!(candidate.kinds & kind) || !candidate.bounds.contains(position))
+            continue;
+        if (candidate.clip.has_value() && !candidate.clip->contains(position))
+            continue;
+        if (auto result = candidate.paint_box->hit_test(position, type); result.has_value())
+            return result;
+    }
+    return {};
+}
+
 Optional<HitTestResult> StackingContext::hit_test(Gfx::FloatPoint const& position, HitTestType type) const
 {
     if (!m_box.is_visible())
@@ -352,23 +570,8 @@ Optional<HitTestResult> StackingContext::hit_test(Gfx::FloatPoint const& positio
             return result;
     }
 
-    Optional<HitTestResult> result;
     // 6. the child stacking contexts with stack level 0 and the positioned descendants with stack level 0.
-    paintable().for_each_in_subtree_of_type<PaintableBox>([&](auto& paint_box) {
-        // FIXME: Support more overflow variations.
-        if (paint_box.computed_values().overflow_x() == CSS::Overflow::Hidden && paint_box.computed_values().overflow_y() == CSS::Overflow::Hidden) {
-            if (!paint_box.absolute_border_box_rect().contains(transformed_position.x(), transformed_position.y()))
-                return TraversalDecision::SkipChildrenAndContinue;
-        }
-
-        auto& layout_box = paint_box.layout_box();
-        if (layout_box.is_positioned() && !paint_box.stacking_context()) {
-            if (auto candidate = paint_box.hit_test(transformed_position, type); candidate.has_value())
-                result = move(candidate);
-        }
-        return TraversalDecision::Continue;
-    });
-    if (result.has_value())
+    if (auto result = hit_test_candidates(transformed_position, type, HitTestCandidate::PositionedDescendant); result.has_value())
         return result;
 
     // 5. the in-flow, inline-level, non-positioned descendants, including inline tables and inline blocks.
@@ -379,40 +582,12 @@ Optional<HitTestResult> StackingContext::hit_test(Gfx::FloatPoint const& positio
     }
 
     // 4. the non-positioned floats.
-    paintable().for_each_in_subtree_of_type<PaintableBox>([&](auto const& paint_box) {
-        // FIXME: Support more overflow variations.
-        if (paint_box.computed_values().overflow_x() == CSS::Overflow::Hidden && paint_box.computed_values().overflow_y() == CSS::Overflow::Hidden) {
-            if (!paint_box.absolute_border_box_rect().contains(transformed_position.x(), transformed_position.y()))
-                return TraversalDecision::SkipChildrenAndContinue;
-        }
-
-        auto& layout_box = paint_box.layout_box();
-        if (layout_box.is_floating()) {
-            if (auto candidate = paint_box.hit_test(transformed_position, type); candidate.has_value())
-                result = move(candidate);
-        }
-        return TraversalDecision::Continue;
-    });
-    if (result.has_value())
+    if (auto result = hit_test_candidates(transformed_position, type, HitTestCandidate::Float); result.has_value())
         return result;
 
     // 3. the in-flow, non-inline-level, non-positioned descendants.
     if (!m_box.children_are_inline()) {
-        paintable().for_each_in_subtree_of_type<PaintableBox>([&](auto const& paint_box) {
-            // FIXME: Support more overflow variations.
-            if (paint_box.computed_values().overflow_x() == CSS::Overflow::Hidden && paint_box.computed_values().overflow_y() == CSS::Overflow::Hidden) {
-                if (!paint_box.absolute_border_box_rect().contains(transformed_position.x(), transformed_position.y()))
-                    return TraversalDecision::SkipChildrenAndContinue;
-            }
-
-            auto& layout_box = paint_box.layout_box();
-            if (!layout_box.is_absolutely_positioned() && !layout_box.is_floating()) {
-                if (auto candidate = paint_box.hit_test(transformed_position, type); candidate.has_value())
-                    result = move(candidate);
-            }
-            return TraversalDecision::Continue;
-        });
-        if (result.has_value())
+        if (auto result = hit_test_candidates(transformed_position, type, HitTestCandidate::InFlowBlock); result.has_value())
             return result;
     }
 
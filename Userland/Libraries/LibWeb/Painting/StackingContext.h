@@ -7,8 +7,10 @@
 #pragma once
 
 #include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibWeb/Layout/Node.h>
+#include <LibWeb/Painting/DisplayList.h>
 #include <LibWeb/Painting/Paintable.h>
 
 namespace Web::Painting {
@@ -30,13 +32,19 @@ public:
         FocusAndOverlay,
     };
 
-    void paint_descendants(PaintContext&, Layout::Node&, StackingContextPaintPhase) const;
     void paint(PaintContext&) const;
+
+    // NOTE: The display list is recorded on first use, and lives as long as the stacking context tree.
+    DisplayList const& display_list() const;
     Optional<HitTestResult> hit_test(Gfx::FloatPoint const&, HitTestType) const;
 
     Gfx::FloatMatrix4x4 const& transform_matrix() const { return m_transform; }
     Gfx::AffineTransform affine_transform_matrix() const;
 
+    // Drop the cached layers of this stacking context and its descendants, so they get painted again.
+    void invalidate_layers();
+    void invalidate_layers_intersecting(Gfx::IntRect const&);
+
     void dump(int indent = 0) const;
 
     void sort();
@@ -47,6 +55,52 @@ private:
     StackingContext* const m_parent { nullptr };
     Vector<StackingContext*> m_children;
 
+    Optional<DisplayList> mutable m_display_list;
+
+    struct Layer {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        Gfx::IntRect rect;
+        Gfx::IntPoint scroll_offset;
+        bool painted_with_focus { false };
+    };
+    Optional<Layer> mutable m_layer;
+
+    // A box that steps 6, 4 or 3 of hit testing may pick.
+    struct HitTestCandidate {
+        enum Kind : u8 {
+            PositionedDescendant = 1 << 0,
+            Float = 1 << 1,
+            InFlowBlock = 1 << 2,
+        };
+
+        PaintableBox const* paint_box { nullptr };
+        // Where the box's own hit_test() can find anything.
+        Gfx::FloatRect bounds;
+        // Where the box isn't cut off by overflow: hidden on itself or an ancestor.
+        Optional<Gfx::FloatRect> clip;
+        u8 kinds { 0 };
+    };
+
+    // The candidates in tree order, and which of them overlap each horizontal band of the page, so that a hit test only
+    // has to look at the boxes that are around the position instead of walking the whole subtree.
+    // NOTE: Like the display list, this is built on first use and lives as long as the stacking context tree.
+    struct HitTestIndex {
+        Vector<HitTestCandidate> candidates;
+        Vector<Vector<u32>> bands;
+        float top { 0 };
+        float band_height { 1 };
+    };
+    Optional<HitTestIndex> mutable m_hit_test_index;
+
+    HitTestIndex const& hit_test_index() const;
+    static u8 hit_test_candidate_kinds(PaintableBox const&);
+    static void collect_hit_test_candidates(Paintable const&, Optional<Gfx::FloatRect> const& clip, Vector<HitTestCandidate>&);
+    Optional<HitTestResult> hit_test_candidates(Gfx::FloatPoint const&, HitTestType, HitTestCandidate::Kind) const;
+
+    Layer const* ensure_layer(PaintContext&) const;
+    bool has_fixed_position_descendant() const;
+
+    void record_descendants(DisplayList&, Layout::Node const&, StackingContextPaintPhase) const;
     void paint_internal(PaintContext&) const;
     Gfx::FloatMatrix4x4 get_transformation_matrix(CSS::Transformation const& transformation) const;
     Gfx::FloatMatrix4x4 combine_transformations(Vector<CSS::Transformation> const& transformations) const;
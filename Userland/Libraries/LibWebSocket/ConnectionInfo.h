@@ -29,6 +29,10 @@ public:
     Vector<String> const& extensions() const { return m_extensions; }
     void set_extensions(Vector<String> extensions) { m_extensions = move(extensions); }
 
+    // Whether to offer compressing messages with the permessage-deflate extension - defined in RFC 7692
+    bool permessage_deflate() const { return m_permessage_deflate; }
+    void set_permessage_deflate(bool permessage_deflate) { m_permessage_deflate = permessage_deflate; }
+
     struct Header {
         String name;
         String value;
@@ -48,6 +52,7 @@ private:
     Vector<String> m_protocols {};
     Vector<String> m_extensions {};
     Vector<Header> m_headers {};
+    bool m_permessage_deflate { true };
 };
 
 }
@@ -30,6 +30,7 @@ public:
 
     bool can_read() { return MUST(m_socket->can_read_without_blocking()); }
     ErrorOr<ByteBuffer> read(int max_size);
+    ErrorOr<Bytes> read(Bytes buffer) { return m_socket->read(buffer); }
 
     bool send(ReadonlyBytes bytes) { return m_socket->write_or_error(bytes); }
 
@@ -6,7 +6,9 @@
  */
 
 #include <AK/Base64.h>
+#include <AK/MemoryStream.h>
 #include <AK/Random.h>
+#include <LibCompress/Deflate.h>
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibWebSocket/WebSocket.h>
 #include <unistd.h>
@@ -16,6 +18,31 @@ namespace WebSocket {
 // Note : The websocket protocol is defined by RFC 6455, found at https://tools.ietf.org/html/rfc6455
 // In this file, section numbers will refer to the RFC 6455
 
+// Messages smaller than this are sent uncompressed, as compressing them saves next to nothing.
+static constexpr size_t minimum_size_worth_compressing = 128;
+
+// The largest window permessage-deflate can use, see RFC 7692 section 7.1.2
+static constexpr size_t deflate_window_size = 32 * KiB;
+
+// Section 5.3 : Masking and unmasking is the same XOR of the data with the masking key repeated over it.
+// This is done a machine word at a time instead of byte by byte, which the compiler can vectorize further.
+static void apply_mask(Bytes data, u8 const* masking_key)
+{
+    u32 key;
+    __builtin_memcpy(&key, masking_key, sizeof(key));
+    u64 const wide_key = (static_cast<u64>(key) << 32) | key;
+
+    size_t offset = 0;
+    for (; offset + sizeof(u64) <= data.size(); offset += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, data.data() + offset, sizeof(word));
+        word ^= wide_key;
+        __builtin_memcpy(data.data() + offset, &word, sizeof(word));
+    }
+    for (; offset < data.size(); ++offset)
+        data[offset] ^= masking_key[offset % 4];
+}
+
 NonnullRefPtr<WebSocket> WebSocket::create(ConnectionInfo connection)
 {
     return adopt_ref(*new WebSocket(move(connection)));
@@ -76,10 +103,15 @@ void WebSocket::send(Message const& message)
     // Calling send on a socket that is not opened is not allowed
     VERIFY(m_state == WebSocket::InternalState::Open);
     VERIFY(m_impl);
-    if (message.is_text())
-        send_frame(WebSocket::OpCode::Text, message.data(), true);
-    else
-        send_frame(WebSocket::OpCode::Binary, message.data(), true);
+    auto op_code = message.is_text() ? WebSocket::OpCode::Text : WebSocket::OpCode::Binary;
+    if (m_permessage_deflate && message.data().size() >= minimum_size_worth_compressing) {
+        auto compressed_data = compress_message(message.data());
+        if (compressed_data.has_value() && compressed_data->size() < message.data().size()) {
+            send_frame(op_code, *compressed_data, true, true);
+            return;
+        }
+    }
+    send_frame(op_code, message.data(), true);
 }
 
 void WebSocket::close(u16 code, String const& message)
@@ -117,7 +149,10 @@ void WebSocket::drain_read()
     } break;
     case InternalState::Open:
     case InternalState::Closing: {
-        read_frame();
+        // Several frames may have arrived at once, and once they are buffered, we won't be told about them again.
+        do {
+            read_frame();
+        } while ((m_state == InternalState::Open || m_state == InternalState::Closing) && m_impl->can_read());
     } break;
     case InternalState::Closed:
     case InternalState::Errored: {
@@ -175,9 +210,13 @@ void WebSocket::send_client_handshake()
     }
 
     // 11. Websocket extensions (optional field)
-    if (!m_connection.extensions().is_empty()) {
+    auto extensions = m_connection.extensions();
+    // RFC 7692 section 7.1.1.2 : Every message we send is compressed on its own, so the server doesn't have to keep its context around either.
+    if (m_connection.permessage_deflate())
+        extensions.append("permessage-deflate; client_no_context_takeover");
+    if (!extensions.is_empty()) {
         builder.append("Sec-WebSocket-Extensions: "sv);
-        builder.join(',', m_connection.extensions());
+        builder.join(',', extensions);
         builder.append("\r\n"sv);
     }
 
@@ -310,21 +349,9 @@ void WebSocket::read_server_handshake()
         }
 
         if (header_name.equals_ignoring_case("Sec-WebSocket-Extensions"sv)) {
-            // 5. |Sec-WebSocket-Extensions| should not contain an extension that doesn't appear in m_connection->extensions()
-            auto server_extensions = parts[1].split(',');
-            for (auto const& extension : server_extensions) {
-                auto trimmed_extension = extension.trim_whitespace();
-                bool found_extension = false;
-                for (auto const& supported_extension : m_connection.extensions()) {
-                    if (trimmed_extension.equals_ignoring_case(supported_extension)) {
-                        found_extension = true;
-                    }
-                }
-                if (!found_extension) {
-                    dbgln("WebSocket: Server HTTP Handshake Header |Sec-WebSocket-Extensions| contains '{}', which is not supported by the client. Failing connection.", trimmed_extension);
-                    fatal_error(WebSocket::Error::ConnectionUpgradeFailed);
-                    return;
-                }
+            if (!read_server_extensions(parts[1])) {
+                fatal_error(WebSocket::Error::ConnectionUpgradeFailed);
+                return;
             }
             continue;
         }
@@ -353,12 +380,67 @@ void WebSocket::read_server_handshake()
     // If needed, we will keep reading the header on the next drain_read call
 }
 
+bool WebSocket::read_server_extensions(StringView server_extensions)
+{
+    // 5. |Sec-WebSocket-Extensions| should not contain an extension that doesn't appear in m_connection->extensions()
+    for (auto extension : server_extensions.split_view(',')) {
+        auto trimmed_extension = extension.trim_whitespace();
+
+        auto parameters = trimmed_extension.split_view(';');
+        if (m_connection.permessage_deflate() && !parameters.is_empty() && parameters.take_first().trim_whitespace().equals_ignoring_case("permessage-deflate"sv)) {
+            if (m_permessage_deflate) {
+                dbgln("WebSocket: Server HTTP Handshake Header |Sec-WebSocket-Extensions| contains 'permessage-deflate' more than once. Failing connection.");
+                return false;
+            }
+            // The parameters are defined in RFC 7692 section 7.1
+            for (auto parameter : parameters) {
+                auto parameter_name = parameter.split_view('=').first().trim_whitespace();
+                if (parameter_name.equals_ignoring_case("server_no_context_takeover"sv)) {
+                    m_server_no_context_takeover = true;
+                } else if (parameter_name.equals_ignoring_case("client_no_context_takeover"sv) || parameter_name.equals_ignoring_case("server_max_window_bits"sv)) {
+                    // We don't keep our context anyway, and the history we keep is large enough for any window.
+                } else {
+                    dbgln("WebSocket: Server HTTP Handshake Header |Sec-WebSocket-Extensions| contains parameter '{}' for 'permessage-deflate', which the client didn't offer. Failing connection.", parameter_name);
+                    return false;
+                }
+            }
+            m_permessage_deflate = true;
+            continue;
+        }
+
+        bool found_extension = false;
+        for (auto const& supported_extension : m_connection.extensions()) {
+            if (trimmed_extension.equals_ignoring_case(supported_extension)) {
+                found_extension = true;
+            }
+        }
+        if (!found_extension) {
+            dbgln("WebSocket: Server HTTP Handshake Header |Sec-WebSocket-Extensions| contains '{}', which is not supported by the client. Failing connection.", trimmed_extension);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WebSocket::read_exactly(Bytes buffer)
+{
+    size_t read_length = 0;
+    while (read_length < buffer.size()) {
+        auto result = m_impl->read(buffer.slice(read_length));
+        if (result.is_error() || result.value().is_empty())
+            return false;
+        read_length += result.value().size();
+    }
+    return true;
+}
+
 void WebSocket::read_frame()
 {
     VERIFY(m_impl);
     VERIFY(m_state == WebSocket::InternalState::Open || m_state == WebSocket::InternalState::Closing);
 
-    auto head_bytes_result = m_impl->read(2);
+    u8 head_bytes[2];
+    auto head_bytes_result = m_impl->read({ head_bytes, sizeof(head_bytes) });
     if (head_bytes_result.is_error() || head_bytes_result.value().is_empty()) {
         // The connection got closed.
         m_state = WebSocket::InternalState::Closed;
@@ -366,15 +448,15 @@ void WebSocket::read_frame()
         discard_connection();
         return;
     }
-    auto head_bytes = head_bytes_result.release_value();
-    VERIFY(head_bytes.size() == 2);
-
-    bool is_final_frame = head_bytes[0] & 0x80;
-    if (!is_final_frame) {
-        // FIXME: Support fragmented frames
-        TODO();
+    if (head_bytes_result.value().size() < sizeof(head_bytes) && !read_exactly({ head_bytes + 1, 1 })) {
+        dbgln("Websocket: Server disconnected while sending a frame header");
+        fatal_error(WebSocket::Error::ServerClosedSocket);
+        return;
     }
 
+    bool is_final_frame = head_bytes[0] & 0x80;
+    // RFC 7692 section 6 : RSV1 is set on the first frame of a compressed message
+    bool is_compressed = head_bytes[0] & 0x40;
     auto op_code = (WebSocket::OpCode)(head_bytes[0] & 0x0f);
     bool is_masked = head_bytes[1] & 0x80;
 
@@ -383,8 +465,12 @@ void WebSocket::read_frame()
     auto payload_length_bits = head_bytes[1] & 0x7f;
     if (payload_length_bits == 127) {
         // A code of 127 means that the next 8 bytes contains the payload length
-        auto actual_bytes = MUST(m_impl->read(8));
-        VERIFY(actual_bytes.size() == 8);
+        u8 actual_bytes[8];
+        if (!read_exactly({ actual_bytes, sizeof(actual_bytes) })) {
+            dbgln("Websocket: Server disconnected while sending a frame header");
+            fatal_error(WebSocket::Error::ServerClosedSocket);
+            return;
+        }
         u64 full_payload_length = (u64)((u64)(actual_bytes[0] & 0xff) << 56)
             | (u64)((u64)(actual_bytes[1] & 0xff) << 48)
             | (u64)((u64)(actual_bytes[2] & 0xff) << 40)
@@ -397,8 +483,12 @@ void WebSocket::read_frame()
         payload_length = (size_t)full_payload_length;
     } else if (payload_length_bits == 126) {
         // A code of 126 means that the next 2 bytes contains the payload length
-        auto actual_bytes = MUST(m_impl->read(2));
-        VERIFY(actual_bytes.size() == 2);
+        u8 actual_bytes[2];
+        if (!read_exactly({ actual_bytes, sizeof(actual_bytes) })) {
+            dbgln("Websocket: Server disconnected while sending a frame header");
+            fatal_error(WebSocket::Error::ServerClosedSocket);
+            return;
+        }
         payload_length = (size_t)((size_t)(actual_bytes[0] & 0xff) << 8)
             | (size_t)((size_t)(actual_bytes[1] & 0xff) << 0);
     } else {
@@ -412,147 +502,195 @@ void WebSocket::read_frame()
     // > (These rules might be relaxed in a future specification.)
     // But because it doesn't cost much, we can support receiving masked frames anyways.
     u8 masking_key[4];
-    if (is_masked) {
-        auto masking_key_data = MUST(m_impl->read(4));
-        VERIFY(masking_key_data.size() == 4);
-        masking_key[0] = masking_key_data[0];
-        masking_key[1] = masking_key_data[1];
-        masking_key[2] = masking_key_data[2];
-        masking_key[3] = masking_key_data[3];
+    if (is_masked && !read_exactly({ masking_key, sizeof(masking_key) })) {
+        dbgln("Websocket: Server disconnected while sending a frame header");
+        fatal_error(WebSocket::Error::ServerClosedSocket);
+        return;
     }
 
-    auto payload = ByteBuffer::create_uninitialized(payload_length).release_value_but_fixme_should_propagate_errors(); // FIXME: Handle possible OOM situation.
-    u64 read_length = 0;
-    while (read_length < payload_length) {
-        auto payload_part_result = m_impl->read(payload_length - read_length);
-        if (payload_part_result.is_error() || payload_part_result.value().is_empty()) {
-            // We got disconnected, somehow.
-            dbgln("Websocket: Server disconnected while sending payload ({} bytes read out of {})", read_length, payload_length);
-            fatal_error(WebSocket::Error::ServerClosedSocket);
-            return;
-        }
-        auto payload_part = payload_part_result.release_value();
-        // We read at most "actual_length - read" bytes, so this is safe to do.
-        payload.overwrite(read_length, payload_part.data(), payload_part.size());
-        read_length += payload_part.size();
+    // The payload is read straight into the end of the message it belongs to, which is handed out as-is once it's complete.
+    // Control frames may come in between the frames of a message (Section 5.4), so they are only there temporarily.
+    auto message_size = m_message_data.size();
+    auto payload_or_error = m_message_data.get_bytes_for_writing(payload_length);
+    if (payload_or_error.is_error()) {
+        dbgln("Websocket: Not enough memory for a payload of {} bytes", payload_length);
+        fatal_error(WebSocket::Error::ServerClosedSocket);
+        return;
+    }
+    auto payload = payload_or_error.release_value();
+    if (!read_exactly(payload)) {
+        // We got disconnected, somehow.
+        dbgln("Websocket: Server disconnected while sending payload of {} bytes", payload_length);
+        fatal_error(WebSocket::Error::ServerClosedSocket);
+        return;
     }
 
     if (is_masked) {
         // Unmask the payload
-        for (size_t i = 0; i < payload.size(); ++i) {
-            payload[i] = payload[i] ^ (masking_key[i % 4]);
-        }
+        apply_mask(payload, masking_key);
     }
 
-    if (op_code == WebSocket::OpCode::ConnectionClose) {
-        if (payload.size() > 1) {
-            m_last_close_code = (((u16)(payload[0] & 0xff) << 8) | ((u16)(payload[1] & 0xff)));
-            m_last_close_message = String(ReadonlyBytes(payload.offset_pointer(2), payload.size() - 2));
+    bool is_control_frame = to_underlying(op_code) & 0x8;
+    if (is_control_frame) {
+        ScopeGuard drop_payload = [&] { m_message_data.resize(message_size); };
+
+        if (op_code == WebSocket::OpCode::ConnectionClose) {
+            if (payload.size() > 1) {
+                m_last_close_code = (((u16)(payload[0] & 0xff) << 8) | ((u16)(payload[1] & 0xff)));
+                m_last_close_message = String(payload.slice(2));
+            }
+            m_state = WebSocket::InternalState::Closing;
+            return;
         }
-        m_state = WebSocket::InternalState::Closing;
-        return;
-    }
-    if (op_code == WebSocket::OpCode::Ping) {
-        // Immediately send a pong frame as a reply, with the given payload.
-        send_frame(WebSocket::OpCode::Pong, payload, true);
-        return;
-    }
-    if (op_code == WebSocket::OpCode::Pong) {
-        // We can safely ignore the pong
+        if (op_code == WebSocket::OpCode::Ping) {
+            // Immediately send a pong frame as a reply, with the given payload.
+            send_frame(WebSocket::OpCode::Pong, payload, true);
+            return;
+        }
+        if (op_code == WebSocket::OpCode::Pong) {
+            // We can safely ignore the pong
+            return;
+        }
+        dbgln("Websocket: Found unknown opcode {}", (u8)op_code);
         return;
     }
+
     if (op_code == WebSocket::OpCode::Continuation) {
-        // FIXME: Support fragmented frames
-        TODO();
+        if (!m_message_op_code.has_value()) {
+            dbgln("Websocket: Got a continuation frame without a message to continue");
+            m_message_data.clear();
+            return;
+        }
+    } else {
+        if (m_message_op_code.has_value() || (op_code != WebSocket::OpCode::Text && op_code != WebSocket::OpCode::Binary)) {
+            dbgln("Websocket: Found unexpected opcode {}", (u8)op_code);
+            m_message_data.clear();
+            m_message_op_code.clear();
+            return;
+        }
+        m_message_op_code = op_code;
+        m_message_is_compressed = is_compressed && m_permessage_deflate;
     }
-    if (op_code == WebSocket::OpCode::Text) {
-        notify_message(Message(payload, true));
+
+    if (!is_final_frame)
         return;
+
+    auto message_data = move(m_message_data);
+    auto message_op_code = m_message_op_code.release_value();
+    if (m_message_is_compressed) {
+        auto decompressed_data = decompress_message(message_data);
+        if (!decompressed_data.has_value()) {
+            dbgln("Websocket: Failed to decompress a message of {} bytes", message_data.size());
+            return;
+        }
+        message_data = decompressed_data.release_value();
     }
-    if (op_code == WebSocket::OpCode::Binary) {
-        notify_message(Message(payload, false));
-        return;
+    notify_message(Message(move(message_data), message_op_code == WebSocket::OpCode::Text));
+}
+
+Optional<ByteBuffer> WebSocket::compress_message(ReadonlyBytes data)
+{
+    auto compressed_data = Compress::DeflateCompressor::compress_all(data);
+    if (!compressed_data.has_value())
+        return {};
+    // RFC 7692 section 7.2.3.3 : The stream is ended with a final block instead of being flushed, which is followed by an empty byte.
+    if (compressed_data->try_append(0).is_error())
+        return {};
+    return compressed_data;
+}
+
+Optional<ByteBuffer> WebSocket::decompress_message(ByteBuffer& data)
+{
+    // RFC 7692 section 7.2.2 : The sender flushed the stream with an empty block, and left off the end of that.
+    if (data.try_append("\x00\x00\xff\xff", 4).is_error())
+        return {};
+
+    InputMemoryStream input_stream { data };
+    auto decompressor_or_error = try_make<Compress::DeflateDecompressor>(input_stream);
+    if (decompressor_or_error.is_error())
+        return {};
+    auto decompressor = decompressor_or_error.release_value();
+    // Unless the server told us otherwise, it keeps its compression context from one message to the next, so we have to do the same.
+    if (!m_server_no_context_takeover)
+        decompressor->set_history(m_decompression_history);
+
+    ByteBuffer decompressed_data;
+    while (true) {
+        auto size = decompressed_data.size();
+        auto buffer_or_error = decompressed_data.get_bytes_for_writing(4 * KiB);
+        if (buffer_or_error.is_error())
+            return {};
+        auto read_size = decompressor->read(buffer_or_error.value());
+        decompressed_data.resize(size + read_size);
+        if (read_size == 0)
+            break;
     }
-    dbgln("Websocket: Found unknown opcode {}", (u8)op_code);
+    if (decompressor->handle_any_error() && !decompressor->ended_on_block_boundary())
+        return {};
+
+    if (!m_server_no_context_takeover) {
+        ByteBuffer history;
+        auto new_history_size = min(decompressed_data.size(), deflate_window_size);
+        auto kept_history_size = min(m_decompression_history.size(), deflate_window_size - new_history_size);
+        history.append(m_decompression_history.bytes().slice(m_decompression_history.size() - kept_history_size));
+        history.append(decompressed_data.bytes().slice(decompressed_data.size() - new_history_size));
+        m_decompression_history = move(history);
+    }
+
+    return decompressed_data;
 }
 
-void WebSocket::send_frame(WebSocket::OpCode op_code, ReadonlyBytes payload, bool is_final)
+void WebSocket::send_frame(WebSocket::OpCode op_code, ReadonlyBytes payload, bool is_final, bool is_compressed)
 {
     VERIFY(m_impl);
     VERIFY(m_state == WebSocket::InternalState::Open);
-    u8 frame_head[1] = { (u8)((is_final ? 0x80 : 0x00) | ((u8)(op_code)&0xf)) };
-    m_impl->send(ReadonlyBytes(frame_head, 1));
+
+    // The frame is put together as a whole first, so that it goes out with a single write.
+    u8 frame_head[14];
+    size_t frame_head_size = 0;
+    frame_head[frame_head_size++] = (u8)((is_final ? 0x80 : 0x00) | (is_compressed ? 0x40 : 0x00) | ((u8)(op_code)&0xf));
     // Section 5.1 : a client MUST mask all frames that it sends to the server
     bool has_mask = true;
     // FIXME: If the payload has a size > size_t max on a 32-bit platform, we could
     //     technically stream it via non-final packets. However, the size was already
     //     truncated earlier in the call stack when stuffing into a ReadonlyBytes
-    if (payload.size() > NumericLimits<u16>::max()) {
+    u64 payload_size = payload.size();
+    if (payload_size > NumericLimits<u16>::max()) {
         // Send (the 'mask' flag + 127) + the 8-byte payload length
-        if constexpr (sizeof(size_t) >= 8) {
-            u8 payload_length[9] = {
-                (u8)((has_mask ? 0x80 : 0x00) | 127),
-                (u8)((payload.size() >> 56) & 0xff),
-                (u8)((payload.size() >> 48) & 0xff),
-                (u8)((payload.size() >> 40) & 0xff),
-                (u8)((payload.size() >> 32) & 0xff),
-                (u8)((payload.size() >> 24) & 0xff),
-                (u8)((payload.size() >> 16) & 0xff),
-                (u8)((payload.size() >> 8) & 0xff),
-                (u8)((payload.size() >> 0) & 0xff),
-            };
-            m_impl->send(ReadonlyBytes(payload_length, 9));
-        } else {
-            u8 payload_length[9] = {
-                (u8)((has_mask ? 0x80 : 0x00) | 127),
-                0,
-                0,
-                0,
-                0,
-                (u8)((payload.size() >> 24) & 0xff),
-                (u8)((payload.size() >> 16) & 0xff),
-                (u8)((payload.size() >> 8) & 0xff),
-                (u8)((payload.size() >> 0) & 0xff),
-            };
-            m_impl->send(ReadonlyBytes(payload_length, 9));
-        }
-    } else if (payload.size() >= 126) {
+        frame_head[frame_head_size++] = (u8)((has_mask ? 0x80 : 0x00) | 127);
+        for (int shift = 56; shift >= 0; shift -= 8)
+            frame_head[frame_head_size++] = (u8)((payload_size >> shift) & 0xff);
+    } else if (payload_size >= 126) {
         // Send (the 'mask' flag + 126) + the 2-byte payload length
-        u8 payload_length[3] = {
-            (u8)((has_mask ? 0x80 : 0x00) | 126),
-            (u8)((payload.size() >> 8) & 0xff),
-            (u8)((payload.size() >> 0) & 0xff),
-        };
-        m_impl->send(ReadonlyBytes(payload_length, 3));
+        frame_head[frame_head_size++] = (u8)((has_mask ? 0x80 : 0x00) | 126);
+        frame_head[frame_head_size++] = (u8)((payload_size >> 8) & 0xff);
+        frame_head[frame_head_size++] = (u8)((payload_size >> 0) & 0xff);
     } else {
         // Send the mask flag + the payload in a single byte
-        u8 payload_length[1] = {
-            (u8)((has_mask ? 0x80 : 0x00) | (u8)(payload.size() & 0x7f)),
-        };
-        m_impl->send(ReadonlyBytes(payload_length, 1));
+        frame_head[frame_head_size++] = (u8)((has_mask ? 0x80 : 0x00) | (u8)(payload_size & 0x7f));
     }
+    u8 masking_key[4];
     if (has_mask) {
         // Section 10.3 :
         // > Clients MUST choose a new masking key for each frame, using an algorithm
         // > that cannot be predicted by end applications that provide data
-        u8 masking_key[4];
         fill_with_random(masking_key, 4);
-        m_impl->send(ReadonlyBytes(masking_key, 4));
-        // don't try to send empty payload
-        if (payload.size() == 0)
-            return;
-        // Mask the payload
-        auto buffer_result = ByteBuffer::create_uninitialized(payload.size());
-        if (!buffer_result.is_error()) {
-            auto& masked_payload = buffer_result.value();
-            for (size_t i = 0; i < payload.size(); ++i) {
-                masked_payload[i] = payload[i] ^ (masking_key[i % 4]);
-            }
-            m_impl->send(masked_payload);
-        }
-    } else if (payload.size() > 0) {
-        m_impl->send(payload);
+        __builtin_memcpy(frame_head + frame_head_size, masking_key, sizeof(masking_key));
+        frame_head_size += sizeof(masking_key);
+    }
+
+    auto frame_or_error = ByteBuffer::create_uninitialized(frame_head_size + payload.size());
+    if (frame_or_error.is_error())
+        return;
+    auto frame = frame_or_error.release_value();
+    frame.overwrite(0, frame_head, frame_head_size);
+    if (!payload.is_empty()) {
+        auto frame_payload = frame.bytes().slice(frame_head_size);
+        payload.copy_to(frame_payload);
+        if (has_mask)
+            apply_mask(frame_payload, masking_key);
     }
+    m_impl->send(frame);
 }
 
 void WebSocket::fatal_error(WebSocket::Error error)
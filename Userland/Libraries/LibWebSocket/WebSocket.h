@@ -72,7 +72,12 @@ private:
     void read_server_handshake();
 
     void read_frame();
-    void send_frame(OpCode, ReadonlyBytes, bool is_final);
+    bool read_exactly(Bytes);
+    void send_frame(OpCode, ReadonlyBytes, bool is_final, bool is_compressed = false);
+
+    bool read_server_extensions(StringView);
+    Optional<ByteBuffer> compress_message(ReadonlyBytes);
+    Optional<ByteBuffer> decompress_message(ByteBuffer&);
 
     void notify_open();
     void notify_close(u16 code, String reason, bool was_clean);
@@ -104,6 +109,16 @@ private:
     u16 m_last_close_code { 1005 };
     String m_last_close_message;
 
+    // The data frames of the message that is being received, see section 5.4
+    ByteBuffer m_message_data;
+    Optional<OpCode> m_message_op_code;
+    bool m_message_is_compressed { false };
+
+    // permessage-deflate, as defined in RFC 7692
+    bool m_permessage_deflate { false };
+    bool m_server_no_context_takeover { false };
+    ByteBuffer m_decompression_history;
+
     ConnectionInfo m_connection;
     RefPtr<WebSocketImpl> m_impl;
 };
@@ -14,7 +14,7 @@ NonnullRefPtr<ImageDecoderClientAdapter> ImageDecoderClientAdapter::create()
     return adopt_ref(*new ImageDecoderClientAdapter());
 }
 
-Optional<Web::ImageDecoding::DecodedImage> ImageDecoderClientAdapter::decode_image(ReadonlyBytes bytes)
+Optional<Web::ImageDecoding::DecodedImage> ImageDecoderClientAdapter::decode_image(ReadonlyBytes bytes, Optional<Gfx::IntSize> ideal_size)
 {
     if (!m_client) {
         m_client = ImageDecoderClient::Client::try_create().release_value_but_fixme_should_propagate_errors();
@@ -23,7 +23,7 @@ Optional<Web::ImageDecoding::DecodedImage> ImageDecoderClientAdapter::decode_ima
         };
     }
 
-    auto result_or_empty = m_client->decode_image(bytes);
+    auto result_or_empty = m_client->decode_image(bytes, ideal_size);
     if (!result_or_empty.has_value())
         return {};
     auto result = result_or_empty.release_value();
@@ -21,7 +21,7 @@ public:
 
     virtual ~ImageDecoderClientAdapter() override = default;
 
-    virtual Optional<Web::ImageDecoding::DecodedImage> decode_image(ReadonlyBytes) override;
+    virtual Optional<Web::ImageDecoding::DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size) override;
 
 private:
     explicit ImageDecoderClientAdapter() = default;
@@ -7,6 +7,7 @@
 #include "OutOfProcessWebView.h"
 #include "WebContentClient.h"
 #include <AK/String.h>
+#include <LibCore/EventLoop.h>
 #include <LibFileSystemAccessClient/Client.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/Desktop.h>
@@ -23,6 +24,45 @@ REGISTER_WIDGET(WebView, OutOfProcessWebView)
 
 namespace WebView {
 
+static bool s_prewarm_web_content_process { false };
+
+// NOTE: This is leaked on purpose, since the client must not be destroyed after the event loop.
+static RefPtr<WebContentClient>& spare_client()
+{
+    static auto* client = new RefPtr<WebContentClient>;
+    return *client;
+}
+
+static void prewarm_spare_client()
+{
+    if (!s_prewarm_web_content_process || spare_client())
+        return;
+
+    auto client_or_error = WebContentClient::try_create();
+    if (client_or_error.is_error()) {
+        dbgln("Failed to prewarm a WebContent process: {}", client_or_error.error());
+        return;
+    }
+
+    auto client = client_or_error.release_value();
+    client->on_web_content_process_crash = [client = client.ptr()] {
+        Core::deferred_invoke([client] {
+            if (spare_client() == client)
+                spare_client() = nullptr;
+        });
+    };
+    spare_client() = move(client);
+}
+
+void OutOfProcessWebView::set_prewarm_web_content_process(bool prewarm)
+{
+    s_prewarm_web_content_process = prewarm;
+    if (prewarm)
+        prewarm_spare_client();
+    else
+        spare_client() = nullptr;
+}
+
 OutOfProcessWebView::OutOfProcessWebView()
 {
     set_should_hide_unnecessary_scrollbars(true);
@@ -61,13 +101,21 @@ void OutOfProcessWebView::create_client()
 {
     m_client_state = {};
 
-    m_client_state.client = WebContentClient::try_create(*this).release_value_but_fixme_should_propagate_errors();
+    m_client_state.client = move(spare_client());
+    if (!m_client_state.client)
+        m_client_state.client = WebContentClient::try_create().release_value_but_fixme_should_propagate_errors();
+
+    m_client_state.client->set_view({}, *this);
     m_client_state.client->on_web_content_process_crash = [this] {
         deferred_invoke([this] {
             handle_web_content_process_crash();
         });
     };
 
+    // Start up the process for the next view now, while nobody is waiting for it.
+    if (s_prewarm_web_content_process)
+        Core::deferred_invoke([] { prewarm_spare_client(); });
+
     client().async_update_system_theme(Gfx::current_system_theme_buffer());
     client().async_update_system_fonts(Gfx::FontDatabase::default_font_query(), Gfx::FontDatabase::fixed_width_font_query(), Gfx::FontDatabase::window_title_font_query());
     client().async_update_screen_rects(GUI::Desktop::the().rects(), GUI::Desktop::the().main_screen_index());
@@ -79,6 +127,12 @@ void OutOfProcessWebView::load(const AK::URL& url)
     client().async_load_url(url);
 }
 
+void OutOfProcessWebView::load_from_history(const AK::URL& url)
+{
+    m_url = url;
+    client().async_load_url_from_history(url);
+}
+
 void OutOfProcessWebView::load_html(StringView html, const AK::URL& url)
 {
     m_url = url;
@@ -22,8 +22,12 @@ class OutOfProcessWebView final : public GUI::AbstractScrollableWidget {
 public:
     virtual ~OutOfProcessWebView() override;
 
+    // Keep a WebContent process started up ahead of time, so that a new view doesn't have to wait for one.
+    static void set_prewarm_web_content_process(bool);
+
     AK::URL url() const { return m_url; }
     void load(const AK::URL&);
+    void load_from_history(const AK::URL&);
 
     void load_html(StringView, const AK::URL&);
     void load_empty_document();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/HashMap.h>
 #include <LibIPC/ConnectionToServer.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
@@ -24,8 +25,14 @@ class WebContentClient final
 public:
     Function<void()> on_web_content_process_crash;
 
+    // NOTE: A client can be created before the view it's going to belong to, so that the WebContent process
+    //       has started up by the time someone needs it.
+    void set_view(Badge<OutOfProcessWebView>, OutOfProcessWebView& view) { m_view = &view; }
+
 private:
-    WebContentClient(NonnullOwnPtr<Core::Stream::LocalSocket>, OutOfProcessWebView&);
+    explicit WebContentClient(NonnullOwnPtr<Core::Stream::LocalSocket>);
+
+    OutOfProcessWebView& view();
 
     virtual void die() override;
 
@@ -63,7 +70,7 @@ private:
     virtual void did_update_resource_count(i32 count_waiting) override;
     virtual void did_request_file(String const& path, i32) override;
 
-    OutOfProcessWebView& m_view;
+    OutOfProcessWebView* m_view { nullptr };
 };
 
 }
@@ -183,6 +183,16 @@ ErrorOr<void, ParseError> Parser::parse_with_listener(Listener& listener)
     return result;
 }
 
+ErrorOr<void, ParseError> Parser::parse_stream_with_listener(Core::Stream::Stream& stream, Listener& listener, Options options)
+{
+    auto source_or_error = stream.read_all();
+    if (source_or_error.is_error())
+        return ParseError { 0, String::formatted("Failed to read the source: {}", source_or_error.error()) };
+
+    Parser parser { source_or_error.value(), move(options) };
+    return parser.parse_with_listener(listener);
+}
+
 // 2.3.3. S, https://www.w3.org/TR/2006/REC-xml11-20060816/#NT-S
 ErrorOr<void, ParseError> Parser::skip_whitespace(Required required)
 {
@@ -610,7 +620,13 @@ ErrorOr<void, ParseError> Parser::parse_element()
     // element ::= EmptyElemTag
     //           | STag content ETag
     if (auto result = parse_empty_element_tag(); !result.is_error()) {
-        append_node(result.release_value());
+        auto node = result.release_value();
+        if (m_listener) {
+            enter_node(*node);
+            leave_node();
+        } else {
+            append_node(move(node));
+        }
         rollback.disarm();
         return {};
     }
@@ -618,7 +634,13 @@ ErrorOr<void, ParseError> Parser::parse_element()
     auto start_tag = TRY(parse_start_tag());
     auto& node = *start_tag;
     auto& tag = node.content.get<Node::Element>();
-    append_node(move(start_tag));
+
+    // A listener is told about the element instead, so only the elements that are still open are kept around.
+    OwnPtr<Node> open_element;
+    if (m_listener)
+        open_element = move(start_tag);
+    else
+        append_node(move(start_tag));
     enter_node(node);
     ScopeGuard quit {
         [&] {
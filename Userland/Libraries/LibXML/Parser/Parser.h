@@ -14,6 +14,7 @@
 #include <AK/SourceLocation.h>
 #include <AK/String.h>
 #include <AK/TemporaryChange.h>
+#include <LibCore/Stream.h>
 #include <LibXML/DOM/Document.h>
 #include <LibXML/DOM/DocumentTypeDeclaration.h>
 #include <LibXML/DOM/Node.h>
@@ -61,8 +62,13 @@ public:
     }
 
     ErrorOr<Document, ParseError> parse();
+    // Note: A listener only gets events, no Document is built in the meantime.
     ErrorOr<void, ParseError> parse_with_listener(Listener&);
 
+    // Reads the stream in blocks until it ends, then parses it with the listener.
+    // The parser needs the whole source at once, since it has to be able to backtrack over any of it.
+    static ErrorOr<void, ParseError> parse_stream_with_listener(Core::Stream::Stream&, Listener&, Options);
+
     Vector<ParseError> const& parse_error_causes() const { return m_parse_errors; }
 
 private:
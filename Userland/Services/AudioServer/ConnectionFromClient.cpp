@@ -82,6 +82,11 @@ void ConnectionFromClient::set_sample_rate(u32 sample_rate)
     m_mixer.audiodevice_set_sample_rate(sample_rate);
 }
 
+Messages::AudioServer::GetUnderrunCountResponse ConnectionFromClient::get_underrun_count()
+{
+    return m_mixer.underrun_count();
+}
+
 Messages::AudioServer::GetSelfVolumeResponse ConnectionFromClient::get_self_volume()
 {
     return m_queue->volume().target();
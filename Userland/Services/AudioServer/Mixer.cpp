@@ -8,8 +8,10 @@
 #include "Mixer.h"
 #include <AK/Array.h>
 #include <AK/Format.h>
-#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AudioServer/ConnectionFromClient.h>
 #include <AudioServer/Mixer.h>
 #include <LibCore/ConfigFile.h>
@@ -20,6 +22,58 @@
 
 namespace AudioServer {
 
+using AK::SIMD::f32x4;
+
+// The mixing loops treat buffers of stereo samples as plain arrays of floats, four of them at a time.
+static_assert(sizeof(Audio::Sample) == 2 * sizeof(float));
+
+static ALWAYS_INLINE f32x4 load_unaligned(float const* data)
+{
+    f32x4 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static ALWAYS_INLINE void store_unaligned(float* data, f32x4 value)
+{
+    __builtin_memcpy(data, &value, sizeof(value));
+}
+
+// Adds the samples, multiplied by the factor, to the mix.
+static void mix_samples(Span<Audio::Sample> mix, Span<Audio::Sample const> samples, float factor)
+{
+    VERIFY(samples.size() <= mix.size());
+    auto* mix_data = reinterpret_cast<float*>(mix.data());
+    auto const* sample_data = reinterpret_cast<float const*>(samples.data());
+    auto const value_count = samples.size() * 2;
+    auto const factor4 = AK::SIMD::expand4(factor);
+
+    size_t i = 0;
+    for (; i + 4 <= value_count; i += 4)
+        store_unaligned(mix_data + i, load_unaligned(mix_data + i) + load_unaligned(sample_data + i) * factor4);
+    for (; i < value_count; ++i)
+        mix_data[i] += sample_data[i] * factor;
+}
+
+// Converts the mix, multiplied by the factor, to clipped 16-bit samples.
+static void convert_samples(Span<Audio::Sample const> mix, Span<LittleEndian<i16>> output, float factor)
+{
+    VERIFY(output.size() == mix.size() * 2);
+    auto const* mix_data = reinterpret_cast<float const*>(mix.data());
+    auto const value_count = output.size();
+    auto const factor4 = AK::SIMD::expand4(factor);
+    constexpr auto max_value = static_cast<float>(NumericLimits<i16>::max());
+
+    size_t i = 0;
+    for (; i + 4 <= value_count; i += 4) {
+        auto values = AK::SIMD::to_i32x4(AK::SIMD::clamp(load_unaligned(mix_data + i) * factor4, -1.0f, 1.0f) * max_value);
+        for (size_t j = 0; j < 4; ++j)
+            output[i + j] = static_cast<i16>(values[j]);
+    }
+    for (; i < value_count; ++i)
+        output[i] = static_cast<i16>(clamp(mix_data[i] * factor, -1.0f, 1.0f) * max_value);
+}
+
 Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     // FIXME: Allow AudioServer to use other audio channels as well
     : m_device(Core::File::construct("/dev/audio/0", this))
@@ -38,6 +92,8 @@ Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
 
     m_muted = m_config->read_bool_entry("Master", "Mute", false);
     m_main_volume = static_cast<double>(m_config->read_num_entry("Master", "Volume", 100)) / 100.0;
+    auto hardware_buffer_size = m_config->read_num_entry("Mixer", "BufferSize", DEFAULT_HARDWARE_BUFFER_SIZE);
+    m_hardware_buffer_size = clamp(static_cast<size_t>(max(hardware_buffer_size, 0)), MIN_HARDWARE_BUFFER_SIZE, MAX_HARDWARE_BUFFER_SIZE);
 
     m_sound_thread->start();
 }
@@ -48,6 +104,7 @@ NonnullRefPtr<ClientAudioStream> Mixer::create_queue(ConnectionFromClient& clien
     m_pending_mutex.lock();
 
     m_pending_mixing.append(*queue);
+    m_has_pending_mixing.store(true, AK::memory_order_release);
 
     m_pending_mutex.unlock();
     // Signal the mixer thread to start back up, in case nobody was connected before.
@@ -61,69 +118,55 @@ void Mixer::mix()
     decltype(m_pending_mixing) active_mix_queues;
 
     for (;;) {
-        m_pending_mutex.lock();
-        // While we have nothing to mix, wait on the condition.
-        m_mixing_necessary.wait_while([this, &active_mix_queues]() { return m_pending_mixing.is_empty() && active_mix_queues.is_empty(); });
-        if (!m_pending_mixing.is_empty()) {
-            active_mix_queues.extend(move(m_pending_mixing));
-            m_pending_mixing.clear();
+        // The lock is only needed to pick up new streams, or to sleep while there is nothing to mix.
+        if (active_mix_queues.is_empty() || m_has_pending_mixing.load(AK::memory_order_acquire)) {
+            m_pending_mutex.lock();
+            // While we have nothing to mix, wait on the condition.
+            m_mixing_necessary.wait_while([this, &active_mix_queues]() { return m_pending_mixing.is_empty() && active_mix_queues.is_empty(); });
+            if (!m_pending_mixing.is_empty()) {
+                active_mix_queues.extend(move(m_pending_mixing));
+                m_pending_mixing.clear();
+            }
+            m_has_pending_mixing.store(false, AK::memory_order_relaxed);
+            m_pending_mutex.unlock();
         }
-        m_pending_mutex.unlock();
 
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->client(); });
 
-        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> mixed_buffer;
+        auto mixed_buffer = m_mixed_buffer.span().trim(m_hardware_buffer_size);
+        mixed_buffer.fill({});
 
         m_main_volume.advance_time();
 
-        int active_queues = 0;
         // Mix the buffers together into the output
         for (auto& queue : active_mix_queues) {
             if (!queue->client()) {
                 queue->clear();
                 continue;
             }
-            ++active_queues;
             queue->volume().advance_time();
 
-            for (auto& mixed_sample : mixed_buffer) {
-                Audio::Sample sample;
-                if (!queue->get_next_sample(sample))
-                    break;
-                if (queue->is_muted())
-                    continue;
-                sample.log_multiply(SAMPLE_HEADROOM);
-                sample.log_multiply(static_cast<float>(queue->volume()));
-                mixed_sample += sample;
-            }
+            auto underruns_before = queue->underrun_count();
+            auto samples_read = queue->read_samples(m_stream_buffer.span().trim(mixed_buffer.size()));
+            if (auto underruns = queue->underrun_count() - underruns_before; underruns > 0)
+                m_underrun_count.fetch_add(underruns, AK::memory_order_relaxed);
+
+            if (queue->is_muted() || samples_read == 0)
+                continue;
+            // The volume only changes from one buffer to the next, so this is the same as log_multiply() on every sample.
+            auto factor = Audio::Sample::linear_to_log(SAMPLE_HEADROOM) * Audio::Sample::linear_to_log(static_cast<float>(queue->volume()));
+            mix_samples(mixed_buffer, m_stream_buffer.span().trim(samples_read), factor);
         }
 
+        auto const output_size = mixed_buffer.size() * 2 * sizeof(i16);
         if (m_muted) {
-            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(m_zero_filled_buffer.size()));
+            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(output_size));
         } else {
-            Array<u8, HARDWARE_BUFFER_SIZE_BYTES> buffer;
-            OutputMemoryStream stream { buffer };
-
-            for (auto& mixed_sample : mixed_buffer) {
-
-                // Even though it's not realistic, the user expects no sound at 0%.
-                if (m_main_volume < 0.01)
-                    mixed_sample = Audio::Sample { 0 };
-                else
-                    mixed_sample.log_multiply(static_cast<float>(m_main_volume));
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = static_cast<i16>(mixed_sample.left * NumericLimits<i16>::max());
-                stream << out_sample;
-
-                out_sample = static_cast<i16>(mixed_sample.right * NumericLimits<i16>::max());
-                stream << out_sample;
-            }
-
-            VERIFY(stream.is_end());
-            VERIFY(!stream.has_any_error());
-            m_device->write(stream.data(), static_cast<int>(stream.size()));
+            // Even though it's not realistic, the user expects no sound at 0%.
+            auto main_factor = m_main_volume < 0.01 ? 0.0f : Audio::Sample::linear_to_log(static_cast<float>(m_main_volume));
+            auto output_buffer = m_output_buffer.span().trim(mixed_buffer.size() * 2);
+            convert_samples(mixed_buffer, output_buffer, main_factor);
+            m_device->write(reinterpret_cast<u8 const*>(output_buffer.data()), static_cast<int>(output_size));
         }
     }
 }
@@ -12,6 +12,7 @@
 #include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
+#include <AK/Endian.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Queue.h>
 #include <AK/RefCounted.h>
@@ -30,9 +31,13 @@ namespace AudioServer {
 // This is to prevent clipping when two streams with low headroom (e.g. normalized & compressed) are playing.
 constexpr double SAMPLE_HEADROOM = 0.95;
 // The size of the buffer in samples that the hardware receives through write() calls to the audio device.
-constexpr size_t HARDWARE_BUFFER_SIZE = 512;
-// The hardware buffer size in bytes; there's two channels of 16-bit samples.
-constexpr size_t HARDWARE_BUFFER_SIZE_BYTES = HARDWARE_BUFFER_SIZE * 2 * sizeof(i16);
+// Smaller buffers mean lower latency, but the clients have less time to refill their queues before we run dry.
+// It can be changed with the BufferSize entry in the Mixer group of the configuration.
+constexpr size_t DEFAULT_HARDWARE_BUFFER_SIZE = 512;
+constexpr size_t MIN_HARDWARE_BUFFER_SIZE = 32;
+constexpr size_t MAX_HARDWARE_BUFFER_SIZE = 4096;
+// The largest hardware buffer size in bytes; there's two channels of 16-bit samples.
+constexpr size_t MAX_HARDWARE_BUFFER_SIZE_BYTES = MAX_HARDWARE_BUFFER_SIZE * 2 * sizeof(i16);
 
 class ConnectionFromClient;
 
@@ -41,30 +46,40 @@ public:
     explicit ClientAudioStream(ConnectionFromClient&);
     ~ClientAudioStream() = default;
 
-    bool get_next_sample(Audio::Sample& sample)
+    // Copies the next samples of the stream into the start of the given span, and returns how many there were.
+    size_t read_samples(Span<Audio::Sample> samples)
     {
         if (m_paused)
-            return false;
-
-        if (m_in_chunk_location >= m_current_audio_chunk.size()) {
-            // FIXME: We should send a did_misbehave to the client if the queue is empty,
-            //        but the lifetimes involved mean that we segfault if we try to do that.
-            auto result = m_buffer->try_dequeue();
-            if (result.is_error()) {
-                if (result.error() == Audio::AudioQueue::QueueStatus::Empty)
-                    dbgln("Audio client can't keep up!");
-
-                return false;
+            return 0;
+
+        size_t samples_read = 0;
+        while (samples_read < samples.size()) {
+            if (m_in_chunk_location >= m_current_audio_chunk.size()) {
+                // FIXME: We should send a did_misbehave to the client if the queue is empty,
+                //        but the lifetimes involved mean that we segfault if we try to do that.
+                auto result = m_buffer->try_dequeue();
+                if (result.is_error()) {
+                    if (result.error() == Audio::AudioQueue::QueueStatus::Empty)
+                        note_underrun();
+                    return samples_read;
+                }
+                m_current_audio_chunk = result.release_value();
+                m_in_chunk_location = 0;
             }
-            m_current_audio_chunk = result.release_value();
-            m_in_chunk_location = 0;
-        }
 
-        sample = m_current_audio_chunk[m_in_chunk_location++];
+            auto chunk_samples = m_current_audio_chunk.span().slice(m_in_chunk_location);
+            auto copied_samples = chunk_samples.copy_trimmed_to(samples.slice(samples_read));
+            m_in_chunk_location += copied_samples;
+            samples_read += copied_samples;
+        }
 
-        return true;
+        m_is_starved = false;
+        return samples_read;
     }
 
+    // The number of times this stream ran dry while it was playing. Only counts the first time in a row.
+    u64 underrun_count() const { return m_underrun_count; }
+
     ConnectionFromClient* client() { return m_client.ptr(); }
 
     void set_buffer(OwnPtr<Audio::AudioQueue> buffer) { m_buffer = move(buffer); }
@@ -88,7 +103,19 @@ public:
 private:
     OwnPtr<Audio::AudioQueue> m_buffer;
     Array<Audio::Sample, Audio::AUDIO_BUFFER_SIZE> m_current_audio_chunk;
-    size_t m_in_chunk_location;
+    size_t m_in_chunk_location { Audio::AUDIO_BUFFER_SIZE };
+
+    void note_underrun()
+    {
+        if (m_is_starved)
+            return;
+        m_is_starved = true;
+        ++m_underrun_count;
+        dbgln("Audio client can't keep up!");
+    }
+
+    bool m_is_starved { false };
+    u64 m_underrun_count { 0 };
 
     bool m_paused { true };
     bool m_muted { false };
@@ -114,12 +141,17 @@ public:
     int audiodevice_set_sample_rate(u32 sample_rate);
     u32 audiodevice_get_sample_rate() const;
 
+    // The number of times any stream ran dry while it was playing.
+    u64 underrun_count() const { return m_underrun_count.load(AK::memory_order_relaxed); }
+
 private:
     Mixer(NonnullRefPtr<Core::ConfigFile> config);
 
     void request_setting_sync();
 
     Vector<NonnullRefPtr<ClientAudioStream>> m_pending_mixing;
+    // Lets the mixer thread check for new streams without taking the lock.
+    Atomic<bool> m_has_pending_mixing { false };
     Threading::Mutex m_pending_mutex;
     Threading::ConditionVariable m_mixing_necessary { m_pending_mutex };
 
@@ -133,7 +165,13 @@ private:
     NonnullRefPtr<Core::ConfigFile> m_config;
     RefPtr<Core::Timer> m_config_write_timer;
 
-    Array<u8, HARDWARE_BUFFER_SIZE_BYTES> m_zero_filled_buffer;
+    size_t m_hardware_buffer_size { DEFAULT_HARDWARE_BUFFER_SIZE };
+    Atomic<u64> m_underrun_count { 0 };
+
+    Array<Audio::Sample, MAX_HARDWARE_BUFFER_SIZE> m_mixed_buffer;
+    Array<Audio::Sample, MAX_HARDWARE_BUFFER_SIZE> m_stream_buffer;
+    Array<LittleEndian<i16>, MAX_HARDWARE_BUFFER_SIZE * 2> m_output_buffer;
+    Array<u8, MAX_HARDWARE_BUFFER_SIZE_BYTES> m_zero_filled_buffer {};
 
     void mix();
 };
@@ -10,10 +10,10 @@
 #include <AK/String.h>
 #include <AK/StringView.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/Stream.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/TreeWalker.h>
 #include <sched.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -78,35 +78,67 @@ static void report_error(StringView message)
     outln("ERROR {}", message);
 }
 
+// Walks the source, and calls the callbacks with the path each entry would have inside of the destination directory.
+// Directories are left (on_leave_directory) after everything inside of them has been visited.
+static ErrorOr<void> walk_source(String const& source, String const& destination,
+    Function<ErrorOr<void>(String const& path, Core::DirectoryEntry const&, String const& destination)> on_entry,
+    Function<ErrorOr<void>(String const& path)> on_leave_directory = nullptr)
+{
+    // The destination directories of the directories we're currently in, the innermost one last.
+    Vector<String> destinations;
+    destinations.append(destination);
+
+    Threading::TreeWalker walker;
+    walker.set_fetch_metadata(Core::DirectoryEntry::FetchMetadata::Yes);
+    walker.on_entry = [&](String const& path, Core::DirectoryEntry const& entry, size_t) -> ErrorOr<void> {
+        // Deleting things doesn't need a destination.
+        String entry_destination;
+        if (!destination.is_null())
+            entry_destination = LexicalPath::join(destinations.last(), entry.name).string();
+        if (entry.type == Core::DirectoryEntry::Type::Directory)
+            destinations.append(entry_destination);
+        return on_entry(path, entry, entry_destination);
+    };
+    walker.on_leave_directory = [&](String const& path, Core::DirectoryEntry const&, size_t) -> ErrorOr<void> {
+        destinations.take_last();
+        if (on_leave_directory)
+            return on_leave_directory(path);
+        return {};
+    };
+    return walker.walk(source);
+}
+
+static ErrorOr<off_t> size_of(String const& path, Core::DirectoryEntry const& entry)
+{
+    // The walker only leaves out the metadata if it couldn't stat the entry, so this reports why.
+    if (!entry.metadata.has_value())
+        return TRY(Core::System::lstat(path)).st_size;
+    return entry.metadata->st_size;
+}
+
 static ErrorOr<int> collect_copy_work_items(String const& source, String const& destination, Vector<WorkItem>& items)
 {
-    if (auto const st = TRY(Core::System::lstat(source)); !S_ISDIR(st.st_mode)) {
-        // It's a file.
+    TRY(walk_source(source, destination, [&](String const& path, Core::DirectoryEntry const& entry, String const& entry_destination) -> ErrorOr<void> {
+        if (entry.type != Core::DirectoryEntry::Type::Directory) {
+            // It's a file.
+            items.append(WorkItem {
+                .type = WorkItem::Type::CopyFile,
+                .source = path,
+                .destination = entry_destination,
+                .size = TRY(size_of(path, entry)),
+            });
+            return {};
+        }
+
+        // It's a directory.
         items.append(WorkItem {
-            .type = WorkItem::Type::CopyFile,
-            .source = source,
-            .destination = LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-            .size = st.st_size,
+            .type = WorkItem::Type::CreateDirectory,
+            .source = {},
+            .destination = entry_destination,
+            .size = 0,
         });
-        return 0;
-    }
-
-    // It's a directory.
-    items.append(WorkItem {
-        .type = WorkItem::Type::CreateDirectory,
-        .source = {},
-        .destination = LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-        .size = 0,
-    });
-
-    Core::DirIterator dt(source, Core::DirIterator::SkipParentAndBaseDir);
-    while (dt.has_next()) {
-        auto name = dt.next_path();
-        TRY(collect_copy_work_items(
-            LexicalPath::join(source, name).string(),
-            LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-            items));
-    }
+        return {};
+    }));
 
     return 0;
 }
@@ -124,40 +156,37 @@ ErrorOr<int> perform_copy(Vector<StringView> const& sources, String const& desti
 
 static ErrorOr<int> collect_move_work_items(String const& source, String const& destination, Vector<WorkItem>& items)
 {
-    if (auto const st = TRY(Core::System::lstat(source)); !S_ISDIR(st.st_mode)) {
-        // It's a file.
+    auto on_entry = [&](String const& path, Core::DirectoryEntry const& entry, String const& entry_destination) -> ErrorOr<void> {
+        if (entry.type != Core::DirectoryEntry::Type::Directory) {
+            // It's a file.
+            items.append(WorkItem {
+                .type = WorkItem::Type::MoveFile,
+                .source = path,
+                .destination = entry_destination,
+                .size = TRY(size_of(path, entry)),
+            });
+            return {};
+        }
+
+        // It's a directory.
         items.append(WorkItem {
-            .type = WorkItem::Type::MoveFile,
-            .source = source,
-            .destination = LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-            .size = st.st_size,
+            .type = WorkItem::Type::CreateDirectory,
+            .source = {},
+            .destination = entry_destination,
+            .size = 0,
         });
-        return 0;
-    }
-
-    // It's a directory.
-    items.append(WorkItem {
-        .type = WorkItem::Type::CreateDirectory,
-        .source = {},
-        .destination = LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-        .size = 0,
-    });
-
-    Core::DirIterator dt(source, Core::DirIterator::SkipParentAndBaseDir);
-    while (dt.has_next()) {
-        auto name = dt.next_path();
-        TRY(collect_move_work_items(
-            LexicalPath::join(source, name).string(),
-            LexicalPath::join(destination, LexicalPath::basename(source)).string(),
-            items));
-    }
-
-    items.append(WorkItem {
-        .type = WorkItem::Type::DeleteDirectory,
-        .source = source,
-        .destination = {},
-        .size = 0,
-    });
+        return {};
+    };
+    auto on_leave_directory = [&](String const& path) -> ErrorOr<void> {
+        items.append(WorkItem {
+            .type = WorkItem::Type::DeleteDirectory,
+            .source = path,
+            .destination = {},
+            .size = 0,
+        });
+        return {};
+    };
+    TRY(walk_source(source, destination, move(on_entry), move(on_leave_directory)));
 
     return 0;
 }
@@ -175,30 +204,29 @@ ErrorOr<int> perform_move(Vector<StringView> const& sources, String const& desti
 
 static ErrorOr<int> collect_delete_work_items(String const& source, Vector<WorkItem>& items)
 {
-    if (auto const st = TRY(Core::System::lstat(source)); !S_ISDIR(st.st_mode)) {
+    auto on_entry = [&](String const& path, Core::DirectoryEntry const& entry, String const&) -> ErrorOr<void> {
+        if (entry.type == Core::DirectoryEntry::Type::Directory)
+            return {};
+
         // It's a file.
         items.append(WorkItem {
             .type = WorkItem::Type::DeleteFile,
-            .source = source,
+            .source = path,
             .destination = {},
-            .size = st.st_size,
+            .size = TRY(size_of(path, entry)),
         });
-        return 0;
-    }
-
-    // It's a directory.
-    Core::DirIterator dt(source, Core::DirIterator::SkipParentAndBaseDir);
-    while (dt.has_next()) {
-        auto name = dt.next_path();
-        TRY(collect_delete_work_items(LexicalPath::join(source, name).string(), items));
-    }
-
-    items.append(WorkItem {
-        .type = WorkItem::Type::DeleteDirectory,
-        .source = source,
-        .destination = {},
-        .size = 0,
-    });
+        return {};
+    };
+    auto on_leave_directory = [&](String const& path) -> ErrorOr<void> {
+        items.append(WorkItem {
+            .type = WorkItem::Type::DeleteDirectory,
+            .source = path,
+            .destination = {},
+            .size = 0,
+        });
+        return {};
+    };
+    TRY(walk_source(source, {}, move(on_entry), move(on_leave_directory)));
 
     return 0;
 }
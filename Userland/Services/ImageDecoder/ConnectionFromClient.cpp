@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <ImageDecoder/ConnectionFromClient.h>
+#include <ImageDecoder/DecodedImageCache.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageDecoder.h>
@@ -22,40 +23,63 @@ void ConnectionFromClient::die()
     Core::EventLoop::current().quit(0);
 }
 
-Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer)
+static RefPtr<DecodedImageCache::Entry> decode(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> const& ideal_size)
 {
-    if (!encoded_buffer.is_valid()) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
-        return nullptr;
-    }
-
-    auto decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() });
+    auto decoder = Gfx::ImageDecoder::try_create(encoded_data);
 
     if (!decoder) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return nullptr;
     }
 
     if (!decoder->frame_count()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return nullptr;
     }
 
-    Vector<Gfx::ShareableBitmap> bitmaps;
-    Vector<u32> durations;
+    auto image = adopt_ref(*new DecodedImageCache::Entry);
+    image->is_animated = decoder->is_animated();
+    image->loop_count = static_cast<u32>(decoder->loop_count());
     for (size_t i = 0; i < decoder->frame_count(); ++i) {
-        auto frame_or_error = decoder->frame(i);
+        // If the client is only going to show a smaller version of the image, there is no point in decoding (and sending) more.
+        auto frame_or_error = ideal_size.has_value() ? decoder->downscaled_frame(i, *ideal_size) : decoder->frame(i);
         if (frame_or_error.is_error()) {
-            bitmaps.append(Gfx::ShareableBitmap {});
-            durations.append(0);
+            image->frames.append(nullptr);
+            image->durations.append(0);
         } else {
             auto frame = frame_or_error.release_value();
-            bitmaps.append(frame.image->to_shareable_bitmap());
-            durations.append(frame.duration);
+            image->frames.append(frame.image);
+            image->durations.append(frame.duration);
         }
     }
+    return image;
+}
+
+Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        return nullptr;
+    }
+
+    ReadonlyBytes encoded_data { encoded_buffer.data<u8>(), encoded_buffer.size() };
+    auto cache_key = DecodedImageCache::key_for(encoded_data, ideal_size);
+    auto image = DecodedImageCache::the().lookup(cache_key);
+    if (image) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Found decoded image in cache");
+    } else {
+        image = decode(encoded_data, ideal_size);
+        if (!image)
+            return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        DecodedImageCache::the().store(cache_key, *image);
+    }
+
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    for (auto const& frame : image->frames)
+        bitmaps.append(frame ? frame->to_shareable_bitmap() : Gfx::ShareableBitmap {});
 
-    return { decoder->is_animated(), static_cast<u32>(decoder->loop_count()), bitmaps, durations };
+    image->set_volatile();
+    return { image->is_animated, image->loop_count, move(bitmaps), image->durations };
 }
 
 }
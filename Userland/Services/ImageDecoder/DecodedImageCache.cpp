@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <ImageDecoder/DecodedImageCache.h>
+#include <LibCrypto/Hash/SHA2.h>
+
+namespace ImageDecoder {
+
+size_t DecodedImageCache::Entry::size_in_bytes() const
+{
+    size_t size = 0;
+    for (auto const& frame : frames) {
+        if (frame)
+            size += frame->size_in_bytes();
+    }
+    return size;
+}
+
+void DecodedImageCache::Entry::set_volatile()
+{
+    for (auto& frame : frames) {
+        // NOTE: Only bitmaps in memory of their own can be made volatile, not ones backed by a (shared) anonymous buffer.
+        if (frame && !frame->anonymous_buffer().is_valid())
+            frame->set_volatile();
+    }
+}
+
+bool DecodedImageCache::Entry::set_nonvolatile()
+{
+    bool all_frames_intact = true;
+    for (auto& frame : frames) {
+        if (!frame)
+            continue;
+        bool was_purged = false;
+        if (!frame->set_nonvolatile(was_purged) || was_purged)
+            all_frames_intact = false;
+    }
+    return all_frames_intact;
+}
+
+DecodedImageCache& DecodedImageCache::the()
+{
+    static DecodedImageCache s_the;
+    return s_the;
+}
+
+DecodedImageCache::Key DecodedImageCache::key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    auto digest = Crypto::Hash::SHA256::hash(encoded_data.data(), encoded_data.size());
+    Key key;
+    static_assert(sizeof(key.digest) == sizeof(digest.data));
+    __builtin_memcpy(key.digest.data(), digest.data, sizeof(digest.data));
+    key.ideal_size = ideal_size.value_or({});
+    return key;
+}
+
+RefPtr<DecodedImageCache::Entry> DecodedImageCache::lookup(Key const& key)
+{
+    auto* cached_entry = m_entries.get(key);
+    if (!cached_entry)
+        return nullptr;
+
+    NonnullRefPtr<Entry> entry = *cached_entry;
+
+    // If the kernel purged any of the frames, the image has to be decoded again anyway.
+    if (!entry->set_nonvolatile()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "DecodedImageCache: Entry was purged, dropping it");
+        m_entries.remove(key);
+        return nullptr;
+    }
+
+    return entry;
+}
+
+void DecodedImageCache::store(Key const& key, NonnullRefPtr<Entry> entry)
+{
+    m_entries.set(key, move(entry));
+}
+
+void DecodedImageCache::set_memory_budget(size_t budget)
+{
+    m_entries.set_capacity(budget);
+}
+
+void DecodedImageCache::did_change_memory_pressure(Core::MemoryPressureLevel level)
+{
+    switch (level) {
+    case Core::MemoryPressureLevel::Normal:
+        break;
+    case Core::MemoryPressureLevel::Low:
+        m_entries.evict_until_within(m_entries.capacity() / 4);
+        break;
+    case Core::MemoryPressureLevel::Critical:
+        m_entries.evict_until_within(0);
+        break;
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/LRUCache.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+#include <LibCore/MemoryPressureNotifier.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Size.h>
+
+namespace ImageDecoder {
+
+// Images that were decoded recently, keyed by a hash of their encoded data (and the size they were asked to be decoded at),
+// so that a client decoding the same image again, e.g. because a page was reloaded, doesn't have to wait for the decoder.
+// NOTE: There is one ImageDecoder process per client, so clients don't share their caches.
+class DecodedImageCache {
+public:
+    struct Key {
+        Array<u8, 32> digest;
+        // Empty if the image was decoded at its full size.
+        Gfx::IntSize ideal_size;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key)
+        {
+            // The digest is already uniformly distributed, so any 4 bytes of it make a good hash.
+            u32 digest_prefix;
+            __builtin_memcpy(&digest_prefix, key.digest.data(), sizeof(digest_prefix));
+            return pair_int_hash(digest_prefix, pair_int_hash(key.ideal_size.width(), key.ideal_size.height()));
+        }
+    };
+
+    struct Entry : public RefCounted<Entry> {
+        bool is_animated { false };
+        u32 loop_count { 0 };
+        // Frames that failed to decode are null.
+        Vector<RefPtr<Gfx::Bitmap>> frames;
+        Vector<u32> durations;
+
+        size_t size_in_bytes() const;
+
+        // Cached frames are kept volatile while nobody uses them, which allows the kernel to purge them under memory pressure.
+        void set_volatile();
+        // Returns false if any of the frames were purged in the meantime.
+        [[nodiscard]] bool set_nonvolatile();
+    };
+
+    static DecodedImageCache& the();
+
+    static Key key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size);
+
+    // The entry is returned non-volatile; callers should make it volatile again once they are done with it.
+    RefPtr<Entry> lookup(Key const&);
+    void store(Key const&, NonnullRefPtr<Entry>);
+
+    void set_memory_budget(size_t);
+
+    // Under low memory, only the most recently used images are kept, and under critical memory, none at all.
+    void did_change_memory_pressure(Core::MemoryPressureLevel);
+
+    static constexpr size_t default_memory_budget = 64 * MiB;
+
+private:
+    DecodedImageCache() = default;
+
+    LRUCache<Key, NonnullRefPtr<Entry>, KeyTraits> m_entries { default_memory_budget, [](Key const&, NonnullRefPtr<Entry> const& entry) { return entry->size_in_bytes(); } };
+};
+
+}
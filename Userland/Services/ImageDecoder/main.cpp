@@ -5,14 +5,35 @@
  */
 
 #include <ImageDecoder/ConnectionFromClient.h>
+#include <ImageDecoder/DecodedImageCache.h>
+#include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
+#include <LibCore/MemoryPressureNotifier.h>
 #include <LibCore/System.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
 
-ErrorOr<int> serenity_main(Main::Arguments)
+ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
+    size_t cache_budget_in_mib = ImageDecoder::DecodedImageCache::default_memory_budget / MiB;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(cache_budget_in_mib, "Memory budget for decoded images kept around for reuse, in MiB", "cache-budget", 0, "size");
+    args_parser.parse(arguments);
+
+    ImageDecoder::DecodedImageCache::the().set_memory_budget(cache_budget_in_mib * MiB);
+
     Core::EventLoop event_loop;
+
+    auto memory_pressure_notifier_or_error = Core::MemoryPressureNotifier::create();
+    if (memory_pressure_notifier_or_error.is_error()) {
+        dbgln("Unable to listen for memory pressure: {}", memory_pressure_notifier_or_error.error());
+    } else {
+        memory_pressure_notifier_or_error.value()->on_change = [](auto level) {
+            ImageDecoder::DecodedImageCache::the().did_change_memory_pressure(level);
+        };
+    }
+
     TRY(Core::System::pledge("stdio recvfd sendfd unix"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
@@ -16,6 +16,7 @@
 #include <LibCore/LocalServer.h>
 #include <LibCore/Stream.h>
 #include <LibDNS/Packet.h>
+#include <poll.h>
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
@@ -25,6 +26,16 @@ namespace LookupServer {
 static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
+// NOTE: Without parsing the SOA record of a negative response, we don't know how long the nameserver wants us to
+//       remember it, so we go with a short time.
+static constexpr u32 s_negative_ttl = 60;
+// How often we ask the nameservers again before giving up on those that haven't responded, and how long we wait.
+static constexpr int s_upstream_attempts = 3;
+static constexpr i64 s_upstream_timeout_ms = 1000;
+// Answers that are asked for during the last tenth of their lifetime get refreshed right away, as long as they live
+// long enough for that to be worth it.
+static constexpr u32 s_prefetch_min_ttl = 60;
+static constexpr u32 s_prefetch_ttl_divisor = 10;
 
 LookupServer& LookupServer::the()
 {
@@ -170,15 +181,27 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
 
     // Third, try our cache.
     if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
+        bool is_about_to_expire = false;
+        auto now = time(nullptr);
         for (auto& answer : cached_answers->value) {
             // TODO: Actually remove expired answers from the cache.
             if (answer.type() == record_type && !answer.has_expired()) {
                 dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
                 add_answer(answer);
+                auto time_left = answer.received_time() + answer.ttl() - now;
+                if (answer.ttl() >= s_prefetch_min_ttl && time_left < answer.ttl() / s_prefetch_ttl_divisor)
+                    is_about_to_expire = true;
             }
         }
-        if (!answers.is_empty())
+        if (!answers.is_empty()) {
+            if (is_about_to_expire)
+                prefetch(name, record_type);
             return answers;
+        }
+    }
+    if (is_in_negative_cache(name, record_type)) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {}", name.as_string());
+        return Vector<Answer> {};
     }
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
@@ -190,64 +213,121 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<Answer> upstream_answers;
-        do {
-            auto upstream_answers_or_error = lookup(name, nameserver, did_get_response, record_type);
-            if (upstream_answers_or_error.is_error())
-                continue;
-            upstream_answers = upstream_answers_or_error.release_value();
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
-        }
-    }
+    bool every_nameserver_responded = false;
+    auto upstream_answers = TRY(lookup_upstream(name, record_type, every_nameserver_responded));
+    for (auto& answer : upstream_answers)
+        add_answer(answer);
 
     // Sixth, fail.
     if (answers.is_empty()) {
-        dbgln("Tried all nameservers but never got a response :(");
+        if (every_nameserver_responded) {
+            dbgln("All nameservers responded, but there were no results");
+            put_in_negative_cache(name, record_type);
+        } else {
+            dbgln("Tried all nameservers but never got a response :(");
+        }
         return Vector<Answer> {};
     }
 
     return answers;
 }
 
-ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase should_randomize_case)
+// Every nameserver gets asked at once, and the first one to come up with answers wins. Asking them one after the
+// other meant sitting out all the timeouts of a nameserver that is down before the next one even heard of us.
+ErrorOr<Vector<Answer>> LookupServer::lookup_upstream(Name const& name, RecordType record_type, bool& every_nameserver_responded)
+{
+    Vector<UpstreamQuery> queries;
+    for (auto& nameserver : m_nameservers) {
+        auto socket_or_error = Core::Stream::UDPSocket::connect(nameserver, 53);
+        if (socket_or_error.is_error()) {
+            dbgln("Failed to connect to nameserver '{}': {}", nameserver, socket_or_error.error());
+            continue;
+        }
+        queries.append({ nameserver, socket_or_error.release_value(), {} });
+    }
+    auto nameserver_count = queries.size();
+
+    for (int attempt = 0; attempt < s_upstream_attempts && !queries.is_empty(); ++attempt) {
+        for (size_t i = 0; i < queries.size();) {
+            if (auto result = send_query(queries[i], name, record_type); result.is_error()) {
+                dbgln("Failed to send query to nameserver '{}': {}", queries[i].nameserver, result.error());
+                queries.remove(i);
+                continue;
+            }
+            ++i;
+        }
+
+        auto deadline = Time::now_monotonic() + Time::from_milliseconds(s_upstream_timeout_ms);
+        while (!queries.is_empty()) {
+            auto timeout = (deadline - Time::now_monotonic()).to_milliseconds();
+            if (timeout <= 0)
+                break;
+
+            Vector<pollfd> poll_fds;
+            for (auto& query : queries)
+                poll_fds.append({ query.socket->fd(), POLLIN, 0 });
+            int rc = poll(poll_fds.data(), poll_fds.size(), static_cast<int>(timeout));
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                return Error::from_syscall("poll"sv, -errno);
+            }
+            if (rc == 0)
+                break;
+
+            for (size_t i = poll_fds.size(); i-- > 0;) {
+                if (poll_fds[i].revents == 0)
+                    continue;
+                auto& query = queries[i];
+                auto response_or_error = receive_response(query, name, record_type);
+                if (response_or_error.is_error()) {
+                    dbgln("Failed to get a response from '{}': {}", query.nameserver, response_or_error.error());
+                    queries.remove(i);
+                    continue;
+                }
+                auto response = response_or_error.release_value();
+                if (!response.has_value())
+                    continue;
+                if (!response->is_empty())
+                    return response.release_value();
+                dbgln("Received response from '{}' but no result(s)", query.nameserver);
+                queries.remove(i);
+            }
+        }
+
+        if (!queries.is_empty())
+            dbgln_if(LOOKUPSERVER_DEBUG, "{} nameserver(s) haven't responded, asking again", queries.size());
+    }
+
+    every_nameserver_responded = nameserver_count > 0 && queries.is_empty();
+    return Vector<Answer> {};
+}
+
+ErrorOr<void> LookupServer::send_query(UpstreamQuery& query, Name const& name, RecordType record_type)
 {
     Packet request;
     request.set_is_query();
     request.set_id(get_random_uniform(UINT16_MAX));
     Name name_in_question = name;
-    if (should_randomize_case == ShouldRandomizeCase::Yes)
+    if (query.should_randomize_case == ShouldRandomizeCase::Yes)
         name_in_question.randomize_case();
     request.add_question({ name_in_question, record_type, RecordClass::IN, false });
 
-    auto buffer = request.to_byte_buffer();
-
-    auto udp_socket = TRY(Core::Stream::UDPSocket::connect(nameserver, 53, Time::from_seconds(1)));
-    TRY(udp_socket->set_blocking(true));
+    TRY(query.socket->write(request.to_byte_buffer()));
+    query.request = move(request);
+    return {};
+}
 
-    TRY(udp_socket->write(buffer));
+// Returns nothing if the response doesn't settle the query, and we should keep waiting for another one.
+ErrorOr<Optional<Vector<Answer>>> LookupServer::receive_response(UpstreamQuery& query, Name const& name, RecordType record_type)
+{
+    auto& request = query.request;
 
     u8 response_buffer[4096];
-    int nrecv = TRY(udp_socket->read({ response_buffer, sizeof(response_buffer) })).size();
-    if (udp_socket->is_eof())
+    int nrecv = TRY(query.socket->read({ response_buffer, sizeof(response_buffer) })).size();
+    if (query.socket->is_eof())
         return Vector<Answer> {};
 
-    did_get_response = true;
-
     auto o_response = Packet::from_raw_packet(response_buffer, nrecv);
     if (!o_response.has_value())
         return Vector<Answer> {};
@@ -255,14 +335,17 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nam
     auto& response = o_response.value();
 
     if (response.id() != request.id()) {
+        // This might be a late response to a query we have since asked again.
         dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return Vector<Answer> {};
+        return Optional<Vector<Answer>> {};
     }
 
     if (response.code() == Packet::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
+        if (query.should_randomize_case == ShouldRandomizeCase::Yes) {
             // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
+            query.should_randomize_case = ShouldRandomizeCase::No;
+            TRY(send_query(query, name, record_type));
+            return Optional<Vector<Answer>> {};
         }
         return Vector<Answer> {};
     }
@@ -292,7 +375,7 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nam
         return Vector<Answer> {};
     }
 
-    Vector<Answer, 8> answers;
+    Vector<Answer> answers;
     for (auto& answer : response.answers()) {
         put_in_cache(answer);
         if (answer.type() != record_type)
@@ -303,6 +386,60 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nam
     return answers;
 }
 
+void LookupServer::prefetch(Name const& name, RecordType record_type)
+{
+    // Names in .local are answered by mDNS, which keeps its answers fresh by itself.
+    if (name.as_string().ends_with(".local"sv))
+        return;
+
+    auto key = String::formatted("{}/{}", name.as_string().to_lowercase(), to_underlying(record_type));
+    if (m_prefetches_in_flight.set(key) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    // NOTE: This runs once the client that asked has gotten its (still valid) answers.
+    deferred_invoke([this, name, record_type, key] {
+        m_prefetches_in_flight.remove(key);
+        auto start_time = time(nullptr);
+        bool every_nameserver_responded = false;
+        auto answers_or_error = lookup_upstream(name, record_type, every_nameserver_responded);
+        if (answers_or_error.is_error() || answers_or_error.value().is_empty())
+            return;
+
+        dbgln_if(LOOKUPSERVER_DEBUG, "Prefetched {} answer(s) for '{}'", answers_or_error.value().size(), name.as_string());
+        // The fresh answers are in the cache now, so we can forget about the ones that are about to expire.
+        if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
+            cached_answers->value.remove_all_matching([&](Answer const& answer) {
+                return answer.type() == record_type && answer.received_time() < start_time;
+            });
+        }
+    });
+}
+
+void LookupServer::put_in_negative_cache(Name const& name, RecordType record_type)
+{
+    // Prevent the cache from growing too big.
+    if (m_negative_cache.size() >= 256)
+        m_negative_cache.remove(m_negative_cache.begin());
+
+    auto now = time(nullptr);
+    auto& negative_answers = m_negative_cache.ensure(name);
+    negative_answers.remove_all_matching([&](auto& negative_answer) {
+        return negative_answer.record_type == record_type || negative_answer.expiry_time <= now;
+    });
+    negative_answers.append({ record_type, now + s_negative_ttl });
+}
+
+bool LookupServer::is_in_negative_cache(Name const& name, RecordType record_type) const
+{
+    auto negative_answers = m_negative_cache.find(name);
+    if (negative_answers == m_negative_cache.end())
+        return false;
+    auto now = time(nullptr);
+    return any_of(negative_answers->value, [&](auto& negative_answer) {
+        return negative_answer.record_type == record_type && negative_answer.expiry_time > now;
+    });
+}
+
 void LookupServer::put_in_cache(Answer const& answer)
 {
     if (answer.has_expired())
@@ -9,8 +9,10 @@
 #include "ConnectionFromClient.h"
 #include "DNSServer.h"
 #include "MulticastDNS.h"
+#include <AK/HashTable.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCore/Object.h>
+#include <LibCore/Stream.h>
 #include <LibDNS/Name.h>
 #include <LibDNS/Packet.h>
 #include <LibIPC/MultiServer.h>
@@ -29,10 +31,27 @@ public:
 private:
     LookupServer();
 
+    struct UpstreamQuery {
+        String nameserver;
+        NonnullOwnPtr<Core::Stream::UDPSocket> socket;
+        Packet request;
+        ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+    };
+
+    struct NegativeAnswer {
+        RecordType record_type;
+        time_t expiry_time;
+    };
+
     void load_etc_hosts();
     void put_in_cache(Answer const&);
+    void put_in_negative_cache(Name const&, RecordType);
+    bool is_in_negative_cache(Name const&, RecordType) const;
+    void prefetch(Name const&, RecordType);
 
-    ErrorOr<Vector<Answer>> lookup(Name const& hostname, String const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    ErrorOr<Vector<Answer>> lookup_upstream(Name const&, RecordType, bool& every_nameserver_responded);
+    ErrorOr<void> send_query(UpstreamQuery&, Name const&, RecordType);
+    ErrorOr<Optional<Vector<Answer>>> receive_response(UpstreamQuery&, Name const&, RecordType);
 
     OwnPtr<IPC::MultiServer<ConnectionFromClient>> m_server;
     RefPtr<DNSServer> m_dns_server;
@@ -41,6 +60,8 @@ private:
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<Name, Vector<Answer>, Name::Traits> m_etc_hosts;
     HashMap<Name, Vector<Answer>, Name::Traits> m_lookup_cache;
+    HashMap<Name, Vector<NegativeAnswer>, Name::Traits> m_negative_cache;
+    HashTable<String> m_prefetches_in_flight;
 };
 
 }
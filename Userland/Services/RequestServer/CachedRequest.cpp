@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <RequestServer/CachedRequest.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ConnectionFromClient& client, NonnullRefPtr<HttpCache::Entry> entry, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_entry(entry)
+    , m_writer(this->output_stream(), entry)
+{
+    // NOTE: The client only learns about this request once start_request() returns, so respond on the next event loop iteration.
+    m_start_timer = Core::Timer::create_single_shot(0, [this] {
+        set_status_code(m_entry->status_code);
+        set_response_headers(m_entry->response_headers);
+        m_writer.start([this](bool success) {
+            did_progress(m_entry->body.size(), m_entry->body.size());
+            did_finish(success);
+        });
+    });
+    m_start_timer->start();
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ConnectionFromClient& client, NonnullRefPtr<HttpCache::Entry> entry, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+{
+    return adopt_own(*new CachedRequest(client, move(entry), move(output_stream)));
+}
+
+}
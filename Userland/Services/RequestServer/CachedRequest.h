@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Timer.h>
+#include <RequestServer/HttpCache.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request that is answered from a fresh HttpCache entry without touching the network.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override = default;
+    static NonnullOwnPtr<CachedRequest> create(ConnectionFromClient&, NonnullRefPtr<HttpCache::Entry>, NonnullOwnPtr<Core::Stream::File>&&);
+
+    virtual URL url() const override { return m_entry->url; }
+
+private:
+    explicit CachedRequest(ConnectionFromClient&, NonnullRefPtr<HttpCache::Entry>, NonnullOwnPtr<Core::Stream::File>&&);
+
+    NonnullRefPtr<HttpCache::Entry> m_entry;
+    CachedBodyWriter m_writer;
+    RefPtr<Core::Timer> m_start_timer;
+};
+
+}
@@ -13,6 +13,23 @@ namespace RequestServer::ConnectionCache {
 
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache {};
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache {};
+NonnullRefPtr<TLS::SessionCache> g_tls_session_cache = TLS::SessionCache::create();
+Limits g_limits {};
+
+void load_limits(Core::ConfigFile const& config)
+{
+    Limits defaults;
+    auto read_size = [&](StringView key, size_t default_value) -> size_t {
+        return max(config.read_num_entry("ConnectionCache", key, static_cast<int>(default_value)), 0);
+    };
+    g_limits.max_connections_per_host = max<size_t>(read_size("MaxConnectionsPerHost"sv, defaults.max_connections_per_host), 1);
+    g_limits.max_connections = max(read_size("MaxConnections"sv, defaults.max_connections), g_limits.max_connections_per_host);
+    g_limits.keep_alive_time_ms = read_size("KeepAliveTimeMilliseconds"sv, defaults.keep_alive_time_ms);
+    g_limits.enable_pipelining = config.read_bool_entry("ConnectionCache", "EnablePipelining", defaults.enable_pipelining);
+    g_limits.max_pipelined_requests_per_connection = read_size("MaxPipelinedRequestsPerConnection"sv, defaults.max_pipelined_requests_per_connection);
+    dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache: {} connections per host, {} in total, {}ms keep-alive, pipelining {}",
+        g_limits.max_connections_per_host, g_limits.max_connections, g_limits.keep_alive_time_ms, g_limits.enable_pipelining ? "enabled" : "disabled");
+}
 
 void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 {
@@ -37,6 +54,7 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
         }
 
         auto& connection = *connection_it;
+        connection->is_persistent = connection->socket->is_open() && !connection->socket->is_eof();
         if (connection->request_queue.is_empty()) {
             Core::deferred_invoke([&connection, &cache_entry = *it->value, key = it->key, &cache] {
                 connection->socket->set_notifications_enabled(false);
@@ -85,7 +103,7 @@ void dump_jobs()
     for (auto& connection : g_tls_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (socket={}) (pipelined={}) (http2 streams={})", &entry, entry.has_started, entry.socket, entry.pipelined_request_count(), entry.http2 ? entry.http2->active_stream_count() : 0);
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
@@ -96,7 +114,7 @@ void dump_jobs()
     for (auto& connection : g_tcp_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (socket={}) (pipelined={}) (http2 streams={})", &entry, entry.has_started, entry.socket, entry.pipelined_request_count(), entry.http2 ? entry.http2->active_stream_count() : 0);
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
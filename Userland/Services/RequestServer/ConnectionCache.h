@@ -12,11 +12,13 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/URL.h>
 #include <AK/Vector.h>
+#include <LibCore/ConfigFile.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/NetworkJob.h>
 #include <LibCore/SOCKSProxyClient.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
 
 namespace RequestServer {
@@ -60,6 +62,10 @@ struct Connection {
         Function<void(Core::Stream::Socket&)> start {};
         Function<void(Core::NetworkJob::Error)> fail {};
         Function<Vector<TLS::Certificate>()> provide_client_certificates {};
+        Function<bool(Core::Stream::Socket&)> send_request_ahead {};
+        Function<void()> discard_request_sent_ahead {};
+        bool request_was_sent_ahead { false };
+        Function<void(HTTP::Http2Connection&)> start_http2 {};
 
         template<typename T>
         static JobData create(T& job)
@@ -83,6 +89,24 @@ struct Connection {
                     }
                     return Vector<TLS::Certificate> {};
                 },
+                .send_request_ahead = [&job](auto& socket) {
+                    if constexpr (requires { job.send_request_ahead(socket); })
+                        return job.send_request_ahead(socket);
+                    else
+                        return false;
+                },
+                .discard_request_sent_ahead = [&job] {
+                    if constexpr (requires { job.discard_request_sent_ahead(); })
+                        job.discard_request_sent_ahead();
+                    else
+                        (void)job;
+                },
+                .start_http2 = [&job](HTTP::Http2Connection& connection) {
+                    if constexpr (requires { job.start(connection); })
+                        job.start(connection);
+                    else
+                        VERIFY_NOT_REACHED();
+                },
             };
             // clang-format on
         }
@@ -99,6 +123,21 @@ struct Connection {
     Core::ElapsedTimer timer {};
     JobData job_data {};
     Proxy proxy {};
+    // Whether the socket was kept open after a request finished, i.e. the server honours keep-alive.
+    bool is_persistent { false };
+    // Set if the server agreed to speak HTTP/2, in which case all requests are multiplexed over this connection.
+    // NOTE: This is declared after the socket, so that it goes away before the socket it uses.
+    RefPtr<HTTP::Http2Connection> http2;
+
+    size_t pipelined_request_count() const
+    {
+        size_t count = 0;
+        for (auto& job_data : request_queue) {
+            if (job_data.request_was_sent_ahead)
+                ++count;
+        }
+        return count;
+    }
 };
 
 struct ConnectionKey {
@@ -123,12 +162,26 @@ namespace RequestServer::ConnectionCache {
 
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache;
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache;
+// Shared by all TLS connections, so that any new connection can resume a session negotiated by an earlier one.
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
 
 void request_did_finish(URL const&, Core::Stream::Socket const*);
 void dump_jobs();
 
-constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
-constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
+struct Limits {
+    size_t max_connections_per_host { 6 };
+    // Per connection cache (i.e. separately for TCP and TLS connections).
+    size_t max_connections { 64 };
+    // Idle connections are closed after this long.
+    size_t keep_alive_time_ms { 10'000 };
+    // Whether requests may be sent ahead on a busy keep-alive connection (HTTP/1.1 pipelining).
+    bool enable_pipelining { false };
+    size_t max_pipelined_requests_per_connection { 4 };
+};
+
+extern Limits g_limits;
+
+void load_limits(Core::ConfigFile const&);
 
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
@@ -162,29 +215,167 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
                     return connection.job_data.provide_client_certificates();
                 return {};
             });
+            options.set_session_cache(g_tls_session_cache);
             TRY(set_socket(TRY((connection.proxy.template tunnel<SocketType, SocketStorageType>(url, move(options))))));
         } else {
             TRY(set_socket(TRY((connection.proxy.template tunnel<SocketType, SocketStorageType>(url)))));
         }
         dbgln_if(REQUESTSERVER_DEBUG, "Creating a new socket for {} -> {}", url, connection.socket);
+
+        // Anything we pipelined on the old socket is lost, so those requests will have to be sent again.
+        connection.is_persistent = false;
+        for (auto& job_data : connection.request_queue) {
+            if (job_data.request_was_sent_ahead) {
+                job_data.request_was_sent_ahead = false;
+                job_data.discard_request_sent_ahead();
+            }
+        }
     }
     return {};
 }
 
+// Closes a connection that is waiting to be reused, to make room for a new one.
+template<typename Cache>
+bool evict_an_idle_connection(Cache& cache)
+{
+    for (auto& it : cache) {
+        auto& connections = *it.value;
+        auto connection_it = connections.find_if([](auto& connection) {
+            // NOTE: An inactive removal timer means the connection is either in use or already on its way out.
+            return !connection->has_started && connection->removal_timer->is_active();
+        });
+        if (connection_it.is_end())
+            continue;
+        dbgln_if(REQUESTSERVER_DEBUG, "Evicting idle connection {} to {}:{}", &*connection_it, it.key.hostname, it.key.port);
+        (*connection_it)->removal_timer->stop();
+        connections.remove(connection_it.index());
+        if (connections.is_empty()) {
+            auto key = it.key;
+            cache.remove(key);
+        }
+        return true;
+    }
+    return false;
+}
+
+template<typename Cache>
+size_t connection_count(Cache const& cache)
+{
+    size_t count = 0;
+    for (auto& it : cache)
+        count += it.value->size();
+    return count;
+}
+
+template<typename Cache>
+void remove_connection(Cache& cache, ConnectionKey const& key, void const* connection)
+{
+    auto it = cache.find(key);
+    if (it == cache.end())
+        return;
+    it->value->remove_first_matching([&](auto& entry) { return entry.ptr() == connection; });
+    if (it->value->is_empty())
+        cache.remove(it);
+}
+
+template<typename Cache, typename ConnectionType>
+void set_up_http2_connection(Cache& cache, ConnectionKey const& key, ConnectionType& connection)
+{
+    connection.http2->on_stream_closed = [&cache, key, &connection] {
+        auto& http2 = *connection.http2;
+        while (!connection.request_queue.is_empty() && http2.can_open_stream()) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Running next job in queue for HTTP/2 connection {}", &connection);
+            connection.request_queue.take_first().start_http2(http2);
+        }
+        if (http2.active_stream_count() != 0 || !connection.request_queue.is_empty())
+            return;
+
+        connection.has_started = false;
+        connection.current_url = {};
+        connection.removal_timer->on_timeout = [&cache, key, ptr = &connection] {
+            Core::deferred_invoke([&cache, key, ptr] {
+                dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used HTTP/2 connection {}", ptr);
+                remove_connection(cache, key, ptr);
+            });
+        };
+        connection.removal_timer->start();
+    };
+    connection.http2->on_close = [&cache, key, &connection] {
+        dbgln_if(REQUESTSERVER_DEBUG, "HTTP/2 connection {} to {}:{} closed", &connection, key.hostname, key.port);
+        connection.removal_timer->stop();
+        // NOTE: The requests waiting for a stream never made it out, so they can't be answered anymore.
+        auto request_queue = move(connection.request_queue);
+        for (auto& job_data : request_queue)
+            job_data.fail(Core::NetworkJob::Error::ConnectionFailed);
+        // NOTE: We're being called by the HTTP/2 connection we're about to destroy.
+        Core::deferred_invoke([&cache, key, ptr = &connection] {
+            remove_connection(cache, key, ptr);
+        });
+    };
+}
+
 decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job, Core::ProxyData proxy_data = {})
 {
     using CacheEntryType = RemoveCVReference<decltype(*cache.begin()->value)>;
-    auto& sockets_for_url = *cache.ensure({ url.host(), url.port_or_default(), proxy_data }, [] { return make<CacheEntryType>(); });
+    using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
+    ConnectionKey key { url.host(), url.port_or_default(), proxy_data };
+    auto& sockets_for_url = *cache.ensure(key, [] { return make<CacheEntryType>(); });
 
     Proxy proxy { proxy_data };
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
+
+    constexpr bool can_use_http2 = IsSame<typename ConnectionType::SocketType, TLS::TLSv12> && requires { job.start(declval<HTTP::Http2Connection&>()); };
+    auto start_or_enqueue_on_http2_connection = [&](ConnectionType& connection) {
+        auto job_data = decltype(connection.job_data)::create(job);
+        if (!connection.http2->can_open_stream()) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in HTTP/2 connection {}", url, &connection);
+            connection.request_queue.append(move(job_data));
+            return;
+        }
+        dbgln_if(REQUESTSERVER_DEBUG, "Start request for URL {} in HTTP/2 connection {}", url, &connection);
+        connection.has_started = true;
+        connection.removal_timer->stop();
+        connection.timer.start();
+        connection.current_url = url;
+        job_data.start_http2(*connection.http2);
+        // NOTE: The job may not have opened a stream after all (e.g. when pre-connecting), leaving the connection idle.
+        if (connection.http2->active_stream_count() == 0 && connection.http2->on_stream_closed)
+            connection.http2->on_stream_closed();
+    };
+
+    if constexpr (can_use_http2) {
+        // One HTTP/2 connection can carry all of our requests to this host.
+        auto it = sockets_for_url.find_if([](auto& connection) { return connection->http2 && connection->http2->is_open(); });
+        if (!it.is_end()) {
+            auto& connection = sockets_for_url[it.index()];
+            start_or_enqueue_on_http2_connection(connection);
+            return &connection;
+        }
+    }
+
+    // NOTE: A connection with an empty request queue may still be busy with a request, only pick truly idle ones.
+    auto it = sockets_for_url.find_if([](auto& connection) { return !connection->has_started && !connection->http2; });
     auto did_add_new_connection = false;
     auto failed_to_find_a_socket = it.is_end();
-    if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
-        auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+    auto can_add_connection = [&] {
+        if (sockets_for_url.size() >= g_limits.max_connections_per_host)
+            return false;
+        return connection_count(cache) < g_limits.max_connections || evict_an_idle_connection(cache);
+    };
+    if (failed_to_find_a_socket && can_add_connection()) {
+        auto connection_result = [&] {
+            if constexpr (IsSame<typename ConnectionType::SocketType, TLS::TLSv12>) {
+                TLS::Options options;
+                options.set_session_cache(g_tls_session_cache);
+                // https://www.rfc-editor.org/rfc/rfc9113#section-3.2
+                if constexpr (can_use_http2)
+                    options.set_alpn_protocols({ "h2", "http/1.1" });
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url, move(options));
+            } else {
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+            }
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([&job] {
@@ -192,6 +383,9 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        auto negotiated_http2 = false;
+        if constexpr (can_use_http2)
+            negotiated_http2 = connection_result.value()->alpn() == "h2"sv;
         auto socket_result = Core::Stream::BufferedSocket<typename ConnectionType::StorageType>::create(connection_result.release_value());
         if (socket_result.is_error()) {
             dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
@@ -200,11 +394,32 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        RefPtr<HTTP::Http2Connection> http2;
+        if (negotiated_http2) {
+            auto http2_result = HTTP::Http2Connection::try_create(*socket_result.value());
+            if (http2_result.is_error()) {
+                dbgln("ConnectionCache: Failed to set up HTTP/2 for {}: {}", url, http2_result.error());
+                Core::deferred_invoke([&job] {
+                    job.fail(Core::NetworkJob::Error::ConnectionFailed);
+                });
+                return ReturnType { nullptr };
+            }
+            http2 = http2_result.release_value();
+        }
         sockets_for_url.append(make<ConnectionType>(
             socket_result.release_value(),
             typename ConnectionType::QueueType {},
-            Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr)));
-        sockets_for_url.last().proxy = move(proxy);
+            Core::Timer::create_single_shot(g_limits.keep_alive_time_ms, nullptr)));
+        auto& connection = sockets_for_url.last();
+        connection.proxy = move(proxy);
+        if (http2) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Negotiated HTTP/2 for new connection {} to {}", &connection, url);
+            connection.http2 = move(http2);
+            connection.socket->set_notifications_enabled(true);
+            set_up_http2_connection(cache, key, connection);
+            start_or_enqueue_on_http2_connection(connection);
+            return &connection;
+        }
         did_add_new_connection = true;
     }
     size_t index;
@@ -213,14 +428,24 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             index = sockets_for_url.size() - 1;
         } else {
             // Find the least backed-up connection (based on how many entries are in their request queue).
-            index = 0;
+            Optional<size_t> least_backed_up_index;
             auto min_queue_size = (size_t)-1;
             for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+                // NOTE: HTTP/2 connections that are still usable were considered above, the others are on their way out.
+                if (it->http2)
+                    continue;
                 if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
-                    index = it.index();
+                    least_backed_up_index = it.index();
                     min_queue_size = queue_size;
                 }
             }
+            if (!least_backed_up_index.has_value()) {
+                Core::deferred_invoke([&job] {
+                    job.fail(Core::NetworkJob::Error::ConnectionFailed);
+                });
+                return ReturnType { nullptr };
+            }
+            index = *least_backed_up_index;
         }
     } else {
         index = it.index();
@@ -251,7 +476,12 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
         connection.job_data.start(*connection.socket);
     } else {
         dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in {} - {}", url, &connection, connection.socket);
-        connection.request_queue.append(decltype(connection.job_data)::create(job));
+        auto job_data = decltype(connection.job_data)::create(job);
+        if (g_limits.enable_pipelining && connection.is_persistent && connection.pipelined_request_count() < g_limits.max_pipelined_requests_per_connection) {
+            job_data.request_was_sent_ahead = job_data.send_request_ahead(*connection.socket);
+            dbgln_if(REQUESTSERVER_DEBUG, "Pipelined request for URL {} in {}: {}", url, &connection, job_data.request_was_sent_ahead);
+        }
+        connection.request_queue.append(move(job_data));
     }
     return &connection;
 }
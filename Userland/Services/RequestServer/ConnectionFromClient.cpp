@@ -130,6 +130,11 @@ struct Job {
         ConnectionCache::request_did_finish(m_url, &socket);
         s_jobs.remove(m_url);
     }
+    void start(HTTP::Http2Connection&)
+    {
+        // Nothing to do, the connection is all we wanted.
+        s_jobs.remove(m_url);
+    }
     void fail(Core::NetworkJob::Error error)
     {
         dbgln("Pre-connect to {} failed: {}", m_url, Core::to_string(error));
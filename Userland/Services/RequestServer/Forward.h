@@ -8,9 +8,12 @@
 
 namespace RequestServer {
 
+class CachedRequest;
 class ConnectionFromClient;
 class Request;
 class GeminiProtocol;
+class HttpCache;
+struct HttpCacheContext;
 class HttpRequest;
 class HttpProtocol;
 class HttpsRequest;
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/GenericLexer.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/System.h>
+#include <RequestServer/HttpCache.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+struct CacheControl {
+    Optional<i64> max_age;
+    bool no_store { false };
+    bool no_cache { false };
+};
+
+static CacheControl parse_cache_control(StringView value)
+{
+    CacheControl cache_control;
+    for (auto directive : value.split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto name = directive;
+        StringView argument;
+        if (auto equals = directive.find('='); equals.has_value()) {
+            name = directive.substring_view(0, *equals).trim_whitespace();
+            argument = directive.substring_view(*equals + 1).trim_whitespace().trim("\""sv);
+        }
+        if (name.equals_ignoring_case("max-age"sv)) {
+            // NOTE: An invalid max-age makes the response stale (RFC 9111 section 4.2.1).
+            cache_control.max_age = argument.to_uint<u32>().value_or(0);
+        } else if (name.equals_ignoring_case("no-store"sv)) {
+            cache_control.no_store = true;
+        } else if (name.equals_ignoring_case("no-cache"sv)) {
+            cache_control.no_cache = true;
+        } else if (name.equals_ignoring_case("must-revalidate"sv)) {
+            // NOTE: We never serve stale responses without revalidating them, so there is nothing more to do.
+        }
+    }
+    return cache_control;
+}
+
+static Optional<i64> parse_http_date(Optional<String> const& value)
+{
+    if (!value.has_value())
+        return {};
+    // FIXME: Also accept the obsolete RFC 850 and asctime() formats (RFC 9110 section 5.6.7).
+    auto date = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S GMT"sv, *value);
+    if (!date.has_value())
+        return {};
+    return date->timestamp();
+}
+
+static Optional<String> request_header(HashMap<String, String> const& request_headers, StringView name)
+{
+    for (auto& it : request_headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9110#section-15.1
+static bool is_heuristically_cacheable(u32 status_code)
+{
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static time_t now()
+{
+    return Core::DateTime::now().timestamp();
+}
+
+void HttpCache::Entry::update_freshness()
+{
+    auto cache_control = parse_cache_control(response_headers.get("Cache-Control").value_or({}));
+    no_cache = cache_control.no_cache;
+    if (!response_headers.contains("Cache-Control")) {
+        if (auto pragma = response_headers.get("Pragma"); pragma.has_value() && pragma->contains("no-cache"sv, CaseSensitivity::CaseInsensitive))
+            no_cache = true;
+    }
+
+    initial_age = response_headers.get("Age").value_or({}).to_uint<u32>().value_or(0);
+
+    // https://www.rfc-editor.org/rfc/rfc9111#section-4.2.1
+    // NOTE: Core::DateTime::parse() interprets dates in local time, so we only ever look at
+    //       differences between dates sent by the server.
+    auto date = parse_http_date(response_headers.get("Date"));
+    if (cache_control.max_age.has_value()) {
+        freshness_lifetime = *cache_control.max_age;
+    } else if (response_headers.contains("Expires")) {
+        auto expires = parse_http_date(response_headers.get("Expires"));
+        freshness_lifetime = (expires.has_value() && date.has_value()) ? *expires - *date : 0;
+    } else if (auto last_modified = parse_http_date(response_headers.get("Last-Modified")); last_modified.has_value() && date.has_value() && is_heuristically_cacheable(status_code)) {
+        // https://www.rfc-editor.org/rfc/rfc9111#section-4.2.2
+        // A typical heuristic is 10% of the time since the resource was last modified; cap it at a day.
+        freshness_lifetime = min((*date - *last_modified) / 10, static_cast<i64>(24 * 60 * 60));
+    } else {
+        freshness_lifetime = 0;
+    }
+}
+
+bool HttpCache::Entry::is_fresh() const
+{
+    if (no_cache)
+        return false;
+    auto current_age = initial_age + max(static_cast<i64>(0), static_cast<i64>(now() - stored_at));
+    return current_age < freshness_lifetime;
+}
+
+bool HttpCache::Entry::has_validators() const
+{
+    return response_headers.contains("ETag") || response_headers.contains("Last-Modified");
+}
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache* s_the;
+    if (!s_the) {
+        s_the = new HttpCache;
+        if (auto result = Core::System::mkdir(cache_directory, 0700); result.is_error() && !(result.error().is_errno() && result.error().code() == EEXIST))
+            dbgln("HttpCache: Unable to create {}: {}", cache_directory, result.error());
+    }
+    return *s_the;
+}
+
+bool HttpCache::can_use_cache_for(StringView method, HashMap<String, String> const& request_headers)
+{
+    if (!method.equals_ignoring_case("GET"sv))
+        return false;
+    // NOTE: Responses to authorized requests must not be stored by default (RFC 9111 section 3.5).
+    if (request_header(request_headers, "Authorization"sv).has_value())
+        return false;
+    // NOTE: Leave conditional and range requests made by the client alone, it expects to see the actual response.
+    for (auto name : { "If-None-Match"sv, "If-Modified-Since"sv, "If-Match"sv, "If-Unmodified-Since"sv, "Range"sv }) {
+        if (request_header(request_headers, name).has_value())
+            return false;
+    }
+    if (parse_cache_control(request_header(request_headers, "Cache-Control"sv).value_or({})).no_store)
+        return false;
+    return true;
+}
+
+void HttpCache::add_validators_to(Entry const& entry, HashMap<String, String>& request_headers)
+{
+    // https://www.rfc-editor.org/rfc/rfc9111#section-4.3.1
+    if (auto etag = entry.response_headers.get("ETag"); etag.has_value())
+        request_headers.set("If-None-Match", *etag);
+    if (auto last_modified = entry.response_headers.get("Last-Modified"); last_modified.has_value())
+        request_headers.set("If-Modified-Since", *last_modified);
+}
+
+RefPtr<HttpCache::Entry> HttpCache::lookup(URL const& url, HashMap<String, String> const& request_headers)
+{
+    RefPtr<Entry> entry;
+    if (auto* cached_entry = m_entries.get(url)) {
+        entry = *cached_entry;
+    } else {
+        entry = load_from_disk(url);
+        if (!entry)
+            return nullptr;
+        insert(*entry);
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc9111#section-4.1
+    for (auto& it : entry->vary_request_headers) {
+        if (request_header(request_headers, it.key).value_or({}) != it.value)
+            return nullptr;
+    }
+
+    // A client asking not to be served from the cache still gets to revalidate.
+    if (auto cache_control = parse_cache_control(request_header(request_headers, "Cache-Control"sv).value_or({})); cache_control.no_cache) {
+        if (!entry->has_validators())
+            return nullptr;
+        entry->no_cache = true;
+    }
+
+    dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Found {} entry for {}", entry->is_fresh() ? "fresh" : "stale", url);
+    return entry;
+}
+
+void HttpCache::store(URL const& url, HashMap<String, String> const& request_headers, u32 status_code, Headers const& response_headers, ByteBuffer body)
+{
+    if (!is_heuristically_cacheable(status_code) || body.size() > max_entry_size)
+        return;
+    if (parse_cache_control(response_headers.get("Cache-Control").value_or({})).no_store)
+        return;
+    // NOTE: Cookies are managed by the client; replaying them from the cache would be wrong.
+    if (response_headers.contains("Set-Cookie"))
+        return;
+
+    auto entry = adopt_ref(*new Entry);
+    entry->url = url;
+    entry->status_code = status_code;
+    entry->response_headers = response_headers;
+    entry->body = move(body);
+    entry->stored_at = now();
+
+    if (auto vary = response_headers.get("Vary"); vary.has_value()) {
+        for (auto name : vary->split_view(',')) {
+            name = name.trim_whitespace();
+            if (name == "*"sv)
+                return;
+            entry->vary_request_headers.set(name, request_header(request_headers, name).value_or({}));
+        }
+    }
+
+    entry->update_freshness();
+    if (entry->freshness_lifetime <= 0 && !entry->has_validators())
+        return;
+
+    dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Storing {} ({} bytes, fresh for {}s)", url, entry->body.size(), entry->freshness_lifetime);
+    write_to_disk(*entry);
+    insert(move(entry));
+}
+
+void HttpCache::did_revalidate(Entry& entry, Headers const& not_modified_response_headers)
+{
+    // https://www.rfc-editor.org/rfc/rfc9111#section-3.2
+    for (auto& it : not_modified_response_headers) {
+        if (it.key.equals_ignoring_case("Content-Length"sv) || it.key.equals_ignoring_case("Content-Encoding"sv) || it.key.equals_ignoring_case("Transfer-Encoding"sv))
+            continue;
+        entry.response_headers.set(it.key, it.value);
+    }
+    entry.stored_at = now();
+    entry.update_freshness();
+    write_to_disk(entry);
+}
+
+void HttpCache::invalidate(URL const& url)
+{
+    m_entries.remove(url);
+    (void)Core::System::unlink(path_for(url));
+}
+
+void HttpCache::insert(NonnullRefPtr<Entry> entry)
+{
+    auto url = entry->url;
+    m_entries.set(move(url), move(entry));
+}
+
+String HttpCache::path_for(URL const& url)
+{
+    return String::formatted("{}/{:08x}", cache_directory, url.to_string().hash());
+}
+
+// On-disk format: a line-based header (magic, URL, status code, time of storing, the
+// Vary request headers and the response headers, each as a count followed by name/value
+// lines, and the body size), followed by the raw body.
+static constexpr StringView disk_format_magic = "HTTPCACHE1"sv;
+
+RefPtr<HttpCache::Entry> HttpCache::load_from_disk(URL const& url)
+{
+    auto file_or_error = Core::Stream::File::open(path_for(url), Core::Stream::OpenMode::Read);
+    if (file_or_error.is_error())
+        return nullptr;
+    auto contents_or_error = file_or_error.value()->read_all();
+    if (contents_or_error.is_error())
+        return nullptr;
+    auto contents = contents_or_error.release_value();
+
+    GenericLexer lexer { StringView { contents.bytes() } };
+    auto read_line = [&]() -> Optional<StringView> {
+        auto line = lexer.consume_until('\n');
+        if (!lexer.consume_specific('\n'))
+            return {};
+        return line;
+    };
+    auto read_number = [&]() -> Optional<u64> {
+        auto line = read_line();
+        if (!line.has_value())
+            return {};
+        return line->to_uint<u64>();
+    };
+    auto read_headers = [&](Headers& headers) {
+        auto count = read_number();
+        if (!count.has_value())
+            return false;
+        for (u64 i = 0; i < *count; ++i) {
+            auto name = read_line();
+            auto value = read_line();
+            if (!name.has_value() || !value.has_value())
+                return false;
+            headers.set(*name, *value);
+        }
+        return true;
+    };
+
+    if (read_line() != disk_format_magic)
+        return nullptr;
+    // NOTE: File names are a hash of the URL, so make sure this isn't a different URL's entry.
+    if (read_line() != url.to_string().view())
+        return nullptr;
+
+    auto entry = adopt_ref(*new Entry);
+    entry->url = url;
+    auto status_code = read_number();
+    auto stored_at = read_number();
+    if (!status_code.has_value() || !stored_at.has_value())
+        return nullptr;
+    entry->status_code = *status_code;
+    entry->stored_at = *stored_at;
+    if (!read_headers(entry->vary_request_headers) || !read_headers(entry->response_headers))
+        return nullptr;
+
+    auto body_size = read_number();
+    if (!body_size.has_value() || *body_size != lexer.tell_remaining())
+        return nullptr;
+    auto body_or_error = ByteBuffer::copy(lexer.remaining().bytes());
+    if (body_or_error.is_error())
+        return nullptr;
+    entry->body = body_or_error.release_value();
+    entry->update_freshness();
+    return entry;
+}
+
+void HttpCache::write_to_disk(Entry const& entry)
+{
+    StringBuilder builder;
+    builder.appendff("{}\n{}\n{}\n{}\n", disk_format_magic, entry.url, entry.status_code, entry.stored_at);
+    auto append_headers = [&](Headers const& headers) {
+        builder.appendff("{}\n", headers.size());
+        for (auto& it : headers)
+            builder.appendff("{}\n{}\n", it.key, it.value);
+    };
+    append_headers(entry.vary_request_headers);
+    append_headers(entry.response_headers);
+    builder.appendff("{}\n", entry.body.size());
+
+    // NOTE: Other RequestServer processes may be reading this entry, so write it out
+    //       to a temporary file first and move it into place when it's complete.
+    // FIXME: Put a limit on the total size of the cache directory.
+    auto path = path_for(entry.url);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    auto result = [&]() -> ErrorOr<void> {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate, 0600));
+        if (!file->write_or_error(builder.string_view().bytes()) || !file->write_or_error(entry.body))
+            return Error::from_errno(EIO);
+        file->close();
+        TRY(Core::System::rename(temporary_path, path));
+        return {};
+    }();
+    if (result.is_error()) {
+        dbgln("HttpCache: Unable to write {} to disk: {}", entry.url, result.error());
+        (void)Core::System::unlink(temporary_path);
+    }
+}
+
+ErrorOr<size_t> CachingStream::write(ReadonlyBytes bytes)
+{
+    auto written = TRY(m_output.write(bytes));
+    if (m_capturing) {
+        if (m_captured.size() + written > HttpCache::max_entry_size || m_captured.try_append(bytes.trim(written)).is_error()) {
+            m_capturing = false;
+            m_captured.clear();
+        }
+    }
+    return written;
+}
+
+Optional<ByteBuffer> CachingStream::take_captured_body()
+{
+    if (!m_capturing)
+        return {};
+    m_capturing = false;
+    return move(m_captured);
+}
+
+CachedBodyWriter::CachedBodyWriter(Core::Stream::File& output, NonnullRefPtr<HttpCache::Entry> entry)
+    : m_output(output)
+    , m_entry(move(entry))
+{
+}
+
+void CachedBodyWriter::start(Function<void(bool)> on_complete)
+{
+    m_on_complete = move(on_complete);
+    m_retry_timer = Core::Timer::create_repeating(50, [this] { write_more(); });
+    write_more();
+}
+
+void CachedBodyWriter::write_more()
+{
+    auto body = m_entry->body.bytes();
+    while (m_offset < body.size()) {
+        auto result = m_output.write(body.slice(m_offset));
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            if (result.error().is_errno() && result.error().code() == EAGAIN) {
+                // The client hasn't drained the pipe yet, try again later.
+                if (!m_retry_timer->is_active())
+                    m_retry_timer->start();
+                return;
+            }
+            return finish(false);
+        }
+        m_offset += result.value();
+    }
+    finish(true);
+}
+
+void CachedBodyWriter::finish(bool success)
+{
+    m_retry_timer->stop();
+    auto on_complete = move(m_on_complete);
+    on_complete(success);
+}
+
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/LRUCache.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
+#include <RequestServer/Forward.h>
+
+namespace RequestServer {
+
+// A private (per-user-agent) HTTP cache, as described by RFC 9111.
+// Entries live in memory and are written through to disk, so that they survive
+// across RequestServer instances (there is one RequestServer process per client).
+class HttpCache {
+public:
+    using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+    struct Entry : public RefCounted<Entry> {
+        URL url;
+        // The values of the request headers named by the response's Vary header, at the time of storing.
+        Headers vary_request_headers;
+        u32 status_code { 0 };
+        Headers response_headers;
+        ByteBuffer body;
+        time_t stored_at { 0 };
+
+        // Derived from response_headers by update_freshness().
+        i64 freshness_lifetime { 0 };
+        i64 initial_age { 0 };
+        bool no_cache { false };
+
+        void update_freshness();
+        bool is_fresh() const;
+        bool has_validators() const;
+    };
+
+    static HttpCache& the();
+
+    RefPtr<Entry> lookup(URL const&, HashMap<String, String> const& request_headers);
+    void store(URL const&, HashMap<String, String> const& request_headers, u32 status_code, Headers const& response_headers, ByteBuffer body);
+    void did_revalidate(Entry&, Headers const& not_modified_response_headers);
+    void invalidate(URL const&);
+
+    static bool can_use_cache_for(StringView method, HashMap<String, String> const& request_headers);
+    static void add_validators_to(Entry const&, HashMap<String, String>& request_headers);
+
+    static constexpr size_t max_entry_size = 8 * MiB;
+    static constexpr size_t memory_budget = 32 * MiB;
+    static constexpr StringView cache_directory = "/tmp/http-cache"sv;
+
+private:
+    HttpCache() = default;
+
+    void insert(NonnullRefPtr<Entry>);
+    RefPtr<Entry> load_from_disk(URL const&);
+    void write_to_disk(Entry const&);
+    static String path_for(URL const&);
+
+    // Entries evicted from memory remain on disk.
+    LRUCache<URL, NonnullRefPtr<Entry>> m_entries { memory_budget, [](URL const&, NonnullRefPtr<Entry> const& entry) { return entry->body.size(); } };
+};
+
+// Forwards everything written to it to the request's output pipe, keeping a copy of
+// the bytes that were accepted so that the complete response body can be cached.
+class CachingStream final : public Core::Stream::Stream {
+public:
+    CachingStream(Core::Stream::File& output, bool capture)
+        : m_output(output)
+        , m_capturing(capture)
+    {
+    }
+
+    virtual ErrorOr<Bytes> read(Bytes) override { return Error::from_errno(EBADF); }
+    virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+    virtual bool is_eof() const override { return m_output.is_eof(); }
+    virtual bool is_open() const override { return m_output.is_open(); }
+    virtual void close() override { m_output.close(); }
+    virtual bool is_writable() const override { return true; }
+
+    // Empty if capturing was disabled or the body exceeded HttpCache::max_entry_size.
+    Optional<ByteBuffer> take_captured_body();
+
+private:
+    Core::Stream::File& m_output;
+    ByteBuffer m_captured;
+    bool m_capturing { false };
+};
+
+// Writes a cached response body into a request's output pipe, retrying periodically
+// whenever the pipe is full (like HTTP::Job does when flushing its buffers).
+class CachedBodyWriter {
+public:
+    CachedBodyWriter(Core::Stream::File& output, NonnullRefPtr<HttpCache::Entry>);
+
+    // NOTE: on_complete may destroy the request, and with it this writer.
+    void start(Function<void(bool success)> on_complete);
+
+private:
+    void write_more();
+    void finish(bool success);
+
+    Core::Stream::File& m_output;
+    NonnullRefPtr<HttpCache::Entry> m_entry;
+    size_t m_offset { 0 };
+    RefPtr<Core::Timer> m_retry_timer;
+    Function<void(bool)> m_on_complete;
+};
+
+// Cache state attached to an HTTP(S) request that goes over the network.
+struct HttpCacheContext {
+    NonnullOwnPtr<CachingStream> stream;
+    HashMap<String, String> request_headers;
+    // Set when the request is a conditional one, revalidating a stale entry.
+    RefPtr<HttpCache::Entry> entry_being_revalidated;
+    // Set once the server answered 304 Not Modified and we serve the cached body.
+    OwnPtr<CachedBodyWriter> writer;
+};
+
+}
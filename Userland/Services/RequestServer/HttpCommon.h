@@ -14,8 +14,10 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -24,19 +26,45 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        if (auto* cache_context = self->cache_context(); cache_context && cache_context->entry_being_revalidated && response_code == 304u) {
+            // Our cached response is still good, serve it once the job finishes.
+            auto& entry = *cache_context->entry_being_revalidated;
+            HttpCache::the().did_revalidate(entry, headers);
+            cache_context->writer = make<CachedBodyWriter>(self->output_stream(), entry);
+            self->set_status_code(entry.status_code);
+            self->set_response_headers(entry.response_headers);
+            return;
+        }
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
     job->on_finish = [self](bool success) {
-        Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
-            ConnectionCache::request_did_finish(url, socket);
-        });
+        // NOTE: Jobs that ran on an HTTP/2 connection don't have a socket of their own, the connection takes care of itself.
+        if (auto* socket = self->job().socket()) {
+            Core::deferred_invoke([url = self->job().url(), socket] {
+                ConnectionCache::request_did_finish(url, socket);
+            });
+        }
+        auto* cache_context = self->cache_context();
+        if (success && cache_context && cache_context->writer) {
+            cache_context->writer->start([self](bool success) {
+                auto size = self->cache_context()->entry_being_revalidated->body.size();
+                self->did_progress(size, size);
+                self->did_finish(success);
+            });
+            return;
+        }
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
             self->set_downloaded_size(response->downloaded_size());
+
+            if (success && cache_context) {
+                if (auto body = cache_context->stream->take_captured_body(); body.has_value())
+                    HttpCache::the().store(self->url(), cache_context->request_headers, response->code(), response->headers(), body.release_value());
+            }
         }
 
         // if we didn't know the total size, pretend that the request finished successfully
@@ -70,6 +98,29 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
         return {};
     }
 
+    auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
+
+    auto can_use_cache = HttpCache::can_use_cache_for(method, headers);
+    RefPtr<HttpCache::Entry> cached_entry;
+    if (can_use_cache) {
+        cached_entry = HttpCache::the().lookup(url, headers);
+    } else if (!method.is_one_of_ignoring_case("get"sv, "head"sv, "options"sv, "trace"sv)) {
+        // https://www.rfc-editor.org/rfc/rfc9111#section-4.4
+        HttpCache::the().invalidate(url);
+    }
+
+    if (cached_entry && cached_entry->is_fresh()) {
+        auto cached_request = CachedRequest::create(client, cached_entry.release_nonnull(), move(output_stream));
+        cached_request->set_request_fd(pipe_result.value().read_fd);
+        return cached_request;
+    }
+
+    auto request_headers = headers;
+    if (cached_entry && cached_entry->has_validators())
+        HttpCache::add_validators_to(*cached_entry, request_headers);
+    else
+        cached_entry = nullptr;
+
     HTTP::HttpRequest request;
     if (method.equals_ignoring_case("post"sv))
         request.set_method(HTTP::HttpRequest::Method::POST);
@@ -90,17 +141,23 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+    request.set_headers(request_headers);
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
         return {};
     request.set_body(allocated_body_result.release_value());
 
-    auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+    auto cache_context = adopt_own(*new HttpCacheContext {
+        .stream = make<CachingStream>(*output_stream, can_use_cache),
+        .request_headers = headers,
+        .entry_being_revalidated = move(cached_entry),
+        .writer = nullptr,
+    });
+    auto job = TJob::construct(move(request), *cache_context->stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    protocol_request->set_cache_context(move(cache_context));
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
         ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data);
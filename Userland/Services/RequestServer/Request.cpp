@@ -5,6 +5,7 @@
  */
 
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer {
@@ -19,6 +20,8 @@ Request::Request(ConnectionFromClient& client, NonnullOwnPtr<Core::Stream::File>
 {
 }
 
+Request::~Request() = default;
+
 void Request::stop()
 {
     m_client.did_finish_request({}, *this, false);
@@ -30,6 +33,11 @@ void Request::set_response_headers(HashMap<String, String, CaseInsensitiveString
     m_client.did_receive_headers({}, *this);
 }
 
+void Request::set_cache_context(NonnullOwnPtr<HttpCacheContext> cache_context)
+{
+    m_cache_context = move(cache_context);
+}
+
 void Request::set_certificate(String, String)
 {
 }
@@ -10,6 +10,7 @@
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
 #include <RequestServer/Forward.h>
@@ -18,7 +19,7 @@ namespace RequestServer {
 
 class Request {
 public:
-    virtual ~Request() = default;
+    virtual ~Request();
 
     i32 id() const { return m_id; }
     virtual URL url() const = 0;
@@ -42,6 +43,10 @@ public:
     void set_response_headers(HashMap<String, String, CaseInsensitiveStringTraits> const&);
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::Stream::File const& output_stream() const { return *m_output_stream; }
+    Core::Stream::File& output_stream() { return *m_output_stream; }
+
+    void set_cache_context(NonnullOwnPtr<HttpCacheContext>);
+    HttpCacheContext* cache_context() { return m_cache_context.ptr(); }
 
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::Stream::File>&&);
@@ -54,6 +59,7 @@ private:
     Optional<u32> m_total_size {};
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::Stream::File> m_output_stream;
+    OwnPtr<HttpCacheContext> m_cache_context;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
 };
 
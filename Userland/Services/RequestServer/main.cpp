@@ -5,6 +5,7 @@
  */
 
 #include <AK/OwnPtr.h>
+#include <LibCore/ConfigFile.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/System.h>
@@ -13,6 +14,7 @@
 #include <LibTLS/Certificate.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/GeminiProtocol.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpsProtocol.h>
 #include <signal.h>
@@ -22,7 +24,7 @@ ErrorOr<int> serenity_main(Main::Arguments)
     if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd sigaction"));
     else
-        TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd sigaction"));
+        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd sigaction"));
 
 #ifdef SIGINFO
     signal(SIGINFO, [](int) { RequestServer::ConnectionCache::dump_jobs(); });
@@ -31,15 +33,22 @@ ErrorOr<int> serenity_main(Main::Arguments)
     if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd"));
     else
-        TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd"));
+        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd"));
 
     // Ensure the certificates are read out here.
     [[maybe_unused]] auto& certs = DefaultRootCACertificates::the();
 
+    auto config = TRY(Core::ConfigFile::open_for_system("RequestServer"));
+    RequestServer::ConnectionCache::load_limits(*config);
+
+    // Make sure the cache directory exists before we unveil it.
+    [[maybe_unused]] auto& cache = RequestServer::HttpCache::the();
+
     Core::EventLoop event_loop;
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
     TRY(Core::System::unveil("/tmp/portal/lookup", "rw"));
     TRY(Core::System::unveil("/etc/timezone", "r"));
+    TRY(Core::System::unveil(RequestServer::HttpCache::cache_directory, "rwc"));
     if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::unveil("/home/anon", "rwc"));
     TRY(Core::System::unveil(nullptr, nullptr));
@@ -38,12 +38,13 @@ DatabaseConnection::DatabaseConnection(String database_name, int client_id)
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection {} initiating connection with database '{}'", connection_id(), m_database_name);
     s_connections.set(m_connection_id, *this);
     deferred_invoke([this]() {
-        m_database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", m_database_name));
         auto client_connection = ConnectionFromClient::client_connection_for(m_client_id);
-        if (auto maybe_error = m_database->open(); maybe_error.is_error()) {
-            client_connection->async_connection_error(m_connection_id, (int)SQL::SQLErrorCode::InternalError, maybe_error.error().string_literal());
+        auto database_or_error = SharedDatabase::open(m_database_name);
+        if (database_or_error.is_error()) {
+            client_connection->async_connection_error(m_connection_id, (int)SQL::SQLErrorCode::InternalError, database_or_error.error().string_literal());
             return;
         }
+        m_database = database_or_error.release_value();
         m_accept_statements = true;
         if (client_connection)
             client_connection->async_connected(m_connection_id, m_database_name);
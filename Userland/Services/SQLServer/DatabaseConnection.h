@@ -7,8 +7,8 @@
 #pragma once
 
 #include <LibCore/Object.h>
-#include <LibSQL/Database.h>
 #include <SQLServer/Forward.h>
+#include <SQLServer/SharedDatabase.h>
 
 namespace SQLServer {
 
@@ -21,14 +21,14 @@ public:
     static RefPtr<DatabaseConnection> connection_for(int connection_id);
     int connection_id() const { return m_connection_id; }
     int client_id() const { return m_client_id; }
-    RefPtr<SQL::Database> database() { return m_database; }
+    RefPtr<SharedDatabase> database() { return m_database; }
     void disconnect();
     int sql_statement(String const& sql);
 
 private:
     DatabaseConnection(String database_name, int client_id);
 
-    RefPtr<SQL::Database> m_database { nullptr };
+    RefPtr<SharedDatabase> m_database { nullptr };
     String m_database_name;
     int m_connection_id;
     int m_client_id;
@@ -9,5 +9,6 @@
 namespace SQLServer {
 class ConnectionFromClient;
 class DatabaseConnection;
+class SharedDatabase;
 class SQLStatement;
 }
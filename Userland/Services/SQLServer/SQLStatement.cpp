@@ -47,8 +47,7 @@ void SQLStatement::report_error(SQL::Result result)
     else
         warnln("Cannot return execution error. Client disconnected");
 
-    m_statement = nullptr;
-    m_result = {};
+    m_rows.clear();
 }
 
 void SQLStatement::execute()
@@ -60,58 +59,81 @@ void SQLStatement::execute()
         return;
     }
 
-    deferred_invoke([this]() mutable {
-        auto parse_result = parse();
-        if (parse_result.is_error()) {
-            report_error(parse_result.release_error());
-            return;
-        }
-
-        VERIFY(!connection()->database().is_null());
-
-        auto execution_result = m_statement->execute(connection()->database().release_nonnull());
-        if (execution_result.is_error()) {
-            report_error(execution_result.release_error());
-            return;
-        }
-
-        auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
-        if (!client_connection) {
-            warnln("Cannot return statement execution results. Client disconnected");
-            return;
-        }
+    auto database = connection()->database();
+    VERIFY(!database.is_null());
+
+    // The copy of the statement text is what makes it safe to hand to the database thread, as the string
+    // it is copied from stays here.
+    database->enqueue<SQL::ResultOr<ExecutionResult>>(
+        [sql = String { m_sql.view() }](SQL::Database& database) {
+            return execute_on(database, sql);
+        },
+        [this, protector = NonnullRefPtr(*this)](SQL::ResultOr<ExecutionResult> result) {
+            did_execute(move(result));
+        });
+}
 
-        m_result = execution_result.release_value();
+SQL::ResultOr<SQLStatement::ExecutionResult> SQLStatement::execute_on(SQL::Database& database, String const& sql)
+{
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+    auto statement = parser.next_statement();
+    if (parser.has_errors())
+        return SQL::Result { SQL::SQLCommand::Unknown, SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_string() };
 
-        if (should_send_result_rows()) {
-            client_connection->async_execution_success(statement_id(), true, 0, 0, 0);
-            m_index = 0;
-            next();
-        } else {
-            client_connection->async_execution_success(statement_id(), false, 0, m_result->size(), 0);
+    auto result = TRY(statement->execute(database));
+
+    // Every statement runs in a transaction of its own.
+    if (auto commit_result = database.commit(); commit_result.is_error())
+        return SQL::Result { result.command(), SQL::SQLErrorCode::InternalError, String::formatted("{}", commit_result.error()) };
+
+    ExecutionResult execution_result { result.command(), result.size(), {} };
+    if (should_send_result_rows(result)) {
+        Vector<Vector<String>> rows;
+        rows.ensure_capacity(result.size());
+        for (auto& result_row : result) {
+            // Values can share their strings with the database's caches, so the strings are copied.
+            Vector<String> row;
+            for (auto& value : result_row.row.to_string_vector())
+                row.append(value.view());
+            rows.append(move(row));
         }
-    });
+        execution_result.rows = move(rows);
+    }
+    return execution_result;
 }
 
-SQL::ResultOr<void> SQLStatement::parse()
+void SQLStatement::did_execute(SQL::ResultOr<ExecutionResult> execution_result)
 {
-    auto parser = SQL::AST::Parser(SQL::AST::Lexer(m_sql));
-    m_statement = parser.next_statement();
+    if (execution_result.is_error()) {
+        report_error(execution_result.release_error());
+        return;
+    }
 
-    if (parser.has_errors())
-        return SQL::Result { SQL::SQLCommand::Unknown, SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_string() };
-    return {};
+    auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return;
+    }
+
+    auto result = execution_result.release_value();
+    if (result.rows.has_value()) {
+        m_rows = result.rows.release_value();
+        client_connection->async_execution_success(statement_id(), true, 0, 0, 0);
+        m_index = 0;
+        next();
+    } else {
+        client_connection->async_execution_success(statement_id(), false, 0, result.size, 0);
+    }
 }
 
-bool SQLStatement::should_send_result_rows() const
+bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result)
 {
-    VERIFY(m_result.has_value());
-
-    if (m_result->is_empty())
+    if (result.is_empty())
         return false;
 
-    switch (m_result->command()) {
+    switch (result.command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
@@ -121,15 +143,14 @@ bool SQLStatement::should_send_result_rows() const
 
 void SQLStatement::next()
 {
-    VERIFY(!m_result->is_empty());
+    VERIFY(!m_rows.is_empty());
     auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
     if (!client_connection) {
         warnln("Cannot yield next result. Client disconnected");
         return;
     }
-    if (m_index < m_result->size()) {
-        auto& tuple = m_result->at(m_index++).row;
-        client_connection->async_next_result(statement_id(), tuple.to_string_vector());
+    if (m_index < m_rows.size()) {
+        client_connection->async_next_result(statement_id(), m_rows[m_index++]);
         deferred_invoke([this]() {
             next();
         });
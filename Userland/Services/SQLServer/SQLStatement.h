@@ -8,8 +8,9 @@
 
 #include <AK/NonnullRefPtr.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 #include <LibCore/Object.h>
-#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
 #include <LibSQL/ResultSet.h>
 #include <SQLServer/DatabaseConnection.h>
@@ -30,17 +31,25 @@ public:
     void execute();
 
 private:
+    // What a statement leaves behind once it ran on the database thread. The rows are converted to strings
+    // there, so that nothing in here refers to the database anymore.
+    struct ExecutionResult {
+        SQL::SQLCommand command { SQL::SQLCommand::Unknown };
+        size_t size { 0 };
+        Optional<Vector<Vector<String>>> rows;
+    };
+
     SQLStatement(DatabaseConnection&, String sql);
-    SQL::ResultOr<void> parse();
-    bool should_send_result_rows() const;
+    static SQL::ResultOr<ExecutionResult> execute_on(SQL::Database&, String const& sql);
+    static bool should_send_result_rows(SQL::ResultSet const&);
+    void did_execute(SQL::ResultOr<ExecutionResult>);
     void next();
     void report_error(SQL::Result);
 
     int m_statement_id;
     String m_sql;
     size_t m_index { 0 };
-    RefPtr<SQL::AST::Statement> m_statement { nullptr };
-    Optional<SQL::ResultSet> m_result {};
+    Vector<Vector<String>> m_rows;
 };
 
 }
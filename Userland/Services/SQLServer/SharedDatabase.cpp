@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <SQLServer/SharedDatabase.h>
+
+namespace SQLServer {
+
+static HashMap<String, SharedDatabase*> s_databases;
+
+ErrorOr<NonnullRefPtr<SharedDatabase>> SharedDatabase::open(String const& name)
+{
+    if (auto database = s_databases.get(name); database.has_value())
+        return NonnullRefPtr(*database.value());
+
+    dbgln_if(SQLSERVER_DEBUG, "SharedDatabase::open(name '{}')", name);
+    auto database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", name));
+    TRY(database->open());
+    return adopt_ref(*new SharedDatabase(name, move(database)));
+}
+
+SharedDatabase::SharedDatabase(String name, NonnullRefPtr<SQL::Database> database)
+    : m_name(move(name))
+    , m_database(move(database))
+{
+    s_databases.set(m_name, this);
+    m_thread = Threading::Thread::construct(
+        [this] {
+            worker_loop();
+            return 0;
+        },
+        "SQL database"sv);
+    m_thread->start();
+}
+
+SharedDatabase::~SharedDatabase()
+{
+    dbgln_if(SQLSERVER_DEBUG, "SharedDatabase::~SharedDatabase(name '{}')", m_name);
+    s_databases.remove(m_name);
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_exiting = true;
+        m_work_available.signal();
+    }
+    (void)m_thread->join();
+}
+
+void SharedDatabase::enqueue_job(Function<void()> job)
+{
+    Threading::MutexLocker locker(m_mutex);
+    m_jobs.enqueue(move(job));
+    m_work_available.signal();
+}
+
+void SharedDatabase::worker_loop()
+{
+    for (;;) {
+        Function<void()> job;
+        {
+            Threading::MutexLocker locker(m_mutex);
+            m_work_available.wait_while([this] { return !m_exiting && m_jobs.is_empty(); });
+            // Pending jobs keep the database alive, so there can't be any left once it's going away.
+            if (m_jobs.is_empty())
+                return;
+            job = m_jobs.dequeue();
+        }
+        job();
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/Queue.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <LibCore/EventLoop.h>
+#include <LibSQL/Database.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace SQLServer {
+
+// A database that is open in the server, shared by all connections to it. Work on the database runs on a
+// thread of its own, one job at a time, so that a long-running statement only holds up the connections
+// using the same database and never the event loop.
+// NOTE: Reference counts aren't atomic, so jobs must not share anything with the main thread. Whatever a job
+//       needs is moved to the database thread with it, and whatever it produces is moved back.
+class SharedDatabase : public RefCounted<SharedDatabase> {
+public:
+    static ErrorOr<NonnullRefPtr<SharedDatabase>> open(String const& name);
+    ~SharedDatabase();
+
+    String const& name() const { return m_name; }
+
+    // Runs work() on the database thread, and then on_complete() with its result on the calling thread's event loop.
+    template<typename Result>
+    void enqueue(Function<Result(SQL::Database&)> work, Function<void(Result)> on_complete)
+    {
+        // The database stays around until every job has completed. This reference is only ever
+        // taken and dropped on the calling thread, as the job just moves it along.
+        Function<void(Result)> complete = [protector = NonnullRefPtr(*this), on_complete = move(on_complete)](Result result) {
+            on_complete(move(result));
+        };
+        enqueue_job([this, work = move(work), complete = move(complete), origin_event_loop = &Core::EventLoop::current()]() mutable {
+            auto result = work(*m_database);
+            origin_event_loop->deferred_invoke([complete = move(complete), result = move(result)]() mutable {
+                complete(move(result));
+            });
+            origin_event_loop->wake();
+        });
+    }
+
+private:
+    SharedDatabase(String name, NonnullRefPtr<SQL::Database>);
+
+    void enqueue_job(Function<void()>);
+    void worker_loop();
+
+    String m_name;
+    NonnullRefPtr<SQL::Database> m_database;
+    RefPtr<Threading::Thread> m_thread;
+    Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_work_available { m_mutex };
+    Queue<Function<void()>> m_jobs;
+    bool m_exiting { false };
+};
+
+}
@@ -14,7 +14,7 @@
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
-    TRY(Core::System::pledge("stdio accept unix rpath wpath cpath"));
+    TRY(Core::System::pledge("stdio accept unix rpath wpath cpath thread"));
 
     if (mkdir("/home/anon/sql", 0700) < 0 && errno != EEXIST) {
         perror("mkdir");
@@ -117,12 +117,22 @@ void Service::activate()
 {
     VERIFY(m_pid < 0);
 
+    m_activated = true;
     if (m_lazy)
         setup_notifier();
     else
         spawn();
 }
 
+bool Service::has_finished_starting() const
+{
+    if (!m_activated)
+        return false;
+    // Clients can connect to the sockets of a server right away, and a kept alive service never finishes, so only
+    // one-shot services hold up the ones after them until they have exited.
+    return m_pid < 0 || m_keep_alive || !m_sockets.is_empty();
+}
+
 void Service::spawn(int socket_fd)
 {
     if (!Core::File::exists(m_executable_path)) {
@@ -245,7 +255,7 @@ void Service::did_exit(int exit_code)
     VERIFY(m_pid > 0);
     VERIFY(!m_multi_instance);
 
-    dbgln("Service {} has exited with exit code {}", name(), exit_code);
+    dbgln("Service {} has exited with exit code {} after {} ms", name(), exit_code, m_run_timer.elapsed());
 
     s_service_map.remove(m_pid);
     m_pid = -1;
@@ -311,6 +321,8 @@ Service::Service(Core::ConfigFile const& config, StringView name)
     m_system_modes = config.read_entry(name, "SystemModes", "graphical").split(',');
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
+    m_after = config.read_entry(name, "After").split(',');
+    m_required_services = config.read_entry(name, "Requires").split(',');
 
     String socket_entry = config.read_entry(name, "Socket");
     String socket_permissions_entry = config.read_entry(name, "SocketPermissions", "0600");
@@ -22,6 +22,11 @@ public:
 
     bool is_enabled() const;
     void activate();
+    bool is_activated() const { return m_activated; }
+    // Whether the services that are ordered after this one can be activated yet.
+    bool has_finished_starting() const;
+    Vector<String> const& after() const { return m_after; }
+    Vector<String> const& required_services() const { return m_required_services; }
     void did_exit(int exit_code);
 
     static Service* find_by_pid(pid_t);
@@ -74,6 +79,10 @@ private:
     Vector<String> m_environment;
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
+    // Services that have to finish starting before this one gets activated.
+    Vector<String> m_after;
+    // Services that have to be enabled for this one to be enabled.
+    Vector<String> m_required_services;
 
     // The resolved user account to run this service as.
     Optional<Core::Account> m_account;
@@ -81,6 +90,7 @@ private:
     // For single-instance services, PID of the running instance of this service.
     pid_t m_pid { -1 };
     RefPtr<Core::Notifier> m_socket_notifier;
+    bool m_activated { false };
 
     // Timer since we last spawned the service.
     Core::ElapsedTimer m_run_timer;
@@ -13,6 +13,7 @@
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/DirIterator.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
@@ -32,6 +33,17 @@
 String g_system_mode = "graphical";
 NonnullRefPtrVector<Service> g_services;
 
+static Core::ElapsedTimer s_boot_timer;
+static Vector<Service*> s_services_to_activate;
+
+struct ActivationTime {
+    String service_name;
+    i64 milliseconds_into_boot;
+};
+static Vector<ActivationTime> s_activation_times;
+
+static void activate_services_that_are_ready();
+
 // NOTE: This handler ensures that the destructor of g_services is called.
 static void sigterm_handler(int)
 {
@@ -60,6 +72,7 @@ static void sigchld_handler(int)
 
         service->did_exit(status);
     }
+    activate_services_that_are_ready();
 }
 
 static ErrorOr<void> determine_system_mode()
@@ -267,6 +280,10 @@ static void populate_devtmpfs_devices_based_on_devctl()
                     create_devtmpfs_char_device("/dev/random", 0666, 1, 8);
                     break;
                 }
+                case 9: {
+                    create_devtmpfs_char_device("/dev/memorypressure", 0444, 1, 9);
+                    break;
+                }
                 default:
                     warnln("Unknown character device {}:{}", major_number, minor_number);
                     break;
@@ -467,8 +484,103 @@ static ErrorOr<void> create_tmp_semaphore_directory()
     return {};
 }
 
+static Service* find_service(StringView name)
+{
+    for (auto& service : g_services) {
+        if (service.name() == name)
+            return &service;
+    }
+    return nullptr;
+}
+
+static bool is_ready_to_activate(Service const& service)
+{
+    for (auto& name : service.after()) {
+        // Services that aren't enabled in this system mode don't hold anything up.
+        auto* dependency = find_service(name);
+        if (dependency && !dependency->has_finished_starting())
+            return false;
+    }
+    return true;
+}
+
+static bool is_waiting_for_a_running_service()
+{
+    for (auto* service : s_services_to_activate) {
+        for (auto& name : service->after()) {
+            auto* dependency = find_service(name);
+            if (dependency && dependency->is_activated() && !dependency->has_finished_starting())
+                return true;
+        }
+    }
+    return false;
+}
+
+static void activate_services_that_are_ready()
+{
+    if (s_services_to_activate.is_empty())
+        return;
+
+    // Services that don't spawn a process right away are done starting as soon as they are activated, so keep going
+    // until nothing else becomes ready.
+    bool activated_any;
+    do {
+        activated_any = false;
+        for (size_t i = 0; i < s_services_to_activate.size();) {
+            auto& service = *s_services_to_activate[i];
+            if (!is_ready_to_activate(service)) {
+                ++i;
+                continue;
+            }
+            s_services_to_activate.remove(i);
+            service.activate();
+            s_activation_times.append({ service.name(), s_boot_timer.elapsed() });
+            activated_any = true;
+        }
+    } while (activated_any);
+
+    if (!s_services_to_activate.is_empty() && !is_waiting_for_a_running_service()) {
+        // Nothing that is still running can make the rest ready, so their After= entries go around in a circle.
+        for (auto* service : s_services_to_activate) {
+            dbgln("Service {} is ordered after a service that is ordered after it, activating it anyway", service->name());
+            service->activate();
+            s_activation_times.append({ service->name(), s_boot_timer.elapsed() });
+        }
+        s_services_to_activate.clear();
+    }
+
+    if (s_services_to_activate.is_empty()) {
+        dbgln("Activated {} services in {} ms:", s_activation_times.size(), s_boot_timer.elapsed());
+        for (auto& activation_time : s_activation_times)
+            dbgln("    {} at {} ms", activation_time.service_name, activation_time.milliseconds_into_boot);
+        s_activation_times.clear();
+    }
+}
+
+static void remove_services_with_missing_requirements()
+{
+    // Removing a service can take away a requirement of another one, so keep going until nothing changes.
+    bool removed_any;
+    do {
+        removed_any = false;
+        for (size_t i = 0; i < g_services.size();) {
+            auto& service = g_services[i];
+            auto missing_requirement = service.required_services().first_matching([](auto& name) { return !find_service(name); });
+            if (!missing_requirement.has_value()) {
+                ++i;
+                continue;
+            }
+            dbgln("Service {} requires {}, which isn't enabled, skipping service.", service.name(), *missing_requirement);
+            g_services.remove(i);
+            removed_any = true;
+        }
+    } while (removed_any);
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
+    s_boot_timer.start();
+
     bool user = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(user, "Run in user-mode", "user", 'u');
@@ -503,10 +615,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             g_services.append(move(service));
     }
 
-    // After we've set them all up, activate them!
+    remove_services_with_missing_requirements();
+
+    // After we've set them all up, activate them! Services only wait for the ones they are ordered after,
+    // everything else is spawned right away.
     dbgln("Activating {} services...", g_services.size());
     for (auto& service : g_services)
-        service.activate();
+        s_services_to_activate.append(&service);
+    activate_services_that_are_ready();
 
     return event_loop.exec();
 }
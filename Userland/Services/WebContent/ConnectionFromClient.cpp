@@ -77,10 +77,8 @@ void ConnectionFromClient::update_screen_rects(Vector<Gfx::IntRect> const& rects
     m_page_host->set_screen_rects(rects, main_screen);
 }
 
-void ConnectionFromClient::load_url(const URL& url)
+static void set_process_name_for_url(const URL& url)
 {
-    dbgln_if(SPAM_DEBUG, "handle: WebContentServer::LoadURL: url={}", url);
-
     String process_name;
     if (url.host().is_empty())
         process_name = "WebContent";
@@ -88,10 +86,22 @@ void ConnectionFromClient::load_url(const URL& url)
         process_name = String::formatted("WebContent: {}", url.host());
 
     pthread_setname_np(pthread_self(), process_name.characters());
+}
 
+void ConnectionFromClient::load_url(const URL& url)
+{
+    dbgln_if(SPAM_DEBUG, "handle: WebContentServer::LoadURL: url={}", url);
+    set_process_name_for_url(url);
     page().load(url);
 }
 
+void ConnectionFromClient::load_url_from_history(const URL& url)
+{
+    dbgln_if(SPAM_DEBUG, "handle: WebContentServer::LoadURLFromHistory: url={}", url);
+    set_process_name_for_url(url);
+    page().load_from_history(url);
+}
+
 void ConnectionFromClient::load_html(String const& html, const URL& url)
 {
     dbgln_if(SPAM_DEBUG, "handle: WebContentServer::LoadHTML: html={}, url={}", html, url);
@@ -6,6 +6,7 @@
 
 #include "PageHost.h"
 #include "ConnectionFromClient.h"
+#include <AK/AnyOf.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/ShareableBitmap.h>
 #include <LibGfx/SystemTheme.h>
@@ -30,6 +31,8 @@ PageHost::PageHost(ConnectionFromClient& client)
 
 void PageHost::set_has_focus(bool has_focus)
 {
+    if (m_has_focus != has_focus)
+        invalidate_all_tiles();
     m_has_focus = has_focus;
 }
 
@@ -53,6 +56,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 {
     m_palette_impl = impl;
+    invalidate_all_tiles();
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -60,6 +64,7 @@ void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 void PageHost::set_preferred_color_scheme(Web::CSS::PreferredColorScheme color_scheme)
 {
     m_preferred_color_scheme = color_scheme;
+    invalidate_all_tiles();
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -77,6 +82,11 @@ Web::Layout::InitialContainingBlock* PageHost::layout_root()
     return document->layout_node();
 }
 
+static int floor_div(int a, int b)
+{
+    return a / b - (a % b < 0 ? 1 : 0);
+}
+
 void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
 {
     Gfx::Painter painter(target);
@@ -91,20 +101,73 @@ void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
         return;
     }
 
+    auto first_column = floor_div(content_rect.left(), tile_size);
+    auto last_column = floor_div(content_rect.right(), tile_size);
+    auto first_row = floor_div(content_rect.top(), tile_size);
+    auto last_row = floor_div(content_rect.bottom(), tile_size);
+
+    for (auto row = first_row; row <= last_row; ++row) {
+        for (auto column = first_column; column <= last_column; ++column) {
+            Gfx::IntRect tile_rect { column * tile_size, row * tile_size, tile_size, tile_size };
+            auto tile = ensure_tile(tile_rect, content_rect);
+            if (!tile)
+                continue;
+            painter.blit(tile_rect.location() - content_rect.location(), *tile, tile->rect());
+        }
+    }
+}
+
+RefPtr<Gfx::Bitmap> PageHost::ensure_tile(Gfx::IntRect const& tile_rect, Gfx::IntRect const& content_rect)
+{
+    if (auto it = m_tiles.find(tile_rect.location()); it != m_tiles.end())
+        return it->value;
+
+    auto tile_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, tile_rect.size());
+    if (tile_or_error.is_error())
+        return nullptr;
+    auto tile = tile_or_error.release_value();
+
+    Gfx::Painter painter(tile);
+    painter.fill_rect(tile->rect(), palette().base());
+
+    // NOTE: The page is painted relative to the viewport, so we shift it into place for this tile.
+    painter.translate(content_rect.location() - tile_rect.location());
+
     Web::PaintContext context(painter, palette(), content_rect.top_left());
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_viewport_rect(content_rect);
     context.set_has_focus(m_has_focus);
-    layout_root->paint_all_phases(context);
+    layout_root()->paint_all_phases(context);
+
+    // NOTE: We only hear about changes to the visible part of the page, so we can't keep tiles that are partially hidden.
+    if (content_rect.contains(tile_rect))
+        m_tiles.set(tile_rect.location(), tile);
+    return tile;
+}
+
+void PageHost::invalidate_tiles(Gfx::IntRect const& content_rect)
+{
+    m_tiles.remove_all_matching([&](auto const& location, auto const&) {
+        return content_rect.intersects({ location, { tile_size, tile_size } });
+    });
 }
 
 void PageHost::set_viewport_rect(Gfx::IntRect const& rect)
 {
-    page().top_level_browsing_context().set_viewport_rect(rect);
+    auto& browsing_context = page().top_level_browsing_context();
+    if (m_has_fixed_position_content && rect.location() != browsing_context.viewport_rect().location())
+        invalidate_all_tiles();
+
+    m_tiles.remove_all_matching([&](auto const& location, auto const&) {
+        return !rect.contains(Gfx::IntRect { location, { tile_size, tile_size } });
+    });
+
+    browsing_context.set_viewport_rect(rect);
 }
 
 void PageHost::page_did_invalidate(Gfx::IntRect const& content_rect)
 {
+    invalidate_tiles(content_rect);
     m_invalidation_rect = m_invalidation_rect.united(content_rect);
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
@@ -124,6 +187,19 @@ void PageHost::page_did_layout()
 {
     auto* layout_root = this->layout_root();
     VERIFY(layout_root);
+
+    invalidate_all_tiles();
+    m_has_fixed_position_content = false;
+    // NOTE: Fixed-position boxes and fixed backgrounds move along with the viewport, so the tiles they're in change when scrolling.
+    layout_root->for_each_in_subtree([&](auto const& layout_node) {
+        bool has_fixed_background = layout_node.has_style() && any_of(layout_node.computed_values().background_layers(), [](auto const& layer) { return layer.attachment == Web::CSS::BackgroundAttachment::Fixed; });
+        if (layout_node.is_fixed_position() || has_fixed_background) {
+            m_has_fixed_position_content = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+
     Gfx::IntSize content_size;
     if (layout_root->paint_box()->has_overflow())
         content_size = enclosing_int_rect(layout_root->paint_box()->scrollable_overflow_rect().value()).size();
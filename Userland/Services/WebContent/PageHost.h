@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
+#include <LibGfx/Bitmap.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
 
@@ -31,7 +33,11 @@ public:
     void set_screen_rects(Vector<Gfx::IntRect, 4> const& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index]; };
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool b)
+    {
+        m_should_show_line_box_borders = b;
+        invalidate_all_tiles();
+    }
     void set_has_focus(bool);
     void set_is_scripting_enabled(bool);
 
@@ -73,6 +79,10 @@ private:
     Web::Layout::InitialContainingBlock* layout_root();
     void setup_palette();
 
+    RefPtr<Gfx::Bitmap> ensure_tile(Gfx::IntRect const& tile_rect, Gfx::IntRect const& content_rect);
+    void invalidate_tiles(Gfx::IntRect const& content_rect);
+    void invalidate_all_tiles() { m_tiles.clear(); }
+
     ConnectionFromClient& m_client;
     NonnullOwnPtr<Web::Page> m_page;
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
@@ -80,6 +90,12 @@ private:
     bool m_should_show_line_box_borders { false };
     bool m_has_focus { false };
 
+    // The page is painted in tiles, which we hold on to for as long as they are fully visible and nothing in them changes.
+    // This way, scrolling and small invalidations only need to paint the tiles that are new or have changed.
+    static constexpr int tile_size = 256;
+    HashMap<Gfx::IntPoint, NonnullRefPtr<Gfx::Bitmap>> m_tiles;
+    bool m_has_fixed_position_content { false };
+
     RefPtr<Core::Timer> m_invalidation_coalescing_timer;
     Gfx::IntRect m_invalidation_rect;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
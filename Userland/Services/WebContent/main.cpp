@@ -6,9 +6,14 @@
 
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/MemoryPressureNotifier.h>
 #include <LibCore/System.h>
 #include <LibIPC/SingleServer.h>
+#include <LibJS/Script.h>
 #include <LibMain/Main.h>
+#include <LibWeb/Bindings/MainThreadVM.h>
+#include <LibWeb/CSS/Parser/StyleSheetCache.h>
+#include <LibWeb/HTML/BackForwardCache.h>
 #include <LibWeb/ImageDecoding.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/WebSockets/WebSocket.h>
@@ -21,6 +26,23 @@ ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
     TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath"));
+
+    // Cached resources can be loaded again and garbage can be collected early, which is better than running out of memory.
+    auto memory_pressure_notifier_or_error = Core::MemoryPressureNotifier::create();
+    if (memory_pressure_notifier_or_error.is_error()) {
+        dbgln("Unable to listen for memory pressure: {}", memory_pressure_notifier_or_error.error());
+    } else {
+        memory_pressure_notifier_or_error.value()->on_change = [](auto level) {
+            if (level == Core::MemoryPressureLevel::Normal)
+                return;
+            Web::ResourceLoader::the().clear_cache();
+            Web::CSS::Parser::StyleSheetCache::the().clear();
+            JS::Script::clear_cache();
+            Web::HTML::BackForwardCache::clear_all();
+            Web::Bindings::main_thread_vm().heap().collect_garbage(JS::Heap::CollectionType::CollectGarbage);
+        };
+    }
+
     TRY(Core::System::unveil("/res", "r"));
     TRY(Core::System::unveil("/etc/timezone", "r"));
     TRY(Core::System::unveil("/tmp/user/%uid/portal/request", "rw"));
@@ -15,9 +15,9 @@
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
-#include <LibCore/FileStream.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
+#include <LibCore/System.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
@@ -163,13 +163,11 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         return false;
     }
 
-    Core::InputFileStream stream { file };
-
-    TRY(send_response(stream, request, { .type = Core::guess_mime_type_based_on_filename(real_path), .length = TRY(Core::File::size(real_path)) }));
+    TRY(send_file_response(file->fd(), request, { .type = Core::guess_mime_type_based_on_filename(real_path), .length = TRY(Core::File::size(real_path)) }));
     return true;
 }
 
-ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response_header(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
     builder.append("HTTP/1.0 200 OK\r\n"sv);
@@ -187,6 +185,41 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
     auto builder_contents = builder.to_byte_buffer();
     TRY(m_socket->write(builder_contents));
     log_response(200, request);
+    return {};
+}
+
+ErrorOr<void> Client::send_file_response(int fd, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_header(request, content_info));
+
+    // Let the kernel move the file contents to the socket, so they don't have to be copied through our buffers.
+    size_t remaining = content_info.length;
+    while (remaining > 0) {
+#ifdef __serenity__
+        auto nsent = TRY(Core::System::sendfile(m_socket->fd(), fd, nullptr, remaining));
+#else
+        // NOTE: sendfile() is a Serenity syscall, so elsewhere the file has to go through a buffer of ours after all.
+        char buffer[PAGE_SIZE];
+        auto nread = ::read(fd, buffer, min(remaining, sizeof(buffer)));
+        if (nread < 0)
+            return Error::from_errno(errno);
+        auto nsent = static_cast<size_t>(nread);
+        for (ReadonlyBytes write_buffer { buffer, nsent }; !write_buffer.is_empty();)
+            write_buffer = write_buffer.slice(TRY(m_socket->write(write_buffer)));
+#endif
+        // The file was truncated underneath us, there's nothing more we can send.
+        if (nsent == 0)
+            break;
+        remaining -= nsent;
+    }
+
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_header(request, content_info));
 
     char buffer[PAGE_SIZE];
     do {
@@ -206,6 +239,12 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
         }
     } while (true);
 
+    finish_response(request);
+    return {};
+}
+
+void Client::finish_response(HTTP::HttpRequest const& request)
+{
     auto keep_alive = false;
     if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"sv); }); !it.is_end()) {
         if (it->value.trim_whitespace().equals_ignoring_case("keep-alive"sv))
@@ -213,8 +252,6 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
     }
     if (!keep_alive)
         m_socket->close();
-
-    return {};
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
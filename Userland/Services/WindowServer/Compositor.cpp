@@ -6,6 +6,7 @@
 
 #include "Compositor.h"
 #include "Animation.h"
+#include "CompositorThreadPool.h"
 #include "ConnectionFromClient.h"
 #include "Event.h"
 #include "EventLoop.h"
@@ -64,9 +65,15 @@ Compositor::Compositor()
         },
         this);
 
+    // The compositing thread does its share of the painting too, and the rest of the system still needs to get some work done.
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    m_thread_pool = make<CompositorThreadPool>(clamp<long>(processor_count - 1, 0, 3));
+
     init_bitmaps();
 }
 
+Compositor::~Compositor() = default;
+
 Gfx::Bitmap const* Compositor::cursor_bitmap_for_screenshot(Badge<ConnectionFromClient>, Screen& screen) const
 {
     if (!m_current_cursor)
@@ -192,13 +199,17 @@ void Compositor::compose()
         auto transition_offset = window_transition_offset(window);
         auto frame_rect = window.frame().render_rect();
         auto frame_rect_on_screen = frame_rect.translated(transition_offset);
+        // Nothing of a window hidden behind opaque windows gets rendered, so there's no point in tracking its damage.
+        bool is_occluded = window.opaque_rects().is_empty() && window.transparency_rects().is_empty();
         for (auto& dirty_rect : dirty_screen_rects.rects()) {
             auto invalidate_rect = dirty_rect.intersected(frame_rect_on_screen);
             if (!invalidate_rect.is_empty()) {
+                m_invalidated_window = true;
+                if (is_occluded)
+                    break;
                 auto inner_rect_offset = window.rect().location() - frame_rect.location();
                 invalidate_rect.translate_by(-(frame_rect.location() + inner_rect_offset + transition_offset));
                 window.invalidate_no_notify(invalidate_rect);
-                m_invalidated_window = true;
             }
         }
         window.prepare_dirty_rects();
@@ -335,8 +346,9 @@ void Compositor::compose()
                 if (!screen_render_rect.is_empty()) {
                     dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {} on screen #{}", screen_render_rect, screen.index());
                     prepare_rect(screen, render_rect);
-                    auto& back_painter = *screen.compositor_screen_data().m_back_painter;
-                    paint_wallpaper(screen, back_painter, render_rect, screen_rect);
+                    defer_back_buffer_paint(screen, render_rect, m_wallpaper, [&paint_wallpaper, &screen, render_rect, screen_rect](Gfx::Painter& painter) {
+                        paint_wallpaper(screen, painter, render_rect, screen_rect);
+                    });
                 }
                 return IterationDecision::Continue;
             });
@@ -371,7 +383,7 @@ void Compositor::compose()
         dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
 
         RefPtr<Gfx::Bitmap> backing_store = window.backing_store();
-        auto compose_window_rect = [&](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect) {
+        auto compose_window_rect = [&](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect, bool is_back_buffer) {
             if (!window.is_fullscreen()) {
                 rect.for_each_intersected(frame_rects, [&](const Gfx::IntRect& intersected_rect) {
                     Gfx::PainterStateSaver saver(painter);
@@ -448,6 +460,11 @@ void Compositor::compose()
                             return color;
                         });
                     }
+                } else if (is_back_buffer) {
+                    // This is where most of the pixels of a frame come from, so do them all in one go at the end.
+                    defer_back_buffer_paint(screen, { dst, dirty_rect_in_backing_coordinates.size() }, backing_store, [dst, &bitmap = *backing_store, src_rect = dirty_rect_in_backing_coordinates, opacity = window.opacity()](Gfx::Painter& painter) {
+                        painter.blit(dst, bitmap, src_rect, opacity);
+                    });
                 } else {
                     painter.blit(dst, *backing_store, dirty_rect_in_backing_coordinates, window.opacity());
                 }
@@ -482,7 +499,7 @@ void Compositor::compose()
                     auto& back_painter = *screen->compositor_screen_data().m_back_painter;
                     Gfx::PainterStateSaver saver(back_painter);
                     back_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, back_painter, screen_render_rect);
+                    compose_window_rect(*screen, back_painter, screen_render_rect, true);
                 }
                 return IterationDecision::Continue;
             });
@@ -521,7 +538,7 @@ void Compositor::compose()
                     auto& temp_painter = *screen->compositor_screen_data().m_temp_painter;
                     Gfx::PainterStateSaver saver(temp_painter);
                     temp_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, temp_painter, screen_render_rect);
+                    compose_window_rect(*screen, temp_painter, screen_render_rect, false);
                 }
                 return IterationDecision::Continue;
             });
@@ -573,12 +590,18 @@ void Compositor::compose()
         Screen::for_each([&](auto& screen) {
             auto screen_rect = screen.rect();
             auto& screen_data = screen.compositor_screen_data();
-            for (auto& rect : screen_data.m_flush_transparent_rects.rects())
-                screen_data.m_back_painter->blit(rect.location(), *screen_data.m_temp_bitmap, rect.translated(-screen_rect.location()));
+            for (auto& rect : screen_data.m_flush_transparent_rects.rects()) {
+                defer_back_buffer_paint(screen, rect, screen_data.m_temp_bitmap, [&temp_bitmap = *screen_data.m_temp_bitmap, rect, screen_rect](Gfx::Painter& painter) {
+                    painter.blit(rect.location(), temp_bitmap, rect.translated(-screen_rect.location()));
+                });
+            }
             return IterationDecision::Continue;
         });
     }
 
+    // All of the deferred painting is to disjoint areas (the flush rects), so it can happen in any order.
+    run_deferred_paints();
+
     m_invalidated_any = false;
     m_invalidated_window = false;
     m_invalidated_cursor = false;
@@ -607,6 +630,53 @@ void Compositor::compose()
     });
 }
 
+void Compositor::defer_back_buffer_paint(Screen& screen, Gfx::IntRect const& rect, RefPtr<Gfx::Bitmap> source, Function<void(Gfx::Painter&)> paint)
+{
+    auto& screen_data = screen.compositor_screen_data();
+    auto screen_rect = screen.rect();
+    auto clip_rect = rect.intersected(screen_rect);
+    if (clip_rect.is_empty())
+        return;
+
+    // Cut big areas into bands, so that a single window update can be spread over all threads too.
+    // Everything Painter does honors the clip rect, so this doesn't change a single pixel.
+    static constexpr int minimum_band_height = 32;
+    static constexpr int minimum_band_pixel_count = 64 * 1024;
+    auto band_count = min((size_t)clip_rect.height() / minimum_band_height, (size_t)(clip_rect.width() * clip_rect.height()) / minimum_band_pixel_count);
+    band_count = clamp<size_t>(band_count, 1, m_thread_pool->thread_count() + 1);
+
+    DeferredPaint deferred_paint { move(paint), {}, move(source) };
+    int band_top = clip_rect.top();
+    for (size_t i = 0; i < band_count; ++i) {
+        int band_bottom = clip_rect.top() + (int)((i + 1) * clip_rect.height() / band_count);
+        auto painter = make<Gfx::Painter>(*screen_data.m_back_bitmap);
+        painter->translate(-screen_rect.location());
+        painter->add_clip_rect({ clip_rect.left(), band_top, clip_rect.width(), band_bottom - band_top });
+        deferred_paint.band_painters.append(move(painter));
+        band_top = band_bottom;
+    }
+    m_deferred_paints.append(move(deferred_paint));
+}
+
+void Compositor::run_deferred_paints()
+{
+    if (m_deferred_paints.is_empty())
+        return;
+
+    for (auto& deferred_paint : m_deferred_paints) {
+        for (auto& painter : deferred_paint.band_painters) {
+            m_deferred_paint_jobs.append([&paint = deferred_paint.paint, &painter = *painter] {
+                paint(painter);
+            });
+        }
+    }
+    m_thread_pool->run(m_deferred_paint_jobs);
+
+    // The painters and bitmaps are reference counted, so they have to go away on this thread.
+    m_deferred_paint_jobs.clear_with_capacity();
+    m_deferred_paints.clear_with_capacity();
+}
+
 void Compositor::flush(Screen& screen)
 {
     auto& screen_data = screen.compositor_screen_data();
@@ -19,6 +19,7 @@ namespace WindowServer {
 class Animation;
 class ConnectionFromClient;
 class Compositor;
+class CompositorThreadPool;
 class Cursor;
 class MultiScaleBitmaps;
 class Window;
@@ -92,6 +93,7 @@ class Compositor final : public Core::Object {
 
 public:
     static Compositor& the();
+    virtual ~Compositor() override;
 
     void compose();
     void invalidate_window();
@@ -212,6 +214,18 @@ private:
     void start_window_stack_switch_overlay_timer();
     void finish_window_stack_switch();
 
+    // Painting into the back buffer that doesn't depend on anything else being painted first,
+    // so it can be done in parallel once the rest of the frame has been composed.
+    // Large areas are split into bands, each with a painter clipped to it.
+    struct DeferredPaint {
+        Function<void(Gfx::Painter&)> paint;
+        Vector<NonnullOwnPtr<Gfx::Painter>> band_painters;
+        // Keeps the bitmap being painted from alive, as it can't be ref'd from the other threads.
+        RefPtr<Gfx::Bitmap> source;
+    };
+    void defer_back_buffer_paint(Screen&, Gfx::IntRect const&, RefPtr<Gfx::Bitmap> source, Function<void(Gfx::Painter&)>);
+    void run_deferred_paints();
+
     RefPtr<Core::Timer> m_compose_timer;
     RefPtr<Core::Timer> m_immediate_compose_timer;
     bool m_flash_flush { false };
@@ -247,6 +261,10 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    OwnPtr<CompositorThreadPool> m_thread_pool;
+    Vector<DeferredPaint> m_deferred_paints;
+    Vector<Function<void()>> m_deferred_paint_jobs;
 };
 
 }
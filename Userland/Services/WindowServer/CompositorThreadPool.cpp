@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "CompositorThreadPool.h"
+
+namespace WindowServer {
+
+CompositorThreadPool::CompositorThreadPool(size_t thread_count)
+{
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = Threading::Thread::construct(
+            [this] {
+                worker_loop();
+                return 0;
+            },
+            "Compositor"sv);
+        thread->start();
+        m_threads.append(move(thread));
+        ++m_running_threads;
+    }
+}
+
+CompositorThreadPool::~CompositorThreadPool()
+{
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_exiting = true;
+        m_work_available.broadcast();
+        m_work_finished.wait_while([this] { return m_running_threads > 0; });
+    }
+    for (auto& thread : m_threads)
+        (void)thread.join();
+}
+
+void CompositorThreadPool::run_jobs(Vector<Function<void()>>& jobs)
+{
+    for (;;) {
+        auto index = m_next_job.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        if (index >= jobs.size())
+            return;
+        jobs[index]();
+    }
+}
+
+void CompositorThreadPool::run(Vector<Function<void()>>& jobs)
+{
+    if (jobs.size() <= 1 || m_threads.is_empty()) {
+        for (auto& job : jobs)
+            job();
+        return;
+    }
+
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_jobs = &jobs;
+        m_next_job = 0;
+        ++m_generation;
+        m_work_available.broadcast();
+    }
+
+    run_jobs(jobs);
+
+    Threading::MutexLocker locker(m_mutex);
+    m_work_finished.wait_while([this] { return m_busy_threads > 0; });
+    // Any thread waking up from here on is too late to pick up a job, and must not look at the batch anymore.
+    m_jobs = nullptr;
+}
+
+void CompositorThreadPool::worker_loop()
+{
+    u64 seen_generation = 0;
+    for (;;) {
+        Vector<Function<void()>>* jobs = nullptr;
+        {
+            Threading::MutexLocker locker(m_mutex);
+            m_work_available.wait_while([&] { return !m_exiting && m_generation == seen_generation; });
+            if (m_exiting) {
+                if (--m_running_threads == 0)
+                    m_work_finished.signal();
+                return;
+            }
+            seen_generation = m_generation;
+            if (!m_jobs)
+                continue;
+            jobs = m_jobs;
+            ++m_busy_threads;
+        }
+
+        run_jobs(*jobs);
+
+        Threading::MutexLocker locker(m_mutex);
+        if (--m_busy_threads == 0)
+            m_work_finished.signal();
+    }
+}
+
+}
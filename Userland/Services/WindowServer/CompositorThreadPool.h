@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace WindowServer {
+
+// A small set of threads that the compositor hands batches of independent painting jobs to.
+// The thread calling run() works on the batch too, and it only returns once every job has finished.
+class CompositorThreadPool {
+    AK_MAKE_NONCOPYABLE(CompositorThreadPool);
+    AK_MAKE_NONMOVABLE(CompositorThreadPool);
+
+public:
+    explicit CompositorThreadPool(size_t thread_count);
+    ~CompositorThreadPool();
+
+    size_t thread_count() const { return m_threads.size(); }
+
+    // NOTE: Jobs must not touch anything that is reference counted, as those counts aren't atomic.
+    //       They are created and destroyed by the caller, only run() calls them.
+    void run(Vector<Function<void()>>& jobs);
+
+private:
+    void worker_loop();
+    void run_jobs(Vector<Function<void()>>& jobs);
+
+    NonnullRefPtrVector<Threading::Thread> m_threads;
+    Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_work_available { m_mutex };
+    Threading::ConditionVariable m_work_finished { m_mutex };
+    Vector<Function<void()>>* m_jobs { nullptr };
+    Atomic<size_t> m_next_job { 0 };
+    u64 m_generation { 0 };
+    size_t m_busy_threads { 0 };
+    size_t m_running_threads { 0 };
+    bool m_exiting { false };
+};
+
+}
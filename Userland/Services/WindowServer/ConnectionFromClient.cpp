@@ -716,9 +716,7 @@ void ConnectionFromClient::set_window_backing_store(i32 window_id, [[maybe_unuse
         return;
     }
     auto& window = *(*it).value;
-    if (window.last_backing_store() && window.last_backing_store_serial() == serial) {
-        window.swap_backing_stores();
-    } else {
+    if (!window.switch_to_previous_backing_store(serial)) {
         // FIXME: Plumb scale factor here eventually.
         auto buffer_or_error = Core::AnonymousBuffer::create_from_anon_fd(anon_file.take_fd(), pitch * size.height());
         if (buffer_or_error.is_error()) {
@@ -732,13 +730,17 @@ void ConnectionFromClient::set_window_backing_store(i32 window_id, [[maybe_unuse
             1,
             {});
         if (backing_store_or_error.is_error()) {
-            did_misbehave("");
+            did_misbehave("SetWindowBackingStore: Failed to create bitmap for window backing store");
+            return;
         }
         window.set_backing_store(backing_store_or_error.release_value(), serial);
     }
 
     if (flush_immediately)
         window.invalidate(false);
+
+    // We won't read from any of the client's other backing stores anymore, so it can paint into them.
+    async_did_switch_backing_store(window_id, serial);
 }
 
 void ConnectionFromClient::set_global_mouse_tracking(bool enabled)
@@ -135,6 +135,34 @@ void Window::set_title(String const& title)
     WindowManager::the().notify_title_changed(*this);
 }
 
+void Window::set_backing_store(RefPtr<Gfx::Bitmap> backing_store, i32 serial)
+{
+    if (m_backing_store) {
+        if (m_previous_backing_stores.size() == max_previous_backing_stores)
+            m_previous_backing_stores.take_first();
+        m_previous_backing_stores.append({ m_backing_store.release_nonnull(), m_backing_store_serial });
+    }
+    m_backing_store = move(backing_store);
+    m_backing_store_serial = serial;
+
+    // The client won't switch back to stores of a different size, so don't keep them alive.
+    m_previous_backing_stores.remove_all_matching([&](auto& previous) {
+        return !m_backing_store || previous.bitmap->size() != m_backing_store->size();
+    });
+}
+
+bool Window::switch_to_previous_backing_store(i32 serial)
+{
+    for (size_t i = 0; i < m_previous_backing_stores.size(); ++i) {
+        if (m_previous_backing_stores[i].serial != serial)
+            continue;
+        auto previous = m_previous_backing_stores.take(i);
+        set_backing_store(move(previous.bitmap), previous.serial);
+        return true;
+    }
+    return false;
+}
+
 void Window::set_rect(Gfx::IntRect const& rect)
 {
     if (m_rect == rect)
@@ -632,13 +660,10 @@ void Window::prepare_dirty_rects()
             m_dirty_rects = rect();
     } else {
         m_dirty_rects.move_by(frame().render_rect().location());
+        // Even if parts of the contents were invalidated as well, only those need to be rendered again along with the frame.
         if (m_invalidated_frame) {
-            if (m_invalidated) {
-                m_dirty_rects.add(frame().render_rect());
-            } else {
-                for (auto& rects : frame().render_rect().shatter(rect()))
-                    m_dirty_rects.add(rects);
-            }
+            for (auto& rects : frame().render_rect().shatter(rect()))
+                m_dirty_rects.add(rects);
         }
     }
 }
@@ -27,6 +27,7 @@
 #include <LibCore/System.h>
 #include <LibCore/Timer.h>
 #include <LibLine/Editor.h>
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
@@ -242,53 +243,64 @@ Vector<String> Shell::expand_globs(StringView path, StringView base)
     return results;
 }
 
-Vector<String> Shell::expand_globs(Vector<StringView> path_segments, StringView base)
+static void expand_glob_segments(Span<StringView const> path_segments, String const& base, bool base_exists, Vector<String>& results)
 {
     if (path_segments.is_empty()) {
-        String base_str = base;
         struct stat statbuf;
-        if (lstat(base_str.characters(), &statbuf) < 0)
-            return {};
-        return { move(base_str) };
+        if (!base_exists && lstat(base.characters(), &statbuf) < 0)
+            return;
+        results.append(base);
+        return;
     }
 
-    auto first_segment = path_segments.take_first();
-    if (is_glob(first_segment)) {
-        Vector<String> result;
+    auto first_segment = path_segments[0];
+    auto remaining_segments = path_segments.slice(1);
 
-        Core::DirIterator di(base, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error())
-            return {};
+    StringBuilder builder;
+    builder.append(base);
+    if (!base.ends_with('/'))
+        builder.append('/');
 
-        while (di.has_next()) {
-            String path = di.next_path();
+    if (!Shell::is_glob(first_segment)) {
+        builder.append(first_segment);
+        expand_glob_segments(remaining_segments, builder.to_string(), false, results);
+        return;
+    }
 
-            // Dotfiles have to be explicitly requested
-            if (path[0] == '.' && first_segment[0] != '.')
-                continue;
+    auto prefix = builder.to_string();
 
-            if (path.matches(first_segment, CaseSensitivity::CaseSensitive)) {
-                StringBuilder builder;
-                builder.append(base);
-                if (!base.ends_with('/'))
-                    builder.append('/');
-                builder.append(path);
-                result.extend(expand_globs(path_segments, builder.string_view()));
-            }
-        }
+    // Note: This reads the directory only once, and trusts it for the existence of whatever matched,
+    //       instead of looking up every single match again.
+    auto* dir = opendir(base.characters());
+    if (!dir)
+        return;
+    ScopeGuard close_dir = [&] { closedir(dir); };
 
-        return result;
-    } else {
-        StringBuilder builder;
-        builder.append(base);
-        if (!base.ends_with('/'))
-            builder.append('/');
-        builder.append(first_segment);
+    while (auto* entry = readdir(dir)) {
+        StringView name { entry->d_name, strlen(entry->d_name) };
+        if (name == "."sv || name == ".."sv)
+            continue;
 
-        return expand_globs(move(path_segments), builder.string_view());
+        // Dotfiles have to be explicitly requested
+        if (name.starts_with('.') && !first_segment.starts_with('.'))
+            continue;
+
+        // There is nothing to find below anything that isn't a directory.
+        if (!remaining_segments.is_empty() && entry->d_type != DT_DIR && entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN)
+            continue;
+
+        if (name.matches(first_segment, CaseSensitivity::CaseSensitive))
+            expand_glob_segments(remaining_segments, String::formatted("{}{}", prefix, name), true, results);
     }
 }
 
+Vector<String> Shell::expand_globs(Vector<StringView> path_segments, StringView base)
+{
+    Vector<String> results;
+    expand_glob_segments(path_segments.span(), base, false, results);
+    return results;
+}
+
 Vector<AST::Command> Shell::expand_aliases(Vector<AST::Command> initial_commands)
 {
     Vector<AST::Command> commands;
@@ -586,13 +598,18 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
     if (!command)
         return 0;
 
+    return run_parsed_command(*command);
+}
+
+int Shell::run_parsed_command(AST::Node& command)
+{
     if constexpr (SH_DEBUG) {
         dbgln("Command follows");
-        command->dump(0);
+        command.dump(0);
     }
 
-    if (command->is_syntax_error()) {
-        auto& error_node = command->syntax_error_node();
+    if (command.is_syntax_error()) {
+        auto& error_node = command.syntax_error_node();
         auto& position = error_node.position();
         raise_error(ShellError::EvaluatedSyntaxError, error_node.error_text(), position);
     }
@@ -605,7 +622,7 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
 
     tcgetattr(0, &termios);
 
-    (void)command->run(*this);
+    (void)command.run(*this);
 
     if (!has_error(ShellError::None)) {
         possibly_print_error();
@@ -1057,8 +1074,38 @@ bool Shell::run_file(String const& filename, bool explicitly_invoked)
         return false;
     }
     auto file = file_result.value();
-    auto data = file->read_all();
-    return run_command(data) == 0;
+
+    // Scripts that are sourced over and over (e.g. from a loop, or by every script of a build) only get parsed again when they change.
+    struct stat statbuf;
+    if (fstat(file->fd(), &statbuf) < 0) {
+        auto data = file->read_all();
+        return run_command(data) == 0;
+    }
+
+    RefPtr<AST::Node> command;
+    auto cached_script = m_parsed_script_cache.find(filename);
+    if (cached_script != m_parsed_script_cache.end()
+        && cached_script->value.device == statbuf.st_dev
+        && cached_script->value.inode == statbuf.st_ino
+        && cached_script->value.size == statbuf.st_size
+        && cached_script->value.modification_time.tv_sec == statbuf.st_mtim.tv_sec
+        && cached_script->value.modification_time.tv_nsec == statbuf.st_mtim.tv_nsec) {
+        command = cached_script->value.command;
+    } else {
+        auto data = file->read_all();
+        command = Parser(data, m_is_interactive).parse();
+        if (m_parsed_script_cache.size() >= max_parsed_script_cache_size)
+            m_parsed_script_cache.clear();
+        m_parsed_script_cache.set(filename, { statbuf.st_dev, statbuf.st_ino, statbuf.st_size, statbuf.st_mtim, command });
+    }
+
+    // Note: This runs the script the same way run_command() would, minus parsing it.
+    take_error();
+    if (!last_return_code.has_value())
+        last_return_code = 0;
+    if (!command)
+        return true;
+    return run_parsed_command(*command) == 0;
 }
 
 bool Shell::is_allowed_to_modify_termios(const AST::Command& command) const
@@ -21,7 +21,9 @@
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibLine/Editor.h>
+#include <sys/types.h>
 #include <termios.h>
+#include <time.h>
 
 #define ENUMERATE_SHELL_BUILTINS()     \
     __ENUMERATE_SHELL_BUILTIN(alias)   \
@@ -140,6 +142,7 @@ public:
     Optional<RunnablePath> runnable_path_for(StringView);
     Optional<String> help_path_for(Vector<RunnablePath> visited, RunnablePath const& runnable_path);
     ErrorOr<RefPtr<Job>> run_command(const AST::Command&);
+    int run_parsed_command(AST::Node&);
     NonnullRefPtrVector<Job> run_commands(Vector<AST::Command>&);
     bool run_file(String const&, bool explicitly_invoked = true);
     bool run_builtin(const AST::Command&, NonnullRefPtrVector<AST::Rewiring> const&, int& retval);
@@ -441,6 +444,16 @@ private:
     };
 
     HashMap<String, ShellFunction> m_functions;
+
+    struct ParsedScript {
+        dev_t device { 0 };
+        ino_t inode { 0 };
+        off_t size { 0 };
+        timespec modification_time {};
+        RefPtr<AST::Node> command;
+    };
+    static constexpr size_t max_parsed_script_cache_size = 64;
+    HashMap<String, ParsedScript> m_parsed_script_cache;
     NonnullOwnPtrVector<LocalFrame> m_local_frames;
     Promise::List m_active_promises;
     NonnullRefPtrVector<AST::Redirection> m_global_redirections;
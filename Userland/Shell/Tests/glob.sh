@@ -0,0 +1,34 @@
+#!/bin/sh
+
+source $(dirname "$0")/test-commons.inc
+
+rm -rf /tmp/shell-test-glob 2> /dev/null
+mkdir -p /tmp/shell-test-glob
+pushd /tmp/shell-test-glob
+
+    mkdir -p a/x b/x c
+    touch a/x/1 b/x/2 c/x file .hidden
+
+    # Simple globs
+    if not test "$(echo *)" = "a b c file" { fail simple glob }
+    if not test "$(echo .h*)" = ".hidden" { fail explicitly requested dotfiles }
+
+    # Globs in the middle of a path only descend into directories
+    if not test "$(echo */x)" = "a/x b/x c/x" { fail glob in the middle of a path }
+    if not test "$(echo */x/*)" = "a/x/1 b/x/2" { fail glob below a glob }
+
+    # Sourcing a script again picks up changes to it
+    echo 'value=first' > script.sh
+    source script.sh
+    if not test "$value" = "first" { fail cannot source a script }
+    value=''
+    source script.sh
+    if not test "$value" = "first" { fail cannot source a script twice }
+    echo 'value=second' > script.sh
+    source script.sh
+    if not test "$value" = "second" { fail changes to a sourced script are ignored }
+
+popd
+rm -rf /tmp/shell-test-glob
+
+pass
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <AK/NumericLimits.h>
 #include <AK/Types.h>
 #include <LibAudio/Loader.h>
@@ -39,27 +40,26 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     }
     auto loader = maybe_loader.release_value();
 
+    // All chunks are decoded into the same buffer, so that we only measure the decoder and not the allocator.
+    auto buffer = TRY(FixedArray<Audio::Sample>::try_create(MAX_CHUNK_SIZE));
+
     Core::ElapsedTimer sample_timer { true };
     u64 total_loader_time = 0;
     int remaining_samples = sample_count > 0 ? sample_count : NumericLimits<int>::max();
     unsigned total_loaded_samples = 0;
 
-    for (;;) {
-        if (remaining_samples > 0) {
-            sample_timer = sample_timer.start_new();
-            auto samples = loader->get_more_samples(min(MAX_CHUNK_SIZE, remaining_samples));
-            auto elapsed = static_cast<u64>(sample_timer.elapsed());
-            total_loader_time += static_cast<u64>(elapsed);
-            if (!samples.is_error()) {
-                remaining_samples -= samples.value().size();
-                total_loaded_samples += samples.value().size();
-                if (samples.value().size() == 0)
-                    break;
-            } else {
-                warnln("Error while loading audio: {}", samples.error().description);
-                return 1;
-            }
-        } else
+    while (remaining_samples > 0) {
+        sample_timer = sample_timer.start_new();
+        auto samples = loader->read_samples(buffer.span().trim(remaining_samples));
+        auto elapsed = static_cast<u64>(sample_timer.elapsed());
+        total_loader_time += static_cast<u64>(elapsed);
+        if (samples.is_error()) {
+            warnln("Error while loading audio: {}", samples.error().description);
+            return 1;
+        }
+        remaining_samples -= samples.value();
+        total_loaded_samples += samples.value();
+        if (samples.value() == 0)
             break;
     }
 
@@ -10,10 +10,10 @@
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DateTime.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/TreeWalker.h>
 #include <limits.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -37,7 +37,8 @@ struct DuOption {
 };
 
 static ErrorOr<void> parse_args(Main::Arguments arguments, Vector<String>& files, DuOption& du_option);
-static ErrorOr<u64> print_space_usage(String const& path, DuOption const& du_option, size_t current_depth, bool inside_dir = false);
+static ErrorOr<void> print_space_usage(String const& path, DuOption const& du_option);
+static ErrorOr<u64> print_space_usage(String const& path, Core::DirectoryEntry const&, DuOption const& du_option, size_t current_depth, u64 size_of_contents);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -47,7 +48,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(parse_args(arguments, files, du_option));
 
     for (auto const& file : files)
-        TRY(print_space_usage(file, du_option, 0));
+        TRY(print_space_usage(file, du_option));
 
     return 0;
 }
@@ -134,23 +135,47 @@ ErrorOr<void> parse_args(Main::Arguments arguments, Vector<String>& files, DuOpt
     return {};
 }
 
-ErrorOr<u64> print_space_usage(String const& path, DuOption const& du_option, size_t current_depth, bool inside_dir)
+ErrorOr<void> print_space_usage(String const& path, DuOption const& du_option)
 {
-    u64 size = 0;
-    struct stat path_stat = TRY(Core::System::lstat(path));
-    bool const is_directory = S_ISDIR(path_stat.st_mode);
-    if (is_directory) {
-        auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error()) {
-            outln("du: cannot read directory '{}': {}", path, di.error_string());
-            return Error::from_string_literal("An error occurred. See previous error.");
-        }
+    // Errors for the path itself are reported as they are, only those for directories inside of it get the extra message.
+    TRY(Core::System::lstat(path));
+
+    // The sizes of what's inside the directories we're currently in, the innermost one last.
+    Vector<u64> sizes_of_contents;
+    auto add_to_parent = [&](u64 size) {
+        if (!sizes_of_contents.is_empty())
+            sizes_of_contents.last() += size;
+    };
 
-        while (di.has_next()) {
-            auto const child_path = di.next_full_path();
-            size += TRY(print_space_usage(child_path, du_option, current_depth + 1, true));
+    Threading::TreeWalker walker;
+    walker.set_fetch_metadata(Core::DirectoryEntry::FetchMetadata::Yes);
+    walker.on_entry = [&](String const& entry_path, Core::DirectoryEntry const& entry, size_t depth) -> ErrorOr<void> {
+        if (entry.type == Core::DirectoryEntry::Type::Directory) {
+            sizes_of_contents.append(0);
+            return {};
         }
-    }
+        add_to_parent(TRY(print_space_usage(entry_path, entry, du_option, depth, 0)));
+        return {};
+    };
+    walker.on_leave_directory = [&](String const& directory_path, Core::DirectoryEntry const& directory, size_t depth) -> ErrorOr<void> {
+        auto size_of_contents = sizes_of_contents.take_last();
+        add_to_parent(TRY(print_space_usage(directory_path, directory, du_option, depth, size_of_contents)));
+        return {};
+    };
+    walker.on_error = [](String const& directory_path, Error const& error) -> ErrorOr<void> {
+        outln("du: cannot read directory '{}': {}", directory_path, strerror(error.code()));
+        return Error::from_string_literal("An error occurred. See previous error.");
+    };
+    return walker.walk(path);
+}
+
+ErrorOr<u64> print_space_usage(String const& path, Core::DirectoryEntry const& entry, DuOption const& du_option, size_t current_depth, u64 size_of_contents)
+{
+    u64 size = size_of_contents;
+    // The walker only leaves out the metadata if it couldn't stat the entry, so this reports why.
+    struct stat path_stat = entry.metadata.has_value() ? *entry.metadata : TRY(Core::System::lstat(path));
+    bool const is_directory = S_ISDIR(path_stat.st_mode);
+    bool const inside_dir = current_depth > 0;
 
     auto const basename = LexicalPath::basename(path);
     for (auto const& pattern : du_option.excluded_patterns) {
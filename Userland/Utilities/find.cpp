@@ -12,6 +12,7 @@
 #include <AK/Vector.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/TreeWalker.h>
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -41,10 +42,8 @@ template<typename... Parameters>
 struct FileData {
     // Full path to the file; either absolute or relative to cwd.
     LexicalPath full_path;
-    // The parent directory of the file.
-    int dirfd { -1 };
-    // The file's basename, relative to the directory.
-    char const* basename { nullptr };
+    // The path the file was found at, which may not be canonical like the one above.
+    String path;
     // Optionally, cached information as returned by stat/lstat/fstatat.
     struct stat stat {
     };
@@ -58,7 +57,7 @@ struct FileData {
             return &stat;
 
         int flags = g_follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW;
-        int rc = fstatat(dirfd, basename, &stat, flags);
+        int rc = fstatat(AT_FDCWD, path.characters(), &stat, flags);
         if (rc < 0) {
             perror(full_path.string().characters());
             g_there_was_an_error = true;
@@ -66,37 +65,42 @@ struct FileData {
         }
 
         stat_is_valid = true;
-
-        if (S_ISREG(stat.st_mode))
-            d_type = DT_REG;
-        else if (S_ISDIR(stat.st_mode))
-            d_type = DT_DIR;
-        else if (S_ISCHR(stat.st_mode))
-            d_type = DT_CHR;
-        else if (S_ISBLK(stat.st_mode))
-            d_type = DT_BLK;
-        else if (S_ISFIFO(stat.st_mode))
-            d_type = DT_FIFO;
-        else if (S_ISLNK(stat.st_mode))
-            d_type = DT_LNK;
-        else if (S_ISSOCK(stat.st_mode))
-            d_type = DT_SOCK;
-        else
-            VERIFY_NOT_REACHED();
-
+        d_type = dirent_type_from_mode(stat.st_mode);
         return &stat;
     }
+
+    static unsigned char dirent_type_from_mode(mode_t mode)
+    {
+        if (S_ISREG(mode))
+            return DT_REG;
+        if (S_ISDIR(mode))
+            return DT_DIR;
+        if (S_ISCHR(mode))
+            return DT_CHR;
+        if (S_ISBLK(mode))
+            return DT_BLK;
+        if (S_ISFIFO(mode))
+            return DT_FIFO;
+        if (S_ISLNK(mode))
+            return DT_LNK;
+        if (S_ISSOCK(mode))
+            return DT_SOCK;
+        VERIFY_NOT_REACHED();
+    }
 };
 
 class Command {
 public:
     virtual ~Command() = default;
     virtual bool evaluate(FileData& file_data) const = 0;
+    // Whether evaluating the command needs the files' metadata, so we can ask for it up front.
+    virtual bool needs_stat() const { return false; }
 };
 
 class StatCommand : public Command {
 public:
     virtual bool evaluate(const struct stat&) const = 0;
+    virtual bool needs_stat() const override { return true; }
 
 private:
     virtual bool evaluate(FileData& file_data) const override
@@ -342,6 +346,11 @@ private:
         return m_lhs->evaluate(file_data) && m_rhs->evaluate(file_data);
     }
 
+    virtual bool needs_stat() const override
+    {
+        return m_lhs->needs_stat() || m_rhs->needs_stat();
+    }
+
     NonnullOwnPtr<Command> m_lhs;
     NonnullOwnPtr<Command> m_rhs;
 };
@@ -360,6 +369,11 @@ private:
         return m_lhs->evaluate(file_data) || m_rhs->evaluate(file_data);
     }
 
+    virtual bool needs_stat() const override
+    {
+        return m_lhs->needs_stat() || m_rhs->needs_stat();
+    }
+
     NonnullOwnPtr<Command> m_lhs;
     NonnullOwnPtr<Command> m_rhs;
 };
@@ -488,67 +502,62 @@ static NonnullOwnPtr<Command> parse_all_commands(Vector<char*>& args)
     return make<AndCommand>(command.release_nonnull(), make<PrintCommand>());
 }
 
-static void walk_tree(FileData& root_data, Command& command)
+static unsigned char dirent_type_from_entry_type(Core::DirectoryEntry::Type type)
 {
-    command.evaluate(root_data);
-
-    // We should try to read directory entries if either:
-    // * This is a directory.
-    // * This is a symlink (that could point to a directory),
-    //   and we're following symlinks.
-    // * The type is unknown, so it could be a directory.
-    switch (root_data.d_type) {
-    case DT_DIR:
-    case DT_UNKNOWN:
-        break;
-    case DT_LNK:
-        if (g_follow_symlinks)
-            break;
-        return;
-    default:
-        return;
-    }
-
-    int dirfd = openat(root_data.dirfd, root_data.basename, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
-    if (dirfd < 0) {
-        if (errno == ENOTDIR) {
-            // Above we decided to try to open this file because it could
-            // be a directory, but turns out it's not. This is fine though.
-            return;
-        }
-        perror(root_data.full_path.string().characters());
-        g_there_was_an_error = true;
-        return;
-    }
-
-    DIR* dir = fdopendir(dirfd);
-
-    while (true) {
-        errno = 0;
-        auto* dirent = readdir(dir);
-        if (!dirent)
-            break;
+    switch (type) {
+    case Core::DirectoryEntry::Type::BlockDevice:
+        return DT_BLK;
+    case Core::DirectoryEntry::Type::CharacterDevice:
+        return DT_CHR;
+    case Core::DirectoryEntry::Type::Directory:
+        return DT_DIR;
+    case Core::DirectoryEntry::Type::File:
+        return DT_REG;
+    case Core::DirectoryEntry::Type::NamedPipe:
+        return DT_FIFO;
+    case Core::DirectoryEntry::Type::Socket:
+        return DT_SOCK;
+    case Core::DirectoryEntry::Type::SymbolicLink:
+        return DT_LNK;
+    case Core::DirectoryEntry::Type::Unknown:
+        return DT_UNKNOWN;
+    }
+    VERIFY_NOT_REACHED();
+}
 
-        if (strcmp(dirent->d_name, ".") == 0 || strcmp(dirent->d_name, "..") == 0)
-            continue;
+static void walk_tree(String const& root_path, Command& command)
+{
+    Threading::TreeWalker walker;
+    if (command.needs_stat())
+        walker.set_fetch_metadata(Core::DirectoryEntry::FetchMetadata::Yes);
+    if (g_follow_symlinks)
+        walker.set_follow_symlinks(Core::DirectoryEntry::FollowSymlinks::Yes);
 
+    walker.on_entry = [&](String const& path, Core::DirectoryEntry const& entry, size_t) -> ErrorOr<void> {
         FileData file_data {
-            root_data.full_path.append({ dirent->d_name, strlen(dirent->d_name) }),
-            dirfd,
-            dirent->d_name,
+            LexicalPath { path },
+            path,
             (struct stat) {},
             false,
-            dirent->d_type,
+            DT_UNKNOWN,
         };
-        walk_tree(file_data, command);
-    }
-
-    if (errno != 0) {
-        perror(root_data.full_path.string().characters());
+        if (entry.metadata.has_value()) {
+            file_data.stat = *entry.metadata;
+            file_data.stat_is_valid = true;
+            file_data.d_type = FileData::dirent_type_from_mode(file_data.stat.st_mode);
+        } else {
+            file_data.d_type = dirent_type_from_entry_type(entry.type);
+        }
+        command.evaluate(file_data);
+        return {};
+    };
+    walker.on_error = [](String const& path, Error const& error) -> ErrorOr<void> {
+        warnln("{}: {}", LexicalPath { path }, strerror(error.code()));
         g_there_was_an_error = true;
-    }
+        return {};
+    };
 
-    closedir(dir);
+    MUST(walker.walk(root_path));
 }
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
@@ -557,7 +566,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args.append(arguments.argv + 1, arguments.argc - 1);
 
     OwnPtr<Command> command;
-    Vector<LexicalPath> paths;
+    Vector<String> paths;
 
     while (!args.is_empty()) {
         char* raw_arg = args.take_first();
@@ -565,7 +574,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (arg == "-L") {
             g_follow_symlinks = true;
         } else if (!arg.starts_with('-')) {
-            paths.append(LexicalPath(arg));
+            paths.append(arg);
         } else {
             // No special case, so add back the argument and try to parse a command.
             args.prepend(raw_arg);
@@ -577,25 +586,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         command = make<PrintCommand>();
 
     if (paths.is_empty())
-        paths.append(LexicalPath("."));
-
-    for (auto& path : paths) {
-        String dirname = path.dirname();
-        String basename = path.basename();
-
-        int dirfd = TRY(Core::System::open(dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        paths.append(".");
 
-        FileData file_data {
-            path,
-            dirfd,
-            basename.characters(),
-            (struct stat) {},
-            false,
-            DT_UNKNOWN,
-        };
-        walk_tree(file_data, *command);
-        close(dirfd);
-    }
+    for (auto& path : paths)
+        walk_tree(path, *command);
 
     return g_there_was_an_error ? 1 : 0;
 }
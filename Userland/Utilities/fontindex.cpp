@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/ArgsParser.h>
+#include <LibCore/System.h>
+#include <LibGfx/Font/FontDatabase.h>
+#include <LibMain/Main.h>
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Write an index of the installed fonts, so that applications only load the fonts they use.");
+    args_parser.parse(arguments);
+
+    TRY(Gfx::FontDatabase::write_font_index());
+    outln("Wrote the font index to {}", Gfx::FontDatabase::font_index_path());
+    return 0;
+}
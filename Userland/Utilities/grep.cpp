@@ -8,14 +8,20 @@
 #include <AK/LexicalPath.h>
 #include <AK/ScopeGuard.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <LibRegex/Regex.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 
 enum class BinaryFileMode {
@@ -33,9 +39,236 @@ void fail(StringView format, Ts... args)
     abort();
 }
 
+// The number of files that are searched in parallel before their output is written, in the order they were given.
+static constexpr size_t files_per_batch = 64;
+
+struct GrepOptions {
+    BinaryFileMode binary_mode { BinaryFileMode::Binary };
+    bool line_numbers { false };
+    bool invert_match { false };
+    bool quiet_mode { false };
+    bool colored_output { false };
+    bool count_lines { false };
+};
+
+// The result of searching one file. Files are searched on the thread pool, so their output is collected here and
+// written by the main thread.
+struct FileResult {
+    bool opened { false };
+    bool matched { false };
+    size_t matched_line_count { 0 };
+    String output;
+    String error;
+};
+
+struct PendingFile {
+    String path;
+    String display_name;
+    FileResult result;
+};
+
+// Every line a match can be found in contains this literal, so lines without it can be skipped without running the regex.
+static Optional<String> required_literal(regex::Parser::Result const& parser_result, PosixOptions options, bool invert_match)
+{
+    if (invert_match || options.has_flag_set(PosixFlags::Insensitive))
+        return {};
+
+    StringBuilder builder;
+    for (auto ch : parser_result.required_prefix) {
+        if (ch > 0x7f)
+            break;
+        builder.append(static_cast<char>(ch));
+    }
+    if (builder.is_empty())
+        return {};
+    return builder.to_string();
+}
+
+static Optional<size_t> find_literal(StringView contents, StringView literal, size_t start)
+{
+    auto const* characters = contents.characters_without_null_termination();
+    while (start + literal.length() <= contents.length()) {
+        auto const* found = static_cast<char const*>(memchr(characters + start, literal[0], contents.length() - literal.length() + 1 - start));
+        if (!found)
+            return {};
+        auto offset = static_cast<size_t>(found - characters);
+        if (memcmp(found + 1, literal.characters_without_null_termination() + 1, literal.length() - 1) == 0)
+            return offset;
+        start = offset + 1;
+    }
+    return {};
+}
+
+static size_t count_newlines(StringView contents, size_t start, size_t end)
+{
+    size_t count = 0;
+    auto const* characters = contents.characters_without_null_termination();
+    while (start < end) {
+        auto const* found = static_cast<char const*>(memchr(characters + start, '\n', end - start));
+        if (!found)
+            break;
+        ++count;
+        start = found - characters + 1;
+    }
+    return count;
+}
+
+template<typename RegexType>
+static bool match_line(Vector<RegexType>& regular_expressions, GrepOptions const& options, StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary, StringBuilder& output, size_t& matched_line_count)
+{
+    size_t last_printed_char_pos { 0 };
+    if (is_binary && options.binary_mode == BinaryFileMode::Skip)
+        return false;
+
+    for (auto& re : regular_expressions) {
+        auto result = re.match(str, PosixFlags::Global);
+        if (!(result.success ^ options.invert_match))
+            continue;
+
+        if (options.quiet_mode)
+            return true;
+
+        if (options.count_lines) {
+            matched_line_count++;
+            return true;
+        }
+
+        if (is_binary && options.binary_mode == BinaryFileMode::Binary) {
+            output.appendff(options.colored_output ? "binary file \x1B[34m{}\x1B[0m matches\n"sv : "binary file {} matches\n"sv, filename);
+        } else {
+            if ((result.matches.size() || options.invert_match) && print_filename)
+                output.appendff(options.colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
+            if ((result.matches.size() || options.invert_match) && options.line_numbers)
+                output.appendff(options.colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
+
+            for (auto& match : result.matches) {
+                auto pre_match_length = match.global_offset - last_printed_char_pos;
+                output.appendff(options.colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
+                    pre_match_length > 0 ? StringView(&str[last_printed_char_pos], pre_match_length) : ""sv,
+                    match.view.to_string());
+                last_printed_char_pos = match.global_offset + match.view.length();
+            }
+            auto remaining_length = str.length() - last_printed_char_pos;
+            output.append(remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
+            output.append('\n');
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+template<typename RegexType>
+static bool search_contents(Vector<RegexType>& regular_expressions, GrepOptions const& options, Optional<StringView> literal, StringView contents, StringView filename, bool print_filename, StringBuilder& output, size_t& matched_line_count)
+{
+    bool did_match_something = false;
+    size_t position = 0;
+    size_t line_number = 1;
+
+    while (position < contents.length()) {
+        if (literal.has_value()) {
+            auto found = find_literal(contents, *literal, position);
+            if (!found.has_value())
+                break;
+            // Go back to the start of the line the literal is in.
+            size_t line_start = *found;
+            while (line_start > position && contents[line_start - 1] != '\n')
+                --line_start;
+            if (options.line_numbers)
+                line_number += count_newlines(contents, position, line_start);
+            position = line_start;
+        }
+
+        auto const* newline = static_cast<char const*>(memchr(contents.characters_without_null_termination() + position, '\n', contents.length() - position));
+        size_t line_end = newline ? newline - contents.characters_without_null_termination() : contents.length();
+        auto line = contents.substring_view(position, line_end - position);
+        auto is_binary = memchr(line.characters_without_null_termination(), 0, line.length()) != nullptr;
+
+        auto matched = match_line(regular_expressions, options, line, filename, line_number, print_filename, is_binary, output, matched_line_count);
+        did_match_something = did_match_something || matched;
+        if (matched && is_binary && options.binary_mode == BinaryFileMode::Binary)
+            break;
+
+        position = line_end + 1;
+        ++line_number;
+    }
+
+    return did_match_something;
+}
+
+// Files are mapped into memory when possible, and read the usual way otherwise (empty files, pipes, ...).
+template<typename RegexType>
+static FileResult search_file(Vector<RegexType>& regular_expressions, GrepOptions const& options, Optional<StringView> literal, StringView path, StringView display_name, bool print_filename)
+{
+    FileResult result;
+
+    RefPtr<Core::MappedFile> mapped_file;
+    ByteBuffer file_contents;
+    StringView contents;
+    if (auto mapped_file_or_error = Core::MappedFile::map(path); !mapped_file_or_error.is_error()) {
+        mapped_file = mapped_file_or_error.release_value();
+        contents = { static_cast<char const*>(mapped_file->data()), mapped_file->size() };
+    } else {
+        // NOTE: Core::File is a Core::Object, which can't be created off the main thread.
+        auto file_contents_or_error = [&]() -> ErrorOr<ByteBuffer> {
+            auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Read));
+            return file->read_all();
+        }();
+        if (file_contents_or_error.is_error()) {
+            result.error = String::formatted("Failed to open {}: {}", display_name, strerror(file_contents_or_error.error().code()));
+            return result;
+        }
+        file_contents = file_contents_or_error.release_value();
+        contents = StringView { file_contents.bytes() };
+    }
+    result.opened = true;
+
+    StringBuilder output;
+    result.matched = search_contents(regular_expressions, options, literal, contents, display_name, print_filename, output, result.matched_line_count);
+    result.output = output.to_string();
+    return result;
+}
+
+// Regexes keep state while matching, so every thread that's searching needs a set of its own.
+template<typename RegexType>
+class RegexSets {
+public:
+    RegexSets(Vector<String> const& patterns, PosixOptions options, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            Vector<RegexType> regular_expressions;
+            for (auto& pattern : patterns)
+                regular_expressions.append(RegexType(pattern, options));
+            m_sets.append(move(regular_expressions));
+            m_free_sets.append(i);
+        }
+    }
+
+    Vector<RegexType>& first() { return m_sets.first(); }
+
+    template<typename Callback>
+    void with_free_set(Callback callback)
+    {
+        size_t index;
+        {
+            Threading::MutexLocker locker(m_mutex);
+            index = m_free_sets.take_last();
+        }
+        callback(m_sets[index]);
+        Threading::MutexLocker locker(m_mutex);
+        m_free_sets.append(index);
+    }
+
+private:
+    Vector<Vector<RegexType>> m_sets;
+    Threading::Mutex m_mutex;
+    Vector<size_t> m_free_sets;
+};
+
 ErrorOr<int> serenity_main(Main::Arguments args)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath thread"));
 
     String program_name = AK::LexicalPath::basename(args.strings[0]);
 
@@ -44,16 +277,10 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     bool recursive = (program_name == "rgrep"sv);
     bool use_ere = (program_name == "egrep"sv);
     Vector<String> patterns;
-    BinaryFileMode binary_mode { BinaryFileMode::Binary };
+    GrepOptions grep_options;
     bool case_insensitive = false;
-    bool line_numbers = false;
-    bool invert_match = false;
-    bool quiet_mode = false;
     bool suppress_errors = false;
-    bool colored_output = isatty(STDOUT_FILENO);
-    bool count_lines = false;
-
-    size_t matched_line_count = 0;
+    grep_options.colored_output = isatty(STDOUT_FILENO);
 
     Core::ArgsParser args_parser;
     args_parser.add_option(recursive, "Recursively scan files", "recursive", 'r');
@@ -70,9 +297,9 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         },
     });
     args_parser.add_option(case_insensitive, "Make matches case-insensitive", nullptr, 'i');
-    args_parser.add_option(line_numbers, "Output line-numbers", "line-numbers", 'n');
-    args_parser.add_option(invert_match, "Select non-matching lines", "invert-match", 'v');
-    args_parser.add_option(quiet_mode, "Do not write anything to standard output", "quiet", 'q');
+    args_parser.add_option(grep_options.line_numbers, "Output line-numbers", "line-numbers", 'n');
+    args_parser.add_option(grep_options.invert_match, "Select non-matching lines", "invert-match", 'v');
+    args_parser.add_option(grep_options.quiet_mode, "Do not write anything to standard output", "quiet", 'q');
     args_parser.add_option(suppress_errors, "Suppress error messages for nonexistent or unreadable files", "no-messages", 's');
     args_parser.add_option(Core::ArgsParser::Option {
         .argument_mode = Core::ArgsParser::OptionArgumentMode::Required,
@@ -80,11 +307,11 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .long_name = "binary-mode",
         .accept_value = [&](auto* str) {
             if ("text"sv == str)
-                binary_mode = BinaryFileMode::Text;
+                grep_options.binary_mode = BinaryFileMode::Text;
             else if ("binary"sv == str)
-                binary_mode = BinaryFileMode::Binary;
+                grep_options.binary_mode = BinaryFileMode::Binary;
             else if ("skip"sv == str)
-                binary_mode = BinaryFileMode::Skip;
+                grep_options.binary_mode = BinaryFileMode::Skip;
             else
                 return false;
             return true;
@@ -96,7 +323,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .long_name = "text",
         .short_name = 'a',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Text;
+            grep_options.binary_mode = BinaryFileMode::Text;
             return true;
         },
     });
@@ -106,7 +333,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .long_name = nullptr,
         .short_name = 'I',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Skip;
+            grep_options.binary_mode = BinaryFileMode::Skip;
             return true;
         },
     });
@@ -118,15 +345,15 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .value_name = "WHEN",
         .accept_value = [&](auto* str) {
             if ("never"sv == str)
-                colored_output = false;
+                grep_options.colored_output = false;
             else if ("always"sv == str)
-                colored_output = true;
+                grep_options.colored_output = true;
             else if ("auto"sv != str)
                 return false;
             return true;
         },
     });
-    args_parser.add_option(count_lines, "Output line count instead of line contents", "count", 'c');
+    args_parser.add_option(grep_options.count_lines, "Output line count instead of line contents", "count", 'c');
     args_parser.add_positional_argument(files, "File(s) to process", "file", Core::ArgsParser::Required::No);
     args_parser.parse(args);
 
@@ -141,104 +368,80 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     if (case_insensitive)
         options |= PosixFlags::Insensitive;
 
-    auto grep_logic = [&](auto&& regular_expressions) {
-        for (auto& re : regular_expressions) {
+    auto grep_logic = [&]<typename RegexType>(RegexSets<RegexType>& regex_sets) {
+        for (auto& re : regex_sets.first()) {
             if (re.parser_result.error != regex::Error::NoError) {
                 return 1;
             }
         }
 
-        auto matches = [&](StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary) {
-            size_t last_printed_char_pos { 0 };
-            if (is_binary && binary_mode == BinaryFileMode::Skip)
-                return false;
-
-            for (auto& re : regular_expressions) {
-                auto result = re.match(str, PosixFlags::Global);
-                if (!(result.success ^ invert_match))
-                    continue;
-
-                if (quiet_mode)
-                    return true;
-
-                if (count_lines) {
-                    matched_line_count++;
-                    return true;
-                }
-
-                if (is_binary && binary_mode == BinaryFileMode::Binary) {
-                    outln(colored_output ? "binary file \x1B[34m{}\x1B[0m matches"sv : "binary file {} matches"sv, filename);
-                } else {
-                    if ((result.matches.size() || invert_match) && print_filename)
-                        out(colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
-                    if ((result.matches.size() || invert_match) && line_numbers)
-                        out(colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
-
-                    for (auto& match : result.matches) {
-                        auto pre_match_length = match.global_offset - last_printed_char_pos;
-                        out(colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
-                            pre_match_length > 0 ? StringView(&str[last_printed_char_pos], pre_match_length) : ""sv,
-                            match.view.to_string());
-                        last_printed_char_pos = match.global_offset + match.view.length();
-                    }
-                    auto remaining_length = str.length() - last_printed_char_pos;
-                    outln("{}", remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
-                }
-
-                return true;
-            }
-
-            return false;
-        };
+        // NOTE: The literal is only used with a single pattern, since any of several patterns could match a line.
+        Optional<String> literal;
+        if (regex_sets.first().size() == 1)
+            literal = required_literal(regex_sets.first().first().parser_result, options, grep_options.invert_match);
+        Optional<StringView> literal_view;
+        if (literal.has_value())
+            literal_view = literal->view();
 
         bool did_match_something = false;
 
-        auto handle_file = [&matches, binary_mode, suppress_errors, count_lines, quiet_mode,
-                               user_specified_multiple_files, &matched_line_count, &did_match_something](StringView filename, bool print_filename) -> bool {
-            auto file = Core::File::construct(filename);
-            if (!file->open(Core::OpenMode::ReadOnly)) {
-                if (!suppress_errors)
-                    warnln("Failed to open {}: {}", filename, file->error_string());
-                return false;
-            }
-
-            auto file_size_or_error = Core::File::size(filename);
-            if (file_size_or_error.is_error()) {
+        auto write_result = [&](PendingFile const& file) -> bool {
+            auto& result = file.result;
+            if (!result.opened) {
                 if (!suppress_errors)
-                    warnln("Failed to retrieve size of {}: {}", filename, strerror(file_size_or_error.error().code()));
+                    warnln("{}", result.error);
                 return false;
             }
 
-            auto file_size = file_size_or_error.release_value();
-
-            for (size_t line_number = 1; file->can_read_line(); ++line_number) {
-                auto line = file->read_line(file_size);
-                auto is_binary = memchr(line.characters(), 0, line.length()) != nullptr;
-
-                auto matched = matches(line, filename, line_number, print_filename, is_binary);
-                did_match_something = did_match_something || matched;
-                if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
-                    break;
-            }
+            out("{}", result.output);
+            did_match_something = did_match_something || result.matched;
 
-            if (count_lines && !quiet_mode) {
+            if (grep_options.count_lines && !grep_options.quiet_mode) {
                 if (user_specified_multiple_files)
-                    outln("{}:{}", filename, matched_line_count);
+                    outln("{}:{}", file.display_name, result.matched_line_count);
                 else
-                    outln("{}", matched_line_count);
-                matched_line_count = 0;
+                    outln("{}", result.matched_line_count);
             }
+            return true;
+        };
+
+        // Searches the pending files in parallel, and writes their results in order. Returns false if a file couldn't
+        // be read and we should stop there.
+        Vector<PendingFile> pending_files;
+        auto search_pending_files = [&](bool print_filename, bool stop_on_error) -> bool {
+            Function<void(size_t)> search = [&](size_t index) {
+                regex_sets.with_free_set([&](auto& regular_expressions) {
+                    auto& file = pending_files[index];
+                    file.result = search_file(regular_expressions, grep_options, literal_view, file.path, file.display_name, print_filename);
+                });
+            };
+
+            if (pending_files.size() == 1)
+                search(0);
+            else
+                Threading::ThreadPool::the().parallel_for(0, pending_files.size(), search, 1);
 
+            ScopeGuard clear_pending_files = [&] { pending_files.clear(); };
+            for (auto& file : pending_files) {
+                if (!write_result(file) && stop_on_error)
+                    return false;
+            }
             return true;
         };
 
-        auto add_directory = [&handle_file, user_has_specified_files](String base, Optional<String> recursive, auto handle_directory) -> void {
+        auto add_file = [&](String path, String display_name) {
+            pending_files.append({ move(path), move(display_name), {} });
+            if (pending_files.size() == files_per_batch)
+                search_pending_files(true, false);
+        };
+
+        auto add_directory = [&add_file, user_has_specified_files](String base, Optional<String> recursive, auto handle_directory) -> void {
             Core::DirIterator it(recursive.value_or(base), Core::DirIterator::Flags::SkipDots);
             while (it.has_next()) {
                 auto path = it.next_full_path();
                 if (!Core::File::is_directory(path)) {
-                    auto key = user_has_specified_files ? path.view() : path.substring_view(base.length() + 1, path.length() - base.length() - 1);
-                    handle_file(key, true);
+                    auto key = user_has_specified_files ? path : path.substring(base.length() + 1, path.length() - base.length() - 1);
+                    add_file(move(path), move(key));
                 } else {
                     handle_directory(base, path, handle_directory);
                 }
@@ -246,11 +449,14 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         };
 
         if (!files.size() && !recursive) {
+            auto& regular_expressions = regex_sets.first();
             char* line = nullptr;
             size_t line_len = 0;
             ssize_t nread = 0;
             ScopeGuard free_line = [line] { free(line); };
             size_t line_number = 0;
+            size_t matched_line_count = 0;
+            StringBuilder output;
             while ((nread = getline(&line, &line_len, stdin)) != -1) {
                 VERIFY(nread > 0);
                 if (line[nread - 1] == '\n')
@@ -260,16 +466,18 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 StringView line_view(line, nread);
                 bool is_binary = line_view.contains(0);
 
-                if (is_binary && binary_mode == BinaryFileMode::Skip)
+                if (is_binary && grep_options.binary_mode == BinaryFileMode::Skip)
                     return 1;
 
-                auto matched = matches(line_view, "stdin"sv, line_number, false, is_binary);
+                auto matched = match_line(regular_expressions, grep_options, line_view, "stdin"sv, line_number, false, is_binary, output, matched_line_count);
                 did_match_something = did_match_something || matched;
-                if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
+                out("{}", output.string_view());
+                output.clear();
+                if (matched && is_binary && grep_options.binary_mode == BinaryFileMode::Binary)
                     break;
             }
 
-            if (count_lines && !quiet_mode)
+            if (grep_options.count_lines && !grep_options.quiet_mode)
                 outln("{}", matched_line_count);
         } else {
             if (recursive) {
@@ -280,11 +488,14 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 } else {
                     add_directory(".", {}, add_directory);
                 }
-
+                if (!pending_files.is_empty())
+                    search_pending_files(true, false);
             } else {
                 bool print_filename { files.size() > 1 };
-                for (auto& filename : files) {
-                    if (!handle_file(filename, print_filename))
+                for (size_t i = 0; i < files.size(); i += files_per_batch) {
+                    for (size_t j = i; j < min(i + files_per_batch, files.size()); ++j)
+                        pending_files.append({ files[j], files[j], {} });
+                    if (!search_pending_files(print_filename, true))
                         return 1;
                 }
             }
@@ -293,17 +504,16 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         return did_match_something ? 0 : 1;
     };
 
+    // Only create as many sets of regexes as there can be threads searching at the same time.
+    auto regex_set_count = 1u;
+    if (recursive || files.size() > 1)
+        regex_set_count = Threading::ThreadPool::the().worker_count() + 1;
+
     if (use_ere) {
-        Vector<Regex<PosixExtended>> regular_expressions;
-        for (auto pattern : patterns) {
-            regular_expressions.append(Regex<PosixExtended>(pattern, options));
-        }
-        return grep_logic(regular_expressions);
+        RegexSets<Regex<PosixExtended>> regex_sets { patterns, options, regex_set_count };
+        return grep_logic(regex_sets);
     }
 
-    Vector<Regex<PosixBasic>> regular_expressions;
-    for (auto pattern : patterns) {
-        regular_expressions.append(Regex<PosixBasic>(pattern, options));
-    }
-    return grep_logic(regular_expressions);
+    RegexSets<Regex<PosixBasic>> regex_sets { patterns, options, regex_set_count };
+    return grep_logic(regex_sets);
 }
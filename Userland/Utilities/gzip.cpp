@@ -4,31 +4,73 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <LibCompress/Gzip.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/FileStream.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/Thread.h>
 #include <unistd.h>
 
+static Optional<ByteBuffer> compress_in_parallel(ReadonlyBytes input_bytes, size_t thread_count)
+{
+    Compress::ChunkedGzipCompressor compressor { input_bytes };
+    thread_count = min(thread_count, compressor.chunk_count());
+
+    Atomic<size_t> next_chunk { 0 };
+    auto compress_chunks = [&] {
+        for (;;) {
+            auto index = next_chunk.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (index >= compressor.chunk_count())
+                return;
+            compressor.compress_chunk(index);
+        }
+    };
+
+    // This thread compresses chunks too, so it needs one helper less
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+        auto thread = Threading::Thread::construct(
+            [&] {
+                compress_chunks();
+                return 0;
+            },
+            "gzip"sv);
+        thread->start();
+        threads.append(move(thread));
+    }
+    compress_chunks();
+    for (auto& thread : threads)
+        (void)thread.join();
+
+    return compressor.finish();
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     Vector<StringView> filenames;
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    int thread_count { -1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Number of threads to compress with (default: one per CPU)", "threads", 'T', "count");
     args_parser.add_positional_argument(filenames, "Files", "FILES");
     args_parser.parse(arguments);
 
     if (write_to_stdout)
         keep_input_files = true;
 
+    if (thread_count <= 0)
+        thread_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1);
+
     for (auto const& input_filename : filenames) {
         String output_filename;
         if (decompress) {
@@ -53,6 +95,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         AK::Optional<ByteBuffer> output_bytes;
         if (decompress)
             output_bytes = Compress::GzipDecompressor::decompress_all(input_bytes);
+        else if (thread_count > 1)
+            output_bytes = compress_in_parallel(input_bytes, thread_count);
         else
             output_bytes = Compress::GzipCompressor::compress_all(input_bytes);
 
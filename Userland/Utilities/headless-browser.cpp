@@ -244,7 +244,7 @@ public:
 
     virtual ~HeadlessImageDecoderClient() override = default;
 
-    virtual Optional<Web::ImageDecoding::DecodedImage> decode_image(ReadonlyBytes data) override
+    virtual Optional<Web::ImageDecoding::DecodedImage> decode_image(ReadonlyBytes data, Optional<Gfx::IntSize> ideal_size) override
     {
         auto decoder = Gfx::ImageDecoder::try_create(data);
 
@@ -256,7 +256,7 @@ public:
 
         Vector<Web::ImageDecoding::Frame> frames;
         for (size_t i = 0; i < decoder->frame_count(); ++i) {
-            auto frame_or_error = decoder->frame(i);
+            auto frame_or_error = ideal_size.has_value() ? decoder->downscaled_frame(i, *ideal_size) : decoder->frame(i);
             if (frame_or_error.is_error()) {
                 frames.append({ {}, 0 });
             } else {
@@ -129,6 +129,8 @@ private:
 static bool s_dump_ast = false;
 static bool s_run_bytecode = false;
 static bool s_opt_bytecode = false;
+static bool s_dump_property_lookup_cache_statistics = false;
+static bool s_dump_shape_statistics = false;
 static bool s_as_module = false;
 static bool s_print_last_result = false;
 static bool s_strip_ansi = false;
@@ -1176,6 +1178,8 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView source, Strin
                     result = result_or_error.value.release_error();
                 else
                     result = result_or_error.frame->registers[0];
+                if (s_dump_property_lookup_cache_statistics)
+                    JS::Bytecode::g_property_lookup_cache_statistics.dump();
             } else {
                 return ReturnEarly::Yes;
             }
@@ -1183,6 +1187,9 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView source, Strin
             result = interpreter.run(*script_or_module);
         }
 
+        if (s_dump_shape_statistics)
+            JS::g_shape_statistics.dump();
+
         return ReturnEarly::No;
     };
 
@@ -1500,7 +1507,7 @@ private:
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
 #ifdef __serenity__
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction prot_exec"));
 #endif
 
     bool gc_on_every_allocation = false;
@@ -1514,6 +1521,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(JS::Bytecode::g_jit_enabled, "Compile frequently run bytecode to native code", "jit", 'j');
+    args_parser.add_option(s_dump_property_lookup_cache_statistics, "Dump property lookup cache statistics after running the bytecode", "dump-property-lookup-cache-statistics", 0);
+    args_parser.add_option(s_dump_shape_statistics, "Dump shape and property table statistics after running the script", "dump-shape-statistics", 0);
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -1524,6 +1534,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+#ifdef __serenity__
+    // Only the JIT needs to make memory executable.
+    if (!JS::Bytecode::g_jit_enabled)
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+#endif
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     g_vm = JS::VM::create();
@@ -1706,7 +1722,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             Vector<Line::CompletionSuggestion> results;
 
             Function<void(JS::Shape const&, StringView)> list_all_properties = [&results, &list_all_properties](JS::Shape const& shape, auto property_pattern) {
-                for (auto const& descriptor : shape.property_table()) {
+                for (auto const& descriptor : shape.property_table_ordered()) {
                     if (!descriptor.key.is_string())
                         continue;
                     auto key = descriptor.key.as_string();
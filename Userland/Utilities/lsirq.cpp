@@ -20,17 +20,30 @@ ErrorOr<int> serenity_main(Main::Arguments)
 
     TRY(Core::System::pledge("stdio"));
 
-    outln("      CPU0");
     auto file_contents = proc_interrupts->read_all();
     auto json = TRY(JsonValue::from_string(file_contents));
-    json.as_array().for_each([](auto& value) {
+
+    size_t processor_count = 1;
+    json.as_array().for_each([&](auto& value) {
+        processor_count = max(processor_count, value.as_object().get("per_cpu_call_counts"sv).as_array().size());
+    });
+
+    out("     ");
+    for (size_t processor = 0; processor < processor_count; ++processor)
+        out(" {:>10}", String::formatted("CPU{}", processor));
+    outln();
+
+    json.as_array().for_each([&](auto& value) {
         auto& handler = value.as_object();
         auto purpose = handler.get("purpose"sv).to_string();
         auto interrupt = handler.get("interrupt_line"sv).to_string();
         auto controller = handler.get("controller"sv).to_string();
-        auto call_count = handler.get("call_count"sv).to_string();
+        auto& call_counts = handler.get("per_cpu_call_counts"sv).as_array();
 
-        outln("{:>4}: {:10} {:10}  {:30}", interrupt, call_count, controller, purpose);
+        out("{:>4}:", interrupt);
+        for (size_t processor = 0; processor < processor_count; ++processor)
+            out(" {:>10}", processor < call_counts.size() ? call_counts.at(processor).to_string() : "0");
+        outln(" {:10}  {:30}", controller, purpose);
     });
 
     return 0;
@@ -53,6 +53,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "read")
                 event_mask |= PERF_EVENT_READ;
+            else if (event_type == "lock_contention")
+                event_mask |= PERF_EVENT_LOCK_CONTENTION;
+            else if (event_type == "cpu_cycles")
+                event_mask |= PERF_EVENT_CPU_CYCLES;
+            else if (event_type == "cache_misses")
+                event_mask |= PERF_EVENT_CACHE_MISSES;
+            else if (event_type == "branch_misses")
+                event_mask |= PERF_EVENT_BRANCH_MISSES;
+            else if (event_type == "tlb_misses")
+                event_mask |= PERF_EVENT_TLB_MISSES;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -62,7 +72,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, lock_contention, kmalloc, kfree,");
+        outln("cpu_cycles, cache_misses, branch_misses and tlb_misses.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
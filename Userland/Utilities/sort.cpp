@@ -4,43 +4,200 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BinaryHeap.h>
+#include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
-{
-    TRY(Core::System::pledge("stdio"sv));
+// The number of sorted runs that are merged at once. Any more than that are merged in several passes.
+static constexpr size_t max_merge_width = 64;
 
-    Vector<String> lines;
+// Sorting fewer lines than this isn't worth waking up other threads for.
+static constexpr size_t parallel_sort_threshold = 16 * KiB;
+
+// A rough estimate of what a line costs on top of its characters.
+static constexpr size_t line_overhead = sizeof(String) + 32;
+
+// Reads lines from a file, reusing the same buffer for all of them.
+class LineReader {
+    AK_MAKE_NONCOPYABLE(LineReader);
+
+public:
+    explicit LineReader(FILE* file)
+        : m_file(file)
+    {
+    }
 
-    for (;;) {
-        char* buffer = nullptr;
-        ssize_t buflen = 0;
-        size_t n;
+    LineReader(LineReader&& other)
+        : m_file(exchange(other.m_file, nullptr))
+        , m_buffer(exchange(other.m_buffer, nullptr))
+        , m_buffer_size(exchange(other.m_buffer_size, 0))
+    {
+    }
+
+    ~LineReader()
+    {
+        free(m_buffer);
+        if (m_file && m_file != stdin)
+            fclose(m_file);
+    }
+
+    ErrorOr<Optional<String>> read_line()
+    {
         errno = 0;
-        buflen = getline(&buffer, &n, stdin);
-        if (buflen == -1 && errno != 0) {
-            perror("getline");
-            exit(1);
+        ssize_t length = getline(&m_buffer, &m_buffer_size, m_file);
+        if (length == -1) {
+            if (errno != 0)
+                return Error::from_errno(errno);
+            return Optional<String> {};
+        }
+        return String { m_buffer, static_cast<size_t>(length), AK::ShouldChomp::Chomp };
+    }
+
+private:
+    FILE* m_file { nullptr };
+    char* m_buffer { nullptr };
+    size_t m_buffer_size { 0 };
+};
+
+static ErrorOr<void> write_line(FILE* file, StringView line)
+{
+    if (fwrite(line.characters_without_null_termination(), 1, line.length(), file) != line.length() || fputc('\n', file) == EOF)
+        return Error::from_errno(errno);
+    return {};
+}
+
+// Temporary files are unlinked right away, so they disappear along with us.
+static ErrorOr<FILE*> create_temporary_file()
+{
+    char path[] = "/tmp/sort.XXXXXX";
+    auto fd = TRY(Core::System::mkstemp(path));
+    TRY(Core::System::unlink({ path, strlen(path) }));
+    auto* file = fdopen(fd, "w+");
+    if (!file) {
+        auto error = Error::from_errno(errno);
+        (void)Core::System::close(fd);
+        return error;
+    }
+    return file;
+}
+
+static void sort_lines(Vector<String>& lines)
+{
+    if (lines.size() < parallel_sort_threshold)
+        quick_sort(lines);
+    else
+        Threading::ThreadPool::the().parallel_sort(lines.span());
+}
+
+static ErrorOr<LineReader> write_sorted_run(Vector<String>& lines)
+{
+    sort_lines(lines);
+
+    auto* file = TRY(create_temporary_file());
+    for (auto& line : lines)
+        TRY(write_line(file, line));
+    if (fflush(file) != 0)
+        return Error::from_errno(errno);
+    rewind(file);
+
+    lines.clear();
+    return LineReader { file };
+}
+
+// Merges the sorted runs into the output file with a k-way merge.
+static ErrorOr<void> merge_runs(Span<LineReader> runs, FILE* output)
+{
+    VERIFY(runs.size() <= max_merge_width);
+
+    BinaryHeap<String, size_t, max_merge_width> heap;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (auto line = TRY(runs[i].read_line()); line.has_value())
+            heap.insert(line.release_value(), i);
+    }
+
+    while (!heap.is_empty()) {
+        TRY(write_line(output, heap.peek_min_key()));
+        auto run = heap.pop_min();
+        if (auto line = TRY(runs[run].read_line()); line.has_value())
+            heap.insert(line.release_value(), run);
+    }
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"sv));
+
+    char const* input_path = nullptr;
+    size_t memory_limit_in_mib = 64;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(memory_limit_in_mib, "Memory to use for sorting before spilling to temporary files (default: 64)", "buffer-size", 'S', "MiB");
+    args_parser.add_positional_argument(input_path, "File to sort (default: standard input)", "input", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    FILE* input_file = stdin;
+    if (input_path && strcmp(input_path, "-") != 0) {
+        input_file = fopen(input_path, "r");
+        if (!input_file) {
+            perror("fopen");
+            return 1;
         }
-        if (buflen == -1)
+    }
+    LineReader input { input_file };
+
+    // Lines are read in chunks that fit into the memory limit. If all of them do, we sort them in memory, otherwise
+    // every chunk is sorted and written to a temporary file, and those are merged at the end.
+    size_t memory_limit = max(memory_limit_in_mib, static_cast<size_t>(1)) * MiB;
+    Vector<String> lines;
+    Vector<LineReader> runs;
+    size_t memory_used = 0;
+
+    while (true) {
+        auto line = TRY(input.read_line());
+        if (!line.has_value())
             break;
-        lines.append({ buffer, AK::ShouldChomp::Chomp });
+
+        memory_used += line->length() + line_overhead;
+        lines.append(line.release_value());
+        if (memory_used >= memory_limit) {
+            runs.append(TRY(write_sorted_run(lines)));
+            memory_used = 0;
+        }
+    }
+
+    if (runs.is_empty()) {
+        sort_lines(lines);
+        for (auto& line : lines)
+            outln("{}", line);
+        return 0;
     }
 
-    quick_sort(lines);
+    if (!lines.is_empty())
+        runs.append(TRY(write_sorted_run(lines)));
 
-    for (auto& line : lines) {
-        outln("{}", line);
+    while (runs.size() > max_merge_width) {
+        auto* merged = TRY(create_temporary_file());
+        LineReader merged_run { merged };
+        TRY(merge_runs(runs.span().trim(max_merge_width), merged));
+        if (fflush(merged) != 0)
+            return Error::from_errno(errno);
+        rewind(merged);
+        runs.remove(0, max_merge_width);
+        runs.append(move(merged_run));
     }
 
+    TRY(merge_runs(runs.span(), stdout));
     return 0;
 }
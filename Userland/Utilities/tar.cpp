@@ -7,6 +7,8 @@
 #include "LibCore/Directory.h"
 #include <AK/Assertions.h>
 #include <AK/LexicalPath.h>
+#include <AK/MemoryStream.h>
+#include <AK/Queue.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
 #include <LibArchive/TarStream.h>
@@ -15,14 +17,126 @@
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/FileStream.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 constexpr size_t buffer_size = 4096;
+constexpr size_t extraction_buffer_size = 256 * KiB;
+
+// Creating and writing the extracted files happens on a thread of its own, so that reading and decompressing
+// the archive doesn't have to wait for the file system. Tasks run one at a time, in the order they were queued.
+class ExtractionWriter {
+    AK_MAKE_NONCOPYABLE(ExtractionWriter);
+    AK_MAKE_NONMOVABLE(ExtractionWriter);
+
+public:
+    using Task = Function<ErrorOr<void>()>;
+
+    ExtractionWriter()
+    {
+        m_thread = Threading::Thread::construct([this] { return run(); }, "tar writer"sv);
+        m_thread->start();
+    }
+
+    ~ExtractionWriter()
+    {
+        (void)finish();
+    }
+
+    // Blocks while a lot of data is waiting to be written already, and fails if an earlier task has failed.
+    ErrorOr<void> queue(Task task, size_t data_size = 0)
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_condition.wait_while([&] {
+            return !m_error.has_value() && m_queued_data_size > 0 && m_queued_data_size + data_size > max_queued_data_size;
+        });
+        if (m_error.has_value())
+            return m_error.value();
+
+        m_tasks.enqueue({ move(task), data_size });
+        m_queued_data_size += data_size;
+        m_condition.broadcast();
+        return {};
+    }
+
+    // Waits for all queued tasks to run.
+    ErrorOr<void> finish()
+    {
+        {
+            Threading::MutexLocker locker(m_mutex);
+            if (m_finished)
+                return m_error.has_value() ? ErrorOr<void> { m_error.value() } : ErrorOr<void> {};
+            m_finished = true;
+            m_condition.broadcast();
+        }
+        (void)m_thread->join();
+
+        if (m_error.has_value())
+            return m_error.value();
+        return {};
+    }
+
+private:
+    static constexpr size_t max_queued_data_size = 16 * MiB;
+
+    struct QueuedTask {
+        Task function;
+        size_t data_size { 0 };
+    };
+
+    intptr_t run()
+    {
+        for (;;) {
+            QueuedTask task;
+            {
+                Threading::MutexLocker locker(m_mutex);
+                m_condition.wait_while([&] { return m_tasks.is_empty() && !m_finished; });
+                if (m_tasks.is_empty())
+                    return 0;
+                task = m_tasks.dequeue();
+            }
+
+            auto result = task.function();
+
+            Threading::MutexLocker locker(m_mutex);
+            m_queued_data_size -= task.data_size;
+            if (result.is_error()) {
+                // Nothing that comes after a failed task is going to run.
+                m_error = result.release_error();
+                m_tasks.clear();
+                m_queued_data_size = 0;
+                m_condition.broadcast();
+                return 1;
+            }
+            m_condition.broadcast();
+        }
+    }
+
+    RefPtr<Threading::Thread> m_thread;
+    Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_condition { m_mutex };
+    Queue<QueuedTask> m_tasks;
+    size_t m_queued_data_size { 0 };
+    Optional<Error> m_error;
+    bool m_finished { false };
+};
+
+static ErrorOr<void> write_all(int fd, ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto nwritten = TRY(Core::System::write(fd, bytes));
+        bytes = bytes.slice(nwritten);
+    }
+    return {};
+}
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -60,17 +174,27 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     if (list || extract) {
         auto file = Core::File::standard_input();
-
-        if (!archive_file.is_empty())
-            file = TRY(Core::File::open(archive_file, Core::OpenMode::ReadOnly));
+        RefPtr<Core::MappedFile> mapped_file;
+
+        if (!archive_file.is_empty()) {
+            // Reading the archive straight out of memory saves pushing all of it through small read() calls.
+            // Things that can't be mapped, like pipes, are read like standard input.
+            auto mapped_file_or_error = Core::MappedFile::map(archive_file);
+            if (mapped_file_or_error.is_error())
+                file = TRY(Core::File::open(archive_file, Core::OpenMode::ReadOnly));
+            else
+                mapped_file = mapped_file_or_error.release_value();
+        }
 
         if (!directory.is_empty())
             TRY(Core::System::chdir(directory));
 
-        Core::InputFileStream file_stream(file);
-        Compress::GzipDecompressor gzip_stream(file_stream);
+        // Buffered<T> skips over data by reading it, which unlike seeking also works on pipes.
+        Buffered<Core::InputFileStream> file_stream(file);
+        InputMemoryStream memory_stream(mapped_file ? mapped_file->bytes() : ReadonlyBytes {});
+        InputStream& file_input_stream = mapped_file ? static_cast<InputStream&>(memory_stream) : static_cast<InputStream&>(file_stream);
 
-        InputStream& file_input_stream = file_stream;
+        Compress::GzipDecompressor gzip_stream(file_input_stream);
         InputStream& gzip_input_stream = gzip_stream;
         Archive::TarInputStream tar_stream((gzip) ? gzip_input_stream : file_input_stream);
         // FIXME: implement ErrorOr<TarInputStream>?
@@ -96,6 +220,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             return {};
         };
 
+        // These are only used by the writer's tasks, which all run on the writer thread.
+        int output_fd = -1;
+        String last_parent_path;
+        auto create_parent_directory = [&last_parent_path](LexicalPath const& parent_path) -> ErrorOr<void> {
+            // The files of a directory are usually stored next to each other, so this mostly saves
+            // looking up the same directories over and over again.
+            if (parent_path.string() == last_parent_path)
+                return {};
+            TRY(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
+            last_parent_path = parent_path.string();
+            return {};
+        };
+
+        ExtractionWriter writer;
+
         for (; !tar_stream.finished(); tar_stream.advance()) {
             Archive::TarFileHeader const& header = tar_stream.header();
 
@@ -161,30 +300,48 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 switch (header.type_flag()) {
                 case Archive::TarFileType::NormalFile:
                 case Archive::TarFileType::AlternateNormalFile: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
-
-                    int fd = TRY(Core::System::open(absolute_path, O_CREAT | O_WRONLY, header.mode()));
-
-                    Array<u8, buffer_size> buffer;
-                    size_t bytes_read;
-                    while ((bytes_read = file_stream.read(buffer)) > 0)
-                        TRY(Core::System::write(fd, buffer.span().slice(0, bytes_read)));
+                    TRY(writer.queue([&, absolute_path, parent_path, mode = header.mode()]() -> ErrorOr<void> {
+                        TRY(create_parent_directory(parent_path));
+                        output_fd = TRY(Core::System::open(absolute_path, O_CREAT | O_WRONLY, mode));
+                        return {};
+                    }));
 
-                    TRY(Core::System::close(fd));
+                    size_t remaining_size = header.size();
+                    while (remaining_size > 0) {
+                        auto buffer = TRY(ByteBuffer::create_uninitialized(min(remaining_size, extraction_buffer_size)));
+                        auto bytes_read = file_stream.read(buffer);
+                        if (bytes_read == 0)
+                            break;
+                        buffer.resize(bytes_read);
+                        remaining_size -= bytes_read;
+
+                        TRY(writer.queue([&output_fd, buffer = move(buffer)]() {
+                            return write_all(output_fd, buffer);
+                        },
+                            bytes_read));
+                    }
+
+                    TRY(writer.queue([&output_fd]() {
+                        return Core::System::close(output_fd);
+                    }));
                     break;
                 }
                 case Archive::TarFileType::SymLink: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
-
-                    TRY(Core::System::symlink(header.link_name(), absolute_path));
+                    TRY(writer.queue([&, absolute_path, parent_path, link_name = String(header.link_name())]() -> ErrorOr<void> {
+                        TRY(create_parent_directory(parent_path));
+                        return Core::System::symlink(link_name, absolute_path);
+                    }));
                     break;
                 }
                 case Archive::TarFileType::Directory: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
+                    TRY(writer.queue([&, absolute_path, parent_path, mode = header.mode()]() -> ErrorOr<void> {
+                        TRY(create_parent_directory(parent_path));
 
-                    auto result_or_error = Core::System::mkdir(absolute_path, header.mode());
-                    if (result_or_error.is_error() && result_or_error.error().code() != EEXIST)
-                        return result_or_error.error();
+                        auto result_or_error = Core::System::mkdir(absolute_path, mode);
+                        if (result_or_error.is_error() && result_or_error.error().code() != EEXIST)
+                            return result_or_error.error();
+                        return {};
+                    }));
                     break;
                 }
                 default:
@@ -197,7 +354,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             // Non-global headers should be cleared after every file.
             local_overrides.clear();
         }
-        file_stream.close();
+        TRY(writer.finish());
+        file_stream.underlying_stream().close();
 
         return 0;
     }
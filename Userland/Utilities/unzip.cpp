@@ -6,6 +6,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/NumberFormat.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StringUtils.h>
 #include <LibArchive/Zip.h>
 #include <LibCompress/Deflate.h>
@@ -14,64 +15,52 @@
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
+#include <LibThreading/ThreadPool.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool unpack_zip_directory(Archive::ZipMember const& zip_member, bool quiet)
 {
-    if (zip_member.is_directory) {
-        if (mkdir(zip_member.name.characters(), 0755) < 0) {
-            perror("mkdir");
-            return false;
-        }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
-    }
-    MUST(Core::Directory::create(LexicalPath(zip_member.name).parent(), Core::Directory::CreateDirectories::Yes));
-    auto new_file = Core::File::construct(zip_member.name);
-    if (!new_file->open(Core::OpenMode::WriteOnly)) {
-        warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
+    if (mkdir(zip_member.name.characters(), 0755) < 0) {
+        perror("mkdir");
         return false;
     }
-
     if (!quiet)
         outln(" extracting: {}", zip_member.name);
+    return true;
+}
+
+// This runs on the thread pool, so it leaves reporting errors to the caller.
+static ErrorOr<void> unpack_zip_file(Archive::ZipMember const& zip_member)
+{
+    auto fd = TRY(Core::System::open(zip_member.name, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0666));
+    ScopeGuard close_fd = [fd] { (void)Core::System::close(fd); };
+
+    auto write_all = [fd](ReadonlyBytes bytes) -> ErrorOr<void> {
+        while (!bytes.is_empty()) {
+            auto nwritten = TRY(Core::System::write(fd, bytes));
+            bytes = bytes.slice(nwritten);
+        }
+        return {};
+    };
 
     // TODO: verify CRC32s match!
     switch (zip_member.compression_method) {
-    case Archive::ZipCompressionMethod::Store: {
-        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+    case Archive::ZipCompressionMethod::Store:
+        TRY(write_all(zip_member.compressed_data));
         break;
-    }
     case Archive::ZipCompressionMethod::Deflate: {
         auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (!decompressed_data.has_value()) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+        if (!decompressed_data.has_value() || decompressed_data.value().size() != zip_member.uncompressed_size)
+            return Error::from_string_literal("Failed decompressing file");
+        TRY(write_all(decompressed_data.value()));
         break;
     }
     default:
         VERIFY_NOT_REACHED();
     }
 
-    if (!new_file->close()) {
-        warnln("Can't close file {}: {}", zip_member.name, new_file->error_string());
-        return false;
-    }
-
-    return true;
+    return {};
 }
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
@@ -116,6 +105,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         TRY(Core::System::chdir(output_directory_path));
     }
 
+    Vector<Archive::ZipMember> zip_files;
+    String last_parent_path;
     auto success = zip_file->for_each_member([&](auto zip_member) {
         bool keep_file = false;
 
@@ -132,13 +123,47 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             keep_file = true;
         }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
+        if (!keep_file)
+            return IterationDecision::Continue;
+
+        if (zip_member.is_directory) {
+            if (!unpack_zip_directory(zip_member, quiet))
                 return IterationDecision::Break;
+            return IterationDecision::Continue;
+        }
+
+        // Directories are created up front, so that the threads extracting the files don't race to create the same ones.
+        auto parent_path = LexicalPath(zip_member.name).parent();
+        if (parent_path.string() != last_parent_path) {
+            MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
+            last_parent_path = parent_path.string();
         }
 
+        if (!quiet)
+            outln(" extracting: {}", zip_member.name);
+        zip_files.append(zip_member);
         return IterationDecision::Continue;
     });
 
+    if (!success)
+        return 1;
+
+    // Every member is compressed on its own, so they can all be decompressed and written out at the same time.
+    Vector<Optional<Error>> errors;
+    errors.resize(zip_files.size());
+    Threading::ThreadPool::the().parallel_for(
+        0, zip_files.size(), [&](size_t index) {
+            if (auto result = unpack_zip_file(zip_files[index]); result.is_error())
+                errors[index] = result.release_error();
+        },
+        1);
+
+    for (size_t i = 0; i < zip_files.size(); ++i) {
+        if (errors[i].has_value()) {
+            warnln("Can't extract {}: {}", zip_files[i].name, errors[i].value());
+            success = false;
+        }
+    }
+
     return success ? 0 : 1;
 }